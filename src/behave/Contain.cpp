@@ -122,6 +122,9 @@ using namespace std;
 //for logging inside contain.cpp - ok to be static since it's used as a readonly var
 static int     m_logLevel = 0;
 
+//! Largest turn of the attack point per AdaptiveStep step (radians)
+static const double AdaptiveMaxTurn = 0.05;
+
 
 //------------------------------------------------------------------------------
 /*! \brief Contain constructor.
@@ -183,7 +186,14 @@ Sem::Contain::Contain(
     m_x(0.),
     m_y(0.),
     m_status(Unreported),
-    m_startTime(fireStartMinutesStartTime)
+    m_startTime(fireStartMinutesStartTime),
+    m_integrator(FixedStep),
+    m_tolerance(1.e-6),
+    m_adaptiveStep(0.),
+    m_stepTaken(0.),
+    m_analyticSteps(true),
+    m_analyticStepCount(0),
+    m_stepLanded(false)
 {
     // Set all the input parameters.
     setReport( reportSize, reportRate, lwRatio, distStep );
@@ -313,6 +323,300 @@ void Sem::Contain::calcU( void )
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief AdaptiveStep version of calcU().
+
+    Each step is taken as one full 4th order Runga-Kutta step and as two half
+    steps, and the difference between the two estimates the error in u.
+    Steps whose error exceeds the tolerance are retried with a smaller
+    distance step, and accepted steps set the distance step to try next,
+    so the step grows while the attack point moves smoothly and shrinks
+    where it turns sharply.  Steps are also cut short at the next change
+    in fireline production or hourly spread rate so the production ratios
+    used within a step never straddle a change, at containment so the
+    final step is short, and before the attack point turns far enough to
+    coarsen the perimeter built from the steps.
+
+    Where the production ratio stays constant over the step, calcUAnalytic()
+    takes the step instead, and these Runga-Kutta steps are the fallback.
+
+    \retval Next value of the angle from the fire origin to the point of
+                active fireline construction is stored in m_u.
+    \retval Next value of free-burning head position is stored in m_h.
+    \retval Distance step taken is stored in m_stepTaken.
+ */
+
+void Sem::Contain::calcUAdaptive( void )
+{
+    // Store the current u and h as the old u and h.
+    m_u0 = m_u;
+    m_h0 = m_h;
+    m_status = Attacked;
+    m_stepLanded = false;
+
+    // Minutes it takes the fire head to advance one chain
+    double minutes = m_currentTimeAtFireHead + m_attackTime;
+    double fire = getDiurnalSpreadRate( minutes );
+    if ( fire < 0.0001 )
+    {
+        fire = 0.0001;
+    }
+    double minutesPerChain = 60. / fire;
+    if ( m_analyticSteps && calcUAnalytic( minutes, minutesPerChain ) )
+    {
+        return;
+    }
+
+    // Keep the step between 1/1000 and 64 times the fixed distance step
+    double minStep = 0.001 * m_distStep;
+    double maxStep = 64. * m_distStep;
+    // Largest turn of the attack point per step (radians)
+    const double maxTurn = AdaptiveMaxTurn;
+    double distStep = ( m_adaptiveStep > 0. ) ? m_adaptiveStep : m_distStep;
+    distStep = ( distStep > maxStep ) ? maxStep : distStep;
+
+    // Don't step past the next production change or hour boundary
+    double until = minutes + distStep * minutesPerChain;
+    double next = m_force->nextArrival( minutes, until + 1., m_flank );
+    double hour = 60. * ( floor( ( minutes + m_startTime ) / 60. ) + 1. )
+                - m_startTime;
+    if ( hour < until )
+    {
+        until = hour;
+    }
+    if ( next > minutes && next < until )
+    {
+        until = next;
+    }
+    bool limited = false;
+    if ( ( until - minutes ) / minutesPerChain < distStep )
+    {
+        distStep = ( until - minutes ) / minutesPerChain;
+        distStep = ( distStep < minStep ) ? minStep : distStep;
+        limited = true;
+    }
+
+    // Take the step, shrinking it until the error is within tolerance
+    double uFull, uHalf, uTwoHalves, error;
+    double uContained = ( m_tactic == HeadAttack ) ? M_PI : 0.;
+    int landings = 0;
+    while ( true )
+    {
+        if ( ! rungeKuttaStep( m_h0, m_u0, distStep, minutes,
+                    minutesPerChain, &uFull )
+          || ! rungeKuttaStep( m_h0, m_u0, 0.5 * distStep, minutes,
+                    minutesPerChain, &uHalf )
+          || ! rungeKuttaStep( m_h0 + 0.5 * distStep, uHalf, 0.5 * distStep,
+                    minutes + 0.5 * distStep * minutesPerChain,
+                    minutesPerChain, &uTwoHalves ) )
+        {
+            return;
+        }
+        error = fabs( uTwoHalves - uFull ) / 15.;
+        // Keep the turn per step small enough for the perimeter polygon
+        // built from the steps to follow the fireline
+        double turn = fabs( uTwoHalves - m_u0 );
+        if ( turn > maxTurn && distStep > minStep )
+        {
+            distStep *= 0.9 * maxTurn / turn;
+            distStep = ( distStep < minStep ) ? minStep : distStep;
+            limited = true;
+            continue;
+        }
+        if ( error <= m_tolerance || distStep <= minStep )
+        {
+            // A step that overshoots containment is shortened to land just
+            // past it, rather than interpolating back across a long step
+            double u = uTwoHalves + ( uTwoHalves - uFull ) / 15.;
+            double over = ( m_tactic == HeadAttack )
+                        ? ( u - uContained )
+                        : ( uContained - u );
+            if ( over <= m_tolerance || distStep <= minStep || landings >= 8 )
+            {
+                break;
+            }
+            distStep = minStep + 1.001 * distStep
+                     * ( uContained - m_u0 ) / ( u - m_u0 );
+            limited = true;
+            landings++;
+            continue;
+        }
+        double factor = 0.9 * pow( m_tolerance / error, 0.2 );
+        distStep *= ( factor < 0.1 ) ? 0.1 : factor;
+        distStep = ( distStep < minStep ) ? minStep : distStep;
+        limited = false;
+    }
+
+    // Richardson extrapolation of the two estimates
+    m_u = uTwoHalves + ( uTwoHalves - uFull ) / 15.;
+    m_h = m_h0 + distStep;
+    m_stepTaken = distStep;
+    m_timeIncrement = distStep * minutesPerChain;
+
+    // Choose the next step from this step's error, unless this step was
+    // only cut short to land on a production change
+    if ( ! limited )
+    {
+        double factor = ( error > 0. )
+                      ? 0.9 * pow( m_tolerance / error, 0.2 )
+                      : 4.;
+        factor = ( factor > 4. ) ? 4. : factor;
+        factor = ( factor < 0.2 ) ? 0.2 : factor;
+        m_adaptiveStep = distStep * factor;
+    }
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constant production version of calcUAdaptive().
+
+    With the production ratio p held constant, the containment equation of
+    calcUh() taken the other way round, dh/du, is linear in h and does not
+    depend on time, so the step is taken in u rather than in h: one 4th
+    order Runga-Kutta step turns the attack point by the full perimeter
+    turn limit, or lands it exactly on containment, with no error control
+    loop or step retries.  The step is only accepted if the fire head spread
+    rate and the production rate stay the same until the step ends, and
+    the attack point keeps a steady pace along it; otherwise calcUAdaptive()
+    takes its Runga-Kutta steps in h instead.
+
+    \param[in] minutesSinceReport Time at the start of the step.
+    \param[in] minutesPerChain    Minutes for the fire head to advance one chain.
+
+    \retval TRUE if the step was taken and m_u, m_h, m_stepTaken and
+                m_timeIncrement are set.
+ */
+
+bool Sem::Contain::calcUAnalytic( double minutesSinceReport,
+        double minutesPerChain )
+{
+    double uContained = ( m_tactic == HeadAttack ) ? M_PI : 0.;
+    double turn = ( m_tactic == HeadAttack ) ? AdaptiveMaxTurn : -AdaptiveMaxTurn;
+    bool lands = false;
+    if ( fabs( uContained - m_u0 ) <= AdaptiveMaxTurn )
+    {
+        turn = uContained - m_u0;
+        lands = true;
+    }
+    if ( fabs( turn ) < 1.e-12 )
+    {
+        return( false );
+    }
+
+    // 4th order Runga-Kutta step of dh/du at constant production
+    double p = productionRatioAt( minutesSinceReport );
+    double rk[4], deriv, minDeriv, maxDeriv;
+    if ( ! calcHu( p, m_h0, m_u0, &deriv ) )
+    {
+        return( false );
+    }
+    rk[0] = turn * deriv;
+    minDeriv = maxDeriv = deriv;
+    if ( ! calcHu( p, ( m_h0 + 0.5 * rk[0] ), ( m_u0 + 0.5 * turn ), &deriv ) )
+    {
+        return( false );
+    }
+    rk[1] = turn * deriv;
+    minDeriv = ( deriv < minDeriv ) ? deriv : minDeriv;
+    maxDeriv = ( deriv > maxDeriv ) ? deriv : maxDeriv;
+    if ( ! calcHu( p, ( m_h0 + 0.5 * rk[1] ), ( m_u0 + 0.5 * turn ), &deriv ) )
+    {
+        return( false );
+    }
+    rk[2] = turn * deriv;
+    minDeriv = ( deriv < minDeriv ) ? deriv : minDeriv;
+    maxDeriv = ( deriv > maxDeriv ) ? deriv : maxDeriv;
+    if ( ! calcHu( p, ( m_h0 + rk[2] ), ( m_u0 + turn ), &deriv ) )
+    {
+        return( false );
+    }
+    rk[3] = turn * deriv;
+    minDeriv = ( deriv < minDeriv ) ? deriv : minDeriv;
+    maxDeriv = ( deriv > maxDeriv ) ? deriv : maxDeriv;
+
+    // A sharp slow down of the attack point is left to the error control
+    // of the Runga-Kutta steps in h, as is a step longer than they may take
+    double distStep = ( rk[0] + rk[3] + 2. * ( rk[1] + rk[2] ) ) / 6.;
+    if ( fabs( maxDeriv ) > 2. * fabs( minDeriv ) || distStep <= 0.
+      || distStep > 64. * m_distStep )
+    {
+        return( false );
+    }
+
+    // The production ratio must not change before the step ends
+    double until = minutesSinceReport + distStep * minutesPerChain;
+    double next = m_force->nextArrival( minutesSinceReport, until + 1., m_flank );
+    if ( next > minutesSinceReport && next < until )
+    {
+        return( false );
+    }
+    double fire = getDiurnalSpreadRate( minutesSinceReport );
+    double hour = 60. * ( floor( ( minutesSinceReport + m_startTime ) / 60. ) + 1. )
+                - m_startTime;
+    for ( ; hour < until; hour += 60. )
+    {
+        if ( getDiurnalSpreadRate( hour ) != fire )
+        {
+            return( false );
+        }
+    }
+
+    m_u = lands ? uContained : ( m_u0 + turn );
+    m_h = m_h0 + distStep;
+    m_stepTaken = distStep;
+    m_timeIncrement = distStep * minutesPerChain;
+    m_adaptiveStep = distStep;
+    m_stepLanded = lands;
+    m_analyticStepCount++;
+    return( true );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Takes one 4th order Runga-Kutta step of \a distStep from (h, u)
+    for the AdaptiveStep integrator.
+
+    \param[in] h                  Free-burning fire head position (ch).
+    \param[in] u                  Angle to point of active line building.
+    \param[in] distStep           Fire head distance step (ch).
+    \param[in] minutesSinceReport Time at the start of the step.
+    \param[in] minutesPerChain    Minutes for the fire head to advance one chain.
+    \param[out] uNext             Address where the next u is returned.
+
+    \retval TRUE if ContainResources are not overrun and uNext is valid.
+ */
+
+bool Sem::Contain::rungeKuttaStep( double h, double u, double distStep,
+        double minutesSinceReport, double minutesPerChain, double *uNext )
+{
+    double minutes = distStep * minutesPerChain;
+    double pr0 = productionRatioAt( minutesSinceReport );
+    double pr1 = productionRatioAt( minutesSinceReport + 0.5 * minutes );
+    double pr2 = productionRatioAt( minutesSinceReport + minutes );
+    double rk[4], deriv;
+    if ( ! calcUh( pr0, h, u, &deriv ) )
+    {
+        return( false );
+    }
+    rk[0] = distStep * deriv;
+    if ( ! calcUh( pr1, ( h + 0.5 * distStep ), ( u + 0.5 * rk[0] ), &deriv ) )
+    {
+        return( false );
+    }
+    rk[1] = distStep * deriv;
+    if ( ! calcUh( pr1, ( h + 0.5 * distStep ), ( u + 0.5 * rk[1] ), &deriv ) )
+    {
+        return( false );
+    }
+    rk[2] = distStep * deriv;
+    if ( ! calcUh( pr2, ( h + distStep ), ( u + rk[2] ), &deriv ) )
+    {
+        return( false );
+    }
+    rk[3] = distStep * deriv;
+    *uNext = u + ( rk[0] + rk[3] + 2. * ( rk[1] + rk[2] ) ) / 6.;
+    return( true );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Determines du/dh for a particular u, h, and p,
     and returns the value in d.
@@ -413,6 +717,59 @@ bool Sem::Contain::calcUh( double p, double h, double u, double *d )
     return( true );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Determines dh/du, the inverse of calcUh(), for a particular u, h,
+    and p, and returns the value in d.  Used by calcUAnalytic().
+
+    \param[in] p Fireline production ratio.
+    \param[in] h Current distance of free-burning fire head from the origin (ch).
+    \param[in] u Current angle from the fire origin to the point of active
+                 fireline construction.
+    \param[in] d Address where the dh/du derivative is returned.
+
+    \retval TRUE if d has a valid result.
+    \retval FALSE if the expression under the radical sign is near zero,
+            or the attack point is not moving towards containment.
+ */
+
+bool Sem::Contain::calcHu( double p, double h, double u, double *d ) const
+{
+    double cosU = cos(u);
+    double sinU = sin(u);
+    double x = 1. - m_eps * cosU;
+    double uh_radical = ( p * p * x / ( 1. + m_eps * cosU ) ) - m_a * m_a;
+    if ( uh_radical <= 1.0e-10 )
+    {
+        return( false );
+    }
+    double dh = x * h;
+    if ( m_attackDist > 0.001 )
+    {
+        dh = x * ( h + ( 1. - m_eps ) *
+           ( m_attackDist * sqrt( 1. - m_eps2 )
+             / exp( 1.5 * log( 1. - ( m_eps2 * cosU * cosU ) ) ) ) );
+    }
+    double du;
+    if ( m_tactic == RearAttack )
+    {
+        du = m_eps * sinU - ( 1. + m_eps ) * sqrt( uh_radical );
+        if ( du >= 0. )
+        {
+            return( false );
+        }
+    }
+    else
+    {
+        du = m_eps * sinU + ( 1. + m_eps ) * sqrt( uh_radical );
+        if ( du <= 0. )
+        {
+            return( false );
+        }
+    }
+    *d = dh / du;
+    return( true );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Determines the x- and y- coordinates ( m_x and m_y)
     for the current angle (m_u) and free-burning head position (m_h).
@@ -803,6 +1160,27 @@ double Sem::Contain::productionRatio( double fireHeadPosition )
 
 
 
+//------------------------------------------------------------------------------
+/*! \brief Determines the ratio of the aggregate containment force holdable
+    fireline production rate to the fire head spread rate at a time,
+    without touching m_timeIncrement.  Used by the AdaptiveStep integrator.
+
+    \param[in] minutesSinceReport Time since the fire was reported (min).
+
+    \return Ratio of production rate to fire head spread rate.
+ */
+
+double Sem::Contain::productionRatioAt( double minutesSinceReport ) const
+{
+    double prod = m_force->productionRate( minutesSinceReport, m_flank );
+    double fire = getDiurnalSpreadRate( minutesSinceReport );
+    if ( fire < 0.0001 )
+    {
+        fire = 0.0001;
+    }
+    return( prod / fire );
+}
+
 //===============================================================================
 //===============================================================================
 //
@@ -869,11 +1247,6 @@ void Sem::Contain::reset( void )
 {
     //double CTime, fsize, CRate, L, W, atktime;
 	
-    m_currentTimeAtFireHead=0.0;
-    m_timeIncrement=0.0;
-    m_currentTime=m_attackTime;//0.0;
-
-
     // Eccentricity
     double r = 1. / m_lwRatio;
     m_eps2 = 1. - (r * r);
@@ -962,6 +1335,29 @@ void Sem::Contain::reset( void )
     m_attackBack=m_attackHead*(1.0-m_eps)/(1.0+m_eps);
     //------------------------------------------------------------------------
 
+    startAttack();
+
+    // Log it
+    containLog( (m_logLevel>1), "\n\nCONTAIN RESET-----------------------------\n\n" );
+    containLog( (m_logLevel>1), "Eta   = %12.10f\n", m_distStep );
+    containLog( (m_logLevel>1), "eps   = %12.10f\n", m_eps );
+    containLog( (m_logLevel>1), "EpsSq = %12.10f\n", m_eps2 );
+    containLog( (m_logLevel>1), "A     = %12.10f\n", m_a );
+    containLog( (m_logLevel>1), "hr    = %12.10f\n", m_reportHead );
+    containLog( (m_logLevel>1), "ho    = %12.10f\n", m_attackHead );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Places the attack point for the current tactic and attack distance
+    and starts the simulation over from the fire at first attack.
+
+    Only the tactic and attack distance are read, so the fire growth up to
+    the attack that reset() worked out can be shared by several tactics.
+ */
+
+void Sem::Contain::startAttack( void )
+{
     // Initial angle to attack point depends on whether HeadAttack or RearAttack
     if ( m_tactic == RearAttack )
     {
@@ -975,21 +1371,18 @@ void Sem::Contain::reset( void )
     }
     m_h = m_h0 = m_attackHead;
     m_y = 0.;
+    m_adaptiveStep = m_stepTaken = m_distStep;
+    m_analyticStepCount = 0;
+    m_stepLanded = false;
 
     // Initialization
+    m_currentTimeAtFireHead=0.0;
+    m_timeIncrement=0.0;
+    m_currentTime=m_attackTime;//0.0;
     m_step = 0;
     m_time = 0.0;
     m_rkpr[0] = m_rkpr[1] = m_rkpr[2] = 0.;
     m_status = Reported;        // Also means that we're initialized
-
-    // Log it
-    containLog( (m_logLevel>1), "\n\nCONTAIN RESET-----------------------------\n\n" );
-    containLog( (m_logLevel>1), "Eta   = %12.10f\n", m_distStep );
-    containLog( (m_logLevel>1), "eps   = %12.10f\n", m_eps );
-    containLog( (m_logLevel>1), "EpsSq = %12.10f\n", m_eps2 );
-    containLog( (m_logLevel>1), "A     = %12.10f\n", m_a );
-    containLog( (m_logLevel>1), "hr    = %12.10f\n", m_reportHead );
-    containLog( (m_logLevel>1), "ho    = %12.10f\n", m_attackHead );
     return;
 }
 
@@ -1218,7 +1611,8 @@ double Sem::Contain::spreadRate( double /* minutesSinceReport */ ) const
 
 //------------------------------------------------------------------------------
 /*! \brief Performs one containment simulation step by incrementing the head
-    position by the distance step \a m_distStep.
+    position by the distance step \a m_distStep, or by the step chosen by
+    calcUAdaptive() under the AdaptiveStep integrator.
 
     \retval Current fire status.
  */
@@ -1226,7 +1620,15 @@ double Sem::Contain::spreadRate( double /* minutesSinceReport */ ) const
 Sem::Contain::ContainStatus Sem::Contain::step( void )
 {
     // Determine next angle and fire head position.
-    calcU();
+    if ( m_integrator == AdaptiveStep )
+    {
+        calcUAdaptive();
+    }
+    else
+    {
+        calcU();
+        m_stepTaken = m_distStep;
+    }
 
     // Increment step counter
     m_step++;
@@ -1239,17 +1641,24 @@ Sem::Contain::ContainStatus Sem::Contain::step( void )
     {
         return( m_status );
     }
-    // If the forces contain the fire, interpolate the final u and h.
+    // If the forces contain the fire, interpolate the final u and h,
+    // unless calcUAnalytic() landed the step on containment.
     if ( m_tactic == HeadAttack && m_u >= M_PI )
     {
         m_status = Contained;
-        m_h = m_h0 - m_distStep * m_u0 / ( m_u0 + fabs( m_u ) );
+        if ( ! m_stepLanded )
+        {
+            m_h = m_h0 - m_stepTaken * m_u0 / ( m_u0 + fabs( m_u ) );
+        }
         m_u = M_PI;
     }
     else if ( m_tactic == RearAttack && m_u <= 0.0 )
     {
         m_status = Contained;
-        m_h = m_h0 + m_distStep * m_u0 / ( m_u0 + fabs( m_u ) );
+        if ( ! m_stepLanded )
+        {
+            m_h = m_h0 + m_stepTaken * m_u0 / ( m_u0 + fabs( m_u ) );
+        }
         m_u = 0.;
     }
     // Determine the x and y coordinate.
@@ -1264,6 +1673,91 @@ Sem::Contain::ContainStatus Sem::Contain::step( void )
     return( m_status );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Access to the integration method.
+
+    \return Integration method Sem::Contain::ContainIntegrator
+        - FixedStep = 0
+        - AdaptiveStep = 1
+ */
+
+Sem::Contain::ContainIntegrator Sem::Contain::integrator( void ) const
+{
+    return( m_integrator );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the AdaptiveStep error tolerance.
+
+    \return Error tolerance on the attack point angle per step (radians).
+ */
+
+double Sem::Contain::integratorTolerance( void ) const
+{
+    return( m_tolerance );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the integration method.
+
+    FixedStep advances the fire head by the distance step, halved as needed
+    to keep each step within a minute, and is the reference method.
+    AdaptiveStep grows and shrinks the step to keep the estimated error in
+    the attack point angle within \a tolerance, taking far fewer steps.
+
+    \param[in] integrator FixedStep or AdaptiveStep.
+    \param[in] tolerance  AdaptiveStep error tolerance on the attack point
+                           angle per step (radians).
+ */
+
+void Sem::Contain::setIntegrator( ContainIntegrator integrator,
+        double tolerance )
+{
+    m_integrator = integrator;
+    m_tolerance = ( tolerance > 0. ) ? tolerance : 1.e-6;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to whether AdaptiveStep tries constant production steps.
+
+    \return TRUE if AdaptiveStep takes calcUAnalytic() steps where it can.
+ */
+
+bool Sem::Contain::analyticSteps( void ) const
+{
+    return( m_analyticSteps );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of steps since the attack began that were
+    taken at constant production by calcUAnalytic().
+
+    \return Number of constant production steps.
+ */
+
+int Sem::Contain::analyticStepCount( void ) const
+{
+    return( m_analyticStepCount );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets whether AdaptiveStep takes constant production steps.
+
+    While the fire head spread rate and the fireline production rate stay
+    the same, AdaptiveStep turns the attack point by a fixed angle per step
+    in one Runga-Kutta step instead of shrinking its steps in h to meet the
+    tolerance.  It is on by default; FixedStep is unaffected.
+
+    \param[in] analyticSteps TRUE to take constant production steps.
+ */
+
+void Sem::Contain::setAnalyticSteps( bool analyticSteps )
+{
+    m_analyticSteps = analyticSteps;
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Access to the attack tactic.
 
@@ -1327,6 +1821,9 @@ char * Sem::Contain::printStatus(Sem::Contain::ContainStatus cs) {
  	case Sem::Contain::TimeLimitExceeded:
  	    status = "TimeLimitExceeded";  //!< Simulation max fire time exceeded   
  	    break; 	    
+    case Sem::Contain::Stopped:
+        status = "Stopped";  //!< Simulation stopped by its RunControl
+        break;
     default:
  	    status = "unknown state";
  	    break;
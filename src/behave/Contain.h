@@ -109,7 +109,18 @@ enum ContainStatus
     Exhausted  = 5,     //!< Fire escaped when all resources are exhausted
     Overflow   = 6,     //!< Simulation max step overflow
  	SizeLimitExceeded = 7,      //!< Simulation max fire size exceeded    
- 	TimeLimitExceeded = 8	    //!< Simulation max fire time exceeded 
+ 	TimeLimitExceeded = 8,	    //!< Simulation max fire time exceeded 
+    Stopped    = 9      //!< Simulation stopped by its RunControl
+};
+
+//------------------------------------------------------------------------------
+/*! \enum ContainIntegrator
+    \brief Identifies how the distance step between simulation steps is chosen.
+ */
+enum ContainIntegrator
+{
+    FixedStep    = 0,   //!< Fixed 4th order Runga-Kutta step (reference method)
+    AdaptiveStep = 1    //!< Step grown and shrunk to meet an error tolerance
 };
 
 static const int containVersion = 1;    //!< Class version
@@ -168,18 +179,34 @@ public:
     static char * printStatus(ContainStatus );
     bool   setDiurnalSpreadRates(double *rates);         // hourly, added MAF 10/6/2008
 
+    // Integration method
+    ContainIntegrator integrator( void ) const ;
+    double integratorTolerance( void ) const ;
+    void   setIntegrator( ContainIntegrator integrator, double tolerance ) ;
+    bool   analyticSteps( void ) const ;
+    int    analyticStepCount( void ) const ;
+    void   setAnalyticSteps( bool analyticSteps ) ;
+
     // Computational methods
 protected:
   
     void    calcCoordinates( void ) ;
     void    calcU( void ) ;
+    void    calcUAdaptive( void ) ;
+    bool    calcUAnalytic( double minutesSinceReport, double minutesPerChain ) ;
     bool    calcUh( double r, double h, double u, double *d ) ;
+    bool    calcHu( double p, double h, double u, double *d ) const ;
     void    containLog( bool dolog, char *fmt, ... ) const ;
     double  containPsi( double u, double eps2 ) ;
     double  headPosition( double minutesSinceReport ) const ;
     double  productionRate( double fireHeadPosition ) const ;
     double  productionRatio( double fireHeadPosition )  ;
+    double  productionRatioAt( double minutesSinceReport ) const ;
+    bool    rungeKuttaStep( double h, double u, double distStep,
+                double minutesSinceReport, double minutesPerChain,
+                double *uNext ) ;
     void    reset( void ) ;
+    void    startAttack( void ) ;
     double  spreadRate( double minutesSinceReport ) const ;
     double  getDiurnalSpreadRate( double minutesSinceReport ) const;    // added MAF, 10/6/2008
     ContainStatus step( void ) ;
@@ -224,6 +251,13 @@ protected:
     //added time steps (m_currentTimeAtFireHead, m_timeIncrement) for use in determining ROS
     double  m_currentTimeAtFireHead; //!< calculated as the current time at the fire head, without the attack time
     double  m_timeIncrement;
+    ContainIntegrator m_integrator; //!< FixedStep or AdaptiveStep
+    double  m_tolerance;    //!< AdaptiveStep error tolerance on u per step (radians)
+    double  m_adaptiveStep; //!< AdaptiveStep distance step to try next (ch)
+    double  m_stepTaken;    //!< Distance step taken by the last calcU() (ch)
+    bool    m_analyticSteps; //!< AdaptiveStep tries calcUAnalytic() first
+    int     m_analyticStepCount; //!< Steps taken by calcUAnalytic() since startAttack()
+    bool    m_stepLanded;   //!< Last step landed exactly on containment
     
     
 
@@ -12,6 +12,10 @@ ContainAdapter::ContainAdapter()
     maxSteps_ = 1000,
     maxFireSize_ = 1000,
     maxFireTime_ = 1080;
+    integrator_ = Sem::Contain::FixedStep;
+    integratorTolerance_ = 1.0e-6;
+    keepPerimeter_ = true;
+    runControl_ = nullptr;
     reportSize_ = 0;
     reportRate_ = 0;
     fireStartTime_ = 0;
@@ -22,10 +26,38 @@ ContainAdapter::ContainAdapter()
     finalFireSize_ = 0.0;
     finalContainmentArea_ = 0.0;
     finalTime_ = 0.0;
+    perimeterAtInitialAttack_ = 0.0;
+    fireSizeAtIntitialAttack_ = 0.0;
+    containmentStatus_ = ContainStatus::Unreported;
+    simulationSteps_ = 0;
+
+    m_x = nullptr;
+    m_y = nullptr;
+    m_size = 0;
+    m_reportHead = 0.0;
+    m_reportBack = 0.0;
+    m_attackHead = 0.0;
+    m_attackBack = 0.0;
 
     doContainRun();
 }
 
+ContainRunWorkspace::ContainRunWorkspace()
+{
+
+}
+
+ContainRunWorkspace::ContainRunWorkspace(const ContainRunWorkspace&)
+{
+
+}
+
+ContainRunWorkspace& ContainRunWorkspace::operator=(const ContainRunWorkspace&)
+{
+    // Keep this workspace, it holds nothing that depends on the other adapter
+    return *this;
+}
+
 ContainAdapter::~ContainAdapter()
 {
 
@@ -76,6 +108,16 @@ void ContainAdapter::removeAllResources()
     force_.resourceVector.clear();
 }
 
+int ContainAdapter::getNumberOfResources() const
+{
+    return (int)force_.resourceVector.size();
+}
+
+const Sem::ContainResource& ContainAdapter::getResourceAt(int index) const
+{
+    return force_.resourceVector[index];
+}
+
 void ContainAdapter::setReportSize(double reportSize, AreaUnits::AreaUnitsEnum areaUnits)
 {
     double reportSizeInSquareFeet = AreaUnits::toBaseUnits(reportSize, areaUnits); // convert report size to base units
@@ -98,6 +140,31 @@ void ContainAdapter::setLwRatio(double lwRatio)
     lwRatio_ = lwRatio;
 }
 
+void ContainAdapter::setHourlyFire(const ContainHourlyFire& hourlyFire)
+{
+    hourlySpreadRates_.clear();
+    if (hourlyFire.numberOfHours <= 0 || !hourlyFire.spreadRate)
+    {
+        return;
+    }
+    int numberOfHours = (hourlyFire.numberOfHours < 24) ? hourlyFire.numberOfHours : 24;
+    for (int hour = 0; hour < numberOfHours; hour++)
+    {
+        // Contain expects chains per hour
+        hourlySpreadRates_.push_back(SpeedUnits::fromBaseUnits(hourlyFire.spreadRate[hour], SpeedUnits::ChainsPerHour));
+    }
+    reportRate_ = hourlySpreadRates_[0];
+    if (hourlyFire.lengthToWidthRatio)
+    {
+        lwRatio_ = hourlyFire.lengthToWidthRatio[0];
+    }
+}
+
+void ContainAdapter::clearHourlyFire()
+{
+    hourlySpreadRates_.clear();
+}
+
 void ContainAdapter::setTactic(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic)
 {
     tactic_ = convertAdapterTacticToSemTactic(tactic);
@@ -134,6 +201,27 @@ void ContainAdapter::setMaxFireTime(int maxFireTime)
     maxFireTime_ = maxFireTime;
 }
 
+void ContainAdapter::setIntegrator(ContainAdapterEnums::ContainIntegrator::ContainIntegratorEnum integrator, double tolerance)
+{
+    integrator_ = (Sem::Contain::ContainIntegrator)integrator;
+    integratorTolerance_ = tolerance;
+}
+
+void ContainAdapter::setKeepPerimeter(bool keepPerimeter)
+{
+    keepPerimeter_ = keepPerimeter;
+}
+
+void ContainAdapter::setPerimeterCallback(Sem::ContainPerimeterCallback perimeterCallback)
+{
+    perimeterCallback_ = perimeterCallback;
+}
+
+void ContainAdapter::setRunControl(RunControl* runControl)
+{
+    runControl_ = runControl;
+}
+
 void ContainAdapter::doContainRun()
 {
     if (reportRate_ < 0.00001)
@@ -147,58 +235,35 @@ void ContainAdapter::doContainRun()
         {
             diurnalROS_[i] = reportRate_;
         }
-
-        double  resourceArrival;
-        double  resourceBaseCost;
-        double  resourceCost;
-        std::string resourceDescription;
-        double  resourceDuration;
-        Sem::ContainFlank resourceFlank;
-        double  resourceHourCost;
-        double  resourceProduction;
-
-        Sem::ContainForce oldForce;
-        Sem::ContainForce* oldForcePointer = &oldForce;
-        for (int i = 0; i < force_.resourceVector.size(); i++)
+        if (!hourlySpreadRates_.empty())
         {
-            resourceArrival = force_.resourceVector[i].arrival();
-            resourceBaseCost = force_.resourceVector[i].baseCost();
-            resourceDescription = force_.resourceVector[i].description();
-            resourceDuration = force_.resourceVector[i].duration();
-            resourceFlank = force_.resourceVector[i].flank();
-            resourceHourCost = force_.resourceVector[i].hourCost();
-            resourceProduction = force_.resourceVector[i].production();
-
-            char* const desc = (char* const)resourceDescription.c_str();
-            oldForcePointer->addResource(resourceArrival, resourceProduction, resourceDuration, resourceFlank,
-                desc, resourceBaseCost, resourceHourCost);
+            // Contain looks the rates up by hour of the day, the series starts at the fire start time's hour
+            int numberOfHours = (int)hourlySpreadRates_.size();
+            int startHour = ((fireStartTime_ / 60) % 24 + 24) % 24;
+            for (int hour = 0; hour < 24; hour++)
+            {
+                double spreadRate = hourlySpreadRates_[(hour < numberOfHours) ? hour : numberOfHours - 1];
+                diurnalROS_[(startHour + hour) % 24] = (spreadRate < 0.00001) ? 0.00001 : spreadRate;
+            }
         }
 
-        Sem::ContainSim containSim(reportSize_, reportRate_, diurnalROS_, fireStartTime_, lwRatio_,
-            oldForcePointer, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_,
-            maxFireTime_);
-
-        // Do Contain simulation
-        containSim.run();
-
-        // Store Values from ContainSim For Access in SIGContainAdapter
-        m_size       = containSim.firePoints();
-        m_x          = containSim.firePerimeterX();
-        m_y          = containSim.firePerimeterY();
-        m_reportHead = containSim.fireHeadAtReport();
-        m_reportBack = containSim.fireBackAtReport();
-        m_attackHead = containSim.fireHeadAtAttack();
-        m_attackBack = containSim.fireBackAtAttack();
-
-        // Get results from Contain simulation
-        finalCost_ = containSim.finalFireCost();
-        finalFireLineLength_ = LengthUnits::toBaseUnits(containSim.finalFireLine(), LengthUnits::Chains);
-        perimeterAtContainment_ = LengthUnits::toBaseUnits(containSim.finalFirePerimeter(), LengthUnits::Chains);
-        finalFireSize_ = AreaUnits::toBaseUnits(containSim.finalFireSize(), AreaUnits::Acres);
-        finalContainmentArea_ = AreaUnits::toBaseUnits(containSim.finalFireSweep(), AreaUnits::Acres);
-        finalTime_ = TimeUnits::toBaseUnits(containSim.finalFireTime(), TimeUnits::Minutes);
-        containmentStatus_ = convertSemStatusToAdapterStatus(containSim.status());
-        containmentStatus_ = static_cast<ContainStatus::ContainStatusEnum>(containSim.status());
+        // The simulation works straight from the adapter's resources
+        Sem::ContainForce* forcePointer = &workspace_.force;
+        forcePointer->viewResources(force_.resourceVector.data(), (int)force_.resourceVector.size());
+
+        if (workspace_.containSim)
+        {
+            workspace_.containSim->reset(reportSize_, reportRate_, diurnalROS_, fireStartTime_, lwRatio_,
+                forcePointer, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_,
+                maxFireTime_);
+        }
+        else
+        {
+            workspace_.containSim.reset(new Sem::ContainSim(reportSize_, reportRate_, diurnalROS_, fireStartTime_, lwRatio_,
+                forcePointer, tactic_, attackDistance_, retry_, minSteps_, maxSteps_, maxFireSize_,
+                maxFireTime_));
+        }
+        runWorkspaceSim();
 
         // Calculate effective windspeed needed for Size module
         // Find the effective windspeed
@@ -241,6 +306,54 @@ void ContainAdapter::doContainRun()
     }
 }
 
+void ContainAdapter::doContainRunWithAttack(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic,
+    double attackDistance, LengthUnits::LengthUnitsEnum lengthUnits)
+{
+    setTactic(tactic);
+    setAttackDistance(attackDistance, lengthUnits);
+    if (!workspace_.containSim)
+    {
+        doContainRun();
+        return;
+    }
+
+    // Start from the fire at first attack of the last run, only the attack point moves
+    workspace_.containSim->resetAttack(tactic_, attackDistance_);
+    runWorkspaceSim();
+}
+
+void ContainAdapter::runWorkspaceSim()
+{
+    Sem::ContainSim& containSim = *workspace_.containSim;
+    containSim.setIntegrator(integrator_, integratorTolerance_);
+    containSim.setOutputs(keepPerimeter_ ? Sem::ContainSim::PerimeterOutputs : Sem::ContainSim::SummaryOutputs);
+    containSim.setPerimeterCallback(perimeterCallback_);
+    containSim.setRunControl(runControl_);
+
+    // Do Contain simulation
+    containSim.run();
+
+    // Store Values from ContainSim For Access in SIGContainAdapter
+    m_size       = containSim.firePoints();
+    m_x          = containSim.firePerimeterX();
+    m_y          = containSim.firePerimeterY();
+    m_reportHead = containSim.fireHeadAtReport();
+    m_reportBack = containSim.fireBackAtReport();
+    m_attackHead = containSim.fireHeadAtAttack();
+    m_attackBack = containSim.fireBackAtAttack();
+
+    // Get results from Contain simulation
+    finalCost_ = containSim.finalFireCost();
+    finalFireLineLength_ = LengthUnits::toBaseUnits(containSim.finalFireLine(), LengthUnits::Chains);
+    perimeterAtContainment_ = LengthUnits::toBaseUnits(containSim.finalFirePerimeter(), LengthUnits::Chains);
+    finalFireSize_ = AreaUnits::toBaseUnits(containSim.finalFireSize(), AreaUnits::Acres);
+    finalContainmentArea_ = AreaUnits::toBaseUnits(containSim.finalFireSweep(), AreaUnits::Acres);
+    finalTime_ = TimeUnits::toBaseUnits(containSim.finalFireTime(), TimeUnits::Minutes);
+    containmentStatus_ = convertSemStatusToAdapterStatus(containSim.status());
+    containmentStatus_ = static_cast<ContainStatus::ContainStatusEnum>(containSim.status());
+    simulationSteps_ = containSim.simulationSteps();
+}
+
 double ContainAdapter::getFinalCost() const
 {
     return finalCost_;
@@ -286,6 +399,11 @@ ContainAdapterEnums::ContainStatus::ContainStatusEnum ContainAdapter::getContain
     return containmentStatus_;
 }
 
+int ContainAdapter::getNumberOfSimulationSteps() const
+{
+    return simulationSteps_;
+}
+
 Sem::Contain::ContainTactic ContainAdapter::convertAdapterTacticToSemTactic(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic)
 {
     return (Sem::Contain::ContainTactic)tactic;
@@ -36,7 +36,9 @@
 #include "behaveUnits.h"
 #include "fireSize.h"
 
+#include <memory>
 #include <string>
+#include <vector>
 
 //------------------------------------------------------------------------------
 /*! \enum ContainTactic
@@ -71,7 +73,8 @@ namespace ContainAdapterEnums
             Exhausted = 5,     //!< Fire escaped when all resources are exhausted
             Overflow = 6,     //!< Simulation max step overflow
             SizeLimitExceeded = 7,      //!< Simulation max fire size exceeded    
-            TimeLimitExceeded = 8	    //!< Simulation max fire time exceeded 
+            TimeLimitExceeded = 8,	    //!< Simulation max fire time exceeded 
+            Stopped = 9     //!< Simulation stopped by its RunControl
         };
     };
 
@@ -85,11 +88,46 @@ namespace ContainAdapterEnums
             NeitherFlank = 3    //!< Attack neither flank (inactive)
         };
     };
+
+    //------------------------------------------------------------------------------
+    /*! \enum ContainIntegrator
+    \brief Identifies how the simulation distance step is chosen.
+    */
+    struct ContainIntegrator
+    {
+        enum ContainIntegratorEnum
+        {
+            FixedStep = 0,      //!< Fixed distance step, the reference method
+            AdaptiveStep = 1    //!< Distance step adapted to an error tolerance
+        };
+    };
 }
 
 using std::string;
 using namespace ContainAdapterEnums;
 
+// Hourly fire behavior at the fire location from the hour of the fire start time on, in base units:
+// head fire spread rate in ft/min and length to width ratio, as BehaveRun::doTimeSeriesRun() fills
+// them in BehaveTimeSeriesOutputs. lengthToWidthRatio may be null to keep the adapter's own.
+struct ContainHourlyFire
+{
+    int numberOfHours;
+    const double* spreadRate;
+    const double* lengthToWidthRatio;
+};
+
+// Simulation objects kept between doContainRun() calls so repeated runs don't allocate.
+// A copy of an adapter starts with a workspace of its own rather than sharing one.
+struct ContainRunWorkspace
+{
+    ContainRunWorkspace();
+    ContainRunWorkspace(const ContainRunWorkspace& rhs);
+    ContainRunWorkspace& operator=(const ContainRunWorkspace& rhs);
+
+    Sem::ContainForce force; // views the adapter's resources during a run
+    std::unique_ptr<Sem::ContainSim> containSim; // created by the first run
+};
+
 class ContainAdapter
 {
 public:
@@ -111,11 +149,21 @@ public:
     int removeResourceWithThisDesc(string desc);
     int removeAllResourcesWithThisDesc(string desc);
     void removeAllResources();
+    int getNumberOfResources() const;
+    const Sem::ContainResource& getResourceAt(int index) const;
 
     void setReportSize(double reportSize, AreaUnits::AreaUnitsEnum areaUnits);
     void setReportRate(double reportRate, SpeedUnits::SpeedUnitsEnum speedUnits);
     void setFireStartTime(int fireStartTime);
     void setLwRatio(double lwRatio);
+    // Drives Contain's hourly spread rates with the fire's hourly head spread rates rather than the report
+    // rate for every hour. Contain keeps one rate for each hour of the day, looked up from the fire start
+    // time, so only the first 24 hours are used and a shorter series keeps its last rate for the rest of
+    // the day. The first hour also gives the report rate and, unless it is null, the length to width ratio,
+    // as Contain holds the fire's shape at report. Later setReportRate() and setLwRatio() calls still
+    // override those two, and clearHourlyFire() goes back to the report rate for every hour
+    void setHourlyFire(const ContainHourlyFire& hourlyFire);
+    void clearHourlyFire();
     void setTactic(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic);
     void setAttackDistance(double attackDistance, LengthUnits::LengthUnitsEnum lengthUnits);
     void setRetry(bool retry);
@@ -123,8 +171,21 @@ public:
     void setMaxSteps(int maxSteps);
     void setMaxFireSize(int maxFireSize);
     void setMaxFireTime(int maxFireTime);
+    // AdaptiveStep tolerance is on the attack point angle per step (radians)
+    void setIntegrator(ContainAdapterEnums::ContainIntegrator::ContainIntegratorEnum integrator, double tolerance = 1.0e-6);
+    // Runs that only need the final outputs can skip keeping the perimeter arrays
+    void setKeepPerimeter(bool keepPerimeter);
+    // Receives each perimeter point (ch) as it is produced, see Sem::ContainPerimeterCallback
+    void setPerimeterCallback(Sem::ContainPerimeterCallback perimeterCallback);
+    // Token polled every simulation step of doContainRun(), null for none
+    void setRunControl(RunControl* runControl);
 
     void doContainRun();
+    // Runs again with another tactic and attack distance, starting from the fire growth up
+    // to the first attack of the last doContainRun() rather than working it out again. Every
+    // other input must be as it was for that run, a copy that hasn't run yet does a full run
+    void doContainRunWithAttack(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic,
+        double attackDistance, LengthUnits::LengthUnitsEnum lengthUnits);
 
     double getFinalCost() const;
     double getFinalFireLineLength(LengthUnits::LengthUnitsEnum lengthUnits) const;
@@ -135,6 +196,7 @@ public:
     double getFinalContainmentArea(AreaUnits::AreaUnitsEnum areaUnits) const;
     double getFinalTimeSinceReport(TimeUnits::TimeUnitsEnum timeUnits) const;
     ContainStatus::ContainStatusEnum getContainmentStatus() const;
+    int getNumberOfSimulationSteps() const;
 
 protected:
     FireSize size_; 
@@ -142,11 +204,14 @@ protected:
     Sem::Contain::ContainTactic convertAdapterTacticToSemTactic(ContainAdapterEnums::ContainTactic::ContainTacticEnum tactic);
     ContainAdapterEnums::ContainStatus::ContainStatusEnum convertSemStatusToAdapterStatus(Sem::Contain::ContainStatus status);
     Sem::ContainFlank converAdapterFlankToSemFlank(ContainAdapterEnums::ContainFlank::ContainFlankEnum flank);
+    // Runs the workspace's ContainSim as set up and stores its outputs
+    void runWorkspaceSim();
 
     // Contain Inputs
     double reportSize_;
     double reportRate_;
     double diurnalROS_[24];
+    std::vector<double> hourlySpreadRates_; // ch/h from the hour of the fire start time, empty for none
     int fireStartTime_;
     double lwRatio_;
     ContainForceAdapter force_;
@@ -157,6 +222,13 @@ protected:
     int maxSteps_;
     int maxFireSize_;
     int maxFireTime_;
+    Sem::Contain::ContainIntegrator integrator_;
+    double integratorTolerance_;
+    bool keepPerimeter_;
+    Sem::ContainPerimeterCallback perimeterCallback_;
+    RunControl* runControl_;
+
+    ContainRunWorkspace workspace_;
 
     // Contain Outputs
     double finalCost_; // Final total cost of all resources used
@@ -168,6 +240,7 @@ protected:
     double finalContainmentArea_; // Final containment area at containment or escape
     double finalTime_; // Containment or escape time since report
     ContainAdapterEnums::ContainStatus::ContainStatusEnum containmentStatus_;
+    int simulationSteps_; // Steps taken by the final simulation pass
 
     // ContainSim Outputs
     double* m_x;          //!< Array of perimeter x coordinates (ch)
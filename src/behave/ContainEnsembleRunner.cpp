@@ -0,0 +1,154 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Runs containment for every pairing of weather ensemble members
+*           and resource plans in parallel from hourly fire behavior
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "ContainEnsembleRunner.h"
+
+#include <algorithm>
+
+#include "threadPool.h"
+
+ContainEnsembleRunner::ContainEnsembleRunner(const ContainAdapter& prototype)
+    : prototype_(prototype),
+    numberOfThreads_(0)
+{
+
+}
+
+void ContainEnsembleRunner::addMember(const ContainHourlyFire& hourlyFire)
+{
+    Member member;
+    int numberOfHours = (hourlyFire.numberOfHours > 0) ? hourlyFire.numberOfHours : 0;
+    if(hourlyFire.spreadRate)
+    {
+        member.spreadRate.assign(hourlyFire.spreadRate, hourlyFire.spreadRate + numberOfHours);
+    }
+    if(hourlyFire.lengthToWidthRatio)
+    {
+        member.lengthToWidthRatio.assign(hourlyFire.lengthToWidthRatio, hourlyFire.lengthToWidthRatio + numberOfHours);
+    }
+    members_.push_back(member);
+}
+
+void ContainEnsembleRunner::addResourcePlan(const std::vector<Sem::ContainResource>& resources)
+{
+    plans_.push_back(resources);
+}
+
+void ContainEnsembleRunner::clearMembers()
+{
+    members_.clear();
+}
+
+void ContainEnsembleRunner::clearResourcePlans()
+{
+    plans_.clear();
+}
+
+void ContainEnsembleRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+const std::vector<ContainEnsembleResult>& ContainEnsembleRunner::getResults() const
+{
+    return results_;
+}
+
+double ContainEnsembleRunner::getFractionContained(int plan) const
+{
+    int numberOfRuns = 0;
+    int numberOfContained = 0;
+    for(const ContainEnsembleResult& result : results_)
+    {
+        if(result.plan == plan)
+        {
+            numberOfRuns++;
+            numberOfContained += (result.status == ContainStatus::Contained);
+        }
+    }
+    return (numberOfRuns > 0) ? (double)numberOfContained / numberOfRuns : 0.0;
+}
+
+void ContainEnsembleRunner::run()
+{
+    results_.clear();
+    for(int member = 0; member < (int)members_.size(); member++)
+    {
+        for(int plan = 0; plan < (int)plans_.size(); plan++)
+        {
+            ContainEnsembleResult result;
+            result.member = member;
+            result.plan = plan;
+            results_.push_back(result);
+        }
+    }
+    if(results_.empty())
+    {
+        return;
+    }
+
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots(std::min((numberOfThreads_ > 0) ? numberOfThreads_ : (int)results_.size(),
+        (int)results_.size()));
+    std::vector<ContainAdapter> workers(numberOfSlots, prototype_);
+    for(ContainAdapter& worker : workers)
+    {
+        // Only the final outputs are compared, so skip the perimeter
+        worker.setKeepPerimeter(false);
+        worker.setPerimeterCallback(Sem::ContainPerimeterCallback());
+    }
+
+    threadPool->runChunks((long)results_.size(), 1, [&](int slot, long begin, long end)
+    {
+        ContainAdapter& worker = workers[slot];
+        for(long i = begin; i < end; i++)
+        {
+            ContainEnsembleResult& result = results_[i];
+            const Member& member = members_[result.member];
+            ContainHourlyFire hourlyFire;
+            hourlyFire.numberOfHours = (int)member.spreadRate.size();
+            hourlyFire.spreadRate = member.spreadRate.data();
+            hourlyFire.lengthToWidthRatio = member.lengthToWidthRatio.empty() ? nullptr : member.lengthToWidthRatio.data();
+            worker.setHourlyFire(hourlyFire);
+
+            worker.removeAllResources();
+            for(Sem::ContainResource resource : plans_[result.plan])
+            {
+                worker.addResource(resource);
+            }
+            worker.doContainRun();
+
+            result.status = worker.getContainmentStatus();
+            result.finalCost = worker.getFinalCost();
+            result.finalFireLineLength = worker.getFinalFireLineLength(LengthUnits::Feet);
+            result.finalFireSize = worker.getFinalFireSize(AreaUnits::SquareFeet);
+            result.finalTime = worker.getFinalTimeSinceReport(TimeUnits::Minutes);
+            result.numberOfSimulationSteps = worker.getNumberOfSimulationSteps();
+        }
+    }, numberOfSlots);
+}
@@ -0,0 +1,89 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Runs containment for every pairing of weather ensemble members
+*           and resource plans in parallel from hourly fire behavior
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef CONTAINENSEMBLERUNNER_H
+#define CONTAINENSEMBLERUNNER_H
+
+#include <vector>
+
+#include "ContainAdapter.h"
+
+// Outcome of one containment run for a weather ensemble member and a resource plan, in base units
+struct ContainEnsembleResult
+{
+    int member;
+    int plan;
+    ContainStatus::ContainStatusEnum status;
+    double finalCost;
+    double finalFireLineLength; // feet
+    double finalFireSize;       // square feet
+    double finalTime;           // minutes since report
+    int numberOfSimulationSteps;
+};
+
+// Runs the prototype's Contain inputs for every pairing of the added weather ensemble members, each
+// the hourly fire behavior of one member at the fire location as ContainAdapter::setHourlyFire() takes
+// it, and the added resource plans, each replacing the prototype's resources. The runs are independent
+// and are shared out over a ThreadPool, each worker running its own copy of the prototype.
+class ContainEnsembleRunner
+{
+public:
+    explicit ContainEnsembleRunner(const ContainAdapter& prototype);
+
+    // The hourly values are copied
+    void addMember(const ContainHourlyFire& hourlyFire);
+    void addResourcePlan(const std::vector<Sem::ContainResource>& resources);
+    void clearMembers();
+    void clearResourcePlans();
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+
+    void run();
+
+    // One result per member and plan, members in the order added and the plans of each member in the
+    // order added
+    const std::vector<ContainEnsembleResult>& getResults() const;
+    // Fraction of the members the plan contains
+    double getFractionContained(int plan) const;
+
+protected:
+    struct Member
+    {
+        std::vector<double> spreadRate;
+        std::vector<double> lengthToWidthRatio; // empty when the member has none
+    };
+
+    ContainAdapter prototype_;
+    std::vector<Member> members_;
+    std::vector<std::vector<Sem::ContainResource>> plans_;
+    int numberOfThreads_;
+
+    std::vector<ContainEnsembleResult> results_;
+};
+
+#endif // CONTAINENSEMBLERUNNER_H
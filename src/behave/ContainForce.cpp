@@ -8,6 +8,7 @@
 // Local include files
 #include "ContainSim.h"         // for checkmem()
 #include "ContainForce.h"
+#include <algorithm>
 #include <math.h>
 
 /* Silence warnings that aren't our fault */
@@ -33,8 +34,13 @@
 Sem::ContainForce::ContainForce( int maxResources ) :
     m_cr(0),
     m_size(maxResources),
-    m_count(0)
+    m_count(0),
+    m_ownsResources(true)
 {
+    for ( int flank=0; flank<4; flank++ )
+    {
+        m_schedule[flank].m_valid = false;
+    }
     // Allocate ContainResource pointer array.
     m_cr = new ContainResource *[m_size];
     ContainSim::checkmem( __FILE__, __LINE__, m_cr, "ContainResource", m_size );
@@ -47,9 +53,12 @@ Sem::ContainForce::ContainForce( int maxResources ) :
 
 Sem::ContainForce::~ContainForce( void )
 {
-    for ( int i=0; i<m_count; i++ )
+    if ( m_ownsResources )
     {
-        delete m_cr[i];  m_cr[i] = 0;
+        for ( int i=0; i<m_count; i++ )
+        {
+            delete m_cr[i];  m_cr[i] = 0;
+        }
     }
     delete[] m_cr;      m_cr = 0;
     return;
@@ -123,19 +132,35 @@ double Sem::ContainForce::nextArrival( double after, double until,
         ContainFlank flank ) const
 {
     // Get the production rate at the requested time
-    double prodRate = productionRate( after, flank );
+    const ProductionSchedule& schedule = productionSchedule( flank );
+    double prodRate = scheduledProductionRate( schedule, after );
     // Look for next production boost starting at the next minute
     int it = (int) after;
     after = (double) it + 1.;
     while ( after < until )
     {
         // Check production rate at the next minute
-        if ( fabs(( productionRate( after, flank ) - prodRate )) > 0.001 )
+        if ( fabs(( scheduledProductionRate( schedule, after ) - prodRate )) > 0.001 )
         {
             return( after );
         }
-		// Try the next minute
-        after += 1.;
+        // Between scheduled changes the rate is constant, so skip straight
+        // to the first minute at or after the next change
+        std::vector<double>::const_iterator next = std::upper_bound(
+            schedule.m_times.begin(), schedule.m_times.end(), after );
+        if ( next != schedule.m_times.begin() && *( next - 1 ) == after )
+        {
+            // This minute is itself a change, the rate just after may differ
+            after += 1.;
+        }
+        else if ( next == schedule.m_times.end() )
+        {
+            break;
+        }
+        else
+        {
+            after = std::max( after + 1., ceil( *next ) );
+        }
     }
     // No more productivity boosts after this time
     return( 0.0 );
@@ -152,6 +177,12 @@ double Sem::ContainForce::nextArrival( double after, double until,
 Sem::ContainResource *Sem::ContainForce::addResource(
         Sem::ContainResource* resource )
 {
+    // Adding a resource ends any view, the viewed resources are not ours
+    if ( ! m_ownsResources )
+    {
+        m_count = 0;
+        m_ownsResources = true;
+    }
 	#define EXTRA_ALLOCATION 100
     // Check for vector space 
     if ( m_count >= m_size )
@@ -173,9 +204,53 @@ Sem::ContainResource *Sem::ContainForce::addResource(
     }
     // Add the new record to the vector and return.
     m_cr[m_count++] = resource;
+    for ( int flank=0; flank<4; flank++ )
+    {
+        m_schedule[flank].m_valid = false;
+    }
     return( resource );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Makes the ContainForce a view of an existing array of
+    ContainResources, replacing any resources it held.  The resources are
+    neither copied nor deleted by the ContainForce, so the array must outlive
+    its use.  Repeated views only reallocate the pointer array if it must grow.
+
+    \param[in] resources Array of ContainResources.
+    \param[in] count     Number of ContainResources in the array.
+ */
+
+void Sem::ContainForce::viewResources( Sem::ContainResource* resources,
+        int count )
+{
+    if ( m_ownsResources )
+    {
+        for ( int i=0; i<m_count; i++ )
+        {
+            delete m_cr[i];  m_cr[i] = 0;
+        }
+    }
+    if ( count > m_size )
+    {
+        delete[] m_cr;
+        m_size = count;
+        m_cr = new ContainResource *[m_size];
+        ContainSim::checkmem( __FILE__, __LINE__, m_cr, "ContainResource", m_size );
+    }
+    for ( int i=0; i<count; i++ )
+    {
+        m_cr[i] = &resources[i];
+    }
+    m_count = count;
+    m_ownsResources = false;
+    for ( int flank=0; flank<4; flank++ )
+    {
+        m_schedule[flank].m_valid = false;
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Adds a new ContainResource to the ContainForce.
   
@@ -226,6 +301,23 @@ Sem::ContainResource *Sem::ContainForce::addResource(
 
 double Sem::ContainForce::productionRate( double minSinceReport,
     Sem::ContainFlank flank ) const
+{
+    return( scheduledProductionRate( productionSchedule( flank ), minSinceReport ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sums the fireline production rate along one fire flank at the
+    specified time over every resource.  This is the reference calculation
+    used to build the ProductionSchedule.
+
+    \param[in] minSinceReport Minutes since the fire was reported.
+    \param[in] flank One of LeftFlank or RightFlank.
+
+    \return Aggregate containment force fireline production rate (ch/h).
+ */
+
+double Sem::ContainForce::sumProductionRate( double minSinceReport,
+    Sem::ContainFlank flank ) const
 {
     double fpm = 0.0;
     for ( int i=0; i<m_count; i++ )
@@ -240,6 +332,84 @@ double Sem::ContainForce::productionRate( double minSinceReport,
     return( fpm );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Access to the production schedule for one flank, building it the
+    first time it is needed after resources are added.
+
+    Each resource only changes the production rate when it arrives and when
+    its duration ends, so the rate is constant between those times.  The
+    schedule stores the rate at each of those times and over the interval up
+    to the next one, so Contain's many productionRate() calls per step are a
+    binary search instead of a loop over every resource.
+
+    \param[in] flank One of LeftFlank, RightFlank, BothFlanks or NeitherFlank.
+
+    \return Reference to the flank's schedule.
+ */
+
+const Sem::ContainForce::ProductionSchedule&
+    Sem::ContainForce::productionSchedule( Sem::ContainFlank flank ) const
+{
+    ProductionSchedule& schedule = m_schedule[flank];
+    if ( schedule.m_valid )
+    {
+        return( schedule );
+    }
+
+    schedule.m_times.clear();
+    for ( int i=0; i<m_count; i++ )
+    {
+        if ( m_cr[i]->m_flank == flank || m_cr[i]->m_flank == BothFlanks )
+        {
+            schedule.m_times.push_back( m_cr[i]->m_arrival - 0.001 );
+            schedule.m_times.push_back( m_cr[i]->m_arrival + m_cr[i]->m_duration );
+        }
+    }
+    std::sort( schedule.m_times.begin(), schedule.m_times.end() );
+    schedule.m_times.erase( std::unique( schedule.m_times.begin(),
+        schedule.m_times.end() ), schedule.m_times.end() );
+
+    // Sample the reference sum at each change and between changes, so the
+    // schedule returns exactly what the resource loop would
+    size_t n = schedule.m_times.size();
+    schedule.m_rateAt.resize( n );
+    schedule.m_rateAfter.resize( n );
+    for ( size_t k=0; k<n; k++ )
+    {
+        double at = schedule.m_times[k];
+        schedule.m_rateAt[k] = sumProductionRate( at, flank );
+        schedule.m_rateAfter[k] = ( k+1 < n )
+            ? sumProductionRate( 0.5 * ( at + schedule.m_times[k+1] ), flank )
+            : 0.0;
+    }
+    schedule.m_valid = true;
+    return( schedule );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Looks up the production rate at the specified time in a schedule.
+
+    \param[in] schedule Schedule from productionSchedule().
+    \param[in] minSinceReport Minutes since the fire was reported.
+
+    \return Aggregate containment force fireline production rate (ch/h).
+ */
+
+double Sem::ContainForce::scheduledProductionRate(
+    const ProductionSchedule& schedule, double minSinceReport ) const
+{
+    std::vector<double>::const_iterator next = std::upper_bound(
+        schedule.m_times.begin(), schedule.m_times.end(), minSinceReport );
+    if ( next == schedule.m_times.begin() )
+    {
+        // Before the first arrival
+        return( 0.0 );
+    }
+    size_t k = ( next - schedule.m_times.begin() ) - 1;
+    return( ( schedule.m_times[k] == minSinceReport )
+        ? schedule.m_rateAt[k] : schedule.m_rateAfter[k] );
+}
+
 //------------------------------------------------------------------------------
 /*! \brief API access to the number of ContainResources in the
     containment force.
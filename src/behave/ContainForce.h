@@ -12,6 +12,7 @@
 #include "Contain.h"
 #include "ContainResource.h"
 #include <cstring>
+#include <vector>
 
 namespace Sem
 {
@@ -43,10 +44,13 @@ public:
         double production,
         double duration=480.,
         Sem::ContainFlank flank=Sem::LeftFlank,
-        char * const desc="",
+        char * const desc=(char *) "",
         double baseCost=0.0,
         double hourCost=0.0 );
 
+    // Use an existing array of resources without copying or owning them
+    void viewResources( ContainResource* resources, int count ) ;
+
     // Force-level access methods
     double exhausted( Sem::ContainFlank flank ) const ;
     double firstArrival( Sem::ContainFlank flank ) const ;
@@ -67,11 +71,28 @@ public:
     double  resourceHourCost( int index ) const ;
     double  resourceProduction( int index ) const ;
 
+// Protected methods
+protected:
+    //! Piecewise-constant production rate on one flank, rebuilt after resources change
+    struct ProductionSchedule
+    {
+        bool m_valid;                    //!< False until built for the current resources
+        std::vector<double> m_times;     //!< Sorted times at which the rate may change
+        std::vector<double> m_rateAt;    //!< Production rate at each time in m_times
+        std::vector<double> m_rateAfter; //!< Production rate from each time to the next
+    };
+    const ProductionSchedule& productionSchedule( Sem::ContainFlank flank ) const ;
+    double scheduledProductionRate( const ProductionSchedule& schedule,
+        double minutesSinceReport ) const ;
+    double sumProductionRate( double minutesSinceReport, Sem::ContainFlank flank ) const ;
+
 // Protected data
 protected:
     ContainResource **m_cr;     //!< Array of pointers to ContainResources
     int     m_size;             //!< Size of m_cr
     int     m_count;            //!< Items in m_cr
+    bool    m_ownsResources;    //!< False when m_cr points into a viewed array
+    mutable ProductionSchedule m_schedule[4];   //!< Built on demand for each ContainFlank
 
 friend class Contain;
 };
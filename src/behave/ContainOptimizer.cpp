@@ -0,0 +1,321 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Evaluates containment scenarios over subsets of candidate
+*           resources in parallel and finds the cost versus size trade-off
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "ContainOptimizer.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "threadPool.h"
+
+namespace
+{
+    int countResources(unsigned long resourceMask)
+    {
+        int count = 0;
+        for(; resourceMask != 0; resourceMask &= resourceMask - 1)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    bool dominatesResource(const Sem::ContainResource& a, const Sem::ContainResource& b)
+    {
+        bool isSameSchedule = a.arrival() == b.arrival() && a.duration() == b.duration();
+        return a.flank() == b.flank() &&
+            a.arrival() <= b.arrival() &&
+            a.arrival() + a.duration() >= b.arrival() + b.duration() &&
+            a.production() >= b.production() &&
+            a.baseCost() <= b.baseCost() &&
+            a.hourCost() <= b.hourCost() &&
+            (a.hourCost() == 0.0 || isSameSchedule);
+    }
+
+    bool isSameResource(const Sem::ContainResource& a, const Sem::ContainResource& b)
+    {
+        return a.flank() == b.flank() && a.arrival() == b.arrival() && a.duration() == b.duration() &&
+            a.production() == b.production() && a.baseCost() == b.baseCost() && a.hourCost() == b.hourCost();
+    }
+}
+
+ContainOptimizer::ContainOptimizer(const ContainAdapter& prototype)
+    : prototype_(prototype),
+    useHeadAttack_(true),
+    useRearAttack_(true),
+    pruneDominatedResources_(true),
+    numberOfThreads_(0),
+    numberOfContainRuns_(0),
+    numberOfReusedResults_(0),
+    numberOfDominatedSubsets_(0)
+{
+    for(int i = 0; i < prototype.getNumberOfResources(); i++)
+    {
+        candidates_.push_back(prototype.getResourceAt(i));
+    }
+
+    dominatorMasks_.assign(candidates_.size(), 0);
+    for(size_t b = 0; b < candidates_.size() && b < maxNumberOfCandidates; b++)
+    {
+        for(size_t a = 0; a < candidates_.size() && a < maxNumberOfCandidates; a++)
+        {
+            // Of two identical resources only the first dominates, so one of them is kept
+            bool isDominator = (a != b) && dominatesResource(candidates_[a], candidates_[b]) &&
+                (!isSameResource(candidates_[a], candidates_[b]) || a < b);
+            if(isDominator)
+            {
+                dominatorMasks_[b] |= 1UL << a;
+            }
+        }
+    }
+}
+
+void ContainOptimizer::setTactics(bool useHeadAttack, bool useRearAttack)
+{
+    useHeadAttack_ = useHeadAttack;
+    useRearAttack_ = useRearAttack;
+}
+
+void ContainOptimizer::setPruneDominatedResources(bool pruneDominatedResources)
+{
+    pruneDominatedResources_ = pruneDominatedResources;
+}
+
+void ContainOptimizer::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+const std::vector<ContainScenarioResult>& ContainOptimizer::getResults() const
+{
+    return results_;
+}
+
+int ContainOptimizer::getNumberOfContainRuns() const
+{
+    return numberOfContainRuns_;
+}
+
+int ContainOptimizer::getNumberOfReusedResults() const
+{
+    return numberOfReusedResults_;
+}
+
+int ContainOptimizer::getNumberOfDominatedSubsets() const
+{
+    return numberOfDominatedSubsets_;
+}
+
+bool ContainOptimizer::run()
+{
+    results_.clear();
+    numberOfContainRuns_ = 0;
+    numberOfReusedResults_ = 0;
+    numberOfDominatedSubsets_ = 0;
+
+    const int numberOfCandidates = (int)candidates_.size();
+    if(numberOfCandidates > maxNumberOfCandidates)
+    {
+        return false;
+    }
+    const unsigned long numberOfSubsets = 1UL << numberOfCandidates;
+
+    std::vector<ContainTactic::ContainTacticEnum> tactics;
+    if(useHeadAttack_)
+    {
+        tactics.push_back(ContainTactic::HeadAttack);
+    }
+    if(useRearAttack_)
+    {
+        tactics.push_back(ContainTactic::RearAttack);
+    }
+
+    // Group the subsets by size, a subset's result can only be reused from a smaller one
+    std::vector<std::vector<unsigned long>> subsetsBySize(numberOfCandidates + 1);
+    for(unsigned long resourceMask = 1; resourceMask < numberOfSubsets; resourceMask++)
+    {
+        subsetsBySize[countResources(resourceMask)].push_back(resourceMask);
+    }
+
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots(numberOfThreads_);
+    std::vector<ContainAdapter> workers(numberOfSlots, prototype_);
+    for(ContainAdapter& worker : workers)
+    {
+        // Only the final outputs are compared, so skip the perimeter
+        worker.setKeepPerimeter(false);
+        worker.setPerimeterCallback(Sem::ContainPerimeterCallback());
+    }
+
+    for(ContainTactic::ContainTacticEnum tactic : tactics)
+    {
+        std::vector<int> resultIndexByMask(numberOfSubsets, -1);
+        for(int size = 1; size <= numberOfCandidates; size++)
+        {
+            std::vector<ContainScenarioResult> scenarios;
+            for(unsigned long resourceMask : subsetsBySize[size])
+            {
+                if(pruneDominatedResources_ && isDominated(resourceMask))
+                {
+                    numberOfDominatedSubsets_++;
+                    continue;
+                }
+                ContainScenarioResult result;
+                if(findReusableResult(resultIndexByMask, resourceMask, result))
+                {
+                    result.resourceMask = resourceMask;
+                    resultIndexByMask[resourceMask] = (int)results_.size();
+                    results_.push_back(result);
+                    numberOfReusedResults_++;
+                    continue;
+                }
+                result.resourceMask = resourceMask;
+                result.tactic = tactic;
+                scenarios.push_back(result);
+            }
+
+            threadPool->runChunks((long)scenarios.size(), 1, [&](int slot, long begin, long end)
+            {
+                for(long i = begin; i < end; i++)
+                {
+                    runScenario(workers[slot], scenarios[i]);
+                }
+            }, numberOfSlots);
+
+            numberOfContainRuns_ += (int)scenarios.size();
+            for(const ContainScenarioResult& result : scenarios)
+            {
+                resultIndexByMask[result.resourceMask] = (int)results_.size();
+                results_.push_back(result);
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<ContainScenarioResult> ContainOptimizer::getParetoFront(ContainParetoObjective::ContainParetoObjectiveEnum objective) const
+{
+    auto objectiveValue = [objective](const ContainScenarioResult& result)
+    {
+        return (objective == ContainParetoObjective::FinalTime) ? result.finalTime : result.finalFireSize;
+    };
+
+    std::vector<ContainScenarioResult> contained;
+    for(const ContainScenarioResult& result : results_)
+    {
+        if(result.status == ContainStatus::Contained)
+        {
+            contained.push_back(result);
+        }
+    }
+    std::sort(contained.begin(), contained.end(), [&objectiveValue](const ContainScenarioResult& lhs, const ContainScenarioResult& rhs)
+    {
+        if(lhs.finalCost != rhs.finalCost)
+        {
+            return lhs.finalCost < rhs.finalCost;
+        }
+        return objectiveValue(lhs) < objectiveValue(rhs);
+    });
+
+    // Walking up in cost, a result is on the front if it beats everything cheaper on the objective
+    std::vector<ContainScenarioResult> front;
+    for(const ContainScenarioResult& result : contained)
+    {
+        if(front.empty() || objectiveValue(result) < objectiveValue(front.back()))
+        {
+            front.push_back(result);
+        }
+    }
+    return front;
+}
+
+bool ContainOptimizer::getCheapestContained(ContainScenarioResult& result) const
+{
+    std::vector<ContainScenarioResult> front = getParetoFront(ContainParetoObjective::FinalFireSize);
+    if(front.empty())
+    {
+        return false;
+    }
+    result = front.front();
+    return true;
+}
+
+bool ContainOptimizer::isDominated(unsigned long resourceMask) const
+{
+    for(size_t b = 0; b < candidates_.size(); b++)
+    {
+        if((resourceMask & (1UL << b)) && (dominatorMasks_[b] & ~resourceMask))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ContainOptimizer::findReusableResult(const std::vector<int>& resultIndexByMask, unsigned long resourceMask,
+    ContainScenarioResult& result) const
+{
+    // Resources that only arrive once the rest have contained the fire change nothing,
+    // they are neither used nor charged for
+    for(size_t r = 0; r < candidates_.size(); r++)
+    {
+        unsigned long resourceBit = 1UL << r;
+        unsigned long smallerMask = resourceMask & ~resourceBit;
+        if(!(resourceMask & resourceBit) || smallerMask == 0 || resultIndexByMask[smallerMask] < 0)
+        {
+            continue;
+        }
+        const ContainScenarioResult& smallerResult = results_[resultIndexByMask[smallerMask]];
+        if(smallerResult.status == ContainStatus::Contained && candidates_[r].arrival() >= smallerResult.finalTime)
+        {
+            result = smallerResult;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ContainOptimizer::runScenario(ContainAdapter& worker, ContainScenarioResult& result) const
+{
+    worker.removeAllResources();
+    for(size_t i = 0; i < candidates_.size(); i++)
+    {
+        if(result.resourceMask & (1UL << i))
+        {
+            Sem::ContainResource resource = candidates_[i];
+            worker.addResource(resource);
+        }
+    }
+    worker.setTactic(result.tactic);
+    worker.doContainRun();
+
+    result.status = worker.getContainmentStatus();
+    result.finalCost = worker.getFinalCost();
+    result.finalFireSize = worker.getFinalFireSize(AreaUnits::SquareFeet);
+    result.finalTime = worker.getFinalTimeSinceReport(TimeUnits::Minutes);
+}
@@ -0,0 +1,115 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Evaluates containment scenarios over subsets of candidate
+*           resources in parallel and finds the cost versus size trade-off
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef CONTAINOPTIMIZER_H
+#define CONTAINOPTIMIZER_H
+
+#include <vector>
+
+#include "ContainAdapter.h"
+
+// Outcome of one containment run on a subset of the candidate resources, in base units
+struct ContainScenarioResult
+{
+    unsigned long resourceMask; // bit i set when candidate resource i is dispatched
+    ContainTactic::ContainTacticEnum tactic;
+    ContainStatus::ContainStatusEnum status;
+    double finalCost;
+    double finalFireSize;       // square feet
+    double finalTime;           // minutes since report
+};
+
+struct ContainParetoObjective
+{
+    enum ContainParetoObjectiveEnum
+    {
+        FinalFireSize,
+        FinalTime
+    };
+};
+
+// Runs ContainAdapter::doContainRun() for every subset of the prototype's resources,
+// for each enabled tactic, to find the resource mixes that contain the fire. All other
+// Contain inputs come from the prototype. Subsets of the same size are independent and
+// are shared out over a ThreadPool, each worker running its own copy of the prototype.
+//
+// Two kinds of subsets are not run:
+// - A subset holding resource b but not a resource a that arrives no later, produces at
+//   least as much until at least as late and costs no more is dominated, since swapping b
+//   for a can only contain the fire sooner for less. So that a's hours can't cost more,
+//   a must have no hourly cost or the same arrival and duration as b. This assumes more
+//   production never makes Contain's result worse, and can be turned off.
+// - A subset that is a contained subset plus resources that arrive after it was
+//   contained has the same outcome, so that result is reused.
+class ContainOptimizer
+{
+public:
+    static const int maxNumberOfCandidates = 16;
+
+    explicit ContainOptimizer(const ContainAdapter& prototype);
+
+    void setTactics(bool useHeadAttack, bool useRearAttack);
+    void setPruneDominatedResources(bool pruneDominatedResources);
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+
+    // Returns false, without running, if the prototype has more than maxNumberOfCandidates resources
+    bool run();
+
+    // Results for every subset that was run or had its result reused, by subset size
+    const std::vector<ContainScenarioResult>& getResults() const;
+    // Contained results that no other contained result beats on both cost and the objective,
+    // in order of increasing cost
+    std::vector<ContainScenarioResult> getParetoFront(ContainParetoObjective::ContainParetoObjectiveEnum objective) const;
+    bool getCheapestContained(ContainScenarioResult& result) const;
+
+    int getNumberOfContainRuns() const;
+    int getNumberOfReusedResults() const;
+    int getNumberOfDominatedSubsets() const;
+
+protected:
+    bool isDominated(unsigned long resourceMask) const;
+    bool findReusableResult(const std::vector<int>& resultIndexByMask, unsigned long resourceMask,
+        ContainScenarioResult& result) const;
+    void runScenario(ContainAdapter& worker, ContainScenarioResult& result) const;
+
+    ContainAdapter prototype_;
+    std::vector<Sem::ContainResource> candidates_;
+    std::vector<unsigned long> dominatorMasks_; // candidates that dominate each candidate
+    bool useHeadAttack_;
+    bool useRearAttack_;
+    bool pruneDominatedResources_;
+    int numberOfThreads_;
+
+    std::vector<ContainScenarioResult> results_;
+    int numberOfContainRuns_;
+    int numberOfReusedResults_;
+    int numberOfDominatedSubsets_;
+};
+
+#endif // CONTAINOPTIMIZER_H
@@ -61,7 +61,7 @@ public:
         double production,
         double duration=480.,
         Sem::ContainFlank flank=Sem::LeftFlank,
-        char * const desc="",
+        char * const desc=(char *) "",
         double baseCost=0.00,
         double hourCost=0.00 );
     // Virtual destructor
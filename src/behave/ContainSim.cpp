@@ -24,6 +24,8 @@
 // Local include files
 #include <iostream>
 #include "ContainSim.h"
+#include "instrumentation.h"
+#include "runControl.h"
 //include "Logger.h"
 
 // Standard include files
@@ -75,6 +77,7 @@ Sem::ContainSim::ContainSim(
         int maxFireSize , 
         int maxFireTime) :
     m_finalCost(0.),
+    m_finalLine(0.),
     m_finalPerim(0.),
     m_finalSize(0.),
     m_finalSweep(0.),
@@ -90,6 +93,7 @@ Sem::ContainSim::ContainSim(
     m_p(0),
     m_left(0),
     m_right(0),
+    m_preAttack(0),
     m_force(force),
     m_minSteps(minSteps),
     m_maxSteps(maxSteps),
@@ -98,7 +102,116 @@ Sem::ContainSim::ContainSim(
     m_used(0),
     m_retry(retry),
     m_maxFireSize(maxFireSize),
-    m_maxFireTime(maxFireTime)
+    m_maxFireTime(maxFireTime),
+    m_capacity(0),
+    m_integrator(Sem::Contain::FixedStep),
+    m_tolerance(1.e-6),
+    m_analyticSteps(true),
+    m_outputs(PerimeterOutputs),
+    m_perimeterCallback(),
+    m_runControl(0)
+{
+    initialize( reportSize, reportRate, diurnalROS, fireStartMinutesStartTime,
+        lwRatio, tactic, attackDist );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Resets the ContainSim for another run with new inputs, as if it had
+    been newly constructed, but reusing the left flank Contain object and the
+    simulation arrays.  The arrays are only reallocated if \a maxSteps needs
+    more room than any previous run, so repeated runs do not allocate.
+
+    The arguments are the same as the constructor's.
+ */
+
+void Sem::ContainSim::reset(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio,
+        ContainForce *force,
+        Sem::Contain::ContainTactic tactic,
+        double attackDist,
+        bool retry,
+        int minSteps,
+        int maxSteps,
+        int maxFireSize,
+        int maxFireTime )
+{
+    clearResults();
+    m_force = force;
+    m_minSteps = minSteps;
+    m_maxSteps = maxSteps;
+    m_retry = retry;
+    m_maxFireSize = maxFireSize;
+    m_maxFireTime = maxFireTime;
+    initialize( reportSize, reportRate, diurnalROS, fireStartMinutesStartTime,
+        lwRatio, tactic, attackDist );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Starts the ContainSim over with another tactic and attack distance,
+    keeping every other input of the last constructor or reset() call.
+
+    The fire growth up to the first attack does not depend on the tactic or
+    the attack distance, so it is taken from the last initialize() instead of
+    being worked out again.  Only the left flank is simulated either way; the
+    right flank is its mirror image.
+
+    \param[in] tactic HeadAttack or RearAttack.
+    \param[in] attackDist Parallel attack distance from the fire (ch).
+ */
+
+void Sem::ContainSim::resetAttack(
+        Sem::Contain::ContainTactic tactic,
+        double attackDist )
+{
+    clearResults();
+    *m_left = *m_preAttack;
+    m_left->m_tactic = tactic;
+    m_left->m_attackDist = attackDist;
+    m_left->setIntegrator( m_integrator, m_tolerance );
+    m_left->setAnalyticSteps( m_analyticSteps );
+    m_left->startAttack();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Zeroes the final statistics and pass counters ahead of another run.
+ */
+
+void Sem::ContainSim::clearResults( void )
+{
+    m_finalCost = 0.;
+    m_finalLine = 0.;
+    m_finalPerim = 0.;
+    m_finalSize = 0.;
+    m_finalSweep = 0.;
+    m_finalTime = 0.;
+    m_xMax = 0.;
+    m_xMin = 0.;
+    m_yMax = 0.;
+    m_pass = 0;
+    m_used = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets up the left flank Contain object and the simulation arrays
+    for the current inputs.  Shared by the constructor and reset().
+ */
+
+void Sem::ContainSim::initialize(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio,
+        Sem::Contain::ContainTactic tactic,
+        double attackDist )
 {
 	int logLevel = 0;
 	
@@ -119,56 +232,100 @@ Sem::ContainSim::ContainSim(
     // delay the initial attack until the next arrival of forces.
     double attackTime = m_force->firstArrival( LeftFlank );
 
-    // Create the left flank
-	  m_left = new Contain( reportSize, reportRate, 
-        diurnalROS,fireStartMinutesStartTime,
-        lwRatio, distStep,
-        LeftFlank, force, attackTime, tactic, attackDist );
+    // Create the left flank, or start the existing one over
+    if ( m_left )
+    {
+        *m_left = Contain( reportSize, reportRate,
+            diurnalROS, fireStartMinutesStartTime,
+            lwRatio, distStep,
+            LeftFlank, m_force, attackTime, tactic, attackDist );
+    }
+    else
+    {
+        m_left = new Contain( reportSize, reportRate,
+            diurnalROS,fireStartMinutesStartTime,
+            lwRatio, distStep,
+            LeftFlank, m_force, attackTime, tactic, attackDist );
+    }
+    m_left->setIntegrator( m_integrator, m_tolerance );
+    m_left->setAnalyticSteps( m_analyticSteps );
 
 
     if (logLevel > 0) {
        m_left-> containLog( true, " reportSize=%f,  reportRate=%f, lwRatio=%f, tactic=%d ,attackDist=%f   \n",reportSize, reportRate, lwRatio,tactic, attackDist);
-       m_left-> containLog( true, "retry=%d minSteps=%d maxSteps=%d maxFireSize=%d maxFireTime=%d \n",    retry,  minSteps, maxSteps,   maxFireSize,  maxFireTime);
+       m_left-> containLog( true, "retry=%d minSteps=%d maxSteps=%d maxFireSize=%d maxFireTime=%d \n",    m_retry,  m_minSteps, m_maxSteps,   m_maxFireSize,  m_maxFireTime);
        m_left-> containLog( true, "attackTime=%f m_force->numresource=%d \n" , attackTime, m_force->resources());
-       force->logResources( true, m_left );
+       m_force->logResources( true, m_left );
     }
     
     //Check for invalid attack time. The algorithm goes into an endless loop on negative values 
     if (attackTime<0) {
       m_left-> containLog( true, "attackTime=%f m_force->numresource=%d \n" , attackTime, m_force->resources());    
-      force->logResources( true, m_left );
+      m_force->logResources( true, m_left );
       throw INVALID_RESOURCE_TIME_ERROR;
     }
+
+    // Keep the fire at first attack for resetAttack()
+    if ( m_preAttack )
+    {
+        *m_preAttack = *m_left;
+    }
+    else
+    {
+        m_preAttack = new Contain( *m_left );
+    }
     
     // Create the right flank
     //attackTime = m_force->firstArrival( RightFlank );
     //m_right = new Contain( reportSize, reportRate, lwRatio,  distStep,
     //    RightFlank, force, attackTime, tactic, attackDist );
 
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Allocates the simulation arrays for the requested outputs.
+    Called at the start of run().
+ */
+
+void Sem::ContainSim::allocateArrays( void )
+{
     // How big do the arrays need to be?
     //Carmi commented out - m_right is not being initialized anymore 
     //m_size = ( m_right ) ? 2 * m_maxSteps : m_maxSteps;
     //allocate an extra so we don't go out of bounds on the arrays
-    m_size =  m_maxSteps+1; 
-
-    // Array of attack point angles (radians) at each simulation step.
-    m_u = new double[m_size];
-    checkmem( __FILE__, __LINE__, m_u, "double m_u", m_size );
-    // Array of free-burning fire head positions (ch) at each simulation step.
-    m_h = new double[m_size];
-    checkmem( __FILE__, __LINE__, m_h, "double m_h", m_size );
-    // Array of attack point x coordinates (ch) at each simulation step.
-    m_x = new double[m_size];
-    checkmem( __FILE__, __LINE__, m_x, "double m_x", m_size );
-    // Array of attack point y coordinates (ch) at each simulation step.
-    m_y = new double[m_size];
-    checkmem( __FILE__, __LINE__, m_y, "double m_y", m_size );
-    // Array of area under the perimeter curve (ch2) burned at each sim step.
-    m_a = new double[m_size];
-    checkmem( __FILE__, __LINE__, m_a, "double m_a", m_size );
-    // Array of fireline perimeter (ch) constructed at each simulation step.
-    m_p = new double[m_size];
-    checkmem( __FILE__, __LINE__, m_p, "double m_p", m_size );
+    // Summary runs do without the arrays altogether
+    m_size = ( m_outputs & PerimeterOutputs ) ? m_maxSteps+1 : 0;
+
+    // Only grow the arrays, a smaller run reuses the existing ones
+    if ( m_size > m_capacity )
+    {
+        if ( m_u )      { delete[] m_u;     m_u = 0; }
+        if ( m_h )      { delete[] m_h;     m_h = 0; }
+        if ( m_x )      { delete[] m_x;     m_x = 0; }
+        if ( m_y )      { delete[] m_y;     m_y = 0; }
+        if ( m_a )      { delete[] m_a;     m_a = 0; }
+        if ( m_p )      { delete[] m_p;     m_p = 0; }
+        // Array of attack point angles (radians) at each simulation step.
+        m_u = new double[m_size];
+        checkmem( __FILE__, __LINE__, m_u, "double m_u", m_size );
+        // Array of free-burning fire head positions (ch) at each simulation step.
+        m_h = new double[m_size];
+        checkmem( __FILE__, __LINE__, m_h, "double m_h", m_size );
+        // Array of attack point x coordinates (ch) at each simulation step.
+        m_x = new double[m_size];
+        checkmem( __FILE__, __LINE__, m_x, "double m_x", m_size );
+        // Array of attack point y coordinates (ch) at each simulation step.
+        m_y = new double[m_size];
+        checkmem( __FILE__, __LINE__, m_y, "double m_y", m_size );
+        // Array of area under the perimeter curve (ch2) burned at each sim step.
+        m_a = new double[m_size];
+        checkmem( __FILE__, __LINE__, m_a, "double m_a", m_size );
+        // Array of fireline perimeter (ch) constructed at each simulation step.
+        m_p = new double[m_size];
+        checkmem( __FILE__, __LINE__, m_p, "double m_p", m_size );
+        m_capacity = m_size;
+    }
     return;
 }
 
@@ -186,6 +343,7 @@ Sem::ContainSim::~ContainSim( void )
     if ( m_p )      { delete[] m_p;     m_p = 0; }
     if ( m_left )   { delete   m_left;  m_left = 0; }
     if ( m_right )  { delete   m_right; m_right = 0; }
+    if ( m_preAttack ) { delete m_preAttack; m_preAttack = 0; }
     return;
 }
 
@@ -437,6 +595,7 @@ double Sem::ContainSim::fireHeadAtReport( void ) const
     during the simulation.
 
     \note Call firePoints() to determine the array size.
+    The array is only kept with PerimeterOutputs, otherwise 0 is returned.
 
     \return Pointer to the array of free-burning fire head positions
     during the simulation (radians).
@@ -444,7 +603,7 @@ double Sem::ContainSim::fireHeadAtReport( void ) const
 
 double* Sem::ContainSim::fireHeadX( void ) const
 {
-    return( m_h );
+    return( m_size ? m_h : 0 );
 }
 
 //------------------------------------------------------------------------------
@@ -463,6 +622,7 @@ double Sem::ContainSim::fireLwRatioAtReport( void ) const
     during the simulation.
 
     \note Call firePoints() to determine the array size.
+    The array is only kept with PerimeterOutputs, otherwise 0 is returned.
 
     \return Pointer to the array of fire perimeter x-coordinates
     during the simulation.
@@ -470,7 +630,7 @@ double Sem::ContainSim::fireLwRatioAtReport( void ) const
 
 double* Sem::ContainSim::firePerimeterX( void ) const
 {
-    return( m_x );
+    return( m_size ? m_x : 0 );
 }
 
 //------------------------------------------------------------------------------
@@ -478,6 +638,7 @@ double* Sem::ContainSim::firePerimeterX( void ) const
     during the simulation.
 
     \note Call firePoints() to determine the array size.
+    The array is only kept with PerimeterOutputs, otherwise 0 is returned.
 
     \return Pointer to the array of fire perimeter x-coordinates
     during the simulation.
@@ -485,7 +646,7 @@ double* Sem::ContainSim::firePerimeterX( void ) const
 
 double* Sem::ContainSim::firePerimeterY( void ) const
 {
-    return( m_y );
+    return( m_size ? m_y : 0 );
 }
 
 //------------------------------------------------------------------------------
@@ -576,6 +737,142 @@ int Sem::ContainSim::minimumSimulationSteps( void ) const
     return( m_minSteps );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of simulation steps taken by the final pass.
+
+    \return Number of simulation steps.
+ */
+
+int Sem::ContainSim::simulationSteps( void ) const
+{
+    return( m_left->simulationStep() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the outputs kept by run().
+
+    \return ContainOutputs flags.
+ */
+
+int Sem::ContainSim::outputs( void ) const
+{
+    return( m_outputs );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the outputs kept by run().
+
+    The final status, time, cost, line, perimeter, and size are always
+    computed.  Without PerimeterOutputs the perimeter and head arrays are
+    neither allocated nor filled, and firePoints() returns 0, so runs that
+    only need the final statistics are cheaper; the perimeter can still be
+    streamed with setPerimeterCallback().
+
+    \param[in] outputs ContainOutputs flags (default PerimeterOutputs).
+ */
+
+void Sem::ContainSim::setOutputs( int outputs )
+{
+    m_outputs = outputs;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a callback that receives each perimeter point as run()
+    produces it, whatever the outputs.
+
+    \param[in] callback Callback, or an empty one to stop streaming.
+ */
+
+void Sem::ContainSim::setPerimeterCallback( ContainPerimeterCallback callback )
+{
+    m_perimeterCallback = callback;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets a RunControl that run() polls every simulation step and
+    counts the steps on.  A stopped run ends with the Stopped status and the
+    statistics of the steps it had taken.
+
+    \param[in] runControl Token that outlives run(), or 0 for none.
+ */
+
+void Sem::ContainSim::setRunControl( RunControl *runControl )
+{
+    m_runControl = runControl;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the integration method.
+
+    \return Integration method used by run().
+ */
+
+Sem::Contain::ContainIntegrator Sem::ContainSim::integrator( void ) const
+{
+    return( m_integrator );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the integration method used by run(), and kept across reset().
+
+    Under Sem::Contain::AdaptiveStep the distance step is adapted within a
+    pass, so run() does not repeat the simulation with a larger or smaller
+    distance step to bring the number of steps into [m_minSteps..m_maxSteps].
+
+    \param[in] integrator Sem::Contain::FixedStep or Sem::Contain::AdaptiveStep.
+    \param[in] tolerance  AdaptiveStep error tolerance on the attack point
+                           angle per step (radians).
+ */
+
+void Sem::ContainSim::setIntegrator( Sem::Contain::ContainIntegrator integrator,
+        double tolerance )
+{
+    m_integrator = integrator;
+    m_tolerance = tolerance;
+    m_left->setIntegrator( m_integrator, m_tolerance );
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to whether AdaptiveStep takes constant production steps.
+
+    \return TRUE if run() lets AdaptiveStep take constant production steps.
+ */
+
+bool Sem::ContainSim::analyticSteps( void ) const
+{
+    return( m_analyticSteps );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Access to the number of steps of the final pass taken at constant
+    production rather than by the Runga-Kutta steps of AdaptiveStep.
+
+    \return Number of constant production steps.
+ */
+
+int Sem::ContainSim::analyticStepCount( void ) const
+{
+    return( m_left->analyticStepCount() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets whether AdaptiveStep takes constant production steps, kept
+    across reset().  See Sem::Contain::setAnalyticSteps().
+
+    \param[in] analyticSteps TRUE to take constant production steps.
+ */
+
+void Sem::ContainSim::setAnalyticSteps( bool analyticSteps )
+{
+    m_analyticSteps = analyticSteps;
+    m_left->setAnalyticSteps( m_analyticSteps );
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Runs the simulation to completion.
   
@@ -587,6 +884,7 @@ int Sem::ContainSim::minimumSimulationSteps( void ) const
 
 void Sem::ContainSim::run( void )
 {
+    BEHAVE_TIME_STAGE(ContainSimRun);
     // Status names
     const char *StatusName[] =
     {
@@ -598,7 +896,8 @@ void Sem::ContainSim::run( void )
         "Exhausted",
         "Sim Overflow",
         "Size Limit Exceeded",
-        "Time Limit Exceeded"
+        "Time Limit Exceeded",
+        "Stopped"
     };
     
    	
@@ -614,12 +913,20 @@ void Sem::ContainSim::run( void )
     int logLevel = 0;
     // Repeat simulation until [m_minSteps::m_maxSteps] steps achieved,
     // or if retry==TRUE, until sufficient resources are able to contain fire
-    double area, dx, dy, suma, sumb, sumDT;
+    double area, dx, dy, suma, sumb, sumDT, sumDTPrev;
     double totalArea;
 //    double maxArea = 500.0;
     bool rerun = true;
     bool MAXSTEPS_EXCEEDED=false;
     m_pass = 0;
+    bool keepPerimeter = ( m_outputs & PerimeterOutputs ) != 0;
+    bool stopped = false;
+    if ( m_runControl )
+    {
+        // the number of steps, retries included, is not known up front
+        m_runControl->beginWork( 0 );
+    }
+    allocateArrays();
     
     
     while ( rerun )
@@ -627,10 +934,25 @@ void Sem::ContainSim::run( void )
         m_left->containLog( ( logLevel >= 1 ), "\nPass %d Begins:\n", m_pass );
         // Simulate until forces overrun, fire contained, or maxSteps reached
         int iLeft = 0;              // First index of left half values
-        m_u[iLeft] = m_left->m_u;
-        m_h[iLeft] = m_left->m_h;
-        m_x[iLeft] = m_left->m_x;
-        m_y[iLeft] = m_left->m_y;
+        // The first and previous points are all the sums need, the
+        // arrays are only filled when the perimeter is kept
+        double x0 = m_left->m_x;
+        double y0 = m_left->m_y;
+        double xPrev = x0;
+        double yPrev = y0;
+        double xBefore = x0;
+        double yBefore = y0;
+        if ( keepPerimeter )
+        {
+            m_u[iLeft] = m_left->m_u;
+            m_h[iLeft] = m_left->m_h;
+            m_x[iLeft] = m_left->m_x;
+            m_y[iLeft] = m_left->m_y;
+        }
+        if ( m_perimeterCallback )
+        {
+            m_perimeterCallback( m_pass, iLeft, x0, y0 );
+        }
         //int iRight = m_maxSteps;  // First index of right half values
         elapsed = m_left->m_attackTime;
         m_left->containLog( ( logLevel == 2 ),
@@ -640,7 +962,7 @@ void Sem::ContainSim::run( void )
         // This is the main simulation loop!
         m_finalSweep = m_finalLine = m_finalPerim = 0.0;
         totalArea=0.0;
-        suma = sumb = sumDT = 0.0;
+        suma = sumb = sumDT = sumDTPrev = 0.0;
         while ( m_left->m_status != Sem::Contain::Overrun
              && m_left->m_status != Sem::Contain::Contained
              && m_left->m_step    < m_maxSteps
@@ -648,92 +970,127 @@ void Sem::ContainSim::run( void )
              && m_left->m_currentTime < m_maxFireTime		 		// MAF
              && m_left->m_currentTime < m_left->m_exhausted)		// MAF
         {
+            if ( m_runControl )
+            {
+                if ( m_runControl->isStopRequested() )
+                {
+                    stopped = true;
+                    break;
+                }
+                m_runControl->addWorkDone( 1 );
+            }
             // Store angle and head position in the proper array element
             m_left->step();
 
             // Store the new angle, head position, and coordinate values
             iLeft++;
-                       
-            m_u[iLeft] = m_left->m_u;
-            m_h[iLeft] = m_left->m_h;
-            m_x[iLeft] = m_left->m_x;
-            m_y[iLeft] = m_left->m_y;
+            double x = m_left->m_x;
+            double y = m_left->m_y;
+            if ( keepPerimeter )
+            {
+                m_u[iLeft] = m_left->m_u;
+                m_h[iLeft] = m_left->m_h;
+                m_x[iLeft] = x;
+                m_y[iLeft] = y;
+            }
             elapsed = m_left->m_currentTime;//m_time; // MAF
 //            m_left->containLog( (logLevel == 2 ),
 //                "%d: u=%12.10f,  h=%12.10f,  t=%12.10f\n",
 //                iLeft, m_u[iLeft], m_h[iLeft], elapsed );
             // Update the extent
-            m_xMin = ( m_x[iLeft] < m_xMin ) ? m_x[iLeft] : m_xMin;
-            m_xMax = ( m_x[iLeft] > m_xMax ) ? m_x[iLeft] : m_xMax;
-            m_yMax = ( m_y[iLeft] > m_yMax ) ? m_y[iLeft] : m_yMax;
+            m_xMin = ( x < m_xMin ) ? x : m_xMin;
+            m_xMax = ( x > m_xMax ) ? x : m_xMax;
+            m_yMax = ( y > m_yMax ) ? y : m_yMax;
 
             // Line constructed and area swept during this simulation step
-            dy = fabs( m_y[iLeft-1] - m_y[iLeft] );
-            dx = fabs( m_x[iLeft-1] - m_x[iLeft] );
-            m_p[iLeft-1] = sqrt( ( dy * dy ) + ( dx * dx ) );
+            dy = fabs( yPrev - y );
+            dx = fabs( xPrev - x );
+            double segment = sqrt( ( dy * dy ) + ( dx * dx ) );
             // Accumulate line constructed for BOTH flanks (ch)
-            m_finalLine += 2.0 * m_p[iLeft-1];
+            m_finalLine += 2.0 * segment;
             // Accumulate area of containment (apply trapazoidal rule)
-            suma += ( m_y[iLeft-1] * m_x[iLeft] );
-            sumb += ( m_x[iLeft-1] * m_y[iLeft] );
-            area = ( suma > sumb )
-                 ? ( 0.5 * ( suma - sumb ) )
-                 : ( 0.5 * ( sumb - suma ) );
-			
-			// Calculate the area using the trapizoidal rule
-			sumDT = 0;
-			for ( int i = 1; i <= iLeft; i++ )	
-				sumDT = (m_x[i] - m_x[i-1]) * (m_y[i] + m_y[i-1]) + sumDT;
-
-			if ( sumDT < 0 )
-				sumDT = -1.0 * sumDT;
-				
-			area = sumDT * .5;
+            suma += ( yPrev * x );
+            sumb += ( xPrev * y );
+
+			// Calculate the area using the trapizoidal rule, carried from
+			// step to step rather than summed over all the points again
+			sumDTPrev = sumDT;
+			sumDT = (x - xPrev) * (y + yPrev) + sumDT;
+			area = fabs( sumDT ) * .5;
 			
 			// Add in the area for the uncontained portion of the fire DT 1/2013
-			double UCarea = UncontainedArea( m_h[iLeft], fireLwRatioAtReport(), m_x[iLeft], m_y[iLeft], tactic() );
+			double UCarea = UncontainedArea( m_left->m_h, fireLwRatioAtReport(), x, y, tactic() );
 			area = area + UCarea;
 			
             // Accumulate area for BOTH flanks (ac)
-            m_a[iLeft-1] = 0.2 * area;
-            totalArea = m_a[iLeft-1];
+            totalArea = 0.2 * area;
+            if ( keepPerimeter )
+            {
+                m_p[iLeft-1] = segment;
+                m_a[iLeft-1] = totalArea;
+            }
             m_left->containLog( (logLevel == 2 ),
                 "%d: u=%12.10f,  h=%12.10f,  x=%12.10f, y=%12.10f, t=%12.10f, UCA=%12.10f, CA=%12.1f, TA=%12.10f, TP=%12.10f\n",
-                iLeft, m_u[iLeft], m_h[iLeft], m_x[iLeft], m_y[iLeft], elapsed, UCarea*0.2, (area-UCarea)*0.2, totalArea, m_finalLine );
+                iLeft, m_left->m_u, m_left->m_h, x, y, elapsed, UCarea*0.2, (area-UCarea)*0.2, totalArea, m_finalLine );
+
+            // Stream the point, already adjusted if this step contains a head attack
+            if ( m_perimeterCallback )
+            {
+                bool adjust = m_left->m_status == Sem::Contain::Contained
+                           && m_left->m_tactic == Sem::Contain::HeadAttack;
+                m_perimeterCallback( m_pass, iLeft,
+                    adjust ? ( x - 2. * m_left->m_attackDist ) : x, y );
+            }
+            xBefore = xPrev;
+            yBefore = yPrev;
+            xPrev = x;
+            yPrev = y;
         }
         // BEHAVEPLUS FIX: Adjust the last x-coordinate for contained head attacks
+        double xLast = xPrev;
         if ( m_left->m_status == Sem::Contain::Contained
           && m_left->m_tactic == Sem::Contain::HeadAttack )
         {
-            m_x[m_left->m_step] -= 2. * m_left->m_attackDist;
+            xLast -= 2. * m_left->m_attackDist;
+            if ( keepPerimeter )
+            {
+                m_x[m_left->m_step] = xLast;
+            }
 		}
 
-        suma += ( m_y[m_left->m_step] * m_x[0] );
-        sumb += ( m_x[m_left->m_step] * m_y[0] );
+        suma += ( yPrev * x0 );
+        sumb += ( xLast * y0 );
         m_finalSweep = ( suma > sumb )
                      ? ( 0.5 * ( suma - sumb ) )
                      : ( 0.5 * ( sumb - suma ) );
         m_finalSweep *= 0.20;
 
-		// Calculate the area using the trapizoidal rule
-		sumDT = 0;
-		for ( int i = 1; i <= m_left->m_step; i++ )	
-			sumDT = (m_x[i] - m_x[i-1]) * (m_y[i] + m_y[i-1]) + sumDT;
+		// Calculate the area using the trapizoidal rule, redoing the last
+		// step's term with the adjusted x-coordinate
+		if ( iLeft > 0 )
+			sumDT = (xLast - xBefore) * (yPrev + yBefore) + sumDTPrev;
 
-		if ( sumDT < 0 )
-			sumDT = -1.0 * sumDT;
-				
-		area = sumDT * .5;
+		area = fabs( sumDT ) * .5;
 
 		// Add in the area for the uncontained portion of the fire DT 1/2013
-		double UCarea = UncontainedArea( m_h[m_left->m_step], fireLwRatioAtReport(), m_x[m_left->m_step], m_y[m_left->m_step], tactic() );
+		double UCarea = UncontainedArea( m_left->m_h, fireLwRatioAtReport(), xLast, yPrev, tactic() );
 		area = area + UCarea;
 			
         // Accumulate area for BOTH flanks (ac)
         m_finalSweep = 0.2 * area;
 
+        // Case 0: the RunControl stopped the run, keep what it has
+        if ( stopped )
+        {
+            rerun = false;
+            m_left->containLog( ( logLevel >= 1 ),
+                "Pass %d Result 0: Stopped\n"
+                "    - run stopped at %3.1f minutes (%d steps)\n",
+                m_pass, elapsed, m_left->m_step );
+            m_left->m_status = Sem::Contain::Stopped;
+        }
         // Cases 1-3: forces are overrun by fire...
-        if ( m_left->m_status == Sem::Contain::Overrun )
+        else if ( m_left->m_status == Sem::Contain::Overrun )
         {
             // Case 1: No retry allowed, simulation is complete
             if ( ! m_retry )
@@ -811,7 +1168,8 @@ void Sem::ContainSim::run( void )
             m_left->m_distStep *= factor;
             m_pass++;
             
-		  if(MAXSTEPS_EXCEEDED==false)
+		  // The adaptive step has already grown as far as its tolerance allows
+		  if(MAXSTEPS_EXCEEDED==false && m_integrator == Sem::Contain::FixedStep)
 		  {	m_left->reset();
 			rerun = true;
 		  }
@@ -823,7 +1181,9 @@ void Sem::ContainSim::run( void )
         else if ( m_left->m_status == Sem::Contain::Contained )
         {
             // Case 5: there were insufficient simulation steps...
-            if (  iLeft < m_minSteps && MAXSTEPS_EXCEEDED==false) // MAF 9/29/2010 added MAXSTEPS_EXCEEDED check
+            // (never under AdaptiveStep, whose steps are sized by its error tolerance)
+            if (  iLeft < m_minSteps && MAXSTEPS_EXCEEDED==false // MAF 9/29/2010 added MAXSTEPS_EXCEEDED check
+               && m_integrator == Sem::Contain::FixedStep )
             {
                 // Make the distance step size smaller and rerun the simulation
                 // Need to make sure that with the new smaller step we will not
@@ -933,7 +1293,7 @@ void Sem::ContainSim::run( void )
     //------------------------------------------------------------------
     //  MAF 6/2010
     //------------------------------------------------------------------
-    if ((m_left->m_currentTime) > (m_maxFireTime-1)) {
+    if ( ! stopped && (m_left->m_currentTime) > (m_maxFireTime-1)) {
      	m_left->m_currentTime=m_maxFireTime;
      	m_left->m_status = Sem::Contain::TimeLimitExceeded;
      }
@@ -66,9 +66,26 @@
 #include "ContainForce.h"
 #include "ContainResource.h"
 
+// Standard include files
+#include <functional>
+
+class RunControl;
+
 namespace Sem
 {
 
+//------------------------------------------------------------------------------
+/*! \brief Receives each fire perimeter point (ch) as ContainSim::run()
+    produces it.
+
+    \a step restarts at 0 with each simulation pass, and the points of a pass
+    that is re-run replace those already received.  The final point of a
+    contained head attack is already adjusted for the attack distance.
+ */
+
+typedef std::function<void( int pass, int step, double x, double y )>
+    ContainPerimeterCallback;
+
 //------------------------------------------------------------------------------
 /*! \class ContainSim Contain.h
     \brief Fire containment simulation object.
@@ -79,6 +96,20 @@ namespace Sem
 
 class ContainSim
 {
+// Public enums
+public:
+
+//------------------------------------------------------------------------------
+/*! \enum ContainOutputs
+    \brief Identifies the outputs run() keeps beyond the final statistics,
+    which are always computed.
+ */
+enum ContainOutputs
+{
+    SummaryOutputs   = 0,   //!< Final status, time, cost, line, and size only
+    PerimeterOutputs = 1    //!< Also keep the perimeter and head arrays
+};
+
 // Public methods
 public:
     // Custom constructor
@@ -98,6 +129,23 @@ public:
         int maxFireTime=1080) ;
     // Virtual destructor
     ~ContainSim( void ) ;
+    // Start over with new inputs, reusing the Contain object and arrays
+    void reset(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio=1.,
+        ContainForce *force=0,
+        Contain::ContainTactic tactic=Contain::HeadAttack,
+        double attackDist=0.,
+        bool retry=true,
+        int minSteps=250,
+        int maxSteps=1000,
+        int maxFireSize=1000,
+        int maxFireTime=1080) ;
+    // Start over with another tactic and attack distance, keeping the rest
+    void resetAttack( Contain::ContainTactic tactic, double attackDist ) ;
 
     // Access to input properties
     double attackDistance( void ) const ;
@@ -128,6 +176,7 @@ public:
     double finalFireSweep( void ) const ;
     double finalFireTime( void ) const ;
     int    finalResourcesUsed( void ) const ;
+    int    simulationSteps( void ) const ;
 
     // Access to simulation coordinate array
     double* fireHeadX( void ) const ;
@@ -135,6 +184,22 @@ public:
     double* firePerimeterY( void ) const ;
     int     firePoints( void ) const ;
 
+    // Integration method used by the next run()
+    Contain::ContainIntegrator integrator( void ) const ;
+    void setIntegrator( Contain::ContainIntegrator integrator,
+            double tolerance=1.e-6 ) ;
+    bool analyticSteps( void ) const ;
+    int  analyticStepCount( void ) const ;
+    void setAnalyticSteps( bool analyticSteps ) ;
+
+    // Outputs kept by the next run()
+    int  outputs( void ) const ;
+    void setOutputs( int outputs ) ;
+    void setPerimeterCallback( ContainPerimeterCallback callback ) ;
+
+    // Cancel, progress and time budget token polled by the next run()
+    void setRunControl( RunControl *runControl ) ;
+
     // Run the simulation!
     void run( void );
     static void checkmem( const char* fileName, int lineNumber, void* ptr,
@@ -144,7 +209,17 @@ public:
 	double UncontainedArea( double head, double lwRatio, double x, double y, Sem::Contain::ContainTactic tactic  );	 // By DT 1/2013
 
 protected:
+    void allocateArrays( void ) ;
+    void clearResults( void ) ;
     void finalStats( void ) ;
+    void initialize(
+        double reportSize,
+        double reportRate,
+        double *diurnalROS,
+        int fireStartMinutesStartTime,
+        double lwRatio,
+        Contain::ContainTactic tactic,
+        double attackDist ) ;
 
 // Protected data
 protected:
@@ -165,15 +240,23 @@ protected:
     double  *m_p;           //!< Array of flank perimeter segments (ch)
     Contain *m_left;        //!< Left flank Contain object.
     Contain *m_right;       //!< Right flank Contain object.
+    Contain *m_preAttack;   //!< Left flank as initialize() set it up, before any step
     ContainForce *m_force;  //!< Containment forces for both flanks
     int      m_minSteps;    //!< Minimum number of simulation distance steps
     int      m_maxSteps;    //!< Maximum number of simulation distance steps
-    int      m_size;        //!< Size of the arrays (m_maxSteps or 2*m_maxSteps)
+    int      m_size;        //!< Size of the arrays (m_maxSteps+1, or 0 without PerimeterOutputs)
     int      m_pass;        //!< Pass number
     int      m_used;        //!< Number of containment resources deployed
     bool     m_retry;       //!< Retry with later attack time if forces overrun
     int   m_maxFireSize;	//!< Maximum size a fire can burn before it escapes (acres)
     int   m_maxFireTime;     //!< Maximum time a fire can burn before it escapes (minutes)
+    int      m_capacity;    //!< Allocated size of the arrays, may exceed m_size after reset()
+    Contain::ContainIntegrator m_integrator; //!< Integration method applied to m_left
+    double   m_tolerance;   //!< AdaptiveStep error tolerance applied to m_left
+    bool     m_analyticSteps; //!< AdaptiveStep constant production steps applied to m_left
+    int      m_outputs;     //!< ContainOutputs flags kept by run()
+    ContainPerimeterCallback m_perimeterCallback; //!< Optional perimeter point stream
+    RunControl *m_runControl; //!< Optional token polled every step, may be null
 };
 
 }   // End of namespace Sem
@@ -0,0 +1,153 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Runs one containment scenario for several tactics and attack
+*           distances in parallel from a shared fire at first attack
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "ContainVariantRunner.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "threadPool.h"
+
+ContainVariantRunner::ContainVariantRunner(const ContainAdapter& prototype)
+    : prototype_(prototype),
+    numberOfThreads_(0),
+    numberOfFullRuns_(0)
+{
+
+}
+
+void ContainVariantRunner::addTactic(ContainTactic::ContainTacticEnum tactic)
+{
+    tactics_.push_back(tactic);
+}
+
+void ContainVariantRunner::addAttackDistance(double attackDistance, LengthUnits::LengthUnitsEnum lengthUnits)
+{
+    attackDistances_.push_back(LengthUnits::toBaseUnits(attackDistance, lengthUnits));
+}
+
+void ContainVariantRunner::clearVariants()
+{
+    tactics_.clear();
+    attackDistances_.clear();
+}
+
+void ContainVariantRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+const std::vector<ContainVariantResult>& ContainVariantRunner::getResults() const
+{
+    return results_;
+}
+
+int ContainVariantRunner::getNumberOfFullRuns() const
+{
+    return numberOfFullRuns_;
+}
+
+void ContainVariantRunner::run()
+{
+    results_.clear();
+    numberOfFullRuns_ = 0;
+    for(ContainTactic::ContainTacticEnum tactic : tactics_)
+    {
+        for(double attackDistance : attackDistances_)
+        {
+            ContainVariantResult result;
+            result.tactic = tactic;
+            result.attackDistance = attackDistance;
+            results_.push_back(result);
+        }
+    }
+    if(results_.empty())
+    {
+        return;
+    }
+
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots(std::min((numberOfThreads_ > 0) ? numberOfThreads_ : (int)results_.size(),
+        (int)results_.size()));
+    std::vector<ContainAdapter> workers(numberOfSlots, prototype_);
+    std::vector<int> fullRunsBySlot(workers.size(), 0);
+    for(ContainAdapter& worker : workers)
+    {
+        // Only the final outputs are compared, so skip the perimeter
+        worker.setKeepPerimeter(false);
+        worker.setPerimeterCallback(Sem::ContainPerimeterCallback());
+    }
+
+    threadPool->runChunks((long)results_.size(), 1, [&](int slot, long begin, long end)
+    {
+        ContainAdapter& worker = workers[slot];
+        for(long i = begin; i < end; i++)
+        {
+            ContainVariantResult& result = results_[i];
+            if(fullRunsBySlot[slot] == 0)
+            {
+                worker.setTactic(result.tactic);
+                worker.setAttackDistance(result.attackDistance, LengthUnits::Feet);
+                worker.doContainRun();
+                fullRunsBySlot[slot]++;
+            }
+            else
+            {
+                worker.doContainRunWithAttack(result.tactic, result.attackDistance, LengthUnits::Feet);
+            }
+
+            result.status = worker.getContainmentStatus();
+            result.finalCost = worker.getFinalCost();
+            result.finalFireLineLength = worker.getFinalFireLineLength(LengthUnits::Feet);
+            result.finalFireSize = worker.getFinalFireSize(AreaUnits::SquareFeet);
+            result.finalTime = worker.getFinalTimeSinceReport(TimeUnits::Minutes);
+            result.numberOfSimulationSteps = worker.getNumberOfSimulationSteps();
+        }
+    }, numberOfSlots);
+
+    for(int fullRuns : fullRunsBySlot)
+    {
+        numberOfFullRuns_ += fullRuns;
+    }
+}
+
+bool ContainVariantRunner::getCheapestContained(ContainVariantResult& result) const
+{
+    bool isFound = false;
+    for(const ContainVariantResult& candidate : results_)
+    {
+        bool isCheaper = !isFound || candidate.finalCost < result.finalCost ||
+            (candidate.finalCost == result.finalCost && candidate.finalFireSize < result.finalFireSize);
+        if(candidate.status == ContainStatus::Contained && isCheaper)
+        {
+            result = candidate;
+            isFound = true;
+        }
+    }
+    return isFound;
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Runs one containment scenario for several tactics and attack
+*           distances in parallel from a shared fire at first attack
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef CONTAINVARIANTRUNNER_H
+#define CONTAINVARIANTRUNNER_H
+
+#include <vector>
+
+#include "ContainAdapter.h"
+
+// Outcome of one containment run with a given tactic and attack distance, in base units
+struct ContainVariantResult
+{
+    ContainTactic::ContainTacticEnum tactic;
+    double attackDistance;      // feet
+    ContainStatus::ContainStatusEnum status;
+    double finalCost;
+    double finalFireLineLength; // feet
+    double finalFireSize;       // square feet
+    double finalTime;           // minutes since report
+    int numberOfSimulationSteps;
+};
+
+// Runs the prototype's Contain inputs for every pairing of the added tactics and attack
+// distances. The fire growth up to the first attack doesn't depend on either, so each
+// worker works it out once, with a full ContainAdapter::doContainRun(), and starts every
+// other variant it is given from it with ContainAdapter::doContainRunWithAttack(). The
+// variants are independent and are shared out over a ThreadPool, each worker running its
+// own copy of the prototype.
+class ContainVariantRunner
+{
+public:
+    explicit ContainVariantRunner(const ContainAdapter& prototype);
+
+    void addTactic(ContainTactic::ContainTacticEnum tactic);
+    void addAttackDistance(double attackDistance, LengthUnits::LengthUnitsEnum lengthUnits);
+    void clearVariants();
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+
+    void run();
+
+    // One result per tactic and attack distance, tactics in the order added and the
+    // distances of each tactic in the order added
+    const std::vector<ContainVariantResult>& getResults() const;
+    bool getCheapestContained(ContainVariantResult& result) const;
+
+    int getNumberOfFullRuns() const;
+
+protected:
+    ContainAdapter prototype_;
+    std::vector<ContainTactic::ContainTacticEnum> tactics_;
+    std::vector<double> attackDistances_; // feet
+    int numberOfThreads_;
+
+    std::vector<ContainVariantResult> results_;
+    int numberOfFullRuns_;
+};
+
+#endif // CONTAINVARIANTRUNNER_H
@@ -0,0 +1,428 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  C interface over shared fuel models and species data with batch
+*           entry points for surface, crown, spot, mortality and contain runs
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#include "behaveCApi.h"
+
+#include "ContainAdapter.h"
+#include "crown.h"
+#include "fuelModels.h"
+#include "mortality.h"
+#include "species_master_table.h"
+#include "spot.h"
+#include "surface.h"
+#include "threadPool.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct BehaveEngine
+{
+    BehaveEngine()
+    {
+        speciesMasterTable.initializeMasterTable();
+    }
+
+    FuelModels fuelModels;
+    SpeciesMasterTable speciesMasterTable;
+};
+
+namespace
+{
+    thread_local std::string lastErrorMessage;
+
+    BehaveStatus setError(BehaveStatus status, const char* message)
+    {
+        lastErrorMessage = message;
+        return status;
+    }
+
+    // Holds an int enum array from the C side as the matching C++ enum, or null if the array is null
+    template<typename Enum>
+    class EnumArray
+    {
+    public:
+        EnumArray(const int* values, int count)
+        {
+            if(values)
+            {
+                values_.resize(count);
+                for(int i = 0; i < count; i++)
+                {
+                    values_[i] = static_cast<Enum>(values[i]);
+                }
+            }
+        }
+
+        const Enum* data() const
+        {
+            return values_.empty() ? nullptr : values_.data();
+        }
+
+    private:
+        std::vector<Enum> values_;
+    };
+
+    bool hasSurfaceInputs(const BehaveSurfaceBatchInputs& inputs)
+    {
+        return inputs.numberOfCells >= 0 && inputs.fuelModelNumber && inputs.moistureOneHour
+            && inputs.moistureTenHour && inputs.moistureHundredHour && inputs.moistureLiveHerbaceous
+            && inputs.moistureLiveWoody && inputs.windSpeed && inputs.windDirection && inputs.slope
+            && inputs.aspect && inputs.canopyCover && inputs.canopyHeight && inputs.crownRatio;
+    }
+
+    SurfaceBatchInputs toSurfaceBatchInputs(const BehaveSurfaceBatchInputs& inputs)
+    {
+        SurfaceBatchInputs surfaceInputs;
+        surfaceInputs.numberOfCells = inputs.numberOfCells;
+        surfaceInputs.fuelModelNumber = inputs.fuelModelNumber;
+        surfaceInputs.moistureOneHour = inputs.moistureOneHour;
+        surfaceInputs.moistureTenHour = inputs.moistureTenHour;
+        surfaceInputs.moistureHundredHour = inputs.moistureHundredHour;
+        surfaceInputs.moistureLiveHerbaceous = inputs.moistureLiveHerbaceous;
+        surfaceInputs.moistureLiveWoody = inputs.moistureLiveWoody;
+        surfaceInputs.windSpeed = inputs.windSpeed;
+        surfaceInputs.windDirection = inputs.windDirection;
+        surfaceInputs.slope = inputs.slope;
+        surfaceInputs.aspect = inputs.aspect;
+        surfaceInputs.canopyCover = inputs.canopyCover;
+        surfaceInputs.canopyHeight = inputs.canopyHeight;
+        surfaceInputs.crownRatio = inputs.crownRatio;
+        return surfaceInputs;
+    }
+}
+
+// Exceptions must not cross into the calling runtime, every entry point below is wrapped in this
+#define BEHAVE_C_API_TRY try {
+#define BEHAVE_C_API_CATCH \
+    } \
+    catch(const std::exception& exception) \
+    { \
+        return setError(BehaveStatusError, exception.what()); \
+    } \
+    catch(...) \
+    { \
+        return setError(BehaveStatusError, "unknown error"); \
+    }
+
+BehaveEngine* behaveCreateEngine(void)
+{
+    try
+    {
+        return new BehaveEngine();
+    }
+    catch(const std::exception& exception)
+    {
+        setError(BehaveStatusError, exception.what());
+    }
+    catch(...)
+    {
+        setError(BehaveStatusError, "unknown error");
+    }
+    return nullptr;
+}
+
+void behaveDestroyEngine(BehaveEngine* engine)
+{
+    delete engine;
+}
+
+const char* behaveGetLastErrorMessage(void)
+{
+    return lastErrorMessage.c_str();
+}
+
+int behaveGetNumberOfSpecies(const BehaveEngine* engine)
+{
+    return engine ? (int)engine->speciesMasterTable.record_.size() : 0;
+}
+
+int behaveGetSpeciesTableIndex(const BehaveEngine* engine, const char* speciesCode)
+{
+    if(!engine || !speciesCode)
+    {
+        return -1;
+    }
+    try
+    {
+        return engine->speciesMasterTable.getSpeciesTableIndexFromSpeciesCode(speciesCode);
+    }
+    catch(...)
+    {
+        return -1;
+    }
+}
+
+BehaveStatus behaveDoSurfaceRunBatch(const BehaveEngine* engine, const BehaveSurfaceBatchInputs* inputs,
+    BehaveSurfaceBatchOutputs* outputs)
+{
+    if(!engine || !inputs || !outputs || !hasSurfaceInputs(*inputs))
+    {
+        return setError(BehaveStatusInvalidArgument, "missing engine, surface inputs or outputs");
+    }
+    BEHAVE_C_API_TRY
+        Surface surface(engine->fuelModels);
+        surface.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+        surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+        SurfaceBatchOutputs surfaceOutputs;
+        surfaceOutputs.spreadRate = outputs->spreadRate;
+        surfaceOutputs.firelineIntensity = outputs->firelineIntensity;
+        surfaceOutputs.flameLength = outputs->flameLength;
+        surfaceOutputs.directionOfMaxSpread = outputs->directionOfMaxSpread;
+        surfaceOutputs.fireLengthToWidthRatio = outputs->fireLengthToWidthRatio;
+        surface.doSurfaceRunBatch(toSurfaceBatchInputs(*inputs), surfaceOutputs);
+        return BehaveStatusOk;
+    BEHAVE_C_API_CATCH
+}
+
+BehaveStatus behaveDoCrownRunBatchScottAndReinhardt(const BehaveEngine* engine, const BehaveCrownBatchInputs* inputs,
+    BehaveCrownBatchOutputs* outputs)
+{
+    if(!engine || !inputs || !outputs || !hasSurfaceInputs(inputs->surfaceInputs) || !inputs->canopyBaseHeight
+        || !inputs->canopyBulkDensity || !inputs->moistureFoliar)
+    {
+        return setError(BehaveStatusInvalidArgument, "missing engine, crown inputs or outputs");
+    }
+    BEHAVE_C_API_TRY
+        Crown crown(engine->fuelModels);
+        crown.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+        crown.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+        CrownBatchInputs crownInputs;
+        crownInputs.surfaceInputs = toSurfaceBatchInputs(inputs->surfaceInputs);
+        crownInputs.canopyBaseHeight = inputs->canopyBaseHeight;
+        crownInputs.canopyBulkDensity = inputs->canopyBulkDensity;
+        crownInputs.moistureFoliar = inputs->moistureFoliar;
+
+        const int numberOfCells = inputs->surfaceInputs.numberOfCells;
+        std::vector<FireType::FireTypeEnum> fireType(outputs->fireType ? numberOfCells : 0);
+        CrownBatchOutputs crownOutputs;
+        crownOutputs.fireType = outputs->fireType ? fireType.data() : nullptr;
+        crownOutputs.crownFractionBurned = outputs->crownFractionBurned;
+        crownOutputs.crownFireSpreadRate = outputs->crownFireSpreadRate;
+        crownOutputs.finalSpreadRate = outputs->finalSpreadRate;
+        crownOutputs.finalHeatPerUnitArea = outputs->finalHeatPerUnitArea;
+        crownOutputs.finalFirelineIntensity = outputs->finalFirelineIntensity;
+        crownOutputs.finalFlameLength = outputs->finalFlameLength;
+        crownOutputs.torchingIndex = outputs->torchingIndex;
+        crownOutputs.crowningIndex = outputs->crowningIndex;
+        crown.doCrownRunBatchScottAndReinhardt(crownInputs, crownOutputs);
+
+        if(outputs->fireType)
+        {
+            std::copy(fireType.begin(), fireType.end(), outputs->fireType);
+        }
+        return BehaveStatusOk;
+    BEHAVE_C_API_CATCH
+}
+
+BehaveStatus behaveCalculateSpottingDistanceBatch(const BehaveEngine* engine, BehaveSpotSource source,
+    const BehaveSpotBatchInputs* inputs, BehaveSpotBatchOutputs* outputs, int numberOfThreads)
+{
+    if(!engine || !inputs || !outputs || inputs->numberOfSources < 0)
+    {
+        return setError(BehaveStatusInvalidArgument, "missing engine, spot inputs or outputs");
+    }
+    BEHAVE_C_API_TRY
+        const int count = inputs->numberOfSources;
+        EnumArray<SpotTreeSpecies::SpotTreeSpeciesEnum> treeSpecies(inputs->treeSpecies, count);
+        EnumArray<SpotDownWindCanopyMode::SpotDownWindCanopyModeEnum> downwindCanopyMode(inputs->downwindCanopyMode, count);
+        EnumArray<SpotFireLocation::SpotFireLocationEnum> location(inputs->location, count);
+
+        SpotBatchInputs spotInputs;
+        spotInputs.numberOfSources = count;
+        spotInputs.burningPileFlameHeight = inputs->burningPileFlameHeight;
+        spotInputs.flameLength = inputs->flameLength;
+        spotInputs.torchingTrees = inputs->torchingTrees;
+        spotInputs.dbh = inputs->dbh;
+        spotInputs.treeHeight = inputs->treeHeight;
+        spotInputs.treeSpecies = treeSpecies.data();
+        spotInputs.windSpeedAtTwentyFeet = inputs->windSpeedAtTwentyFeet;
+        spotInputs.downwindCoverHeight = inputs->downwindCoverHeight;
+        spotInputs.downwindCanopyMode = downwindCanopyMode.data();
+        spotInputs.location = location.data();
+        spotInputs.ridgeToValleyDistance = inputs->ridgeToValleyDistance;
+        spotInputs.ridgeToValleyElevation = inputs->ridgeToValleyElevation;
+
+        SpotBatchOutputs spotOutputs;
+        spotOutputs.firebrandHeight = outputs->firebrandHeight;
+        spotOutputs.flatDistance = outputs->flatDistance;
+        spotOutputs.mountainDistance = outputs->mountainDistance;
+
+        Spot spot;
+        switch(source)
+        {
+            case BehaveSpotSourceBurningPile:
+                spot.calculateSpottingDistanceFromBurningPileBatch(spotInputs, spotOutputs, numberOfThreads);
+                break;
+            case BehaveSpotSourceSurfaceFire:
+                spot.calculateSpottingDistanceFromSurfaceFireBatch(spotInputs, spotOutputs, numberOfThreads);
+                break;
+            case BehaveSpotSourceTorchingTrees:
+                spot.calculateSpottingDistanceFromTorchingTreesBatch(spotInputs, spotOutputs, numberOfThreads);
+                break;
+            default:
+                return setError(BehaveStatusInvalidArgument, "unknown spot source");
+        }
+        return BehaveStatusOk;
+    BEHAVE_C_API_CATCH
+}
+
+BehaveStatus behaveCalculateMortalityBatch(const BehaveEngine* engine, const BehaveMortalityStandInputs* standInputs,
+    const BehaveMortalityBatchInputs* inputs, BehaveMortalityBatchOutputs* outputs,
+    BehaveMortalityStandTotals* standTotals, int numberOfThreads)
+{
+    if(!engine || !standInputs || !inputs || !outputs || inputs->numberOfTrees < 0 || !inputs->speciesTableIndex)
+    {
+        return setError(BehaveStatusInvalidArgument, "missing engine, mortality inputs or outputs");
+    }
+    BEHAVE_C_API_TRY
+        const int count = inputs->numberOfTrees;
+        EnumArray<EquationType> equationType(inputs->equationType, count);
+        EnumArray<FlameLengthOrScorchHeightSwitch> flameLengthOrScorchHeightSwitch(inputs->flameLengthOrScorchHeightSwitch, count);
+        EnumArray<BeetleDamage> beetleDamage(inputs->beetleDamage, count);
+
+        MortalityBatchInputs mortalityInputs;
+        mortalityInputs.numberOfTrees = count;
+        mortalityInputs.speciesTableIndex = inputs->speciesTableIndex;
+        mortalityInputs.equationType = equationType.data();
+        mortalityInputs.treeDensityPerAcre = inputs->treeDensityPerAcre;
+        mortalityInputs.dbh = inputs->dbh;
+        mortalityInputs.treeHeight = inputs->treeHeight;
+        mortalityInputs.crownRatio = inputs->crownRatio;
+        mortalityInputs.flameLengthOrScorchHeightSwitch = flameLengthOrScorchHeightSwitch.data();
+        mortalityInputs.flameLengthOrScorchHeightValue = inputs->flameLengthOrScorchHeightValue;
+        mortalityInputs.crownDamage = inputs->crownDamage;
+        mortalityInputs.cambiumKillRating = inputs->cambiumKillRating;
+        mortalityInputs.beetleDamage = beetleDamage.data();
+        mortalityInputs.boleCharHeight = inputs->boleCharHeight;
+
+        MortalityBatchOutputs mortalityOutputs;
+        mortalityOutputs.probabilityOfMortality = outputs->probabilityOfMortality;
+        mortalityOutputs.barkThickness = outputs->barkThickness;
+        mortalityOutputs.killedTrees = outputs->killedTrees;
+
+        Mortality mortality(engine->speciesMasterTable);
+        mortality.setRegion(static_cast<RegionCode>(standInputs->region));
+        mortality.setFireSeverity(static_cast<FireSeverity>(standInputs->fireSeverity));
+        MortalityStandTotals totals = mortality.calculateMortalityBatch(mortalityInputs, mortalityOutputs, numberOfThreads);
+
+        if(standTotals)
+        {
+            standTotals->numberOfTrees = totals.numberOfTrees;
+            standTotals->numberOfErrors = totals.numberOfErrors;
+            standTotals->totalPrefireTrees = totals.totalPrefireTrees;
+            standTotals->totalKilledTrees = totals.totalKilledTrees;
+            standTotals->averageProbabilityOfMortality = totals.averageProbabilityOfMortality;
+            standTotals->averageProbabilityOfMortalityGreaterThan4DBH = totals.averageProbabilityOfMortalityGreaterThan4DBH;
+            standTotals->averageDBHKilled = totals.averageDBHKilled;
+            standTotals->basalAreaPrefire = totals.basalAreaPrefire;
+            standTotals->basalAreaKilled = totals.basalAreaKilled;
+            standTotals->basalAreaPostfire = totals.basalAreaPostfire;
+            standTotals->prefireCanopyCover = totals.prefireCanopyCover;
+            standTotals->postfireCanopyCover = totals.postfireCanopyCover;
+        }
+        return BehaveStatusOk;
+    BEHAVE_C_API_CATCH
+}
+
+BehaveStatus behaveDoContainRunBatch(const BehaveEngine* engine, const BehaveContainResources* resources,
+    const BehaveContainBatchInputs* inputs, BehaveContainBatchOutputs* outputs, int numberOfThreads)
+{
+    if(!engine || !resources || !inputs || !outputs || resources->numberOfResources < 0 || inputs->numberOfFires < 0
+        || (resources->numberOfResources > 0 && (!resources->arrival || !resources->duration || !resources->productionRate))
+        || !inputs->reportSize || !inputs->reportRate || !inputs->lwRatio)
+    {
+        return setError(BehaveStatusInvalidArgument, "missing engine, contain resources, inputs or outputs");
+    }
+    BEHAVE_C_API_TRY
+        ContainAdapter prototype;
+        for(int i = 0; i < resources->numberOfResources; i++)
+        {
+            prototype.addResource(resources->arrival[i], resources->duration[i], TimeUnits::Minutes,
+                resources->productionRate[i], SpeedUnits::FeetPerMinute, "",
+                resources->baseCost ? resources->baseCost[i] : 0.0, resources->hourCost ? resources->hourCost[i] : 0.0);
+        }
+        prototype.setKeepPerimeter(false);
+
+        if(numberOfThreads <= 0)
+        {
+            numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+        }
+        // Each fire is a whole simulation, so chunks are kept small for an even load
+        const long chunkSize = 16;
+        long numberOfChunks = (inputs->numberOfFires + chunkSize - 1) / chunkSize;
+        numberOfThreads = (int)std::max(1L, std::min((long)numberOfThreads, numberOfChunks));
+
+        std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+        int numberOfSlots = threadPool->getNumberOfSlots(numberOfThreads);
+        std::vector<ContainAdapter> workers(numberOfSlots, prototype);
+        threadPool->runChunks(inputs->numberOfFires, chunkSize, [&](int slot, long begin, long end)
+        {
+            ContainAdapter& worker = workers[slot];
+            for(long i = begin; i < end; i++)
+            {
+                worker.setReportSize(inputs->reportSize[i], AreaUnits::SquareFeet);
+                worker.setReportRate(inputs->reportRate[i], SpeedUnits::FeetPerMinute);
+                worker.setLwRatio(inputs->lwRatio[i]);
+                worker.setTactic(inputs->tactic ? static_cast<ContainTactic::ContainTacticEnum>(inputs->tactic[i])
+                    : ContainTactic::HeadAttack);
+                worker.setAttackDistance(inputs->attackDistance ? inputs->attackDistance[i] : 0.0, LengthUnits::Feet);
+                worker.doContainRun();
+
+                if(outputs->containmentStatus)
+                {
+                    outputs->containmentStatus[i] = worker.getContainmentStatus();
+                }
+                if(outputs->finalFireLineLength)
+                {
+                    outputs->finalFireLineLength[i] = worker.getFinalFireLineLength(LengthUnits::Feet);
+                }
+                if(outputs->finalFireSize)
+                {
+                    outputs->finalFireSize[i] = worker.getFinalFireSize(AreaUnits::SquareFeet);
+                }
+                if(outputs->finalContainmentArea)
+                {
+                    outputs->finalContainmentArea[i] = worker.getFinalContainmentArea(AreaUnits::SquareFeet);
+                }
+                if(outputs->finalTimeSinceReport)
+                {
+                    outputs->finalTimeSinceReport[i] = worker.getFinalTimeSinceReport(TimeUnits::Minutes);
+                }
+                if(outputs->finalCost)
+                {
+                    outputs->finalCost[i] = worker.getFinalCost();
+                }
+            }
+        }, numberOfSlots);
+        return BehaveStatusOk;
+    BEHAVE_C_API_CATCH
+}
@@ -0,0 +1,281 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  C interface over shared fuel models and species data with batch
+*           entry points for surface, crown, spot, mortality and contain runs
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#ifndef BEHAVECAPI_H
+#define BEHAVECAPI_H
+
+/* C interface for embedding behave in other runtimes. Everything here is plain C so it can be
+   bound through cgo, ctypes, cffi or similar without a C++ compiler. An engine handle owns the
+   standard fuel models and the species master table, which are built once when the engine is
+   created and only read afterwards, so the batch calls below may be made on one engine from
+   several threads at once. Each batch call takes structure-of-arrays buffers in base units and
+   covers a whole set of cells, sources, trees or fires in a single call.
+
+   Every batch call returns BehaveStatusOk or an error status, the message for the most recent
+   error on the calling thread is available from behaveGetLastErrorMessage(). Enumerated inputs
+   and outputs are passed as ints holding the values of the matching C++ enums. */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BehaveEngine BehaveEngine;
+
+typedef enum BehaveStatus
+{
+    BehaveStatusOk = 0,
+    BehaveStatusInvalidArgument = 1,    /* null engine, null required array or negative count */
+    BehaveStatusError = 2               /* the calculation failed, see behaveGetLastErrorMessage() */
+} BehaveStatus;
+
+/* Surface inputs, each array holds numberOfCells values: moistures as fractions, wind speed at
+   twenty feet in ft/min, slope in degrees, canopy height in ft, wind and aspect directions in
+   degrees relative to north. Every array is required. */
+typedef struct BehaveSurfaceBatchInputs
+{
+    int numberOfCells;
+    const int* fuelModelNumber;
+    const double* moistureOneHour;
+    const double* moistureTenHour;
+    const double* moistureHundredHour;
+    const double* moistureLiveHerbaceous;
+    const double* moistureLiveWoody;
+    const double* windSpeed;
+    const double* windDirection;
+    const double* slope;
+    const double* aspect;
+    const double* canopyCover;
+    const double* canopyHeight;
+    const double* crownRatio;
+} BehaveSurfaceBatchInputs;
+
+/* Surface outputs, each sized for numberOfCells values: spread rate in ft/min, fireline intensity
+   in btu/ft/s, flame length in ft. Any array may be null. */
+typedef struct BehaveSurfaceBatchOutputs
+{
+    double* spreadRate;
+    double* firelineIntensity;
+    double* flameLength;
+    double* directionOfMaxSpread;
+    double* fireLengthToWidthRatio;
+} BehaveSurfaceBatchOutputs;
+
+/* Crown inputs, the surface inputs plus canopy base height in ft, canopy bulk density in lb/ft^3
+   and foliar moisture as a fraction, each for surfaceInputs.numberOfCells values. */
+typedef struct BehaveCrownBatchInputs
+{
+    BehaveSurfaceBatchInputs surfaceInputs;
+    const double* canopyBaseHeight;
+    const double* canopyBulkDensity;
+    const double* moistureFoliar;
+} BehaveCrownBatchInputs;
+
+/* Crown outputs of the Scott and Reinhardt method, each sized for numberOfCells values: fire type
+   as a FireType value, spread rates in ft/min, heat per unit area in btu/ft^2, fireline intensity
+   in btu/ft/s, flame length in ft, torching and crowning indices as 20 ft wind speeds in ft/min.
+   Any array may be null, a null torching index array also skips its search. */
+typedef struct BehaveCrownBatchOutputs
+{
+    int* fireType;
+    double* crownFractionBurned;
+    double* crownFireSpreadRate;
+    double* finalSpreadRate;
+    double* finalHeatPerUnitArea;
+    double* finalFirelineIntensity;
+    double* finalFlameLength;
+    double* torchingIndex;
+    double* crowningIndex;
+} BehaveCrownBatchOutputs;
+
+typedef enum BehaveSpotSource
+{
+    BehaveSpotSourceBurningPile = 0,
+    BehaveSpotSourceSurfaceFire = 1,
+    BehaveSpotSourceTorchingTrees = 2
+} BehaveSpotSource;
+
+/* Firebrand sources, each array holds numberOfSources values: heights, flame lengths, cover
+   heights and ridge to valley distance and elevation in ft, wind speed at twenty feet in ft/min
+   and DBH in inches. Tree species, canopy mode and location hold SpotTreeSpecies,
+   SpotDownWindCanopyMode and SpotFireLocation values. Only the arrays the source type uses are
+   read, and any array may be null, every source then uses the default of a new Spot. */
+typedef struct BehaveSpotBatchInputs
+{
+    int numberOfSources;
+    const double* burningPileFlameHeight;
+    const double* flameLength;
+    const int* torchingTrees;
+    const double* dbh;
+    const double* treeHeight;
+    const int* treeSpecies;
+    const double* windSpeedAtTwentyFeet;
+    const double* downwindCoverHeight;
+    const int* downwindCanopyMode;
+    const int* location;
+    const double* ridgeToValleyDistance;
+    const double* ridgeToValleyElevation;
+} BehaveSpotBatchInputs;
+
+/* Spotting outputs in ft, each sized for numberOfSources values. Any array may be null. */
+typedef struct BehaveSpotBatchOutputs
+{
+    double* firebrandHeight;
+    double* flatDistance;
+    double* mountainDistance;
+} BehaveSpotBatchOutputs;
+
+/* Stand-wide mortality inputs shared by every tree of a batch: region as a RegionCode value and
+   fire severity as a FireSeverity value. */
+typedef struct BehaveMortalityStandInputs
+{
+    int region;
+    int fireSeverity;
+} BehaveMortalityStandInputs;
+
+/* Tree list, each array holds numberOfTrees values. Species are given by species master table
+   index. DBH is in inches, heights and flame length or scorch height in ft, crown ratio as a
+   fraction, crown damage in percent and tree density in trees per acre. Equation type, flame
+   length or scorch height switch and beetle damage hold the values of the matching C++ enums.
+   Any array other than speciesTableIndex may be null, every tree then uses the default of a new
+   Mortality (and the species record's equation type when equationType is null). */
+typedef struct BehaveMortalityBatchInputs
+{
+    int numberOfTrees;
+    const int* speciesTableIndex;
+    const int* equationType;
+    const double* treeDensityPerAcre;
+    const double* dbh;
+    const double* treeHeight;
+    const double* crownRatio;
+    const int* flameLengthOrScorchHeightSwitch;
+    const double* flameLengthOrScorchHeightValue;
+    const double* crownDamage;
+    const double* cambiumKillRating;
+    const int* beetleDamage;
+    const double* boleCharHeight;
+} BehaveMortalityBatchInputs;
+
+/* Mortality outputs, each sized for numberOfTrees values: probability of mortality as a fraction
+   (-1 when it can't be calculated), bark thickness in inches (-1 when the tree's equation doesn't
+   use it) and killed trees per acre. Any array may be null. */
+typedef struct BehaveMortalityBatchOutputs
+{
+    double* probabilityOfMortality;
+    double* barkThickness;
+    double* killedTrees;
+} BehaveMortalityBatchOutputs;
+
+/* Stand totals over the trees of a batch with a valid probability of mortality */
+typedef struct BehaveMortalityStandTotals
+{
+    int numberOfTrees;
+    int numberOfErrors;
+    double totalPrefireTrees;                   /* trees per acre */
+    double totalKilledTrees;                    /* trees per acre */
+    double averageProbabilityOfMortality;       /* fraction */
+    double averageProbabilityOfMortalityGreaterThan4DBH; /* fraction */
+    double averageDBHKilled;                    /* inches */
+    double basalAreaPrefire;                    /* square feet per acre */
+    double basalAreaKilled;                     /* square feet per acre */
+    double basalAreaPostfire;                   /* square feet per acre */
+    double prefireCanopyCover;                  /* percent */
+    double postfireCanopyCover;                 /* percent */
+} BehaveMortalityStandTotals;
+
+/* Containment resources shared by every fire of a batch, each array holds numberOfResources
+   values: arrival time and duration in minutes, line production rate in ft/min, base cost and
+   hourly cost. The cost arrays may be null for no cost. */
+typedef struct BehaveContainResources
+{
+    int numberOfResources;
+    const double* arrival;
+    const double* duration;
+    const double* productionRate;
+    const double* baseCost;
+    const double* hourCost;
+} BehaveContainResources;
+
+/* Fires to contain, each array holds numberOfFires values: fire size at report in ft^2, spread
+   rate at report in ft/min, length to width ratio, tactic as a ContainTactic value and attack
+   distance in ft. The tactic and attack distance arrays may be null for a head attack at the
+   fire perimeter, the others are required. */
+typedef struct BehaveContainBatchInputs
+{
+    int numberOfFires;
+    const double* reportSize;
+    const double* reportRate;
+    const double* lwRatio;
+    const int* tactic;
+    const double* attackDistance;
+} BehaveContainBatchInputs;
+
+/* Containment outputs, each sized for numberOfFires values: status as a ContainStatus value,
+   final fire line length in ft, fire size and contained area in ft^2, time from report in
+   minutes and final cost. Any array may be null. */
+typedef struct BehaveContainBatchOutputs
+{
+    int* containmentStatus;
+    double* finalFireLineLength;
+    double* finalFireSize;
+    double* finalContainmentArea;
+    double* finalTimeSinceReport;
+    double* finalCost;
+} BehaveContainBatchOutputs;
+
+/* Returns null if the engine could not be created */
+BehaveEngine* behaveCreateEngine(void);
+void behaveDestroyEngine(BehaveEngine* engine);
+
+/* Message for the most recent error on the calling thread, empty if there was none */
+const char* behaveGetLastErrorMessage(void);
+
+/* Number of records in the engine's species master table, for speciesTableIndex bounds */
+int behaveGetNumberOfSpecies(const BehaveEngine* engine);
+/* Species master table index of a species code, -1 if there is none */
+int behaveGetSpeciesTableIndex(const BehaveEngine* engine, const char* speciesCode);
+
+BehaveStatus behaveDoSurfaceRunBatch(const BehaveEngine* engine, const BehaveSurfaceBatchInputs* inputs,
+    BehaveSurfaceBatchOutputs* outputs);
+BehaveStatus behaveDoCrownRunBatchScottAndReinhardt(const BehaveEngine* engine, const BehaveCrownBatchInputs* inputs,
+    BehaveCrownBatchOutputs* outputs);
+/* numberOfThreads of 0 uses one thread per hardware thread */
+BehaveStatus behaveCalculateSpottingDistanceBatch(const BehaveEngine* engine, BehaveSpotSource source,
+    const BehaveSpotBatchInputs* inputs, BehaveSpotBatchOutputs* outputs, int numberOfThreads);
+/* standTotals may be null */
+BehaveStatus behaveCalculateMortalityBatch(const BehaveEngine* engine, const BehaveMortalityStandInputs* standInputs,
+    const BehaveMortalityBatchInputs* inputs, BehaveMortalityBatchOutputs* outputs,
+    BehaveMortalityStandTotals* standTotals, int numberOfThreads);
+BehaveStatus behaveDoContainRunBatch(const BehaveEngine* engine, const BehaveContainResources* resources,
+    const BehaveContainBatchInputs* inputs, BehaveContainBatchOutputs* outputs, int numberOfThreads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BEHAVECAPI_H
@@ -28,15 +28,34 @@
 
 #include "behaveRun.h"
 
+#include <algorithm>
+#include <vector>
 #include "fuelModels.h"
+#include "resultCache.h"
 
-BehaveRun::BehaveRun(FuelModels& fuelModels, SpeciesMasterTable& speciesMasterTable)
+namespace
+{
+
+// The surface fire inputs of a fused run's mortality, scorch height coming from them as it would from a
+// mortality run with the flame length entered
+void setFusedMortalityFire(Mortality& mortality, double flameLength, double firelineIntensity, double midflameWindSpeed)
+{
+    mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::flame_length);
+    mortality.setFlameLength(flameLength, LengthUnits::Feet);
+    mortality.setFirelineIntensity(firelineIntensity, FirelineIntensityUnits::BtusPerFootPerSecond);
+    mortality.setMidFlameWindSpeed(midflameWindSpeed, SpeedUnits::FeetPerMinute);
+}
+
+} // namespace
+
+BehaveRun::BehaveRun(const FuelModels& fuelModels, SpeciesMasterTable& speciesMasterTable)
     : surface(fuelModels),
     crown(fuelModels),
     mortality(speciesMasterTable)
 {
     fuelModels_ = &fuelModels;
     speciesMasterTable_ = &speciesMasterTable;
+    resultCache_ = nullptr;
 }
 
 BehaveRun::BehaveRun(const BehaveRun& rhs)
@@ -44,6 +63,7 @@ BehaveRun::BehaveRun(const BehaveRun& rhs)
     crown(*rhs.fuelModels_),
     mortality(*rhs.speciesMasterTable_)
 {
+    speciesMasterTable_ = rhs.speciesMasterTable_;
     memberwiseCopyAssignment(rhs);
 }
 
@@ -59,6 +79,7 @@ BehaveRun& BehaveRun::operator=(const BehaveRun& rhs)
 void BehaveRun::memberwiseCopyAssignment(const BehaveRun& rhs)
 {
     setFuelModels(*rhs.fuelModels_);
+    resultCache_ = rhs.resultCache_;
     surface = rhs.surface;
     crown = rhs.crown;
     spot = rhs.spot;
@@ -78,7 +99,7 @@ void BehaveRun::reinitialize()
     safety.initializeMembers();
 }
 
-void BehaveRun::setFuelModels(FuelModels& fuelModels)
+void BehaveRun::setFuelModels(const FuelModels& fuelModels)
 {
     // makes this behaveRun's fuelModels_ point to the FuelModels given to this method as a parameter
     fuelModels_ = &fuelModels;
@@ -86,17 +107,322 @@ void BehaveRun::setFuelModels(FuelModels& fuelModels)
     crown.setFuelModels(fuelModels);
 }
 
-void BehaveRun::setMoistureScenarios(MoistureScenarios& moistureScenarios)
+void BehaveRun::setResultCache(ResultCache* resultCache)
+{
+    resultCache_ = resultCache;
+}
+
+const FuelModels& BehaveRun::getFuelModels() const
+{
+    return *fuelModels_;
+}
+
+void BehaveRun::setMoistureScenarios(const MoistureScenarios& moistureScenarios)
 {
     surface.setMoistureScenarios(moistureScenarios);
     crown.setMoistureScenarios(moistureScenarios);
 }
 
+BehaveRunSnapshot::BehaveRunSnapshot(const FuelModels& fuelModels)
+    : fuelModels_(&fuelModels),
+    fuelModelsRevision_(0),
+    surface_(fuelModels),
+    crown_(fuelModels)
+{
+}
+
+void BehaveRun::takeSnapshot(BehaveRunSnapshot& snapshot) const
+{
+    snapshot.fuelModels_ = fuelModels_;
+    snapshot.fuelModelsRevision_ = fuelModels_->getRevision();
+    snapshot.surface_.copyStateWithoutCaches(surface);
+    snapshot.crown_.copyStateWithoutCaches(crown);
+    snapshot.spot_ = spot;
+    snapshot.ignite_ = ignite;
+    snapshot.safety_ = safety;
+}
+
+void BehaveRun::restoreSnapshot(const BehaveRunSnapshot& snapshot)
+{
+    surface.copyStateWithoutCaches(snapshot.surface_);
+    crown.copyStateWithoutCaches(snapshot.crown_);
+    spot = snapshot.spot_;
+    ignite = snapshot.ignite_;
+    safety = snapshot.safety_;
+}
+
+int BehaveRun::getModulesWithChangedInputs(const BehaveRunSnapshot& snapshot) const
+{
+    bool isFuelModelsChanged = (snapshot.fuelModels_ != fuelModels_) || (snapshot.fuelModelsRevision_ != fuelModels_->getRevision());
+    int changedModules = BehaveRunModule::None;
+    if (isFuelModelsChanged || !surface.hasSameInputs(snapshot.surface_))
+    {
+        changedModules |= BehaveRunModule::Surface;
+    }
+    if (isFuelModelsChanged || !crown.hasSameInputs(snapshot.crown_))
+    {
+        changedModules |= BehaveRunModule::Crown;
+    }
+    if (!spot.hasSameInputs(snapshot.spot_))
+    {
+        changedModules |= BehaveRunModule::Spot;
+    }
+    if (!ignite.hasSameInputs(snapshot.ignite_))
+    {
+        changedModules |= BehaveRunModule::Ignite;
+    }
+    if (!safety.hasSameInputs(snapshot.safety_))
+    {
+        changedModules |= BehaveRunModule::Safety;
+    }
+    return changedModules;
+}
+
+int BehaveRun::restoreModulesWithUnchangedInputs(const BehaveRunSnapshot& snapshot)
+{
+    int changedModules = getModulesWithChangedInputs(snapshot);
+    if (!(changedModules & BehaveRunModule::Surface))
+    {
+        surface.copyStateWithoutCaches(snapshot.surface_);
+    }
+    if (!(changedModules & BehaveRunModule::Crown))
+    {
+        crown.copyStateWithoutCaches(snapshot.crown_);
+    }
+    if (!(changedModules & BehaveRunModule::Spot))
+    {
+        spot = snapshot.spot_;
+    }
+    if (!(changedModules & BehaveRunModule::Ignite))
+    {
+        ignite = snapshot.ignite_;
+    }
+    if (!(changedModules & BehaveRunModule::Safety))
+    {
+        safety = snapshot.safety_;
+    }
+    return changedModules;
+}
+
+void BehaveRun::doTimeSeriesRun(const BehaveTimeSeriesLocation& location, const BehaveTimeSeriesWeather& weather,
+    BehaveTimeSeriesOutputs& outputs)
+{
+    if(weather.numberOfHours <= 0)
+    {
+        return;
+    }
+
+    bool isBurnable = crown.isFuelModelDefined(location.fuelModelNumber) && !crown.isAllFuelLoadZero(location.fuelModelNumber);
+    bool wasReusingCrownFuelModel = crown.getIsReusingCrownFuelModel();
+    crown.setIsReusingCrownFuelModel(true);
+
+    double canopyHeight = location.canopyHeight;
+    double canopyBaseHeight = location.canopyBaseHeight;
+    double crownRatio = (canopyHeight > 0.0) ? (canopyHeight - canopyBaseHeight) / canopyHeight : 0.0;
+
+    crown.updateCrownInputs(location.fuelModelNumber, weather.moistureOneHour[0], weather.moistureTenHour[0],
+        weather.moistureHundredHour[0], weather.moistureLiveHerbaceous[0], weather.moistureLiveWoody[0],
+        weather.moistureFoliar[0], FractionUnits::Fraction, weather.windSpeed[0], SpeedUnits::FeetPerMinute,
+        location.windHeightInputMode, weather.windDirection[0], location.windAndSpreadOrientationMode, location.slope,
+        SlopeUnits::Degrees, location.aspect, location.canopyCover, FractionUnits::Fraction, canopyHeight,
+        canopyBaseHeight, LengthUnits::Feet, crownRatio, FractionUnits::Fraction, location.canopyBulkDensity,
+        DensityUnits::PoundsPerCubicFoot);
+
+    for(int hour = 0; hour < weather.numberOfHours; hour++)
+    {
+        if(hour > 0)
+        {
+            crown.setWindSpeed(weather.windSpeed[hour], SpeedUnits::FeetPerMinute, location.windHeightInputMode);
+            crown.setWindDirection(weather.windDirection[hour]);
+            crown.setMoistureOneHour(weather.moistureOneHour[hour], FractionUnits::Fraction);
+            crown.setMoistureTenHour(weather.moistureTenHour[hour], FractionUnits::Fraction);
+            crown.setMoistureHundredHour(weather.moistureHundredHour[hour], FractionUnits::Fraction);
+            crown.setMoistureLiveHerbaceous(weather.moistureLiveHerbaceous[hour], FractionUnits::Fraction);
+            crown.setMoistureLiveWoody(weather.moistureLiveWoody[hour], FractionUnits::Fraction);
+            crown.setMoistureFoliar(weather.moistureFoliar[hour], FractionUnits::Fraction);
+        }
+
+        double spreadRate = 0.0;
+        double flameLength = 0.0;
+        double firelineIntensity = 0.0;
+        int fireType = FireType::Surface;
+        double crownFractionBurned = 0.0;
+        double lengthToWidthRatio = 1.0;
+
+        ResultCacheKey key = {};
+        ResultCacheRecord record;
+        bool isCached = false;
+        if(isBurnable && resultCache_ && !outputs.lengthToWidthRatio)
+        {
+            ResultCacheKeyBuilder keyBuilder;
+            keyBuilder.addCrownRun(crown, location.crownFireMethod, location.windAndSpreadOrientationMode);
+            key = keyBuilder.getKey();
+            isCached = resultCache_->find(key, record) && record.numberOfValues == ResultCacheRecord::NumberOfCrownRunValues;
+        }
+
+        if(isCached)
+        {
+            spreadRate = record.values[0];
+            flameLength = record.values[1];
+            firelineIntensity = record.values[2];
+            fireType = (int)record.values[3];
+            crownFractionBurned = record.values[4];
+        }
+        else if(isBurnable)
+        {
+            if(location.crownFireMethod == TimeSeriesCrownFireMethod::Rothermel)
+            {
+                crown.doCrownRunRothermel();
+            }
+            else
+            {
+                crown.doCrownRunScottAndReinhardt();
+            }
+
+            spreadRate = crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+            flameLength = crown.getFinalFlameLength(LengthUnits::Feet);
+            firelineIntensity = crown.getFinalFirelineIntesity(FirelineIntensityUnits::BtusPerFootPerSecond);
+            fireType = crown.getFireType();
+            crownFractionBurned = crown.getCrownFractionBurned();
+            lengthToWidthRatio = (fireType == FireType::Crowning) ? crown.getCrownFireLengthToWidthRatio() :
+                crown.getSurfaceFireLengthToWidthRatio();
+            if(resultCache_)
+            {
+                ResultCacheRecord computed = { ResultCacheRecord::NumberOfCrownRunValues,
+                    { spreadRate, flameLength, firelineIntensity, (double)fireType, crownFractionBurned } };
+                resultCache_->insert(key, computed);
+            }
+        }
+
+        if(outputs.spreadRate)
+        {
+            outputs.spreadRate[hour] = spreadRate;
+        }
+        if(outputs.flameLength)
+        {
+            outputs.flameLength[hour] = flameLength;
+        }
+        if(outputs.firelineIntensity)
+        {
+            outputs.firelineIntensity[hour] = firelineIntensity;
+        }
+        if(outputs.fireType)
+        {
+            outputs.fireType[hour] = fireType;
+        }
+        if(outputs.crownFractionBurned)
+        {
+            outputs.crownFractionBurned[hour] = crownFractionBurned;
+        }
+        if(outputs.lengthToWidthRatio)
+        {
+            outputs.lengthToWidthRatio[hour] = lengthToWidthRatio;
+        }
+    }
+
+    crown.setIsReusingCrownFuelModel(wasReusingCrownFuelModel);
+}
+
+void BehaveRun::doFusedSurfaceRun()
+{
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+
+    // Base unit intermediates of the surface run, the wind at twenty feet from its wind adjustment factor
+    double flameLength = surface.getFlameLength(LengthUnits::Feet);
+    double firelineIntensity = surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond);
+    double midflameWindSpeed = surface.getMidflameWindspeed(SpeedUnits::FeetPerMinute);
+    double windSpeedAtTwentyFeet = surface.getWindSpeed(SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
+
+    spot.setFlameLength(flameLength, LengthUnits::Feet);
+    spot.setWindSpeedAtTwentyFeet(windSpeedAtTwentyFeet, SpeedUnits::FeetPerMinute);
+    spot.calculateSpottingDistanceFromSurfaceFire();
+
+    setFusedMortalityFire(mortality, flameLength, firelineIntensity, midflameWindSpeed);
+    mortality.calculateMortality(FractionUnits::Fraction);
+
+    safety.setFlameHeight(flameLength, LengthUnits::Feet);
+    safety.calculateSafetyZone();
+}
+
+void BehaveRun::doFusedSurfaceRunBatch(const SurfaceBatchInputs& inputs, BehaveFusedBatchOutputs& outputs)
+{
+    const int numberOfCells = inputs.numberOfCells;
+    if(numberOfCells <= 0)
+    {
+        return;
+    }
+
+    // The flame length and winds are needed downstream whether or not they are asked for
+    std::vector<double> spreadRate(numberOfCells);
+    std::vector<double> firelineIntensity(numberOfCells);
+    std::vector<double> flameLength(numberOfCells);
+    std::vector<double> midflameWindSpeed(numberOfCells);
+    std::vector<double> windSpeedAtTwentyFeet(numberOfCells);
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        // The cells are run one at a time so the surface getters also report each cell's winds
+        SurfaceBatchInputs cellInputs = { 1, inputs.fuelModelNumber + i, inputs.moistureOneHour + i, inputs.moistureTenHour + i,
+            inputs.moistureHundredHour + i, inputs.moistureLiveHerbaceous + i, inputs.moistureLiveWoody + i, inputs.windSpeed + i,
+            inputs.windDirection + i, inputs.slope + i, inputs.aspect + i, inputs.canopyCover + i, inputs.canopyHeight + i,
+            inputs.crownRatio + i };
+        SurfaceBatchOutputs cellOutputs = { &spreadRate[i], &firelineIntensity[i], &flameLength[i], nullptr, nullptr };
+        surface.doSurfaceRunBatch(cellInputs, cellOutputs);
+        midflameWindSpeed[i] = surface.getMidflameWindspeed(SpeedUnits::FeetPerMinute);
+        windSpeedAtTwentyFeet[i] = surface.getWindSpeed(SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
+    }
+    if(outputs.spreadRate)
+    {
+        std::copy(spreadRate.begin(), spreadRate.end(), outputs.spreadRate);
+    }
+    if(outputs.firelineIntensity)
+    {
+        std::copy(firelineIntensity.begin(), firelineIntensity.end(), outputs.firelineIntensity);
+    }
+    if(outputs.flameLength)
+    {
+        std::copy(flameLength.begin(), flameLength.end(), outputs.flameLength);
+    }
+
+    if(outputs.firebrandHeight || outputs.spotFlatDistance || outputs.spotMountainDistance)
+    {
+        SpotBatchInputs spotInputs = { numberOfCells, nullptr, flameLength.data(), nullptr, nullptr, nullptr, nullptr,
+            windSpeedAtTwentyFeet.data(), nullptr, nullptr, nullptr, nullptr, nullptr };
+        SpotBatchOutputs spotOutputs = { outputs.firebrandHeight, outputs.spotFlatDistance, outputs.spotMountainDistance };
+        spot.calculateSpottingDistanceFromSurfaceFireBatch(spotInputs, spotOutputs, 1);
+    }
+
+    if(outputs.scorchHeight || outputs.probabilityOfMortality)
+    {
+        // A copy, so the mortality module keeps its own fire inputs and outputs
+        Mortality cellMortality(mortality);
+        for(int i = 0; i < numberOfCells; i++)
+        {
+            setFusedMortalityFire(cellMortality, flameLength[i], firelineIntensity[i], midflameWindSpeed[i]);
+            if(outputs.scorchHeight)
+            {
+                outputs.scorchHeight[i] = cellMortality.getScorchHeight(LengthUnits::Feet);
+            }
+            if(outputs.probabilityOfMortality)
+            {
+                outputs.probabilityOfMortality[i] = cellMortality.calculateMortality(FractionUnits::Fraction);
+            }
+        }
+    }
+
+    SafetyBatchOutputs safetyOutputs = { outputs.separationDistance, outputs.safetyZoneRadius, outputs.safetyZoneArea };
+    safety.calculateSafetyZonesBatch(flameLength.data(), numberOfCells, safetyOutputs);
+}
+
 std::string BehaveRun::getFuelCode(int fuelModelNumber) const
 {
     return fuelModels_->getFuelCode(fuelModelNumber);
 }
 
+int BehaveRun::getFuelModelNumberFromFuelCode(std::string fuelCode) const
+{
+    return fuelModels_->getFuelModelNumberFromFuelCode(fuelCode);
+}
+
 std::string BehaveRun::getFuelName(int fuelModelNumber) const
 {
     return fuelModels_->getFuelName(fuelModelNumber);
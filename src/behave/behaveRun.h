@@ -42,12 +42,127 @@
 #include "vaporPressureDeficitCalculator.h"
 
 class FuelModels;
+class ResultCache;
+
+struct TimeSeriesCrownFireMethod
+{
+    enum TimeSeriesCrownFireMethodEnum
+    {
+        Rothermel,
+        ScottAndReinhardt
+    };
+};
+
+// Inputs of a time series that stay the same at one location, in base units: slope and aspect
+// in degrees, canopy cover as a fraction, canopy heights in ft and canopy bulk density in lb/ft^3
+struct BehaveTimeSeriesLocation
+{
+    int fuelModelNumber;
+    double slope;
+    double aspect;
+    double canopyCover;
+    double canopyHeight;
+    double canopyBaseHeight;
+    double canopyBulkDensity;
+
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode;
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode;
+    TimeSeriesCrownFireMethod::TimeSeriesCrownFireMethodEnum crownFireMethod;
+};
+
+// Hourly weather of a time series, each array holding numberOfHours values in base units:
+// wind speed in ft/min at the location's wind height, wind direction in degrees 0-360 and the
+// moistures as fractions
+struct BehaveTimeSeriesWeather
+{
+    int numberOfHours;
+
+    const double* windSpeed;
+    const double* windDirection;
+    const double* moistureOneHour;
+    const double* moistureTenHour;
+    const double* moistureHundredHour;
+    const double* moistureLiveHerbaceous;
+    const double* moistureLiveWoody;
+    const double* moistureFoliar;
+};
+
+// Caller-provided hourly outputs, each sized for numberOfHours values and filled in base units:
+// spread rate in ft/min, flame length in ft, fireline intensity in btu/ft/s. Any array may be
+// null if that output is not needed. The length to width ratio is the crown fire's for an active
+// crown fire and the surface fire's otherwise, as ContainHourlyFire takes it. Result cache records
+// don't hold it, so a run asking for it calculates every hour.
+struct BehaveTimeSeriesOutputs
+{
+    double* spreadRate;
+    double* flameLength;
+    double* firelineIntensity;
+    int* fireType;      // FireType::FireTypeEnum
+    double* crownFractionBurned;
+    double* lengthToWidthRatio;
+};
+
+// Caller-provided outputs of BehaveRun::doFusedSurfaceRunBatch(), each sized for numberOfCells values
+// and filled in base units: spread rate in ft/min, fireline intensity in btu/ft/s, lengths, heights and
+// distances in ft, probability of mortality as a fraction and area in ft^2. Any array may be null if that
+// output is not needed.
+struct BehaveFusedBatchOutputs
+{
+    double* spreadRate;
+    double* firelineIntensity;
+    double* flameLength;
+    double* firebrandHeight;            // spotting from the surface fire
+    double* spotFlatDistance;
+    double* spotMountainDistance;
+    double* scorchHeight;
+    double* probabilityOfMortality;     // of the mortality module's tree, -1 when it has no equation
+    double* separationDistance;         // safety zone with the flame length as flame height
+    double* safetyZoneRadius;
+    double* safetyZoneArea;
+};
+
+// Modules of a BehaveRun, as bits of a mask
+struct BehaveRunModule
+{
+    enum BehaveRunModuleEnum
+    {
+        None = 0,
+        Surface = 1 << 0,
+        Crown = 1 << 1,
+        Spot = 1 << 2,
+        Ignite = 1 << 3,
+        Safety = 1 << 4,
+        All = Surface | Crown | Spot | Ignite | Safety
+    };
+};
+
+// The inputs and results of a BehaveRun's Surface, Crown, Spot, Ignite and Safety modules, for branching
+// what-if runs from a base scenario. Unlike copying a BehaveRun it leaves out the fuelbed, two fuel models
+// and wind adjustment factor caches, which are keyed by their inputs and so stay valid in the run being
+// restored. Once a snapshot has been taken or restored, doing it again only copies values in place.
+// The Contain and Mortality modules and the tools are not included.
+class BehaveRunSnapshot
+{
+public:
+    explicit BehaveRunSnapshot(const FuelModels& fuelModels);
+
+protected:
+    friend class BehaveRun;
+
+    const FuelModels* fuelModels_;
+    unsigned long fuelModelsRevision_;
+    Surface surface_;
+    Crown crown_;
+    Spot spot_;
+    Ignite ignite_;
+    Safety safety_;
+};
 
 class BehaveRun
 {
 public:
     BehaveRun() = delete; // There is no default constructor
-    explicit BehaveRun(FuelModels& fuelModels, SpeciesMasterTable& speciesMasterTable);
+    explicit BehaveRun(const FuelModels& fuelModels, SpeciesMasterTable& speciesMasterTable);
     
     BehaveRun(const BehaveRun& rhs);
     BehaveRun& operator=(const BehaveRun& rhs);
@@ -55,11 +170,46 @@ public:
 
     void reinitialize();
 
-    void setFuelModels(FuelModels& fuelModels);
-    void setMoistureScenarios(MoistureScenarios& moistureScenarios);
+    void setFuelModels(const FuelModels& fuelModels);
+    const FuelModels& getFuelModels() const;
+    void setMoistureScenarios(const MoistureScenarios& moistureScenarios);
+    // Cache that doTimeSeriesRun() looks every hour up in before running it, null for none
+    void setResultCache(ResultCache* resultCache);
+
+    void takeSnapshot(BehaveRunSnapshot& snapshot) const;
+    void restoreSnapshot(const BehaveRunSnapshot& snapshot);
+    // Mask of BehaveRunModule bits for the modules whose inputs are not the same as the snapshot's, a
+    // change to the fuel models counting as a change to the Surface and Crown inputs
+    int getModulesWithChangedInputs(const BehaveRunSnapshot& snapshot) const;
+    // Restores the snapshot into the modules whose inputs are the same as the snapshot's, so their results
+    // are the snapshot's without running them, and returns the mask of the others, which are left for
+    // the caller to run again
+    int restoreModulesWithUnchangedInputs(const BehaveRunSnapshot& snapshot);
+
+    // Runs the crown module, which includes its surface run, for every hour of weather at one
+    // location. The location's inputs are set once and each hour only sets the wind and moistures,
+    // so the fuel model, slope factor, wind adjustment factor and crown fuel model are kept from
+    // hour to hour. Leaves the crown module holding the inputs and outputs of the last hour, its
+    // outputs being those of the last hour calculated when later hours were found in the result cache.
+    void doTimeSeriesRun(const BehaveTimeSeriesLocation& location, const BehaveTimeSeriesWeather& weather,
+        BehaveTimeSeriesOutputs& outputs);
+
+    // Runs the surface fire in the direction of max spread and hands its results on in base units instead
+    // of through each module's unit converting setters: the flame length and the wind at twenty feet the
+    // surface run derived to the spot module's surface fire spotting, the flame length, fireline intensity and
+    // midflame wind speed to the mortality module, which scorch height then comes from, and the flame length
+    // as flame height to the safety module. The mortality module's tree, air temperature and the other
+    // modules' remaining inputs are their current ones. Every module is left holding its inputs and outputs,
+    // so results are read with the modules' getters in any units.
+    void doFusedSurfaceRun();
+    // doFusedSurfaceRun() for every cell of a batch, the surface module running the cells in order as
+    // Surface::doSurfaceRunBatch() does and the spot and safety modules in their batch versions. Only the
+    // surface module is changed, its getters reporting the last cell.
+    void doFusedSurfaceRunBatch(const SurfaceBatchInputs& inputs, BehaveFusedBatchOutputs& outputs);
 
     // Fuel Model Getter Methods
     std::string getFuelCode(int fuelModelNumber) const;
+    int getFuelModelNumberFromFuelCode(std::string fuelCode) const;
     std::string getFuelName(int fuelModelNumber) const;
     double getFuelbedDepth(int fuelModelNumber, LengthUnits::LengthUnitsEnum lengthUnits) const;
     double getFuelMoistureOfExtinctionDead(int fuelModelNumber, FractionUnits::FractionUnitsEnum moistureUnits) const;
@@ -112,10 +262,12 @@ protected:
     void memberwiseCopyAssignment(const BehaveRun& rhs);
 
     // Fuel models (orginal 13, 40 and custom)
-    FuelModels* fuelModels_;
+    const FuelModels* fuelModels_;
 
     // Tree species data for Mortality Module
     SpeciesMasterTable* speciesMasterTable_;
+
+    ResultCache* resultCache_;
 };
 
 #endif //BEHAVERUN_H
@@ -0,0 +1,333 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Demand driven evaluation of a BehaveRun's modules, rerunning
+*           only the outputs whose inputs have changed
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#include "behaveRunEvaluator.h"
+
+BehaveRunEvaluator::BehaveRunEvaluator(BehaveRun& behaveRun)
+    : behaveRun_(behaveRun),
+    snapshot_(behaveRun.getFuelModels()),
+    isSnapshotTaken_(false),
+    crownFireMethod_(EvaluatorCrownFireMethod::ScottAndReinhardt),
+    firebrandHeightFromSurfaceFire_(0.0),
+    flatDistanceFromSurfaceFire_(0.0),
+    mountainDistanceFromSurfaceFire_(0.0),
+    firebrandIgnitionProbability_(0.0),
+    lightningIgnitionProbability_(0.0),
+    separationDistance_(0.0),
+    safetyZoneRadius_(0.0),
+    safetyZoneArea_(0.0)
+{
+    for(int node = 0; node < BehaveRunNode::NumberOfNodes; node++)
+    {
+        isUpToDate_[node] = false;
+        numberOfEvaluations_[node] = 0;
+    }
+}
+
+void BehaveRunEvaluator::setCrownFireMethod(EvaluatorCrownFireMethod::EvaluatorCrownFireMethodEnum crownFireMethod)
+{
+    if(crownFireMethod != crownFireMethod_)
+    {
+        crownFireMethod_ = crownFireMethod;
+        isUpToDate_[BehaveRunNode::CrownFire] = false;
+    }
+}
+
+void BehaveRunEvaluator::invalidate()
+{
+    for(int node = 0; node < BehaveRunNode::NumberOfNodes; node++)
+    {
+        isUpToDate_[node] = false;
+    }
+}
+
+bool BehaveRunEvaluator::isNodeUpToDate(BehaveRunNode::BehaveRunNodeEnum node) const
+{
+    if(!isSnapshotTaken_ || !isUpToDate_[node])
+    {
+        return false;
+    }
+    return (behaveRun_.getModulesWithChangedInputs(snapshot_) & getNodeModules(node)) == 0;
+}
+
+long BehaveRunEvaluator::getNumberOfEvaluations(BehaveRunNode::BehaveRunNodeEnum node) const
+{
+    return numberOfEvaluations_[node];
+}
+
+int BehaveRunEvaluator::getNodeModules(BehaveRunNode::BehaveRunNodeEnum node)
+{
+    // The modules whose inputs a node reads, directly or through the nodes upstream of it
+    switch(node)
+    {
+        case BehaveRunNode::SurfaceFire:
+        {
+            return BehaveRunModule::Surface;
+        }
+        case BehaveRunNode::CrownFire:
+        {
+            return BehaveRunModule::Crown;
+        }
+        case BehaveRunNode::SpotFromSurfaceFire:
+        {
+            return BehaveRunModule::Surface | BehaveRunModule::Spot;
+        }
+        case BehaveRunNode::SpotFromTorchingTrees:
+        case BehaveRunNode::SpotFromBurningPile:
+        {
+            return BehaveRunModule::Spot;
+        }
+        case BehaveRunNode::IgnitionProbability:
+        {
+            return BehaveRunModule::Ignite;
+        }
+        case BehaveRunNode::SafetyZone:
+        {
+            return BehaveRunModule::Surface | BehaveRunModule::Safety;
+        }
+        default:
+        {
+            return BehaveRunModule::All;
+        }
+    }
+}
+
+void BehaveRunEvaluator::evaluate(BehaveRunNode::BehaveRunNodeEnum node)
+{
+    int changedModules = isSnapshotTaken_ ? behaveRun_.getModulesWithChangedInputs(snapshot_) : BehaveRunModule::All;
+    for(int i = 0; i < BehaveRunNode::NumberOfNodes; i++)
+    {
+        if(getNodeModules((BehaveRunNode::BehaveRunNodeEnum)i) & changedModules)
+        {
+            isUpToDate_[i] = false;
+        }
+    }
+    if(isUpToDate_[node])
+    {
+        return;
+    }
+
+    evaluateNode(node);
+
+    // Taken after the runs, a crown run changing its own surface inputs doesn't count as a change next time
+    behaveRun_.takeSnapshot(snapshot_);
+    isSnapshotTaken_ = true;
+}
+
+void BehaveRunEvaluator::evaluateNode(BehaveRunNode::BehaveRunNodeEnum node)
+{
+    if(isUpToDate_[node])
+    {
+        return;
+    }
+    if(node == BehaveRunNode::SpotFromSurfaceFire || node == BehaveRunNode::SafetyZone)
+    {
+        evaluateNode(BehaveRunNode::SurfaceFire);
+    }
+
+    switch(node)
+    {
+        case BehaveRunNode::SurfaceFire:
+        {
+            behaveRun_.surface.doSurfaceRunInDirectionOfMaxSpread();
+            break;
+        }
+        case BehaveRunNode::CrownFire:
+        {
+            if(crownFireMethod_ == EvaluatorCrownFireMethod::Rothermel)
+            {
+                behaveRun_.crown.doCrownRunRothermel();
+            }
+            else
+            {
+                behaveRun_.crown.doCrownRunScottAndReinhardt();
+            }
+            break;
+        }
+        case BehaveRunNode::SpotFromSurfaceFire:
+        {
+            double flameLength = behaveRun_.surface.getFlameLength(LengthUnits::Feet);
+            double windSpeedAtTwentyFeet = behaveRun_.surface.getWindSpeed(SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
+            SpotBatchInputs inputs = { 1, nullptr, &flameLength, nullptr, nullptr, nullptr, nullptr, &windSpeedAtTwentyFeet,
+                nullptr, nullptr, nullptr, nullptr, nullptr };
+            SpotBatchOutputs outputs = { &firebrandHeightFromSurfaceFire_, &flatDistanceFromSurfaceFire_, &mountainDistanceFromSurfaceFire_ };
+            behaveRun_.spot.calculateSpottingDistanceFromSurfaceFireBatch(inputs, outputs, 1);
+            break;
+        }
+        case BehaveRunNode::SpotFromTorchingTrees:
+        {
+            behaveRun_.spot.calculateSpottingDistanceFromTorchingTrees();
+            break;
+        }
+        case BehaveRunNode::SpotFromBurningPile:
+        {
+            behaveRun_.spot.calculateSpottingDistanceFromBurningPile();
+            break;
+        }
+        case BehaveRunNode::IgnitionProbability:
+        {
+            firebrandIgnitionProbability_ = behaveRun_.ignite.calculateFirebrandIgnitionProbability(FractionUnits::Fraction);
+            lightningIgnitionProbability_ = behaveRun_.ignite.calculateLightningIgnitionProbability(FractionUnits::Fraction);
+            break;
+        }
+        case BehaveRunNode::SafetyZone:
+        {
+            double flameHeight = behaveRun_.surface.getFlameLength(LengthUnits::Feet);
+            SafetyBatchOutputs outputs = { &separationDistance_, &safetyZoneRadius_, &safetyZoneArea_ };
+            behaveRun_.safety.calculateSafetyZonesBatch(&flameHeight, 1, outputs);
+            break;
+        }
+        default:
+        {
+            return;
+        }
+    }
+    isUpToDate_[node] = true;
+    numberOfEvaluations_[node]++;
+}
+
+double BehaveRunEvaluator::getSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits)
+{
+    evaluate(BehaveRunNode::SurfaceFire);
+    return behaveRun_.surface.getSpreadRate(spreadRateUnits);
+}
+
+double BehaveRunEvaluator::getFlameLength(LengthUnits::LengthUnitsEnum flameLengthUnits)
+{
+    evaluate(BehaveRunNode::SurfaceFire);
+    return behaveRun_.surface.getFlameLength(flameLengthUnits);
+}
+
+double BehaveRunEvaluator::getFirelineIntensity(FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits)
+{
+    evaluate(BehaveRunNode::SurfaceFire);
+    return behaveRun_.surface.getFirelineIntensity(firelineIntensityUnits);
+}
+
+double BehaveRunEvaluator::getDirectionOfMaxSpread()
+{
+    evaluate(BehaveRunNode::SurfaceFire);
+    return behaveRun_.surface.getDirectionOfMaxSpread();
+}
+
+FireType::FireTypeEnum BehaveRunEvaluator::getFireType()
+{
+    evaluate(BehaveRunNode::CrownFire);
+    return behaveRun_.crown.getFireType();
+}
+
+double BehaveRunEvaluator::getFinalSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits)
+{
+    evaluate(BehaveRunNode::CrownFire);
+    return behaveRun_.crown.getFinalSpreadRate(spreadRateUnits);
+}
+
+double BehaveRunEvaluator::getFinalFlameLength(LengthUnits::LengthUnitsEnum flameLengthUnits)
+{
+    evaluate(BehaveRunNode::CrownFire);
+    return behaveRun_.crown.getFinalFlameLength(flameLengthUnits);
+}
+
+double BehaveRunEvaluator::getCrownFractionBurned()
+{
+    evaluate(BehaveRunNode::CrownFire);
+    return behaveRun_.crown.getCrownFractionBurned();
+}
+
+double BehaveRunEvaluator::getMaxFirebrandHeightFromSurfaceFire(LengthUnits::LengthUnitsEnum firebrandHeightUnits)
+{
+    evaluate(BehaveRunNode::SpotFromSurfaceFire);
+    return LengthUnits::fromBaseUnits(firebrandHeightFromSurfaceFire_, firebrandHeightUnits);
+}
+
+double BehaveRunEvaluator::getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::LengthUnitsEnum spottingDistanceUnits)
+{
+    evaluate(BehaveRunNode::SpotFromSurfaceFire);
+    return LengthUnits::fromBaseUnits(flatDistanceFromSurfaceFire_, spottingDistanceUnits);
+}
+
+double BehaveRunEvaluator::getMaxMountainousTerrainSpottingDistanceFromSurfaceFire(LengthUnits::LengthUnitsEnum spottingDistanceUnits)
+{
+    evaluate(BehaveRunNode::SpotFromSurfaceFire);
+    return LengthUnits::fromBaseUnits(mountainDistanceFromSurfaceFire_, spottingDistanceUnits);
+}
+
+double BehaveRunEvaluator::getMaxFlatTerrainSpottingDistanceFromTorchingTrees(LengthUnits::LengthUnitsEnum spottingDistanceUnits)
+{
+    evaluate(BehaveRunNode::SpotFromTorchingTrees);
+    return behaveRun_.spot.getMaxFlatTerrainSpottingDistanceFromTorchingTrees(spottingDistanceUnits);
+}
+
+double BehaveRunEvaluator::getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(LengthUnits::LengthUnitsEnum spottingDistanceUnits)
+{
+    evaluate(BehaveRunNode::SpotFromTorchingTrees);
+    return behaveRun_.spot.getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(spottingDistanceUnits);
+}
+
+double BehaveRunEvaluator::getMaxFlatTerrainSpottingDistanceFromBurningPile(LengthUnits::LengthUnitsEnum spottingDistanceUnits)
+{
+    evaluate(BehaveRunNode::SpotFromBurningPile);
+    return behaveRun_.spot.getMaxFlatTerrainSpottingDistanceFromBurningPile(spottingDistanceUnits);
+}
+
+double BehaveRunEvaluator::getMaxMountainousTerrainSpottingDistanceFromBurningPile(LengthUnits::LengthUnitsEnum spottingDistanceUnits)
+{
+    evaluate(BehaveRunNode::SpotFromBurningPile);
+    return behaveRun_.spot.getMaxMountainousTerrainSpottingDistanceFromBurningPile(spottingDistanceUnits);
+}
+
+double BehaveRunEvaluator::getFirebrandIgnitionProbability(FractionUnits::FractionUnitsEnum probabilityUnits)
+{
+    evaluate(BehaveRunNode::IgnitionProbability);
+    return FractionUnits::fromBaseUnits(firebrandIgnitionProbability_, probabilityUnits);
+}
+
+double BehaveRunEvaluator::getLightningIgnitionProbability(FractionUnits::FractionUnitsEnum probabilityUnits)
+{
+    evaluate(BehaveRunNode::IgnitionProbability);
+    return FractionUnits::fromBaseUnits(lightningIgnitionProbability_, probabilityUnits);
+}
+
+double BehaveRunEvaluator::getSeparationDistance(LengthUnits::LengthUnitsEnum lengthUnits)
+{
+    evaluate(BehaveRunNode::SafetyZone);
+    return LengthUnits::fromBaseUnits(separationDistance_, lengthUnits);
+}
+
+double BehaveRunEvaluator::getSafetyZoneRadius(LengthUnits::LengthUnitsEnum lengthUnits)
+{
+    evaluate(BehaveRunNode::SafetyZone);
+    return LengthUnits::fromBaseUnits(safetyZoneRadius_, lengthUnits);
+}
+
+double BehaveRunEvaluator::getSafetyZoneArea(AreaUnits::AreaUnitsEnum areaUnits)
+{
+    evaluate(BehaveRunNode::SafetyZone);
+    return AreaUnits::fromBaseUnits(safetyZoneArea_, areaUnits);
+}
@@ -0,0 +1,133 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Demand driven evaluation of a BehaveRun's modules, rerunning
+*           only the outputs whose inputs have changed
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef BEHAVERUNEVALUATOR_H
+#define BEHAVERUNEVALUATOR_H
+
+#include "behaveRun.h"
+
+// Nodes of a BehaveRunEvaluator's dependency graph, each computing one group of outputs
+struct BehaveRunNode
+{
+    enum BehaveRunNodeEnum
+    {
+        SurfaceFire,            // surface run in the direction of max spread
+        CrownFire,              // crown run with the evaluator's crown fire method
+        SpotFromSurfaceFire,    // Spot inputs, with the flame length and twenty foot wind of SurfaceFire
+        SpotFromTorchingTrees,  // Spot inputs
+        SpotFromBurningPile,    // Spot inputs
+        IgnitionProbability,    // Ignite inputs, firebrand and lightning
+        SafetyZone,             // Safety inputs, with the flame length of SurfaceFire as flame height
+        NumberOfNodes
+    };
+};
+
+struct EvaluatorCrownFireMethod
+{
+    enum EvaluatorCrownFireMethodEnum
+    {
+        Rothermel,
+        ScottAndReinhardt
+    };
+};
+
+// Demand driven evaluation of a BehaveRun: asking for an output runs only the nodes it depends on, and
+// each node's results are kept until the inputs of a module it depends on change, as found by comparing
+// the modules with a BehaveRunSnapshot taken after the last evaluation. Inputs are set on the BehaveRun's
+// modules as usual, between calls to the getters.
+//
+// SpotFromSurfaceFire and SafetyZone take the surface fire through the Spot and Safety batch calculations,
+// so the Spot and Safety modules' own inputs and outputs are left unchanged. The other nodes leave their
+// module holding its outputs as its own run would.
+class BehaveRunEvaluator
+{
+public:
+    explicit BehaveRunEvaluator(BehaveRun& behaveRun);
+
+    void setCrownFireMethod(EvaluatorCrownFireMethod::EvaluatorCrownFireMethodEnum crownFireMethod);
+    // Forgets every node's results, for changes the module comparison doesn't see
+    void invalidate();
+    bool isNodeUpToDate(BehaveRunNode::BehaveRunNodeEnum node) const;
+    // Times the node has been evaluated since construction
+    long getNumberOfEvaluations(BehaveRunNode::BehaveRunNodeEnum node) const;
+
+    // SurfaceFire
+    double getSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits);
+    double getFlameLength(LengthUnits::LengthUnitsEnum flameLengthUnits);
+    double getFirelineIntensity(FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits);
+    double getDirectionOfMaxSpread();
+
+    // CrownFire
+    FireType::FireTypeEnum getFireType();
+    double getFinalSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits);
+    double getFinalFlameLength(LengthUnits::LengthUnitsEnum flameLengthUnits);
+    double getCrownFractionBurned();
+
+    // SpotFromSurfaceFire, SpotFromTorchingTrees and SpotFromBurningPile
+    double getMaxFirebrandHeightFromSurfaceFire(LengthUnits::LengthUnitsEnum firebrandHeightUnits);
+    double getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::LengthUnitsEnum spottingDistanceUnits);
+    double getMaxMountainousTerrainSpottingDistanceFromSurfaceFire(LengthUnits::LengthUnitsEnum spottingDistanceUnits);
+    double getMaxFlatTerrainSpottingDistanceFromTorchingTrees(LengthUnits::LengthUnitsEnum spottingDistanceUnits);
+    double getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(LengthUnits::LengthUnitsEnum spottingDistanceUnits);
+    double getMaxFlatTerrainSpottingDistanceFromBurningPile(LengthUnits::LengthUnitsEnum spottingDistanceUnits);
+    double getMaxMountainousTerrainSpottingDistanceFromBurningPile(LengthUnits::LengthUnitsEnum spottingDistanceUnits);
+
+    // IgnitionProbability
+    double getFirebrandIgnitionProbability(FractionUnits::FractionUnitsEnum probabilityUnits);
+    double getLightningIgnitionProbability(FractionUnits::FractionUnitsEnum probabilityUnits);
+
+    // SafetyZone
+    double getSeparationDistance(LengthUnits::LengthUnitsEnum lengthUnits);
+    double getSafetyZoneRadius(LengthUnits::LengthUnitsEnum lengthUnits);
+    double getSafetyZoneArea(AreaUnits::AreaUnitsEnum areaUnits);
+
+protected:
+    // Brings the node up to date, first marking out of date the nodes whose modules changed
+    void evaluate(BehaveRunNode::BehaveRunNodeEnum node);
+    void evaluateNode(BehaveRunNode::BehaveRunNodeEnum node);
+    static int getNodeModules(BehaveRunNode::BehaveRunNodeEnum node);
+
+    BehaveRun& behaveRun_;
+    BehaveRunSnapshot snapshot_;
+    bool isSnapshotTaken_;
+    EvaluatorCrownFireMethod::EvaluatorCrownFireMethodEnum crownFireMethod_;
+    bool isUpToDate_[BehaveRunNode::NumberOfNodes];
+    long numberOfEvaluations_[BehaveRunNode::NumberOfNodes];
+
+    // Results kept by the evaluator rather than a module, in base units
+    double firebrandHeightFromSurfaceFire_;
+    double flatDistanceFromSurfaceFire_;
+    double mountainDistanceFromSurfaceFire_;
+    double firebrandIgnitionProbability_;
+    double lightningIgnitionProbability_;
+    double separationDistance_;
+    double safetyZoneRadius_;
+    double safetyZoneArea_;
+};
+
+#endif // BEHAVERUNEVALUATOR_H
@@ -0,0 +1,414 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  A resident service that coalesces small surface and crown
+*           requests into batch runs on a pool of workers
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "behaveService.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "threadPool.h"
+
+namespace
+{
+    // Requests per chunk of a batch, small so even a short batch is spread over all the workers
+    const long RequestsPerChunk = 16;
+
+    template <typename Entry>
+    void failEntries(std::vector<Entry>& entries, std::exception_ptr exception)
+    {
+        for(size_t i = 0; i < entries.size(); i++)
+        {
+            entries[i].result.set_exception(exception);
+        }
+    }
+
+    // The structure-of-arrays form of a run of surface requests
+    struct SurfaceRequestArrays
+    {
+        explicit SurfaceRequestArrays(size_t numberOfRequests)
+            : fuelModelNumber(numberOfRequests),
+            values(NumberOfValues, std::vector<double>(numberOfRequests))
+        {
+
+        }
+
+        void set(size_t index, const BehaveServiceSurfaceRequest& request)
+        {
+            fuelModelNumber[index] = request.fuelModelNumber;
+            values[0][index] = request.moistureOneHour;
+            values[1][index] = request.moistureTenHour;
+            values[2][index] = request.moistureHundredHour;
+            values[3][index] = request.moistureLiveHerbaceous;
+            values[4][index] = request.moistureLiveWoody;
+            values[5][index] = request.windSpeed;
+            values[6][index] = request.windDirection;
+            values[7][index] = request.slope;
+            values[8][index] = request.aspect;
+            values[9][index] = request.canopyCover;
+            values[10][index] = request.canopyHeight;
+            values[11][index] = request.crownRatio;
+        }
+
+        // Inputs of the requests [begin, end)
+        SurfaceBatchInputs getInputs(long begin, long end) const
+        {
+            SurfaceBatchInputs inputs = { (int)(end - begin), fuelModelNumber.data() + begin,
+                values[0].data() + begin, values[1].data() + begin, values[2].data() + begin, values[3].data() + begin,
+                values[4].data() + begin, values[5].data() + begin, values[6].data() + begin, values[7].data() + begin,
+                values[8].data() + begin, values[9].data() + begin, values[10].data() + begin, values[11].data() + begin };
+            return inputs;
+        }
+
+        static const int NumberOfValues = 12;
+
+        std::vector<int> fuelModelNumber;
+        std::vector<std::vector<double>> values;
+    };
+}
+
+BehaveService::BehaveService()
+    : prototype_(fuelModels_, speciesMasterTable_),
+    numberOfThreads_(0),
+    coalescingWindow_(2000),
+    maximumBatchSize_(1024),
+    isRunning_(false),
+    isStopping_(false),
+    numberOfRequests_(0),
+    numberOfBatches_(0),
+    largestBatchSize_(0),
+    numberOfLatencies_(0),
+    fuelbedCacheNumberOfHits_(0),
+    fuelbedCacheNumberOfMisses_(0)
+{
+    speciesMasterTable_.initializeMasterTable();
+    prototype_.surface.setFuelbedCacheCapacity(FuelbedCacheCapacity);
+}
+
+BehaveService::~BehaveService()
+{
+    stop();
+}
+
+const FuelModels& BehaveService::getFuelModels() const
+{
+    return fuelModels_;
+}
+
+const SpeciesMasterTable& BehaveService::getSpeciesMasterTable() const
+{
+    return speciesMasterTable_;
+}
+
+BehaveRun& BehaveService::getPrototype()
+{
+    return prototype_;
+}
+
+void BehaveService::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+void BehaveService::setCoalescingWindow(std::chrono::microseconds coalescingWindow)
+{
+    coalescingWindow_ = std::max(coalescingWindow, std::chrono::microseconds(0));
+}
+
+void BehaveService::setMaximumBatchSize(int maximumBatchSize)
+{
+    maximumBatchSize_ = std::max(1, maximumBatchSize);
+}
+
+void BehaveService::start()
+{
+    if(isRunning())
+    {
+        return;
+    }
+    int numberOfThreads = numberOfThreads_;
+    if(numberOfThreads <= 0)
+    {
+        numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    threadPool_ = ThreadPool::getShared();
+    workers_.assign(threadPool_->getNumberOfSlots(numberOfThreads), prototype_);
+
+    numberOfRequests_ = 0;
+    numberOfBatches_ = 0;
+    largestBatchSize_ = 0;
+    latencies_.assign(NumberOfLatencySamples, 0.0);
+    numberOfLatencies_ = 0;
+    fuelbedCacheNumberOfHits_ = 0;
+    fuelbedCacheNumberOfMisses_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isRunning_ = true;
+        isStopping_ = false;
+    }
+    dispatcher_ = std::thread(&BehaveService::dispatchLoop, this);
+}
+
+void BehaveService::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(!isRunning_)
+        {
+            return;
+        }
+        isStopping_ = true;
+    }
+    requestAvailable_.notify_all();
+    dispatcher_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    isRunning_ = false;
+    threadPool_.reset();
+}
+
+bool BehaveService::isRunning() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return isRunning_ && !isStopping_;
+}
+
+std::future<BehaveServiceSurfaceResult> BehaveService::submitSurfaceRequest(const BehaveServiceSurfaceRequest& request)
+{
+    SurfaceEntry entry;
+    entry.request = request;
+    entry.submitTime = Clock::now();
+    std::future<BehaveServiceSurfaceResult> result = entry.result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(!isRunning_ || isStopping_)
+        {
+            entry.result.set_exception(std::make_exception_ptr(std::runtime_error("BehaveService is not running")));
+            return result;
+        }
+        surfaceEntries_.push_back(std::move(entry));
+    }
+    requestAvailable_.notify_one();
+    return result;
+}
+
+std::future<BehaveServiceCrownResult> BehaveService::submitCrownRequest(const BehaveServiceCrownRequest& request)
+{
+    CrownEntry entry;
+    entry.request = request;
+    entry.submitTime = Clock::now();
+    std::future<BehaveServiceCrownResult> result = entry.result.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(!isRunning_ || isStopping_)
+        {
+            entry.result.set_exception(std::make_exception_ptr(std::runtime_error("BehaveService is not running")));
+            return result;
+        }
+        crownEntries_.push_back(std::move(entry));
+    }
+    requestAvailable_.notify_one();
+    return result;
+}
+
+BehaveServiceSurfaceResult BehaveService::runSurfaceRequest(const BehaveServiceSurfaceRequest& request)
+{
+    return submitSurfaceRequest(request).get();
+}
+
+BehaveServiceCrownResult BehaveService::runCrownRequest(const BehaveServiceCrownRequest& request)
+{
+    return submitCrownRequest(request).get();
+}
+
+BehaveServiceMetrics BehaveService::getMetrics() const
+{
+    BehaveServiceMetrics metrics = {};
+    std::vector<double> latencies;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        metrics.numberOfRequests = numberOfRequests_;
+        metrics.numberOfBatches = numberOfBatches_;
+        metrics.largestBatchSize = largestBatchSize_;
+        long numberOfSamples = std::min(numberOfLatencies_, (long)NumberOfLatencySamples);
+        latencies.assign(latencies_.begin(), latencies_.begin() + numberOfSamples);
+        metrics.fuelbedCacheNumberOfHits = fuelbedCacheNumberOfHits_;
+        metrics.fuelbedCacheNumberOfMisses = fuelbedCacheNumberOfMisses_;
+    }
+    if(!latencies.empty())
+    {
+        std::sort(latencies.begin(), latencies.end());
+        metrics.latencyMedian = latencies[(latencies.size() - 1) / 2];
+        metrics.latencyNinetyNinthPercentile = latencies[(size_t)((latencies.size() - 1) * 0.99)];
+    }
+    return metrics;
+}
+
+void BehaveService::dispatchLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for(;;)
+    {
+        requestAvailable_.wait(lock, [this]() { return isStopping_ || !surfaceEntries_.empty() || !crownEntries_.empty(); });
+        if(surfaceEntries_.empty() && crownEntries_.empty())
+        {
+            return; // stopping with nothing left to run
+        }
+
+        // Waits out the window from the oldest pending request, unless the batch fills first
+        Clock::time_point oldest = Clock::time_point::max();
+        if(!surfaceEntries_.empty())
+        {
+            oldest = surfaceEntries_.front().submitTime;
+        }
+        if(!crownEntries_.empty())
+        {
+            oldest = std::min(oldest, crownEntries_.front().submitTime);
+        }
+        requestAvailable_.wait_until(lock, oldest + coalescingWindow_, [this]()
+        {
+            return isStopping_ || (long)(surfaceEntries_.size() + crownEntries_.size()) >= maximumBatchSize_;
+        });
+
+        std::vector<SurfaceEntry> surfaceEntries;
+        std::vector<CrownEntry> crownEntries;
+        surfaceEntries.swap(surfaceEntries_);
+        crownEntries.swap(crownEntries_);
+        long batchSize = (long)(surfaceEntries.size() + crownEntries.size());
+        numberOfRequests_ += batchSize;
+        numberOfBatches_++;
+        largestBatchSize_ = std::max(largestBatchSize_, batchSize);
+        lock.unlock();
+
+        runSurfaceBatch(surfaceEntries);
+        runCrownBatch(crownEntries);
+        long fuelbedCacheNumberOfHits = 0;
+        long fuelbedCacheNumberOfMisses = 0;
+        for(size_t i = 0; i < workers_.size(); i++)
+        {
+            fuelbedCacheNumberOfHits += workers_[i].surface.getFuelbedCacheNumberOfHits();
+            fuelbedCacheNumberOfMisses += workers_[i].surface.getFuelbedCacheNumberOfMisses();
+        }
+
+        lock.lock();
+        fuelbedCacheNumberOfHits_ = fuelbedCacheNumberOfHits;
+        fuelbedCacheNumberOfMisses_ = fuelbedCacheNumberOfMisses;
+    }
+}
+
+void BehaveService::runSurfaceBatch(std::vector<SurfaceEntry>& entries)
+{
+    if(entries.empty())
+    {
+        return;
+    }
+    const size_t numberOfRequests = entries.size();
+    SurfaceRequestArrays requests(numberOfRequests);
+    for(size_t i = 0; i < numberOfRequests; i++)
+    {
+        requests.set(i, entries[i].request);
+    }
+    std::vector<BehaveServiceSurfaceResult> results(numberOfRequests);
+    std::vector<std::vector<double>> outputs(5, std::vector<double>(numberOfRequests));
+
+    try
+    {
+        threadPool_->runChunks((long)numberOfRequests, RequestsPerChunk, [&](int slot, long begin, long end)
+        {
+            SurfaceBatchInputs inputs = requests.getInputs(begin, end);
+            SurfaceBatchOutputs chunkOutputs = { outputs[0].data() + begin, outputs[1].data() + begin,
+                outputs[2].data() + begin, outputs[3].data() + begin, outputs[4].data() + begin };
+            workers_[slot].surface.doSurfaceRunBatch(inputs, chunkOutputs);
+        }, (int)workers_.size());
+    }
+    catch(...)
+    {
+        failEntries(entries, std::current_exception());
+        return;
+    }
+
+    Clock::time_point finishTime = Clock::now();
+    for(size_t i = 0; i < numberOfRequests; i++)
+    {
+        BehaveServiceSurfaceResult result = { outputs[0][i], outputs[1][i], outputs[2][i], outputs[3][i], outputs[4][i] };
+        entries[i].result.set_value(result);
+        recordLatency(entries[i].submitTime, finishTime);
+    }
+}
+
+void BehaveService::runCrownBatch(std::vector<CrownEntry>& entries)
+{
+    if(entries.empty())
+    {
+        return;
+    }
+    const size_t numberOfRequests = entries.size();
+    SurfaceRequestArrays requests(numberOfRequests);
+    std::vector<double> canopyBaseHeight(numberOfRequests);
+    std::vector<double> canopyBulkDensity(numberOfRequests);
+    std::vector<double> moistureFoliar(numberOfRequests);
+    for(size_t i = 0; i < numberOfRequests; i++)
+    {
+        requests.set(i, entries[i].request.surface);
+        canopyBaseHeight[i] = entries[i].request.canopyBaseHeight;
+        canopyBulkDensity[i] = entries[i].request.canopyBulkDensity;
+        moistureFoliar[i] = entries[i].request.moistureFoliar;
+    }
+    std::vector<FireType::FireTypeEnum> fireType(numberOfRequests);
+    std::vector<std::vector<double>> outputs(5, std::vector<double>(numberOfRequests));
+
+    try
+    {
+        threadPool_->runChunks((long)numberOfRequests, RequestsPerChunk, [&](int slot, long begin, long end)
+        {
+            CrownBatchInputs inputs = { requests.getInputs(begin, end), canopyBaseHeight.data() + begin,
+                canopyBulkDensity.data() + begin, moistureFoliar.data() + begin };
+            CrownBatchOutputs chunkOutputs = { fireType.data() + begin, outputs[0].data() + begin, outputs[1].data() + begin,
+                outputs[2].data() + begin, nullptr, outputs[3].data() + begin, outputs[4].data() + begin, nullptr, nullptr };
+            workers_[slot].crown.doCrownRunBatchScottAndReinhardt(inputs, chunkOutputs);
+        }, (int)workers_.size());
+    }
+    catch(...)
+    {
+        failEntries(entries, std::current_exception());
+        return;
+    }
+
+    Clock::time_point finishTime = Clock::now();
+    for(size_t i = 0; i < numberOfRequests; i++)
+    {
+        BehaveServiceCrownResult result = { fireType[i], outputs[0][i], outputs[1][i], outputs[2][i], outputs[3][i], outputs[4][i] };
+        entries[i].result.set_value(result);
+        recordLatency(entries[i].submitTime, finishTime);
+    }
+}
+
+void BehaveService::recordLatency(Clock::time_point submitTime, Clock::time_point finishTime)
+{
+    double latency = std::chrono::duration<double, std::micro>(finishTime - submitTime).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_[numberOfLatencies_ % NumberOfLatencySamples] = latency;
+    numberOfLatencies_++;
+}
@@ -0,0 +1,204 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  A resident service that coalesces small surface and crown
+*           requests into batch runs on a pool of workers
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef BEHAVESERVICE_H
+#define BEHAVESERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "behaveRun.h"
+#include "fuelModels.h"
+#include "species_master_table.h"
+
+class ThreadPool;
+
+// One single point surface run, in the base units of SurfaceBatchInputs: moistures as fractions,
+// wind speed in ft/min at the prototype Surface's wind height, directions, slope and aspect in
+// degrees, canopy height in ft
+struct BehaveServiceSurfaceRequest
+{
+    int fuelModelNumber;
+    double moistureOneHour;
+    double moistureTenHour;
+    double moistureHundredHour;
+    double moistureLiveHerbaceous;
+    double moistureLiveWoody;
+    double windSpeed;
+    double windDirection;
+    double slope;
+    double aspect;
+    double canopyCover;
+    double canopyHeight;
+    double crownRatio;
+};
+
+// Results of a surface request, in the base units of SurfaceBatchOutputs
+struct BehaveServiceSurfaceResult
+{
+    double spreadRate;
+    double firelineIntensity;
+    double flameLength;
+    double directionOfMaxSpread;
+    double fireLengthToWidthRatio;
+};
+
+// One single point Scott and Reinhardt crown run. As in CrownBatchInputs the wind speed is the 20 ft wind
+// speed and the crown ratio is derived from the canopy heights, canopy base height is in ft, canopy bulk
+// density in lb/ft^3 and foliar moisture a fraction.
+struct BehaveServiceCrownRequest
+{
+    BehaveServiceSurfaceRequest surface;
+    double canopyBaseHeight;
+    double canopyBulkDensity;
+    double moistureFoliar;
+};
+
+// Results of a crown request, in the base units of CrownBatchOutputs
+struct BehaveServiceCrownResult
+{
+    FireType::FireTypeEnum fireType;
+    double crownFractionBurned;
+    double crownFireSpreadRate;
+    double finalSpreadRate;
+    double finalFirelineIntensity;
+    double finalFlameLength;
+};
+
+// Counters of a BehaveService since it started. Latencies are from a request's submission to its
+// result, in microseconds, over the most recent requests. The fuelbed cache counts are summed over
+// the workers' Surfaces.
+struct BehaveServiceMetrics
+{
+    long numberOfRequests;
+    long numberOfBatches;
+    long largestBatchSize;
+    double latencyMedian;
+    double latencyNinetyNinthPercentile;
+    long fuelbedCacheNumberOfHits;
+    long fuelbedCacheNumberOfMisses;
+};
+
+// A resident service for many small surface and crown requests from any number of threads, such as
+// the handlers of a web server. It owns the fuel models and species tables, which stay loaded for its
+// lifetime, and a pool of BehaveRun workers copied from a prototype, so a request costs neither table
+// set up nor a BehaveRun. Requests that arrive within the coalescing window of the first pending one
+// are merged into a single structure-of-arrays batch, split over the workers, whose Surfaces have
+// their fuelbed caches turned on and keep them warm from batch to batch. Settings and the prototype are changed before start().
+// The service does not include a transport, a server hands it the requests it has decoded.
+class BehaveService
+{
+public:
+    BehaveService();
+    ~BehaveService();
+
+    BehaveService(const BehaveService& rhs) = delete;
+    BehaveService& operator=(const BehaveService& rhs) = delete;
+
+    const FuelModels& getFuelModels() const;
+    const SpeciesMasterTable& getSpeciesMasterTable() const;
+    // Settings of the surface and crown modules, e.g. the wind height input mode, copied to the workers
+    BehaveRun& getPrototype();
+
+    // Zero or less uses one worker per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+    void setCoalescingWindow(std::chrono::microseconds coalescingWindow);
+    // A batch is run as soon as it has this many requests, without waiting out the window
+    void setMaximumBatchSize(int maximumBatchSize);
+
+    void start();
+    // Runs the requests already submitted, then stops the workers
+    void stop();
+    bool isRunning() const;
+
+    // Submitting to a service that is not running fails the future with std::runtime_error
+    std::future<BehaveServiceSurfaceResult> submitSurfaceRequest(const BehaveServiceSurfaceRequest& request);
+    std::future<BehaveServiceCrownResult> submitCrownRequest(const BehaveServiceCrownRequest& request);
+    BehaveServiceSurfaceResult runSurfaceRequest(const BehaveServiceSurfaceRequest& request);
+    BehaveServiceCrownResult runCrownRequest(const BehaveServiceCrownRequest& request);
+
+    BehaveServiceMetrics getMetrics() const;
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct SurfaceEntry
+    {
+        BehaveServiceSurfaceRequest request;
+        Clock::time_point submitTime;
+        std::promise<BehaveServiceSurfaceResult> result;
+    };
+
+    struct CrownEntry
+    {
+        BehaveServiceCrownRequest request;
+        Clock::time_point submitTime;
+        std::promise<BehaveServiceCrownResult> result;
+    };
+
+    static const int NumberOfLatencySamples = 4096;
+    static const int FuelbedCacheCapacity = 256;
+
+    void dispatchLoop();
+    void runSurfaceBatch(std::vector<SurfaceEntry>& entries);
+    void runCrownBatch(std::vector<CrownEntry>& entries);
+    void recordLatency(Clock::time_point submitTime, Clock::time_point finishTime);
+
+    FuelModels fuelModels_;
+    SpeciesMasterTable speciesMasterTable_;
+    BehaveRun prototype_;
+
+    int numberOfThreads_;
+    std::chrono::microseconds coalescingWindow_;
+    int maximumBatchSize_;
+
+    std::vector<BehaveRun> workers_;
+    std::shared_ptr<ThreadPool> threadPool_;
+    std::thread dispatcher_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable requestAvailable_;
+    bool isRunning_;
+    bool isStopping_;
+    std::vector<SurfaceEntry> surfaceEntries_;
+    std::vector<CrownEntry> crownEntries_;
+
+    long numberOfRequests_;
+    long numberOfBatches_;
+    long largestBatchSize_;
+    std::vector<double> latencies_;  // ring of the last NumberOfLatencySamples latencies
+    long numberOfLatencies_;
+    long fuelbedCacheNumberOfHits_;   // summed over the workers after every batch
+    long fuelbedCacheNumberOfMisses_;
+};
+
+#endif // BEHAVESERVICE_H
@@ -28,6 +28,14 @@
 #ifndef	BEHAVEUNITS_H
 #define BEHAVEUNITS_H
 
+#include <cstddef>
+
+// Each units struct exposes its conversion factors as constexpr functions so
+// that conversions inline into callers. When the units are known at compile
+// time, the templated overloads, e.g. LengthUnits::toBaseUnits<LengthUnits::Meters>(x),
+// fold to a single multiply (multiply-add for temperature). The pointer
+// overloads convert a whole buffer in place using one factor.
+
 struct AreaUnits
 {
     enum AreaUnitsEnum
@@ -40,8 +48,42 @@ struct AreaUnits
         SquareKilometers
     };
 
-    static double toBaseUnits(double value, AreaUnitsEnum units);
-    static double fromBaseUnits(double value, AreaUnitsEnum units);
+    static constexpr double toBaseFactor(AreaUnitsEnum units)
+    {
+        switch (units)
+        {
+            case Acres: return 43560.002160576107;
+            case Hectares: return 107639.10416709723;
+            case SquareMeters: return 10.76391041671;
+            case SquareMiles: return 27878400;
+            case SquareKilometers: return 10763910.416709721;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(AreaUnitsEnum units)
+    {
+        switch (units)
+        {
+            case Acres: return 2.295684e-05;
+            case Hectares: return 0.0000092903036;
+            case SquareMeters: return 0.0929030353835;
+            case SquareMiles: return 3.5870064279e-08;
+            case SquareKilometers: return 9.290304e-08;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, AreaUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, AreaUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <AreaUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <AreaUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, AreaUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, AreaUnitsEnum units);
 };
 
 struct BasalAreaUnits
@@ -52,8 +94,26 @@ struct BasalAreaUnits
         SquareMetersPerHectare
     };
 
-    static double toBaseUnits(double value, BasalAreaUnitsEnum units);
-    static double fromBaseUnits(double value, BasalAreaUnitsEnum units);
+    static constexpr double toBaseFactor(BasalAreaUnitsEnum units)
+    {
+        return (units == SquareMetersPerHectare) ? 0.229568 : 1.0;
+    }
+
+    static constexpr double fromBaseFactor(BasalAreaUnitsEnum units)
+    {
+        return (units == SquareMetersPerHectare) ? 4.356 : 1.0;
+    }
+
+    static double toBaseUnits(double value, BasalAreaUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, BasalAreaUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <BasalAreaUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <BasalAreaUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, BasalAreaUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, BasalAreaUnitsEnum units);
 };
 
 struct LengthUnits
@@ -70,8 +130,46 @@ struct LengthUnits
         Kilometers
     };
 
-    static double toBaseUnits(double value, LengthUnitsEnum units);
-    static double fromBaseUnits(double value, LengthUnitsEnum units);
+    static constexpr double toBaseFactor(LengthUnitsEnum units)
+    {
+        switch (units)
+        {
+            case Inches: return 0.08333333333333;
+            case Millimeters: return 0.003280839895;
+            case Centimeters: return 0.03280839895;
+            case Meters: return 3.2808398950131;
+            case Chains: return 66.0;
+            case Miles: return 5280.0;
+            case Kilometers: return 3280.8398950131;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(LengthUnitsEnum units)
+    {
+        switch (units)
+        {
+            case Inches: return 12;
+            case Millimeters: return 304.8;
+            case Centimeters: return 30.480;
+            case Meters: return 0.3048;
+            case Chains: return 0.0151515151515;
+            case Miles: return 0.0001893939393939394;
+            case Kilometers: return 0.0003048;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, LengthUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, LengthUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <LengthUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <LengthUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, LengthUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, LengthUnitsEnum units);
 };
 
 struct LoadingUnits
@@ -84,8 +182,38 @@ struct LoadingUnits
         KilogramsPerSquareMeter
     };
 
-    static double toBaseUnits(double value, LoadingUnitsEnum units);
-    static double fromBaseUnits(double value, LoadingUnitsEnum units);
+    static constexpr double toBaseFactor(LoadingUnitsEnum units)
+    {
+        switch (units)
+        {
+            case TonsPerAcre: return 0.045913682277318638;
+            case TonnesPerHectare: return 0.02048161436225217;
+            case KilogramsPerSquareMeter: return 0.2048161436225217;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(LoadingUnitsEnum units)
+    {
+        switch (units)
+        {
+            case TonsPerAcre: return 21.78;
+            case TonnesPerHectare: return 48.8242763638305;
+            case KilogramsPerSquareMeter: return 4.88242763638305;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, LoadingUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, LoadingUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <LoadingUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <LoadingUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, LoadingUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, LoadingUnitsEnum units);
 };
 
 struct PressureUnits
@@ -103,8 +231,37 @@ struct PressureUnits
         PoundPerSquareInch   // psi
     };
 
-    static double toBaseUnits(double value, PressureUnitsEnum units);
-    static double fromBaseUnits(double value, PressureUnitsEnum units);
+    static constexpr double fromBaseFactor(PressureUnitsEnum units)
+    {
+        switch (units)
+        {
+            case HectoPascal: return 1e2;
+            case KiloPascal: return 1e3;
+            case MegaPascal: return 1e6;
+            case GigaPascal: return 1e9;
+            case Bar: return 1e5;
+            case Atmosphere: return 101325;
+            case TechnicalAtmosphere: return 98066.5;
+            case PoundPerSquareInch: return 6894.757;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double toBaseFactor(PressureUnitsEnum units)
+    {
+        return 1.0 / fromBaseFactor(units);
+    }
+
+    static double toBaseUnits(double value, PressureUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, PressureUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <PressureUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <PressureUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, PressureUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, PressureUnitsEnum units);
 };
 
 struct SurfaceAreaToVolumeUnits
@@ -117,8 +274,38 @@ struct SurfaceAreaToVolumeUnits
         SquareCentimetersOverCubicCentimeters
     };
 
-    static double toBaseUnits(double value, SurfaceAreaToVolumeUnitsEnum units);
-    static double fromBaseUnits(double value, SurfaceAreaToVolumeUnitsEnum units);
+    static constexpr double toBaseFactor(SurfaceAreaToVolumeUnitsEnum units)
+    {
+        switch (units)
+        {
+            case SquareMetersOverCubicMeters: return 3.280839895013123;
+            case SquareInchesOverCubicInches: return 0.083333333333333;
+            case SquareCentimetersOverCubicCentimeters: return 0.03280839895013123;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(SurfaceAreaToVolumeUnitsEnum units)
+    {
+        switch (units)
+        {
+            case SquareMetersOverCubicMeters: return 0.3048;
+            case SquareInchesOverCubicInches: return 12;
+            case SquareCentimetersOverCubicCentimeters: return 30.48;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, SurfaceAreaToVolumeUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, SurfaceAreaToVolumeUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <SurfaceAreaToVolumeUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <SurfaceAreaToVolumeUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, SurfaceAreaToVolumeUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, SurfaceAreaToVolumeUnitsEnum units);
 };
 
 struct SpeedUnits
@@ -134,8 +321,44 @@ struct SpeedUnits
         KilometersPerHour,
     };
 
-    static double toBaseUnits(double value, SpeedUnitsEnum units);
-    static double fromBaseUnits(double value, SpeedUnitsEnum units);
+    static constexpr double toBaseFactor(SpeedUnitsEnum units)
+    {
+        switch (units)
+        {
+            case ChainsPerHour: return 1.1;
+            case MetersPerSecond: return 196.8503937;
+            case MetersPerMinute: return 3.28084;
+            case MetersPerHour: return 0.0547;
+            case MilesPerHour: return 88;
+            case KilometersPerHour: return 54.680665;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(SpeedUnitsEnum units)
+    {
+        switch (units)
+        {
+            case ChainsPerHour: return 10.0 / 11.0;
+            case MetersPerSecond: return 0.00508;
+            case MetersPerMinute: return 0.3048;
+            case MetersPerHour: return 18.288;
+            case MilesPerHour: return 0.01136363636;
+            case KilometersPerHour: return 0.018288;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, SpeedUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, SpeedUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <SpeedUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <SpeedUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, SpeedUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, SpeedUnitsEnum units);
 };
 
 struct FractionUnits
@@ -146,8 +369,26 @@ struct FractionUnits
         Percent
     };
 
-    static double toBaseUnits(double value, FractionUnitsEnum units);
-    static double fromBaseUnits(double value, FractionUnitsEnum units);
+    static constexpr double toBaseFactor(FractionUnitsEnum units)
+    {
+        return (units == Percent) ? 1.0 / 100.0 : 1.0;
+    }
+
+    static constexpr double fromBaseFactor(FractionUnitsEnum units)
+    {
+        return (units == Percent) ? 100.0 : 1.0;
+    }
+
+    static double toBaseUnits(double value, FractionUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, FractionUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <FractionUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <FractionUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, FractionUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, FractionUnitsEnum units);
 };
 
 struct SlopeUnits
@@ -158,8 +399,12 @@ struct SlopeUnits
         Percent
     };
 
+    // Percent slope is not a linear scaling of degrees, so there is no factor table here
     static double toBaseUnits(double value, SlopeUnitsEnum units);
     static double fromBaseUnits(double value, SlopeUnitsEnum units);
+
+    static void toBaseUnits(double* values, std::size_t count, SlopeUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, SlopeUnitsEnum units);
 };
 
 struct DensityUnits
@@ -170,8 +415,26 @@ struct DensityUnits
         KilogramsPerCubicMeter
     };
 
-    static double toBaseUnits(double value, DensityUnitsEnum units);
-    static double fromBaseUnits(double value, DensityUnitsEnum units);
+    static constexpr double toBaseFactor(DensityUnitsEnum units)
+    {
+        return (units == KilogramsPerCubicMeter) ? 0.06242781786 : 1.0;
+    }
+
+    static constexpr double fromBaseFactor(DensityUnitsEnum units)
+    {
+        return (units == KilogramsPerCubicMeter) ? 16.0185 : 1.0;
+    }
+
+    static double toBaseUnits(double value, DensityUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, DensityUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <DensityUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <DensityUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, DensityUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, DensityUnitsEnum units);
 };
 
 struct HeatOfCombustionUnits
@@ -182,8 +445,26 @@ struct HeatOfCombustionUnits
         KilojoulesPerKilogram
     };
 
-    static double toBaseUnits(double value, HeatOfCombustionUnitsEnum units);
-    static double fromBaseUnits(double value, HeatOfCombustionUnitsEnum units);
+    static constexpr double toBaseFactor(HeatOfCombustionUnitsEnum units)
+    {
+        return (units == KilojoulesPerKilogram) ? 0.429592 : 1.0;
+    }
+
+    static constexpr double fromBaseFactor(HeatOfCombustionUnitsEnum units)
+    {
+        return (units == KilojoulesPerKilogram) ? 2.32779 : 1.0;
+    }
+
+    static double toBaseUnits(double value, HeatOfCombustionUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, HeatOfCombustionUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <HeatOfCombustionUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <HeatOfCombustionUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, HeatOfCombustionUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, HeatOfCombustionUnitsEnum units);
 };
 
 struct HeatSinkUnits
@@ -194,8 +475,26 @@ struct HeatSinkUnits
         KilojoulesPerCubicMeter
     };
 
-    static double toBaseUnits(double value, HeatSinkUnitsEnum units);
-    static double fromBaseUnits(double value, HeatSinkUnitsEnum units);
+    static constexpr double toBaseFactor(HeatSinkUnitsEnum units)
+    {
+        return (units == KilojoulesPerCubicMeter) ? 0.02681849745789 : 1.0;
+    }
+
+    static constexpr double fromBaseFactor(HeatSinkUnitsEnum units)
+    {
+        return (units == KilojoulesPerCubicMeter) ? 37.28769673134085 : 1.0;
+    }
+
+    static double toBaseUnits(double value, HeatSinkUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, HeatSinkUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <HeatSinkUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <HeatSinkUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, HeatSinkUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, HeatSinkUnitsEnum units);
 };
 
 struct HeatPerUnitAreaUnits
@@ -207,8 +506,36 @@ struct HeatPerUnitAreaUnits
         KilowattSecondsPerSquareMeter
     };
 
-    static double toBaseUnits(double value, HeatPerUnitAreaUnitsEnum units);
-    static double fromBaseUnits(double value, HeatPerUnitAreaUnitsEnum units);
+    static constexpr double toBaseFactor(HeatPerUnitAreaUnitsEnum units)
+    {
+        switch (units)
+        {
+            case KilojoulesPerSquareMeter: return 0.0879872;
+            case KilowattSecondsPerSquareMeter: return 0.0879872;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(HeatPerUnitAreaUnitsEnum units)
+    {
+        switch (units)
+        {
+            case KilojoulesPerSquareMeter: return 11.3653;
+            case KilowattSecondsPerSquareMeter: return 11.3653;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, HeatPerUnitAreaUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, HeatPerUnitAreaUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <HeatPerUnitAreaUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <HeatPerUnitAreaUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, HeatPerUnitAreaUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, HeatPerUnitAreaUnitsEnum units);
 };
 
 struct HeatSourceAndReactionIntensityUnits
@@ -222,8 +549,40 @@ struct HeatSourceAndReactionIntensityUnits
         KilowattsPerSquareMeter
     };
 
-    static double toBaseUnits(double value, HeatSourceAndReactionIntensityUnitsEnum units);
-    static double fromBaseUnits(double value, HeatSourceAndReactionIntensityUnitsEnum units);
+    static constexpr double toBaseFactor(HeatSourceAndReactionIntensityUnitsEnum units)
+    {
+        switch (units)
+        {
+            case BtusPerSquareFootPerSecond: return 60;
+            case KilojoulesPerSquareMeterPerSecond: return 5.27921783108615;
+            case KilojoulesPerSquareMeterPerMinute: return 0.0880549963329497;
+            case KilowattsPerSquareMeter: return 5.27921783108615;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(HeatSourceAndReactionIntensityUnitsEnum units)
+    {
+        switch (units)
+        {
+            case BtusPerSquareFootPerSecond: return 0.01666666666666667;
+            case KilojoulesPerSquareMeterPerSecond: return 0.189422;
+            case KilojoulesPerSquareMeterPerMinute: return 11.356539;
+            case KilowattsPerSquareMeter: return 0.189422;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, HeatSourceAndReactionIntensityUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, HeatSourceAndReactionIntensityUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <HeatSourceAndReactionIntensityUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <HeatSourceAndReactionIntensityUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, HeatSourceAndReactionIntensityUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, HeatSourceAndReactionIntensityUnitsEnum units);
 };
 
 struct FirelineIntensityUnits
@@ -237,8 +596,40 @@ struct FirelineIntensityUnits
         KilowattsPerMeter
     };
 
-    static double toBaseUnits(double value, FirelineIntensityUnitsEnum units);
-    static double fromBaseUnits(double value, FirelineIntensityUnitsEnum units);
+    static constexpr double toBaseFactor(FirelineIntensityUnitsEnum units)
+    {
+        switch (units)
+        {
+            case BtusPerFootPerMinute: return 0.01666666666666667;
+            case KilojoulesPerMeterPerSecond: return 0.2886719;
+            case KilojoulesPerMeterPerMinute: return 0.00481120819;
+            case KilowattsPerMeter: return 0.2886719;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(FirelineIntensityUnitsEnum units)
+    {
+        switch (units)
+        {
+            case BtusPerFootPerMinute: return 60;
+            case KilojoulesPerMeterPerSecond: return 3.464140419;
+            case KilojoulesPerMeterPerMinute: return 207.848;
+            case KilowattsPerMeter: return 3.464140419;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, FirelineIntensityUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, FirelineIntensityUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <FirelineIntensityUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <FirelineIntensityUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, FirelineIntensityUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, FirelineIntensityUnitsEnum units);
 };
 
 struct TemperatureUnits
@@ -250,8 +641,47 @@ struct TemperatureUnits
         Kelvin
     };
 
-    static double toBaseUnits(double value, TemperatureUnitsEnum units);
-    static double fromBaseUnits(double value, TemperatureUnitsEnum units);
+    // Temperature conversions are value * factor + offset
+    static constexpr double toBaseFactor(TemperatureUnitsEnum units)
+    {
+        return (units == Fahrenheit) ? 1.0 : 9.0 / 5.0;
+    }
+
+    static constexpr double toBaseOffset(TemperatureUnitsEnum units)
+    {
+        return (units == Celsius) ? 32.0 : (units == Kelvin) ? 32.0 - (273.15 * 9.0) / 5.0 : 0.0;
+    }
+
+    static constexpr double fromBaseFactor(TemperatureUnitsEnum units)
+    {
+        return (units == Fahrenheit) ? 1.0 : 5.0 / 9.0;
+    }
+
+    static constexpr double fromBaseOffset(TemperatureUnitsEnum units)
+    {
+        return (units == Celsius) ? -(32.0 * 5.0) / 9.0 : (units == Kelvin) ? 273.15 - (32.0 * 5.0) / 9.0 : 0.0;
+    }
+
+    static double toBaseUnits(double value, TemperatureUnitsEnum units) { return value * toBaseFactor(units) + toBaseOffset(units); }
+    static double fromBaseUnits(double value, TemperatureUnitsEnum units) { return value * fromBaseFactor(units) + fromBaseOffset(units); }
+
+    template <TemperatureUnitsEnum units>
+    static double toBaseUnits(double value)
+    {
+        constexpr double factor = toBaseFactor(units);
+        constexpr double offset = toBaseOffset(units);
+        return value * factor + offset;
+    }
+    template <TemperatureUnitsEnum units>
+    static double fromBaseUnits(double value)
+    {
+        constexpr double factor = fromBaseFactor(units);
+        constexpr double offset = fromBaseOffset(units);
+        return value * factor + offset;
+    }
+
+    static void toBaseUnits(double* values, std::size_t count, TemperatureUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, TemperatureUnitsEnum units);
 };
 
 struct TimeUnits
@@ -265,8 +695,40 @@ struct TimeUnits
         Years
     };
 
-    static double toBaseUnits(double value, TimeUnitsEnum units);
-    static double fromBaseUnits(double value, TimeUnitsEnum units);
+    static constexpr double toBaseFactor(TimeUnitsEnum units)
+    {
+        switch (units)
+        {
+            case Seconds: return 1.0 / 60.0;
+            case Hours: return 60;
+            case Days: return 1440;
+            case Years: return 525600;
+            default: return 1.0;
+        }
+    }
+
+    static constexpr double fromBaseFactor(TimeUnitsEnum units)
+    {
+        switch (units)
+        {
+            case Seconds: return 60;
+            case Hours: return 1.0 / 60.0;
+            case Days: return 1.0 / 1440.0;
+            case Years: return 1.0 / 525600.0;
+            default: return 1.0;
+        }
+    }
+
+    static double toBaseUnits(double value, TimeUnitsEnum units) { return value * toBaseFactor(units); }
+    static double fromBaseUnits(double value, TimeUnitsEnum units) { return value * fromBaseFactor(units); }
+
+    template <TimeUnitsEnum units>
+    static double toBaseUnits(double value) { constexpr double factor = toBaseFactor(units); return value * factor; }
+    template <TimeUnitsEnum units>
+    static double fromBaseUnits(double value) { constexpr double factor = fromBaseFactor(units); return value * factor; }
+
+    static void toBaseUnits(double* values, std::size_t count, TimeUnitsEnum units);
+    static void fromBaseUnits(double* values, std::size_t count, TimeUnitsEnum units);
 };
 
 #endif // BEHAVEUNITS_H
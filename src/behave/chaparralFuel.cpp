@@ -382,7 +382,12 @@ void ChaparralFuel::updateFuelLoadFromDepthAndFuelType()
  */
 void ChaparralFuel::updateDeadFuelFractionFromAge()
 {
-    deadFuelFraction_ = 0.0694 * exp(0.0402 * age_);    // Average Mortality
+    deadFuelFraction_ = calculateDeadFuelFractionFromAge(age_);
+}
+
+double ChaparralFuel::calculateDeadFuelFractionFromAge(double age)
+{
+    return 0.0694 * exp(0.0402 * age);    // Average Mortality
     //m_deadFuelFraction = 0.1094 * exp( 0.0385 * m_age );    // Severe Mortality
 }
 
@@ -433,10 +438,9 @@ void ChaparralFuel::updateFuelLoads()
  */
 void ChaparralFuel::updateLiveFuelHeatFromDate()
 {
-    double d = days_;
     int live = 1;
-    heatOfCombustion_[live][0] = 9613.0 - 1.00 * d + 0.1369 * d * d - 0.000365 * d * d * d;
-    double liveHeat = 9509.0 - 10.74 * d + 0.1359 * d * d - 0.000405 * d * d * d;
+    heatOfCombustion_[live][0] = calculateLiveLeafHeatFromDate(days_);
+    double liveHeat = calculateLiveStemHeatFromDate(days_);
     for (int size = 1; size < static_cast<int>(ChaparralContants::NumFuelClasses); size++)
     {
         heatOfCombustion_[live][size] = liveHeat;
@@ -449,14 +453,34 @@ void ChaparralFuel::updateLiveFuelHeatFromDate()
 void ChaparralFuel::updateLiveFuelMoistureFromDate()
 {
     int live = 1;
-    moisture_[live][0] = 1.0 / (0.726 + 0.00877 * days_);
-    double liveMc = 1.0 / (1.454 + 0.00650 * days_);
+    moisture_[live][0] = calculateLiveLeafMoistureFromDate(days_);
+    double liveMc = calculateLiveStemMoistureFromDate(days_);
     for (int size = 1; size < static_cast<int>(ChaparralContants::NumFuelClasses); size++)
     {
         moisture_[live][size] = liveMc;
     }
 }
 
+double ChaparralFuel::calculateLiveLeafHeatFromDate(double d)
+{
+    return 9613.0 - 1.00 * d + 0.1369 * d * d - 0.000365 * d * d * d;
+}
+
+double ChaparralFuel::calculateLiveStemHeatFromDate(double d)
+{
+    return 9509.0 - 10.74 * d + 0.1359 * d * d - 0.000405 * d * d * d;
+}
+
+double ChaparralFuel::calculateLiveLeafMoistureFromDate(double days)
+{
+    return 1.0 / (0.726 + 0.00877 * days);
+}
+
+double ChaparralFuel::calculateLiveStemMoistureFromDate(double days)
+{
+    return 1.0 / (1.454 + 0.00650 * days);
+}
+
 void ChaparralFuel::updateAgeFromDepth()
 {
     if (fuelType_ == ChaparralFuelType::Chamise)
@@ -475,25 +499,32 @@ void ChaparralFuel::updateAgeFromDepth()
 
 void ChaparralFuel::updateFuelBedDepthFromAge()
 {
-    if (fuelType_ == ChaparralFuelType::Chamise)
-    {
-        double x = log(age_) / 3.912023;
-        fuelBedDepth_ = 7.5 * x * x;
-    }
-    else if (fuelType_ == ChaparralFuelType::MixedBrush)
+    fuelBedDepth_ = calculateFuelBedDepthFromAge(fuelType_, age_);
+}
+
+double ChaparralFuel::calculateFuelBedDepthFromAge(ChaparralFuelType::ChaparralFuelTypeEnum fuelType, double age)
+{
+    if (fuelType == ChaparralFuelType::Chamise)
     {
-        double x = log(age_) / 3.912023;
-        fuelBedDepth_ = 10.0 * x * x;
+        double x = log(age) / 3.912023;
+        return 7.5 * x * x;
     }
-    else if (fuelType_ == ChaparralFuelType::NotSet)
+    else if (fuelType == ChaparralFuelType::MixedBrush)
     {
-        fuelBedDepth_ = -1.0; // Indicates an error
+        double x = log(age) / 3.912023;
+        return 10.0 * x * x;
     }
+    return -1.0; // Indicates an error
 }
 
 void ChaparralFuel::updateTotalFuelLoadFromAge()
 {
-    if (fuelType_ == ChaparralFuelType::Chamise)
+    totalFuelLoad_ = calculateTotalFuelLoadFromAge(fuelType_, age_);
+}
+
+double ChaparralFuel::calculateTotalFuelLoadFromAge(ChaparralFuelType::ChaparralFuelTypeEnum fuelType, double age)
+{
+    if (fuelType == ChaparralFuelType::Chamise)
     {
         /* NOTE - Rothermel & Philpot(1973) used a factor of 0.0315 for chamise age,
          * while Cohen used 0.0347 in FIRECAST. According to Faith Ann Heinsch,
@@ -502,16 +533,57 @@ void ChaparralFuel::updateTotalFuelLoadFromAge()
          * using an entered age. He had to make some corrections for that assumption.
          */
         double chamiseLoadFactor = 0.0347;	// Chamise load factor from Cohen's FIRECAST code
-        double tpa = age_ / (1.4459 + chamiseLoadFactor * age_);
-        totalFuelLoad_ = tpa * 2000.0 / 43560.0;
+        double tpa = age / (1.4459 + chamiseLoadFactor * age);
+        return tpa * 2000.0 / 43560.0;
     }
-    else if (fuelType_ == ChaparralFuelType::MixedBrush)
+    else if (fuelType == ChaparralFuelType::MixedBrush)
     {
-        double tpa = age_ / (0.4849 + 0.0170 * age_);
-        totalFuelLoad_ = tpa * 2000. / 43560.0;
+        double tpa = age / (0.4849 + 0.0170 * age);
+        return tpa * 2000. / 43560.0;
     }
-    else if (fuelType_ == ChaparralFuelType::NotSet)
+    return -1.0; // Indicates an error
+}
+
+//------------------------------------------------------------------------------
+/*!   \brief Derives the fuel bed depth, total fuel load and dead fuel fraction from
+ *    each cell's age, and the live fuel moistures and heats of combustion from its
+ *    date, with the same relationships and date limit as setAge() and setDate().
+ */
+void ChaparralFuel::calculateFuelbedPropertiesBatch(ChaparralFuelType::ChaparralFuelTypeEnum fuelType, const ChaparralBatchInputs& inputs,
+    ChaparralBatchOutputs& outputs)
+{
+    for (int i = 0; i < inputs.numberOfCells; i++)
     {
-        totalFuelLoad_ = -1.0; // Indicates an error
+        double age = inputs.age[i];
+        if (outputs.fuelBedDepth)
+        {
+            outputs.fuelBedDepth[i] = calculateFuelBedDepthFromAge(fuelType, age);
+        }
+        if (outputs.totalFuelLoad)
+        {
+            outputs.totalFuelLoad[i] = calculateTotalFuelLoadFromAge(fuelType, age);
+        }
+        if (outputs.deadFuelFraction)
+        {
+            outputs.deadFuelFraction[i] = calculateDeadFuelFractionFromAge(age);
+        }
+
+        double days = (inputs.daysSinceMayFirst[i] > 184.0) ? 184.0 : inputs.daysSinceMayFirst[i]; // Do not extend past Oct 31
+        if (outputs.liveLeafMoisture)
+        {
+            outputs.liveLeafMoisture[i] = calculateLiveLeafMoistureFromDate(days);
+        }
+        if (outputs.liveStemMoisture)
+        {
+            outputs.liveStemMoisture[i] = calculateLiveStemMoistureFromDate(days);
+        }
+        if (outputs.liveLeafHeatOfCombustion)
+        {
+            outputs.liveLeafHeatOfCombustion[i] = calculateLiveLeafHeatFromDate(days);
+        }
+        if (outputs.liveStemHeatOfCombustion)
+        {
+            outputs.liveStemHeatOfCombustion[i] = calculateLiveStemHeatFromDate(days);
+        }
     }
 }
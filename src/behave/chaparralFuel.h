@@ -56,6 +56,29 @@
  * - dead fuel particle heat content by size class;
  */
 
+// Structure-of-arrays inputs for ChaparralFuel::calculateFuelbedPropertiesBatch(), each array holds
+// numberOfCells values: fuel age in years since last fire and seasonal date in days since May 1
+struct ChaparralBatchInputs
+{
+    int numberOfCells;
+    const double* age;
+    const double* daysSinceMayFirst;
+};
+
+// Caller-provided output arrays for ChaparralFuel::calculateFuelbedPropertiesBatch(), each sized for
+// numberOfCells values: depth in ft, load in lb/ft2, dead fraction and moistures as ratios, heat of
+// combustion in btu/lb. Any array may be null if that output is not needed.
+struct ChaparralBatchOutputs
+{
+    double* fuelBedDepth;
+    double* totalFuelLoad;
+    double* deadFuelFraction;
+    double* liveLeafMoisture;
+    double* liveStemMoisture;
+    double* liveLeafHeatOfCombustion;
+    double* liveStemHeatOfCombustion;
+};
+
 class ChaparralFuel
 {
 public:
@@ -108,7 +131,20 @@ public:
     void updateFuelBedDepthFromAge();
     void updateTotalFuelLoadFromAge();
 
+    // What setAge() and setDate() derive for a single chaparral object, for every cell of a batch in one pass
+    static void calculateFuelbedPropertiesBatch(ChaparralFuelType::ChaparralFuelTypeEnum fuelType, const ChaparralBatchInputs& inputs,
+        ChaparralBatchOutputs& outputs);
+
 protected:
+    // Age and date relationships shared by the updaters and the batch
+    static double calculateDeadFuelFractionFromAge(double age);
+    static double calculateFuelBedDepthFromAge(ChaparralFuelType::ChaparralFuelTypeEnum fuelType, double age);
+    static double calculateTotalFuelLoadFromAge(ChaparralFuelType::ChaparralFuelTypeEnum fuelType, double age);
+    static double calculateLiveLeafMoistureFromDate(double days);
+    static double calculateLiveStemMoistureFromDate(double days);
+    static double calculateLiveLeafHeatFromDate(double days);
+    static double calculateLiveStemHeatFromDate(double days);
+
     void initializeFuelArrays();
     bool isGoodSizeClassIndex(FuelLifeState::FuelLifeStateEnum lifeState, int sizeClass) const;
 
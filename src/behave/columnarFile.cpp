@@ -0,0 +1,749 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Columnar binary output for batch runs, written a chunk of rows at
+*           a time and read back through a memory mapping
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#include "columnarFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const char fileMagic[8] = { 'B', 'E', 'H', 'A', 'V', 'C', 'O', 'L' };
+const uint32_t byteOrderMark = 0x01020304;
+const uint32_t formatVersion = 1;
+
+size_t getValueSize(ColumnarColumnType::ColumnarColumnTypeEnum type)
+{
+    switch (type)
+    {
+        case ColumnarColumnType::Float64:
+            return 8;
+        case ColumnarColumnType::Float32:
+        case ColumnarColumnType::Int32:
+            return 4;
+        default:
+            return 1;
+    }
+}
+
+size_t getPaddingToEightBytes(size_t size)
+{
+    return (8 - size % 8) % 8;
+}
+
+void appendBytes(std::string& out, const void* data, size_t size)
+{
+    out.append(static_cast<const char*>(data), size);
+}
+
+template <typename T>
+bool readBytes(const char* data, size_t size, size_t& position, T& value)
+{
+    if (position + sizeof(T) > size)
+    {
+        return false;
+    }
+    memcpy(&value, data + position, sizeof(T));
+    position += sizeof(T);
+    return true;
+}
+
+// Gathers byte b of every value together so the slowly varying sign and exponent bytes form long runs
+void shuffleBytes(const char* in, size_t size, size_t valueSize, std::string& out)
+{
+    size_t numberOfValues = size / valueSize;
+    out.resize(size);
+    for (size_t byte = 0; byte < valueSize; byte++)
+    {
+        for (size_t i = 0; i < numberOfValues; i++)
+        {
+            out[byte * numberOfValues + i] = in[i * valueSize + byte];
+        }
+    }
+}
+
+void unshuffleBytes(const char* in, size_t size, size_t valueSize, char* out)
+{
+    size_t numberOfValues = size / valueSize;
+    for (size_t byte = 0; byte < valueSize; byte++)
+    {
+        for (size_t i = 0; i < numberOfValues; i++)
+        {
+            out[i * valueSize + byte] = in[byte * numberOfValues + i];
+        }
+    }
+}
+
+// LZ77 in sequences of literals followed by a copy of earlier output. A token byte holds both lengths,
+// literals in its high and the copy less minimumMatchLength in its low four bits, with 15 meaning more
+// length follows in bytes of up to 255. The copy's offset back is two bytes. The last sequence has
+// literals only, so the input always ends right after a sequence's literals.
+const size_t minimumMatchLength = 4;
+const size_t maximumMatchOffset = 65535;
+
+void appendLength(std::string& out, size_t length)
+{
+    while (length >= 255)
+    {
+        out += static_cast<char>(255);
+        length -= 255;
+    }
+    out += static_cast<char>(length);
+}
+
+void appendSequence(std::string& out, const char* literals, size_t numberOfLiterals, size_t offset, size_t matchLength)
+{
+    size_t matchCode = (matchLength > 0) ? matchLength - minimumMatchLength : 0;
+    unsigned int token = (static_cast<unsigned int>(std::min<size_t>(numberOfLiterals, 15)) << 4) |
+        static_cast<unsigned int>(std::min<size_t>(matchCode, 15));
+    out += static_cast<char>(token);
+    if (numberOfLiterals >= 15)
+    {
+        appendLength(out, numberOfLiterals - 15);
+    }
+    out.append(literals, numberOfLiterals);
+    if (matchLength > 0)
+    {
+        out += static_cast<char>(offset & 0xff);
+        out += static_cast<char>(offset >> 8);
+        if (matchCode >= 15)
+        {
+            appendLength(out, matchCode - 15);
+        }
+    }
+}
+
+void compressBytes(const char* in, size_t size, std::string& out)
+{
+    out.clear();
+    const size_t notFound = static_cast<size_t>(-1);
+    std::vector<size_t> recentPositions(1 << 14, notFound); // by hash of the next four bytes
+    size_t literalsBegin = 0;
+    size_t i = 0;
+    while (i + minimumMatchLength <= size)
+    {
+        uint32_t next;
+        memcpy(&next, in + i, sizeof(next));
+        size_t hash = (next * 2654435761u) >> 18;
+        size_t candidate = recentPositions[hash];
+        recentPositions[hash] = i;
+        if (candidate != notFound && i - candidate <= maximumMatchOffset && memcmp(in + candidate, in + i, minimumMatchLength) == 0)
+        {
+            size_t matchLength = minimumMatchLength;
+            while (i + matchLength < size && in[candidate + matchLength] == in[i + matchLength])
+            {
+                matchLength++;
+            }
+            appendSequence(out, in + literalsBegin, i - literalsBegin, i - candidate, matchLength);
+            i += matchLength;
+            literalsBegin = i;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    appendSequence(out, in + literalsBegin, size - literalsBegin, 0, 0);
+}
+
+bool readLength(const char* in, size_t size, size_t& i, size_t& length)
+{
+    unsigned int next = 255;
+    while (next == 255)
+    {
+        if (i >= size)
+        {
+            return false;
+        }
+        next = static_cast<unsigned char>(in[i++]);
+        length += next;
+    }
+    return true;
+}
+
+bool decompressBytes(const char* in, size_t size, char* out, size_t rawSize)
+{
+    size_t i = 0;
+    size_t o = 0;
+    while (i < size)
+    {
+        unsigned int token = static_cast<unsigned char>(in[i++]);
+        size_t numberOfLiterals = token >> 4;
+        if (numberOfLiterals == 15 && !readLength(in, size, i, numberOfLiterals))
+        {
+            return false;
+        }
+        if (numberOfLiterals > size - i || numberOfLiterals > rawSize - o)
+        {
+            return false;
+        }
+        memcpy(out + o, in + i, numberOfLiterals);
+        i += numberOfLiterals;
+        o += numberOfLiterals;
+        if (i == size)
+        {
+            break;
+        }
+
+        if (i + 2 > size)
+        {
+            return false;
+        }
+        size_t offset = static_cast<unsigned char>(in[i]) | (static_cast<size_t>(static_cast<unsigned char>(in[i + 1])) << 8);
+        i += 2;
+        size_t matchLength = token & 0xf;
+        if (matchLength == 15 && !readLength(in, size, i, matchLength))
+        {
+            return false;
+        }
+        matchLength += minimumMatchLength;
+        if (offset == 0 || offset > o || matchLength > rawSize - o)
+        {
+            return false;
+        }
+        // byte by byte, as a copy may overlap the bytes it is producing
+        for (size_t k = 0; k < matchLength; k++, o++)
+        {
+            out[o] = out[o - offset];
+        }
+    }
+    return o == rawSize;
+}
+}
+
+ColumnarChunk::ColumnarChunk(const ColumnarWriter& writer)
+{
+    columns_.resize(writer.getNumberOfColumns());
+    for (int i = 0; i < writer.getNumberOfColumns(); i++)
+    {
+        columns_[i].type = writer.getColumnType(i);
+    }
+}
+
+void ColumnarChunk::clear()
+{
+    for (Column& column : columns_)
+    {
+        column.values.clear();
+        column.stringEnds.clear();
+    }
+}
+
+void ColumnarChunk::reserve(size_t numberOfRows)
+{
+    for (Column& column : columns_)
+    {
+        if (column.type == ColumnarColumnType::String)
+        {
+            column.stringEnds.reserve(numberOfRows);
+        }
+        else
+        {
+            column.values.reserve(numberOfRows * getValueSize(column.type));
+        }
+    }
+}
+
+void ColumnarChunk::appendValue(int column, double value)
+{
+    Column& target = columns_[column];
+    switch (target.type)
+    {
+        case ColumnarColumnType::Float64:
+        {
+            appendBytes(target.values, &value, sizeof(value));
+            break;
+        }
+        case ColumnarColumnType::Float32:
+        {
+            float narrowed = static_cast<float>(value);
+            appendBytes(target.values, &narrowed, sizeof(narrowed));
+            break;
+        }
+        case ColumnarColumnType::Int32:
+        {
+            int32_t narrowed = static_cast<int32_t>(value);
+            appendBytes(target.values, &narrowed, sizeof(narrowed));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ColumnarChunk::appendString(int column, const char* text, size_t size)
+{
+    Column& target = columns_[column];
+    target.values.append(text, size);
+    target.stringEnds.push_back(static_cast<uint32_t>(target.values.size()));
+}
+
+void ColumnarChunk::appendString(int column, const std::string& text)
+{
+    appendString(column, text.data(), text.size());
+}
+
+size_t ColumnarChunk::getNumberOfRows(int column) const
+{
+    const Column& target = columns_[column];
+    return (target.type == ColumnarColumnType::String)
+        ? target.stringEnds.size()
+        : target.values.size() / getValueSize(target.type);
+}
+
+ColumnarWriter::ColumnarWriter()
+    : file_(nullptr), isCompressed_(false)
+{
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+    close();
+}
+
+void ColumnarWriter::addColumn(const std::string& name, ColumnarColumnType::ColumnarColumnTypeEnum type)
+{
+    if (!file_)
+    {
+        columnNames_.push_back(name);
+        columnTypes_.push_back(type);
+    }
+}
+
+int ColumnarWriter::getNumberOfColumns() const
+{
+    return static_cast<int>(columnTypes_.size());
+}
+
+ColumnarColumnType::ColumnarColumnTypeEnum ColumnarWriter::getColumnType(int column) const
+{
+    return columnTypes_[column];
+}
+
+bool ColumnarWriter::open(const std::string& fileName, bool isCompressed)
+{
+    close();
+    file_ = fopen(fileName.c_str(), "wb");
+    if (!file_)
+    {
+        return false;
+    }
+    isCompressed_ = isCompressed;
+
+    std::string header;
+    appendBytes(header, fileMagic, sizeof(fileMagic));
+    appendBytes(header, &byteOrderMark, sizeof(byteOrderMark));
+    appendBytes(header, &formatVersion, sizeof(formatVersion));
+    uint32_t numberOfColumns = static_cast<uint32_t>(columnTypes_.size());
+    appendBytes(header, &numberOfColumns, sizeof(numberOfColumns));
+    for (size_t i = 0; i < columnTypes_.size(); i++)
+    {
+        uint32_t type = static_cast<uint32_t>(columnTypes_[i]);
+        uint32_t nameLength = static_cast<uint32_t>(columnNames_[i].size());
+        appendBytes(header, &type, sizeof(type));
+        appendBytes(header, &nameLength, sizeof(nameLength));
+        header += columnNames_[i];
+    }
+    header.append(getPaddingToEightBytes(header.size()), '\0');
+    return writeEncodedChunk(header);
+}
+
+bool ColumnarWriter::isOpen() const
+{
+    return file_ != nullptr;
+}
+
+bool ColumnarWriter::close()
+{
+    bool isClosed = true;
+    if (file_)
+    {
+        isClosed = (fclose(file_) == 0);
+        file_ = nullptr;
+    }
+    return isClosed;
+}
+
+bool ColumnarWriter::encodeChunk(const ColumnarChunk& chunk, std::string& encoded) const
+{
+    encoded.clear();
+    if (chunk.columns_.size() != columnTypes_.size() || columnTypes_.empty())
+    {
+        return false;
+    }
+    size_t numberOfRows = chunk.getNumberOfRows(0);
+    for (size_t i = 1; i < columnTypes_.size(); i++)
+    {
+        if (chunk.getNumberOfRows(static_cast<int>(i)) != numberOfRows)
+        {
+            return false;
+        }
+    }
+
+    uint32_t chunkHeader[2] = { static_cast<uint32_t>(numberOfRows), 0 };
+    appendBytes(encoded, chunkHeader, sizeof(chunkHeader));
+
+    std::string raw;
+    std::string shuffled;
+    std::string compressed;
+    for (const ColumnarChunk::Column& column : chunk.columns_)
+    {
+        const std::string* block = &column.values;
+        if (column.type == ColumnarColumnType::String)
+        {
+            raw.clear();
+            appendBytes(raw, column.stringEnds.data(), column.stringEnds.size() * sizeof(uint32_t));
+            raw += column.values;
+            block = &raw;
+        }
+
+        uint64_t sizes[2] = { block->size(), block->size() };
+        if (isCompressed_ && !block->empty())
+        {
+            shuffleBytes(block->data(), block->size(), getValueSize(column.type), shuffled);
+            compressBytes(shuffled.data(), shuffled.size(), compressed);
+            if (compressed.size() < block->size())
+            {
+                sizes[1] = compressed.size();
+                block = &compressed;
+            }
+        }
+        appendBytes(encoded, sizes, sizeof(sizes));
+        encoded += *block;
+        encoded.append(getPaddingToEightBytes(block->size()), '\0');
+    }
+    return true;
+}
+
+bool ColumnarWriter::writeEncodedChunk(const std::string& encoded)
+{
+    return file_ && fwrite(encoded.data(), 1, encoded.size(), file_) == encoded.size();
+}
+
+bool ColumnarWriter::writeChunk(const ColumnarChunk& chunk)
+{
+    return encodeChunk(chunk, encodedChunk_) && writeEncodedChunk(encodedChunk_);
+}
+
+ColumnarReader::ColumnarReader()
+    : data_(nullptr), size_(0), numberOfRows_(0)
+{
+}
+
+ColumnarReader::~ColumnarReader()
+{
+    close();
+}
+
+bool ColumnarReader::open(const std::string& fileName)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            data_ = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            size_ = data_ ? static_cast<size_t>(fileSize.QuadPart) : 0;
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(fileName.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    struct stat fileStatus;
+    if (fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_SHARED, file, 0);
+        if (mapping != MAP_FAILED)
+        {
+            data_ = static_cast<const char*>(mapping);
+            size_ = static_cast<size_t>(fileStatus.st_size);
+        }
+    }
+    ::close(file);
+#endif
+
+    size_t position = 0;
+    if (!data_ || !readSchema(position))
+    {
+        close();
+        return false;
+    }
+    readChunks(position);
+    return true;
+}
+
+bool ColumnarReader::isOpen() const
+{
+    return data_ != nullptr;
+}
+
+void ColumnarReader::close()
+{
+    if (data_)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    columnNames_.clear();
+    columnTypes_.clear();
+    chunkNumberOfRows_.clear();
+    blocks_.clear();
+    numberOfRows_ = 0;
+}
+
+bool ColumnarReader::readSchema(size_t& position)
+{
+    char magic[sizeof(fileMagic)];
+    uint32_t fileByteOrderMark = 0;
+    uint32_t version = 0;
+    uint32_t numberOfColumns = 0;
+    if (!readBytes(data_, size_, position, magic) || memcmp(magic, fileMagic, sizeof(fileMagic)) != 0 ||
+        !readBytes(data_, size_, position, fileByteOrderMark) || fileByteOrderMark != byteOrderMark ||
+        !readBytes(data_, size_, position, version) || version != formatVersion ||
+        !readBytes(data_, size_, position, numberOfColumns))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < numberOfColumns; i++)
+    {
+        uint32_t type = 0;
+        uint32_t nameLength = 0;
+        if (!readBytes(data_, size_, position, type) || type > ColumnarColumnType::String ||
+            !readBytes(data_, size_, position, nameLength) || nameLength > size_ - position)
+        {
+            return false;
+        }
+        columnTypes_.push_back(static_cast<ColumnarColumnType::ColumnarColumnTypeEnum>(type));
+        columnNames_.push_back(std::string(data_ + position, nameLength));
+        position += nameLength;
+    }
+    position += getPaddingToEightBytes(position);
+    return position <= size_;
+}
+
+void ColumnarReader::readChunks(size_t position)
+{
+    std::vector<Block> chunkBlocks(columnTypes_.size());
+    uint32_t chunkHeader[2];
+    while (readBytes(data_, size_, position, chunkHeader))
+    {
+        uint32_t numberOfRows = chunkHeader[0];
+        for (size_t i = 0; i < columnTypes_.size(); i++)
+        {
+            uint64_t sizes[2];
+            if (!readBytes(data_, size_, position, sizes) || sizes[1] > sizes[0] || sizes[1] > size_ - position)
+            {
+                return; // cut short
+            }
+            size_t valueSize = getValueSize(columnTypes_[i]);
+            bool isSizeValid = (columnTypes_[i] == ColumnarColumnType::String)
+                ? sizes[0] >= uint64_t(numberOfRows) * sizeof(uint32_t)
+                : sizes[0] == uint64_t(numberOfRows) * valueSize;
+            if (!isSizeValid)
+            {
+                return;
+            }
+            chunkBlocks[i].offset = position;
+            chunkBlocks[i].rawSize = sizes[0];
+            chunkBlocks[i].storedSize = sizes[1];
+            position += static_cast<size_t>(sizes[1]);
+            position += getPaddingToEightBytes(position);
+        }
+        chunkNumberOfRows_.push_back(static_cast<int>(numberOfRows));
+        blocks_.insert(blocks_.end(), chunkBlocks.begin(), chunkBlocks.end());
+        numberOfRows_ += numberOfRows;
+    }
+}
+
+int ColumnarReader::getNumberOfColumns() const
+{
+    return static_cast<int>(columnTypes_.size());
+}
+
+const std::string& ColumnarReader::getColumnName(int column) const
+{
+    return columnNames_[column];
+}
+
+ColumnarColumnType::ColumnarColumnTypeEnum ColumnarReader::getColumnType(int column) const
+{
+    return columnTypes_[column];
+}
+
+int ColumnarReader::getColumnIndex(const std::string& name) const
+{
+    for (size_t i = 0; i < columnNames_.size(); i++)
+    {
+        if (columnNames_[i] == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+long ColumnarReader::getNumberOfRows() const
+{
+    return numberOfRows_;
+}
+
+int ColumnarReader::getNumberOfChunks() const
+{
+    return static_cast<int>(chunkNumberOfRows_.size());
+}
+
+int ColumnarReader::getChunkNumberOfRows(int chunk) const
+{
+    return chunkNumberOfRows_[chunk];
+}
+
+const void* ColumnarReader::getChunkColumn(int chunk, int column)
+{
+    const Block& block = blocks_[chunk * columnTypes_.size() + column];
+    const char* stored = data_ + block.offset;
+    if (block.storedSize == block.rawSize)
+    {
+        return stored;
+    }
+
+    size_t rawSize = static_cast<size_t>(block.rawSize);
+    std::vector<char> shuffled(rawSize);
+    if (!decompressBytes(stored, static_cast<size_t>(block.storedSize), shuffled.data(), rawSize))
+    {
+        return nullptr;
+    }
+    decoded_.resize(rawSize);
+    unshuffleBytes(shuffled.data(), rawSize, getValueSize(columnTypes_[column]), decoded_.data());
+    return decoded_.data();
+}
+
+bool ColumnarReader::readColumn(int column, std::vector<double>& values)
+{
+    values.clear();
+    ColumnarColumnType::ColumnarColumnTypeEnum type = columnTypes_[column];
+    if (type == ColumnarColumnType::String)
+    {
+        return false;
+    }
+    values.reserve(numberOfRows_);
+    for (int chunk = 0; chunk < getNumberOfChunks(); chunk++)
+    {
+        const char* block = static_cast<const char*>(getChunkColumn(chunk, column));
+        if (!block)
+        {
+            return false;
+        }
+        for (int row = 0; row < chunkNumberOfRows_[chunk]; row++)
+        {
+            if (type == ColumnarColumnType::Float64)
+            {
+                double value;
+                memcpy(&value, block + row * sizeof(value), sizeof(value));
+                values.push_back(value);
+            }
+            else if (type == ColumnarColumnType::Float32)
+            {
+                float value;
+                memcpy(&value, block + row * sizeof(value), sizeof(value));
+                values.push_back(value);
+            }
+            else
+            {
+                int32_t value;
+                memcpy(&value, block + row * sizeof(value), sizeof(value));
+                values.push_back(value);
+            }
+        }
+    }
+    return true;
+}
+
+bool ColumnarReader::readColumn(int column, std::vector<std::string>& values)
+{
+    values.clear();
+    if (columnTypes_[column] != ColumnarColumnType::String)
+    {
+        return false;
+    }
+    values.reserve(numberOfRows_);
+    for (int chunk = 0; chunk < getNumberOfChunks(); chunk++)
+    {
+        const char* block = static_cast<const char*>(getChunkColumn(chunk, column));
+        if (!block)
+        {
+            return false;
+        }
+        size_t numberOfRows = chunkNumberOfRows_[chunk];
+        size_t textSize = static_cast<size_t>(blocks_[chunk * columnTypes_.size() + column].rawSize) -
+            numberOfRows * sizeof(uint32_t);
+        const char* text = block + numberOfRows * sizeof(uint32_t);
+        uint32_t begin = 0;
+        for (size_t row = 0; row < numberOfRows; row++)
+        {
+            uint32_t end;
+            memcpy(&end, block + row * sizeof(end), sizeof(end));
+            if (end < begin || end > textSize)
+            {
+                return false;
+            }
+            values.push_back(std::string(text + begin, end - begin));
+            begin = end;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,175 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Columnar binary output for batch runs, written a chunk of rows at
+*           a time and read back through a memory mapping
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#ifndef COLUMNARFILE_H
+#define COLUMNARFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Columnar binary files hold a schema header followed by chunks of rows. Each chunk stores every
+// column as one contiguous block: Float32, Float64 and Int32 columns as fixed-width values in host
+// byte order, String columns as one uint32 end offset per row followed by the text of every row.
+// Blocks are 8 byte aligned so uncompressed blocks can be used in place from a memory mapping.
+// Compressed blocks are byte shuffled by value width and LZ77 compressed, and are only kept where
+// that is smaller than the raw values.
+struct ColumnarColumnType
+{
+    enum ColumnarColumnTypeEnum
+    {
+        Float32,
+        Float64,
+        Int32,
+        String
+    };
+};
+
+class ColumnarWriter;
+
+// The rows of one chunk, built up column by column. Each column must end up with the same number
+// of rows before the chunk is written.
+class ColumnarChunk
+{
+public:
+    explicit ColumnarChunk(const ColumnarWriter& writer);
+
+    void clear();
+    void reserve(size_t numberOfRows);
+
+    // Numeric columns take the value converted to the column's type
+    void appendValue(int column, double value);
+    void appendString(int column, const char* text, size_t size);
+    void appendString(int column, const std::string& text);
+
+    size_t getNumberOfRows(int column) const;
+
+private:
+    friend class ColumnarWriter;
+
+    struct Column
+    {
+        ColumnarColumnType::ColumnarColumnTypeEnum type;
+        std::string values;
+        std::vector<uint32_t> stringEnds;
+    };
+
+    std::vector<Column> columns_;
+};
+
+class ColumnarWriter
+{
+public:
+    ColumnarWriter();
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter& rhs) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter& rhs) = delete;
+
+    // The schema is fixed once the file is open
+    void addColumn(const std::string& name, ColumnarColumnType::ColumnarColumnTypeEnum type);
+    int getNumberOfColumns() const;
+    ColumnarColumnType::ColumnarColumnTypeEnum getColumnType(int column) const;
+
+    bool open(const std::string& fileName, bool isCompressed);
+    bool isOpen() const;
+    bool close();
+
+    // Encoding does not touch the file, so chunks can be encoded on worker threads and handed to
+    // whichever thread writes them. False if the chunk's columns do not all have the same number of rows.
+    bool encodeChunk(const ColumnarChunk& chunk, std::string& encoded) const;
+    bool writeEncodedChunk(const std::string& encoded);
+    bool writeChunk(const ColumnarChunk& chunk);
+
+private:
+    FILE* file_;
+    bool isCompressed_;
+    std::vector<std::string> columnNames_;
+    std::vector<ColumnarColumnType::ColumnarColumnTypeEnum> columnTypes_;
+    std::string encodedChunk_;
+};
+
+// Reads a columnar file through a read-only memory mapping. A file cut short while it was still
+// being written reads as the chunks that are complete.
+class ColumnarReader
+{
+public:
+    ColumnarReader();
+    ~ColumnarReader();
+
+    ColumnarReader(const ColumnarReader& rhs) = delete;
+    ColumnarReader& operator=(const ColumnarReader& rhs) = delete;
+
+    bool open(const std::string& fileName);
+    bool isOpen() const;
+    void close();
+
+    int getNumberOfColumns() const;
+    const std::string& getColumnName(int column) const;
+    ColumnarColumnType::ColumnarColumnTypeEnum getColumnType(int column) const;
+    int getColumnIndex(const std::string& name) const; // -1 if there is no such column
+
+    long getNumberOfRows() const;
+    int getNumberOfChunks() const;
+    int getChunkNumberOfRows(int chunk) const;
+
+    // The column's block within a chunk, laid out as described above. Points into the mapping when the
+    // block is stored uncompressed, otherwise into a buffer that is only valid until the next call.
+    // Null if a compressed block does not decode.
+    const void* getChunkColumn(int chunk, int column);
+
+    // Every row of a column; numeric columns are widened to double. False if the column has the other
+    // kind of type or a block does not decode.
+    bool readColumn(int column, std::vector<double>& values);
+    bool readColumn(int column, std::vector<std::string>& values);
+
+private:
+    struct Block
+    {
+        size_t offset;
+        uint64_t rawSize;
+        uint64_t storedSize;
+    };
+
+    bool readSchema(size_t& position);
+    void readChunks(size_t position);
+
+    const char* data_;
+    size_t size_;
+    std::vector<std::string> columnNames_;
+    std::vector<ColumnarColumnType::ColumnarColumnTypeEnum> columnTypes_;
+    std::vector<int> chunkNumberOfRows_;
+    std::vector<Block> blocks_; // by chunk, then column
+    long numberOfRows_;
+    std::vector<char> decoded_;
+};
+
+#endif // COLUMNARFILE_H
@@ -0,0 +1,231 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Compact per-pixel Surface state, its inputs packed and its special
+*           fuel inputs and results kept only when used
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#include "compactSurfaceState.h"
+
+#include <cstring>
+
+#include "surfaceFuelbedIntermediates.h"
+
+CompactSurfaceState::CompactSurfaceState()
+    : inputs_()
+{
+
+}
+
+CompactSurfaceState::CompactSurfaceState(const Surface& surface)
+    : inputs_()
+{
+    capture(surface);
+}
+
+CompactSurfaceState::CompactSurfaceState(const CompactSurfaceState& rhs)
+{
+    memberwiseCopyAssignment(rhs);
+}
+
+CompactSurfaceState& CompactSurfaceState::operator=(const CompactSurfaceState& rhs)
+{
+    if(this != &rhs)
+    {
+        memberwiseCopyAssignment(rhs);
+    }
+    return *this;
+}
+
+void CompactSurfaceState::memberwiseCopyAssignment(const CompactSurfaceState& rhs)
+{
+    inputs_ = rhs.inputs_;
+    specialFuelInputs_.reset(rhs.specialFuelInputs_ ? new CompactSpecialFuelInputs(*rhs.specialFuelInputs_) : nullptr);
+    results_.reset(rhs.results_ ? new CompactSurfaceResults(*rhs.results_) : nullptr);
+}
+
+void CompactSurfaceState::capture(const Surface& surface)
+{
+    inputs_.fuelModelNumber = (short)surface.getFuelModelNumber();
+    inputs_.moistureOneHour = surface.getMoistureOneHour(FractionUnits::Fraction);
+    inputs_.moistureTenHour = surface.getMoistureTenHour(FractionUnits::Fraction);
+    inputs_.moistureHundredHour = surface.getMoistureHundredHour(FractionUnits::Fraction);
+    inputs_.moistureLiveHerbaceous = surface.getMoistureLiveHerbaceous(FractionUnits::Fraction);
+    inputs_.moistureLiveWoody = surface.getMoistureLiveWoody(FractionUnits::Fraction);
+    inputs_.windSpeed = surface.getInputWindSpeed(SpeedUnits::FeetPerMinute);
+    inputs_.windHeightInputMode = (unsigned char)surface.getWindHeightInputMode();
+    inputs_.windDirection = surface.getWindDirection();
+    inputs_.slope = surface.getSlope(SlopeUnits::Degrees);
+    inputs_.aspect = surface.getAspect();
+    inputs_.canopyCover = surface.getCanopyCover(FractionUnits::Fraction);
+    inputs_.canopyHeight = surface.getCanopyHeight(LengthUnits::Feet);
+    inputs_.crownRatio = surface.getCrownRatio(FractionUnits::Fraction);
+
+    CompactSpecialFuelInputs special = { 0, 0, { 0.0, 0.0, 0.0, 0.0 } };
+    if(surface.getIsUsingPalmettoGallberry())
+    {
+        inputs_.fuelbedType = SurfaceFuelbedType::PalmettoGallberry;
+        special.values[0] = surface.getAgeOfRough();
+        special.values[1] = surface.getHeightOfUnderstory(LengthUnits::Feet);
+        special.values[2] = surface.getPalmettoGallberryCoverage(FractionUnits::Fraction);
+        special.values[3] = surface.getOverstoryBasalArea(BasalAreaUnits::SquareFeetPerAcre);
+    }
+    else if(surface.getIsUsingWesternAspen())
+    {
+        inputs_.fuelbedType = SurfaceFuelbedType::WesternAspen;
+        special.code = surface.getAspenFuelModelNumber();
+        special.mode = surface.getAspenFireSeverity();
+        special.values[0] = surface.getAspenCuringLevel(FractionUnits::Fraction);
+        special.values[1] = surface.getAspenDBH(LengthUnits::Inches);
+    }
+    else if(surface.getIsUsingChaparral())
+    {
+        inputs_.fuelbedType = SurfaceFuelbedType::Chaparral;
+        special.code = surface.getChaparralFuelType();
+        special.mode = surface.getChaparralFuelLoadInputMode();
+        special.values[0] = surface.getChaparralFuelBedDepth(LengthUnits::Feet);
+        special.values[1] = surface.getChaparralFuelDeadLoadFraction();
+        special.values[2] = surface.getChaparralTotalFuelLoad(LoadingUnits::PoundsPerSquareFoot);
+    }
+    else
+    {
+        inputs_.fuelbedType = SurfaceFuelbedType::Standard;
+    }
+    specialFuelInputs_.reset((inputs_.fuelbedType != SurfaceFuelbedType::Standard) ? new CompactSpecialFuelInputs(special) : nullptr);
+    results_.reset();
+}
+
+void CompactSurfaceState::captureResults(const Surface& surface)
+{
+    CompactSurfaceResults results = { surface.getSpreadRate(SpeedUnits::FeetPerMinute),
+        surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond), surface.getFlameLength(LengthUnits::Feet),
+        surface.getDirectionOfMaxSpread(), surface.getFireLengthToWidthRatio() };
+    results_.reset(new CompactSurfaceResults(results));
+}
+
+void CompactSurfaceState::clearResults()
+{
+    results_.reset();
+}
+
+void CompactSurfaceState::rehydrate(Surface& surface) const
+{
+    surface.setFuelModelNumber(inputs_.fuelModelNumber);
+    surface.setMoistureOneHour(inputs_.moistureOneHour, FractionUnits::Fraction);
+    surface.setMoistureTenHour(inputs_.moistureTenHour, FractionUnits::Fraction);
+    surface.setMoistureHundredHour(inputs_.moistureHundredHour, FractionUnits::Fraction);
+    surface.setMoistureLiveHerbaceous(inputs_.moistureLiveHerbaceous, FractionUnits::Fraction);
+    surface.setMoistureLiveWoody(inputs_.moistureLiveWoody, FractionUnits::Fraction);
+    surface.setWindSpeed(inputs_.windSpeed, SpeedUnits::FeetPerMinute,
+        (WindHeightInputMode::WindHeightInputModeEnum)inputs_.windHeightInputMode);
+    surface.setWindDirection(inputs_.windDirection);
+    surface.setSlope(inputs_.slope, SlopeUnits::Degrees);
+    surface.setAspect(inputs_.aspect);
+    surface.setCanopyCover(inputs_.canopyCover, FractionUnits::Fraction);
+    surface.setCanopyHeight(inputs_.canopyHeight, LengthUnits::Feet);
+    surface.setCrownRatio(inputs_.crownRatio, FractionUnits::Fraction);
+
+    const CompactSpecialFuelInputs* special = specialFuelInputs_.get();
+    switch(inputs_.fuelbedType)
+    {
+        case SurfaceFuelbedType::PalmettoGallberry:
+            surface.setIsUsingPalmettoGallberry(true);
+            surface.setAgeOfRough(special->values[0]);
+            surface.setHeightOfUnderstory(special->values[1], LengthUnits::Feet);
+            surface.setPalmettoCoverage(special->values[2], FractionUnits::Fraction);
+            surface.setOverstoryBasalArea(special->values[3], BasalAreaUnits::SquareFeetPerAcre);
+            break;
+        case SurfaceFuelbedType::WesternAspen:
+            surface.setIsUsingWesternAspen(true);
+            surface.setAspenFuelModelNumber(special->code);
+            surface.setAspenFireSeverity((AspenFireSeverity::AspenFireSeverityEnum)special->mode);
+            surface.setAspenCuringLevel(special->values[0], FractionUnits::Fraction);
+            surface.setAspenDBH(special->values[1], LengthUnits::Inches);
+            break;
+        case SurfaceFuelbedType::Chaparral:
+            surface.setIsUsingChaparral(true);
+            surface.setChaparralFuelType((ChaparralFuelType::ChaparralFuelTypeEnum)special->code);
+            surface.setChaparralFuelLoadInputMode((ChaparralFuelLoadInputMode::ChaparralFuelInputLoadModeEnum)special->mode);
+            surface.setChaparralFuelBedDepth(special->values[0], LengthUnits::Feet);
+            surface.setChaparralFuelDeadLoadFraction(special->values[1]);
+            surface.setChaparralTotalFuelLoad(special->values[2], LoadingUnits::PoundsPerSquareFoot);
+            break;
+        default:
+            surface.setIsUsingPalmettoGallberry(false);
+            surface.setIsUsingWesternAspen(false);
+            surface.setIsUsingChaparral(false);
+            break;
+    }
+}
+
+const CompactSurfaceInputs& CompactSurfaceState::getInputs() const
+{
+    return inputs_;
+}
+
+const CompactSpecialFuelInputs* CompactSurfaceState::getSpecialFuelInputs() const
+{
+    return specialFuelInputs_.get();
+}
+
+const CompactSurfaceResults* CompactSurfaceState::getResults() const
+{
+    return results_.get();
+}
+
+bool CompactSurfaceState::hasSameInputs(const CompactSurfaceState& rhs) const
+{
+    const CompactSurfaceInputs& lhsInputs = inputs_;
+    const CompactSurfaceInputs& rhsInputs = rhs.inputs_;
+    bool isSame = lhsInputs.moistureOneHour == rhsInputs.moistureOneHour &&
+        lhsInputs.moistureTenHour == rhsInputs.moistureTenHour &&
+        lhsInputs.moistureHundredHour == rhsInputs.moistureHundredHour &&
+        lhsInputs.moistureLiveHerbaceous == rhsInputs.moistureLiveHerbaceous &&
+        lhsInputs.moistureLiveWoody == rhsInputs.moistureLiveWoody &&
+        lhsInputs.windSpeed == rhsInputs.windSpeed &&
+        lhsInputs.windDirection == rhsInputs.windDirection &&
+        lhsInputs.slope == rhsInputs.slope &&
+        lhsInputs.aspect == rhsInputs.aspect &&
+        lhsInputs.canopyCover == rhsInputs.canopyCover &&
+        lhsInputs.canopyHeight == rhsInputs.canopyHeight &&
+        lhsInputs.crownRatio == rhsInputs.crownRatio &&
+        lhsInputs.fuelModelNumber == rhsInputs.fuelModelNumber &&
+        lhsInputs.windHeightInputMode == rhsInputs.windHeightInputMode &&
+        lhsInputs.fuelbedType == rhsInputs.fuelbedType;
+    if(isSame && specialFuelInputs_ && rhs.specialFuelInputs_)
+    {
+        const CompactSpecialFuelInputs& lhsSpecial = *specialFuelInputs_;
+        const CompactSpecialFuelInputs& rhsSpecial = *rhs.specialFuelInputs_;
+        isSame = lhsSpecial.code == rhsSpecial.code && lhsSpecial.mode == rhsSpecial.mode &&
+            std::memcmp(lhsSpecial.values, rhsSpecial.values, sizeof(lhsSpecial.values)) == 0;
+    }
+    return isSame;
+}
+
+size_t CompactSurfaceState::getNumberOfBytes() const
+{
+    return sizeof(*this) + (specialFuelInputs_ ? sizeof(CompactSpecialFuelInputs) : 0) +
+        (results_ ? sizeof(CompactSurfaceResults) : 0);
+}
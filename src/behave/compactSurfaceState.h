@@ -0,0 +1,120 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Compact per-pixel Surface state, its inputs packed and its special
+*           fuel inputs and results kept only when used
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef COMPACTSURFACESTATE_H
+#define COMPACTSURFACESTATE_H
+
+#include <cstddef>
+#include <memory>
+
+#include "surface.h"
+
+// The per-pixel surface inputs, in base units: moistures by size class and canopy cover and crown
+// ratio as fractions, wind speed in ft/min at windHeightInputMode, slope, aspect and wind direction
+// in degrees, canopy height in ft. fuelbedType is a SurfaceFuelbedType.
+struct CompactSurfaceInputs
+{
+    double moistureOneHour;
+    double moistureTenHour;
+    double moistureHundredHour;
+    double moistureLiveHerbaceous;
+    double moistureLiveWoody;
+    double windSpeed;
+    double windDirection;
+    double slope;
+    double aspect;
+    double canopyCover;
+    double canopyHeight;
+    double crownRatio;
+    short fuelModelNumber;
+    unsigned char windHeightInputMode;
+    unsigned char fuelbedType;
+};
+
+// Inputs of a special fuelbed, in base units. Palmetto-gallberry keeps its age of rough, understory
+// height in ft, palmetto coverage as a fraction and overstory basal area in square feet per acre.
+// Western aspen keeps its aspen fuel model as code, fire severity as mode, curing level as a fraction
+// and DBH in inches. Chaparral keeps its fuel type as code, fuel load input mode as mode, depth in ft,
+// dead load fraction and total fuel load in lb/ft^2.
+struct CompactSpecialFuelInputs
+{
+    int code;
+    int mode;
+    double values[4];
+};
+
+// Outputs of the last run in the direction of max spread, in the base units of SurfaceBatchOutputs
+struct CompactSurfaceResults
+{
+    double spreadRate;
+    double firelineIntensity;
+    double flameLength;
+    double directionOfMaxSpread;
+    double fireLengthToWidthRatio;
+};
+
+// The state of one pixel's Surface kept between runs, such as hourly updates over a landscape, in a
+// small fraction of a Surface. Only the inputs that vary by pixel are kept, the special fuel inputs
+// only for a pixel that uses one, and the results of the last run only once they are captured.
+// Settings shared by every pixel, such as the wind adjustment factor method and moisture input
+// mode, are left on the Surface a state is rehydrated into.
+class CompactSurfaceState
+{
+public:
+    CompactSurfaceState();
+    explicit CompactSurfaceState(const Surface& surface);
+    CompactSurfaceState(const CompactSurfaceState& rhs);
+    CompactSurfaceState& operator=(const CompactSurfaceState& rhs);
+
+    // Keeps surface's inputs and drops any captured results
+    void capture(const Surface& surface);
+    // Keeps the results of surface's last run in the direction of max spread
+    void captureResults(const Surface& surface);
+    void clearResults();
+    // Sets this state's inputs on surface, which then runs as the captured Surface did
+    void rehydrate(Surface& surface) const;
+
+    const CompactSurfaceInputs& getInputs() const;
+    // Null when the pixel uses a standard fuel model
+    const CompactSpecialFuelInputs* getSpecialFuelInputs() const;
+    // Null until results are captured
+    const CompactSurfaceResults* getResults() const;
+    bool hasSameInputs(const CompactSurfaceState& rhs) const;
+
+    // Bytes held by this state, its own size and any blocks it allocated
+    size_t getNumberOfBytes() const;
+
+protected:
+    void memberwiseCopyAssignment(const CompactSurfaceState& rhs);
+
+    CompactSurfaceInputs inputs_;
+    std::unique_ptr<CompactSpecialFuelInputs> specialFuelInputs_;
+    std::unique_ptr<CompactSurfaceResults> results_;
+};
+
+#endif // COMPACTSURFACESTATE_H
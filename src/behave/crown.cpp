@@ -31,13 +31,16 @@
 #include "crown.h"
 
 #include <cmath>
+#include <vector>
 #include "fuelModels.h"
+#include "instrumentation.h"
 #include "windSpeedUtility.h"
 
-Crown::Crown(FuelModels& fuelModels)
+Crown::Crown(const FuelModels& fuelModels)
     : surfaceFuel_(fuelModels), crownFuel_(fuelModels)
 {
     fuelModels_ = &fuelModels;
+    isUsingCrownFuelKernel_ = true; // kept by initializeMembers()
     initializeMembers();
 }
 
@@ -63,10 +66,32 @@ Crown& Crown::operator=(const Crown& rhs)
 
 void Crown::memberwiseCopyAssignment(const Crown& rhs)
 {
-    fuelModels_ = rhs.fuelModels_;
     surfaceFuel_ = rhs.surfaceFuel_;
     crownFuel_ = rhs.crownFuel_;
+    copyCrownState(rhs);
+}
+
+void Crown::copyStateWithoutCaches(const Crown& rhs)
+{
+    if (this != &rhs)
+    {
+        surfaceFuel_.copyStateWithoutCaches(rhs.surfaceFuel_);
+        crownFuel_.copyStateWithoutCaches(rhs.crownFuel_);
+        copyCrownState(rhs);
+    }
+}
+
+bool Crown::hasSameInputs(const Crown& rhs) const
+{
+    return crownInputs_.hasSameInputs(rhs.crownInputs_) && surfaceFuel_.hasSameInputs(rhs.surfaceFuel_);
+}
+
+// Everything but the two Surfaces
+void Crown::copyCrownState(const Crown& rhs)
+{
+    fuelModels_ = rhs.fuelModels_;
     crownInputs_ = rhs.crownInputs_;
+    crownFireSize_ = rhs.crownFireSize_;
 
     fireType_ = rhs.fireType_;
     surfaceFireHeatPerUnitArea_ = rhs.surfaceFireHeatPerUnitArea_;
@@ -77,6 +102,9 @@ void Crown::memberwiseCopyAssignment(const Crown& rhs)
     crownFirelineIntensity_ = rhs.crownFirelineIntensity_;
     crownFlameLength_ = rhs.crownFlameLength_;
     crownFireSpreadRate_ = rhs.crownFireSpreadRate_;
+    crownFuelSpreadRate_ = rhs.crownFuelSpreadRate_;
+    crownFuelReactionIntensity_ = rhs.crownFuelReactionIntensity_;
+    crownFuelHeatSink_ = rhs.crownFuelHeatSink_;
     crownCriticalSurfaceFirelineIntensity_ = rhs.crownCriticalSurfaceFirelineIntensity_;
     crownCriticalFireSpreadRate_ = rhs.crownCriticalFireSpreadRate_;
     crownCriticalSurfaceFlameLength_ = rhs.crownCriticalSurfaceFlameLength_;
@@ -86,6 +114,7 @@ void Crown::memberwiseCopyAssignment(const Crown& rhs)
     crownFireLengthToWidthRatio_ = rhs.crownFireLengthToWidthRatio_;
 
     surfaceFireSpreadRate_ = rhs.surfaceFireSpreadRate_;
+    surfaceFireFlameLength_ = rhs.surfaceFireFlameLength_;
     surfaceFireCriticalSpreadRate_ = rhs.surfaceFireCriticalSpreadRate_;
 
     passiveCrownFireSpreadRate_ = rhs.passiveCrownFireSpreadRate_;
@@ -98,16 +127,24 @@ void Crown::memberwiseCopyAssignment(const Crown& rhs)
     finalFirelineIntesity_ = rhs.finalFirelineIntesity_;
     finalFlameLength_ = rhs.finalFlameLength_;
 
+    isReusingCrownFuelModel_ = rhs.isReusingCrownFuelModel_;
+    isCrownFuelModelSetUp_ = rhs.isCrownFuelModelSetUp_;
+    isUsingCrownFuelKernel_ = rhs.isUsingCrownFuelKernel_;
+
     isSurfaceFire_ = rhs.isSurfaceFire_;
     isPassiveCrownFire_ = rhs.isPassiveCrownFire_;
     isActiveCrownFire_ = rhs.isActiveCrownFire_;
+    isCrownFire_ = rhs.isCrownFire_;
 
     crownFireActiveWindSpeed_ = rhs.crownFireActiveWindSpeed_;
     crownFractionBurned_ = rhs.crownFractionBurned_;
+    torchingIndex_ = rhs.torchingIndex_;
+    crowningIndex_ = rhs.crowningIndex_;
 }
 
 void Crown::doCrownRunRothermel()
 {
+    BEHAVE_TIME_STAGE(CrownRun);
     // This method uses Rothermel's 1991 crown fire correlation to calculate Crown fire average spread rate (ft/min)
     double canopyHeight = surfaceFuel_.getCanopyHeight(LengthUnits::Feet);
     double canopyBaseHeight = crownInputs_.getCanopyBaseHeight(LengthUnits::Feet);
@@ -128,18 +165,13 @@ void Crown::doCrownRunRothermel()
     surfaceFireFlameLength_ = surfaceFuel_.getFlameLength(LengthUnits::Feet); // Byram
     
     // Step 2: Create the crown fuel model (fire behavior fuel model 10)
-    crownFuel_ = surfaceFuel_;
-    crownFuel_.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UserInput);
-    double windAdjustmentFactor = 0.4; // Wind adjustment factor is assumed to be 0.4 for crown fuels
-    crownFuel_.setUserProvidedWindAdjustmentFactor(windAdjustmentFactor);
-    crownFuel_.setFuelModelNumber(10); // Set the fuel model used to fuel model 10
-    crownFuel_.setSlope(0.0, SlopeUnits::Degrees); // Slope is assumed to be zero
-    crownFuel_.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
-    crownFuel_.setWindDirection(0.0); // Wind direction is assumed to be upslope
-
     // Step 3: Determine crown fire behavior
-    crownFuel_.doSurfaceRunInDirectionOfMaxSpread();
-    crownFireSpreadRate_ = 3.34 * crownFuel_.getSpreadRate(SpeedUnits::FeetPerMinute); // Rothermel 1991
+    if (!calculateCrownFuelModelWithKernel())
+    {
+        updateCrownFuelModel();
+        calculateCrownFuelModelWithSurface();
+    }
+    crownFireSpreadRate_ = 3.34 * crownFuelSpreadRate_; // Rothermel 1991
 
     // Step 4: Calculate remaining crown fire characteristics
     calculateCrownFuelLoad();
@@ -169,6 +201,7 @@ void Crown::doCrownRunRothermel()
 
 void Crown::doCrownRunScottAndReinhardt()
 {
+    BEHAVE_TIME_STAGE(CrownRun);
     // Scott and Reinhardt (2001) linked models method for crown fire
     double canopyHeight = surfaceFuel_.getCanopyHeight(LengthUnits::Feet);
     double canopyBaseHeight = crownInputs_.getCanopyBaseHeight(LengthUnits::Feet);
@@ -186,18 +219,14 @@ void Crown::doCrownRunScottAndReinhardt()
     surfaceFireFlameLength_ = surfaceFuel_.getFlameLength(LengthUnits::Feet); // Byram
 
     // Step 2: Create the crown fuel model (fire behavior fuel model 10)
-    crownFuel_ = surfaceFuel_;
-    crownFuel_.setFuelModelNumber(10); // Set the crown fuel model used to fuel model 10
-    crownFuel_.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UserInput);
-    crownFuel_.setUserProvidedWindAdjustmentFactor(0.4); // Wind adjustment factor is assumed to be 0.4
-    crownFuel_.setSlope(0, SlopeUnits::Degrees);
-    crownFuel_.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
-    crownFuel_.setWindDirection(0.0); // Wind direction is assumed to be upslope
-    crownFuel_.setWindSpeed(windSpeed, SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
-
     // Step 3: Determine crown fire behavior
-    crownFuel_.doSurfaceRunInDirectionOfMaxSpread();
-    crownFireSpreadRate_ = 3.34 * crownFuel_.getSpreadRate(SpeedUnits::FeetPerMinute); // Rothermel 1991
+    if (!calculateCrownFuelModelWithKernel())
+    {
+        updateCrownFuelModel();
+        crownFuel_.setWindSpeed(windSpeed, SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
+        calculateCrownFuelModelWithSurface();
+    }
+    crownFireSpreadRate_ = 3.34 * crownFuelSpreadRate_; // Rothermel 1991
 
     // Step 4: Calculate remaining crown fire characteristics
     calculateCrownFireActiveWindSpeed();
@@ -225,6 +254,8 @@ void Crown::doCrownRunScottAndReinhardt()
     calculateSurfaceFireCriticalSpreadRateScottAndReinhardt();
 
     calculateCrowningSurfaceFireRateOfSpread();
+    calculateTorchingIndex();
+    calculateCrowningIndex();
 
     // Scott & Reinhardt crown fraction burned
     calculateCrownFractionBurned();
@@ -242,6 +273,203 @@ void Crown::doCrownRunScottAndReinhardt()
     assignFinalFireBehaviorBasedOnFireType(CrownModelType::scott_and_reinhardt);
 }
 
+// Scott and Reinhardt run over a batch of cells, matching doCrownRunScottAndReinhardt() cell by cell. The surface
+// run, the crown fuel model run, the surface spread rate at the crown fire active wind speed and the torching
+// and crowning indices need Crown's Surface set up for the cell, so they are done one cell at a time. All the crown arithmetic that follows only
+// depends on per cell values and is done in a second pass over plain arrays. The crown inputs are left as they
+// were, but after the call Crown's Surface holds the last cell of the batch and the crown getters are stale.
+void Crown::doCrownRunBatchScottAndReinhardt(const CrownBatchInputs& inputs, CrownBatchOutputs& outputs)
+{
+    BEHAVE_TIME_STAGE(CrownRun);
+    const SurfaceBatchInputs& surfaceInputs = inputs.surfaceInputs;
+    const int numberOfCells = surfaceInputs.numberOfCells;
+    std::vector<double> surfaceSpreadRate(numberOfCells);
+    std::vector<double> surfaceHeatPerUnitArea(numberOfCells);
+    std::vector<double> surfaceFirelineIntensity(numberOfCells);
+    std::vector<double> surfaceFlameLength(numberOfCells);
+    std::vector<double> crownSpreadRate(numberOfCells);
+    std::vector<double> crowningSurfaceSpreadRate(numberOfCells);
+    std::vector<double> crownCriticalSurfaceFirelineIntensity(numberOfCells);
+
+    // Pass 1: surface and crown fuel model runs, and the torching and crowning indices that depend on them
+    const CrownInputs crownInputs = crownInputs_;
+    const double torchingIndex = torchingIndex_;
+    surfaceFuel_.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        double crownRatio = (surfaceInputs.canopyHeight[i] - inputs.canopyBaseHeight[i]) / surfaceInputs.canopyHeight[i];
+        SurfaceBatchInputs cellInputs = { 1, &surfaceInputs.fuelModelNumber[i], &surfaceInputs.moistureOneHour[i],
+            &surfaceInputs.moistureTenHour[i], &surfaceInputs.moistureHundredHour[i], &surfaceInputs.moistureLiveHerbaceous[i],
+            &surfaceInputs.moistureLiveWoody[i], &surfaceInputs.windSpeed[i], &surfaceInputs.windDirection[i], &surfaceInputs.slope[i],
+            &surfaceInputs.aspect[i], &surfaceInputs.canopyCover[i], &surfaceInputs.canopyHeight[i], &crownRatio };
+        SurfaceBatchOutputs cellOutputs = { &surfaceSpreadRate[i], &surfaceFirelineIntensity[i], &surfaceFlameLength[i], nullptr, nullptr };
+        surfaceFuel_.doSurfaceRunBatch(cellInputs, cellOutputs);
+        surfaceHeatPerUnitArea[i] = surfaceFuel_.getHeatPerUnitArea(HeatPerUnitAreaUnits::BtusPerSquareFoot);
+
+        if (!calculateCrownFuelModelWithKernel())
+        {
+            updateCrownFuelModel();
+            crownFuel_.setWindSpeed(surfaceInputs.windSpeed[i], SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
+            calculateCrownFuelModelWithSurface();
+        }
+        crownSpreadRate[i] = 3.34 * crownFuelSpreadRate_; // Rothermel 1991
+
+        crownInputs_.updateCrownInputs(inputs.canopyBaseHeight[i], LengthUnits::Feet, inputs.canopyBulkDensity[i],
+            DensityUnits::PoundsPerCubicFoot, inputs.moistureFoliar[i], FractionUnits::Fraction);
+        calculateCrownFireActiveWindSpeed();
+        calculateCrowningSurfaceFireRateOfSpread();
+        crowningSurfaceSpreadRate[i] = crowningSurfaceFireRos_;
+        calculateCrownCriticalSurfaceFireIntensity();
+        crownCriticalSurfaceFirelineIntensity[i] = crownCriticalSurfaceFirelineIntensity_;
+
+        if (outputs.torchingIndex)
+        {
+            // Each cell's search is warm started from the previous cell's index
+            surfaceFireHeatPerUnitArea_ = surfaceHeatPerUnitArea[i];
+            calculateSurfaceFireCriticalSpreadRateScottAndReinhardt();
+            calculateTorchingIndex();
+            outputs.torchingIndex[i] = torchingIndex_;
+        }
+        if (outputs.crowningIndex)
+        {
+            calculateCrowningIndex();
+            outputs.crowningIndex[i] = crowningIndex_;
+        }
+    }
+    crownInputs_ = crownInputs;
+    torchingIndex_ = torchingIndex;
+
+    // Pass 2: crown fire characteristics, critical values, fire type and final fire behavior, as in the single run
+    const double LOW_HEAT_OF_COMBUSTION = 8000.0; // Low heat of combustion (hard coded to 8000 Btu/lbs)
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        const double canopyBaseHeight = inputs.canopyBaseHeight[i];
+        const double canopyBulkDensity = inputs.canopyBulkDensity[i];
+
+        double canopyHeatPerUnitArea = canopyBulkDensity * (surfaceInputs.canopyHeight[i] - canopyBaseHeight) * LOW_HEAT_OF_COMBUSTION;
+        double crownHeatPerUnitArea = surfaceHeatPerUnitArea[i] + canopyHeatPerUnitArea;
+        double crownFirelineIntensity = (crownSpreadRate[i] / 60.0) * crownHeatPerUnitArea;
+        double crownFlameLength = (crownFirelineIntensity <= 0.0) ? 0.0 : 0.2 * pow(crownFirelineIntensity, (2.0 / 3.0));
+
+        double convertedCanopyBulkDensity = DensityUnits::fromBaseUnits(canopyBulkDensity, DensityUnits::KilogramsPerCubicMeter);
+        double crownCriticalFireSpreadRate = (convertedCanopyBulkDensity < 1e-07) ? 0.00 : (3.0 / convertedCanopyBulkDensity);
+        crownCriticalFireSpreadRate = SpeedUnits::toBaseUnits(crownCriticalFireSpreadRate, SpeedUnits::MetersPerMinute);
+
+        double crownFireActiveRatio = (crownCriticalFireSpreadRate < 1e-07) ? 0.00 : (crownSpreadRate[i] / crownCriticalFireSpreadRate);
+        double crownFireTransitionRatio = (crownCriticalSurfaceFirelineIntensity[i] < 1.0e-7)
+            ? 0.00
+            : (surfaceFirelineIntensity[i] / crownCriticalSurfaceFirelineIntensity[i]);
+        FireType::FireTypeEnum fireType = (crownFireTransitionRatio < 1.0)
+            ? ((crownFireActiveRatio < 1.0) ? FireType::Surface : FireType::ConditionalCrownFire)
+            : ((crownFireActiveRatio < 1.0) ? FireType::Torching : FireType::Crowning);
+
+        // Scott & Reinhardt's critical surface fire spread rate and crown fraction burned
+        double surfaceCriticalSpreadRate = (60. * crownCriticalSurfaceFirelineIntensity[i]) / surfaceHeatPerUnitArea[i];
+        double numerator = surfaceSpreadRate[i] - surfaceCriticalSpreadRate;
+        double denominator = crowningSurfaceSpreadRate[i] - surfaceCriticalSpreadRate;
+        double crownFractionBurned = (denominator > 1e-07) ? (numerator / denominator) : 0.0;
+        crownFractionBurned = (crownFractionBurned > 1.0) ? 1.0 : crownFractionBurned;
+        crownFractionBurned = (crownFractionBurned < 0.0) ? 0.0 : crownFractionBurned;
+
+        double finalSpreadRate = surfaceSpreadRate[i];
+        double finalHeatPerUnitArea = surfaceHeatPerUnitArea[i];
+        double finalFirelineIntensity = surfaceFirelineIntensity[i];
+        double finalFlameLength = surfaceFlameLength[i];
+        if (fireType == FireType::Torching)
+        {
+            finalSpreadRate = surfaceSpreadRate[i] + crownFractionBurned * (crownSpreadRate[i] - surfaceSpreadRate[i]);
+            finalHeatPerUnitArea = surfaceHeatPerUnitArea[i] + canopyHeatPerUnitArea * crownFractionBurned;
+            finalFirelineIntensity = finalHeatPerUnitArea * finalSpreadRate / 60.0;
+            finalFlameLength = (finalFirelineIntensity <= 0.0) ? 0.0 : 0.2 * pow(finalFirelineIntensity, (2.0 / 3.0));
+        }
+        else if (fireType == FireType::Crowning)
+        {
+            finalSpreadRate = crownSpreadRate[i];
+            finalHeatPerUnitArea = crownHeatPerUnitArea;
+            finalFirelineIntensity = crownFirelineIntensity;
+            finalFlameLength = crownFlameLength;
+        }
+
+        if (outputs.fireType)
+        {
+            outputs.fireType[i] = fireType;
+        }
+        if (outputs.crownFractionBurned)
+        {
+            outputs.crownFractionBurned[i] = crownFractionBurned;
+        }
+        if (outputs.crownFireSpreadRate)
+        {
+            outputs.crownFireSpreadRate[i] = crownSpreadRate[i];
+        }
+        if (outputs.finalSpreadRate)
+        {
+            outputs.finalSpreadRate[i] = finalSpreadRate;
+        }
+        if (outputs.finalHeatPerUnitArea)
+        {
+            outputs.finalHeatPerUnitArea[i] = finalHeatPerUnitArea;
+        }
+        if (outputs.finalFirelineIntensity)
+        {
+            outputs.finalFirelineIntensity[i] = finalFirelineIntensity;
+        }
+        if (outputs.finalFlameLength)
+        {
+            outputs.finalFlameLength[i] = finalFlameLength;
+        }
+    }
+}
+
+void Crown::updateCrownFuelModel()
+{
+    if(isReusingCrownFuelModel_ && isCrownFuelModelSetUp_)
+    {
+        // Only the weather has changed since the crown fuel model was set up
+        crownFuel_.copyWindAndMoistureInputs(surfaceFuel_);
+        return;
+    }
+
+    crownFuel_ = surfaceFuel_;
+    crownFuel_.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UserInput);
+    double windAdjustmentFactor = 0.4; // Wind adjustment factor is assumed to be 0.4 for crown fuels
+    crownFuel_.setUserProvidedWindAdjustmentFactor(windAdjustmentFactor);
+    crownFuel_.setFuelModelNumber(10); // Set the fuel model used to fuel model 10
+    crownFuel_.setSlope(0.0, SlopeUnits::Degrees); // Slope is assumed to be zero
+    crownFuel_.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
+    crownFuel_.setWindDirection(0.0); // Wind direction is assumed to be upslope
+    isCrownFuelModelSetUp_ = true;
+}
+
+// Fuel model 10 run on level ground with upslope wind and a wind adjustment factor of 0.4, the same inputs
+// updateCrownFuelModel() gives the crown fuel model. False when SurfaceKernel does not apply.
+bool Crown::calculateCrownFuelModelWithKernel()
+{
+    const double windAdjustmentFactor = 0.4; // Wind adjustment factor is assumed to be 0.4 for crown fuels
+    SurfaceKernelInputs inputs;
+    SurfaceKernelFuelModel fuelModel;
+    if (!isUsingCrownFuelKernel_ || !surfaceFuel_.getSurfaceKernelInputsOnLevelGround(windAdjustmentFactor, inputs) ||
+        !SurfaceKernel::loadFuelModel(*fuelModels_, 10, fuelModel))
+    {
+        return false;
+    }
+
+    SurfaceKernelOutputs outputs;
+    SurfaceKernel::calculate(fuelModel, inputs, outputs);
+    crownFuelSpreadRate_ = outputs.spreadRate;
+    crownFuelReactionIntensity_ = outputs.reactionIntensity;
+    crownFuelHeatSink_ = outputs.heatSink;
+    return true;
+}
+
+void Crown::calculateCrownFuelModelWithSurface()
+{
+    crownFuel_.doSurfaceRunInDirectionOfMaxSpread();
+    crownFuelSpreadRate_ = crownFuel_.getSpreadRate(SpeedUnits::FeetPerMinute);
+    crownFuelReactionIntensity_ = crownFuel_.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
+    crownFuelHeatSink_ = crownFuel_.getHeatSink(HeatSinkUnits::BtusPerCubicFoot);
+}
+
 void Crown::calculateCrownFractionBurned()
 {
     // Calculates the crown fraction burned as per Scott & Reinhardt.
@@ -321,9 +549,7 @@ void Crown::calculateCrownFireActiveWindSpeed()
     double ractive = 3.28084 * (3.0 / cbd);         // R'active, ft/min
     double r10 = ractive / 3.34;                    // R'active = 3.324 * R10
     double propFlux = 0.048317062998571636;         // Fuel model 10 actual propagating flux ratio
-    double reactionIntensity = crownFuel_.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
-    double heatSink = crownFuel_.getHeatSink(HeatSinkUnits::BtusPerCubicFoot);
-    double ros0 = reactionIntensity * propFlux / heatSink;
+    double ros0 = crownFuelReactionIntensity_ * propFlux / crownFuelHeatSink_;
     double windB = 1.4308256324729873;              // Fuel model 10 actual wind factor B
     double windBInv = 1.0 / windB;                  // Fuel model 10 actual inverse of wind factor B
     double windK = 0.0016102128596515481;           // Fuel model 10 actual K = C*pow((beta/betOpt),-E)
@@ -333,6 +559,29 @@ void Crown::calculateCrownFireActiveWindSpeed()
     crownFireActiveWindSpeed_ = uMid / 0.4;         // 20-ft wind speed (ft/min) for waf=0.4
 }
 
+void Crown::calculateTorchingIndex()
+{
+    // O'initiation, the 20-ft wind speed at which the surface fire spread rate reaches R'initiation, see Scott &
+    // Reinhardt (2001) page 19. The previous index warm starts the search when there is no closed form.
+    torchingIndex_ = surfaceFuel_.calculateTwentyFootWindSpeedAtSpreadRate(surfaceFireCriticalSpreadRate_,
+        (torchingIndex_ == HUGE_VAL) ? 0.0 : torchingIndex_);
+}
+
+void Crown::calculateCrowningIndex()
+{
+    // O'active, unless fuel model 10 needs more midflame wind than its wind speed limit to spread at R'active
+    double uMid = 0.4 * crownFireActiveWindSpeed_;
+    double windSpeedLimit = 0.9 * crownFuelReactionIntensity_;
+    if (!(uMid > 0.0))
+    {
+        crowningIndex_ = 0.0; // R'active is reached with no wind
+    }
+    else
+    {
+        crowningIndex_ = (uMid > windSpeedLimit) ? HUGE_VAL : crownFireActiveWindSpeed_;
+    }
+}
+
 double Crown::getCrownFireSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits) const
 {
     return SpeedUnits::fromBaseUnits(crownFireSpreadRate_, spreadRateUnits);
@@ -396,6 +645,11 @@ double Crown::getCrownFireLengthToWidthRatio() const
     return crownFireLengthToWidthRatio_;
 }
 
+double Crown::getSurfaceFireLengthToWidthRatio() const
+{
+    return surfaceFuel_.getFireLengthToWidthRatio();
+}
+
 double Crown::getCrownFireArea(AreaUnits::AreaUnitsEnum areaUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const
 {
     return crownFireSize_.getFireArea(true, areaUnits, elapsedTime, timeUnits);
@@ -406,6 +660,12 @@ double Crown::getCrownFirePerimeter(LengthUnits::LengthUnitsEnum lengthUnits, do
     return crownFireSize_.getFirePerimeter(true, lengthUnits, elapsedTime, timeUnits);
 }
 
+void Crown::getCrownFireSizeAtElapsedTimes(const double* elapsedTimes, int numberOfElapsedTimes, TimeUnits::TimeUnitsEnum timeUnits,
+    LengthUnits::LengthUnitsEnum lengthUnits, AreaUnits::AreaUnitsEnum areaUnits, FireSizeBatchOutputs& outputs) const
+{
+    crownFireSize_.getFireSizeAtElapsedTimes(true, elapsedTimes, numberOfElapsedTimes, timeUnits, lengthUnits, areaUnits, outputs);
+}
+
 double Crown::getCriticalOpenWindSpeed(SpeedUnits::SpeedUnitsEnum speedUnits) const
 {
     return SpeedUnits::fromBaseUnits(crownFireActiveWindSpeed_, speedUnits);
@@ -416,6 +676,39 @@ double Crown::getCrownFractionBurned() const
     return crownFractionBurned_;
 }
 
+double Crown::getTorchingIndex(SpeedUnits::SpeedUnitsEnum speedUnits) const
+{
+    return SpeedUnits::fromBaseUnits(torchingIndex_, speedUnits);
+}
+
+double Crown::getCrowningIndex(SpeedUnits::SpeedUnitsEnum speedUnits) const
+{
+    return SpeedUnits::fromBaseUnits(crowningIndex_, speedUnits);
+}
+
+void Crown::getOutputs(const OutputUnitProfile& unitProfile, CrownOutputValues& outputs) const
+{
+    const double spreadRateFactor = unitProfile.getSpreadRateFactor();
+    const double flameLengthFactor = unitProfile.getFlameLengthFactor();
+    const double firelineIntensityFactor = unitProfile.getFirelineIntensityFactor();
+    const double windSpeedFactor = unitProfile.getWindSpeedFactor();
+
+    outputs.fireType = fireType_;
+    outputs.crownFractionBurned = crownFractionBurned_;
+    outputs.surfaceFireSpreadRate = surfaceFuel_.getSpreadRate(SpeedUnits::FeetPerMinute) * spreadRateFactor;
+    outputs.crownFireSpreadRate = crownFireSpreadRate_ * spreadRateFactor;
+    outputs.crownFlameLength = crownFlameLength_ * flameLengthFactor;
+    outputs.crownFirelineIntensity = crownFirelineIntensity_ * firelineIntensityFactor;
+    outputs.finalSpreadRate = finalSpreadRate_ * spreadRateFactor;
+    outputs.finalHeatPerUnitArea = finalHeatPerUnitArea_ * unitProfile.getHeatPerUnitAreaFactor();
+    outputs.finalFirelineIntensity = finalFirelineIntesity_ * firelineIntensityFactor;
+    outputs.finalFlameLength = finalFlameLength_ * flameLengthFactor;
+    outputs.crownFireLengthToWidthRatio = crownFireLengthToWidthRatio_;
+    outputs.criticalOpenWindSpeed = crownFireActiveWindSpeed_ * windSpeedFactor;
+    outputs.torchingIndex = torchingIndex_ * windSpeedFactor;
+    outputs.crowningIndex = crowningIndex_ * windSpeedFactor;
+}
+
 void Crown::initializeMembers()
 {
     fireType_ = FireType::Surface;
@@ -427,6 +720,9 @@ void Crown::initializeMembers()
     crownFirelineIntensity_ = 0.0;
     crownFlameLength_ = 0.0;
     crownFireSpreadRate_ = 0.0;
+    crownFuelSpreadRate_ = 0.0;
+    crownFuelReactionIntensity_ = 0.0;
+    crownFuelHeatSink_ = 0.0;
     crownCriticalSurfaceFirelineIntensity_ = 0.0;
     crownCriticalFireSpreadRate_ = 0.0;
     crownCriticalSurfaceFlameLength_ = 0.0;
@@ -435,8 +731,17 @@ void Crown::initializeMembers()
     windSpeedAtTwentyFeet_ = 0.0;;
     crownFireLengthToWidthRatio_ = 1.0;
     crownFractionBurned_ = 0.0;
+    torchingIndex_ = 0.0;
+    crowningIndex_ = 0.0;
     surfaceFireSpreadRate_ = 0.0;
     surfaceFireCriticalSpreadRate_ = 0.0;
+    surfaceFireFlameLength_ = 0.0;
+    crowningSurfaceFireRos_ = 0.0;
+
+    finalSpreadRate_ = 0.0;
+    finalHeatPerUnitArea_ = 0.0;
+    finalFirelineIntesity_ = 0.0;
+    finalFlameLength_ = 0.0;
 
     passiveCrownFireSpreadRate_ = 0.0;
     passiveCrownFireHeatPerUnitArea_ = 0.0;
@@ -446,14 +751,51 @@ void Crown::initializeMembers()
     isSurfaceFire_ = false;
     isPassiveCrownFire_ = false;
     isActiveCrownFire_ = false;
+    isCrownFire_ = false;
 
     crownFireActiveWindSpeed_ = 0.0;
     crownInputs_.initializeMembers();
+
+    isReusingCrownFuelModel_ = false;
+    isCrownFuelModelSetUp_ = false;
 }
 
-void Crown::setFuelModels(FuelModels& fuelModels)
+void Crown::setFuelModels(const FuelModels& fuelModels)
 {
     fuelModels_ = &fuelModels;
+    isCrownFuelModelSetUp_ = false;
+}
+
+void Crown::setIsReusingCrownFuelModel(bool isReusingCrownFuelModel)
+{
+    isReusingCrownFuelModel_ = isReusingCrownFuelModel;
+    isCrownFuelModelSetUp_ = false;
+}
+
+bool Crown::getIsReusingCrownFuelModel() const
+{
+    return isReusingCrownFuelModel_;
+}
+
+void Crown::setIsUsingCrownFuelKernel(bool isUsingCrownFuelKernel)
+{
+    isUsingCrownFuelKernel_ = isUsingCrownFuelKernel;
+}
+
+bool Crown::getIsUsingCrownFuelKernel() const
+{
+    return isUsingCrownFuelKernel_;
+}
+
+void Crown::setSharedCache(SharedSurfaceCache* sharedCache)
+{
+    surfaceFuel_.setSharedCache(sharedCache);
+    crownFuel_.setSharedCache(sharedCache);
+}
+
+SharedSurfaceCache* Crown::getSharedCache() const
+{
+    return surfaceFuel_.getSharedCache();
 }
 
 void Crown::calculateCanopyHeatPerUnitArea()
@@ -579,11 +921,9 @@ void Crown::calculateWindSpeedAtTwentyFeet()
 
 void Crown::calculateCrowningSurfaceFireRateOfSpread()
 {
-    Surface surfaceTemp = surfaceFuel_; // Remember state to undo side-effects of this method
-    surfaceFuel_.setWindSpeed(crownFireActiveWindSpeed_, SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
-    surfaceFuel_.doSurfaceRunInDirectionOfMaxSpread(); // Do crown run with crowning fire active wind speed
-    crowningSurfaceFireRos_ = surfaceFuel_.getSpreadRate(SpeedUnits::FeetPerMinute);
-    surfaceFuel_ = surfaceTemp; // Restore state
+    // Surface spread rate at the crowning fire active wind speed, leaves the surface run untouched
+    crowningSurfaceFireRos_ = surfaceFuel_.calculateSpreadRateAtTwentyFootWindSpeed(crownFireActiveWindSpeed_, SpeedUnits::FeetPerMinute,
+        SpeedUnits::FeetPerMinute);
 }
 
 void Crown::calculateFireTypeRothermel()
@@ -644,6 +984,7 @@ void Crown::updateCrownInputs(int fuelModelNumber, double moistureOneHour, doubl
         moistureLiveWoody, moistureUnits, windSpeed, windSpeedUnits, windHeightInputMode, windDirection,
         windAndSpreadOrientationMode, slope, slopeUnits, aspect, canopyCover, coverUnits, canopyHeight, canopyHeightUnits, crownRatio, crownRatioUnits);
     crownInputs_.updateCrownInputs(canopyBaseHeight, canopyHeightUnits, canopyBulkDensity, densityUnits, moistureFoliar, moistureUnits);
+    isCrownFuelModelSetUp_ = false;
 }
 
 void Crown::setCanopyBaseHeight(double canopyBaseHeight, LengthUnits::LengthUnitsEnum heightUnits)
@@ -763,6 +1104,7 @@ void Crown::updateCrownsSurfaceInputs(int fuelModelNumber, double moistureOneHou
         moistureLiveHerbaceous, moistureLiveWoody, moistureUnits, windSpeed, windSpeedUnits, windHeightInputMode,
         windDirection, windAndSpreadOrientationMode, slope, slopeUnits, aspect, canopyCover, coverUnits,
         canopyHeight, canopyHeightUnits, crownRatio, crownRatioUnits);
+    isCrownFuelModelSetUp_ = false;
 }
 
 void  Crown::setCanopyCover(double canopyCover, FractionUnits::FractionUnitsEnum coverUnits)
@@ -823,7 +1165,7 @@ void Crown::setMoistureLiveAggregate(double moistureLive, FractionUnits::Fractio
     crownFuel_.setMoistureLiveAggregate(moistureLive, moistureUnits);
 }
 
-void Crown::setMoistureScenarios(MoistureScenarios& moistureScenarios)
+void Crown::setMoistureScenarios(const MoistureScenarios& moistureScenarios)
 {
     surfaceFuel_.setMoistureScenarios(moistureScenarios);
 }
@@ -885,6 +1227,16 @@ void Crown::setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalcula
     surfaceFuel_.setWindAdjustmentFactorCalculationMethod(windAdjustmentFactorCalculationMethod);
 }
 
+double Crown::getUserProvidedWindAdjustmentFactor() const
+{
+    return surfaceFuel_.getUserProvidedWindAdjustmentFactor();
+}
+
+WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum Crown::getWindAdjustmentFactorCalculationMethod() const
+{
+    return surfaceFuel_.getWindAdjustmentFactorCalculationMethod();
+}
+
 int Crown::getFuelModelNumber() const
 {
     return surfaceFuel_.getFuelModelNumber();
@@ -52,21 +52,93 @@ struct FireType
     };
 };
 
+// Inputs for Crown::doCrownRunBatchScottAndReinhardt(), each array holds surfaceInputs.numberOfCells values in
+// base units: canopy base height in ft, canopy bulk density in lb/ft^3 and foliar moisture as a fraction.
+// The surface wind speeds are 20 ft wind speeds and surfaceInputs.crownRatio may be null, each cell's crown
+// ratio is derived from its canopy height and canopy base height as in the single run.
+struct CrownBatchInputs
+{
+    SurfaceBatchInputs surfaceInputs;
+    const double* canopyBaseHeight;
+    const double* canopyBulkDensity;
+    const double* moistureFoliar;
+};
+
+// Caller-provided output arrays for Crown::doCrownRunBatchScottAndReinhardt(), each sized for numberOfCells
+// values and filled in base units: spread rates in ft/min, heat per unit area in btu/ft^2, fireline intensity
+// in btu/ft/s, flame length in ft. Any array may be null if that output is not needed, a null torching index
+// array also skips its search.
+struct CrownBatchOutputs
+{
+    FireType::FireTypeEnum* fireType;
+    double* crownFractionBurned;
+    double* crownFireSpreadRate;
+    double* finalSpreadRate;
+    double* finalHeatPerUnitArea;
+    double* finalFirelineIntensity;
+    double* finalFlameLength;
+    double* torchingIndex;              // 20 ft wind speed (ft/min)
+    double* crowningIndex;              // 20 ft wind speed (ft/min)
+};
+
+// Outputs of the last run filled by one Crown::getOutputs() call, in the units of its OutputUnitProfile.
+// The surface fire outputs are those of the surface fuel; the torching and crowning indices and the
+// critical open wind speed are 20 ft wind speeds in the profile's wind speed units.
+struct CrownOutputValues
+{
+    FireType::FireTypeEnum fireType;
+    double crownFractionBurned;
+    double surfaceFireSpreadRate;
+    double crownFireSpreadRate;
+    double crownFlameLength;
+    double crownFirelineIntensity;
+    double finalSpreadRate;
+    double finalHeatPerUnitArea;
+    double finalFirelineIntensity;
+    double finalFlameLength;
+    double crownFireLengthToWidthRatio;
+    double criticalOpenWindSpeed;
+    double torchingIndex;
+    double crowningIndex;
+};
+
 class Crown
 {
 public:
     Crown() = delete; // No default constructor
-    Crown(FuelModels& fuelModels);
+    Crown(const FuelModels& fuelModels);
     ~Crown();
 
     Crown(const Crown& rhs);
     Crown& operator=(const Crown& rhs);
 
+    // Like assignment, but keeps the caches of this Crown's surface and crown fuel Surfaces
+    void copyStateWithoutCaches(const Crown& rhs);
+    bool hasSameInputs(const Crown& rhs) const;
+
     void doCrownRunRothermel();
     void doCrownRunScottAndReinhardt();
+    void doCrownRunBatchScottAndReinhardt(const CrownBatchInputs& inputs, CrownBatchOutputs& outputs);
     void initializeMembers();
 
-    void setFuelModels(FuelModels& fuelModels);
+    void setFuelModels(const FuelModels& fuelModels);
+
+    // When reusing, the crown fuel model (fuel model 10 on Crown's second Surface) is set up on the
+    // next run and later runs only copy the wind speed and moistures of the surface fuel into it.
+    // This is only valid while those are the only surface inputs set between runs, as for a time
+    // series at one location. updateCrownInputs() sets the crown fuel model up again.
+    void setIsReusingCrownFuelModel(bool isReusingCrownFuelModel);
+    bool getIsReusingCrownFuelModel() const;
+
+    // With fuel model 10, slope, wind direction and wind adjustment factor all fixed, the crown fuel model run only
+    // depends on the moistures and the wind speed, so by default it goes through SurfaceKernel without setting up
+    // the second Surface. Moistures that are not entered by size class always take the second Surface.
+    void setIsUsingCrownFuelKernel(bool isUsingCrownFuelKernel);
+    bool getIsUsingCrownFuelKernel() const;
+
+    // Shared cache of the surface and crown fuel Surfaces, see Surface::setSharedCache()
+    void setSharedCache(SharedSurfaceCache* sharedCache);
+    SharedSurfaceCache* getSharedCache() const;
 
     // CROWN Module Setters
     void updateCrownInputs(int fuelModelNumber, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
@@ -99,11 +171,23 @@ public:
     double getFinalFlameLength(LengthUnits::LengthUnitsEnum flameLengthUnits) const;
 
     double getCrownFireLengthToWidthRatio() const;
+    double getSurfaceFireLengthToWidthRatio() const;
     double getCrownFireArea(AreaUnits::AreaUnitsEnum areaUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const;
     double getCrownFirePerimeter(LengthUnits::LengthUnitsEnum lengthUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const;
+    void getCrownFireSizeAtElapsedTimes(const double* elapsedTimes, int numberOfElapsedTimes, TimeUnits::TimeUnitsEnum timeUnits,
+        LengthUnits::LengthUnitsEnum lengthUnits, AreaUnits::AreaUnitsEnum areaUnits, FireSizeBatchOutputs& outputs) const;
     double getCriticalOpenWindSpeed(SpeedUnits::SpeedUnitsEnum speedUnits) const;
     double getCrownFractionBurned() const;
 
+    // Scott and Reinhardt (2001) torching and crowning indices, the 20 ft wind speeds at which crown fire initiates
+    // and at which active crown fire is possible. Set by doCrownRunScottAndReinhardt(), an index the wind speed
+    // limit keeps from being reached is HUGE_VAL.
+    double getTorchingIndex(SpeedUnits::SpeedUnitsEnum speedUnits) const;
+    double getCrowningIndex(SpeedUnits::SpeedUnitsEnum speedUnits) const;
+
+    // All of the outputs above in one call, converted by the profile's resolved factors
+    void getOutputs(const OutputUnitProfile& unitProfile, CrownOutputValues& outputs) const;
+
     // Fuel Model Getter Methods
     std::string getFuelCode(int fuelModelNumber) const;
     std::string getFuelName(int fuelModelNumber) const;
@@ -142,7 +226,7 @@ public:
     void setMoistureLiveHerbaceous(double moistureLiveHerbaceous, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureLiveWoody(double moistureLiveWoody, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureLiveAggregate(double moistureLive, FractionUnits::FractionUnitsEnum moistureUnits);
-    void setMoistureScenarios(MoistureScenarios& moistureScenarios);
+    void setMoistureScenarios(const MoistureScenarios& moistureScenarios);
     bool setCurrentMoistureScenarioByName(std::string moistureScenarioName);
     bool setCurrentMoistureScenarioByIndex(int moistureScenarioIndex);
     void setMoistureInputMode(MoistureInputMode::MoistureInputModeEnum moistureInputMode);
@@ -186,6 +270,8 @@ public:
     double getCanopyCover(FractionUnits::FractionUnitsEnum canopyCoverUnits) const;
     double getCanopyHeight(LengthUnits::LengthUnitsEnum canopyHeighUnits) const;
     double getCrownRatio(FractionUnits::FractionUnitsEnum crownRatioUnits) const;
+    double getUserProvidedWindAdjustmentFactor() const;
+    WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum getWindAdjustmentFactorCalculationMethod() const;
 
 protected:
     struct CrownModelType
@@ -196,7 +282,7 @@ protected:
             scott_and_reinhardt
         };
     };
-    FuelModels* fuelModels_;
+    const FuelModels* fuelModels_;
     CrownInputs crownInputs_;
 
     // SURFACE module components
@@ -208,7 +294,13 @@ protected:
 
     // Private methods
     void memberwiseCopyAssignment(const Crown& rhs);
+    void copyCrownState(const Crown& rhs);
+    void updateCrownFuelModel();
+    bool calculateCrownFuelModelWithKernel();
+    void calculateCrownFuelModelWithSurface();
     void calculateCrownFireActiveWindSpeed();
+    void calculateTorchingIndex();
+    void calculateCrowningIndex();
     void calculateCanopyHeatPerUnitArea();
     void calculateCrownFireHeatPerUnitArea();
     void calculateCrownFuelLoad();
@@ -241,6 +333,9 @@ protected:
     double crownFirelineIntensity_;                 // Crown fire fireline intensity (Btu / ft / s)
     double crownFlameLength_;                       // Crown fire flame length (ft)
     double crownFireSpreadRate_;
+    double crownFuelSpreadRate_;                    // Fuel model 10 spread rate (ft/min)
+    double crownFuelReactionIntensity_;             // Fuel model 10 reaction intensity (Btu/ft^2/min)
+    double crownFuelHeatSink_;                      // Fuel model 10 heat sink (Btu/ft^3)
     double crownCriticalSurfaceFirelineIntensity_;  // Crown fire's critical surface fire intensity (Btu / ft / s)
     double crownCriticalFireSpreadRate_;            // Crown fire's critical crown fire spread rate (ft / min)
     double crownCriticalSurfaceFlameLength_;        // Crown fire's critical surface fire flame length (ft)
@@ -249,6 +344,8 @@ protected:
     double crownFireLengthToWidthRatio_;            // Crown fire length-to-width ratio
     double crownFireActiveWindSpeed_;               // 20 ft windspeed at which active crowning is possible (ft/min)
     double crownFractionBurned_;
+    double torchingIndex_;                          // 20 ft wind speed at which crown fire initiates (ft/min)
+    double crowningIndex_;                          // 20 ft wind speed at which active crown fire is possible (ft/min)
     double crowningSurfaceFireRos_;                 // Surface fire spread rate at which the active crown fire spread rate is fully achieved (ft/min)
     double windSpeedAtTwentyFeet_;
 
@@ -266,6 +363,10 @@ protected:
     bool isPassiveCrownFire_;
     bool isActiveCrownFire_;
     bool isCrownFire_;
+
+    bool isReusingCrownFuelModel_;
+    bool isCrownFuelModelSetUp_;                    // crownFuel_ holds fuel model 10 set up from surfaceFuel_
+    bool isUsingCrownFuelKernel_;
 };
 
 #endif // CROWN_H
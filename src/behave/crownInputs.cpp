@@ -104,3 +104,12 @@ void CrownInputs::updateCrownInputs(double canopyBaseHeight, LengthUnits::Length
     setCanopyBulkDensity(canopyBulkDensity, densityUnits);
     setMoistureFoliar(moistureFoliar, moistureUnits);
 }
+
+bool CrownInputs::hasSameInputs(const CrownInputs& rhs) const
+{
+    return canopyBaseHeight_ == rhs.canopyBaseHeight_ &&
+        canopyBulkDensity_ == rhs.canopyBulkDensity_ &&
+        canopyUserProvidedFlameLength_ == rhs.canopyUserProvidedFlameLength_ &&
+        canopyUserProvidedFirelineIntensity_ == rhs.canopyUserProvidedFirelineIntensity_ &&
+        moistureFoliar_ == rhs.moistureFoliar_;
+}
@@ -55,6 +55,8 @@ public:
         double canopyBulkDensity, DensityUnits::DensityUnitsEnum densityUnits, double moistureFoliar, 
         FractionUnits::FractionUnitsEnum moistureUnits);
 
+    bool hasSameInputs(const CrownInputs& rhs) const;
+
 protected:
     double canopyBaseHeight_; //Canopy base height(ft)
     double canopyBulkDensity_; // Canopy bulk density(lb / ft3)
@@ -0,0 +1,229 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Streaming reader for comma delimited files that hands out each
+*           row's fields as views into its read buffer
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "csvReader.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+bool CsvField::equals(const char* text) const
+{
+    size_t length = strlen(text);
+    return (length == size_) && (length == 0 || memcmp(data_, text, length) == 0);
+}
+
+CsvField CsvField::trimmed() const
+{
+    const char* begin = data_;
+    const char* end = data_ + size_;
+    while (begin < end && (isspace((unsigned char)*begin) || !isprint((unsigned char)*begin)))
+    {
+        begin++;
+    }
+    while (end > begin && (isspace((unsigned char)end[-1]) || !isprint((unsigned char)end[-1])))
+    {
+        end--;
+    }
+    return CsvField(begin, end - begin);
+}
+
+bool CsvField::toDouble(double& value) const
+{
+    // strtod() needs a terminated string, numbers are short so copy to the stack
+    char text[64];
+    if (size_ == 0 || size_ >= sizeof(text))
+    {
+        return false;
+    }
+    memcpy(text, data_, size_);
+    text[size_] = '\0';
+    char* end = nullptr;
+    errno = 0;
+    double parsed = strtod(text, &end);
+    if (end != text + size_ || errno == ERANGE)
+    {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool CsvField::toInt(int& value) const
+{
+    size_t i = 0;
+    bool isNegative = false;
+    if (size_ > 0 && (data_[0] == '-' || data_[0] == '+'))
+    {
+        isNegative = (data_[0] == '-');
+        i++;
+    }
+    if (i == size_)
+    {
+        return false;
+    }
+    long long parsed = 0;
+    for (; i < size_; i++)
+    {
+        if (data_[i] < '0' || data_[i] > '9')
+        {
+            return false;
+        }
+        parsed = parsed * 10 + (data_[i] - '0');
+        if (parsed > 2147483648LL)
+        {
+            return false;
+        }
+    }
+    parsed = isNegative ? -parsed : parsed;
+    if (parsed > 2147483647LL)
+    {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+CsvReader::CsvReader(const std::string& fileName, char delimiter)
+    : file_(fopen(fileName.c_str(), "rb")),
+    delimiter_(delimiter),
+    buffer_(blockSize_),
+    rowBegin_(0),
+    dataEnd_(0),
+    isEndOfFile_(file_ == nullptr),
+    rowNumber_(0)
+{
+
+}
+
+CsvReader::~CsvReader()
+{
+    if (file_)
+    {
+        fclose(file_);
+    }
+}
+
+bool CsvReader::isOpen() const
+{
+    return file_ != nullptr;
+}
+
+bool CsvReader::fillBuffer()
+{
+    // Slide the unfinished row to the front, growing the buffer if that row fills it
+    size_t pending = dataEnd_ - rowBegin_;
+    if (rowBegin_ > 0)
+    {
+        memmove(buffer_.data(), buffer_.data() + rowBegin_, pending);
+        rowBegin_ = 0;
+        dataEnd_ = pending;
+    }
+    if (dataEnd_ == buffer_.size())
+    {
+        buffer_.resize(buffer_.size() * 2);
+    }
+    size_t bytesRead = fread(buffer_.data() + dataEnd_, 1, buffer_.size() - dataEnd_, file_);
+    dataEnd_ += bytesRead;
+    if (bytesRead == 0)
+    {
+        isEndOfFile_ = true;
+    }
+    return bytesRead > 0;
+}
+
+bool CsvReader::readRow()
+{
+    fields_.clear();
+    size_t scanFrom = rowBegin_;
+    const char* newline = nullptr;
+    while (true)
+    {
+        newline = static_cast<const char*>(memchr(buffer_.data() + scanFrom, '\n', dataEnd_ - scanFrom));
+        if (newline || isEndOfFile_)
+        {
+            break;
+        }
+        size_t scanned = dataEnd_ - rowBegin_;
+        fillBuffer();
+        scanFrom = rowBegin_ + scanned;
+    }
+
+    const char* begin = buffer_.data() + rowBegin_;
+    const char* end = newline ? newline : buffer_.data() + dataEnd_;
+    if (!newline && begin == end)
+    {
+        return false; // nothing after the last line ending
+    }
+    rowBegin_ = newline ? (newline - buffer_.data()) + 1 : dataEnd_;
+    if (end > begin && end[-1] == '\r')
+    {
+        end--;
+    }
+
+    row_ = CsvField(begin, end - begin);
+    const char* fieldBegin = begin;
+    while (true)
+    {
+        const char* delimiter = static_cast<const char*>(memchr(fieldBegin, delimiter_, end - fieldBegin));
+        if (!delimiter)
+        {
+            fields_.push_back(CsvField(fieldBegin, end - fieldBegin));
+            break;
+        }
+        fields_.push_back(CsvField(fieldBegin, delimiter - fieldBegin));
+        fieldBegin = delimiter + 1;
+    }
+    rowNumber_++;
+    return true;
+}
+
+int CsvReader::getNumberOfFields() const
+{
+    return static_cast<int>(fields_.size());
+}
+
+CsvField CsvReader::getField(int index) const
+{
+    if (index < 0 || index >= static_cast<int>(fields_.size()))
+    {
+        return CsvField();
+    }
+    return fields_[index];
+}
+
+CsvField CsvReader::getRow() const
+{
+    return row_;
+}
+
+long CsvReader::getRowNumber() const
+{
+    return rowNumber_;
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Streaming reader for comma delimited files that hands out each
+*           row's fields as views into its read buffer
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A field of the current CsvReader row. It points into the reader's buffer, so it is only valid
+// until the next call to readRow().
+class CsvField
+{
+public:
+    CsvField() : data_(nullptr), size_(0) {}
+    CsvField(const char* data, size_t size) : data_(data), size_(size) {}
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    bool equals(const char* text) const;
+    std::string toString() const { return std::string(data_, size_); }
+
+    // Without surrounding whitespace and non-printable characters
+    CsvField trimmed() const;
+
+    // Parse the whole field as a number, false (leaving value alone) if it is empty or has
+    // anything else in it
+    bool toDouble(double& value) const;
+    bool toInt(int& value) const;
+
+private:
+    const char* data_;
+    size_t size_;
+};
+
+// Reads a comma delimited file one row at a time in large blocks, splitting each row in place
+// rather than copying every field into its own string. Rows end in \n or \r\n; quoting is not
+// supported. Every field of a row is split, so a row ending in a comma has a final empty field.
+class CsvReader
+{
+public:
+    explicit CsvReader(const std::string& fileName, char delimiter = ',');
+    ~CsvReader();
+
+    CsvReader(const CsvReader& rhs) = delete;
+    CsvReader& operator=(const CsvReader& rhs) = delete;
+
+    bool isOpen() const;
+
+    // Advances to the next row, false at the end of the file
+    bool readRow();
+
+    int getNumberOfFields() const;
+    CsvField getField(int index) const; // empty past the last field of the row
+    CsvField getRow() const; // the whole row without its line ending
+    long getRowNumber() const; // one based, counting the header
+
+private:
+    bool fillBuffer();
+
+    static const size_t blockSize_ = 1 << 20;
+
+    FILE* file_;
+    char delimiter_;
+    std::vector<char> buffer_;
+    size_t rowBegin_;       // start of the current row in buffer_
+    size_t dataEnd_;        // one past the last byte read into buffer_
+    bool isEndOfFile_;
+    CsvField row_;
+    std::vector<CsvField> fields_;
+    long rowNumber_;
+};
+
+#endif // CSVREADER_H
@@ -1,3 +1,7 @@
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+
 #include "fineDeadFuelMoistureTool.h"
 
 FineDeadFuelMoistureTool::FineDeadFuelMoistureTool()
@@ -250,6 +254,107 @@ void FineDeadFuelMoistureTool::calculateByIndex(const int aspectIndex, const int
     }
 }
 
+void FineDeadFuelMoistureTool::calculateBatch(const FDFMToolBatchInputs& inputs, FDFMToolBatchOutputs& outputs) const
+{
+    // Flattened copies of the tables, so each cell's lookups are a single index each
+    const int numRelativeHumidityValues = relativeHumidities_.size();
+    const int numCorrectionColumns = correctionMoistures_[0].size();
+    std::vector<int> referenceTable;
+    for (const std::vector<int>& row : referenceMostures_)
+    {
+        referenceTable.insert(referenceTable.end(), row.begin(), row.end());
+    }
+    std::vector<int> correctionTable;
+    for (const std::vector<int>& row : correctionMoistures_)
+    {
+        correctionTable.insert(correctionTable.end(), row.begin(), row.end());
+    }
+
+    // Month number to month index, January first
+    const int monthIndices[12] = { 2, 1, 1, 1, 0, 0, 0, 1, 1, 1, 2, 2 };
+    // 30 percent slope in degrees
+    const double steepSlope = atan(0.30) * 180.0 / M_PI;
+
+    // A null month or hour array reads the scalar for every cell
+    const int* month = (inputs.month != nullptr) ? inputs.month : &inputs.allCellsMonth;
+    const int monthStride = (inputs.month != nullptr) ? 1 : 0;
+    const double* hourOfDay = (inputs.hourOfDay != nullptr) ? inputs.hourOfDay : &inputs.allCellsHourOfDay;
+    const int hourStride = (inputs.hourOfDay != nullptr) ? 1 : 0;
+
+    // Cells are classified a chunk at a time, then the chunk's moistures are gathered. The
+    // classification clamps every index into its table before validity is applied, so neither
+    // loop branches on the inputs.
+    const int chunkSize = 256;
+    int referenceIndex[chunkSize];
+    int correctionIndex[chunkSize];
+    int isValid[chunkSize];
+    for (int begin = 0; begin < inputs.numberOfCells; begin += chunkSize)
+    {
+        const int count = std::min(chunkSize, inputs.numberOfCells - begin);
+        for (int j = 0; j < count; j++)
+        {
+            const int i = begin + j;
+            const double aspect = inputs.aspect[i];
+            const double slope = inputs.slope[i];
+            const double shading = inputs.shading[i];
+            const double dryBulb = inputs.dryBulbTemperature[i];
+            const double relativeHumidity = inputs.relativeHumidity[i];
+            const double elevationDifference = inputs.elevationDifference[i];
+            const int cellMonth = month[i * monthStride];
+            const double cellHour = hourOfDay[i * hourStride];
+
+            // Quadrants centred on north, east, south and west
+            double rotatedAspect = fmod(aspect + 45.0, 360.0);
+            rotatedAspect += (rotatedAspect < 0.0) * 360.0;
+            const int aspectIndex = static_cast<int>(fmin(fmax(rotatedAspect / 90.0, 0.0), 3.0));
+            const int dryBulbIndex = static_cast<int>(fmin(fmax((dryBulb - 10.0) / 20.0, 0.0), 5.0));
+            // The small offset keeps bin edges such as 0.15 in the upper bin
+            const int relativeHumidityIndex = static_cast<int>(fmin(fmax(relativeHumidity * 20.0 + 1.0e-9, 0.0), 20.0));
+            const int slopeIndex = (slope > steepSlope);
+            const int shadingIndex = (shading >= 0.5);
+            const int elevationIndex = 1 + (elevationDifference > 1000.0) - (elevationDifference < -1000.0);
+            const int monthIndex = monthIndices[std::min(std::max(cellMonth, 1), 12) - 1];
+            const int timeOfDayIndex = static_cast<int>(fmin(fmax((cellHour - 8.0) / 2.0, 0.0), 5.0));
+
+            isValid[j] = (rotatedAspect >= 0.0) & (slope >= 0.0) & (shading >= 0.0) & (shading <= 1.0) &
+                (dryBulb >= 10.0) & (relativeHumidity >= 0.0) & (relativeHumidity <= 1.0) &
+                (fabs(elevationDifference) <= 2000.0) & (cellMonth >= 1) & (cellMonth <= 12) &
+                (cellHour >= 8.0) & (cellHour <= 24.0);
+
+            // Same table rows and columns as calculateByIndex()
+            referenceIndex[j] = dryBulbIndex * numRelativeHumidityValues + relativeHumidityIndex;
+            const int row = (1 - shadingIndex) * (slopeIndex + 2 * aspectIndex) + shadingIndex * (8 + aspectIndex)
+                + 12 * monthIndex;
+            const int column = elevationIndex + 3 * timeOfDayIndex;
+            correctionIndex[j] = row * numCorrectionColumns + column;
+        }
+
+        for (int j = 0; j < count; j++)
+        {
+            const int i = begin + j;
+            const int referenceMoisture = isValid[j] ? referenceTable[referenceIndex[j]] : -1;
+            const int correctionMoisture = isValid[j] ? correctionTable[correctionIndex[j]] : -1;
+            const int fineDeadFuelMoisture = isValid[j] ? referenceMoisture + correctionMoisture : -1;
+            if (outputs.referenceMoisture != nullptr)
+            {
+                outputs.referenceMoisture[i] = referenceMoisture;
+            }
+            if (outputs.correctionMoisture != nullptr)
+            {
+                outputs.correctionMoisture[i] = correctionMoisture;
+            }
+            if (outputs.fineDeadFuelMoisture != nullptr)
+            {
+                outputs.fineDeadFuelMoisture[i] = fineDeadFuelMoisture;
+            }
+            if (outputs.moistureOneHour != nullptr)
+            {
+                outputs.moistureOneHour[i] = isValid[j] ? fineDeadFuelMoisture / 100.0 : -1.0;
+            }
+        }
+    }
+}
+
 int FineDeadFuelMoistureTool::getReferenceMoisture() const
 {
     return referenceMoisture_;
@@ -106,6 +106,40 @@ struct FDFMToolTimeOfDayIndex
     };
 };
 
+// Structure-of-arrays inputs for FineDeadFuelMoistureTool::calculateBatch(), each array holds
+// numberOfCells values in the base units the surface batch inputs use, so the same aspect, slope
+// and canopy cover rasters can be passed to both: aspect in degrees clockwise from north, slope
+// in degrees, shading and relative humidity as fractions, dry bulb temperature in oF and the
+// elevation of the cell minus that of the weather site in ft. Month (1 - 12) and hour of day
+// (0 - 24) are usually the same for a whole grid, when their array is null every cell uses the
+// scalar value instead.
+struct FDFMToolBatchInputs
+{
+    int numberOfCells;
+    const double* aspect;
+    const double* slope;
+    const double* shading;
+    const double* dryBulbTemperature;
+    const double* relativeHumidity;
+    const double* elevationDifference;
+    const int* month;
+    const double* hourOfDay;
+    int allCellsMonth;
+    double allCellsHourOfDay;
+};
+
+// Caller-provided output arrays for FineDeadFuelMoistureTool::calculateBatch(), each sized for
+// numberOfCells values. The moistures are in percent, as from the single cell getters, and
+// moistureOneHour has the fine dead fuel moisture as the fraction SurfaceBatchInputs takes. Cells
+// whose inputs are outside the tool's tables get -1 in every output. Any array may be null.
+struct FDFMToolBatchOutputs
+{
+    int* referenceMoisture;
+    int* correctionMoisture;
+    int* fineDeadFuelMoisture;
+    double* moistureOneHour;
+};
+
 class FineDeadFuelMoistureTool
 {
 public:
@@ -128,6 +162,14 @@ public:
         const int relativeHumidityIndex, const int shadingIndex,
         const int slopeIndex, const int timeOfDayIndex);
 
+    // Classifies every cell's inputs into the tool's index ranges and looks up its moistures,
+    // without changing this tool's outputs. Aspects are binned into the quadrants centred on
+    // north, east, south and west, dry bulb temperatures from 10 oF, relative humidity from 0 to
+    // 1, slopes at 30 percent, shading at 0.5, elevation differences within 2000 ft and hours
+    // from 8 on, with every hour from 18 on in the "18:00 - Sunset" range. Masking cells after
+    // sunset is left to the caller.
+    void calculateBatch(const FDFMToolBatchInputs& inputs, FDFMToolBatchOutputs& outputs) const;
+
     // Getters for the maximum valid values for various indices, applies to enums and string vectors 
     int getAspectIndexSize() const;
     int getDryBulbTemperatureIndexSize() const;
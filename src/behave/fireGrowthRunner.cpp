@@ -0,0 +1,490 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Minimum travel time fire growth over a landscape raster
+*           driven by hourly weather
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "fireGrowthRunner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <thread>
+
+#include "behaveRun.h"
+#include "runControl.h"
+#include "threadPool.h"
+
+namespace
+{
+    // The eight neighbors and the eight knight's moves between them, clockwise from north
+    const int neighborRowOffsets[FireGrowthRunner::NumberOfNeighbors] =
+        { -1, -2, -1, -1, 0, 1, 1, 2, 1, 2, 1, 1, 0, -1, -1, -2 };
+    const int neighborColumnOffsets[FireGrowthRunner::NumberOfNeighbors] =
+        { 0, 1, 1, 2, 1, 2, 1, 1, 0, -1, -1, -2, -1, -2, -1, -1 };
+
+    // A knight's move crosses the corners of two more pixels, the one it leaves and the one it
+    // lands beside, given as offsets from the pixel it leaves. Steps to the eight neighbors
+    // cross none and repeat their own offset so the two arrays line up
+    const int crossedRowOffsets[FireGrowthRunner::NumberOfNeighbors][2] =
+    {
+        { -1, -1 }, { -1, -1 }, { -1, -1 }, { 0, -1 }, { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 1 },
+        { 1, 1 }, { 1, 1 }, { 1, 1 }, { 0, 1 }, { 0, 0 }, { 0, -1 }, { -1, -1 }, { -1, -1 }
+    };
+    const int crossedColumnOffsets[FireGrowthRunner::NumberOfNeighbors][2] =
+    {
+        { 0, 0 }, { 0, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 1, 1 }, { 0, 1 },
+        { 0, 0 }, { 0, -1 }, { -1, -1 }, { -1, -1 }, { -1, -1 }, { -1, -1 }, { -1, -1 }, { 0, -1 }
+    };
+
+    const int queueArity = 4;
+
+    // Burned pixels between polls of the RunControl
+    const long pixelsPerPoll = 256;
+
+    bool isNoDataInBand(const LandscapeBand& band, long pixel, double noDataValue)
+    {
+        return band.values && band.values[pixel] == noDataValue;
+    }
+}
+
+void FireGrowthQueue::clear()
+{
+    entries_.clear();
+}
+
+void FireGrowthQueue::reserve(size_t capacity)
+{
+    entries_.reserve(capacity);
+}
+
+bool FireGrowthQueue::empty() const
+{
+    return entries_.empty();
+}
+
+size_t FireGrowthQueue::size() const
+{
+    return entries_.size();
+}
+
+const FireGrowthQueue::Entry& FireGrowthQueue::top() const
+{
+    return entries_.front();
+}
+
+void FireGrowthQueue::push(double time, long pixel)
+{
+    // Sift the hole up from the end, moving parents down rather than swapping
+    size_t hole = entries_.size();
+    entries_.push_back(Entry());
+    while(hole > 0)
+    {
+        size_t parent = (hole - 1) / queueArity;
+        if(entries_[parent].time <= time)
+        {
+            break;
+        }
+        entries_[hole] = entries_[parent];
+        hole = parent;
+    }
+    entries_[hole].time = time;
+    entries_[hole].pixel = pixel;
+}
+
+void FireGrowthQueue::pop()
+{
+    Entry last = entries_.back();
+    entries_.pop_back();
+    size_t size = entries_.size();
+    if(size == 0)
+    {
+        return;
+    }
+
+    // Sift the hole left at the root down to where the last entry belongs
+    size_t hole = 0;
+    for(;;)
+    {
+        size_t firstChild = hole * queueArity + 1;
+        if(firstChild >= size)
+        {
+            break;
+        }
+        size_t lastChild = std::min(firstChild + queueArity, size);
+        size_t smallest = firstChild;
+        for(size_t child = firstChild + 1; child < lastChild; child++)
+        {
+            if(entries_[child].time < entries_[smallest].time)
+            {
+                smallest = child;
+            }
+        }
+        if(last.time <= entries_[smallest].time)
+        {
+            break;
+        }
+        entries_[hole] = entries_[smallest];
+        hole = smallest;
+    }
+    entries_[hole] = last;
+}
+
+FireGrowthRunner::FireGrowthRunner(const BehaveRun& prototype)
+    : surfacePrototype_(prototype.surface),
+    crownPrototype_(prototype.crown),
+    fireMethod_(FireGrowthFireMethod::ScottAndReinhardt),
+    windHeightInputMode_(WindHeightInputMode::TwentyFoot),
+    cellSize_(LengthUnits::toBaseUnits(30.0, LengthUnits::Meters)),
+    maximumTime_(0.0),
+    numberOfThreads_(0),
+    runControl_(nullptr),
+    numberOfBurnedPixels_(0),
+    numberOfSpreadRateSweeps_(0),
+    wasStopped_(false)
+{
+    for(int neighbor = 0; neighbor < NumberOfNeighbors; neighbor++)
+    {
+        neighborDirections_[neighbor] = getNeighborDirection(neighbor);
+    }
+}
+
+void FireGrowthRunner::setFireMethod(FireGrowthFireMethod::FireGrowthFireMethodEnum fireMethod)
+{
+    fireMethod_ = fireMethod;
+}
+
+void FireGrowthRunner::setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
+{
+    windHeightInputMode_ = windHeightInputMode;
+}
+
+void FireGrowthRunner::setCellSize(double cellSize, LengthUnits::LengthUnitsEnum lengthUnits)
+{
+    cellSize_ = LengthUnits::toBaseUnits(cellSize, lengthUnits);
+}
+
+void FireGrowthRunner::setMaximumTime(double maximumTime)
+{
+    maximumTime_ = maximumTime;
+}
+
+void FireGrowthRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+void FireGrowthRunner::setRunControl(RunControl* runControl)
+{
+    runControl_ = runControl;
+}
+
+long FireGrowthRunner::getNumberOfBurnedPixels() const
+{
+    return numberOfBurnedPixels_;
+}
+
+int FireGrowthRunner::getNumberOfSpreadRateSweeps() const
+{
+    return numberOfSpreadRateSweeps_;
+}
+
+bool FireGrowthRunner::wasStopped() const
+{
+    return wasStopped_;
+}
+
+void FireGrowthRunner::getNeighborOffset(int neighbor, int& rowOffset, int& columnOffset)
+{
+    rowOffset = neighborRowOffsets[neighbor];
+    columnOffset = neighborColumnOffsets[neighbor];
+}
+
+double FireGrowthRunner::getNeighborDirection(int neighbor)
+{
+    // Rows run south, so north is a negative row offset
+    double direction = atan2((double)neighborColumnOffsets[neighbor], (double)-neighborRowOffsets[neighbor]) * 180.0 / M_PI;
+    return (direction < 0.0) ? direction + 360.0 : direction;
+}
+
+void FireGrowthRunner::run(const LandscapeInputBands& inputs, const BehaveTimeSeriesWeather& weather,
+    const std::vector<FireGrowthIgnition>& ignitions, FireGrowthOutputBands& outputs)
+{
+    numberOfBurnedPixels_ = 0;
+    numberOfSpreadRateSweeps_ = 0;
+    wasStopped_ = false;
+    if(inputs.numberOfRows <= 0 || inputs.numberOfColumns <= 0)
+    {
+        return;
+    }
+
+    const int numberOfRows = inputs.numberOfRows;
+    const int numberOfColumns = inputs.numberOfColumns;
+    const long numberOfPixels = (long)numberOfRows * numberOfColumns;
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    std::vector<double> arrivalTime(numberOfPixels, infinity);
+    std::vector<int> flowDirection(numberOfPixels, -1);
+    std::vector<char> isBurned(numberOfPixels, 0);
+
+    if(weather.numberOfHours > 0)
+    {
+        int numberOfThreads = numberOfThreads_;
+        if(numberOfThreads <= 0)
+        {
+            numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+        }
+        numberOfThreads = (int)std::min((long)numberOfThreads, (long)numberOfRows);
+
+        std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+        Worker prototypeWorker = { surfacePrototype_, crownPrototype_ };
+        std::vector<Worker> workers(threadPool->getNumberOfSlots(numberOfThreads), prototypeWorker);
+        spreadRates_.assign(numberOfPixels * NumberOfNeighbors, 0.0f);
+
+        double stepDistances[NumberOfNeighbors];
+        for(int neighbor = 0; neighbor < NumberOfNeighbors; neighbor++)
+        {
+            double rowOffset = neighborRowOffsets[neighbor];
+            double columnOffset = neighborColumnOffsets[neighbor];
+            stepDistances[neighbor] = cellSize_ * sqrt(rowOffset * rowOffset + columnOffset * columnOffset);
+        }
+
+        queue_.clear();
+        for(size_t i = 0; i < ignitions.size(); i++)
+        {
+            const FireGrowthIgnition& ignition = ignitions[i];
+            if(ignition.row < 0 || ignition.row >= numberOfRows || ignition.column < 0 || ignition.column >= numberOfColumns)
+            {
+                continue;
+            }
+            long pixel = (long)ignition.row * numberOfColumns + ignition.column;
+            if(!isNoDataPixel(inputs, pixel) && ignition.time < arrivalTime[pixel])
+            {
+                arrivalTime[pixel] = ignition.time;
+                queue_.push(ignition.time, pixel);
+            }
+        }
+
+        if(runControl_)
+        {
+            runControl_->beginWork(numberOfPixels);
+        }
+
+        int sweptHour = -1;
+        long pixelsSincePoll = 0;
+        while(!queue_.empty())
+        {
+            FireGrowthQueue::Entry entry = queue_.top();
+            queue_.pop();
+            long pixel = entry.pixel;
+            if(isBurned[pixel] || entry.time > arrivalTime[pixel])
+            {
+                // Reached sooner by another path since this entry was pushed
+                continue;
+            }
+            if(maximumTime_ > 0.0 && entry.time > maximumTime_)
+            {
+                break;
+            }
+
+            // Pixels leave the queue in order of arrival, so the hour never goes back
+            int hour = (int)std::min(std::max(0.0, floor(entry.time / 60.0)), (double)(weather.numberOfHours - 1));
+            if(hour != sweptHour)
+            {
+                sweepSpreadRates(inputs, weather, hour, workers, *threadPool);
+                sweptHour = hour;
+                numberOfSpreadRateSweeps_++;
+            }
+
+            if(runControl_ && numberOfBurnedPixels_ % pixelsPerPoll == 0)
+            {
+                runControl_->addWorkDone(pixelsSincePoll);
+                pixelsSincePoll = 0;
+                if(runControl_->isStopRequested())
+                {
+                    wasStopped_ = true;
+                    break;
+                }
+            }
+            isBurned[pixel] = 1;
+            numberOfBurnedPixels_++;
+            pixelsSincePoll++;
+
+            int row = (int)(pixel / numberOfColumns);
+            int column = (int)(pixel % numberOfColumns);
+            const float* pixelRates = &spreadRates_[pixel * NumberOfNeighbors];
+            for(int neighbor = 0; neighbor < NumberOfNeighbors; neighbor++)
+            {
+                int neighborRow = row + neighborRowOffsets[neighbor];
+                int neighborColumn = column + neighborColumnOffsets[neighbor];
+                if(pixelRates[neighbor] <= 0.0f || neighborRow < 0 || neighborRow >= numberOfRows ||
+                    neighborColumn < 0 || neighborColumn >= numberOfColumns)
+                {
+                    continue;
+                }
+                long neighborPixel = (long)neighborRow * numberOfColumns + neighborColumn;
+                float neighborRate = spreadRates_[neighborPixel * NumberOfNeighbors + neighbor];
+                if(isBurned[neighborPixel] || neighborRate <= 0.0f)
+                {
+                    continue;
+                }
+                double slowness = 1.0 / pixelRates[neighbor] + 1.0 / neighborRate;
+                double time = 0.0;
+                if(crossedRowOffsets[neighbor][0] == neighborRowOffsets[neighbor] &&
+                    crossedColumnOffsets[neighbor][0] == neighborColumnOffsets[neighbor])
+                {
+                    time = entry.time + (stepDistances[neighbor] / 2.0) * slowness;
+                }
+                else
+                {
+                    // A knight's move only spreads through the two pixels it crosses if both burn
+                    long firstCrossed = (long)(row + crossedRowOffsets[neighbor][0]) * numberOfColumns +
+                        column + crossedColumnOffsets[neighbor][0];
+                    long secondCrossed = (long)(row + crossedRowOffsets[neighbor][1]) * numberOfColumns +
+                        column + crossedColumnOffsets[neighbor][1];
+                    float firstCrossedRate = spreadRates_[firstCrossed * NumberOfNeighbors + neighbor];
+                    float secondCrossedRate = spreadRates_[secondCrossed * NumberOfNeighbors + neighbor];
+                    if(firstCrossedRate <= 0.0f || secondCrossedRate <= 0.0f)
+                    {
+                        continue;
+                    }
+                    slowness += 1.0 / firstCrossedRate + 1.0 / secondCrossedRate;
+                    time = entry.time + (stepDistances[neighbor] / 4.0) * slowness;
+                }
+                if(time < arrivalTime[neighborPixel])
+                {
+                    arrivalTime[neighborPixel] = time;
+                    flowDirection[neighborPixel] = neighbor;
+                    queue_.push(time, neighborPixel);
+                }
+            }
+        }
+        if(runControl_ && pixelsSincePoll > 0)
+        {
+            runControl_->addWorkDone(pixelsSincePoll);
+        }
+    }
+
+    for(long pixel = 0; pixel < numberOfPixels; pixel++)
+    {
+        if(outputs.arrivalTime)
+        {
+            outputs.arrivalTime[pixel] = isBurned[pixel] ? arrivalTime[pixel] : outputs.noDataValue;
+        }
+        if(outputs.flowDirection)
+        {
+            outputs.flowDirection[pixel] = isBurned[pixel] ? flowDirection[pixel] : -1;
+        }
+    }
+}
+
+bool FireGrowthRunner::isNoDataPixel(const LandscapeInputBands& inputs, long pixel) const
+{
+    // The wind and moisture bands are not used, the weather replaces them
+    const double noDataValue = inputs.noDataValue;
+    return inputs.fuelModelNumber[pixel] == noDataValue ||
+        isNoDataInBand(inputs.slope, pixel, noDataValue) ||
+        isNoDataInBand(inputs.aspect, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyCover, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyHeight, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyBaseHeight, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyBulkDensity, pixel, noDataValue);
+}
+
+void FireGrowthRunner::sweepSpreadRates(const LandscapeInputBands& inputs, const BehaveTimeSeriesWeather& weather, int hour,
+    std::vector<Worker>& workers, ThreadPool& threadPool)
+{
+    const int numberOfColumns = inputs.numberOfColumns;
+    threadPool.runChunks(inputs.numberOfRows, 4, [&](int slot, long begin, long end)
+    {
+        for(long row = begin; row < end; row++)
+        {
+            for(int column = 0; column < numberOfColumns; column++)
+            {
+                long pixel = row * numberOfColumns + column;
+                calculatePixelSpreadRates(workers[slot], inputs, weather, hour, pixel, &spreadRates_[pixel * NumberOfNeighbors]);
+            }
+        }
+    }, (int)workers.size());
+}
+
+void FireGrowthRunner::calculatePixelSpreadRates(Worker& worker, const LandscapeInputBands& inputs,
+    const BehaveTimeSeriesWeather& weather, int hour, long pixel, float* spreadRates) const
+{
+    int fuelModelNumber = inputs.fuelModelNumber[pixel];
+    if(isNoDataPixel(inputs, pixel) || !worker.surface.isFuelModelDefined(fuelModelNumber) ||
+        worker.surface.isAllFuelLoadZero(fuelModelNumber))
+    {
+        std::fill(spreadRates, spreadRates + NumberOfNeighbors, 0.0f);
+        return;
+    }
+
+    double canopyHeight = inputs.canopyHeight.at(pixel);
+    double canopyBaseHeight = inputs.canopyBaseHeight.at(pixel);
+    double crownRatio = (canopyHeight > 0.0) ? (canopyHeight - canopyBaseHeight) / canopyHeight : 0.0;
+
+    double rates[NumberOfNeighbors];
+    worker.surface.updateSurfaceInputs(fuelModelNumber, weather.moistureOneHour[hour], weather.moistureTenHour[hour],
+        weather.moistureHundredHour[hour], weather.moistureLiveHerbaceous[hour], weather.moistureLiveWoody[hour],
+        FractionUnits::Fraction, weather.windSpeed[hour], SpeedUnits::FeetPerMinute, windHeightInputMode_,
+        weather.windDirection[hour], WindAndSpreadOrientationMode::RelativeToNorth, inputs.slope.at(pixel), SlopeUnits::Degrees,
+        inputs.aspect.at(pixel), inputs.canopyCover.at(pixel), FractionUnits::Fraction, canopyHeight, LengthUnits::Feet,
+        crownRatio, FractionUnits::Fraction);
+    worker.surface.doSurfaceRunInDirectionsOfInterest(neighborDirections_, NumberOfNeighbors,
+        SurfaceFireSpreadDirectionMode::FromIgnitionPoint, rates, nullptr, nullptr);
+
+    double crownScale = 1.0;
+    if(fireMethod_ != FireGrowthFireMethod::Surface)
+    {
+        worker.crown.updateCrownInputs(fuelModelNumber, weather.moistureOneHour[hour], weather.moistureTenHour[hour],
+            weather.moistureHundredHour[hour], weather.moistureLiveHerbaceous[hour], weather.moistureLiveWoody[hour],
+            weather.moistureFoliar[hour], FractionUnits::Fraction, weather.windSpeed[hour], SpeedUnits::FeetPerMinute,
+            windHeightInputMode_, weather.windDirection[hour], WindAndSpreadOrientationMode::RelativeToNorth,
+            inputs.slope.at(pixel), SlopeUnits::Degrees, inputs.aspect.at(pixel), inputs.canopyCover.at(pixel),
+            FractionUnits::Fraction, canopyHeight, canopyBaseHeight, LengthUnits::Feet, crownRatio, FractionUnits::Fraction,
+            inputs.canopyBulkDensity.at(pixel), DensityUnits::PoundsPerCubicFoot);
+        if(fireMethod_ == FireGrowthFireMethod::Rothermel)
+        {
+            worker.crown.doCrownRunRothermel();
+        }
+        else
+        {
+            worker.crown.doCrownRunScottAndReinhardt();
+        }
+
+        // A crowning pixel keeps the surface fire's shape, stretched to the crown spread rate
+        double surfaceSpreadRate = worker.crown.getSurfaceFireSpreadRate(SpeedUnits::FeetPerMinute);
+        if(worker.crown.getFireType() != FireType::Surface && surfaceSpreadRate > 0.0)
+        {
+            crownScale = worker.crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute) / surfaceSpreadRate;
+        }
+    }
+
+    for(int neighbor = 0; neighbor < NumberOfNeighbors; neighbor++)
+    {
+        spreadRates[neighbor] = (float)(rates[neighbor] * crownScale);
+    }
+}
@@ -0,0 +1,174 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Minimum travel time fire growth over a landscape raster
+*           driven by hourly weather
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef FIREGROWTHRUNNER_H
+#define FIREGROWTHRUNNER_H
+
+#include <vector>
+#include "landscapeRunner.h"
+#include "surface.h"
+
+class BehaveRun;
+class RunControl;
+class ThreadPool;
+struct BehaveTimeSeriesWeather;
+
+struct FireGrowthFireMethod
+{
+    enum FireGrowthFireMethodEnum
+    {
+        Surface,            // surface spread only
+        Rothermel,          // surface ellipse scaled to the Rothermel crown spread rate where the fire crowns
+        ScottAndReinhardt   // surface ellipse scaled to the Scott and Reinhardt spread rate where the fire crowns
+    };
+};
+
+// An ignited pixel and the time it ignites in minutes from the start of the weather
+struct FireGrowthIgnition
+{
+    int row;
+    int column;
+    double time;
+};
+
+// Caller-provided output bands, each sized for numberOfRows * numberOfColumns values. Arrival
+// time is in minutes from the start of the weather. flowDirection is the neighbor index, see
+// getNeighborOffset(), of the step the fire took to reach the pixel, so following the opposite
+// of each step from any burned pixel leads back to its ignition. Pixels the fire did not reach
+// get noDataValue and a flowDirection of -1, as do the ignitions' flowDirection. Either band
+// may be null if that output is not needed.
+struct FireGrowthOutputBands
+{
+    double noDataValue;
+
+    double* arrivalTime;
+    int* flowDirection;
+};
+
+// Minimum heap of (time, pixel) entries kept in one contiguous array with four children per
+// node, which halves the depth of a binary heap and keeps each node's children on one cache
+// line. Entries are never decreased in place, a pixel reached sooner is pushed again and the
+// older entry skipped when it is popped.
+class FireGrowthQueue
+{
+public:
+    struct Entry
+    {
+        double time;
+        long pixel;
+    };
+
+    void clear();
+    void reserve(size_t capacity);
+    bool empty() const;
+    size_t size() const;
+    const Entry& top() const;
+    void push(double time, long pixel);
+    void pop();
+
+protected:
+    std::vector<Entry> entries_;
+};
+
+// Grows a fire over a landscape from its ignitions by minimum travel time: the fire reaches
+// each pixel along the fastest path of steps between pixels, the steps taking the eight
+// neighbors and the eight knight's moves so paths are not held to multiples of 45 degrees.
+// The spread rates of every pixel in each of the sixteen step directions are taken from the
+// elliptical fire shape with Surface's multi-direction sweep, swept over a ThreadPool once
+// for each hour of weather the fire lives through. A step from pixel a to pixel b in
+// direction d takes (distance / 2) * (1 / R_a(d) + 1 / R_b(d)) at the rates of the hour it
+// leaves a. A knight's move also averages in the two pixels it crosses and only spreads if
+// both burn, so a fire does not jump a road one pixel wide. The hourly weather is landscape-wide and replaces the inputs' wind and moisture
+// bands; hour h applies from h * 60 minutes and the last hour holds to the end of the run.
+// Wind and spread directions are degrees clockwise from north, with north up the raster.
+class FireGrowthRunner
+{
+public:
+    static const int NumberOfNeighbors = 16;
+    // Farthest a step reaches in rows or columns, the halo a tile of a fire growth run needs
+    static const int NeighborReach = 2;
+
+    explicit FireGrowthRunner(const BehaveRun& prototype);
+
+    void setFireMethod(FireGrowthFireMethod::FireGrowthFireMethodEnum fireMethod);
+    void setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode);
+    // Width and height of a pixel
+    void setCellSize(double cellSize, LengthUnits::LengthUnitsEnum lengthUnits);
+    // No pixel is reached after this many minutes, zero or less for no limit
+    void setMaximumTime(double maximumTime);
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+    // Token polled while the fire grows and counting burned pixels as work, null for none.
+    // Once it stops a run the pixels not yet reached are left unburned in the outputs
+    void setRunControl(RunControl* runControl);
+
+    void run(const LandscapeInputBands& inputs, const BehaveTimeSeriesWeather& weather,
+        const std::vector<FireGrowthIgnition>& ignitions, FireGrowthOutputBands& outputs);
+
+    long getNumberOfBurnedPixels() const;
+    // Hours of weather whose spread rates were swept on the last run()
+    int getNumberOfSpreadRateSweeps() const;
+    bool wasStopped() const;
+
+    // Row and column offsets of a neighbor index, in clockwise order from north
+    static void getNeighborOffset(int neighbor, int& rowOffset, int& columnOffset);
+    // Direction of a neighbor index in degrees clockwise from north
+    static double getNeighborDirection(int neighbor);
+
+protected:
+    struct Worker
+    {
+        Surface surface;
+        Crown crown;
+    };
+
+    bool isNoDataPixel(const LandscapeInputBands& inputs, long pixel) const;
+    void sweepSpreadRates(const LandscapeInputBands& inputs, const BehaveTimeSeriesWeather& weather, int hour,
+        std::vector<Worker>& workers, ThreadPool& threadPool);
+    void calculatePixelSpreadRates(Worker& worker, const LandscapeInputBands& inputs, const BehaveTimeSeriesWeather& weather,
+        int hour, long pixel, float* spreadRates) const;
+
+    Surface surfacePrototype_;
+    Crown crownPrototype_;
+    FireGrowthFireMethod::FireGrowthFireMethodEnum fireMethod_;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode_;
+    double cellSize_; // ft
+    double maximumTime_; // min
+    double neighborDirections_[NumberOfNeighbors]; // degrees clockwise from north
+    int numberOfThreads_;
+    RunControl* runControl_;
+
+    std::vector<float> spreadRates_; // ft/min, NumberOfNeighbors per pixel
+    FireGrowthQueue queue_;
+
+    long numberOfBurnedPixels_;
+    int numberOfSpreadRateSweeps_;
+    bool wasStopped_;
+};
+
+#endif // FIREGROWTHRUNNER_H
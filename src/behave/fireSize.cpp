@@ -217,3 +217,68 @@ double FireSize::getFireArea(bool isCrown, AreaUnits::AreaUnitsEnum areaUnits, d
     }
     return area;
 }
+
+// The fire size getters for many elapsed times at once. Lengths grow linearly with elapsed time and area with
+// its square, so the per minute dimensions and the unit factors are worked out once and each elapsed time only
+// scales them. The perimeter formula of Ramanujan used for surface fires only depends on the ratio of the axes.
+void FireSize::getFireSizeAtElapsedTimes(bool isCrown, const double* elapsedTimes, int numberOfElapsedTimes, TimeUnits::TimeUnitsEnum timeUnits,
+    LengthUnits::LengthUnitsEnum lengthUnits, AreaUnits::AreaUnitsEnum areaUnits, FireSizeBatchOutputs& outputs) const
+{
+    const double timeFactor = TimeUnits::toBaseFactor(timeUnits);
+    const double lengthFactor = LengthUnits::fromBaseFactor(lengthUnits);
+    const double areaFactor = AreaUnits::fromBaseFactor(areaUnits);
+
+    double perimeterPerMinute = 0.0;
+    double areaPerSquareMinute = 0.0;
+    if (isCrown)
+    {
+        perimeterPerMinute = 0.5 * M_PI * forwardSpreadRate_ * (1.0 + 1.0 / fireLengthToWidthRatio_);
+        areaPerSquareMinute = M_PI * forwardSpreadRate_ * forwardSpreadRate_ / (4.0 * fireLengthToWidthRatio_);
+    }
+    else
+    {
+        if ((ellipticalA_ + ellipticalB_) > 0.0)
+        {
+            double aMinusB = (ellipticalA_ - ellipticalB_);
+            double aPlusB = (ellipticalA_ + ellipticalB_);
+            double h = (aMinusB * aMinusB) / (aPlusB * aPlusB);
+            perimeterPerMinute = M_PI * aPlusB * (1 + (h / 4.0) + ((h * h) / 64.0));
+        }
+        areaPerSquareMinute = M_PI * ellipticalA_ * ellipticalB_;
+    }
+
+    for (int i = 0; i < numberOfElapsedTimes; i++)
+    {
+        const double elapsedTime = elapsedTimes[i] * timeFactor;
+        if (outputs.ellipticalA)
+        {
+            outputs.ellipticalA[i] = ellipticalA_ * elapsedTime * lengthFactor;
+        }
+        if (outputs.ellipticalB)
+        {
+            outputs.ellipticalB[i] = ellipticalB_ * elapsedTime * lengthFactor;
+        }
+        if (outputs.ellipticalC)
+        {
+            outputs.ellipticalC[i] = ellipticalC_ * elapsedTime * lengthFactor;
+        }
+        if (outputs.fireLength)
+        {
+            outputs.fireLength[i] = ellipticalB_ * elapsedTime * 2.0 * lengthFactor;
+        }
+        if (outputs.maxFireWidth)
+        {
+            outputs.maxFireWidth[i] = ellipticalA_ * elapsedTime * 2.0 * lengthFactor;
+        }
+        if (outputs.firePerimeter)
+        {
+            // As in getFirePerimeter(), a surface fire too small to measure has no perimeter
+            bool isPerimeterZero = !isCrown && ((ellipticalA_ + ellipticalB_) * elapsedTime <= 1.0e-07);
+            outputs.firePerimeter[i] = isPerimeterZero ? 0.0 : perimeterPerMinute * elapsedTime * lengthFactor;
+        }
+        if (outputs.fireArea)
+        {
+            outputs.fireArea[i] = areaPerSquareMinute * elapsedTime * elapsedTime * areaFactor;
+        }
+    }
+}
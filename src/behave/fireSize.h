@@ -30,6 +30,19 @@
 
 #include "behaveUnits.h"
 
+// Caller-provided output arrays for FireSize::getFireSizeAtElapsedTimes(), each sized for numberOfElapsedTimes
+// values and filled in the requested length and area units. Any array may be null if that output is not needed.
+struct FireSizeBatchOutputs
+{
+    double* ellipticalA;
+    double* ellipticalB;
+    double* ellipticalC;
+    double* fireLength;
+    double* maxFireWidth;
+    double* firePerimeter;
+    double* fireArea;
+};
+
 class FireSize
 {
 public:
@@ -49,6 +62,8 @@ public:
     double getMaxFireWidth(LengthUnits::LengthUnitsEnum lengthUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const;
     double getFirePerimeter(bool isCrown, LengthUnits::LengthUnitsEnum lengthUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const;
     double getFireArea(bool isCrown, AreaUnits::AreaUnitsEnum areaUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const;
+    void getFireSizeAtElapsedTimes(bool isCrown, const double* elapsedTimes, int numberOfElapsedTimes, TimeUnits::TimeUnitsEnum timeUnits,
+        LengthUnits::LengthUnitsEnum lengthUnits, AreaUnits::AreaUnitsEnum areaUnits, FireSizeBatchOutputs& outputs) const;
    
 protected:
     void calculateSurfaceFireLengthToWidthRatio();
@@ -0,0 +1,375 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Growable library of custom fuel models numbered past the FuelModels
+*           table, with bulk loading from a binary file
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "fuelLibrary.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "threadPool.h"
+
+namespace
+{
+    const char fileMagic[8] = { 'B', 'E', 'H', 'A', 'V', 'E', 'F', 'L' };
+    const std::uint64_t fileVersion = 1;
+
+    // One model of a library file, values in base units, code and name zero terminated
+    struct FileRecord
+    {
+        std::int32_t fuelModelNumber;
+        std::int32_t isDynamic;
+        char code[FuelLibrary::MaxCodeLength + 1];
+        char name[FuelLibrary::MaxNameLength + 1];
+        double fuelbedDepth;
+        double moistureOfExtinctionDead;
+        double heatOfCombustionDead;
+        double heatOfCombustionLive;
+        double fuelLoadOneHour;
+        double fuelLoadTenHour;
+        double fuelLoadHundredHour;
+        double fuelLoadLiveHerbaceous;
+        double fuelLoadLiveWoody;
+        double savrOneHour;
+        double savrLiveHerbaceous;
+        double savrLiveWoody;
+    };
+    static_assert(sizeof(FileRecord) == 184, "library files have fixed width records");
+
+    std::string toUpperCase(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), ::toupper);
+        return text;
+    }
+
+    void copyText(const std::string& text, char* destination, size_t size)
+    {
+        std::memset(destination, 0, size);
+        std::memcpy(destination, text.data(), std::min(text.size(), size - 1));
+    }
+
+    bool writeBytes(FILE* file, const void* bytes, size_t size)
+    {
+        return fwrite(bytes, 1, size, file) == size;
+    }
+
+    bool readBytes(FILE* file, void* bytes, size_t size)
+    {
+        return fread(bytes, 1, size, file) == size;
+    }
+}
+
+FuelLibrary::FuelLibrary()
+    : capacity_(0)
+{
+
+}
+
+FuelLibrary::~FuelLibrary()
+{
+
+}
+
+bool FuelLibrary::addFuelModel(int fuelModelNumber, std::string code, std::string name,
+    double fuelBedDepth, LengthUnits::LengthUnitsEnum lengthUnits, double moistureOfExtinctionDead,
+    FractionUnits::FractionUnitsEnum moistureUnits, double heatOfCombustionDead, double heatOfCombustionLive,
+    HeatOfCombustionUnits::HeatOfCombustionUnitsEnum heatOfCombustionUnits,
+    double fuelLoadOneHour, double fuelLoadTenHour, double fuelLoadHundredHour, double fuelLoadLiveHerbaceous,
+    double fuelLoadLiveWoody, LoadingUnits::LoadingUnitsEnum loadingUnits, double savrOneHour, double savrLiveHerbaceous,
+    double savrLiveWoody, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits, bool isDynamic)
+{
+    if (fuelModelNumber < FirstFuelModelNumber)
+    {
+        return false;
+    }
+
+    FuelModels::FuelbedParameters parameters = FuelModels::FuelbedParameters();
+    parameters.fuelbedDepth_ = LengthUnits::toBaseUnits(fuelBedDepth, lengthUnits);
+    parameters.moistureOfExtinctionDead_ = FractionUnits::toBaseUnits(moistureOfExtinctionDead, moistureUnits);
+    parameters.heatOfCombustionDead_ = HeatOfCombustionUnits::toBaseUnits(heatOfCombustionDead, heatOfCombustionUnits);
+    parameters.heatOfCombustionLive_ = HeatOfCombustionUnits::toBaseUnits(heatOfCombustionLive, heatOfCombustionUnits);
+    parameters.fuelLoadOneHour_ = LoadingUnits::toBaseUnits(fuelLoadOneHour, loadingUnits);
+    parameters.fuelLoadTenHour_ = LoadingUnits::toBaseUnits(fuelLoadTenHour, loadingUnits);
+    parameters.fuelLoadHundredHour_ = LoadingUnits::toBaseUnits(fuelLoadHundredHour, loadingUnits);
+    parameters.fuelLoadLiveHerbaceous_ = LoadingUnits::toBaseUnits(fuelLoadLiveHerbaceous, loadingUnits);
+    parameters.fuelLoadLiveWoody_ = LoadingUnits::toBaseUnits(fuelLoadLiveWoody, loadingUnits);
+    parameters.savrOneHour_ = SurfaceAreaToVolumeUnits::toBaseUnits(savrOneHour, savrUnits);
+    parameters.savrLiveHerbaceous_ = SurfaceAreaToVolumeUnits::toBaseUnits(savrLiveHerbaceous, savrUnits);
+    parameters.savrLiveWoody_ = SurfaceAreaToVolumeUnits::toBaseUnits(savrLiveWoody, savrUnits);
+    parameters.isDynamic_ = isDynamic;
+
+    reserve((int)fuelModelNumbers_.size() + 1);
+    calculateDerivedConstants(setFuelModel(fuelModelNumber, code, name, parameters));
+    return true;
+}
+
+bool FuelLibrary::load(const std::string& fileName, int numberOfThreads)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    // Header: magic, format version, number of models. The records follow in one block, which
+    // must be exactly the rest of the file
+    char magic[sizeof(fileMagic)];
+    std::uint64_t version = 0;
+    std::uint64_t numberOfRecords = 0;
+    bool isRead = readBytes(file, magic, sizeof(magic)) && std::memcmp(magic, fileMagic, sizeof(magic)) == 0 &&
+        readBytes(file, &version, sizeof(version)) && version == fileVersion &&
+        readBytes(file, &numberOfRecords, sizeof(numberOfRecords));
+    if (isRead)
+    {
+        long recordsStart = ftell(file);
+        isRead = recordsStart >= 0 && fseek(file, 0, SEEK_END) == 0;
+        long fileEnd = isRead ? ftell(file) : -1;
+        isRead = isRead && fileEnd >= recordsStart && fseek(file, recordsStart, SEEK_SET) == 0 &&
+            numberOfRecords == (std::uint64_t)(fileEnd - recordsStart) / sizeof(FileRecord) &&
+            (std::uint64_t)(fileEnd - recordsStart) % sizeof(FileRecord) == 0 &&
+            numberOfRecords <= (std::uint64_t)std::numeric_limits<int>::max() - fuelModelNumbers_.size();
+    }
+    std::vector<FileRecord> records;
+    if (isRead)
+    {
+        records.resize((size_t)numberOfRecords);
+        isRead = readBytes(file, records.data(), records.size() * sizeof(FileRecord));
+    }
+    fclose(file);
+    for (size_t i = 0; i < records.size() && isRead; i++)
+    {
+        isRead = records[i].fuelModelNumber >= FirstFuelModelNumber;
+    }
+    if (!isRead)
+    {
+        return false;
+    }
+
+    // Records are set in file order so a model listed twice keeps its last values, then the constants
+    // of each slot written are derived once, the slots shared out across the pool
+    reserve((int)(fuelModelNumbers_.size() + records.size()));
+    std::vector<char> isSlotLoaded(capacity_, 0);
+    std::vector<int> loadedSlots;
+    loadedSlots.reserve(records.size());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        FileRecord& record = records[i];
+        record.code[MaxCodeLength] = '\0';
+        record.name[MaxNameLength] = '\0';
+        FuelModels::FuelbedParameters parameters = FuelModels::FuelbedParameters();
+        parameters.fuelbedDepth_ = record.fuelbedDepth;
+        parameters.moistureOfExtinctionDead_ = record.moistureOfExtinctionDead;
+        parameters.heatOfCombustionDead_ = record.heatOfCombustionDead;
+        parameters.heatOfCombustionLive_ = record.heatOfCombustionLive;
+        parameters.fuelLoadOneHour_ = record.fuelLoadOneHour;
+        parameters.fuelLoadTenHour_ = record.fuelLoadTenHour;
+        parameters.fuelLoadHundredHour_ = record.fuelLoadHundredHour;
+        parameters.fuelLoadLiveHerbaceous_ = record.fuelLoadLiveHerbaceous;
+        parameters.fuelLoadLiveWoody_ = record.fuelLoadLiveWoody;
+        parameters.savrOneHour_ = record.savrOneHour;
+        parameters.savrLiveHerbaceous_ = record.savrLiveHerbaceous;
+        parameters.savrLiveWoody_ = record.savrLiveWoody;
+        parameters.isDynamic_ = (record.isDynamic != 0);
+        int slot = setFuelModel(record.fuelModelNumber, record.code, record.name, parameters);
+        if (!isSlotLoaded[slot])
+        {
+            isSlotLoaded[slot] = 1;
+            loadedSlots.push_back(slot);
+        }
+    }
+
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots(numberOfThreads);
+    const long chunkSize = 16;
+    threadPool->runChunks((long)loadedSlots.size(), chunkSize, [this, &loadedSlots](int, long begin, long end)
+    {
+        for (long i = begin; i < end; i++)
+        {
+            calculateDerivedConstants(loadedSlots[i]);
+        }
+    }, numberOfSlots);
+    return true;
+}
+
+bool FuelLibrary::save(const std::string& fileName) const
+{
+    std::vector<FileRecord> records(fuelModelNumbers_.size());
+    for (size_t slot = 0; slot < records.size(); slot++)
+    {
+        const FuelModels::FuelbedParameters& parameters = fuelbedParameters_.get()[slot];
+        FileRecord& record = records[slot];
+        std::memset(&record, 0, sizeof(record));
+        record.fuelModelNumber = fuelModelNumbers_[slot];
+        record.isDynamic = parameters.isDynamic_ ? 1 : 0;
+        copyText(codes_[slot], record.code, sizeof(record.code));
+        copyText(names_[slot], record.name, sizeof(record.name));
+        record.fuelbedDepth = parameters.fuelbedDepth_;
+        record.moistureOfExtinctionDead = parameters.moistureOfExtinctionDead_;
+        record.heatOfCombustionDead = parameters.heatOfCombustionDead_;
+        record.heatOfCombustionLive = parameters.heatOfCombustionLive_;
+        record.fuelLoadOneHour = parameters.fuelLoadOneHour_;
+        record.fuelLoadTenHour = parameters.fuelLoadTenHour_;
+        record.fuelLoadHundredHour = parameters.fuelLoadHundredHour_;
+        record.fuelLoadLiveHerbaceous = parameters.fuelLoadLiveHerbaceous_;
+        record.fuelLoadLiveWoody = parameters.fuelLoadLiveWoody_;
+        record.savrOneHour = parameters.savrOneHour_;
+        record.savrLiveHerbaceous = parameters.savrLiveHerbaceous_;
+        record.savrLiveWoody = parameters.savrLiveWoody_;
+    }
+
+    FILE* file = fopen(fileName.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+    std::uint64_t version = fileVersion;
+    std::uint64_t numberOfRecords = records.size();
+    bool isWritten = writeBytes(file, fileMagic, sizeof(fileMagic)) && writeBytes(file, &version, sizeof(version)) &&
+        writeBytes(file, &numberOfRecords, sizeof(numberOfRecords)) &&
+        writeBytes(file, records.data(), records.size() * sizeof(FileRecord));
+    return (fclose(file) == 0) && isWritten;
+}
+
+int FuelLibrary::getNumberOfFuelModels() const
+{
+    return (int)fuelModelNumbers_.size();
+}
+
+int FuelLibrary::getFuelModelNumber(int slot) const
+{
+    return (slot < 0 || slot >= (int)fuelModelNumbers_.size()) ? -1 : fuelModelNumbers_[slot];
+}
+
+int FuelLibrary::getSlot(int fuelModelNumber) const
+{
+    auto found = slots_.find(fuelModelNumber);
+    return (found == slots_.end()) ? -1 : found->second;
+}
+
+bool FuelLibrary::isFuelModelDefined(int fuelModelNumber) const
+{
+    return getSlot(fuelModelNumber) >= 0;
+}
+
+std::string FuelLibrary::getFuelCode(int fuelModelNumber) const
+{
+    int slot = getSlot(fuelModelNumber);
+    return (slot < 0) ? "NO_CODE" : codes_[slot];
+}
+
+std::string FuelLibrary::getFuelName(int fuelModelNumber) const
+{
+    int slot = getSlot(fuelModelNumber);
+    return (slot < 0) ? "NO_NAME" : names_[slot];
+}
+
+int FuelLibrary::getFuelModelNumberFromFuelCode(std::string fuelCode) const
+{
+    auto found = fuelCodeIndex_.find(toUpperCase(fuelCode));
+    return (found == fuelCodeIndex_.end() || found->second.empty()) ? -1 : found->second.front();
+}
+
+const FuelModels::FuelbedParameters* FuelLibrary::findFuelbedParameters(int fuelModelNumber) const
+{
+    int slot = getSlot(fuelModelNumber);
+    return (slot < 0) ? nullptr : &fuelbedParameters_.get()[slot];
+}
+
+const FuelModels::StaticFuelbedConstants* FuelLibrary::getFuelbedConstants(int fuelModelNumber, double moistureLiveHerbaceous) const
+{
+    int slot = getSlot(fuelModelNumber);
+    if (slot < 0)
+    {
+        return nullptr;
+    }
+    const std::vector<FuelModels::StaticFuelbedConstants>& curingTable = curingFuelbedConstants_[slot];
+    if (curingTable.empty())
+    {
+        const FuelModels::FuelbedParameters& parameters = fuelbedParameters_.get()[slot];
+        return parameters.hasStaticFuelbedConstants_ ? &parameters.staticFuelbedConstants_ : nullptr;
+    }
+    int curingLevel = FuelModels::getCuringLevel(moistureLiveHerbaceous);
+    return (curingLevel < 0) ? nullptr : &curingTable[curingLevel];
+}
+
+void FuelLibrary::reserve(int numberOfFuelModels)
+{
+    // The parameter table grows by doubling, moving to a new aligned table
+    if (numberOfFuelModels <= capacity_)
+    {
+        return;
+    }
+    int capacity = std::max(numberOfFuelModels, 2 * capacity_);
+    fuelbedParameters_ = FuelModels::createFuelbedParameterTable(fuelbedParameters_.get(), (int)fuelModelNumbers_.size(), capacity);
+    capacity_ = capacity;
+    fuelModelNumbers_.reserve(capacity);
+    codes_.reserve(capacity);
+    names_.reserve(capacity);
+    curingFuelbedConstants_.reserve(capacity);
+}
+
+int FuelLibrary::setFuelModel(int fuelModelNumber, const std::string& code, const std::string& name,
+    const FuelModels::FuelbedParameters& parameters)
+{
+    // Sets the values of a model, appending a slot for a new number, and leaves its constants to
+    // calculateDerivedConstants(). Room for the slot must have been reserved
+    int slot = getSlot(fuelModelNumber);
+    if (slot < 0)
+    {
+        slot = (int)fuelModelNumbers_.size();
+        slots_[fuelModelNumber] = slot;
+        fuelModelNumbers_.push_back(fuelModelNumber);
+        codes_.emplace_back();
+        names_.emplace_back();
+        curingFuelbedConstants_.emplace_back();
+    }
+    else
+    {
+        std::vector<int>& oldCodeFuelModelNumbers = fuelCodeIndex_[toUpperCase(codes_[slot])];
+        oldCodeFuelModelNumbers.erase(std::remove(oldCodeFuelModelNumbers.begin(), oldCodeFuelModelNumbers.end(), fuelModelNumber),
+            oldCodeFuelModelNumbers.end());
+    }
+    codes_[slot] = code.substr(0, MaxCodeLength);
+    names_[slot] = name.substr(0, MaxNameLength);
+    fuelbedParameters_.get()[slot] = parameters;
+    std::vector<int>& codeFuelModelNumbers = fuelCodeIndex_[toUpperCase(codes_[slot])];
+    codeFuelModelNumbers.insert(std::lower_bound(codeFuelModelNumbers.begin(), codeFuelModelNumbers.end(), fuelModelNumber),
+        fuelModelNumber);
+    return slot;
+}
+
+void FuelLibrary::calculateDerivedConstants(int slot)
+{
+    // Touches only this slot's entries, so loads derive slots in parallel
+    FuelModels::FuelbedParameters& parameters = fuelbedParameters_.get()[slot];
+    FuelModels::calculateStaticFuelbedConstants(parameters);
+    FuelModels::calculateCuringFuelbedConstants(parameters, curingFuelbedConstants_[slot]);
+    FuelModels::calculateSizeClassBins(parameters);
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Growable library of custom fuel models numbered past the FuelModels
+*           table, with bulk loading from a binary file
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef FUELLIBRARY_H
+#define FUELLIBRARY_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fuelModels.h"
+
+// A growable set of custom fuel models for workflows that evaluate far more candidate models than
+// the custom records of FuelModels hold. Models are numbered from FirstFuelModelNumber up, the
+// numbers need not be contiguous and are hashed to dense slots. A FuelModels given the library with
+// FuelModels::setFuelLibrary() looks those numbers up in it, so surface runs and the batch APIs,
+// which take fuel model numbers, use the library's models without each being set as a custom model.
+// A model's static constants, curing table and size class bins are derived as it is added, those
+// of a loaded file in parallel on the shared thread pool.
+//
+// A library file is a header, the magic, format version and number of models, followed by one
+// fixed width record per model in base units, so the models can be read in one block or mapped
+class FuelLibrary
+{
+public:
+    static const int FirstFuelModelNumber = FuelConstants::MaxFuelModels;
+    static const int MaxCodeLength = 15;    // longer codes are cut
+    static const int MaxNameLength = 63;    // longer names are cut
+
+    FuelLibrary();
+    ~FuelLibrary();
+
+    FuelLibrary(const FuelLibrary& rhs) = delete;
+    FuelLibrary& operator=(const FuelLibrary& rhs) = delete;
+
+    // Adds a model or replaces the one with its number, false if the number is below FirstFuelModelNumber
+    bool addFuelModel(int fuelModelNumber, std::string code, std::string name,
+        double fuelBedDepth, LengthUnits::LengthUnitsEnum lengthUnits, double moistureOfExtinctionDead,
+        FractionUnits::FractionUnitsEnum moistureUnits, double heatOfCombustionDead, double heatOfCombustionLive,
+        HeatOfCombustionUnits::HeatOfCombustionUnitsEnum heatOfCombustionUnits,
+        double fuelLoadOneHour, double fuelLoadTenHour, double fuelLoadHundredHour, double fuelLoadLiveHerbaceous,
+        double fuelLoadLiveWoody, LoadingUnits::LoadingUnitsEnum loadingUnits, double savrOneHour, double savrLiveHerbaceous,
+        double savrLiveWoody, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits, bool isDynamic);
+    // Adds or replaces every model in the file, false with the library unchanged if it cannot be read
+    // or holds a number below FirstFuelModelNumber. Zero or fewer threads uses every thread of the pool
+    bool load(const std::string& fileName, int numberOfThreads = 0);
+    bool save(const std::string& fileName) const;
+
+    int getNumberOfFuelModels() const;
+    // Fuel model number in a slot, slots numbered from 0 in the order their models were first added
+    int getFuelModelNumber(int slot) const;
+    int getSlot(int fuelModelNumber) const; // -1 if the library has no such model
+    bool isFuelModelDefined(int fuelModelNumber) const;
+    std::string getFuelCode(int fuelModelNumber) const;
+    std::string getFuelName(int fuelModelNumber) const;
+    // Lowest fuel model number whose code matches, ignoring case, -1 if there is none
+    int getFuelModelNumberFromFuelCode(std::string fuelCode) const;
+    // Numeric values of a model in base units, null if the library has no such model
+    const FuelModels::FuelbedParameters* findFuelbedParameters(int fuelModelNumber) const;
+    // As FuelModels::getFuelbedConstants()
+    const FuelModels::StaticFuelbedConstants* getFuelbedConstants(int fuelModelNumber, double moistureLiveHerbaceous) const;
+
+protected:
+    void reserve(int numberOfFuelModels);
+    int setFuelModel(int fuelModelNumber, const std::string& code, const std::string& name,
+        const FuelModels::FuelbedParameters& parameters);
+    void calculateDerivedConstants(int slot);
+
+    std::unordered_map<int, int> slots_;            // slot of each fuel model number
+    std::vector<int> fuelModelNumbers_;             // fuel model number of each slot
+    std::vector<std::string> codes_;
+    std::vector<std::string> names_;
+    std::shared_ptr<FuelModels::FuelbedParameters> fuelbedParameters_; // capacity_ entries, cache line aligned
+    int capacity_;
+    // Curing table of each slot, empty unless the model is dynamic, as in FuelModels
+    std::vector<std::vector<FuelModels::StaticFuelbedConstants>> curingFuelbedConstants_;
+    // Fuel model numbers of each upper case code, in ascending order
+    std::unordered_map<std::string, std::vector<int>> fuelCodeIndex_;
+};
+
+#endif // FUELLIBRARY_H
@@ -31,11 +31,39 @@
 
 #include "fuelModels.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <new>
+#include <type_traits>
+#include "fuelLibrary.h"
 #include "surfaceInputs.h"
 
+// Source of fuel model revisions, shared by every FuelModels so a revision identifies one set of records
+static std::atomic<unsigned long> nextFuelModelsRevision(1);
+
+constexpr double FuelModels::FullyCuredMoisture;
+constexpr double FuelModels::UncuredMoisture;
+constexpr double FuelModels::CuringMoistureStep;
+
+// Returned for fuel model numbers outside the table
+static const FuelModels::FuelbedParameters emptyFuelbedParameters = FuelModels::FuelbedParameters();
+
 FuelModels::FuelModels()
 {
-    FuelModelVector_.resize(FuelConstants::MaxFuelModels);
+    // The standard records are built once per process and shared, read only, by every FuelModels
+    // until it sets or clears a custom model
+    static const FuelModels standardFuelModels = FuelModels(PopulateStandardFuelModels());
+    memberwiseCopyAssignment(standardFuelModels);
+}
+
+FuelModels::FuelModels(PopulateStandardFuelModels)
+{
+    fuelModelRecords_ = std::make_shared<std::vector<FuelModelRecord>>(FuelConstants::MaxFuelModels);
+    fuelbedParameters_ = createFuelbedParameterTable(nullptr);
+    curingFuelbedConstants_ = std::make_shared<std::vector<std::vector<StaticFuelbedConstants>>>(FuelConstants::MaxFuelModels);
+    fuelCodeIndex_ = std::make_shared<std::unordered_map<std::string, std::vector<int>>>();
     initializeAllFuelModelRecords();
     populateFuelModels();
 }
@@ -56,27 +84,61 @@ FuelModels& FuelModels::operator=(const FuelModels& rhs)
 
 void FuelModels::memberwiseCopyAssignment(const FuelModels& rhs)
 {
-    FuelModelVector_.resize(rhs.FuelModelVector_.size());
-    for (unsigned int i = 0; i < rhs.FuelModelVector_.size(); i++)
-    {
-        FuelModelVector_[i].fuelModelNumber_ = rhs.FuelModelVector_[i].fuelModelNumber_;
-        FuelModelVector_[i].code_ = rhs.FuelModelVector_[i].code_;
-        FuelModelVector_[i].name_ = rhs.FuelModelVector_[i].name_;
-        FuelModelVector_[i].fuelbedDepth_ = rhs.FuelModelVector_[i].fuelbedDepth_;
-        FuelModelVector_[i].moistureOfExtinctionDead_ = rhs.FuelModelVector_[i].moistureOfExtinctionDead_;
-        FuelModelVector_[i].heatOfCombustionDead_ = rhs.FuelModelVector_[i].heatOfCombustionDead_;
-        FuelModelVector_[i].heatOfCombustionLive_ = rhs.FuelModelVector_[i].heatOfCombustionLive_;
-        FuelModelVector_[i].fuelLoadOneHour_ = rhs.FuelModelVector_[i].fuelLoadOneHour_;
-        FuelModelVector_[i].fuelLoadTenHour_ = rhs.FuelModelVector_[i].fuelLoadTenHour_;
-        FuelModelVector_[i].fuelLoadHundredHour_ = rhs.FuelModelVector_[i].fuelLoadHundredHour_;
-        FuelModelVector_[i].fuelLoadLiveHerbaceous_ = rhs.FuelModelVector_[i].fuelLoadLiveHerbaceous_;
-        FuelModelVector_[i].fuelLoadLiveWoody_ = rhs.FuelModelVector_[i].fuelLoadLiveWoody_;
-        FuelModelVector_[i].savrOneHour_ = rhs.FuelModelVector_[i].savrOneHour_;
-        FuelModelVector_[i].savrLiveHerbaceous_ = rhs.FuelModelVector_[i].savrLiveHerbaceous_;
-        FuelModelVector_[i].savrLiveWoody_ = rhs.FuelModelVector_[i].savrLiveWoody_;
-        FuelModelVector_[i].isReserved_ = rhs.FuelModelVector_[i].isReserved_;
-        FuelModelVector_[i].isDefined_ = rhs.FuelModelVector_[i].isDefined_;
+    // Records are immutable while shared, so a copy only takes another reference
+    fuelModelRecords_ = rhs.fuelModelRecords_;
+    fuelbedParameters_ = rhs.fuelbedParameters_;
+    curingFuelbedConstants_ = rhs.curingFuelbedConstants_;
+    fuelCodeIndex_ = rhs.fuelCodeIndex_;
+    fuelLibrary_ = rhs.fuelLibrary_;
+    revision_ = rhs.revision_;
+}
+
+std::vector<FuelModels::FuelModelRecord>& FuelModels::getMutableFuelModelRecords()
+{
+    // Detach from the shared records before the first change. Another FuelModels can only start
+    // sharing these records by copying this one, so a use count of one means they are not shared
+    if (fuelModelRecords_.use_count() != 1)
+    {
+        fuelModelRecords_ = std::make_shared<std::vector<FuelModelRecord>>(*fuelModelRecords_);
+    }
+    if (fuelbedParameters_.use_count() != 1)
+    {
+        fuelbedParameters_ = createFuelbedParameterTable(fuelbedParameters_.get());
+    }
+    if (curingFuelbedConstants_.use_count() != 1)
+    {
+        curingFuelbedConstants_ = std::make_shared<std::vector<std::vector<StaticFuelbedConstants>>>(*curingFuelbedConstants_);
     }
+    if (fuelCodeIndex_.use_count() != 1)
+    {
+        fuelCodeIndex_ = std::make_shared<std::unordered_map<std::string, std::vector<int>>>(*fuelCodeIndex_);
+    }
+    return *fuelModelRecords_;
+}
+
+FuelModels::FuelbedParameters* FuelModels::getMutableFuelbedParameters()
+{
+    getMutableFuelModelRecords();
+    return fuelbedParameters_.get();
+}
+
+std::shared_ptr<FuelModels::FuelbedParameters> FuelModels::createFuelbedParameterTable(const FuelbedParameters* source,
+    int numberOfSourceEntries, int numberOfEntries)
+{
+    // operator new only guarantees the alignment of fundamental types before C++17, so the table
+    // is placed in a buffer with room to move its start up to the next cache line
+    static_assert(std::is_trivially_destructible<FuelbedParameters>::value, "table entries are never destroyed");
+    size_t tableSize = sizeof(FuelbedParameters) * numberOfEntries;
+    size_t bufferSize = tableSize + alignof(FuelbedParameters);
+    char* buffer = new char[bufferSize];
+    void* tableStart = buffer;
+    std::align(alignof(FuelbedParameters), tableSize, tableStart, bufferSize);
+    FuelbedParameters* table = static_cast<FuelbedParameters*>(tableStart);
+    for (int i = 0; i < numberOfEntries; i++)
+    {
+        new (&table[i]) FuelbedParameters((source && i < numberOfSourceEntries) ? source[i] : FuelbedParameters());
+    }
+    return std::shared_ptr<FuelbedParameters>(table, [buffer](FuelbedParameters*) { delete[] buffer; });
 }
 
 FuelModels::~FuelModels()
@@ -86,23 +148,15 @@ FuelModels::~FuelModels()
 
 void FuelModels::initializeSingleFuelModelRecord(int fuelModelNumber)
 {
-    FuelModelVector_[fuelModelNumber].fuelModelNumber_ = 0;
-    FuelModelVector_[fuelModelNumber].code_ = "NO_CODE";
-    FuelModelVector_[fuelModelNumber].name_ = "NO_NAME";
-    FuelModelVector_[fuelModelNumber].fuelbedDepth_ = 0;
-    FuelModelVector_[fuelModelNumber].moistureOfExtinctionDead_ = 0;
-    FuelModelVector_[fuelModelNumber].heatOfCombustionDead_ = 0;
-    FuelModelVector_[fuelModelNumber].heatOfCombustionLive_ = 0;
-    FuelModelVector_[fuelModelNumber].fuelLoadOneHour_ = 0;
-    FuelModelVector_[fuelModelNumber].fuelLoadTenHour_ = 0;
-    FuelModelVector_[fuelModelNumber].fuelLoadHundredHour_ = 0;
-    FuelModelVector_[fuelModelNumber].fuelLoadLiveHerbaceous_ = 0;
-    FuelModelVector_[fuelModelNumber].fuelLoadLiveWoody_ = 0;
-    FuelModelVector_[fuelModelNumber].savrOneHour_ = 0;
-    FuelModelVector_[fuelModelNumber].savrLiveHerbaceous_ = 0;
-    FuelModelVector_[fuelModelNumber].savrLiveWoody_ = 0;
-    FuelModelVector_[fuelModelNumber].isReserved_ = false;
-    FuelModelVector_[fuelModelNumber].isDefined_ = false;
+    std::vector<FuelModelRecord>& fuelModelRecords = getMutableFuelModelRecords();
+    fuelModelRecords[fuelModelNumber].fuelModelNumber_ = 0;
+    fuelModelRecords[fuelModelNumber].code_ = "NO_CODE";
+    fuelModelRecords[fuelModelNumber].name_ = "NO_NAME";
+    fuelModelRecords[fuelModelNumber].isReserved_ = false;
+    fuelModelRecords[fuelModelNumber].isDefined_ = false;
+    getMutableFuelbedParameters()[fuelModelNumber] = FuelbedParameters();
+    (*curingFuelbedConstants_)[fuelModelNumber].clear();
+    revision_ = nextFuelModelsRevision++;
 }
 
 void FuelModels::initializeAllFuelModelRecords()
@@ -119,24 +173,208 @@ void FuelModels::setFuelModelRecord(int fuelModelNumber, std::string code, std::
     double fuelLoadliveWoody, double savrOneHour, double savrLiveHerbaceous, double savrLiveWoody,
     bool isDynamic, bool isReserved)
 {
-    FuelModelVector_[fuelModelNumber].fuelModelNumber_ = fuelModelNumber;
-    FuelModelVector_[fuelModelNumber].code_ = code;
-    FuelModelVector_[fuelModelNumber].name_ = name;
-    FuelModelVector_[fuelModelNumber].fuelbedDepth_ = fuelBedDepth;
-    FuelModelVector_[fuelModelNumber].moistureOfExtinctionDead_ = moistureOfExtinctionDead;
-    FuelModelVector_[fuelModelNumber].heatOfCombustionDead_ = heatOfCombustionDead;
-    FuelModelVector_[fuelModelNumber].heatOfCombustionLive_ = heatOfCombustionLive;
-    FuelModelVector_[fuelModelNumber].fuelLoadOneHour_ = fuelLoadOneHour;
-    FuelModelVector_[fuelModelNumber].fuelLoadTenHour_ = fuelLoadTenHour;
-    FuelModelVector_[fuelModelNumber].fuelLoadHundredHour_ = fuelLoadHundredHour;
-    FuelModelVector_[fuelModelNumber].fuelLoadLiveHerbaceous_ = fuelLoadliveHerbaceous;
-    FuelModelVector_[fuelModelNumber].fuelLoadLiveWoody_ = fuelLoadliveWoody;
-    FuelModelVector_[fuelModelNumber].savrOneHour_ = savrOneHour;
-    FuelModelVector_[fuelModelNumber].savrLiveHerbaceous_ = savrLiveHerbaceous;
-    FuelModelVector_[fuelModelNumber].savrLiveWoody_ = savrLiveWoody;
-    FuelModelVector_[fuelModelNumber].isDynamic_ = isDynamic;
-    FuelModelVector_[fuelModelNumber].isReserved_ = isReserved;
-    FuelModelVector_[fuelModelNumber].isDefined_ = true;
+    std::vector<FuelModelRecord>& fuelModelRecords = getMutableFuelModelRecords();
+    fuelModelRecords[fuelModelNumber].fuelModelNumber_ = fuelModelNumber;
+    fuelModelRecords[fuelModelNumber].code_ = code;
+    fuelModelRecords[fuelModelNumber].name_ = name;
+    fuelModelRecords[fuelModelNumber].isReserved_ = isReserved;
+    fuelModelRecords[fuelModelNumber].isDefined_ = true;
+    FuelbedParameters& parameters = getMutableFuelbedParameters()[fuelModelNumber];
+    parameters.fuelbedDepth_ = fuelBedDepth;
+    parameters.moistureOfExtinctionDead_ = moistureOfExtinctionDead;
+    parameters.heatOfCombustionDead_ = heatOfCombustionDead;
+    parameters.heatOfCombustionLive_ = heatOfCombustionLive;
+    parameters.fuelLoadOneHour_ = fuelLoadOneHour;
+    parameters.fuelLoadTenHour_ = fuelLoadTenHour;
+    parameters.fuelLoadHundredHour_ = fuelLoadHundredHour;
+    parameters.fuelLoadLiveHerbaceous_ = fuelLoadliveHerbaceous;
+    parameters.fuelLoadLiveWoody_ = fuelLoadliveWoody;
+    parameters.savrOneHour_ = savrOneHour;
+    parameters.savrLiveHerbaceous_ = savrLiveHerbaceous;
+    parameters.savrLiveWoody_ = savrLiveWoody;
+    parameters.isDynamic_ = isDynamic;
+    std::string upperCaseCode = code;
+    std::transform(upperCaseCode.begin(), upperCaseCode.end(), upperCaseCode.begin(), ::toupper);
+    std::vector<int>& codeFuelModelNumbers = (*fuelCodeIndex_)[upperCaseCode];
+    if (std::find(codeFuelModelNumbers.begin(), codeFuelModelNumbers.end(), fuelModelNumber) == codeFuelModelNumbers.end())
+    {
+        codeFuelModelNumbers.push_back(fuelModelNumber);
+        std::sort(codeFuelModelNumbers.begin(), codeFuelModelNumbers.end());
+    }
+    calculateStaticFuelbedConstants(parameters);
+    calculateCuringFuelbedConstants(parameters, (*curingFuelbedConstants_)[fuelModelNumber]);
+    calculateSizeClassBins(parameters);
+    revision_ = nextFuelModelsRevision++;
+}
+
+void FuelModels::calculateSizeClassBins(FuelbedParameters& parameters)
+{
+    // The particles of the standard fuelbed as set up by SurfaceFuelbedIntermediates, the dead
+    // herbaceous particle takes the live herbaceous SAVR whether or not any load is transferred to it
+    SizeClassBins& bins = parameters.sizeClassBins_;
+    const double savrDead[FuelConstants::MaxParticles] = { parameters.savrOneHour_, 109.0, 30.0, parameters.savrLiveHerbaceous_, 0.0 };
+    const double savrLive[FuelConstants::MaxParticles] = { parameters.savrLiveHerbaceous_, parameters.savrLiveWoody_, 0.0, 0.0, 0.0 };
+    for (int i = 0; i < FuelConstants::MaxParticles; i++)
+    {
+        bins.sizeClassDead_[i] = static_cast<signed char>(getSavrSizeClass(savrDead[i]));
+        bins.sizeClassLive_[i] = static_cast<signed char>(getSavrSizeClass(savrLive[i]));
+    }
+
+    // Any nonzero load in a life state boosts its count to the maximum number of size classes
+    bool hasDeadLoad = parameters.fuelLoadOneHour_ || parameters.fuelLoadTenHour_ || parameters.fuelLoadHundredHour_;
+    bool hasLiveLoad = parameters.fuelLoadLiveHerbaceous_ || parameters.fuelLoadLiveWoody_;
+    bins.numberOfSizeClasses_[FuelLifeState::Dead] = hasDeadLoad ? FuelConstants::MaxDeadSizeClasses : 0;
+    bins.numberOfSizeClasses_[FuelLifeState::Live] = hasLiveLoad ? FuelConstants::MaxLiveSizeClasses : 0;
+}
+
+int FuelModels::getSavrSizeClass(double savr)
+{
+    if (savr >= 1200.0)
+    {
+        return 0;
+    }
+    else if (savr >= 192.0)
+    {
+        return 1;
+    }
+    else if (savr >= 96.0)
+    {
+        return 2;
+    }
+    else if (savr >= 48.0)
+    {
+        return 3;
+    }
+    else if (savr >= 16.0)
+    {
+        return 4;
+    }
+    return -1;
+}
+
+void FuelModels::calculateStaticFuelbedConstants(FuelbedParameters& parameters)
+{
+    // Dynamic models transfer load with live herbaceous moisture, so they get a curing table instead
+    parameters.staticFuelbedConstants_ = StaticFuelbedConstants();
+    parameters.hasStaticFuelbedConstants_ = false;
+    bool isAllFuelLoadZero = !(parameters.fuelLoadOneHour_ || parameters.fuelLoadTenHour_ || parameters.fuelLoadHundredHour_
+        || parameters.fuelLoadLiveHerbaceous_ || parameters.fuelLoadLiveWoody_);
+    if (parameters.isDynamic_ || isAllFuelLoadZero)
+    {
+        return;
+    }
+
+    double loadDead[FuelConstants::MaxParticles] = { parameters.fuelLoadOneHour_, parameters.fuelLoadTenHour_, parameters.fuelLoadHundredHour_, 0.0, 0.0 };
+    double loadLive[FuelConstants::MaxParticles] = { parameters.fuelLoadLiveHerbaceous_, parameters.fuelLoadLiveWoody_, 0.0, 0.0, 0.0 };
+    parameters.hasStaticFuelbedConstants_ = calculateFuelbedConstants(parameters, loadDead, loadLive, parameters.staticFuelbedConstants_);
+}
+
+void FuelModels::calculateCuringFuelbedConstants(const FuelbedParameters& parameters, std::vector<StaticFuelbedConstants>& curingTable)
+{
+    // Each level transfers the herbaceous load the way SurfaceFuelbedIntermediates::dynamicLoadTransfer()
+    // does at that level's moisture. A model any level of which has no constants gets no table, as does
+    // one without dead load, whose transferred load a run leaves out because it counts size classes first
+    curingTable.clear();
+    bool hasDeadLoad = parameters.fuelLoadOneHour_ || parameters.fuelLoadTenHour_ || parameters.fuelLoadHundredHour_;
+    if (!parameters.isDynamic_ || !hasDeadLoad)
+    {
+        return;
+    }
+
+    std::vector<StaticFuelbedConstants> levels(NumberOfCuringLevels);
+    for (int level = 0; level < NumberOfCuringLevels; level++)
+    {
+        double loadDead[FuelConstants::MaxParticles] = { parameters.fuelLoadOneHour_, parameters.fuelLoadTenHour_, parameters.fuelLoadHundredHour_, 0.0, 0.0 };
+        double loadLive[FuelConstants::MaxParticles] = { parameters.fuelLoadLiveHerbaceous_, parameters.fuelLoadLiveWoody_, 0.0, 0.0, 0.0 };
+        if (level == 0)
+        {
+            loadDead[3] = loadLive[0];
+            loadLive[0] = 0.0;
+        }
+        else if (level < NumberOfCuringLevels - 1)
+        {
+            double moistureLiveHerbaceous = FullyCuredMoisture + (level - 1) * CuringMoistureStep;
+            loadDead[3] = loadLive[0] * (1.333 - 1.11 * moistureLiveHerbaceous);
+            loadLive[0] -= loadDead[3];
+        }
+        if (!calculateFuelbedConstants(parameters, loadDead, loadLive, levels[level]))
+        {
+            return;
+        }
+    }
+    curingTable.swap(levels);
+}
+
+bool FuelModels::calculateFuelbedConstants(const FuelbedParameters& parameters, const double loadDead[FuelConstants::MaxParticles],
+    const double loadLive[FuelConstants::MaxParticles], StaticFuelbedConstants& constants)
+{
+    // Mirrors the standard fuel model path of SurfaceFuelbedIntermediates term for term so the
+    // stored values are identical to the ones computed there
+    constants = StaticFuelbedConstants();
+    double depth = parameters.fuelbedDepth_;
+    if (depth < 1.0e-07)
+    {
+        return false;
+    }
+
+    const double fuelDensity = 32.0; // Average density of dry fuel in lbs/ft^3, Albini 1976, p. 91
+    double savrDead[FuelConstants::MaxParticles] = { parameters.savrOneHour_, 109.0, 30.0, parameters.savrLiveHerbaceous_, 0.0 };
+    double savrLive[FuelConstants::MaxParticles] = { parameters.savrLiveHerbaceous_, parameters.savrLiveWoody_, 0.0, 0.0, 0.0 };
+
+    double totalSurfaceAreaDead = 0.0;
+    double totalSurfaceAreaLive = 0.0;
+    for (int i = 0; i < FuelConstants::MaxParticles; i++)
+    {
+        totalSurfaceAreaDead += loadDead[i] * savrDead[i] / fuelDensity;
+        totalSurfaceAreaLive += loadLive[i] * savrLive[i] / fuelDensity;
+    }
+
+    double weightedSavrDead = 0.0;
+    double weightedSavrLive = 0.0;
+    for (int i = 0; i < FuelConstants::MaxParticles; i++)
+    {
+        if (savrDead[i] > 1.0e-07 && totalSurfaceAreaDead > 1.0e-7)
+        {
+            weightedSavrDead += ((loadDead[i] * savrDead[i] / fuelDensity) / totalSurfaceAreaDead) * savrDead[i];
+        }
+        if (savrLive[i] > 1.0e-07 && totalSurfaceAreaLive > 1.0e-7)
+        {
+            weightedSavrLive += ((loadLive[i] * savrLive[i] / fuelDensity) / totalSurfaceAreaLive) * savrLive[i];
+        }
+    }
+
+    double fractionOfTotalSurfaceAreaDead = totalSurfaceAreaDead / (totalSurfaceAreaDead + totalSurfaceAreaLive);
+    double fractionOfTotalSurfaceAreaLive = 1.0 - fractionOfTotalSurfaceAreaDead;
+    double sigma = fractionOfTotalSurfaceAreaDead * weightedSavrDead + fractionOfTotalSurfaceAreaLive * weightedSavrLive;
+    if (sigma < 1.0e-07)
+    {
+        return false;
+    }
+
+    double packingRatio = 0.0;
+    for (int i = 0; i < FuelConstants::MaxParticles; i++)
+    {
+        packingRatio += loadDead[i] / (depth * fuelDensity);
+        packingRatio += loadLive[i] / (depth * fuelDensity);
+    }
+    double optimumPackingRatio = 3.348 / pow(sigma, 0.8189);
+    double relativePackingRatio = packingRatio / optimumPackingRatio;
+
+    double aa = 133.0 / pow(sigma, 0.7913);
+    double sigmaToTheOnePointFive = pow(sigma, 1.5);
+    double gammaMax = sigmaToTheOnePointFive / (495.0 + (0.0594 * sigmaToTheOnePointFive));
+
+    constants.sigma_ = sigma;
+    constants.packingRatio_ = packingRatio;
+    constants.relativePackingRatio_ = relativePackingRatio;
+    constants.propagatingFlux_ = exp((0.792 + (0.681 * sqrt(sigma))) * (packingRatio + 0.1)) / (192.0 + 0.2595 * sigma);
+    constants.reactionVelocity_ = gammaMax * pow(relativePackingRatio, aa) * exp(aa * (1.0 - relativePackingRatio));
+    constants.windC_ = 7.47 * exp(-0.133 * pow(sigma, 0.55));
+    constants.windB_ = 0.02526 * pow(sigma, 0.54);
+    constants.windE_ = 0.715 * exp(-0.000359 * sigma);
+    constants.windRelativePackingRatioFactor_ = pow(relativePackingRatio, -constants.windE_);
+    constants.slopePackingRatioFactor_ = 5.275 * pow(packingRatio, -0.3);
+    return true;
 }
 
 // PopulateFuelModels() fills FuelModelArray[] with the standard fuel model parameters
@@ -150,7 +388,7 @@ void FuelModels::populateFuelModels()
     // Index 0 is not used
     setFuelModelRecord(0, "NO_CODE", "NO_NAME", 0, 0, 0, 0,
         0, 0, 0, 0, 0, 0, 0, 0, false, false);
-    FuelModelVector_[0].isDefined_ = false;
+    getMutableFuelModelRecords()[0].isDefined_ = false;
     /*
     fuelModelNumber, code, name
     fuelBedDepth, moistureOfExtinctionDeadFuel, heatOfCombustionDeadFuel, heatOfCombustionLiveFuel,
@@ -732,7 +970,7 @@ bool FuelModels::setCustomFuelModel(int fuelModelNumber, std::string code, std::
         savrLiveWoody = SurfaceAreaToVolumeUnits::toBaseUnits(savrLiveWoody, savrUnits);
     }
 
-    if (FuelModelVector_[fuelModelNumber].isReserved_ == false)
+    if ((*fuelModelRecords_)[fuelModelNumber].isReserved_ == false)
     {
         setFuelModelRecord(fuelModelNumber, code, name,
             fuelBedDepth, moistureOfExtinctionDead, heatOfCombustionDead, heatOfCombustionLive,
@@ -748,7 +986,7 @@ bool FuelModels::clearCustomFuelModel(int fuelModelNumber)
 {
     bool successStatus = false;
 
-    if (FuelModelVector_[fuelModelNumber].isReserved_)
+    if ((*fuelModelRecords_)[fuelModelNumber].isReserved_)
     {
         successStatus = false;
     }
@@ -762,123 +1000,243 @@ bool FuelModels::clearCustomFuelModel(int fuelModelNumber)
 
 void FuelModels::markAsReservedModel(int fuelModelNumber)
 {
-    FuelModelVector_[fuelModelNumber].isReserved_ = true;
+    std::vector<FuelModelRecord>& fuelModelRecords = getMutableFuelModelRecords();
+    fuelModelRecords[fuelModelNumber].isReserved_ = true;
 }
 
 double FuelModels::getFuelbedDepth(int fuelModelNumber, LengthUnits::LengthUnitsEnum lengthUnits) const
 {
-    return LengthUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].fuelbedDepth_, lengthUnits);
+    return LengthUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).fuelbedDepth_, lengthUnits);
 }
 
 std::string FuelModels::getFuelCode(int fuelModelNumber) const
 {
-    return FuelModelVector_[fuelModelNumber].code_;
+    if (fuelModelNumber >= FuelConstants::MaxFuelModels)
+    {
+        return fuelLibrary_ ? fuelLibrary_->getFuelCode(fuelModelNumber) : "NO_CODE";
+    }
+    return (*fuelModelRecords_)[fuelModelNumber].code_;
+}
+
+int FuelModels::getFuelModelNumberFromFuelCode(std::string fuelCode) const
+{
+    std::transform(fuelCode.begin(), fuelCode.end(), fuelCode.begin(), ::toupper);
+    auto found = fuelCodeIndex_->find(fuelCode);
+    if (found == fuelCodeIndex_->end())
+    {
+        return fuelLibrary_ ? fuelLibrary_->getFuelModelNumberFromFuelCode(fuelCode) : -1;
+    }
+    for (int fuelModelNumber : found->second)
+    {
+        const FuelModelRecord& record = (*fuelModelRecords_)[fuelModelNumber];
+        if (record.isDefined_ && record.code_.size() == fuelCode.size() &&
+            std::equal(record.code_.begin(), record.code_.end(), fuelCode.begin(),
+                [](char lhs, char rhs) { return ::toupper((unsigned char)lhs) == rhs; }))
+        {
+            return fuelModelNumber;
+        }
+    }
+    return fuelLibrary_ ? fuelLibrary_->getFuelModelNumberFromFuelCode(fuelCode) : -1;
 }
 
 std::string FuelModels::getFuelName(int fuelModelNumber) const
 {
-    return FuelModelVector_[fuelModelNumber].name_;
+    if (fuelModelNumber >= FuelConstants::MaxFuelModels)
+    {
+        return fuelLibrary_ ? fuelLibrary_->getFuelName(fuelModelNumber) : "NO_NAME";
+    }
+    return (*fuelModelRecords_)[fuelModelNumber].name_;
 }
 
 double FuelModels::getMoistureOfExtinctionDead(int fuelModelNumber, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
-    return FractionUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].moistureOfExtinctionDead_, moistureUnits);
+    return FractionUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).moistureOfExtinctionDead_, moistureUnits);
 }
 
 double FuelModels::getHeatOfCombustionDead(int fuelModelNumber, HeatOfCombustionUnits::HeatOfCombustionUnitsEnum heatOfCombustionUnits) const
 {
-    return HeatOfCombustionUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].heatOfCombustionDead_, heatOfCombustionUnits);
+    return HeatOfCombustionUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).heatOfCombustionDead_, heatOfCombustionUnits);
 }
 
 double FuelModels::getHeatOfCombustionLive(int fuelModelNumber, HeatOfCombustionUnits::HeatOfCombustionUnitsEnum heatOfCombustionUnits) const
 {
-    return HeatOfCombustionUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].heatOfCombustionLive_, heatOfCombustionUnits);
+    return HeatOfCombustionUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).heatOfCombustionLive_, heatOfCombustionUnits);
 }
 
 double FuelModels::getFuelLoadOneHour(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].fuelLoadOneHour_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).fuelLoadOneHour_, loadingUnits);
 }
 
 double FuelModels::getFuelLoadTenHour(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].fuelLoadTenHour_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).fuelLoadTenHour_, loadingUnits);
 }
 
 double FuelModels::getFuelLoadHundredHour(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].fuelLoadHundredHour_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).fuelLoadHundredHour_, loadingUnits);
 }
 
 double FuelModels::getFuelLoadLiveHerbaceous(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].fuelLoadLiveHerbaceous_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).fuelLoadLiveHerbaceous_, loadingUnits);
 }
 
 double FuelModels::getFuelLoadLiveWoody(int fuelModelNumber, LoadingUnits::LoadingUnitsEnum loadingUnits) const
 {
-    return LoadingUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].fuelLoadLiveWoody_, loadingUnits);
+    return LoadingUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).fuelLoadLiveWoody_, loadingUnits);
 }
 
 double FuelModels::getSavrOneHour(int fuelModelNumber, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const
 {
-    return SurfaceAreaToVolumeUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].savrOneHour_, savrUnits);
+    return SurfaceAreaToVolumeUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).savrOneHour_, savrUnits);
 }
 
 double FuelModels::getSavrLiveHerbaceous(int fuelModelNumber, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const
 {
-    return SurfaceAreaToVolumeUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].savrLiveHerbaceous_, savrUnits);
+    return SurfaceAreaToVolumeUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).savrLiveHerbaceous_, savrUnits);
 }
 
 double FuelModels::getSavrLiveWoody(int fuelModelNumber, SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const
 {
-    return SurfaceAreaToVolumeUnits::fromBaseUnits(FuelModelVector_[fuelModelNumber].savrLiveWoody_, savrUnits);
+    return SurfaceAreaToVolumeUnits::fromBaseUnits(getFuelbedParameters(fuelModelNumber).savrLiveWoody_, savrUnits);
 }
 
 bool FuelModels::getIsDynamic(int fuelModelNumber) const
 {
-    if(fuelModelNumber <= 0 || fuelModelNumber > 256)
+    if (fuelModelNumber >= FuelConstants::MaxFuelModels)
+    {
+        return getFuelbedParameters(fuelModelNumber).isDynamic_;
+    }
+    else if(fuelModelNumber <= 0)
     {
         return false;
     }
     else
     {
-        return FuelModelVector_[fuelModelNumber].isDynamic_;
+        return fuelbedParameters_.get()[fuelModelNumber].isDynamic_;
     }
 }
 
 bool FuelModels::isFuelModelDefined(int fuelModelNumber) const
 {
-    if (fuelModelNumber <= 0 || fuelModelNumber > 256)
+    if (fuelModelNumber >= FuelConstants::MaxFuelModels)
+    {
+        return fuelLibrary_ && fuelLibrary_->isFuelModelDefined(fuelModelNumber);
+    }
+    else if (fuelModelNumber <= 0)
     {
         return false;
     }
     else
     {
-        return FuelModelVector_[fuelModelNumber].isDefined_;
+        return (*fuelModelRecords_)[fuelModelNumber].isDefined_;
     }
 }
 
 bool FuelModels::isFuelModelReserved(int fuelModelNumber) const
 {
-    if(fuelModelNumber <= 0 || fuelModelNumber > 256)
+    if(fuelModelNumber <= 0 || fuelModelNumber >= FuelConstants::MaxFuelModels)
     {
         return false;
     }
     else
     {
-        return  FuelModelVector_[fuelModelNumber].isReserved_;
+        return  (*fuelModelRecords_)[fuelModelNumber].isReserved_;
     }
 }
 
 bool FuelModels::isAllFuelLoadZero(int fuelModelNumber) const
 {
     // if  all loads are zero, skip calculations
-    bool isZeroLoad = !(getFuelLoadOneHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-        || getFuelLoadTenHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-        || getFuelLoadHundredHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-        || getFuelLoadLiveHerbaceous(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
-        || getFuelLoadLiveWoody(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+    const FuelbedParameters& parameters = getFuelbedParameters(fuelModelNumber);
+    bool isZeroLoad = !(parameters.fuelLoadOneHour_ || parameters.fuelLoadTenHour_ || parameters.fuelLoadHundredHour_
+        || parameters.fuelLoadLiveHerbaceous_ || parameters.fuelLoadLiveWoody_);
 
     return isZeroLoad;
 }
+
+unsigned long FuelModels::getRevision() const
+{
+    return revision_;
+}
+
+void FuelModels::setFuelLibrary(std::shared_ptr<const FuelLibrary> fuelLibrary)
+{
+    fuelLibrary_ = fuelLibrary;
+    revision_ = nextFuelModelsRevision++;
+}
+
+std::shared_ptr<const FuelLibrary> FuelModels::getFuelLibrary() const
+{
+    return fuelLibrary_;
+}
+
+int FuelModels::getCuringLevel(double moistureLiveHerbaceous)
+{
+    if (moistureLiveHerbaceous < FullyCuredMoisture)
+    {
+        return 0;
+    }
+    else if (moistureLiveHerbaceous > UncuredMoisture)
+    {
+        return NumberOfCuringLevels - 1;
+    }
+    else if (!(moistureLiveHerbaceous <= UncuredMoisture))
+    {
+        return -1; // NaN
+    }
+    long step = std::lround((moistureLiveHerbaceous - FullyCuredMoisture) / CuringMoistureStep);
+    if (fabs(moistureLiveHerbaceous - (FullyCuredMoisture + step * CuringMoistureStep)) > 1.0e-9)
+    {
+        return -1;
+    }
+    return static_cast<int>(step) + 1;
+}
+
+const FuelModels::StaticFuelbedConstants* FuelModels::getFuelbedConstants(int fuelModelNumber, double moistureLiveHerbaceous) const
+{
+    if (fuelModelNumber >= FuelConstants::MaxFuelModels)
+    {
+        return fuelLibrary_ ? fuelLibrary_->getFuelbedConstants(fuelModelNumber, moistureLiveHerbaceous) : nullptr;
+    }
+    else if (fuelModelNumber < 0)
+    {
+        return nullptr;
+    }
+    const std::vector<StaticFuelbedConstants>& curingTable = (*curingFuelbedConstants_)[fuelModelNumber];
+    if (curingTable.empty())
+    {
+        return getStaticFuelbedConstants(fuelModelNumber);
+    }
+    int curingLevel = getCuringLevel(moistureLiveHerbaceous);
+    return (curingLevel < 0) ? nullptr : &curingTable[curingLevel];
+}
+
+const FuelModels::StaticFuelbedConstants* FuelModels::getStaticFuelbedConstants(int fuelModelNumber) const
+{
+    const FuelbedParameters& parameters = getFuelbedParameters(fuelModelNumber);
+    if (fuelModelNumber <= 0 || !parameters.hasStaticFuelbedConstants_)
+    {
+        return nullptr;
+    }
+    else
+    {
+        return &parameters.staticFuelbedConstants_;
+    }
+}
+
+const FuelModels::FuelbedParameters& FuelModels::getFuelbedParameters(int fuelModelNumber) const
+{
+    if (fuelModelNumber >= FuelConstants::MaxFuelModels)
+    {
+        const FuelbedParameters* parameters = fuelLibrary_ ? fuelLibrary_->findFuelbedParameters(fuelModelNumber) : nullptr;
+        return parameters ? *parameters : emptyFuelbedParameters;
+    }
+    else if (fuelModelNumber < 0)
+    {
+        return emptyFuelbedParameters;
+    }
+    return fuelbedParameters_.get()[fuelModelNumber];
+}
@@ -33,12 +33,65 @@
 #define FUELMODELS_H
 
 #include "behaveUnits.h"
+#include "surfaceInputEnums.h"
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+class FuelLibrary;
+
 class FuelModels
 {
 public:
+    // Values that depend only on the loads, SAVRs and depth of a static fuel model,
+    // computed once when the model is defined rather than on every surface run
+    struct StaticFuelbedConstants
+    {
+        double sigma_;                              // Characteristic SAVR (ft^2/ft^3)
+        double packingRatio_;                       // Packing ratio, Rothermel 1972, equation 31
+        double relativePackingRatio_;               // Packing ratio over optimum packing ratio
+        double propagatingFlux_;                    // Propagating flux ratio, Rothermel 1972, equation 42
+        double reactionVelocity_;                   // Optimum reaction velocity, Rothermel 1972, equation 38
+        double windB_;                              // Wind factor exponent B, Rothermel 1972, equation 49
+        double windC_;                              // Wind factor coefficient C, Rothermel 1972, equation 48
+        double windE_;                              // Wind factor exponent E, Rothermel 1972, equation 50
+        double windRelativePackingRatioFactor_;     // pow(relativePackingRatio_, -windE_)
+        double slopePackingRatioFactor_;            // 5.275 * pow(packingRatio_, -0.3), Rothermel 1972, equation 51
+    };
+
+    // Which SAVR size class each particle of a fuel model's fuelbed falls in, and how many particles each
+    // life state has. They depend only on the SAVRs and on which loads are nonzero, neither of which a
+    // dynamic model's curing transfer changes, so they are sorted once when the model is defined
+    struct SizeClassBins
+    {
+        signed char sizeClassDead_[FuelConstants::MaxParticles];        // SAVR size class, -1 below 16 ft^2/ft^3
+        signed char sizeClassLive_[FuelConstants::MaxParticles];        // SAVR size class, -1 below 16 ft^2/ft^3
+        signed char numberOfSizeClasses_[FuelConstants::MaxLifeStates]; // Particles counted for each life state
+    };
+
+    // The numeric part of a fuel model in base units, everything a surface run reads. Kept in its own
+    // cache line aligned table, apart from the codes and names, so a run touches three cache lines
+    struct alignas(64) FuelbedParameters
+    {
+        double fuelbedDepth_;               // Fuelbed depth in feet
+        double fuelLoadOneHour_;            // Dead 1 hour fuel loading (lb/ft^2)
+        double fuelLoadTenHour_;            // Dead 10 hour fuel loading (lb/ft^2)
+        double fuelLoadHundredHour_;        // Dead 100 hour fuel loading (lb/ft^2)
+        double fuelLoadLiveHerbaceous_;     // Live herb fuel loading (lb/ft^2)
+        double fuelLoadLiveWoody_;          // Live wood fuel loading (lb/ft^2)
+        double savrOneHour_;                // Dead 1-h fuel surface area to volume ratio (ft^2/ft^3)
+        double savrLiveHerbaceous_;         // Live herb surface area to volume ratio (ft^2/ft^3)
+        double savrLiveWoody_;              // Live wood surface area to volume ratio (ft^2/ft^3)
+        double moistureOfExtinctionDead_;   // Dead fuel extinction moisture content (fraction)
+        double heatOfCombustionDead_;       // Dead fuel heat of combustion (Btu/lb)
+        double heatOfCombustionLive_;       // Live fuel heat of combustion (Btu/lb)
+        bool isDynamic_;                    // If true, the fuel model is dynamic
+        bool hasStaticFuelbedConstants_;    // If true, staticFuelbedConstants_ is valid for this fuel model
+        SizeClassBins sizeClassBins_;       // Size classes of the particles, valid for every defined fuel model
+        StaticFuelbedConstants staticFuelbedConstants_; // Derived values for static fuel models
+    };
+
     FuelModels();
     FuelModels& operator=(const FuelModels& rhs);
     FuelModels(const FuelModels& rhs);
@@ -54,6 +107,8 @@ public:
     bool clearCustomFuelModel(int fuelModelNumber);
 
     std::string getFuelCode(int fuelModelNumber) const;
+    // Lowest defined fuel model number whose code matches, ignoring case, -1 if there is none
+    int getFuelModelNumberFromFuelCode(std::string fuelCode) const;
     std::string getFuelName(int fuelModelNumber) const;
     double getFuelbedDepth(int fuelModelNumber, LengthUnits::LengthUnitsEnum lengthUnits) const;
     double getMoistureOfExtinctionDead(int fuelModelNumber, FractionUnits::FractionUnitsEnum moistureUnits) const;;
@@ -71,9 +126,40 @@ public:
     bool isFuelModelDefined(int fuelModelNumber) const;
     bool isFuelModelReserved(int fuelModelNumber) const;
     bool isAllFuelLoadZero(int fuelModelNumber) const;
+    // All the numeric values of a fuel model in base units at once, zeros for numbers outside the table
+    const FuelbedParameters& getFuelbedParameters(int fuelModelNumber) const;
+    const StaticFuelbedConstants* getStaticFuelbedConstants(int fuelModelNumber) const;
+
+    // Dynamic fuel models transfer live herbaceous load to dead with the live herbaceous moisture, all
+    // of it below FullyCuredMoisture and none above UncuredMoisture. In between their constants are
+    // tabulated at every CuringMoistureStep, so runs at a whole percent of moisture skip the calculation
+    static constexpr double FullyCuredMoisture = 0.30;   // fraction
+    static constexpr double UncuredMoisture = 1.20;      // fraction
+    static constexpr double CuringMoistureStep = 0.01;   // fraction
+    static const int NumberOfCuringLevels = 93;         // fully cured, the 91 steps from 0.30 to 1.20, uncured
+    // Curing level of a live herbaceous moisture (fraction), -1 when it falls between two levels
+    static int getCuringLevel(double moistureLiveHerbaceous);
+    // Constants of a fuel model's fuelbed at a live herbaceous moisture (fraction), those of a static model
+    // whatever the moisture, those of a dynamic model's curing level, or null if the moisture has no level
+    const StaticFuelbedConstants* getFuelbedConstants(int fuelModelNumber, double moistureLiveHerbaceous) const;
+    // Index of the SAVR size class a particle falls in, or -1 below 16 ft^2/ft^3
+    static int getSavrSizeClass(double savr);
+    unsigned long getRevision() const; // changes whenever any record is set or cleared
+
+    // Fuel model numbers from FuelLibrary::FirstFuelModelNumber up are looked up in the attached library,
+    // so every run given this FuelModels can use them. A library must not change once it is attached
+    void setFuelLibrary(std::shared_ptr<const FuelLibrary> fuelLibrary);
+    std::shared_ptr<const FuelLibrary> getFuelLibrary() const;
 
 protected:
+    friend class FuelLibrary; // derives its models' constants the way the records' are
+    struct FuelModelRecord;
+    struct PopulateStandardFuelModels {};
+
+    explicit FuelModels(PopulateStandardFuelModels);
     void memberwiseCopyAssignment(const FuelModels& rhs);
+    std::vector<FuelModelRecord>& getMutableFuelModelRecords();
+    FuelbedParameters* getMutableFuelbedParameters();
     void initializeSingleFuelModelRecord(int fuelModelNumber);
     void initializeAllFuelModelRecords();
     void populateFuelModels();
@@ -83,30 +169,35 @@ protected:
         double fuelLoadOneHour, double fuelLoadTenHour, double fuelLoadHundredHour, double fuelLoadLiveHerbaceous,
         double fuelLoadLiveWoody, double savrOneHourFuel, double savrLiveHerbaceous, double savrLiveWoody,
         bool isDynamic, bool isReserved);
+    static void calculateStaticFuelbedConstants(FuelbedParameters& parameters);
+    static void calculateCuringFuelbedConstants(const FuelbedParameters& parameters, std::vector<StaticFuelbedConstants>& curingTable);
+    static bool calculateFuelbedConstants(const FuelbedParameters& parameters, const double loadDead[FuelConstants::MaxParticles],
+        const double loadLive[FuelConstants::MaxParticles], StaticFuelbedConstants& constants);
+    static void calculateSizeClassBins(FuelbedParameters& parameters);
 
+    // Descriptive part of a fuel model, its numeric values are in the FuelbedParameters table
     struct FuelModelRecord
     {
         int fuelModelNumber_;               // Standard ID number for fuel model 
         std::string code_;                  // Fuel model code, usually 2 letters followed by number,(e.g., "GR1")
         std::string name_;                  // Fuel model name, (e.g., "Humid Climate Grass")
-        double fuelbedDepth_;               // Fuelbed depth in feet
-        double moistureOfExtinctionDead_;   // Dead fuel extinction moisture content (fraction)
-        double heatOfCombustionDead_;       // Dead fuel heat of combustion (Btu/lb)
-        double heatOfCombustionLive_;       // Live fuel heat of combustion (Btu/lb)
-        double fuelLoadOneHour_;            // Dead 1 hour fuel loading (lb/ft^2)
-        double fuelLoadTenHour_;            // Dead 10 hour fuel loading (lb/ft^2)
-        double fuelLoadHundredHour_;        // Dead 100 hour fuel loading (lb/ft^2)
-        double fuelLoadLiveHerbaceous_;     // Live herb fuel loading (lb/ft^2)
-        double fuelLoadLiveWoody_;          // Live wood fuel loading (lb/ft^2)
-        double savrOneHour_;                // Dead 1-h fuel surface area to volume ratio (ft^2/ft^3)
-        double savrLiveHerbaceous_;         // Live herb surface area to volume ratio (ft^2/ft^3)
-        double savrLiveWoody_;              // Live wood surface area to volume ratio (ft^2/ft^3)
-        bool isDynamic_;                    // If true, the fuel model is dynamic
         bool isReserved_;                   // If true, record cannot be used for custom fuel model
         bool isDefined_;                    // If true, record has been populated with values for its fields
     };
 
-    std::vector<FuelModelRecord> FuelModelVector_;
+    // Cache line aligned table of numberOfEntries entries, copying the first numberOfSourceEntries from source
+    static std::shared_ptr<FuelbedParameters> createFuelbedParameterTable(const FuelbedParameters* source,
+        int numberOfSourceEntries = FuelConstants::MaxFuelModels, int numberOfEntries = FuelConstants::MaxFuelModels);
+
+    std::shared_ptr<std::vector<FuelModelRecord>> fuelModelRecords_; // Shared between copies until one changes
+    std::shared_ptr<FuelbedParameters> fuelbedParameters_; // MaxFuelModels entries, shared and detached with the records
+    // MaxFuelModels curing tables of NumberOfCuringLevels entries, empty unless the model is dynamic, shared and detached with the records
+    std::shared_ptr<std::vector<std::vector<StaticFuelbedConstants>>> curingFuelbedConstants_;
+    // Every fuel model number each upper case code has been given, shared and detached with the records.
+    // Numbers are only added, lookups skip records that were cleared or given another code since
+    std::shared_ptr<std::unordered_map<std::string, std::vector<int>>> fuelCodeIndex_;
+    std::shared_ptr<const FuelLibrary> fuelLibrary_; // null unless one is attached
+    unsigned long revision_;
 };
 
 #endif // FUELMODELS_H
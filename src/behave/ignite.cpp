@@ -50,6 +50,11 @@ void Ignite::initializeMembers()
     fuelTemperature_ = 0;
 }
 
+bool Ignite::hasSameInputs(const Ignite& rhs) const
+{
+    return igniteInputs_.hasSameInputs(rhs.igniteInputs_);
+}
+
 double Ignite::calculateFirebrandIgnitionProbability(FractionUnits::FractionUnitsEnum desiredUnits)
 {
     // Covert temperature to Celcius
@@ -223,6 +228,174 @@ double Ignite::calculateLightningIgnitionProbability(FractionUnits::FractionUnit
     return FractionUnits::fromBaseUnits(probabilityOfLightningIgnition, desiredUnits);
 }
 
+// Ignition probabilities over a batch of cells, matching calculateFirebrandIgnitionProbability() and
+// calculateLightningIgnitionProbability() cell by cell with the current fuel bed type and lightning charge.
+// Those pick the lightning curves and their weights once for the batch, leaving each cell a few multiplies and
+// exponentials. The Ignite inputs and fuel temperature are left as they were.
+void Ignite::calculateIgnitionProbabilitiesBatch(const IgniteBatchInputs& inputs, IgniteBatchOutputs& outputs)
+{
+    // Probability of continuing current by charge type (Latham) and relative frequency by charge type (Latham and Schlieter)
+    const double ccNeg = 0.2;
+    const double ccPos = 0.9;
+    const double freqNeg = 0.723;
+    const double freqPos = 0.277;
+
+    LightningIgnitionCurve positiveCurve;
+    LightningIgnitionCurve negativeCurve;
+    getLightningIgnitionCurves(igniteInputs_.getIgnitionFuelBedType(), positiveCurve, negativeCurve);
+
+    double positiveWeight = 0.0;
+    double negativeWeight = 0.0;
+    switch (igniteInputs_.getLightningChargeType())
+    {
+        case LightningCharge::Negative:
+        {
+            negativeWeight = ccNeg;
+            break;
+        }
+        case LightningCharge::Positive:
+        {
+            positiveWeight = ccPos;
+            break;
+        }
+        case LightningCharge::Unknown:
+        {
+            positiveWeight = freqPos * ccPos;
+            negativeWeight = freqNeg * ccNeg;
+            break;
+        }
+    }
+
+    for (int i = 0; i < inputs.numberOfCells; i++)
+    {
+        double fuelTemperature = inputs.airTemperature[i] + (25.0 - (20.0 * inputs.sunShade[i]));
+        if (outputs.fuelTemperature)
+        {
+            outputs.fuelTemperature[i] = fuelTemperature;
+        }
+
+        if (outputs.firebrandIgnitionProbability)
+        {
+            double fuelTemperatureCelsius = TemperatureUnits::fromBaseUnits(fuelTemperature, TemperatureUnits::Celsius);
+            double fuelMoisture = inputs.moistureOneHour[i];
+            double heatOfIgnition = 144.51
+                - 0.26600 * fuelTemperatureCelsius
+                - 0.00058 * fuelTemperatureCelsius * fuelTemperatureCelsius
+                - fuelTemperatureCelsius * fuelMoisture
+                + 18.5400 * (1.0 - exp(-15.1 * fuelMoisture))
+                + 640.000 * fuelMoisture;
+            heatOfIgnition = (heatOfIgnition > 400.0) ? 400.0 : heatOfIgnition;
+
+            double x = 0.1 * (400.0 - heatOfIgnition);
+            double probabilityOfIgnition = (0.000048 * pow(x, 4.3)) / 50.0;
+            probabilityOfIgnition = (probabilityOfIgnition > 1.0) ? 1.0 : probabilityOfIgnition;
+            probabilityOfIgnition = (probabilityOfIgnition < 0.0) ? 0.0 : probabilityOfIgnition;
+            outputs.firebrandIgnitionProbability[i] = probabilityOfIgnition;
+        }
+
+        if (outputs.lightningIgnitionProbability)
+        {
+            // Duff depth in cm, as in calculateLightningIgnitionProbability(), and hundred hour moisture in percent
+            double duffDepth = LengthUnits::fromBaseUnits(inputs.duffDepth[i], LengthUnits::Centimeters) * 2.54;
+            duffDepth = (duffDepth > 10.0) ? 10.0 : duffDepth;
+            double fuelMoisture = FractionUnits::fromBaseUnits(inputs.moistureHundredHour[i], FractionUnits::Percent);
+            fuelMoisture = (fuelMoisture > 40.0) ? 40.0 : fuelMoisture;
+
+            double probabilityOfLightningIgnition = 0.0;
+            if (positiveWeight > 0.0)
+            {
+                probabilityOfLightningIgnition += positiveWeight * calculateLightningIgnitionCurve(positiveCurve, fuelMoisture, duffDepth);
+            }
+            if (negativeWeight > 0.0)
+            {
+                probabilityOfLightningIgnition += negativeWeight * calculateLightningIgnitionCurve(negativeCurve, fuelMoisture, duffDepth);
+            }
+            probabilityOfLightningIgnition = (probabilityOfLightningIgnition < 0.0) ? 0.0 : probabilityOfLightningIgnition;
+            probabilityOfLightningIgnition = (probabilityOfLightningIgnition > 1.0) ? 1.0 : probabilityOfLightningIgnition;
+            outputs.lightningIgnitionProbability[i] = probabilityOfLightningIgnition;
+        }
+    }
+}
+
+// The curves of calculateLightningIgnitionProbability() for each fuel bed type
+void Ignite::getLightningIgnitionCurves(IgnitionFuelBedType::IgnitionFuelBedTypeEnum fuelBedType, LightningIgnitionCurve& positive,
+    LightningIgnitionCurve& negative)
+{
+    positive = { LightningIgnitionCurve::Linear, 0.0, 0.0 };
+    negative = { LightningIgnitionCurve::Linear, 0.0, 0.0 };
+    switch (fuelBedType)
+    {
+        case IgnitionFuelBedType::PonderosaPineLitter:
+        {
+            positive = { LightningIgnitionCurve::Exponential, 0.92, -0.087 };
+            negative = { LightningIgnitionCurve::Exponential, 1.04, -0.054 };
+            break;
+        }
+        case IgnitionFuelBedType::PunkyWoodRottenChunky:
+        {
+            positive = { LightningIgnitionCurve::Exponential, 0.44, -0.110 };
+            negative = { LightningIgnitionCurve::Exponential, 0.59, -0.094 };
+            break;
+        }
+        case IgnitionFuelBedType::PunkyWoodPowderDeep:
+        {
+            positive = { LightningIgnitionCurve::Exponential, 0.86, -0.060 };
+            negative = { LightningIgnitionCurve::Exponential, 0.90, -0.056 };
+            break;
+        }
+        case IgnitionFuelBedType::PunkWoodPowderShallow:
+        {
+            positive = { LightningIgnitionCurve::Linear, 0.60, 0.011 };
+            negative = { LightningIgnitionCurve::Linear, 0.73, 0.011 };
+            break;
+        }
+        case IgnitionFuelBedType::LodgepolePineDuff:
+        {
+            positive = { LightningIgnitionCurve::Logistic, 5.13, 0.68 };
+            negative = { LightningIgnitionCurve::Logistic, 3.84, 0.60 };
+            break;
+        }
+        case IgnitionFuelBedType::DouglasFirDuff:
+        {
+            positive = { LightningIgnitionCurve::Logistic, 6.69, 1.39 };
+            negative = { LightningIgnitionCurve::Logistic, 5.48, 1.28 };
+            break;
+        }
+        case IgnitionFuelBedType::HighAltitudeMixed:
+        {
+            positive = { LightningIgnitionCurve::Exponential, 0.62, -0.050 };
+            negative = { LightningIgnitionCurve::Linear, 0.80, 0.014 };
+            break;
+        }
+        case IgnitionFuelBedType::PeatMoss:
+        {
+            positive = { LightningIgnitionCurve::Exponential, 0.71, -0.070 };
+            negative = { LightningIgnitionCurve::Exponential, 0.84, -0.060 };
+            break;
+        }
+    }
+}
+
+double Ignite::calculateLightningIgnitionCurve(const LightningIgnitionCurve& curve, double fuelMoisture, double duffDepth)
+{
+    switch (curve.form)
+    {
+        case LightningIgnitionCurve::Exponential:
+        {
+            return curve.a * exp(curve.b * fuelMoisture);
+        }
+        case LightningIgnitionCurve::Linear:
+        {
+            return curve.a - (curve.b * fuelMoisture);
+        }
+        case LightningIgnitionCurve::Logistic:
+        {
+            return 1.0 / (1.0 + exp(curve.a - curve.b * duffDepth));
+        }
+    }
+    return 0.0;
+}
+
 void Ignite::setAirTemperature(double airTemperature, TemperatureUnits::TemperatureUnitsEnum temperatureUnites)
 {
     igniteInputs_.setAirTemperature(airTemperature, temperatureUnites);
@@ -34,6 +34,28 @@
 
 #include "igniteInputs.h"
 
+// Structure-of-arrays inputs for Ignite::calculateIgnitionProbabilitiesBatch(), each array holds numberOfCells
+// values in base units: moistures and sun shade as fractions, air temperature in Fahrenheit and duff depth in ft.
+struct IgniteBatchInputs
+{
+    int numberOfCells;
+    const double* moistureOneHour;
+    const double* moistureHundredHour;
+    const double* airTemperature;
+    const double* sunShade;
+    const double* duffDepth;
+};
+
+// Caller-provided output arrays for Ignite::calculateIgnitionProbabilitiesBatch(), each sized for numberOfCells
+// values, with fuel temperature in Fahrenheit and probabilities as fractions. Any array may be null if that
+// output is not needed.
+struct IgniteBatchOutputs
+{
+    double* fuelTemperature;
+    double* firebrandIgnitionProbability;
+    double* lightningIgnitionProbability;
+};
+
 class Ignite
 {
 public:
@@ -41,9 +63,11 @@ public:
     ~Ignite();
 
     void initializeMembers();
+    bool hasSameInputs(const Ignite& rhs) const;
 
     double calculateFirebrandIgnitionProbability(FractionUnits::FractionUnitsEnum desiredUnits);
     double calculateLightningIgnitionProbability(FractionUnits::FractionUnitsEnum desiredUnits);
+    void calculateIgnitionProbabilitiesBatch(const IgniteBatchInputs& inputs, IgniteBatchOutputs& outputs);
 
     void setMoistureOneHour(double moistureOneHour, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureHundredHour(double moistureHundredHour, FractionUnits::FractionUnitsEnum moistureUnits);
@@ -72,7 +96,25 @@ public:
     bool isFuelDepthNeeded();
 
 protected:
+    // Latham's probability of ignition given a long continuing current, for one charge and fuel bed type, in one
+    // of three forms of either the hundred hour moisture in percent or the duff depth
+    struct LightningIgnitionCurve
+    {
+        enum LightningIgnitionCurveFormEnum
+        {
+            Exponential,    // a * exp(b * moisture)
+            Linear,         // a - b * moisture
+            Logistic        // 1 / (1 + exp(a - b * duffDepth))
+        };
+        LightningIgnitionCurveFormEnum form;
+        double a;
+        double b;
+    };
+
     double calculateFuelTemperature();
+    static void getLightningIgnitionCurves(IgnitionFuelBedType::IgnitionFuelBedTypeEnum fuelBedType, LightningIgnitionCurve& positive,
+        LightningIgnitionCurve& negative);
+    static double calculateLightningIgnitionCurve(const LightningIgnitionCurve& curve, double fuelMoisture, double duffDepth);
 
     IgniteInputs igniteInputs_;
 
@@ -112,3 +112,14 @@ LightningCharge::LightningChargeEnum IgniteInputs::getLightningChargeType()
 {
     return lightningChargeType_;
 }
+
+bool IgniteInputs::hasSameInputs(const IgniteInputs& rhs) const
+{
+    return moistureOneHour_ == rhs.moistureOneHour_ &&
+        moistureHundredHour_ == rhs.moistureHundredHour_ &&
+        airTemperature_ == rhs.airTemperature_ &&
+        sunShade_ == rhs.sunShade_ &&
+        fuelBedType_ == rhs.fuelBedType_ &&
+        duffDepth_ == rhs.duffDepth_ &&
+        lightningChargeType_ == rhs.lightningChargeType_;
+}
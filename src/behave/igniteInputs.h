@@ -77,6 +77,8 @@ public:
   
     void setLightningChargeType(LightningCharge::LightningChargeEnum lightningChargeType);
 
+    bool hasSameInputs(const IgniteInputs& rhs) const;
+
     double getAirTemperature(TemperatureUnits::TemperatureUnitsEnum desiredUnits);
     double getMoistureOneHour(FractionUnits::FractionUnitsEnum desiredUnits);
     double getMoistureHundredHour(FractionUnits::FractionUnitsEnum desiredUnits);
@@ -0,0 +1,199 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Optional scoped timers and call counters around the main calculation
+*           stages, aggregated per thread and dumped as JSON
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "instrumentation.h"
+
+#ifdef BEHAVE_INSTRUMENTATION
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+const int numberOfStages = InstrumentationStage::NumberOfStages;
+
+// Counters of one thread. Only the owning thread writes them, with relaxed loads and stores
+// rather than read-modify-writes, and other threads only read them for the totals.
+struct ThreadCounters
+{
+    ThreadCounters();
+    ~ThreadCounters();
+
+    std::atomic<unsigned long long> numberOfCalls[numberOfStages];
+    std::atomic<unsigned long long> nanoseconds[numberOfStages];
+    int depth[numberOfStages];
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<ThreadCounters*> threads;
+    InstrumentationCounters exitedThreads[numberOfStages];   // counters of threads that have exited
+};
+
+Registry& getRegistry()
+{
+    // Constructed before the first thread's counters, so it outlives them all
+    static Registry registry = {};
+    return registry;
+}
+
+ThreadCounters::ThreadCounters()
+{
+    for(int i = 0; i < numberOfStages; i++)
+    {
+        numberOfCalls[i].store(0, std::memory_order_relaxed);
+        nanoseconds[i].store(0, std::memory_order_relaxed);
+        depth[i] = 0;
+    }
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(this);
+}
+
+ThreadCounters::~ThreadCounters()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(int i = 0; i < numberOfStages; i++)
+    {
+        registry.exitedThreads[i].numberOfCalls += numberOfCalls[i].load(std::memory_order_relaxed);
+        registry.exitedThreads[i].nanoseconds += nanoseconds[i].load(std::memory_order_relaxed);
+    }
+    for(size_t i = 0; i < registry.threads.size(); i++)
+    {
+        if(registry.threads[i] == this)
+        {
+            registry.threads.erase(registry.threads.begin() + i);
+            break;
+        }
+    }
+}
+
+ThreadCounters& getThreadCounters()
+{
+    static thread_local ThreadCounters threadCounters;
+    return threadCounters;
+}
+
+} // namespace
+
+bool Instrumentation::enterStage(InstrumentationStage::InstrumentationStageEnum stage)
+{
+    return getThreadCounters().depth[stage]++ == 0;
+}
+
+void Instrumentation::leaveStage(InstrumentationStage::InstrumentationStageEnum stage, bool isOutermostCall, unsigned long long nanoseconds)
+{
+    ThreadCounters& threadCounters = getThreadCounters();
+    threadCounters.depth[stage]--;
+    if(isOutermostCall)
+    {
+        std::atomic<unsigned long long>& numberOfCalls = threadCounters.numberOfCalls[stage];
+        std::atomic<unsigned long long>& totalNanoseconds = threadCounters.nanoseconds[stage];
+        numberOfCalls.store(numberOfCalls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        totalNanoseconds.store(totalNanoseconds.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+    }
+}
+
+void Instrumentation::getTotals(InstrumentationCounters totals[InstrumentationStage::NumberOfStages])
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(int i = 0; i < numberOfStages; i++)
+    {
+        totals[i] = registry.exitedThreads[i];
+        for(const ThreadCounters* threadCounters : registry.threads)
+        {
+            totals[i].numberOfCalls += threadCounters->numberOfCalls[i].load(std::memory_order_relaxed);
+            totals[i].nanoseconds += threadCounters->nanoseconds[i].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Instrumentation::reset()
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for(int i = 0; i < numberOfStages; i++)
+    {
+        registry.exitedThreads[i].numberOfCalls = 0;
+        registry.exitedThreads[i].nanoseconds = 0;
+        for(ThreadCounters* threadCounters : registry.threads)
+        {
+            threadCounters->numberOfCalls[i].store(0, std::memory_order_relaxed);
+            threadCounters->nanoseconds[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::string Instrumentation::toJson()
+{
+    InstrumentationCounters totals[numberOfStages];
+    getTotals(totals);
+
+    std::ostringstream json;
+    json << "{\"stages\":[";
+    for(int i = 0; i < numberOfStages; i++)
+    {
+        json << ((i > 0) ? "," : "")
+            << "{\"name\":\"" << getStageName(static_cast<InstrumentationStage::InstrumentationStageEnum>(i)) << "\""
+            << ",\"calls\":" << totals[i].numberOfCalls
+            << ",\"nanoseconds\":" << totals[i].nanoseconds << "}";
+    }
+    json << "]}";
+    return json.str();
+}
+
+const char* Instrumentation::getStageName(InstrumentationStage::InstrumentationStageEnum stage)
+{
+    switch(stage)
+    {
+        case InstrumentationStage::SurfaceRun:
+            return "surfaceRun";
+        case InstrumentationStage::FuelbedIntermediates:
+            return "fuelbedIntermediates";
+        case InstrumentationStage::ReactionIntensity:
+            return "reactionIntensity";
+        case InstrumentationStage::CrownRun:
+            return "crownRun";
+        case InstrumentationStage::ContainSimRun:
+            return "containSimRun";
+        case InstrumentationStage::Mortality:
+            return "mortality";
+        case InstrumentationStage::RandFuelSpread:
+            return "randFuelSpread";
+        default:
+            return "unknown";
+    }
+}
+
+#endif // BEHAVE_INSTRUMENTATION
@@ -0,0 +1,119 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Optional scoped timers and call counters around the main calculation
+*           stages, aggregated per thread and dumped as JSON
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// Timed stages of a run. Each stage is timed inclusively from its outermost call on a thread, so
+// a stage that calls itself, such as a surface run over many directions, counts as one call.
+struct InstrumentationStage
+{
+    enum InstrumentationStageEnum
+    {
+        SurfaceRun,             // Surface::doSurfaceRun*
+        FuelbedIntermediates,   // SurfaceFuelbedIntermediates::calculateFuelbedIntermediates
+        ReactionIntensity,      // SurfaceFireReactionIntensity::calculateReactionIntensity
+        CrownRun,               // Crown::doCrownRun*
+        ContainSimRun,          // ContainSim::run
+        Mortality,              // Mortality::calculateMortality
+        RandFuelSpread,         // RandFuel::computeSpread2
+        NumberOfStages
+    };
+};
+
+#ifdef BEHAVE_INSTRUMENTATION
+
+#include <chrono>
+#include <string>
+
+struct InstrumentationCounters
+{
+    unsigned long long numberOfCalls;
+    unsigned long long nanoseconds;
+};
+
+// Every thread adds to its own counters without locking. The totals sum the counters of the
+// running threads and of the threads that have already exited. reset() must only be called
+// while no stage is running.
+class Instrumentation
+{
+public:
+    static void getTotals(InstrumentationCounters totals[InstrumentationStage::NumberOfStages]);
+    static void reset();
+    static std::string toJson();
+    static const char* getStageName(InstrumentationStage::InstrumentationStageEnum stage);
+
+    // Used by ScopedStageTimer, enterStage() returns whether this is the stage's outermost call
+    static bool enterStage(InstrumentationStage::InstrumentationStageEnum stage);
+    static void leaveStage(InstrumentationStage::InstrumentationStageEnum stage, bool isOutermostCall, unsigned long long nanoseconds);
+};
+
+class ScopedStageTimer
+{
+public:
+    explicit ScopedStageTimer(InstrumentationStage::InstrumentationStageEnum stage)
+        : stage_(stage),
+        isOutermostCall_(Instrumentation::enterStage(stage))
+    {
+        if(isOutermostCall_)
+        {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedStageTimer()
+    {
+        unsigned long long nanoseconds = 0;
+        if(isOutermostCall_)
+        {
+            nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        }
+        Instrumentation::leaveStage(stage_, isOutermostCall_, nanoseconds);
+    }
+
+    ScopedStageTimer(const ScopedStageTimer& rhs) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer& rhs) = delete;
+
+private:
+    InstrumentationStage::InstrumentationStageEnum stage_;
+    bool isOutermostCall_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define BEHAVE_INSTRUMENTATION_CONCATENATE_IMPL(a, b) a##b
+#define BEHAVE_INSTRUMENTATION_CONCATENATE(a, b) BEHAVE_INSTRUMENTATION_CONCATENATE_IMPL(a, b)
+// Times the rest of the enclosing scope as the given InstrumentationStage
+#define BEHAVE_TIME_STAGE(stage) \
+    ScopedStageTimer BEHAVE_INSTRUMENTATION_CONCATENATE(behaveStageTimer, __LINE__)(InstrumentationStage::stage)
+
+#else
+
+#define BEHAVE_TIME_STAGE(stage)
+
+#endif // BEHAVE_INSTRUMENTATION
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,324 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Optional OpenMP target offload of the surface and crown
+*           kernels for large batches of cells
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "kernelOffload.h"
+
+#include <cmath>
+#include <vector>
+
+#include "crown.h"
+
+#ifdef BEHAVE_OFFLOAD
+#include <omp.h>
+#endif
+
+namespace
+{
+
+struct CellOutputs
+{
+    double spreadRate;
+    double firelineIntensity;
+    double flameLength;
+    double directionOfMaxSpread;
+    double crownFireSpreadRate;
+    int fireType;
+    double finalSpreadRate;
+};
+
+constexpr double feetToMeters = LengthUnits::fromBaseFactor(LengthUnits::Meters);
+constexpr double kilowattsPerMeterToBase = FirelineIntensityUnits::toBaseFactor(FirelineIntensityUnits::KilowattsPerMeter);
+constexpr double densityToKilogramsPerCubicMeter = DensityUnits::fromBaseFactor(DensityUnits::KilogramsPerCubicMeter);
+constexpr double metersPerMinuteToBase = SpeedUnits::toBaseFactor(SpeedUnits::MetersPerMinute);
+
+BEHAVE_OFFLOAD_BEGIN_DECLARE_TARGET
+
+// Crown::doCrownRunRothermel() from the surface run on, term for term
+void calculateCrownCell(const SurfaceKernelFuelModel& crownFuelModel, const SurfaceKernelInputs& surfaceInputs,
+    double firelineIntensity, double windSpeedAtTwentyFeet, double canopyBaseHeight, double canopyBulkDensity,
+    double moistureFoliar, CellOutputs& outputs)
+{
+    // Fuel model 10 on level ground with upslope wind and a wind adjustment factor of 0.4
+    SurfaceKernelInputs crownFuelInputs = surfaceInputs;
+    crownFuelInputs.midflameWindSpeed = 0.4 * windSpeedAtTwentyFeet;
+    crownFuelInputs.windDirection = 0.0;
+    crownFuelInputs.slope = 0.0;
+    SurfaceKernelOutputs crownFuelOutputs;
+    calculateSurfaceKernel(crownFuelModel, crownFuelInputs, crownFuelOutputs);
+    double crownFireSpreadRate = 3.34 * crownFuelOutputs.spreadRate; // Rothermel 1991
+
+    double crownCriticalFireSpreadRate = canopyBulkDensity * densityToKilogramsPerCubicMeter;
+    crownCriticalFireSpreadRate = (crownCriticalFireSpreadRate < 1e-07) ? 0.00 : (3.0 / crownCriticalFireSpreadRate);
+    crownCriticalFireSpreadRate *= metersPerMinuteToBase;
+    double crownFireActiveRatio = (crownCriticalFireSpreadRate < 1e-07)
+        ? (0.00)
+        : (crownFireSpreadRate / crownCriticalFireSpreadRate);
+
+    double moistureFoliarPercent = moistureFoliar * 100.0;
+    moistureFoliarPercent = (moistureFoliarPercent < 30.0) ? 30.0 : moistureFoliarPercent;
+    double crownBaseHeight = canopyBaseHeight * feetToMeters;
+    crownBaseHeight = (crownBaseHeight < 0.1) ? 0.1 : crownBaseHeight;
+    double crownCriticalSurfaceFirelineIntensity = pow((0.010 * crownBaseHeight * (460.0 + 25.9 * moistureFoliarPercent)), 1.5) *
+        kilowattsPerMeterToBase;
+    double crownFireTransitionRatio = (crownCriticalSurfaceFirelineIntensity < 1.0e-7)
+        ? (0.00)
+        : (firelineIntensity / crownCriticalSurfaceFirelineIntensity);
+
+    int fireType = FireType::Surface;
+    if (crownFireTransitionRatio < 1.0)
+    {
+        fireType = (crownFireActiveRatio < 1.0) ? FireType::Surface : FireType::ConditionalCrownFire;
+    }
+    else
+    {
+        fireType = (crownFireActiveRatio < 1.0) ? FireType::Torching : FireType::Crowning;
+    }
+
+    outputs.crownFireSpreadRate = crownFireSpreadRate;
+    outputs.fireType = fireType;
+    outputs.finalSpreadRate = (fireType == FireType::Crowning) ? crownFireSpreadRate : outputs.spreadRate;
+}
+
+void calculateCell(const SurfaceKernelFuelModel* fuelModelTable, const char* isBurnable, const KernelOffloadInputs& inputs,
+    bool hasCrownInputs, int cell, CellOutputs& outputs)
+{
+    outputs.spreadRate = 0.0;
+    outputs.firelineIntensity = 0.0;
+    outputs.flameLength = 0.0;
+    outputs.directionOfMaxSpread = 0.0;
+    outputs.crownFireSpreadRate = 0.0;
+    outputs.fireType = FireType::Surface;
+    outputs.finalSpreadRate = 0.0;
+
+    int fuelModelNumber = inputs.fuelModelNumber[cell];
+    if (fuelModelNumber < 0 || fuelModelNumber >= FuelConstants::MaxFuelModels || !isBurnable[fuelModelNumber])
+    {
+        return;
+    }
+
+    SurfaceKernelInputs surfaceInputs;
+    surfaceInputs.moistureOneHour = inputs.moistureOneHour[cell];
+    surfaceInputs.moistureTenHour = inputs.moistureTenHour[cell];
+    surfaceInputs.moistureHundredHour = inputs.moistureHundredHour[cell];
+    surfaceInputs.moistureLiveHerbaceous = inputs.moistureLiveHerbaceous[cell];
+    surfaceInputs.moistureLiveWoody = inputs.moistureLiveWoody[cell];
+    surfaceInputs.midflameWindSpeed = inputs.midflameWindSpeed[cell];
+    surfaceInputs.windDirection = inputs.windDirection[cell];
+    surfaceInputs.slope = inputs.slope[cell];
+    SurfaceKernelOutputs surfaceOutputs;
+    calculateSurfaceKernel(fuelModelTable[fuelModelNumber], surfaceInputs, surfaceOutputs);
+
+    outputs.spreadRate = surfaceOutputs.spreadRate;
+    outputs.firelineIntensity = surfaceOutputs.firelineIntensity;
+    outputs.flameLength = surfaceOutputs.flameLength;
+    outputs.directionOfMaxSpread = surfaceOutputs.directionOfMaxSpread;
+    outputs.finalSpreadRate = surfaceOutputs.spreadRate;
+    if (hasCrownInputs && isBurnable[10])
+    {
+        calculateCrownCell(fuelModelTable[10], surfaceInputs, surfaceOutputs.firelineIntensity, inputs.windSpeedAtTwentyFeet[cell],
+            inputs.canopyBaseHeight[cell], inputs.canopyBulkDensity[cell], inputs.moistureFoliar[cell], outputs);
+    }
+}
+
+BEHAVE_OFFLOAD_END_DECLARE_TARGET
+
+}
+
+KernelOffload::KernelOffload(const FuelModels& fuelModels)
+    : fuelModels_(&fuelModels),
+    fuelModelsRevision_(0),
+    fuelModelTable_(FuelConstants::MaxFuelModels),
+    isBurnable_(FuelConstants::MaxFuelModels, 0),
+    isUsingDevice_(false),
+    isUploaded_(false),
+    numberOfUploads_(0)
+{
+#ifdef BEHAVE_OFFLOAD
+    isUsingDevice_ = omp_get_num_devices() > 0;
+#endif
+    uploadFuelModels();
+}
+
+KernelOffload::~KernelOffload()
+{
+    releaseFuelModels();
+}
+
+bool KernelOffload::isUsingDevice() const
+{
+    return isUsingDevice_;
+}
+
+int KernelOffload::getNumberOfUploads() const
+{
+    return numberOfUploads_;
+}
+
+void KernelOffload::uploadFuelModels()
+{
+    releaseFuelModels();
+    for (int fuelModelNumber = 0; fuelModelNumber < FuelConstants::MaxFuelModels; fuelModelNumber++)
+    {
+        isBurnable_[fuelModelNumber] = SurfaceKernel::loadFuelModel(*fuelModels_, fuelModelNumber, fuelModelTable_[fuelModelNumber]);
+    }
+    fuelModelsRevision_ = fuelModels_->getRevision();
+
+    SurfaceKernelFuelModel* fuelModelTable = fuelModelTable_.data();
+    char* isBurnable = isBurnable_.data();
+    const int numberOfFuelModels = FuelConstants::MaxFuelModels;
+    // GCC doesn't count the array sections of a target data map as uses of the pointers
+    (void)fuelModelTable;
+    (void)isBurnable;
+    (void)numberOfFuelModels;
+#ifdef BEHAVE_OFFLOAD
+#pragma omp target enter data map(to: fuelModelTable[0:numberOfFuelModels], isBurnable[0:numberOfFuelModels]) if(isUsingDevice_)
+#endif
+    isUploaded_ = true;
+    numberOfUploads_++;
+}
+
+void KernelOffload::releaseFuelModels()
+{
+    if (!isUploaded_)
+    {
+        return;
+    }
+#ifdef BEHAVE_OFFLOAD
+    SurfaceKernelFuelModel* fuelModelTable = fuelModelTable_.data();
+    char* isBurnable = isBurnable_.data();
+    const int numberOfFuelModels = FuelConstants::MaxFuelModels;
+    (void)fuelModelTable;
+    (void)isBurnable;
+#pragma omp target exit data map(delete: fuelModelTable[0:numberOfFuelModels], isBurnable[0:numberOfFuelModels]) if(isUsingDevice_)
+#endif
+    isUploaded_ = false;
+}
+
+void KernelOffload::run(const KernelOffloadInputs& inputs, KernelOffloadOutputs& outputs)
+{
+    if (fuelModels_->getRevision() != fuelModelsRevision_)
+    {
+        uploadFuelModels();
+    }
+
+    const int numberOfCells = inputs.numberOfCells;
+    if (numberOfCells <= 0)
+    {
+        return;
+    }
+    const bool hasCrownInputs = inputs.windSpeedAtTwentyFeet && inputs.canopyBaseHeight && inputs.canopyBulkDensity &&
+        inputs.moistureFoliar;
+
+    // All seven outputs come back in one array of CellOutputs, so the device writes one contiguous
+    // block whichever outputs the caller asked for
+    std::vector<CellOutputs> cellOutputStorage(numberOfCells);
+    CellOutputs* cellOutputs = cellOutputStorage.data();
+    const SurfaceKernelFuelModel* fuelModelTable = fuelModelTable_.data();
+    const char* isBurnable = isBurnable_.data();
+#ifdef BEHAVE_OFFLOAD
+    // The arrays are mapped one by one and the device builds its own KernelOffloadInputs from them
+    const int* fuelModelNumber = inputs.fuelModelNumber;
+    const double* moistureOneHour = inputs.moistureOneHour;
+    const double* moistureTenHour = inputs.moistureTenHour;
+    const double* moistureHundredHour = inputs.moistureHundredHour;
+    const double* moistureLiveHerbaceous = inputs.moistureLiveHerbaceous;
+    const double* moistureLiveWoody = inputs.moistureLiveWoody;
+    const double* midflameWindSpeed = inputs.midflameWindSpeed;
+    const double* windDirection = inputs.windDirection;
+    const double* slope = inputs.slope;
+    const int numberOfCrownCells = hasCrownInputs ? numberOfCells : 0;
+    const double* windSpeedAtTwentyFeet = inputs.windSpeedAtTwentyFeet;
+    const double* canopyBaseHeight = inputs.canopyBaseHeight;
+    const double* canopyBulkDensity = inputs.canopyBulkDensity;
+    const double* moistureFoliar = inputs.moistureFoliar;
+#pragma omp target teams distribute parallel for if(isUsingDevice_) \
+    map(to: fuelModelNumber[0:numberOfCells], moistureOneHour[0:numberOfCells], moistureTenHour[0:numberOfCells], \
+        moistureHundredHour[0:numberOfCells], moistureLiveHerbaceous[0:numberOfCells], moistureLiveWoody[0:numberOfCells], \
+        midflameWindSpeed[0:numberOfCells], windDirection[0:numberOfCells], slope[0:numberOfCells], \
+        windSpeedAtTwentyFeet[0:numberOfCrownCells], canopyBaseHeight[0:numberOfCrownCells], \
+        canopyBulkDensity[0:numberOfCrownCells], moistureFoliar[0:numberOfCrownCells]) \
+    map(from: cellOutputs[0:numberOfCells])
+    for (int cell = 0; cell < numberOfCells; cell++)
+    {
+        KernelOffloadInputs deviceInputs;
+        deviceInputs.numberOfCells = numberOfCells;
+        deviceInputs.fuelModelNumber = fuelModelNumber;
+        deviceInputs.moistureOneHour = moistureOneHour;
+        deviceInputs.moistureTenHour = moistureTenHour;
+        deviceInputs.moistureHundredHour = moistureHundredHour;
+        deviceInputs.moistureLiveHerbaceous = moistureLiveHerbaceous;
+        deviceInputs.moistureLiveWoody = moistureLiveWoody;
+        deviceInputs.midflameWindSpeed = midflameWindSpeed;
+        deviceInputs.windDirection = windDirection;
+        deviceInputs.slope = slope;
+        deviceInputs.windSpeedAtTwentyFeet = windSpeedAtTwentyFeet;
+        deviceInputs.canopyBaseHeight = canopyBaseHeight;
+        deviceInputs.canopyBulkDensity = canopyBulkDensity;
+        deviceInputs.moistureFoliar = moistureFoliar;
+        calculateCell(fuelModelTable, isBurnable, deviceInputs, hasCrownInputs, cell, cellOutputs[cell]);
+    }
+#else
+    for (int cell = 0; cell < numberOfCells; cell++)
+    {
+        calculateCell(fuelModelTable, isBurnable, inputs, hasCrownInputs, cell, cellOutputs[cell]);
+    }
+#endif
+
+    for (int cell = 0; cell < numberOfCells; cell++)
+    {
+        const CellOutputs& cellOutput = cellOutputs[cell];
+        if (outputs.spreadRate)
+        {
+            outputs.spreadRate[cell] = cellOutput.spreadRate;
+        }
+        if (outputs.firelineIntensity)
+        {
+            outputs.firelineIntensity[cell] = cellOutput.firelineIntensity;
+        }
+        if (outputs.flameLength)
+        {
+            outputs.flameLength[cell] = cellOutput.flameLength;
+        }
+        if (outputs.directionOfMaxSpread)
+        {
+            outputs.directionOfMaxSpread[cell] = cellOutput.directionOfMaxSpread;
+        }
+        if (outputs.crownFireSpreadRate)
+        {
+            outputs.crownFireSpreadRate[cell] = cellOutput.crownFireSpreadRate;
+        }
+        if (outputs.fireType)
+        {
+            outputs.fireType[cell] = cellOutput.fireType;
+        }
+        if (outputs.finalSpreadRate)
+        {
+            outputs.finalSpreadRate[cell] = cellOutput.finalSpreadRate;
+        }
+    }
+}
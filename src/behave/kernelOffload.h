@@ -0,0 +1,116 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Optional OpenMP target offload of the surface and crown
+*           kernels for large batches of cells
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef KERNELOFFLOAD_H
+#define KERNELOFFLOAD_H
+
+#include <vector>
+#include "fuelModels.h"
+#include "surfaceKernel.h"
+
+// Structure-of-arrays inputs of KernelOffload::run(), each array holding numberOfCells values in
+// base units: moistures as fractions, wind speeds in ft/min, the wind direction in degrees clockwise
+// from upslope, slope in degrees, canopy base height in ft, canopy bulk density in lb/ft^3 and
+// foliar moisture as a fraction. The midflame wind speed drives the surface fire and the 20 ft
+// wind speed the crown fuel model, which takes 0.4 of it as its midflame wind. A run with any of
+// the crown arrays null is a surface only run.
+struct KernelOffloadInputs
+{
+    int numberOfCells;
+    const int* fuelModelNumber;
+    const double* moistureOneHour;
+    const double* moistureTenHour;
+    const double* moistureHundredHour;
+    const double* moistureLiveHerbaceous;
+    const double* moistureLiveWoody;
+    const double* midflameWindSpeed;
+    const double* windDirection;
+    const double* slope;
+
+    const double* windSpeedAtTwentyFeet;
+    const double* canopyBaseHeight;
+    const double* canopyBulkDensity;
+    const double* moistureFoliar;
+};
+
+// Caller-provided output arrays of KernelOffload::run(), each sized for numberOfCells values and
+// filled in base units: spread rates in ft/min, fireline intensity in btu/ft/s, flame length in ft
+// and the direction of max spread in degrees clockwise from upslope. The surface outputs are those
+// of the direction of max spread, the fire type and final spread rate those of Rothermel's crown
+// fire method. Any array may be null if that output is not needed.
+struct KernelOffloadOutputs
+{
+    double* spreadRate;
+    double* firelineIntensity;
+    double* flameLength;
+    double* directionOfMaxSpread;
+    double* crownFireSpreadRate;
+    int* fireType;      // FireType::FireTypeEnum
+    double* finalSpreadRate;
+};
+
+// Runs SurfaceKernel and Rothermel's crown fire method for a batch of cells on an OpenMP target
+// device: the fuelbed intermediates, reaction intensity, wind and slope factors, the fuel model
+// 10 crown fuel run and the fire type classification all happen on the device, one cell per
+// device thread. The fuel models are copied into a compact table of SurfaceKernelFuelModel and
+// uploaded once, then again only when the FuelModels revision changes. Built without
+// BEHAVE_OFFLOAD, or with it but no device present, the same loop runs on the host, so the host
+// build is the reference the device is checked against. The host loop matches Crown's Rothermel
+// run to a relative 1e-9. A device may contract multiplies and adds or use its own pow() and
+// exp(), so its outputs are only held to a relative 1e-6 of the host's, and the fire type may
+// differ for cells within that of a transition threshold.
+class KernelOffload
+{
+public:
+    explicit KernelOffload(const FuelModels& fuelModels);
+    ~KernelOffload();
+
+    KernelOffload(const KernelOffload& rhs) = delete;
+    KernelOffload& operator=(const KernelOffload& rhs) = delete;
+
+    void run(const KernelOffloadInputs& inputs, KernelOffloadOutputs& outputs);
+
+    // True when run() executes on a device rather than the host
+    bool isUsingDevice() const;
+    // Times the fuel model table has been uploaded, once plus once per FuelModels change seen by run()
+    int getNumberOfUploads() const;
+
+protected:
+    void uploadFuelModels();
+    void releaseFuelModels();
+
+    const FuelModels* fuelModels_;
+    unsigned long fuelModelsRevision_;
+    std::vector<SurfaceKernelFuelModel> fuelModelTable_; // FuelConstants::MaxFuelModels entries
+    std::vector<char> isBurnable_; // false for undefined and fuelless fuel models
+    bool isUsingDevice_;
+    bool isUploaded_;
+    int numberOfUploads_;
+};
+
+#endif // KERNELOFFLOAD_H
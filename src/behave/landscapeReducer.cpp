@@ -0,0 +1,280 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Summaries of a landscape run built pixel by pixel, such as
+*           zonal histograms, exceedance fractions and top values
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#include "landscapeReducer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Orders the heap so its front is the lowest ranked value
+    bool isRankedHigher(const LandscapeTopValue& lhs, const LandscapeTopValue& rhs)
+    {
+        return (lhs.value != rhs.value) ? lhs.value > rhs.value : lhs.pixel < rhs.pixel;
+    }
+}
+
+LandscapeReducer::~LandscapeReducer()
+{
+
+}
+
+double LandscapeReducer::getOutput(LandscapeReducerOutput::LandscapeReducerOutputEnum output, const LandscapePixelResult& result)
+{
+    switch(output)
+    {
+        case LandscapeReducerOutput::SpreadRate:
+            return result.spreadRate;
+        case LandscapeReducerOutput::FlameLength:
+            return result.flameLength;
+        case LandscapeReducerOutput::FirelineIntensity:
+            return result.firelineIntensity;
+        default:
+            return result.crownFractionBurned;
+    }
+}
+
+LandscapeZonalHistogram::LandscapeZonalHistogram(LandscapeReducerOutput::LandscapeReducerOutputEnum output, const int* zones,
+    int numberOfZones, double lowerBound, double binWidth, int numberOfBins)
+    : output_(output),
+    zones_(zones),
+    numberOfZones_(std::max(1, numberOfZones)),
+    lowerBound_(lowerBound),
+    binWidth_((binWidth > 0.0) ? binWidth : 1.0),
+    numberOfBins_(std::max(1, numberOfBins)),
+    counts_((size_t)numberOfZones_ * numberOfBins_, 0)
+{
+
+}
+
+void LandscapeZonalHistogram::beginRun(int numberOfSlots)
+{
+    slotCounts_.assign(std::max(1, numberOfSlots), std::vector<long>(counts_.size(), 0));
+}
+
+void LandscapeZonalHistogram::addPixel(int slot, long pixel, const LandscapePixelResult& result)
+{
+    int zone = zones_ ? zones_[pixel] : 0;
+    if(zone < 0 || zone >= numberOfZones_)
+    {
+        return;
+    }
+    double bin = floor((getOutput(output_, result) - lowerBound_) / binWidth_);
+    int clampedBin = (int)std::min(std::max(bin, 0.0), (double)(numberOfBins_ - 1));
+    slotCounts_[slot][(size_t)zone * numberOfBins_ + clampedBin]++;
+}
+
+void LandscapeZonalHistogram::endRun()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    for(const std::vector<long>& slotCounts : slotCounts_)
+    {
+        for(size_t i = 0; i < counts_.size(); i++)
+        {
+            counts_[i] += slotCounts[i];
+        }
+    }
+    slotCounts_.clear();
+}
+
+int LandscapeZonalHistogram::getNumberOfZones() const
+{
+    return numberOfZones_;
+}
+
+int LandscapeZonalHistogram::getNumberOfBins() const
+{
+    return numberOfBins_;
+}
+
+long LandscapeZonalHistogram::getCount(int zone, int bin) const
+{
+    if(zone < 0 || zone >= numberOfZones_ || bin < 0 || bin >= numberOfBins_)
+    {
+        return 0;
+    }
+    return counts_[(size_t)zone * numberOfBins_ + bin];
+}
+
+long LandscapeZonalHistogram::getNumberOfPixels(int zone) const
+{
+    long numberOfPixels = 0;
+    for(int bin = 0; bin < numberOfBins_; bin++)
+    {
+        numberOfPixels += getCount(zone, bin);
+    }
+    return numberOfPixels;
+}
+
+double LandscapeZonalHistogram::getQuantile(int zone, double fraction) const
+{
+    long numberOfPixels = getNumberOfPixels(zone);
+    if(numberOfPixels == 0)
+    {
+        return 0.0;
+    }
+    double rank = std::min(std::max(fraction, 0.0), 1.0) * numberOfPixels;
+    long countBelow = 0;
+    for(int bin = 0; bin < numberOfBins_; bin++)
+    {
+        long count = getCount(zone, bin);
+        if(count > 0 && countBelow + count >= rank)
+        {
+            return lowerBound_ + (bin + (rank - countBelow) / count) * binWidth_;
+        }
+        countBelow += count;
+    }
+    return lowerBound_ + numberOfBins_ * binWidth_;
+}
+
+LandscapeExceedanceFraction::LandscapeExceedanceFraction(LandscapeReducerOutput::LandscapeReducerOutputEnum output, double threshold,
+    const int* zones, int numberOfZones)
+    : output_(output),
+    threshold_(threshold),
+    zones_(zones),
+    numberOfZones_(std::max(1, numberOfZones)),
+    numberOfPixels_(numberOfZones_, 0),
+    numberOfExceedingPixels_(numberOfZones_, 0)
+{
+
+}
+
+void LandscapeExceedanceFraction::beginRun(int numberOfSlots)
+{
+    slotCounts_.assign(std::max(1, numberOfSlots), std::vector<long>(2 * (size_t)numberOfZones_, 0));
+}
+
+void LandscapeExceedanceFraction::addPixel(int slot, long pixel, const LandscapePixelResult& result)
+{
+    int zone = zones_ ? zones_[pixel] : 0;
+    if(zone < 0 || zone >= numberOfZones_)
+    {
+        return;
+    }
+    std::vector<long>& slotCounts = slotCounts_[slot];
+    slotCounts[zone]++;
+    if(getOutput(output_, result) > threshold_)
+    {
+        slotCounts[numberOfZones_ + zone]++;
+    }
+}
+
+void LandscapeExceedanceFraction::endRun()
+{
+    std::fill(numberOfPixels_.begin(), numberOfPixels_.end(), 0);
+    std::fill(numberOfExceedingPixels_.begin(), numberOfExceedingPixels_.end(), 0);
+    for(const std::vector<long>& slotCounts : slotCounts_)
+    {
+        for(int zone = 0; zone < numberOfZones_; zone++)
+        {
+            numberOfPixels_[zone] += slotCounts[zone];
+            numberOfExceedingPixels_[zone] += slotCounts[numberOfZones_ + zone];
+        }
+    }
+    slotCounts_.clear();
+}
+
+int LandscapeExceedanceFraction::getNumberOfZones() const
+{
+    return numberOfZones_;
+}
+
+long LandscapeExceedanceFraction::getNumberOfPixels(int zone) const
+{
+    return (zone >= 0 && zone < numberOfZones_) ? numberOfPixels_[zone] : 0;
+}
+
+long LandscapeExceedanceFraction::getNumberOfExceedingPixels(int zone) const
+{
+    return (zone >= 0 && zone < numberOfZones_) ? numberOfExceedingPixels_[zone] : 0;
+}
+
+double LandscapeExceedanceFraction::getFraction(int zone) const
+{
+    long numberOfPixels = getNumberOfPixels(zone);
+    return (numberOfPixels > 0) ? (double)getNumberOfExceedingPixels(zone) / numberOfPixels : 0.0;
+}
+
+LandscapeTopK::LandscapeTopK(LandscapeReducerOutput::LandscapeReducerOutputEnum output, int k)
+    : output_(output),
+    k_(std::max(0, k))
+{
+
+}
+
+void LandscapeTopK::beginRun(int numberOfSlots)
+{
+    slotHeaps_.assign(std::max(1, numberOfSlots), std::vector<LandscapeTopValue>());
+    for(std::vector<LandscapeTopValue>& heap : slotHeaps_)
+    {
+        heap.reserve(k_);
+    }
+}
+
+void LandscapeTopK::addPixel(int slot, long pixel, const LandscapePixelResult& result)
+{
+    if(k_ == 0)
+    {
+        return;
+    }
+    LandscapeTopValue topValue = { getOutput(output_, result), pixel };
+    std::vector<LandscapeTopValue>& heap = slotHeaps_[slot];
+    if((int)heap.size() < k_)
+    {
+        heap.push_back(topValue);
+        std::push_heap(heap.begin(), heap.end(), isRankedHigher);
+    }
+    else if(isRankedHigher(topValue, heap.front()))
+    {
+        std::pop_heap(heap.begin(), heap.end(), isRankedHigher);
+        heap.back() = topValue;
+        std::push_heap(heap.begin(), heap.end(), isRankedHigher);
+    }
+}
+
+void LandscapeTopK::endRun()
+{
+    topValues_.clear();
+    for(const std::vector<LandscapeTopValue>& heap : slotHeaps_)
+    {
+        topValues_.insert(topValues_.end(), heap.begin(), heap.end());
+    }
+    slotHeaps_.clear();
+    std::sort(topValues_.begin(), topValues_.end(), isRankedHigher);
+    if((int)topValues_.size() > k_)
+    {
+        topValues_.resize(k_);
+    }
+}
+
+const std::vector<LandscapeTopValue>& LandscapeTopK::getTopValues() const
+{
+    return topValues_;
+}
@@ -0,0 +1,162 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Summaries of a landscape run built pixel by pixel, such as
+*           zonal histograms, exceedance fractions and top values
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef LANDSCAPEREDUCER_H
+#define LANDSCAPEREDUCER_H
+
+#include <vector>
+
+// The outputs of one run pixel, in the base units of LandscapeOutputBands
+struct LandscapePixelResult
+{
+    double spreadRate;
+    double flameLength;
+    double firelineIntensity;
+    int fireType;   // FireType::FireTypeEnum
+    double crownFractionBurned;
+};
+
+struct LandscapeReducerOutput
+{
+    enum LandscapeReducerOutputEnum
+    {
+        SpreadRate,
+        FlameLength,
+        FirelineIntensity,
+        CrownFractionBurned
+    };
+};
+
+// A summary LandscapeRunner builds while it runs, so products such as the percent of a
+// planning unit over a flame length need no output rasters. Pixels are added on the
+// worker's slot, each slot keeping its own partial, and the partials are merged once
+// every tile is run. No-data pixels are never added, non-burnable pixels are added with
+// their zero outputs. A reducer is reset by every run it is added to.
+class LandscapeReducer
+{
+public:
+    virtual ~LandscapeReducer();
+
+    virtual void beginRun(int numberOfSlots) = 0;
+    virtual void addPixel(int slot, long pixel, const LandscapePixelResult& result) = 0;
+    virtual void endRun() = 0;
+
+protected:
+    static double getOutput(LandscapeReducerOutput::LandscapeReducerOutputEnum output, const LandscapePixelResult& result);
+};
+
+// Per zone histogram of one output over numberOfBins bins of binWidth from lowerBound, the
+// first and last bins also counting the values below and above. Zones are a row-major band
+// of zone numbers from 0 to numberOfZones - 1, pixels of any other zone are not counted, and
+// null zones puts every pixel in zone 0. Quantiles are read from the bins, so they are exact
+// to within one bin width whatever the number of pixels.
+class LandscapeZonalHistogram : public LandscapeReducer
+{
+public:
+    LandscapeZonalHistogram(LandscapeReducerOutput::LandscapeReducerOutputEnum output, const int* zones, int numberOfZones,
+        double lowerBound, double binWidth, int numberOfBins);
+
+    void beginRun(int numberOfSlots) override;
+    void addPixel(int slot, long pixel, const LandscapePixelResult& result) override;
+    void endRun() override;
+
+    int getNumberOfZones() const;
+    int getNumberOfBins() const;
+    long getCount(int zone, int bin) const;
+    long getNumberOfPixels(int zone) const;
+    // Value below which the fraction of the zone's pixels lies, interpolated within its bin,
+    // zero for an empty zone
+    double getQuantile(int zone, double fraction) const;
+
+protected:
+    LandscapeReducerOutput::LandscapeReducerOutputEnum output_;
+    const int* zones_;
+    int numberOfZones_;
+    double lowerBound_;
+    double binWidth_;
+    int numberOfBins_;
+    std::vector<std::vector<long>> slotCounts_; // per slot, zone * numberOfBins_ + bin
+    std::vector<long> counts_;
+};
+
+// Per zone fraction of pixels whose output is above a threshold
+class LandscapeExceedanceFraction : public LandscapeReducer
+{
+public:
+    LandscapeExceedanceFraction(LandscapeReducerOutput::LandscapeReducerOutputEnum output, double threshold, const int* zones,
+        int numberOfZones);
+
+    void beginRun(int numberOfSlots) override;
+    void addPixel(int slot, long pixel, const LandscapePixelResult& result) override;
+    void endRun() override;
+
+    int getNumberOfZones() const;
+    long getNumberOfPixels(int zone) const;
+    long getNumberOfExceedingPixels(int zone) const;
+    // Zero for an empty zone
+    double getFraction(int zone) const;
+
+protected:
+    LandscapeReducerOutput::LandscapeReducerOutputEnum output_;
+    double threshold_;
+    const int* zones_;
+    int numberOfZones_;
+    std::vector<std::vector<long>> slotCounts_; // per slot, pixels then exceeding pixels of each zone
+    std::vector<long> numberOfPixels_;
+    std::vector<long> numberOfExceedingPixels_;
+};
+
+struct LandscapeTopValue
+{
+    double value;
+    long pixel;
+};
+
+// The k pixels with the highest output, each slot keeping a bounded heap of its own k so
+// memory stays O(k) per slot. Equal values rank the lower pixel first, so the result does
+// not depend on how tiles were shared out.
+class LandscapeTopK : public LandscapeReducer
+{
+public:
+    LandscapeTopK(LandscapeReducerOutput::LandscapeReducerOutputEnum output, int k);
+
+    void beginRun(int numberOfSlots) override;
+    void addPixel(int slot, long pixel, const LandscapePixelResult& result) override;
+    void endRun() override;
+
+    // Highest first, fewer than k if fewer pixels were run
+    const std::vector<LandscapeTopValue>& getTopValues() const;
+
+protected:
+    LandscapeReducerOutput::LandscapeReducerOutputEnum output_;
+    int k_;
+    std::vector<std::vector<LandscapeTopValue>> slotHeaps_;
+    std::vector<LandscapeTopValue> topValues_;
+};
+
+#endif // LANDSCAPEREDUCER_H
@@ -0,0 +1,488 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Runs surface and crown fire behavior over aligned raster bands,
+*           tile by tile on a pool of threads
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "landscapeRunner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "landscapeReducer.h"
+#include "resultCache.h"
+#include "runControl.h"
+#include "threadPool.h"
+
+namespace
+{
+    template <typename Real>
+    bool isNoDataInBand(const BasicLandscapeBand<Real>& band, long pixel, double noDataValue)
+    {
+        return band.values && band.values[pixel] == noDataValue;
+    }
+
+    int getFuelModelNumber(const int* fuelModelNumber, long pixel)
+    {
+        return fuelModelNumber[pixel];
+    }
+
+    int getFuelModelNumber(const LandscapeQuantizedBand& fuelModelNumber, long pixel)
+    {
+        return fuelModelNumber.values ? fuelModelNumber.rawAt(pixel) : (int)fuelModelNumber.constantValue;
+    }
+
+    // Rounds a gridded band to float into storage, a constant band stays constant
+    LandscapeFloatBand toFloatBand(const LandscapeBand& band, long numberOfPixels, std::vector<float>& storage)
+    {
+        LandscapeFloatBand floatBand = { nullptr, band.constantValue };
+        if(band.values)
+        {
+            storage.assign(band.values, band.values + numberOfPixels);
+            floatBand.values = storage.data();
+        }
+        return floatBand;
+    }
+
+    double relativeDeviation(double observed, double expected)
+    {
+        double difference = fabs(observed - expected);
+        return (expected != 0.0) ? difference / fabs(expected) : difference;
+    }
+}
+
+LandscapeRunner::LandscapeRunner(const Crown& prototype)
+    : prototype_(prototype),
+    crownFireMethod_(LandscapeCrownFireMethod::ScottAndReinhardt),
+    windHeightInputMode_(WindHeightInputMode::TwentyFoot),
+    windAndSpreadOrientationMode_(WindAndSpreadOrientationMode::RelativeToNorth),
+    tileSize_(64),
+    numberOfThreads_(0),
+    runControl_(nullptr),
+    resultCache_(nullptr),
+    numberOfNoDataPixels_(0),
+    numberOfNonBurnablePixels_(0),
+    numberOfTiles_(0),
+    numberOfTilesRun_(0)
+{
+
+}
+
+void LandscapeRunner::setCrownFireMethod(LandscapeCrownFireMethod::LandscapeCrownFireMethodEnum crownFireMethod)
+{
+    crownFireMethod_ = crownFireMethod;
+}
+
+void LandscapeRunner::setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
+{
+    windHeightInputMode_ = windHeightInputMode;
+}
+
+void LandscapeRunner::setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode)
+{
+    windAndSpreadOrientationMode_ = windAndSpreadOrientationMode;
+}
+
+void LandscapeRunner::setTileSize(int tileSize)
+{
+    tileSize_ = std::max(1, tileSize);
+}
+
+void LandscapeRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+void LandscapeRunner::setRunControl(RunControl* runControl)
+{
+    runControl_ = runControl;
+}
+
+void LandscapeRunner::setResultCache(ResultCache* resultCache)
+{
+    resultCache_ = resultCache;
+}
+
+void LandscapeRunner::setSharedSurfaceCache(SharedSurfaceCache* sharedSurfaceCache)
+{
+    // Worker Crowns are copies of the prototype, which share its cache
+    prototype_.setSharedCache(sharedSurfaceCache);
+}
+
+void LandscapeRunner::addReducer(LandscapeReducer* reducer)
+{
+    if(reducer)
+    {
+        reducers_.push_back(reducer);
+    }
+}
+
+void LandscapeRunner::clearReducers()
+{
+    reducers_.clear();
+}
+
+long LandscapeRunner::getNumberOfNoDataPixels() const
+{
+    return numberOfNoDataPixels_;
+}
+
+long LandscapeRunner::getNumberOfNonBurnablePixels() const
+{
+    return numberOfNonBurnablePixels_;
+}
+
+long LandscapeRunner::getNumberOfTilesRun() const
+{
+    return numberOfTilesRun_;
+}
+
+bool LandscapeRunner::wasStopped() const
+{
+    return numberOfTilesRun_ < numberOfTiles_;
+}
+
+void LandscapeRunner::run(const LandscapeInputBands& inputs, LandscapeOutputBands& outputs)
+{
+    runBands(inputs, outputs);
+}
+
+void LandscapeRunner::run(const LandscapeFloatInputBands& inputs, LandscapeFloatOutputBands& outputs)
+{
+    runBands(inputs, outputs);
+}
+
+void LandscapeRunner::run(const LandscapeQuantizedInputBands& inputs, LandscapeOutputBands& outputs)
+{
+    runBands(inputs, outputs);
+}
+
+void LandscapeRunner::run(const LandscapeQuantizedInputBands& inputs, LandscapeFloatOutputBands& outputs)
+{
+    runBands(inputs, outputs);
+}
+
+LandscapePrecisionReport LandscapeRunner::validateFloatPrecision(const LandscapeInputBands& inputs)
+{
+    LandscapePrecisionReport report = { 0.0, 0.0, 0.0, 0.0, 0 };
+    long numberOfPixels = (long)std::max(0, inputs.numberOfRows) * std::max(0, inputs.numberOfColumns);
+
+    std::vector<double> spreadRate(numberOfPixels);
+    std::vector<double> flameLength(numberOfPixels);
+    std::vector<double> firelineIntensity(numberOfPixels);
+    std::vector<int> fireType(numberOfPixels);
+    std::vector<double> crownFractionBurned(numberOfPixels);
+    LandscapeOutputBands outputs = { inputs.noDataValue, spreadRate.data(), flameLength.data(), firelineIntensity.data(),
+        fireType.data(), crownFractionBurned.data() };
+    runBands(inputs, outputs);
+
+    const int numberOfBands = 14;
+    std::vector<std::vector<float>> storage(numberOfBands);
+    LandscapeFloatInputBands floatInputs;
+    floatInputs.numberOfRows = inputs.numberOfRows;
+    floatInputs.numberOfColumns = inputs.numberOfColumns;
+    floatInputs.noDataValue = inputs.noDataValue;
+    floatInputs.fuelModelNumber = inputs.fuelModelNumber;
+    floatInputs.slope = toFloatBand(inputs.slope, numberOfPixels, storage[0]);
+    floatInputs.aspect = toFloatBand(inputs.aspect, numberOfPixels, storage[1]);
+    floatInputs.canopyCover = toFloatBand(inputs.canopyCover, numberOfPixels, storage[2]);
+    floatInputs.canopyHeight = toFloatBand(inputs.canopyHeight, numberOfPixels, storage[3]);
+    floatInputs.canopyBaseHeight = toFloatBand(inputs.canopyBaseHeight, numberOfPixels, storage[4]);
+    floatInputs.canopyBulkDensity = toFloatBand(inputs.canopyBulkDensity, numberOfPixels, storage[5]);
+    floatInputs.windSpeed = toFloatBand(inputs.windSpeed, numberOfPixels, storage[6]);
+    floatInputs.windDirection = toFloatBand(inputs.windDirection, numberOfPixels, storage[7]);
+    floatInputs.moistureOneHour = toFloatBand(inputs.moistureOneHour, numberOfPixels, storage[8]);
+    floatInputs.moistureTenHour = toFloatBand(inputs.moistureTenHour, numberOfPixels, storage[9]);
+    floatInputs.moistureHundredHour = toFloatBand(inputs.moistureHundredHour, numberOfPixels, storage[10]);
+    floatInputs.moistureLiveHerbaceous = toFloatBand(inputs.moistureLiveHerbaceous, numberOfPixels, storage[11]);
+    floatInputs.moistureLiveWoody = toFloatBand(inputs.moistureLiveWoody, numberOfPixels, storage[12]);
+    floatInputs.moistureFoliar = toFloatBand(inputs.moistureFoliar, numberOfPixels, storage[13]);
+
+    std::vector<float> floatSpreadRate(numberOfPixels);
+    std::vector<float> floatFlameLength(numberOfPixels);
+    std::vector<float> floatFirelineIntensity(numberOfPixels);
+    std::vector<int> floatFireType(numberOfPixels);
+    std::vector<float> floatCrownFractionBurned(numberOfPixels);
+    LandscapeFloatOutputBands floatOutputs = { inputs.noDataValue, floatSpreadRate.data(), floatFlameLength.data(),
+        floatFirelineIntensity.data(), floatFireType.data(), floatCrownFractionBurned.data() };
+    runBands(floatInputs, floatOutputs);
+
+    for(long pixel = 0; pixel < numberOfPixels; pixel++)
+    {
+        if(isNoDataPixel(inputs, pixel) || isNoDataPixel(floatInputs, pixel))
+        {
+            continue;
+        }
+        report.spreadRate = std::max(report.spreadRate, relativeDeviation(floatSpreadRate[pixel], spreadRate[pixel]));
+        report.flameLength = std::max(report.flameLength, relativeDeviation(floatFlameLength[pixel], flameLength[pixel]));
+        report.firelineIntensity = std::max(report.firelineIntensity,
+            relativeDeviation(floatFirelineIntensity[pixel], firelineIntensity[pixel]));
+        report.crownFractionBurned = std::max(report.crownFractionBurned,
+            relativeDeviation(floatCrownFractionBurned[pixel], crownFractionBurned[pixel]));
+        report.numberOfFireTypeMismatches += (floatFireType[pixel] != fireType[pixel]);
+    }
+    return report;
+}
+
+template <typename InputBands, typename Real>
+void LandscapeRunner::runBands(const InputBands& inputs, BasicLandscapeOutputBands<Real>& outputs)
+{
+    numberOfNoDataPixels_ = 0;
+    numberOfNonBurnablePixels_ = 0;
+    numberOfTiles_ = 0;
+    numberOfTilesRun_ = 0;
+    if(inputs.numberOfRows <= 0 || inputs.numberOfColumns <= 0)
+    {
+        for(LandscapeReducer* reducer : reducers_)
+        {
+            reducer->beginRun(1);
+            reducer->endRun();
+        }
+        return;
+    }
+
+    long tilesDown = (inputs.numberOfRows + tileSize_ - 1) / tileSize_;
+    long tilesAcross = (inputs.numberOfColumns + tileSize_ - 1) / tileSize_;
+    long numberOfTiles = tilesDown * tilesAcross;
+    numberOfTiles_ = numberOfTiles;
+    if(runControl_)
+    {
+        runControl_->beginWork(numberOfTiles);
+    }
+
+    // Each worker's Crown copy is made on the worker's own thread, so its caches are allocated there
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots((int)std::min<long>(numberOfTiles, (numberOfThreads_ > 0) ?
+        numberOfThreads_ : numberOfTiles));
+    std::vector<std::unique_ptr<Crown>> workers(numberOfSlots);
+    threadPool->runOnEachSlot([&](int slot)
+    {
+        workers[slot].reset(new Crown(prototype_));
+    }, numberOfSlots);
+    std::vector<long> noDataPixels(workers.size(), 0);
+    std::vector<long> nonBurnablePixels(workers.size(), 0);
+    std::vector<long> tilesRun(workers.size(), 0);
+    for(LandscapeReducer* reducer : reducers_)
+    {
+        reducer->beginRun(numberOfSlots);
+    }
+
+    threadPool->runChunks(numberOfTiles, 1, [&](int slot, long begin, long end)
+    {
+        for(long tile = begin; tile < end; tile++)
+        {
+            if(runControl_ && runControl_->isStopRequested())
+            {
+                return;
+            }
+            runTile(*workers[slot], slot, inputs, outputs, tile, noDataPixels[slot], nonBurnablePixels[slot]);
+            tilesRun[slot]++;
+            if(runControl_)
+            {
+                runControl_->addWorkDone(1);
+            }
+        }
+    }, numberOfSlots);
+
+    for(size_t slot = 0; slot < workers.size(); slot++)
+    {
+        numberOfNoDataPixels_ += noDataPixels[slot];
+        numberOfNonBurnablePixels_ += nonBurnablePixels[slot];
+        numberOfTilesRun_ += tilesRun[slot];
+    }
+    for(LandscapeReducer* reducer : reducers_)
+    {
+        reducer->endRun();
+    }
+}
+
+template <typename Real>
+bool LandscapeRunner::isNoDataPixel(const BasicLandscapeInputBands<Real>& inputs, long pixel) const
+{
+    const double noDataValue = inputs.noDataValue;
+    return inputs.fuelModelNumber[pixel] == noDataValue ||
+        isNoDataInBand(inputs.slope, pixel, noDataValue) ||
+        isNoDataInBand(inputs.aspect, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyCover, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyHeight, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyBaseHeight, pixel, noDataValue) ||
+        isNoDataInBand(inputs.canopyBulkDensity, pixel, noDataValue) ||
+        isNoDataInBand(inputs.windSpeed, pixel, noDataValue) ||
+        isNoDataInBand(inputs.windDirection, pixel, noDataValue) ||
+        isNoDataInBand(inputs.moistureOneHour, pixel, noDataValue) ||
+        isNoDataInBand(inputs.moistureTenHour, pixel, noDataValue) ||
+        isNoDataInBand(inputs.moistureHundredHour, pixel, noDataValue) ||
+        isNoDataInBand(inputs.moistureLiveHerbaceous, pixel, noDataValue) ||
+        isNoDataInBand(inputs.moistureLiveWoody, pixel, noDataValue) ||
+        isNoDataInBand(inputs.moistureFoliar, pixel, noDataValue);
+}
+
+bool LandscapeRunner::isNoDataPixel(const LandscapeQuantizedInputBands& inputs, long pixel) const
+{
+    return inputs.fuelModelNumber.isNoData(pixel) ||
+        inputs.slope.isNoData(pixel) ||
+        inputs.aspect.isNoData(pixel) ||
+        inputs.canopyCover.isNoData(pixel) ||
+        inputs.canopyHeight.isNoData(pixel) ||
+        inputs.canopyBaseHeight.isNoData(pixel) ||
+        inputs.canopyBulkDensity.isNoData(pixel) ||
+        inputs.windSpeed.isNoData(pixel) ||
+        inputs.windDirection.isNoData(pixel) ||
+        inputs.moistureOneHour.isNoData(pixel) ||
+        inputs.moistureTenHour.isNoData(pixel) ||
+        inputs.moistureHundredHour.isNoData(pixel) ||
+        inputs.moistureLiveHerbaceous.isNoData(pixel) ||
+        inputs.moistureLiveWoody.isNoData(pixel) ||
+        inputs.moistureFoliar.isNoData(pixel);
+}
+
+template <typename InputBands, typename Real>
+void LandscapeRunner::runTile(Crown& crown, int slot, const InputBands& inputs, BasicLandscapeOutputBands<Real>& outputs, long tile,
+    long& numberOfNoDataPixels, long& numberOfNonBurnablePixels) const
+{
+    long tilesAcross = (inputs.numberOfColumns + tileSize_ - 1) / tileSize_;
+    int rowBegin = (int)(tile / tilesAcross) * tileSize_;
+    int columnBegin = (int)(tile % tilesAcross) * tileSize_;
+    int rowEnd = std::min(rowBegin + tileSize_, inputs.numberOfRows);
+    int columnEnd = std::min(columnBegin + tileSize_, inputs.numberOfColumns);
+
+    for(int row = rowBegin; row < rowEnd; row++)
+    {
+        for(int column = columnBegin; column < columnEnd; column++)
+        {
+            long pixel = (long)row * inputs.numberOfColumns + column;
+            int fuelModelNumber = getFuelModelNumber(inputs.fuelModelNumber, pixel);
+
+            double spreadRate = 0.0;
+            double flameLength = 0.0;
+            double firelineIntensity = 0.0;
+            int fireType = FireType::Surface;
+            double crownFractionBurned = 0.0;
+
+            bool isNoData = isNoDataPixel(inputs, pixel);
+            if(isNoData)
+            {
+                numberOfNoDataPixels++;
+                spreadRate = flameLength = firelineIntensity = crownFractionBurned = outputs.noDataValue;
+                fireType = (int)outputs.noDataValue;
+            }
+            else if(!crown.isFuelModelDefined(fuelModelNumber) || crown.isAllFuelLoadZero(fuelModelNumber))
+            {
+                // Nothing to burn, leave the zero outputs without running Crown
+                numberOfNonBurnablePixels++;
+            }
+            else
+            {
+                double canopyHeight = inputs.canopyHeight.at(pixel);
+                double canopyBaseHeight = inputs.canopyBaseHeight.at(pixel);
+                double crownRatio = (canopyHeight > 0.0) ? (canopyHeight - canopyBaseHeight) / canopyHeight : 0.0;
+
+                crown.updateCrownInputs(fuelModelNumber, inputs.moistureOneHour.at(pixel), inputs.moistureTenHour.at(pixel),
+                    inputs.moistureHundredHour.at(pixel), inputs.moistureLiveHerbaceous.at(pixel), inputs.moistureLiveWoody.at(pixel),
+                    inputs.moistureFoliar.at(pixel), FractionUnits::Fraction, inputs.windSpeed.at(pixel), SpeedUnits::FeetPerMinute,
+                    windHeightInputMode_, inputs.windDirection.at(pixel), windAndSpreadOrientationMode_, inputs.slope.at(pixel),
+                    SlopeUnits::Degrees, inputs.aspect.at(pixel), inputs.canopyCover.at(pixel), FractionUnits::Fraction,
+                    canopyHeight, canopyBaseHeight, LengthUnits::Feet, crownRatio, FractionUnits::Fraction,
+                    inputs.canopyBulkDensity.at(pixel), DensityUnits::PoundsPerCubicFoot);
+
+                ResultCacheKey key = {};
+                ResultCacheRecord record;
+                bool isCached = false;
+                if(resultCache_)
+                {
+                    ResultCacheKeyBuilder keyBuilder;
+                    keyBuilder.addCrownRun(crown, crownFireMethod_, windAndSpreadOrientationMode_);
+                    key = keyBuilder.getKey();
+                    isCached = resultCache_->find(key, record) && record.numberOfValues == ResultCacheRecord::NumberOfCrownRunValues;
+                }
+
+                if(isCached)
+                {
+                    spreadRate = record.values[0];
+                    flameLength = record.values[1];
+                    firelineIntensity = record.values[2];
+                    fireType = (int)record.values[3];
+                    crownFractionBurned = record.values[4];
+                }
+                else
+                {
+                    if(crownFireMethod_ == LandscapeCrownFireMethod::Rothermel)
+                    {
+                        crown.doCrownRunRothermel();
+                    }
+                    else
+                    {
+                        crown.doCrownRunScottAndReinhardt();
+                    }
+
+                    spreadRate = crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+                    flameLength = crown.getFinalFlameLength(LengthUnits::Feet);
+                    firelineIntensity = crown.getFinalFirelineIntesity(FirelineIntensityUnits::BtusPerFootPerSecond);
+                    fireType = crown.getFireType();
+                    crownFractionBurned = crown.getCrownFractionBurned();
+                    if(resultCache_)
+                    {
+                        ResultCacheRecord computed = { ResultCacheRecord::NumberOfCrownRunValues,
+                            { spreadRate, flameLength, firelineIntensity, (double)fireType, crownFractionBurned } };
+                        resultCache_->insert(key, computed);
+                    }
+                }
+            }
+
+            if(!isNoData && !reducers_.empty())
+            {
+                LandscapePixelResult result = { spreadRate, flameLength, firelineIntensity, fireType, crownFractionBurned };
+                for(LandscapeReducer* reducer : reducers_)
+                {
+                    reducer->addPixel(slot, pixel, result);
+                }
+            }
+
+            if(outputs.spreadRate)
+            {
+                outputs.spreadRate[pixel] = (Real)spreadRate;
+            }
+            if(outputs.flameLength)
+            {
+                outputs.flameLength[pixel] = (Real)flameLength;
+            }
+            if(outputs.firelineIntensity)
+            {
+                outputs.firelineIntensity[pixel] = (Real)firelineIntensity;
+            }
+            if(outputs.fireType)
+            {
+                outputs.fireType[pixel] = fireType;
+            }
+            if(outputs.crownFractionBurned)
+            {
+                outputs.crownFractionBurned[pixel] = (Real)crownFractionBurned;
+            }
+        }
+    }
+}
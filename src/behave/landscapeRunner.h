@@ -0,0 +1,292 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Runs surface and crown fire behavior over aligned raster bands,
+*           tile by tile on a pool of threads
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef LANDSCAPERUNNER_H
+#define LANDSCAPERUNNER_H
+
+#include <vector>
+
+#include "crown.h"
+
+class LandscapeReducer;
+class ResultCache;
+class RunControl;
+class SharedSurfaceCache;
+
+// One input raster band for LandscapeRunner, row-major with numberOfRows * numberOfColumns
+// values. A band with null values uses constantValue for every pixel, which suits inputs
+// such as foliar moisture that are often not gridded. Bands are stored as Real, double or
+// float, and widened to double for the fire behavior calculations.
+template <typename Real>
+struct BasicLandscapeBand
+{
+    const Real* values;
+    double constantValue;
+
+    double at(long pixel) const
+    {
+        return values ? values[pixel] : constantValue;
+    }
+};
+
+typedef BasicLandscapeBand<double> LandscapeBand;
+typedef BasicLandscapeBand<float> LandscapeFloatBand;
+
+// Aligned input bands for LandscapeRunner::run(), in base units: moistures, canopy cover
+// as fractions, slope and aspect in degrees, wind speed in ft/min at the runner's wind
+// height, canopy heights in ft and canopy bulk density in lb/ft^3. A pixel is no-data if
+// its fuel model or any gridded value equals noDataValue. Float band values are widened to
+// double before the comparison, so their noDataValue must be exactly representable as a float.
+template <typename Real>
+struct BasicLandscapeInputBands
+{
+    int numberOfRows;
+    int numberOfColumns;
+    double noDataValue;
+
+    const int* fuelModelNumber;
+    BasicLandscapeBand<Real> slope;
+    BasicLandscapeBand<Real> aspect;
+    BasicLandscapeBand<Real> canopyCover;
+    BasicLandscapeBand<Real> canopyHeight;
+    BasicLandscapeBand<Real> canopyBaseHeight;
+    BasicLandscapeBand<Real> canopyBulkDensity;
+
+    BasicLandscapeBand<Real> windSpeed;
+    BasicLandscapeBand<Real> windDirection;
+    BasicLandscapeBand<Real> moistureOneHour;
+    BasicLandscapeBand<Real> moistureTenHour;
+    BasicLandscapeBand<Real> moistureHundredHour;
+    BasicLandscapeBand<Real> moistureLiveHerbaceous;
+    BasicLandscapeBand<Real> moistureLiveWoody;
+    BasicLandscapeBand<Real> moistureFoliar;
+};
+
+typedef BasicLandscapeInputBands<double> LandscapeInputBands;
+typedef BasicLandscapeInputBands<float> LandscapeFloatInputBands;
+
+// Storage type of a LandscapeQuantizedBand's raw values
+struct LandscapeBandDataType
+{
+    enum LandscapeBandDataTypeEnum
+    {
+        UInt8,
+        Int8,
+        UInt16,
+        Int16,
+        Int32
+    };
+};
+
+// One input raster band kept in the compact integer type it is delivered in, such as a
+// LANDFIRE band of canopy cover in percent or canopy base height in tenths of meters. Each
+// raw value is converted to base units as raw * scale + offset when the pixel is run, so
+// the raster is never widened to double. A band with null values uses constantValue, given
+// in base units, for every pixel. When hasNoDataValue is set, a pixel whose raw value equals
+// noDataValue is no-data.
+struct LandscapeQuantizedBand
+{
+    LandscapeBandDataType::LandscapeBandDataTypeEnum dataType;
+    const void* values;
+    double scale;
+    double offset;
+    bool hasNoDataValue;
+    int noDataValue;
+    double constantValue;
+
+    int rawAt(long pixel) const
+    {
+        switch(dataType)
+        {
+            case LandscapeBandDataType::UInt8:
+                return ((const unsigned char*)values)[pixel];
+            case LandscapeBandDataType::Int8:
+                return ((const signed char*)values)[pixel];
+            case LandscapeBandDataType::UInt16:
+                return ((const unsigned short*)values)[pixel];
+            case LandscapeBandDataType::Int16:
+                return ((const short*)values)[pixel];
+            default:
+                return ((const int*)values)[pixel];
+        }
+    }
+
+    double at(long pixel) const
+    {
+        return values ? rawAt(pixel) * scale + offset : constantValue;
+    }
+
+    bool isNoData(long pixel) const
+    {
+        return values && hasNoDataValue && rawAt(pixel) == noDataValue;
+    }
+};
+
+// Aligned quantized input bands for LandscapeRunner::run(), whose scales and offsets map
+// every band to the base units of LandscapeInputBands. The fuel model band holds the fuel
+// model codes themselves, its scale and offset are not used. No-data is taken from each
+// band's own noDataValue.
+struct LandscapeQuantizedInputBands
+{
+    int numberOfRows;
+    int numberOfColumns;
+
+    LandscapeQuantizedBand fuelModelNumber;
+    LandscapeQuantizedBand slope;
+    LandscapeQuantizedBand aspect;
+    LandscapeQuantizedBand canopyCover;
+    LandscapeQuantizedBand canopyHeight;
+    LandscapeQuantizedBand canopyBaseHeight;
+    LandscapeQuantizedBand canopyBulkDensity;
+
+    LandscapeQuantizedBand windSpeed;
+    LandscapeQuantizedBand windDirection;
+    LandscapeQuantizedBand moistureOneHour;
+    LandscapeQuantizedBand moistureTenHour;
+    LandscapeQuantizedBand moistureHundredHour;
+    LandscapeQuantizedBand moistureLiveHerbaceous;
+    LandscapeQuantizedBand moistureLiveWoody;
+    LandscapeQuantizedBand moistureFoliar;
+};
+
+// Caller-provided output bands, each sized for numberOfRows * numberOfColumns values and
+// filled in base units: spread rate in ft/min, flame length in ft, fireline intensity in
+// btu/ft/s. Any band may be null if that output is not needed. No-data pixels are set to
+// noDataValue, non-burnable pixels to zero spread with a surface fire type.
+template <typename Real>
+struct BasicLandscapeOutputBands
+{
+    double noDataValue;
+
+    Real* spreadRate;
+    Real* flameLength;
+    Real* firelineIntensity;
+    int* fireType;      // FireType::FireTypeEnum
+    Real* crownFractionBurned;
+};
+
+typedef BasicLandscapeOutputBands<double> LandscapeOutputBands;
+typedef BasicLandscapeOutputBands<float> LandscapeFloatOutputBands;
+
+// Largest relative deviation of each output of a float run from the double run of the same
+// inputs, over the pixels both runs burned, |float - double| / |double| or the absolute
+// difference where the double output is zero
+struct LandscapePrecisionReport
+{
+    double spreadRate;
+    double flameLength;
+    double firelineIntensity;
+    double crownFractionBurned;
+    long numberOfFireTypeMismatches;
+};
+
+struct LandscapeCrownFireMethod
+{
+    enum LandscapeCrownFireMethodEnum
+    {
+        Rothermel,
+        ScottAndReinhardt
+    };
+};
+
+// Runs Crown, which includes its Surface run, for every pixel of a landscape. The raster
+// is cut into square tiles so each worker walks a small block of every band at a time,
+// and the tiles are shared out over a ThreadPool. Every worker runs on its own copy of
+// the prototype Crown, so inputs that are not gridded, such as the wind adjustment factor
+// method, are set on the prototype before calling run(). All copies share the prototype's
+// FuelModels, which must not change during the run. Bands can be double or float, halving the
+// memory of large rasters, or quantized integer bands converted pixel by pixel in the tile
+// loop, either way every pixel is calculated in double.
+class LandscapeRunner
+{
+public:
+    explicit LandscapeRunner(const Crown& prototype);
+
+    void setCrownFireMethod(LandscapeCrownFireMethod::LandscapeCrownFireMethodEnum crownFireMethod);
+    void setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode);
+    void setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode);
+    void setTileSize(int tileSize);
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+    // Token polled before every tile and counting tiles as work, null for none. Once it
+    // stops a run the remaining tiles are skipped and their output pixels left unchanged
+    void setRunControl(RunControl* runControl);
+    // Cache looked up before every burnable pixel's Crown run and filled with the runs it misses,
+    // null for none. It must outlive the run and is shared by all the workers.
+    void setResultCache(ResultCache* resultCache);
+    // Fuelbed and wind adjustment factor cache all the workers' Crowns share, so the pool warms
+    // one cache rather than one per worker, null for none. It must outlive the runs
+    void setSharedSurfaceCache(SharedSurfaceCache* sharedSurfaceCache);
+    // Reducers fed every pixel of every run, which must outlive the runs. With reducers the
+    // output bands may all be null, so a summary takes no rasters
+    void addReducer(LandscapeReducer* reducer);
+    void clearReducers();
+
+    void run(const LandscapeInputBands& inputs, LandscapeOutputBands& outputs);
+    void run(const LandscapeFloatInputBands& inputs, LandscapeFloatOutputBands& outputs);
+    void run(const LandscapeQuantizedInputBands& inputs, LandscapeOutputBands& outputs);
+    void run(const LandscapeQuantizedInputBands& inputs, LandscapeFloatOutputBands& outputs);
+
+    // Runs the landscape with double bands, then again with the bands rounded to float, and
+    // reports how far the float outputs are from the double ones
+    LandscapePrecisionReport validateFloatPrecision(const LandscapeInputBands& inputs);
+
+    // Pixels skipped on the last run() without calling Crown
+    long getNumberOfNoDataPixels() const;
+    long getNumberOfNonBurnablePixels() const;
+    // Tiles calculated on the last run(), fewer than the whole raster if it was stopped
+    long getNumberOfTilesRun() const;
+    bool wasStopped() const;
+
+protected:
+    template <typename InputBands, typename Real>
+    void runBands(const InputBands& inputs, BasicLandscapeOutputBands<Real>& outputs);
+    template <typename Real>
+    bool isNoDataPixel(const BasicLandscapeInputBands<Real>& inputs, long pixel) const;
+    bool isNoDataPixel(const LandscapeQuantizedInputBands& inputs, long pixel) const;
+    template <typename InputBands, typename Real>
+    void runTile(Crown& crown, int slot, const InputBands& inputs, BasicLandscapeOutputBands<Real>& outputs, long tile,
+        long& numberOfNoDataPixels, long& numberOfNonBurnablePixels) const;
+
+    Crown prototype_;
+    LandscapeCrownFireMethod::LandscapeCrownFireMethodEnum crownFireMethod_;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode_;
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode_;
+    int tileSize_;
+    int numberOfThreads_;
+    RunControl* runControl_;
+    ResultCache* resultCache_;
+    std::vector<LandscapeReducer*> reducers_;
+
+    long numberOfNoDataPixels_;
+    long numberOfNonBurnablePixels_;
+    long numberOfTiles_;
+    long numberOfTilesRun_;
+};
+
+#endif // LANDSCAPERUNNER_H
@@ -0,0 +1,459 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Landscape runs split into tiles that any number of workers
+*           can run, checkpoint and merge
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "landscapeTileRunner.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "columnarFile.h"
+#include "runControl.h"
+
+namespace
+{
+    // The bands of LandscapeInputBands other than the fuel model, in the order of the tile storage
+    LandscapeBand LandscapeInputBands::* const inputBands[] =
+    {
+        &LandscapeInputBands::slope,
+        &LandscapeInputBands::aspect,
+        &LandscapeInputBands::canopyCover,
+        &LandscapeInputBands::canopyHeight,
+        &LandscapeInputBands::canopyBaseHeight,
+        &LandscapeInputBands::canopyBulkDensity,
+        &LandscapeInputBands::windSpeed,
+        &LandscapeInputBands::windDirection,
+        &LandscapeInputBands::moistureOneHour,
+        &LandscapeInputBands::moistureTenHour,
+        &LandscapeInputBands::moistureHundredHour,
+        &LandscapeInputBands::moistureLiveHerbaceous,
+        &LandscapeInputBands::moistureLiveWoody,
+        &LandscapeInputBands::moistureFoliar
+    };
+
+    const char* const spreadRateColumn = "SPREAD_RATE";
+    const char* const flameLengthColumn = "FLAME_LENGTH";
+    const char* const firelineIntensityColumn = "FIRELINE_INTENSITY";
+    const char* const fireTypeColumn = "FIRE_TYPE";
+    const char* const crownFractionBurnedColumn = "CROWN_FRACTION_BURNED";
+
+    bool isFileReadable(const std::string& fileName)
+    {
+        FILE* file = fopen(fileName.c_str(), "rb");
+        if(file)
+        {
+            fclose(file);
+            return true;
+        }
+        return false;
+    }
+
+    // Copies one band of a tile's core out of a tile file into a raster band, nothing if the band is null
+    template <typename Value>
+    bool readTileColumn(ColumnarReader& reader, const char* name, const LandscapeTile& tile, int numberOfColumns, Value* band)
+    {
+        if(!band)
+        {
+            return true;
+        }
+        std::vector<double> values;
+        int column = reader.getColumnIndex(name);
+        if(column < 0 || !reader.readColumn(column, values))
+        {
+            return false;
+        }
+        size_t value = 0;
+        for(int row = tile.rowBegin; row < tile.rowEnd; row++)
+        {
+            for(int pixelColumn = tile.columnBegin; pixelColumn < tile.columnEnd; pixelColumn++)
+            {
+                band[(long)row * numberOfColumns + pixelColumn] = (Value)values[value++];
+            }
+        }
+        return true;
+    }
+}
+
+LandscapeTiling::LandscapeTiling(int numberOfRows, int numberOfColumns, int tileSize, int haloWidth)
+    : numberOfRows_(std::max(0, numberOfRows)),
+    numberOfColumns_(std::max(0, numberOfColumns)),
+    tileSize_(std::max(1, tileSize)),
+    haloWidth_(std::max(0, haloWidth))
+{
+    tilesAcross_ = (numberOfColumns_ + tileSize_ - 1) / tileSize_;
+    tilesDown_ = (numberOfRows_ + tileSize_ - 1) / tileSize_;
+}
+
+int LandscapeTiling::getNumberOfRows() const
+{
+    return numberOfRows_;
+}
+
+int LandscapeTiling::getNumberOfColumns() const
+{
+    return numberOfColumns_;
+}
+
+int LandscapeTiling::getTileSize() const
+{
+    return tileSize_;
+}
+
+int LandscapeTiling::getHaloWidth() const
+{
+    return haloWidth_;
+}
+
+int LandscapeTiling::getNumberOfTiles() const
+{
+    return tilesAcross_ * tilesDown_;
+}
+
+LandscapeTile LandscapeTiling::getTile(int index) const
+{
+    LandscapeTile tile;
+    tile.index = index;
+    tile.rowBegin = (index / tilesAcross_) * tileSize_;
+    tile.columnBegin = (index % tilesAcross_) * tileSize_;
+    tile.rowEnd = std::min(tile.rowBegin + tileSize_, numberOfRows_);
+    tile.columnEnd = std::min(tile.columnBegin + tileSize_, numberOfColumns_);
+    tile.haloRowBegin = std::max(tile.rowBegin - haloWidth_, 0);
+    tile.haloRowEnd = std::min(tile.rowEnd + haloWidth_, numberOfRows_);
+    tile.haloColumnBegin = std::max(tile.columnBegin - haloWidth_, 0);
+    tile.haloColumnEnd = std::min(tile.columnEnd + haloWidth_, numberOfColumns_);
+    return tile;
+}
+
+std::vector<int> LandscapeTiling::getTilesOfWorker(int worker, int numberOfWorkers) const
+{
+    std::vector<int> tiles;
+    numberOfWorkers = std::max(1, numberOfWorkers);
+    for(int tile = std::max(0, worker); tile < getNumberOfTiles(); tile += numberOfWorkers)
+    {
+        tiles.push_back(tile);
+    }
+    return tiles;
+}
+
+LandscapeTileInputs::LandscapeTileInputs()
+{
+    inputs_ = LandscapeInputBands();
+}
+
+void LandscapeTileInputs::extract(const LandscapeInputBands& inputs, const LandscapeTile& tile)
+{
+    const int numberOfRows = tile.haloRowEnd - tile.haloRowBegin;
+    const int numberOfColumns = tile.haloColumnEnd - tile.haloColumnBegin;
+    inputs_ = inputs;
+    inputs_.numberOfRows = numberOfRows;
+    inputs_.numberOfColumns = numberOfColumns;
+
+    fuelModelNumber_.resize((size_t)numberOfRows * numberOfColumns);
+    for(int row = 0; row < numberOfRows; row++)
+    {
+        const int* source = inputs.fuelModelNumber + (long)(tile.haloRowBegin + row) * inputs.numberOfColumns + tile.haloColumnBegin;
+        std::copy(source, source + numberOfColumns, fuelModelNumber_.begin() + (long)row * numberOfColumns);
+    }
+    inputs_.fuelModelNumber = fuelModelNumber_.data();
+
+    for(int band = 0; band < NumberOfBands; band++)
+    {
+        const LandscapeBand& source = inputs.*inputBands[band];
+        if(!source.values)
+        {
+            bands_[band].clear();
+            continue;
+        }
+        bands_[band].resize((size_t)numberOfRows * numberOfColumns);
+        for(int row = 0; row < numberOfRows; row++)
+        {
+            const double* sourceRow = source.values + (long)(tile.haloRowBegin + row) * inputs.numberOfColumns + tile.haloColumnBegin;
+            std::copy(sourceRow, sourceRow + numberOfColumns, bands_[band].begin() + (long)row * numberOfColumns);
+        }
+        (inputs_.*inputBands[band]).values = bands_[band].data();
+    }
+}
+
+const LandscapeInputBands& LandscapeTileInputs::getInputs() const
+{
+    return inputs_;
+}
+
+LandscapeTileRunner::LandscapeTileRunner(const Crown& prototype, const std::string& outputPrefix)
+    : prototype_(prototype),
+    outputPrefix_(outputPrefix),
+    crownFireMethod_(LandscapeCrownFireMethod::ScottAndReinhardt),
+    windHeightInputMode_(WindHeightInputMode::TwentyFoot),
+    windAndSpreadOrientationMode_(WindAndSpreadOrientationMode::RelativeToNorth),
+    tileSize_(512),
+    numberOfThreads_(0),
+    isCompressed_(true),
+    dispatchMode_(LandscapeTileDispatchMode::Partition),
+    worker_(0),
+    numberOfWorkers_(1),
+    runControl_(nullptr),
+    numberOfTilesRun_(0),
+    numberOfTilesSkipped_(0)
+{
+
+}
+
+void LandscapeTileRunner::setCrownFireMethod(LandscapeCrownFireMethod::LandscapeCrownFireMethodEnum crownFireMethod)
+{
+    crownFireMethod_ = crownFireMethod;
+}
+
+void LandscapeTileRunner::setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
+{
+    windHeightInputMode_ = windHeightInputMode;
+}
+
+void LandscapeTileRunner::setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode)
+{
+    windAndSpreadOrientationMode_ = windAndSpreadOrientationMode;
+}
+
+void LandscapeTileRunner::setTileSize(int tileSize)
+{
+    tileSize_ = std::max(1, tileSize);
+}
+
+void LandscapeTileRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+void LandscapeTileRunner::setIsCompressed(bool isCompressed)
+{
+    isCompressed_ = isCompressed;
+}
+
+void LandscapeTileRunner::setDispatchMode(LandscapeTileDispatchMode::LandscapeTileDispatchModeEnum dispatchMode)
+{
+    dispatchMode_ = dispatchMode;
+}
+
+void LandscapeTileRunner::setWorker(int worker, int numberOfWorkers)
+{
+    worker_ = worker;
+    numberOfWorkers_ = std::max(1, numberOfWorkers);
+}
+
+void LandscapeTileRunner::setRunControl(RunControl* runControl)
+{
+    runControl_ = runControl;
+}
+
+long LandscapeTileRunner::getNumberOfTilesRun() const
+{
+    return numberOfTilesRun_;
+}
+
+long LandscapeTileRunner::getNumberOfTilesSkipped() const
+{
+    return numberOfTilesSkipped_;
+}
+
+std::string LandscapeTileRunner::getTileFileName(int tile) const
+{
+    return outputPrefix_ + "tile_" + std::to_string(tile) + ".bcol";
+}
+
+std::string LandscapeTileRunner::getClaimFileName(int tile) const
+{
+    return outputPrefix_ + "tile_" + std::to_string(tile) + ".claim";
+}
+
+bool LandscapeTileRunner::isTileDone(int tile) const
+{
+    return isFileReadable(getTileFileName(tile));
+}
+
+bool LandscapeTileRunner::areAllTilesDone(int numberOfRows, int numberOfColumns) const
+{
+    LandscapeTiling tiling(numberOfRows, numberOfColumns, tileSize_, 0);
+    for(int tile = 0; tile < tiling.getNumberOfTiles(); tile++)
+    {
+        if(!isTileDone(tile))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LandscapeTileRunner::claimTile(int tile) const
+{
+    // Creating the claim file fails if it exists, so only one worker gets each tile
+    FILE* claim = fopen(getClaimFileName(tile).c_str(), "wx");
+    if(!claim)
+    {
+        return false;
+    }
+    fclose(claim);
+    return true;
+}
+
+int LandscapeTileRunner::clearStaleClaims(int numberOfRows, int numberOfColumns) const
+{
+    int numberOfClaimsCleared = 0;
+    LandscapeTiling tiling(numberOfRows, numberOfColumns, tileSize_, 0);
+    for(int tile = 0; tile < tiling.getNumberOfTiles(); tile++)
+    {
+        if(!isTileDone(tile) && std::remove(getClaimFileName(tile).c_str()) == 0)
+        {
+            numberOfClaimsCleared++;
+        }
+    }
+    return numberOfClaimsCleared;
+}
+
+bool LandscapeTileRunner::run(const LandscapeInputBands& inputs)
+{
+    numberOfTilesRun_ = 0;
+    numberOfTilesSkipped_ = 0;
+    LandscapeTiling tiling(inputs.numberOfRows, inputs.numberOfColumns, tileSize_, 0);
+
+    std::vector<int> tiles;
+    if(dispatchMode_ == LandscapeTileDispatchMode::Partition)
+    {
+        tiles = tiling.getTilesOfWorker(worker_, numberOfWorkers_);
+    }
+    else
+    {
+        // Every worker walks the tiles from a different starting point, so early claims rarely collide
+        int numberOfTiles = tiling.getNumberOfTiles();
+        for(int i = 0; i < numberOfTiles; i++)
+        {
+            tiles.push_back((i + (int)((long)worker_ * numberOfTiles / numberOfWorkers_)) % numberOfTiles);
+        }
+    }
+    if(runControl_)
+    {
+        runControl_->beginWork((long)tiles.size());
+    }
+
+    LandscapeRunner runner(prototype_);
+    runner.setCrownFireMethod(crownFireMethod_);
+    runner.setWindHeightInputMode(windHeightInputMode_);
+    runner.setWindAndSpreadOrientationMode(windAndSpreadOrientationMode_);
+    runner.setNumberOfThreads(numberOfThreads_);
+
+    bool isWritten = true;
+    for(size_t i = 0; i < tiles.size(); i++)
+    {
+        if(runControl_ && runControl_->isStopRequested())
+        {
+            break;
+        }
+        int tile = tiles[i];
+        if(isTileDone(tile))
+        {
+            numberOfTilesSkipped_++;
+        }
+        else if(dispatchMode_ == LandscapeTileDispatchMode::Partition || claimTile(tile))
+        {
+            isWritten = runTile(runner, inputs, tiling.getTile(tile)) && isWritten;
+            numberOfTilesRun_++;
+        }
+        if(runControl_)
+        {
+            runControl_->addWorkDone(1);
+        }
+    }
+    return isWritten;
+}
+
+bool LandscapeTileRunner::runTile(LandscapeRunner& runner, const LandscapeInputBands& inputs, const LandscapeTile& tile)
+{
+    LandscapeTileInputs tileInputs;
+    tileInputs.extract(inputs, tile);
+    const LandscapeInputBands& bands = tileInputs.getInputs();
+    long numberOfPixels = (long)bands.numberOfRows * bands.numberOfColumns;
+
+    std::vector<double> spreadRate(numberOfPixels);
+    std::vector<double> flameLength(numberOfPixels);
+    std::vector<double> firelineIntensity(numberOfPixels);
+    std::vector<int> fireType(numberOfPixels);
+    std::vector<double> crownFractionBurned(numberOfPixels);
+    LandscapeOutputBands outputs = { inputs.noDataValue, spreadRate.data(), flameLength.data(), firelineIntensity.data(),
+        fireType.data(), crownFractionBurned.data() };
+    runner.run(bands, outputs);
+
+    ColumnarWriter writer;
+    writer.addColumn(spreadRateColumn, ColumnarColumnType::Float64);
+    writer.addColumn(flameLengthColumn, ColumnarColumnType::Float64);
+    writer.addColumn(firelineIntensityColumn, ColumnarColumnType::Float64);
+    writer.addColumn(fireTypeColumn, ColumnarColumnType::Int32);
+    writer.addColumn(crownFractionBurnedColumn, ColumnarColumnType::Float64);
+    ColumnarChunk chunk(writer);
+    chunk.reserve(numberOfPixels);
+    for(long pixel = 0; pixel < numberOfPixels; pixel++)
+    {
+        chunk.appendValue(0, spreadRate[pixel]);
+        chunk.appendValue(1, flameLength[pixel]);
+        chunk.appendValue(2, firelineIntensity[pixel]);
+        chunk.appendValue(3, fireType[pixel]);
+        chunk.appendValue(4, crownFractionBurned[pixel]);
+    }
+
+    // Written under a temporary name, so a worker that dies mid-write leaves no tile file behind
+    std::string fileName = getTileFileName(tile.index);
+    std::string partialFileName = fileName + ".partial";
+    bool isWritten = writer.open(partialFileName, isCompressed_) && writer.writeChunk(chunk);
+    isWritten = writer.close() && isWritten;
+    isWritten = isWritten && std::rename(partialFileName.c_str(), fileName.c_str()) == 0;
+    if(!isWritten)
+    {
+        std::remove(partialFileName.c_str());
+    }
+    return isWritten;
+}
+
+bool LandscapeTileRunner::mergeTiles(int numberOfRows, int numberOfColumns, LandscapeOutputBands& outputs) const
+{
+    LandscapeTiling tiling(numberOfRows, numberOfColumns, tileSize_, 0);
+    for(int index = 0; index < tiling.getNumberOfTiles(); index++)
+    {
+        LandscapeTile tile = tiling.getTile(index);
+        long numberOfPixels = (long)(tile.rowEnd - tile.rowBegin) * (tile.columnEnd - tile.columnBegin);
+        ColumnarReader reader;
+        if(!reader.open(getTileFileName(index)) || reader.getNumberOfRows() != numberOfPixels)
+        {
+            return false;
+        }
+        if(!readTileColumn(reader, spreadRateColumn, tile, numberOfColumns, outputs.spreadRate) ||
+            !readTileColumn(reader, flameLengthColumn, tile, numberOfColumns, outputs.flameLength) ||
+            !readTileColumn(reader, firelineIntensityColumn, tile, numberOfColumns, outputs.firelineIntensity) ||
+            !readTileColumn(reader, fireTypeColumn, tile, numberOfColumns, outputs.fireType) ||
+            !readTileColumn(reader, crownFractionBurnedColumn, tile, numberOfColumns, outputs.crownFractionBurned))
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,178 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Landscape runs split into tiles that any number of workers
+*           can run, checkpoint and merge
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef LANDSCAPETILERUNNER_H
+#define LANDSCAPETILERUNNER_H
+
+#include <string>
+#include <vector>
+#include "landscapeRunner.h"
+
+class RunControl;
+
+// One tile of a LandscapeTiling: the core block of pixels the tile is responsible for, and the
+// same block grown by the tiling's halo and clipped to the raster, both as row and column ranges
+// with exclusive ends
+struct LandscapeTile
+{
+    int index;
+    int rowBegin;
+    int rowEnd;
+    int columnBegin;
+    int columnEnd;
+    int haloRowBegin;
+    int haloRowEnd;
+    int haloColumnBegin;
+    int haloColumnEnd;
+};
+
+// Cuts a raster into square tiles, numbered row by row. A job that reads its neighbors, such as
+// fire growth, needs a halo around each tile as wide as its stencil reaches:
+// FireGrowthRunner::NeighborReach pixels. Pixel by pixel jobs need none.
+class LandscapeTiling
+{
+public:
+    LandscapeTiling(int numberOfRows, int numberOfColumns, int tileSize, int haloWidth);
+
+    int getNumberOfRows() const;
+    int getNumberOfColumns() const;
+    int getTileSize() const;
+    int getHaloWidth() const;
+    int getNumberOfTiles() const;
+    LandscapeTile getTile(int index) const;
+
+    // Tiles of one worker of a fixed round robin partition, e.g. by MPI rank and size, so every
+    // worker finds its own tiles without talking to the others
+    std::vector<int> getTilesOfWorker(int worker, int numberOfWorkers) const;
+
+protected:
+    int numberOfRows_;
+    int numberOfColumns_;
+    int tileSize_;
+    int haloWidth_;
+    int tilesAcross_;
+    int tilesDown_;
+};
+
+// The input bands cut to the halo window of one tile, with their own storage, so a tile can be
+// run, or sent to another node, without the rest of the raster. Constant bands stay constant.
+class LandscapeTileInputs
+{
+public:
+    LandscapeTileInputs();
+
+    void extract(const LandscapeInputBands& inputs, const LandscapeTile& tile);
+    const LandscapeInputBands& getInputs() const;
+
+protected:
+    static const int NumberOfBands = 14;
+
+    LandscapeInputBands inputs_;
+    std::vector<int> fuelModelNumber_;
+    std::vector<double> bands_[NumberOfBands];
+};
+
+struct LandscapeTileDispatchMode
+{
+    enum LandscapeTileDispatchModeEnum
+    {
+        Partition,      // each worker runs the tiles of its round robin share
+        SharedQueue     // workers sharing a file system claim any tile nobody has claimed yet
+    };
+};
+
+// Runs a landscape as independent tiles spread over any number of workers, processes on one or
+// many nodes, each running LandscapeRunner on one tile at a time with its own threads. Every
+// finished tile is written to its own file in the columnar binary format, first under a temporary
+// name and then renamed, so a tile file only exists once it is complete and serves as that tile's
+// checkpoint: a rerun skips every tile with a file, and a failed worker only costs the tiles it
+// had not finished. A tile file holds the tile's core pixels row by row, in the columns
+// SPREAD_RATE, FLAME_LENGTH, FIRELINE_INTENSITY, FIRE_TYPE and CROWN_FRACTION_BURNED, in the
+// base units of LandscapeOutputBands. mergeTiles() puts the tiles back together into one set of
+// output bands. Every worker must use the same tile size and output prefix.
+class LandscapeTileRunner
+{
+public:
+    // Tile files are named outputPrefix followed by "tile_<index>.bcol", so the prefix can be a
+    // directory with a trailing separator, a file name prefix or both
+    LandscapeTileRunner(const Crown& prototype, const std::string& outputPrefix);
+
+    void setCrownFireMethod(LandscapeCrownFireMethod::LandscapeCrownFireMethodEnum crownFireMethod);
+    void setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode);
+    void setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode);
+    void setTileSize(int tileSize);
+    // Threads of this worker, zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+    void setIsCompressed(bool isCompressed);
+    void setDispatchMode(LandscapeTileDispatchMode::LandscapeTileDispatchModeEnum dispatchMode);
+    // This worker's number among numberOfWorkers, used by the Partition mode
+    void setWorker(int worker, int numberOfWorkers);
+    // Token polled before every tile, null for none. A stopped run leaves the tiles it did not
+    // finish for the next run
+    void setRunControl(RunControl* runControl);
+
+    // Runs this worker's tiles that have no tile file yet. False if a tile file could not be written.
+    bool run(const LandscapeInputBands& inputs);
+    // Tiles run and tiles skipped for having a tile file on the last run()
+    long getNumberOfTilesRun() const;
+    long getNumberOfTilesSkipped() const;
+
+    bool isTileDone(int tile) const;
+    bool areAllTilesDone(int numberOfRows, int numberOfColumns) const;
+    // Removes the SharedQueue claims of tiles without a tile file, left by workers that failed, so
+    // the next run() of any worker picks those tiles up. Only safe once the workers have stopped.
+    int clearStaleClaims(int numberOfRows, int numberOfColumns) const;
+    // Reads every tile file into outputs, sized for the whole raster. False if a tile is missing or
+    // does not read back, in which case outputs are partly filled.
+    bool mergeTiles(int numberOfRows, int numberOfColumns, LandscapeOutputBands& outputs) const;
+
+    std::string getTileFileName(int tile) const;
+
+protected:
+    std::string getClaimFileName(int tile) const;
+    bool claimTile(int tile) const;
+    bool runTile(LandscapeRunner& runner, const LandscapeInputBands& inputs, const LandscapeTile& tile);
+
+    Crown prototype_;
+    std::string outputPrefix_;
+    LandscapeCrownFireMethod::LandscapeCrownFireMethodEnum crownFireMethod_;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode_;
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode_;
+    int tileSize_;
+    int numberOfThreads_;
+    bool isCompressed_;
+    LandscapeTileDispatchMode::LandscapeTileDispatchModeEnum dispatchMode_;
+    int worker_;
+    int numberOfWorkers_;
+    RunControl* runControl_;
+
+    long numberOfTilesRun_;
+    long numberOfTilesSkipped_;
+};
+
+#endif // LANDSCAPETILERUNNER_H
@@ -0,0 +1,228 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  A BehaveRun for worker pools that shares read only fuel model and
+*           species data and only constructs the modules that are used
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#include "lazyBehaveRun.h"
+
+#include "fuelModels.h"
+#include "moistureScenarios.h"
+#include "species_master_table.h"
+
+LazyBehaveRun::LazyBehaveRun(const FuelModels& fuelModels, const SpeciesMasterTable& speciesMasterTable)
+    : fuelModels_(&fuelModels),
+    speciesMasterTable_(&speciesMasterTable),
+    moistureScenarios_(nullptr)
+{
+
+}
+
+LazyBehaveRun::LazyBehaveRun(const LazyBehaveRun& rhs)
+    : fuelModels_(rhs.fuelModels_),
+    speciesMasterTable_(rhs.speciesMasterTable_),
+    moistureScenarios_(nullptr)
+{
+    memberwiseCopyAssignment(rhs);
+}
+
+LazyBehaveRun& LazyBehaveRun::operator=(const LazyBehaveRun& rhs)
+{
+    if (this != &rhs)
+    {
+        memberwiseCopyAssignment(rhs);
+    }
+    return *this;
+}
+
+LazyBehaveRun::~LazyBehaveRun()
+{
+
+}
+
+void LazyBehaveRun::memberwiseCopyAssignment(const LazyBehaveRun& rhs)
+{
+    fuelModels_ = rhs.fuelModels_;
+    speciesMasterTable_ = rhs.speciesMasterTable_;
+    moistureScenarios_ = rhs.moistureScenarios_;
+
+    surface_.reset(rhs.surface_ ? new Surface(*rhs.surface_) : nullptr);
+    crown_.reset(rhs.crown_ ? new Crown(*rhs.crown_) : nullptr);
+    spot_.reset(rhs.spot_ ? new Spot(*rhs.spot_) : nullptr);
+    ignite_.reset();
+    contain_.reset();
+    safety_.reset();
+    mortality_.reset();
+    fineDeadFuelMoistureTool_.reset();
+    slopeTool_.reset();
+    vpdCalculator_.reset();
+}
+
+void LazyBehaveRun::reinitialize()
+{
+    if (surface_)
+    {
+        surface_->initializeMembers();
+    }
+    if (crown_)
+    {
+        crown_->initializeMembers();
+    }
+    if (spot_)
+    {
+        spot_->initializeMembers();
+    }
+    if (ignite_)
+    {
+        ignite_->initializeMembers();
+    }
+    if (safety_)
+    {
+        safety_->initializeMembers();
+    }
+}
+
+void LazyBehaveRun::setFuelModels(const FuelModels& fuelModels)
+{
+    fuelModels_ = &fuelModels;
+    if (surface_)
+    {
+        surface_->setFuelModels(fuelModels);
+    }
+    if (crown_)
+    {
+        crown_->setFuelModels(fuelModels);
+    }
+}
+
+void LazyBehaveRun::setMoistureScenarios(const MoistureScenarios& moistureScenarios)
+{
+    moistureScenarios_ = &moistureScenarios;
+    if (surface_)
+    {
+        surface_->setMoistureScenarios(moistureScenarios);
+    }
+    if (crown_)
+    {
+        crown_->setMoistureScenarios(moistureScenarios);
+    }
+}
+
+Surface& LazyBehaveRun::surface()
+{
+    if (!surface_)
+    {
+        surface_.reset(new Surface(*fuelModels_));
+        if (moistureScenarios_ != nullptr)
+        {
+            surface_->setMoistureScenarios(*moistureScenarios_);
+        }
+    }
+    return *surface_;
+}
+
+Crown& LazyBehaveRun::crown()
+{
+    if (!crown_)
+    {
+        crown_.reset(new Crown(*fuelModels_));
+        if (moistureScenarios_ != nullptr)
+        {
+            crown_->setMoistureScenarios(*moistureScenarios_);
+        }
+    }
+    return *crown_;
+}
+
+Spot& LazyBehaveRun::spot()
+{
+    if (!spot_)
+    {
+        spot_.reset(new Spot());
+    }
+    return *spot_;
+}
+
+Ignite& LazyBehaveRun::ignite()
+{
+    if (!ignite_)
+    {
+        ignite_.reset(new Ignite());
+    }
+    return *ignite_;
+}
+
+ContainAdapter& LazyBehaveRun::contain()
+{
+    if (!contain_)
+    {
+        contain_.reset(new ContainAdapter());
+    }
+    return *contain_;
+}
+
+Safety& LazyBehaveRun::safety()
+{
+    if (!safety_)
+    {
+        safety_.reset(new Safety());
+    }
+    return *safety_;
+}
+
+Mortality& LazyBehaveRun::mortality()
+{
+    if (!mortality_)
+    {
+        mortality_.reset(new Mortality(*speciesMasterTable_));
+    }
+    return *mortality_;
+}
+
+FineDeadFuelMoistureTool& LazyBehaveRun::fineDeadFuelMoistureTool()
+{
+    if (!fineDeadFuelMoistureTool_)
+    {
+        fineDeadFuelMoistureTool_.reset(new FineDeadFuelMoistureTool());
+    }
+    return *fineDeadFuelMoistureTool_;
+}
+
+SlopeTool& LazyBehaveRun::slopeTool()
+{
+    if (!slopeTool_)
+    {
+        slopeTool_.reset(new SlopeTool());
+    }
+    return *slopeTool_;
+}
+
+VaporPressureDeficitCalculator& LazyBehaveRun::vpdCalculator()
+{
+    if (!vpdCalculator_)
+    {
+        vpdCalculator_.reset(new VaporPressureDeficitCalculator());
+    }
+    return *vpdCalculator_;
+}
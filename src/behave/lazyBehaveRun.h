@@ -0,0 +1,104 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  A BehaveRun for worker pools that shares read only fuel model and
+*           species data and only constructs the modules that are used
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef LAZYBEHAVERUN_H
+#define LAZYBEHAVERUN_H
+
+#include <memory>
+
+#include "ContainAdapter.h"
+#include "crown.h"
+#include "fineDeadFuelMoistureTool.h"
+#include "ignite.h"
+#include "mortality.h"
+#include "safety.h"
+#include "slopeTool.h"
+#include "spot.h"
+#include "surface.h"
+#include "vaporPressureDeficitCalculator.h"
+
+class FuelModels;
+class MoistureScenarios;
+class SpeciesMasterTable;
+
+// Holds the same modules as BehaveRun, but each one is only constructed the
+// first time its accessor is called, so a worker that only runs Surface does
+// not pay for Crown, Contain or Mortality.
+//
+// Thread safety: a LazyBehaveRun must only be used by one thread at a time.
+// Any number of LazyBehaveRuns, on any number of threads, may share the same
+// FuelModels, SpeciesMasterTable and MoistureScenarios, since the modules only
+// read them through const references. The shared objects must not be changed
+// while a run that refers to them is in progress, and speciesMasterTable must
+// already be initialized.
+class LazyBehaveRun
+{
+public:
+    LazyBehaveRun(const FuelModels& fuelModels, const SpeciesMasterTable& speciesMasterTable);
+    // Like BehaveRun, a copy carries over the Surface, Crown and Spot state, the
+    // other modules start fresh
+    LazyBehaveRun(const LazyBehaveRun& rhs);
+    LazyBehaveRun& operator=(const LazyBehaveRun& rhs);
+    ~LazyBehaveRun();
+
+    // Reinitializes the modules that have been constructed
+    void reinitialize();
+
+    void setFuelModels(const FuelModels& fuelModels);
+    void setMoistureScenarios(const MoistureScenarios& moistureScenarios);
+
+    Surface& surface();
+    Crown& crown();
+    Spot& spot();
+    Ignite& ignite();
+    ContainAdapter& contain();
+    Safety& safety();
+    Mortality& mortality();
+    FineDeadFuelMoistureTool& fineDeadFuelMoistureTool();
+    SlopeTool& slopeTool();
+    VaporPressureDeficitCalculator& vpdCalculator();
+
+protected:
+    void memberwiseCopyAssignment(const LazyBehaveRun& rhs);
+
+    const FuelModels* fuelModels_;
+    const SpeciesMasterTable* speciesMasterTable_;
+    const MoistureScenarios* moistureScenarios_;
+
+    std::unique_ptr<Surface> surface_;
+    std::unique_ptr<Crown> crown_;
+    std::unique_ptr<Spot> spot_;
+    std::unique_ptr<Ignite> ignite_;
+    std::unique_ptr<ContainAdapter> contain_;
+    std::unique_ptr<Safety> safety_;
+    std::unique_ptr<Mortality> mortality_;
+    std::unique_ptr<FineDeadFuelMoistureTool> fineDeadFuelMoistureTool_;
+    std::unique_ptr<SlopeTool> slopeTool_;
+    std::unique_ptr<VaporPressureDeficitCalculator> vpdCalculator_;
+};
+
+#endif // LAZYBEHAVERUN_H
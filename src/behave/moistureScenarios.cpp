@@ -4,6 +4,15 @@
 
 MoistureScenarios::MoistureScenarios()
 {
+    // The standard scenarios are built once per process and shared, read only, by every MoistureScenarios
+    static const MoistureScenarios standardMoistureScenarios = MoistureScenarios(PopulateStandardMoistureScenarios());
+    memberwiseCopyAssignment(standardMoistureScenarios);
+}
+
+MoistureScenarios::MoistureScenarios(PopulateStandardMoistureScenarios)
+{
+    moistureScenarioVector_ = std::make_shared<std::vector<MoistureScenarioRecord>>();
+    moistureScenarioIndexByName_ = std::make_shared<std::unordered_map<std::string, int>>();
     populateMoistureScenarios();
 }
 
@@ -26,190 +35,220 @@ MoistureScenarios::MoistureScenarios(const MoistureScenarios& rhs)
     memberwiseCopyAssignment(rhs);
 }
 
-int MoistureScenarios::getNumberOfMoistureScenarios()
+int MoistureScenarios::getNumberOfMoistureScenarios() const
 {
-    return moistureScenarioVector_.size();
+    return moistureScenarioVector_->size();
 }
 
-int MoistureScenarios::getMoistureScenarioIndexByName(const std::string name)
+int MoistureScenarios::getMoistureScenarioIndexByName(const std::string name) const
 {
-    int index = -1;
-    std::string searchNameAllUppercase = name;
-    std::transform(searchNameAllUppercase.begin(), searchNameAllUppercase.end(), searchNameAllUppercase.begin(), ::toupper);
-    for(int i = 0; i < moistureScenarioVector_.size(); i++)
-    {
-        std::string currentNameAllUppercase = moistureScenarioVector_[i].name_;
-        std::transform(currentNameAllUppercase.begin(), currentNameAllUppercase.end(), currentNameAllUppercase.begin(), ::toupper);
-        if(currentNameAllUppercase == searchNameAllUppercase)
-        {
-            index = i;
-            break;
-        }
-    }
-    return index;
+    auto found = moistureScenarioIndexByName_->find(toUppercase(name));
+    return (found != moistureScenarioIndexByName_->end()) ? found->second : -1;
 }
 
-bool MoistureScenarios::getIsMoistureScenarioDefinedByName(const std::string name)
+bool MoistureScenarios::getIsMoistureScenarioDefinedByName(const std::string name) const
 {
     bool isMoistureScenarioDefined = false;
     int index = getMoistureScenarioIndexByName(name);
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
         isMoistureScenarioDefined = true;
     }
     return isMoistureScenarioDefined;
 }
 
-std::string MoistureScenarios::getMoistureScenarioDescriptionByName(const std::string name)
+std::string MoistureScenarios::getMoistureScenarioDescriptionByName(const std::string name) const
 {
     std::string description = "Error: Scenario " + name + " is not defined";
     int index = getMoistureScenarioIndexByName(name);
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        description = moistureScenarioVector_[index].description_;
+        description = (*moistureScenarioVector_)[index].description_;
     }
     return description;
 }
 
-double MoistureScenarios::getMoistureScenarioOneHourByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioOneHourByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureOneHour = -1.0;
     int index = getMoistureScenarioIndexByName(name);
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureOneHour = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureOneHour_, moistureUnits);
+        moistureOneHour = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureOneHour_, moistureUnits);
     }
     return moistureOneHour;
 }
 
-double MoistureScenarios::getMoistureScenarioTenHourByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioTenHourByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureTenHour = -1.0;
     int index = getMoistureScenarioIndexByName(name);
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureTenHour = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureTenHour_, moistureUnits);
+        moistureTenHour = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureTenHour_, moistureUnits);
     }
     return moistureTenHour;
 }
 
-double MoistureScenarios::getMoistureScenarioHundredHourByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioHundredHourByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureHundredHour = -1.0;
     int index = getMoistureScenarioIndexByName(name);
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureHundredHour = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureHundredHour_, moistureUnits);
+        moistureHundredHour = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureHundredHour_, moistureUnits);
     }
     return moistureHundredHour;
 }
 
-double MoistureScenarios::getMoistureScenarioLiveHerbaceousByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioLiveHerbaceousByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureLiveHerbaceous = -1.0;
     int index = getMoistureScenarioIndexByName(name);
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureLiveHerbaceous = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureLiveHerbaceous_, moistureUnits);
+        moistureLiveHerbaceous = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureLiveHerbaceous_, moistureUnits);
     }
     return moistureLiveHerbaceous;
 }
 
-double MoistureScenarios::getMoistureScenarioLiveWoodyByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioLiveWoodyByName(const std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureLiveWoody = -1.0;
     int index = getMoistureScenarioIndexByName(name);
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureLiveWoody = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureLiveWoody_, moistureUnits);
+        moistureLiveWoody = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureLiveWoody_, moistureUnits);
     }
     return moistureLiveWoody;
 }
 
-bool MoistureScenarios::getIsMoistureScenarioDefinedByIndex(const int index)
+bool MoistureScenarios::getIsMoistureScenarioDefinedByIndex(const int index) const
 {
     bool isMoistureScenarioDefined = false;
 
-    if((moistureScenarioVector_.size() > 0) && (index >= 0) && (index < moistureScenarioVector_.size()))
+    if((moistureScenarioVector_->size() > 0) && (index >= 0) && (index < moistureScenarioVector_->size()))
     {
         isMoistureScenarioDefined = true;
     }
     return isMoistureScenarioDefined;
 }
 
-std::string MoistureScenarios::getMoistureScenarioNameByIndex(const int index)
+std::string MoistureScenarios::getMoistureScenarioNameByIndex(const int index) const
 {
     std::string name = "Error: Scenario with vector index " + std::to_string(index) + " is not defined";
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        name = moistureScenarioVector_[index].name_;
+        name = (*moistureScenarioVector_)[index].name_;
     }
     return name;
 }
 
-std::string MoistureScenarios::getMoistureScenarioDescriptionByIndex(const int index)
+std::string MoistureScenarios::getMoistureScenarioDescriptionByIndex(const int index) const
 {
     std::string description = "Error: Scenario with vector index " + std::to_string(index) + " is not defined";
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        description = moistureScenarioVector_[index].description_;
+        description = (*moistureScenarioVector_)[index].description_;
     }
     return description;
 }
 
-double MoistureScenarios::getMoistureScenarioOneHourByIndex(const int index, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioOneHourByIndex(const int index, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureOneHour = -1.0;
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureOneHour = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureOneHour_, moistureUnits);
+        moistureOneHour = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureOneHour_, moistureUnits);
     }
     return moistureOneHour;
 }
 
-double MoistureScenarios::getMoistureScenarioTenHourByIndex(const int index, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioTenHourByIndex(const int index, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureTenHour = -1.0;
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureTenHour = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureTenHour_, moistureUnits);
+        moistureTenHour = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureTenHour_, moistureUnits);
     }
     return moistureTenHour;
 }
 
-double MoistureScenarios::getMoistureScenarioHundredHourByIndex(const int index, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioHundredHourByIndex(const int index, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureHundredHour = -1.0;
-    if((index >= 0) && (index < moistureScenarioVector_.size()))
+    if((index >= 0) && (index < moistureScenarioVector_->size()))
     {
-        moistureHundredHour = FractionUnits::fromBaseUnits(moistureScenarioVector_[index].moistureHundredHour_, moistureUnits);
+        moistureHundredHour = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[index].moistureHundredHour_, moistureUnits);
     }
     return moistureHundredHour;
 }
 
-double MoistureScenarios::getMoistureScenarioLiveHerbaceousByIndex(const int vectorIndex, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioLiveHerbaceousByIndex(const int vectorIndex, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureLiveHerbaceous = -1.0;
-    if((vectorIndex >= 0) && (vectorIndex < moistureScenarioVector_.size()))
+    if((vectorIndex >= 0) && (vectorIndex < moistureScenarioVector_->size()))
     {
-        moistureLiveHerbaceous = FractionUnits::fromBaseUnits(moistureScenarioVector_[vectorIndex].moistureLiveHerbaceous_, moistureUnits);
+        moistureLiveHerbaceous = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[vectorIndex].moistureLiveHerbaceous_, moistureUnits);
     }
     return moistureLiveHerbaceous;
 }
 
-double MoistureScenarios::getMoistureScenarioLiveWoodyByIndex(const int vectorIndex, FractionUnits::FractionUnitsEnum moistureUnits)
+double MoistureScenarios::getMoistureScenarioLiveWoodyByIndex(const int vectorIndex, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     double moistureLiveWoody = -1.0;
-    if((vectorIndex >= 0) && (vectorIndex < moistureScenarioVector_.size()))
+    if((vectorIndex >= 0) && (vectorIndex < moistureScenarioVector_->size()))
     {
-        moistureLiveWoody = FractionUnits::fromBaseUnits(moistureScenarioVector_[vectorIndex].moistureLiveWoody_, moistureUnits);
+        moistureLiveWoody = FractionUnits::fromBaseUnits((*moistureScenarioVector_)[vectorIndex].moistureLiveWoody_, moistureUnits);
     }
     return moistureLiveWoody;
 }
 
+bool MoistureScenarios::getMoistureScenarioMoisturesByIndex(const int index, FractionUnits::FractionUnitsEnum moistureUnits,
+    double moistures[5]) const
+{
+    if((index < 0) || (index >= moistureScenarioVector_->size()))
+    {
+        for(int i = 0; i < 5; i++)
+        {
+            moistures[i] = -1.0;
+        }
+        return false;
+    }
+    const MoistureScenarioRecord& record = (*moistureScenarioVector_)[index];
+    moistures[0] = FractionUnits::fromBaseUnits(record.moistureOneHour_, moistureUnits);
+    moistures[1] = FractionUnits::fromBaseUnits(record.moistureTenHour_, moistureUnits);
+    moistures[2] = FractionUnits::fromBaseUnits(record.moistureHundredHour_, moistureUnits);
+    moistures[3] = FractionUnits::fromBaseUnits(record.moistureLiveHerbaceous_, moistureUnits);
+    moistures[4] = FractionUnits::fromBaseUnits(record.moistureLiveWoody_, moistureUnits);
+    return true;
+}
+
 void MoistureScenarios::memberwiseCopyAssignment(const MoistureScenarios& rhs)
 {
+    // Records are immutable while shared, so a copy only takes another reference
     moistureScenarioVector_ = rhs.moistureScenarioVector_;
+    moistureScenarioIndexByName_ = rhs.moistureScenarioIndexByName_;
+}
+
+std::vector<MoistureScenarios::MoistureScenarioRecord>& MoistureScenarios::getMutableMoistureScenarioVector()
+{
+    // Detach from the shared records before the first change
+    if(moistureScenarioVector_.use_count() != 1)
+    {
+        moistureScenarioVector_ = std::make_shared<std::vector<MoistureScenarioRecord>>(*moistureScenarioVector_);
+    }
+    if(moistureScenarioIndexByName_.use_count() != 1)
+    {
+        moistureScenarioIndexByName_ = std::make_shared<std::unordered_map<std::string, int>>(*moistureScenarioIndexByName_);
+    }
+    return *moistureScenarioVector_;
+}
+
+std::string MoistureScenarios::toUppercase(std::string name)
+{
+    std::transform(name.begin(), name.end(), name.begin(), ::toupper);
+    return name;
 }
 
 void MoistureScenarios::setMoistureScenarioRecord(const std::string name, const std::string description,
@@ -224,7 +263,9 @@ void MoistureScenarios::setMoistureScenarioRecord(const std::string name, const
     record.moistureHundredHour_ = moistureHundredHour;
     record.moistureLiveHerbaceous_ = moistureLiveHerbaceous;
     record.moistureLiveWoody_ = moistureLiveWoody;
-    moistureScenarioVector_.push_back(record);
+    std::vector<MoistureScenarioRecord>& moistureScenarioVector = getMutableMoistureScenarioVector();
+    moistureScenarioIndexByName_->emplace(toUppercase(name), (int)moistureScenarioVector.size()); // keeps the first of a name
+    moistureScenarioVector.push_back(record);
 }
 
 void MoistureScenarios::populateMoistureScenarios()
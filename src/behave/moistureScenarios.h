@@ -28,7 +28,9 @@
 #ifndef MOISTURE_SCENARIOS_H
 #define MOISTURE_SCENARIOS_H
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "behaveUnits.h"
@@ -44,30 +46,39 @@ public:
     // Getters by scenario name
 
     // Returns the number of mositure scenarios that are currently defined
-    int getNumberOfMoistureScenarios();
+    int getNumberOfMoistureScenarios() const;
     // If a moisture scenerio having "name" is found, returns that scenario's vector index 
     // Otherwise returns -1
-    int getMoistureScenarioIndexByName(std::string name);
-    bool getIsMoistureScenarioDefinedByName(std::string name);
-    std::string getMoistureScenarioDescriptionByName(std::string name);
-    double getMoistureScenarioOneHourByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioTenHourByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioHundredHourByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioLiveHerbaceousByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioLiveWoodyByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits);
+    int getMoistureScenarioIndexByName(std::string name) const;
+    bool getIsMoistureScenarioDefinedByName(std::string name) const;
+    std::string getMoistureScenarioDescriptionByName(std::string name) const;
+    double getMoistureScenarioOneHourByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioTenHourByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioHundredHourByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioLiveHerbaceousByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioLiveWoodyByName(std::string name, FractionUnits::FractionUnitsEnum moistureUnits) const;
   
     // Getters by vector index
-    bool getIsMoistureScenarioDefinedByIndex(int index);
-    std::string getMoistureScenarioNameByIndex(int index);
-    std::string getMoistureScenarioDescriptionByIndex(int index);
-    double getMoistureScenarioOneHourByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioTenHourByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioHundredHourByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioLiveHerbaceousByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits);
-    double getMoistureScenarioLiveWoodyByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits);
+    bool getIsMoistureScenarioDefinedByIndex(int index) const;
+    std::string getMoistureScenarioNameByIndex(int index) const;
+    std::string getMoistureScenarioDescriptionByIndex(int index) const;
+    double getMoistureScenarioOneHourByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioTenHourByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioHundredHourByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioLiveHerbaceousByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    double getMoistureScenarioLiveWoodyByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits) const;
+    // Fills moistures with the one hour, ten hour, hundred hour, live herbaceous and live woody moistures
+    // in that order, returns false and fills them with -1 if the index is out of range
+    bool getMoistureScenarioMoisturesByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits, double moistures[5]) const;
    
 protected:
+    struct MoistureScenarioRecord;
+    struct PopulateStandardMoistureScenarios {};
+
+    explicit MoistureScenarios(PopulateStandardMoistureScenarios);
     void memberwiseCopyAssignment(const MoistureScenarios& rhs);
+    std::vector<MoistureScenarioRecord>& getMutableMoistureScenarioVector();
+    static std::string toUppercase(std::string name);
     void setMoistureScenarioRecord(std::string name, std::string description,
         double moistureOneHour, double moistureTenHour, double moistureHundredHour,
         double moistureLiveHerbaceous, double moistureLiveWoody);
@@ -84,7 +95,9 @@ protected:
         double moistureLiveWoody_;          // Live wood moisture (fraction)
     };
 
-    std::vector<MoistureScenarioRecord> moistureScenarioVector_;
+    std::shared_ptr<std::vector<MoistureScenarioRecord>> moistureScenarioVector_; // Shared between copies until one changes
+    // Vector index of the first scenario with each upper case name, shared and detached with the vector
+    std::shared_ptr<std::unordered_map<std::string, int>> moistureScenarioIndexByName_;
 };
 
 #endif //MOISTURE_SCENARIOS_H
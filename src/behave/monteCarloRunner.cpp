@@ -0,0 +1,606 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Monte Carlo sampling of uncertain surface and crown fire inputs,
+*           accumulated into histograms without storing the samples
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "monteCarloRunner.h"
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "behaveRun.h"
+#include "threadPool.h"
+
+namespace
+{
+
+// Samples per block, the unit of work shared out over the threads. Block results are combined in
+// block order, so this also fixes the summation order of the means.
+const long samplesPerBlock = 256;
+
+enum SampledInput
+{
+    WindSpeedInput,
+    WindDirectionInput,
+    MoistureOneHourInput,
+    MoistureTenHourInput,
+    MoistureHundredHourInput,
+    MoistureLiveHerbaceousInput,
+    MoistureLiveWoodyInput,
+    MoistureFoliarInput,
+    CanopyBaseHeightInput,
+    NumberOfSampledInputs
+};
+
+enum SummedOutput
+{
+    SpreadRateSum,
+    FlameLengthSum,
+    FirelineIntensitySum,
+    CrownFractionBurnedSum,
+    NumberOfSummedOutputs
+};
+
+unsigned long long mixBits(unsigned long long z)
+{
+    // SplitMix64 finalizer
+    z ^= z >> 30;
+    z *= 0xBF58476D1CE4E5B9ULL;
+    z ^= z >> 27;
+    z *= 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return z;
+}
+
+} // namespace
+
+MonteCarloDistribution MonteCarloDistribution::constant(double value)
+{
+    MonteCarloDistribution distribution = { MonteCarloDistributionType::Constant, value, 0.0, value, value };
+    return distribution;
+}
+
+MonteCarloDistribution MonteCarloDistribution::uniform(double minimum, double maximum)
+{
+    MonteCarloDistribution distribution = { MonteCarloDistributionType::Uniform, 0.5 * (minimum + maximum), 0.0, minimum, maximum };
+    return distribution;
+}
+
+MonteCarloDistribution MonteCarloDistribution::normal(double mean, double standardDeviation, double minimum, double maximum)
+{
+    MonteCarloDistribution distribution = { MonteCarloDistributionType::Normal, mean, standardDeviation, minimum, maximum };
+    return distribution;
+}
+
+MonteCarloDistribution MonteCarloDistribution::triangular(double minimum, double mode, double maximum)
+{
+    MonteCarloDistribution distribution = { MonteCarloDistributionType::Triangular, mode, 0.0, minimum, maximum };
+    return distribution;
+}
+
+unsigned long long CounterBasedRandom::getBits(unsigned long long seed, unsigned long long counter, unsigned int stream)
+{
+    unsigned long long z = mixBits(seed + 0x9E3779B97F4A7C15ULL * (counter + 1));
+    return mixBits(z ^ (0xD1B54A32D192ED03ULL * ((unsigned long long)stream + 1)));
+}
+
+double CounterBasedRandom::getUniform(unsigned long long seed, unsigned long long counter, unsigned int stream)
+{
+    // The top 53 bits, centred in their interval so neither end is reached
+    return ((getBits(seed, counter, stream) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+MonteCarloHistogram::MonteCarloHistogram(double minimum, double maximum, int numberOfBins)
+    : minimum_(minimum),
+    maximum_(std::max(minimum, maximum)),
+    counts_(std::max(1, numberOfBins), 0)
+{
+    binWidth_ = (maximum_ - minimum_) / counts_.size();
+    clear();
+}
+
+void MonteCarloHistogram::add(double value)
+{
+    if(numberOfValues_ == 0 || value < smallestValue_)
+    {
+        smallestValue_ = value;
+    }
+    if(numberOfValues_ == 0 || value > largestValue_)
+    {
+        largestValue_ = value;
+    }
+    numberOfValues_++;
+
+    if(value < minimum_)
+    {
+        numberBelowMinimum_++;
+    }
+    else if(value > maximum_)
+    {
+        numberAboveMaximum_++;
+    }
+    else
+    {
+        // The maximum itself falls in the last bin
+        long bin = (binWidth_ > 0.0) ? (long)((value - minimum_) / binWidth_) : 0;
+        counts_[std::min(bin, (long)counts_.size() - 1)]++;
+    }
+}
+
+void MonteCarloHistogram::merge(const MonteCarloHistogram& rhs)
+{
+    if(rhs.numberOfValues_ == 0)
+    {
+        return;
+    }
+    if(numberOfValues_ == 0 || rhs.smallestValue_ < smallestValue_)
+    {
+        smallestValue_ = rhs.smallestValue_;
+    }
+    if(numberOfValues_ == 0 || rhs.largestValue_ > largestValue_)
+    {
+        largestValue_ = rhs.largestValue_;
+    }
+    numberOfValues_ += rhs.numberOfValues_;
+    numberBelowMinimum_ += rhs.numberBelowMinimum_;
+    numberAboveMaximum_ += rhs.numberAboveMaximum_;
+    for(size_t bin = 0; bin < counts_.size() && bin < rhs.counts_.size(); bin++)
+    {
+        counts_[bin] += rhs.counts_[bin];
+    }
+}
+
+void MonteCarloHistogram::clear()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    numberBelowMinimum_ = 0;
+    numberAboveMaximum_ = 0;
+    numberOfValues_ = 0;
+    smallestValue_ = 0.0;
+    largestValue_ = 0.0;
+}
+
+double MonteCarloHistogram::getQuantile(double p) const
+{
+    if(numberOfValues_ == 0)
+    {
+        return 0.0;
+    }
+    double rank = std::min(std::max(p, 0.0), 1.0) * numberOfValues_;
+    double countBefore = (double)numberBelowMinimum_;
+    if(rank <= countBefore)
+    {
+        return smallestValue_;
+    }
+    for(size_t bin = 0; bin < counts_.size(); bin++)
+    {
+        double count = (double)counts_[bin];
+        if(count > 0.0 && rank <= countBefore + count)
+        {
+            double value = minimum_ + (bin + (rank - countBefore) / count) * binWidth_;
+            return std::min(std::max(value, smallestValue_), largestValue_);
+        }
+        countBefore += count;
+    }
+    return largestValue_;
+}
+
+int MonteCarloHistogram::getNumberOfBins() const
+{
+    return (int)counts_.size();
+}
+
+double MonteCarloHistogram::getBinLowerEdge(int bin) const
+{
+    return minimum_ + bin * binWidth_;
+}
+
+long MonteCarloHistogram::getCount(int bin) const
+{
+    return (bin >= 0 && bin < (int)counts_.size()) ? counts_[bin] : 0;
+}
+
+long MonteCarloHistogram::getNumberBelowMinimum() const
+{
+    return numberBelowMinimum_;
+}
+
+long MonteCarloHistogram::getNumberAboveMaximum() const
+{
+    return numberAboveMaximum_;
+}
+
+long MonteCarloHistogram::getNumberOfValues() const
+{
+    return numberOfValues_;
+}
+
+double MonteCarloHistogram::getSmallestValue() const
+{
+    return smallestValue_;
+}
+
+double MonteCarloHistogram::getLargestValue() const
+{
+    return largestValue_;
+}
+
+struct MonteCarloRunner::Worker
+{
+    Worker(const MonteCarloRunner& runner)
+        : surface(runner.surfacePrototype_),
+        crown(runner.crownPrototype_),
+        spreadRate(runner.spreadRateHistogram_),
+        flameLength(runner.flameLengthHistogram_),
+        firelineIntensity(runner.firelineIntensityHistogram_),
+        crownFractionBurned(runner.crownFractionBurnedHistogram_),
+        inputs(NumberOfSampledInputs * samplesPerBlock),
+        outputs(3 * samplesPerBlock),
+        fuelModelNumber(samplesPerBlock),
+        slope(samplesPerBlock),
+        aspect(samplesPerBlock),
+        canopyCover(samplesPerBlock),
+        canopyHeight(samplesPerBlock),
+        crownRatio(samplesPerBlock)
+    {
+        for(int i = 0; i <= FireType::Crowning; i++)
+        {
+            numberOfSamplesOfFireType[i] = 0;
+        }
+    }
+
+    Surface surface;
+    Crown crown;
+    MonteCarloHistogram spreadRate;
+    MonteCarloHistogram flameLength;
+    MonteCarloHistogram firelineIntensity;
+    MonteCarloHistogram crownFractionBurned;
+    long numberOfSamplesOfFireType[FireType::Crowning + 1];
+
+    // Scratch arrays of one block, the sampled inputs and outputs, then the site inputs of the surface batch
+    std::vector<double> inputs;
+    std::vector<double> outputs;
+    std::vector<int> fuelModelNumber;
+    std::vector<double> slope;
+    std::vector<double> aspect;
+    std::vector<double> canopyCover;
+    std::vector<double> canopyHeight;
+    std::vector<double> crownRatio;
+};
+
+MonteCarloRunner::MonteCarloRunner(const BehaveRun& prototype)
+    : surfacePrototype_(prototype.surface),
+    crownPrototype_(prototype.crown),
+    fireMethod_(MonteCarloFireMethod::ScottAndReinhardt),
+    windHeightInputMode_(WindHeightInputMode::TwentyFoot),
+    windAndSpreadOrientationMode_(WindAndSpreadOrientationMode::RelativeToNorth),
+    numberOfThreads_(0),
+    spreadRateHistogram_(0.0, 1000.0, 2000),
+    flameLengthHistogram_(0.0, 400.0, 2000),
+    firelineIntensityHistogram_(0.0, 100000.0, 2000),
+    crownFractionBurnedHistogram_(0.0, 1.0, 100),
+    meanSpreadRate_(0.0),
+    meanFlameLength_(0.0),
+    meanFirelineIntensity_(0.0),
+    meanCrownFractionBurned_(0.0)
+{
+    for(int i = 0; i <= FireType::Crowning; i++)
+    {
+        numberOfSamplesOfFireType_[i] = 0;
+    }
+}
+
+void MonteCarloRunner::setFireMethod(MonteCarloFireMethod::MonteCarloFireMethodEnum fireMethod)
+{
+    fireMethod_ = fireMethod;
+}
+
+void MonteCarloRunner::setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
+{
+    windHeightInputMode_ = windHeightInputMode;
+}
+
+void MonteCarloRunner::setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode)
+{
+    windAndSpreadOrientationMode_ = windAndSpreadOrientationMode;
+}
+
+void MonteCarloRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+void MonteCarloRunner::setSpreadRateBins(double minimum, double maximum, int numberOfBins)
+{
+    spreadRateHistogram_ = MonteCarloHistogram(minimum, maximum, numberOfBins);
+}
+
+void MonteCarloRunner::setFlameLengthBins(double minimum, double maximum, int numberOfBins)
+{
+    flameLengthHistogram_ = MonteCarloHistogram(minimum, maximum, numberOfBins);
+}
+
+void MonteCarloRunner::setFirelineIntensityBins(double minimum, double maximum, int numberOfBins)
+{
+    firelineIntensityHistogram_ = MonteCarloHistogram(minimum, maximum, numberOfBins);
+}
+
+double MonteCarloRunner::drawSample(const MonteCarloDistribution& distribution, unsigned long long seed, long sample, int index)
+{
+    double u = CounterBasedRandom::getUniform(seed, sample, 2 * index);
+    double minimum = distribution.minimum;
+    double maximum = distribution.maximum;
+    switch(distribution.type)
+    {
+        case MonteCarloDistributionType::Uniform:
+        {
+            return minimum + u * (maximum - minimum);
+        }
+        case MonteCarloDistributionType::Triangular:
+        {
+            double range = maximum - minimum;
+            if(range <= 0.0)
+            {
+                return minimum;
+            }
+            double mode = distribution.mean;
+            if(u < (mode - minimum) / range)
+            {
+                return minimum + sqrt(u * range * (mode - minimum));
+            }
+            return maximum - sqrt((1.0 - u) * range * (maximum - mode));
+        }
+        case MonteCarloDistributionType::Normal:
+        {
+            // Box-Muller, with the angle drawn from the input's second stream
+            double angle = 2.0 * M_PI * CounterBasedRandom::getUniform(seed, sample, 2 * index + 1);
+            double value = distribution.mean + distribution.standardDeviation * sqrt(-2.0 * log(u)) * cos(angle);
+            if(maximum > minimum)
+            {
+                value = std::min(std::max(value, minimum), maximum);
+            }
+            return value;
+        }
+        default:
+        {
+            return distribution.mean;
+        }
+    }
+}
+
+void MonteCarloRunner::run(const MonteCarloInputs& inputs)
+{
+    spreadRateHistogram_.clear();
+    flameLengthHistogram_.clear();
+    firelineIntensityHistogram_.clear();
+    crownFractionBurnedHistogram_.clear();
+    meanSpreadRate_ = 0.0;
+    meanFlameLength_ = 0.0;
+    meanFirelineIntensity_ = 0.0;
+    meanCrownFractionBurned_ = 0.0;
+    for(int i = 0; i <= FireType::Crowning; i++)
+    {
+        numberOfSamplesOfFireType_[i] = 0;
+    }
+    if(inputs.numberOfSamples <= 0)
+    {
+        return;
+    }
+
+    long numberOfBlocks = (inputs.numberOfSamples + samplesPerBlock - 1) / samplesPerBlock;
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots((int)std::min<long>(numberOfBlocks, (numberOfThreads_ > 0) ?
+        numberOfThreads_ : numberOfBlocks));
+    std::vector<Worker> workers(numberOfSlots, Worker(*this));
+    std::vector<double> blockSums(numberOfBlocks * NumberOfSummedOutputs, 0.0);
+
+    threadPool->runChunks(numberOfBlocks, 1, [&](int slot, long begin, long end)
+    {
+        for(long block = begin; block < end; block++)
+        {
+            runBlock(workers[slot], inputs, block, &blockSums[block * NumberOfSummedOutputs]);
+        }
+    }, numberOfSlots);
+
+    // Histogram counts are integers, so merging them in any order gives the same totals
+    for(const Worker& worker : workers)
+    {
+        spreadRateHistogram_.merge(worker.spreadRate);
+        flameLengthHistogram_.merge(worker.flameLength);
+        firelineIntensityHistogram_.merge(worker.firelineIntensity);
+        crownFractionBurnedHistogram_.merge(worker.crownFractionBurned);
+        for(int i = 0; i <= FireType::Crowning; i++)
+        {
+            numberOfSamplesOfFireType_[i] += worker.numberOfSamplesOfFireType[i];
+        }
+    }
+
+    for(long block = 0; block < numberOfBlocks; block++)
+    {
+        const double* sums = &blockSums[block * NumberOfSummedOutputs];
+        meanSpreadRate_ += sums[SpreadRateSum];
+        meanFlameLength_ += sums[FlameLengthSum];
+        meanFirelineIntensity_ += sums[FirelineIntensitySum];
+        meanCrownFractionBurned_ += sums[CrownFractionBurnedSum];
+    }
+    meanSpreadRate_ /= inputs.numberOfSamples;
+    meanFlameLength_ /= inputs.numberOfSamples;
+    meanFirelineIntensity_ /= inputs.numberOfSamples;
+    meanCrownFractionBurned_ /= inputs.numberOfSamples;
+}
+
+void MonteCarloRunner::runBlock(Worker& worker, const MonteCarloInputs& inputs, long block, double* blockSums) const
+{
+    long firstSample = block * samplesPerBlock;
+    int numberOfSamples = (int)std::min(samplesPerBlock, inputs.numberOfSamples - firstSample);
+
+    const MonteCarloDistribution* distributions[NumberOfSampledInputs] =
+    {
+        &inputs.windSpeed, &inputs.windDirection, &inputs.moistureOneHour, &inputs.moistureTenHour, &inputs.moistureHundredHour,
+        &inputs.moistureLiveHerbaceous, &inputs.moistureLiveWoody, &inputs.moistureFoliar, &inputs.canopyBaseHeight
+    };
+    double* sampled[NumberOfSampledInputs];
+    for(int input = 0; input < NumberOfSampledInputs; input++)
+    {
+        sampled[input] = &worker.inputs[input * samplesPerBlock];
+        for(int i = 0; i < numberOfSamples; i++)
+        {
+            sampled[input][i] = drawSample(*distributions[input], inputs.seed, firstSample + i, input);
+        }
+    }
+
+    double* spreadRate = &worker.outputs[0];
+    double* flameLength = &worker.outputs[samplesPerBlock];
+    double* firelineIntensity = &worker.outputs[2 * samplesPerBlock];
+    const double canopyHeight = inputs.canopyHeight;
+    bool isBurnable = worker.crown.isFuelModelDefined(inputs.fuelModelNumber) && !worker.crown.isAllFuelLoadZero(inputs.fuelModelNumber);
+
+    for(int i = 0; i < numberOfSamples; i++)
+    {
+        double crownRatio = (canopyHeight > 0.0) ? (canopyHeight - sampled[CanopyBaseHeightInput][i]) / canopyHeight : 0.0;
+        double crownFractionBurned = 0.0;
+        int fireType = FireType::Surface;
+        if(fireMethod_ == MonteCarloFireMethod::Surface)
+        {
+            worker.crownRatio[i] = crownRatio; // Run as one batch below
+        }
+        else if(!isBurnable)
+        {
+            spreadRate[i] = flameLength[i] = firelineIntensity[i] = 0.0;
+        }
+        else
+        {
+            Crown& crown = worker.crown;
+            crown.updateCrownInputs(inputs.fuelModelNumber, sampled[MoistureOneHourInput][i], sampled[MoistureTenHourInput][i],
+                sampled[MoistureHundredHourInput][i], sampled[MoistureLiveHerbaceousInput][i], sampled[MoistureLiveWoodyInput][i],
+                sampled[MoistureFoliarInput][i], FractionUnits::Fraction, sampled[WindSpeedInput][i], SpeedUnits::FeetPerMinute,
+                windHeightInputMode_, sampled[WindDirectionInput][i], windAndSpreadOrientationMode_, inputs.slope, SlopeUnits::Degrees,
+                inputs.aspect, inputs.canopyCover, FractionUnits::Fraction, canopyHeight, sampled[CanopyBaseHeightInput][i],
+                LengthUnits::Feet, crownRatio, FractionUnits::Fraction, inputs.canopyBulkDensity, DensityUnits::PoundsPerCubicFoot);
+            if(fireMethod_ == MonteCarloFireMethod::Rothermel)
+            {
+                crown.doCrownRunRothermel();
+            }
+            else
+            {
+                crown.doCrownRunScottAndReinhardt();
+            }
+            spreadRate[i] = crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+            flameLength[i] = crown.getFinalFlameLength(LengthUnits::Feet);
+            firelineIntensity[i] = crown.getFinalFirelineIntesity(FirelineIntensityUnits::BtusPerFootPerSecond);
+            crownFractionBurned = crown.getCrownFractionBurned();
+            fireType = crown.getFireType();
+        }
+
+        if(fireMethod_ != MonteCarloFireMethod::Surface)
+        {
+            worker.crownFractionBurned.add(crownFractionBurned);
+            worker.numberOfSamplesOfFireType[fireType]++;
+            blockSums[CrownFractionBurnedSum] += crownFractionBurned;
+        }
+    }
+
+    if(fireMethod_ == MonteCarloFireMethod::Surface)
+    {
+        // The site inputs are the same for every sample
+        std::fill(worker.fuelModelNumber.begin(), worker.fuelModelNumber.end(), inputs.fuelModelNumber);
+        std::fill(worker.slope.begin(), worker.slope.end(), inputs.slope);
+        std::fill(worker.aspect.begin(), worker.aspect.end(), inputs.aspect);
+        std::fill(worker.canopyCover.begin(), worker.canopyCover.end(), inputs.canopyCover);
+        std::fill(worker.canopyHeight.begin(), worker.canopyHeight.end(), canopyHeight);
+
+        SurfaceBatchInputs batchInputs = { numberOfSamples, worker.fuelModelNumber.data(), sampled[MoistureOneHourInput],
+            sampled[MoistureTenHourInput], sampled[MoistureHundredHourInput], sampled[MoistureLiveHerbaceousInput],
+            sampled[MoistureLiveWoodyInput], sampled[WindSpeedInput], sampled[WindDirectionInput], worker.slope.data(),
+            worker.aspect.data(), worker.canopyCover.data(), worker.canopyHeight.data(), worker.crownRatio.data() };
+        SurfaceBatchOutputs batchOutputs = { spreadRate, firelineIntensity, flameLength, nullptr, nullptr };
+        worker.surface.setWindHeightInputMode(windHeightInputMode_);
+        worker.surface.setWindAndSpreadOrientationMode(windAndSpreadOrientationMode_);
+        worker.surface.doSurfaceRunBatch(batchInputs, batchOutputs);
+
+        for(int i = 0; i < numberOfSamples; i++)
+        {
+            worker.crownFractionBurned.add(0.0);
+            worker.numberOfSamplesOfFireType[FireType::Surface]++;
+        }
+    }
+
+    for(int i = 0; i < numberOfSamples; i++)
+    {
+        worker.spreadRate.add(spreadRate[i]);
+        worker.flameLength.add(flameLength[i]);
+        worker.firelineIntensity.add(firelineIntensity[i]);
+        blockSums[SpreadRateSum] += spreadRate[i];
+        blockSums[FlameLengthSum] += flameLength[i];
+        blockSums[FirelineIntensitySum] += firelineIntensity[i];
+    }
+}
+
+const MonteCarloHistogram& MonteCarloRunner::getSpreadRateHistogram() const
+{
+    return spreadRateHistogram_;
+}
+
+const MonteCarloHistogram& MonteCarloRunner::getFlameLengthHistogram() const
+{
+    return flameLengthHistogram_;
+}
+
+const MonteCarloHistogram& MonteCarloRunner::getFirelineIntensityHistogram() const
+{
+    return firelineIntensityHistogram_;
+}
+
+const MonteCarloHistogram& MonteCarloRunner::getCrownFractionBurnedHistogram() const
+{
+    return crownFractionBurnedHistogram_;
+}
+
+double MonteCarloRunner::getMeanSpreadRate() const
+{
+    return meanSpreadRate_;
+}
+
+double MonteCarloRunner::getMeanFlameLength() const
+{
+    return meanFlameLength_;
+}
+
+double MonteCarloRunner::getMeanFirelineIntensity() const
+{
+    return meanFirelineIntensity_;
+}
+
+double MonteCarloRunner::getMeanCrownFractionBurned() const
+{
+    return meanCrownFractionBurned_;
+}
+
+long MonteCarloRunner::getNumberOfSamplesOfFireType(FireType::FireTypeEnum fireType) const
+{
+    return (fireType >= FireType::Surface && fireType <= FireType::Crowning) ? numberOfSamplesOfFireType_[fireType] : 0;
+}
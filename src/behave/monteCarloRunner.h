@@ -0,0 +1,203 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Monte Carlo sampling of uncertain surface and crown fire inputs,
+*           accumulated into histograms without storing the samples
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+#ifndef MONTECARLORUNNER_H
+#define MONTECARLORUNNER_H
+
+#include <vector>
+#include "crown.h"
+
+class BehaveRun;
+
+struct MonteCarloDistributionType
+{
+    enum MonteCarloDistributionTypeEnum
+    {
+        Constant,   // always mean
+        Uniform,    // between minimum and maximum
+        Normal,     // mean and standardDeviation, clamped to minimum and maximum when maximum > minimum
+        Triangular  // between minimum and maximum, peaking at mean
+    };
+};
+
+struct MonteCarloDistribution
+{
+    MonteCarloDistributionType::MonteCarloDistributionTypeEnum type;
+    double mean;
+    double standardDeviation;
+    double minimum;
+    double maximum;
+
+    static MonteCarloDistribution constant(double value);
+    static MonteCarloDistribution uniform(double minimum, double maximum);
+    static MonteCarloDistribution normal(double mean, double standardDeviation, double minimum, double maximum);
+    static MonteCarloDistribution triangular(double minimum, double mode, double maximum);
+};
+
+// Inputs of a Monte Carlo run at one site, in base units: slope and aspect in degrees, canopy
+// cover as a fraction, canopy heights in ft, canopy bulk density in lb/ft^3, wind speed in ft/min
+// at the runner's wind height, wind direction in degrees and moistures as fractions
+struct MonteCarloInputs
+{
+    long numberOfSamples;
+    unsigned long long seed;
+
+    int fuelModelNumber;
+    double slope;
+    double aspect;
+    double canopyCover;
+    double canopyHeight;
+    double canopyBulkDensity;
+
+    MonteCarloDistribution windSpeed;
+    MonteCarloDistribution windDirection;
+    MonteCarloDistribution moistureOneHour;
+    MonteCarloDistribution moistureTenHour;
+    MonteCarloDistribution moistureHundredHour;
+    MonteCarloDistribution moistureLiveHerbaceous;
+    MonteCarloDistribution moistureLiveWoody;
+    MonteCarloDistribution moistureFoliar;
+    MonteCarloDistribution canopyBaseHeight;
+};
+
+// Stateless random numbers: the value drawn for a sample depends only on the seed, the sample's
+// index and the stream, so samples come out the same whichever thread runs them
+class CounterBasedRandom
+{
+public:
+    static unsigned long long getBits(unsigned long long seed, unsigned long long counter, unsigned int stream);
+    // Uniform in (0, 1), never exactly 0 or 1
+    static double getUniform(unsigned long long seed, unsigned long long counter, unsigned int stream);
+};
+
+// Fixed-bin histogram of one output. Values outside [minimum, maximum) are counted below or
+// above the bins, and the smallest and largest values seen are kept exactly.
+class MonteCarloHistogram
+{
+public:
+    MonteCarloHistogram(double minimum, double maximum, int numberOfBins);
+
+    void add(double value);
+    void merge(const MonteCarloHistogram& rhs);
+    void clear();
+
+    // Estimate of the value below which the fraction p of the values falls, interpolated linearly
+    // within a bin. Quantiles below or above the bins return the smallest or largest value seen.
+    double getQuantile(double p) const;
+
+    int getNumberOfBins() const;
+    double getBinLowerEdge(int bin) const;
+    long getCount(int bin) const;
+    long getNumberBelowMinimum() const;
+    long getNumberAboveMaximum() const;
+    long getNumberOfValues() const;
+    double getSmallestValue() const;
+    double getLargestValue() const;
+
+protected:
+    double minimum_;
+    double maximum_;
+    double binWidth_;
+    std::vector<long> counts_;
+    long numberBelowMinimum_;
+    long numberAboveMaximum_;
+    long numberOfValues_;
+    double smallestValue_;
+    double largestValue_;
+};
+
+struct MonteCarloFireMethod
+{
+    enum MonteCarloFireMethodEnum
+    {
+        Surface,            // surface fire only, through Surface::doSurfaceRunBatch()
+        Rothermel,
+        ScottAndReinhardt
+    };
+};
+
+// Runs every sample of a MonteCarloInputs and accumulates the outputs into histograms, means and
+// fire type counts. Samples are drawn with CounterBasedRandom and run in fixed blocks shared out
+// over a ThreadPool, each worker on its own copy of the prototype's surface or crown module, and
+// the block results are combined in block order, so the results only depend on the inputs and
+// not on the number of threads.
+class MonteCarloRunner
+{
+public:
+    explicit MonteCarloRunner(const BehaveRun& prototype);
+
+    void setFireMethod(MonteCarloFireMethod::MonteCarloFireMethodEnum fireMethod);
+    void setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode);
+    void setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode);
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+
+    // Bins of the outputs in base units, spread rate in ft/min, flame length in ft and fireline
+    // intensity in btu/ft/s. Crown fraction burned always uses 100 bins from 0 to 1.
+    void setSpreadRateBins(double minimum, double maximum, int numberOfBins);
+    void setFlameLengthBins(double minimum, double maximum, int numberOfBins);
+    void setFirelineIntensityBins(double minimum, double maximum, int numberOfBins);
+
+    void run(const MonteCarloInputs& inputs);
+
+    const MonteCarloHistogram& getSpreadRateHistogram() const;
+    const MonteCarloHistogram& getFlameLengthHistogram() const;
+    const MonteCarloHistogram& getFirelineIntensityHistogram() const;
+    const MonteCarloHistogram& getCrownFractionBurnedHistogram() const;
+    double getMeanSpreadRate() const;
+    double getMeanFlameLength() const;
+    double getMeanFirelineIntensity() const;
+    double getMeanCrownFractionBurned() const;
+    long getNumberOfSamplesOfFireType(FireType::FireTypeEnum fireType) const;
+
+    // The value of one input for one sample, index is the input's position in MonteCarloInputs
+    // starting from windSpeed
+    static double drawSample(const MonteCarloDistribution& distribution, unsigned long long seed, long sample, int index);
+
+protected:
+    struct Worker;
+    void runBlock(Worker& worker, const MonteCarloInputs& inputs, long block, double* blockSums) const;
+
+    Surface surfacePrototype_;
+    Crown crownPrototype_;
+    MonteCarloFireMethod::MonteCarloFireMethodEnum fireMethod_;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode_;
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode_;
+    int numberOfThreads_;
+
+    MonteCarloHistogram spreadRateHistogram_;
+    MonteCarloHistogram flameLengthHistogram_;
+    MonteCarloHistogram firelineIntensityHistogram_;
+    MonteCarloHistogram crownFractionBurnedHistogram_;
+    double meanSpreadRate_;
+    double meanFlameLength_;
+    double meanFirelineIntensity_;
+    double meanCrownFractionBurned_;
+    long numberOfSamplesOfFireType_[FireType::Crowning + 1];
+};
+
+#endif // MONTECARLORUNNER_H
@@ -5,13 +5,27 @@
 
 #include <algorithm>
 #include <functional>
+#include <numeric>
+#include <thread>
 
+#include "instrumentation.h"
 #include "mortality_inputs.h" 
 #include "mortality.h"
 #include "species_master_table.h"
 #include "mortality_equation_table.h"
+#include "threadPool.h"
 
 Mortality::Mortality(SpeciesMasterTable& speciesMasterTable)
+    : Mortality(static_cast<const SpeciesMasterTable&>(speciesMasterTable))
+{
+    // Fill the table only once, Mortality objects sharing a table must not rebuild it under each other
+    if(speciesMasterTable.record_.empty())
+    {
+        speciesMasterTable.initializeMasterTable();
+    }
+}
+
+Mortality::Mortality(const SpeciesMasterTable& speciesMasterTable)
     : boleCharTable_
 {
     { 100,  2.3014,    -0.3267, 1.1137  },
@@ -30,7 +44,6 @@ Mortality::Mortality(SpeciesMasterTable& speciesMasterTable)
     treeCrownLengthScorched_ = -1;
     treeCrownVolumeScorched_ = -1;
     speciesMasterTable_ = &speciesMasterTable;
-    speciesMasterTable_->initializeMasterTable();
     initializeOutputs();
 }
 
@@ -56,6 +69,7 @@ void Mortality::memberwiseCopyAssignment(const Mortality& rhs)
     equationRequiredFieldTable_ = rhs.equationRequiredFieldTable_;
     boleCharTable_ = rhs.boleCharTable_;
     canopyCoefficientTable_ = rhs.canopyCoefficientTable_;
+    equationPlan_ = rhs.equationPlan_;
 }
 
 Mortality::~Mortality()
@@ -101,6 +115,7 @@ void Mortality::setRegion(RegionCode region)
 void Mortality::setSpeciesCode(std::string speciesCode)
 {
     mortalityInputs_.setSpeciesCode(speciesCode);
+    equationPlan_.reset(); // until a matching species record is found
     EquationType equationType = mortalityInputs_.getEquationType();
 
     if (speciesCode != "") {
@@ -117,6 +132,7 @@ void Mortality::setSpeciesCode(std::string speciesCode)
 void Mortality::setEquationType(EquationType equationType)
 {
     mortalityInputs_.setEquationType(equationType);
+    equationPlan_.reset();
     string speciesCode = mortalityInputs_.getSpeciesCode();
   
     if(speciesCode != "" && equationType != EquationType::not_set)
@@ -307,6 +323,7 @@ double Mortality::getBarkThickness(LengthUnits::LengthUnitsEnum barkThicknessUni
 *******************************************************************************************************/
 double Mortality::calculateMortality(FractionUnits::FractionUnitsEnum probablityUnits)
 {
+    BEHAVE_TIME_STAGE(Mortality);
     initializeOutputs();
 
     if (mortalityInputs_.getCrownScorchOrBoleCharEquationNumber() == -1 && mortalityInputs_.getCrownDamageEquationCode() == CrownDamageEquationCode::not_set)
@@ -349,6 +366,243 @@ double Mortality::calculateMortality(FractionUnits::FractionUnitsEnum probablity
     return FractionUnits::fromBaseUnits(probabilityOfMortality_, probablityUnits);
 }
 
+namespace
+{
+// Stand sums for one chunk of a batch, kept per chunk so the totals don't depend on which
+// thread ran which chunk
+struct MortalityStandSums
+{
+    int numberOfTrees = 0;
+    int numberOfErrors = 0;
+    double prefireTrees = 0;
+    double killedTrees = 0;
+    double probabilityOfMortality = 0;
+    double probabilityOfMortalityGreaterThan4DBH = 0;
+    int numberOfTreesGreaterThan4DBH = 0;
+    double killedTreesTimesDBH = 0;
+    double basalAreaPrefire = 0;
+    double basalAreaKilled = 0;
+    double basalAreaPostfire = 0;
+    double prefireCanopyCoverArea = 0;  // square feet, before overlap
+    double postfireCanopyCoverArea = 0;
+};
+
+// A worker's inputs for the group of trees it is working through, set up from the shared inputs
+// once per group so each tree only copies them rather than looking up its species again
+struct MortalityGroupInputs
+{
+    long groupKey = -2; // no group yet
+    bool isResolved = false;
+    MortalityInputs inputs;
+};
+}
+
+/*******************************************************************************************************
+* Name: calculateMortalityBatch
+* Desc: Calculate mortality for a columnar tree list on a pool of threads,
+*       each thread works on its own copy of this Mortality. Trees are
+*       visited grouped by species record and equation type, so a worker
+*       resolves each species' equation plan once per group, and results
+*       are written back in input order.
+*  Ret: stand totals over the trees with a valid probability of mortality
+*******************************************************************************************************/
+MortalityStandTotals Mortality::calculateMortalityBatch(const MortalityBatchInputs& inputs, MortalityBatchOutputs& outputs,
+    int numberOfThreads)
+{
+    if(numberOfThreads <= 0)
+    {
+        numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    const long chunkSize = 1024;
+    long numberOfChunks = (inputs.numberOfTrees + chunkSize - 1) / chunkSize;
+    if(numberOfThreads > numberOfChunks)
+    {
+        numberOfThreads = std::max(1L, numberOfChunks);
+    }
+
+    // Group key of each tree, -1 for trees with no species record
+    std::vector<long> groupKeys(inputs.numberOfTrees);
+    const long numberOfSpecies = (long)speciesMasterTable_->record_.size();
+    for(int i = 0; i < inputs.numberOfTrees; i++)
+    {
+        int speciesIndex = inputs.speciesTableIndex[i];
+        if(speciesIndex >= 0 && speciesIndex < numberOfSpecies)
+        {
+            EquationType equationType = inputs.equationType ? inputs.equationType[i] : speciesMasterTable_->record_[speciesIndex].equationType;
+            groupKeys[i] = (long)speciesIndex * 4 + ((int)equationType + 1);
+        }
+        else
+        {
+            groupKeys[i] = -1;
+        }
+    }
+    std::vector<int> treeOrder(inputs.numberOfTrees);
+    std::iota(treeOrder.begin(), treeOrder.end(), 0);
+    std::stable_sort(treeOrder.begin(), treeOrder.end(), [&](int lhs, int rhs)
+    {
+        return groupKeys[lhs] < groupKeys[rhs];
+    });
+
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots(numberOfThreads);
+    std::vector<Mortality> workers(numberOfSlots, *this);
+    std::vector<MortalityGroupInputs> workerGroupInputs(numberOfSlots);
+    std::vector<MortalityStandSums> chunkSums(numberOfChunks);
+    const MortalityInputs& sharedInputs = mortalityInputs_;
+
+    threadPool->runChunks(inputs.numberOfTrees, chunkSize, [&](int slot, long begin, long end)
+    {
+        Mortality& worker = workers[slot];
+        MortalityGroupInputs& groupInputs = workerGroupInputs[slot];
+        MortalityStandSums& sums = chunkSums[begin / chunkSize];
+        for(long sortedIndex = begin; sortedIndex < end; sortedIndex++)
+        {
+            const int i = treeOrder[sortedIndex];
+            if(groupKeys[i] != groupInputs.groupKey)
+            {
+                // Each group starts from the shared inputs so nothing carries over from the previous one
+                groupInputs.groupKey = groupKeys[i];
+                groupInputs.isResolved = false;
+                worker.mortalityInputs_ = sharedInputs;
+                if(groupKeys[i] >= 0)
+                {
+                    const SpeciesMasterTableRecord& record = speciesMasterTable_->record_[inputs.speciesTableIndex[i]];
+                    EquationType equationType = inputs.equationType ? inputs.equationType[i] : record.equationType;
+                    worker.mortalityInputs_.setSpeciesCode(record.speciesCode);
+                    worker.mortalityInputs_.setEquationType(equationType);
+                    groupInputs.isResolved = worker.updateInputsForSpeciesCodeAndEquationType(record.speciesCode, equationType);
+                }
+                groupInputs.inputs = worker.mortalityInputs_;
+            }
+            else
+            {
+                worker.mortalityInputs_ = groupInputs.inputs;
+            }
+
+            double probabilityOfMortality = -1.0;
+            if(groupInputs.isResolved)
+            {
+                if(inputs.treeDensityPerAcre)
+                {
+                    worker.mortalityInputs_.setTreeDensityPerUnitArea(inputs.treeDensityPerAcre[i], AreaUnits::Acres);
+                }
+                if(inputs.dbh)
+                {
+                    worker.mortalityInputs_.setDBH(inputs.dbh[i], LengthUnits::Inches);
+                }
+                if(inputs.treeHeight)
+                {
+                    worker.mortalityInputs_.setTreeHeight(inputs.treeHeight[i], LengthUnits::Feet);
+                }
+                if(inputs.crownRatio)
+                {
+                    worker.mortalityInputs_.setCrownRatio(inputs.crownRatio[i], FractionUnits::Fraction);
+                }
+                if(inputs.flameLengthOrScorchHeightSwitch)
+                {
+                    worker.mortalityInputs_.setFlameLengthOrScorchHeightSwitch(inputs.flameLengthOrScorchHeightSwitch[i]);
+                }
+                if(inputs.flameLengthOrScorchHeightValue)
+                {
+                    worker.mortalityInputs_.setFlameLengthOrScorchHeightValue(inputs.flameLengthOrScorchHeightValue[i], LengthUnits::Feet);
+                }
+                if(inputs.crownDamage)
+                {
+                    worker.mortalityInputs_.setCrownDamage(inputs.crownDamage[i]);
+                }
+                if(inputs.cambiumKillRating)
+                {
+                    worker.mortalityInputs_.setCambiumKillRating(inputs.cambiumKillRating[i]);
+                }
+                if(inputs.beetleDamage)
+                {
+                    worker.mortalityInputs_.setBeetleDamage(inputs.beetleDamage[i]);
+                }
+                if(inputs.boleCharHeight)
+                {
+                    worker.mortalityInputs_.setBoleCharHeight(inputs.boleCharHeight[i], LengthUnits::Feet);
+                }
+                probabilityOfMortality = worker.calculateMortality(FractionUnits::Fraction);
+            }
+
+            if(outputs.probabilityOfMortality)
+            {
+                outputs.probabilityOfMortality[i] = probabilityOfMortality;
+            }
+            if(outputs.barkThickness)
+            {
+                outputs.barkThickness[i] = worker.mortalityInputs_.getBarkThickness(LengthUnits::Inches);
+            }
+            if(probabilityOfMortality < 0)
+            {
+                if(outputs.killedTrees)
+                {
+                    outputs.killedTrees[i] = 0;
+                }
+                sums.numberOfErrors++;
+                continue;
+            }
+            if(outputs.killedTrees)
+            {
+                outputs.killedTrees[i] = worker.killedTrees_;
+            }
+
+            // calculateMortality() resets the running totals, so they hold this tree's values
+            double dbh = worker.mortalityInputs_.getDBH(LengthUnits::Inches);
+            sums.numberOfTrees++;
+            sums.prefireTrees += worker.mortalityInputs_.getTreeDensityPerUnitArea(AreaUnits::Acres);
+            sums.killedTrees += worker.killedTrees_;
+            sums.probabilityOfMortality += probabilityOfMortality;
+            if(dbh >= 4.0)
+            {
+                sums.probabilityOfMortalityGreaterThan4DBH += probabilityOfMortality;
+                sums.numberOfTreesGreaterThan4DBH++;
+            }
+            sums.killedTreesTimesDBH += dbh * worker.killedTrees_;
+            sums.basalAreaPrefire += worker.basalAreaPrefire_;
+            sums.basalAreaKilled += worker.basalAreaKillled_;
+            sums.basalAreaPostfire += worker.basalAreaPostfire_;
+            sums.prefireCanopyCoverArea += worker.gloabalTotalCoveragePrefireLive_;
+            sums.postfireCanopyCoverArea += worker.globalTotalCoverPostfireLive_;
+        }
+    }, numberOfSlots);
+
+    MortalityStandSums standSums;
+    for(const MortalityStandSums& sums : chunkSums)
+    {
+        standSums.numberOfTrees += sums.numberOfTrees;
+        standSums.numberOfErrors += sums.numberOfErrors;
+        standSums.prefireTrees += sums.prefireTrees;
+        standSums.killedTrees += sums.killedTrees;
+        standSums.probabilityOfMortality += sums.probabilityOfMortality;
+        standSums.probabilityOfMortalityGreaterThan4DBH += sums.probabilityOfMortalityGreaterThan4DBH;
+        standSums.numberOfTreesGreaterThan4DBH += sums.numberOfTreesGreaterThan4DBH;
+        standSums.killedTreesTimesDBH += sums.killedTreesTimesDBH;
+        standSums.basalAreaPrefire += sums.basalAreaPrefire;
+        standSums.basalAreaKilled += sums.basalAreaKilled;
+        standSums.basalAreaPostfire += sums.basalAreaPostfire;
+        standSums.prefireCanopyCoverArea += sums.prefireCanopyCoverArea;
+        standSums.postfireCanopyCoverArea += sums.postfireCanopyCoverArea;
+    }
+
+    MortalityStandTotals standTotals;
+    standTotals.numberOfTrees = standSums.numberOfTrees;
+    standTotals.numberOfErrors = standSums.numberOfErrors;
+    standTotals.totalPrefireTrees = standSums.prefireTrees;
+    standTotals.totalKilledTrees = standSums.killedTrees;
+    standTotals.averageProbabilityOfMortality = (standSums.numberOfTrees > 0) ?
+        standSums.probabilityOfMortality / standSums.numberOfTrees : 0;
+    standTotals.averageProbabilityOfMortalityGreaterThan4DBH = (standSums.numberOfTreesGreaterThan4DBH > 0) ?
+        standSums.probabilityOfMortalityGreaterThan4DBH / standSums.numberOfTreesGreaterThan4DBH : 0;
+    standTotals.averageDBHKilled = (standSums.killedTrees != 0) ? standSums.killedTreesTimesDBH / standSums.killedTrees : 0;
+    standTotals.basalAreaPrefire = standSums.basalAreaPrefire;
+    standTotals.basalAreaKilled = standSums.basalAreaKilled;
+    standTotals.basalAreaPostfire = standSums.basalAreaPostfire;
+    standTotals.prefireCanopyCover = CC_Overlap(standSums.prefireCanopyCoverArea);
+    standTotals.postfireCanopyCover = CC_Overlap(standSums.postfireCanopyCoverArea);
+    return standTotals;
+}
+
 string Mortality::getSpeciesCodeAtSpeciesTableIndex(int index) const
 {
     return speciesMasterTable_->record_[index].speciesCode;
@@ -596,14 +850,15 @@ double  Mortality::calculateMortalityCrownScorch()
     blackHillsFlameLength = Fl;
     scorchHeight = getScorchHeight(LengthUnits::Feet);
 
-    if(speciesMasterTable_->getSpeciesTableIndexFromSpeciesCodeAndEquationType(mortalityInputs_.getSpeciesCode(), mortalityInputs_.getEquationType()) == -1) // Check for Valid Species        
+    if(equationPlan_.speciesTableIndex == -1) // Check for Valid Species        
     {
         //sprintf(cr_ErrMes, "Invalid Species: %s", mortalityInputs_.speciesCode_);
         return -1.0;
     }
 
     // Calculate Bark Thickness
-    mortalityInputs_.setBarkThickness(calculateBarkThickness(), LengthUnits::Inches);
+    const double barkThickness = calculateBarkThickness();
+    mortalityInputs_.setBarkThickness(barkThickness, LengthUnits::Inches);
 
     treeHeight = mortalityInputs_.getTreeHeight(LengthUnits::Feet); // Note-1                        
     HCR = treeHeight * (mortalityInputs_.getCrownRatio(FractionUnits::Fraction));
@@ -645,7 +900,7 @@ double  Mortality::calculateMortalityCrownScorch()
         {
             if(DBH >= 1.0)
             {
-                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-mortalityInputs_.getBarkThickness(LengthUnits::Inches)))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
+                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-barkThickness))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
             }
             else if(CSL > 50.0)
             {
@@ -658,8 +913,7 @@ double  Mortality::calculateMortalityCrownScorch()
             }
             else
             {
-                mortalityInputs_.setBarkThickness(calculateBarkThickness(), LengthUnits::Inches);
-                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-mortalityInputs_.getBarkThickness(LengthUnits::Inches)))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
+                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-barkThickness))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
                 P = P + (1.0 - P) * (1.0 - ((treeHeight - 3.0) / (((1.0 / DBH) * treeHeight) - 3.0)));
             }
             break;
@@ -668,7 +922,7 @@ double  Mortality::calculateMortalityCrownScorch()
         {
             if(DBH > 1.0)
             {
-                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-mortalityInputs_.getBarkThickness(LengthUnits::Inches)))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
+                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-barkThickness))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
             }
             else if(CSL > 50.0)
             {
@@ -680,8 +934,7 @@ double  Mortality::calculateMortalityCrownScorch()
             }
             else
             {
-                mortalityInputs_.setBarkThickness(calculateBarkThickness(), LengthUnits::Inches);
-                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-mortalityInputs_.getBarkThickness(LengthUnits::Inches)))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
+                P = 1.0 / (1.0 + exp(-1.941 + (6.316 * (1.0 - exp(-barkThickness))) - 0.000535 * (crownVolumeScorchedPercent * crownVolumeScorchedPercent)));
                 P = P + (1.0 - P) * (1.0 - ((treeHeight - 3.0) / (((1.0 / DBH) * treeHeight) - 3.0)));
             }
             if(P < 0.8)
@@ -1752,40 +2005,26 @@ double Mortality::Eq_DouglasFir_DF()
 *******************************************************************************************************/
 double Mortality::BoleCharCalculate()
 {
-    int i;
     double f;
     double dbh_centimeters;
     double bole_char_height_meters;
     double B1, B2, B3;
     f = 0;
 
-    for (i = 0; i < boleCharTable_.size(); i++)
+    if(!equationPlan_.hasBoleCharCoefficients)
     {
-        if(boleCharTable_[i].equationNumber == mortalityInputs_.getCrownScorchOrBoleCharEquationNumber())
-        {
-            break; // found it
-        }
-        else if(boleCharTable_[i].equationNumber == -1)
-        {
-            return -1; // Error - didn't find equation number in table
-        }
+        return -1; // Error - didn't find equation number in table
     }
     
-    B1 = boleCharTable_[i].B1; // spreadsheet column - formula coefficent
-    B2 = boleCharTable_[i].B2;
-    B3 = boleCharTable_[i].B3;
+    B1 = equationPlan_.boleCharB1; // spreadsheet column - formula coefficent
+    B2 = equationPlan_.boleCharB2;
+    B3 = equationPlan_.boleCharB3;
 
     dbh_centimeters = LengthUnits::fromBaseUnits(mortalityInputs_.getDBH(LengthUnits::Feet), LengthUnits::Centimeters);
     bole_char_height_meters = LengthUnits::fromBaseUnits(mortalityInputs_.getBoleCharHeight(LengthUnits::Feet), LengthUnits::Meters);
     f = 1.0 / (1.0 + exp(-1.0*(B1 + (B2*dbh_centimeters) + (B3*bole_char_height_meters))));
      // will also get put into a_MO as whole int value
 
-    // test..................................
-    double a, b;
-    a = -1.0*(B1 + (B2*dbh_centimeters) + (B3*bole_char_height_meters));
-    b = exp(a);
-
-    // test.................................
     calculateMortalityTotals(); // Accumulate and calculate averages, etc.
     return f;
 }
@@ -1852,119 +2091,24 @@ SpeciesMasterTableRecord Mortality::getSpeciesRecordBySpeciesCodeAndEquationType
 
 std::vector<SpeciesMasterTableRecord> Mortality::getSpeciesRecordVectorForRegion(RegionCode region) const
 {
-    std::vector<SpeciesMasterTableRecord> speciesInSelectedRegion;
-    bool isErroneousInput = false;
-    for(int i = 0; i < speciesMasterTable_->record_.size(); i++)
-    {
-        switch(region)
-        {
-            case RegionCode::interior_west:
-            {
-                if(speciesMasterTable_->record_[i].regionInteriorWest == (int)RegionCode::interior_west)
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            case RegionCode::pacific_west:
-            {
-                if(speciesMasterTable_->record_[i].regionPacificWest == (int)RegionCode::pacific_west)
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            case RegionCode::north_east:
-            {
-                if(speciesMasterTable_->record_[i].regionNorthEast == (int)RegionCode::north_east)
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            case RegionCode::south_east:
-            {
-                if(speciesMasterTable_->record_[i].regionSouthEast == (int)RegionCode::south_east)
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            default: // error case
-            {
-                isErroneousInput = true;
-                break;
-            }
-        }
-
-        if(isErroneousInput)
-        {
-            break; // get out of for loop
-        }
-    }
-
-    return speciesInSelectedRegion;
+    SpeciesMasterTableRecordSpan speciesInSelectedRegion = getSpeciesRecordSpanForRegion(region);
+    return std::vector<SpeciesMasterTableRecord>(speciesInSelectedRegion.begin(), speciesInSelectedRegion.end());
 }
 
 std::vector<SpeciesMasterTableRecord> Mortality::getSpeciesRecordVectorForRegionAndEquationType(RegionCode region, EquationType equationType) const
 {
-    std::vector<SpeciesMasterTableRecord> speciesInSelectedRegion;
-    bool isErroneousInput = false;
-   
-    for(int i = 0; i < speciesMasterTable_->record_.size(); i++)
-    {
-        switch(region)
-        {
-            case RegionCode::interior_west:
-            {
-                if((speciesMasterTable_->record_[i].regionInteriorWest == (int)RegionCode::interior_west) &&
-                    (speciesMasterTable_->record_[i].equationType == equationType))
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            case RegionCode::pacific_west:
-            {
-                if((speciesMasterTable_->record_[i].regionPacificWest == (int)RegionCode::pacific_west) &&
-                    (speciesMasterTable_->record_[i].equationType == equationType))
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            case RegionCode::north_east:
-            {
-                if((speciesMasterTable_->record_[i].regionNorthEast == (int)RegionCode::north_east) &&
-                    (speciesMasterTable_->record_[i].equationType == equationType))
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            case RegionCode::south_east:
-            {
-                if((speciesMasterTable_->record_[i].regionSouthEast == (int)RegionCode::south_east) &&
-                    (speciesMasterTable_->record_[i].equationType == equationType))
-                {
-                    speciesInSelectedRegion.push_back(speciesMasterTable_->record_[i]);
-                }
-                break;
-            }
-            default: // error case
-            {
-                isErroneousInput = true;
-                break;
-            }
-        }
+    SpeciesMasterTableRecordSpan speciesInSelectedRegion = getSpeciesRecordSpanForRegionAndEquationType(region, equationType);
+    return std::vector<SpeciesMasterTableRecord>(speciesInSelectedRegion.begin(), speciesInSelectedRegion.end());
+}
 
-        if(isErroneousInput)
-        {
-            break; // get out of for loop
-        }
-    }
+SpeciesMasterTableRecordSpan Mortality::getSpeciesRecordSpanForRegion(RegionCode region) const
+{
+    return speciesMasterTable_->getRecordSpanForRegion(region);
+}
 
-    return speciesInSelectedRegion;
+SpeciesMasterTableRecordSpan Mortality::getSpeciesRecordSpanForRegionAndEquationType(RegionCode region, EquationType equationType) const
+{
+    return speciesMasterTable_->getRecordSpanForRegionAndEquationType(region, equationType);
 }
 
 double Mortality::getProbabilityOfMortality(FractionUnits::FractionUnitsEnum probabilityUnits) const
@@ -2034,246 +2178,114 @@ bool Mortality::updateInputsForSpeciesCodeAndEquationType(std::string speciesCod
 
         mortalityInputs_.isFieldRequiredVector_ = equationRequiredFieldTable_.getRequiredFieldVector(mortalityInputs_.getEquationType(), mortalityInputs_.getCrownDamageEquationCode());
         mortalityInputs_.setCrownDamageType(equationRequiredFieldTable_.getCrownDamageType(mortalityInputs_.getEquationType(), mortalityInputs_.getCrownDamageEquationCode()));
+        resolveEquationPlan(speciesIndex);
         return true; // OK
     }
 
+    equationPlan_.reset();
     return false; // Error
 }
 
+/*************************************************************
+* Name: resolveEquationPlan
+* Desc: Look up the bark thickness, bole char and canopy cover
+*       coefficients for a species master table record once,
+*       so each tree's calculation can use them directly
+**************************************************************/
+void Mortality::resolveEquationPlan(int speciesTableIndex)
+{
+    const SpeciesMasterTableRecord& record = speciesMasterTable_->record_[speciesTableIndex];
+    equationPlan_.reset();
+    equationPlan_.speciesTableIndex = speciesTableIndex;
+    equationPlan_.barkThicknessPerInchDBH = getBarkThicknessPerInchDBH(record.barkEquationNumber);
+
+    for(int i = 0; i < (int)boleCharTable_.size() && boleCharTable_[i].equationNumber != -1; i++)
+    {
+        if(boleCharTable_[i].equationNumber == record.mortalityEquationNumber)
+        {
+            equationPlan_.hasBoleCharCoefficients = true;
+            equationPlan_.boleCharB1 = boleCharTable_[i].B1;
+            equationPlan_.boleCharB2 = boleCharTable_[i].B2;
+            equationPlan_.boleCharB3 = boleCharTable_[i].B3;
+            break;
+        }
+    }
+
+    if(record.crownCoefficientCode >= 0 && record.crownCoefficientCode < (int)canopyCoefficientTable_.record_.size())
+    {
+        const CanopyCoefficientTableRecord& canopyCoefficients = canopyCoefficientTable_.record_[record.crownCoefficientCode];
+        equationPlan_.hasCanopyCoefficients = true;
+        equationPlan_.canopyCoefficientR = canopyCoefficients.coefficientR_;
+        equationPlan_.canopyCoefficientA = canopyCoefficients.coefficientA_;
+        equationPlan_.canopyCoefficientB = canopyCoefficients.coefficientB_;
+    }
+}
+
+Mortality::EquationPlan::EquationPlan()
+{
+    reset();
+}
+
+void Mortality::EquationPlan::reset()
+{
+    speciesTableIndex = -1;
+    barkThicknessPerInchDBH = -1;
+    hasBoleCharCoefficients = false;
+    boleCharB1 = 0;
+    boleCharB2 = 0;
+    boleCharB3 = 0;
+    hasCanopyCoefficients = false;
+    canopyCoefficientR = 0;
+    canopyCoefficientA = 0;
+    canopyCoefficientB = 0;
+}
+
 /****************************************************************************
 * Name: calculateBarkThickness
-* Desc: Calculate the Bark Thickness
-*   In: speciesCode....Species
-*       dbh.....DBH
-* Note-1: Equation(s) that do not use a bark thickness equation
-*         Ex: PIPA2
+* Desc: Calculate the Bark Thickness from the current equation plan
+*   In: dbh.....DBH
 *  Ret: bark thinkness,
 *      -1 if no equation
 ****************************************************************************/
 double Mortality::calculateBarkThickness()
 {
-    int index, barkEquation;
-    double f, barkThickness;
-    index = speciesMasterTable_->getSpeciesTableIndexFromSpeciesCodeAndEquationType(mortalityInputs_.getSpeciesCode(), mortalityInputs_.getEquationType());
-    if(index < 0)
+    if(equationPlan_.barkThicknessPerInchDBH < 0)
     {
         //strcpy(errMes, "Logic Error - Can't Find Species in function calculateBarkThickness");
         return -1;
     }
+    return equationPlan_.barkThicknessPerInchDBH * mortalityInputs_.getDBH(LengthUnits::Inches);
+}
 
-    barkEquation = speciesMasterTable_->record_[index].barkEquationNumber;
-
-    switch(barkEquation)
+/****************************************************************************
+* Name: getBarkThicknessPerInchDBH
+* Desc: Bark thickness per inch of DBH for a species master table bark
+*        equation number
+* Note-1: Equation(s) that do not use a bark thickness equation
+*         Ex: PIPA2
+*  Ret: bark thickness in inches per inch of DBH,
+*      -1 if no equation
+****************************************************************************/
+double Mortality::getBarkThicknessPerInchDBH(int barkEquationNumber)
+{
+    static const double barkThicknessPerInchDBH[] = // bark equations 1 to 39
     {
-        case 1:
-        {
-            f = 0.019;
-            break;
-        }
-        case 2:
-        {
-            f = 0.022;
-            break;
-        }
-        case 3:
-        {
-            f = 0.024;
-            break;
-        }
-        case 4:
-        {
-            f = 0.025;
-            break;
-        }
-        case 5:
-        {
-            f = 0.026;
-            break;
-        }
-        case 6:
-        {
-            f = 0.027;
-            break;
-        }
-        case 7:
-        {
-            f = 0.028;
-            break;
-        }
-        case 8:
-        {
-            f = 0.029;
-            break;
-        }
-        case 9:
-        {
-            f = 0.03;
-            break;
-        }
-        case 10:
-        {
-            f = 0.031;
-            break;
-        }
-        case 11:
-        {
-            f = 0.032;
-            break;
-        }
-        case 12:
-        {
-            f = 0.033;
-            break;
-        }
-        case 13:
-        {
-            f = 0.034;
-            break;
-        }
-        case 14:
-        {
-            f = 0.035;
-            break;
-        }
-        case 15:
-        {
-            f = 0.036;
-            break;
-        }
-        case 16:
-        {
-            f = 0.037;
-            break;
-        }
-        case 17:
-        {
-            f = 0.038;
-            break;
-        }
-        case 18:
-        {
-            f = 0.039;
-            break;
-        }
-        case 19:
-        {
-            f = 0.04;
-            break;
-        }
-        case 20:
-        {
-            f = 0.041;
-            break;
-        }
-        case 21:
-        {
-            f = 0.042;
-            break;
-        }
-        case 22:
-        {
-            f = 0.043;
-            break;
-        }
-        case 23:
-        {
-            f = 0.044;
-            break;
-        }
-        case 24:
-        {
-            f = 0.045;
-            break;
-        }
-        case 25:
-        {
-            f = 0.046;
-            break;
-        }
-        case 26:
-        {
-            f = 0.047;
-            break;
-        }
-        case 27:
-        {
-            f = 0.048;
-            break;
-        }
-        case 28:
-        {
-            f = 0.049;
-            break;
-        }
-        case 29:
-        {
-            f = 0.05;
-            break;
-        }
-        case 30:
-        {
-            f = 0.052;
-            break;
-        }
-        case 31:
-        {
-            f = 0.055;
-            break;
-        }
-        case 32:
-        {
-            f = 0.057;
-            break;
-        }
-        case 33:
-        {
-            f = 0.059;
-            break;
-        }
-        case 34:
-        {
-            f = 0.06;
-            break;
-        }
-        case 35:
-        {
-            f = 0.062;
-            break;
-        }
-        case 36:
-        {
-            f = 0.063;
-            break;
-        }
-        case 37:
-        {
-            f = 0.068;
-            break;
-        }
-        case 38:
-        {
-            f = 0.072;
-            break;
-        }
-        case 39:
-        {
-            f = 0.081;
-            break;
-        }
-        case 100: // See Note-1 above
-        {
-            f = 0;
-            break;
-        }
-        default:
-        {
-            return -1;
-            break;
-        }
+        0.019, 0.022, 0.024, 0.025, 0.026, 0.027, 0.028, 0.029, 0.03, 0.031,
+        0.032, 0.033, 0.034, 0.035, 0.036, 0.037, 0.038, 0.039, 0.04, 0.041,
+        0.042, 0.043, 0.044, 0.045, 0.046, 0.047, 0.048, 0.049, 0.05, 0.052,
+        0.055, 0.057, 0.059, 0.06, 0.062, 0.063, 0.068, 0.072, 0.081
+    };
+    const int numberOfBarkEquations = sizeof(barkThicknessPerInchDBH) / sizeof(barkThicknessPerInchDBH[0]);
+
+    if(barkEquationNumber >= 1 && barkEquationNumber <= numberOfBarkEquations)
+    {
+        return barkThicknessPerInchDBH[barkEquationNumber - 1];
     }
-
-    barkThickness = f * mortalityInputs_.getDBH(LengthUnits::Inches);
-    return barkThickness;
+    if(barkEquationNumber == 100) // See Note-1 above
+    {
+        return 0;
+    }
+    return -1;
 }
 
 /****************************************************************************
@@ -2290,7 +2302,6 @@ double Mortality::calculateBarkThickness()
 ****************************************************************************/
 double Mortality::calculateCrownCover()
 {
-    int speciesTableIndex;
     double f, r, a;
 
     if(mortalityInputs_.getTreeHeight(LengthUnits::Feet) <= 0)
@@ -2302,22 +2313,23 @@ double Mortality::calculateCrownCover()
         return 0;
     }
 
-    speciesTableIndex = speciesMasterTable_->getSpeciesTableIndexFromSpeciesCodeAndEquationType(mortalityInputs_.getSpeciesCode(), mortalityInputs_.getEquationType()); // Get index into Species table
-
-    const int canopyCoefficientTableIndex = speciesMasterTable_->record_[speciesTableIndex].crownCoefficientCode;
+    if(!equationPlan_.hasCanopyCoefficients)
+    {
+        return 0;
+    }
 
     /* Get Diameter of Crown using Coefficients                                  */
     if(mortalityInputs_.getTreeHeight(LengthUnits::Feet) <= 4.5) // Small trees
     {
         //f = s_CCT.coefficientR_ * Dia;
-        f = canopyCoefficientTable_.record_[canopyCoefficientTableIndex].coefficientR_ * mortalityInputs_.getDBH(LengthUnits::Inches);
+        f = equationPlan_.canopyCoefficientR * mortalityInputs_.getDBH(LengthUnits::Inches);
     }
     else // Large Trees
     {
         //f = pow((double)Dia, (double)s_CCT.coefficientB_); // raise it to power
-        f = pow((double)mortalityInputs_.getDBH(LengthUnits::Inches), (double)canopyCoefficientTable_.record_[canopyCoefficientTableIndex].coefficientB_); // raise it to power
+        f = pow((double)mortalityInputs_.getDBH(LengthUnits::Inches), equationPlan_.canopyCoefficientB); // raise it to power
         //f = f * s_CCT.coefficientA_;  // and multiply
-        f = f * canopyCoefficientTable_.record_[canopyCoefficientTableIndex].coefficientA_;  // and multiply
+        f = f * equationPlan_.canopyCoefficientA;  // and multiply
     }
 
     /* Use Diameter of Crown to get Area..........                               */
@@ -13,12 +13,66 @@
 #include "canopy_coefficient_table.h"
 #include "mortality_inputs.h"
 
+// Structure-of-arrays tree list for Mortality::calculateMortalityBatch(), each array holds
+// numberOfTrees values. Species are given by species master table index. DBH is in inches,
+// heights and flame length or scorch height in feet, crown ratio as a fraction, crown damage
+// in percent and tree density in trees per acre. Any array other than speciesTableIndex may be
+// null, every tree then uses the calling Mortality's current value for that input (and the
+// species record's equation type when equationType is null).
+struct MortalityBatchInputs
+{
+    int numberOfTrees;
+    const int* speciesTableIndex;
+    const EquationType* equationType;
+    const double* treeDensityPerAcre;
+    const double* dbh;
+    const double* treeHeight;
+    const double* crownRatio;
+    const FlameLengthOrScorchHeightSwitch* flameLengthOrScorchHeightSwitch;
+    const double* flameLengthOrScorchHeightValue;
+    const double* crownDamage;
+    const double* cambiumKillRating;
+    const BeetleDamage* beetleDamage;
+    const double* boleCharHeight;
+};
+
+// Caller-provided output arrays for Mortality::calculateMortalityBatch(), each sized for
+// numberOfTrees values: probability of mortality as a fraction (-1 when it can't be
+// calculated), bark thickness in inches (-1 when the tree's equation doesn't use it) and
+// killed trees per acre. Any array may be null.
+struct MortalityBatchOutputs
+{
+    double* probabilityOfMortality;
+    double* barkThickness;
+    double* killedTrees;
+};
+
+// Stand totals over the trees of a batch with a valid probability of mortality, accumulated
+// as calculateMortalityTotals() does for a single tree. Averages and canopy covers are not
+// rounded to whole numbers.
+struct MortalityStandTotals
+{
+    int numberOfTrees;                           // trees with a valid probability of mortality
+    int numberOfErrors;                          // trees whose probability of mortality is -1
+    double totalPrefireTrees;                    // trees per acre
+    double totalKilledTrees;                     // trees per acre
+    double averageProbabilityOfMortality;        // fraction
+    double averageProbabilityOfMortalityGreaterThan4DBH; // fraction, trees with DBH of 4 inches or more
+    double averageDBHKilled;                     // inches
+    double basalAreaPrefire;                     // square feet per acre
+    double basalAreaKilled;                      // square feet per acre
+    double basalAreaPostfire;                    // square feet per acre
+    double prefireCanopyCover;                   // percent
+    double postfireCanopyCover;                  // percent
+};
+
 //.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.
 class Mortality
 {
 public:
     Mortality() = delete; // There is no default constructor
-    explicit Mortality(SpeciesMasterTable& speciesMasterTable);
+    explicit Mortality(SpeciesMasterTable& speciesMasterTable); // Initializes the table if it is empty
+    explicit Mortality(const SpeciesMasterTable& speciesMasterTable); // The table must already be initialized
     Mortality(const Mortality& rhs);
     Mortality& operator=(const Mortality& rhs);
     ~Mortality();
@@ -74,6 +128,12 @@ public:
 
     double calculateMortality(FractionUnits::FractionUnitsEnum probablityUnits);
 
+    // Runs every tree of the batch through its own copy of this Mortality, using the current
+    // region, fire severity and other inputs the batch doesn't supply, on numberOfThreads
+    // threads (0 for one per hardware thread). The species master table is only read.
+    MortalityStandTotals calculateMortalityBatch(const MortalityBatchInputs& inputs, MortalityBatchOutputs& outputs,
+        int numberOfThreads);
+
     // Species Master Table Interface
     string getSpeciesCodeAtSpeciesTableIndex(int index) const;
     string getScientificNameAtSpeciesTableIndex(int index) const;
@@ -104,6 +164,9 @@ public:
 
     std::vector<SpeciesMasterTableRecord> getSpeciesRecordVectorForRegion(RegionCode region) const;
     std::vector<SpeciesMasterTableRecord> getSpeciesRecordVectorForRegionAndEquationType(RegionCode region, EquationType equationType) const;
+    // Same records as above without copying, valid until the species master table changes
+    SpeciesMasterTableRecordSpan getSpeciesRecordSpanForRegion(RegionCode region) const;
+    SpeciesMasterTableRecordSpan getSpeciesRecordSpanForRegionAndEquationType(RegionCode region, EquationType equationType) const;
 
     // Mortality outputs getters
     double getProbabilityOfMortality(FractionUnits::FractionUnitsEnum probabilityUnits) const;   // Individual Species Probility of Mortality
@@ -120,8 +183,30 @@ public:
     double postfireCanopyCover() const;         // Postfire Canopy Cover             
 
 protected:
+    // Everything about the current species and equation type that is the same for every tree,
+    // resolved by updateInputsForSpeciesCodeAndEquationType() so the per-tree calculations need
+    // no table searches or equation number switches
+    struct EquationPlan
+    {
+        EquationPlan();
+        void reset();
+
+        int speciesTableIndex;          // -1 if the species and equation type aren't in the table
+        double barkThicknessPerInchDBH; // -1 if the species has no bark thickness equation
+        bool hasBoleCharCoefficients;
+        double boleCharB1;
+        double boleCharB2;
+        double boleCharB3;
+        bool hasCanopyCoefficients;
+        double canopyCoefficientR;      // crown diameter per inch DBH for trees up to 4.5 ft
+        double canopyCoefficientA;      // crown diameter is A * DBH^B for taller trees
+        double canopyCoefficientB;
+    };
+
     void memberwiseCopyAssignment(const Mortality& rhs);
     void initializeOutputs();
+    void resolveEquationPlan(int speciesTableIndex);
+    static double getBarkThicknessPerInchDBH(int barkEquationNumber);
 
     double calculateMortalityCrownScorch();
 
@@ -170,10 +255,11 @@ protected:
     MortalityInputs mortalityInputs_;
     //MortalityOutputs mortalityOutputs_;
 
-    SpeciesMasterTable* speciesMasterTable_;
+    const SpeciesMasterTable* speciesMasterTable_;
     EquationRequiredFieldTable equationRequiredFieldTable_;
     std::vector <BoleCharCoefficientTableRecord> boleCharTable_;
     CanopyCoefficientTable canopyCoefficientTable_;
+    EquationPlan equationPlan_;
 
     //.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.
     // Low and High Limits on Flame Length and Scorch Height                     
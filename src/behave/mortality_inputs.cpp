@@ -12,6 +12,7 @@
 
 MortalityInputs::MortalityInputs()
 {
+    region_ = RegionCode::interior_west;
     speciesCode_ = "";
     equationType_ = EquationType::not_set;
     densityPerAcre_ = -1.0;
@@ -30,6 +31,10 @@ MortalityInputs::MortalityInputs()
     cambiumKillRating_ = -1.0;
     beetleDamage_ = BeetleDamage::not_set;
     boleCharHeight_ = -1.0;
+    barkThickness_ = -1.0;
+    crownScorchOrBoleCharEquationNumber_ = -1;
+    crownDamageEquationCode_ = CrownDamageEquationCode::not_set;
+    crownDamageType_ = CrownDamageType::not_set;
 
     isFieldRequiredVector_.resize((int)RequiredFieldNames::num_inputs);
     std::fill(isFieldRequiredVector_.begin(), isFieldRequiredVector_.end(), false);
@@ -55,6 +60,7 @@ MortalityInputs& MortalityInputs::operator=(const MortalityInputs& rhs)
 
 void MortalityInputs::memberwiseCopyAssignment(const MortalityInputs& rhs)
 {
+    region_ = rhs.region_;
     speciesCode_ = rhs.speciesCode_;
     equationType_ = rhs.equationType_;
     densityPerAcre_ = rhs.densityPerAcre_;
@@ -64,12 +70,19 @@ void MortalityInputs::memberwiseCopyAssignment(const MortalityInputs& rhs)
     flameLengthOrScorchHeightSwitch_ = rhs.flameLengthOrScorchHeightSwitch_;
     flameLengthOrScorchHeightValue_ = rhs.flameLengthOrScorchHeightValue_; // depreacated
     flameLength_ = rhs.flameLength_;
-    scorchHeight_ = rhs.flameLength_;
+    scorchHeight_ = rhs.scorchHeight_;
     fireSeverity_ = rhs.fireSeverity_;
     crownDamage_ = rhs.crownDamage_;
     cambiumKillRating_ = rhs.cambiumKillRating_;
     beetleDamage_ = rhs.beetleDamage_;
     boleCharHeight_ = rhs.boleCharHeight_;
+    crownScorchOrBoleCharEquationNumber_ = rhs.crownScorchOrBoleCharEquationNumber_;
+    crownDamageEquationCode_ = rhs.crownDamageEquationCode_;
+    crownDamageType_ = rhs.crownDamageType_;
+    barkThickness_ = rhs.barkThickness_;
+    firelineIntensity_ = rhs.firelineIntensity_;
+    midFlameWindSpeed_ = rhs.midFlameWindSpeed_;
+    airTemperature_ = rhs.airTemperature_;
     isFieldRequiredVector_ = rhs.isFieldRequiredVector_; 
 }
 
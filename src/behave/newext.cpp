@@ -87,97 +87,35 @@ bool Extension::allocExtension(long p_blocks, long p_cols, long p_rows,
     m_cells = m_cols * m_rows;
     m_leeFuels = m_fuels * m_fuels;
 
-#ifndef USE_OLD_METHOD
-    // Allocate one large block of doubles for the following:
-    //  Variable        Doubles                 Pointers
-    //  m_combArray     m_blocks * m_cells      m_blocks
-    //  m_rosArray      m_blocks * m_cells      m_blocks
-    //  m_cuumProb      m_blocks                0
-    //  m_maxRosArray   m_blocks                0
-    int doubles = 2 * m_blocks + 2 * (m_blocks * m_cells);
-    int pointers = 2 * m_blocks;
-    int blockSize = pointers * sizeof(double *) + doubles * sizeof(double);
-    m_blockPtr = new char[blockSize];
-    if (!m_blockPtr)
+    // Allocate the block probabilities and spread rates, each contiguous
+    if (!m_combArray.alloc(m_blocks, m_cells)
+        || !m_rosArray.alloc(m_blocks, m_cells))
     {
+        freeExtension();
         return(false);
     }
-    memset(m_blockPtr, 0x0, blockSize * sizeof(char));
-
-    int i, len;
-    // Start of m_combArray of pointers to doubles
-    char *cPtr = m_blockPtr;
-    m_combArray = (double **)cPtr;
-    len = m_blocks * sizeof(double *);
-    cPtr += len;         // Move to end of pointer array
-    // Set pointers to start of each cell block of doubles
-    for (i = 0; i < m_blocks; i++)
-    {
-        m_combArray[i] = (double *)cPtr;
-        cPtr += (m_cells * sizeof(double));
-    }
 
-    // Start of m_rosArray of pointers to doubles
-    m_rosArray = (double **)cPtr;
-    len = m_blocks * sizeof(double *);
-    cPtr += len;           // Move to end of pointer array
-    // Set pointers to start of each cell block of doubles
-    for (i = 0; i < m_blocks; i++)
+    // Allocate one block of doubles for the following:
+    //  Variable        Doubles
+    //  m_maxRosArray   m_blocks
+    //  m_cuumProb      m_blocks
+    int blockSize = 2 * m_blocks * sizeof(double);
+    m_blockPtr = new char[blockSize];
+    if (!m_blockPtr)
     {
-        m_rosArray[i] = (double *)cPtr;
-        cPtr += (m_cells * sizeof(double));
+        freeExtension();
+        return(false);
     }
+    memset(m_blockPtr, 0x0, blockSize * sizeof(char));
 
     // Start of m_maxRosArray data array of doubles
+    char *cPtr = m_blockPtr;
     m_maxRosArray = (double *)cPtr;
-    len = m_blocks * sizeof(double);
-    cPtr += len;
+    cPtr += m_blocks * sizeof(double);
     // Start of m_cuumProb data array of doubles
     m_cuumProb = (double *)cPtr;
 
     return(true);
-#else
-    if ( ! ( m_combArray = new double*[m_blocks] ) )
-    {
-        return( false );
-    }
-
-    if ( ! ( m_rosArray = new double*[m_blocks] ) )
-    {
-        freeExtension();
-        return( false );
-    }
-
-    for ( long i=0; i<m_blocks; i++ )
-    {
-        if ( ! ( m_combArray[i] = new double[ m_cells ] ) )
-        {
-            freeExtension();
-            return( false );
-        }
-        if ( ! ( m_rosArray[i]  = new double[ m_cells ] ) )
-        {
-            freeExtension();
-            return( false );
-        }
-    }
-
-    if ( ! ( m_cuumProb = new double[ m_blocks ] ) )
-    {
-        freeExtension();
-        return( false );
-    }
-    memset( m_cuumProb, 0x0, m_blocks * sizeof( double ) );
-
-    if ( ! ( m_maxRosArray = new double[ m_blocks ] ) )
-    {
-        freeExtension();
-        return( false );
-    }
-    memset( m_maxRosArray, 0x0, m_blocks * sizeof( double ) );
-
-    return( true );
-#endif
 }
 
 //------------------------------------------------------------------------------
@@ -205,6 +143,28 @@ double Extension::calcProb(long p_block, bool p_subtFaster)
     return(prob);
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Same as calcProb(p_block, true) with the faster probabilities of
+ *  the outer extensions, which are the same for every block, worked out
+ *  beforehand by getNextFasterProbs().
+ *
+ *  Looping over the blocks this way takes m_blocks steps instead of
+ *  m_blocks times the number of blocks of the outer extensions.
+ */
+
+double Extension::calcProb(long p_block, double p_nextFasterProbs)
+{
+    double prob = 1.0;
+
+    for (long i = 0; i < m_cells; i++)
+    {
+        prob *= ((double)m_combArray[p_block][i]);
+    }
+    prob *= m_latProb;
+    prob -= m_cuumProb[p_block] + p_nextFasterProbs;
+    return(prob);
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Frees all dynamically allocated memory and reset all data to
  *  initial values.
@@ -212,52 +172,12 @@ double Extension::calcProb(long p_block, bool p_subtFaster)
 
 void Extension::freeExtension(void)
 {
-#ifndef USE_OLD_METHOD
     if (m_blockPtr)
     {
         delete[] m_blockPtr;
     }
-#else
-    for ( int i=0; i<m_blocks; i++ )
-    {
-        if ( m_combArray )
-        {
-            if ( m_combArray[i] )
-            {
-                delete[] m_combArray[i];
-                m_combArray[i] = 0;
-            }
-        }
-        if ( m_rosArray )
-        {
-            if ( m_rosArray[i] )
-            {
-                delete[] m_rosArray[i];
-                m_rosArray[i] = 0;
-            }
-        }
-    }
-    if ( m_combArray )
-    {
-        delete[] m_combArray;
-        m_combArray = 0;
-    }
-    if ( m_rosArray )
-    {
-        delete m_rosArray;
-        m_rosArray = 0;
-    }
-    if ( m_cuumProb )
-    {
-        delete[] m_cuumProb;
-        m_cuumProb = 0;
-    }
-    if ( m_maxRosArray )
-    {
-        delete[] m_maxRosArray;
-        m_maxRosArray = 0;
-    }
-#endif
+    m_combArray.free();
+    m_rosArray.free();
     init();
     return;
 }
@@ -279,6 +199,27 @@ double Extension::getFasterProbs(long p_block)
     return(prob);
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Sums the probabilities of faster spread rates in the outer
+ *  extensions, the part of getFasterProbs() that does not depend on the
+ *  block.
+ */
+
+double Extension::getNextFasterProbs(void) const
+{
+    double prob = 0.0;
+    const Extension *xt = m_nextExt;
+    while (xt != NULL)
+    {
+        for (int i = 0; i < xt->m_blocks; i++)
+        {
+            prob += xt->m_cuumProb[i];
+        }
+        xt = xt->m_nextExt;
+    }
+    return(prob);
+}
+
 //------------------------------------------------------------------------------
 
 void Extension::init(void)
@@ -292,8 +233,6 @@ void Extension::init(void)
     m_nextExt = 0;
     m_rf = 0;
     m_maxRosArray = 0;
-    m_combArray = 0;
-    m_rosArray = 0;
 
     // Private data
     m_prob = 0.0;
@@ -306,8 +245,6 @@ void Extension::init(void)
     m_leeFuels = 0;
     m_cuumProb = 0;
     m_blockPtr = 0;
-    m_latRosArray = 0;
-    m_latCombArray = 0;
     return;
 }
 
@@ -323,10 +260,17 @@ void Extension::run(long p_lats, double *p_latRos, double *p_latComb,
     m_extAverageRos = 0.0;
     double maxRos = p_maxRos;
 
-    //
-    m_rf->calcExtendedSpreadRates2(m_cols, m_rows, m_blocks, m_combArray,
-        m_rosArray, p_latRos, m_maxRosArray, p_lats);
+    // the same parent block and lee side fuels come up again in reruns
+    // with other fuel fractions, RandFuel keeps their max spread rates
     long oldLats = 2 * p_lats;
+    m_memoKey.assign(m_rosArray[0], m_rosArray[0] + m_cells);
+    m_memoKey.insert(m_memoKey.end(), p_latRos, p_latRos + oldLats);
+    if (!m_rf->findExtensionMaxRos(m_memoKey, m_maxRosArray, m_blocks))
+    {
+        m_rf->calcExtendedSpreadRates2(m_cols, m_rows, m_blocks, m_combArray,
+            m_rosArray, p_latRos, m_maxRosArray, p_lats);
+        m_rf->storeExtensionMaxRos(m_memoKey, m_maxRosArray, m_blocks);
+    }
     m_latProb = 1.0;
     long i;
     for (i = 0; i < oldLats; i++)
@@ -352,7 +296,7 @@ void Extension::run(long p_lats, double *p_latRos, double *p_latComb,
     for (i = 0; i < m_blocks; i++)
     {
         m_rf->spliceExtensions2(m_combArray[i], m_rosArray[i],
-            &(m_nextExt->m_combArray), &(m_nextExt->m_rosArray), m_cols);
+            &m_nextExt->m_combArray, &m_nextExt->m_rosArray, m_cols);
         for (j = 0; j<fuelCombs; j++)
         {
             latros2[0] = m_latRosArray[j][0];
@@ -363,12 +307,13 @@ void Extension::run(long p_lats, double *p_latRos, double *p_latComb,
             latcomb2[p_lats * 2 + 1] = m_latCombArray[j][1];
 
             m_nextExt->run(p_lats + 1, latros2, latcomb2, m_maxRosArray[i]);
+            double nextFasterProbs = m_nextExt->getNextFasterProbs();
             for (k = 0; k<m_blocks; k++)
             {
                 if (m_nextExt->m_maxRosArray[k] > maxRos
                     &&  m_nextExt->m_maxRosArray[k] > m_maxRosArray[i])
                 {
-                    m_prob = m_nextExt->calcProb(k, true);
+                    m_prob = m_nextExt->calcProb(k, nextFasterProbs);
                     m_cuumProb[i] += m_prob;
                     m_harmonicRos += m_prob / m_nextExt->m_maxRosArray[k];
                     m_averageRos += m_prob * m_nextExt->m_maxRosArray[k];
@@ -382,24 +327,8 @@ void Extension::run(long p_lats, double *p_latRos, double *p_latComb,
         // Accumulate cumulative probabilities from next extension
         m_extCuumProb += m_cuumProb[i];
     }
-    if (m_latCombArray)
-    {
-        for (i = 0; i < fuelCombs; i++)
-        {
-            delete[] m_latCombArray[i];
-        }
-        delete[] m_latCombArray;
-        m_latCombArray = 0;
-    }
-    if (m_latRosArray)
-    {
-        for (i = 0; i < fuelCombs; i++)
-        {
-            delete[] m_latRosArray[i];
-        }
-        delete[] m_latRosArray;
-        m_latRosArray = 0;
-    }
+    m_latCombArray.free();
+    m_latRosArray.free();
     if (latros2)
     {
         delete[] latros2;
@@ -53,6 +53,9 @@
 
 // Custom include files
 #include "randfuel.h"
+#include "randthread.h"
+
+#include <vector>
 
 class RandFuel;
 
@@ -66,6 +69,8 @@ public:
     // These are called by RandFuel::computeSpread2()
     bool   allocExtension( long p_blocks, long p_cols, long p_rows, long p_fuels ) ;
     double calcProb( long p_block, bool p_subtFaster ) ;
+    double calcProb( long p_block, double p_nextFasterProbs ) ;
+    double getNextFasterProbs( void ) const ;
     void   run( long p_lats, double *p_latRos, double *p_latComb,
                 double p_maxRos ) ;
 
@@ -85,8 +90,8 @@ public:
     Extension *m_nextExt;       //!< link to next Extension
     RandFuel  *m_rf;            //!< pointer to calculations of RandFuel
     double    *m_maxRosArray;   //!< 1x array with resulting max spread rates for each block
-    double   **m_combArray;     //!< 2x array with probabilities in it
-    double   **m_rosArray;      //!< 2x array with spread rates in it
+    RandBlockArray m_combArray; //!< 2x array with probabilities in it
+    RandBlockArray m_rosArray;  //!< 2x array with spread rates in it
 
 // Private data
 protected:
@@ -100,8 +105,9 @@ protected:
     long       m_leeFuels;      //!< number of lee fuel combinations
     char      *m_blockPtr;      //!< Pointer to single dynamic memory block
     double    *m_cuumProb;      //!< cumulative prob of faster spread rates
-    double   **m_latRosArray;   //!< lee side spread rates and probabilities
-    double   **m_latCombArray;  //!< lee side spread rates and probabilities
+    RandBlockArray m_latRosArray;  //!< lee side spread rates and probabilities
+    RandBlockArray m_latCombArray; //!< lee side spread rates and probabilities
+    std::vector<double> m_memoKey; //!< RandFuel extension memo key of the current run
 };
 
 #endif //  NEWEXT_H
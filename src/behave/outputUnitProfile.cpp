@@ -0,0 +1,117 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Output units resolved once into factors from base units, for filling
+*           output structs without a unit switch per getter call
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "outputUnitProfile.h"
+
+OutputUnitProfile::OutputUnitProfile()
+{
+    setSpreadRateUnits(SpeedUnits::FeetPerMinute);
+    setWindSpeedUnits(SpeedUnits::FeetPerMinute);
+    setFlameLengthUnits(LengthUnits::Feet);
+    setFirelineIntensityUnits(FirelineIntensityUnits::BtusPerFootPerSecond);
+    setHeatPerUnitAreaUnits(HeatPerUnitAreaUnits::BtusPerSquareFoot);
+    setReactionIntensityUnits(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
+    setTimeUnits(TimeUnits::Minutes);
+}
+
+void OutputUnitProfile::setSpreadRateUnits(SpeedUnits::SpeedUnitsEnum spreadRateUnits)
+{
+    spreadRateUnits_ = spreadRateUnits;
+    spreadRateFactor_ = SpeedUnits::fromBaseFactor(spreadRateUnits);
+}
+
+void OutputUnitProfile::setWindSpeedUnits(SpeedUnits::SpeedUnitsEnum windSpeedUnits)
+{
+    windSpeedUnits_ = windSpeedUnits;
+    windSpeedFactor_ = SpeedUnits::fromBaseFactor(windSpeedUnits);
+}
+
+void OutputUnitProfile::setFlameLengthUnits(LengthUnits::LengthUnitsEnum flameLengthUnits)
+{
+    flameLengthUnits_ = flameLengthUnits;
+    flameLengthFactor_ = LengthUnits::fromBaseFactor(flameLengthUnits);
+}
+
+void OutputUnitProfile::setFirelineIntensityUnits(FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits)
+{
+    firelineIntensityUnits_ = firelineIntensityUnits;
+    firelineIntensityFactor_ = FirelineIntensityUnits::fromBaseFactor(firelineIntensityUnits);
+}
+
+void OutputUnitProfile::setHeatPerUnitAreaUnits(HeatPerUnitAreaUnits::HeatPerUnitAreaUnitsEnum heatPerUnitAreaUnits)
+{
+    heatPerUnitAreaUnits_ = heatPerUnitAreaUnits;
+    heatPerUnitAreaFactor_ = HeatPerUnitAreaUnits::fromBaseFactor(heatPerUnitAreaUnits);
+}
+
+void OutputUnitProfile::setReactionIntensityUnits(HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum reactionIntensityUnits)
+{
+    reactionIntensityUnits_ = reactionIntensityUnits;
+    reactionIntensityFactor_ = HeatSourceAndReactionIntensityUnits::fromBaseFactor(reactionIntensityUnits);
+}
+
+void OutputUnitProfile::setTimeUnits(TimeUnits::TimeUnitsEnum timeUnits)
+{
+    timeUnits_ = timeUnits;
+    timeFactor_ = TimeUnits::fromBaseFactor(timeUnits);
+}
+
+SpeedUnits::SpeedUnitsEnum OutputUnitProfile::getSpreadRateUnits() const
+{
+    return spreadRateUnits_;
+}
+
+SpeedUnits::SpeedUnitsEnum OutputUnitProfile::getWindSpeedUnits() const
+{
+    return windSpeedUnits_;
+}
+
+LengthUnits::LengthUnitsEnum OutputUnitProfile::getFlameLengthUnits() const
+{
+    return flameLengthUnits_;
+}
+
+FirelineIntensityUnits::FirelineIntensityUnitsEnum OutputUnitProfile::getFirelineIntensityUnits() const
+{
+    return firelineIntensityUnits_;
+}
+
+HeatPerUnitAreaUnits::HeatPerUnitAreaUnitsEnum OutputUnitProfile::getHeatPerUnitAreaUnits() const
+{
+    return heatPerUnitAreaUnits_;
+}
+
+HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum OutputUnitProfile::getReactionIntensityUnits() const
+{
+    return reactionIntensityUnits_;
+}
+
+TimeUnits::TimeUnitsEnum OutputUnitProfile::getTimeUnits() const
+{
+    return timeUnits_;
+}
@@ -0,0 +1,86 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Output units resolved once into factors from base units, for filling
+*           output structs without a unit switch per getter call
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef OUTPUTUNITPROFILE_H
+#define OUTPUTUNITPROFILE_H
+
+#include "behaveUnits.h"
+
+// Output units chosen once, for example for a session of batch or FFI calls, resolved into the factors
+// that take each output from its base units. Every unit here converts by a factor alone, so filling an
+// output struct through a profile costs a multiply per output rather than a unit switch per getter call.
+// A default profile keeps the base units: ft/min, ft, Btu/ft/s, Btu/ft^2, Btu/ft^2/min and minutes.
+class OutputUnitProfile
+{
+public:
+    OutputUnitProfile();
+
+    void setSpreadRateUnits(SpeedUnits::SpeedUnitsEnum spreadRateUnits);
+    void setWindSpeedUnits(SpeedUnits::SpeedUnitsEnum windSpeedUnits);
+    void setFlameLengthUnits(LengthUnits::LengthUnitsEnum flameLengthUnits);
+    void setFirelineIntensityUnits(FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits);
+    void setHeatPerUnitAreaUnits(HeatPerUnitAreaUnits::HeatPerUnitAreaUnitsEnum heatPerUnitAreaUnits);
+    void setReactionIntensityUnits(HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum reactionIntensityUnits);
+    void setTimeUnits(TimeUnits::TimeUnitsEnum timeUnits);
+
+    SpeedUnits::SpeedUnitsEnum getSpreadRateUnits() const;
+    SpeedUnits::SpeedUnitsEnum getWindSpeedUnits() const;
+    LengthUnits::LengthUnitsEnum getFlameLengthUnits() const;
+    FirelineIntensityUnits::FirelineIntensityUnitsEnum getFirelineIntensityUnits() const;
+    HeatPerUnitAreaUnits::HeatPerUnitAreaUnitsEnum getHeatPerUnitAreaUnits() const;
+    HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum getReactionIntensityUnits() const;
+    TimeUnits::TimeUnitsEnum getTimeUnits() const;
+
+    // Factors from base units, resolved by the setters
+    double getSpreadRateFactor() const { return spreadRateFactor_; }
+    double getWindSpeedFactor() const { return windSpeedFactor_; }
+    double getFlameLengthFactor() const { return flameLengthFactor_; }
+    double getFirelineIntensityFactor() const { return firelineIntensityFactor_; }
+    double getHeatPerUnitAreaFactor() const { return heatPerUnitAreaFactor_; }
+    double getReactionIntensityFactor() const { return reactionIntensityFactor_; }
+    double getTimeFactor() const { return timeFactor_; }
+
+private:
+    SpeedUnits::SpeedUnitsEnum spreadRateUnits_;
+    SpeedUnits::SpeedUnitsEnum windSpeedUnits_;
+    LengthUnits::LengthUnitsEnum flameLengthUnits_;
+    FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits_;
+    HeatPerUnitAreaUnits::HeatPerUnitAreaUnitsEnum heatPerUnitAreaUnits_;
+    HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum reactionIntensityUnits_;
+    TimeUnits::TimeUnitsEnum timeUnits_;
+
+    double spreadRateFactor_;
+    double windSpeedFactor_;
+    double flameLengthFactor_;
+    double firelineIntensityFactor_;
+    double heatPerUnitAreaFactor_;
+    double reactionIntensityFactor_;
+    double timeFactor_;
+};
+
+#endif // OUTPUTUNITPROFILE_H
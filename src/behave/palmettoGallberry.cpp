@@ -31,10 +31,88 @@
 #include "palmettoGallberry.h"
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 PalmettoGallberry::PalmettoGallberry()
 {
     initializeMembers();
+    clearFuelbedMemo();
+}
+
+void PalmettoGallberry::clearFuelbedMemo()
+{
+    for (int i = 0; i < NumberOfFuelbedMemoEntries; i++)
+    {
+        fuelbedMemo_[i].isUsed = false;
+    }
+    fuelbedMemoNumberOfHits_ = 0;
+    fuelbedMemoNumberOfMisses_ = 0;
+}
+
+int PalmettoGallberry::getFuelbedMemoSlot(double ageOfRough, double heightOfUnderstory, double palmettoCoverage, double overstoryBasalArea)
+{
+    const double keyValues[] = { ageOfRough, heightOfUnderstory, palmettoCoverage, overstoryBasalArea };
+    std::uint64_t hash = 0;
+    for (double keyValue : keyValues)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &keyValue, sizeof(bits));
+        hash = (hash ^ bits) * 0x9e3779b97f4a7c15ULL;
+    }
+    return static_cast<int>(hash >> 61) & (NumberOfFuelbedMemoEntries - 1);
+}
+
+const PalmettoGallberryFuelbed& PalmettoGallberry::calculatePalmettoGallberyFuelbed(double ageOfRough, double heightOfUnderstory,
+    double palmettoCoverage, double overstoryBasalArea)
+{
+    FuelbedMemoEntry& entry = fuelbedMemo_[getFuelbedMemoSlot(ageOfRough, heightOfUnderstory, palmettoCoverage, overstoryBasalArea)];
+    if (entry.isUsed && entry.ageOfRough == ageOfRough && entry.heightOfUnderstory == heightOfUnderstory &&
+        entry.palmettoCoverage == palmettoCoverage && entry.overstoryBasalArea == overstoryBasalArea)
+    {
+        fuelbedMemoNumberOfHits_++;
+        setMembersFromFuelbed(entry.fuelbed);
+        return entry.fuelbed;
+    }
+    fuelbedMemoNumberOfMisses_++;
+
+    PalmettoGallberryFuelbed& fuelbed = entry.fuelbed;
+    fuelbed.fuelBedDepth = calculatePalmettoGallberyFuelBedDepth(heightOfUnderstory);
+    fuelbed.deadFineFuelLoad = calculatePalmettoGallberyDeadFineFuelLoad(ageOfRough, heightOfUnderstory);
+    fuelbed.deadMediumFuelLoad = calculatePalmettoGallberyDeadMediumFuelLoad(ageOfRough, palmettoCoverage);
+    fuelbed.deadFoliageLoad = calculatePalmettoGallberyDeadFoliageLoad(ageOfRough, palmettoCoverage);
+    fuelbed.litterLoad = calculatePalmettoGallberyLitterLoad(ageOfRough, overstoryBasalArea);
+    fuelbed.liveFineFuelLoad = calculatePalmettoGallberyLiveFineFuelLoad(ageOfRough, heightOfUnderstory);
+    fuelbed.liveMediumFuelLoad = calculatePalmettoGallberyLiveMediumFuelLoad(ageOfRough, heightOfUnderstory);
+    fuelbed.liveFoliageLoad = calculatePalmettoGallberyLiveFoliageLoad(ageOfRough, palmettoCoverage, heightOfUnderstory);
+    entry.isUsed = true;
+    entry.ageOfRough = ageOfRough;
+    entry.heightOfUnderstory = heightOfUnderstory;
+    entry.palmettoCoverage = palmettoCoverage;
+    entry.overstoryBasalArea = overstoryBasalArea;
+    return fuelbed;
+}
+
+void PalmettoGallberry::setMembersFromFuelbed(const PalmettoGallberryFuelbed& fuelbed)
+{
+    palmettoGallberyFuelBedDepth_ = fuelbed.fuelBedDepth;
+    palmettoGallberyDeadFineFuelLoad_ = fuelbed.deadFineFuelLoad;
+    palmettoGallberyDeadMediumFuelLoad_ = fuelbed.deadMediumFuelLoad;
+    palmettoGallberyDeadFoliageFuelLoad_ = fuelbed.deadFoliageLoad;
+    palmettoGallberyLitterLoad_ = fuelbed.litterLoad;
+    palmettoGallberyLiveFineFuelLoad_ = fuelbed.liveFineFuelLoad;
+    palmettoGallberyLiveMediumFuelLoad_ = fuelbed.liveMediumFuelLoad;
+    palmettoGallberyLiveFoliageLoad_ = fuelbed.liveFoliageLoad;
+}
+
+long PalmettoGallberry::getFuelbedMemoNumberOfHits() const
+{
+    return fuelbedMemoNumberOfHits_;
+}
+
+long PalmettoGallberry::getFuelbedMemoNumberOfMisses() const
+{
+    return fuelbedMemoNumberOfMisses_;
 }
 
 void PalmettoGallberry::initializeMembers()
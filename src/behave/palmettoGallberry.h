@@ -31,11 +31,34 @@
 #ifndef PALMETTOGALLBERRY_H
 #define PALMETTOGALLBERRY_H
 
+// Fuel bed depth in ft and loads in lb/ft2 of one palmetto-gallberry stand
+struct PalmettoGallberryFuelbed
+{
+    double fuelBedDepth;
+    double deadFineFuelLoad;
+    double deadMediumFuelLoad;
+    double deadFoliageLoad;
+    double litterLoad;
+    double liveFineFuelLoad;
+    double liveMediumFuelLoad;
+    double liveFoliageLoad;
+};
+
 class PalmettoGallberry
 {
 public:
+    static const int NumberOfFuelbedMemoEntries = 8;
+
     PalmettoGallberry();
-    void initializeMembers();
+    void initializeMembers(); // keeps the fuelbed memo
+
+    // Runs all of the depth and load regressions of a stand, unless they are in the small direct-mapped
+    // memo of recent stands keyed on the exact inputs. Either way the getters report the stand afterwards.
+    const PalmettoGallberryFuelbed& calculatePalmettoGallberyFuelbed(double ageOfRough, double heightOfUnderstory,
+        double palmettoCoverage, double overstoryBasalArea);
+    void clearFuelbedMemo();
+    long getFuelbedMemoNumberOfHits() const;
+    long getFuelbedMemoNumberOfMisses() const;
 
     double calculatePalmettoGallberyDeadFineFuelLoad(double ageOfRough, double heightOfUnderstory);
     double calculatePalmettoGallberyDeadMediumFuelLoad(double ageOfRough, double palmettoCoverage);
@@ -59,6 +82,23 @@ public:
     double getPalmettoGallberyLiveFoliageLoad() const;
 
 protected:
+    struct FuelbedMemoEntry
+    {
+        bool isUsed;
+        double ageOfRough;
+        double heightOfUnderstory;
+        double palmettoCoverage;
+        double overstoryBasalArea;
+        PalmettoGallberryFuelbed fuelbed;
+    };
+
+    static int getFuelbedMemoSlot(double ageOfRough, double heightOfUnderstory, double palmettoCoverage, double overstoryBasalArea);
+    void setMembersFromFuelbed(const PalmettoGallberryFuelbed& fuelbed);
+
+    FuelbedMemoEntry fuelbedMemo_[NumberOfFuelbedMemoEntries];
+    long fuelbedMemoNumberOfHits_;
+    long fuelbedMemoNumberOfMisses_;
+
     double moistureOfExtinctionDead_;
     double heatOfCombustionDead_;
     double heatOfCombustionLive_;
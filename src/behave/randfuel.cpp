@@ -53,10 +53,14 @@
 #endif
 
 #include "randfuel.h"
+#include "instrumentation.h"
+#include "runControl.h"
+#include "threadPool.h"
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <random>
 
 //------------------------------------------------------------------------------
 
@@ -70,6 +74,7 @@ RandFuel::RandFuel(void)
 
 RandFuel::~RandFuel(void)
 {
+    closeRandThreads();
     freeBlockArrays();
     if (m_maxRosArray)
     {
@@ -102,6 +107,13 @@ bool RandFuel::allocRandThreads(void)
     {
         return(false);
     }
+    m_threadPool = ThreadPool::getShared();
+    for (long i = 0; i < m_threads; i++)
+    {
+        m_randThread[i].setPathMemoryLimit(m_pathMemoryLimit / m_threads);
+        m_randThread[i].setRunControl(m_runControl);
+        m_randThread[i].setVectorMathMode(m_vectorMathMode);
+    }
     return(true);
 }
 
@@ -119,7 +131,7 @@ bool RandFuel::allocRandThreads(void)
  */
 
 bool RandFuel::calcCombinations(long p_nX, long p_nY, long *p_nT,
-    double ***p_ca, double ***p_ra)
+    RandBlockArray *p_ca, RandBlockArray *p_ra)
 {
     double *comb;                          // array of probability distribution
     double *ros;                           // array of spread rate distribution
@@ -140,7 +152,7 @@ bool RandFuel::calcCombinations(long p_nX, long p_nY, long *p_nT,
 
     // calculate the combinations that form the breadth of the fuel patch
     long terms = 1;
-    long i, j, k, m, n, p, q;
+    long i, j, k, m, n, q;
     for (i = 0; i < p_nX; i++)
     {
         m = 0;
@@ -173,27 +185,16 @@ bool RandFuel::calcCombinations(long p_nX, long p_nY, long *p_nT,
     {
         *p_nT = (long)pow((double)cols, (int)p_nY);
     }
-    if (!(*p_ca = new double*[*p_nT]))
-    {
-        delete[] comb;
-        delete[] ros;
-        return(false);
-    }
-
-    if (!(*p_ra = new double*[*p_nT]))
+    long cells = p_nX * p_nY;
+    if (!p_ca->alloc(*p_nT, cells) || !p_ra->alloc(*p_nT, cells))
     {
+        p_ca->free();
         delete[] comb;
         delete[] ros;
-        delete[] * p_ca;
         return(false);
     }
 
     // calculate block array probabilities and spread rates
-    for (i = 0; i < *p_nT; i++)
-    {
-        (*p_ca)[i] = new double[p_nX * p_nY];
-        (*p_ra)[i] = new double[p_nX * p_nY];
-    }
 
     terms = 1;
     for (i = 0; i < p_nY; i++)
@@ -212,16 +213,13 @@ bool RandFuel::calcCombinations(long p_nX, long p_nY, long *p_nT,
         n = cols * m;
         if (i < (p_nY - 1))
         {
+            // blocks are contiguous, so the first q are replicated at once
             q = m;
             do
             {
-                for (p = 0; p < q; p++)
-                {
-                    memcpy(&((*p_ca)[m][0]), &((*p_ca)[p][0]),
-                        p_nY * p_nX * sizeof(double));
-                    memcpy(&((*p_ra)[m++][0]), &((*p_ra)[p][0]),
-                        p_nY * p_nX * sizeof(double));
-                }
+                memcpy((*p_ca)[m], (*p_ca)[0], q * cells * sizeof(double));
+                memcpy((*p_ra)[m], (*p_ra)[0], q * cells * sizeof(double));
+                m += q;
             } while (m < n);
         }
         terms *= cols;
@@ -247,93 +245,84 @@ bool RandFuel::calcCombinations(long p_nX, long p_nY, long *p_nT,
  */
 
 void RandFuel::calcExtendedSpreadRates2(long p_cols, long p_rows,
-    long p_latCombs, double **p_combArray, double **p_rosArray,
-    double *p_latRosArray, double *p_maxRosExtArray, long p_laterals)
+    long p_latCombs, const RandBlockArray &p_combArray,
+    const RandBlockArray &p_rosArray, double *p_latRosArray, double *p_maxRosExtArray, long p_laterals)
 {
-    double ipart;
-    double interval = ((double)p_latCombs) / ((double)m_threads);
-    double fract = modf(interval, &ipart);
-    long   range = (long)interval;
-    if (fract > 0.0)
-    {
-        range++;
-    }
-    long begin = 0;
-    long end = 0;
     for (int i = 0; i < m_threads; i++)
     {
-        end = begin + range;
-        if (begin >= p_latCombs)
-        {
-            continue;
-        }
-        if (end > p_latCombs)
-        {
-            end = p_latCombs;
-        }
         m_randThread[i].setThreadData(p_cols, p_rows, p_latCombs,
-            m_lbRatio, p_combArray, p_rosArray, p_maxRosExtArray, begin, end, p_laterals,
+            m_lbRatio, &p_combArray, &p_rosArray, p_maxRosExtArray, 0, p_latCombs, p_laterals,
             (p_cols - p_laterals), p_latRosArray, m_lessIgns);
-        begin = end;
     }
-    m_randThread[0].calcSpreadPaths2();
+    runRandThreads(p_latCombs, false);
     return;
 }
 
 //------------------------------------------------------------------------------
-/*! \brief
+/*! \brief Sets each fuel type's relative spread rate to its spread rate
+ *  divided by the fastest fuel type's.
  *
- *  -#  Allocates threads and m_maxRosArray array to store max spread rates
+ *  \return The fastest absolute spread rate.
+ */
+
+double RandFuel::calcRelativeSpreadRates(void)
+{
+    double maxRos = 0.0;
+    long i;
+    for (i = 0; i < m_fuels; i++)
+    {
+        if (maxRos < m_fuelTypeArray[i].m_absRos)
+        {
+            maxRos = m_fuelTypeArray[i].m_absRos;
+        }
+    }
+    for (i = 0; i < m_fuels; i++)
+    {
+        m_fuelTypeArray[i].m_relRos = m_fuelTypeArray[i].m_absRos / maxRos;
+    }
+    return(maxRos);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief array to store max spread rates
  *      from all blocks
- *  -#  Divides the Number of Combinations (m_combs) into parts for each thread.
- *  -#  Runs each thread and wait until they are all finished (hRandSyncEvent)
+ *  -#  Hands the Number of Combinations (m_combs) to every thread.
+ *  -#  Runs the threads over small chunks of the combinations and waits
+ *      until they are all finished (runRandThreads)
  *  -#  Calculates Expected Spread Rates by Prob[i] X MaxSpread[i]
  *
+ *  \return false if the spread paths did not fit under the limit set by
+ *  setPathMemoryLimit() or the RunControl stopped the run.
  */
 
-void RandFuel::calcSpreadRates(void)
+bool RandFuel::calcSpreadRates(void)
 {
+    m_maxRosCached = false;
     if (m_maxRosArray)
     {
         delete[] m_maxRosArray;
     }
+    // combinations a stopped run never reached keep a negative max
     m_maxRosArray = new double[m_combs];
-    memset(m_maxRosArray, 0x0, m_combs * sizeof(double));
-
-    double interval = ((double)m_combs) / ((double)m_threads);
-    double ipart;
-    double fract = modf(interval, &ipart);
-    long   range = (long)interval;
-    if (fract > 0.0)
+    for (long i = 0; i < m_combs; i++)
     {
-        range++;
+        m_maxRosArray[i] = -1.0;
     }
-    long begin = 0;
-    long end = 0;
+
     for (int i = 0; i < m_threads; i++)
     {
-        end = begin + range;
-        if (begin >= m_combs)
-        {
-            continue;
-        }
-        if (end > m_combs)
-        {
-            end = m_combs;
-        }
         m_randThread[i].setThreadData(m_samples, m_depths, m_combs, m_lbRatio,
-            m_combArray, m_rosArray, m_maxRosArray, begin, end, 0, m_samples,
+            &m_combArray, &m_rosArray, m_maxRosArray, 0, m_combs, 0, m_samples,
             0, m_lessIgns);
-        begin = end;
     }
-    m_randThread[0].calcSpreadPaths2();
-    return;
+    return(runRandThreads(m_combs, true));
 }
 
 //------------------------------------------------------------------------------
 
 void RandFuel::closeRandThreads(void)
 {
+    m_threadPool.reset();
     if (m_randThread)
     {
         delete[] m_randThread;
@@ -346,15 +335,18 @@ void RandFuel::closeRandThreads(void)
  *  of fuels and their probabilities.
  *
  *  Also adds ROS from lateral extensions=Extend.
+ *
+ *  Returns -1.0 if the spread paths did not fit under setPathMemoryLimit()
+ *  or the RunControl given to setRunControl() stopped the run.
  */
 
 double RandFuel::computeSpread2(long p_samples, long p_depths,
     double p_lbRatio, long p_threads, double *p_maxRos,
     double *p_harmonicRos, long p_exts, long p_lessIgns)
 {
+    BEHAVE_TIME_STAGE(RandFuelSpread);
     long i, j, k, m, fuelCombs;
     double maxRos = 0.0;
-    double minRos = 1e12;
     double harmonic = 0.0;
     double average = 0.0;
 
@@ -365,35 +357,62 @@ double RandFuel::computeSpread2(long p_samples, long p_depths,
 
     m_samples = p_samples;
     m_depths = p_depths;
-    m_threads = p_threads;
+    m_threads = (p_threads < 1) ? 1 : p_threads;
     m_lessIgns = p_lessIgns;
     m_lbRatio = p_lbRatio;
+    maxRos = calcRelativeSpreadRates();
 
-    for (i = 0; i < m_fuels; i++)
+    // base combinations for sample block
+    calcCombinations(m_samples, m_depths, &m_combs, &m_combArray, &m_rosArray);
+
+    // the max spread rate of each combination only depends on its spread
+    // rates, so when only the fuel fractions changed the cached
+    // m_maxRosArray is reused and only the probabilities are recomputed
+    bool isCached = isMaxRosCached();
+    if (!isCached)
     {
-        if (maxRos < m_fuelTypeArray[i].m_absRos)
-        {
-            maxRos = m_fuelTypeArray[i].m_absRos;
-        }
-        if (minRos > m_fuelTypeArray[i].m_absRos)
-        {
-            minRos = m_fuelTypeArray[i].m_absRos;
-        }
+        // the extension max spread rates have the same key
+        m_extMaxRosMemo.clear();
+        m_extMaxRosMemoBytes = 0;
     }
-    for (i = 0; i < m_fuels; i++)
+    if ((!isCached || p_exts > 0) && !allocRandThreads())
     {
-        m_fuelTypeArray[i].m_relRos = m_fuelTypeArray[i].m_absRos / maxRos;
+        return(-1.0);
     }
 
-    // base combinations for sample block
-    calcCombinations(m_samples, m_depths, &m_combs, &m_combArray, &m_rosArray);
-    if (!allocRandThreads())
+    // progress counts the sample block combinations, then once more
+    // for each combination's lateral extensions
+    if (m_runControl)
     {
-        return(-1.0);
+        m_runControl->beginWork((p_exts > 0) ? 2 * m_combs : m_combs);
+        if (isCached)
+        {
+            m_runControl->addWorkDone(m_combs);
+        }
     }
-
-    calcSpreadRates(); // ri for sample block
-    double **latComb, **latRos;
+    m_stopped = false;
+    m_pathMemoryExceeded = false;
+    if (!isCached)
+    {
+        if (!calcSpreadRates()) // ri for sample block
+        {
+            closeRandThreads();
+            freeBlockArrays();
+            return(-1.0);
+        }
+        m_maxRosCached = true;
+        m_cachedSamples = m_samples;
+        m_cachedDepths = m_depths;
+        m_cachedLessIgns = m_lessIgns;
+        m_cachedLbRatio = m_lbRatio;
+        m_cachedVectorMathMode = m_vectorMathMode;
+        m_cachedRelRos.resize(m_fuels);
+        for (i = 0; i < m_fuels; i++)
+        {
+            m_cachedRelRos[i] = m_fuelTypeArray[i].m_relRos;
+        }
+    }
+    RandBlockArray latComb, latRos;
 
     double prob, cuumProb;
 
@@ -418,24 +437,34 @@ double RandFuel::computeSpread2(long p_samples, long p_depths,
 
         // for all original combinations of the sample block
         fprintf(stderr, "%ld extensions: ", m_combs);
-        for (j = 0; j < m_combs; j++)
+        for (j = 0; j < m_combs && !m_pathMemoryExceeded && !m_stopped; j++)
         {
+            if (m_runControl)
+            {
+                if (m_runControl->isStopRequested())
+                {
+                    m_stopped = true;
+                    break;
+                }
+                m_runControl->addWorkDone(1);
+            }
             cuumProb = 0.0;
             // don't need to do this if spread rate is already 1.0
             if (m_maxRosArray[j] < 1.0)
             {
                 spliceExtensions2(m_combArray[j], m_rosArray[j],
-                    &(ext[0].m_combArray), &(ext[0].m_rosArray),
+                    &ext[0].m_combArray, &ext[0].m_rosArray,
                     m_samples);
 
                 for (k = 0; k < fuelCombs; k++)
                 {
                     ext[0].run(1, latRos[k], latComb[k], m_maxRosArray[j]);
+                    double nextFasterProbs = ext[0].getNextFasterProbs();
                     for (m = 0; m<m_exts; m++)
                     {
                         if (ext[0].m_maxRosArray[m] > m_maxRosArray[j])
                         {
-                            prob = ext[0].calcProb(m, true);
+                            prob = ext[0].calcProb(m, nextFasterProbs);
                             cuumProb += prob;
                             harmonic += prob / ext[0].m_maxRosArray[m];
                             average += prob * ext[0].m_maxRosArray[m];
@@ -474,24 +503,6 @@ double RandFuel::computeSpread2(long p_samples, long p_depths,
         }
         fprintf(stderr, "\n");
         delete[] ext;
-        if (latComb)
-        {
-            for (i = 0; i < fuelCombs; i++)
-            {
-                delete[] latComb[i];
-            }
-            delete[] latComb;
-            latComb = 0;
-        }
-        if (latRos)
-        {
-            for (i = 0; i < fuelCombs; i++)
-            {
-                delete[] latRos[i];
-            }
-            delete[] latRos;
-            latRos = 0;
-        }
     }
     else
     {
@@ -527,63 +538,229 @@ double RandFuel::computeSpread2(long p_samples, long p_depths,
     }
     closeRandThreads();
     freeBlockArrays();
+    if (m_pathMemoryExceeded || m_stopped)
+    {
+        return(-1.0);
+    }
     return(average);
 }
 
 //------------------------------------------------------------------------------
+/*! \brief Estimates Expected Spread Rate from p_arrangements randomly
+ *  sampled fuel arrangements instead of all factorial combinations.
+ *
+ *  computeSpread2() enumerates m_fuels^(p_samples * p_depths) arrangements,
+ *  which is out of reach for more than a few fuel types.  Here each cell
+ *  of each sampled block is assigned a fuel type with probability equal to
+ *  its landscape fraction, so every sampled arrangement is drawn with the
+ *  probability computeSpread2() would weight it by, and the expected and
+ *  harmonic mean spread rates are simple means over the sampled blocks.
+ *  The blocks are run on the RandThread workers exactly like the
+ *  enumerated ones.
+ *
+ *  The arrangements are drawn from a generator seeded with p_seed before
+ *  the threads start, so results depend only on p_seed and p_arrangements,
+ *  not on the thread count.
+ *
+ *  \param p_arrangements Number of sampled arrangements (at least 2).
+ *  \param p_seed Random number generator seed.
+ *  \param p_expectedRosInterval Returns the half width of the 95%
+ *              confidence interval of the expected relative spread rate.
+ *  \param p_harmonicRosInterval Returns the half width of the 95%
+ *              confidence interval of the harmonic mean relative spread rate.
+ *
+ *  If the RunControl given to setRunControl() stops the run, the estimates
+ *  and intervals are taken from the arrangements that had finished.
+ *
+ *  \return Expected relative spread rate, or -1.0 if the run failed or
+ *  was stopped before two arrangements finished.
+ */
 
-void RandFuel::freeFuels(void)
+double RandFuel::computeSpreadSampled(long p_samples, long p_depths,
+    double p_lbRatio, long p_threads, long p_arrangements,
+    unsigned long p_seed, double *p_maxRos, double *p_harmonicRos,
+    double *p_expectedRosInterval, double *p_harmonicRosInterval)
 {
-    if (m_fuelTypeArray)
+    BEHAVE_TIME_STAGE(RandFuelSpread);
+    if (p_samples < 1 || p_samples > 50 || p_depths < 1 || p_arrangements < 2)
     {
-        delete[] m_fuelTypeArray;
+        return(0.0);
     }
-    m_fuelTypeArray = 0;
-    m_fuels = 0;
-    return;
-}
 
-//------------------------------------------------------------------------------
+    m_samples = p_samples;
+    m_depths = p_depths;
+    m_threads = (p_threads < 1) ? 1 : p_threads;
+    m_lessIgns = 0;
+    m_lbRatio = p_lbRatio;
+    double maxRos = calcRelativeSpreadRates();
 
-void RandFuel::freeBlockArrays(void)
-{
-    long i;
-    if (m_combArray)
+    if (!sampleCombinations(p_arrangements, p_seed) || !allocRandThreads())
     {
-        for (i = 0; i < m_combs; i++)
-        {
-            delete[] m_combArray[i];
-        }
-        delete[] m_combArray;
-        m_combArray = 0;
+        freeBlockArrays();
+        return(-1.0);
     }
-    if (m_rosArray)
+
+    if (m_runControl)
     {
-        for (i = 0; i < m_combs; i++)
+        m_runControl->beginWork(p_arrangements);
+    }
+    m_stopped = false;
+    m_pathMemoryExceeded = false;
+    calcSpreadRates();
+    long arrangements = m_combs;
+    closeRandThreads();
+    freeBlockArrays();
+
+    // sums of spread rates and inverse spread rates and their squares,
+    // over the arrangements that finished
+    long finished = 0;
+    double sum = 0.0;
+    double sumSq = 0.0;
+    double invSum = 0.0;
+    double invSumSq = 0.0;
+    for (long i = 0; i < arrangements; i++)
+    {
+        double ros = m_maxRosArray[i];
+        if (ros < 0.0)
+        {
+            continue;
+        }
+        finished++;
+        sum += ros;
+        sumSq += ros * ros;
+        if (ros > 0.0)
         {
-            delete[] m_rosArray[i];
+            invSum += 1.0 / ros;
+            invSumSq += 1.0 / (ros * ros);
         }
-        delete[] m_rosArray;
-        m_rosArray = 0;
     }
-    if (m_combExtArray)
+    if (m_pathMemoryExceeded || finished < 2)
+    {
+        delete[] m_maxRosArray;
+        m_maxRosArray = 0;
+        return(-1.0);
+    }
+    double n = (double)finished;
+    double average = sum / n;
+    double variance = (sumSq - n * average * average) / (n - 1.0);
+    double invAverage = invSum / n;
+    double invVariance = (invSumSq - n * invAverage * invAverage) / (n - 1.0);
+    const double z95 = 1.959964;
+
+    if (p_maxRos)
+    {
+        *p_maxRos = maxRos;
+    }
+    if (p_harmonicRos)
+    {
+        *p_harmonicRos = (invAverage > 0.0) ? (1.0 / invAverage) : 0.0;
+    }
+    if (p_expectedRosInterval)
     {
-        for (i = 0; i < m_exts; i++)
+        *p_expectedRosInterval = z95 * sqrt((variance > 0.0) ? variance / n : 0.0);
+    }
+    if (p_harmonicRosInterval)
+    {
+        // delta method, d(1/x) = dx / x^2
+        *p_harmonicRosInterval = 0.0;
+        if (invAverage > 0.0 && invVariance > 0.0)
         {
-            delete[] m_combExtArray[i];
+            *p_harmonicRosInterval = z95 * sqrt(invVariance / n)
+                / (invAverage * invAverage);
         }
-        delete[] m_combExtArray;
-        m_combExtArray = 0;
     }
-    if (m_rosExtArray)
+
+    // m_maxRosArray no longer matches the enumeration recomputeSpread() uses
+    delete[] m_maxRosArray;
+    m_maxRosArray = 0;
+    m_maxRosCached = false;
+    return(average);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates Expected Spread Rate for two fuel types as in
+ *  computeSpread2() without lateral extensions, and also returns it by the
+ *  number of cells holding the first fuel type.
+ *
+ *  An arrangement with k cells of the first type out of n has
+ *  probability f^k (1-f)^(n-k), where f is the first type's fraction, so
+ *  the expected relative spread rate at any fraction is
+ *
+ *      sum over k of C(n,k) f^k (1-f)^(n-k) p_countRos[k].
+ *
+ *  That depends on the fuel spread rates and p_lbRatio only through
+ *  p_countRos, so callers can keep it and change the fractions freely.
+ *
+ *  \param p_countRos Returns the mean maximum relative spread rate of the
+ *              arrangements with k cells of the first fuel type, for k
+ *              from 0 to p_samples * p_depths.
+ *
+ *  \return Expected relative spread rate at the current fractions, or
+ *  -1.0 if there are not two fuel types or the run failed.
+ */
+
+double RandFuel::computeSpreadByFuelCount(long p_samples, long p_depths,
+    double p_lbRatio, long p_threads, double *p_maxRos, double *p_countRos)
+{
+    if (m_fuels != 2 || p_depths < 1)
+    {
+        return(-1.0);
+    }
+    double average = computeSpread2(p_samples, p_depths, p_lbRatio,
+        p_threads, p_maxRos, 0, 0, 0);
+    if (average < 0.0 || !m_maxRosArray)
+    {
+        return(-1.0);
+    }
+
+    // cell t of arrangement i holds fuel type (i >> t) & 1, the order
+    // calcCombinations() enumerates them in
+    long cells = m_samples * m_depths;
+    long combs = 1L << cells;
+    std::vector<long> arrangements(cells + 1, 0);
+    long i, t, k;
+    for (k = 0; k <= cells; k++)
+    {
+        p_countRos[k] = 0.0;
+    }
+    for (i = 0; i < combs; i++)
     {
-        for (i = 0; i < m_exts; i++)
+        k = 0;
+        for (t = 0; t < cells; t++)
         {
-            delete[] m_rosExtArray[i];
+            k += ((i >> t) & 1) ? 0 : 1;
         }
-        delete[] m_rosExtArray;
-        m_rosExtArray = 0;
+        p_countRos[k] += m_maxRosArray[i];
+        arrangements[k]++;
+    }
+    for (k = 0; k <= cells; k++)
+    {
+        p_countRos[k] /= (double)arrangements[k];
+    }
+    return(average);
+}
+
+//------------------------------------------------------------------------------
+
+void RandFuel::freeFuels(void)
+{
+    if (m_fuelTypeArray)
+    {
+        delete[] m_fuelTypeArray;
     }
+    m_fuelTypeArray = 0;
+    m_fuels = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+
+void RandFuel::freeBlockArrays(void)
+{
+    m_combArray.free();
+    m_rosArray.free();
+    m_combExtArray.free();
+    m_rosExtArray.free();
     if (m_maxRosExtArray)
     {
         delete[] m_maxRosExtArray;
@@ -607,17 +784,124 @@ void RandFuel::init(void)
     m_lessIgns = 0;
     m_lbRatio = 0.0;
     m_cellSize = 0.0;
-    m_combArray = 0;
-    m_rosArray = 0;
-    m_combExtArray = 0;
-    m_rosExtArray = 0;
     m_maxRosArray = 0;
     m_maxRosExtArray = 0;
     m_fuelTypeArray = 0;
     m_randThread = 0;
+    m_threadPool.reset();
+    m_pathMemoryLimit = 0;
+    m_pathMemoryExceeded = false;
+    m_runControl = 0;
+    m_stopped = false;
+    m_vectorMathMode = VectorMathMode::Exact;
+    m_maxRosCached = false;
+    m_cachedSamples = 0;
+    m_cachedDepths = 0;
+    m_cachedLessIgns = 0;
+    m_cachedLbRatio = 0.0;
+    m_cachedVectorMathMode = VectorMathMode::Exact;
+    m_cachedRelRos.clear();
+    m_extMaxRosMemo.clear();
+    m_extMaxRosMemoBytes = 0;
+    m_extMaxRosMemoLimit = RAND_EXTENSION_MEMO_BYTES;
+    m_extMaxRosMemoHits = 0;
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Hashes the spread rates of an extension memo key.
+ */
+
+std::size_t RandFuel::ExtensionKeyHash::operator()(const std::vector<double> &p_key) const
+{
+    std::size_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < p_key.size(); i++)
+    {
+        hash = (hash ^ std::hash<double>()(p_key[i])) * 1099511628211ULL;
+    }
+    return(hash);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Copies the max spread rates of an extension's p_blocks blocks
+ *  into p_maxRosArray if an earlier extension run had the same fuel
+ *  composition.
+ *
+ *  An extension's blocks all splice the same parent block into the same
+ *  set of extension columns, so p_key, the spread rates of its first
+ *  block followed by the spread rates of its lee side cells, gives the
+ *  max spread rates of every block.  The memo is kept between runs while
+ *  the cached m_maxRosArray is valid, whatever the fuel fractions.
+ *  Called by Extension::run().
+ *
+ *  \return false if the rates have to be worked out.
+ */
+
+bool RandFuel::findExtensionMaxRos(const std::vector<double> &p_key,
+    double *p_maxRosArray, long p_blocks)
+{
+    if (m_extMaxRosMemoLimit == 0)
+    {
+        return(false);
+    }
+    std::unordered_map<std::vector<double>, std::vector<double>, ExtensionKeyHash>::const_iterator found
+        = m_extMaxRosMemo.find(p_key);
+    if (found == m_extMaxRosMemo.end() || (long)found->second.size() != p_blocks)
+    {
+        return(false);
+    }
+    memcpy(p_maxRosArray, found->second.data(), p_blocks * sizeof(double));
+    m_extMaxRosMemoHits++;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the number of extension runs kept by the memo.
+ */
+
+unsigned long RandFuel::getExtensionMemoEntries(void) const
+{
+    return((unsigned long)m_extMaxRosMemo.size());
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns the number of extension runs answered from the memo.
+ */
+
+unsigned long RandFuel::getExtensionMemoHits(void) const
+{
+    return(m_extMaxRosMemoHits);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns TRUE if m_maxRosArray holds the max spread rates of the
+ *  current block size, fire shape and fuel relative spread rates.
+ *
+ *  Fuel fractions are not part of the key; they only weight combinations.
+ */
+
+bool RandFuel::isMaxRosCached(void) const
+{
+    if (!m_maxRosCached || !m_maxRosArray
+        || m_cachedSamples != m_samples
+        || m_cachedDepths != m_depths
+        || m_cachedLessIgns != m_lessIgns
+        || m_cachedLbRatio != m_lbRatio
+        || m_cachedVectorMathMode != m_vectorMathMode
+        || (long)m_cachedRelRos.size() != m_fuels)
+    {
+        return(false);
+    }
+    for (long i = 0; i < m_fuels; i++)
+    {
+        if (m_cachedRelRos[i] != m_fuelTypeArray[i].m_relRos)
+        {
+            return(false);
+        }
+    }
+    return(true);
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Recomputes spread using the existing spread rate array m_maxRosArray after
  *  the user has run ComputeSpread().
@@ -664,6 +948,157 @@ double RandFuel::recomputeSpread(double *p_harmonicRos)
     return(expectedRos);
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Runs the RandThreads concurrently over combinations [0, p_combs).
+ *
+ *  The combinations are split into chunks of roughly
+ *  p_combs / (m_threads * RAND_CHUNKS_PER_THREAD) so that threads which
+ *  finish early can steal chunks from the ones that are still busy.
+ *  Each combination's max spread rate only depends on that combination
+ *  and is written to its own slot of the max spread rate array, so the
+ *  result does not depend on the thread count or on which thread ran it.
+ */
+
+bool RandFuel::runRandThreads(long p_combs, bool p_countWork)
+{
+    long chunkSize = p_combs / (m_threads * RAND_CHUNKS_PER_THREAD);
+    if (chunkSize < 1)
+    {
+        chunkSize = 1;
+    }
+    int i;
+    for (i = 0; i < m_threads; i++)
+    {
+        m_randThread[i].beginSpreadPaths();
+    }
+    RandThread *randThreads = m_randThread;
+    RunControl *runControl = p_countWork ? m_runControl : 0;
+    m_threadPool->runChunks(p_combs, chunkSize,
+        [randThreads, runControl](int slot, long begin, long end)
+        {
+            randThreads[slot].calcSpreadPathsForRange(begin, end);
+            if (runControl)
+            {
+                runControl->addWorkDone(end - begin);
+            }
+        }, (int) m_threads);
+    for (i = 0; i < m_threads; i++)
+    {
+        m_randThread[i].endSpreadPaths();
+        if (m_randThread[i].isPathMemoryExceeded())
+        {
+            m_pathMemoryExceeded = true;
+        }
+    }
+    if (m_runControl && m_runControl->isStopRequested())
+    {
+        m_stopped = true;
+    }
+    return(!m_pathMemoryExceeded && !m_stopped);
+}
+
+//------------------------------------------------------------------------------
+
+/*! \brief Sets the most memory, in bytes, the spread paths of all threads
+ *  together may use.  Zero (the default) means no limit.
+ *
+ *  Deep blocks can have a very large number of paths; when they do not
+ *  fit, computeSpread2() returns -1.0 instead of running out of memory.
+ */
+
+void RandFuel::setPathMemoryLimit(unsigned long p_bytes)
+{
+    m_pathMemoryLimit = p_bytes;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Fills m_combArray and m_rosArray with p_arrangements random
+ *  m_samples x m_depths blocks, each cell's fuel type drawn with
+ *  probability proportional to its m_fract, and sets m_combs.
+ */
+
+bool RandFuel::sampleCombinations(long p_arrangements, unsigned long p_seed)
+{
+    long cells = m_samples * m_depths;
+    if (!m_combArray.alloc(p_arrangements, cells)
+        || !m_rosArray.alloc(p_arrangements, cells))
+    {
+        return(false);
+    }
+    m_combs = p_arrangements;
+
+    double totalFract = 0.0;
+    long k;
+    for (k = 0; k < m_fuels; k++)
+    {
+        totalFract += m_fuelTypeArray[k].m_fract;
+    }
+    std::mt19937 generator((std::mt19937::result_type)p_seed);
+    std::uniform_real_distribution<double> distribution(0.0, totalFract);
+    for (long i = 0; i < m_combs; i++)
+    {
+        double *comb = m_combArray[i];
+        double *ros = m_rosArray[i];
+        for (long j = 0; j < cells; j++)
+        {
+            double draw = distribution(generator);
+            for (k = 0; k < m_fuels - 1; k++)
+            {
+                draw -= m_fuelTypeArray[k].m_fract;
+                if (draw < 0.0)
+                {
+                    break;
+                }
+            }
+            comb[j] = m_fuelTypeArray[k].m_fract;
+            ros[j] = m_fuelTypeArray[k].m_relRos;
+        }
+    }
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the RunControl the spread runs poll before each combination
+ *  and report their progress to, or 0 for none.  It must outlive the runs.
+ */
+
+void RandFuel::setRunControl(RunControl *p_runControl)
+{
+    m_runControl = p_runControl;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets how the spread paths work out their lateral sweeps.
+ *  Exact (the default) gives the original results, Fast runs each sweep
+ *  through RandThread::calcFlankingTimes() and agrees within rounding.
+ */
+
+void RandFuel::setVectorMathMode(VectorMathMode::VectorMathModeEnum p_mode)
+{
+    m_vectorMathMode = p_mode;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the most memory, in bytes, the extension max spread rates
+ *  kept for later extension runs may use.  Zero turns the memo off; the
+ *  default is RAND_EXTENSION_MEMO_BYTES.  Once full, the rates already
+ *  kept are still used but no more are added.
+ */
+
+void RandFuel::setExtensionMemoLimit(unsigned long p_bytes)
+{
+    m_extMaxRosMemoLimit = p_bytes;
+    if (p_bytes == 0)
+    {
+        m_extMaxRosMemo.clear();
+        m_extMaxRosMemoBytes = 0;
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 
 void RandFuel::setCellDimensions(double p_cellSize)
@@ -684,9 +1119,35 @@ void RandFuel::setFuelData(long p_type, double p_ros, double p_fract)
     return;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Keeps the max spread rates of an extension's p_blocks blocks
+ *  for later extension runs of the same fuel composition (see
+ *  findExtensionMaxRos()), unless the run that worked them out ran out
+ *  of path memory or was stopped, or the memo is full.
+ *  Called by Extension::run().
+ */
+
+void RandFuel::storeExtensionMaxRos(const std::vector<double> &p_key,
+    const double *p_maxRosArray, long p_blocks)
+{
+    unsigned long bytes = (p_key.size() + p_blocks) * sizeof(double);
+    if (m_pathMemoryExceeded || m_stopped
+        || m_extMaxRosMemoBytes + bytes > m_extMaxRosMemoLimit)
+    {
+        return;
+    }
+    std::vector<double> &maxRos = m_extMaxRosMemo[p_key];
+    if (maxRos.empty())
+    {
+        maxRos.assign(p_maxRosArray, p_maxRosArray + p_blocks);
+        m_extMaxRosMemoBytes += bytes;
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Splices *p_ca into m_combExtArray and *p_ra into m_rosExtArray
- *  and puts the results into **p_cs and **p_rs.
+ *  and puts the results into *p_cs and *p_rs.
  *
  *  \param p_ca Array of combinations (probabilities of the fuels occurring)
  *  \param p_ra Array of spread rates for each fuel type
@@ -696,8 +1157,8 @@ void RandFuel::setFuelData(long p_type, double p_ros, double p_fract)
  *              in m_combExtArray and p_ra
  */
 
-void RandFuel::spliceExtensions2(double *p_ca, double *p_ra, double ***p_cs,
-    double ***p_rs, long p_oldCols)
+void RandFuel::spliceExtensions2(const double *p_ca, const double *p_ra,
+    RandBlockArray *p_cs, RandBlockArray *p_rs, long p_oldCols)
 {
     long newCols;
     unsigned loc;
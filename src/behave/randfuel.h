@@ -55,6 +55,19 @@
 #include "newext.h"
 #include "randthread.h"
 
+// Standard include files
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class ThreadPool;
+
+//! Number of chunks each thread's share of the combinations is split into
+#define RAND_CHUNKS_PER_THREAD 8
+
+//! Default most bytes of extension max spread rates kept between runs
+#define RAND_EXTENSION_MEMO_BYTES (64UL * 1024UL * 1024UL)
+
 //------------------------------------------------------------------------------
 /*! \typedef FuelType
  *  \brief Contains fuel types and their properties (RandFuel)
@@ -79,27 +92,55 @@ public:
     ~RandFuel();
     bool    allocFuels(long p_fuels);
     bool    calcCombinations(long p_nX, long p_nY, long *p_nT,
-        double ***p_ca, double ***p_ra);
+        RandBlockArray *p_ca, RandBlockArray *p_ra);
     void    calcExtendedSpreadRates2(long p_cols, long p_rows,
-        long p_latCombs, double **p_combArray, double **p_rosArray,
+        long p_latCombs, const RandBlockArray &p_combArray,
+        const RandBlockArray &p_rosArray,
         double *p_latRosArray, double *p_maxRosExtArray, long p_laterals);
     double  computeSpread2(long p_samples, long p_depths, double p_lbRatio,
         long p_threads, double *p_maxRos, double *p_harmonicRos,
         long p_exts, long p_lessIgns);
+    double  computeSpreadSampled(long p_samples, long p_depths,
+        double p_lbRatio, long p_threads, long p_arrangements,
+        unsigned long p_seed, double *p_maxRos, double *p_harmonicRos,
+        double *p_expectedRosInterval, double *p_harmonicRosInterval);
+    double  computeSpreadByFuelCount(long p_samples, long p_depths,
+        double p_lbRatio, long p_threads, double *p_maxRos,
+        double *p_countRos);
+    bool    findExtensionMaxRos(const std::vector<double> &p_key,
+        double *p_maxRosArray, long p_blocks);
     void    freeFuels(void);
+    unsigned long getExtensionMemoEntries(void) const;
+    unsigned long getExtensionMemoHits(void) const;
     double  recomputeSpread(double *p_harmonicRos);
     void    setCellDimensions(double p_cellSize);
+    void    setExtensionMemoLimit(unsigned long p_bytes);
     void    setFuelData(long p_type, double p_ros, double p_fract);
-    void    spliceExtensions2(double *p_ca, double *p_ra, double ***p_cs,
-        double ***p_rs, long p_oldCols);
+    void    setPathMemoryLimit(unsigned long p_bytes);
+    void    setRunControl(RunControl *p_runControl);
+    void    setVectorMathMode(VectorMathMode::VectorMathModeEnum p_mode);
+    void    spliceExtensions2(const double *p_ca, const double *p_ra,
+        RandBlockArray *p_cs, RandBlockArray *p_rs, long p_oldCols);
+    void    storeExtensionMaxRos(const std::vector<double> &p_key,
+        const double *p_maxRosArray, long p_blocks);
 
     // Private methods
 protected:
+    //! Hashes the spread rates of an extension memo key
+    struct ExtensionKeyHash
+    {
+        std::size_t operator()(const std::vector<double> &p_key) const;
+    };
+
     bool    allocRandThreads(void);
-    void    calcSpreadRates(void);
+    double  calcRelativeSpreadRates(void);
+    bool    calcSpreadRates(void);
+    bool    sampleCombinations(long p_arrangements, unsigned long p_seed);
     void    closeRandThreads(void);
     void    freeBlockArrays(void);
     void    init(void);
+    bool    isMaxRosCached(void) const;
+    bool    runRandThreads(long p_combs, bool p_countWork);
 
     // Private data
 protected:
@@ -112,14 +153,32 @@ protected:
     long        m_lessIgns;         //!< number of ignition points FEWER than NumSamples;
     double      m_lbRatio;          //!< length to breadth ratio of fire
     double      m_cellSize;         //!< size of raster cell
-    double    **m_combArray;        //!< array of block probabilities
-    double    **m_rosArray;         //!< array of spread rates in block
-    double    **m_combExtArray;     //!< lateral extension array of prob
-    double    **m_rosExtArray;      //!< lateral extension array of ros
+    RandBlockArray m_combArray;     //!< array of block probabilities
+    RandBlockArray m_rosArray;      //!< array of spread rates in block
+    RandBlockArray m_combExtArray;  //!< lateral extension array of prob
+    RandBlockArray m_rosExtArray;   //!< lateral extension array of ros
     double     *m_maxRosArray;      //!< max spread rate for all blocks
     double     *m_maxRosExtArray;   //!< max spread rate for all blocks in extension
     FuelType   *m_fuelTypeArray;    //!< array of FuelType structs
     RandThread *m_randThread;       //!< array of RandThread classes=m_threads
+    std::shared_ptr<ThreadPool> m_threadPool; //!< shared workers that run the RandThreads concurrently
+    unsigned long m_pathMemoryLimit; //!< max bytes of spread paths for all threads, 0 = no limit
+    bool        m_pathMemoryExceeded; //!< set when a run went over m_pathMemoryLimit
+    RunControl *m_runControl;       //!< cancel, progress and time budget token, may be null
+    bool        m_stopped;          //!< set when m_runControl stopped the last run
+    VectorMathMode::VectorMathModeEnum m_vectorMathMode; //!< how the RandThreads work out lateral sweeps
+    bool        m_maxRosCached;     //!< m_maxRosArray holds the max spread rates for the key below
+    long        m_cachedSamples;    //!< m_samples of the cached m_maxRosArray
+    long        m_cachedDepths;     //!< m_depths of the cached m_maxRosArray
+    long        m_cachedLessIgns;   //!< m_lessIgns of the cached m_maxRosArray
+    double      m_cachedLbRatio;    //!< m_lbRatio of the cached m_maxRosArray
+    VectorMathMode::VectorMathModeEnum m_cachedVectorMathMode; //!< m_vectorMathMode of the cached m_maxRosArray
+    std::vector<double> m_cachedRelRos; //!< fuel relative spread rates of the cached m_maxRosArray
+    std::unordered_map<std::vector<double>, std::vector<double>, ExtensionKeyHash>
+        m_extMaxRosMemo;            //!< extension max spread rates by spread rates of the block and lee side, same key as m_maxRosArray
+    unsigned long m_extMaxRosMemoBytes; //!< bytes of spread rates held by m_extMaxRosMemo
+    unsigned long m_extMaxRosMemoLimit; //!< most bytes m_extMaxRosMemo may hold, 0 = no memo
+    unsigned long m_extMaxRosMemoHits;  //!< extension runs answered from m_extMaxRosMemo
 };
 
 #endif // RANDFUEL_H
@@ -49,12 +49,15 @@
 
 // Custom include files
 #include "randthread.h"
+#include "runControl.h"
 
 // Standard include files
+#include <limits.h>
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <new>
 
 //------------------------------------------------------------------------------
 
@@ -69,6 +72,56 @@ double pow2(double input)
 
 //------------------------------------------------------------------------------
 
+RandBlockArray::RandBlockArray(void) :
+    m_data(0),
+    m_blocks(0),
+    m_stride(0)
+{
+}
+
+//------------------------------------------------------------------------------
+
+RandBlockArray::~RandBlockArray(void)
+{
+    free();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Allocates zero-filled storage for \a p_blocks blocks of
+ *  \a p_cells cells each, releasing any previous storage.
+ *
+ *  \return TRUE on success, FALSE if the storage could not be allocated.
+ */
+
+bool RandBlockArray::alloc(long p_blocks, long p_cells)
+{
+    free();
+    size_t count = (size_t)p_blocks * (size_t)p_cells;
+    if (count > 0)
+    {
+        if (!(m_data = new(std::nothrow) double[count]))
+        {
+            return(false);
+        }
+        memset(m_data, 0x0, count * sizeof(double));
+    }
+    m_blocks = p_blocks;
+    m_stride = p_cells;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+
+void RandBlockArray::free(void)
+{
+    delete[] m_data;
+    m_data = 0;
+    m_blocks = 0;
+    m_stride = 0;
+}
+
+//------------------------------------------------------------------------------
+
 RandThread::RandThread(void)
 {
     m_lbRatio = 0.0;
@@ -94,6 +147,22 @@ RandThread::RandThread(void)
     m_startDelay[0] = 0;
     m_startDelay[1] = 0;
     m_latRosArray = 0;
+    m_sampleTime = 0;
+    m_exitTime = 0;
+    m_lateralDistances = 0;
+    m_spreadRates = 0;
+    m_flankingTimes = 0;
+    m_firstPathCapacity = 0;
+    m_newPathCapacity = 0;
+    m_pathMemoryLimit = 0;
+    m_pathMemoryExceeded = false;
+    m_runControl = 0;
+    m_sampleCapacity = 0;
+    m_layerCapacity = 0;
+    m_startDelayCapacity = 0;
+    m_numAlloc = 0;
+    m_isLateral = false;
+    m_vectorMathMode = VectorMathMode::Exact;
     return;
 }
 
@@ -101,6 +170,7 @@ RandThread::RandThread(void)
 
 RandThread::~RandThread()
 {
+    freeSpreadPaths();
     return;
 }
 
@@ -114,6 +184,12 @@ void RandThread::addNewPath(long *NumPath2, double p_time, long p_loc,
     {
         return;
     }
+    if ((unsigned long)*NumPath2 >= m_newPathCapacity
+        && !growNewPaths((unsigned long)*NumPath2 + 1))
+    {
+        // over the memory limit, calcSpreadPathsForRange() gives up on the combination
+        return;
+    }
 
     m_newPath[*NumPath2].m_pathTime = p_time;
     m_newPath[*NumPath2].m_loc = p_loc;
@@ -180,6 +256,51 @@ double RandThread::calcFlankingTime(long p_numLayers, double p_separation,
     return(travelTime);
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Calculates the flanking times of a whole lateral sweep at once.
+ *
+ *  p_times[p] is calcFlankingTime(p + 1, p_separation,
+ *  p_overlap + p * m_cellSize, p_latDist, p_ros) for p = 1 to
+ *  p_numLayers - 1; p_times[0] is not set.  The layer sums are kept
+ *  as a running total instead of being summed again for every p, and
+ *  the angles come from the cell geometry without atan2() or acos(),
+ *  so the angle loop has no branches or library calls and vectorizes.
+ *  Results are within rounding of calcFlankingTime().
+ */
+
+void RandThread::calcFlankingTimes(long p_numLayers, double p_separation,
+    double p_overlap, const double *p_latDist, const double *p_ros,
+    double *p_times)
+{
+    long p;
+    double layerTime = p_latDist[0] / p_ros[0];
+    for (p = 1; p < p_numLayers; p++)
+    {
+        layerTime += p_latDist[p] / p_ros[p];
+        p_times[p] = layerTime;
+    }
+
+    double a2 = pow2(m_a);
+    double b2 = pow2(m_b);
+    double c2 = pow2(m_c);
+    double separation2 = pow2(p_separation);
+    for (p = 1; p < p_numLayers; p++)
+    {
+        // beta = atan2(overlap, separation), theta from beta as in calcFlankingTime()
+        double overlap = p_overlap + p * m_cellSize;
+        double dist2 = separation2 + pow2(overlap);
+        double cosB2 = separation2 / dist2;
+        double sinB2 = pow2(overlap) / dist2;
+        double cosB = p_separation / sqrt(dist2);
+        double cosT = (m_a * cosB * sqrt(a2 * cosB2 + (b2 - c2) * sinB2)
+            - m_b * m_c * sinB2) / (a2 * cosB2 + b2 * sinB2);
+        double sinT2 = (1.0 - cosT) * (1.0 + cosT);
+        double sinT = sqrt((sinT2 > 0.0) ? sinT2 : 0.0);
+        p_times[p] = p_times[p] / (m_a * sinT);
+    }
+    return;
+}
+
 //------------------------------------------------------------------------------
 
 double RandThread::calcLateralRos(double p_forwardRos)
@@ -201,46 +322,98 @@ double RandThread::calcLateralRos(double p_forwardRos)
  *  m_maxRosArray because this represents the path that fire would first
  *  emerge from the block.
  *
- *  This version 2 does a one time allocation of data needed,
- *  rather than linked list (it is probably slightly faster than version 1)
+ *  This version 2 stores the paths in two arrays rather than a linked list
+ *  (it is probably slightly faster than version 1).  The arrays only hold
+ *  the paths still being followed, grow as needed and are reused from one
+ *  call to the next.
  */
 
 void RandThread::calcSpreadPaths2(void)
 {
-    bool Lateral = false;
-    long i, j, k, m, n, p;
-    long NumPath1, NumPath2, ParentLoc, NumMax, StraightNum;
-    unsigned long NumAlloc;
-    double     Delay, *SampleTime, ParentRos, ParentTime;
-    double     Separation, Overlap, OldOverlap, OldSeparation, StraightTime;
-    double    DirectTime, *ExitTime, *LateralDistances, *SpreadRates;
+    beginSpreadPaths();
+    calcSpreadPathsForRange(m_start, m_end);
+    endSpreadPaths();
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Makes sure the scratch arrays used by calcSpreadPathsForRange()
+ *  are big enough and computes the elliptical dimensions and lateral start
+ *  delays, which are the same for every combination handed to this thread.
+ *
+ *  The scratch arrays and the two path arrays are kept between calls and
+ *  only reallocated when a larger block comes along, so the many small
+ *  runs made for lateral extensions do not allocate at all.
+ */
 
-    if (m_firstSample != 0)
+void RandThread::beginSpreadPaths(void)
+{
+    long i, NumMax;
+
+    m_isLateral = (m_firstSample != 0);
+    m_pathMemoryExceeded = false;
+
+    if (m_samples > m_sampleCapacity)
     {
-        Lateral = true;
+        delete[] m_exitTime;
+        delete[] m_sampleTime;
+        m_exitTime = new double[m_samples];
+        m_sampleTime = new double[m_samples];
+        m_sampleCapacity = m_samples;
     }
-
-    ExitTime = new double[m_samples];
-    memset(ExitTime, 0x0, m_samples*sizeof(double));
+    memset(m_exitTime, 0x0, m_samples*sizeof(double));
     if (m_firstSample > 0)
     {
         // store number of startdelays
-        m_startDelay[0] = new double[m_firstSample];
-        m_startDelay[1] = new double[m_firstSample];
+        if (m_firstSample > m_startDelayCapacity)
+        {
+            for (i = 0; i < 2; i++)
+            {
+                delete[] m_startDelay[i];
+                m_startDelay[i] = new double[m_firstSample];
+            }
+            m_startDelayCapacity = m_firstSample;
+        }
         memset(m_startDelay[0], 0x0, m_firstSample*sizeof(double));
         memset(m_startDelay[1], 0x0, m_firstSample*sizeof(double));
     }
-    SampleTime = new double[m_samples];
-    NumAlloc = (unsigned long)pow((double)m_samples, (int)m_depths);
-    m_firstPath = new PathStruct[NumAlloc];
-    m_newPath = new PathStruct[NumAlloc];
     NumMax = m_samples;
     if (m_depths > m_samples)
     {
         NumMax = m_depths;
     }
-    LateralDistances = new double[NumMax];
-    SpreadRates = new double[NumMax + 1];
+    if (NumMax > m_layerCapacity)
+    {
+        delete[] m_lateralDistances;
+        delete[] m_spreadRates;
+        delete[] m_flankingTimes;
+        m_lateralDistances = new double[NumMax];
+        m_spreadRates = new double[NumMax + 1];
+        m_flankingTimes = new double[NumMax];
+        m_layerCapacity = NumMax;
+    }
+
+    // The path arrays used to be allocated at samples^depths; that count
+    // is still the bound on the right hand neighbour index, so keep it
+    // (saturated, as it only takes part in a comparison)
+    m_numAlloc = 1;
+    for (i = 0; i < m_depths; i++)
+    {
+        if (m_numAlloc > (unsigned long)LONG_MAX / (unsigned long)m_samples)
+        {
+            m_numAlloc = (unsigned long)LONG_MAX;
+            break;
+        }
+        m_numAlloc *= (unsigned long)m_samples;
+    }
+    // room for the ignition point, the paths it spawns grow m_newPath as needed
+    if (m_firstPathCapacity < 1)
+    {
+        delete[] m_firstPath;
+        m_firstPath = new PathStruct[1];
+        m_firstPathCapacity = 1;
+    }
+
     calcEllipticalDimensions();
     if (m_firstSample > 0)
     {
@@ -249,9 +422,188 @@ void RandThread::calcSpreadPaths2(void)
         // calculate all start delays for lateral extensions, right
         calcStartDelay(m_firstSample, 1);
     }
-    for (i = m_start; i < m_end; i++)
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Finishes a run started by beginSpreadPaths().
+ *
+ *  The scratch arrays are left in place for the next run; they are
+ *  released by the destructor.
+ */
+
+void RandThread::endSpreadPaths(void)
+{
+    m_curPath = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Releases the scratch and path arrays.
+ */
+
+void RandThread::freeSpreadPaths(void)
+{
+    long i;
+    delete[] m_sampleTime;
+    m_sampleTime = 0;
+    delete[] m_exitTime;
+    m_exitTime = 0;
+    m_sampleCapacity = 0;
+    for (i = 0; i < 2; i++)
     {
+        delete[] m_startDelay[i];
+        m_startDelay[i] = 0;
+    }
+    m_startDelayCapacity = 0;
+    delete[] m_firstPath;
+    m_firstPath = 0;
+    m_firstPathCapacity = 0;
+    delete[] m_newPath;
+    m_newPath = 0;
+    m_newPathCapacity = 0;
+    m_curPath = 0;
+    delete[] m_lateralDistances;
+    m_lateralDistances = 0;
+    delete[] m_spreadRates;
+    m_spreadRates = 0;
+    delete[] m_flankingTimes;
+    m_flankingTimes = 0;
+    m_layerCapacity = 0;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Grows m_newPath to hold at least p_paths paths, keeping the
+ *  paths already stored in it.
+ *
+ *  The array at least doubles so that a run of addNewPath() calls only
+ *  reallocates a few times.  m_firstPath, which m_curPath points into,
+ *  is never touched.
+ *
+ *  \return false (leaving m_newPath as it was) if both path arrays
+ *  together would go over m_pathMemoryLimit.
+ */
+
+bool RandThread::growNewPaths(unsigned long p_paths)
+{
+    unsigned long capacity = 2 * m_newPathCapacity;
+    if (capacity < 16)
+    {
+        capacity = 16;
+    }
+    if (capacity < p_paths)
+    {
+        capacity = p_paths;
+    }
+    if (m_pathMemoryLimit > 0)
+    {
+        unsigned long maxPaths = m_pathMemoryLimit / sizeof(PathStruct);
+        maxPaths = (maxPaths > m_firstPathCapacity) ? maxPaths - m_firstPathCapacity : 0;
+        if (capacity > maxPaths)
+        {
+            capacity = maxPaths;
+        }
+        if (capacity < p_paths)
+        {
+            m_pathMemoryExceeded = true;
+            return(false);
+        }
+    }
+
+    PathStruct *paths = new PathStruct[capacity];
+    if (m_newPath)
+    {
+        memcpy(paths, m_newPath, m_newPathCapacity * sizeof(PathStruct));
+        delete[] m_newPath;
+    }
+    m_newPath = paths;
+    m_newPathCapacity = capacity;
+    return(true);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Returns true if the last run gave up because the paths of a
+ *  combination did not fit under the limit set by setPathMemoryLimit().
+ *  The max spread rates of such a run are not valid.
+ */
+
+bool RandThread::isPathMemoryExceeded(void) const
+{
+    return(m_pathMemoryExceeded);
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the RunControl polled before each combination of
+ *  calcSpreadPathsForRange(); the range stops early once it requests a stop.
+ */
+
+void RandThread::setRunControl(const RunControl *p_runControl)
+{
+    m_runControl = p_runControl;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets how the lateral sweeps of calcSpreadPathsForRange() are
+ *  calculated: Exact (the default) calls calcFlankingTime() for every
+ *  cell of the sweep, Fast works out the whole sweep with
+ *  calcFlankingTimes(), which agrees within rounding.
+ */
+
+void RandThread::setVectorMathMode(VectorMathMode::VectorMathModeEnum p_mode)
+{
+    m_vectorMathMode = p_mode;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Sets the most memory, in bytes, this thread may use to hold
+ *  spread paths.  Zero (the default) means no limit.
+ */
+
+void RandThread::setPathMemoryLimit(unsigned long p_bytes)
+{
+    m_pathMemoryLimit = p_bytes;
+    return;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculates the max spread rate of combinations [p_begin, p_end)
+ *  using the scratch arrays set up by beginSpreadPaths().
+ *
+ *  The result for each combination only depends on that combination, so
+ *  the range may be any subset of the combinations given to setThreadData().
+ */
+
+void RandThread::calcSpreadPathsForRange(long p_begin, long p_end)
+{
+    bool Lateral = m_isLateral;
+    long i, j, k, m, n, p;
+    long NumPath1, NumPath2, ParentLoc, StraightNum;
+    unsigned long NumAlloc = m_numAlloc;
+    double     Delay, *SampleTime, ParentRos, ParentTime;
+    double     Separation, Overlap, OldOverlap, OldSeparation, StraightTime;
+    double    DirectTime, *LateralDistances, *SpreadRates;
+
+    SampleTime = m_sampleTime;
+    LateralDistances = m_lateralDistances;
+    SpreadRates = m_spreadRates;
+    for (i = p_begin; i < p_end; i++)
+    {
+        if (m_pathMemoryExceeded)
+        {
+            // the run is no good anymore, don't bother with the rest
+            return;
+        }
+        if (m_runControl && m_runControl->isStopRequested())
+        {
+            // combinations from here on are left untouched
+            return;
+        }
         m_maxRosArray[i] = 0.0;
+        // spread rates of this block are contiguous, row j at j * m_samples
+        const double *blockRos = (*m_rosArray)[i];
         for (p = 0; p < m_samples; p++)   // make it very large
         {
             SampleTime[p] = 9e12;
@@ -301,7 +653,7 @@ void RandThread::calcSpreadPaths2(void)
             NumPath2 = 0;
             for (n = 0; n < NumPath1; n++)
             {
-                ParentRos = m_rosArray[i][j * m_samples + m_curPath->m_loc];
+                ParentRos = blockRos[j * m_samples + m_curPath->m_loc];
                 if (ParentRos > 0.0)
                 {
                     Separation = m_cellSize;
@@ -316,7 +668,7 @@ void RandThread::calcSpreadPaths2(void)
                     do
                     {
                         LateralDistances[p] = Overlap;
-                        SpreadRates[p] = m_rosArray[i][p*m_samples + m_curPath->m_loc];
+                        SpreadRates[p] = blockRos[p*m_samples + m_curPath->m_loc];
                         if (Separation > m_cellSize)
                         {
                             LateralDistances[p] = Overlap / (double)(j + 1);
@@ -337,8 +689,7 @@ void RandThread::calcSpreadPaths2(void)
                         for (p = 0; p < StraightNum; p++)
                         {
                             StraightTime += m_cellSize
-                                / m_rosArray[i]
-                                [(j - p - 1) * m_samples + m_curPath->m_loc];
+                                / blockRos[(j - p - 1) * m_samples + m_curPath->m_loc];
                         }
                         Delay += (ParentTime - StraightTime);
                         Separation = m_cellSize;
@@ -368,8 +719,7 @@ void RandThread::calcSpreadPaths2(void)
                             {
                                 break;
                             }
-                            SpreadRates[p] = m_rosArray[i]
-                                [j * m_samples + ParentLoc - p];
+                            SpreadRates[p] = blockRos[j * m_samples + ParentLoc - p];
                         }
                         for (p = 1; p < m_samples - 1; p++)
                         {
@@ -383,6 +733,10 @@ void RandThread::calcSpreadPaths2(void)
                                 break;
                             }
                             LateralDistances[p] = m_cellSize;
+                            if (m_vectorMathMode == VectorMathMode::Fast)
+                            {
+                                continue;
+                            }
                             //SpreadRates[p]=m_rosArray[i][j*m_samples+ParentLoc-p];
                             Overlap += m_cellSize;
                             Delay = calcFlankingTime(p + 1, Separation, Overlap,
@@ -390,6 +744,17 @@ void RandThread::calcSpreadPaths2(void)
                             addNewPath(&NumPath2, (Delay + ParentTime),
                                 ParentLoc - (p + 1), -1, 0.0);
                         }
+                        if (m_vectorMathMode == VectorMathMode::Fast)
+                        {
+                            // the sweep stopped at p, work it out in one go
+                            calcFlankingTimes(p, Separation, Overlap,
+                                LateralDistances, SpreadRates, m_flankingTimes);
+                            for (m = 1; m < p; m++)
+                            {
+                                addNewPath(&NumPath2, (m_flankingTimes[m] + ParentTime),
+                                    ParentLoc - (m + 1), -1, 0.0);
+                            }
+                        }
 
                         // go right
                         Overlap = OldOverlap;
@@ -400,8 +765,7 @@ void RandThread::calcSpreadPaths2(void)
                             {
                                 break;
                             }
-                            SpreadRates[p] = m_rosArray[i]
-                                [j*m_samples + ParentLoc + p];
+                            SpreadRates[p] = blockRos[j*m_samples + ParentLoc + p];
                         }
                         for (p = 1; p < m_samples - 1; p++)
                         {
@@ -416,12 +780,26 @@ void RandThread::calcSpreadPaths2(void)
                             }
                             //SpreadRates[p]=m_rosArray[i][j*m_samples+ParentLoc+p];
                             LateralDistances[p] = m_cellSize;
+                            if (m_vectorMathMode == VectorMathMode::Fast)
+                            {
+                                continue;
+                            }
                             Overlap += m_cellSize;
                             Delay = calcFlankingTime(p + 1, Separation, Overlap,
                                 LateralDistances, SpreadRates, REFRACT_LATERAL);
                             addNewPath(&NumPath2, (Delay + ParentTime),
                                 ParentLoc + (p + 1), 1, 0.0);
                         }
+                        if (m_vectorMathMode == VectorMathMode::Fast)
+                        {
+                            calcFlankingTimes(p, Separation, Overlap,
+                                LateralDistances, SpreadRates, m_flankingTimes);
+                            for (m = 1; m < p; m++)
+                            {
+                                addNewPath(&NumPath2, (m_flankingTimes[m] + ParentTime),
+                                    ParentLoc + (m + 1), 1, 0.0);
+                            }
+                        }
                     }
                 }
                 else
@@ -441,6 +819,9 @@ void RandThread::calcSpreadPaths2(void)
                         m_firstPath = m_newPath;
                         m_newPath = m_curPath;
                         m_curPath = m_firstPath;
+                        unsigned long capacity = m_firstPathCapacity;
+                        m_firstPathCapacity = m_newPathCapacity;
+                        m_newPathCapacity = capacity;
                         n = -1;
                         j++;
                     }
@@ -497,21 +878,6 @@ void RandThread::calcSpreadPaths2(void)
         }
     } // all combinations are done
 
-    // Release resources
-    delete[] SampleTime;
-    delete[] ExitTime;
-    for (i = 0; i < 2; i++)
-    {
-        if (m_startDelay[i])
-        {
-            delete[] m_startDelay[i];
-            m_startDelay[i] = 0;
-        }
-    }
-    delete[] m_firstPath;
-    delete[] m_newPath;
-    delete[] LateralDistances;
-    delete[] SpreadRates;
     return;
 }
 
@@ -571,7 +937,7 @@ void RandThread::calcStartDelay(long p_laterals, long p_leftRight)
 //------------------------------------------------------------------------------
 
 double RandThread::fastFlankTime(long XStart, long YStart, double Xmid,
-    long XEnd, long YEnd, long NumX, double **Ros)
+    long XEnd, long YEnd, long NumX, const double *Ros)
 {
     long NumCells, loc, sX, sY, NumVert;
     double TravelTime = 0.0;
@@ -644,7 +1010,7 @@ double RandThread::fastFlankTime(long XStart, long YStart, double Xmid,
     while ((nX + nY) < NumCells)
     {
         loc = (long)(YStart + nY * sY) * NumX + XStart + ((long)nX) * sX;
-        ROS = (*Ros)[loc];
+        ROS = Ros[loc];
         if (ROS == 0.0)
         {
             ROS = 1e-6;
@@ -711,7 +1077,7 @@ double RandThread::fastFlankTime(long XStart, long YStart, double Xmid,
     NumVert = 0;
     do
     {
-        ROS = (*Ros)[loc];
+        ROS = Ros[loc];
         if (ROS > 0.0)
         {
             TravelTime += Fract / ROS;
@@ -727,7 +1093,8 @@ double RandThread::fastFlankTime(long XStart, long YStart, double Xmid,
 //------------------------------------------------------------------------------
 
 void RandThread::setThreadData(long p_samples, long p_depths, long p_combs,
-    double p_lbRatio, double **p_combArray, double **p_rosArray,
+    double p_lbRatio, const RandBlockArray *p_combArray,
+    const RandBlockArray *p_rosArray,
     double *p_maxRosArray, long p_start, long p_end, long p_firstSample,
     long p_lastSample, double *p_m_latRosArray, long p_lessIgns)
 {
@@ -750,7 +1117,7 @@ void RandThread::setThreadData(long p_samples, long p_depths, long p_combs,
 //------------------------------------------------------------------------------
 
 double RandThread::spreadTime(long XStart, long YStart, double Xmid,
-    long XEnd, long YEnd, long NumX, double **Ros, long Flank)
+    long XEnd, long YEnd, long NumX, const double *Ros, long Flank)
 {
     long   NumCells, loc, sX, sY;
     double TravelTime = 0.0, FlankTime;
@@ -825,7 +1192,7 @@ double RandThread::spreadTime(long XStart, long YStart, double Xmid,
     while (nX + nY < NumCells)
     {
         loc = (long)(YStart + nY * sY) * NumX + XStart + ((long)nX) * sX;
-        ROS = (*Ros)[loc];
+        ROS = Ros[loc];
 
         if (ROS == 0.0)
         {
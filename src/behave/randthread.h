@@ -51,13 +51,54 @@
 #ifndef RANDTHREAD_H
 #define RANDTHREAD_H
 
+#include "vectorMath.h"
+
 #define REFRACT_LATERAL 0
 #define REFRACT_FORWARD 1
 
+class RunControl;
+
 //------------------------------------------------------------------------------
 
 double pow2(double input);
 
+//------------------------------------------------------------------------------
+/*! \class RandBlockArray randthread.h
+ *  \brief Contiguous storage for the probabilities or spread rates of
+ *  every fuel arrangement (block) in an EXRATE sample.
+ *
+ *  All blocks live in a single row-major allocation, block \a i starting
+ *  at data() + i * stride(), so block scans walk memory with unit stride
+ *  and the whole array is released with one delete.  operator[] returns
+ *  the start of a block, so existing array[block][cell] indexing works.
+ */
+
+class RandBlockArray
+{
+public:
+    RandBlockArray(void);
+    ~RandBlockArray(void);
+    bool    alloc(long p_blocks, long p_cells);
+    void    free(void);
+
+    //! Returns the first cell of block \a p_block.
+    double *operator[](long p_block) const { return(m_data + p_block * m_stride); }
+    //! Returns the start of the contiguous storage, or 0 if not allocated.
+    double *data(void) const { return(m_data); }
+    //! Returns the number of blocks allocated.
+    long    blocks(void) const { return(m_blocks); }
+    //! Returns the number of cells per block.
+    long    stride(void) const { return(m_stride); }
+
+private:
+    RandBlockArray(const RandBlockArray &);
+    RandBlockArray &operator=(const RandBlockArray &);
+
+    double *m_data;     //!< m_blocks * m_stride doubles
+    long    m_blocks;   //!< number of blocks
+    long    m_stride;   //!< number of cells in each block
+};
+
 //------------------------------------------------------------------------------
 /*! \typedef PathStruct
  *  \brief Linked list structure for pathtimes allocated by each RandThread
@@ -81,9 +122,17 @@ class RandThread
 public:
     RandThread();
     ~RandThread();
+    void    beginSpreadPaths(void);
     void    calcSpreadPaths2(void);
+    void    calcSpreadPathsForRange(long p_begin, long p_end);
+    void    endSpreadPaths(void);
+    bool    isPathMemoryExceeded(void) const;
+    void    setPathMemoryLimit(unsigned long p_bytes);
+    void    setRunControl(const RunControl *p_runControl);
+    void    setVectorMathMode(VectorMathMode::VectorMathModeEnum p_mode);
     void    setThreadData(long p_samples, long p_depths, long p_combs,
-        double p_lbRatio, double **p_combArray, double **p_rosArray,
+        double p_lbRatio, const RandBlockArray *p_combArray,
+        const RandBlockArray *p_rosArray,
         double *p_maxRosArray, long p_start, long p_end,
         long p_firstSample, long p_lastSample,
         double *p_m_latRosArray, long p_lessIgns);
@@ -92,17 +141,22 @@ public:
 protected:
     void    addNewPath(long *NumPath2, double p_time, long p_loc,
         long p_ignitionPt, double p_relCellSize);
+    void    freeSpreadPaths(void);
+    bool    growNewPaths(unsigned long p_paths);
     void    calcEllipticalDimensions(void);
     double  calcFlankingTime(long p_numLayers, double p_separation,
         double p_overlap, double *p_latDist, double *p_ros,
         long p_refractDir);
+    void    calcFlankingTimes(long p_numLayers, double p_separation,
+        double p_overlap, const double *p_latDist, const double *p_ros,
+        double *p_times);
     double  calcLateralRos(double p_forwardRos);
     void    calcStartDelay(long p_laterals, long p_leftRight);
     double  fastFlankTime(long XStart, long YStart, double Xmid,
-        long XEnd, long YEnd, long NumX, double **ros);
+        long XEnd, long YEnd, long NumX, const double *ros);
     double  spreadTime(long XStart, long YStart, double Xmid,
         long XEnd, long YEnd, long NumX,
-        double **ros, long FastFlank);
+        const double *ros, long FastFlank);
 
     //Private data
 protected:
@@ -119,15 +173,31 @@ protected:
     long        m_end;          //!< start and end for thread
     long        m_firstSample;  //!< specify ignition pts along the x axis
     long        m_lastSample;   //!< specify ignition pts along the x axis
-    double    **m_combArray;    //!< probability array for all blocks, from RandFuel
-    double    **m_rosArray;     //!< spread rate array for all blocks, from RandFuel
+    const RandBlockArray *m_combArray; //!< probability array for all blocks, from RandFuel
+    const RandBlockArray *m_rosArray;  //!< spread rate array for all blocks, from RandFuel
     double     *m_maxRosArray;  //!< max ROS for all blocks, passed in from RandFuel
     double      m_latRos;       //!< lateral spread rate from ig pt
     PathStruct *m_firstPath;    //!< pointer to array of PathStructs
     PathStruct *m_curPath;      //!< pointer to array of PathStructs
     PathStruct *m_newPath;      //!< pointer to array of PathStructs
+    unsigned long m_firstPathCapacity;  //!< number of PathStructs allocated in m_firstPath
+    unsigned long m_newPathCapacity;    //!< number of PathStructs allocated in m_newPath
+    unsigned long m_pathMemoryLimit;    //!< max bytes for both path arrays, 0 = no limit
+    bool        m_pathMemoryExceeded;   //!< set when a path did not fit under m_pathMemoryLimit
+    const RunControl *m_runControl;     //!< polled before each combination, may be null
     double     *m_startDelay[2];//!< pointer to delay data for extra row
     double     *m_latRosArray;  //!< pointer to delay data for extra row
+    double     *m_sampleTime;   //!< min path time per ignition point, scratch
+    double     *m_exitTime;     //!< exit time per column, scratch
+    double     *m_lateralDistances; //!< lateral distances of adjacent cells, scratch
+    double     *m_spreadRates;  //!< spread rates of adjacent cells, scratch
+    double     *m_flankingTimes; //!< flanking times of a lateral sweep, scratch
+    long        m_sampleCapacity;   //!< size of m_sampleTime and m_exitTime
+    long        m_layerCapacity;    //!< size of m_lateralDistances (m_spreadRates is one more)
+    long        m_startDelayCapacity; //!< size of each m_startDelay array
+    unsigned long m_numAlloc;   //!< samples^depths, index bound used when going right
+    bool        m_isLateral;    //!< true if ignition points include lateral extensions
+    VectorMathMode::VectorMathModeEnum m_vectorMathMode; //!< Fast runs each lateral sweep through calcFlankingTimes()
 };
 
 #endif // RANDTHREAD_H
@@ -0,0 +1,353 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  A content addressed cache of run results that persists
+*           across runs on disk
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "resultCache.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "crown.h"
+
+namespace
+{
+    const char fileMagic[8] = { 'B', 'E', 'H', 'A', 'V', 'E', 'R', 'C' };
+
+    std::uint64_t hashString(const char* text)
+    {
+        // FNV-1a
+        std::uint64_t hash = 14695981039346656037ULL;
+        for(; *text; text++)
+        {
+            hash = (hash ^ (unsigned char)*text) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    bool writeBytes(FILE* file, const void* bytes, size_t size)
+    {
+        return fwrite(bytes, 1, size, file) == size;
+    }
+
+    bool readBytes(FILE* file, void* bytes, size_t size)
+    {
+        return fread(bytes, 1, size, file) == size;
+    }
+}
+
+const char* const ResultCache::ResultsVersion = "behave-results-1";
+
+bool ResultCacheKey::operator==(const ResultCacheKey& rhs) const
+{
+    return high == rhs.high && low == rhs.low;
+}
+
+ResultCacheKeyBuilder::ResultCacheKeyBuilder()
+    : high_(14695981039346656037ULL),
+    low_(0x6a09e667f3bcc908ULL)
+{
+    addWord(hashString(ResultCache::ResultsVersion));
+}
+
+void ResultCacheKeyBuilder::add(int value)
+{
+    addWord((std::uint64_t)(std::int64_t)value);
+}
+
+void ResultCacheKeyBuilder::add(double value)
+{
+    if(value == 0.0)
+    {
+        value = 0.0; // negative zero
+    }
+    else if(std::isnan(value))
+    {
+        value = std::nan("");
+    }
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    addWord(bits);
+}
+
+void ResultCacheKeyBuilder::addCrownRun(const Crown& crown, int crownFireMethod,
+    WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode)
+{
+    int fuelModelNumber = crown.getFuelModelNumber();
+    add(crownFireMethod);
+    add((int)windAndSpreadOrientationMode);
+    add(crown.getMoistureOneHour(FractionUnits::Fraction));
+    add(crown.getMoistureTenHour(FractionUnits::Fraction));
+    add(crown.getMoistureHundredHour(FractionUnits::Fraction));
+    add(crown.getMoistureLiveHerbaceous(FractionUnits::Fraction));
+    add(crown.getMoistureLiveWoody(FractionUnits::Fraction));
+    add(crown.getMoistureFoliar(FractionUnits::Fraction));
+    add(crown.getWindSpeed(SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot));
+    add(crown.getWindDirection());
+    add(crown.getSlope(SlopeUnits::Degrees));
+    add(crown.getAspect());
+    add(crown.getCanopyCover(FractionUnits::Fraction));
+    add(crown.getCanopyHeight(LengthUnits::Feet));
+    add(crown.getCrownRatio(FractionUnits::Fraction));
+    add(crown.getCanopyBaseHeight(LengthUnits::Feet));
+    add(crown.getCanopyBulkDensity(DensityUnits::PoundsPerCubicFoot));
+
+    add((int)crown.getWindAdjustmentFactorCalculationMethod());
+    add(crown.getUserProvidedWindAdjustmentFactor());
+    add(fuelModelNumber);
+    add(crown.isFuelDynamic(fuelModelNumber) ? 1 : 0);
+    add(crown.getFuelbedDepth(fuelModelNumber, LengthUnits::Feet));
+    add(crown.getFuelMoistureOfExtinctionDead(fuelModelNumber, FractionUnits::Fraction));
+    add(crown.getFuelHeatOfCombustionDead(fuelModelNumber, HeatOfCombustionUnits::BtusPerPound));
+    add(crown.getFuelHeatOfCombustionLive(fuelModelNumber, HeatOfCombustionUnits::BtusPerPound));
+    add(crown.getFuelLoadOneHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+    add(crown.getFuelLoadTenHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+    add(crown.getFuelLoadHundredHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+    add(crown.getFuelLoadLiveHerbaceous(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+    add(crown.getFuelLoadLiveWoody(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot));
+    add(crown.getFuelSavrOneHour(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet));
+    add(crown.getFuelSavrLiveHerbaceous(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet));
+    add(crown.getFuelSavrLiveWoody(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet));
+}
+
+ResultCacheKey ResultCacheKeyBuilder::getKey() const
+{
+    ResultCacheKey key = { high_, low_ };
+    return key;
+}
+
+void ResultCacheKeyBuilder::addWord(std::uint64_t word)
+{
+    // Two independent lanes, FNV-1a over the bytes of the word and a multiply rotate mix
+    for(int byte = 0; byte < 8; byte++)
+    {
+        high_ = (high_ ^ ((word >> (8 * byte)) & 0xff)) * 1099511628211ULL;
+    }
+    low_ = (low_ ^ word) * 0x9e3779b97f4a7c15ULL;
+    low_ = (low_ << 31) | (low_ >> 33);
+}
+
+std::size_t ResultCache::KeyHash::operator()(const ResultCacheKey& key) const
+{
+    return (std::size_t)(key.high ^ key.low);
+}
+
+ResultCache::ResultCache()
+    : capacity_(1000000),
+    evictionMode_(ResultCacheEvictionMode::LeastRecentlyUsed),
+    numberOfHits_(0),
+    numberOfMisses_(0)
+{
+
+}
+
+void ResultCache::setCapacity(long capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = (capacity < 0) ? 0 : capacity;
+    evictToCapacity();
+}
+
+void ResultCache::setEvictionMode(ResultCacheEvictionMode::ResultCacheEvictionModeEnum evictionMode)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    evictionMode_ = evictionMode;
+}
+
+long ResultCache::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+bool ResultCache::load(const std::string& fileName)
+{
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if(!file)
+    {
+        return true;
+    }
+
+    // Header: magic, hash of the results version, number of entries. Entries follow newest first.
+    char magic[sizeof(fileMagic)];
+    std::uint64_t version = 0;
+    std::uint64_t numberOfEntries = 0;
+    bool isRead = readBytes(file, magic, sizeof(magic)) && std::memcmp(magic, fileMagic, sizeof(magic)) == 0 &&
+        readBytes(file, &version, sizeof(version)) && readBytes(file, &numberOfEntries, sizeof(numberOfEntries));
+    if(!isRead)
+    {
+        fclose(file);
+        return false;
+    }
+    if(version != hashString(ResultsVersion))
+    {
+        fclose(file);
+        return true;
+    }
+
+    std::vector<Entry> entries;
+    for(std::uint64_t i = 0; i < numberOfEntries && isRead; i++)
+    {
+        Entry entry;
+        unsigned char numberOfValues = 0;
+        isRead = readBytes(file, &entry.key.high, sizeof(entry.key.high)) && readBytes(file, &entry.key.low, sizeof(entry.key.low)) &&
+            readBytes(file, &numberOfValues, 1) && numberOfValues <= ResultCacheRecord::MaxNumberOfValues &&
+            readBytes(file, entry.record.values, numberOfValues * sizeof(double));
+        entry.record.numberOfValues = numberOfValues;
+        if(isRead)
+        {
+            entries.push_back(entry);
+        }
+    }
+    fclose(file);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(size_t i = entries.size(); i-- > 0; )
+    {
+        insertLocked(entries[i].key, entries[i].record);
+    }
+    return isRead;
+}
+
+bool ResultCache::save(const std::string& fileName) const
+{
+    std::string partialFileName = fileName + ".partial";
+    FILE* file = fopen(partialFileName.c_str(), "wb");
+    if(!file)
+    {
+        return false;
+    }
+
+    bool isWritten;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t version = hashString(ResultsVersion);
+        std::uint64_t numberOfEntries = entries_.size();
+        isWritten = writeBytes(file, fileMagic, sizeof(fileMagic)) && writeBytes(file, &version, sizeof(version)) &&
+            writeBytes(file, &numberOfEntries, sizeof(numberOfEntries));
+        for(std::list<Entry>::const_iterator entry = entries_.begin(); entry != entries_.end() && isWritten; ++entry)
+        {
+            unsigned char numberOfValues = (unsigned char)entry->record.numberOfValues;
+            isWritten = writeBytes(file, &entry->key.high, sizeof(entry->key.high)) &&
+                writeBytes(file, &entry->key.low, sizeof(entry->key.low)) && writeBytes(file, &numberOfValues, 1) &&
+                writeBytes(file, entry->record.values, numberOfValues * sizeof(double));
+        }
+    }
+    isWritten = (fclose(file) == 0) && isWritten;
+
+    std::remove(fileName.c_str());
+    isWritten = isWritten && std::rename(partialFileName.c_str(), fileName.c_str()) == 0;
+    if(!isWritten)
+    {
+        std::remove(partialFileName.c_str());
+    }
+    return isWritten;
+}
+
+void ResultCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+void ResultCache::resetCounters()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    numberOfHits_ = 0;
+    numberOfMisses_ = 0;
+}
+
+bool ResultCache::find(const ResultCacheKey& key, ResultCacheRecord& record)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::unordered_map<ResultCacheKey, std::list<Entry>::iterator, KeyHash>::iterator found = index_.find(key);
+    if(found == index_.end())
+    {
+        numberOfMisses_++;
+        return false;
+    }
+    numberOfHits_++;
+    if(evictionMode_ == ResultCacheEvictionMode::LeastRecentlyUsed)
+    {
+        entries_.splice(entries_.begin(), entries_, found->second);
+    }
+    record = found->second->record;
+    return true;
+}
+
+void ResultCache::insert(const ResultCacheKey& key, const ResultCacheRecord& record)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    insertLocked(key, record);
+}
+
+long ResultCache::getNumberOfEntries() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (long)entries_.size();
+}
+
+long ResultCache::getNumberOfHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numberOfHits_;
+}
+
+long ResultCache::getNumberOfMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numberOfMisses_;
+}
+
+void ResultCache::insertLocked(const ResultCacheKey& key, const ResultCacheRecord& record)
+{
+    if(capacity_ == 0)
+    {
+        return;
+    }
+    std::unordered_map<ResultCacheKey, std::list<Entry>::iterator, KeyHash>::iterator found = index_.find(key);
+    if(found != index_.end())
+    {
+        found->second->record = record;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return;
+    }
+    Entry entry = { key, record };
+    entries_.push_front(entry);
+    index_[key] = entries_.begin();
+    evictToCapacity();
+}
+
+void ResultCache::evictToCapacity()
+{
+    while((long)entries_.size() > capacity_)
+    {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+    }
+}
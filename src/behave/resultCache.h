@@ -0,0 +1,159 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  A content addressed cache of run results that persists
+*           across runs on disk
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "surfaceInputEnums.h"
+
+class Crown;
+
+// 128 bit content hash of a run's inputs
+struct ResultCacheKey
+{
+    std::uint64_t high;
+    std::uint64_t low;
+
+    bool operator==(const ResultCacheKey& rhs) const;
+};
+
+// Builds a ResultCacheKey from a canonical sequence of base unit values. Every key starts from
+// ResultCache::ResultsVersion, so results of an older library never match. Negative zero hashes as
+// zero and every NaN alike.
+class ResultCacheKeyBuilder
+{
+public:
+    ResultCacheKeyBuilder();
+
+    void add(int value);
+    void add(double value);
+    // The inputs a Crown holds for its next run, read back in base units, with the settings that change
+    // its results: the run method, the orientation mode, the wind adjustment factor method and the
+    // numeric values of the fuel model, which can be a custom one
+    void addCrownRun(const Crown& crown, int crownFireMethod,
+        WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode);
+
+    ResultCacheKey getKey() const;
+
+protected:
+    void addWord(std::uint64_t word);
+
+    std::uint64_t high_;
+    std::uint64_t low_;
+};
+
+// The outputs of a cached run, at most MaxNumberOfValues base unit values. The Crown runs of the
+// engines store spread rate, flame length, fireline intensity, fire type and crown fraction burned.
+struct ResultCacheRecord
+{
+    static const int MaxNumberOfValues = 8;
+    static const int NumberOfCrownRunValues = 5;
+
+    int numberOfValues;
+    double values[MaxNumberOfValues];
+};
+
+struct ResultCacheEvictionMode
+{
+    enum ResultCacheEvictionModeEnum
+    {
+        LeastRecentlyUsed,  // a hit makes an entry the newest
+        FirstInFirstOut     // entries age from when they were inserted, hits or not
+    };
+};
+
+// A content addressed cache of run results that can be saved to disk and loaded by later runs, so
+// runs repeating earlier inputs, such as the same forecast hours in the next model cycle, look their
+// results up instead of calculating them. The engines that take a ResultCache, LandscapeRunner and
+// BehaveRun::doTimeSeriesRun(), key each run on a hash of its base unit inputs and settings and store
+// a record of its outputs. Entries are capped at the capacity, evicting the oldest by the eviction
+// mode, and the cache file takes 17 bytes per entry plus 8 per value. A file saved by a different ResultsVersion
+// loads as empty. Files use the machine's byte order. The cache locks around every lookup, so threads
+// of one engine can share it.
+class ResultCache
+{
+public:
+    // Changed whenever the calculations change any result, so older cache files are not reused
+    static const char* const ResultsVersion;
+
+    ResultCache();
+
+    ResultCache(const ResultCache& rhs) = delete;
+    ResultCache& operator=(const ResultCache& rhs) = delete;
+
+    // Zero turns the cache off, the default is one million entries
+    void setCapacity(long capacity);
+    void setEvictionMode(ResultCacheEvictionMode::ResultCacheEvictionModeEnum evictionMode);
+    long getCapacity() const;
+
+    // Adds the entries of a cache file, keeping the newest up to the capacity. False if the file
+    // could not be read, a missing file leaves the cache as it was
+    bool load(const std::string& fileName);
+    // Writes every entry, first under a temporary name that is then renamed over fileName
+    bool save(const std::string& fileName) const;
+    void clear();
+    void resetCounters();
+
+    bool find(const ResultCacheKey& key, ResultCacheRecord& record);
+    void insert(const ResultCacheKey& key, const ResultCacheRecord& record);
+
+    long getNumberOfEntries() const;
+    long getNumberOfHits() const;
+    long getNumberOfMisses() const;
+
+protected:
+    struct KeyHash
+    {
+        std::size_t operator()(const ResultCacheKey& key) const;
+    };
+
+    struct Entry
+    {
+        ResultCacheKey key;
+        ResultCacheRecord record;
+    };
+
+    void insertLocked(const ResultCacheKey& key, const ResultCacheRecord& record);
+    void evictToCapacity();
+
+    mutable std::mutex mutex_;
+    long capacity_;
+    ResultCacheEvictionMode::ResultCacheEvictionModeEnum evictionMode_;
+    long numberOfHits_;
+    long numberOfMisses_;
+    std::list<Entry> entries_; // newest first
+    std::unordered_map<ResultCacheKey, std::list<Entry>::iterator, KeyHash> index_;
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,120 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Cooperative cancel, progress and time budget token for long-running
+*           calculations
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "runControl.h"
+
+RunControl::RunControl()
+{
+    reset();
+}
+
+void RunControl::reset()
+{
+    isStopRequested_.store(false);
+    status_.store(RunStatus::Running);
+    hasDeadline_.store(false);
+    deadline_.store(0);
+    workDone_.store(0);
+    totalWork_.store(0);
+}
+
+void RunControl::cancel()
+{
+    stop(RunStatus::Cancelled);
+}
+
+void RunControl::setTimeBudget(double timeBudgetInSeconds)
+{
+    Clock::duration budget = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(timeBudgetInSeconds));
+    deadline_.store((Clock::now() + budget).time_since_epoch().count());
+    hasDeadline_.store(true);
+}
+
+void RunControl::clearTimeBudget()
+{
+    hasDeadline_.store(false);
+}
+
+bool RunControl::isStopRequested() const
+{
+    if (isStopRequested_.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+    if (!hasDeadline_.load(std::memory_order_relaxed)
+        || Clock::now().time_since_epoch().count() < deadline_.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    stop(RunStatus::DeadlineExceeded);
+    return true;
+}
+
+RunStatus::RunStatusEnum RunControl::getStatus() const
+{
+    return static_cast<RunStatus::RunStatusEnum>(status_.load());
+}
+
+void RunControl::beginWork(long totalWork)
+{
+    workDone_.store(0);
+    totalWork_.store(totalWork);
+}
+
+void RunControl::addWorkDone(long workDone)
+{
+    workDone_.fetch_add(workDone, std::memory_order_relaxed);
+}
+
+long RunControl::getWorkDone() const
+{
+    return workDone_.load(std::memory_order_relaxed);
+}
+
+long RunControl::getTotalWork() const
+{
+    return totalWork_.load(std::memory_order_relaxed);
+}
+
+double RunControl::getProgress() const
+{
+    long totalWork = getTotalWork();
+    if (totalWork <= 0)
+    {
+        return 0.0;
+    }
+    double progress = static_cast<double>(getWorkDone()) / static_cast<double>(totalWork);
+    return (progress < 1.0) ? progress : 1.0;
+}
+
+void RunControl::stop(RunStatus::RunStatusEnum status) const
+{
+    int running = RunStatus::Running;
+    status_.compare_exchange_strong(running, status);
+    isStopRequested_.store(true);
+}
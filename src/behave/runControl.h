@@ -0,0 +1,92 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Cooperative cancel, progress and time budget token for long-running
+*           calculations
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef RUNCONTROL_H
+#define RUNCONTROL_H
+
+#include <atomic>
+#include <chrono>
+
+struct RunStatus
+{
+    enum RunStatusEnum
+    {
+        Running,            // not stopped, or finished without being stopped
+        Cancelled,          // cancel() was called
+        DeadlineExceeded    // the time budget ran out
+    };
+};
+
+// Cooperative cancel, progress and time budget token shared between a
+// long-running engine and the code that started it. The engine polls
+// isStopRequested() from its inner loop, one cheap atomic load plus a clock
+// read when a deadline is set, and counts finished work items with
+// addWorkDone(). Any thread may call cancel() or read the progress while
+// the run is going. A stopped engine returns what it had finished and the
+// caller reads why from getStatus().
+class RunControl
+{
+public:
+    RunControl();
+
+    RunControl(const RunControl& rhs) = delete;
+    RunControl& operator=(const RunControl& rhs) = delete;
+
+    // Clears any cancel, deadline and progress so the token can be reused
+    void reset();
+
+    void cancel();
+    // Stops the run once timeBudgetInSeconds have passed from now
+    void setTimeBudget(double timeBudgetInSeconds);
+    void clearTimeBudget();
+
+    bool isStopRequested() const;
+    RunStatus::RunStatusEnum getStatus() const;
+
+    // Set by the engine at the start of a run, totalWork is zero when unknown
+    void beginWork(long totalWork);
+    void addWorkDone(long workDone);
+    long getWorkDone() const;
+    long getTotalWork() const;
+    // Fraction of the total work done, zero while the total is unknown
+    double getProgress() const;
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    void stop(RunStatus::RunStatusEnum status) const;
+
+    mutable std::atomic<bool> isStopRequested_;
+    mutable std::atomic<int> status_;       // RunStatus::RunStatusEnum, first reason to stop wins
+    std::atomic<bool> hasDeadline_;
+    std::atomic<Clock::rep> deadline_;      // Clock ticks since the clock's epoch
+    std::atomic<long> workDone_;
+    std::atomic<long> totalWork_;
+};
+
+#endif // RUNCONTROL_H
@@ -43,16 +43,58 @@ void Safety::updateSafetyInputs(double flameHeight, LengthUnits::LengthUnitsEnum
 void Safety::calculateSafetyZone()
 {
     calculateSafetyZoneSeparationDistance();
+    double coreRadius = calculateCoreRadius(numberOfPersonnel_, areaPerPerson_, numberOfEquipment_, areaPerEquipment_);
+    // Add 4 times the flame ht to the protected safety zone core
+    safetyZoneRadius_ = separationDistance_ + coreRadius;
+    safetyZoneArea_ = M_PI * safetyZoneRadius_ * safetyZoneRadius_;
+}
+
+bool Safety::hasSameInputs(const Safety& rhs) const
+{
+    return flameHeight_ == rhs.flameHeight_ &&
+        numberOfPersonnel_ == rhs.numberOfPersonnel_ &&
+        areaPerPerson_ == rhs.areaPerPerson_ &&
+        numberOfEquipment_ == rhs.numberOfEquipment_ &&
+        areaPerEquipment_ == rhs.areaPerEquipment_;
+}
+
+void Safety::calculateSafetyZonesBatch(const double* flameHeight, int count, SafetyBatchOutputs& outputs) const
+{
+    double coreRadius = calculateCoreRadius(numberOfPersonnel_, areaPerPerson_, numberOfEquipment_, areaPerEquipment_);
+    calculateSafetyZonesAtCoreRadius(coreRadius, flameHeight, count, outputs);
+}
+
+double Safety::calculateCoreRadius(double numberOfPersonnel, double areaPerPerson, double numberOfEquipment, double areaPerEquipment)
+{
     // Space needed by firefighters and equipment in core of safety zone
-    double coreRadius = (areaPerPerson_ * numberOfPersonnel_ +
-        numberOfEquipment_ * areaPerEquipment_) / M_PI;
+    double coreRadius = (areaPerPerson * numberOfPersonnel +
+        numberOfEquipment * areaPerEquipment) / M_PI;
     if (coreRadius > 1.0e-07)
     {
         coreRadius = sqrt(coreRadius);
     }
-    // Add 4 times the flame ht to the protected safety zone core
-    safetyZoneRadius_ = separationDistance_ + coreRadius;
-    safetyZoneArea_ = M_PI * safetyZoneRadius_ * safetyZoneRadius_;
+    return coreRadius;
+}
+
+void Safety::calculateSafetyZonesAtCoreRadius(double coreRadius, const double* flameHeight, int count, SafetyBatchOutputs& outputs)
+{
+    for (int i = 0; i < count; i++)
+    {
+        double separationDistance = 4.0 * flameHeight[i];
+        double safetyZoneRadius = separationDistance + coreRadius;
+        if (outputs.separationDistance)
+        {
+            outputs.separationDistance[i] = separationDistance;
+        }
+        if (outputs.safetyZoneRadius)
+        {
+            outputs.safetyZoneRadius[i] = safetyZoneRadius;
+        }
+        if (outputs.safetyZoneArea)
+        {
+            outputs.safetyZoneArea[i] = M_PI * safetyZoneRadius * safetyZoneRadius;
+        }
+    }
 }
 
 double Safety::getSeparationDistance(LengthUnits::LengthUnitsEnum lengthUnits) const
@@ -86,3 +128,52 @@ void Safety::calculateSafetyZoneSeparationDistance()
 {
     separationDistance_ = 4.0 * flameHeight_;
 }
+
+SafetyZoneTable::SafetyZoneTable(double areaPerPerson, double areaPerEquipment, AreaUnits::AreaUnitsEnum areaUnits,
+    int maxNumberOfPersonnel, int maxNumberOfEquipment)
+{
+    areaPerPerson_ = AreaUnits::toBaseUnits(areaPerPerson, areaUnits);
+    areaPerEquipment_ = AreaUnits::toBaseUnits(areaPerEquipment, areaUnits);
+    maxNumberOfPersonnel_ = (maxNumberOfPersonnel < 0) ? 0 : maxNumberOfPersonnel;
+    maxNumberOfEquipment_ = (maxNumberOfEquipment < 0) ? 0 : maxNumberOfEquipment;
+
+    coreRadii_.resize((maxNumberOfPersonnel_ + 1) * (maxNumberOfEquipment_ + 1));
+    for (int personnel = 0; personnel <= maxNumberOfPersonnel_; personnel++)
+    {
+        for (int equipment = 0; equipment <= maxNumberOfEquipment_; equipment++)
+        {
+            coreRadii_[personnel * (maxNumberOfEquipment_ + 1) + equipment] =
+                Safety::calculateCoreRadius(personnel, areaPerPerson_, equipment, areaPerEquipment_);
+        }
+    }
+}
+
+int SafetyZoneTable::getMaxNumberOfPersonnel() const
+{
+    return maxNumberOfPersonnel_;
+}
+
+int SafetyZoneTable::getMaxNumberOfEquipment() const
+{
+    return maxNumberOfEquipment_;
+}
+
+double SafetyZoneTable::getCoreRadius(int numberOfPersonnel, int numberOfEquipment, LengthUnits::LengthUnitsEnum lengthUnits) const
+{
+    return LengthUnits::fromBaseUnits(getCoreRadiusInBaseUnits(numberOfPersonnel, numberOfEquipment), lengthUnits);
+}
+
+void SafetyZoneTable::calculateSafetyZones(int numberOfPersonnel, int numberOfEquipment, const double* flameHeight, int count,
+    SafetyBatchOutputs& outputs) const
+{
+    Safety::calculateSafetyZonesAtCoreRadius(getCoreRadiusInBaseUnits(numberOfPersonnel, numberOfEquipment), flameHeight, count, outputs);
+}
+
+double SafetyZoneTable::getCoreRadiusInBaseUnits(int numberOfPersonnel, int numberOfEquipment) const
+{
+    bool isInTable = numberOfPersonnel >= 0 && numberOfPersonnel <= maxNumberOfPersonnel_ &&
+        numberOfEquipment >= 0 && numberOfEquipment <= maxNumberOfEquipment_;
+    return isInTable
+        ? coreRadii_[numberOfPersonnel * (maxNumberOfEquipment_ + 1) + numberOfEquipment]
+        : Safety::calculateCoreRadius(numberOfPersonnel, areaPerPerson_, numberOfEquipment, areaPerEquipment_);
+}
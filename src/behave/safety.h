@@ -33,8 +33,18 @@
 #ifndef SAFETY_H
 #define SAFETY_H
 
+#include <vector>
 #include "behaveUnits.h"
 
+// Caller-provided output arrays for the safety zone batch calculations, each sized for count values and filled
+// in base units: distances in ft and area in ft^2. Any array may be null if that output is not needed.
+struct SafetyBatchOutputs
+{
+    double* separationDistance;
+    double* safetyZoneRadius;
+    double* safetyZoneArea;
+};
+
 class Safety
 {
 public:
@@ -48,15 +58,22 @@ public:
         double areaPerEquipment, AreaUnits::AreaUnitsEnum areaUnits);
 
     void calculateSafetyZone();
+    // calculateSafetyZone() for count flame heights (ft) with the current crew and equipment
+    void calculateSafetyZonesBatch(const double* flameHeight, int count, SafetyBatchOutputs& outputs) const;
 
     double getSeparationDistance(LengthUnits::LengthUnitsEnum lengthUnits) const;
     double getSafetyZoneRadius(LengthUnits::LengthUnitsEnum lengthUnits) const;
     double getSafetyZoneArea(AreaUnits::AreaUnitsEnum areaUnits) const;
 
     void initializeMembers();
+    bool hasSameInputs(const Safety& rhs) const;
 
 protected:
+    friend class SafetyZoneTable;
+
     void calculateSafetyZoneSeparationDistance();
+    static double calculateCoreRadius(double numberOfPersonnel, double areaPerPerson, double numberOfEquipment, double areaPerEquipment);
+    static void calculateSafetyZonesAtCoreRadius(double coreRadius, const double* flameHeight, int count, SafetyBatchOutputs& outputs);
 
     //Inputs
     double flameHeight_;        // flame height (ft)
@@ -71,4 +88,31 @@ protected:
     double safetyZoneArea_;     // radius of minimum circular safety zone that protect the specified number of personnel and heavy equipment from radiant burn injury
 };
 
+// Safety zone core radii for every crew of up to maxNumberOfPersonnel personnel and maxNumberOfEquipment pieces of
+// equipment, with fixed areas per person and per piece of equipment. The core radius is the only part of a safety
+// zone that depends on the crew, so once the table is built a flame height raster costs one multiply-add per
+// crew and pixel. Tables are immutable and can be kept and shared between threads. Crews outside the table are
+// worked out on the fly.
+class SafetyZoneTable
+{
+public:
+    SafetyZoneTable(double areaPerPerson, double areaPerEquipment, AreaUnits::AreaUnitsEnum areaUnits, int maxNumberOfPersonnel,
+        int maxNumberOfEquipment);
+
+    int getMaxNumberOfPersonnel() const;
+    int getMaxNumberOfEquipment() const;
+    double getCoreRadius(int numberOfPersonnel, int numberOfEquipment, LengthUnits::LengthUnitsEnum lengthUnits) const;
+    void calculateSafetyZones(int numberOfPersonnel, int numberOfEquipment, const double* flameHeight, int count,
+        SafetyBatchOutputs& outputs) const;
+
+protected:
+    double getCoreRadiusInBaseUnits(int numberOfPersonnel, int numberOfEquipment) const;
+
+    double areaPerPerson_;      // ft^2
+    double areaPerEquipment_;   // ft^2
+    int maxNumberOfPersonnel_;
+    int maxNumberOfEquipment_;
+    std::vector<double> coreRadii_; // ft, by number of personnel then number of equipment
+};
+
 #endif  // SAFETY_H
@@ -0,0 +1,152 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Fuelbed and wind adjustment factor caches shared without locks on
+*           lookups by the Surfaces of all the workers of a threaded run
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "sharedSurfaceCache.h"
+
+#include <cstdint>
+#include <cstring>
+
+SharedSurfaceCache::SharedSurfaceCache()
+{
+    setCapacity(4096);
+}
+
+void SharedSurfaceCache::setCapacity(int capacity)
+{
+    fuelbeds_.setCapacity(capacity);
+    windAdjustmentFactors_.setCapacity(capacity);
+}
+
+int SharedSurfaceCache::getCapacity() const
+{
+    return fuelbeds_.getCapacity();
+}
+
+void SharedSurfaceCache::clear()
+{
+    fuelbeds_.clear();
+    windAdjustmentFactors_.clear();
+}
+
+void SharedSurfaceCache::resetCounters()
+{
+    fuelbeds_.resetCounters();
+    windAdjustmentFactors_.resetCounters();
+}
+
+int SharedSurfaceCache::getFuelbedNumberOfEntries() const
+{
+    return fuelbeds_.getNumberOfEntries();
+}
+
+long SharedSurfaceCache::getFuelbedNumberOfHits() const
+{
+    return fuelbeds_.getNumberOfHits();
+}
+
+long SharedSurfaceCache::getFuelbedNumberOfMisses() const
+{
+    return fuelbeds_.getNumberOfMisses();
+}
+
+int SharedSurfaceCache::getWindAdjustmentFactorNumberOfEntries() const
+{
+    return windAdjustmentFactors_.getNumberOfEntries();
+}
+
+long SharedSurfaceCache::getWindAdjustmentFactorNumberOfHits() const
+{
+    return windAdjustmentFactors_.getNumberOfHits();
+}
+
+long SharedSurfaceCache::getWindAdjustmentFactorNumberOfMisses() const
+{
+    return windAdjustmentFactors_.getNumberOfMisses();
+}
+
+bool SharedSurfaceCache::findFuelbed(const SurfaceFuelbedCache::Key& key, SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+    SurfaceFireReactionIntensity& surfaceFireReactionIntensity)
+{
+    const FuelbedValue* found = fuelbeds_.find(key);
+    if(found == nullptr)
+    {
+        return false;
+    }
+    // The copies keep the pointers to this worker's own fuel models, inputs and fuelbed
+    surfaceFuelbedIntermediates = found->surfaceFuelbedIntermediates;
+    surfaceFireReactionIntensity = found->surfaceFireReactionIntensity;
+    return true;
+}
+
+void SharedSurfaceCache::insertFuelbed(const SurfaceFuelbedCache::Key& key, const SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+    const SurfaceFireReactionIntensity& surfaceFireReactionIntensity)
+{
+    fuelbeds_.insert(key, FuelbedValue{ surfaceFuelbedIntermediates, surfaceFireReactionIntensity });
+}
+
+bool SharedSurfaceCache::findWindAdjustmentFactor(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio,
+    double fuelbedDepth, double& windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum& shelterMethod)
+{
+    WindAdjustmentFactorKey key = { isUsingCrownRatio, canopyCover, canopyHeight, crownRatio, fuelbedDepth };
+    const WindAdjustmentFactorValue* found = windAdjustmentFactors_.find(key);
+    if(found == nullptr)
+    {
+        return false;
+    }
+    windAdjustmentFactor = found->windAdjustmentFactor;
+    shelterMethod = found->shelterMethod;
+    return true;
+}
+
+void SharedSurfaceCache::insertWindAdjustmentFactor(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio,
+    double fuelbedDepth, double windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod)
+{
+    WindAdjustmentFactorKey key = { isUsingCrownRatio, canopyCover, canopyHeight, crownRatio, fuelbedDepth };
+    windAdjustmentFactors_.insert(key, WindAdjustmentFactorValue{ windAdjustmentFactor, shelterMethod });
+}
+
+bool SharedSurfaceCache::WindAdjustmentFactorKey::operator==(const WindAdjustmentFactorKey& rhs) const
+{
+    return isUsingCrownRatio == rhs.isUsingCrownRatio && canopyCover == rhs.canopyCover && canopyHeight == rhs.canopyHeight &&
+        crownRatio == rhs.crownRatio && fuelbedDepth == rhs.fuelbedDepth;
+}
+
+std::size_t SharedSurfaceCache::WindAdjustmentFactorKeyHash::operator()(const WindAdjustmentFactorKey& key) const
+{
+    // FNV-1a style combination of the bit patterns of the key fields, zero added so negative zero hashes as zero
+    const double values[] = { key.canopyCover + 0.0, key.canopyHeight + 0.0, key.crownRatio + 0.0, key.fuelbedDepth + 0.0 };
+    std::size_t hash = 14695981039346656037ULL;
+    hash = (hash ^ static_cast<std::size_t>(key.isUsingCrownRatio)) * 1099511628211ULL;
+    for(int i = 0; i < 4; i++)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        hash = (hash ^ static_cast<std::size_t>(bits)) * 1099511628211ULL;
+    }
+    return hash;
+}
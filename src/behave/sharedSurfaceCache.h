@@ -0,0 +1,291 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Fuelbed and wind adjustment factor caches shared without locks on
+*           lookups by the Surfaces of all the workers of a threaded run
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SHAREDSURFACECACHE_H
+#define SHAREDSURFACECACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "surfaceFuelbedCache.h"
+#include "windAdjustmentFactor.h"
+
+// A bounded hash table of immutable entries that any number of threads can look up and insert into.
+// Keys are split over NumberOfShards shards, each an open addressed table of entry pointers kept at
+// most half full. A lookup only loads slot pointers, so hits take no lock; an insertion locks its
+// shard, builds the entry and then publishes its pointer, so readers never see a partial entry.
+// Entries are never replaced or evicted: a full shard takes no more, which suits the few distinct
+// fuelbeds and canopies of a landscape. setCapacity() and clear() free the entries and must not run
+// while other threads use the table.
+template <typename Key, typename Value, typename KeyHash>
+class SharedCacheTable
+{
+public:
+    static const int NumberOfShards = 16;
+
+    SharedCacheTable()
+        : capacity_(0)
+    {
+
+    }
+
+    SharedCacheTable(const SharedCacheTable& rhs) = delete;
+    SharedCacheTable& operator=(const SharedCacheTable& rhs) = delete;
+
+    void setCapacity(int capacity)
+    {
+        capacity_ = (capacity < 0) ? 0 : capacity;
+        int maxNumberOfEntries = (capacity_ + NumberOfShards - 1) / NumberOfShards;
+        std::size_t numberOfSlots = 1;
+        while(numberOfSlots < 2 * (std::size_t)maxNumberOfEntries)
+        {
+            numberOfSlots *= 2;
+        }
+        for(int i = 0; i < NumberOfShards; i++)
+        {
+            Shard& shard = shards_[i];
+            shard.slots.reset(new std::atomic<const Entry*>[numberOfSlots]);
+            for(std::size_t slot = 0; slot < numberOfSlots; slot++)
+            {
+                shard.slots[slot].store(nullptr, std::memory_order_relaxed);
+            }
+            shard.numberOfSlots = numberOfSlots;
+            shard.maxNumberOfEntries = maxNumberOfEntries;
+            shard.entries.clear();
+            shard.numberOfEntries.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void clear()
+    {
+        setCapacity(capacity_);
+    }
+
+    void resetCounters()
+    {
+        for(int i = 0; i < NumberOfShards; i++)
+        {
+            shards_[i].numberOfHits.store(0, std::memory_order_relaxed);
+            shards_[i].numberOfMisses.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int getCapacity() const
+    {
+        return capacity_;
+    }
+
+    int getNumberOfEntries() const
+    {
+        int numberOfEntries = 0;
+        for(int i = 0; i < NumberOfShards; i++)
+        {
+            numberOfEntries += shards_[i].numberOfEntries.load(std::memory_order_relaxed);
+        }
+        return numberOfEntries;
+    }
+
+    long getNumberOfHits() const
+    {
+        long numberOfHits = 0;
+        for(int i = 0; i < NumberOfShards; i++)
+        {
+            numberOfHits += shards_[i].numberOfHits.load(std::memory_order_relaxed);
+        }
+        return numberOfHits;
+    }
+
+    long getNumberOfMisses() const
+    {
+        long numberOfMisses = 0;
+        for(int i = 0; i < NumberOfShards; i++)
+        {
+            numberOfMisses += shards_[i].numberOfMisses.load(std::memory_order_relaxed);
+        }
+        return numberOfMisses;
+    }
+
+    // The entry's value, valid until the next setCapacity() or clear(), or null on a miss
+    const Value* find(const Key& key)
+    {
+        std::size_t hash = KeyHash()(key);
+        Shard& shard = shards_[hash % NumberOfShards];
+        if(shard.maxNumberOfEntries == 0)
+        {
+            return nullptr;
+        }
+        std::size_t mask = shard.numberOfSlots - 1;
+        for(std::size_t slot = (hash / NumberOfShards) & mask; ; slot = (slot + 1) & mask)
+        {
+            const Entry* entry = shard.slots[slot].load(std::memory_order_acquire);
+            if(entry == nullptr)
+            {
+                shard.numberOfMisses.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if(entry->key == key)
+            {
+                shard.numberOfHits.fetch_add(1, std::memory_order_relaxed);
+                return &entry->value;
+            }
+        }
+    }
+
+    void insert(const Key& key, const Value& value)
+    {
+        std::size_t hash = KeyHash()(key);
+        Shard& shard = shards_[hash % NumberOfShards];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if((int)shard.entries.size() >= shard.maxNumberOfEntries)
+        {
+            return;
+        }
+        // Only insertions store to the slots, and they hold the lock
+        std::size_t mask = shard.numberOfSlots - 1;
+        std::size_t slot = (hash / NumberOfShards) & mask;
+        for(const Entry* entry = shard.slots[slot].load(std::memory_order_relaxed); entry != nullptr;
+            entry = shard.slots[slot].load(std::memory_order_relaxed))
+        {
+            if(entry->key == key)
+            {
+                return; // another thread got there first
+            }
+            slot = (slot + 1) & mask;
+        }
+        shard.entries.emplace_back(new Entry{ key, value });
+        shard.slots[slot].store(shard.entries.back().get(), std::memory_order_release);
+        shard.numberOfEntries.store((int)shard.entries.size(), std::memory_order_relaxed);
+    }
+
+protected:
+    struct Entry
+    {
+        Key key;
+        Value value;
+    };
+
+    struct Shard
+    {
+        Shard()
+            : numberOfSlots(0),
+            maxNumberOfEntries(0),
+            numberOfEntries(0),
+            numberOfHits(0),
+            numberOfMisses(0)
+        {
+
+        }
+
+        std::mutex mutex; // held by insertions only
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+        std::size_t numberOfSlots; // a power of two
+        int maxNumberOfEntries;
+        std::vector<std::unique_ptr<Entry>> entries;
+        std::atomic<int> numberOfEntries;
+        std::atomic<long> numberOfHits;
+        std::atomic<long> numberOfMisses;
+    };
+
+    int capacity_;
+    Shard shards_[NumberOfShards];
+};
+
+// Fuelbed intermediates and wind adjustment factors shared by the Surfaces of all the workers of a
+// threaded run, so the workers warm one cache between them rather than one each. A Surface given a
+// SharedSurfaceCache looks a fuelbed or wind adjustment factor up here when its own cache misses and
+// inserts what it calculates, using the keys of SurfaceFuelbedCache and WindAdjustmentFactorMemo.
+// Entries are immutable copies of the results, and a hit copies them into the Surface, so each worker
+// keeps its own fuel models and inputs. Only standard fuel models are shared, as in SurfaceFuelbedCache.
+// The cache must outlive the Surfaces using it, and setCapacity() and clear() must not run while they do.
+class SharedSurfaceCache
+{
+public:
+    SharedSurfaceCache();
+
+    SharedSurfaceCache(const SharedSurfaceCache& rhs) = delete;
+    SharedSurfaceCache& operator=(const SharedSurfaceCache& rhs) = delete;
+
+    // Entries of each of the two tables, zero turns the cache off, the default is 4096
+    void setCapacity(int capacity);
+    int getCapacity() const;
+    void clear();
+    void resetCounters();
+
+    int getFuelbedNumberOfEntries() const;
+    long getFuelbedNumberOfHits() const;
+    long getFuelbedNumberOfMisses() const;
+    int getWindAdjustmentFactorNumberOfEntries() const;
+    long getWindAdjustmentFactorNumberOfHits() const;
+    long getWindAdjustmentFactorNumberOfMisses() const;
+
+    bool findFuelbed(const SurfaceFuelbedCache::Key& key, SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+        SurfaceFireReactionIntensity& surfaceFireReactionIntensity);
+    void insertFuelbed(const SurfaceFuelbedCache::Key& key, const SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+        const SurfaceFireReactionIntensity& surfaceFireReactionIntensity);
+    bool findWindAdjustmentFactor(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio, double fuelbedDepth,
+        double& windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum& shelterMethod);
+    void insertWindAdjustmentFactor(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio, double fuelbedDepth,
+        double windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod);
+
+protected:
+    struct FuelbedValue
+    {
+        SurfaceFuelbedIntermediates surfaceFuelbedIntermediates;
+        SurfaceFireReactionIntensity surfaceFireReactionIntensity;
+    };
+
+    struct WindAdjustmentFactorKey
+    {
+        bool isUsingCrownRatio;
+        double canopyCover;
+        double canopyHeight;
+        double crownRatio;
+        double fuelbedDepth;
+
+        bool operator==(const WindAdjustmentFactorKey& rhs) const;
+    };
+
+    struct WindAdjustmentFactorKeyHash
+    {
+        std::size_t operator()(const WindAdjustmentFactorKey& key) const;
+    };
+
+    struct WindAdjustmentFactorValue
+    {
+        double windAdjustmentFactor;
+        WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod;
+    };
+
+    SharedCacheTable<SurfaceFuelbedCache::Key, FuelbedValue, SurfaceFuelbedCache::KeyHash> fuelbeds_;
+    SharedCacheTable<WindAdjustmentFactorKey, WindAdjustmentFactorValue, WindAdjustmentFactorKeyHash> windAdjustmentFactors_;
+};
+
+#endif // SHAREDSURFACECACHE_H
@@ -164,6 +164,71 @@ void SlopeTool::calculateSlopeFromMapMeasurements(const int mapRepresentativeFra
     slopeFromMapMeasurements_ = (slopeHorizontalDistance_ < 0.01) ? 0.0 : atan(slopeInPercent) * 180.0 / M_PI;
 }
 
+void SlopeTool::calculateHorizontalDistances(const double* mapDistance, const double* maxSlope, const double* directionFromUpslope,
+    int count, double* horizontalDistance, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        std::vector<double> cosDirection(count);
+        std::vector<double> sinDirection(count);
+        for (int i = 0; i < count; i++)
+        {
+            horizontalDistance[i] = maxSlope[i] * M_PI / 180.0;
+            cosDirection[i] = directionFromUpslope[i] * M_PI / 180.0;
+        }
+        VectorMath::sin(cosDirection.data(), sinDirection.data(), count, VectorMathMode::Fast);
+        VectorMath::cos(cosDirection.data(), cosDirection.data(), count, VectorMathMode::Fast);
+        VectorMath::cos(horizontalDistance, horizontalDistance, count, VectorMathMode::Fast);
+        for (int i = 0; i < count; i++)
+        {
+            const double groundDistanceInInches = LengthUnits::fromBaseUnits(mapDistance[i], LengthUnits::Inches);
+            double b = groundDistanceInInches * sinDirection[i];
+            double c = groundDistanceInInches * cosDirection[i] * horizontalDistance[i];
+            horizontalDistance[i] = c * c + b * b;
+        }
+        VectorMath::sqrt(horizontalDistance, horizontalDistance, count);
+        LengthUnits::toBaseUnits(horizontalDistance, count, LengthUnits::Inches);
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const double groundDistanceInInches = LengthUnits::fromBaseUnits(mapDistance[i], LengthUnits::Inches);
+        double a = groundDistanceInInches * cos(directionFromUpslope[i] * M_PI / 180.0);
+        double b = groundDistanceInInches * sin(directionFromUpslope[i] * M_PI / 180.0);
+        double c = a * cos(maxSlope[i] * M_PI / 180.0);
+        double d = sqrt(c * c + b * b);
+        horizontalDistance[i] = LengthUnits::toBaseUnits(d, LengthUnits::Inches);
+    }
+}
+
+void SlopeTool::calculateSlopesFromMapMeasurements(const int mapRepresentativeFraction, const double* mapDistance,
+    const double* elevationChange, int count, double* slope, double* horizontalDistance, VectorMathMode::VectorMathModeEnum mode)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const double distanceInches = LengthUnits::fromBaseUnits(mapDistance[i], LengthUnits::Inches);
+        horizontalDistance[i] = LengthUnits::toBaseUnits(mapRepresentativeFraction * distanceInches, LengthUnits::Inches);
+    }
+
+    if (mode == VectorMathMode::Fast)
+    {
+        // atan(rise / run) as atan2(rise, run), the run is never negative
+        VectorMath::atan2(elevationChange, horizontalDistance, slope, count, VectorMathMode::Fast);
+        for (int i = 0; i < count; i++)
+        {
+            slope[i] = (horizontalDistance[i] < 0.01) ? 0.0 : slope[i] * 180.0 / M_PI;
+        }
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const double slopeInPercent = (horizontalDistance[i] < 0.01) ? 0.0 : elevationChange[i] / horizontalDistance[i];
+        slope[i] = (horizontalDistance[i] < 0.01) ? 0.0 : atan(slopeInPercent) * 180.0 / M_PI;
+    }
+}
+
 int SlopeTool::getNumberOfHorizontalDistances() const
 {
     return horizontalDistances_.size();
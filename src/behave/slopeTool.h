@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include "behaveUnits.h"
+#include "vectorMath.h"
 
 struct RepresentativeFraction
 {
@@ -54,6 +55,14 @@ public:
     void calculateSlopeFromMapMeasurements(const int mapRepresentativeFraction, const double mapDistance,
         const LengthUnits::LengthUnitsEnum distanceUnits,  const double contourInterval, const double numberOfContours, const LengthUnits::LengthUnitsEnum contourUnits);
 
+    // Array versions of the two calculations in base units: distances and elevation changes in ft, slopes in
+    // degrees and directions in degrees from upslope. Each cell gets one horizontal distance, in its own
+    // direction. Exact mode gives the single value results, Fast mode uses the VectorMath kernels.
+    static void calculateHorizontalDistances(const double* mapDistance, const double* maxSlope, const double* directionFromUpslope,
+        int count, double* horizontalDistance, VectorMathMode::VectorMathModeEnum mode);
+    static void calculateSlopesFromMapMeasurements(const int mapRepresentativeFraction, const double* mapDistance,
+        const double* elevationChange, int count, double* slope, double* horizontalDistance, VectorMathMode::VectorMathModeEnum mode);
+
     // calculateHorizontalDistance() getters
     int getNumberOfHorizontalDistances() const;
     double getHorizontalDistanceMaxSlope(const SlopeUnits::SlopeUnitsEnum slopeUnits) const;
@@ -9,7 +9,10 @@
 #include "canopy_coefficient_table.h"
 #include "mortality_equation_table.h"
 
+#include <cstddef>
+#include <iterator>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using std::string;
@@ -41,6 +44,54 @@ struct SpeciesMasterTableRecord
     CrownDamageEquationCode crownDamageEquationCode = CrownDamageEquationCode::not_set;
 };
 
+/*.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.-.- */
+/*                     Species Master Table Record Span                      */
+/* Read only view of a subset of the table's records, in table order, that   */
+/* refers to the table's own index rather than copying records               */
+class SpeciesMasterTableRecordSpan
+{
+public:
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef SpeciesMasterTableRecord value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const SpeciesMasterTableRecord* pointer;
+        typedef const SpeciesMasterTableRecord& reference;
+
+        const_iterator(const vector<SpeciesMasterTableRecord>* records, const int* position)
+            : records_(records), position_(position) {}
+
+        const SpeciesMasterTableRecord& operator*() const { return (*records_)[*position_]; }
+        const SpeciesMasterTableRecord* operator->() const { return &(*records_)[*position_]; }
+        const_iterator& operator++() { ++position_; return *this; }
+        const_iterator operator++(int) { const_iterator previous = *this; ++position_; return previous; }
+        bool operator==(const const_iterator& rhs) const { return position_ == rhs.position_; }
+        bool operator!=(const const_iterator& rhs) const { return position_ != rhs.position_; }
+
+    private:
+        const vector<SpeciesMasterTableRecord>* records_;
+        const int* position_;
+    };
+
+    SpeciesMasterTableRecordSpan() : records_(nullptr), recordIndices_(nullptr) {}
+    SpeciesMasterTableRecordSpan(const vector<SpeciesMasterTableRecord>& records, const vector<int>& recordIndices)
+        : records_(&records), recordIndices_(&recordIndices) {}
+
+    size_t size() const { return (recordIndices_ != nullptr) ? recordIndices_->size() : 0; }
+    bool empty() const { return size() == 0; }
+    const SpeciesMasterTableRecord& operator[](size_t i) const { return (*records_)[(*recordIndices_)[i]]; }
+    int getSpeciesTableIndex(size_t i) const { return (*recordIndices_)[i]; }
+
+    const_iterator begin() const { return const_iterator(records_, (recordIndices_ != nullptr) ? recordIndices_->data() : nullptr); }
+    const_iterator end() const { return const_iterator(records_, (recordIndices_ != nullptr) ? recordIndices_->data() + recordIndices_->size() : nullptr); }
+
+private:
+    const vector<SpeciesMasterTableRecord>* records_;
+    const vector<int>* recordIndices_;
+};
+
 class SpeciesMasterTable
 {
 public:
@@ -52,6 +103,13 @@ public:
   
     int getSpeciesTableIndexFromSpeciesCode(string speciesCode) const;
     int getSpeciesTableIndexFromSpeciesCodeAndEquationType(string speciesCode, EquationType equationType) const;
+
+    // Spans stay valid until record_ is next modified
+    SpeciesMasterTableRecordSpan getRecordSpanForRegion(RegionCode region) const;
+    SpeciesMasterTableRecordSpan getRecordSpanForRegionAndEquationType(RegionCode region, EquationType equationType) const;
+
+    // Called by initializeMasterTable(), call again after editing record_ directly
+    void buildRecordIndexes();
    
     vector<SpeciesMasterTableRecord> record_;
 
@@ -61,6 +119,24 @@ public:
         int  mortalityEquation, int  brkEqu, int  crownCoefficientCode,
         int8_t region1, int8_t  region2, int8_t  region3, int8_t region4, EquationType equationType,
         CrownDamageEquationCode crownDamageEquationCode);
+
+private:
+    static const int NUM_REGIONS = 4;
+    static const int NUM_EQUATION_TYPES = 3;
+
+    void addRecordToIndexes(int recordIndex);
+    bool isSpeciesCodeIndexCurrent() const;
+
+    // Upper case species code -> record indices in table order, covering the
+    // records ahead of the first blank species code (where the scans stop)
+    std::unordered_map<string, vector<int>> speciesCodeIndex_;
+    size_t numRecordsIndexed_ = 0;
+    bool isSpeciesCodeIndexClosed_ = false;
+
+    // Record indices in table order for each region, and each region and equation type
+    vector<int> regionIndex_[NUM_REGIONS];
+    vector<int> regionAndEquationTypeIndex_[NUM_REGIONS][NUM_EQUATION_TYPES];
+    vector<int> emptyIndex_;
 };
 
 #endif // SPECIES_MASTER_TABLE_H
@@ -31,8 +31,16 @@
 
 #include "spot.h"
 #define _USE_MATH_DEFINES
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <cmath>
+#include <thread>
+#include <vector>
+#include "monteCarloRunner.h"
+#include "threadPool.h"
+
+constexpr double Spot::EmberDensityScale;
 
 Spot::Spot()
 {
@@ -63,6 +71,8 @@ void Spot::memberwiseCopyAssignment(const Spot& rhs)
     memcpy(speciesFlameHeightParameters_, rhs.speciesFlameHeightParameters_, SpotInputs::SpotArrayConstants::NUM_SPECIES * sizeof(speciesFlameHeightParameters_[0]));
     memcpy(speciesFlameDurationParameters_, rhs.speciesFlameDurationParameters_, SpotInputs::SpotArrayConstants::NUM_SPECIES * sizeof(speciesFlameDurationParameters_[0]));
     memcpy(firebrandHeightFactors_, rhs.firebrandHeightFactors_, SpotInputs::SpotArrayConstants::NUM_FIREBRAND_ROWS * sizeof(firebrandHeightFactors_[0]));
+    torchingTreesTable_ = rhs.torchingTreesTable_;
+    spotInputs_ = rhs.spotInputs_;
 
     coverHeightUsedForSurfaceFire_ = rhs.coverHeightUsedForSurfaceFire_;
     coverHeightUsedForBurningPile_ = rhs.coverHeightUsedForBurningPile_;
@@ -76,10 +86,15 @@ void Spot::memberwiseCopyAssignment(const Spot& rhs)
     firebrandHeightFromTorchingTrees_ = rhs.firebrandHeightFromTorchingTrees_;
     flatDistanceFromBurningPile_ = rhs.flatDistanceFromBurningPile_;
     flatDistanceFromSurfaceFire_ = rhs.flatDistanceFromSurfaceFire_;
-    flatDistanceFromTorchingTrees_ = rhs.mountainDistanceFromBurningPile_;
+    flatDistanceFromTorchingTrees_ = rhs.flatDistanceFromTorchingTrees_;
     mountainDistanceFromBurningPile_ = rhs.mountainDistanceFromBurningPile_;
-    mountainDistanceFromSurfaceFire_ = rhs.mountainDistanceFromBurningPile_;
-    mountainDistanceFromTorchingTrees_ = rhs.mountainDistanceFromBurningPile_;
+    mountainDistanceFromSurfaceFire_ = rhs.mountainDistanceFromSurfaceFire_;
+    mountainDistanceFromTorchingTrees_ = rhs.mountainDistanceFromTorchingTrees_;
+}
+
+bool Spot::hasSameInputs(const Spot& rhs) const
+{
+    return spotInputs_.hasSameInputs(rhs.spotInputs_) && torchingTreesTable_ == rhs.torchingTreesTable_;
 }
 
 void Spot::initializeMembers()
@@ -137,6 +152,7 @@ void Spot::initializeMembers()
       { 4.70, 0.000 }
     };
     memcpy(firebrandHeightFactors_, tempFirebrandHeightFactors, SpotInputs::SpotArrayConstants::NUM_FIREBRAND_ROWS * sizeof(firebrandHeightFactors_[0]));
+    torchingTreesTable_.reset();
 
     coverHeightUsedForSurfaceFire_ = 0.0;
     coverHeightUsedForBurningPile_ = 0.0;
@@ -156,7 +172,7 @@ void Spot::initializeMembers()
     mountainDistanceFromTorchingTrees_ = 0.0;
 }
 
-double Spot::calculateSpotCriticalCoverHeight(double firebrandHeight, double coverHeight)
+double Spot::calculateSpotCriticalCoverHeight(double firebrandHeight, double coverHeight) const
 {
     // Minimum value of coverHeight used to calculate flatDistance
     // using log variation with ht.
@@ -189,7 +205,7 @@ double Spot::spotDistanceMountainTerrain(
     double flatDistance,
     SpotFireLocation::SpotFireLocationEnum location,
     double ridgeToValleyDistance,
-    double ridgeToValleyElevation)
+    double ridgeToValleyElevation) const
 {
     double mountainDistance = flatDistance;
     if (ridgeToValleyElevation > 1e-7 && ridgeToValleyDistance > 1e-7)
@@ -210,7 +226,7 @@ double Spot::spotDistanceMountainTerrain(
 double Spot::spotDistanceFlatTerrain(
     double firebrandHeight,
     double coverHeight,
-    double windSpeedAtTwentyFeet)
+    double windSpeedAtTwentyFeet) const
 {
     // Flat terrain spotting distance.
     double flatDistance = 0.0;
@@ -223,159 +239,526 @@ double Spot::spotDistanceFlatTerrain(
     return flatDistance;
 }
 
-void Spot::calculateSpottingDistanceFromBurningPile()
+Spot::SpotSource Spot::getCurrentSource() const
 {
-    // Get needed inputs
-    SpotFireLocation::SpotFireLocationEnum location = spotInputs_.getLocation();
-    double ridgeToValleyDistance = spotInputs_.getRidgeToValleyDistance(LengthUnits::Miles);
-    double ridgeToValleyElevation = spotInputs_.getRidgeToValleyElevation(LengthUnits::Feet);
-    double downwindCoverHeight = calculateDownwindCanopyCoverHeight();
-    double windSpeedAtTwentyFeet = spotInputs_.getWindSpeedAtTwentyFeet(SpeedUnits::MilesPerHour);
-    double burningPileflameHeight = spotInputs_.getBurningPileFlameHeight(LengthUnits::Feet);
+    SpotSource source;
+    source.location = spotInputs_.getLocation();
+    source.ridgeToValleyDistance = spotInputs_.getRidgeToValleyDistance(LengthUnits::Miles);
+    source.ridgeToValleyElevation = spotInputs_.getRidgeToValleyElevation(LengthUnits::Feet);
+    source.downwindCoverHeight = calculateDownwindCanopyCoverHeight();
+    source.windSpeedAtTwentyFeet = spotInputs_.getWindSpeedAtTwentyFeet(SpeedUnits::MilesPerHour);
+    source.flameHeight = 0.0;
+    source.torchingTrees = spotInputs_.getTorchingTrees();
+    source.DBH = spotInputs_.getDBH(LengthUnits::Inches);
+    source.treeHeight = spotInputs_.getTreeHeight(LengthUnits::Feet);
+    source.treeSpecies = spotInputs_.getTreeSpecies();
+    return source;
+}
 
+void Spot::calculateSourceFromBurningPile(const SpotSource& source, SpotSourceResult& result) const
+{
     // Initialize return values
-    firebrandHeightFromBurningPile_ = 0.0;
-    flatDistanceFromBurningPile_ = 0.0;
-    mountainDistanceFromBurningPile_ = 0.0;
+    memset(&result, 0, sizeof(result));
 
     // Determine maximum firebrand height
-    if ((windSpeedAtTwentyFeet > 1e-7) && (burningPileflameHeight > 1e-7))
+    if ((source.windSpeedAtTwentyFeet > 1e-7) && (source.flameHeight > 1e-7))
     {
         // Determine maximum firebrand height
-        firebrandHeightFromBurningPile_ = 12.2 * burningPileflameHeight;
+        result.firebrandHeight = 12.2 * source.flameHeight;
 
         // Cover height used in calculation of flatDist.
-        coverHeightUsedForBurningPile_ = calculateSpotCriticalCoverHeight(firebrandHeightFromBurningPile_, downwindCoverHeight);
-        if (coverHeightUsedForBurningPile_ > 1e-7)
+        result.coverHeightUsed = calculateSpotCriticalCoverHeight(result.firebrandHeight, source.downwindCoverHeight);
+        result.isCoverHeightCalculated = true;
+        if (result.coverHeightUsed > 1e-7)
         {
             // Flat terrain spotting distance.
-            flatDistanceFromBurningPile_ = 0.000718 * windSpeedAtTwentyFeet * sqrt(coverHeightUsedForBurningPile_)
-                * (0.362 + sqrt(firebrandHeightFromBurningPile_ / coverHeightUsedForBurningPile_) / 2.0
-                    * log(firebrandHeightFromBurningPile_ / coverHeightUsedForBurningPile_));
+            result.flatDistance = 0.000718 * source.windSpeedAtTwentyFeet * sqrt(result.coverHeightUsed)
+                * (0.362 + sqrt(result.firebrandHeight / result.coverHeightUsed) / 2.0
+                    * log(result.firebrandHeight / result.coverHeightUsed));
             // Adjust for mountainous terrain.
-            mountainDistanceFromBurningPile_ = spotDistanceMountainTerrain(flatDistanceFromBurningPile_,
-                location, ridgeToValleyDistance, ridgeToValleyElevation);
+            result.mountainDistance = spotDistanceMountainTerrain(result.flatDistance,
+                source.location, source.ridgeToValleyDistance, source.ridgeToValleyElevation);
             // Convert distances from miles to feet (base distance unit)
-            flatDistanceFromBurningPile_ = LengthUnits::toBaseUnits(flatDistanceFromBurningPile_, LengthUnits::Miles);
-            mountainDistanceFromBurningPile_ = LengthUnits::toBaseUnits(mountainDistanceFromBurningPile_, LengthUnits::Miles);
+            result.flatDistance = LengthUnits::toBaseUnits(result.flatDistance, LengthUnits::Miles);
+            result.mountainDistance = LengthUnits::toBaseUnits(result.mountainDistance, LengthUnits::Miles);
+            result.isDistanceCalculated = true;
         }
     }
 }
 
-void Spot::calculateSpottingDistanceFromSurfaceFire()
+void Spot::calculateSourceFromSurfaceFire(const SpotSource& source, SpotSourceResult& result) const
 {
-    // Get needed inputs
-    SpotFireLocation::SpotFireLocationEnum location = spotInputs_.getLocation();
-    double ridgeToValleyDistance = spotInputs_.getRidgeToValleyDistance(LengthUnits::Miles);
-    double ridgeToValleyElevation = spotInputs_.getRidgeToValleyElevation(LengthUnits::Feet);
-    double downwindCoverHeight = calculateDownwindCanopyCoverHeight();
-    double windSpeedAtTwentyFeet = spotInputs_.getWindSpeedAtTwentyFeet(SpeedUnits::MilesPerHour);
-    double flameLength = spotInputs_.getSurfaceFlameLength(LengthUnits::Feet);
-
     // Initialize return values
-    firebrandHeightFromSurfaceFire_ = 0.0;
-    flatDistanceFromSurfaceFire_ = 0.0;
-    firebrandDrift_ = 0.0;
+    memset(&result, 0, sizeof(result));
 
     // Determine maximum firebrand height
-    if ((windSpeedAtTwentyFeet) > 1e-7 && (flameLength > 1e-7))
+    if ((source.windSpeedAtTwentyFeet) > 1e-7 && (source.flameHeight > 1e-7))
     {
         // f is a function relating thermal energy to windspeed.
-        double f = 322. * pow((0.474 * windSpeedAtTwentyFeet), -1.01);
+        double f = 322. * pow((0.474 * source.windSpeedAtTwentyFeet), -1.01);
 
         // Byram's fireline intensity is derived back from flame length.
-        double byrams = pow((flameLength / 0.45), (1. / 0.46));
+        double byrams = pow((source.flameHeight / 0.45), (1. / 0.46));
 
         // Initial firebrand height (ft).
-        firebrandHeightFromSurfaceFire_ = ((f * byrams) < 1e-7)
+        result.firebrandHeight = ((f * byrams) < 1e-7)
             ? (0.0)
             : (1.055 * sqrt(f * byrams));
 
         // Cover height used in calculation of localflatDistance.
-        coverHeightUsedForSurfaceFire_ = calculateSpotCriticalCoverHeight(firebrandHeightFromSurfaceFire_, downwindCoverHeight);
+        result.coverHeightUsed = calculateSpotCriticalCoverHeight(result.firebrandHeight, source.downwindCoverHeight);
+        result.isCoverHeightCalculated = true;
 
-        if (coverHeightUsedForSurfaceFire_ > 1e-7)
+        if (result.coverHeightUsed > 1e-7)
         {
-            firebrandDrift_ = 0.000278 * windSpeedAtTwentyFeet * pow(firebrandHeightFromSurfaceFire_, 0.643);
-            flatDistanceFromSurfaceFire_ = spotDistanceFlatTerrain(firebrandHeightFromSurfaceFire_, coverHeightUsedForSurfaceFire_, windSpeedAtTwentyFeet) + firebrandDrift_;
-            mountainDistanceFromSurfaceFire_ = spotDistanceMountainTerrain(flatDistanceFromSurfaceFire_,
-                location, ridgeToValleyDistance, ridgeToValleyElevation);
+            result.firebrandDrift = 0.000278 * source.windSpeedAtTwentyFeet * pow(result.firebrandHeight, 0.643);
+            result.flatDistance = spotDistanceFlatTerrain(result.firebrandHeight, result.coverHeightUsed, source.windSpeedAtTwentyFeet) + result.firebrandDrift;
+            result.mountainDistance = spotDistanceMountainTerrain(result.flatDistance,
+                source.location, source.ridgeToValleyDistance, source.ridgeToValleyElevation);
             // Convert distances from miles to feet (base distance unit)
-            flatDistanceFromSurfaceFire_ = LengthUnits::toBaseUnits(flatDistanceFromSurfaceFire_, LengthUnits::Miles);
-            mountainDistanceFromSurfaceFire_ = LengthUnits::toBaseUnits(mountainDistanceFromSurfaceFire_, LengthUnits::Miles);
+            result.flatDistance = LengthUnits::toBaseUnits(result.flatDistance, LengthUnits::Miles);
+            result.mountainDistance = LengthUnits::toBaseUnits(result.mountainDistance, LengthUnits::Miles);
+            result.isDistanceCalculated = true;
         }
     }
 }
 
-void Spot::calculateSpottingDistanceFromTorchingTrees()
+void Spot::calculateSourceFromTorchingTrees(const SpotSource& source, SpotSourceResult& result) const
 {
-    // Get needed inputs
-    SpotFireLocation::SpotFireLocationEnum location = spotInputs_.getLocation();
-    double ridgeToValleyDistance = spotInputs_.getRidgeToValleyDistance(LengthUnits::Miles);
-    double ridgeToValleyElevation = spotInputs_.getRidgeToValleyElevation(LengthUnits::Feet);
-    double downwindCoverHeight = calculateDownwindCanopyCoverHeight();
-    double windSpeedAtTwentyFeet = spotInputs_.getWindSpeedAtTwentyFeet(SpeedUnits::MilesPerHour);
-    double torchingTrees = spotInputs_.getTorchingTrees();
-    double DBH = spotInputs_.getDBH(LengthUnits::Inches);
-    double treeHeight = spotInputs_.getTreeHeight(LengthUnits::Feet);
-    SpotTreeSpecies::SpotTreeSpeciesEnum treeSpecies = spotInputs_.getTreeSpecies();
-
     // Initialize return variables
-    flameRatio_ = 0.0;
-    flameHeightForTorchingTrees_ = 0.0;
-    flameDuration_ = 0.0;
-    firebrandHeightFromTorchingTrees_ = 0.0;
-    flatDistanceFromTorchingTrees_ = 0.0;
-    mountainDistanceFromTorchingTrees_ = 0.0;
+    memset(&result, 0, sizeof(result));
 
     // Determine maximum firebrand height
-    if (windSpeedAtTwentyFeet > 1e-7 && DBH > 1e-7 && torchingTrees >= 1.0)
+    if (source.windSpeedAtTwentyFeet > 1e-7 && source.DBH > 1e-7 && source.torchingTrees >= 1.0)
     {
         // Catch species errors.
+        SpotTreeSpecies::SpotTreeSpeciesEnum treeSpecies = source.treeSpecies;
         if (!(treeSpecies < 0 || treeSpecies >= 14))
         {
-            // Steady flame height (ft).
-            flameHeightForTorchingTrees_ = speciesFlameHeightParameters_[treeSpecies][0]
-                * pow(DBH, speciesFlameHeightParameters_[treeSpecies][1])
-                * pow(torchingTrees, 0.4);
-
-            flameRatio_ = treeHeight / flameHeightForTorchingTrees_;
-            // Steady flame duration.
-            flameDuration_ = speciesFlameDurationParameters_[treeSpecies][0]
-                * pow(DBH, speciesFlameDurationParameters_[treeSpecies][1])
-                * pow(torchingTrees, -0.2);
-
-            int i;
-            if (flameRatio_ >= 1.0)
+            if (!torchingTreesTable_ || !torchingTreesTable_->lookup(treeSpecies, source.DBH, source.torchingTrees,
+                source.treeHeight, result.flameHeight, result.flameRatio, result.flameDuration, result.firebrandHeight))
             {
-                i = 0;
+                // Steady flame height (ft).
+                result.flameHeight = speciesFlameHeightParameters_[treeSpecies][0]
+                    * pow(source.DBH, speciesFlameHeightParameters_[treeSpecies][1])
+                    * pow(source.torchingTrees, 0.4);
+
+                result.flameRatio = source.treeHeight / result.flameHeight;
+                // Steady flame duration.
+                result.flameDuration = speciesFlameDurationParameters_[treeSpecies][0]
+                    * pow(source.DBH, speciesFlameDurationParameters_[treeSpecies][1])
+                    * pow(source.torchingTrees, -0.2);
+
+                int i;
+                if (result.flameRatio >= 1.0)
+                {
+                    i = 0;
+                }
+                else if (result.flameRatio >= 0.5)
+                {
+                    i = 1;
+                }
+                else if (result.flameDuration < 3.5)
+                {
+                    i = 2;
+                }
+                else
+                {
+                    i = 3;
+                }
+
+                // Initial firebrand height (ft).
+                result.firebrandHeight = firebrandHeightFactors_[i][0] * pow(result.flameDuration, firebrandHeightFactors_[i][1]) * result.flameHeight + source.treeHeight / 2.0;
             }
-            else if (flameRatio_ >= 0.5)
+
+            // Cover ht used in calculation of flatDist.
+            result.coverHeightUsed = calculateSpotCriticalCoverHeight(result.firebrandHeight, source.downwindCoverHeight);
+            result.isCoverHeightCalculated = true;
+            if (result.coverHeightUsed > 1e-7)
             {
-                i = 1;
+                result.flatDistance = spotDistanceFlatTerrain(result.firebrandHeight, result.coverHeightUsed, source.windSpeedAtTwentyFeet);
+                result.mountainDistance = spotDistanceMountainTerrain(result.flatDistance, source.location, source.ridgeToValleyDistance,
+                    source.ridgeToValleyElevation);
+                // Convert distances from miles to feet (base distance unit)
+                result.flatDistance = LengthUnits::toBaseUnits(result.flatDistance, LengthUnits::Miles);
+                result.mountainDistance = LengthUnits::toBaseUnits(result.mountainDistance, LengthUnits::Miles);
+                result.isDistanceCalculated = true;
             }
-            else if (flameDuration_ < 3.5)
+        }
+    }
+}
+
+void Spot::setIsUsingTorchingTreesTable(bool isUsingTorchingTreesTable, double dbhStep, double minimumDBH,
+    double maximumDBH, int maximumTorchingTrees)
+{
+    if (isUsingTorchingTreesTable)
+    {
+        torchingTreesTable_ = std::make_shared<const SpotTorchingTreesTable>(speciesFlameHeightParameters_,
+            speciesFlameDurationParameters_, firebrandHeightFactors_, dbhStep, minimumDBH, maximumDBH, maximumTorchingTrees);
+    }
+    else
+    {
+        torchingTreesTable_.reset();
+    }
+}
+
+bool Spot::getIsUsingTorchingTreesTable() const
+{
+    return torchingTreesTable_ != nullptr;
+}
+
+const SpotTorchingTreesTable* Spot::getTorchingTreesTable() const
+{
+    return torchingTreesTable_.get();
+}
+
+void Spot::calculateSpottingDistanceFromBurningPile()
+{
+    // Get needed inputs
+    SpotSource source = getCurrentSource();
+    source.flameHeight = spotInputs_.getBurningPileFlameHeight(LengthUnits::Feet);
+
+    SpotSourceResult result;
+    calculateSourceFromBurningPile(source, result);
+
+    firebrandHeightFromBurningPile_ = result.firebrandHeight;
+    flatDistanceFromBurningPile_ = result.flatDistance;
+    mountainDistanceFromBurningPile_ = result.mountainDistance;
+    if (result.isCoverHeightCalculated)
+    {
+        coverHeightUsedForBurningPile_ = result.coverHeightUsed;
+    }
+}
+
+void Spot::calculateSpottingDistanceFromSurfaceFire()
+{
+    // Get needed inputs
+    SpotSource source = getCurrentSource();
+    source.flameHeight = spotInputs_.getSurfaceFlameLength(LengthUnits::Feet);
+
+    SpotSourceResult result;
+    calculateSourceFromSurfaceFire(source, result);
+
+    firebrandHeightFromSurfaceFire_ = result.firebrandHeight;
+    flatDistanceFromSurfaceFire_ = result.flatDistance;
+    firebrandDrift_ = result.firebrandDrift;
+    if (result.isCoverHeightCalculated)
+    {
+        coverHeightUsedForSurfaceFire_ = result.coverHeightUsed;
+    }
+    if (result.isDistanceCalculated)
+    {
+        mountainDistanceFromSurfaceFire_ = result.mountainDistance;
+    }
+}
+
+void Spot::calculateSpottingDistanceFromTorchingTrees()
+{
+    // Get needed inputs
+    SpotSource source = getCurrentSource();
+
+    SpotSourceResult result;
+    calculateSourceFromTorchingTrees(source, result);
+
+    flameRatio_ = result.flameRatio;
+    flameHeightForTorchingTrees_ = result.flameHeight;
+    flameDuration_ = result.flameDuration;
+    firebrandHeightFromTorchingTrees_ = result.firebrandHeight;
+    flatDistanceFromTorchingTrees_ = result.flatDistance;
+    mountainDistanceFromTorchingTrees_ = result.mountainDistance;
+    if (result.isCoverHeightCalculated)
+    {
+        coverHeightUsedForTorchingTrees_ = result.coverHeightUsed;
+    }
+}
+
+void Spot::calculateSpottingDistanceFromBurningPileBatch(const SpotBatchInputs& inputs, SpotBatchOutputs& outputs,
+    int numberOfThreads) const
+{
+    calculateSpottingDistanceBatch(BurningPile, inputs, outputs, numberOfThreads);
+}
+
+void Spot::calculateSpottingDistanceFromSurfaceFireBatch(const SpotBatchInputs& inputs, SpotBatchOutputs& outputs,
+    int numberOfThreads) const
+{
+    calculateSpottingDistanceBatch(SurfaceFire, inputs, outputs, numberOfThreads);
+}
+
+void Spot::calculateSpottingDistanceFromTorchingTreesBatch(const SpotBatchInputs& inputs, SpotBatchOutputs& outputs,
+    int numberOfThreads) const
+{
+    calculateSpottingDistanceBatch(TorchingTrees, inputs, outputs, numberOfThreads);
+}
+
+Spot::SpotBatchDefaults Spot::getBatchDefaults(SpotSourceType sourceType) const
+{
+    // Inputs the batch doesn't supply come from this Spot, the source equations only read it
+    SpotBatchDefaults defaults;
+    defaults.source = getCurrentSource();
+    defaults.source.flameHeight = (sourceType == BurningPile)
+        ? spotInputs_.getBurningPileFlameHeight(LengthUnits::Feet)
+        : spotInputs_.getSurfaceFlameLength(LengthUnits::Feet);
+    defaults.downwindCoverHeight = spotInputs_.getDownwindCoverHeight(LengthUnits::Feet);
+    defaults.downwindCanopyMode = getDownwindCanopyMode();
+    return defaults;
+}
+
+void Spot::getBatchSource(SpotSourceType sourceType, const SpotBatchInputs& inputs, const SpotBatchDefaults& defaults,
+    long i, SpotSource& source) const
+{
+    source = defaults.source;
+    if (inputs.location)
+    {
+        source.location = inputs.location[i];
+    }
+    if (inputs.ridgeToValleyDistance)
+    {
+        source.ridgeToValleyDistance = LengthUnits::fromBaseUnits(inputs.ridgeToValleyDistance[i], LengthUnits::Miles);
+    }
+    if (inputs.ridgeToValleyElevation)
+    {
+        source.ridgeToValleyElevation = inputs.ridgeToValleyElevation[i];
+    }
+    if (inputs.downwindCoverHeight || inputs.downwindCanopyMode)
+    {
+        double coverHeight = inputs.downwindCoverHeight ? inputs.downwindCoverHeight[i] : defaults.downwindCoverHeight;
+        SpotDownWindCanopyMode::SpotDownWindCanopyModeEnum canopyMode = inputs.downwindCanopyMode ?
+            inputs.downwindCanopyMode[i] : defaults.downwindCanopyMode;
+        source.downwindCoverHeight = (canopyMode == SpotDownWindCanopyMode::OPEN) ? coverHeight * 0.5 : coverHeight;
+    }
+    if (inputs.windSpeedAtTwentyFeet)
+    {
+        source.windSpeedAtTwentyFeet = SpeedUnits::fromBaseUnits(inputs.windSpeedAtTwentyFeet[i], SpeedUnits::MilesPerHour);
+    }
+
+    if (sourceType == TorchingTrees)
+    {
+        if (inputs.torchingTrees)
+        {
+            source.torchingTrees = inputs.torchingTrees[i];
+        }
+        if (inputs.dbh)
+        {
+            source.DBH = inputs.dbh[i];
+        }
+        if (inputs.treeHeight)
+        {
+            source.treeHeight = inputs.treeHeight[i];
+        }
+        if (inputs.treeSpecies)
+        {
+            source.treeSpecies = inputs.treeSpecies[i];
+        }
+    }
+    else
+    {
+        const double* flameHeight = (sourceType == BurningPile) ? inputs.burningPileFlameHeight : inputs.flameLength;
+        if (flameHeight)
+        {
+            source.flameHeight = flameHeight[i];
+        }
+    }
+}
+
+void Spot::calculateSource(SpotSourceType sourceType, const SpotSource& source, SpotSourceResult& result) const
+{
+    if (sourceType == TorchingTrees)
+    {
+        calculateSourceFromTorchingTrees(source, result);
+    }
+    else if (sourceType == BurningPile)
+    {
+        calculateSourceFromBurningPile(source, result);
+    }
+    else
+    {
+        calculateSourceFromSurfaceFire(source, result);
+    }
+}
+
+void Spot::calculateSpottingDistanceBatch(SpotSourceType sourceType, const SpotBatchInputs& inputs,
+    SpotBatchOutputs& outputs, int numberOfThreads) const
+{
+    if (numberOfThreads <= 0)
+    {
+        numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    const long chunkSize = 1024;
+    long numberOfChunks = (inputs.numberOfSources + chunkSize - 1) / chunkSize;
+    if (numberOfThreads > numberOfChunks)
+    {
+        numberOfThreads = std::max(1L, numberOfChunks);
+    }
+
+    SpotBatchDefaults defaults = getBatchDefaults(sourceType);
+
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots(numberOfThreads);
+    threadPool->runChunks(inputs.numberOfSources, chunkSize, [&](int, long begin, long end)
+    {
+        SpotSource source;
+        SpotSourceResult result;
+        for (long i = begin; i < end; i++)
+        {
+            getBatchSource(sourceType, inputs, defaults, i, source);
+            calculateSource(sourceType, source, result);
+
+            if (outputs.firebrandHeight)
+            {
+                outputs.firebrandHeight[i] = result.firebrandHeight;
+            }
+            if (outputs.flatDistance)
             {
-                i = 2;
+                outputs.flatDistance[i] = result.flatDistance;
             }
-            else
+            if (outputs.mountainDistance)
             {
-                i = 3;
+                outputs.mountainDistance[i] = result.mountainDistance;
             }
+        }
+    }, numberOfSlots);
+}
 
-            // Initial firebrand height (ft).
-            firebrandHeightFromTorchingTrees_ = firebrandHeightFactors_[i][0] * pow(flameDuration_, firebrandHeightFactors_[i][1]) * flameHeightForTorchingTrees_ + treeHeight / 2.0;
+void Spot::accumulateEmberLandingDensityFromBurningPile(const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+    const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const
+{
+    accumulateEmberLandingDensity(BurningPile, inputs, sources, parameters, raster, numberOfThreads);
+}
 
-            // Cover ht used in calculation of flatDist.
-            coverHeightUsedForTorchingTrees_ = calculateSpotCriticalCoverHeight(firebrandHeightFromTorchingTrees_, downwindCoverHeight);
-            if (coverHeightUsedForTorchingTrees_ > 1e-7)
+void Spot::accumulateEmberLandingDensityFromSurfaceFire(const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+    const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const
+{
+    accumulateEmberLandingDensity(SurfaceFire, inputs, sources, parameters, raster, numberOfThreads);
+}
+
+void Spot::accumulateEmberLandingDensityFromTorchingTrees(const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+    const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const
+{
+    accumulateEmberLandingDensity(TorchingTrees, inputs, sources, parameters, raster, numberOfThreads);
+}
+
+void Spot::accumulateEmberLandingDensity(SpotSourceType sourceType, const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+    const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const
+{
+    long numberOfCells = (long)raster.numberOfRows * raster.numberOfColumns;
+    if (inputs.numberOfSources <= 0 || parameters.numberOfEmbersPerSource <= 0 || numberOfCells <= 0 || raster.cellSize <= 0.0)
+    {
+        return;
+    }
+    if (numberOfThreads <= 0)
+    {
+        numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numberOfThreads = (int)std::min((long)numberOfThreads, (long)inputs.numberOfSources);
+
+    // Every slot adds its embers' shares to one fixed point raster, integer sums don't depend on their order
+    std::vector<std::atomic<long long>> landings(numberOfCells);
+    for (long cell = 0; cell < numberOfCells; cell++)
+    {
+        landings[cell].store(0, std::memory_order_relaxed);
+    }
+
+    SpotBatchDefaults defaults = getBatchDefaults(sourceType);
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots(numberOfThreads);
+    threadPool->runChunks(inputs.numberOfSources, 16, [&](int, long begin, long end)
+    {
+        SpotSource source;
+        SpotSourceResult result;
+        for (long i = begin; i < end; i++)
+        {
+            getBatchSource(sourceType, inputs, defaults, i, source);
+            calculateSource(sourceType, source, result);
+            if (result.isDistanceCalculated)
             {
-                flatDistanceFromTorchingTrees_ = spotDistanceFlatTerrain(firebrandHeightFromTorchingTrees_, coverHeightUsedForTorchingTrees_, windSpeedAtTwentyFeet);
-                mountainDistanceFromTorchingTrees_ = spotDistanceMountainTerrain(flatDistanceFromTorchingTrees_, location, ridgeToValleyDistance,
-                    ridgeToValleyElevation);
-                // Convert distances from miles to feet (base distance unit)
-                flatDistanceFromTorchingTrees_ = LengthUnits::toBaseUnits(flatDistanceFromTorchingTrees_, LengthUnits::Miles);
-                mountainDistanceFromTorchingTrees_ = LengthUnits::toBaseUnits(mountainDistanceFromTorchingTrees_, LengthUnits::Miles);
+                addSourceEmberLandings(sourceType, source, result, sources, parameters, raster, i, landings.data());
+            }
+        }
+    }, numberOfSlots);
+
+    for (long cell = 0; cell < numberOfCells; cell++)
+    {
+        long long landing = landings[cell].load(std::memory_order_relaxed);
+        if (landing != 0)
+        {
+            raster.density[cell] += landing / EmberDensityScale;
+        }
+    }
+}
+
+void Spot::addSourceEmberLandings(SpotSourceType sourceType, const SpotSource& source, const SpotSourceResult& result,
+    const SpotEmberSources& sources, const SpotEmberParameters& parameters, const SpotEmberRaster& raster, long sourceIndex,
+    std::atomic<long long>* landings) const
+{
+    double weight = sources.weight ? sources.weight[sourceIndex] : 1.0;
+    long long share = std::llround(weight / parameters.numberOfEmbersPerSource * EmberDensityScale);
+    if (share == 0)
+    {
+        return;
+    }
+    double x = sources.x ? sources.x[sourceIndex] : 0.0;
+    double y = sources.y ? sources.y[sourceIndex] : 0.0;
+    double downwindDirection = (sources.downwindDirection ? sources.downwindDirection[sourceIndex] : 0.0) * M_PI / 180.0;
+    double downwindX = sin(downwindDirection);
+    double downwindY = cos(downwindDirection);
+
+    // Embers are lofted between the cover height used and the maximum firebrand height, all of them
+    // to the maximum when it isn't above the cover
+    double lowestHeight = std::min(result.coverHeightUsed, result.firebrandHeight);
+    double heightRange = result.firebrandHeight - lowestHeight;
+    unsigned int stream = (unsigned int)(sourceIndex * NumberOfEmberStreams);
+
+    double height[EmberBlockSize];
+    double alongDistance[EmberBlockSize];
+    double acrossDeviate[EmberBlockSize];
+    long cell[EmberBlockSize];
+    for (long first = 0; first < parameters.numberOfEmbersPerSource; first += EmberBlockSize)
+    {
+        int numberInBlock = (int)std::min((long)EmberBlockSize, parameters.numberOfEmbersPerSource - first);
+        for (int j = 0; j < numberInBlock; j++)
+        {
+            unsigned long long ember = (unsigned long long)(first + j);
+            height[j] = lowestHeight + heightRange * CounterBasedRandom::getUniform(parameters.seed, ember, stream);
+            // Box-Muller, only the cosine half so each ember takes its own pair of draws
+            double radius = sqrt(-2.0 * log(CounterBasedRandom::getUniform(parameters.seed, ember, stream + 1)));
+            acrossDeviate[j] = radius * cos(2.0 * M_PI * CounterBasedRandom::getUniform(parameters.seed, ember, stream + 2));
+        }
+
+        // Distance in mi for each ember's height, by the same equations as the maximum distance
+        for (int j = 0; j < numberInBlock; j++)
+        {
+            double flatDistance = spotDistanceFlatTerrain(height[j], result.coverHeightUsed, source.windSpeedAtTwentyFeet);
+            if (sourceType == SurfaceFire)
+            {
+                flatDistance += 0.000278 * source.windSpeedAtTwentyFeet * pow(height[j], 0.643);
+            }
+            alongDistance[j] = std::max(0.0, flatDistance);
+        }
+        if (parameters.isUsingMountainTerrain)
+        {
+            for (int j = 0; j < numberInBlock; j++)
+            {
+                alongDistance[j] = std::max(0.0, spotDistanceMountainTerrain(alongDistance[j], source.location,
+                    source.ridgeToValleyDistance, source.ridgeToValleyElevation));
+            }
+        }
+
+        for (int j = 0; j < numberInBlock; j++)
+        {
+            double along = LengthUnits::toBaseUnits(alongDistance[j], LengthUnits::Miles);
+            double across = acrossDeviate[j] * parameters.lateralSpread * along;
+            double landingX = x + along * downwindX + across * downwindY;
+            double landingY = y + along * downwindY - across * downwindX;
+            double column = floor((landingX - raster.westEdge) / raster.cellSize);
+            double row = floor((raster.northEdge - landingY) / raster.cellSize);
+            bool isInside = (column >= 0.0 && column < raster.numberOfColumns && row >= 0.0 && row < raster.numberOfRows);
+            cell[j] = isInside ? (long)row * raster.numberOfColumns + (long)column : -1;
+        }
+        for (int j = 0; j < numberInBlock; j++)
+        {
+            if (cell[j] >= 0)
+            {
+                landings[cell[j]].fetch_add(share, std::memory_order_relaxed);
             }
         }
     }
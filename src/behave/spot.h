@@ -32,7 +32,82 @@
 #ifndef SPOT_H
 #define SPOT_H
 
+#include <atomic>
+#include <memory>
+
 #include "spotInputs.h"
+#include "spotTorchingTreesTable.h"
+
+// Structure-of-arrays firebrand sources for the Spot batch calculations, each array holds
+// numberOfSources values in base units: heights, flame lengths, cover heights and ridge to
+// valley distance and elevation in feet, wind speed at twenty feet in ft/min and DBH in
+// inches. Only the arrays the source type uses are read: burningPileFlameHeight for burning
+// piles, flameLength for surface fires, and torchingTrees, dbh, treeHeight and treeSpecies
+// for torching trees. Any array may be null, every source then uses the calling Spot's
+// current value for that input.
+struct SpotBatchInputs
+{
+    int numberOfSources;
+    const double* burningPileFlameHeight;
+    const double* flameLength;
+    const int* torchingTrees;
+    const double* dbh;
+    const double* treeHeight;
+    const SpotTreeSpecies::SpotTreeSpeciesEnum* treeSpecies;
+    const double* windSpeedAtTwentyFeet;
+    const double* downwindCoverHeight;
+    const SpotDownWindCanopyMode::SpotDownWindCanopyModeEnum* downwindCanopyMode;
+    const SpotFireLocation::SpotFireLocationEnum* location;
+    const double* ridgeToValleyDistance;
+    const double* ridgeToValleyElevation;
+};
+
+// Caller-provided output arrays for the Spot batch calculations, each sized for
+// numberOfSources values and filled in feet. Sources with no spotting (no wind, flame or
+// cover) get zero rather than the previous source's values. Any array may be null.
+struct SpotBatchOutputs
+{
+    double* firebrandHeight;
+    double* flatDistance;
+    double* mountainDistance;
+};
+
+// Where the firebrands of each source of a SpotBatchInputs start and which way the wind carries
+// them, for the ember landing density calculations: positions in ft with x east and y north, and
+// the direction the wind blows toward in degrees clockwise from north. weight is how much each
+// source counts in the density, e.g. the probability that it burns. Null arrays give 0, and a
+// null weight counts every source once.
+struct SpotEmberSources
+{
+    const double* x;
+    const double* y;
+    const double* downwindDirection;
+    const double* weight;
+};
+
+// How the ember landing density calculations draw firebrands. Each source releases
+// numberOfEmbersPerSource of them, and an ember carried a distance d downwind lands a normal
+// deviate of standard deviation lateralSpread * d across the wind.
+struct SpotEmberParameters
+{
+    long numberOfEmbersPerSource;
+    unsigned long long seed;
+    double lateralSpread;
+    bool isUsingMountainTerrain;    // downwind distances adjusted with each source's ridge to valley inputs
+};
+
+// Raster the ember landing densities are added to, numberOfRows by numberOfColumns cells of
+// cellSize ft in row-major order, row 0 along northEdge and column 0 along westEdge (ft). Each
+// cell gains the weighted fraction of each source's embers that land in it.
+struct SpotEmberRaster
+{
+    int numberOfRows;
+    int numberOfColumns;
+    double cellSize;
+    double westEdge;
+    double northEdge;
+    double* density;
+};
 
 class Spot
 {
@@ -44,11 +119,42 @@ public:
     Spot& operator=(const Spot& rhs);
 
     void initializeMembers();
+    bool hasSameInputs(const Spot& rhs) const;
 
     void calculateSpottingDistanceFromBurningPile();
     void calculateSpottingDistanceFromSurfaceFire();
     void calculateSpottingDistanceFromTorchingTrees();
 
+    // Batch versions of the above over many sources, on numberOfThreads threads (0 for one per
+    // hardware thread). They don't change this Spot's inputs or outputs.
+    void calculateSpottingDistanceFromBurningPileBatch(const SpotBatchInputs& inputs, SpotBatchOutputs& outputs,
+        int numberOfThreads) const;
+    void calculateSpottingDistanceFromSurfaceFireBatch(const SpotBatchInputs& inputs, SpotBatchOutputs& outputs,
+        int numberOfThreads) const;
+    void calculateSpottingDistanceFromTorchingTreesBatch(const SpotBatchInputs& inputs, SpotBatchOutputs& outputs,
+        int numberOfThreads) const;
+
+    // Stochastic ember transport from the same sources as the batch versions. Embers are lofted
+    // uniformly between a source's cover height used and its maximum firebrand height and carried
+    // downwind as far as the spotting distance equations give for their height, so none lands
+    // beyond the maximum spotting distance. Draws come from CounterBasedRandom on the seed, source
+    // and ember, and landings are summed in fixed point, so the raster doesn't depend on the
+    // number of threads. They don't change this Spot's inputs or outputs.
+    void accumulateEmberLandingDensityFromBurningPile(const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+        const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const;
+    void accumulateEmberLandingDensityFromSurfaceFire(const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+        const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const;
+    void accumulateEmberLandingDensityFromTorchingTrees(const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+        const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const;
+
+    // Takes torching tree flame and firebrand heights from a SpotTorchingTreesTable built with
+    // this Spot's parameters, trading the error the table reports for skipping the power laws.
+    // Sources outside the table still use the power laws. Copies of this Spot share the table.
+    void setIsUsingTorchingTreesTable(bool isUsingTorchingTreesTable, double dbhStep = 0.25,
+        double minimumDBH = 1.0, double maximumDBH = 120.0, int maximumTorchingTrees = 50);
+    bool getIsUsingTorchingTreesTable() const;
+    const SpotTorchingTreesTable* getTorchingTreesTable() const;
+
   // Spot Inputs Setters
     void setBurningPileFlameHeight(double buringPileflameHeight, LengthUnits::LengthUnitsEnum flameHeightUnits);
     void setDBH(double DBH, LengthUnits::LengthUnitsEnum DBHUnits);
@@ -110,18 +216,83 @@ public:
     double getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(LengthUnits::LengthUnitsEnum spottingDistanceUnits) const;
 
 protected:
+    enum SpotSourceType
+    {
+        BurningPile,
+        SurfaceFire,
+        TorchingTrees
+    };
+
+    // One firebrand source, in the units the spotting equations use
+    struct SpotSource
+    {
+        SpotFireLocation::SpotFireLocationEnum location;
+        double ridgeToValleyDistance;   // mi
+        double ridgeToValleyElevation;  // ft
+        double downwindCoverHeight;     // ft, already halved for open canopy
+        double windSpeedAtTwentyFeet;   // mi/h
+        double flameHeight;             // ft, burning pile flame height or surface flame length
+        double torchingTrees;
+        double DBH;                     // in
+        double treeHeight;              // ft
+        SpotTreeSpecies::SpotTreeSpeciesEnum treeSpecies;
+    };
+
+    // What the spotting equations found for one source, zero where they didn't get that far
+    struct SpotSourceResult
+    {
+        bool isCoverHeightCalculated;   // coverHeightUsed was calculated
+        bool isDistanceCalculated;      // cover height was high enough for the distances
+        double coverHeightUsed;         // ft
+        double firebrandHeight;         // ft
+        double firebrandDrift;          // mi, surface fire only
+        double flameHeight;             // ft, torching trees only
+        double flameRatio;              // torching trees only
+        double flameDuration;           // torching trees only
+        double flatDistance;            // ft
+        double mountainDistance;        // ft
+    };
+
+    // What a batch source takes from this Spot where the SpotBatchInputs has no array
+    struct SpotBatchDefaults
+    {
+        SpotSource source;
+        double downwindCoverHeight;     // ft, before halving for open canopy
+        SpotDownWindCanopyMode::SpotDownWindCanopyModeEnum downwindCanopyMode;
+    };
+
+    static const int EmberBlockSize = 64;           // embers drawn and carried together
+    static const int NumberOfEmberStreams = 3;      // draws per ember: height, across wind radius and angle
+    static constexpr double EmberDensityScale = 4294967296.0; // fixed point units per unit of density
+
     void memberwiseCopyAssignment(const Spot& rhs);
-    double calculateSpotCriticalCoverHeight(double firebrandHeight, double coverHeight);
+    double calculateSpotCriticalCoverHeight(double firebrandHeight, double coverHeight) const;
     double calculateDownwindCanopyCoverHeight() const;
-    double spotDistanceFlatTerrain(double firebrandHeight, double coverHeight, double windSpeedAtTwentyFeet);
+    double spotDistanceFlatTerrain(double firebrandHeight, double coverHeight, double windSpeedAtTwentyFeet) const;
     double spotDistanceMountainTerrain(double flatDistance, SpotFireLocation::SpotFireLocationEnum location,
-    double ridgeToValleyDistance, double ridgeToValleyElevation);
+    double ridgeToValleyDistance, double ridgeToValleyElevation) const;
+    SpotSource getCurrentSource() const;
+    void calculateSourceFromBurningPile(const SpotSource& source, SpotSourceResult& result) const;
+    void calculateSourceFromSurfaceFire(const SpotSource& source, SpotSourceResult& result) const;
+    void calculateSourceFromTorchingTrees(const SpotSource& source, SpotSourceResult& result) const;
+    SpotBatchDefaults getBatchDefaults(SpotSourceType sourceType) const;
+    void getBatchSource(SpotSourceType sourceType, const SpotBatchInputs& inputs, const SpotBatchDefaults& defaults,
+        long i, SpotSource& source) const;
+    void calculateSource(SpotSourceType sourceType, const SpotSource& source, SpotSourceResult& result) const;
+    void calculateSpottingDistanceBatch(SpotSourceType sourceType, const SpotBatchInputs& inputs,
+        SpotBatchOutputs& outputs, int numberOfThreads) const;
+    void accumulateEmberLandingDensity(SpotSourceType sourceType, const SpotBatchInputs& inputs, const SpotEmberSources& sources,
+        const SpotEmberParameters& parameters, SpotEmberRaster& raster, int numberOfThreads) const;
+    void addSourceEmberLandings(SpotSourceType sourceType, const SpotSource& source, const SpotSourceResult& result,
+        const SpotEmberSources& sources, const SpotEmberParameters& parameters, const SpotEmberRaster& raster, long sourceIndex,
+        std::atomic<long long>* landings) const;
 
     SpotInputs spotInputs_;
 
     double speciesFlameHeightParameters_[SpotInputs::SpotArrayConstants::NUM_SPECIES][SpotInputs::SpotArrayConstants::NUM_COLS];
     double speciesFlameDurationParameters_[SpotInputs::SpotArrayConstants::NUM_SPECIES][SpotInputs::SpotArrayConstants::NUM_COLS];
     double firebrandHeightFactors_[SpotInputs::SpotArrayConstants::NUM_FIREBRAND_ROWS][SpotInputs::SpotArrayConstants::NUM_COLS];
+    std::shared_ptr<const SpotTorchingTreesTable> torchingTreesTable_; // null unless using the table
 
   // Outputs
     double coverHeightUsedForSurfaceFire_;      // Actual tree / vegetation ht used for surface fire(ft)
@@ -198,6 +198,22 @@ double SpotInputs::getWindSpeedAtTwentyFeet(SpeedUnits::SpeedUnitsEnum windSpeed
     return SpeedUnits::fromBaseUnits(windSpeedAtTwentyFeet_, windSpeedUnits);
 }
 
+bool SpotInputs::hasSameInputs(const SpotInputs& rhs) const
+{
+    return DBH_ == rhs.DBH_ &&
+        downwindCoverHeight_ == rhs.downwindCoverHeight_ &&
+        downwindCanopyMode_ == rhs.downwindCanopyMode_ &&
+        location_ == rhs.location_ &&
+        ridgeToValleyDistance_ == rhs.ridgeToValleyDistance_ &&
+        ridgeToValleyElevation_ == rhs.ridgeToValleyElevation_ &&
+        windSpeedAtTwentyFeet_ == rhs.windSpeedAtTwentyFeet_ &&
+        buringPileFlameHeight_ == rhs.buringPileFlameHeight_ &&
+        surfaceFlameLength_ == rhs.surfaceFlameLength_ &&
+        torchingTrees_ == rhs.torchingTrees_ &&
+        treeHeight_ == rhs.treeHeight_ &&
+        treeSpecies_ == rhs.treeSpecies_;
+}
+
 void SpotInputs::initializeMembers()
 {
     downwindCoverHeight_ = 0.0;
@@ -211,4 +227,5 @@ void SpotInputs::initializeMembers()
     torchingTrees_ = 0.0;
     DBH_ = 0.0;
     treeHeight_ = 0.0;
+    treeSpecies_ = SpotTreeSpecies::ENGELMANN_SPRUCE;
 }
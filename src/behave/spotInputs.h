@@ -117,6 +117,8 @@ public:
     SpotTreeSpecies::SpotTreeSpeciesEnum getTreeSpecies() const;
     double getWindSpeedAtTwentyFeet(SpeedUnits::SpeedUnitsEnum windSpeedUnits) const;
 
+    bool hasSameInputs(const SpotInputs& rhs) const;
+
     struct SpotArrayConstants
     {
         enum SpotArrayConstantsEnum
@@ -0,0 +1,204 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Precomputed, interpolated torching tree flame and firebrand heights
+*           over DBH and number of torching trees for each tree species
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "spotTorchingTreesTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+SpotTorchingTreesTable::SpotTorchingTreesTable(const SpeciesParameters* speciesFlameHeightParameters,
+    const SpeciesParameters* speciesFlameDurationParameters, const SpeciesParameters* firebrandHeightFactors,
+    double dbhStep, double minimumDBH, double maximumDBH, int maximumTorchingTrees)
+    : dbhStep_(dbhStep),
+    minimumDBH_(minimumDBH),
+    maximumTorchingTrees_(std::max(maximumTorchingTrees, 1))
+{
+    memcpy(speciesFlameHeightParameters_, speciesFlameHeightParameters, sizeof(speciesFlameHeightParameters_));
+    memcpy(speciesFlameDurationParameters_, speciesFlameDurationParameters, sizeof(speciesFlameDurationParameters_));
+    memcpy(firebrandHeightFactors_, firebrandHeightFactors, sizeof(firebrandHeightFactors_));
+
+    numberOfDBHPoints_ = std::max(2, static_cast<int>(ceil((maximumDBH - minimumDBH_) / dbhStep_ - 1e-9)) + 1);
+    maximumDBH_ = minimumDBH_ + (numberOfDBHPoints_ - 1) * dbhStep_;
+
+    // Species terms in DBH
+    dbhValues_.resize(numberOfSpecies * numberOfDBHPoints_ * valuesPerDBHPoint);
+    for (int species = 0; species < numberOfSpecies; species++)
+    {
+        for (int point = 0; point < numberOfDBHPoints_; point++)
+        {
+            double DBH = minimumDBH_ + point * dbhStep_;
+            double* values = &dbhValues_[(species * numberOfDBHPoints_ + point) * valuesPerDBHPoint];
+            values[0] = speciesFlameHeightParameters_[species][0] * pow(DBH, speciesFlameHeightParameters_[species][1]);
+            values[1] = speciesFlameDurationParameters_[species][0] * pow(DBH, speciesFlameDurationParameters_[species][1]);
+            for (int regime = 0; regime < numberOfRegimes; regime++)
+            {
+                values[2 + regime] = pow(values[1], firebrandHeightFactors_[regime][1]) * values[0];
+            }
+        }
+    }
+
+    // Exact terms in the number of torching trees, row 0 is unused
+    torchingTreesValues_.assign((maximumTorchingTrees_ + 1) * valuesPerTorchingTrees, 0.0);
+    for (int torchingTrees = 1; torchingTrees <= maximumTorchingTrees_; torchingTrees++)
+    {
+        double* values = &torchingTreesValues_[torchingTrees * valuesPerTorchingTrees];
+        values[0] = pow(torchingTrees, 0.4);
+        values[1] = pow(torchingTrees, -0.2);
+        for (int regime = 0; regime < numberOfRegimes; regime++)
+        {
+            values[2 + regime] = pow(torchingTrees, 0.4 - 0.2 * firebrandHeightFactors_[regime][1]);
+        }
+    }
+
+    measureError();
+}
+
+double SpotTorchingTreesTable::getDBHStep() const
+{
+    return dbhStep_;
+}
+
+double SpotTorchingTreesTable::getMinimumDBH() const
+{
+    return minimumDBH_;
+}
+
+double SpotTorchingTreesTable::getMaximumDBH() const
+{
+    return maximumDBH_;
+}
+
+int SpotTorchingTreesTable::getMaximumTorchingTrees() const
+{
+    return maximumTorchingTrees_;
+}
+
+int SpotTorchingTreesTable::getNumberOfDBHPoints() const
+{
+    return numberOfDBHPoints_;
+}
+
+double SpotTorchingTreesTable::getMaximumFlameHeightError() const
+{
+    return maximumFlameHeightError_;
+}
+
+double SpotTorchingTreesTable::getMaximumFlameDurationError() const
+{
+    return maximumFlameDurationError_;
+}
+
+double SpotTorchingTreesTable::getMaximumFirebrandHeightError() const
+{
+    return maximumFirebrandHeightError_;
+}
+
+bool SpotTorchingTreesTable::lookup(SpotTreeSpecies::SpotTreeSpeciesEnum treeSpecies, double DBH, double torchingTrees,
+    double treeHeight, double& flameHeight, double& flameRatio, double& flameDuration, double& firebrandHeight) const
+{
+    int wholeTorchingTrees = static_cast<int>(torchingTrees);
+    if (treeSpecies < 0 || treeSpecies >= numberOfSpecies || !(DBH >= minimumDBH_ && DBH <= maximumDBH_)
+        || wholeTorchingTrees < 1 || wholeTorchingTrees > maximumTorchingTrees_ || wholeTorchingTrees != torchingTrees)
+    {
+        return false;
+    }
+
+    double values[valuesPerDBHPoint];
+    interpolateDBH(treeSpecies, DBH, values);
+    const double* torchingTreesValues = &torchingTreesValues_[wholeTorchingTrees * valuesPerTorchingTrees];
+
+    flameHeight = values[0] * torchingTreesValues[0];
+    flameRatio = treeHeight / flameHeight;
+    flameDuration = values[1] * torchingTreesValues[1];
+
+    // Same regimes as Spot::calculateSpottingDistanceFromTorchingTrees()
+    int regime;
+    if (flameRatio >= 1.0)
+    {
+        regime = 0;
+    }
+    else if (flameRatio >= 0.5)
+    {
+        regime = 1;
+    }
+    else if (flameDuration < 3.5)
+    {
+        regime = 2;
+    }
+    else
+    {
+        regime = 3;
+    }
+
+    firebrandHeight = firebrandHeightFactors_[regime][0] * values[2 + regime] * torchingTreesValues[2 + regime]
+        + treeHeight / 2.0;
+    return true;
+}
+
+void SpotTorchingTreesTable::interpolateDBH(int treeSpecies, double DBH, double* values) const
+{
+    double position = (DBH - minimumDBH_) / dbhStep_;
+    int point = std::min(static_cast<int>(position), numberOfDBHPoints_ - 2);
+    double fraction = position - point;
+
+    const double* low = &dbhValues_[(treeSpecies * numberOfDBHPoints_ + point) * valuesPerDBHPoint];
+    const double* high = low + valuesPerDBHPoint;
+    for (int i = 0; i < valuesPerDBHPoint; i++)
+    {
+        values[i] = low[i] + fraction * (high[i] - low[i]);
+    }
+}
+
+void SpotTorchingTreesTable::measureError()
+{
+    // The terms in the number of torching trees are exact, so the relative error of every
+    // result is that of its DBH term and doesn't depend on N
+    maximumFlameHeightError_ = 0.0;
+    maximumFlameDurationError_ = 0.0;
+    maximumFirebrandHeightError_ = 0.0;
+    for (int species = 0; species < numberOfSpecies; species++)
+    {
+        for (int point = 0; point < numberOfDBHPoints_ - 1; point++)
+        {
+            double DBH = minimumDBH_ + (point + 0.5) * dbhStep_;
+            double values[valuesPerDBHPoint];
+            interpolateDBH(species, DBH, values);
+
+            double flameHeight = speciesFlameHeightParameters_[species][0] * pow(DBH, speciesFlameHeightParameters_[species][1]);
+            double flameDuration = speciesFlameDurationParameters_[species][0] * pow(DBH, speciesFlameDurationParameters_[species][1]);
+            maximumFlameHeightError_ = std::max(maximumFlameHeightError_, fabs(values[0] - flameHeight) / flameHeight);
+            maximumFlameDurationError_ = std::max(maximumFlameDurationError_, fabs(values[1] - flameDuration) / flameDuration);
+            for (int regime = 0; regime < numberOfRegimes; regime++)
+            {
+                double lofted = pow(flameDuration, firebrandHeightFactors_[regime][1]) * flameHeight;
+                maximumFirebrandHeightError_ = std::max(maximumFirebrandHeightError_, fabs(values[2 + regime] - lofted) / lofted);
+            }
+        }
+    }
+}
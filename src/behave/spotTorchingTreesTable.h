@@ -0,0 +1,111 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Precomputed, interpolated torching tree flame and firebrand heights
+*           over DBH and number of torching trees for each tree species
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SPOTTORCHINGTREESTABLE_H
+#define SPOTTORCHINGTREESTABLE_H
+
+#include <vector>
+
+#include "spotInputs.h"
+
+// Torching tree flame height, flame duration and firebrand height taken from tables instead
+// of the power laws, for tools that evaluate torching spotting at many sources. Both power
+// laws separate into a species term in DBH times a term in the number of torching trees:
+// flameHeight = a * DBH^b * N^0.4 and flameDuration = c * DBH^d * N^-0.2, and so does the
+// lofted part of the firebrand height, flameDuration^f * flameHeight. The DBH terms are
+// linearly interpolated from a uniform grid per species, and since the number of torching
+// trees is a whole number its terms are tabulated exactly for every N up to the maximum, so
+// all of the interpolation error is in DBH. The lofted part has its own DBH term per regime,
+// so each result comes from a single interpolation. The error is largest at small DBH, where the
+// power laws bend the most, and is measured at the centre of every DBH cell when the table
+// is built. Near the flame ratio and flame duration bounds of the firebrand height regimes
+// an interpolated value can fall on the other side of a bound than the exact one, and the
+// firebrand height then uses the neighbouring regime's factors. A table is never changed
+// after it is built, so it can be shared between threads and Spot objects.
+class SpotTorchingTreesTable
+{
+public:
+    typedef double SpeciesParameters[SpotInputs::SpotArrayConstants::NUM_COLS];
+
+    // The parameter arrays are Spot's species flame height and duration parameters and
+    // firebrand height factors, DBH is in inches. The DBH grid runs from minimumDBH in steps
+    // of dbhStep up to the first point at or past maximumDBH, and has at least one cell.
+    SpotTorchingTreesTable(const SpeciesParameters* speciesFlameHeightParameters,
+        const SpeciesParameters* speciesFlameDurationParameters, const SpeciesParameters* firebrandHeightFactors,
+        double dbhStep, double minimumDBH, double maximumDBH, int maximumTorchingTrees);
+
+    double getDBHStep() const;
+    double getMinimumDBH() const;
+    double getMaximumDBH() const;
+    int getMaximumTorchingTrees() const;
+    int getNumberOfDBHPoints() const;
+
+    // Largest relative difference from the power laws found at the centre of every DBH cell
+    // of every species. The firebrand height error is that of its lofted part, within a
+    // regime, the half tree height added to it is exact.
+    double getMaximumFlameHeightError() const;
+    double getMaximumFlameDurationError() const;
+    double getMaximumFirebrandHeightError() const;
+
+    // Fills the torching tree results for a source with DBH in inches and tree height in
+    // feet, or returns false without touching them when the species, DBH or number of
+    // torching trees is outside the table
+    bool lookup(SpotTreeSpecies::SpotTreeSpeciesEnum treeSpecies, double DBH, double torchingTrees,
+        double treeHeight, double& flameHeight, double& flameRatio, double& flameDuration,
+        double& firebrandHeight) const;
+
+protected:
+    static const int numberOfSpecies = SpotInputs::SpotArrayConstants::NUM_SPECIES;
+    static const int numberOfRegimes = SpotInputs::SpotArrayConstants::NUM_FIREBRAND_ROWS;
+    // Per DBH point: flame height term, flame duration term, then the lofted term per regime
+    static const int valuesPerDBHPoint = 2 + numberOfRegimes;
+    // Per number of torching trees: N^0.4, N^-0.2, then N^(0.4 - 0.2 * f) per regime
+    static const int valuesPerTorchingTrees = 2 + numberOfRegimes;
+
+    void measureError();
+    void interpolateDBH(int treeSpecies, double DBH, double* values) const;
+
+    double dbhStep_;
+    double minimumDBH_;
+    double maximumDBH_;
+    int maximumTorchingTrees_;
+    int numberOfDBHPoints_;
+
+    double speciesFlameHeightParameters_[numberOfSpecies][SpotInputs::SpotArrayConstants::NUM_COLS];
+    double speciesFlameDurationParameters_[numberOfSpecies][SpotInputs::SpotArrayConstants::NUM_COLS];
+    double firebrandHeightFactors_[numberOfRegimes][SpotInputs::SpotArrayConstants::NUM_COLS];
+
+    std::vector<double> dbhValues_;             // numberOfSpecies * numberOfDBHPoints_ * valuesPerDBHPoint
+    std::vector<double> torchingTreesValues_;   // (maximumTorchingTrees_ + 1) * valuesPerTorchingTrees
+
+    double maximumFlameHeightError_;
+    double maximumFlameDurationError_;
+    double maximumFirebrandHeightError_;
+};
+
+#endif // SPOTTORCHINGTREESTABLE_H
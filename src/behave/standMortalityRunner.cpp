@@ -0,0 +1,239 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Maps stand tree mortality from surface fireline intensity bands,
+*           pixel by pixel on a pool of threads
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "standMortalityRunner.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "threadPool.h"
+
+StandMortalityRunner::StandMortalityRunner(const Mortality& prototype)
+    : prototype_(prototype),
+    numberOfThreads_(0)
+{
+
+}
+
+void StandMortalityRunner::addStand(int standId, const MortalityBatchInputs& trees)
+{
+    const int numberOfSpecies = prototype_.getNumberOfRecordsInSpeciesTable();
+    Stand stand;
+    stand.reserve(trees.numberOfTrees);
+    for(int i = 0; i < trees.numberOfTrees; i++)
+    {
+        int speciesIndex = trees.speciesTableIndex[i];
+        if(speciesIndex < 0 || speciesIndex >= numberOfSpecies)
+        {
+            continue;
+        }
+        EquationType equationType = trees.equationType ? trees.equationType[i] : prototype_.getEquationTypeAtSpeciesTableIndex(speciesIndex);
+
+        StandTree tree;
+        tree.group = -1;
+        for(int group = 0; group < (int)groups_.size() && tree.group < 0; group++)
+        {
+            if(groups_[group].speciesTableIndex == speciesIndex && groups_[group].equationType == equationType)
+            {
+                tree.group = group;
+            }
+        }
+        if(tree.group < 0)
+        {
+            SpeciesGroup group;
+            group.speciesTableIndex = speciesIndex;
+            group.equationType = equationType;
+            tree.group = (int)groups_.size();
+            groups_.push_back(group);
+        }
+        tree.treeDensityPerAcre = trees.treeDensityPerAcre ? trees.treeDensityPerAcre[i] : prototype_.getTreeDensityPerUnitArea(AreaUnits::Acres);
+        tree.dbh = trees.dbh ? trees.dbh[i] : prototype_.getDBH(LengthUnits::Inches);
+        tree.treeHeight = trees.treeHeight ? trees.treeHeight[i] : prototype_.getTreeHeight(LengthUnits::Feet);
+        tree.crownRatio = trees.crownRatio ? trees.crownRatio[i] : prototype_.getCrownRatio(FractionUnits::Fraction);
+        tree.crownDamage = trees.crownDamage ? trees.crownDamage[i] : prototype_.getCrownDamage();
+        tree.cambiumKillRating = trees.cambiumKillRating ? trees.cambiumKillRating[i] : prototype_.getCambiumKillRating();
+        tree.beetleDamage = trees.beetleDamage ? trees.beetleDamage[i] : prototype_.getBeetleDamage();
+        tree.boleCharHeight = trees.boleCharHeight ? trees.boleCharHeight[i] : prototype_.getBoleCharHeight(LengthUnits::Feet);
+        stand.push_back(tree);
+    }
+    // Trees of a group are run one after the other
+    std::stable_sort(stand.begin(), stand.end(), [](const StandTree& lhs, const StandTree& rhs)
+    {
+        return lhs.group < rhs.group;
+    });
+
+    std::unordered_map<int, int>::const_iterator found = standIndices_.find(standId);
+    if(found != standIndices_.end())
+    {
+        stands_[found->second] = stand;
+    }
+    else
+    {
+        standIndices_[standId] = (int)stands_.size();
+        stands_.push_back(stand);
+    }
+}
+
+void StandMortalityRunner::clearStands()
+{
+    stands_.clear();
+    standIndices_.clear();
+    groups_.clear();
+}
+
+int StandMortalityRunner::getNumberOfStands() const
+{
+    return (int)stands_.size();
+}
+
+void StandMortalityRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+void StandMortalityRunner::run(const StandMortalityInputBands& inputs, StandMortalityOutputBands& outputs)
+{
+    const long numberOfPixels = (long)inputs.numberOfRows * inputs.numberOfColumns;
+    if(numberOfPixels <= 0)
+    {
+        return;
+    }
+
+    // Each species group's equation plan is resolved once here, workers copy the resolved Mortality
+    std::vector<Mortality> groupPrototypes(groups_.size(), prototype_);
+    std::vector<bool> isGroupResolved(groups_.size(), false);
+    for(size_t group = 0; group < groups_.size(); group++)
+    {
+        std::string speciesCode = prototype_.getSpeciesCodeAtSpeciesTableIndex(groups_[group].speciesTableIndex);
+        groupPrototypes[group].setEquationType(groups_[group].equationType);
+        groupPrototypes[group].setSpeciesCode(speciesCode);
+        isGroupResolved[group] = groupPrototypes[group].updateInputsForSpeciesCodeAndEquationType(speciesCode, groups_[group].equationType);
+        groupPrototypes[group].setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::scorch_height);
+    }
+
+    int numberOfThreads = (numberOfThreads_ > 0) ? numberOfThreads_ : std::max(1, (int)std::thread::hardware_concurrency());
+    const long chunkSize = 1024;
+    long numberOfChunks = (numberOfPixels + chunkSize - 1) / chunkSize;
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots((int)std::min((long)numberOfThreads, numberOfChunks));
+    std::vector<std::vector<Mortality>> workers(numberOfSlots, groupPrototypes);
+
+    threadPool->runChunks(numberOfPixels, chunkSize, [&](int slot, long begin, long end)
+    {
+        std::vector<Mortality>& groupWorkers = workers[slot];
+        // Neighboring pixels often share a stand and fire, their result is reused
+        int lastStand = -1;
+        double lastScorchHeight = -1.0;
+        double basalAreaMortality = outputs.noDataValue;
+        double stemMortality = outputs.noDataValue;
+        for(long pixel = begin; pixel < end; pixel++)
+        {
+            std::unordered_map<int, int>::const_iterator found = standIndices_.find(inputs.standId[pixel]);
+            double firelineIntensity = inputs.firelineIntensity.at(pixel);
+            if(found == standIndices_.end() ||
+                (inputs.firelineIntensity.values && firelineIntensity == inputs.noDataValue))
+            {
+                if(outputs.basalAreaMortality)
+                {
+                    outputs.basalAreaMortality[pixel] = outputs.noDataValue;
+                }
+                if(outputs.stemMortality)
+                {
+                    outputs.stemMortality[pixel] = outputs.noDataValue;
+                }
+                continue;
+            }
+
+            if(firelineIntensity <= 0.0)
+            {
+                // Unburned, nothing is killed and the cached result is kept for the next burned pixel
+                if(outputs.basalAreaMortality)
+                {
+                    outputs.basalAreaMortality[pixel] = 0.0;
+                }
+                if(outputs.stemMortality)
+                {
+                    outputs.stemMortality[pixel] = 0.0;
+                }
+                continue;
+            }
+
+            const int standIndex = found->second;
+            double scorchHeight = prototype_.calculateScorchHeight(firelineIntensity, FirelineIntensityUnits::BtusPerFootPerSecond,
+                inputs.midflameWindSpeed.at(pixel), SpeedUnits::FeetPerMinute, inputs.airTemperature.at(pixel),
+                TemperatureUnits::Fahrenheit, LengthUnits::Feet);
+            if(standIndex != lastStand || scorchHeight != lastScorchHeight)
+            {
+                lastStand = standIndex;
+                lastScorchHeight = scorchHeight;
+                int numberOfTrees = 0;
+                double prefireTrees = 0;
+                double killedTrees = 0;
+                double prefireBasalArea = 0;
+                double killedBasalArea = 0;
+                for(const StandTree& tree : stands_[standIndex])
+                {
+                    if(!isGroupResolved[tree.group])
+                    {
+                        continue;
+                    }
+                    Mortality& worker = groupWorkers[tree.group];
+                    worker.setScorchHeight(scorchHeight, LengthUnits::Feet);
+                    worker.setTreeDensityPerUnitArea(tree.treeDensityPerAcre, AreaUnits::Acres);
+                    worker.setDBH(tree.dbh, LengthUnits::Inches);
+                    worker.setTreeHeight(tree.treeHeight, LengthUnits::Feet);
+                    worker.setCrownRatio(tree.crownRatio, FractionUnits::Fraction);
+                    worker.setCrownDamage(tree.crownDamage);
+                    worker.setCambiumKillRating(tree.cambiumKillRating);
+                    worker.setBeetleDamage(tree.beetleDamage);
+                    worker.setBoleCharHeight(tree.boleCharHeight, LengthUnits::Feet);
+                    double probabilityOfMortality = worker.calculateMortality(FractionUnits::Fraction);
+                    if(probabilityOfMortality < 0)
+                    {
+                        continue;
+                    }
+                    numberOfTrees++;
+                    prefireTrees += tree.treeDensityPerAcre;
+                    killedTrees += worker.getKilledTrees();
+                    prefireBasalArea += worker.getBasalAreaPrefire();
+                    killedBasalArea += worker.getBasalAreaKillled();
+                }
+                basalAreaMortality = (numberOfTrees > 0) ? ((prefireBasalArea > 0) ? killedBasalArea / prefireBasalArea : 0.0) : outputs.noDataValue;
+                stemMortality = (numberOfTrees > 0) ? ((prefireTrees > 0) ? killedTrees / prefireTrees : 0.0) : outputs.noDataValue;
+            }
+            if(outputs.basalAreaMortality)
+            {
+                outputs.basalAreaMortality[pixel] = basalAreaMortality;
+            }
+            if(outputs.stemMortality)
+            {
+                outputs.stemMortality[pixel] = stemMortality;
+            }
+        }
+    }, numberOfSlots);
+}
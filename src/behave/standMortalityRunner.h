@@ -0,0 +1,118 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Maps stand tree mortality from surface fireline intensity bands,
+*           pixel by pixel on a pool of threads
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef STANDMORTALITYRUNNER_H
+#define STANDMORTALITYRUNNER_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "landscapeRunner.h"
+#include "mortality.h"
+
+// Aligned input bands for StandMortalityRunner::run(), in base units: fireline intensity in
+// btu/ft/s as LandscapeRunner fills it, midflame wind speed in ft/min and air temperature in
+// degrees F. standId gives each pixel's stand as added to the runner, a pixel whose stand
+// wasn't added or whose gridded fireline intensity equals noDataValue is no-data.
+struct StandMortalityInputBands
+{
+    int numberOfRows;
+    int numberOfColumns;
+    double noDataValue;
+
+    const int* standId;
+    LandscapeBand firelineIntensity;
+    LandscapeBand midflameWindSpeed;
+    LandscapeBand airTemperature;
+};
+
+// Caller-provided output bands, each sized for numberOfRows * numberOfColumns values: the
+// fractions of the stand's prefire basal area and of its prefire stems killed, over the trees
+// with a valid probability of mortality. Either band may be null. No-data pixels, and burned
+// pixels whose stand has no tree with a valid probability of mortality, are set to noDataValue.
+struct StandMortalityOutputBands
+{
+    double noDataValue;
+
+    double* basalAreaMortality;
+    double* stemMortality;
+};
+
+// Maps post-fire tree mortality over a landscape of stands. Each pixel's scorch height comes from
+// its fireline intensity, midflame wind and air temperature, and every tree of the pixel's stand is
+// run with it through a Mortality resolved once per species record and equation type, summing the
+// stand's killed basal area and stems without keeping per-tree results. Pixels with no fireline
+// intensity are unburned and kill nothing. Inputs the tree lists don't supply, such as the region,
+// come from the prototype, whose species master table must not change while the runner is used.
+class StandMortalityRunner
+{
+public:
+    explicit StandMortalityRunner(const Mortality& prototype);
+
+    // The tree list is copied, its flame length or scorch height inputs are not used. Adding a stand
+    // again replaces its tree list
+    void addStand(int standId, const MortalityBatchInputs& trees);
+    void clearStands();
+    int getNumberOfStands() const;
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+
+    void run(const StandMortalityInputBands& inputs, StandMortalityOutputBands& outputs);
+
+protected:
+    // One tree of a stand, its group the species record and equation type it is run with
+    struct StandTree
+    {
+        int group;
+        double treeDensityPerAcre;
+        double dbh;
+        double treeHeight;
+        double crownRatio;
+        double crownDamage;
+        double cambiumKillRating;
+        BeetleDamage beetleDamage;
+        double boleCharHeight;
+    };
+
+    struct SpeciesGroup
+    {
+        int speciesTableIndex;
+        EquationType equationType;
+    };
+
+    // Trees ordered by group, trees with no species record left out
+    typedef std::vector<StandTree> Stand;
+
+    Mortality prototype_;
+    std::vector<Stand> stands_;
+    std::unordered_map<int, int> standIndices_; // stand id to index in stands_
+    std::vector<SpeciesGroup> groups_;
+    int numberOfThreads_;
+};
+
+#endif // STANDMORTALITYRUNNER_H
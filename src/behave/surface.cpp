@@ -30,22 +30,74 @@
 ******************************************************************************/
 
 #include "surface.h"
+#include "instrumentation.h"
 #include "surfaceTwoFuelModels.h"
 #include "surfaceInputs.h"
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    // Orders NaN after every number and equal to any other NaN, so that it is a strict weak ordering
+    bool isBeforeWithNaNLast(double lhs, double rhs)
+    {
+        if (std::isnan(rhs))
+        {
+            return !std::isnan(lhs);
+        }
+        return lhs < rhs;
+    }
+
+    // Cells ordered by fuel model and moistures, then canopy, keeping input order within a group
+    void getCellOrderGroupedByFuelbed(const SurfaceBatchInputs& inputs, std::vector<int>& cellOrder)
+    {
+        cellOrder.resize(inputs.numberOfCells);
+        std::iota(cellOrder.begin(), cellOrder.end(), 0);
+        const double* const keys[] = { inputs.moistureOneHour, inputs.moistureTenHour, inputs.moistureHundredHour,
+            inputs.moistureLiveHerbaceous, inputs.moistureLiveWoody, inputs.canopyCover, inputs.canopyHeight, inputs.crownRatio };
+        auto isBefore = [&inputs, &keys](int lhs, int rhs)
+        {
+            if (inputs.fuelModelNumber[lhs] != inputs.fuelModelNumber[rhs])
+            {
+                return inputs.fuelModelNumber[lhs] < inputs.fuelModelNumber[rhs];
+            }
+            for (const double* key : keys)
+            {
+                if (isBeforeWithNaNLast(key[lhs], key[rhs]))
+                {
+                    return true;
+                }
+                if (isBeforeWithNaNLast(key[rhs], key[lhs]))
+                {
+                    return false;
+                }
+            }
+            return false;
+        };
+        if (!std::is_sorted(cellOrder.begin(), cellOrder.end(), isBefore))
+        {
+            std::stable_sort(cellOrder.begin(), cellOrder.end(), isBefore);
+        }
+    }
+}
 
 Surface::Surface(const FuelModels& fuelModels)
     : surfaceInputs_(),
-    surfaceFire_(fuelModels, surfaceInputs_, size_)
+    surfaceFire_(fuelModels, surfaceInputs_, size_),
+    batchOrderMode_(SurfaceBatchOrderMode::InputOrder)
 {
     fuelModels_ = &fuelModels;
 }
 
 // Copy Ctor
 Surface::Surface(const Surface& rhs)
-    : surfaceFire_()
+    : surfaceInputs_(),
+    surfaceFire_(*rhs.fuelModels_, surfaceInputs_, size_)
 {
+    fuelModels_ = rhs.fuelModels_;
     memberwiseCopyAssignment(rhs);
 }
 
@@ -63,6 +115,23 @@ void Surface::memberwiseCopyAssignment(const Surface& rhs)
     surfaceInputs_ = rhs.surfaceInputs_;
     surfaceFire_ = rhs.surfaceFire_;
     size_ = rhs.size_;
+    batchOrderMode_ = rhs.batchOrderMode_;
+}
+
+void Surface::copyStateWithoutCaches(const Surface& rhs)
+{
+    if (this != &rhs)
+    {
+        surfaceInputs_ = rhs.surfaceInputs_;
+        surfaceFire_.copyStateWithoutCaches(rhs.surfaceFire_);
+        size_ = rhs.size_;
+        batchOrderMode_ = rhs.batchOrderMode_;
+    }
+}
+
+bool Surface::hasSameInputs(const Surface& rhs) const
+{
+    return surfaceInputs_.hasSameInputs(rhs.surfaceInputs_);
 }
 
 bool Surface::isAllFuelLoadZero(int fuelModelNumber)
@@ -72,6 +141,7 @@ bool Surface::isAllFuelLoadZero(int fuelModelNumber)
 
 void Surface::doSurfaceRunInDirectionOfMaxSpread()
 {
+    BEHAVE_TIME_STAGE(SurfaceRun);
     surfaceInputs_.updateMoisturesBasedOnInputMode();
     double directionOfInterest = 0.0;
     bool hasDirectionOfInterest = false;
@@ -109,6 +179,7 @@ void Surface::doSurfaceRunInDirectionOfMaxSpread()
 
 void Surface::doSurfaceRunInDirectionOfInterest(double directionOfInterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode)
 {
+    BEHAVE_TIME_STAGE(SurfaceRun);
     surfaceInputs_.updateMoisturesBasedOnInputMode();
     bool hasDirectionOfInterest = true;
     if (isUsingTwoFuelModels())
@@ -138,6 +209,460 @@ void Surface::doSurfaceRunInDirectionOfInterest(double directionOfInterest, Surf
     }
 }
 
+// Spread rate in the direction of max spread the last run would have given with a different 20 foot wind
+// speed, leaving every input and output as it was. Only the wind factor depends on the wind speed, so for a
+// single fuel model with a 20 foot or 10 meter wind just the wind factor and spread vector are recalculated,
+// otherwise the surface is run again with the new wind speed and then restored.
+double Surface::calculateSpreadRateAtTwentyFootWindSpeed(double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits,
+    SpeedUnits::SpeedUnitsEnum spreadRateUnits)
+{
+    double spreadRate = 0.0;
+    windSpeed = SpeedUnits::toBaseUnits(windSpeed, windSpeedUnits);
+    if (!isUsingTwoFuelModels() && (surfaceInputs_.getWindHeightInputMode() != WindHeightInputMode::DirectMidflame))
+    {
+        double midflameWindSpeed = surfaceFire_.getWindAdjustmentFactor() * windSpeed;
+        spreadRate = surfaceFire_.calculateForwardSpreadRateAtMidflameWindSpeed(midflameWindSpeed);
+    }
+    else
+    {
+        Surface surfaceTemp = *this; // Remember state to undo side-effects of this method
+        setWindSpeed(windSpeed, SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot);
+        doSurfaceRunInDirectionOfMaxSpread();
+        spreadRate = surfaceFire_.getSpreadRate();
+        *this = surfaceTemp; // Restore state
+    }
+    return SpeedUnits::fromBaseUnits(spreadRate, spreadRateUnits);
+}
+
+// Inverse of calculateSpreadRateAtTwentyFootWindSpeed() in base units, the 20 ft wind speed (ft/min) at which the
+// last run would spread at spreadRate (ft/min), HUGE_VAL if the wind speed limit keeps it from spreading that
+// fast. A single fuel model with upslope or no slope wind inverts the wind factor in closed form. Otherwise the
+// wind speed is bracketed, starting from initialWindSpeed when it is a previous answer, and found by regula
+// falsi (Illinois variant) on calculateSpreadRateAtTwentyFootWindSpeed(), which reuses the fuelbed of the run.
+double Surface::calculateTwentyFootWindSpeedAtSpreadRate(double spreadRate, double initialWindSpeed)
+{
+    const double MAX_WIND_SPEED = 88.0 * 1000.0; // 1000 mph, bracketing gives up above this (ft/min)
+    const double RELATIVE_TOLERANCE = 1.0e-10;
+    const int MAX_ITERATIONS = 100;
+
+    if (!isUsingTwoFuelModels() && (surfaceInputs_.getWindHeightInputMode() != WindHeightInputMode::DirectMidflame))
+    {
+        double midflameWindSpeed = 0.0;
+        if (surfaceFire_.calculateMidflameWindSpeedAtForwardSpreadRate(spreadRate, midflameWindSpeed))
+        {
+            double windAdjustmentFactor = surfaceFire_.getWindAdjustmentFactor();
+            if (midflameWindSpeed <= 0.0)
+            {
+                return 0.0;
+            }
+            return (windAdjustmentFactor < 1.0e-07 || midflameWindSpeed == HUGE_VAL)
+                ? (HUGE_VAL)
+                : (midflameWindSpeed / windAdjustmentFactor);
+        }
+    }
+
+    // Bracket the wind speed, f(low) < 0 <= f(high)
+    double low = 0.0;
+    double fLow = calculateSpreadRateAtTwentyFootWindSpeed(low, SpeedUnits::FeetPerMinute, SpeedUnits::FeetPerMinute) - spreadRate;
+    if (fLow >= 0.0)
+    {
+        return 0.0;
+    }
+    double high = (initialWindSpeed > 0.0 && initialWindSpeed < MAX_WIND_SPEED) ? initialWindSpeed : 88.0;
+    double fHigh = calculateSpreadRateAtTwentyFootWindSpeed(high, SpeedUnits::FeetPerMinute, SpeedUnits::FeetPerMinute) - spreadRate;
+    if (fHigh >= 0.0)
+    {
+        // Warm start, tighten the low end towards the previous answer
+        double lower = 0.5 * high;
+        double fLower = calculateSpreadRateAtTwentyFootWindSpeed(lower, SpeedUnits::FeetPerMinute, SpeedUnits::FeetPerMinute) - spreadRate;
+        if (fLower < 0.0)
+        {
+            low = lower;
+            fLow = fLower;
+        }
+        else
+        {
+            high = lower;
+            fHigh = fLower;
+        }
+    }
+    while (fHigh < 0.0)
+    {
+        low = high;
+        fLow = fHigh;
+        high *= 2.0;
+        if (high > MAX_WIND_SPEED)
+        {
+            return HUGE_VAL;
+        }
+        fHigh = calculateSpreadRateAtTwentyFootWindSpeed(high, SpeedUnits::FeetPerMinute, SpeedUnits::FeetPerMinute) - spreadRate;
+    }
+
+    int side = 0;
+    for (int i = 0; i < MAX_ITERATIONS && (high - low) > RELATIVE_TOLERANCE * high; i++)
+    {
+        double windSpeed = (low * fHigh - high * fLow) / (fHigh - fLow);
+        double f = calculateSpreadRateAtTwentyFootWindSpeed(windSpeed, SpeedUnits::FeetPerMinute, SpeedUnits::FeetPerMinute) - spreadRate;
+        if (f >= 0.0)
+        {
+            high = windSpeed;
+            fHigh = f;
+            if (f == 0.0)
+            {
+                break;
+            }
+            if (side == 1)
+            {
+                fLow *= 0.5;
+            }
+            side = 1;
+        }
+        else
+        {
+            low = windSpeed;
+            fLow = f;
+            if (side == -1)
+            {
+                fHigh *= 0.5;
+            }
+            side = -1;
+        }
+    }
+    return high;
+}
+
+// Sweeps numberOfDirections directions of interest for the current inputs, writing spread rate (ft/min),
+// fireline intensity (Btu/ft/s) and flame length (ft) for each direction. A single fuel model is run once
+// in the direction of max spread and only the fire ellipse is evaluated per direction, so afterwards the
+// Surface getters report that run. Two fuel models weight every direction separately and are run once
+// per direction. Null output arrays are skipped.
+void Surface::doSurfaceRunInDirectionsOfInterest(const double* directionsOfInterest, int numberOfDirections,
+    SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode, double* spreadRates,
+    double* firelineIntensities, double* flameLengths)
+{
+    BEHAVE_TIME_STAGE(SurfaceRun);
+    if (isUsingTwoFuelModels())
+    {
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            doSurfaceRunInDirectionOfInterest(directionsOfInterest[i], directionMode);
+            if (spreadRates != nullptr)
+            {
+                spreadRates[i] = surfaceFire_.getSpreadRateInDirectionOfInterest();
+            }
+            if (firelineIntensities != nullptr)
+            {
+                firelineIntensities[i] = surfaceFire_.getFirelineIntensityInDirectionOfInterest();
+            }
+            if (flameLengths != nullptr)
+            {
+                flameLengths[i] = surfaceFire_.getFlameLengthInDirectionOfInterest();
+            }
+        }
+    }
+    else
+    {
+        // The sweep evaluates the fire ellipse, so it is calculated whatever the requested outputs
+        int surfaceFireOutputs = surfaceInputs_.getSurfaceFireOutputs();
+        surfaceInputs_.setSurfaceFireOutputs(surfaceFireOutputs | SurfaceFireOutputs::FireShape);
+        doSurfaceRunInDirectionOfMaxSpread();
+        surfaceInputs_.setSurfaceFireOutputs(surfaceFireOutputs);
+        surfaceFire_.calculateSpreadRatesAtVectors(directionsOfInterest, numberOfDirections, directionMode, spreadRates,
+            firelineIntensities, flameLengths);
+    }
+}
+
+// Sweeps numberOfCoverages first fuel model coverages for the current two fuel models inputs, writing spread
+// rate (ft/min), fireline intensity (Btu/ft/s) and flame length (ft) in the direction of max spread for each
+// coverage. Only the weighting depends on the coverage, so both fuel models are run once and then weighted
+// per coverage. The coverage input is left as it was, but afterwards the Surface getters report the last
+// coverage swept. With a single fuel model the coverage doesn't apply and every coverage gets the same run.
+// Null output arrays are skipped.
+void Surface::doSurfaceRunForFirstFuelModelCoverages(const double* firstFuelModelCoverages, int numberOfCoverages,
+    FractionUnits::FractionUnitsEnum coverageUnits, double* spreadRates, double* firelineIntensities, double* flameLengths)
+{
+    BEHAVE_TIME_STAGE(SurfaceRun);
+    if (isUsingTwoFuelModels())
+    {
+        std::vector<double> coverages(firstFuelModelCoverages, firstFuelModelCoverages + numberOfCoverages);
+        FractionUnits::toBaseUnits(coverages.data(), coverages.size(), coverageUnits);
+
+        surfaceInputs_.updateMoisturesBasedOnInputMode();
+        SurfaceTwoFuelModels surfaceTwoFuelModels(surfaceFire_);
+        surfaceTwoFuelModels.calculateWeightedSpreadRates(surfaceInputs_.getTwoFuelModelsMethod(), surfaceInputs_.getFirstFuelModelNumber(),
+            coverages.data(), numberOfCoverages, surfaceInputs_.getSecondFuelModelNumber(), spreadRates, firelineIntensities, flameLengths);
+    }
+    else
+    {
+        doSurfaceRunInDirectionOfMaxSpread();
+        for (int i = 0; i < numberOfCoverages; i++)
+        {
+            if (spreadRates != nullptr)
+            {
+                spreadRates[i] = surfaceFire_.getSpreadRate();
+            }
+            if (firelineIntensities != nullptr)
+            {
+                firelineIntensities[i] = surfaceFire_.getFirelineIntensity();
+            }
+            if (flameLengths != nullptr)
+            {
+                flameLengths[i] = surfaceFire_.getFlameLength();
+            }
+        }
+    }
+}
+
+// Runs the surface fire in the direction of max spread for every cell of a structure-of-arrays batch.
+// Inputs not in SurfaceBatchInputs (wind height and orientation modes, wind adjustment factor method, etc.)
+// are taken from the current surface inputs. Each cell uses a single fuel model with moistures by size class.
+// After the call the Surface getters report the last cell run, which is the last cell of the batch in input order,
+// or in GroupedByFuelbed mode the last cell of the grouped order.
+void Surface::doSurfaceRunBatch(const SurfaceBatchInputs& inputs, SurfaceBatchOutputs& outputs)
+{
+    BEHAVE_TIME_STAGE(SurfaceRun);
+    bool isUsingChaparralOrPalmettoGallberryOrWesternAspen = surfaceInputs_.getIsUsingPalmettoGallberry() || surfaceInputs_.getIsUsingWesternAspen() ||
+        surfaceInputs_.getIsUsingChaparral();
+
+    if (batchOrderMode_ == SurfaceBatchOrderMode::GroupedByFuelbed)
+    {
+        std::vector<int> cellOrder;
+        getCellOrderGroupedByFuelbed(inputs, cellOrder);
+        for (int cell : cellOrder)
+        {
+            doSurfaceRunBatchCell(inputs, cell, isUsingChaparralOrPalmettoGallberryOrWesternAspen, outputs);
+        }
+        return;
+    }
+
+    for (int i = 0; i < inputs.numberOfCells; i++)
+    {
+        doSurfaceRunBatchCell(inputs, i, isUsingChaparralOrPalmettoGallberryOrWesternAspen, outputs);
+    }
+}
+
+// Runs each of numberOfFuelModels fuel models in the direction of max spread under the current weather, terrain
+// and canopy inputs, writing the outputs of fuel model i at index i as doSurfaceRunBatch() would for a cell.
+// Moistures are settled once for the whole sweep. The spread of each fuel model is calculated without its
+// fireline intensity and flame length, which depend on the model only through its spread rate, reaction
+// intensity and residence time, so they are evaluated for all the models at once in loops the compiler can
+// vectorize, flame lengths with VectorMath's pow in Fast mode. After the call the Surface getters report the
+// last fuel model's spread but not its fireline intensity or flame length.
+void Surface::doSurfaceRunForFuelModels(const int* fuelModelNumbers, int numberOfFuelModels, SurfaceBatchOutputs& outputs)
+{
+    BEHAVE_TIME_STAGE(SurfaceRun);
+    const SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode = SurfaceFireSpreadDirectionMode::FromIgnitionPoint;
+    bool isUsingChaparralOrPalmettoGallberryOrWesternAspen = surfaceInputs_.getIsUsingPalmettoGallberry() || surfaceInputs_.getIsUsingWesternAspen() ||
+        surfaceInputs_.getIsUsingChaparral();
+    int surfaceFireOutputs = surfaceInputs_.getSurfaceFireOutputs();
+    bool isCalculatingFlameLength = (outputs.flameLength != nullptr) && (surfaceFireOutputs & SurfaceFireOutputs::FlameLength);
+    bool isCalculatingFirelineIntensity = isCalculatingFlameLength ||
+        ((outputs.firelineIntensity != nullptr) && (surfaceFireOutputs & SurfaceFireOutputs::FirelineIntensity));
+    bool isFireShapeCalculated = (surfaceFireOutputs & SurfaceFireOutputs::FireShape) != 0;
+
+    surfaceInputs_.updateMoisturesBasedOnInputMode();
+    surfaceInputs_.setSurfaceFireOutputs(surfaceFireOutputs & ~(SurfaceFireOutputs::FirelineIntensity | SurfaceFireOutputs::FlameLength));
+    std::vector<double> spreadRates(numberOfFuelModels);
+    std::vector<double> reactionIntensities(numberOfFuelModels);
+    std::vector<double> residenceTimeFactors(numberOfFuelModels); // residence time in seconds
+    for (int i = 0; i < numberOfFuelModels; i++)
+    {
+        int fuelModelNumber = fuelModelNumbers[i];
+        bool isFuelToBurn = isUsingChaparralOrPalmettoGallberryOrWesternAspen ||
+            (!isAllFuelLoadZero(fuelModelNumber) && fuelModels_->isFuelModelDefined(fuelModelNumber));
+        if (isFuelToBurn)
+        {
+            surfaceFire_.calculateForwardSpreadRate(fuelModelNumber, false, 0.0, directionMode);
+        }
+        else
+        {
+            // No fuel to burn, spread rate is zero
+            surfaceFire_.skipCalculationForZeroLoad();
+        }
+
+        spreadRates[i] = surfaceFire_.getSpreadRate();
+        reactionIntensities[i] = surfaceFire_.getReactionIntensity();
+        residenceTimeFactors[i] = surfaceFire_.getResidenceTime() / 60.0;
+        if (outputs.directionOfMaxSpread)
+        {
+            outputs.directionOfMaxSpread[i] = surfaceFire_.getDirectionOfMaxSpread();
+        }
+        if (outputs.fireLengthToWidthRatio)
+        {
+            outputs.fireLengthToWidthRatio[i] = (isFuelToBurn && isFireShapeCalculated) ? surfaceFire_.getFireLengthToWidthRatio() : 1.0;
+        }
+    }
+    surfaceInputs_.setSurfaceFireOutputs(surfaceFireOutputs);
+
+    if (outputs.spreadRate)
+    {
+        std::copy(spreadRates.begin(), spreadRates.end(), outputs.spreadRate);
+    }
+    std::vector<double> intensityStorage;
+    double* intensities = outputs.firelineIntensity;
+    if (isCalculatingFirelineIntensity && !intensities)
+    {
+        intensityStorage.resize(numberOfFuelModels);
+        intensities = intensityStorage.data();
+    }
+    if (intensities)
+    {
+        for (int i = 0; i < numberOfFuelModels; i++)
+        {
+            intensities[i] = isCalculatingFirelineIntensity ? (spreadRates[i] * reactionIntensities[i] * residenceTimeFactors[i]) : 0.0;
+        }
+    }
+    if (outputs.flameLength)
+    {
+        double* flameLengths = outputs.flameLength;
+        if (!isCalculatingFlameLength)
+        {
+            std::fill(flameLengths, flameLengths + numberOfFuelModels, 0.0);
+        }
+        else if (getVectorMathMode() == VectorMathMode::Fast)
+        {
+            VectorMath::pow(intensities, 0.46, flameLengths, numberOfFuelModels, VectorMathMode::Fast);
+            for (int i = 0; i < numberOfFuelModels; i++)
+            {
+                flameLengths[i] = (intensities[i] < 1.0e-07) ? (0.0) : (0.45 * flameLengths[i]);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < numberOfFuelModels; i++)
+            {
+                // Byram 1959, Albini 1976
+                flameLengths[i] = (intensities[i] < 1.0e-07) ? (0.0) : (0.45 * pow(intensities[i], 0.46));
+            }
+        }
+    }
+}
+
+// Chaparral version of doSurfaceRunBatch(), the chaparral surface inputs must be turned on with a fuel type set.
+// Every cell's fuel bed depth, total fuel load and dead fuel fraction are derived from its age, and its live
+// leaf and stem moistures from its date, in one pass before the runs. The derived moistures replace the live
+// herbaceous and woody moisture arrays of inputs, which may be null. As with the single cell chaparral run,
+// live heats of combustion stay at the fixed BehavePlus 6 values. Cells of equal age and moistures reuse the
+// fuelbed of the previous cell. After the call the Surface getters report the last cell of the batch.
+void Surface::doSurfaceRunBatchChaparral(const SurfaceBatchInputs& inputs, const ChaparralBatchInputs& chaparralInputs,
+    SurfaceBatchOutputs& outputs)
+{
+    BEHAVE_TIME_STAGE(SurfaceRun);
+    int numberOfCells = inputs.numberOfCells;
+    std::vector<double> fuelBedDepth(numberOfCells);
+    std::vector<double> totalFuelLoad(numberOfCells);
+    std::vector<double> deadFuelFraction(numberOfCells);
+    std::vector<double> liveLeafMoisture(numberOfCells);
+    std::vector<double> liveStemMoisture(numberOfCells);
+    ChaparralBatchOutputs chaparralOutputs = { fuelBedDepth.data(), totalFuelLoad.data(), deadFuelFraction.data(),
+        liveLeafMoisture.data(), liveStemMoisture.data(), nullptr, nullptr };
+    ChaparralFuel::calculateFuelbedPropertiesBatch(surfaceInputs_.getChaparralFuelType(), chaparralInputs, chaparralOutputs);
+
+    SurfaceBatchInputs chaparralCellInputs = inputs;
+    chaparralCellInputs.moistureLiveHerbaceous = liveLeafMoisture.data();
+    chaparralCellInputs.moistureLiveWoody = liveStemMoisture.data();
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        surfaceInputs_.updateChaparralInputsInBaseUnits(fuelBedDepth[i], totalFuelLoad[i], deadFuelFraction[i]);
+        doSurfaceRunBatchCell(chaparralCellInputs, i, true, outputs);
+    }
+}
+
+// Runs one cell of a batch and writes its outputs at the same index
+void Surface::doSurfaceRunBatchCell(const SurfaceBatchInputs& inputs, int cell, bool isUsingSpecialFuel, SurfaceBatchOutputs& outputs)
+{
+    const SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode = SurfaceFireSpreadDirectionMode::FromIgnitionPoint;
+    int fuelModelNumber = inputs.fuelModelNumber[cell];
+    surfaceInputs_.updateSurfaceInputsInBaseUnits(fuelModelNumber, inputs.moistureOneHour[cell], inputs.moistureTenHour[cell],
+        inputs.moistureHundredHour[cell], inputs.moistureLiveHerbaceous[cell], inputs.moistureLiveWoody[cell], inputs.windSpeed[cell],
+        inputs.windDirection[cell], inputs.slope[cell], inputs.aspect[cell], inputs.canopyCover[cell], inputs.canopyHeight[cell], inputs.crownRatio[cell]);
+
+    bool isFuelToBurn = isUsingSpecialFuel ||
+        (!isAllFuelLoadZero(fuelModelNumber) && fuelModels_->isFuelModelDefined(fuelModelNumber));
+    if (isFuelToBurn)
+    {
+        surfaceFire_.calculateForwardSpreadRate(fuelModelNumber, false, 0.0, directionMode);
+    }
+    else
+    {
+        // No fuel to burn, spread rate is zero
+        surfaceFire_.skipCalculationForZeroLoad();
+    }
+
+    if (outputs.spreadRate)
+    {
+        outputs.spreadRate[cell] = surfaceFire_.getSpreadRate();
+    }
+    if (outputs.firelineIntensity)
+    {
+        outputs.firelineIntensity[cell] = surfaceFire_.getFirelineIntensity();
+    }
+    if (outputs.flameLength)
+    {
+        outputs.flameLength[cell] = surfaceFire_.getFlameLength();
+    }
+    if (outputs.directionOfMaxSpread)
+    {
+        outputs.directionOfMaxSpread[cell] = surfaceFire_.getDirectionOfMaxSpread();
+    }
+    if (outputs.fireLengthToWidthRatio)
+    {
+        // The fire size is not updated when there is nothing to burn or no fire shape was asked for,
+        // so don't report the previous cell's
+        bool isFireShapeCalculated = isFuelToBurn && (surfaceInputs_.getSurfaceFireOutputs() & SurfaceFireOutputs::FireShape);
+        outputs.fireLengthToWidthRatio[cell] = isFireShapeCalculated ? surfaceFire_.getFireLengthToWidthRatio() : 1.0;
+    }
+}
+
+// Two fuel models version of doSurfaceRunBatch(), inputs.fuelModelNumber holds each cell's first fuel model,
+// and firstFuelModelCoverage is a fraction. Both fuel models of a cell are run back to back in the direction
+// of max spread and weighted with the current two fuel models method. Turning on the two fuel models cache
+// lets cells that repeat a pair of fuel models under the same conditions, with any coverage, skip both runs.
+// After the call the Surface getters report the last cell of the batch.
+void Surface::doSurfaceRunBatchTwoFuelModels(const SurfaceBatchInputs& inputs, const int* secondFuelModelNumber,
+    const double* firstFuelModelCoverage, SurfaceBatchOutputs& outputs)
+{
+    BEHAVE_TIME_STAGE(SurfaceRun);
+    const SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode = SurfaceFireSpreadDirectionMode::FromIgnitionPoint;
+    // Updating a cell's inputs clears the method
+    const TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod = surfaceInputs_.getTwoFuelModelsMethod();
+
+    for (int i = 0; i < inputs.numberOfCells; i++)
+    {
+        surfaceInputs_.updateSurfaceInputsInBaseUnits(inputs.fuelModelNumber[i], inputs.moistureOneHour[i], inputs.moistureTenHour[i],
+            inputs.moistureHundredHour[i], inputs.moistureLiveHerbaceous[i], inputs.moistureLiveWoody[i], inputs.windSpeed[i],
+            inputs.windDirection[i], inputs.slope[i], inputs.aspect[i], inputs.canopyCover[i], inputs.canopyHeight[i], inputs.crownRatio[i]);
+        surfaceInputs_.setSecondFuelModelNumber(secondFuelModelNumber[i]);
+        surfaceInputs_.setTwoFuelModelsFirstFuelModelCoverage(firstFuelModelCoverage[i], FractionUnits::Fraction);
+        surfaceInputs_.setTwoFuelModelsMethod(twoFuelModelsMethod);
+
+        SurfaceTwoFuelModels surfaceTwoFuelModels(surfaceFire_);
+        surfaceTwoFuelModels.calculateWeightedSpreadRate(twoFuelModelsMethod, inputs.fuelModelNumber[i], firstFuelModelCoverage[i],
+            secondFuelModelNumber[i], false, 0.0, directionMode);
+
+        if (outputs.spreadRate)
+        {
+            outputs.spreadRate[i] = surfaceFire_.getSpreadRate();
+        }
+        if (outputs.firelineIntensity)
+        {
+            outputs.firelineIntensity[i] = surfaceFire_.getFirelineIntensity();
+        }
+        if (outputs.flameLength)
+        {
+            outputs.flameLength[i] = surfaceFire_.getFlameLength();
+        }
+        if (outputs.directionOfMaxSpread)
+        {
+            outputs.directionOfMaxSpread[i] = surfaceFire_.getDirectionOfMaxSpread();
+        }
+        if (outputs.fireLengthToWidthRatio)
+        {
+            outputs.fireLengthToWidthRatio[i] = surfaceFire_.getFireLengthToWidthRatio();
+        }
+    }
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Calculates flame length from fireline (Byram's) intensity.
  *
@@ -156,7 +681,7 @@ double Surface::calculateFlameLength(double firelineIntensity, FirelineIntensity
     return LengthUnits::fromBaseUnits(flameLength, flameLengthUnits);
 }
 
-void Surface::setFuelModels(FuelModels& fuelModels)
+void Surface::setFuelModels(const FuelModels& fuelModels)
 {
     fuelModels_ = &fuelModels;
 }
@@ -167,6 +692,102 @@ void Surface::initializeMembers()
     surfaceInputs_.initializeMembers();
 }
 
+// A capacity of zero, the default, turns the cache off
+void Surface::setFuelbedCacheCapacity(int capacity)
+{
+    surfaceFire_.setFuelbedCacheCapacity(capacity);
+}
+
+void Surface::clearFuelbedCache()
+{
+    surfaceFire_.clearFuelbedCache();
+}
+
+int Surface::getFuelbedCacheNumberOfEntries() const
+{
+    return surfaceFire_.getFuelbedCacheNumberOfEntries();
+}
+
+long Surface::getFuelbedCacheNumberOfHits() const
+{
+    return surfaceFire_.getFuelbedCacheNumberOfHits();
+}
+
+long Surface::getFuelbedCacheNumberOfMisses() const
+{
+    return surfaceFire_.getFuelbedCacheNumberOfMisses();
+}
+
+// A capacity of zero, the default, turns the cache off. With it on, a run whose fuel models both come from
+// the cache leaves the SurfaceFire results that two fuel models don't combine, such as the fuelbed
+// intermediates and backing and flanking fire behavior, as they were after the last model calculated.
+void Surface::setTwoFuelModelsCacheCapacity(int capacity)
+{
+    surfaceFire_.setTwoFuelModelsCacheCapacity(capacity);
+}
+
+void Surface::clearTwoFuelModelsCache()
+{
+    surfaceFire_.clearTwoFuelModelsCache();
+}
+
+int Surface::getTwoFuelModelsCacheNumberOfEntries() const
+{
+    return surfaceFire_.getTwoFuelModelsCacheNumberOfEntries();
+}
+
+long Surface::getTwoFuelModelsCacheNumberOfHits() const
+{
+    return surfaceFire_.getTwoFuelModelsCacheNumberOfHits();
+}
+
+long Surface::getTwoFuelModelsCacheNumberOfMisses() const
+{
+    return surfaceFire_.getTwoFuelModelsCacheNumberOfMisses();
+}
+
+void Surface::setBatchOrderMode(SurfaceBatchOrderMode::SurfaceBatchOrderModeEnum batchOrderMode)
+{
+    batchOrderMode_ = batchOrderMode;
+}
+
+SurfaceBatchOrderMode::SurfaceBatchOrderModeEnum Surface::getBatchOrderMode() const
+{
+    return batchOrderMode_;
+}
+
+// In Fast mode doSurfaceRunInDirectionsOfInterest() evaluates the fire ellipse and flame lengths of a single
+// fuel model with the vectorized kernels of VectorMath, within their error budgets of the Exact results
+void Surface::setVectorMathMode(VectorMathMode::VectorMathModeEnum vectorMathMode)
+{
+    surfaceFire_.setVectorMathMode(vectorMathMode);
+}
+
+VectorMathMode::VectorMathModeEnum Surface::getVectorMathMode() const
+{
+    return surfaceFire_.getVectorMathMode();
+}
+
+long Surface::getWindAdjustmentFactorMemoNumberOfHits() const
+{
+    return surfaceFire_.getWindAdjustmentFactorMemoNumberOfHits();
+}
+
+long Surface::getWindAdjustmentFactorMemoNumberOfMisses() const
+{
+    return surfaceFire_.getWindAdjustmentFactorMemoNumberOfMisses();
+}
+
+void Surface::setSharedCache(SharedSurfaceCache* sharedCache)
+{
+    surfaceFire_.setSharedCache(sharedCache);
+}
+
+SharedSurfaceCache* Surface::getSharedCache() const
+{
+    return surfaceFire_.getSharedCache();
+}
+
 double Surface::calculateSpreadRateAtVector(double directionOfinterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode)
 {
     return surfaceFire_.calculateSpreadRateAtVector(directionOfinterest, directionMode);
@@ -311,6 +932,38 @@ double Surface::getMidflameWindspeed(SpeedUnits::SpeedUnitsEnum spreadRateUnits)
     return SpeedUnits::fromBaseUnits(surfaceFire_.getMidflameWindSpeed(), spreadRateUnits);
 }
 
+void Surface::getOutputs(const OutputUnitProfile& unitProfile, SurfaceOutputValues& outputs) const
+{
+    const double spreadRateFactor = unitProfile.getSpreadRateFactor();
+    const double flameLengthFactor = unitProfile.getFlameLengthFactor();
+    const double firelineIntensityFactor = unitProfile.getFirelineIntensityFactor();
+
+    outputs.spreadRate = surfaceFire_.getSpreadRate() * spreadRateFactor;
+    outputs.spreadRateInDirectionOfInterest = surfaceFire_.getSpreadRateInDirectionOfInterest() * spreadRateFactor;
+    outputs.backingSpreadRate = size_.getBackingSpreadRate(SpeedUnits::FeetPerMinute) * spreadRateFactor;
+    outputs.flankingSpreadRate = size_.getFlankingSpreadRate(SpeedUnits::FeetPerMinute) * spreadRateFactor;
+    outputs.directionOfMaxSpread = surfaceFire_.getDirectionOfMaxSpread();
+
+    outputs.flameLength = surfaceFire_.getFlameLength() * flameLengthFactor;
+    outputs.flameLengthInDirectionOfInterest = surfaceFire_.getFlameLengthInDirectionOfInterest() * flameLengthFactor;
+    outputs.backingFlameLength = surfaceFire_.getBackingFlameLength() * flameLengthFactor;
+    outputs.flankingFlameLength = surfaceFire_.getFlankingFlameLength() * flameLengthFactor;
+
+    outputs.firelineIntensity = surfaceFire_.getFirelineIntensity() * firelineIntensityFactor;
+    outputs.firelineIntensityInDirectionOfInterest = surfaceFire_.getFirelineIntensityInDirectionOfInterest() * firelineIntensityFactor;
+    outputs.backingFirelineIntensity = surfaceFire_.getBackingFirelineIntensity() * firelineIntensityFactor;
+    outputs.flankingFirelineIntensity = surfaceFire_.getFlankingFirelineIntensity() * firelineIntensityFactor;
+
+    outputs.heatPerUnitArea = surfaceFire_.getHeatPerUnitArea() * unitProfile.getHeatPerUnitAreaFactor();
+    outputs.reactionIntensity = surfaceFire_.getReactionIntensity() * unitProfile.getReactionIntensityFactor();
+    outputs.residenceTime = surfaceFire_.getResidenceTime() * unitProfile.getTimeFactor();
+    outputs.midflameWindSpeed = surfaceFire_.getMidflameWindSpeed() * unitProfile.getWindSpeedFactor();
+
+    outputs.fireLengthToWidthRatio = size_.getFireLengthToWidthRatio();
+    outputs.fireEccentricity = size_.getEccentricity();
+    outputs.headingToBackingRatio = size_.getHeadingToBackingRatio();
+}
+
 double Surface::getEllipticalA(LengthUnits::LengthUnitsEnum lengthUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const
 {
     return size_.getEllipticalA(lengthUnits, elapsedTime, timeUnits);
@@ -366,6 +1019,12 @@ double Surface::getFireArea(AreaUnits::AreaUnitsEnum areaUnits, double elapsedTi
     return size_.getFireArea(false, areaUnits, elapsedTime, timeUnits);
 }
 
+void Surface::getFireSizeAtElapsedTimes(const double* elapsedTimes, int numberOfElapsedTimes, TimeUnits::TimeUnitsEnum timeUnits,
+    LengthUnits::LengthUnitsEnum lengthUnits, AreaUnits::AreaUnitsEnum areaUnits, FireSizeBatchOutputs& outputs) const
+{
+    size_.getFireSizeAtElapsedTimes(false, elapsedTimes, numberOfElapsedTimes, timeUnits, lengthUnits, areaUnits, outputs);
+}
+
 double Surface::getCharacteristicMoistureByLifeState(FuelLifeState::FuelLifeStateEnum lifeState, FractionUnits::FractionUnitsEnum moistureUnits) const
 {
     return FractionUnits::fromBaseUnits(surfaceFire_.getWeightedMoistureByLifeState(lifeState), moistureUnits);
@@ -725,6 +1384,16 @@ WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum Surface::getWindA
     return surfaceInputs_.getWindAndSpreadOrientationMode();
 }
 
+int Surface::getSurfaceFireOutputs() const
+{
+    return surfaceInputs_.getSurfaceFireOutputs();
+}
+
+TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum Surface::getTwoDimensionalSpreadMode() const
+{
+    return surfaceInputs_.getTwoDimensionalSpreadMode();
+}
+
 WindHeightInputMode::WindHeightInputModeEnum Surface::getWindHeightInputMode() const
 {
     return surfaceInputs_.getWindHeightInputMode();
@@ -735,6 +1404,11 @@ WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum
     return surfaceInputs_.getWindAdjustmentFactorCalculationMethod();
 }
 
+double Surface::getUserProvidedWindAdjustmentFactor() const
+{
+    return surfaceInputs_.getUserProvidedWindAdjustmentFactor();
+}
+
 bool Surface::getIsUsingPalmettoGallberry() const
 {
     return surfaceInputs_.getIsUsingPalmettoGallberry();
@@ -913,6 +1587,43 @@ double Surface::getWindSpeed(SpeedUnits::SpeedUnitsEnum windSpeedUnits,
     return SpeedUnits::fromBaseUnits(windSpeed, windSpeedUnits);
 }
 
+bool Surface::getSurfaceKernelInputsOnLevelGround(double windAdjustmentFactor, SurfaceKernelInputs& inputs) const
+{
+    if (surfaceInputs_.getMoistureInputMode() != MoistureInputMode::BySizeClass)
+    {
+        return false;
+    }
+    inputs.moistureOneHour = surfaceInputs_.getMoistureOneHour(FractionUnits::Fraction);
+    inputs.moistureTenHour = surfaceInputs_.getMoistureTenHour(FractionUnits::Fraction);
+    inputs.moistureHundredHour = surfaceInputs_.getMoistureHundredHour(FractionUnits::Fraction);
+    inputs.moistureLiveHerbaceous = surfaceInputs_.getMoistureLiveHerbaceous(FractionUnits::Fraction);
+    inputs.moistureLiveWoody = surfaceInputs_.getMoistureLiveWoody(FractionUnits::Fraction);
+
+    // As SurfaceFire::calculateMidflameWindSpeed() with a user provided wind adjustment factor
+    double windSpeed = surfaceInputs_.getWindSpeed(SpeedUnits::FeetPerMinute);
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode = surfaceInputs_.getWindHeightInputMode();
+    if (windHeightInputMode == WindHeightInputMode::DirectMidflame)
+    {
+        inputs.midflameWindSpeed = windSpeed;
+    }
+    else
+    {
+        if (windHeightInputMode == WindHeightInputMode::TenMeter)
+        {
+            windSpeed /= 1.15;
+        }
+        inputs.midflameWindSpeed = windAdjustmentFactor * windSpeed;
+    }
+    inputs.windDirection = 0.0;
+    inputs.slope = 0.0;
+    return true;
+}
+
+double Surface::getInputWindSpeed(SpeedUnits::SpeedUnitsEnum windSpeedUnits) const
+{
+    return surfaceInputs_.getWindSpeed(windSpeedUnits);
+}
+
 double Surface::getWindDirection() const
 {
     return surfaceInputs_.getWindDirection();
@@ -968,7 +1679,7 @@ void Surface::setMoistureLiveAggregate(double moistureLive, FractionUnits::Fract
     surfaceInputs_.setMoistureLiveAggregate(moistureLive, moistureUnits);
 }
 
-void Surface::setMoistureScenarios(MoistureScenarios& moistureScenarios)
+void Surface::setMoistureScenarios(const MoistureScenarios& moistureScenarios)
 {
     surfaceInputs_.setMoistureScenarios(moistureScenarios);
 }
@@ -1005,6 +1716,12 @@ void Surface::setWindSpeed(double windSpeed, SpeedUnits::SpeedUnitsEnum windSpee
     surfaceFire_.calculateMidflameWindSpeed();
 }
 
+void Surface::copyWindAndMoistureInputs(const Surface& rhs)
+{
+    surfaceInputs_.copyWindAndMoistureInputs(rhs.surfaceInputs_);
+    surfaceFire_.calculateMidflameWindSpeed();
+}
+
 void Surface::setUserProvidedWindAdjustmentFactor(double userProvidedWindAdjustmentFactor)
 {
     surfaceInputs_.setUserProvidedWindAdjustmentFactor(userProvidedWindAdjustmentFactor);
@@ -1020,6 +1737,16 @@ void Surface::setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::Wind
     surfaceInputs_.setWindAndSpreadOrientationMode(windAndSpreadOrientationMode);
 }
 
+void Surface::setSurfaceFireOutputs(int surfaceFireOutputs)
+{
+    surfaceInputs_.setSurfaceFireOutputs(surfaceFireOutputs);
+}
+
+void Surface::setTwoDimensionalSpreadMode(TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum twoDimensionalSpreadMode)
+{
+    surfaceInputs_.setTwoDimensionalSpreadMode(twoDimensionalSpreadMode);
+}
+
 void Surface::setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
 {
     surfaceInputs_.setWindHeightInputMode(windHeightInputMode);
@@ -1284,6 +2011,11 @@ bool Surface::getIsUsingChaparral() const
     return surfaceInputs_.getIsUsingChaparral();
 }
 
+ChaparralFuelLoadInputMode::ChaparralFuelInputLoadModeEnum Surface::getChaparralFuelLoadInputMode() const
+{
+    return surfaceInputs_.getChaparralFuelLoadInputMode();
+}
+
 void Surface::setAgeOfRough(double ageOfRough)
 {
     surfaceInputs_.setPalmettoGallberryAgeOfRough(ageOfRough);
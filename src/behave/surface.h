@@ -35,8 +35,83 @@
 // The SURFACE module of BehavePlus
 #include "behaveUnits.h"
 #include "fireSize.h"
+#include "outputUnitProfile.h"
 #include "surfaceFire.h"
 #include "surfaceInputs.h"
+#include "surfaceKernel.h"
+
+// Structure-of-arrays inputs for Surface::doSurfaceRunBatch(), each array holds numberOfCells values
+// in base units: moistures as fractions, wind speed in ft/min, slope in degrees, canopy height in ft.
+// Wind and aspect directions are in degrees, as for the single cell setters.
+struct SurfaceBatchInputs
+{
+    int numberOfCells;
+    const int* fuelModelNumber;
+    const double* moistureOneHour;
+    const double* moistureTenHour;
+    const double* moistureHundredHour;
+    const double* moistureLiveHerbaceous;
+    const double* moistureLiveWoody;
+    const double* windSpeed;
+    const double* windDirection;
+    const double* slope;
+    const double* aspect;
+    const double* canopyCover;
+    const double* canopyHeight;
+    const double* crownRatio;
+};
+
+// Order Surface::doSurfaceRunBatch() visits its cells in. GroupedByFuelbed runs cells with the same
+// fuel model and moistures back to back, then the same canopy, so that the fuelbed and wind adjustment
+// factor of a group are calculated once however the cells are ordered, such as RAWS rows by station
+// then time. Outputs are written at each cell's own index either way, the getters report the last cell run.
+struct SurfaceBatchOrderMode
+{
+    enum SurfaceBatchOrderModeEnum
+    {
+        InputOrder,
+        GroupedByFuelbed
+    };
+};
+
+// Caller-provided output arrays for Surface::doSurfaceRunBatch(), each sized for numberOfCells values
+// and filled in base units: spread rate in ft/min, fireline intensity in btu/ft/s, flame length in ft.
+// Any array may be null if that output is not needed. Outputs left out of the Surface's SurfaceFireOutputs
+// are not calculated and written as zero, or one for the length to width ratio.
+struct SurfaceBatchOutputs
+{
+    double* spreadRate;
+    double* firelineIntensity;
+    double* flameLength;
+    double* directionOfMaxSpread;
+    double* fireLengthToWidthRatio;
+};
+
+// Outputs of the last run filled by one Surface::getOutputs() call, in the units of its OutputUnitProfile.
+// Directions are in degrees and the ratios are unitless.
+struct SurfaceOutputValues
+{
+    double spreadRate;
+    double spreadRateInDirectionOfInterest;
+    double backingSpreadRate;
+    double flankingSpreadRate;
+    double directionOfMaxSpread;
+    double flameLength;
+    double flameLengthInDirectionOfInterest;
+    double backingFlameLength;
+    double flankingFlameLength;
+    double firelineIntensity;
+    double firelineIntensityInDirectionOfInterest;
+    double backingFirelineIntensity;
+    double flankingFirelineIntensity;
+    double heatPerUnitArea;
+    double reactionIntensity;
+    double residenceTime;
+    double midflameWindSpeed;
+    double fireLengthToWidthRatio;
+    double fireEccentricity;
+    double headingToBackingRatio;
+};
 
 class Surface
 {
@@ -46,16 +121,65 @@ public:
     Surface(const Surface& rhs);
     Surface& operator=(const Surface& rhs);
 
+    // Like assignment, but keeps this Surface's caches rather than copying rhs's
+    void copyStateWithoutCaches(const Surface& rhs);
+    bool hasSameInputs(const Surface& rhs) const;
+
     bool isAllFuelLoadZero(int fuelModelNumber);
     void doSurfaceRunInDirectionOfMaxSpread();
     void doSurfaceRunInDirectionOfInterest(double directionOfInterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode);
+    void doSurfaceRunBatch(const SurfaceBatchInputs& inputs, SurfaceBatchOutputs& outputs);
+    void doSurfaceRunBatchTwoFuelModels(const SurfaceBatchInputs& inputs, const int* secondFuelModelNumber,
+        const double* firstFuelModelCoverage, SurfaceBatchOutputs& outputs);
+    void doSurfaceRunBatchChaparral(const SurfaceBatchInputs& inputs, const ChaparralBatchInputs& chaparralInputs,
+        SurfaceBatchOutputs& outputs);
+    void doSurfaceRunInDirectionsOfInterest(const double* directionsOfInterest, int numberOfDirections,
+        SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode, double* spreadRates,
+        double* firelineIntensities, double* flameLengths);
+    void doSurfaceRunForFirstFuelModelCoverages(const double* firstFuelModelCoverages, int numberOfCoverages,
+        FractionUnits::FractionUnitsEnum coverageUnits, double* spreadRates, double* firelineIntensities, double* flameLengths);
+    void doSurfaceRunForFuelModels(const int* fuelModelNumbers, int numberOfFuelModels, SurfaceBatchOutputs& outputs);
+    double calculateSpreadRateAtTwentyFootWindSpeed(double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits,
+        SpeedUnits::SpeedUnitsEnum spreadRateUnits);
+    double calculateTwentyFootWindSpeedAtSpreadRate(double spreadRate, double initialWindSpeed);
 
     double calculateFlameLength(double firelineIntensity, FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits,
         LengthUnits::LengthUnitsEnum flameLengthUnits);
 
-    void setFuelModels(FuelModels& fuelModels);
+    void setFuelModels(const FuelModels& fuelModels);
     void initializeMembers();
 
+    // Fuelbed intermediates cache, reused while only wind, slope or direction inputs change
+    void setFuelbedCacheCapacity(int capacity);
+    void clearFuelbedCache();
+    int getFuelbedCacheNumberOfEntries() const;
+    long getFuelbedCacheNumberOfHits() const;
+    long getFuelbedCacheNumberOfMisses() const;
+
+    // Per fuel model results cache for two fuel models runs, reused while only the coverage or method change
+    void setTwoFuelModelsCacheCapacity(int capacity);
+    void clearTwoFuelModelsCache();
+    int getTwoFuelModelsCacheNumberOfEntries() const;
+    long getTwoFuelModelsCacheNumberOfHits() const;
+    long getTwoFuelModelsCacheNumberOfMisses() const;
+
+    // Cell order of doSurfaceRunBatch(), input order by default
+    void setBatchOrderMode(SurfaceBatchOrderMode::SurfaceBatchOrderModeEnum batchOrderMode);
+    SurfaceBatchOrderMode::SurfaceBatchOrderModeEnum getBatchOrderMode() const;
+
+    // Math kernels of the multi-direction sweep, exact by default
+    void setVectorMathMode(VectorMathMode::VectorMathModeEnum vectorMathMode);
+    VectorMathMode::VectorMathModeEnum getVectorMathMode() const;
+
+    // Wind adjustment factors are memoized on canopy cover and height, crown ratio and fuelbed depth
+    long getWindAdjustmentFactorMemoNumberOfHits() const;
+    long getWindAdjustmentFactorMemoNumberOfMisses() const;
+
+    // Fuelbed and wind adjustment factor cache shared with other workers' Surfaces, null for none.
+    // It must outlive this Surface and its copies, which share it too
+    void setSharedCache(SharedSurfaceCache* sharedCache);
+    SharedSurfaceCache* getSharedCache() const;
+
     // SurfaceFire getters
     double getSpreadRate(SpeedUnits::SpeedUnitsEnum spreadRateUnits) const;
     double getSpreadRateInDirectionOfInterest(SpeedUnits::SpeedUnitsEnum spreadRateUnits) const;
@@ -93,6 +217,11 @@ public:
     double getHeatSource(HeatSourceAndReactionIntensityUnits::HeatSourceAndReactionIntensityUnitsEnum heatSourceUnits) const;
     double getFirePerimeter(LengthUnits::LengthUnitsEnum lengthUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const;
     double getFireArea(AreaUnits::AreaUnitsEnum areaUnits, double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits) const;
+    void getFireSizeAtElapsedTimes(const double* elapsedTimes, int numberOfElapsedTimes, TimeUnits::TimeUnitsEnum timeUnits,
+        LengthUnits::LengthUnitsEnum lengthUnits, AreaUnits::AreaUnitsEnum areaUnits, FireSizeBatchOutputs& outputs) const;
+    // All of the outputs above in one call, converted by the profile's resolved factors
+    void getOutputs(const OutputUnitProfile& unitProfile, SurfaceOutputValues& outputs) const;
+
     double getCharacteristicMoistureByLifeState(FuelLifeState::FuelLifeStateEnum lifeState, FractionUnits::FractionUnitsEnum moistureUnits) const;
     double getLiveFuelMoistureOfExtinction(FractionUnits::FractionUnitsEnum moistureUnits) const;
     double getCharacteristicSAVR(SurfaceAreaToVolumeUnits::SurfaceAreaToVolumeUnitsEnum savrUnits) const;
@@ -114,7 +243,7 @@ public:
     void setMoistureLiveHerbaceous(double moistureLiveHerbaceous, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureLiveWoody(double moistureLiveWoody, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureLiveAggregate(double moistureLive, FractionUnits::FractionUnitsEnum moistureUnits);
-    void setMoistureScenarios(MoistureScenarios& moistureScenarios);
+    void setMoistureScenarios(const MoistureScenarios& moistureScenarios);
     bool setCurrentMoistureScenarioByName(std::string moistureScenarioName);
     bool setCurrentMoistureScenarioByIndex(int moistureScenarioIndex);
     void setMoistureInputMode(MoistureInputMode::MoistureInputModeEnum moistureInputMode);
@@ -124,12 +253,16 @@ public:
     void setUserProvidedWindAdjustmentFactor(double userProvidedWindAdjustmentFactor);
     void setWindDirection(double windDirection);
     void setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode);
+    void setSurfaceFireOutputs(int surfaceFireOutputs); // SurfaceFireOutputs flags, outputs left out read as zero
+    void setTwoDimensionalSpreadMode(TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum twoDimensionalSpreadMode);
     void setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode);
     void setFirstFuelModelNumber(int firstFuelModelNumber);
     void setSecondFuelModelNumber(int secondFuelModelNumber);
     void setTwoFuelModelsMethod(TwoFuelModelsMethod::TwoFuelModelsMethodEnum  twoFuelModelsMethod);
     void setTwoFuelModelsFirstFuelModelCoverage(double firstFuelModelCoverage, FractionUnits::FractionUnitsEnum coverageUnits);
     void setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod);
+    // Takes the wind speed and moistures of another Surface, leaving every other input as it is
+    void copyWindAndMoistureInputs(const Surface& rhs);
     void updateSurfaceInputs(int fuelModelNumber, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
         double moistureLiveHerbaceous, double moistureLiveWoody, FractionUnits::FractionUnitsEnum moistureUnits, double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits,
         WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode, double windDirection,
@@ -230,6 +363,12 @@ public:
     double getMoistureScenarioLiveHerbaceousByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits) const;
     double getMoistureScenarioLiveWoodyByIndex(int index, FractionUnits::FractionUnitsEnum moistureUnits) const;
     double getWindSpeed(SpeedUnits::SpeedUnitsEnum windSpeedUnits, WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode) const;
+    // The moistures and wind speed of the inputs as SurfaceKernelInputs on level ground with the wind blowing upslope,
+    // the midflame wind speed coming from a user provided wind adjustment factor. False unless the moistures are
+    // entered by size class, the only moistures SurfaceKernel takes.
+    bool getSurfaceKernelInputsOnLevelGround(double windAdjustmentFactor, SurfaceKernelInputs& inputs) const;
+    // The wind speed as entered, at the wind height input mode, where getWindSpeed() is derived from the last run
+    double getInputWindSpeed(SpeedUnits::SpeedUnitsEnum windSpeedUnits) const;
     double getWindDirection() const;
     double getSlope(SlopeUnits::SlopeUnitsEnum slopeUnits) const;
     double getAspect() const;
@@ -237,8 +376,11 @@ public:
     double getCanopyHeight(LengthUnits::LengthUnitsEnum canopyHeightUnits) const;
     double getCrownRatio(FractionUnits::FractionUnitsEnum crownRatioUnits) const;
     WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum getWindAndSpreadOrientationMode() const;
+    int getSurfaceFireOutputs() const;
+    TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum getTwoDimensionalSpreadMode() const;
     WindHeightInputMode::WindHeightInputModeEnum getWindHeightInputMode() const;
     WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum getWindAdjustmentFactorCalculationMethod() const;
+    double getUserProvidedWindAdjustmentFactor() const;
 
     // Palmetto-Gallberry getters
     bool getIsUsingPalmettoGallberry() const;
@@ -276,6 +418,7 @@ public:
 
     // Chaparral getters
     bool getIsUsingChaparral() const;
+    ChaparralFuelLoadInputMode::ChaparralFuelInputLoadModeEnum getChaparralFuelLoadInputMode() const;
     ChaparralFuelType::ChaparralFuelTypeEnum getChaparralFuelType() const;
     double getChaparralFuelBedDepth(LengthUnits::LengthUnitsEnum depthUnits) const;
     double getChaparralFuelDeadLoadFraction() const;
@@ -302,6 +445,7 @@ public:
 
 protected:
     void memberwiseCopyAssignment(const Surface& rhs);
+    void doSurfaceRunBatchCell(const SurfaceBatchInputs& inputs, int cell, bool isUsingSpecialFuel, SurfaceBatchOutputs& outputs);
     double calculateSpreadRateAtVector(double directionOfinterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode);
 
     const FuelModels* fuelModels_;
@@ -312,6 +456,8 @@ protected:
 
     // Size Module
     FireSize size_;
+
+    SurfaceBatchOrderMode::SurfaceBatchOrderModeEnum batchOrderMode_;
 };
 
 #endif // SURFACE_H
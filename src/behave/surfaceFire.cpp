@@ -32,15 +32,18 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 
+#include "sharedSurfaceCache.h"
 #include "surfaceFire.h"
 #include "surfaceFuelbedIntermediates.h"
 #include "surfaceInputs.h"
+#include "vectorMath.h"
 #include "windAdjustmentFactor.h"
 
 SurfaceFire::SurfaceFire()
     : surfaceFireReactionIntensity_()
 {
-
+    vectorMathMode_ = VectorMathMode::Exact;
+    sharedCache_ = nullptr;
 }
 
 SurfaceFire::SurfaceFire(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs,
@@ -51,6 +54,8 @@ SurfaceFire::SurfaceFire(const FuelModels& fuelModels, const SurfaceInputs& surf
     fuelModels_ = &fuelModels;
     size_ = &size;
     surfaceInputs_ = &surfaceInputs;
+    vectorMathMode_ = VectorMathMode::Exact;
+    sharedCache_ = nullptr;
     initializeMembers();
 }
 
@@ -71,6 +76,20 @@ SurfaceFire& SurfaceFire::operator=(const SurfaceFire& rhs)
 }
 
 void SurfaceFire::initializeMembers()
+{
+    initializeSpreadMembers();
+
+    surfaceFuelbedIntermediates_ = SurfaceFuelbedIntermediates(*fuelModels_, *surfaceInputs_);
+    surfaceFireReactionIntensity_ = SurfaceFireReactionIntensity(surfaceFuelbedIntermediates_);
+
+    fuelbedFuelModelNumber_ = -1;
+    fuelbedInputsRevision_ = 0;
+    fuelModelsRevision_ = 0;
+    windInputsRevision_ = 0;
+}
+
+// Resets everything but the fuelbed intermediates and reaction intensity
+void SurfaceFire::initializeSpreadMembers()
 {
     isWindLimitExceeded_ = false;
     effectiveWindSpeed_ = 0.0;
@@ -101,22 +120,31 @@ void SurfaceFire::initializeMembers()
     directionOfInterestFlameLength_ = 0.0;
     maxFlameLength_ = 0.0;
     scorchHeight_ = 0.0;
+    heatSource_ = 0.0;
 
     midflameWindSpeed_ = 0.0;
     windAdjustmentFactor_ = 0.0;
     windAdjustmentFactorShelterMethod_ = WindAdjustmentFactorShelterMethod::Unsheltered;
     canopyCrownFraction_ = 0.0;
-
-    surfaceFuelbedIntermediates_ = SurfaceFuelbedIntermediates(*fuelModels_, *surfaceInputs_);
-    surfaceFireReactionIntensity_ = SurfaceFireReactionIntensity(surfaceFuelbedIntermediates_);
 }
 
 void SurfaceFire::memberwiseCopyAssignment(const SurfaceFire& rhs)
+{
+    fuelbedCache_ = rhs.fuelbedCache_;
+    twoFuelModelsCache_ = rhs.twoFuelModelsCache_;
+    windAdjustmentFactorMemo_ = rhs.windAdjustmentFactorMemo_;
+    sharedCache_ = rhs.sharedCache_;
+    copyStateWithoutCaches(rhs);
+}
+
+void SurfaceFire::copyStateWithoutCaches(const SurfaceFire& rhs)
 {
     surfaceFireReactionIntensity_ = rhs.surfaceFireReactionIntensity_;
     surfaceFuelbedIntermediates_ = rhs.surfaceFuelbedIntermediates_;
+    vectorMathMode_ = rhs.vectorMathMode_;
 
     isWindLimitExceeded_ = rhs.isWindLimitExceeded_;
+    directionOfInterest_ = rhs.directionOfInterest_;
     effectiveWindSpeed_ = rhs.effectiveWindSpeed_;
     windSpeedLimit_ = rhs.windSpeedLimit_;
     phiS_ = rhs.phiS_;
@@ -143,6 +171,7 @@ void SurfaceFire::memberwiseCopyAssignment(const SurfaceFire& rhs)
     backingFlameLength_ = rhs.backingFlameLength_;
     flankingFlameLength_ = rhs.flankingFlameLength_;
     directionOfInterestFlameLength_ = rhs.directionOfInterestFlameLength_;
+    heatSource_ = rhs.heatSource_;
     maxFlameLength_ = rhs.maxFlameLength_;
     scorchHeight_ = rhs.scorchHeight_;
 
@@ -150,6 +179,11 @@ void SurfaceFire::memberwiseCopyAssignment(const SurfaceFire& rhs)
     windAdjustmentFactor_ = rhs.windAdjustmentFactor_;
     windAdjustmentFactorShelterMethod_ = rhs.windAdjustmentFactorShelterMethod_;
     canopyCrownFraction_ = rhs.canopyCrownFraction_;
+
+    fuelbedFuelModelNumber_ = rhs.fuelbedFuelModelNumber_;
+    fuelbedInputsRevision_ = rhs.fuelbedInputsRevision_;
+    fuelModelsRevision_ = rhs.fuelModelsRevision_;
+    windInputsRevision_ = rhs.windInputsRevision_;
 }
 
 double SurfaceFire::calculateNoWindNoSlopeSpreadRate(double reactionIntensity, double propagatingFlux, double heatSink)
@@ -177,6 +211,125 @@ double SurfaceFire::calculateFirelineIntensity(double spreadRate,
     return FirelineIntensityUnits::fromBaseUnits(firelineIntensity, firelineIntensityUnits);
 }
 
+// Evaluates the fire ellipse of the last forward spread rate calculation at several directions of interest.
+// Everything that does not depend on the direction is hoisted out of the loops, which have no branches on
+// the data so the compiler can vectorize them. Outputs are in ft/min, Btu/ft/s and ft, null output arrays
+// are skipped.
+void SurfaceFire::calculateSpreadRatesAtVectors(const double* directionsOfInterest, int numberOfDirections,
+    SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode, double* spreadRates,
+    double* firelineIntensities, double* flameLengths) const
+{
+    // Later outputs are derived from earlier ones, so when an earlier output is not wanted
+    // it is computed in place in the array of the next output that is
+    double* intensities = (firelineIntensities != nullptr) ? firelineIntensities : flameLengths;
+    double* rates = (spreadRates != nullptr) ? spreadRates : intensities;
+    if (rates == nullptr)
+    {
+        return;
+    }
+
+    if (!forwardSpreadRate_)
+    {
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            rates[i] = forwardSpreadRate_;
+        }
+    }
+    else
+    {
+        const double eccentricity = size_->getEccentricity();
+        const double directionOfMaxSpread = directionOfMaxSpread_;
+        const double forwardSpreadRate = forwardSpreadRate_;
+        const double L = forwardSpreadRate_ + backingSpreadRate_;
+        const double f = L / 2.0;
+        const double g = forwardSpreadRate_ - f;
+        const double h = size_->getFlankingSpreadRate(SpeedUnits::FeetPerMinute);
+
+        if (vectorMathMode_ == VectorMathMode::Fast)
+        {
+            // Angles from the direction of max spread, then their cosines in place
+            for (int i = 0; i < numberOfDirections; i++)
+            {
+                double directionOfInterest = directionsOfInterest[i] - 360.0 * floor(directionsOfInterest[i] / 360.0);
+                double beta = fabs(directionOfMaxSpread - directionOfInterest);
+                beta = (beta > 180.0) ? (360.0 - beta) : beta;
+                rates[i] = beta * M_PI / 180.0;
+            }
+            VectorMath::cos(rates, rates, numberOfDirections, VectorMathMode::Fast);
+            for (int i = 0; i < numberOfDirections; i++)
+            {
+                double cosBeta = rates[i];
+                if (directionMode == SurfaceFireSpreadDirectionMode::FromIgnitionPoint)
+                {
+                    rates[i] = forwardSpreadRate * (1.0 - eccentricity) / (1.0 - eccentricity * cosBeta);
+                }
+                else
+                {
+                    double sinBetaSquared = (1.0 - cosBeta) * (1.0 + cosBeta);
+                    rates[i] = (g * cosBeta) + sqrt((f * f * cosBeta * cosBeta) + (h * h * sinBetaSquared));
+                }
+            }
+        }
+        else if (directionMode == SurfaceFireSpreadDirectionMode::FromIgnitionPoint)
+        {
+            for (int i = 0; i < numberOfDirections; i++)
+            {
+                // Constrain direction of interest to range of [0, 360) degrees
+                double directionOfInterest = directionsOfInterest[i] - 360.0 * floor(directionsOfInterest[i] / 360.0);
+                double beta = fabs(directionOfMaxSpread - directionOfInterest);
+                beta = (beta > 180.0) ? (360.0 - beta) : beta;
+                double radians = beta * M_PI / 180.0;
+                rates[i] = forwardSpreadRate * (1.0 - eccentricity) / (1.0 - eccentricity * cos(radians));
+            }
+        }
+        else
+        {
+            for (int i = 0; i < numberOfDirections; i++)
+            {
+                double directionOfInterest = directionsOfInterest[i] - 360.0 * floor(directionsOfInterest[i] / 360.0);
+                double beta = fabs(directionOfMaxSpread - directionOfInterest);
+                beta = (beta > 180.0) ? (360.0 - beta) : beta;
+                double radians = beta * M_PI / 180.0;
+                double cosBeta = cos(radians);
+                double sinBeta = sin(radians);
+                // Catchpole et al. (1982), see calculateSpreadRateAtVector()
+                rates[i] = (g * cosBeta) + sqrt((f * f * cosBeta * cosBeta) + (h * h * sinBeta * sinBeta));
+            }
+        }
+    }
+
+    if (intensities != nullptr)
+    {
+        const double secondsPerMinute = 60.0;
+        const double reactionIntensity = reactionIntensity_;
+        const double residenceTimeFactor = residenceTime_ / secondsPerMinute;
+        for (int i = 0; i < numberOfDirections; i++)
+        {
+            intensities[i] = rates[i] * reactionIntensity * residenceTimeFactor;
+        }
+    }
+
+    if (flameLengths != nullptr)
+    {
+        if (vectorMathMode_ == VectorMathMode::Fast)
+        {
+            VectorMath::pow(intensities, 0.46, flameLengths, numberOfDirections, VectorMathMode::Fast);
+            for (int i = 0; i < numberOfDirections; i++)
+            {
+                flameLengths[i] = (intensities[i] < 1.0e-07) ? (0.0) : (0.45 * flameLengths[i]);
+            }
+        }
+        else
+        {
+            for (int i = 0; i < numberOfDirections; i++)
+            {
+                // Byram 1959, Albini 1976
+                flameLengths[i] = (intensities[i] < 1.0e-07) ? (0.0) : (0.45 * pow(intensities[i], 0.46));
+            }
+        }
+    }
+}
+
 void SurfaceFire::calculateFirelineIntensities()
 {
     forwardFirelineIntensity_ = calculateFirelineIntensity(forwardSpreadRate_,
@@ -201,6 +354,88 @@ void SurfaceFire::skipCalculationForZeroLoad()
     initializeMembers();
 }
 
+void SurfaceFire::setFuelbedCacheCapacity(int capacity)
+{
+    fuelbedCache_.setCapacity(capacity);
+}
+
+void SurfaceFire::clearFuelbedCache()
+{
+    fuelbedCache_.clear();
+    fuelbedCache_.resetCounters();
+}
+
+int SurfaceFire::getFuelbedCacheNumberOfEntries() const
+{
+    return fuelbedCache_.getNumberOfEntries();
+}
+
+long SurfaceFire::getFuelbedCacheNumberOfHits() const
+{
+    return fuelbedCache_.getNumberOfHits();
+}
+
+long SurfaceFire::getFuelbedCacheNumberOfMisses() const
+{
+    return fuelbedCache_.getNumberOfMisses();
+}
+
+void SurfaceFire::setTwoFuelModelsCacheCapacity(int capacity)
+{
+    twoFuelModelsCache_.setCapacity(capacity);
+}
+
+void SurfaceFire::clearTwoFuelModelsCache()
+{
+    twoFuelModelsCache_.clear();
+    twoFuelModelsCache_.resetCounters();
+}
+
+int SurfaceFire::getTwoFuelModelsCacheNumberOfEntries() const
+{
+    return twoFuelModelsCache_.getNumberOfEntries();
+}
+
+long SurfaceFire::getTwoFuelModelsCacheNumberOfHits() const
+{
+    return twoFuelModelsCache_.getNumberOfHits();
+}
+
+long SurfaceFire::getTwoFuelModelsCacheNumberOfMisses() const
+{
+    return twoFuelModelsCache_.getNumberOfMisses();
+}
+
+void SurfaceFire::setVectorMathMode(VectorMathMode::VectorMathModeEnum vectorMathMode)
+{
+    vectorMathMode_ = vectorMathMode;
+}
+
+VectorMathMode::VectorMathModeEnum SurfaceFire::getVectorMathMode() const
+{
+    return vectorMathMode_;
+}
+
+long SurfaceFire::getWindAdjustmentFactorMemoNumberOfHits() const
+{
+    return windAdjustmentFactorMemo_.getNumberOfHits();
+}
+
+long SurfaceFire::getWindAdjustmentFactorMemoNumberOfMisses() const
+{
+    return windAdjustmentFactorMemo_.getNumberOfMisses();
+}
+
+void SurfaceFire::setSharedCache(SharedSurfaceCache* sharedCache)
+{
+    sharedCache_ = sharedCache;
+}
+
+SharedSurfaceCache* SurfaceFire::getSharedCache() const
+{
+    return sharedCache_;
+}
+
 double SurfaceFire::calculateFlameLength(double firelineIntensity,
                                          FirelineIntensityUnits::FirelineIntensityUnitsEnum firelineIntensityUnits,
                                          LengthUnits::LengthUnitsEnum flameLengthUnits)
@@ -248,20 +483,91 @@ void SurfaceFire::calculateScorchHeight()
 
 double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDirectionOfInterest, double directionOfInterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode)
 {
-    // Reset member variables to prepare for next calculation
-    initializeMembers();
+    // The fuelbed intermediates and reaction intensity of the last run are still valid if neither the fuel model
+    // nor any of the inputs they depend on have changed since, and the wind factor if the wind inputs have not either
+    unsigned long fuelbedInputsRevision = surfaceInputs_->getFuelbedInputsRevision();
+    unsigned long fuelModelsRevision = fuelModels_->getRevision();
+    unsigned long windInputsRevision = surfaceInputs_->getWindInputsRevision();
+    bool isReusingFuelbed = (fuelModelNumber == fuelbedFuelModelNumber_) && (fuelbedInputsRevision == fuelbedInputsRevision_) &&
+        (fuelModelsRevision == fuelModelsRevision_);
+    bool isReusingWindFactor = isReusingFuelbed && (windInputsRevision == windInputsRevision_);
+
+    double midflameWindSpeed = midflameWindSpeed_;
+    double windAdjustmentFactor = windAdjustmentFactor_;
+    WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum windAdjustmentFactorShelterMethod = windAdjustmentFactorShelterMethod_;
+    double windB = windB_;
+    double windC = windC_;
+    double windE = windE_;
+    double phiW = phiW_;
 
-    // Calculate fuelbed intermediates
-    surfaceFuelbedIntermediates_.calculateFuelbedIntermediates(fuelModelNumber);
+    // Reset member variables to prepare for next calculation
+    if (isReusingFuelbed)
+    {
+        initializeSpreadMembers();
+        reactionIntensity_ = surfaceFireReactionIntensity_.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
+    }
+    else
+    {
+        initializeMembers();
+
+        // Calculate fuelbed intermediates and reaction intensity, or take them from this Surface's cache
+        // and then the shared one
+        bool isFuelbedCacheable = fuelbedCache_.isCacheable(*fuelModels_, *surfaceInputs_, fuelModelNumber);
+        bool isFuelbedShared = sharedCache_ && (sharedCache_->getCapacity() > 0) &&
+            SurfaceFuelbedCache::isStandardFuelbed(*fuelModels_, *surfaceInputs_, fuelModelNumber);
+        if (isFuelbedCacheable && fuelbedCache_.find(*surfaceInputs_, fuelModelNumber, surfaceFuelbedIntermediates_, surfaceFireReactionIntensity_))
+        {
+            reactionIntensity_ = surfaceFireReactionIntensity_.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
+        }
+        else if (isFuelbedShared && sharedCache_->findFuelbed(SurfaceFuelbedCache::makeKey(*surfaceInputs_, fuelModelNumber),
+            surfaceFuelbedIntermediates_, surfaceFireReactionIntensity_))
+        {
+            reactionIntensity_ = surfaceFireReactionIntensity_.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
+            if (isFuelbedCacheable)
+            {
+                fuelbedCache_.insert(*surfaceInputs_, fuelModelNumber, surfaceFuelbedIntermediates_, surfaceFireReactionIntensity_);
+            }
+        }
+        else
+        {
+            surfaceFuelbedIntermediates_.calculateFuelbedIntermediates(fuelModelNumber);
+            reactionIntensity_ = surfaceFireReactionIntensity_.calculateReactionIntensity();
+            if (isFuelbedCacheable)
+            {
+                fuelbedCache_.insert(*surfaceInputs_, fuelModelNumber, surfaceFuelbedIntermediates_, surfaceFireReactionIntensity_);
+            }
+            if (isFuelbedShared)
+            {
+                sharedCache_->insertFuelbed(SurfaceFuelbedCache::makeKey(*surfaceInputs_, fuelModelNumber),
+                    surfaceFuelbedIntermediates_, surfaceFireReactionIntensity_);
+            }
+        }
+        fuelbedFuelModelNumber_ = fuelModelNumber;
+        fuelbedInputsRevision_ = fuelbedInputsRevision;
+        fuelModelsRevision_ = fuelModelsRevision;
+    }
 
     // Get needed fuelbed intermediates
     double propagatingFlux = surfaceFuelbedIntermediates_.getPropagatingFlux();
     double heatSink = surfaceFuelbedIntermediates_.getHeatSink();
-    reactionIntensity_ = surfaceFireReactionIntensity_.calculateReactionIntensity();
 
     // Calculate Wind and Slope Factors
-    calculateMidflameWindSpeed();
-    calculateWindFactor();
+    if (isReusingWindFactor)
+    {
+        midflameWindSpeed_ = midflameWindSpeed;
+        windAdjustmentFactor_ = windAdjustmentFactor;
+        windAdjustmentFactorShelterMethod_ = windAdjustmentFactorShelterMethod;
+        windB_ = windB;
+        windC_ = windC;
+        windE_ = windE;
+        phiW_ = phiW;
+    }
+    else
+    {
+        calculateMidflameWindSpeed();
+        calculateWindFactor();
+        windInputsRevision_ = windInputsRevision;
+    }
     calculateSlopeFactor();
 
     // No-wind no-slope spread rate and parameters
@@ -285,13 +591,36 @@ double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDire
     effectiveWindSpeed_ = SpeedUnits::fromBaseUnits(effectiveWindSpeed_, SpeedUnits::FeetPerMinute);
     calculateResidenceTime();
 
+    // Only the outputs that were asked for are calculated past this point, the others keep the zeros
+    // they were reset to, and without the fire shape the fire size is cleared to a point. The western aspen
+    // mortality needs the forward flame length and the two dimensional two fuel models method the
+    // length to width ratio
+    bool isUsingWesternAspen = surfaceInputs_->getIsUsingWesternAspen();
+    int surfaceFireOutputs = surfaceInputs_->getSurfaceFireOutputs();
+    bool isCalculatingFlameLength = isUsingWesternAspen || (surfaceFireOutputs & SurfaceFireOutputs::FlameLength);
+    bool isCalculatingFirelineIntensity = isCalculatingFlameLength || (surfaceFireOutputs & SurfaceFireOutputs::FirelineIntensity);
+    bool isCalculatingFireShape = hasDirectionOfInterest || (surfaceFireOutputs & SurfaceFireOutputs::FireShape) ||
+        (surfaceInputs_->getTwoFuelModelsMethod() == TwoFuelModelsMethod::TwoDimensional); // weights with the ratio
+
     // Calculate fire ellipse and related properties
-    size_->calculateFireBasicDimensions(false, effectiveWindSpeed_, SpeedUnits::FeetPerMinute, forwardSpreadRate_, SpeedUnits::FeetPerMinute);
+    if (isCalculatingFireShape)
+    {
+        size_->calculateFireBasicDimensions(false, effectiveWindSpeed_, SpeedUnits::FeetPerMinute, forwardSpreadRate_, SpeedUnits::FeetPerMinute);
+
+        fireLengthToWidthRatio_ = size_->getFireLengthToWidthRatio();
+
+        backingSpreadRate_ = size_->getBackingSpreadRate(SpeedUnits::FeetPerMinute);
+        flankingSpreadRate_ = size_->getFlankingSpreadRate(SpeedUnits::FeetPerMinute);
+    }
+    else
+    {
+        size_->calculateFireBasicDimensions(false, 0.0, SpeedUnits::FeetPerMinute, 0.0, SpeedUnits::FeetPerMinute);
 
-    fireLengthToWidthRatio_ = size_->getFireLengthToWidthRatio();
+        fireLengthToWidthRatio_ = 1.0;
 
-    backingSpreadRate_ = size_->getBackingSpreadRate(SpeedUnits::FeetPerMinute);
-    flankingSpreadRate_ = size_->getFlankingSpreadRate(SpeedUnits::FeetPerMinute);
+        backingSpreadRate_ = 0.0;
+        flankingSpreadRate_ = 0.0;
+    }
 
     if (hasDirectionOfInterest) // If needed, calculate spread rate in arbitrary direction of interest
     {
@@ -302,18 +631,29 @@ double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDire
         spreadRateInDirectionOfInterest_ = forwardSpreadRate_;
     }
 
-    calculateHeatPerUnitArea();
-    calculateFirelineIntensities();
-    calculateFlameLengths();
+    if (surfaceFireOutputs & SurfaceFireOutputs::HeatPerUnitArea)
+    {
+        calculateHeatPerUnitArea();
+    }
+    if (isCalculatingFirelineIntensity)
+    {
+        calculateFirelineIntensities();
+    }
+    if (isCalculatingFlameLength)
+    {
+        calculateFlameLengths();
+    }
 
-    bool isUsingWesternAspen = surfaceInputs_->getIsUsingWesternAspen();
     if (isUsingWesternAspen)
     {
         surfaceFuelbedIntermediates_.calculateWesternAspenMortality(forwardFlameLength_);
     }
 
     maxFlameLength_ = forwardFlameLength_; // Used by SAFETY Module
-    calculateHeatSource();
+    if (surfaceFireOutputs & SurfaceFireOutputs::HeatPerUnitArea)
+    {
+        calculateHeatSource();
+    }
 
     if (hasDirectionOfInterest)
     {
@@ -325,6 +665,86 @@ double SurfaceFire::calculateForwardSpreadRate(int fuelModelNumber, bool hasDire
     }
 }
 
+// Forward spread rate the last calculation would have given with a different midflame wind speed.
+// The fuelbed, slope factor and wind speed limit do not depend on the wind speed, so only the wind factor,
+// the vector composition and the wind speed limit check of calculateForwardSpreadRate() are repeated,
+// term for term, without changing any member.
+double SurfaceFire::calculateForwardSpreadRateAtMidflameWindSpeed(double midflameWindSpeed) const
+{
+    const FuelModels::StaticFuelbedConstants* staticConstants = surfaceFuelbedIntermediates_.getStaticFuelbedConstants();
+    double relativePackingRatio = surfaceFuelbedIntermediates_.getRelativePackingRatio();
+    double relativePackingRatioFactor = (staticConstants)
+        ? (staticConstants->windRelativePackingRatioFactor_)
+        : (pow(relativePackingRatio, -windE_));
+
+    double phiW = (midflameWindSpeed < 1.0e-07)
+        ? (0.0)
+        : (pow(midflameWindSpeed, windB_) * windC_ * relativePackingRatioFactor);
+
+    double correctedWindDirection = surfaceInputs_->getWindDirection();
+    if (surfaceInputs_->getWindAndSpreadOrientationMode() == WindAndSpreadOrientationMode::RelativeToNorth)
+    {
+        correctedWindDirection -= surfaceInputs_->getAspect();
+    }
+    double windDirRadians = correctedWindDirection * M_PI / 180.0;
+
+    double slopeRate = noWindNoSlopeSpreadRate_ * phiS_;
+    double windRate = noWindNoSlopeSpreadRate_ * phiW;
+    double x = slopeRate + (windRate * cos(windDirRadians));
+    double y = windRate * sin(windDirRadians);
+    double forwardSpreadRate = noWindNoSlopeSpreadRate_ + sqrt((x * x) + (y * y));
+
+    double phiEffectiveWind = forwardSpreadRate / noWindNoSlopeSpreadRate_ - 1.0;
+    double effectiveWindSpeed = pow(((phiEffectiveWind * pow(relativePackingRatio, windE_)) / windC_), 1.0 / windB_);
+    if (effectiveWindSpeed > windSpeedLimit_)
+    {
+        double phiEffectiveWindAtLimit = windC_ * pow(windSpeedLimit_, windB_) * relativePackingRatioFactor;
+        forwardSpreadRate = noWindNoSlopeSpreadRate_ * (1 + phiEffectiveWindAtLimit);
+    }
+    return forwardSpreadRate;
+}
+
+// Inverse of calculateForwardSpreadRateAtMidflameWindSpeed(), the lowest midflame wind speed (ft/min) at which
+// the last calculation would spread at forwardSpreadRate (ft/min). When the wind blows upslope or there is no
+// slope the wind and slope factors add, so the wind factor of calculateWindFactor() is inverted in closed
+// form, and a spread rate above the one at the wind speed limit is never reached and gives HUGE_VAL. Returns
+// false for any other wind direction, where the caller has to search for the wind speed.
+bool SurfaceFire::calculateMidflameWindSpeedAtForwardSpreadRate(double forwardSpreadRate, double& midflameWindSpeed) const
+{
+    double correctedWindDirection = surfaceInputs_->getWindDirection();
+    if (surfaceInputs_->getWindAndSpreadOrientationMode() == WindAndSpreadOrientationMode::RelativeToNorth)
+    {
+        correctedWindDirection -= surfaceInputs_->getAspect();
+    }
+    if (phiS_ > 0.0 && fabs(remainder(correctedWindDirection, 360.0)) > 1.0e-07)
+    {
+        return false;
+    }
+
+    if (noWindNoSlopeSpreadRate_ < 1.0e-07)
+    {
+        midflameWindSpeed = (forwardSpreadRate > 0.0) ? HUGE_VAL : 0.0;
+        return true;
+    }
+
+    const FuelModels::StaticFuelbedConstants* staticConstants = surfaceFuelbedIntermediates_.getStaticFuelbedConstants();
+    double relativePackingRatioFactor = (staticConstants)
+        ? (staticConstants->windRelativePackingRatioFactor_)
+        : (pow(surfaceFuelbedIntermediates_.getRelativePackingRatio(), -windE_));
+    double phiEffectiveWindAtLimit = windC_ * pow(windSpeedLimit_, windB_) * relativePackingRatioFactor;
+    if (forwardSpreadRate > noWindNoSlopeSpreadRate_ * (1 + phiEffectiveWindAtLimit))
+    {
+        midflameWindSpeed = HUGE_VAL;
+        return true;
+    }
+
+    double phiW = forwardSpreadRate / noWindNoSlopeSpreadRate_ - 1.0 - phiS_;
+    midflameWindSpeed = (phiW <= 0.0)
+        ? (0.0)
+        : (pow(phiW / (windC_ * relativePackingRatioFactor), 1.0 / windB_));
+    return true;
+}
+
 double SurfaceFire::calculateSpreadRateAtVector(double directionOfInterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode)
 {
     // Constrain direction of interest to range of [0, 359] degrees
@@ -385,8 +805,12 @@ void SurfaceFire::applyWindSpeedLimit()
     isWindLimitExceeded_ = true;
     effectiveWindSpeed_ = windSpeedLimit_;
 
+    const FuelModels::StaticFuelbedConstants* staticConstants = surfaceFuelbedIntermediates_.getStaticFuelbedConstants();
     double relativePackingRatio = surfaceFuelbedIntermediates_.getRelativePackingRatio();
-    double phiEffectiveWind = windC_ * pow(windSpeedLimit_, windB_) * pow(relativePackingRatio, -windE_);
+    double relativePackingRatioFactor = (staticConstants)
+        ? (staticConstants->windRelativePackingRatioFactor_)
+        : (pow(relativePackingRatio, -windE_));
+    double phiEffectiveWind = windC_ * pow(windSpeedLimit_, windB_) * relativePackingRatioFactor;
     forwardSpreadRate_ = noWindNoSlopeSpreadRate_ * (1 + phiEffectiveWind);
 }
 
@@ -478,10 +902,23 @@ void SurfaceFire::calculateWindFactor()
 {
     double sigma = surfaceFuelbedIntermediates_.getSigma();
     double relativePackingRatio = surfaceFuelbedIntermediates_.getRelativePackingRatio();
+    double relativePackingRatioFactor = 0.0;
 
-    windC_ = 7.47 * exp(-0.133 * pow(sigma, 0.55));
-    windB_ = 0.02526 * pow(sigma, 0.54);
-    windE_ = 0.715 * exp(-0.000359*sigma);
+    const FuelModels::StaticFuelbedConstants* staticConstants = surfaceFuelbedIntermediates_.getStaticFuelbedConstants();
+    if (staticConstants)
+    {
+        windC_ = staticConstants->windC_;
+        windB_ = staticConstants->windB_;
+        windE_ = staticConstants->windE_;
+        relativePackingRatioFactor = staticConstants->windRelativePackingRatioFactor_;
+    }
+    else
+    {
+        windC_ = 7.47 * exp(-0.133 * pow(sigma, 0.55));
+        windB_ = 0.02526 * pow(sigma, 0.54);
+        windE_ = 0.715 * exp(-0.000359*sigma);
+        relativePackingRatioFactor = pow(relativePackingRatio, -windE_);
+    }
 
     // midflameWindSpeed is in ft/min
     if (midflameWindSpeed_ < 1.0e-07)
@@ -490,7 +927,7 @@ void SurfaceFire::calculateWindFactor()
     }
     else
     {
-        phiW_ = pow(midflameWindSpeed_, windB_) * windC_ * pow(relativePackingRatio, -windE_);
+        phiW_ = pow(midflameWindSpeed_, windB_) * windC_ * relativePackingRatioFactor;
     }
 }
 
@@ -505,6 +942,22 @@ void SurfaceFire::calculateWindAdjustmentFactor()
 
     WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod =
         surfaceInputs_->getWindAdjustmentFactorCalculationMethod();
+    bool isUsingCrownRatio = (windAdjustmentFactorCalculationMethod == WindAdjustmentFactorCalculationMethod::UseCrownRatio);
+    bool isMemoized = isUsingCrownRatio || (windAdjustmentFactorCalculationMethod == WindAdjustmentFactorCalculationMethod::DontUseCrownRatio);
+    double memoCrownRatio = isUsingCrownRatio ? crownRatio : 0.0; // not used without it, so all crown ratios share an entry
+    if (isMemoized && windAdjustmentFactorMemo_.find(isUsingCrownRatio, canopyCover, canopyHeight, memoCrownRatio, fuelbedDepth,
+        windAdjustmentFactor_, windAdjustmentFactorShelterMethod_))
+    {
+        return;
+    }
+    if (isMemoized && sharedCache_ && sharedCache_->findWindAdjustmentFactor(isUsingCrownRatio, canopyCover, canopyHeight, memoCrownRatio,
+        fuelbedDepth, windAdjustmentFactor_, windAdjustmentFactorShelterMethod_))
+    {
+        windAdjustmentFactorMemo_.insert(isUsingCrownRatio, canopyCover, canopyHeight, memoCrownRatio, fuelbedDepth,
+            windAdjustmentFactor_, windAdjustmentFactorShelterMethod_);
+        return;
+    }
+
     if(windAdjustmentFactorCalculationMethod == WindAdjustmentFactorCalculationMethod::UseCrownRatio)
     {
         windAdjustmentFactor_ = windAdjustmentFactor.calculateWindAdjustmentFactorWithCrownRatio(canopyCover, canopyHeight, crownRatio, fuelbedDepth);
@@ -514,6 +967,17 @@ void SurfaceFire::calculateWindAdjustmentFactor()
         windAdjustmentFactor_ = windAdjustmentFactor.calculateWindAdjustmentFactorWithoutCrownRatio(canopyCover, canopyHeight, fuelbedDepth);
     }
     windAdjustmentFactorShelterMethod_ = windAdjustmentFactor.getWindAdjustmentFactorShelterMethod();
+
+    if (isMemoized)
+    {
+        windAdjustmentFactorMemo_.insert(isUsingCrownRatio, canopyCover, canopyHeight, memoCrownRatio, fuelbedDepth,
+            windAdjustmentFactor_, windAdjustmentFactorShelterMethod_);
+        if (sharedCache_)
+        {
+            sharedCache_->insertWindAdjustmentFactor(isUsingCrownRatio, canopyCover, canopyHeight, memoCrownRatio, fuelbedDepth,
+                windAdjustmentFactor_, windAdjustmentFactorShelterMethod_);
+        }
+    }
 }
 
 void SurfaceFire::calculateMidflameWindSpeed()
@@ -549,10 +1013,14 @@ void SurfaceFire::calculateMidflameWindSpeed()
 void SurfaceFire::calculateSlopeFactor()
 {
     double packingRatio = surfaceFuelbedIntermediates_.getPackingRatio();
+    const FuelModels::StaticFuelbedConstants* staticConstants = surfaceFuelbedIntermediates_.getStaticFuelbedConstants();
+    double packingRatioFactor = (staticConstants)
+        ? (staticConstants->slopePackingRatioFactor_)
+        : (5.275 * pow(packingRatio, -0.3));
     // Slope factor
     double slope = surfaceInputs_->getSlope(SlopeUnits::Degrees);
     double slopex = tan((double)slope / 180.0 * M_PI); // convert from degrees to tan
-    phiS_ = 5.275 * pow(packingRatio, -0.3) * (slopex * slopex);
+    phiS_ = packingRatioFactor * (slopex * slopex);
 }
 
 void SurfaceFire::calculateHeatSource()
@@ -986,10 +1454,12 @@ void SurfaceFire::setIsWindLimitExceeded(bool isWindLimitExceeded)
 
 void SurfaceFire::setWindAdjustmentFactor(double windAdjustmentFactor)
 {
+    windInputsRevision_ = 0; // The stored wind factor no longer matches, so the next run recalculates it
     windAdjustmentFactor_ = windAdjustmentFactor;
 }
 
 void SurfaceFire::setMidflameWindSpeed(double midflameWindSpeed)
 {
+    windInputsRevision_ = 0;
     midflameWindSpeed_ = midflameWindSpeed;
 }
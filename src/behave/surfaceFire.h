@@ -34,7 +34,13 @@
 
 #include "fireSize.h"
 #include "surfaceFireReactionIntensity.h"
+#include "surfaceFuelbedCache.h"
+#include "surfaceTwoFuelModelsCache.h"
 #include "surfaceFuelbedIntermediates.h"
+#include "vectorMath.h"
+#include "windAdjustmentFactor.h"
+
+class SharedSurfaceCache;
 
 class SurfaceFire
 {
@@ -45,14 +51,49 @@ public:
     SurfaceFire& operator=(const SurfaceFire& rhs);
     SurfaceFire(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs, FireSize& size);
     void initializeMembers();
+    // Copies everything but the fuelbed and two fuel models caches and the wind adjustment factor memo,
+    // which stay valid for any inputs as they are keyed by them
+    void copyStateWithoutCaches(const SurfaceFire& rhs);
 
     double calculateNoWindNoSlopeSpreadRate(double reactionIntensity, double propagatingFlux, double heatSink);
     double calculateForwardSpreadRate(int fuelModelNumber, bool hasDirectionOfInterest,
         double directionOfInterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode);
     double calculateSpreadRateAtVector(double directionOfInterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode);
+    double calculateForwardSpreadRateAtMidflameWindSpeed(double midflameWindSpeed) const;
+    bool calculateMidflameWindSpeedAtForwardSpreadRate(double forwardSpreadRate, double& midflameWindSpeed) const;
+    void calculateSpreadRatesAtVectors(const double* directionsOfInterest, int numberOfDirections,
+        SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode, double* spreadRates,
+        double* firelineIntensities, double* flameLengths) const;
     void calculateMidflameWindSpeed();
     void skipCalculationForZeroLoad();
 
+    // Fuelbed cache, off until given a capacity
+    void setFuelbedCacheCapacity(int capacity);
+    void clearFuelbedCache();
+    int getFuelbedCacheNumberOfEntries() const;
+    long getFuelbedCacheNumberOfHits() const;
+    long getFuelbedCacheNumberOfMisses() const;
+
+    // Two fuel models per fuel model results cache, off until given a capacity
+    void setTwoFuelModelsCacheCapacity(int capacity);
+    void clearTwoFuelModelsCache();
+    int getTwoFuelModelsCacheNumberOfEntries() const;
+    long getTwoFuelModelsCacheNumberOfHits() const;
+    long getTwoFuelModelsCacheNumberOfMisses() const;
+
+    // Math kernels of the array calculations, Exact until set
+    void setVectorMathMode(VectorMathMode::VectorMathModeEnum vectorMathMode);
+    VectorMathMode::VectorMathModeEnum getVectorMathMode() const;
+
+    // Wind adjustment factor memo, always on
+    long getWindAdjustmentFactorMemoNumberOfHits() const;
+    long getWindAdjustmentFactorMemoNumberOfMisses() const;
+
+    // Cache shared with other workers, looked up when the fuelbed cache or wind adjustment factor
+    // memo misses, null for none. Copies share it too
+    void setSharedCache(SharedSurfaceCache* sharedCache);
+    SharedSurfaceCache* getSharedCache() const;
+
     // Public getters
     double getFuelbedDepth() const;
     double getSpreadRate() const;
@@ -153,6 +194,7 @@ protected:
 
 protected:
     void memberwiseCopyAssignment(const SurfaceFire& rhs);
+    void initializeSpreadMembers();
     void calculateHeatPerUnitArea();
     void calculateWindAdjustmentFactor();
     void calculateWindFactor();
@@ -182,6 +224,17 @@ protected:
     FireSize* size_;
     SurfaceFuelbedIntermediates surfaceFuelbedIntermediates_;
     SurfaceFireReactionIntensity surfaceFireReactionIntensity_;
+    SurfaceFuelbedCache fuelbedCache_;
+    SurfaceTwoFuelModelsCache twoFuelModelsCache_; // used by SurfaceTwoFuelModels
+    VectorMathMode::VectorMathModeEnum vectorMathMode_;
+    WindAdjustmentFactorMemo windAdjustmentFactorMemo_;
+    SharedSurfaceCache* sharedCache_;
+
+    // Inputs of the stored fuelbed intermediates and wind factor, compared with the current ones to skip recalculating them
+    int fuelbedFuelModelNumber_;            // -1 when nothing is stored
+    unsigned long fuelbedInputsRevision_;
+    unsigned long fuelModelsRevision_;
+    unsigned long windInputsRevision_;
 
     // Member variables
     bool isWindLimitExceeded_;
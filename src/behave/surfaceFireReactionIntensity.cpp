@@ -31,6 +31,7 @@
 #include "surfaceFireReactionIntensity.h"
 
 #include <cmath>
+#include "instrumentation.h"
 #include "surfaceFuelbedIntermediates.h"
 
 SurfaceFireReactionIntensity::SurfaceFireReactionIntensity()
@@ -77,18 +78,28 @@ void SurfaceFireReactionIntensity::memberwiseCopyAssignment(const SurfaceFireRea
 
 double SurfaceFireReactionIntensity::calculateReactionIntensity()
 {
+    BEHAVE_TIME_STAGE(ReactionIntensity);
     double aa = 0.0; // Alternate "arbitrary variable" A value for Rothermel equations for use in computer models, Albini 1976, p. 88
     reactionIntensity_ = 0;  // Reaction Intensity, Rothermel 1972, equation 27
 
     double sigma = surfaceFuelbedIntermediates_->getSigma();
     double relativePackingRatio = surfaceFuelbedIntermediates_->getRelativePackingRatio();
+    double gamma = 0.0;
 
-    aa = 133.0 / pow(sigma, 0.7913);
+    const FuelModels::StaticFuelbedConstants* staticConstants = surfaceFuelbedIntermediates_->getStaticFuelbedConstants();
+    if (staticConstants)
+    {
+        gamma = staticConstants->reactionVelocity_;
+    }
+    else
+    {
+        aa = 133.0 / pow(sigma, 0.7913);
 
-    //double gammaMax = (sigma * sqrt(sigma)) / (495.0 + (.0594 * sigma * sqrt(sigma)));
-    double sigmaToTheOnePointFive = pow(sigma, 1.5);
-    double gammaMax = sigmaToTheOnePointFive / (495.0 + (0.0594 * sigmaToTheOnePointFive));
-    double gamma = gammaMax * pow(relativePackingRatio, aa) * exp(aa * (1.0 - relativePackingRatio));
+        //double gammaMax = (sigma * sqrt(sigma)) / (495.0 + (.0594 * sigma * sqrt(sigma)));
+        double sigmaToTheOnePointFive = pow(sigma, 1.5);
+        double gammaMax = sigmaToTheOnePointFive / (495.0 + (0.0594 * sigmaToTheOnePointFive));
+        gamma = gammaMax * pow(relativePackingRatio, aa) * exp(aa * (1.0 - relativePackingRatio));
+    }
 
     double weightedFuelLoad[FuelConstants::MaxLifeStates];
     weightedFuelLoad[FuelLifeState::Dead] = surfaceFuelbedIntermediates_->getWeightedFuelLoadByLifeState(FuelLifeState::Dead);
@@ -0,0 +1,219 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Bounded least recently used cache of fuelbed intermediates and
+*           reaction intensity, keyed on fuel model and moistures
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "surfaceFuelbedCache.h"
+
+#include <cmath>
+
+constexpr double SurfaceFuelbedCache::MoistureQuantum;
+
+SurfaceFuelbedCache::SurfaceFuelbedCache()
+    : capacity_(0),
+    numberOfHits_(0),
+    numberOfMisses_(0)
+{
+
+}
+
+// Copies only the capacity, the entries hold state tied to the fuel models and inputs of the original
+SurfaceFuelbedCache::SurfaceFuelbedCache(const SurfaceFuelbedCache& rhs)
+    : capacity_(rhs.capacity_),
+    numberOfHits_(0),
+    numberOfMisses_(0)
+{
+
+}
+
+SurfaceFuelbedCache& SurfaceFuelbedCache::operator=(const SurfaceFuelbedCache& rhs)
+{
+    if (this != &rhs)
+    {
+        clear();
+        resetCounters();
+        capacity_ = rhs.capacity_;
+    }
+    return *this;
+}
+
+void SurfaceFuelbedCache::setCapacity(int capacity)
+{
+    capacity_ = (capacity < 0) ? 0 : capacity;
+    while (static_cast<int>(entries_.size()) > capacity_)
+    {
+        evictLeastRecentlyUsed();
+    }
+}
+
+void SurfaceFuelbedCache::clear()
+{
+    index_.clear();
+    entries_.clear();
+}
+
+void SurfaceFuelbedCache::resetCounters()
+{
+    numberOfHits_ = 0;
+    numberOfMisses_ = 0;
+}
+
+int SurfaceFuelbedCache::getCapacity() const
+{
+    return capacity_;
+}
+
+int SurfaceFuelbedCache::getNumberOfEntries() const
+{
+    return static_cast<int>(entries_.size());
+}
+
+long SurfaceFuelbedCache::getNumberOfHits() const
+{
+    return numberOfHits_;
+}
+
+long SurfaceFuelbedCache::getNumberOfMisses() const
+{
+    return numberOfMisses_;
+}
+
+bool SurfaceFuelbedCache::isCacheable(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs, int fuelModelNumber) const
+{
+    return (capacity_ != 0) && isStandardFuelbed(fuelModels, surfaceInputs, fuelModelNumber);
+}
+
+bool SurfaceFuelbedCache::isStandardFuelbed(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs, int fuelModelNumber)
+{
+    bool isUsingSpecialFuel = surfaceInputs.getIsUsingPalmettoGallberry() || surfaceInputs.getIsUsingWesternAspen() ||
+        surfaceInputs.getIsUsingChaparral();
+    return !isUsingSpecialFuel && fuelModels.isFuelModelReserved(fuelModelNumber);
+}
+
+bool SurfaceFuelbedCache::find(const SurfaceInputs& surfaceInputs, int fuelModelNumber, SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+    SurfaceFireReactionIntensity& surfaceFireReactionIntensity)
+{
+    auto found = index_.find(makeKey(surfaceInputs, fuelModelNumber));
+    if (found == index_.end())
+    {
+        numberOfMisses_++;
+        return false;
+    }
+
+    // Move to the front to mark it as most recently used, list iterators stay valid
+    entries_.splice(entries_.begin(), entries_, found->second);
+    surfaceFuelbedIntermediates = found->second->surfaceFuelbedIntermediates;
+    surfaceFireReactionIntensity = found->second->surfaceFireReactionIntensity;
+    numberOfHits_++;
+    return true;
+}
+
+void SurfaceFuelbedCache::insert(const SurfaceInputs& surfaceInputs, int fuelModelNumber, const SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+    const SurfaceFireReactionIntensity& surfaceFireReactionIntensity)
+{
+    if (capacity_ == 0)
+    {
+        return;
+    }
+
+    Key key = makeKey(surfaceInputs, fuelModelNumber);
+    auto found = index_.find(key);
+    if (found != index_.end())
+    {
+        entries_.splice(entries_.begin(), entries_, found->second);
+        found->second->surfaceFuelbedIntermediates = surfaceFuelbedIntermediates;
+        found->second->surfaceFireReactionIntensity = surfaceFireReactionIntensity;
+        return;
+    }
+
+    if (static_cast<int>(entries_.size()) >= capacity_)
+    {
+        evictLeastRecentlyUsed();
+    }
+    entries_.push_front(Entry{ key, surfaceFuelbedIntermediates, surfaceFireReactionIntensity });
+    index_[key] = entries_.begin();
+}
+
+SurfaceFuelbedCache::Key SurfaceFuelbedCache::makeKey(const SurfaceInputs& surfaceInputs, int fuelModelNumber)
+{
+    double moistures[NumberOfMoistureInputs] =
+    {
+        surfaceInputs.getMoistureOneHour(FractionUnits::Fraction),
+        surfaceInputs.getMoistureTenHour(FractionUnits::Fraction),
+        surfaceInputs.getMoistureHundredHour(FractionUnits::Fraction),
+        surfaceInputs.getMoistureLiveHerbaceous(FractionUnits::Fraction),
+        surfaceInputs.getMoistureLiveWoody(FractionUnits::Fraction),
+        surfaceInputs.getMoistureDeadAggregateValue(FractionUnits::Fraction),
+        surfaceInputs.getMoistureLiveAggregateValue(FractionUnits::Fraction)
+    };
+
+    Key key;
+    key.fuelModelNumber = fuelModelNumber;
+    key.moistureInputMode = static_cast<int>(surfaceInputs.getMoistureInputMode());
+    for (int i = 0; i < NumberOfMoistureInputs; i++)
+    {
+        key.moistures[i] = std::llround(moistures[i] / MoistureQuantum);
+    }
+    return key;
+}
+
+void SurfaceFuelbedCache::evictLeastRecentlyUsed()
+{
+    if (!entries_.empty())
+    {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+    }
+}
+
+bool SurfaceFuelbedCache::Key::operator==(const Key& rhs) const
+{
+    if (fuelModelNumber != rhs.fuelModelNumber || moistureInputMode != rhs.moistureInputMode)
+    {
+        return false;
+    }
+    for (int i = 0; i < NumberOfMoistureInputs; i++)
+    {
+        if (moistures[i] != rhs.moistures[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t SurfaceFuelbedCache::KeyHash::operator()(const Key& key) const
+{
+    // FNV-1a style combination of the key fields
+    std::size_t hash = 14695981039346656037ULL;
+    hash = (hash ^ static_cast<std::size_t>(key.fuelModelNumber)) * 1099511628211ULL;
+    hash = (hash ^ static_cast<std::size_t>(key.moistureInputMode)) * 1099511628211ULL;
+    for (int i = 0; i < NumberOfMoistureInputs; i++)
+    {
+        hash = (hash ^ std::hash<long long>()(key.moistures[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
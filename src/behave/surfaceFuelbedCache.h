@@ -0,0 +1,105 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Bounded least recently used cache of fuelbed intermediates and
+*           reaction intensity, keyed on fuel model and moistures
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SURFACEFUELBEDCACHE_H
+#define SURFACEFUELBEDCACHE_H
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+#include "surfaceFireReactionIntensity.h"
+#include "surfaceFuelbedIntermediates.h"
+
+// Remembers the fuelbed intermediates and no-wind no-slope reaction intensity of recent runs so a run
+// that only changes wind or slope can skip straight to the wind and slope factors. Entries are keyed on
+// the fuel model number, moisture input mode and all moisture inputs, quantized to MoistureQuantum.
+// Only standard fuel models are cached, custom ones can be redefined at any time, and runs using
+// Palmetto-Gallberry, Western Aspen or Chaparral bypass the cache as their fuelbeds depend on more inputs.
+// A capacity of zero, the default, turns the cache off.
+class SurfaceFuelbedCache
+{
+public:
+    static constexpr double MoistureQuantum = 1.0e-6; // fraction, moistures closer than this share an entry
+    static const int NumberOfMoistureInputs = 7;
+
+    struct Key
+    {
+        int fuelModelNumber;
+        int moistureInputMode;
+        long long moistures[NumberOfMoistureInputs];
+
+        bool operator==(const Key& rhs) const;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    // Whether a run's fuelbed depends only on the key, whatever the cache capacity
+    static bool isStandardFuelbed(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs, int fuelModelNumber);
+    static Key makeKey(const SurfaceInputs& surfaceInputs, int fuelModelNumber);
+
+    SurfaceFuelbedCache();
+    SurfaceFuelbedCache(const SurfaceFuelbedCache& rhs);
+    SurfaceFuelbedCache& operator=(const SurfaceFuelbedCache& rhs);
+
+    void setCapacity(int capacity);
+    void clear();
+    void resetCounters();
+
+    int getCapacity() const;
+    int getNumberOfEntries() const;
+    long getNumberOfHits() const;
+    long getNumberOfMisses() const;
+
+    bool isCacheable(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs, int fuelModelNumber) const;
+    bool find(const SurfaceInputs& surfaceInputs, int fuelModelNumber, SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+        SurfaceFireReactionIntensity& surfaceFireReactionIntensity);
+    void insert(const SurfaceInputs& surfaceInputs, int fuelModelNumber, const SurfaceFuelbedIntermediates& surfaceFuelbedIntermediates,
+        const SurfaceFireReactionIntensity& surfaceFireReactionIntensity);
+
+protected:
+    struct Entry
+    {
+        Key key;
+        SurfaceFuelbedIntermediates surfaceFuelbedIntermediates;
+        SurfaceFireReactionIntensity surfaceFireReactionIntensity;
+    };
+
+    void evictLeastRecentlyUsed();
+
+    int capacity_;
+    long numberOfHits_;
+    long numberOfMisses_;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+};
+
+#endif // SURFACEFUELBEDCACHE_H
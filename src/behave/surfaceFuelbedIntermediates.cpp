@@ -33,6 +33,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "fuelModels.h"
+#include "instrumentation.h"
 #include "surfaceInputs.h"
 
 SurfaceFuelbedIntermediates::SurfaceFuelbedIntermediates()
@@ -63,8 +64,6 @@ SurfaceFuelbedIntermediates& SurfaceFuelbedIntermediates::operator=(const Surfac
 
 void SurfaceFuelbedIntermediates::memberwiseCopyAssignment(const SurfaceFuelbedIntermediates& rhs)
 {
-    const int NUMBER_OF_LIVE_SIZE_CLASSES = 2;
-
     palmettoGallberry_ = rhs.palmettoGallberry_;
     westernAspen_ = rhs.westernAspen_;
 
@@ -76,6 +75,8 @@ void SurfaceFuelbedIntermediates::memberwiseCopyAssignment(const SurfaceFuelbedI
     packingRatio_ = rhs.packingRatio_;
     heatSink_ = rhs.heatSink_;
     totalSilicaContent_ = rhs.totalSilicaContent_;
+    propagatingFlux_ = rhs.propagatingFlux_;
+    isUsingStaticFuelbedConstants_ = rhs.isUsingStaticFuelbedConstants_;
 
     for (int i = 0; i < FuelConstants::MaxSavrSizeClasses; i++)
     {
@@ -86,6 +87,8 @@ void SurfaceFuelbedIntermediates::memberwiseCopyAssignment(const SurfaceFuelbedI
     {
         fractionOfTotalSurfaceAreaDead_[i] = rhs.fractionOfTotalSurfaceAreaDead_[i];
         fractionOfTotalSurfaceAreaLive_[i] = rhs.fractionOfTotalSurfaceAreaLive_[i];
+        sizeClassDead_[i] = rhs.sizeClassDead_[i];
+        sizeClassLive_[i] = rhs.sizeClassLive_[i];
         surfaceAreaDead_[i] = rhs.surfaceAreaDead_[i];
         surfaceAreaLive_[i] = rhs.surfaceAreaLive_[i];
         moistureDead_[i] = rhs.moistureDead_[i];
@@ -97,14 +100,9 @@ void SurfaceFuelbedIntermediates::memberwiseCopyAssignment(const SurfaceFuelbedI
         heatOfCombustionDead_[i] = rhs.heatOfCombustionDead_[i];
         heatOfCombustionLive_[i] = rhs.heatOfCombustionLive_[i];
         silicaEffectiveDead_[i] = rhs.silicaEffectiveDead_[i];
-        if (i < NUMBER_OF_LIVE_SIZE_CLASSES)
-        {
-            silicaEffectiveLive_[i] = 0.01;
-        }
-        else
-        {
-            silicaEffectiveLive_[i] = 0.0;
-        }
+        silicaEffectiveLive_[i] = rhs.silicaEffectiveLive_[i];
+        fuelDensityDead_[i] = rhs.fuelDensityDead_[i];
+        fuelDensityLive_[i] = rhs.fuelDensityLive_[i];
     }
     for (int i = 0; i < FuelConstants::MaxLifeStates; i++)
     {
@@ -115,8 +113,8 @@ void SurfaceFuelbedIntermediates::memberwiseCopyAssignment(const SurfaceFuelbedI
         totalSurfaceArea_[i] = rhs.totalSurfaceArea_[i];
         weightedMoisture_[i] = rhs.weightedMoisture_[i];
         weightedSilica_[i] = rhs.weightedSilica_[i];
-        fuelDensityDead_[i] = rhs.fuelDensityDead_[i];
-        fuelDensityLive_[i] = rhs.fuelDensityLive_[i];
+        weightedHeat_[i] = rhs.weightedHeat_[i];
+        weightedFuelLoad_[i] = rhs.weightedFuelLoad_[i];
     }
 }
 
@@ -126,6 +124,46 @@ SurfaceFuelbedIntermediates::~SurfaceFuelbedIntermediates()
 }
 
 void SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(int fuelModelNumber)
+{
+    BEHAVE_TIME_STAGE(FuelbedIntermediates);
+    // The fuelbed type is read once, so the builder of each type has no special fuel branches
+    switch (getFuelbedType())
+    {
+        case SurfaceFuelbedType::PalmettoGallberry:
+            calculateFuelbedIntermediatesForType<SurfaceFuelbedType::PalmettoGallberry>(fuelModelNumber);
+            break;
+        case SurfaceFuelbedType::WesternAspen:
+            calculateFuelbedIntermediatesForType<SurfaceFuelbedType::WesternAspen>(fuelModelNumber);
+            break;
+        case SurfaceFuelbedType::Chaparral:
+            calculateFuelbedIntermediatesForType<SurfaceFuelbedType::Chaparral>(fuelModelNumber);
+            break;
+        default:
+            calculateFuelbedIntermediatesForType<SurfaceFuelbedType::Standard>(fuelModelNumber);
+            break;
+    }
+}
+
+SurfaceFuelbedType::SurfaceFuelbedTypeEnum SurfaceFuelbedIntermediates::getFuelbedType() const
+{
+    // The special fuel inputs turn each other off, so at most one is on
+    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    {
+        return SurfaceFuelbedType::PalmettoGallberry;
+    }
+    else if (surfaceInputs_->getIsUsingWesternAspen())
+    {
+        return SurfaceFuelbedType::WesternAspen;
+    }
+    else if (surfaceInputs_->getIsUsingChaparral())
+    {
+        return SurfaceFuelbedType::Chaparral;
+    }
+    return SurfaceFuelbedType::Standard;
+}
+
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
+void SurfaceFuelbedIntermediates::calculateFuelbedIntermediatesForType(int fuelModelNumber)
 {
     // TODO: Look into the creation of two new classes, FuelBed and Particle, these
     // new classes should aid in refactoring and also improve the overall design - WMC 08/2015
@@ -141,34 +179,36 @@ void SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(int fuelModelNum
 
     fuelModelNumber_ = fuelModelNumber;
 
-    setFuelbedDepth();
+    setFuelbedDepth<Type>();
 
-    setFuelLoad();
+    setFuelLoad<Type>();
 
-    countSizeClasses();
+    countSizeClasses<Type>();
 
-    setMoistureContent();
+    setMoistureContent<Type>();
 
-    setSAVR();
+    setSAVR<Type>();
 
-    isDynamic = fuelModels_->getIsDynamic(fuelModelNumber_);
+    sortSizeClasses<Type>();
+
+    isDynamic = fuelModels_->getFuelbedParameters(fuelModelNumber_).isDynamic_;
     if (isDynamic) // do the dynamic load transfer
     {
         dynamicLoadTransfer();
     }
 
     // Heat of combustion
-    setHeatOfCombustion();
+    setHeatOfCombustion<Type>();
 
     // Fuel surface area weighting factors
-    calculateFractionOfTotalSurfaceAreaForLifeStates();
+    calculateFractionOfTotalSurfaceAreaForLifeStates<Type>();
 
     // Moisture of extinction
-    setDeadFuelMoistureOfExtinction();
+    setDeadFuelMoistureOfExtinction<Type>();
     calculateLiveMoistureOfExtinction();
 
     // Intermediate calculations, summing parameters by fuel component
-    calculateCharacteristicSAVR();
+    calculateCharacteristicSAVR<Type>();
 
     /* final calculations */
     double totalLoad = totalLoadForLifeState_[FuelLifeState::Dead] + totalLoadForLifeState_[FuelLifeState::Live];
@@ -182,32 +222,37 @@ void SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(int fuelModelNum
         packingRatio_ += loadLive_[i] / (depth_ * fuelDensityLive_[i]);
     }
 
-    optimumPackingRatio = 3.348 / pow(sigma_, 0.8189);
-    relativePackingRatio_ = packingRatio_ / optimumPackingRatio;
+    // Static fuel models, and dynamic ones at a tabulated curing level, have their sigma dependent terms precomputed in FuelModels
+    isUsingStaticFuelbedConstants_ = (Type == SurfaceFuelbedType::Standard) && (fuelModels_->getFuelbedConstants(fuelModelNumber_, moistureLive_[0]) != nullptr);
+    if (isUsingStaticFuelbedConstants_)
+    {
+        relativePackingRatio_ = getStaticFuelbedConstants()->relativePackingRatio_;
+    }
+    else
+    {
+        optimumPackingRatio = 3.348 / pow(sigma_, 0.8189);
+        relativePackingRatio_ = packingRatio_ / optimumPackingRatio;
+    }
 
     calculateHeatSink();
     calculatePropagatingFlux();
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::setFuelLoad()
 {
-    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
-        // Calculate load values for Palmetto-Gallberry
-        double ageOfRough = surfaceInputs_->getPalmettoGallberryAgeOfRough();
-        double heightOfUnderstory = surfaceInputs_->getPalmettoGallberryHeightOfUnderstory(LengthUnits::Feet);
-        double palmettoCoverage = surfaceInputs_->getPalmettoGallberryPalmettoCoverage(FractionUnits::Fraction);
-        double overstoryBasalArea = surfaceInputs_->getPalmettoGallberryOverstoryBasalArea(BasalAreaUnits::SquareFeetPerAcre);
-
-        loadDead_[0] = palmettoGallberry_.calculatePalmettoGallberyDeadFineFuelLoad(ageOfRough, heightOfUnderstory);
-        loadDead_[1] = palmettoGallberry_.calculatePalmettoGallberyDeadMediumFuelLoad(ageOfRough, palmettoCoverage);
-        loadDead_[2] = palmettoGallberry_.calculatePalmettoGallberyDeadFoliageLoad(ageOfRough, palmettoCoverage);
-        loadDead_[3] = palmettoGallberry_.calculatePalmettoGallberyLitterLoad(ageOfRough, overstoryBasalArea);
+        // Load values for Palmetto-Gallberry, the stand was calculated in setFuelbedDepth()
+        loadDead_[0] = palmettoGallberry_.getPalmettoGallberyDeadFineFuelLoad();
+        loadDead_[1] = palmettoGallberry_.getPalmettoGallberyDeadMediumFuelLoad();
+        loadDead_[2] = palmettoGallberry_.getPalmettoGallberyDeadFoliageLoad();
+        loadDead_[3] = palmettoGallberry_.getPalmettoGallberyLitterLoad();
         loadDead_[4] = 0.0;
 
-        loadLive_[0] = palmettoGallberry_.calculatePalmettoGallberyLiveFineFuelLoad(ageOfRough, heightOfUnderstory);
-        loadLive_[1] = palmettoGallberry_.calculatePalmettoGallberyLiveMediumFuelLoad(ageOfRough, heightOfUnderstory);
-        loadLive_[2] = palmettoGallberry_.calculatePalmettoGallberyLiveFoliageLoad(ageOfRough, palmettoCoverage, heightOfUnderstory);
+        loadLive_[0] = palmettoGallberry_.getPalmettoGallberyLiveFineFuelLoad();
+        loadLive_[1] = palmettoGallberry_.getPalmettoGallberyLiveMediumFuelLoad();
+        loadLive_[2] = palmettoGallberry_.getPalmettoGallberyLiveFoliageLoad();
         loadLive_[3] = 0.0;
         loadLive_[4] = 0.0;
 
@@ -216,25 +261,26 @@ void SurfaceFuelbedIntermediates::setFuelLoad()
             silicaEffectiveLive_[i] = 0.015;
         }
     }
-    else if(surfaceInputs_->getIsUsingWesternAspen())
+    else if(Type == SurfaceFuelbedType::WesternAspen)
     {
-        // Calculate load values for Western Aspen
+        // Calculate load and SAVR values for Western Aspen, setSAVR() reads the SAVRs back
         int aspenFuelModelNumber = surfaceInputs_->getAspenFuelModelNumber();
         double aspenCuringLevel = surfaceInputs_->getAspenCuringLevel(FractionUnits::Fraction);
+        const WesternAspenFuelbed& aspenFuelbed = westernAspen_.calculateAspenFuelbed(aspenFuelModelNumber, aspenCuringLevel);
 
-        loadDead_[0] = westernAspen_.calculateAspenLoadDeadOneHour(aspenFuelModelNumber, aspenCuringLevel);
-        loadDead_[1] = westernAspen_.calculateAspenLoadDeadTenHour(aspenFuelModelNumber);
+        loadDead_[0] = aspenFuelbed.loadDeadOneHour;
+        loadDead_[1] = aspenFuelbed.loadDeadTenHour;
         loadDead_[2] = 0.0;
         loadDead_[3] = 0.0;
         loadDead_[4] = 0.0;
 
-        loadLive_[0] = westernAspen_.calculateAspenLoadLiveHerbaceous(aspenFuelModelNumber, aspenCuringLevel);
-        loadLive_[1] = westernAspen_.calculateAspenLoadLiveWoody(aspenFuelModelNumber, aspenCuringLevel);
+        loadLive_[0] = aspenFuelbed.loadLiveHerbaceous;
+        loadLive_[1] = aspenFuelbed.loadLiveWoody;
         loadLive_[2] = 0.0;
         loadLive_[3] = 0.0;
         loadLive_[4] = 0.0;
     }
-    else if (surfaceInputs_->getIsUsingChaparral())
+    else if (Type == SurfaceFuelbedType::Chaparral)
     {
         ChaparralFuelLoadInputMode::ChaparralFuelInputLoadModeEnum chaparralFuelInputMode = surfaceInputs_->getChaparralFuelLoadInputMode();
       
@@ -259,24 +305,26 @@ void SurfaceFuelbedIntermediates::setFuelLoad()
     }
     else
     {
-        // Proceed as normal
-        loadDead_[0] = fuelModels_->getFuelLoadOneHour(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
-        loadDead_[1] = fuelModels_->getFuelLoadTenHour(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
-        loadDead_[2] = fuelModels_->getFuelLoadHundredHour(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
+        // Proceed as normal, the table is already in base units
+        const FuelModels::FuelbedParameters& parameters = fuelModels_->getFuelbedParameters(fuelModelNumber_);
+        loadDead_[0] = parameters.fuelLoadOneHour_;
+        loadDead_[1] = parameters.fuelLoadTenHour_;
+        loadDead_[2] = parameters.fuelLoadHundredHour_;
         loadDead_[3] = 0.0;
         loadDead_[4] = 0.0;
 
-        loadLive_[0] = fuelModels_->getFuelLoadLiveHerbaceous(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
-        loadLive_[1] = fuelModels_->getFuelLoadLiveWoody(fuelModelNumber_, LoadingUnits::PoundsPerSquareFoot);
+        loadLive_[0] = parameters.fuelLoadLiveHerbaceous_;
+        loadLive_[1] = parameters.fuelLoadLiveWoody_;
         loadLive_[2] = 0.0;
         loadLive_[3] = 0.0;
         loadLive_[4] = 0.0;
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::setMoistureContent()
 {
-    if (surfaceInputs_->getIsUsingChaparral())
+    if (Type == SurfaceFuelbedType::Chaparral)
     {
         moistureDead_[0] = surfaceInputs_->getMoistureOneHour(FractionUnits::Fraction);
         moistureDead_[1] = surfaceInputs_->getMoistureTenHour(FractionUnits::Fraction);
@@ -290,7 +338,7 @@ void SurfaceFuelbedIntermediates::setMoistureContent()
         moistureLive_[3] = surfaceInputs_->getMoistureLiveWoody(FractionUnits::Fraction);
         moistureLive_[4] = surfaceInputs_->getMoistureLiveWoody(FractionUnits::Fraction);
     }
-    else if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    else if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
         moistureDead_[0] = surfaceInputs_->getMoistureOneHour(FractionUnits::Fraction);
         moistureDead_[1] = surfaceInputs_->getMoistureTenHour(FractionUnits::Fraction);
@@ -322,52 +370,60 @@ void SurfaceFuelbedIntermediates::setMoistureContent()
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::setDeadFuelMoistureOfExtinction()
 {
-    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
         moistureOfExtinction_[FuelLifeState::Dead] = palmettoGallberry_.getMoistureOfExtinctionDead();
     }
-    else if (surfaceInputs_->getIsUsingWesternAspen())
+    else if (Type == SurfaceFuelbedType::WesternAspen)
     {
         moistureOfExtinction_[FuelLifeState::Dead] = westernAspen_.getAspenMoistureOfExtinctionDead();
     }
-    else if (surfaceInputs_->getIsUsingChaparral())
+    else if (Type == SurfaceFuelbedType::Chaparral)
     {
         moistureOfExtinction_[FuelLifeState::Dead] = chaparralFuel_.getDeadMoistureOfExtinction();
     }
     else
     {
-        moistureOfExtinction_[FuelLifeState::Dead] = fuelModels_->getMoistureOfExtinctionDead(fuelModelNumber_, FractionUnits::Fraction);
+        moistureOfExtinction_[FuelLifeState::Dead] = fuelModels_->getFuelbedParameters(fuelModelNumber_).moistureOfExtinctionDead_;
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::setFuelbedDepth()
 {
-    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
+        // Calculates the whole stand, setFuelLoad() reads the loads back
+        double ageOfRough = surfaceInputs_->getPalmettoGallberryAgeOfRough();
         double heightOfUnderstory = surfaceInputs_->getPalmettoGallberryHeightOfUnderstory(LengthUnits::Feet);
-        depth_ = palmettoGallberry_.calculatePalmettoGallberyFuelBedDepth(heightOfUnderstory);
+        double palmettoCoverage = surfaceInputs_->getPalmettoGallberryPalmettoCoverage(FractionUnits::Fraction);
+        double overstoryBasalArea = surfaceInputs_->getPalmettoGallberryOverstoryBasalArea(BasalAreaUnits::SquareFeetPerAcre);
+        depth_ = palmettoGallberry_.calculatePalmettoGallberyFuelbed(ageOfRough, heightOfUnderstory, palmettoCoverage,
+            overstoryBasalArea).fuelBedDepth;
     }
-    else if (surfaceInputs_->getIsUsingWesternAspen())
+    else if (Type == SurfaceFuelbedType::WesternAspen)
     {
         int aspenFuelModelNumber = surfaceInputs_->getAspenFuelModelNumber();
         depth_ = westernAspen_.getAspenFuelBedDepth(aspenFuelModelNumber);
     }
-    else if (surfaceInputs_->getIsUsingChaparral())
+    else if (Type == SurfaceFuelbedType::Chaparral)
     {
         depth_ = surfaceInputs_->getChaparralFuelBedDepth(LengthUnits::Feet);
         chaparralFuel_.setDepth(depth_);
     }
     else
     {
-        depth_ = fuelModels_->getFuelbedDepth(fuelModelNumber_, LengthUnits::Feet);
+        depth_ = fuelModels_->getFuelbedParameters(fuelModelNumber_).fuelbedDepth_;
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::setSAVR()
 {
-    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
         // Special values for Palmetto-Gallberry
         savrDead_[0] = 350.0;
@@ -382,25 +438,22 @@ void SurfaceFuelbedIntermediates::setSAVR()
         savrLive_[3] = 0.0;
         savrLive_[4] = 0.0;
     }
-    else if (surfaceInputs_->getIsUsingWesternAspen())
+    else if (Type == SurfaceFuelbedType::WesternAspen)
     {
-        // Calculate SAVR values for Western Aspen
-        int aspenFuelModelNumber = surfaceInputs_->getAspenFuelModelNumber();
-        double aspenCuringLevel = surfaceInputs_->getAspenCuringLevel(FractionUnits::Fraction);
-
-        savrDead_[0] = westernAspen_.calculateAspenSavrDeadOneHour(aspenFuelModelNumber, aspenCuringLevel);
-        savrDead_[1] = westernAspen_.calculateAspenSavrDeadTenHour();
+        // SAVR values for Western Aspen, the stand was calculated in setFuelLoad()
+        savrDead_[0] = westernAspen_.getAspenSavrDeadOneHour();
+        savrDead_[1] = westernAspen_.getAspenSavrDeadTenHour();
         savrDead_[2] = 0.0;
         savrDead_[3] = 0.0;
         savrDead_[4] = 0.0;
 
-        savrLive_[0] = westernAspen_.calculateAspenSavrLiveHerbaceous();
-        savrLive_[1] = westernAspen_.calculateAspenSavrLiveWoody(aspenFuelModelNumber, aspenCuringLevel);
+        savrLive_[0] = westernAspen_.getAspenSavrLiveHerbaceous();
+        savrLive_[1] = westernAspen_.getAspenSavrLiveWoody();
         savrLive_[2] = 0.0;
         savrLive_[3] = 0.0;
         savrDead_[4] = 0.0;
     }
-    else if (surfaceInputs_->getIsUsingChaparral())
+    else if (Type == SurfaceFuelbedType::Chaparral)
     {
         for (int i = 0; i < ChaparralContants::NumFuelClasses; i++)
         {
@@ -410,21 +463,23 @@ void SurfaceFuelbedIntermediates::setSAVR()
     }
     else
     {
-        // Proceed as normal
-        savrDead_[0] = fuelModels_->getSavrOneHour(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+        // Proceed as normal, the table is already in base units
+        const FuelModels::FuelbedParameters& parameters = fuelModels_->getFuelbedParameters(fuelModelNumber_);
+        savrDead_[0] = parameters.savrOneHour_;
         savrDead_[1] = 109.0;
         savrDead_[2] = 30.0;
-        savrDead_[3] = fuelModels_->getSavrLiveHerbaceous(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+        savrDead_[3] = parameters.savrLiveHerbaceous_;
         savrDead_[4] = 0.0;
 
-        savrLive_[0] = fuelModels_->getSavrLiveHerbaceous(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
-        savrLive_[1] = fuelModels_->getSavrLiveWoody(fuelModelNumber_, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+        savrLive_[0] = parameters.savrLiveHerbaceous_;
+        savrLive_[1] = parameters.savrLiveWoody_;
         savrLive_[2] = 0.0;
         savrLive_[3] = 0.0;
         savrLive_[4] = 0.0;
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::setHeatOfCombustion()
 {
     const int NUMBER_OF_LIVE_SIZE_CLASSES = 3;
@@ -432,17 +487,17 @@ void SurfaceFuelbedIntermediates::setHeatOfCombustion()
     double heatOfCombustionDead = 0.0;
     double heatOfCombustionLive = 0.0;
 
-    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
         heatOfCombustionDead = palmettoGallberry_.getHeatOfCombustionDead();
         heatOfCombustionLive = palmettoGallberry_.getHeatOfCombustionLive();
     }
-    else if (surfaceInputs_->getIsUsingWesternAspen())
+    else if (Type == SurfaceFuelbedType::WesternAspen)
     {
         heatOfCombustionDead = westernAspen_.getAspenHeatOfCombustionDead();
         heatOfCombustionLive = westernAspen_.getAspenHeatOfCombustionLive();
     }
-    else if (surfaceInputs_->getIsUsingChaparral())
+    else if (Type == SurfaceFuelbedType::Chaparral)
     {
         for (int i = 0; i < FuelConstants::MaxParticles; i++)
         {
@@ -452,11 +507,12 @@ void SurfaceFuelbedIntermediates::setHeatOfCombustion()
     }
     else
     {
-        heatOfCombustionDead = fuelModels_->getHeatOfCombustionDead(fuelModelNumber_, HeatOfCombustionUnits::BtusPerPound);
-        heatOfCombustionLive = fuelModels_->getHeatOfCombustionLive(fuelModelNumber_, HeatOfCombustionUnits::BtusPerPound);
+        const FuelModels::FuelbedParameters& parameters = fuelModels_->getFuelbedParameters(fuelModelNumber_);
+        heatOfCombustionDead = parameters.heatOfCombustionDead_;
+        heatOfCombustionLive = parameters.heatOfCombustionLive_;
     }
 
-    if (!surfaceInputs_->getIsUsingChaparral())
+    if (Type != SurfaceFuelbedType::Chaparral)
     {
         for (int i = 0; i < FuelConstants::MaxParticles; i++)
         {
@@ -475,9 +531,16 @@ void SurfaceFuelbedIntermediates::setHeatOfCombustion()
 
 void SurfaceFuelbedIntermediates::calculatePropagatingFlux()
 {
-    propagatingFlux_ = (sigma_ < 1.0e-07)
-        ? (0.0)
-        : (exp((0.792 + (0.681 * sqrt(sigma_))) * (packingRatio_ + 0.1)) / (192.0 + 0.2595 * sigma_));
+    if (isUsingStaticFuelbedConstants_)
+    {
+        propagatingFlux_ = getStaticFuelbedConstants()->propagatingFlux_;
+    }
+    else
+    {
+        propagatingFlux_ = (sigma_ < 1.0e-07)
+            ? (0.0)
+            : (exp((0.792 + (0.681 * sqrt(sigma_))) * (packingRatio_ + 0.1)) / (192.0 + 0.2595 * sigma_));
+    }
 }
 
 void SurfaceFuelbedIntermediates::calculateWesternAspenMortality(double flameLength)
@@ -514,6 +577,7 @@ void SurfaceFuelbedIntermediates::calculateHeatSink()
     heatSink_ *= bulkDensity_;
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::calculateCharacteristicSAVR()
 {
     double	wnLive[FuelConstants::MaxParticles];			// Net fuel loading for live fuels, Rothermel 1972, equation 24	
@@ -538,16 +602,16 @@ void SurfaceFuelbedIntermediates::calculateCharacteristicSAVR()
         wnLive[i] = 0.0;
     }
 
-    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
         totalSilicaContent_ = 0.030;
     }
-    else if (surfaceInputs_->getIsUsingChaparral() || surfaceInputs_->getIsUsingWesternAspen())
+    else if (Type == SurfaceFuelbedType::Chaparral || Type == SurfaceFuelbedType::WesternAspen)
     {
         totalSilicaContent_ = 0.055;
     }
 
-    if (surfaceInputs_->getIsUsingChaparral())
+    if (Type == SurfaceFuelbedType::Chaparral)
     {
         for (int i = 0; i < ChaparralContants::NumFuelClasses; i++)
         {
@@ -607,8 +671,18 @@ void SurfaceFuelbedIntermediates::calculateCharacteristicSAVR()
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::countSizeClasses()
 {
+    // Standard fuel models have their counts precomputed in FuelModels
+    const FuelModels::SizeClassBins* bins = getStandardFuelbedSizeClassBins<Type>();
+    if (bins)
+    {
+        numberOfSizeClasses_[FuelLifeState::Dead] = bins->numberOfSizeClasses_[FuelLifeState::Dead];
+        numberOfSizeClasses_[FuelLifeState::Live] = bins->numberOfSizeClasses_[FuelLifeState::Live];
+        return;
+    }
+
     // count number of fuels
     for (int i = 0; i < FuelConstants::MaxDeadSizeClasses; i++)
     {
@@ -634,6 +708,32 @@ void SurfaceFuelbedIntermediates::countSizeClasses()
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
+void SurfaceFuelbedIntermediates::sortSizeClasses()
+{
+    const FuelModels::SizeClassBins* bins = getStandardFuelbedSizeClassBins<Type>();
+    for (int i = 0; i < FuelConstants::MaxParticles; i++)
+    {
+        if (bins)
+        {
+            sizeClassDead_[i] = bins->sizeClassDead_[i];
+            sizeClassLive_[i] = bins->sizeClassLive_[i];
+        }
+        else
+        {
+            sizeClassDead_[i] = static_cast<signed char>(FuelModels::getSavrSizeClass(savrDead_[i]));
+            sizeClassLive_[i] = static_cast<signed char>(FuelModels::getSavrSizeClass(savrLive_[i]));
+        }
+    }
+}
+
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
+const FuelModels::SizeClassBins* SurfaceFuelbedIntermediates::getStandardFuelbedSizeClassBins() const
+{
+    // Palmetto-gallberry, western aspen and chaparral build their particles from the stand, not the fuel model
+    return (Type != SurfaceFuelbedType::Standard) ? nullptr : &fuelModels_->getFuelbedParameters(fuelModelNumber_).sizeClassBins_;
+}
+
 void SurfaceFuelbedIntermediates::dynamicLoadTransfer()
 {
     if (moistureLive_[0] < 0.30)
@@ -649,6 +749,7 @@ void SurfaceFuelbedIntermediates::dynamicLoadTransfer()
     }
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::calculateFractionOfTotalSurfaceAreaForLifeStates()
 {
     double summedFractionOfTotalSurfaceArea[FuelConstants::MaxSavrSizeClasses];	// Intermediate weighting factors for each size class
@@ -657,7 +758,7 @@ void SurfaceFuelbedIntermediates::calculateFractionOfTotalSurfaceAreaForLifeStat
     {
         if (numberOfSizeClasses_[lifeState] != 0)
         {
-            calculateTotalSurfaceAreaForLifeState(lifeState);
+            calculateTotalSurfaceAreaForLifeState<Type>(lifeState);
             calculateFractionOfTotalSurfaceAreaForSizeClasses(lifeState);
         }
         for (int i = 0; i < FuelConstants::MaxSavrSizeClasses; i++)
@@ -666,13 +767,13 @@ void SurfaceFuelbedIntermediates::calculateFractionOfTotalSurfaceAreaForLifeStat
         }
         if (lifeState == FuelLifeState::Dead)
         {
-            sumFractionOfTotalSurfaceAreaBySizeClass(fractionOfTotalSurfaceAreaDead_, savrDead_, summedFractionOfTotalSurfaceArea);
-            assignFractionOfTotalSurfaceAreaBySizeClass(FuelLifeState::Dead, savrDead_, summedFractionOfTotalSurfaceArea, sizeSortedFractionOfSurfaceAreaDead_);
+            sumFractionOfTotalSurfaceAreaBySizeClass(fractionOfTotalSurfaceAreaDead_, sizeClassDead_, summedFractionOfTotalSurfaceArea);
+            assignFractionOfTotalSurfaceAreaBySizeClass(sizeClassDead_, summedFractionOfTotalSurfaceArea, sizeSortedFractionOfSurfaceAreaDead_);
         }
         if (lifeState == FuelLifeState::Live)
         {
-            sumFractionOfTotalSurfaceAreaBySizeClass(fractionOfTotalSurfaceAreaLive_, savrLive_, summedFractionOfTotalSurfaceArea);
-            assignFractionOfTotalSurfaceAreaBySizeClass(FuelLifeState::Live, savrLive_, summedFractionOfTotalSurfaceArea, sizeSortedFractionOfSurfaceAreaLive_);
+            sumFractionOfTotalSurfaceAreaBySizeClass(fractionOfTotalSurfaceAreaLive_, sizeClassLive_, summedFractionOfTotalSurfaceArea);
+            assignFractionOfTotalSurfaceAreaBySizeClass(sizeClassLive_, summedFractionOfTotalSurfaceArea, sizeSortedFractionOfSurfaceAreaLive_);
         }
     }
 
@@ -681,6 +782,7 @@ void SurfaceFuelbedIntermediates::calculateFractionOfTotalSurfaceAreaForLifeStat
     fractionOfTotalSurfaceArea_[FuelLifeState::Live] = 1.0 - fractionOfTotalSurfaceArea_[FuelLifeState::Dead];
 }
 
+template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
 void SurfaceFuelbedIntermediates::calculateTotalSurfaceAreaForLifeState(int lifeState)
 {
     for (int i = 0; i < FuelConstants::MaxLifeStates; i++)
@@ -688,7 +790,7 @@ void SurfaceFuelbedIntermediates::calculateTotalSurfaceAreaForLifeState(int life
         totalSurfaceArea_[lifeState] = 0.0;
     }
 
-    if (surfaceInputs_->getIsUsingPalmettoGallberry())
+    if (Type == SurfaceFuelbedType::PalmettoGallberry)
     {
         for (int i = 0; i < FuelConstants::MaxParticles; i++)
         {
@@ -696,7 +798,7 @@ void SurfaceFuelbedIntermediates::calculateTotalSurfaceAreaForLifeState(int life
             fuelDensityLive_[i] = 46.0;
         }
     }
-    else if (surfaceInputs_->getIsUsingChaparral())
+    else if (Type == SurfaceFuelbedType::Chaparral)
     {
         for (int i = 0; i < FuelConstants::MaxParticles; i++)
         {
@@ -751,9 +853,9 @@ void SurfaceFuelbedIntermediates::calculateFractionOfTotalSurfaceAreaForSizeClas
 
 void SurfaceFuelbedIntermediates::sumFractionOfTotalSurfaceAreaBySizeClass(
     const double fractionOfTotalSurfaceAreaDeadOrLive[FuelConstants::MaxParticles],
-    const double savrDeadOrLive[FuelConstants::MaxParticles], double summedFractionOfTotalSurfaceArea[FuelConstants::MaxParticles])
+    const signed char sizeClassDeadOrLive[FuelConstants::MaxParticles], double summedFractionOfTotalSurfaceArea[FuelConstants::MaxParticles])
 {
-    // savrDeadOrLive[] is an alias for savrDead[] or savrLive[], which is determined by the method caller 
+    // sizeClassDeadOrLive[] is an alias for sizeClassDead_[] or sizeClassLive_[], which is determined by the method caller 
     // fractionOfTotalSurfaceAreaDeadOrLive  is an alias for fractionOfTotalSurfaceAreaDead[] or  fractionOfTotalSurfaceAreaLive[], 
     // which is determined by the method caller 
 
@@ -764,59 +866,26 @@ void SurfaceFuelbedIntermediates::sumFractionOfTotalSurfaceAreaBySizeClass(
 
     for (int i = 0; i < FuelConstants::MaxParticles; i++)
     {
-        if (savrDeadOrLive[i] >= 1200.0)
-        {
-            summedFractionOfTotalSurfaceArea[0] += fractionOfTotalSurfaceAreaDeadOrLive[i];
-        }
-        else if (savrDeadOrLive[i] >= 192.0)
-        {
-            summedFractionOfTotalSurfaceArea[1] += fractionOfTotalSurfaceAreaDeadOrLive[i];
-        }
-        else if (savrDeadOrLive[i] >= 96.0)
-        {
-            summedFractionOfTotalSurfaceArea[2] += fractionOfTotalSurfaceAreaDeadOrLive[i];
-        }
-        else if (savrDeadOrLive[i] >= 48.0)
-        {
-            summedFractionOfTotalSurfaceArea[3] += fractionOfTotalSurfaceAreaDeadOrLive[i];
-        }
-        else if (savrDeadOrLive[i] >= 16.0)
+        if (sizeClassDeadOrLive[i] >= 0)
         {
-            summedFractionOfTotalSurfaceArea[4] += fractionOfTotalSurfaceAreaDeadOrLive[i];
+            summedFractionOfTotalSurfaceArea[sizeClassDeadOrLive[i]] += fractionOfTotalSurfaceAreaDeadOrLive[i];
         }
     }
 }
 
-void SurfaceFuelbedIntermediates::assignFractionOfTotalSurfaceAreaBySizeClass(FuelLifeState::FuelLifeStateEnum lifeState, 
-    const double savrDeadOrLive[FuelConstants::MaxParticles],
+void SurfaceFuelbedIntermediates::assignFractionOfTotalSurfaceAreaBySizeClass(const signed char sizeClassDeadOrLive[FuelConstants::MaxParticles],
     const double summedFractionOfTotalSurfaceArea[FuelConstants::MaxParticles],
     double sizeSortedFractionOfSurfaceAreaDeadOrLive[FuelConstants::MaxParticles])
 {
-    // savrDeadOrLive[] is an alias for savrDead[] or savrLive[], which is determined by the method caller 
+    // sizeClassDeadOrLive[] is an alias for sizeClassDead_[] or sizeClassLive_[], which is determined by the method caller 
     // sizeSortedFractionOfSurfaceAreaDeadOrLive[] is an alias for sizeSortedFractionOfSurfaceAreaDead_[] or sizeSortedFractionOfSurfaceAreaLive_[], 
     // which is determined by the method caller
 
     for (int i = 0; i < FuelConstants::MaxParticles; i++)
     {
-        if (savrDeadOrLive[i] >= 1200.0)
+        if (sizeClassDeadOrLive[i] >= 0)
         {
-            sizeSortedFractionOfSurfaceAreaDeadOrLive[i] = summedFractionOfTotalSurfaceArea[0];
-        }
-        else if (savrDeadOrLive[i] >= 192.0)
-        {
-            sizeSortedFractionOfSurfaceAreaDeadOrLive[i] = summedFractionOfTotalSurfaceArea[1];
-        }
-        else if (savrDeadOrLive[i] >= 96.0)
-        {
-            sizeSortedFractionOfSurfaceAreaDeadOrLive[i] = summedFractionOfTotalSurfaceArea[2];
-        }
-        else if (savrDeadOrLive[i] >= 48.0)
-        {
-            sizeSortedFractionOfSurfaceAreaDeadOrLive[i] = summedFractionOfTotalSurfaceArea[3];
-        }
-        else if (savrDeadOrLive[i] >= 16.0)
-        {
-            sizeSortedFractionOfSurfaceAreaDeadOrLive[i] = summedFractionOfTotalSurfaceArea[4];
+            sizeSortedFractionOfSurfaceAreaDeadOrLive[i] = summedFractionOfTotalSurfaceArea[sizeClassDeadOrLive[i]];
         }
         else
         {
@@ -885,6 +954,8 @@ void SurfaceFuelbedIntermediates::initializeMembers()
     packingRatio_ = 0.0;
     heatSink_ = 0.0;
     totalSilicaContent_ = 0.0555;
+    propagatingFlux_ = 0.0;
+    isUsingStaticFuelbedConstants_ = false;
 
     for (int i = 0; i < FuelConstants::MaxSavrSizeClasses; i++)
     {
@@ -895,6 +966,8 @@ void SurfaceFuelbedIntermediates::initializeMembers()
     {
         fractionOfTotalSurfaceAreaDead_[i] = 0.0;
         fractionOfTotalSurfaceAreaLive_[i] = 0.0;
+        sizeClassDead_[i] = -1;
+        sizeClassLive_[i] = -1;
         surfaceAreaDead_[i] = 0.0;
         surfaceAreaLive_[i] = 0.0;
         moistureDead_[i] = 0.0;
@@ -926,6 +999,8 @@ void SurfaceFuelbedIntermediates::initializeMembers()
         totalSurfaceArea_[i] = 0.0;
         weightedMoisture_[i] = 0.0;
         weightedSilica_[i] = 0.0;
+        weightedHeat_[i] = 0.0;
+        weightedFuelLoad_[i] = 0.0;
     }
 }
 
@@ -954,6 +1029,11 @@ double SurfaceFuelbedIntermediates::getRelativePackingRatio() const
     return relativePackingRatio_;
 }
 
+const FuelModels::StaticFuelbedConstants* SurfaceFuelbedIntermediates::getStaticFuelbedConstants() const
+{
+    return isUsingStaticFuelbedConstants_ ? fuelModels_->getFuelbedConstants(fuelModelNumber_, moistureLive_[0]) : nullptr;
+}
+
 double SurfaceFuelbedIntermediates::getSigma() const
 {
     return sigma_;
@@ -37,6 +37,18 @@
 #include "surfaceInputs.h"
 #include "fuelModels.h"
 
+// The kind of fuelbed a run builds, standard for a fuel model or one of the special fuels built from their stand
+struct SurfaceFuelbedType
+{
+    enum SurfaceFuelbedTypeEnum
+    {
+        Standard,
+        PalmettoGallberry,
+        WesternAspen,
+        Chaparral
+    };
+};
+
 class SurfaceFuelbedIntermediates
 {
 public:
@@ -62,6 +74,7 @@ public:
     double getWeightedHeatByLifeState(FuelLifeState::FuelLifeStateEnum lifeState) const;
     double getWeightedSilicaByLifeState(FuelLifeState::FuelLifeStateEnum lifeState) const;
     double getWeightedFuelLoadByLifeState(FuelLifeState::FuelLifeStateEnum lifeState) const;
+    const FuelModels::StaticFuelbedConstants* getStaticFuelbedConstants() const; // null unless the run used a static fuel model or a tabulated curing level
 
     // Palmetto-Gallberry getters
     double getPalmettoGallberryMoistureOfExtinctionDead() const;
@@ -113,21 +126,39 @@ public:
 protected:
     void initializeMembers();
     void memberwiseCopyAssignment(const SurfaceFuelbedIntermediates& rhs);
+    SurfaceFuelbedType::SurfaceFuelbedTypeEnum getFuelbedType() const;
+    // Builders for each fuelbed type, instantiated once per type so the standard fuelbed has no special fuel branches
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
+    void calculateFuelbedIntermediatesForType(int fuelModelNumber);
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void setFuelLoad();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void setMoistureContent();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void setDeadFuelMoistureOfExtinction();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void setFuelbedDepth();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void setSAVR();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void countSizeClasses();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
+    void sortSizeClasses();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
+    const FuelModels::SizeClassBins* getStandardFuelbedSizeClassBins() const;
     void dynamicLoadTransfer();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void calculateFractionOfTotalSurfaceAreaForLifeStates();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void calculateTotalSurfaceAreaForLifeState(int lifeCategory);
     void calculateFractionOfTotalSurfaceAreaForSizeClasses(int lifeCategory);
     void sumFractionOfTotalSurfaceAreaBySizeClass(const double areaWeightingFactorDeadOrLive[FuelConstants::MaxParticles],
-        const double savrDeadOrLive[FuelConstants::MaxParticles], double summedWeightingFactors[FuelConstants::MaxParticles]);
-    void assignFractionOfTotalSurfaceAreaBySizeClass(FuelLifeState::FuelLifeStateEnum lifeState, const double savrDeadOrLive[FuelConstants::MaxParticles],
+        const signed char sizeClassDeadOrLive[FuelConstants::MaxParticles], double summedWeightingFactors[FuelConstants::MaxParticles]);
+    void assignFractionOfTotalSurfaceAreaBySizeClass(const signed char sizeClassDeadOrLive[FuelConstants::MaxParticles],
         const double summedWeightingFactors[FuelConstants::MaxParticles], double sizeSortedWeightingFactorsDeadOrLive[FuelConstants::MaxParticles]);
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void setHeatOfCombustion();
+    template <SurfaceFuelbedType::SurfaceFuelbedTypeEnum Type>
     void calculateCharacteristicSAVR();
     void calculateHeatSink();
     void calculateLiveMoistureOfExtinction();
@@ -168,6 +199,8 @@ protected:
     double fractionOfTotalSurfaceAreaLive_[FuelConstants::MaxParticles];            // Fraction of surface area for live size classes
     double sizeSortedFractionOfSurfaceAreaDead_[FuelConstants::MaxSavrSizeClasses]; // Intermediate fuel weighting values for dead fuels
     double sizeSortedFractionOfSurfaceAreaLive_[FuelConstants::MaxSavrSizeClasses]; // Intermediate fuel weighting values for live fuels
+    signed char sizeClassDead_[FuelConstants::MaxParticles];                        // SAVR size class of dead particles, -1 below 16 ft^2/ft^3
+    signed char sizeClassLive_[FuelConstants::MaxParticles];                        // SAVR size class of live particles, -1 below 16 ft^2/ft^3
 
     int fuelModelNumber_;           // The number associated with the current fuel model being used
     double heatSink_;               // Rothermel 1972, Denominator of equation 52
@@ -177,6 +210,7 @@ protected:
     double relativePackingRatio_;   // Packing ratio divided by the optimum packing ratio, Rothermel 1972, term in RHS equation 47
     double totalSilicaContent_;     // Total silica content (fraction), Albini 1976, p. 91
     double propagatingFlux_;
+    bool isUsingStaticFuelbedConstants_; // True when the current fuelbed has constants precomputed in FuelModels
 };
 
 #endif	// SURFACEFUELBEDINTERMEDIATES_H
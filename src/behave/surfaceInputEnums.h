@@ -93,6 +93,21 @@ struct SurfaceFireSpreadDirectionMode
     };
 };
 
+// Bit flags for the surface fire outputs a run calculates beyond the forward spread rate, direction of
+// max spread and effective wind speed, which are always calculated. Outputs left out read as zero.
+struct SurfaceFireOutputs
+{
+    enum SurfaceFireOutputsEnum
+    {
+        SpreadRateOnly = 0,             // Only the forward spread rate and what it depends on
+        FireShape = 1 << 0,             // Length to width ratio, backing and flanking spread rates
+        FirelineIntensity = 1 << 1,     // Fireline intensities, backing and flanking ones also need FireShape
+        FlameLength = 1 << 2,           // Flame lengths, implies FirelineIntensity
+        HeatPerUnitArea = 1 << 3,       // Heat per unit area, residence time and heat source
+        All = FireShape | FirelineIntensity | FlameLength | HeatPerUnitArea
+    };
+};
+
 struct TwoFuelModelsMethod
 {
     enum TwoFuelModelsMethodEnum
@@ -104,6 +119,15 @@ struct TwoFuelModelsMethod
     };
 };
 
+struct TwoDimensionalSpreadMode
+{
+    enum TwoDimensionalSpreadModeEnum
+    {
+        Exact = 0,          // Enumerate the fuel arrangements every run
+        Interpolated = 1    // Interpolate the shared SurfaceTwoDimensionalSpreadTable, within 0.5% of Exact
+    };
+};
+
 struct TwoFuelModelsContants
 {
     enum TwoFuelModelsContantsEnum
@@ -28,8 +28,12 @@
 
 #include "surfaceInputs.h"
 
+#include <atomic>
 #include <cmath>
 
+// Source of input revisions, shared by every SurfaceInputs so a revision identifies one set of inputs
+static std::atomic<unsigned long> nextInputsRevision(1);
+
 // Default Ctor
 SurfaceInputs::SurfaceInputs()
 {
@@ -76,6 +80,8 @@ void SurfaceInputs::initializeMembers()
     twoFuelModelsMethod_ = TwoFuelModelsMethod::NoMethod;
     windAdjustmentFactorCalculationMethod_ = WindAdjustmentFactorCalculationMethod::UseCrownRatio;
     surfaceFireSpreadDirectionMode_ = SurfaceFireSpreadDirectionMode::FromIgnitionPoint;
+    surfaceFireOutputs_ = SurfaceFireOutputs::All;
+    twoDimensionalSpreadMode_ = TwoDimensionalSpreadMode::Exact;
 
     firstFuelModelCoverage_ = 0.0;
 
@@ -93,6 +99,12 @@ void SurfaceInputs::initializeMembers()
     aspenFireSeverity_ = AspenFireSeverity::Low;
     dbh_ = 0.0;
 
+    chaparralFuelLoadInputMode_ = ChaparralFuelLoadInputMode::DirectFuelLoad;
+    chaparralFuelType_ = ChaparralFuelType::NotSet;
+    chaparralFuelBedDepth_ = 0.0;
+    chaparralFuelDeadLoadFraction_ = 0.0;
+    chaparralTotalFuelLoad_ = 0.0;
+
     elapsedTime_ = TimeUnits::toBaseUnits(1, TimeUnits::Hours);
 
     userProvidedWindAdjustmentFactor_ = -1.0;
@@ -101,6 +113,9 @@ void SurfaceInputs::initializeMembers()
     currentMoistureScenarioName_ = "";
     currentMoistureScenarioIndex_ = -1;
     moistureValuesBySizeClass_ = {-1.0, -1.0, -1.0, -1.0, -1.0, -1.0, -1.0};
+
+    markFuelbedInputsChanged();
+    markWindInputsChanged();
 }
 
 void SurfaceInputs::updateSurfaceInputs(int fuelModelNumber, double moistureOneHour, double moistureTenHour,
@@ -144,6 +159,53 @@ void SurfaceInputs::updateSurfaceInputs(int fuelModelNumber, double moistureOneH
     setCrownRatio(crownRatio, crownRatioUnits);
 }
 
+// Same as updateSurfaceInputs() for values already in base units, keeping the current wind height
+// and orientation modes. Used by Surface::doSurfaceRunBatch() so each cell skips the unit conversions.
+void SurfaceInputs::updateSurfaceInputsInBaseUnits(int fuelModelNumber, double moistureOneHour, double moistureTenHour,
+    double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody, double windSpeed, double windDirection,
+    double slope, double aspect, double canopyCover, double canopyHeight, double crownRatio)
+{
+    slope_ = slope;
+    aspect_ = aspect;
+
+    // Only mark the groups whose inputs differ from the previous cell, so runs of similar cells reuse results
+    if (fuelModelNumber_ != fuelModelNumber || moistureInputMode_ != MoistureInputMode::BySizeClass)
+    {
+        markFuelbedInputsChanged();
+    }
+    if (windSpeed_ != windSpeed || canopyCover_ != canopyCover || canopyHeight_ != canopyHeight || crownRatio_ != crownRatio)
+    {
+        markWindInputsChanged();
+    }
+
+    fuelModelNumber_ = fuelModelNumber;
+
+    moistureInputMode_ = MoistureInputMode::BySizeClass;
+    moistureOneHour_ = moistureOneHour;
+    moistureTenHour_ = moistureTenHour;
+    moistureHundredHour_ = moistureHundredHour;
+    moistureLiveHerbaceous_ = moistureLiveHerbaceous;
+    moistureLiveWoody_ = moistureLiveWoody;
+    updateMoisturesBasedOnInputMode();
+
+    windSpeed_ = windSpeed;
+    if (windDirection < 0.0)
+    {
+        windDirection += 360.0;
+    }
+    while (windDirection >= 360.0)
+    {
+        windDirection -= 360.0;
+    }
+    windDirection_ = windDirection;
+    isUsingTwoFuelModels_ = false;
+    twoFuelModelsMethod_ = TwoFuelModelsMethod::NoMethod;
+
+    canopyCover_ = canopyCover;
+    canopyHeight_ = canopyHeight;
+    crownRatio_ = crownRatio;
+}
+
 void  SurfaceInputs::updateSurfaceInputsForTwoFuelModels(int firstfuelModelNumber, int secondFuelModelNumber,
     double moistureOneHour, double moistureTenHour, double moistureHundredHour, double moistureLiveHerbaceous,
     double moistureLiveWoody, FractionUnits::FractionUnitsEnum moistureUnits, double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits, 
@@ -203,26 +265,31 @@ void SurfaceInputs::updateSurfaceInputsForWesternAspen(int aspenFuelModelNumber,
 
 void SurfaceInputs::setAspenFuelModelNumber(int aspenFuelModelNumber)
 {
+    markFuelbedInputsChanged();
     aspenFuelModelNumber_ = aspenFuelModelNumber;
 }
 
 void SurfaceInputs::setAspenCuringLevel(double aspenCuringLevel, FractionUnits::FractionUnitsEnum fractionUnits)
 {
+    markFuelbedInputsChanged();
     aspenCuringLevel_ = FractionUnits::toBaseUnits(aspenCuringLevel, fractionUnits);
 }
 
 void SurfaceInputs::setAspenDBH(double dbh, LengthUnits::LengthUnitsEnum dbhUnits)
 {
+    markFuelbedInputsChanged();
     dbh_ = LengthUnits::toBaseUnits(dbh, dbhUnits);
 }
 
 void SurfaceInputs::setAspenFireSeverity(AspenFireSeverity::AspenFireSeverityEnum aspenFireSeverity)
 {
+    markFuelbedInputsChanged();
     aspenFireSeverity_ = aspenFireSeverity;
 }
 
 void SurfaceInputs::setIsUsingWesternAspen(bool isUsingWesternAspen)
 {
+    markFuelbedInputsChanged();
     isUsingWesternAspen_ = isUsingWesternAspen;
     if (isUsingWesternAspen_)
     {
@@ -234,16 +301,19 @@ void SurfaceInputs::setIsUsingWesternAspen(bool isUsingWesternAspen)
 
 void SurfaceInputs::setCanopyCover(double canopyCover, FractionUnits::FractionUnitsEnum fractionUnits)
 {
+    markWindInputsChanged();
     canopyCover_ = FractionUnits::toBaseUnits(canopyCover, fractionUnits);
 }
 
 void SurfaceInputs::setCanopyHeight(double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits)
 {
+    markWindInputsChanged();
     canopyHeight_ = LengthUnits::toBaseUnits(canopyHeight, canopyHeightUnits);
 }
 
 void SurfaceInputs::setCrownRatio(double crownRatio, FractionUnits::FractionUnitsEnum crownRatioUnits)
 {
+    markWindInputsChanged();
     crownRatio_ = FractionUnits::toBaseUnits(crownRatio, crownRatioUnits);
 }
 
@@ -254,11 +324,13 @@ void SurfaceInputs::setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode
 
 void SurfaceInputs::setWindHeightInputMode(WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
 {
+    markWindInputsChanged();
     windHeightInputMode_ = windHeightInputMode;
 }
 
 void SurfaceInputs::setFuelModelNumber(int fuelModelNumber)
 {
+    markFuelbedInputsChanged();
     fuelModelNumber_ = fuelModelNumber;
 }
 
@@ -304,7 +376,7 @@ void SurfaceInputs::setMoistureLiveAggregate(double moistureLiveAggregate, Fract
     updateMoisturesBasedOnInputMode();
 }
 
-void SurfaceInputs::setMoistureScenarios(MoistureScenarios& moistureScenarios)
+void SurfaceInputs::setMoistureScenarios(const MoistureScenarios& moistureScenarios)
 {
     moistureScenarios_ = &moistureScenarios;
 }
@@ -314,13 +386,13 @@ bool SurfaceInputs::setCurrentMoistureScenarioByName(std::string moistureScenari
     bool isMoistureScenarioDefined = false;
     if (moistureScenarios_ != nullptr)
     {
-        isMoistureScenarioDefined = moistureScenarios_->getIsMoistureScenarioDefinedByName(moistureScenarioName);
-        moistureScenarios_->getIsMoistureScenarioDefinedByName(moistureScenarioName);
+        int moistureScenarioIndex = moistureScenarios_->getMoistureScenarioIndexByName(moistureScenarioName);
+        isMoistureScenarioDefined = (moistureScenarioIndex >= 0);
         currentMoistureScenarioName_ = "";
         if (isMoistureScenarioDefined)
         {
             currentMoistureScenarioName_ = moistureScenarioName;
-            currentMoistureScenarioIndex_ = moistureScenarios_->getMoistureScenarioIndexByName(moistureScenarioName);
+            currentMoistureScenarioIndex_ = moistureScenarioIndex;
             updateMoisturesBasedOnInputMode();
         }
     }
@@ -346,6 +418,7 @@ bool SurfaceInputs::setCurrentMoistureScenarioByIndex(int moistureScenarioIndex)
 
 void SurfaceInputs::setMoistureInputMode(MoistureInputMode::MoistureInputModeEnum moistureInputMode)
 {
+    markFuelbedInputsChanged();
     moistureInputMode_ = moistureInputMode;
     updateMoisturesBasedOnInputMode();
 }
@@ -372,6 +445,7 @@ void SurfaceInputs::setTwoFuelModelsFirstFuelModelCoverage(double firstFuelModel
 
 void  SurfaceInputs::setWindSpeed(double windSpeed, SpeedUnits::SpeedUnitsEnum windSpeedUnits, WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode)
 {
+    markWindInputsChanged();
     windHeightInputMode_ = windHeightInputMode;
     windSpeed_ = SpeedUnits::toBaseUnits(windSpeed, windSpeedUnits);
 }
@@ -383,6 +457,7 @@ void  SurfaceInputs::setWindDirection(double windDirection)
 
 void  SurfaceInputs::setFirstFuelModelNumber(int firstFuelModelNumber)
 {
+    markFuelbedInputsChanged();
     fuelModelNumber_ = firstFuelModelNumber;
 }
 
@@ -493,6 +568,7 @@ double SurfaceInputs::getMoistureLiveAggregateValue(FractionUnits::FractionUnits
 
 void SurfaceInputs::setPalmettoGallberryAgeOfRough(double ageOfRough)
 {
+    markFuelbedInputsChanged();
     ageOfRough_ = ageOfRough;
 }
 
@@ -503,6 +579,7 @@ double SurfaceInputs::getPalmettoGallberryAgeOfRough() const
 
 void SurfaceInputs::setPalmettoGallberryHeightOfUnderstory(double heightOfUnderstory, LengthUnits::LengthUnitsEnum heightUnits)
 {
+    markFuelbedInputsChanged();
     heightOfUnderstory_ = LengthUnits::toBaseUnits(heightOfUnderstory, heightUnits);
 }
 
@@ -512,6 +589,7 @@ double SurfaceInputs::getPalmettoGallberryHeightOfUnderstory(LengthUnits::Length
 }
 void SurfaceInputs::setPalmettoGallberryPalmettoCoverage(double palmettoCoverage, FractionUnits::FractionUnitsEnum fractionUnits)
 {
+    markFuelbedInputsChanged();
     palmettoCoverage_ = FractionUnits::toBaseUnits(palmettoCoverage, fractionUnits);
 }
 
@@ -522,11 +600,13 @@ double SurfaceInputs::getPalmettoGallberryPalmettoCoverage(FractionUnits::Fracti
 
 void SurfaceInputs::setPalmettoGallberryOverstoryBasalArea(double overstoryBasalArea, BasalAreaUnits::BasalAreaUnitsEnum basalAreaUnits)
 {
+    markFuelbedInputsChanged();
     overstoryBasalArea_ = BasalAreaUnits::toBaseUnits(overstoryBasalArea, basalAreaUnits);
 }
 
 void SurfaceInputs::setIsUsingPalmettoGallberry(bool isUsingPalmettoGallberry)
 {
+    markFuelbedInputsChanged();
     isUsingPalmettoGallberry_ = isUsingPalmettoGallberry;
     if (isUsingPalmettoGallberry_)
     {
@@ -583,31 +663,51 @@ AspenFireSeverity::AspenFireSeverityEnum SurfaceInputs::getAspenFireSeverity() c
 
 void SurfaceInputs::setChaparralFuelLoadInputMode(ChaparralFuelLoadInputMode::ChaparralFuelInputLoadModeEnum fuelLoadInputMode)
 {
+    markFuelbedInputsChanged();
     chaparralFuelLoadInputMode_ = fuelLoadInputMode;
 }
 
 void SurfaceInputs::setChaparralFuelType(ChaparralFuelType::ChaparralFuelTypeEnum chaparralFuelType)
 {
+    markFuelbedInputsChanged();
     chaparralFuelType_ = chaparralFuelType;
 }
 
 void SurfaceInputs::setChaparralFuelBedDepth(double chaparralFuelBedDepth, LengthUnits::LengthUnitsEnum depthUnits)
 {
+    markFuelbedInputsChanged();
     chaparralFuelBedDepth_ = LengthUnits::toBaseUnits(chaparralFuelBedDepth, depthUnits);
 }
 
 void SurfaceInputs::setChaparralFuelDeadLoadFraction(double chaparralFuelDeadLoadFraction)
 {
+    markFuelbedInputsChanged();
     chaparralFuelDeadLoadFraction_ = chaparralFuelDeadLoadFraction;
 }
 
 void SurfaceInputs::setChaparralTotalFuelLoad(double chaparralTotalFuelLoad, LoadingUnits::LoadingUnitsEnum fuelLoadUnits)
 {
+    markFuelbedInputsChanged();
     chaparralTotalFuelLoad_ = LoadingUnits::toBaseUnits(chaparralTotalFuelLoad, fuelLoadUnits);
 }
 
+void SurfaceInputs::updateChaparralInputsInBaseUnits(double chaparralFuelBedDepth, double chaparralTotalFuelLoad,
+    double chaparralFuelDeadLoadFraction)
+{
+    if (chaparralFuelLoadInputMode_ != ChaparralFuelLoadInputMode::DirectFuelLoad || chaparralFuelBedDepth_ != chaparralFuelBedDepth ||
+        chaparralTotalFuelLoad_ != chaparralTotalFuelLoad || chaparralFuelDeadLoadFraction_ != chaparralFuelDeadLoadFraction)
+    {
+        markFuelbedInputsChanged();
+    }
+    chaparralFuelLoadInputMode_ = ChaparralFuelLoadInputMode::DirectFuelLoad;
+    chaparralFuelBedDepth_ = chaparralFuelBedDepth;
+    chaparralTotalFuelLoad_ = chaparralTotalFuelLoad;
+    chaparralFuelDeadLoadFraction_ = chaparralFuelDeadLoadFraction;
+}
+
 void SurfaceInputs::setIsUsingChaparral(bool isUsingChaparral)
 {
+    markFuelbedInputsChanged();
     isUsingChaparral_ = isUsingChaparral;
     if (isUsingChaparral_)
     {
@@ -697,15 +797,32 @@ void SurfaceInputs::memberwiseCopyAssignment(const SurfaceInputs & rhs)
     windAndSpreadOrientationMode_ = rhs.windAndSpreadOrientationMode_;
     windAdjustmentFactorCalculationMethod_ = rhs.windAdjustmentFactorCalculationMethod_;
     surfaceFireSpreadDirectionMode_ = rhs.surfaceFireSpreadDirectionMode_;
+    surfaceFireOutputs_ = rhs.surfaceFireOutputs_;
+    twoDimensionalSpreadMode_ = rhs.twoDimensionalSpreadMode_;
 
     moistureScenarios_ = rhs.moistureScenarios_;
     currentMoistureScenarioName_ = rhs.currentMoistureScenarioName_;
     currentMoistureScenarioIndex_ = rhs.currentMoistureScenarioIndex_;
     moistureValuesBySizeClass_ = rhs.moistureValuesBySizeClass_;
+
+    chaparralFuelLoadInputMode_ = rhs.chaparralFuelLoadInputMode_;
+    chaparralFuelType_ = rhs.chaparralFuelType_;
+    chaparralFuelBedDepth_ = rhs.chaparralFuelBedDepth_;
+    chaparralFuelDeadLoadFraction_ = rhs.chaparralFuelDeadLoadFraction_;
+    chaparralTotalFuelLoad_ = rhs.chaparralTotalFuelLoad_;
+
+    fuelbedInputsRevision_ = rhs.fuelbedInputsRevision_;
+    windInputsRevision_ = rhs.windInputsRevision_;
 }
 
 void SurfaceInputs::updateMoisturesBasedOnInputMode()
 {
+    double previousMoistureValues[MoistureClassInput::LiveAggregate + 1];
+    for (int i = 0; i <= MoistureClassInput::LiveAggregate; i++)
+    {
+        previousMoistureValues[i] = moistureValuesBySizeClass_[i];
+    }
+
     if(moistureInputMode_ == MoistureInputMode::BySizeClass)
     {
         moistureValuesBySizeClass_[MoistureClassInput::OneHour] = moistureOneHour_;
@@ -750,11 +867,9 @@ void SurfaceInputs::updateMoisturesBasedOnInputMode()
     {
         if (moistureScenarios_ != nullptr)
         {
-            moistureValuesBySizeClass_[MoistureClassInput::OneHour] = moistureScenarios_->getMoistureScenarioOneHourByIndex(currentMoistureScenarioIndex_, FractionUnits::Fraction);
-            moistureValuesBySizeClass_[MoistureClassInput::TenHour] = moistureScenarios_->getMoistureScenarioTenHourByIndex(currentMoistureScenarioIndex_, FractionUnits::Fraction);
-            moistureValuesBySizeClass_[MoistureClassInput::HundredHour] = moistureScenarios_->getMoistureScenarioHundredHourByIndex(currentMoistureScenarioIndex_, FractionUnits::Fraction);
-            moistureValuesBySizeClass_[MoistureClassInput::LiveHerbaceous] = moistureScenarios_->getMoistureScenarioLiveHerbaceousByIndex(currentMoistureScenarioIndex_, FractionUnits::Fraction);
-            moistureValuesBySizeClass_[MoistureClassInput::LiveWoody] = moistureScenarios_->getMoistureScenarioLiveWoodyByIndex(currentMoistureScenarioIndex_, FractionUnits::Fraction);
+            // One hour through live woody, in MoistureClassInput order
+            moistureScenarios_->getMoistureScenarioMoisturesByIndex(currentMoistureScenarioIndex_, FractionUnits::Fraction,
+                &moistureValuesBySizeClass_[MoistureClassInput::OneHour]);
             moistureValuesBySizeClass_[MoistureClassInput::DeadAggregate] = -1.0;
             moistureValuesBySizeClass_[MoistureClassInput::LiveAggregate] = -1.0;
         }
@@ -766,15 +881,49 @@ void SurfaceInputs::updateMoisturesBasedOnInputMode()
             }
         }
     }
+
+    for (int i = 0; i <= MoistureClassInput::LiveAggregate; i++)
+    {
+        if (moistureValuesBySizeClass_[i] != previousMoistureValues[i])
+        {
+            markFuelbedInputsChanged();
+            break;
+        }
+    }
+}
+
+void SurfaceInputs::copyWindAndMoistureInputs(const SurfaceInputs& rhs)
+{
+    if((windSpeed_ != rhs.windSpeed_) || (windHeightInputMode_ != rhs.windHeightInputMode_))
+    {
+        markWindInputsChanged();
+        windSpeed_ = rhs.windSpeed_;
+        windHeightInputMode_ = rhs.windHeightInputMode_;
+    }
+
+    moistureInputMode_ = rhs.moistureInputMode_;
+    moistureOneHour_ = rhs.moistureOneHour_;
+    moistureTenHour_ = rhs.moistureTenHour_;
+    moistureHundredHour_ = rhs.moistureHundredHour_;
+    moistureLiveHerbaceous_ = rhs.moistureLiveHerbaceous_;
+    moistureLiveWoody_ = rhs.moistureLiveWoody_;
+    moistureDeadAggregate_ = rhs.moistureDeadAggregate_;
+    moistureLiveAggregate_ = rhs.moistureLiveAggregate_;
+    currentMoistureScenarioName_ = rhs.currentMoistureScenarioName_;
+    currentMoistureScenarioIndex_ = rhs.currentMoistureScenarioIndex_;
+    moistureScenarios_ = rhs.moistureScenarios_;
+    updateMoisturesBasedOnInputMode(); // Marks the fuelbed inputs changed if any moisture differs
 }
 
 void SurfaceInputs::setUserProvidedWindAdjustmentFactor(double userProvidedWindAdjustmentFactor)
 {
+    markWindInputsChanged();
     userProvidedWindAdjustmentFactor_ = userProvidedWindAdjustmentFactor;
 }
 
 void SurfaceInputs::setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod)
 {
+    markWindInputsChanged();
     windAdjustmentFactorCalculationMethod_ = windAdjustmentFactorCalculationMethod;
 }
 
@@ -793,6 +942,16 @@ void SurfaceInputs::setIsCalculatingScorchHeight(bool IsCalculatingScorchHeight)
     isCalculatingScorchHeight_ = IsCalculatingScorchHeight;
 }
 
+void SurfaceInputs::setSurfaceFireOutputs(int surfaceFireOutputs)
+{
+    surfaceFireOutputs_ = surfaceFireOutputs;
+}
+
+void SurfaceInputs::setTwoDimensionalSpreadMode(TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum twoDimensionalSpreadMode)
+{
+    twoDimensionalSpreadMode_ = twoDimensionalSpreadMode;
+}
+
 double SurfaceInputs::getUserProvidedWindAdjustmentFactor() const
 {
     return userProvidedWindAdjustmentFactor_;
@@ -818,6 +977,16 @@ bool SurfaceInputs::getIsCalculatingScorchHeight() const
     return isCalculatingScorchHeight_;
 }
 
+int SurfaceInputs::getSurfaceFireOutputs() const
+{
+    return surfaceFireOutputs_;
+}
+
+TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum SurfaceInputs::getTwoDimensionalSpreadMode() const
+{
+    return twoDimensionalSpreadMode_;
+}
+
 bool SurfaceInputs::isMoistureClassInputNeeded(MoistureClassInput::MoistureClassInputEnum moistureClass) const
 {
     bool isMoistureClassNeeded = false;
@@ -1037,3 +1206,76 @@ double SurfaceInputs::getMoistureScenarioLiveWoodyByIndex(const int index, Fract
     }
     return liveWoodyMoisture;
 }
+
+unsigned long SurfaceInputs::getFuelbedInputsRevision() const
+{
+    return fuelbedInputsRevision_;
+}
+
+unsigned long SurfaceInputs::getWindInputsRevision() const
+{
+    return windInputsRevision_;
+}
+
+bool SurfaceInputs::hasSameInputs(const SurfaceInputs& rhs) const
+{
+    return airTemperature_ == rhs.airTemperature_ &&
+        fuelModelNumber_ == rhs.fuelModelNumber_ &&
+        moistureOneHour_ == rhs.moistureOneHour_ &&
+        moistureTenHour_ == rhs.moistureTenHour_ &&
+        moistureHundredHour_ == rhs.moistureHundredHour_ &&
+        moistureLiveHerbaceous_ == rhs.moistureLiveHerbaceous_ &&
+        moistureLiveWoody_ == rhs.moistureLiveWoody_ &&
+        windSpeed_ == rhs.windSpeed_ &&
+        windDirection_ == rhs.windDirection_ &&
+        slope_ == rhs.slope_ &&
+        aspect_ == rhs.aspect_ &&
+        moistureDeadAggregate_ == rhs.moistureDeadAggregate_ &&
+        moistureLiveAggregate_ == rhs.moistureLiveAggregate_ &&
+        moistureInputMode_ == rhs.moistureInputMode_ &&
+        isCalculatingScorchHeight_ == rhs.isCalculatingScorchHeight_ &&
+        isUsingTwoFuelModels_ == rhs.isUsingTwoFuelModels_ &&
+        secondFuelModelNumber_ == rhs.secondFuelModelNumber_ &&
+        firstFuelModelCoverage_ == rhs.firstFuelModelCoverage_ &&
+        isUsingPalmettoGallberry_ == rhs.isUsingPalmettoGallberry_ &&
+        ageOfRough_ == rhs.ageOfRough_ &&
+        heightOfUnderstory_ == rhs.heightOfUnderstory_ &&
+        palmettoCoverage_ == rhs.palmettoCoverage_ &&
+        overstoryBasalArea_ == rhs.overstoryBasalArea_ &&
+        isUsingWesternAspen_ == rhs.isUsingWesternAspen_ &&
+        aspenFuelModelNumber_ == rhs.aspenFuelModelNumber_ &&
+        aspenCuringLevel_ == rhs.aspenCuringLevel_ &&
+        dbh_ == rhs.dbh_ &&
+        aspenFireSeverity_ == rhs.aspenFireSeverity_ &&
+        isUsingChaparral_ == rhs.isUsingChaparral_ &&
+        elapsedTime_ == rhs.elapsedTime_ &&
+        canopyCover_ == rhs.canopyCover_ &&
+        canopyHeight_ == rhs.canopyHeight_ &&
+        crownRatio_ == rhs.crownRatio_ &&
+        userProvidedWindAdjustmentFactor_ == rhs.userProvidedWindAdjustmentFactor_ &&
+        twoFuelModelsMethod_ == rhs.twoFuelModelsMethod_ &&
+        windHeightInputMode_ == rhs.windHeightInputMode_ &&
+        windAndSpreadOrientationMode_ == rhs.windAndSpreadOrientationMode_ &&
+        windAdjustmentFactorCalculationMethod_ == rhs.windAdjustmentFactorCalculationMethod_ &&
+        surfaceFireSpreadDirectionMode_ == rhs.surfaceFireSpreadDirectionMode_ &&
+        surfaceFireOutputs_ == rhs.surfaceFireOutputs_ &&
+        twoDimensionalSpreadMode_ == rhs.twoDimensionalSpreadMode_ &&
+        moistureScenarios_ == rhs.moistureScenarios_ &&
+        currentMoistureScenarioName_ == rhs.currentMoistureScenarioName_ &&
+        currentMoistureScenarioIndex_ == rhs.currentMoistureScenarioIndex_ &&
+        chaparralFuelLoadInputMode_ == rhs.chaparralFuelLoadInputMode_ &&
+        chaparralFuelType_ == rhs.chaparralFuelType_ &&
+        chaparralFuelBedDepth_ == rhs.chaparralFuelBedDepth_ &&
+        chaparralFuelDeadLoadFraction_ == rhs.chaparralFuelDeadLoadFraction_ &&
+        chaparralTotalFuelLoad_ == rhs.chaparralTotalFuelLoad_;
+}
+
+void SurfaceInputs::markFuelbedInputsChanged()
+{
+    fuelbedInputsRevision_ = nextInputsRevision++;
+}
+
+void SurfaceInputs::markWindInputsChanged()
+{
+    windInputsRevision_ = nextInputsRevision++;
+}
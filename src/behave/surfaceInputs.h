@@ -49,6 +49,9 @@ public:
         double windDirection, WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode, 
         double slope, SlopeUnits::SlopeUnitsEnum slopeUnits, double aspect, double canopyCover, FractionUnits::FractionUnitsEnum fractionUnits,
         double canopyHeight, LengthUnits::LengthUnitsEnum canopyHeightUnits, double crownRatio, FractionUnits::FractionUnitsEnum crownRatioUnits);
+    void updateSurfaceInputsInBaseUnits(int fuelModelNumber, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
+        double moistureLiveHerbaceous, double moistureLiveWoody, double windSpeed, double windDirection, double slope, double aspect,
+        double canopyCover, double canopyHeight, double crownRatio);
     void setFuelModelNumber(int fuelModelNumber);
     void setMoistureOneHour(double moistureOneHour, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureTenHour(double moistureTenHour, FractionUnits::FractionUnitsEnum moistureUnits);
@@ -57,7 +60,7 @@ public:
     void setMoistureLiveWoody(double moistureLiveWoody, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureDeadAggregate(double moistureDeadAggregate, FractionUnits::FractionUnitsEnum moistureUnits);
     void setMoistureLiveAggregate(double moistureLiveAggregate, FractionUnits::FractionUnitsEnum moistureUnits);
-    void setMoistureScenarios(MoistureScenarios& moistureScenarios);
+    void setMoistureScenarios(const MoistureScenarios& moistureScenarios);
     bool setCurrentMoistureScenarioByName(std::string moistureScenarioName);
     bool setCurrentMoistureScenarioByIndex(int moistureScenarioIndex);
     void setMoistureInputMode(MoistureInputMode::MoistureInputModeEnum moistureInputMode);
@@ -75,6 +78,13 @@ public:
     void setElapsedTime(double elapsedTime, TimeUnits::TimeUnitsEnum timeUnits);
     void setAirTemperature(double airTemperature, TemperatureUnits::TemperatureUnitsEnum temperatureUnits);
     void setIsCalculatingScorchHeight(bool IsCalculatingScorchHeight);
+    // Combination of SurfaceFireOutputs flags, defaults to SurfaceFireOutputs::All
+    void setSurfaceFireOutputs(int surfaceFireOutputs);
+    // How TwoFuelModelsMethod::TwoDimensional works out the spread rate, defaults to Exact
+    void setTwoDimensionalSpreadMode(TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum twoDimensionalSpreadMode);
+    // Copies only the wind speed, wind height input mode and moisture inputs, marking the
+    // groups whose values changed
+    void copyWindAndMoistureInputs(const SurfaceInputs& rhs);
 
     // Main Surface module inputs getters 
     int getFuelModelNumber() const;
@@ -100,6 +110,8 @@ public:
     double getElapsedTime(TimeUnits::TimeUnitsEnum timeUnits) const;
     double getAirTemperature(TemperatureUnits::TemperatureUnitsEnum temperatureUnits) const;
     bool getIsCalculatingScorchHeight() const;
+    int getSurfaceFireOutputs() const;
+    TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum getTwoDimensionalSpreadMode() const;
     bool isMoistureClassInputNeeded(MoistureClassInput::MoistureClassInputEnum moistureSizeClass) const;
     MoistureInputMode::MoistureInputModeEnum getMoistureInputMode() const;
     std::string getCurrentMoistureScenarioName() const;
@@ -193,6 +205,8 @@ public:
     void setChaparralFuelDeadLoadFraction(double chaparralFuelDeadLoadFraction);
     void setChaparralTotalFuelLoad(double chaparralTotalFuelLoad, LoadingUnits::LoadingUnitsEnum fuelLoadUnits);
     void setIsUsingChaparral(bool isUsingChaparral);
+    // Direct fuel load mode inputs in ft and lb/ft2, marking the fuelbed group only if a value changed
+    void updateChaparralInputsInBaseUnits(double chaparralFuelBedDepth, double chaparralTotalFuelLoad, double chaparralFuelDeadLoadFraction);
 
     // Chaparral inputs getters
     ChaparralFuelLoadInputMode::ChaparralFuelInputLoadModeEnum getChaparralFuelLoadInputMode() const;
@@ -202,8 +216,18 @@ public:
     double getChaparralTotalFuelLoad(LoadingUnits::LoadingUnitsEnum fuelLoadUnits) const;
     bool getIsUsingChaparral() const;
 
+    // Revisions change whenever an input of their group is set, so a run can tell which of its
+    // previous results are still valid. Revisions are unique across all SurfaceInputs objects.
+    unsigned long getFuelbedInputsRevision() const;   // inputs of the fuelbed intermediates and reaction intensity
+    unsigned long getWindInputsRevision() const;      // inputs of the midflame wind speed
+
+    // Whether every input, but not the revisions or the moistures worked out from them, is the same as rhs's
+    bool hasSameInputs(const SurfaceInputs& rhs) const;
+
 protected:   
     void memberwiseCopyAssignment(const SurfaceInputs& rhs);
+    void markFuelbedInputsChanged();
+    void markWindInputsChanged();
    
     bool isCalculatingScorchHeight_;    // Switch to determine whether scorch height is calculated (requires air temperature to be set)
     int fuelModelNumber_;               // 1 to 256
@@ -227,7 +251,7 @@ protected:
     std::string currentMoistureScenarioName_;  // Currently used moisture scenario name
     int currentMoistureScenarioIndex_;         // Currently used moisture scenario vector index
     std::vector<double> moistureValuesBySizeClass_; // Stores moisture values which will be used during surface and crown runs
-    MoistureScenarios* moistureScenarios_; // Moisture scenarios (optional list of moisture scenarios to simplify user input 
+    const MoistureScenarios* moistureScenarios_; // Moisture scenarios (optional list of moisture scenarios to simplify user input 
 
     // Two Fuel Models inputs
     bool isUsingTwoFuelModels_;         // Whether fire spread calculation is using Two Fuel Models
@@ -271,6 +295,12 @@ protected:
     WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode_;
     WindAdjustmentFactorCalculationMethod::WindAdjustmentFactorCalculationMethodEnum windAdjustmentFactorCalculationMethod_;
     SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum surfaceFireSpreadDirectionMode_;
+    int surfaceFireOutputs_;            // SurfaceFireOutputs flags of the outputs runs calculate
+    TwoDimensionalSpreadMode::TwoDimensionalSpreadModeEnum twoDimensionalSpreadMode_;
+
+    // Change tracking
+    unsigned long fuelbedInputsRevision_;
+    unsigned long windInputsRevision_;
 };
 
 #endif // SURFACEINPUTS_H
@@ -0,0 +1,505 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Stateless surface fire kernel over plain input and output structs
+*           for a standard fuel model
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "surfaceKernel.h"
+
+BEHAVE_OFFLOAD_BEGIN_DECLARE_TARGET
+namespace
+{
+
+// Index of the SAVR size class of SurfaceFuelbedIntermediates::sumFractionOfTotalSurfaceAreaBySizeClass(),
+// or -1 below 16 ft^2/ft^3
+int getSavrSizeClass(double savr)
+{
+    if (savr >= 1200.0)
+    {
+        return 0;
+    }
+    else if (savr >= 192.0)
+    {
+        return 1;
+    }
+    else if (savr >= 96.0)
+    {
+        return 2;
+    }
+    else if (savr >= 48.0)
+    {
+        return 3;
+    }
+    else if (savr >= 16.0)
+    {
+        return 4;
+    }
+    return -1;
+}
+
+void setNoFireOutputs(SurfaceKernelOutputs& outputs)
+{
+    outputs.noWindNoSlopeSpreadRate = 0.0;
+    outputs.spreadRate = 0.0;
+    outputs.backingSpreadRate = 0.0;
+    outputs.flankingSpreadRate = 0.0;
+    outputs.directionOfMaxSpread = 0.0;
+    outputs.effectiveWindSpeed = 0.0;
+    outputs.fireLengthToWidthRatio = 1.0;
+    outputs.firelineIntensity = 0.0;
+    outputs.flameLength = 0.0;
+    outputs.isWindLimitExceeded = false;
+}
+
+}
+BEHAVE_OFFLOAD_END_DECLARE_TARGET
+
+bool SurfaceKernel::loadFuelModel(const FuelModels& fuelModels, int fuelModelNumber, SurfaceKernelFuelModel& fuelModel)
+{
+    if (!fuelModels.isFuelModelDefined(fuelModelNumber) || fuelModels.isAllFuelLoadZero(fuelModelNumber))
+    {
+        return false;
+    }
+
+    fuelModel.fuelbedDepth = fuelModels.getFuelbedDepth(fuelModelNumber, LengthUnits::Feet);
+    fuelModel.moistureOfExtinctionDead = fuelModels.getMoistureOfExtinctionDead(fuelModelNumber, FractionUnits::Fraction);
+    fuelModel.heatOfCombustionDead = fuelModels.getHeatOfCombustionDead(fuelModelNumber, HeatOfCombustionUnits::BtusPerPound);
+    fuelModel.heatOfCombustionLive = fuelModels.getHeatOfCombustionLive(fuelModelNumber, HeatOfCombustionUnits::BtusPerPound);
+    fuelModel.fuelLoadOneHour = fuelModels.getFuelLoadOneHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot);
+    fuelModel.fuelLoadTenHour = fuelModels.getFuelLoadTenHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot);
+    fuelModel.fuelLoadHundredHour = fuelModels.getFuelLoadHundredHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot);
+    fuelModel.fuelLoadLiveHerbaceous = fuelModels.getFuelLoadLiveHerbaceous(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot);
+    fuelModel.fuelLoadLiveWoody = fuelModels.getFuelLoadLiveWoody(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot);
+    fuelModel.savrOneHour = fuelModels.getSavrOneHour(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+    fuelModel.savrLiveHerbaceous = fuelModels.getSavrLiveHerbaceous(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+    fuelModel.savrLiveWoody = fuelModels.getSavrLiveWoody(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+    fuelModel.isDynamic = fuelModels.getIsDynamic(fuelModelNumber);
+
+    const FuelModels::StaticFuelbedConstants* staticConstants = fuelModels.getStaticFuelbedConstants(fuelModelNumber);
+    fuelModel.hasStaticFuelbedConstants = (staticConstants != nullptr);
+    fuelModel.staticFuelbedConstants = (staticConstants) ? (*staticConstants) : FuelModels::StaticFuelbedConstants();
+    return true;
+}
+
+void SurfaceKernel::calculate(const SurfaceKernelFuelModel& fuelModel, const SurfaceKernelInputs& inputs, SurfaceKernelOutputs& outputs)
+{
+    calculateSurfaceKernel(fuelModel, inputs, outputs);
+}
+
+BEHAVE_OFFLOAD_BEGIN_DECLARE_TARGET
+void calculateSurfaceKernel(const SurfaceKernelFuelModel& fuelModel, const SurfaceKernelInputs& inputs, SurfaceKernelOutputs& outputs)
+{
+    const int maxParticles = FuelConstants::MaxParticles;
+    const int dead = FuelLifeState::Dead;
+    const int live = FuelLifeState::Live;
+    const double fuelDensity = 32.0; // Average density of dry fuel in lbs/ft^3, Albini 1976, p. 91
+    const double totalSilicaContent = 0.0555;
+    const double silicaEffective = 0.01;
+    const FuelModels::StaticFuelbedConstants* staticConstants = (fuelModel.hasStaticFuelbedConstants)
+        ? (&fuelModel.staticFuelbedConstants)
+        : (nullptr);
+
+    outputs.reactionIntensity = 0.0;
+    outputs.heatSink = 0.0;
+    outputs.residenceTime = 0.0;
+    outputs.heatPerUnitArea = 0.0;
+    setNoFireOutputs(outputs);
+
+    // Fuel loads, moistures and SAVR
+    double depth = fuelModel.fuelbedDepth;
+    double loadDead[maxParticles] = { fuelModel.fuelLoadOneHour, fuelModel.fuelLoadTenHour, fuelModel.fuelLoadHundredHour, 0.0, 0.0 };
+    double loadLive[maxParticles] = { fuelModel.fuelLoadLiveHerbaceous, fuelModel.fuelLoadLiveWoody, 0.0, 0.0, 0.0 };
+
+    int numberOfSizeClasses[FuelConstants::MaxLifeStates] = { 0, 0 };
+    for (int i = 0; i < FuelConstants::MaxDeadSizeClasses; i++)
+    {
+        if (loadDead[i])
+        {
+            numberOfSizeClasses[dead] = FuelConstants::MaxDeadSizeClasses;
+        }
+    }
+    for (int i = 0; i < FuelConstants::MaxLiveSizeClasses; i++)
+    {
+        if (loadLive[i])
+        {
+            numberOfSizeClasses[live] = FuelConstants::MaxLiveSizeClasses;
+        }
+    }
+    if (numberOfSizeClasses[dead] == 0 && numberOfSizeClasses[live] == 0)
+    {
+        // No fuel to burn
+        return;
+    }
+
+    const double moistureDead[maxParticles] = { inputs.moistureOneHour, inputs.moistureTenHour, inputs.moistureHundredHour,
+        inputs.moistureOneHour, 0.0 };
+    const double moistureLive[maxParticles] = { inputs.moistureLiveHerbaceous, inputs.moistureLiveWoody, 0.0, 0.0, 0.0 };
+    const double savrDead[maxParticles] = { fuelModel.savrOneHour, 109.0, 30.0, fuelModel.savrLiveHerbaceous, 0.0 };
+    const double savrLive[maxParticles] = { fuelModel.savrLiveHerbaceous, fuelModel.savrLiveWoody, 0.0, 0.0, 0.0 };
+
+    if (fuelModel.isDynamic)
+    {
+        if (moistureLive[0] < 0.30)
+        {
+            loadDead[3] = loadLive[0];
+            loadLive[0] = 0.0;
+        }
+        else if (moistureLive[0] <= 1.20)
+        {
+            loadDead[3] = loadLive[0] * (1.333 - 1.11 * moistureLive[0]); // To keep consistant with BehavePlus
+            loadLive[0] -= loadDead[3];
+        }
+    }
+
+    // Fuel surface area weighting factors
+    double totalSurfaceArea[FuelConstants::MaxLifeStates] = { 0.0, 0.0 };
+    double surfaceAreaDead[maxParticles] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    double surfaceAreaLive[maxParticles] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    double fractionOfTotalSurfaceAreaDead[maxParticles] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    double fractionOfTotalSurfaceAreaLive[maxParticles] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    for (int i = 0; i < numberOfSizeClasses[dead]; i++)
+    {
+        surfaceAreaDead[i] = loadDead[i] * savrDead[i] / fuelDensity;
+        totalSurfaceArea[dead] += surfaceAreaDead[i];
+    }
+    for (int i = 0; i < numberOfSizeClasses[live]; i++)
+    {
+        surfaceAreaLive[i] = loadLive[i] * savrLive[i] / fuelDensity;
+        totalSurfaceArea[live] += surfaceAreaLive[i];
+    }
+    if (totalSurfaceArea[dead] > 1.0e-7)
+    {
+        for (int i = 0; i < numberOfSizeClasses[dead]; i++)
+        {
+            fractionOfTotalSurfaceAreaDead[i] = surfaceAreaDead[i] / totalSurfaceArea[dead];
+        }
+    }
+    if (totalSurfaceArea[live] > 1.0e-7)
+    {
+        for (int i = 0; i < numberOfSizeClasses[live]; i++)
+        {
+            fractionOfTotalSurfaceAreaLive[i] = surfaceAreaLive[i] / totalSurfaceArea[live];
+        }
+    }
+
+    double summedFractionDead[FuelConstants::MaxSavrSizeClasses] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    double summedFractionLive[FuelConstants::MaxSavrSizeClasses] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+    for (int i = 0; i < maxParticles; i++)
+    {
+        int deadSizeClass = getSavrSizeClass(savrDead[i]);
+        int liveSizeClass = getSavrSizeClass(savrLive[i]);
+        if (deadSizeClass >= 0)
+        {
+            summedFractionDead[deadSizeClass] += fractionOfTotalSurfaceAreaDead[i];
+        }
+        if (liveSizeClass >= 0)
+        {
+            summedFractionLive[liveSizeClass] += fractionOfTotalSurfaceAreaLive[i];
+        }
+    }
+
+    double fractionOfTotalSurfaceArea[FuelConstants::MaxLifeStates];
+    fractionOfTotalSurfaceArea[dead] = totalSurfaceArea[dead] / (totalSurfaceArea[dead] + totalSurfaceArea[live]);
+    fractionOfTotalSurfaceArea[live] = 1.0 - fractionOfTotalSurfaceArea[dead];
+
+    // Moisture of extinction
+    double moistureOfExtinction[FuelConstants::MaxLifeStates] = { fuelModel.moistureOfExtinctionDead, 0.0 };
+    if (numberOfSizeClasses[live] != 0)
+    {
+        double fineDead = 0.0;
+        double fineLive = 0.0;
+        double weightedMoistureFineDead = 0.0;
+        double fineDeadMoisture = 0.0;
+        double fineDeadOverFineLive = 0.0;
+        for (int i = 0; i < maxParticles; i++)
+        {
+            double fineFuelsWeightingFactor = 0.0;
+            if (savrDead[i] > 1.0e-7)
+            {
+                fineFuelsWeightingFactor = loadDead[i] * exp(-138.0 / savrDead[i]);
+            }
+            fineDead += fineFuelsWeightingFactor;
+            weightedMoistureFineDead += fineFuelsWeightingFactor * moistureDead[i];
+        }
+        if (fineDead > 1.0e-07)
+        {
+            fineDeadMoisture = weightedMoistureFineDead / fineDead;
+        }
+        for (int i = 0; i < numberOfSizeClasses[live]; i++)
+        {
+            if (savrLive[i] > 1.0e-07)
+            {
+                fineLive += loadLive[i] * exp(-500.0 / savrLive[i]);
+            }
+        }
+        if (fineLive > 1.0e-7)
+        {
+            fineDeadOverFineLive = fineDead / fineLive;
+        }
+        moistureOfExtinction[live] = (2.9 * fineDeadOverFineLive * (1.0 - fineDeadMoisture / moistureOfExtinction[dead])) - 0.226;
+        if (moistureOfExtinction[live] < moistureOfExtinction[dead])
+        {
+            moistureOfExtinction[live] = moistureOfExtinction[dead];
+        }
+    }
+
+    // Characteristic SAVR and weighted values by life state
+    double weightedHeat[FuelConstants::MaxLifeStates] = { 0.0, 0.0 };
+    double weightedSilica[FuelConstants::MaxLifeStates] = { 0.0, 0.0 };
+    double weightedMoisture[FuelConstants::MaxLifeStates] = { 0.0, 0.0 };
+    double weightedSavr[FuelConstants::MaxLifeStates] = { 0.0, 0.0 };
+    double weightedFuelLoad[FuelConstants::MaxLifeStates] = { 0.0, 0.0 };
+    double totalLoadForLifeState[FuelConstants::MaxLifeStates] = { 0.0, 0.0 };
+    for (int i = 0; i < maxParticles; i++)
+    {
+        double netLoadDead = 0.0;
+        double netLoadLive = 0.0;
+        if (savrDead[i] > 1.0e-07)
+        {
+            netLoadDead = loadDead[i] * (1.0 - totalSilicaContent); // Rothermel 1972, equation 24
+            weightedHeat[dead] += fractionOfTotalSurfaceAreaDead[i] * fuelModel.heatOfCombustionDead;
+            weightedSilica[dead] += fractionOfTotalSurfaceAreaDead[i] * silicaEffective;
+            weightedMoisture[dead] += fractionOfTotalSurfaceAreaDead[i] * moistureDead[i];
+            weightedSavr[dead] += fractionOfTotalSurfaceAreaDead[i] * savrDead[i];
+            totalLoadForLifeState[dead] += loadDead[i];
+        }
+        if (savrLive[i] > 1.0e-07)
+        {
+            netLoadLive = loadLive[i] * (1.0 - totalSilicaContent); // Rothermel 1972, equation 24
+            weightedHeat[live] += fractionOfTotalSurfaceAreaLive[i] * fuelModel.heatOfCombustionLive;
+            weightedSilica[live] += fractionOfTotalSurfaceAreaLive[i] * silicaEffective;
+            weightedMoisture[live] += fractionOfTotalSurfaceAreaLive[i] * moistureLive[i];
+            weightedSavr[live] += fractionOfTotalSurfaceAreaLive[i] * savrLive[i];
+            totalLoadForLifeState[live] += loadLive[i];
+        }
+        int deadSizeClass = getSavrSizeClass(savrDead[i]);
+        int liveSizeClass = getSavrSizeClass(savrLive[i]);
+        weightedFuelLoad[dead] += ((deadSizeClass >= 0) ? (summedFractionDead[deadSizeClass]) : (0.0)) * netLoadDead;
+        weightedFuelLoad[live] += ((liveSizeClass >= 0) ? (summedFractionLive[liveSizeClass]) : (0.0)) * netLoadLive;
+    }
+    double sigma = 0.0;
+    for (int lifeState = 0; lifeState < FuelConstants::MaxLifeStates; lifeState++)
+    {
+        sigma += fractionOfTotalSurfaceArea[lifeState] * weightedSavr[lifeState];
+    }
+
+    double totalLoad = totalLoadForLifeState[dead] + totalLoadForLifeState[live];
+    double bulkDensity = totalLoad / depth;
+    double packingRatio = 0.0;
+    for (int i = 0; i < maxParticles; i++)
+    {
+        packingRatio += loadDead[i] / (depth * fuelDensity);
+        packingRatio += loadLive[i] / (depth * fuelDensity);
+    }
+    double relativePackingRatio = (staticConstants)
+        ? (staticConstants->relativePackingRatio_)
+        : (packingRatio / (3.348 / pow(sigma, 0.8189)));
+
+    // Heat sink and propagating flux
+    double heatSink = 0.0;
+    for (int i = 0; i < maxParticles; i++)
+    {
+        if (savrDead[i] > 1.0e-07)
+        {
+            double heatOfPreignition = 250.0 + 1116.0 * moistureDead[i];
+            heatSink += fractionOfTotalSurfaceArea[dead] * fractionOfTotalSurfaceAreaDead[i] * heatOfPreignition * exp(-138.0 / savrDead[i]);
+        }
+        if (savrLive[i] > 1.0e-07)
+        {
+            double heatOfPreignition = 250.0 + 1116.0 * moistureLive[i];
+            heatSink += fractionOfTotalSurfaceArea[live] * fractionOfTotalSurfaceAreaLive[i] * heatOfPreignition * exp(-138.0 / savrLive[i]);
+        }
+    }
+    heatSink *= bulkDensity;
+
+    double propagatingFlux = 0.0;
+    if (staticConstants)
+    {
+        propagatingFlux = staticConstants->propagatingFlux_;
+    }
+    else if (sigma >= 1.0e-07)
+    {
+        propagatingFlux = exp((0.792 + (0.681 * sqrt(sigma))) * (packingRatio + 0.1)) / (192.0 + 0.2595 * sigma);
+    }
+
+    // Reaction intensity
+    double gamma = 0.0;
+    if (staticConstants)
+    {
+        gamma = staticConstants->reactionVelocity_;
+    }
+    else
+    {
+        double aa = 133.0 / pow(sigma, 0.7913);
+        double sigmaToTheOnePointFive = pow(sigma, 1.5);
+        double gammaMax = sigmaToTheOnePointFive / (495.0 + (0.0594 * sigmaToTheOnePointFive));
+        gamma = gammaMax * pow(relativePackingRatio, aa) * exp(aa * (1.0 - relativePackingRatio));
+    }
+
+    double relativeMoisture = 0.0;
+    double reactionIntensityForLifeState[FuelConstants::MaxLifeStates];
+    for (int i = 0; i < FuelConstants::MaxLifeStates; i++)
+    {
+        double etaM = 0.0;
+        double etaS = 0.0;
+        if (moistureOfExtinction[i] > 0.0)
+        {
+            relativeMoisture = weightedMoisture[i] / moistureOfExtinction[i];
+        }
+        if (!(weightedMoisture[i] >= moistureOfExtinction[i] || relativeMoisture > 1.0))
+        {
+            etaM = 1.0 - (2.59 * relativeMoisture) + (5.11 * relativeMoisture * relativeMoisture) -
+                (3.52 * relativeMoisture * relativeMoisture * relativeMoisture);
+        }
+        double etaSDenomitator = pow(weightedSilica[i], 0.19);
+        if (etaSDenomitator >= 1e-6)
+        {
+            etaS = 0.174 / etaSDenomitator;
+        }
+        if (etaS > 1.0)
+        {
+            etaS = 1.0;
+        }
+        reactionIntensityForLifeState[i] = gamma * weightedFuelLoad[i] * weightedHeat[i] * etaM * etaS;
+    }
+    double reactionIntensity = reactionIntensityForLifeState[dead] + reactionIntensityForLifeState[live];
+    double residenceTime = (sigma < 1.0e-07)
+        ? (0.0)
+        : (384. / sigma);
+    outputs.reactionIntensity = reactionIntensity;
+    outputs.heatSink = heatSink;
+    outputs.residenceTime = residenceTime;
+    outputs.heatPerUnitArea = reactionIntensity * residenceTime;
+
+    double noWindNoSlopeSpreadRate = (heatSink < 1.0e-07)
+        ? (0.0)
+        : (reactionIntensity * propagatingFlux / heatSink);
+    if (!(noWindNoSlopeSpreadRate > 0.0))
+    {
+        return;
+    }
+
+    // Wind and slope factors
+    double windB = 0.0;
+    double windC = 0.0;
+    double windE = 0.0;
+    double relativePackingRatioFactor = 0.0;
+    double packingRatioFactor = 0.0;
+    if (staticConstants)
+    {
+        windC = staticConstants->windC_;
+        windB = staticConstants->windB_;
+        windE = staticConstants->windE_;
+        relativePackingRatioFactor = staticConstants->windRelativePackingRatioFactor_;
+        packingRatioFactor = staticConstants->slopePackingRatioFactor_;
+    }
+    else
+    {
+        windC = 7.47 * exp(-0.133 * pow(sigma, 0.55));
+        windB = 0.02526 * pow(sigma, 0.54);
+        windE = 0.715 * exp(-0.000359 * sigma);
+        relativePackingRatioFactor = pow(relativePackingRatio, -windE);
+        packingRatioFactor = 5.275 * pow(packingRatio, -0.3);
+    }
+    double phiW = (inputs.midflameWindSpeed < 1.0e-07)
+        ? (0.0)
+        : (pow(inputs.midflameWindSpeed, windB) * windC * relativePackingRatioFactor);
+    double slopex = tan(inputs.slope / 180.0 * M_PI);
+    double phiS = packingRatioFactor * (slopex * slopex);
+
+    double windSpeedLimit = 0.9 * reactionIntensity;
+    if (phiS > 0.0 && phiS > windSpeedLimit)
+    {
+        phiS = windSpeedLimit;
+    }
+
+    // Spread rate and direction of max spread, SurfaceFire::calculateDirectionOfMaxSpread()
+    double windDirRadians = inputs.windDirection * M_PI / 180.0;
+    double slopeRate = noWindNoSlopeSpreadRate * phiS;
+    double windRate = noWindNoSlopeSpreadRate * phiW;
+    double x = slopeRate + (windRate * cos(windDirRadians));
+    double y = windRate * sin(windDirRadians);
+    double spreadRate = noWindNoSlopeSpreadRate + sqrt((x * x) + (y * y));
+
+    double azimuth = atan2(y, x) * 180.0 / M_PI;
+    if (azimuth < -1.0e-20)
+    {
+        azimuth += 360.0;
+    }
+    if (fabs(azimuth) < 0.5)
+    {
+        azimuth = 0.0; // Undocumented hack from BehavePlus code
+    }
+
+    double phiEffectiveWind = spreadRate / noWindNoSlopeSpreadRate - 1.0;
+    double effectiveWindSpeed = pow(((phiEffectiveWind * pow(relativePackingRatio, windE)) / windC), 1.0 / windB);
+    bool isWindLimitExceeded = false;
+    if (effectiveWindSpeed > windSpeedLimit)
+    {
+        isWindLimitExceeded = true;
+        effectiveWindSpeed = windSpeedLimit;
+        spreadRate = noWindNoSlopeSpreadRate * (1 + windC * pow(windSpeedLimit, windB) * relativePackingRatioFactor);
+    }
+
+    // Fire ellipse, FireSize::calculateFireBasicDimensions() with the wind speed in mi/h
+    double effectiveWindSpeedInMilesPerHour = SpeedUnits::fromBaseUnits(effectiveWindSpeed, SpeedUnits::MilesPerHour);
+    double fireLengthToWidthRatio = 1.0;
+    if (effectiveWindSpeedInMilesPerHour > 1.0e-07)
+    {
+        fireLengthToWidthRatio = .936 * exp(.1147 * effectiveWindSpeedInMilesPerHour) + .461 * exp(-.0692 * effectiveWindSpeedInMilesPerHour) - .397;
+        if (fireLengthToWidthRatio > 8.0)
+        {
+            fireLengthToWidthRatio = 8.0;
+        }
+    }
+    double eccentricity = 0.0;
+    double eccentricityTerm = (fireLengthToWidthRatio * fireLengthToWidthRatio) - 1.0;
+    if (eccentricityTerm > 0.0)
+    {
+        eccentricity = sqrt(eccentricityTerm) / fireLengthToWidthRatio;
+    }
+    double backingSpreadRate = spreadRate * (1.0 - eccentricity) / (1.0 + eccentricity);
+
+    // Fireline intensity and flame length, Byram 1959, Albini 1976
+    double firelineIntensity = spreadRate * reactionIntensity * (residenceTime / 60.0);
+    double flameLength = (firelineIntensity < 1.0e-07)
+        ? (0.0)
+        : (0.45 * pow(firelineIntensity, 0.46));
+
+    outputs.noWindNoSlopeSpreadRate = noWindNoSlopeSpreadRate;
+    outputs.spreadRate = spreadRate;
+    outputs.backingSpreadRate = backingSpreadRate;
+    outputs.flankingSpreadRate = ((backingSpreadRate + spreadRate) / fireLengthToWidthRatio) * 0.5;
+    outputs.directionOfMaxSpread = azimuth;
+    outputs.effectiveWindSpeed = effectiveWindSpeed;
+    outputs.fireLengthToWidthRatio = fireLengthToWidthRatio;
+    outputs.firelineIntensity = firelineIntensity;
+    outputs.flameLength = flameLength;
+    outputs.isWindLimitExceeded = isWindLimitExceeded;
+}
+BEHAVE_OFFLOAD_END_DECLARE_TARGET
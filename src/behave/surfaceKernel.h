@@ -0,0 +1,122 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Stateless surface fire kernel over plain input and output structs
+*           for a standard fuel model
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SURFACEKERNEL_H
+#define SURFACEKERNEL_H
+
+#include "fuelModels.h"
+#include "surfaceInputEnums.h"
+
+// Marks the functions the offload backend runs on a device, see kernelOffload.h. Without
+// BEHAVE_OFFLOAD they are ordinary host functions.
+#ifdef BEHAVE_OFFLOAD
+#define BEHAVE_OFFLOAD_BEGIN_DECLARE_TARGET _Pragma("omp declare target")
+#define BEHAVE_OFFLOAD_END_DECLARE_TARGET _Pragma("omp end declare target")
+#else
+#define BEHAVE_OFFLOAD_BEGIN_DECLARE_TARGET
+#define BEHAVE_OFFLOAD_END_DECLARE_TARGET
+#endif
+
+// Read-only copy of the fields of one fuel model that a surface run needs, in base units:
+// depth in ft, loads in lb/ft^2, SAVRs in ft^2/ft^3, heats of combustion in Btu/lb and
+// moisture of extinction as a fraction
+struct SurfaceKernelFuelModel
+{
+    double fuelbedDepth;
+    double moistureOfExtinctionDead;
+    double heatOfCombustionDead;
+    double heatOfCombustionLive;
+    double fuelLoadOneHour;
+    double fuelLoadTenHour;
+    double fuelLoadHundredHour;
+    double fuelLoadLiveHerbaceous;
+    double fuelLoadLiveWoody;
+    double savrOneHour;
+    double savrLiveHerbaceous;
+    double savrLiveWoody;
+    bool isDynamic;
+    bool hasStaticFuelbedConstants;
+    FuelModels::StaticFuelbedConstants staticFuelbedConstants;
+};
+
+// Inputs of SurfaceKernel::calculate() in base units. Moistures are fractions, the midflame wind
+// speed is in ft/min, the wind direction is in degrees clockwise from upslope and the slope is in degrees.
+struct SurfaceKernelInputs
+{
+    double moistureOneHour;
+    double moistureTenHour;
+    double moistureHundredHour;
+    double moistureLiveHerbaceous;
+    double moistureLiveWoody;
+    double midflameWindSpeed;
+    double windDirection;
+    double slope;
+};
+
+// Outputs of SurfaceKernel::calculate() in base units: spread rates and the effective wind speed
+// in ft/min, reaction intensity in Btu/ft^2/min, heat sink in Btu/ft^3, residence time in min, heat per unit area in Btu/ft^2,
+// fireline intensity in Btu/ft/s and flame length in ft. The direction of max spread is in degrees
+// clockwise from upslope.
+struct SurfaceKernelOutputs
+{
+    double reactionIntensity;
+    double heatSink;
+    double noWindNoSlopeSpreadRate;
+    double spreadRate;
+    double backingSpreadRate;
+    double flankingSpreadRate;
+    double directionOfMaxSpread;
+    double effectiveWindSpeed;
+    double fireLengthToWidthRatio;
+    double residenceTime;
+    double heatPerUnitArea;
+    double firelineIntensity;
+    double flameLength;
+    bool isWindLimitExceeded;
+};
+
+// The standard fuel model path of SurfaceFire::calculateForwardSpreadRate() as a pure function, term
+// for term, so its results equal a Surface run in the direction of max spread with the same inputs.
+// It reads nothing but its arguments and writes nothing but its outputs, which makes it safe to call
+// from any number of threads at once. Special fuels, two fuel models, aggregated moistures and the
+// wind adjustment factor stay with Surface, which remains the stateful front end.
+class SurfaceKernel
+{
+public:
+    // Copies a fuel model out of fuelModels, false if it is undefined or has no fuel to burn
+    static bool loadFuelModel(const FuelModels& fuelModels, int fuelModelNumber, SurfaceKernelFuelModel& fuelModel);
+    static void calculate(const SurfaceKernelFuelModel& fuelModel, const SurfaceKernelInputs& inputs, SurfaceKernelOutputs& outputs);
+};
+
+// SurfaceKernel::calculate() as a free function, which the offload backend can build for a device
+// without loadFuelModel() and the FuelModels lookups it makes
+BEHAVE_OFFLOAD_BEGIN_DECLARE_TARGET
+void calculateSurfaceKernel(const SurfaceKernelFuelModel& fuelModel, const SurfaceKernelInputs& inputs, SurfaceKernelOutputs& outputs);
+BEHAVE_OFFLOAD_END_DECLARE_TARGET
+
+#endif // SURFACEKERNEL_H
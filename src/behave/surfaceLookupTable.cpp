@@ -0,0 +1,314 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Precomputed, interpolated surface fire behavior over a grid of
+*           moisture, wind and slope values for each fuel model
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "surfaceLookupTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+SurfaceLookupTable::SurfaceLookupTable(const Surface& prototype)
+    : prototype_(prototype)
+{
+    const double prototypeValues[numberOfAxes] =
+    {
+        prototype_.getMoistureOneHour(FractionUnits::Fraction),
+        prototype_.getMoistureTenHour(FractionUnits::Fraction),
+        prototype_.getMoistureHundredHour(FractionUnits::Fraction),
+        prototype_.getMoistureLiveHerbaceous(FractionUnits::Fraction),
+        prototype_.getMoistureLiveWoody(FractionUnits::Fraction),
+        prototype_.getWindSpeed(SpeedUnits::FeetPerMinute, prototype_.getWindHeightInputMode()),
+        prototype_.getSlope(SlopeUnits::Degrees)
+    };
+    for(int axis = 0; axis < numberOfAxes; axis++)
+    {
+        axes_[axis].minimum = prototypeValues[axis];
+        axes_[axis].step = 0.0;
+        axes_[axis].numberOfPoints = 1;
+    }
+}
+
+void SurfaceLookupTable::setAxis(SurfaceLookupAxis::SurfaceLookupAxisEnum axis, double minimum, double maximum, double step)
+{
+    AxisGrid& grid = axes_[axis];
+    grid.minimum = minimum;
+    grid.step = 0.0;
+    grid.numberOfPoints = 1;
+    if(step > 0.0 && maximum > minimum)
+    {
+        grid.step = step;
+        grid.numberOfPoints = (int)std::floor((maximum - minimum) / step + 0.5) + 1;
+    }
+    clearTables();
+}
+
+int SurfaceLookupTable::getNumberOfAxisPoints(SurfaceLookupAxis::SurfaceLookupAxisEnum axis) const
+{
+    return axes_[axis].numberOfPoints;
+}
+
+long SurfaceLookupTable::getNumberOfTablePoints() const
+{
+    long numberOfPoints = 1;
+    for(int axis = 0; axis < numberOfAxes; axis++)
+    {
+        numberOfPoints *= axes_[axis].numberOfPoints;
+    }
+    return numberOfPoints;
+}
+
+int SurfaceLookupTable::getNumberOfTables() const
+{
+    return (int)tables_.size();
+}
+
+void SurfaceLookupTable::clearTables()
+{
+    tables_.clear();
+}
+
+SurfaceLookupOutputs SurfaceLookupTable::lookup(int fuelModelNumber, double moistureOneHour, double moistureTenHour,
+    double moistureHundredHour, double moistureLiveHerbaceous, double moistureLiveWoody, double windSpeed, double slope)
+{
+    const double axisValues[numberOfAxes] = { moistureOneHour, moistureTenHour, moistureHundredHour, moistureLiveHerbaceous,
+        moistureLiveWoody, windSpeed, slope };
+    return interpolate(getTable(fuelModelNumber), axisValues);
+}
+
+double SurfaceLookupTable::getMaximumSpreadRateError(int fuelModelNumber)
+{
+    return getTable(fuelModelNumber).maximumSpreadRateError;
+}
+
+double SurfaceLookupTable::getMaximumFlameLengthError(int fuelModelNumber)
+{
+    return getTable(fuelModelNumber).maximumFlameLengthError;
+}
+
+SurfaceLookupTable::FuelModelTable& SurfaceLookupTable::getTable(int fuelModelNumber)
+{
+    std::unordered_map<int, FuelModelTable>::iterator found = tables_.find(fuelModelNumber);
+    if(found != tables_.end())
+    {
+        return found->second;
+    }
+    FuelModelTable& table = tables_[fuelModelNumber];
+    buildTable(fuelModelNumber, table);
+    measureTableError(fuelModelNumber, table);
+    return table;
+}
+
+void SurfaceLookupTable::buildTable(int fuelModelNumber, FuelModelTable& table)
+{
+    long numberOfPoints = getNumberOfTablePoints();
+    table.values.resize(numberOfPoints * numberOfOutputs);
+
+    // Grid points are stored with the last axis varying fastest
+    runExact(fuelModelNumber, numberOfPoints, [this](long point, double* axisValues)
+    {
+        for(int axis = numberOfAxes - 1; axis >= 0; axis--)
+        {
+            const AxisGrid& grid = axes_[axis];
+            axisValues[axis] = grid.minimum + (point % grid.numberOfPoints) * grid.step;
+            point /= grid.numberOfPoints;
+        }
+    }, table.values.data());
+}
+
+void SurfaceLookupTable::measureTableError(int fuelModelNumber, FuelModelTable& table)
+{
+    table.maximumSpreadRateError = 0.0;
+    table.maximumFlameLengthError = 0.0;
+
+    long numberOfCells = 1;
+    bool hasCells = false;
+    for(int axis = 0; axis < numberOfAxes; axis++)
+    {
+        if(axes_[axis].numberOfPoints > 1)
+        {
+            numberOfCells *= axes_[axis].numberOfPoints - 1;
+            hasCells = true;
+        }
+    }
+    if(!hasCells)
+    {
+        // A single point is the exact result
+        return;
+    }
+
+    auto cellCentre = [this](long cell, double* axisValues)
+    {
+        for(int axis = numberOfAxes - 1; axis >= 0; axis--)
+        {
+            const AxisGrid& grid = axes_[axis];
+            if(grid.numberOfPoints > 1)
+            {
+                axisValues[axis] = grid.minimum + ((cell % (grid.numberOfPoints - 1)) + 0.5) * grid.step;
+                cell /= grid.numberOfPoints - 1;
+            }
+            else
+            {
+                axisValues[axis] = grid.minimum;
+            }
+        }
+    };
+
+    std::vector<double> exact(numberOfCells * numberOfOutputs);
+    runExact(fuelModelNumber, numberOfCells, cellCentre, exact.data());
+
+    double axisValues[numberOfAxes];
+    for(long cell = 0; cell < numberOfCells; cell++)
+    {
+        cellCentre(cell, axisValues);
+        SurfaceLookupOutputs interpolated = interpolate(table, axisValues);
+        const double* exactOutputs = &exact[cell * numberOfOutputs];
+        table.maximumSpreadRateError = std::max(table.maximumSpreadRateError, std::fabs(interpolated.spreadRate - exactOutputs[0]));
+        table.maximumFlameLengthError = std::max(table.maximumFlameLengthError, std::fabs(interpolated.flameLength - exactOutputs[2]));
+    }
+}
+
+template<typename PointInputs>
+void SurfaceLookupTable::runExact(int fuelModelNumber, long count, PointInputs pointInputs, double* outputs)
+{
+    // Run in blocks so large tables don't need full size input arrays
+    const int blockSize = 1024;
+    std::vector<double> axisInputs[numberOfAxes];
+    for(int axis = 0; axis < numberOfAxes; axis++)
+    {
+        axisInputs[axis].resize(blockSize);
+    }
+    std::vector<int> fuelModelNumbers(blockSize, fuelModelNumber);
+    std::vector<double> windDirection(blockSize, prototype_.getWindDirection());
+    std::vector<double> aspect(blockSize, prototype_.getAspect());
+    std::vector<double> canopyCover(blockSize, prototype_.getCanopyCover(FractionUnits::Fraction));
+    std::vector<double> canopyHeight(blockSize, prototype_.getCanopyHeight(LengthUnits::Feet));
+    std::vector<double> crownRatio(blockSize, prototype_.getCrownRatio(FractionUnits::Fraction));
+    std::vector<double> spreadRate(blockSize);
+    std::vector<double> firelineIntensity(blockSize);
+    std::vector<double> flameLength(blockSize);
+
+    SurfaceBatchInputs inputs;
+    inputs.fuelModelNumber = fuelModelNumbers.data();
+    inputs.moistureOneHour = axisInputs[SurfaceLookupAxis::MoistureOneHour].data();
+    inputs.moistureTenHour = axisInputs[SurfaceLookupAxis::MoistureTenHour].data();
+    inputs.moistureHundredHour = axisInputs[SurfaceLookupAxis::MoistureHundredHour].data();
+    inputs.moistureLiveHerbaceous = axisInputs[SurfaceLookupAxis::MoistureLiveHerbaceous].data();
+    inputs.moistureLiveWoody = axisInputs[SurfaceLookupAxis::MoistureLiveWoody].data();
+    inputs.windSpeed = axisInputs[SurfaceLookupAxis::WindSpeed].data();
+    inputs.windDirection = windDirection.data();
+    inputs.slope = axisInputs[SurfaceLookupAxis::Slope].data();
+    inputs.aspect = aspect.data();
+    inputs.canopyCover = canopyCover.data();
+    inputs.canopyHeight = canopyHeight.data();
+    inputs.crownRatio = crownRatio.data();
+
+    SurfaceBatchOutputs batchOutputs = { spreadRate.data(), firelineIntensity.data(), flameLength.data(), nullptr, nullptr };
+
+    double axisValues[numberOfAxes];
+    for(long begin = 0; begin < count; begin += blockSize)
+    {
+        int blockCount = (int)std::min((long)blockSize, count - begin);
+        for(int i = 0; i < blockCount; i++)
+        {
+            pointInputs(begin + i, axisValues);
+            for(int axis = 0; axis < numberOfAxes; axis++)
+            {
+                axisInputs[axis][i] = axisValues[axis];
+            }
+        }
+        inputs.numberOfCells = blockCount;
+        prototype_.doSurfaceRunBatch(inputs, batchOutputs);
+        for(int i = 0; i < blockCount; i++)
+        {
+            double* pointOutputs = outputs + (begin + i) * numberOfOutputs;
+            pointOutputs[0] = spreadRate[i];
+            pointOutputs[1] = firelineIntensity[i];
+            pointOutputs[2] = flameLength[i];
+        }
+    }
+}
+
+SurfaceLookupOutputs SurfaceLookupTable::interpolate(const FuelModelTable& table, const double* axisValues) const
+{
+    // Find the lower grid point and the fraction of the way to the next along each axis
+    long lowerPoint = 0;
+    long strides[numberOfAxes];
+    double fractions[numberOfAxes];
+    int interpolatedAxes[numberOfAxes];
+    int numberOfInterpolatedAxes = 0;
+    long stride = 1;
+    for(int axis = numberOfAxes - 1; axis >= 0; axis--)
+    {
+        const AxisGrid& grid = axes_[axis];
+        strides[axis] = stride;
+        if(grid.numberOfPoints > 1)
+        {
+            double position = (axisValues[axis] - grid.minimum) / grid.step;
+            position = std::min(std::max(position, 0.0), (double)(grid.numberOfPoints - 1));
+            int index = std::min((int)position, grid.numberOfPoints - 2);
+            fractions[axis] = position - index;
+            lowerPoint += index * stride;
+            interpolatedAxes[numberOfInterpolatedAxes++] = axis;
+        }
+        stride *= grid.numberOfPoints;
+    }
+
+    // Weighted sum over the corners of the cell
+    double sums[numberOfOutputs] = { 0.0, 0.0, 0.0 };
+    for(int corner = 0; corner < (1 << numberOfInterpolatedAxes); corner++)
+    {
+        long point = lowerPoint;
+        double weight = 1.0;
+        for(int i = 0; i < numberOfInterpolatedAxes; i++)
+        {
+            int axis = interpolatedAxes[i];
+            if(corner & (1 << i))
+            {
+                point += strides[axis];
+                weight *= fractions[axis];
+            }
+            else
+            {
+                weight *= 1.0 - fractions[axis];
+            }
+        }
+        if(weight != 0.0)
+        {
+            const double* pointValues = &table.values[point * numberOfOutputs];
+            for(int output = 0; output < numberOfOutputs; output++)
+            {
+                sums[output] += weight * pointValues[output];
+            }
+        }
+    }
+
+    SurfaceLookupOutputs outputs;
+    outputs.spreadRate = sums[0];
+    outputs.firelineIntensity = sums[1];
+    outputs.flameLength = sums[2];
+    return outputs;
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Precomputed, interpolated surface fire behavior over a grid of
+*           moisture, wind and slope values for each fuel model
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SURFACELOOKUPTABLE_H
+#define SURFACELOOKUPTABLE_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "surface.h"
+
+struct SurfaceLookupAxis
+{
+    enum SurfaceLookupAxisEnum
+    {
+        MoistureOneHour,        // fraction
+        MoistureTenHour,        // fraction
+        MoistureHundredHour,    // fraction
+        MoistureLiveHerbaceous, // fraction
+        MoistureLiveWoody,      // fraction
+        WindSpeed,              // ft/min, at the prototype's wind height
+        Slope,                  // degrees
+        NumberOfAxes
+    };
+};
+
+// Interpolated results of SurfaceLookupTable::lookup(), in base units
+struct SurfaceLookupOutputs
+{
+    double spreadRate;          // ft/min, in the direction of max spread
+    double firelineIntensity;   // btu/ft/s
+    double flameLength;         // ft
+};
+
+// An optional fast path for tools that ask for surface fire behavior many times at
+// quantized inputs. For each fuel model a table is built the first time it is asked
+// for, by running the prototype Surface through doSurfaceRunBatch() at every grid point,
+// and lookups multilinearly interpolate that table. Each axis defaults to the single
+// prototype value; inputs outside an axis are clamped to its ends. Everything that is
+// not an axis (wind direction, aspect, canopy, wind adjustment method) comes from the
+// prototype. A SurfaceLookupTable must only be used by one thread at a time.
+class SurfaceLookupTable
+{
+public:
+    explicit SurfaceLookupTable(const Surface& prototype);
+
+    // Uses the points minimum, minimum + step, ... up to maximum, clears any built tables
+    void setAxis(SurfaceLookupAxis::SurfaceLookupAxisEnum axis, double minimum, double maximum, double step);
+    int getNumberOfAxisPoints(SurfaceLookupAxis::SurfaceLookupAxisEnum axis) const;
+    long getNumberOfTablePoints() const;
+
+    SurfaceLookupOutputs lookup(int fuelModelNumber, double moistureOneHour, double moistureTenHour, double moistureHundredHour,
+        double moistureLiveHerbaceous, double moistureLiveWoody, double windSpeed, double slope);
+
+    // Largest difference from the exact Surface run found at the centre of every table
+    // cell, where the interpolation is furthest from the grid points. Builds the table
+    // for the fuel model if needed.
+    double getMaximumSpreadRateError(int fuelModelNumber);
+    double getMaximumFlameLengthError(int fuelModelNumber);
+
+    int getNumberOfTables() const;
+    void clearTables();
+
+protected:
+    static const int numberOfAxes = SurfaceLookupAxis::NumberOfAxes;
+    static const int numberOfOutputs = 3;
+
+    struct AxisGrid
+    {
+        double minimum;
+        double step;
+        int numberOfPoints;
+    };
+
+    struct FuelModelTable
+    {
+        std::vector<double> values; // numberOfOutputs values per grid point
+        double maximumSpreadRateError;
+        double maximumFlameLengthError;
+    };
+
+    FuelModelTable& getTable(int fuelModelNumber);
+    void buildTable(int fuelModelNumber, FuelModelTable& table);
+    void measureTableError(int fuelModelNumber, FuelModelTable& table);
+    // Runs the prototype at count points, pointInputs fills the axis values of one point
+    template<typename PointInputs>
+    void runExact(int fuelModelNumber, long count, PointInputs pointInputs, double* outputs);
+    SurfaceLookupOutputs interpolate(const FuelModelTable& table, const double* axisValues) const;
+
+    Surface prototype_;
+    AxisGrid axes_[numberOfAxes];
+    std::unordered_map<int, FuelModelTable> tables_;
+};
+
+#endif // SURFACELOOKUPTABLE_H
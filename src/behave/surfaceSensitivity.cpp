@@ -0,0 +1,601 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Forward-mode derivatives of the Rothermel surface spread rate and
+*           fireline intensity with respect to moistures, wind, slope and loads
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "surfaceSensitivity.h"
+
+namespace
+{
+
+// A value with its derivatives with respect to the first numberOfDerivatives SurfaceSensitivityVariables
+template<int numberOfDerivatives>
+struct SurfaceDual
+{
+    double value;
+    double derivatives[numberOfDerivatives];
+
+    SurfaceDual(double constant = 0.0)
+        : value(constant)
+    {
+        for(int i = 0; i < numberOfDerivatives; i++)
+        {
+            derivatives[i] = 0.0;
+        }
+    }
+
+    // Variables past numberOfDerivatives are treated as constants
+    static SurfaceDual variable(double value, int index)
+    {
+        SurfaceDual result(value);
+        if(index < numberOfDerivatives)
+        {
+            result.derivatives[index] = 1.0;
+        }
+        return result;
+    }
+
+    // Value a * f(x) + b * f(y) with df = derivativeOfX * dx + derivativeOfY * dy
+    static SurfaceDual chain(double value, double derivativeOfX, const SurfaceDual& x, double derivativeOfY, const SurfaceDual& y)
+    {
+        SurfaceDual result(value);
+        for(int i = 0; i < numberOfDerivatives; i++)
+        {
+            result.derivatives[i] = derivativeOfX * x.derivatives[i] + derivativeOfY * y.derivatives[i];
+        }
+        return result;
+    }
+
+    static SurfaceDual chain(double value, double derivativeOfX, const SurfaceDual& x)
+    {
+        SurfaceDual result(value);
+        for(int i = 0; i < numberOfDerivatives; i++)
+        {
+            result.derivatives[i] = derivativeOfX * x.derivatives[i];
+        }
+        return result;
+    }
+
+    SurfaceDual& operator+=(const SurfaceDual& rhs)
+    {
+        *this = *this + rhs;
+        return *this;
+    }
+
+    SurfaceDual& operator-=(const SurfaceDual& rhs)
+    {
+        *this = *this - rhs;
+        return *this;
+    }
+
+    SurfaceDual& operator*=(const SurfaceDual& rhs)
+    {
+        *this = *this * rhs;
+        return *this;
+    }
+
+    friend SurfaceDual operator+(const SurfaceDual& x, const SurfaceDual& y)
+    {
+        return chain(x.value + y.value, 1.0, x, 1.0, y);
+    }
+
+    friend SurfaceDual operator-(const SurfaceDual& x, const SurfaceDual& y)
+    {
+        return chain(x.value - y.value, 1.0, x, -1.0, y);
+    }
+
+    friend SurfaceDual operator-(const SurfaceDual& x)
+    {
+        return chain(-x.value, -1.0, x);
+    }
+
+    friend SurfaceDual operator*(const SurfaceDual& x, const SurfaceDual& y)
+    {
+        return chain(x.value * y.value, y.value, x, x.value, y);
+    }
+
+    friend SurfaceDual operator/(const SurfaceDual& x, const SurfaceDual& y)
+    {
+        double quotient = x.value / y.value;
+        return chain(quotient, 1.0 / y.value, x, -quotient / y.value, y);
+    }
+
+    friend SurfaceDual exp(const SurfaceDual& x)
+    {
+        double result = std::exp(x.value);
+        return chain(result, result, x);
+    }
+
+    // The derivative at zero is taken as zero, which is the limit along the wind and slope vector
+    friend SurfaceDual sqrt(const SurfaceDual& x)
+    {
+        double result = std::sqrt(x.value);
+        return chain(result, (result > 0.0) ? (0.5 / result) : (0.0), x);
+    }
+
+    friend SurfaceDual tan(const SurfaceDual& x)
+    {
+        double result = std::tan(x.value);
+        return chain(result, 1.0 + result * result, x);
+    }
+
+    friend SurfaceDual pow(const SurfaceDual& x, double exponent)
+    {
+        double result = std::pow(x.value, exponent);
+        return chain(result, (x.value != 0.0) ? (exponent * result / x.value) : (0.0), x);
+    }
+
+    friend SurfaceDual pow(const SurfaceDual& x, const SurfaceDual& exponent)
+    {
+        double result = std::pow(x.value, exponent.value);
+        if(x.value <= 0.0)
+        {
+            return SurfaceDual(result);
+        }
+        return chain(result, exponent.value * result / x.value, x, result * std::log(x.value), exponent);
+    }
+};
+
+inline double valueOf(double x)
+{
+    return x;
+}
+
+template<int numberOfDerivatives>
+inline double valueOf(const SurfaceDual<numberOfDerivatives>& x)
+{
+    return x.value;
+}
+
+// Index of the SAVR size class of sumFractionOfTotalSurfaceAreaBySizeClass(), or -1 below 16 ft^2/ft^3
+int getSavrSizeClass(double savr)
+{
+    if(savr >= 1200.0)
+    {
+        return 0;
+    }
+    else if(savr >= 192.0)
+    {
+        return 1;
+    }
+    else if(savr >= 96.0)
+    {
+        return 2;
+    }
+    else if(savr >= 48.0)
+    {
+        return 3;
+    }
+    else if(savr >= 16.0)
+    {
+        return 4;
+    }
+    return -1;
+}
+
+// Standard fuel model path of SurfaceFuelbedIntermediates::calculateFuelbedIntermediates(),
+// SurfaceFireReactionIntensity::calculateReactionIntensity() and SurfaceFire::calculateForwardSpreadRate()
+template<typename Real>
+void calculateSurfaceFire(const FuelModels& fuelModels, const SurfaceSensitivityInputs& inputs,
+    Real& spreadRate, Real& firelineIntensity)
+{
+    const int maxParticles = FuelConstants::MaxParticles;
+    const int dead = FuelLifeState::Dead;
+    const int live = FuelLifeState::Live;
+    const double fuelDensity = 32.0; // Average density of dry fuel in lbs/ft^3, Albini 1976, p. 91
+    const double totalSilicaContent = 0.0555;
+    const double silicaEffective = 0.01;
+    int fuelModelNumber = inputs.fuelModelNumber;
+    typedef SurfaceSensitivityVariable Variable;
+
+    // Fuel loads, moistures and SAVR
+    double depth = fuelModels.getFuelbedDepth(fuelModelNumber, LengthUnits::Feet);
+    Real loadDead[maxParticles] =
+    {
+        Real::variable(fuelModels.getFuelLoadOneHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot), Variable::LoadOneHour),
+        Real::variable(fuelModels.getFuelLoadTenHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot), Variable::LoadTenHour),
+        Real::variable(fuelModels.getFuelLoadHundredHour(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot), Variable::LoadHundredHour),
+        Real(0.0),
+        Real(0.0)
+    };
+    Real loadLive[maxParticles] =
+    {
+        Real::variable(fuelModels.getFuelLoadLiveHerbaceous(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot), Variable::LoadLiveHerbaceous),
+        Real::variable(fuelModels.getFuelLoadLiveWoody(fuelModelNumber, LoadingUnits::PoundsPerSquareFoot), Variable::LoadLiveWoody),
+        Real(0.0),
+        Real(0.0),
+        Real(0.0)
+    };
+
+    int numberOfSizeClasses[FuelConstants::MaxLifeStates] = { 0, 0 };
+    for(int i = 0; i < maxParticles; i++)
+    {
+        if(valueOf(loadDead[i]) != 0.0)
+        {
+            numberOfSizeClasses[dead] = FuelConstants::MaxDeadSizeClasses;
+        }
+        if(valueOf(loadLive[i]) != 0.0)
+        {
+            numberOfSizeClasses[live] = FuelConstants::MaxLiveSizeClasses;
+        }
+    }
+
+    Real moistureOneHour = Real::variable(inputs.moistureOneHour, Variable::MoistureOneHour);
+    Real moistureLiveHerbaceous = Real::variable(inputs.moistureLiveHerbaceous, Variable::MoistureLiveHerbaceous);
+    Real moistureDead[maxParticles] =
+    {
+        moistureOneHour,
+        Real::variable(inputs.moistureTenHour, Variable::MoistureTenHour),
+        Real::variable(inputs.moistureHundredHour, Variable::MoistureHundredHour),
+        moistureOneHour,
+        Real(0.0)
+    };
+    Real moistureLive[maxParticles] =
+    {
+        moistureLiveHerbaceous,
+        Real::variable(inputs.moistureLiveWoody, Variable::MoistureLiveWoody),
+        Real(0.0),
+        Real(0.0),
+        Real(0.0)
+    };
+
+    double savrOneHour = fuelModels.getSavrOneHour(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+    double savrLiveHerbaceous = fuelModels.getSavrLiveHerbaceous(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+    double savrLiveWoody = fuelModels.getSavrLiveWoody(fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet);
+    const double savrDead[maxParticles] = { savrOneHour, 109.0, 30.0, savrLiveHerbaceous, 0.0 };
+    const double savrLive[maxParticles] = { savrLiveHerbaceous, savrLiveWoody, 0.0, 0.0, 0.0 };
+
+    if(fuelModels.getIsDynamic(fuelModelNumber))
+    {
+        if(valueOf(moistureLive[0]) < 0.30)
+        {
+            loadDead[3] = loadLive[0];
+            loadLive[0] = Real(0.0);
+        }
+        else if(valueOf(moistureLive[0]) <= 1.20)
+        {
+            loadDead[3] = loadLive[0] * (Real(1.333) - Real(1.11) * moistureLive[0]);
+            loadLive[0] -= loadDead[3];
+        }
+    }
+
+    double heatOfCombustionDead = fuelModels.getHeatOfCombustionDead(fuelModelNumber, HeatOfCombustionUnits::BtusPerPound);
+    double heatOfCombustionLive = fuelModels.getHeatOfCombustionLive(fuelModelNumber, HeatOfCombustionUnits::BtusPerPound);
+
+    // Fuel surface area weighting factors
+    Real totalSurfaceArea[FuelConstants::MaxLifeStates];
+    Real fractionOfTotalSurfaceAreaDead[maxParticles];
+    Real fractionOfTotalSurfaceAreaLive[maxParticles];
+    for(int i = 0; i < numberOfSizeClasses[dead]; i++)
+    {
+        totalSurfaceArea[dead] += loadDead[i] * Real(savrDead[i] / fuelDensity);
+    }
+    for(int i = 0; i < numberOfSizeClasses[live]; i++)
+    {
+        totalSurfaceArea[live] += loadLive[i] * Real(savrLive[i] / fuelDensity);
+    }
+    if(valueOf(totalSurfaceArea[dead]) > 1.0e-7)
+    {
+        for(int i = 0; i < numberOfSizeClasses[dead]; i++)
+        {
+            fractionOfTotalSurfaceAreaDead[i] = loadDead[i] * Real(savrDead[i] / fuelDensity) / totalSurfaceArea[dead];
+        }
+    }
+    if(valueOf(totalSurfaceArea[live]) > 1.0e-7)
+    {
+        for(int i = 0; i < numberOfSizeClasses[live]; i++)
+        {
+            fractionOfTotalSurfaceAreaLive[i] = loadLive[i] * Real(savrLive[i] / fuelDensity) / totalSurfaceArea[live];
+        }
+    }
+
+    Real summedFractionDead[FuelConstants::MaxSavrSizeClasses];
+    Real summedFractionLive[FuelConstants::MaxSavrSizeClasses];
+    for(int i = 0; i < maxParticles; i++)
+    {
+        int deadSizeClass = getSavrSizeClass(savrDead[i]);
+        int liveSizeClass = getSavrSizeClass(savrLive[i]);
+        if(deadSizeClass >= 0)
+        {
+            summedFractionDead[deadSizeClass] += fractionOfTotalSurfaceAreaDead[i];
+        }
+        if(liveSizeClass >= 0)
+        {
+            summedFractionLive[liveSizeClass] += fractionOfTotalSurfaceAreaLive[i];
+        }
+    }
+
+    Real fractionOfTotalSurfaceArea[FuelConstants::MaxLifeStates];
+    fractionOfTotalSurfaceArea[dead] = totalSurfaceArea[dead] / (totalSurfaceArea[dead] + totalSurfaceArea[live]);
+    fractionOfTotalSurfaceArea[live] = Real(1.0) - fractionOfTotalSurfaceArea[dead];
+
+    // Moisture of extinction
+    Real moistureOfExtinction[FuelConstants::MaxLifeStates];
+    moistureOfExtinction[dead] = Real(fuelModels.getMoistureOfExtinctionDead(fuelModelNumber, FractionUnits::Fraction));
+    if(numberOfSizeClasses[live] != 0)
+    {
+        Real fineDead;
+        Real fineLive;
+        Real weightedMoistureFineDead;
+        Real fineDeadMoisture;
+        Real fineDeadOverFineLive;
+        for(int i = 0; i < maxParticles; i++)
+        {
+            if(savrDead[i] > 1.0e-7)
+            {
+                Real fineFuelsWeightingFactor = loadDead[i] * Real(std::exp(-138.0 / savrDead[i]));
+                fineDead += fineFuelsWeightingFactor;
+                weightedMoistureFineDead += fineFuelsWeightingFactor * moistureDead[i];
+            }
+        }
+        if(valueOf(fineDead) > 1.0e-07)
+        {
+            fineDeadMoisture = weightedMoistureFineDead / fineDead;
+        }
+        for(int i = 0; i < numberOfSizeClasses[live]; i++)
+        {
+            if(savrLive[i] > 1.0e-07)
+            {
+                fineLive += loadLive[i] * Real(std::exp(-500.0 / savrLive[i]));
+            }
+        }
+        if(valueOf(fineLive) > 1.0e-7)
+        {
+            fineDeadOverFineLive = fineDead / fineLive;
+        }
+        moistureOfExtinction[live] = (Real(2.9) * fineDeadOverFineLive *
+            (Real(1.0) - fineDeadMoisture / moistureOfExtinction[dead])) - Real(0.226);
+        if(valueOf(moistureOfExtinction[live]) < valueOf(moistureOfExtinction[dead]))
+        {
+            moistureOfExtinction[live] = moistureOfExtinction[dead];
+        }
+    }
+
+    // Characteristic SAVR and weighted values by life state
+    Real weightedHeat[FuelConstants::MaxLifeStates];
+    Real weightedSilica[FuelConstants::MaxLifeStates];
+    Real weightedMoisture[FuelConstants::MaxLifeStates];
+    Real weightedSavr[FuelConstants::MaxLifeStates];
+    Real weightedFuelLoad[FuelConstants::MaxLifeStates];
+    Real totalLoad;
+    for(int i = 0; i < maxParticles; i++)
+    {
+        if(savrDead[i] > 1.0e-07)
+        {
+            int sizeClass = getSavrSizeClass(savrDead[i]);
+            Real netLoad = loadDead[i] * Real(1.0 - totalSilicaContent); // Rothermel 1972, equation 24
+            weightedHeat[dead] += fractionOfTotalSurfaceAreaDead[i] * Real(heatOfCombustionDead);
+            weightedSilica[dead] += fractionOfTotalSurfaceAreaDead[i] * Real(silicaEffective);
+            weightedMoisture[dead] += fractionOfTotalSurfaceAreaDead[i] * moistureDead[i];
+            weightedSavr[dead] += fractionOfTotalSurfaceAreaDead[i] * Real(savrDead[i]);
+            totalLoad += loadDead[i];
+            if(sizeClass >= 0)
+            {
+                weightedFuelLoad[dead] += summedFractionDead[sizeClass] * netLoad;
+            }
+        }
+        if(savrLive[i] > 1.0e-07)
+        {
+            int sizeClass = getSavrSizeClass(savrLive[i]);
+            Real netLoad = loadLive[i] * Real(1.0 - totalSilicaContent); // Rothermel 1972, equation 24
+            weightedHeat[live] += fractionOfTotalSurfaceAreaLive[i] * Real(heatOfCombustionLive);
+            weightedSilica[live] += fractionOfTotalSurfaceAreaLive[i] * Real(silicaEffective);
+            weightedMoisture[live] += fractionOfTotalSurfaceAreaLive[i] * moistureLive[i];
+            weightedSavr[live] += fractionOfTotalSurfaceAreaLive[i] * Real(savrLive[i]);
+            totalLoad += loadLive[i];
+            if(sizeClass >= 0)
+            {
+                weightedFuelLoad[live] += summedFractionLive[sizeClass] * netLoad;
+            }
+        }
+    }
+    Real sigma = fractionOfTotalSurfaceArea[dead] * weightedSavr[dead] + fractionOfTotalSurfaceArea[live] * weightedSavr[live];
+
+    Real bulkDensity = totalLoad / Real(depth);
+    Real packingRatio;
+    for(int i = 0; i < maxParticles; i++)
+    {
+        packingRatio += loadDead[i] / Real(depth * fuelDensity);
+        packingRatio += loadLive[i] / Real(depth * fuelDensity);
+    }
+    Real optimumPackingRatio = Real(3.348) / pow(sigma, 0.8189);
+    Real relativePackingRatio = packingRatio / optimumPackingRatio;
+
+    // Heat sink and propagating flux
+    Real heatSink;
+    for(int i = 0; i < maxParticles; i++)
+    {
+        if(savrDead[i] > 1.0e-07)
+        {
+            Real heatOfPreignition = Real(250.0) + Real(1116.0) * moistureDead[i];
+            heatSink += fractionOfTotalSurfaceArea[dead] * fractionOfTotalSurfaceAreaDead[i] * heatOfPreignition * Real(std::exp(-138.0 / savrDead[i]));
+        }
+        if(savrLive[i] > 1.0e-07)
+        {
+            Real heatOfPreignition = Real(250.0) + Real(1116.0) * moistureLive[i];
+            heatSink += fractionOfTotalSurfaceArea[live] * fractionOfTotalSurfaceAreaLive[i] * heatOfPreignition * Real(std::exp(-138.0 / savrLive[i]));
+        }
+    }
+    heatSink *= bulkDensity;
+
+    Real propagatingFlux = (valueOf(sigma) < 1.0e-07)
+        ? (Real(0.0))
+        : (exp((Real(0.792) + (Real(0.681) * sqrt(sigma))) * (packingRatio + Real(0.1))) / (Real(192.0) + Real(0.2595) * sigma));
+
+    // Reaction intensity
+    Real aa = Real(133.0) / pow(sigma, 0.7913);
+    Real sigmaToTheOnePointFive = pow(sigma, 1.5);
+    Real gammaMax = sigmaToTheOnePointFive / (Real(495.0) + (Real(0.0594) * sigmaToTheOnePointFive));
+    Real gamma = gammaMax * pow(relativePackingRatio, aa) * exp(aa * (Real(1.0) - relativePackingRatio));
+
+    Real reactionIntensity;
+    for(int i = 0; i < FuelConstants::MaxLifeStates; i++)
+    {
+        Real relativeMoisture;
+        Real etaM;
+        Real etaS;
+        if(valueOf(moistureOfExtinction[i]) > 0.0)
+        {
+            relativeMoisture = weightedMoisture[i] / moistureOfExtinction[i];
+        }
+        if(!(valueOf(weightedMoisture[i]) >= valueOf(moistureOfExtinction[i]) || valueOf(relativeMoisture) > 1.0))
+        {
+            etaM = Real(1.0) - (Real(2.59) * relativeMoisture) + (Real(5.11) * relativeMoisture * relativeMoisture) -
+                (Real(3.52) * relativeMoisture * relativeMoisture * relativeMoisture);
+        }
+        Real etaSDenomitator = pow(weightedSilica[i], 0.19);
+        if(valueOf(etaSDenomitator) >= 1e-6)
+        {
+            etaS = Real(0.174) / etaSDenomitator;
+        }
+        if(valueOf(etaS) > 1.0)
+        {
+            etaS = Real(1.0);
+        }
+        reactionIntensity += gamma * weightedFuelLoad[i] * weightedHeat[i] * etaM * etaS;
+    }
+
+    Real noWindNoSlopeSpreadRate = (valueOf(heatSink) < 1.0e-07)
+        ? (Real(0.0))
+        : (reactionIntensity * propagatingFlux / heatSink);
+    if(!(valueOf(noWindNoSlopeSpreadRate) > 0.0))
+    {
+        spreadRate = Real(0.0);
+        firelineIntensity = Real(0.0);
+        return;
+    }
+
+    // Wind and slope factors
+    Real windC = Real(7.47) * exp(Real(-0.133) * pow(sigma, 0.55));
+    Real windB = Real(0.02526) * pow(sigma, 0.54);
+    Real windE = Real(0.715) * exp(Real(-0.000359) * sigma);
+    Real relativePackingRatioFactor = pow(relativePackingRatio, -windE);
+    Real midflameWindSpeed = Real::variable(inputs.midflameWindSpeed, Variable::MidflameWindSpeed);
+    Real phiW = (valueOf(midflameWindSpeed) < 1.0e-07)
+        ? (Real(0.0))
+        : (pow(midflameWindSpeed, windB) * windC * relativePackingRatioFactor);
+
+    Real slope = Real::variable(inputs.slope, Variable::Slope);
+    Real slopex = tan(slope * Real(M_PI / 180.0));
+    Real phiS = Real(5.275) * pow(packingRatio, -0.3) * (slopex * slopex);
+
+    Real windSpeedLimit = Real(0.9) * reactionIntensity;
+    if(valueOf(phiS) > 0.0 && valueOf(phiS) > valueOf(windSpeedLimit))
+    {
+        phiS = windSpeedLimit;
+    }
+
+    // Spread rate in the direction of max spread
+    double windDirRadians = inputs.windDirection * M_PI / 180.0;
+    Real slopeRate = noWindNoSlopeSpreadRate * phiS;
+    Real windRate = noWindNoSlopeSpreadRate * phiW;
+    Real x = slopeRate + (windRate * Real(cos(windDirRadians)));
+    Real y = windRate * Real(sin(windDirRadians));
+    spreadRate = noWindNoSlopeSpreadRate + sqrt((x * x) + (y * y));
+
+    double phiEffectiveWind = valueOf(spreadRate) / valueOf(noWindNoSlopeSpreadRate) - 1.0;
+    double effectiveWindSpeed = std::pow(((phiEffectiveWind * std::pow(valueOf(relativePackingRatio), valueOf(windE))) / valueOf(windC)),
+        1.0 / valueOf(windB));
+    if(effectiveWindSpeed > valueOf(windSpeedLimit))
+    {
+        spreadRate = noWindNoSlopeSpreadRate * (Real(1.0) + windC * pow(windSpeedLimit, windB) * relativePackingRatioFactor);
+    }
+
+    Real residenceTime = (valueOf(sigma) < 1.0e-07)
+        ? (Real(0.0))
+        : (Real(384.0) / sigma);
+    firelineIntensity = spreadRate * reactionIntensity * (residenceTime / Real(60.0));
+}
+
+template<int numberOfDerivatives>
+void calculateSensitivities(const FuelModels& fuelModels, const SurfaceSensitivityInputs& inputs, SurfaceSensitivityOutputs& outputs)
+{
+    SurfaceDual<numberOfDerivatives> spreadRate;
+    SurfaceDual<numberOfDerivatives> firelineIntensity;
+    calculateSurfaceFire(fuelModels, inputs, spreadRate, firelineIntensity);
+
+    outputs.spreadRate = spreadRate.value;
+    outputs.firelineIntensity = firelineIntensity.value;
+    for(int i = 0; i < numberOfDerivatives; i++)
+    {
+        outputs.spreadRateGradient[i] = spreadRate.derivatives[i];
+        outputs.firelineIntensityGradient[i] = firelineIntensity.derivatives[i];
+    }
+}
+
+}
+
+SurfaceSensitivity::SurfaceSensitivity(const FuelModels& fuelModels)
+    : fuelModels_(&fuelModels),
+    isIncludingFuelLoads_(false)
+{
+
+}
+
+void SurfaceSensitivity::setFuelModels(const FuelModels& fuelModels)
+{
+    fuelModels_ = &fuelModels;
+}
+
+void SurfaceSensitivity::setIsIncludingFuelLoads(bool isIncludingFuelLoads)
+{
+    isIncludingFuelLoads_ = isIncludingFuelLoads;
+}
+
+bool SurfaceSensitivity::getIsIncludingFuelLoads() const
+{
+    return isIncludingFuelLoads_;
+}
+
+bool SurfaceSensitivity::calculate(const SurfaceSensitivityInputs& inputs, SurfaceSensitivityOutputs& outputs) const
+{
+    outputs.spreadRate = 0.0;
+    outputs.firelineIntensity = 0.0;
+    for(int i = 0; i < SurfaceSensitivityVariable::NumberOfVariables; i++)
+    {
+        outputs.spreadRateGradient[i] = 0.0;
+        outputs.firelineIntensityGradient[i] = 0.0;
+    }
+
+    int fuelModelNumber = inputs.fuelModelNumber;
+    if(!fuelModels_->isFuelModelDefined(fuelModelNumber) || fuelModels_->isAllFuelLoadZero(fuelModelNumber))
+    {
+        return false;
+    }
+
+    if(isIncludingFuelLoads_)
+    {
+        calculateSensitivities<SurfaceSensitivityVariable::NumberOfVariables>(*fuelModels_, inputs, outputs);
+    }
+    else
+    {
+        calculateSensitivities<SurfaceSensitivityVariable::LoadOneHour>(*fuelModels_, inputs, outputs);
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Forward-mode derivatives of the Rothermel surface spread rate and
+*           fireline intensity with respect to moistures, wind, slope and loads
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SURFACESENSITIVITY_H
+#define SURFACESENSITIVITY_H
+
+#include "fuelModels.h"
+#include "surfaceInputEnums.h"
+
+struct SurfaceSensitivityVariable
+{
+    enum SurfaceSensitivityVariableEnum
+    {
+        MoistureOneHour,        // fraction
+        MoistureTenHour,        // fraction
+        MoistureHundredHour,    // fraction
+        MoistureLiveHerbaceous, // fraction
+        MoistureLiveWoody,      // fraction
+        MidflameWindSpeed,      // ft/min
+        Slope,                  // degrees
+        LoadOneHour,            // lb/ft^2, only with fuel loads included
+        LoadTenHour,            // lb/ft^2, only with fuel loads included
+        LoadHundredHour,        // lb/ft^2, only with fuel loads included
+        LoadLiveHerbaceous,     // lb/ft^2, only with fuel loads included
+        LoadLiveWoody,          // lb/ft^2, only with fuel loads included
+        NumberOfVariables
+    };
+};
+
+// Inputs of SurfaceSensitivity::calculate(), in base units. The wind direction is in degrees
+// clockwise from upslope, as for WindAndSpreadOrientationMode::RelativeToUpslope.
+struct SurfaceSensitivityInputs
+{
+    int fuelModelNumber;
+    double moistureOneHour;
+    double moistureTenHour;
+    double moistureHundredHour;
+    double moistureLiveHerbaceous;
+    double moistureLiveWoody;
+    double midflameWindSpeed;
+    double windDirection;
+    double slope;
+};
+
+// Spread rate in the direction of max spread in ft/min and fireline intensity in btu/ft/s, each with
+// its partial derivatives indexed by SurfaceSensitivityVariable, in output units per variable unit
+struct SurfaceSensitivityOutputs
+{
+    double spreadRate;
+    double firelineIntensity;
+    double spreadRateGradient[SurfaceSensitivityVariable::NumberOfVariables];
+    double firelineIntensityGradient[SurfaceSensitivityVariable::NumberOfVariables];
+};
+
+// Evaluates the standard fuel model path of SurfaceFuelbedIntermediates, SurfaceFireReactionIntensity
+// and SurfaceFire term for term on dual numbers, so a single pass gives the outputs together with their
+// exact derivatives. Every sigma dependent term is recalculated rather than taken from the static fuelbed
+// constants, as those do not carry derivatives with respect to the loads. At the thresholds of the model
+// (dynamic load transfer, extinction, wind speed limit) the derivative is the one of the branch taken.
+// Palmetto-gallberry, western aspen, chaparral and two fuel models runs are not covered.
+class SurfaceSensitivity
+{
+public:
+    explicit SurfaceSensitivity(const FuelModels& fuelModels);
+
+    void setFuelModels(const FuelModels& fuelModels);
+
+    // Off by default, derivatives with respect to the loads are left at zero when off
+    void setIsIncludingFuelLoads(bool isIncludingFuelLoads);
+    bool getIsIncludingFuelLoads() const;
+
+    // Returns false, with all outputs zero, if the fuel model is undefined or has no load
+    bool calculate(const SurfaceSensitivityInputs& inputs, SurfaceSensitivityOutputs& outputs) const;
+
+protected:
+    const FuelModels* fuelModels_;
+    bool isIncludingFuelLoads_;
+};
+
+#endif // SURFACESENSITIVITY_H
@@ -0,0 +1,141 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Shared, lazily built table of the two dimensional expected spread
+*           rate of two fuel models, interpolated over their spread rate ratio
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "surfaceTwoDimensionalSpreadTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "randfuel.h"
+
+namespace
+{
+    const double minimumLengthToBreadthRatio = 1.0;
+    const double lengthToBreadthRatioStep = 0.25;
+}
+
+SurfaceTwoDimensionalSpreadTable::Node::Node()
+    : isBuilt(false)
+{
+    std::fill(countSpreadRates, countSpreadRates + NumberOfCells + 1, 0.0);
+}
+
+SurfaceTwoDimensionalSpreadTable::SurfaceTwoDimensionalSpreadTable()
+    : nodes_(NumberOfRelativeSpreadRateNodes * NumberOfLengthToBreadthRatioNodes),
+    numberOfNodesBuilt_(0)
+{
+
+}
+
+SurfaceTwoDimensionalSpreadTable& SurfaceTwoDimensionalSpreadTable::getSharedTable()
+{
+    static SurfaceTwoDimensionalSpreadTable sharedTable;
+    return sharedTable;
+}
+
+double SurfaceTwoDimensionalSpreadTable::getMinimumLengthToBreadthRatio() const
+{
+    return minimumLengthToBreadthRatio;
+}
+
+double SurfaceTwoDimensionalSpreadTable::getMaximumLengthToBreadthRatio() const
+{
+    return minimumLengthToBreadthRatio + (NumberOfLengthToBreadthRatioNodes - 1) * lengthToBreadthRatioStep;
+}
+
+int SurfaceTwoDimensionalSpreadTable::getNumberOfNodesBuilt() const
+{
+    return numberOfNodesBuilt_.load();
+}
+
+bool SurfaceTwoDimensionalSpreadTable::getExpectedRelativeSpreadRate(double slowerRelativeSpreadRate, double fasterCoverage,
+    double lengthToBreadthRatio, double& expectedRelativeSpreadRate)
+{
+    if (!(lengthToBreadthRatio >= getMinimumLengthToBreadthRatio() && lengthToBreadthRatio <= getMaximumLengthToBreadthRatio()))
+    {
+        return false;
+    }
+    slowerRelativeSpreadRate = std::min(std::max(slowerRelativeSpreadRate, 0.0), 1.0);
+    fasterCoverage = std::min(std::max(fasterCoverage, 0.0), 1.0);
+
+    double x = slowerRelativeSpreadRate * (NumberOfRelativeSpreadRateNodes - 1);
+    int i = std::min((int)x, NumberOfRelativeSpreadRateNodes - 2);
+    double u = x - i;
+    double y = (lengthToBreadthRatio - minimumLengthToBreadthRatio) / lengthToBreadthRatioStep;
+    int j = std::min((int)y, NumberOfLengthToBreadthRatioNodes - 2);
+    double v = y - j;
+
+    const Node& node00 = getNode(i, j);
+    const Node& node10 = getNode(i + 1, j);
+    const Node& node01 = getNode(i, j + 1);
+    const Node& node11 = getNode(i + 1, j + 1);
+
+    // Sum the interpolated coefficients times the probability of each number of faster cells
+    const double binomials[NumberOfCells + 1] = { 1.0, 4.0, 6.0, 4.0, 1.0 };
+    double slowerCoverage = 1.0 - fasterCoverage;
+    double expected = 0.0;
+    for (int k = 0; k <= NumberOfCells; k++)
+    {
+        double countSpreadRate = (1.0 - u) * (1.0 - v) * node00.countSpreadRates[k] + u * (1.0 - v) * node10.countSpreadRates[k] +
+            (1.0 - u) * v * node01.countSpreadRates[k] + u * v * node11.countSpreadRates[k];
+        expected += binomials[k] * pow(fasterCoverage, k) * pow(slowerCoverage, NumberOfCells - k) * countSpreadRate;
+    }
+    expectedRelativeSpreadRate = expected;
+    return true;
+}
+
+const SurfaceTwoDimensionalSpreadTable::Node& SurfaceTwoDimensionalSpreadTable::getNode(int relativeSpreadRateIndex,
+    int lengthToBreadthRatioIndex)
+{
+    Node& node = nodes_[relativeSpreadRateIndex * NumberOfLengthToBreadthRatioNodes + lengthToBreadthRatioIndex];
+    if (node.isBuilt.load(std::memory_order_acquire))
+    {
+        return node;
+    }
+
+    // Work the node out without the lock, a node two runs race for is just worked out twice
+    double countSpreadRates[NumberOfCells + 1];
+    RandFuel randFuel;
+    randFuel.setCellDimensions(10);
+    randFuel.allocFuels(2);
+    randFuel.setFuelData(0, 1.0, 0.5);
+    randFuel.setFuelData(1, (double)relativeSpreadRateIndex / (NumberOfRelativeSpreadRateNodes - 1), 0.5);
+    double maximumRos;
+    double lengthToBreadthRatio = minimumLengthToBreadthRatio + lengthToBreadthRatioIndex * lengthToBreadthRatioStep;
+    randFuel.computeSpreadByFuelCount(2, 2, lengthToBreadthRatio, 1, &maximumRos, countSpreadRates);
+    randFuel.freeFuels();
+
+    std::lock_guard<std::mutex> lock(buildMutex_);
+    if (!node.isBuilt.load(std::memory_order_relaxed))
+    {
+        std::copy(countSpreadRates, countSpreadRates + NumberOfCells + 1, node.countSpreadRates);
+        node.isBuilt.store(true, std::memory_order_release);
+        numberOfNodesBuilt_++;
+    }
+    return node;
+}
@@ -0,0 +1,83 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Shared, lazily built table of the two dimensional expected spread
+*           rate of two fuel models, interpolated over their spread rate ratio
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SURFACETWODIMENSIONALSPREADTABLE_H
+#define SURFACETWODIMENSIONALSPREADTABLE_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Expected relative spread rate of Finney's two dimensional method for two fuel models, with the two
+// samples, two rows and no lateral extensions SurfaceTwoFuelModels uses. It depends only on the slower
+// model's spread rate relative to the faster one's, the faster model's coverage and the length-to-breadth
+// ratio. For an arrangement of the four cells it is a polynomial in the coverage whose coefficients are
+// RandFuel::computeSpreadByFuelCount()'s mean spread rates by number of faster cells, so only those are
+// tabled. They are interpolated bilinearly over a grid of relative spread rates and length-to-breadth
+// ratios, coming within 0.5% of the exact expected spread rate, and the coverage is applied exactly.
+//
+// One table is shared by every run. Its grid nodes are worked out the first time a run needs them; the
+// nodes are published with an atomic flag, so lookups of nodes already built take no lock.
+class SurfaceTwoDimensionalSpreadTable
+{
+public:
+    static const int NumberOfCells = 4;                  // two samples by two rows
+    static const int NumberOfRelativeSpreadRateNodes = 65;
+    static const int NumberOfLengthToBreadthRatioNodes = 61;
+
+    static SurfaceTwoDimensionalSpreadTable& getSharedTable();
+
+    // False when the length-to-breadth ratio is outside the table, the caller then works it out exactly
+    bool getExpectedRelativeSpreadRate(double slowerRelativeSpreadRate, double fasterCoverage,
+        double lengthToBreadthRatio, double& expectedRelativeSpreadRate);
+
+    double getMinimumLengthToBreadthRatio() const;
+    double getMaximumLengthToBreadthRatio() const;
+    int getNumberOfNodesBuilt() const;
+
+protected:
+    SurfaceTwoDimensionalSpreadTable();
+    SurfaceTwoDimensionalSpreadTable(const SurfaceTwoDimensionalSpreadTable& rhs);
+    SurfaceTwoDimensionalSpreadTable& operator=(const SurfaceTwoDimensionalSpreadTable& rhs);
+
+    struct Node
+    {
+        Node();
+
+        std::atomic<bool> isBuilt;
+        double countSpreadRates[NumberOfCells + 1]; // by number of cells of the faster model
+    };
+
+    const Node& getNode(int relativeSpreadRateIndex, int lengthToBreadthRatioIndex);
+
+    std::vector<Node> nodes_;
+    std::mutex buildMutex_;
+    std::atomic<int> numberOfNodesBuilt_;
+};
+
+#endif // SURFACETWODIMENSIONALSPREADTABLE_H
@@ -37,6 +37,7 @@
 #include "randthread.h"
 #include "surfaceFire.h"
 #include "surfaceFuelbedIntermediates.h"
+#include "surfaceTwoDimensionalSpreadTable.h"
 
 SurfaceTwoFuelModels::SurfaceTwoFuelModels(SurfaceFire& surfaceFireSpread)
 {
@@ -120,12 +121,49 @@ void SurfaceTwoFuelModels::calculateWeightedSpreadRate(TwoFuelModelsMethod::TwoF
 
     // Calculate fire outputs for each fuel model
     calculateFireOutputsForEachModel(hasDirectionOfInterest, directionOfInterest, directionMode);
-    
+
+    twoFuelModelsMethod_ = twoFuelModelsMethod;
+    combineFireOutputsOfModels();
+}
+
+// Weights the two fuel models' outputs for every coverage with the fuel models run only once. Leaves the
+// outputs and the SurfaceFire as weighted for the last coverage. Null output arrays are skipped.
+void SurfaceTwoFuelModels::calculateWeightedSpreadRates(TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod,
+    int firstFuelModelNumber, const double* firstFuelModelCoverages, int numberOfCoverages, int secondFuelModelNumber,
+    double* spreadRates, double* firelineIntensities, double* flameLengths)
+{
+    fuelModelNumber_[TwoFuelModelsContants::First] = firstFuelModelNumber;
+    fuelModelNumber_[TwoFuelModelsContants::Second] = secondFuelModelNumber;
+
+    calculateFireOutputsForEachModel(false, 0.0, SurfaceFireSpreadDirectionMode::FromIgnitionPoint);
+
+    twoFuelModelsMethod_ = twoFuelModelsMethod;
+    for (int i = 0; i < numberOfCoverages; i++)
+    {
+        coverageForFuelModel_[TwoFuelModelsContants::First] = firstFuelModelCoverages[i];
+        coverageForFuelModel_[TwoFuelModelsContants::Second] = 1 - coverageForFuelModel_[TwoFuelModelsContants::First];
+        combineFireOutputsOfModels();
+        if (spreadRates != nullptr)
+        {
+            spreadRates[i] = spreadRate_;
+        }
+        if (firelineIntensities != nullptr)
+        {
+            firelineIntensities[i] = fireLineIntensity_;
+        }
+        if (flameLengths != nullptr)
+        {
+            flameLengths[i] = flameLength_;
+        }
+    }
+}
+
+void SurfaceTwoFuelModels::combineFireOutputsOfModels()
+{
     //------------------------------------------------
     // Determine and store combined fuel model outputs
     //------------------------------------------------
     // Fire spread rate depends upon the weighting method...
-    twoFuelModelsMethod_ = twoFuelModelsMethod;
     calculateSpreadRateBasedOnMethod();
 
     // The following assignments are based on Pat's rules:
@@ -289,12 +327,25 @@ double SurfaceTwoFuelModels::surfaceFireExpectedSpreadRate(double* ros, double*
 
 void SurfaceTwoFuelModels::calculateFireOutputsForEachModel(bool hasDirectionOfInterest, double directionOfInterest, SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode)
 {
+    // A model's results don't depend on the coverage or the weighting method, so with the two fuel models cache
+    // on they are reused by every run with the same inputs. Results in a direction of interest are only kept
+    // by the SurfaceFire, so those runs always calculate both models.
+    SurfaceTwoFuelModelsCache& twoFuelModelsCache = surfaceFireSpread_->twoFuelModelsCache_;
+    const SurfaceInputs& surfaceInputs = *surfaceFireSpread_->surfaceInputs_;
     for (int i = 0; i < TwoFuelModelsContants::NumberOfModels; i++)
     {
-        fuelbedDepthForFuelModel_[i] = surfaceFireSpread_->getFuelbedDepth();
+        bool isCacheable = !hasDirectionOfInterest &&
+            twoFuelModelsCache.isCacheable(*surfaceFireSpread_->fuelModels_, surfaceInputs, fuelModelNumber_[i]);
+        SurfaceTwoFuelModelsModelOutputs modelOutputs;
+        if (isCacheable && twoFuelModelsCache.find(surfaceInputs, fuelModelNumber_[i], modelOutputs))
+        {
+            setModelOutputs(i, modelOutputs);
+            continue;
+        }
 
         rosForFuelModel_[i] = surfaceFireSpread_->calculateForwardSpreadRate(fuelModelNumber_[i], hasDirectionOfInterest, directionOfInterest, directionMode);
 
+        fuelbedDepthForFuelModel_[i] = surfaceFireSpread_->getFuelbedDepth();
         reactionIntensityForFuelModel_[i] = surfaceFireSpread_->getReactionIntensity();
         dirMaxSpreadForFuelModel_[i] = surfaceFireSpread_->getDirectionOfMaxSpread();
         midFlameWindSpeedForFuelModel_[i] = surfaceFireSpread_->getMidflameWindSpeed();
@@ -305,13 +356,62 @@ void SurfaceTwoFuelModels::calculateFireOutputsForEachModel(bool hasDirectionOfI
         firelineIntensityForFuelModel_[i] = surfaceFireSpread_->getFirelineIntensity();
         maxFlameLengthForFuelModel_[i] = surfaceFireSpread_->getMaxFlameLength();
         flameLengthForFuelModel_[i] = surfaceFireSpread_->getFlameLength();
-        lengthToWidthRatioForFuelModel_[i] = surfaceFireSpread_->getFireLengthToWidthRatio();
+        // The fire size keeps an earlier run's ellipse when the fire shape was not asked for
+        bool isFireShapeCalculated = hasDirectionOfInterest || (surfaceInputs.getSurfaceFireOutputs() & SurfaceFireOutputs::FireShape) ||
+            (surfaceInputs.getTwoFuelModelsMethod() == TwoFuelModelsMethod::TwoDimensional);
+        lengthToWidthRatioForFuelModel_[i] = isFireShapeCalculated ? surfaceFireSpread_->getFireLengthToWidthRatio() : 1.0;
         heatPerUnitAreaForFuelModel_[i] = surfaceFireSpread_->getHeatPerUnitArea();
+
+        if (isCacheable)
+        {
+            twoFuelModelsCache.insert(surfaceInputs, fuelModelNumber_[i], getModelOutputs(i));
+        }
     }
 }
 
+SurfaceTwoFuelModelsModelOutputs SurfaceTwoFuelModels::getModelOutputs(int i) const
+{
+    SurfaceTwoFuelModelsModelOutputs modelOutputs;
+    modelOutputs.spreadRate = rosForFuelModel_[i];
+    modelOutputs.reactionIntensity = reactionIntensityForFuelModel_[i];
+    modelOutputs.directionOfMaxSpread = dirMaxSpreadForFuelModel_[i];
+    modelOutputs.midflameWindSpeed = midFlameWindSpeedForFuelModel_[i];
+    modelOutputs.windAdjustmentFactor = windAdjustmentFactorForFuelModel_[i];
+    modelOutputs.effectiveWindSpeed = effectiveWindSpeedForFuelModel_[i];
+    modelOutputs.windSpeedLimit = windSpeedLimitForFuelModel_[i];
+    modelOutputs.isWindLimitExceeded = windLimitExceededForFuelModel_[i];
+    modelOutputs.firelineIntensity = firelineIntensityForFuelModel_[i];
+    modelOutputs.maxFlameLength = maxFlameLengthForFuelModel_[i];
+    modelOutputs.flameLength = flameLengthForFuelModel_[i];
+    modelOutputs.fireLengthToWidthRatio = lengthToWidthRatioForFuelModel_[i];
+    modelOutputs.heatPerUnitArea = heatPerUnitAreaForFuelModel_[i];
+    modelOutputs.fuelbedDepth = fuelbedDepthForFuelModel_[i];
+    return modelOutputs;
+}
+
+void SurfaceTwoFuelModels::setModelOutputs(int i, const SurfaceTwoFuelModelsModelOutputs& modelOutputs)
+{
+    rosForFuelModel_[i] = modelOutputs.spreadRate;
+    reactionIntensityForFuelModel_[i] = modelOutputs.reactionIntensity;
+    dirMaxSpreadForFuelModel_[i] = modelOutputs.directionOfMaxSpread;
+    midFlameWindSpeedForFuelModel_[i] = modelOutputs.midflameWindSpeed;
+    windAdjustmentFactorForFuelModel_[i] = modelOutputs.windAdjustmentFactor;
+    effectiveWindSpeedForFuelModel_[i] = modelOutputs.effectiveWindSpeed;
+    windSpeedLimitForFuelModel_[i] = modelOutputs.windSpeedLimit;
+    windLimitExceededForFuelModel_[i] = modelOutputs.isWindLimitExceeded;
+    firelineIntensityForFuelModel_[i] = modelOutputs.firelineIntensity;
+    maxFlameLengthForFuelModel_[i] = modelOutputs.maxFlameLength;
+    flameLengthForFuelModel_[i] = modelOutputs.flameLength;
+    lengthToWidthRatioForFuelModel_[i] = modelOutputs.fireLengthToWidthRatio;
+    heatPerUnitAreaForFuelModel_[i] = modelOutputs.heatPerUnitArea;
+    fuelbedDepthForFuelModel_[i] = modelOutputs.fuelbedDepth;
+}
+
 void SurfaceTwoFuelModels::calculateSpreadRateBasedOnMethod()
 {
+    // No spread if neither method applies, such as harmonic with a model that doesn't spread
+    spreadRate_ = 0.0;
+
     // If area weighted spread rate ...
     if (twoFuelModelsMethod_ == TwoFuelModelsMethod::Arithmetic)
     {
@@ -335,7 +435,35 @@ void SurfaceTwoFuelModels::calculateSpreadRateBasedOnMethod()
         int samples = 2; // from behavePlus.xml
         int depth = 2; // from behavePlus.xml
         int laterals = 0; // from behavePlus.xml
-        spreadRate_ = surfaceFireExpectedSpreadRate(rosForFuelModel_, coverageForFuelModel_, TwoFuelModelsContants::NumberOfModels, lbRatio,
-            samples, depth, laterals);
+        bool isInterpolated = (surfaceFireSpread_->surfaceInputs_->getTwoDimensionalSpreadMode() == TwoDimensionalSpreadMode::Interpolated) &&
+            interpolateExpectedSpreadRate(lbRatio, spreadRate_);
+        if (!isInterpolated)
+        {
+            spreadRate_ = surfaceFireExpectedSpreadRate(rosForFuelModel_, coverageForFuelModel_, TwoFuelModelsContants::NumberOfModels, lbRatio,
+                samples, depth, laterals);
+        }
+    }
+}
+
+bool SurfaceTwoFuelModels::interpolateExpectedSpreadRate(double lbRatio, double& expectedRos)
+{
+    // The exact method normalizes the coverages and the spread rates by the faster model's
+    int faster = (rosForFuelModel_[TwoFuelModelsContants::First] >= rosForFuelModel_[TwoFuelModelsContants::Second]) ?
+        TwoFuelModelsContants::First : TwoFuelModelsContants::Second;
+    int slower = TwoFuelModelsContants::NumberOfModels - 1 - faster;
+    double totalCoverage = coverageForFuelModel_[faster] + coverageForFuelModel_[slower];
+    if (rosForFuelModel_[faster] <= 0.0 || totalCoverage <= 0.0)
+    {
+        return false; // leave the edge cases to the exact method
+    }
+
+    double expectedRelativeRos = 0.0;
+    SurfaceTwoDimensionalSpreadTable& table = SurfaceTwoDimensionalSpreadTable::getSharedTable();
+    if (!table.getExpectedRelativeSpreadRate(rosForFuelModel_[slower] / rosForFuelModel_[faster],
+        coverageForFuelModel_[faster] / totalCoverage, lbRatio, expectedRelativeRos))
+    {
+        return false;
     }
+    expectedRos = expectedRelativeRos * rosForFuelModel_[faster];
+    return true;
 }
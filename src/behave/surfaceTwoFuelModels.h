@@ -33,6 +33,7 @@
 #define SURFACETWOFUELMODELS_H
 
 #include "surfaceInputs.h"
+#include "surfaceTwoFuelModelsCache.h"
 
 class SurfaceFuelbedIntermediates;
 class SurfaceFire;
@@ -45,6 +46,9 @@ public:
         int firstFuelModelNumber, double firstFuelModelCoverage, int secondFuelModelNumber,
         bool hasDirectionOfInterest, double directionOfInterest,
         SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode);
+    void calculateWeightedSpreadRates(TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod,
+        int firstFuelModelNumber, const double* firstFuelModelCoverages, int numberOfCoverages, int secondFuelModelNumber,
+        double* spreadRates, double* firelineIntensities, double* flameLengths);
 
     //public getters
     bool getWindLimitExceeded() const;
@@ -64,9 +68,14 @@ public:
 protected:
     double surfaceFireExpectedSpreadRate(double* ros, double* coverage, int fuels,
         double lbRatio, int samples, int depth, int laterals);
+    // With TwoDimensionalSpreadMode::Interpolated, false if the shared table doesn't cover the inputs
+    bool interpolateExpectedSpreadRate(double lbRatio, double& expectedRos);
     void calculateFireOutputsForEachModel(bool hasDirectionOfInterest, double directionOfInterest,
         SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum directionMode);
     void calculateSpreadRateBasedOnMethod();
+    void combineFireOutputsOfModels();
+    SurfaceTwoFuelModelsModelOutputs getModelOutputs(int i) const;
+    void setModelOutputs(int i, const SurfaceTwoFuelModelsModelOutputs& modelOutputs);
 
     SurfaceFire* surfaceFireSpread_;
 
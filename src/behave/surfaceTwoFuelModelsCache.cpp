@@ -0,0 +1,237 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Bounded least recently used cache of the per fuel model results of
+*           two fuel models runs, keyed on fuel model and run inputs
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "surfaceTwoFuelModelsCache.h"
+
+#include <cstring>
+#include <functional>
+
+#include "fuelModels.h"
+#include "surfaceInputs.h"
+
+SurfaceTwoFuelModelsCache::SurfaceTwoFuelModelsCache()
+    : capacity_(0),
+    numberOfHits_(0),
+    numberOfMisses_(0)
+{
+
+}
+
+// Copies only the capacity, the entries hold state tied to the fuel models and inputs of the original
+SurfaceTwoFuelModelsCache::SurfaceTwoFuelModelsCache(const SurfaceTwoFuelModelsCache& rhs)
+    : capacity_(rhs.capacity_),
+    numberOfHits_(0),
+    numberOfMisses_(0)
+{
+
+}
+
+SurfaceTwoFuelModelsCache& SurfaceTwoFuelModelsCache::operator=(const SurfaceTwoFuelModelsCache& rhs)
+{
+    if (this != &rhs)
+    {
+        clear();
+        resetCounters();
+        capacity_ = rhs.capacity_;
+    }
+    return *this;
+}
+
+void SurfaceTwoFuelModelsCache::setCapacity(int capacity)
+{
+    capacity_ = (capacity < 0) ? 0 : capacity;
+    while (static_cast<int>(entries_.size()) > capacity_)
+    {
+        evictLeastRecentlyUsed();
+    }
+}
+
+void SurfaceTwoFuelModelsCache::clear()
+{
+    index_.clear();
+    entries_.clear();
+}
+
+void SurfaceTwoFuelModelsCache::resetCounters()
+{
+    numberOfHits_ = 0;
+    numberOfMisses_ = 0;
+}
+
+int SurfaceTwoFuelModelsCache::getCapacity() const
+{
+    return capacity_;
+}
+
+int SurfaceTwoFuelModelsCache::getNumberOfEntries() const
+{
+    return static_cast<int>(entries_.size());
+}
+
+long SurfaceTwoFuelModelsCache::getNumberOfHits() const
+{
+    return numberOfHits_;
+}
+
+long SurfaceTwoFuelModelsCache::getNumberOfMisses() const
+{
+    return numberOfMisses_;
+}
+
+bool SurfaceTwoFuelModelsCache::isCacheable(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs, int fuelModelNumber) const
+{
+    if (capacity_ == 0)
+    {
+        return false;
+    }
+    bool isUsingSpecialFuel = surfaceInputs.getIsUsingPalmettoGallberry() || surfaceInputs.getIsUsingWesternAspen() ||
+        surfaceInputs.getIsUsingChaparral();
+    return !isUsingSpecialFuel && fuelModels.isFuelModelReserved(fuelModelNumber);
+}
+
+bool SurfaceTwoFuelModelsCache::find(const SurfaceInputs& surfaceInputs, int fuelModelNumber, SurfaceTwoFuelModelsModelOutputs& modelOutputs)
+{
+    auto found = index_.find(makeKey(surfaceInputs, fuelModelNumber));
+    if (found == index_.end())
+    {
+        numberOfMisses_++;
+        return false;
+    }
+
+    // Move to the front to mark it as most recently used, list iterators stay valid
+    entries_.splice(entries_.begin(), entries_, found->second);
+    modelOutputs = found->second->modelOutputs;
+    numberOfHits_++;
+    return true;
+}
+
+void SurfaceTwoFuelModelsCache::insert(const SurfaceInputs& surfaceInputs, int fuelModelNumber, const SurfaceTwoFuelModelsModelOutputs& modelOutputs)
+{
+    if (capacity_ == 0)
+    {
+        return;
+    }
+
+    Key key = makeKey(surfaceInputs, fuelModelNumber);
+    auto found = index_.find(key);
+    if (found != index_.end())
+    {
+        entries_.splice(entries_.begin(), entries_, found->second);
+        found->second->modelOutputs = modelOutputs;
+        return;
+    }
+
+    if (static_cast<int>(entries_.size()) >= capacity_)
+    {
+        evictLeastRecentlyUsed();
+    }
+    entries_.push_front(Entry{ key, modelOutputs });
+    index_[key] = entries_.begin();
+}
+
+SurfaceTwoFuelModelsCache::Key SurfaceTwoFuelModelsCache::makeKey(const SurfaceInputs& surfaceInputs, int fuelModelNumber) const
+{
+    Key key;
+    key.fuelModelNumber = fuelModelNumber;
+    key.modes[0] = static_cast<int>(surfaceInputs.getMoistureInputMode());
+    key.modes[1] = static_cast<int>(surfaceInputs.getWindHeightInputMode());
+    key.modes[2] = static_cast<int>(surfaceInputs.getWindAndSpreadOrientationMode());
+    key.modes[3] = static_cast<int>(surfaceInputs.getWindAdjustmentFactorCalculationMethod());
+    key.modes[4] = surfaceInputs.getSurfaceFireOutputs(); // outputs left out of a run are stored as zero
+
+    // Values are compared exactly, unlike the fuelbed cache's quantized moistures, as spread rate is
+    // sensitive to all of them
+    const double values[NumberOfValues] =
+    {
+        surfaceInputs.getMoistureOneHour(FractionUnits::Fraction),
+        surfaceInputs.getMoistureTenHour(FractionUnits::Fraction),
+        surfaceInputs.getMoistureHundredHour(FractionUnits::Fraction),
+        surfaceInputs.getMoistureLiveHerbaceous(FractionUnits::Fraction),
+        surfaceInputs.getMoistureLiveWoody(FractionUnits::Fraction),
+        surfaceInputs.getMoistureDeadAggregateValue(FractionUnits::Fraction),
+        surfaceInputs.getMoistureLiveAggregateValue(FractionUnits::Fraction),
+        surfaceInputs.getWindSpeed(SpeedUnits::FeetPerMinute),
+        surfaceInputs.getWindDirection(),
+        surfaceInputs.getSlope(SlopeUnits::Degrees),
+        surfaceInputs.getAspect(),
+        surfaceInputs.getCanopyCover(FractionUnits::Fraction),
+        surfaceInputs.getCanopyHeight(LengthUnits::Feet),
+        surfaceInputs.getCrownRatio(FractionUnits::Fraction),
+        surfaceInputs.getUserProvidedWindAdjustmentFactor()
+    };
+    memcpy(key.values, values, sizeof(key.values));
+    return key;
+}
+
+void SurfaceTwoFuelModelsCache::evictLeastRecentlyUsed()
+{
+    if (!entries_.empty())
+    {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+    }
+}
+
+bool SurfaceTwoFuelModelsCache::Key::operator==(const Key& rhs) const
+{
+    if (fuelModelNumber != rhs.fuelModelNumber)
+    {
+        return false;
+    }
+    for (int i = 0; i < NumberOfModes; i++)
+    {
+        if (modes[i] != rhs.modes[i])
+        {
+            return false;
+        }
+    }
+    for (int i = 0; i < NumberOfValues; i++)
+    {
+        if (values[i] != rhs.values[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t SurfaceTwoFuelModelsCache::KeyHash::operator()(const Key& key) const
+{
+    // FNV-1a style combination of the key fields
+    std::size_t hash = 14695981039346656037ULL;
+    hash = (hash ^ static_cast<std::size_t>(key.fuelModelNumber)) * 1099511628211ULL;
+    for (int i = 0; i < NumberOfModes; i++)
+    {
+        hash = (hash ^ static_cast<std::size_t>(key.modes[i])) * 1099511628211ULL;
+    }
+    for (int i = 0; i < NumberOfValues; i++)
+    {
+        hash = (hash ^ std::hash<double>()(key.values[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
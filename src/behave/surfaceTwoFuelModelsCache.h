@@ -0,0 +1,118 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Bounded least recently used cache of the per fuel model results of
+*           two fuel models runs, keyed on fuel model and run inputs
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SURFACETWOFUELMODELSCACHE_H
+#define SURFACETWOFUELMODELSCACHE_H
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+class FuelModels;
+class SurfaceInputs;
+
+// Results of one of the fuel models of a two fuel models run, in base units
+struct SurfaceTwoFuelModelsModelOutputs
+{
+    double spreadRate;
+    double reactionIntensity;
+    double directionOfMaxSpread;
+    double midflameWindSpeed;
+    double windAdjustmentFactor;
+    double effectiveWindSpeed;
+    double windSpeedLimit;
+    bool isWindLimitExceeded;
+    double firelineIntensity;
+    double maxFlameLength;
+    double flameLength;
+    double fireLengthToWidthRatio;
+    double heatPerUnitArea;
+    double fuelbedDepth;
+};
+
+// Remembers the results of each fuel model of recent two fuel models runs. They depend on neither the
+// first fuel model coverage nor the weighting method, so runs that only change those just redo the
+// weighting. Entries are keyed on the fuel model number and every input the model's run reads: the
+// moistures, wind, slope, aspect, canopy and wind adjustment factor inputs.
+// As with SurfaceFuelbedCache only standard fuel models are cached, and runs using Palmetto-Gallberry,
+// Western Aspen or Chaparral bypass the cache. A capacity of zero, the default, turns the cache off.
+class SurfaceTwoFuelModelsCache
+{
+public:
+    SurfaceTwoFuelModelsCache();
+    SurfaceTwoFuelModelsCache(const SurfaceTwoFuelModelsCache& rhs);
+    SurfaceTwoFuelModelsCache& operator=(const SurfaceTwoFuelModelsCache& rhs);
+
+    void setCapacity(int capacity);
+    void clear();
+    void resetCounters();
+
+    int getCapacity() const;
+    int getNumberOfEntries() const;
+    long getNumberOfHits() const;
+    long getNumberOfMisses() const;
+
+    bool isCacheable(const FuelModels& fuelModels, const SurfaceInputs& surfaceInputs, int fuelModelNumber) const;
+    bool find(const SurfaceInputs& surfaceInputs, int fuelModelNumber, SurfaceTwoFuelModelsModelOutputs& modelOutputs);
+    void insert(const SurfaceInputs& surfaceInputs, int fuelModelNumber, const SurfaceTwoFuelModelsModelOutputs& modelOutputs);
+
+protected:
+    static const int NumberOfModes = 5;
+    static const int NumberOfValues = 15;
+
+    struct Key
+    {
+        int fuelModelNumber;
+        int modes[NumberOfModes];
+        double values[NumberOfValues];
+
+        bool operator==(const Key& rhs) const;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        Key key;
+        SurfaceTwoFuelModelsModelOutputs modelOutputs;
+    };
+
+    Key makeKey(const SurfaceInputs& surfaceInputs, int fuelModelNumber) const;
+    void evictLeastRecentlyUsed();
+
+    int capacity_;
+    long numberOfHits_;
+    long numberOfMisses_;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+};
+
+#endif // SURFACETWOFUELMODELSCACHE_H
@@ -0,0 +1,307 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Parallel sweep tables of surface fire outputs over the
+*           Cartesian product of varied inputs
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+
+#include "sweepTableRunner.h"
+
+#include <algorithm>
+#include <numeric>
+#include "behaveRun.h"
+#include "threadPool.h"
+
+namespace
+{
+
+// Cells per block, the unit of work shared out over the threads. Each block is evaluated in order
+// as one surface batch, so longer blocks reuse more of the outer axes' work.
+const long cellsPerBlock = 256;
+
+// How far out an input's axis is evaluated: changing the fuelbed invalidates every stage of the
+// run, the wind and canopy only the wind adjustment and wind factors, and the rest only the spread
+// direction and slope factor
+int getInputStage(SweepTableInput::SweepTableInputEnum input)
+{
+    switch(input)
+    {
+        case SweepTableInput::FuelModelNumber:
+        case SweepTableInput::MoistureOneHour:
+        case SweepTableInput::MoistureTenHour:
+        case SweepTableInput::MoistureHundredHour:
+        case SweepTableInput::MoistureLiveHerbaceous:
+        case SweepTableInput::MoistureLiveWoody:
+        {
+            return 0;
+        }
+        case SweepTableInput::WindSpeed:
+        case SweepTableInput::CanopyCover:
+        case SweepTableInput::CanopyHeight:
+        case SweepTableInput::CrownRatio:
+        {
+            return 1;
+        }
+        default:
+        {
+            return 2;
+        }
+    }
+}
+
+} // namespace
+
+struct SweepTableRunner::Worker
+{
+    Worker(const SweepTableRunner& runner)
+        : surface(runner.surfacePrototype_),
+        inputs(SweepTableInput::NumberOfInputs * cellsPerBlock),
+        fuelModelNumber(cellsPerBlock),
+        outputs(SweepTableOutput::NumberOfOutputs * cellsPerBlock),
+        cells(cellsPerBlock),
+        axisIndices(runner.axes_.size())
+    {
+    }
+
+    Surface surface;
+
+    // Scratch arrays of one block, the batch inputs and outputs, the cube index of each cell and the
+    // index along each axis, in evaluation order, of the cell being filled in
+    std::vector<double> inputs;
+    std::vector<int> fuelModelNumber;
+    std::vector<double> outputs;
+    std::vector<long> cells;
+    std::vector<int> axisIndices;
+};
+
+SweepTableRunner::SweepTableRunner(const BehaveRun& prototype)
+    : surfacePrototype_(prototype.surface),
+    numberOfThreads_(0)
+{
+}
+
+void SweepTableRunner::setNumberOfThreads(int numberOfThreads)
+{
+    numberOfThreads_ = numberOfThreads;
+}
+
+bool SweepTableRunner::addAxis(SweepTableInput::SweepTableInputEnum input, const double* values, int numberOfValues)
+{
+    if(input < 0 || input >= SweepTableInput::NumberOfInputs || values == nullptr || numberOfValues <= 0)
+    {
+        return false;
+    }
+    for(const Axis& axis : axes_)
+    {
+        if(axis.input == input)
+        {
+            return false;
+        }
+    }
+    Axis axis;
+    axis.input = input;
+    axis.values.assign(values, values + numberOfValues);
+    axes_.push_back(axis);
+    return true;
+}
+
+void SweepTableRunner::clearAxes()
+{
+    axes_.clear();
+}
+
+void SweepTableRunner::run()
+{
+    long numberOfCells = getNumberOfCells();
+    for(int output = 0; output < SweepTableOutput::NumberOfOutputs; output++)
+    {
+        outputs_[output].assign(numberOfCells, 0.0);
+    }
+
+    // Inputs without an axis keep the prototype's values
+    const Surface& surface = surfacePrototype_;
+    double fixedInputs[SweepTableInput::NumberOfInputs];
+    fixedInputs[SweepTableInput::FuelModelNumber] = surface.getFuelModelNumber();
+    fixedInputs[SweepTableInput::MoistureOneHour] = surface.getMoistureOneHour(FractionUnits::Fraction);
+    fixedInputs[SweepTableInput::MoistureTenHour] = surface.getMoistureTenHour(FractionUnits::Fraction);
+    fixedInputs[SweepTableInput::MoistureHundredHour] = surface.getMoistureHundredHour(FractionUnits::Fraction);
+    fixedInputs[SweepTableInput::MoistureLiveHerbaceous] = surface.getMoistureLiveHerbaceous(FractionUnits::Fraction);
+    fixedInputs[SweepTableInput::MoistureLiveWoody] = surface.getMoistureLiveWoody(FractionUnits::Fraction);
+    fixedInputs[SweepTableInput::WindSpeed] = surface.getInputWindSpeed(SpeedUnits::FeetPerMinute);
+    fixedInputs[SweepTableInput::WindDirection] = surface.getWindDirection();
+    fixedInputs[SweepTableInput::Slope] = surface.getSlope(SlopeUnits::Degrees);
+    fixedInputs[SweepTableInput::Aspect] = surface.getAspect();
+    fixedInputs[SweepTableInput::CanopyCover] = surface.getCanopyCover(FractionUnits::Fraction);
+    fixedInputs[SweepTableInput::CanopyHeight] = surface.getCanopyHeight(LengthUnits::Feet);
+    fixedInputs[SweepTableInput::CrownRatio] = surface.getCrownRatio(FractionUnits::Fraction);
+
+    // Axes from outermost to innermost, axes of the same stage keep the order they were added in
+    std::vector<int> evaluationOrder(axes_.size());
+    std::iota(evaluationOrder.begin(), evaluationOrder.end(), 0);
+    std::stable_sort(evaluationOrder.begin(), evaluationOrder.end(), [this](int lhs, int rhs)
+    {
+        return getInputStage(axes_[lhs].input) < getInputStage(axes_[rhs].input);
+    });
+
+    long numberOfBlocks = (numberOfCells + cellsPerBlock - 1) / cellsPerBlock;
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    int numberOfSlots = threadPool->getNumberOfSlots((int)std::min<long>(numberOfBlocks, (numberOfThreads_ > 0) ?
+        numberOfThreads_ : numberOfBlocks));
+    std::vector<Worker> workers(numberOfSlots, Worker(*this));
+
+    threadPool->runChunks(numberOfBlocks, 1, [&](int slot, long begin, long end)
+    {
+        for(long block = begin; block < end; block++)
+        {
+            runBlock(workers[slot], evaluationOrder, fixedInputs, block);
+        }
+    }, numberOfSlots);
+}
+
+void SweepTableRunner::runBlock(Worker& worker, const std::vector<int>& evaluationOrder, const double* fixedInputs, long block)
+{
+    long firstCell = block * cellsPerBlock;
+    int numberOfCells = (int)std::min(cellsPerBlock, getNumberOfCells() - firstCell);
+    int numberOfAxes = (int)axes_.size();
+
+    // Decompose the block's first position in evaluation order into an index along each axis
+    std::vector<int>& axisIndices = worker.axisIndices;
+    long position = firstCell;
+    for(int k = numberOfAxes - 1; k >= 0; k--)
+    {
+        long axisLength = (long)axes_[evaluationOrder[k]].values.size();
+        axisIndices[k] = (int)(position % axisLength);
+        position /= axisLength;
+    }
+
+    double* inputs[SweepTableInput::NumberOfInputs];
+    for(int input = 0; input < SweepTableInput::NumberOfInputs; input++)
+    {
+        inputs[input] = &worker.inputs[input * cellsPerBlock];
+        std::fill(inputs[input], inputs[input] + numberOfCells, fixedInputs[input]);
+    }
+
+    std::vector<int> axisIndicesInCube(numberOfAxes);
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        for(int k = 0; k < numberOfAxes; k++)
+        {
+            const Axis& axis = axes_[evaluationOrder[k]];
+            inputs[axis.input][i] = axis.values[axisIndices[k]];
+            axisIndicesInCube[evaluationOrder[k]] = axisIndices[k];
+        }
+        worker.cells[i] = getCellIndex(axisIndicesInCube.data());
+        worker.fuelModelNumber[i] = (int)inputs[SweepTableInput::FuelModelNumber][i];
+
+        // Step to the next cell, the innermost axis fastest
+        for(int k = numberOfAxes - 1; k >= 0; k--)
+        {
+            if(++axisIndices[k] < (int)axes_[evaluationOrder[k]].values.size())
+            {
+                break;
+            }
+            axisIndices[k] = 0;
+        }
+    }
+
+    double* outputs[SweepTableOutput::NumberOfOutputs];
+    for(int output = 0; output < SweepTableOutput::NumberOfOutputs; output++)
+    {
+        outputs[output] = &worker.outputs[output * cellsPerBlock];
+    }
+    SurfaceBatchInputs batchInputs = { numberOfCells, worker.fuelModelNumber.data(), inputs[SweepTableInput::MoistureOneHour],
+        inputs[SweepTableInput::MoistureTenHour], inputs[SweepTableInput::MoistureHundredHour],
+        inputs[SweepTableInput::MoistureLiveHerbaceous], inputs[SweepTableInput::MoistureLiveWoody], inputs[SweepTableInput::WindSpeed],
+        inputs[SweepTableInput::WindDirection], inputs[SweepTableInput::Slope], inputs[SweepTableInput::Aspect],
+        inputs[SweepTableInput::CanopyCover], inputs[SweepTableInput::CanopyHeight], inputs[SweepTableInput::CrownRatio] };
+    SurfaceBatchOutputs batchOutputs = { outputs[SweepTableOutput::SpreadRate], outputs[SweepTableOutput::FirelineIntensity],
+        outputs[SweepTableOutput::FlameLength], outputs[SweepTableOutput::DirectionOfMaxSpread],
+        outputs[SweepTableOutput::FireLengthToWidthRatio] };
+    worker.surface.doSurfaceRunBatch(batchInputs, batchOutputs);
+
+    // Every cell belongs to exactly one block, so the threads write disjoint parts of the cubes
+    for(int output = 0; output < SweepTableOutput::NumberOfOutputs; output++)
+    {
+        std::vector<double>& cube = outputs_[output];
+        for(int i = 0; i < numberOfCells; i++)
+        {
+            cube[worker.cells[i]] = outputs[output][i];
+        }
+    }
+}
+
+int SweepTableRunner::getNumberOfAxes() const
+{
+    return (int)axes_.size();
+}
+
+SweepTableInput::SweepTableInputEnum SweepTableRunner::getAxisInput(int axis) const
+{
+    return (axis >= 0 && axis < (int)axes_.size()) ? axes_[axis].input : SweepTableInput::NumberOfInputs;
+}
+
+int SweepTableRunner::getAxisLength(int axis) const
+{
+    return (axis >= 0 && axis < (int)axes_.size()) ? (int)axes_[axis].values.size() : 0;
+}
+
+long SweepTableRunner::getNumberOfCells() const
+{
+    long numberOfCells = 1;
+    for(const Axis& axis : axes_)
+    {
+        numberOfCells *= (long)axis.values.size();
+    }
+    return numberOfCells;
+}
+
+long SweepTableRunner::getCellIndex(const int* axisIndices) const
+{
+    long cell = 0;
+    for(size_t axis = 0; axis < axes_.size(); axis++)
+    {
+        if(axisIndices[axis] < 0 || axisIndices[axis] >= (int)axes_[axis].values.size())
+        {
+            return -1;
+        }
+        cell = cell * (long)axes_[axis].values.size() + axisIndices[axis];
+    }
+    return cell;
+}
+
+const double* SweepTableRunner::getOutputCube(SweepTableOutput::SweepTableOutputEnum output) const
+{
+    if(output < 0 || output >= SweepTableOutput::NumberOfOutputs || outputs_[output].empty())
+    {
+        return nullptr;
+    }
+    return outputs_[output].data();
+}
+
+double SweepTableRunner::getOutput(SweepTableOutput::SweepTableOutputEnum output, long cell) const
+{
+    const double* cube = getOutputCube(output);
+    return (cube != nullptr && cell >= 0 && cell < (long)outputs_[output].size()) ? cube[cell] : 0.0;
+}
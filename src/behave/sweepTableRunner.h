@@ -0,0 +1,125 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Parallel sweep tables of surface fire outputs over the
+*           Cartesian product of varied inputs
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef SWEEPTABLERUNNER_H
+#define SWEEPTABLERUNNER_H
+
+#include <vector>
+#include "surface.h"
+
+class BehaveRun;
+
+// Inputs a sweep table can vary, in base units as for SurfaceBatchInputs: moistures as fractions,
+// wind speed in ft/min at the prototype's wind height, slope in degrees, canopy height in ft
+struct SweepTableInput
+{
+    enum SweepTableInputEnum
+    {
+        FuelModelNumber,
+        MoistureOneHour,
+        MoistureTenHour,
+        MoistureHundredHour,
+        MoistureLiveHerbaceous,
+        MoistureLiveWoody,
+        WindSpeed,
+        WindDirection,
+        Slope,
+        Aspect,
+        CanopyCover,
+        CanopyHeight,
+        CrownRatio,
+        NumberOfInputs
+    };
+};
+
+// Outputs of a sweep table, in the base units of SurfaceBatchOutputs
+struct SweepTableOutput
+{
+    enum SweepTableOutputEnum
+    {
+        SpreadRate,
+        FirelineIntensity,
+        FlameLength,
+        DirectionOfMaxSpread,
+        FireLengthToWidthRatio,
+        NumberOfOutputs
+    };
+};
+
+// BehavePlus-style tables: runs the surface fire in the direction of max spread for every
+// combination of the values of up to one axis per input, the other inputs taken from the
+// prototype's surface inputs. Each output is a dense cube with one dimension per axis, the
+// first axis added varying slowest.
+//
+// Cells are evaluated with the inputs that invalidate the most work on the outside: fuel model
+// and moistures first, then wind speed and canopy, with wind direction, slope and aspect on the
+// inside. Runs of cells in that order are shared out over a ThreadPool and handed to
+// Surface::doSurfaceRunBatch(), which reuses the fuelbed and wind adjustment results from one
+// cell to the next while their inputs are unchanged. Each cell's result only depends on its
+// inputs, so the cube is the same for any number of threads.
+class SweepTableRunner
+{
+public:
+    explicit SweepTableRunner(const BehaveRun& prototype);
+
+    // Zero or less uses one thread per hardware thread
+    void setNumberOfThreads(int numberOfThreads);
+
+    // Returns false, leaving the axes unchanged, if the input already has an axis or there are no values
+    bool addAxis(SweepTableInput::SweepTableInputEnum input, const double* values, int numberOfValues);
+    void clearAxes();
+
+    void run();
+
+    int getNumberOfAxes() const;
+    SweepTableInput::SweepTableInputEnum getAxisInput(int axis) const;
+    int getAxisLength(int axis) const;
+    long getNumberOfCells() const;
+    // Position in the output cubes of the cell at one index along each axis, in the order the axes were added
+    long getCellIndex(const int* axisIndices) const;
+
+    // numberOfCells values, null before the first run()
+    const double* getOutputCube(SweepTableOutput::SweepTableOutputEnum output) const;
+    double getOutput(SweepTableOutput::SweepTableOutputEnum output, long cell) const;
+
+protected:
+    struct Axis
+    {
+        SweepTableInput::SweepTableInputEnum input;
+        std::vector<double> values;
+    };
+    struct Worker;
+    void runBlock(Worker& worker, const std::vector<int>& evaluationOrder, const double* fixedInputs, long block);
+
+    Surface surfacePrototype_;
+    int numberOfThreads_;
+    std::vector<Axis> axes_;
+    std::vector<double> outputs_[SweepTableOutput::NumberOfOutputs];
+};
+
+#endif // SWEEPTABLERUNNER_H
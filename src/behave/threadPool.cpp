@@ -0,0 +1,433 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Fixed-size pool of worker threads used to run independent pieces
+*           of a calculation concurrently
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#include "threadPool.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    // The pool whose batch this thread is running a task of, null outside any batch
+    thread_local const ThreadPool* currentThreadPool = nullptr;
+
+    // Sets currentThreadPool for the lifetime of a scope
+    class CurrentThreadPoolScope
+    {
+    public:
+        explicit CurrentThreadPoolScope(const ThreadPool* threadPool)
+            : previous_(currentThreadPool)
+        {
+            currentThreadPool = threadPool;
+        }
+
+        ~CurrentThreadPoolScope()
+        {
+            currentThreadPool = previous_;
+        }
+
+    private:
+        const ThreadPool* previous_;
+    };
+
+    std::mutex sharedThreadPoolMutex;
+    std::shared_ptr<ThreadPool> sharedThreadPool;
+    int sharedNumberOfThreads = 0;
+    bool sharedIsPinningThreads = false;
+}
+
+ThreadPool::ThreadPool(int numberOfThreads, bool isPinningThreads)
+    : isPinningThreads_(isPinningThreads),
+    tasks_(nullptr),
+    isPlacedOnThreads_(false),
+    nextTask_(0),
+    tasksFinished_(0),
+    generation_(0),
+    isShuttingDown_(false)
+{
+    // The calling thread always takes part, so only spawn the rest
+    for (int i = 1; i < numberOfThreads; i++)
+    {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isShuttingDown_ = true;
+    }
+    workAvailable_.notify_all();
+    for (size_t i = 0; i < workers_.size(); i++)
+    {
+        workers_[i].join();
+    }
+}
+
+std::shared_ptr<ThreadPool> ThreadPool::getShared()
+{
+    std::lock_guard<std::mutex> lock(sharedThreadPoolMutex);
+    if (!sharedThreadPool)
+    {
+        int numberOfThreads = sharedNumberOfThreads;
+        if (numberOfThreads <= 0)
+        {
+            numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+        }
+        sharedThreadPool = std::make_shared<ThreadPool>(numberOfThreads, sharedIsPinningThreads);
+    }
+    return sharedThreadPool;
+}
+
+void ThreadPool::configureShared(int numberOfThreads, bool isPinningThreads)
+{
+    std::lock_guard<std::mutex> lock(sharedThreadPoolMutex);
+    sharedNumberOfThreads = numberOfThreads;
+    sharedIsPinningThreads = isPinningThreads;
+    sharedThreadPool.reset();
+}
+
+int ThreadPool::getNumberOfThreads() const
+{
+    return static_cast<int>(workers_.size()) + 1;
+}
+
+bool ThreadPool::getIsPinningThreads() const
+{
+    return isPinningThreads_;
+}
+
+int ThreadPool::getNumberOfSlots(int maximumNumberOfSlots) const
+{
+    if (maximumNumberOfSlots <= 0)
+    {
+        return getNumberOfThreads();
+    }
+    return std::min(maximumNumberOfSlots, getNumberOfThreads());
+}
+
+void ThreadPool::runTasks(const std::vector<std::function<void()>>& tasks)
+{
+    runBatch(tasks, false);
+}
+
+void ThreadPool::runBatch(const std::vector<std::function<void()>>& tasks, bool isPlacedOnThreads)
+{
+    if (tasks.empty())
+    {
+        return;
+    }
+
+    if (workers_.empty() || tasks.size() == 1 || currentThreadPool == this)
+    {
+        CurrentThreadPoolScope scope(this);
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            tasks[i]();
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> batchLock(batchMutex_);
+    CurrentThreadPoolScope scope(this);
+    unsigned long generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_ = &tasks;
+        isPlacedOnThreads_ = isPlacedOnThreads;
+        nextTask_ = 0;
+        tasksFinished_ = 0;
+        firstException_ = nullptr;
+        generation = ++generation_;
+    }
+    workAvailable_.notify_all();
+
+    if (isPlacedOnThreads)
+    {
+        runPlacedTask(0, generation);
+    }
+    else
+    {
+        runAvailableTasks(generation);
+    }
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        workFinished_.wait(lock, [this, &tasks] { return tasksFinished_ == tasks.size(); });
+        tasks_ = nullptr;
+        exception = firstException_;
+        firstException_ = nullptr;
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void ThreadPool::workerLoop(int threadIndex)
+{
+    if (isPinningThreads_)
+    {
+        pinCurrentThread(threadIndex);
+    }
+    currentThreadPool = this;
+
+    unsigned long seenGeneration = 0;
+    for (;;)
+    {
+        bool isPlacedOnThreads = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [this, seenGeneration] { return isShuttingDown_ || generation_ != seenGeneration; });
+            if (isShuttingDown_)
+            {
+                return;
+            }
+            seenGeneration = generation_;
+            isPlacedOnThreads = isPlacedOnThreads_;
+        }
+        if (isPlacedOnThreads)
+        {
+            runPlacedTask(threadIndex, seenGeneration);
+        }
+        else
+        {
+            runAvailableTasks(seenGeneration);
+        }
+    }
+}
+
+// A worker may only get to a batch after it has finished and the next one
+// has started, so tasks are only claimed from the batch of the generation
+// the worker woke up for
+void ThreadPool::runAvailableTasks(unsigned long generation)
+{
+    for (;;)
+    {
+        const std::function<void()>* task = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation_ != generation || tasks_ == nullptr || isPlacedOnThreads_ || nextTask_ >= tasks_->size())
+            {
+                return;
+            }
+            task = &(*tasks_)[nextTask_++];
+        }
+
+        std::exception_ptr exception;
+        try
+        {
+            (*task)();
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+        finishTask(exception);
+    }
+}
+
+void ThreadPool::runPlacedTask(size_t threadIndex, unsigned long generation)
+{
+    const std::function<void()>* task = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation_ != generation || tasks_ == nullptr || !isPlacedOnThreads_ || threadIndex >= tasks_->size())
+        {
+            return;
+        }
+        task = &(*tasks_)[threadIndex];
+    }
+
+    std::exception_ptr exception;
+    try
+    {
+        (*task)();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    finishTask(exception);
+}
+
+void ThreadPool::finishTask(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (exception && !firstException_)
+    {
+        firstException_ = exception;
+    }
+    tasksFinished_++;
+    if (tasksFinished_ == tasks_->size())
+    {
+        workFinished_.notify_all();
+    }
+}
+
+void ThreadPool::runChunks(long count, long chunkSize, const std::function<void(int slot, long begin, long end)>& body,
+    int maximumNumberOfSlots)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    if (chunkSize < 1)
+    {
+        chunkSize = 1;
+    }
+
+    long numberOfChunks = (count + chunkSize - 1) / chunkSize;
+    int numberOfSlots = getNumberOfSlots(maximumNumberOfSlots);
+    if (numberOfSlots > numberOfChunks)
+    {
+        numberOfSlots = static_cast<int>(numberOfChunks);
+    }
+
+    // Hand out contiguous runs of chunks so each slot starts on its own part of the range
+    std::unique_ptr<ChunkRange[]> ranges(new ChunkRange[numberOfSlots]);
+    long chunksPerSlot = numberOfChunks / numberOfSlots;
+    long remainder = numberOfChunks % numberOfSlots;
+    long firstChunk = 0;
+    for (int slot = 0; slot < numberOfSlots; slot++)
+    {
+        ranges[slot].front = firstChunk;
+        firstChunk += chunksPerSlot + ((slot < remainder) ? 1 : 0);
+        ranges[slot].back = firstChunk;
+    }
+
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(numberOfSlots);
+    ChunkRange* rangesPtr = ranges.get();
+    for (int slot = 0; slot < numberOfSlots; slot++)
+    {
+        tasks.push_back([this, slot, rangesPtr, numberOfSlots, count, chunkSize, &body]()
+        {
+            runChunksForSlot(slot, rangesPtr, numberOfSlots, count, chunkSize, body);
+        });
+    }
+    runBatch(tasks, true);
+}
+
+void ThreadPool::runOnEachSlot(const std::function<void(int slot)>& body, int maximumNumberOfSlots)
+{
+    int numberOfSlots = getNumberOfSlots(maximumNumberOfSlots);
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(numberOfSlots);
+    for (int slot = 0; slot < numberOfSlots; slot++)
+    {
+        tasks.push_back([slot, &body]() { body(slot); });
+    }
+    runBatch(tasks, true);
+}
+
+void ThreadPool::runChunksForSlot(int slot, ChunkRange* ranges, int numberOfSlots, long count, long chunkSize,
+    const std::function<void(int slot, long begin, long end)>& body)
+{
+    long chunk = 0;
+    for (;;)
+    {
+        bool haveChunk = popFrontChunk(ranges[slot], chunk);
+        for (int i = 1; !haveChunk && i < numberOfSlots; i++)
+        {
+            haveChunk = popBackChunk(ranges[(slot + i) % numberOfSlots], chunk);
+        }
+        if (!haveChunk)
+        {
+            // Chunks are never added back, so an empty sweep means we are done
+            return;
+        }
+
+        long begin = chunk * chunkSize;
+        long end = begin + chunkSize;
+        if (end > count)
+        {
+            end = count;
+        }
+        body(slot, begin, end);
+    }
+}
+
+bool ThreadPool::popFrontChunk(ChunkRange& range, long& chunk)
+{
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.front >= range.back)
+    {
+        return false;
+    }
+    chunk = range.front++;
+    return true;
+}
+
+bool ThreadPool::popBackChunk(ChunkRange& range, long& chunk)
+{
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.front >= range.back)
+    {
+        return false;
+    }
+    chunk = --range.back;
+    return true;
+}
+
+void ThreadPool::pinCurrentThread(int threadIndex)
+{
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    {
+        return;
+    }
+    int numberOfAllowed = CPU_COUNT(&allowed);
+    if (numberOfAllowed <= 0)
+    {
+        return;
+    }
+    int wanted = threadIndex % numberOfAllowed;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &allowed) && wanted-- == 0)
+        {
+            cpu_set_t pinned;
+            CPU_ZERO(&pinned);
+            CPU_SET(cpu, &pinned);
+            pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+            return;
+        }
+    }
+#else
+    (void)threadIndex;
+#endif
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Fixed-size pool of worker threads used to run independent pieces
+*           of a calculation concurrently
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A pool of numberOfThreads - 1 worker threads plus the calling thread.
+// runTasks() hands a batch of tasks to the pool and does not return until
+// every task in the batch has finished, so it doubles as a join barrier.
+// A pool of one thread runs everything on the caller and never spawns.
+// Batches from different calling threads take turns, and a batch started
+// from inside a task of the same pool runs on the calling thread alone, so
+// engines may share one pool and call each other without oversubscribing
+// the machine or deadlocking.
+class ThreadPool
+{
+public:
+    // Pinned workers are each bound to one of the process's allowed CPUs, in
+    // order, so with the memory a worker touches first being placed on its
+    // own NUMA node, per-slot scratch stays local. Pinning is a no-op off Linux.
+    explicit ThreadPool(int numberOfThreads, bool isPinningThreads = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool& rhs) = delete;
+    ThreadPool& operator=(const ThreadPool& rhs) = delete;
+
+    // The library-wide pool the parallel engines share, created on first use.
+    // Holders keep the pool they got alive across a reconfiguration.
+    static std::shared_ptr<ThreadPool> getShared();
+    // Sizes the shared pool, zero or less for one thread per hardware thread,
+    // and pins its workers or not. Runs already holding the old pool finish on it.
+    static void configureShared(int numberOfThreads, bool isPinningThreads);
+
+    int getNumberOfThreads() const;
+    bool getIsPinningThreads() const;
+    // Slots a run limited to maximumNumberOfSlots gets, zero or less for no limit
+    int getNumberOfSlots(int maximumNumberOfSlots) const;
+    void runTasks(const std::vector<std::function<void()>>& tasks);
+
+    // Splits [0, count) into chunks of at most chunkSize items and calls
+    // body(slot, begin, end) once per chunk. Each of the getNumberOfSlots()
+    // slots starts with an even share of the chunks and, when its share runs
+    // out, steals chunks from the back of the other slots' shares. Slot s is
+    // always run by thread s of the pool, slot 0 by the caller, so callers may
+    // use it to index per-thread scratch data that stays on that thread's node.
+    void runChunks(long count, long chunkSize, const std::function<void(int slot, long begin, long end)>& body,
+        int maximumNumberOfSlots = 0);
+    // Calls body(slot) once on the thread of every slot, e.g. to construct the
+    // per-slot scratch of a run where it is going to be used
+    void runOnEachSlot(const std::function<void(int slot)>& body, int maximumNumberOfSlots = 0);
+
+protected:
+    struct ChunkRange
+    {
+        std::mutex mutex;
+        long front;     // next chunk the owning slot takes
+        long back;      // one past the last chunk, thieves take from here
+    };
+
+    void workerLoop(int threadIndex);
+    void runBatch(const std::vector<std::function<void()>>& tasks, bool isPlacedOnThreads);
+    void runAvailableTasks(unsigned long generation);
+    void runPlacedTask(size_t threadIndex, unsigned long generation);
+    void finishTask(std::exception_ptr exception);
+    void runChunksForSlot(int slot, ChunkRange* ranges, int numberOfSlots, long count, long chunkSize,
+        const std::function<void(int slot, long begin, long end)>& body);
+    static bool popFrontChunk(ChunkRange& range, long& chunk);
+    static bool popBackChunk(ChunkRange& range, long& chunk);
+    static void pinCurrentThread(int threadIndex);
+
+    std::vector<std::thread> workers_;
+    bool isPinningThreads_;
+    std::mutex batchMutex_;                           // held by the caller of the batch being run
+    std::mutex mutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable workFinished_;
+
+    const std::vector<std::function<void()>>* tasks_; // batch currently being run, null when idle
+    bool isPlacedOnThreads_;                          // task i of the batch runs on thread i
+    size_t nextTask_;                                 // index of the next unclaimed task
+    size_t tasksFinished_;                            // tasks of the current batch that have returned
+    unsigned long generation_;                        // incremented for every batch
+    bool isShuttingDown_;
+    std::exception_ptr firstException_;               // rethrown on the caller once the batch is done
+};
+
+#endif // THREADPOOL_H
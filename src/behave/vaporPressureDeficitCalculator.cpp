@@ -66,6 +66,38 @@ void VaporPressureDeficitCalculator::runCalculation() {
   vaporPressureDeficit_ = PressureUnits::toBaseUnits(vaporPressureDeficit_, PressureUnits::HectoPascal);
 }
 
+void VaporPressureDeficitCalculator::runCalculations(const double* temperature, const double* relativeHumidity, int count,
+    double* saturatedVaporPressure, double* actualVaporPressure, double* vaporPressureDeficit,
+    VectorMathMode::VectorMathModeEnum mode) {
+  // Exponent of ten of the saturated vapor pressure, kept in the saturated vapor pressure array
+  for (int i = 0; i < count; i++) {
+    double temperatureCelsius = TemperatureUnits::fromBaseUnits(temperature[i], TemperatureUnits::Celsius);
+    double temperatureKelvin = temperatureCelsius + 237.3;
+    saturatedVaporPressure[i] = (7.5 * temperatureCelsius) / temperatureKelvin;
+  }
+
+  if (mode == VectorMathMode::Fast) {
+    const double logTen = std::log(10.0);
+    for (int i = 0; i < count; i++) {
+      saturatedVaporPressure[i] *= logTen;
+    }
+    VectorMath::exp(saturatedVaporPressure, saturatedVaporPressure, count, VectorMathMode::Fast);
+  } else {
+    for (int i = 0; i < count; i++) {
+      saturatedVaporPressure[i] = std::pow(10, saturatedVaporPressure[i]);
+    }
+  }
+
+  // Pressures in hPa, then stored in base units
+  for (int i = 0; i < count; i++) {
+    double saturated = 6.11 * saturatedVaporPressure[i];
+    double actual = relativeHumidity[i] * saturated;
+    saturatedVaporPressure[i] = PressureUnits::toBaseUnits(saturated, PressureUnits::HectoPascal);
+    actualVaporPressure[i] = PressureUnits::toBaseUnits(actual, PressureUnits::HectoPascal);
+    vaporPressureDeficit[i] = PressureUnits::toBaseUnits(saturated - actual, PressureUnits::HectoPascal);
+  }
+}
+
 // Getters
 
 double VaporPressureDeficitCalculator::getVaporPressureDeficit(PressureUnits::PressureUnitsEnum units) {
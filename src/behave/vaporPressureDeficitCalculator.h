@@ -24,7 +24,11 @@
  *
  *****************************************************************************/
 
+#ifndef VAPOR_PRESSURE_DEFICIT_CALCULATOR_H
+#define VAPOR_PRESSURE_DEFICIT_CALCULATOR_H
+
 #include "behaveUnits.h"
+#include "vectorMath.h"
 #include <cmath>
 
 /** Calculator for Vapor Pressure Deficit */
@@ -38,6 +42,13 @@ public:
   double getActualVaporPressure(PressureUnits::PressureUnitsEnum units);
   double getSaturatedVaporPressure(PressureUnits::PressureUnitsEnum units);
 
+  // runCalculation() over count temperatures (Fahrenheit) and relative humidities (fractions), writing the
+  // three pressures in base units (Pa). Exact mode gives the single value results, Fast mode takes the
+  // power of ten through VectorMath::exp().
+  static void runCalculations(const double* temperature, const double* relativeHumidity, int count,
+      double* saturatedVaporPressure, double* actualVaporPressure, double* vaporPressureDeficit,
+      VectorMathMode::VectorMathModeEnum mode);
+
 private:
   double temperature_;		  //<! Temparature is expected to be degrees Celsius
   double relativeHumidity_;	  //<! Relative Humidity is expected to be a fraction
@@ -45,3 +56,5 @@ private:
   double saturatedVaporPressure_; //<! Saturated Vapor Pressure in hectoPascals (hPa)
   double vaporPressureDeficit_;	  //<! Vapor Pressure Deficit is in kPa
 };
+
+#endif // VAPOR_PRESSURE_DEFICIT_CALCULATOR_H
@@ -0,0 +1,417 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Array versions of the transcendental functions used by the surface
+*           fire calculations, written so compilers can vectorize them
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#define _USE_MATH_DEFINES
+#include "vectorMath.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define VECTOR_MATH_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define VECTOR_MATH_TARGET_CLONES
+#endif
+
+namespace
+{
+    // Adding then subtracting 1.5 * 2^52 rounds a double of magnitude below 2^51 to the nearest integer,
+    // and leaves that integer in the low bits of the sum
+    const double RoundingShift = 6755399441055744.0;
+
+    // ln(2) and pi / 2 split so that multiples of the leading parts by small integers are exact (fdlibm)
+    const double Ln2High = 6.93147180369123816490e-01;
+    const double Ln2Low = 1.90821492927058770002e-10;
+    const double HalfPi1 = 1.57079632673412561417e+00;
+    const double HalfPi2 = 6.07710050630396597660e-11;
+    const double HalfPi3 = 2.02226624871116645580e-21;
+
+    const double Log2e = 1.44269504088896338700e+00;
+    const double TwoOverPi = 6.36619772367581382433e-01;
+    const double TanEighthPi = 4.14213562373095034e-01;
+
+    inline std::uint64_t toBits(double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline double fromBits(std::uint64_t bits)
+    {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    inline double fastExp(double x)
+    {
+        // x = n * ln(2) + r with |r| <= ln(2) / 2, so exp(x) = 2^n * exp(r)
+        double clamped = (x < -708.0) ? -708.0 : x;
+        clamped = (clamped > 709.0) ? 709.0 : clamped;
+        double shifted = clamped * Log2e + RoundingShift;
+        double n = shifted - RoundingShift;
+        double r = (clamped - n * Ln2High) - n * Ln2Low;
+
+        // Taylor series through r^13, the next term is below 1.0e-17
+        double p = 1.0 / 6227020800.0;
+        p = p * r + 1.0 / 479001600.0;
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+        p = p * r + 1.0;
+        p = p * r + 1.0;
+
+        // n + 1023 is in [2, 2046], its low 12 bits shifted into place make the exponent of 2^n
+        double twoToN = fromBits((toBits(shifted) + 1023) << 52);
+        double result = p * twoToN;
+        result = (x < -708.0) ? 0.0 : result;
+        result = (x > 709.0) ? HUGE_VAL : result;
+        return result;
+    }
+
+    inline double fastLog(double x)
+    {
+        // x = 2^e * m with sqrt(2) / 2 <= m < sqrt(2), so log(x) = e * ln(2) + log(m)
+        std::uint64_t bits = toBits(x);
+        // 2^52 plus the biased exponent, as a double, is an exact way to get the exponent without integer conversion
+        double e = fromBits(0x4330000000000000ULL | (bits >> 52)) - 4503599627370496.0 - 1023.0;
+        double m = fromBits((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+        bool isAboveSqrtTwo = m > M_SQRT2;
+        m = isAboveSqrtTwo ? 0.5 * m : m;
+        e = isAboveSqrtTwo ? e + 1.0 : e;
+
+        // log(m) = 2 * atanh(s) with s = (m - 1) / (m + 1) and |s| <= 0.1716, series through s^23
+        double s = (m - 1.0) / (m + 1.0);
+        double s2 = s * s;
+        double p = 1.0 / 23.0;
+        p = p * s2 + 1.0 / 21.0;
+        p = p * s2 + 1.0 / 19.0;
+        p = p * s2 + 1.0 / 17.0;
+        p = p * s2 + 1.0 / 15.0;
+        p = p * s2 + 1.0 / 13.0;
+        p = p * s2 + 1.0 / 11.0;
+        p = p * s2 + 1.0 / 9.0;
+        p = p * s2 + 1.0 / 7.0;
+        p = p * s2 + 1.0 / 5.0;
+        p = p * s2 + 1.0 / 3.0;
+        double logM = 2.0 * s + 2.0 * s * s2 * p;
+        return e * Ln2High + (logM + e * Ln2Low);
+    }
+
+    inline double fastPow(double x, double y)
+    {
+        double result = fastExp(y * fastLog(x));
+        return (x == 0.0) ? 0.0 : result;
+    }
+
+    // Taylor series of sin(r) through r^17 and cos(r) through r^16 for |r| <= pi / 4
+    inline double sinPolynomial(double r)
+    {
+        double r2 = r * r;
+        double p = 1.0 / 355687428096000.0;
+        p = p * r2 - 1.0 / 1307674368000.0;
+        p = p * r2 + 1.0 / 6227020800.0;
+        p = p * r2 - 1.0 / 39916800.0;
+        p = p * r2 + 1.0 / 362880.0;
+        p = p * r2 - 1.0 / 5040.0;
+        p = p * r2 + 1.0 / 120.0;
+        p = p * r2 - 1.0 / 6.0;
+        return r + r * r2 * p;
+    }
+
+    inline double cosPolynomial(double r)
+    {
+        double r2 = r * r;
+        double p = 1.0 / 20922789888000.0;
+        p = p * r2 - 1.0 / 87178291200.0;
+        p = p * r2 + 1.0 / 479001600.0;
+        p = p * r2 - 1.0 / 3628800.0;
+        p = p * r2 + 1.0 / 40320.0;
+        p = p * r2 - 1.0 / 720.0;
+        p = p * r2 + 1.0 / 24.0;
+        return (1.0 - 0.5 * r2) + r2 * r2 * p;
+    }
+
+    // Reduces x to r = x - q * pi / 2 with |r| <= pi / 4 and returns the quadrant, q modulo 4
+    inline std::uint64_t reduceHalfPi(double x, double& r)
+    {
+        double shifted = x * TwoOverPi + RoundingShift;
+        double q = shifted - RoundingShift;
+        r = ((x - q * HalfPi1) - q * HalfPi2) - q * HalfPi3;
+        return toBits(shifted) & 3;
+    }
+
+    inline double fastSin(double x)
+    {
+        double r;
+        std::uint64_t quadrant = reduceHalfPi(x, r);
+        double sinR = sinPolynomial(r);
+        double cosR = cosPolynomial(r);
+        double result = (quadrant & 1) ? cosR : sinR;
+        return (quadrant & 2) ? -result : result;
+    }
+
+    inline double fastCos(double x)
+    {
+        double r;
+        std::uint64_t quadrant = reduceHalfPi(x, r);
+        double sinR = sinPolynomial(r);
+        double cosR = cosPolynomial(r);
+        double result = (quadrant & 1) ? sinR : cosR;
+        return (((quadrant + 1) & 2) != 0) ? -result : result;
+    }
+
+    inline double fastAtan2(double y, double x)
+    {
+        // atan of t = min / max in [0, 1], reduced to |u| <= tan(pi / 8) with atan(t) = pi / 4 + atan((t - 1) / (t + 1))
+        double absX = fabs(x);
+        double absY = fabs(y);
+        double largest = (absX > absY) ? absX : absY;
+        double smallest = (absX > absY) ? absY : absX;
+        double t = (largest > 0.0) ? smallest / largest : 0.0;
+        bool isReduced = t > TanEighthPi;
+        double u = isReduced ? (t - 1.0) / (t + 1.0) : t;
+
+        // Taylor series of atan(u) through u^45, |u|^2 <= 0.1716
+        double u2 = u * u;
+        double p = 1.0 / 45.0;
+        p = p * u2 - 1.0 / 43.0;
+        p = p * u2 + 1.0 / 41.0;
+        p = p * u2 - 1.0 / 39.0;
+        p = p * u2 + 1.0 / 37.0;
+        p = p * u2 - 1.0 / 35.0;
+        p = p * u2 + 1.0 / 33.0;
+        p = p * u2 - 1.0 / 31.0;
+        p = p * u2 + 1.0 / 29.0;
+        p = p * u2 - 1.0 / 27.0;
+        p = p * u2 + 1.0 / 25.0;
+        p = p * u2 - 1.0 / 23.0;
+        p = p * u2 + 1.0 / 21.0;
+        p = p * u2 - 1.0 / 19.0;
+        p = p * u2 + 1.0 / 17.0;
+        p = p * u2 - 1.0 / 15.0;
+        p = p * u2 + 1.0 / 13.0;
+        p = p * u2 - 1.0 / 11.0;
+        p = p * u2 + 1.0 / 9.0;
+        p = p * u2 - 1.0 / 7.0;
+        p = p * u2 + 1.0 / 5.0;
+        p = p * u2 - 1.0 / 3.0;
+        p = p * u2 + 1.0 / 1.0;
+        double angle = u * p;
+        angle = isReduced ? M_PI_4 + angle : angle;
+        angle = (absY > absX) ? M_PI_2 - angle : angle;
+        angle = ((toBits(x) >> 63) != 0) ? M_PI - angle : angle; // x is negative, including -0
+
+        return copysign(angle, y);
+    }
+}
+
+VECTOR_MATH_TARGET_CLONES
+static void fastExpArray(const double* x, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = fastExp(x[i]);
+    }
+}
+
+VECTOR_MATH_TARGET_CLONES
+static void fastLogArray(const double* x, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = fastLog(x[i]);
+    }
+}
+
+VECTOR_MATH_TARGET_CLONES
+static void fastPowArray(const double* x, double y, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = fastPow(x[i], y);
+    }
+}
+
+VECTOR_MATH_TARGET_CLONES
+static void fastPowArray(const double* x, const double* y, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = fastPow(x[i], y[i]);
+    }
+}
+
+VECTOR_MATH_TARGET_CLONES
+static void fastSinArray(const double* x, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = fastSin(x[i]);
+    }
+}
+
+VECTOR_MATH_TARGET_CLONES
+static void fastCosArray(const double* x, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = fastCos(x[i]);
+    }
+}
+
+VECTOR_MATH_TARGET_CLONES
+static void fastAtan2Array(const double* y, const double* x, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = fastAtan2(y[i], x[i]);
+    }
+}
+
+void VectorMath::exp(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        fastExpArray(x, result, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            result[i] = std::exp(x[i]);
+        }
+    }
+}
+
+void VectorMath::log(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        fastLogArray(x, result, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            result[i] = std::log(x[i]);
+        }
+    }
+}
+
+void VectorMath::pow(const double* x, double y, double* result, int count, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        fastPowArray(x, y, result, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            result[i] = std::pow(x[i], y);
+        }
+    }
+}
+
+void VectorMath::pow(const double* x, const double* y, double* result, int count, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        fastPowArray(x, y, result, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            result[i] = std::pow(x[i], y[i]);
+        }
+    }
+}
+
+void VectorMath::sin(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        fastSinArray(x, result, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            result[i] = std::sin(x[i]);
+        }
+    }
+}
+
+void VectorMath::cos(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        fastCosArray(x, result, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            result[i] = std::cos(x[i]);
+        }
+    }
+}
+
+void VectorMath::atan2(const double* y, const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode)
+{
+    if (mode == VectorMathMode::Fast)
+    {
+        fastAtan2Array(y, x, result, count);
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            result[i] = std::atan2(y[i], x[i]);
+        }
+    }
+}
+
+void VectorMath::sqrt(const double* x, double* result, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        result[i] = std::sqrt(x[i]);
+    }
+}
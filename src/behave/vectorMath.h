@@ -0,0 +1,68 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Array versions of the transcendental functions used by the surface
+*           fire calculations, written so compilers can vectorize them
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+
+#ifndef VECTORMATH_H
+#define VECTORMATH_H
+
+struct VectorMathMode
+{
+    enum VectorMathModeEnum
+    {
+        Exact, // loops over the standard library functions, bit-identical to the scalar calculations
+        Fast // branch-free polynomial approximations that vectorize, within the ULP budgets below
+    };
+};
+
+// Array kernels for the transcendental functions of the surface fire calculations. Every kernel takes
+// count values and writes count results, results may alias the inputs. In Exact mode the kernels just
+// call the standard library. In Fast mode they use range reduction and polynomials with no branches or
+// library calls, so the loops vectorize for whatever instruction set the compiler targets. On x86-64
+// Linux builds with GCC the Fast kernels are also compiled for AVX2 and picked at load time on machines
+// that have it. Every clone gives the same results, none of them contract into fused multiply-adds.
+//
+// Fast mode error budgets against the correctly rounded result, for normal finite inputs:
+//   exp:   2 ULP, results below the smallest normal double flush to zero
+//   log:   2 ULP, x > 0
+//   pow:   4 + 2 * |y * ln(x)| ULP, x >= 0 (pow of zero is zero, y must be positive there)
+//   sin, cos: 2 ULP for |x| <= pi / 4, otherwise within 4.5e-16 of the correct result for |x| <= 1.0e5
+//   atan2: 3 ULP
+//   sqrt:  correctly rounded in both modes
+class VectorMath
+{
+public:
+    static void exp(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode);
+    static void log(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode);
+    static void pow(const double* x, double y, double* result, int count, VectorMathMode::VectorMathModeEnum mode);
+    static void pow(const double* x, const double* y, double* result, int count, VectorMathMode::VectorMathModeEnum mode);
+    static void sin(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode);
+    static void cos(const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode);
+    static void atan2(const double* y, const double* x, double* result, int count, VectorMathMode::VectorMathModeEnum mode);
+    static void sqrt(const double* x, double* result, int count);
+};
+
+#endif // VECTORMATH_H
@@ -31,10 +31,12 @@
 #include "westernAspen.h"
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 WesternAspen::WesternAspen()
 {
-
+    clearFuelbedMemo();
 }
 
 WesternAspen::~WesternAspen()
@@ -47,6 +49,72 @@ void WesternAspen::initializeMembers()
     mortality_ = 0.0;
 }
 
+void WesternAspen::clearFuelbedMemo()
+{
+    for (int i = 0; i < NumberOfFuelbedMemoEntries; i++)
+    {
+        fuelbedMemo_[i].isUsed = false;
+    }
+    fuelbedMemoNumberOfHits_ = 0;
+    fuelbedMemoNumberOfMisses_ = 0;
+}
+
+int WesternAspen::getFuelbedMemoSlot(int aspenFuelModelNumber, double aspenCuringLevel)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &aspenCuringLevel, sizeof(bits));
+    std::uint64_t hash = (static_cast<std::uint64_t>(aspenFuelModelNumber) ^ bits) * 0x9e3779b97f4a7c15ULL;
+    return static_cast<int>(hash >> 61) & (NumberOfFuelbedMemoEntries - 1);
+}
+
+const WesternAspenFuelbed& WesternAspen::calculateAspenFuelbed(int aspenFuelModelNumber, double aspenCuringLevel)
+{
+    FuelbedMemoEntry& entry = fuelbedMemo_[getFuelbedMemoSlot(aspenFuelModelNumber, aspenCuringLevel)];
+    if (entry.isUsed && entry.aspenFuelModelNumber == aspenFuelModelNumber && entry.aspenCuringLevel == aspenCuringLevel)
+    {
+        fuelbedMemoNumberOfHits_++;
+        setMembersFromFuelbed(entry.fuelbed);
+        return entry.fuelbed;
+    }
+    fuelbedMemoNumberOfMisses_++;
+
+    WesternAspenFuelbed& fuelbed = entry.fuelbed;
+    fuelbed.loadDeadOneHour = calculateAspenLoadDeadOneHour(aspenFuelModelNumber, aspenCuringLevel);
+    fuelbed.loadDeadTenHour = calculateAspenLoadDeadTenHour(aspenFuelModelNumber);
+    fuelbed.loadLiveHerbaceous = calculateAspenLoadLiveHerbaceous(aspenFuelModelNumber, aspenCuringLevel);
+    fuelbed.loadLiveWoody = calculateAspenLoadLiveWoody(aspenFuelModelNumber, aspenCuringLevel);
+    fuelbed.savrDeadOneHour = calculateAspenSavrDeadOneHour(aspenFuelModelNumber, aspenCuringLevel);
+    fuelbed.savrDeadTenHour = calculateAspenSavrDeadTenHour();
+    fuelbed.savrLiveHerbaceous = calculateAspenSavrLiveHerbaceous();
+    fuelbed.savrLiveWoody = calculateAspenSavrLiveWoody(aspenFuelModelNumber, aspenCuringLevel);
+    entry.isUsed = true;
+    entry.aspenFuelModelNumber = aspenFuelModelNumber;
+    entry.aspenCuringLevel = aspenCuringLevel;
+    return fuelbed;
+}
+
+void WesternAspen::setMembersFromFuelbed(const WesternAspenFuelbed& fuelbed)
+{
+    aspenDeadOneHour_ = fuelbed.loadDeadOneHour;
+    aspenDeadTenHour_ = fuelbed.loadDeadTenHour;
+    aspenLiveHerbaceous_ = fuelbed.loadLiveHerbaceous;
+    aspenLiveWoody_ = fuelbed.loadLiveWoody;
+    aspenSavrDeadOneHour_ = fuelbed.savrDeadOneHour;
+    aspenSavrDeadTenHour_ = fuelbed.savrDeadTenHour;
+    aspenSavrLiveHerbaceous_ = fuelbed.savrLiveHerbaceous;
+    aspenSavrLiveWoody_ = fuelbed.savrLiveWoody;
+}
+
+long WesternAspen::getFuelbedMemoNumberOfHits() const
+{
+    return fuelbedMemoNumberOfHits_;
+}
+
+long WesternAspen::getFuelbedMemoNumberOfMisses() const
+{
+    return fuelbedMemoNumberOfMisses_;
+}
+
 double WesternAspen::getAspenMortality () const
 {
     return mortality_;
@@ -31,13 +31,35 @@
 #ifndef WESTERNASPEN_H
 #define WESTERNASPEN_H
 
+// Loads in lb/ft2 and SAVRs in ft2/ft3 of one western aspen stand
+struct WesternAspenFuelbed
+{
+    double loadDeadOneHour;
+    double loadDeadTenHour;
+    double loadLiveHerbaceous;
+    double loadLiveWoody;
+    double savrDeadOneHour;
+    double savrDeadTenHour;
+    double savrLiveHerbaceous;
+    double savrLiveWoody;
+};
+
 class WesternAspen
 {
 public:
+    static const int NumberOfFuelbedMemoEntries = 8;
+
     WesternAspen();
     ~WesternAspen();
 
-    void initializeMembers();
+    void initializeMembers(); // keeps the fuelbed memo
+
+    // Runs all of the load and SAVR interpolations of a stand, unless they are in the small direct-mapped
+    // memo of recent stands keyed on the exact inputs. Either way the getters report the stand afterwards.
+    const WesternAspenFuelbed& calculateAspenFuelbed(int aspenFuelModelNumber, double aspenCuringLevel);
+    void clearFuelbedMemo();
+    long getFuelbedMemoNumberOfHits() const;
+    long getFuelbedMemoNumberOfMisses() const;
     double getAspenMortality() const;
 
     // The following getter methods are used to populate FuelModel data fields 
@@ -69,7 +91,21 @@ public:
     double calculateAspenMortality(int severity, double flameLength, double DBH);
 
 protected:
+    struct FuelbedMemoEntry
+    {
+        bool isUsed;
+        int aspenFuelModelNumber;
+        double aspenCuringLevel;
+        WesternAspenFuelbed fuelbed;
+    };
+
     double aspenInterpolate(double curing, double* valueArray);
+    static int getFuelbedMemoSlot(int aspenFuelModelNumber, double aspenCuringLevel);
+    void setMembersFromFuelbed(const WesternAspenFuelbed& fuelbed);
+
+    FuelbedMemoEntry fuelbedMemo_[NumberOfFuelbedMemoEntries];
+    long fuelbedMemoNumberOfHits_;
+    long fuelbedMemoNumberOfMisses_;
    
     // Member variables
     double mortality_;
@@ -30,6 +30,8 @@
 
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include "windAdjustmentFactor.h"
 
 WindAjustmentFactor::WindAjustmentFactor()
@@ -77,7 +79,7 @@ WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum WindAju
     return windAdjustmentFactorShelterMethod_;
 }
 
-void WindAjustmentFactor::calculateWindAdjustmentFactorShelterMethod(const double canopyCover, const double canopyHeight, const double fuelbedDepth)
+void WindAjustmentFactor::calculateWindAdjustmentFactorShelterMethod(const double canopyCover, const double canopyHeight, const double)
 {
     // Unsheltered
     if (canopyCover < 1.0e-07 || canopyCrownFraction_ < 0.05 || canopyHeight < 6.0)
@@ -91,7 +93,7 @@ void WindAjustmentFactor::calculateWindAdjustmentFactorShelterMethod(const doubl
     }
 }
 
-void WindAjustmentFactor::applyLogProfile(const double canopyCover, const double canopyHeight, const double fuelbedDepth)
+void WindAjustmentFactor::applyLogProfile(const double, const double canopyHeight, const double fuelbedDepth)
 {
     if (windAdjustmentFactorShelterMethod_ == WindAdjustmentFactorShelterMethod::Unsheltered)
     {
@@ -105,3 +107,72 @@ void WindAjustmentFactor::applyLogProfile(const double canopyCover, const double
         windAdjustmentFactor_ = 0.555 / (sqrt(canopyCrownFraction_ * canopyHeight) * log((20.0 + 0.36 * canopyHeight) / (0.13 * canopyHeight)));
     }
 }
+
+WindAdjustmentFactorMemo::WindAdjustmentFactorMemo()
+{
+    clear();
+}
+
+void WindAdjustmentFactorMemo::clear()
+{
+    for (int i = 0; i < NumberOfEntries; i++)
+    {
+        entries_[i].isUsed = false;
+    }
+    numberOfHits_ = 0;
+    numberOfMisses_ = 0;
+}
+
+int WindAdjustmentFactorMemo::getSlot(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio,
+    double fuelbedDepth)
+{
+    const double keyValues[] = { canopyCover, canopyHeight, crownRatio, fuelbedDepth };
+    std::uint64_t hash = isUsingCrownRatio ? 1 : 0;
+    for (double keyValue : keyValues)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &keyValue, sizeof(bits));
+        hash = (hash ^ bits) * 0x9e3779b97f4a7c15ULL;
+    }
+    return static_cast<int>(hash >> 60) & (NumberOfEntries - 1);
+}
+
+bool WindAdjustmentFactorMemo::find(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio,
+    double fuelbedDepth, double& windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum& shelterMethod)
+{
+    const Entry& entry = entries_[getSlot(isUsingCrownRatio, canopyCover, canopyHeight, crownRatio, fuelbedDepth)];
+    if (entry.isUsed && entry.isUsingCrownRatio == isUsingCrownRatio && entry.canopyCover == canopyCover &&
+        entry.canopyHeight == canopyHeight && entry.crownRatio == crownRatio && entry.fuelbedDepth == fuelbedDepth)
+    {
+        windAdjustmentFactor = entry.windAdjustmentFactor;
+        shelterMethod = entry.shelterMethod;
+        numberOfHits_++;
+        return true;
+    }
+    numberOfMisses_++;
+    return false;
+}
+
+void WindAdjustmentFactorMemo::insert(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio,
+    double fuelbedDepth, double windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod)
+{
+    Entry& entry = entries_[getSlot(isUsingCrownRatio, canopyCover, canopyHeight, crownRatio, fuelbedDepth)];
+    entry.isUsed = true;
+    entry.isUsingCrownRatio = isUsingCrownRatio;
+    entry.canopyCover = canopyCover;
+    entry.canopyHeight = canopyHeight;
+    entry.crownRatio = crownRatio;
+    entry.fuelbedDepth = fuelbedDepth;
+    entry.windAdjustmentFactor = windAdjustmentFactor;
+    entry.shelterMethod = shelterMethod;
+}
+
+long WindAdjustmentFactorMemo::getNumberOfHits() const
+{
+    return numberOfHits_;
+}
+
+long WindAdjustmentFactorMemo::getNumberOfMisses() const
+{
+    return numberOfMisses_;
+}
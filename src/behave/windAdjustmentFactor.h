@@ -52,4 +52,44 @@ protected:
     WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum windAdjustmentFactorShelterMethod_;
 };
 
+// Small direct-mapped memo of wind adjustment factors keyed on the exact canopy cover, canopy height,
+// crown ratio and fuelbed depth. These are static per pixel over a forecast and come in few distinct
+// canopy classes, so repeated runs reuse the factor and shelter method instead of the log profile.
+// Entries are replaced when another key maps to the same slot, a memo copy keeps its entries.
+class WindAdjustmentFactorMemo
+{
+public:
+    static const int NumberOfEntries = 16;
+
+    WindAdjustmentFactorMemo();
+
+    void clear();
+    bool find(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio, double fuelbedDepth,
+        double& windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum& shelterMethod);
+    void insert(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio, double fuelbedDepth,
+        double windAdjustmentFactor, WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod);
+
+    long getNumberOfHits() const;
+    long getNumberOfMisses() const;
+
+protected:
+    struct Entry
+    {
+        bool isUsed;
+        bool isUsingCrownRatio;
+        double canopyCover;
+        double canopyHeight;
+        double crownRatio;
+        double fuelbedDepth;
+        double windAdjustmentFactor;
+        WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod;
+    };
+
+    static int getSlot(bool isUsingCrownRatio, double canopyCover, double canopyHeight, double crownRatio, double fuelbedDepth);
+
+    Entry entries_[NumberOfEntries];
+    long numberOfHits_;
+    long numberOfMisses_;
+};
+
 #endif // WINDADJUSTMENTFACTOR_H
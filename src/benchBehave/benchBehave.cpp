@@ -0,0 +1,584 @@
+/******************************************************************************
+*
+* Project:  CodeBlocks
+* Purpose:  Throughput benchmarks for the Behave modules, used to catch
+*           performance regressions between releases
+*
+*******************************************************************************
+*
+* THIS SOFTWARE WAS DEVELOPED AT THE ROCKY MOUNTAIN RESEARCH STATION (RMRS)
+* MISSOULA FIRE SCIENCES LABORATORY BY EMPLOYEES OF THE FEDERAL GOVERNMENT
+* IN THE COURSE OF THEIR OFFICIAL DUTIES. PURSUANT TO TITLE 17 SECTION 105
+* OF THE UNITED STATES CODE, THIS SOFTWARE IS NOT SUBJECT TO COPYRIGHT
+* PROTECTION AND IS IN THE PUBLIC DOMAIN. RMRS MISSOULA FIRE SCIENCES
+* LABORATORY ASSUMES NO RESPONSIBILITY WHATSOEVER FOR ITS USE BY OTHER
+* PARTIES,  AND MAKES NO GUARANTEES, EXPRESSED OR IMPLIED, ABOUT ITS QUALITY,
+* RELIABILITY, OR ANY OTHER CHARACTERISTIC.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+* OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+* FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+* DEALINGS IN THE SOFTWARE.
+*
+******************************************************************************/
+
+// Usage: benchBehave [--format=console|csv|json] [--min_time=seconds] [--filter=substring] [--mortality_input=file.tre]
+//
+// Every benchmark is run for at least min_time seconds, growing its iteration count until it does, and
+// reports the time per iteration and the number of items (surface runs, trees, ...) processed per second.
+// The csv and json formats are meant to be stored and compared between releases.
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "behaveRun.h"
+#include "fuelModels.h"
+#include "randfuel.h"
+#include "species_master_table.h"
+
+#ifndef BENCH_MORTALITY_INPUT
+#define BENCH_MORTALITY_INPUT "src/testMortality/FOFEM_input.tre"
+#endif
+
+using std::string;
+using std::vector;
+
+// Written by every benchmark so the compiler cannot drop the work being timed
+volatile double benchmarkSink = 0.0;
+
+struct BenchmarkResult
+{
+    string name;
+    long iterations;
+    double nanosecondsPerIteration;
+    double itemsPerSecond;
+};
+
+struct BenchmarkOptions
+{
+    string format = "console";
+    string filter = "";
+    string mortalityInput = BENCH_MORTALITY_INPUT;
+    double minTime = 0.5; // seconds
+};
+
+class BenchmarkRunner
+{
+public:
+    explicit BenchmarkRunner(const BenchmarkOptions& options)
+        : options_(options)
+    {
+
+    }
+
+    // body runs one iteration, which processes itemsPerIteration items
+    void run(const string& name, long itemsPerIteration, const std::function<void()>& body)
+    {
+        if (!options_.filter.empty() && name.find(options_.filter) == string::npos)
+        {
+            return;
+        }
+
+        body(); // warm up caches and lazily built tables
+
+        typedef std::chrono::steady_clock Clock;
+        long iterations = 1;
+        double elapsedSeconds = 0.0;
+        for (;;)
+        {
+            Clock::time_point start = Clock::now();
+            for (long i = 0; i < iterations; i++)
+            {
+                body();
+            }
+            elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (elapsedSeconds >= options_.minTime || iterations >= (1L << 40))
+            {
+                break;
+            }
+            // Aim a little past the minimum time so the last pass is usually the only long one
+            double scale = (elapsedSeconds > 0.0) ? (1.4 * options_.minTime / elapsedSeconds) : 10.0;
+            iterations = static_cast<long>(iterations * std::min(std::max(scale, 2.0), 10.0));
+        }
+
+        BenchmarkResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.nanosecondsPerIteration = elapsedSeconds * 1.0e9 / iterations;
+        result.itemsPerSecond = (itemsPerIteration * static_cast<double>(iterations)) / elapsedSeconds;
+        results_.push_back(result);
+
+        if (options_.format == "console")
+        {
+            std::cout << std::left << std::setw(48) << result.name << std::right
+                << std::setw(12) << result.iterations
+                << std::setw(16) << std::fixed << std::setprecision(1) << result.nanosecondsPerIteration << " ns"
+                << std::setw(16) << std::setprecision(0) << result.itemsPerSecond << " items/s\n";
+        }
+    }
+
+    void report() const
+    {
+        if (options_.format == "csv")
+        {
+            std::cout << "name,iterations,ns_per_iteration,items_per_second\n";
+            for (const BenchmarkResult& result : results_)
+            {
+                std::cout << result.name << "," << result.iterations << "," << std::setprecision(10)
+                    << result.nanosecondsPerIteration << "," << result.itemsPerSecond << "\n";
+            }
+        }
+        else if (options_.format == "json")
+        {
+            std::cout << "{\n  \"benchmarks\": [\n";
+            for (size_t i = 0; i < results_.size(); i++)
+            {
+                const BenchmarkResult& result = results_[i];
+                std::cout << "    { \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+                    << ", \"ns_per_iteration\": " << std::setprecision(10) << result.nanosecondsPerIteration
+                    << ", \"items_per_second\": " << result.itemsPerSecond << " }"
+                    << ((i + 1 < results_.size()) ? ",\n" : "\n");
+            }
+            std::cout << "  ]\n}\n";
+        }
+    }
+
+    const BenchmarkOptions& getOptions() const
+    {
+        return options_;
+    }
+
+private:
+    BenchmarkOptions options_;
+    vector<BenchmarkResult> results_;
+};
+
+void setSurfaceInputs(BehaveRun& behaveRun, int fuelModelNumber)
+{
+    behaveRun.surface.updateSurfaceInputs(fuelModelNumber, 6, 7, 8, 60, 90, FractionUnits::Percent, 5, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 45, WindAndSpreadOrientationMode::RelativeToNorth, 30, SlopeUnits::Percent, 95,
+        50, FractionUnits::Percent, 30, LengthUnits::Feet, 50, FractionUnits::Percent);
+}
+
+void benchmarkSurface(BenchmarkRunner& runner, BehaveRun& behaveRun, const FuelModels& fuelModels)
+{
+    vector<int> fuelModelNumbers;
+    for (int fuelModelNumber = 1; fuelModelNumber < FuelConstants::MaxFuelModels; fuelModelNumber++)
+    {
+        if (fuelModels.isFuelModelDefined(fuelModelNumber))
+        {
+            fuelModelNumbers.push_back(fuelModelNumber);
+        }
+    }
+
+    // Changes the fuel model on every run, so nothing computed for the previous run can be reused
+    runner.run("surface/all_fuel_models", static_cast<long>(fuelModelNumbers.size()), [&]()
+    {
+        for (int fuelModelNumber : fuelModelNumbers)
+        {
+            setSurfaceInputs(behaveRun, fuelModelNumber);
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            benchmarkSink = benchmarkSink + behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        }
+    });
+
+    // Only the wind speed changes between runs
+    setSurfaceInputs(behaveRun, 124);
+    runner.run("surface/wind_speed_sweep", 20, [&]()
+    {
+        for (int windSpeed = 0; windSpeed < 20; windSpeed++)
+        {
+            behaveRun.surface.setWindSpeed(windSpeed, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            benchmarkSink = benchmarkSink + behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        }
+    });
+}
+
+void benchmarkTwoFuelModels(BenchmarkRunner& runner, BehaveRun& behaveRun)
+{
+    const struct
+    {
+        const char* name;
+        TwoFuelModelsMethod::TwoFuelModelsMethodEnum method;
+    } methods[] =
+    {
+        { "surface/two_fuel_models/arithmetic", TwoFuelModelsMethod::Arithmetic },
+        { "surface/two_fuel_models/harmonic", TwoFuelModelsMethod::Harmonic },
+        { "surface/two_fuel_models/two_dimensional", TwoFuelModelsMethod::TwoDimensional }
+    };
+
+    for (const auto& method : methods)
+    {
+        behaveRun.surface.updateSurfaceInputsForTwoFuelModels(1, 124, 6, 7, 8, 60, 90, FractionUnits::Percent, 5,
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToUpslope,
+            50, FractionUnits::Percent, method.method, 30, SlopeUnits::Percent, 0, 50, FractionUnits::Percent, 30,
+            LengthUnits::Feet, 50, FractionUnits::Percent);
+        runner.run(method.name, 1, [&]()
+        {
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            benchmarkSink = benchmarkSink + behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        });
+    }
+}
+
+void benchmarkCrown(BenchmarkRunner& runner, BehaveRun& behaveRun)
+{
+    // Inputs of the Scott and Reinhardt test in testBehave
+    behaveRun.crown.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UserInput);
+    behaveRun.crown.setUserProvidedWindAdjustmentFactor(0.4);
+    behaveRun.crown.updateCrownInputs(10, 8, 9, 10, 0, 117, 100, FractionUnits::Percent, 2187.226624, SpeedUnits::FeetPerMinute,
+        WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToUpslope, 20, SlopeUnits::Percent, 0,
+        50, FractionUnits::Percent, 38.104626, 2.952756, LengthUnits::Feet, 0.50, FractionUnits::Fraction, 0.01311,
+        DensityUnits::PoundsPerCubicFoot);
+
+    runner.run("crown/scott_and_reinhardt", 1, [&]()
+    {
+        behaveRun.crown.doCrownRunScottAndReinhardt();
+        benchmarkSink = benchmarkSink + behaveRun.crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+    });
+
+    runner.run("crown/rothermel", 1, [&]()
+    {
+        behaveRun.crown.doCrownRunRothermel();
+        benchmarkSink = benchmarkSink + behaveRun.crown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute);
+    });
+}
+
+void benchmarkSpot(BenchmarkRunner& runner, BehaveRun& behaveRun)
+{
+    SpotFireLocation::SpotFireLocationEnum location = SpotFireLocation::RIDGE_TOP;
+    SpotDownWindCanopyMode::SpotDownWindCanopyModeEnum canopyMode = SpotDownWindCanopyMode::CLOSED;
+
+    behaveRun.spot.updateSpotInputsForBurningPile(location, 1.0, LengthUnits::Miles, 2000.0, LengthUnits::Feet, 30.0,
+        LengthUnits::Feet, canopyMode, 5.0, LengthUnits::Feet, 5.0, SpeedUnits::MilesPerHour);
+    runner.run("spot/burning_pile", 1, [&]()
+    {
+        behaveRun.spot.calculateSpottingDistanceFromBurningPile();
+        benchmarkSink = benchmarkSink + behaveRun.spot.getMaxMountainousTerrainSpottingDistanceFromBurningPile(LengthUnits::Feet);
+    });
+
+    behaveRun.spot.updateSpotInputsForSurfaceFire(location, 1.0, LengthUnits::Miles, 2000.0, LengthUnits::Feet, 30.0,
+        LengthUnits::Feet, canopyMode, 5.0, SpeedUnits::MilesPerHour, 10.0, LengthUnits::Feet);
+    runner.run("spot/surface_fire", 1, [&]()
+    {
+        behaveRun.spot.calculateSpottingDistanceFromSurfaceFire();
+        benchmarkSink = benchmarkSink + behaveRun.spot.getMaxMountainousTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+    });
+
+    behaveRun.spot.updateSpotInputsForTorchingTrees(location, 1.0, LengthUnits::Miles, 2000.0, LengthUnits::Feet, 30.0,
+        LengthUnits::Feet, canopyMode, 15, 20.0, LengthUnits::Inches, 30.0, LengthUnits::Feet, SpotTreeSpecies::ENGELMANN_SPRUCE,
+        5.0, SpeedUnits::MilesPerHour);
+    runner.run("spot/torching_trees", 1, [&]()
+    {
+        behaveRun.spot.calculateSpottingDistanceFromTorchingTrees();
+        benchmarkSink = benchmarkSink + behaveRun.spot.getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(LengthUnits::Feet);
+    });
+}
+
+void benchmarkContain(BenchmarkRunner& runner, BehaveRun& behaveRun)
+{
+    const int resourceCounts[] = { 1, 4, 16 };
+    for (int resourceCount : resourceCounts)
+    {
+        // Inputs of the Contain test in testBehave, with the fireline production split over resourceCount resources
+        behaveRun.contain.removeAllResources();
+        behaveRun.contain.setAttackDistance(0, LengthUnits::Chains);
+        behaveRun.contain.setLwRatio(3);
+        behaveRun.contain.setReportRate(5, SpeedUnits::ChainsPerHour);
+        behaveRun.contain.setReportSize(1, AreaUnits::Acres);
+        behaveRun.contain.setTactic(ContainTactic::HeadAttack);
+        for (int i = 0; i < resourceCount; i++)
+        {
+            behaveRun.contain.addResource(2 + 0.25 * i, 8, TimeUnits::Hours, 20.0 / resourceCount, SpeedUnits::ChainsPerHour,
+                "resource " + std::to_string(i));
+        }
+
+        runner.run("contain/resources_" + std::to_string(resourceCount), 1, [&]()
+        {
+            behaveRun.contain.doContainRun();
+            benchmarkSink = benchmarkSink + behaveRun.contain.getFinalFireLineLength(LengthUnits::Chains);
+        });
+    }
+    behaveRun.contain.removeAllResources();
+}
+
+// One tree of the FOFEM input file, with the columns the mortality client uses already parsed
+struct MortalityRecord
+{
+    string speciesCode;
+    EquationType equationType;
+    string flameLengthOrScorchHeightSwitch;
+    double flameLengthOrScorchHeight;
+    double treeExpansionFactor;
+    double diameter;
+    double treeHeight;
+    double crownRatio;
+    double crownScorch;
+    double cambiumKillRating;
+    string beetleDamage;
+    double boleCharHeight;
+};
+
+// Reads the .tre file the same way testMortality does, empty values are stored as -1
+bool readMortalityRecords(const string& fileName, vector<MortalityRecord>& records)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    auto splitLine = [](const string& line)
+    {
+        vector<string> items;
+        std::stringstream ss(line);
+        string item;
+        while (getline(ss, item, ','))
+        {
+            item.erase(std::remove_if(item.begin(), item.end(), [](char c) { return c == '\r' || c == ' '; }), item.end());
+            items.push_back(item);
+        }
+        return items;
+    };
+
+    string line;
+    getline(file, line);
+    vector<string> header = splitLine(line);
+    auto column = [&](const string& name)
+    {
+        return static_cast<int>(std::find(header.begin(), header.end(), name) - header.begin());
+    };
+    const int speciesColumn = column("TreeSpecies");
+    const int equationColumn = column("EquationType");
+    const int switchColumn = column("FS");
+    const int flameOrScorchColumn = column("FlLe/ScHt");
+    const int expansionColumn = column("TreeExpansionFactor");
+    const int diameterColumn = column("Diameter");
+    const int heightColumn = column("TreeHeight");
+    const int crownRatioColumn = column("CrownRatio");
+    const int crownScorchColumn = column("CrownScorch%");
+    const int cambiumColumn = column("CKR");
+    const int beetleColumn = column("BeetleDamage");
+    const int boleCharColumn = column("BoleCharHeight");
+
+    while (getline(file, line))
+    {
+        vector<string> items = splitLine(line);
+        items.resize(header.size());
+        auto number = [&](int index)
+        {
+            return items[index].empty() ? -1.0 : std::stod(items[index]);
+        };
+
+        MortalityRecord record;
+        record.speciesCode = items[speciesColumn];
+        const string& equation = items[equationColumn];
+        record.equationType = (equation == "CRNSCH") ? EquationType::crown_scorch
+            : (equation == "CRCABE") ? EquationType::crown_damage
+            : (equation == "BOLCHR") ? EquationType::bole_char
+            : EquationType::not_set;
+        record.flameLengthOrScorchHeightSwitch = items[switchColumn];
+        record.flameLengthOrScorchHeight = number(flameOrScorchColumn);
+        record.treeExpansionFactor = number(expansionColumn);
+        record.diameter = number(diameterColumn);
+        record.treeHeight = number(heightColumn);
+        record.crownRatio = number(crownRatioColumn);
+        record.crownScorch = number(crownScorchColumn);
+        record.cambiumKillRating = number(cambiumColumn);
+        record.beetleDamage = items[beetleColumn];
+        std::transform(record.beetleDamage.begin(), record.beetleDamage.end(), record.beetleDamage.begin(), ::toupper);
+        record.boleCharHeight = number(boleCharColumn);
+        records.push_back(record);
+    }
+    return true;
+}
+
+double calculateMortalityForRecord(Mortality& mortality, const MortalityRecord& record)
+{
+    mortality.setEquationType(record.equationType);
+    mortality.setSpeciesCode(record.speciesCode);
+    if (!mortality.updateInputsForSpeciesCodeAndEquationType(record.speciesCode, record.equationType))
+    {
+        return 0.0;
+    }
+
+    if (record.flameLengthOrScorchHeightSwitch == "S")
+    {
+        mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::scorch_height);
+    }
+    else if (!record.flameLengthOrScorchHeightSwitch.empty())
+    {
+        mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::flame_length);
+    }
+    if (record.flameLengthOrScorchHeight >= 0.0)
+    {
+        mortality.setFlameLengthOrScorchHeightValue(record.flameLengthOrScorchHeight, LengthUnits::Feet);
+    }
+    if (record.treeExpansionFactor >= 0.0)
+    {
+        mortality.setTreeDensityPerUnitArea(record.treeExpansionFactor, AreaUnits::Acres);
+    }
+    if (record.diameter >= 0.0)
+    {
+        mortality.setDBH(record.diameter, LengthUnits::Inches);
+    }
+    if (record.treeHeight >= 0.0)
+    {
+        mortality.setTreeHeight(record.treeHeight, LengthUnits::Feet);
+    }
+    if (record.crownRatio >= 0.0)
+    {
+        mortality.setCrownRatio(record.crownRatio / 100, FractionUnits::Fraction);
+    }
+    if (record.crownScorch >= 0.0)
+    {
+        mortality.setCrownDamage(record.crownScorch);
+    }
+    if (record.cambiumKillRating >= 0.0)
+    {
+        mortality.setCambiumKillRating(record.cambiumKillRating);
+    }
+    if (!record.beetleDamage.empty())
+    {
+        mortality.setBeetleDamage((record.beetleDamage == "YES") ? BeetleDamage::yes
+            : (record.beetleDamage == "NO") ? BeetleDamage::no : BeetleDamage::not_set);
+    }
+    if (record.boleCharHeight >= 0.0)
+    {
+        mortality.setBoleCharHeight(record.boleCharHeight, LengthUnits::Feet);
+    }
+    return mortality.calculateMortality(FractionUnits::Percent);
+}
+
+void benchmarkMortality(BenchmarkRunner& runner, SpeciesMasterTable& speciesMasterTable)
+{
+    vector<MortalityRecord> records;
+    if (!readMortalityRecords(runner.getOptions().mortalityInput, records))
+    {
+        std::cerr << "Skipping mortality benchmarks, cannot read " << runner.getOptions().mortalityInput << "\n";
+        return;
+    }
+
+    Mortality mortality(speciesMasterTable);
+    mortality.setRegion(RegionCode::south_east);
+    runner.run("mortality/fofem_input", static_cast<long>(records.size()), [&]()
+    {
+        for (const MortalityRecord& record : records)
+        {
+            benchmarkSink = benchmarkSink + calculateMortalityForRecord(mortality, record);
+        }
+    });
+}
+
+void benchmarkExpectedSpreadRate(BenchmarkRunner& runner)
+{
+    const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const struct
+    {
+        long samples;
+        long depths;
+        long laterals;
+    } blocks[] = { { 2, 2, 0 }, { 3, 3, 0 }, { 2, 2, 1 } };
+
+    vector<int> threadCounts = { 1 };
+    if (hardwareThreads > 1)
+    {
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    for (const auto& block : blocks)
+    {
+        for (int threadCount : threadCounts)
+        {
+            RandFuel randFuel;
+            randFuel.setCellDimensions(10);
+            randFuel.allocFuels(3);
+            randFuel.setFuelData(0, 10.0, 0.5);
+            randFuel.setFuelData(1, 3.0, 0.3);
+            randFuel.setFuelData(2, 1.0, 0.2);
+
+            string name = "exrate/compute_spread2/" + std::to_string(block.samples) + "x" + std::to_string(block.depths) +
+                "_laterals_" + std::to_string(block.laterals) + "/threads_" + std::to_string(threadCount);
+            runner.run(name, 1, [&]()
+            {
+                double maxRos = 0.0;
+                double harmonicRos = 0.0;
+                benchmarkSink = benchmarkSink + randFuel.computeSpread2(block.samples, block.depths, 2.0, threadCount, &maxRos,
+                    &harmonicRos, block.laterals, 0);
+            });
+        }
+    }
+}
+
+void printUsage()
+{
+    std::cout << "Usage: benchBehave [--format=console|csv|json] [--min_time=seconds] [--filter=substring]"
+        << " [--mortality_input=file.tre]\n";
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        auto valueOf = [&](const string& option)
+        {
+            return argument.substr(option.size());
+        };
+        if (argument.compare(0, 9, "--format=") == 0)
+        {
+            options.format = valueOf("--format=");
+        }
+        else if (argument.compare(0, 11, "--min_time=") == 0)
+        {
+            options.minTime = std::stod(valueOf("--min_time="));
+        }
+        else if (argument.compare(0, 9, "--filter=") == 0)
+        {
+            options.filter = valueOf("--filter=");
+        }
+        else if (argument.compare(0, 18, "--mortality_input=") == 0)
+        {
+            options.mortalityInput = valueOf("--mortality_input=");
+        }
+        else
+        {
+            printUsage();
+            return (argument == "--help") ? 0 : 1;
+        }
+    }
+    if (options.format != "console" && options.format != "csv" && options.format != "json")
+    {
+        printUsage();
+        return 1;
+    }
+
+    FuelModels fuelModels;
+    SpeciesMasterTable speciesMasterTable;
+    BehaveRun behaveRun(fuelModels, speciesMasterTable);
+    BenchmarkRunner runner(options);
+
+    benchmarkSurface(runner, behaveRun, fuelModels);
+    benchmarkTwoFuelModels(runner, behaveRun);
+    benchmarkCrown(runner, behaveRun);
+    benchmarkSpot(runner, behaveRun);
+    benchmarkContain(runner, behaveRun);
+    benchmarkMortality(runner, speciesMasterTable);
+    benchmarkExpectedSpreadRate(runner);
+
+    runner.report();
+    return 0;
+}
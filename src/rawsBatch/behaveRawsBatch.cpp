@@ -1,15 +1,25 @@
 #define _CRT_SECURE_NO_WARNINGS // Disable warnings for fopen()
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
-#include "fuelModels.h"
 #include "behaveRun.h"
+#include "columnarFile.h"
+#include "csvReader.h"
+#include "fuelModels.h"
 
 #define EQUAL(a,b) (strcmp(a,b)==0)
 
@@ -30,15 +40,262 @@ enum
     ASPECT
 };
 
+// Columns of the binary output file
+enum
+{
+    BINARY_RAWS_ID,
+    BINARY_DATE_TIME,
+    BINARY_OBSERVED_OR_PREDICTED,
+    BINARY_SPREAD_RATE,
+    BINARY_FLAME_LENGTH
+};
+
+// One line of the input file, parsed
+struct RawsRun
+{
+    size_t identifierEnd; // end of this run's identifier in RawsBlock::identifiers
+    bool badData;
+    int fuelModelNumber;
+    double moistureOneHr;
+    double moistureTenHr;
+    double moistureHundredHr;
+    double moistureLiveHerb;
+    double moistureLiveWoody;
+    double windSpeed;
+    double windDirection;
+    double slope;
+    double aspect;
+};
+
+// A run of consecutive input lines that is handed through the pipeline as a unit
+struct RawsBlock
+{
+    long sequence; // position of the block in the input file
+    std::string identifiers; // every run's RAWS_ID,DATE_TIME,OBSERVED_OR_PREDICTED, back to back
+    std::vector<RawsRun> runs;
+    std::unique_ptr<ColumnarChunk> chunk; // the block's rows of a binary output file, identifiers filled in by the reader
+    std::string output; // the block's lines of the output file, or its encoded chunk of a binary one
+};
+
+// Numeric inputs of a run, each rounded to a multiple of the memo tolerance when there is one
+struct RawsMemoKey
+{
+    int fuelModelNumber;
+    double values[9];
+
+    bool operator==(const RawsMemoKey& rhs) const
+    {
+        return fuelModelNumber == rhs.fuelModelNumber && std::equal(values, values + 9, rhs.values);
+    }
+};
+
+struct RawsMemoKeyHash
+{
+    size_t operator()(const RawsMemoKey& key) const
+    {
+        size_t hash = std::hash<int>()(key.fuelModelNumber);
+        for (double value : key.values)
+        {
+            hash = hash * 31 + std::hash<double>()(value);
+        }
+        return hash;
+    }
+};
+
+// One worker's results by run inputs, so repeated rows such as calm overnight hours skip behave.
+// With a tolerance, rows whose inputs round to the same multiples of it share the result of a run
+// on those multiples, so the output doesn't depend on which worker ran which rows first. The memo
+// is emptied whenever it reaches maxEntries.
+class RawsMemo
+{
+public:
+    explicit RawsMemo(double tolerance)
+        : tolerance_(tolerance), numberOfLookups_(0), numberOfHits_(0) {}
+
+    RawsMemoKey getKey(const RawsRun& run) const
+    {
+        RawsMemoKey key = { run.fuelModelNumber, { run.moistureOneHr, run.moistureTenHr, run.moistureHundredHr,
+            run.moistureLiveHerb, run.moistureLiveWoody, run.windSpeed, run.windDirection, run.slope, run.aspect } };
+        if (tolerance_ > 0.0)
+        {
+            for (double& value : key.values)
+            {
+                value = std::round(value / tolerance_);
+            }
+        }
+        return key;
+    }
+
+    // The run to calculate for a key, run itself when exact, else run with its inputs at their multiples of the tolerance
+    RawsRun getKeyRun(const RawsMemoKey& key, const RawsRun& run) const
+    {
+        RawsRun keyRun = run;
+        if (tolerance_ > 0.0)
+        {
+            double* values[] = { &keyRun.moistureOneHr, &keyRun.moistureTenHr, &keyRun.moistureHundredHr, &keyRun.moistureLiveHerb,
+                &keyRun.moistureLiveWoody, &keyRun.windSpeed, &keyRun.windDirection, &keyRun.slope, &keyRun.aspect };
+            for (int i = 0; i < 9; i++)
+            {
+                *values[i] = key.values[i] * tolerance_;
+            }
+        }
+        return keyRun;
+    }
+
+    bool find(const RawsMemoKey& key, double& spreadRate, double& flameLength)
+    {
+        numberOfLookups_++;
+        auto entry = results_.find(key);
+        if (entry == results_.end())
+        {
+            return false;
+        }
+        numberOfHits_++;
+        spreadRate = entry->second.first;
+        flameLength = entry->second.second;
+        return true;
+    }
+
+    void insert(const RawsMemoKey& key, double spreadRate, double flameLength)
+    {
+        if (results_.size() >= maxEntries)
+        {
+            results_.clear();
+        }
+        results_[key] = std::make_pair(spreadRate, flameLength);
+    }
+
+    long getNumberOfLookups() const { return numberOfLookups_; }
+    long getNumberOfHits() const { return numberOfHits_; }
+
+    static const size_t maxEntries = 65536;
+
+private:
+    double tolerance_;
+    long numberOfLookups_;
+    long numberOfHits_;
+    std::unordered_map<RawsMemoKey, std::pair<double, double>, RawsMemoKeyHash> results_;
+};
+
+// Moves blocks from the reader through the workers to the writer. The reader blocks while
+// maxBlocksInFlight blocks have been read but not yet written, which bounds memory use, and
+// the writer takes finished blocks strictly in input order.
+class RawsPipeline
+{
+public:
+    explicit RawsPipeline(size_t maxBlocksInFlight)
+        : maxBlocksInFlight_(maxBlocksInFlight), blocksInFlight_(0), nextSequenceToWrite_(0), isInputDone_(false) {}
+
+    void pushInput(std::unique_ptr<RawsBlock> block)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        spaceAvailable_.wait(lock, [this] { return blocksInFlight_ < maxBlocksInFlight_; });
+        blocksInFlight_++;
+        input_.push_back(std::move(block));
+        inputAvailable_.notify_one();
+    }
+
+    void finishInput()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        isInputDone_ = true;
+        inputAvailable_.notify_all();
+        outputAvailable_.notify_all();
+    }
+
+    // Null once the input is done and drained
+    std::unique_ptr<RawsBlock> popInput()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        inputAvailable_.wait(lock, [this] { return !input_.empty() || isInputDone_; });
+        if (input_.empty())
+        {
+            return nullptr;
+        }
+        std::unique_ptr<RawsBlock> block = std::move(input_.front());
+        input_.pop_front();
+        return block;
+    }
+
+    void pushOutput(std::unique_ptr<RawsBlock> block)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        long sequence = block->sequence;
+        finished_[sequence] = std::move(block);
+        if (sequence == nextSequenceToWrite_)
+        {
+            outputAvailable_.notify_one();
+        }
+    }
+
+    // Null once every block has been written
+    std::unique_ptr<RawsBlock> popOutput()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        outputAvailable_.wait(lock, [this]
+        {
+            return finished_.count(nextSequenceToWrite_) || (isInputDone_ && blocksInFlight_ == 0);
+        });
+        auto next = finished_.find(nextSequenceToWrite_);
+        if (next == finished_.end())
+        {
+            return nullptr;
+        }
+        std::unique_ptr<RawsBlock> block = std::move(next->second);
+        finished_.erase(next);
+        nextSequenceToWrite_++;
+        return block;
+    }
+
+    void finishOutput()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blocksInFlight_--;
+        spaceAvailable_.notify_one();
+        if (isInputDone_ && blocksInFlight_ == 0)
+        {
+            outputAvailable_.notify_all();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable spaceAvailable_;
+    std::condition_variable inputAvailable_;
+    std::condition_variable outputAvailable_;
+    std::deque<std::unique_ptr<RawsBlock>> input_;
+    std::map<long, std::unique_ptr<RawsBlock>> finished_;
+    size_t maxBlocksInFlight_;
+    size_t blocksInFlight_;
+    long nextSequenceToWrite_;
+    bool isInputDone_;
+};
+
 void Usage()
 {
     printf("\nUsage:\n");
     printf("behave-raws-batch [--input-file-name name]   Optional\n");
     printf("                  [--output-file-name name]  Optional\n");
+    printf("                  [--threads n]              Optional\n");
+    printf("                  [--format csv|binary]      Optional\n");
+    printf("                  [--compress]               Optional\n");
+    printf("                  [--memoize]                Optional\n");
+    printf("                  [--memo-tolerance t]       Optional\n");
     printf("--input-file-name <name>                Optional: Specify input file name\n");
     printf("                                            default file name: input.txt\n");
     printf("--output-file-name <name>               Optional: Specify output file name\n");
-    printf("                                            default file name: output.txt\n");
+    printf("                                            default file name: output.txt, or output.bcol\n");
+    printf("                                            for binary output\n");
+    printf("--threads <n>                           Optional: Number of threads running behave\n");
+    printf("                                            default: one per hardware thread\n");
+    printf("--format <csv|binary>                   Optional: csv writes comma delimited text, binary writes\n");
+    printf("                                            a columnar binary file with NaN for bad data\n");
+    printf("                                            default: csv\n");
+    printf("--compress                              Optional: Compress the chunks of a binary output file\n");
+    printf("--memoize                               Optional: Reuse the results of rows with the same inputs\n");
+    printf("                                            and report the dedup ratio\n");
+    printf("--memo-tolerance <t>                    Optional: Memoize, running inputs at their nearest multiple\n");
+    printf("                                            of t so rows that round alike share a result, default: 0, exact\n");
     printf("\nA properly formatted input file consisting of RAWS data must exist\n");
     printf("RAWS data must be comma delimited and inputs for each behave run separated\nby a new line");
     printf("Inputs must be in the following order within a line:\n");
@@ -54,41 +311,108 @@ void Usage()
     exit(1); // Exit with error code 1
 }
 
-int main(int argc, char *argv[])
+// Runs every line of a block through behave, or takes its result from memo when given, and formats
+// the block's output lines, or encodes its chunk when columnarWriter is given
+void runBlock(BehaveRun& behave, RawsBlock& block, const ColumnarWriter* columnarWriter, RawsMemo* memo)
 {
-    const int MAX_ARGUMENT_INDEX = argc - 1;
-
-    std::string inputFileName = "input.txt"; // default input file name
-    std::string outFileName = "output.txt"; // default output file name
-    std::string runIdentifier = "";
-
-    // Surface Fire Inputs;
-    int fuelModelNumber = 0;
-    double moistureOneHr = 0.0;
-    double moistureTenHr = 0.0;
-    double moistureHundredHr = 0.0;
-    double moistureLiveHerb = 0.0;
-    double moistureLiveWoody = 0.0;
-    double windSpeed = 0.0;
-    double windDirection = 0.0;
-    double slope = 0.0;
-    double aspect = 0.0;
-    double directionOfMaxSpread = 0.0;
-    double flameLength = 0.0;
-    double directionOfInterest = 0.0;
+    // Surface Fire Inputs not read from the file
     double canopyCover = 0.0;
     double canopyHeight = 0.0;
     double crownRatio = 0.0;
-    double spreadRate = 0;
 
-    FuelModels fuelModels;
-    BehaveRun behave(fuelModels);
-
-    std::string line = "";
-    std::string token = "";
-    std::string outputLine = "";
     std::string spreadRateString = "";
     std::string flameLengthString = "";
+    size_t identifierBegin = 0;
+
+    block.output.clear();
+    for (const RawsRun& run : block.runs)
+    {
+        double spreadRate = NAN;
+        double flameLength = NAN;
+        RawsMemoKey memoKey = {};
+        bool isMemoized = false;
+        RawsRun inputs = run;
+        if (memo && !run.badData)
+        {
+            memoKey = memo->getKey(run);
+            isMemoized = memo->find(memoKey, spreadRate, flameLength);
+            inputs = memo->getKeyRun(memoKey, run);
+        }
+        // If data is not bad, do calculations
+        if (!run.badData && !isMemoized)
+        {
+            // Feed input values to behave
+            behave.surface.updateSurfaceInputs(inputs.fuelModelNumber, inputs.moistureOneHr,
+                inputs.moistureTenHr, inputs.moistureHundredHr, inputs.moistureLiveHerb,
+                inputs.moistureLiveWoody, FractionUnits::Percent, inputs.windSpeed,
+                SpeedUnits::MetersPerSecond,
+                WindHeightInputMode::DirectMidflame, inputs.windDirection,
+                WindAndSpreadOrientationMode::RelativeToNorth, inputs.slope,
+                SlopeUnits::Degrees, inputs.aspect, canopyCover, FractionUnits::Percent,
+                canopyHeight, LengthUnits::Feet, crownRatio, FractionUnits::Fraction);
+            // Calculate spread rate and flame length
+            behave.surface.doSurfaceRunInDirectionOfMaxSpread();
+            // Get the surface fire spread rate
+            spreadRate = behave.surface.getSpreadRate(SpeedUnits::MetersPerSecond);
+            // Get other required outputs
+            flameLength = behave.surface.getFlameLength(LengthUnits::Meters);
+            if (memo)
+            {
+                memo->insert(memoKey, spreadRate, flameLength);
+            }
+        }
+
+        if (columnarWriter)
+        {
+            // Bad data is left as NaN
+            block.chunk->appendValue(BINARY_SPREAD_RATE, spreadRate);
+            block.chunk->appendValue(BINARY_FLAME_LENGTH, flameLength);
+            continue;
+        }
+
+        if (!run.badData)
+        {
+            // Convert data to string for output to file
+            spreadRateString = std::to_string(spreadRate);
+            flameLengthString = std::to_string(flameLength);
+        }
+        else
+        {
+            // Data is bad
+            spreadRateString = "NA";
+            flameLengthString = "NA";
+        }
+
+        // Output line is the run's identifier followed by the results
+        block.output.append(block.identifiers, identifierBegin, run.identifierEnd - identifierBegin);
+        block.output += spreadRateString;
+        block.output += ',';
+        block.output += flameLengthString;
+        block.output += '\n';
+        identifierBegin = run.identifierEnd;
+    }
+
+    if (columnarWriter)
+    {
+        columnarWriter->encodeChunk(*block.chunk, block.output);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int MAX_ARGUMENT_INDEX = argc - 1;
+
+    std::string inputFileName = "input.txt"; // default input file name
+    std::string outFileName = ""; // default output file name depends on the format
+    bool isBinaryOutput = false;
+    bool isCompressed = false;
+    bool isMemoized = false;
+    double memoTolerance = 0.0;
+
+    int numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+    FuelModels fuelModels;
+    SpeciesMasterTable speciesMasterTable;
 
     int argIndex = 1;
     // Parse commandline arguments
@@ -105,10 +429,63 @@ int main(int argc, char *argv[])
                     Usage(); // Exits program
                 }
                 outFileName = argv[++argIndex];
-                if (!(outFileName.substr(outFileName.find_last_of(".") + 1) == "txt")) // Output is not yet a .txt file
+            }
+            else if (EQUAL(argv[argIndex], "--format"))
+            {
+                if ((argIndex + 1) > MAX_ARGUMENT_INDEX) // An error has occurred
                 {
-                    // Give the output file a .txt extension
-                    outFileName += ".txt";
+                    // Report error
+                    printf("ERROR: No output format entered\n");
+                    Usage(); // Exits program
+                }
+                argIndex++;
+                if (EQUAL(argv[argIndex], "binary"))
+                {
+                    isBinaryOutput = true;
+                }
+                else if (!EQUAL(argv[argIndex], "csv"))
+                {
+                    printf("ERROR: %s is an invalid output format\n", argv[argIndex]);
+                    Usage(); // Exits program
+                }
+            }
+            else if (EQUAL(argv[argIndex], "--compress"))
+            {
+                isCompressed = true;
+            }
+            else if (EQUAL(argv[argIndex], "--memoize"))
+            {
+                isMemoized = true;
+            }
+            else if (EQUAL(argv[argIndex], "--memo-tolerance"))
+            {
+                if ((argIndex + 1) > MAX_ARGUMENT_INDEX) // An error has occurred
+                {
+                    // Report error
+                    printf("ERROR: No memo tolerance entered\n");
+                    Usage(); // Exits program
+                }
+                memoTolerance = atof(argv[++argIndex]);
+                if (memoTolerance < 0.0)
+                {
+                    printf("ERROR: memo tolerance must not be negative\n");
+                    Usage(); // Exits program
+                }
+                isMemoized = true;
+            }
+            else if (EQUAL(argv[argIndex], "--threads"))
+            {
+                if ((argIndex + 1) > MAX_ARGUMENT_INDEX) // An error has occurred
+                {
+                    // Report error
+                    printf("ERROR: No number of threads entered\n");
+                    Usage(); // Exits program
+                }
+                numberOfThreads = atoi(argv[++argIndex]);
+                if (numberOfThreads < 1)
+                {
+                    printf("ERROR: number of threads must be at least 1\n");
+                    Usage(); // Exits program
                 }
             }
             else if (EQUAL(argv[argIndex], "--input-file-name"))
@@ -135,6 +512,17 @@ int main(int argc, char *argv[])
         }
     }
 
+    const std::string outputExtension = isBinaryOutput ? "bcol" : "txt";
+    if (outFileName.empty())
+    {
+        outFileName = "output." + outputExtension;
+    }
+    else if (!(outFileName.substr(outFileName.find_last_of(".") + 1) == outputExtension)) // Output does not yet have the format's extension
+    {
+        // Give the output file the format's extension
+        outFileName += "." + outputExtension;
+    }
+
     if (inputFileName.compare(outFileName) == 0)
     {
         // Report error
@@ -142,246 +530,153 @@ int main(int argc, char *argv[])
         Usage(); // Exits program
     }
 
-    std::ofstream outputFile(outFileName, std::ios::out);
-    std::ifstream inputFile(inputFileName, std::ifstream::in);
+    std::ofstream outputFile;
+    ColumnarWriter columnarWriter;
+    if (isBinaryOutput)
+    {
+        columnarWriter.addColumn("RAWS_ID", ColumnarColumnType::String);
+        columnarWriter.addColumn("DATE_TIME", ColumnarColumnType::String);
+        columnarWriter.addColumn("OBSERVED_OR_PREDICTED", ColumnarColumnType::String);
+        columnarWriter.addColumn("SPREAD_RATE", ColumnarColumnType::Float64); // m/s
+        columnarWriter.addColumn("FLAME_LENGTH", ColumnarColumnType::Float64); // m
+        columnarWriter.open(outFileName, isCompressed);
+    }
+    else
+    {
+        outputFile.open(outFileName, std::ios::out);
+    }
+    const ColumnarWriter* binaryWriter = isBinaryOutput ? &columnarWriter : nullptr;
+    CsvReader inputReader(inputFileName);
 
     // Check for input file's existence
-    if (!inputFile)
+    if (!inputReader.isOpen())
     {
         // Report error
         printf("ERROR: input file does not exist\n");
         Usage(); // Exits program
     }
 
-    std::stringstream lineStream;
+    // Each worker has its own BehaveRun, made here as constructing one also sets up the
+    // shared species master table
+    std::vector<std::unique_ptr<BehaveRun>> behaveRuns;
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        behaveRuns.emplace_back(new BehaveRun(fuelModels, speciesMasterTable));
+    }
+    const BehaveRun& behave = *behaveRuns[0];
+    std::vector<std::unique_ptr<RawsMemo>> memos;
+    if (isMemoized)
+    {
+        for (int i = 0; i < numberOfThreads; i++)
+        {
+            memos.emplace_back(new RawsMemo(memoTolerance));
+        }
+    }
+
+    const size_t runsPerBlock = 1024;
+    RawsPipeline pipeline(2 * numberOfThreads + 2);
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < numberOfThreads; i++)
+    {
+        workers.emplace_back([&pipeline, &behaveRuns, &memos, binaryWriter, i]()
+        {
+            RawsMemo* memo = memos.empty() ? nullptr : memos[i].get();
+            while (std::unique_ptr<RawsBlock> block = pipeline.popInput())
+            {
+                runBlock(*behaveRuns[i], *block, binaryWriter, memo);
+                pipeline.pushOutput(std::move(block));
+            }
+        });
+    }
+
+    std::thread writer([&pipeline, &outputFile, &columnarWriter, isBinaryOutput]()
+    {
+        while (std::unique_ptr<RawsBlock> block = pipeline.popOutput())
+        {
+            if (isBinaryOutput)
+            {
+                columnarWriter.writeEncodedChunk(block->output);
+            }
+            else
+            {
+                outputFile.write(block->output.data(), block->output.size());
+            }
+            pipeline.finishOutput();
+        }
+    });
+
     bool badData = false;
 
+    // Parses one numeric column, any value that is NA, unreadable or outside of
+    // [lowerLimit, upperLimit] marks the line as bad data
+    auto readValue = [&](int field, double& value, double lowerLimit, double upperLimit)
+    {
+        CsvField token = inputReader.getField(field);
+        if (token.equals("NA") || !token.toDouble(value) || value < lowerLimit || value > upperLimit)
+        {
+            // Data is bad
+            badData = true;
+        }
+    };
 
     printf("Processing files please wait...\n");
     // Start reading input file
-    int tokenCounter = 0;
     int lineCounter = 0;
+    long blockCounter = 0;
+    std::unique_ptr<RawsBlock> block;
 
-    while(getline(inputFile, line))
-    {
-        // Reset variables for new loop iteration
-        lineStream.str("");
-        lineStream.clear();
-        token = "";
-        outputLine = "";
-        spreadRateString = "";
-        flameLengthString = "";
-        tokenCounter = 0;
-        runIdentifier = "";
-        badData = false;
+    while(inputReader.readRow())
+    {
+        if (!block)
+        {
+            block.reset(new RawsBlock());
+            block->sequence = blockCounter++;
+            block->runs.reserve(runsPerBlock);
+            if (isBinaryOutput)
+            {
+                block->chunk.reset(new ColumnarChunk(columnarWriter));
+                block->chunk->reserve(runsPerBlock);
+            }
+        }
 
         // Parse arguments from a single line
-        lineStream << line;
-        while(std::getline(lineStream, token, ','))
+        RawsRun run = RawsRun();
+        badData = false;
+        if (!inputReader.getField(FUEL_MODEL_NUMBER).toInt(run.fuelModelNumber) || !behave.isFuelModelDefined(run.fuelModelNumber))
         {
-            switch (tokenCounter)
+            // Data is bad
+            badData = true;
+        }
+        readValue(ONE_HOUR, run.moistureOneHr, 0, 1000);
+        readValue(TEN_HOUR, run.moistureTenHr, 0, 1000);
+        readValue(HUNDRED_HOUR, run.moistureHundredHr, 0, 1000);
+        readValue(LIVE_HERB, run.moistureLiveHerb, 0, 1000);
+        readValue(LIVE_WOODY, run.moistureLiveWoody, 0, 1000);
+        readValue(WIND_SPEED, run.windSpeed, 0, 1000);
+        readValue(WIND_DIRECTION, run.windDirection, -360, 360);
+        readValue(SLOPE, run.slope, 0, 82);
+        readValue(ASPECT, run.aspect, -360, 360);
+        run.badData = badData;
+
+        // The run is identified by the first three input fields
+        for (int field = RAWS_ID; field <= OBSERVED_OR_PREDICTED; field++)
+        {
+            CsvField token = inputReader.getField(field);
+            if (isBinaryOutput)
             {
-                case RAWS_ID:
-                {
-                    runIdentifier += token + ",";
-                    break;
-                }
-                case DATE_TIME:
-                {
-                    runIdentifier += token + ",";
-                    break;
-                }
-                case OBSERVED_OR_PREDICTED:
-                {
-                    runIdentifier += token;
-                    break;
-                }
-                case FUEL_MODEL_NUMBER:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        fuelModelNumber = std::stoi(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (!behave.isFuelModelDefined(fuelModelNumber))
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case ONE_HOUR:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureOneHr = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureOneHr < 0 || moistureOneHr > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case TEN_HOUR:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureTenHr = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureTenHr < 0 || moistureTenHr > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case HUNDRED_HOUR:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureHundredHr = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureHundredHr < 0 || moistureHundredHr > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case LIVE_HERB:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureLiveHerb = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureLiveHerb < 0 || moistureLiveHerb > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case LIVE_WOODY:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        moistureLiveWoody = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (moistureLiveWoody < 0 || moistureLiveWoody > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case WIND_SPEED:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        windSpeed = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (windSpeed < 0 || windSpeed > 1000)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case WIND_DIRECTION:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        windDirection = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (windDirection < -360 || windDirection > 360)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case SLOPE:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        slope = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (slope < 0 || slope > 82)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                case ASPECT:
-                {
-                    if (!token.compare("NA") == 0)
-                    {
-                        aspect = std::stod(token);
-                    }
-                    else
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    if (aspect < -360|| aspect > 360)
-                    {
-                        // Data is bad
-                        badData = true;
-                    }
-                    break;
-                }
-                default:
-                {
-                    break;
-                }
+                block->chunk->appendString(BINARY_RAWS_ID + field - RAWS_ID, token.data(), token.size());
+                continue;
             }
-            tokenCounter++;
+            block->identifiers.append(token.data(), token.size());
+            block->identifiers += ',';
+        }
+        run.identifierEnd = block->identifiers.size();
+        block->runs.push_back(run);
+
+        if (block->runs.size() == runsPerBlock)
+        {
+            pipeline.pushInput(std::move(block));
         }
 
         lineCounter++;
@@ -389,47 +684,43 @@ int main(int argc, char *argv[])
         {
             printf("processed %d behave runs\n", lineCounter);
         }
+    }
+    if (block)
+    {
+        pipeline.pushInput(std::move(block));
+    }
+    pipeline.finishInput();
 
-        // If data is not bad, do calculations
-        if (!badData)
-        {
-            // Feed input values to behave
-            behave.surface.updateSurfaceInputs(fuelModelNumber, moistureOneHr,
-                moistureTenHr, moistureHundredHr, moistureLiveHerb,
-                moistureLiveWoody, MoistureUnits::Percent, windSpeed,
-                SpeedUnits::MetersPerSecond,
-                WindHeightInputMode::DirectMidflame, windDirection,
-                WindAndSpreadOrientationMode::RelativeToNorth, slope,
-                SlopeUnits::Degrees, aspect, canopyCover, CoverUnits::Percent,
-                canopyHeight, LengthUnits::Feet, crownRatio, FractionUnits::Fraction);
-            // Calculate spread rate and flame length
-            behave.surface.doSurfaceRunInDirectionOfMaxSpread();
-            // Get the surface fire spread rate
-            spreadRate = behave.surface.getSpreadRate(SpeedUnits::MetersPerSecond);
-            // Get other required outputs
-            flameLength = behave.surface.getFlameLength(LengthUnits::Meters);
-            // Convert data to string for output to file
-            spreadRateString = std::to_string(spreadRate);
-            flameLengthString = std::to_string(flameLength);
-        }
-        else
-        {
-            // Data is bad
-            spreadRateString = "NA";
-            flameLengthString = "NA";
-        }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    writer.join();
 
-        // Print line to output file
-        outputLine = runIdentifier + "," + spreadRateString + "," + flameLengthString;
-        outputFile << outputLine << '\n';
+    // Close output file
+    if (isBinaryOutput)
+    {
+        columnarWriter.close();
+    }
+    else
+    {
+        outputFile.close();
     }
 
-    // Close input and output files
-    inputFile.close();
-    outputFile.close();
+    if (isMemoized)
+    {
+        long numberOfLookups = 0;
+        long numberOfHits = 0;
+        for (const std::unique_ptr<RawsMemo>& memo : memos)
+        {
+            numberOfLookups += memo->getNumberOfLookups();
+            numberOfHits += memo->getNumberOfHits();
+        }
+        double dedupRatio = (numberOfLookups > 0) ? (double)numberOfHits / numberOfLookups : 0.0;
+        printf("memoized %ld of %ld behave runs, dedup ratio %.3f\n", numberOfHits, numberOfLookups, dedupRatio);
+    }
 
     printf("Done!\n\n");
 
     return 0; // Success
 }
-
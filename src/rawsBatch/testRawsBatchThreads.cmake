@@ -0,0 +1,61 @@
+# Runs behaveRawsBatch on the same input with one and several threads, exact and memoized with
+# tolerances, and fails if any of the outputs differ. The input spans several pipeline blocks so
+# rows that share a memo key are spread over the workers.
+#
+# cmake -DRAWS_BATCH_EXECUTABLE=<path> -DWORKING_DIRECTORY=<dir> -P testRawsBatchThreads.cmake
+
+file(MAKE_DIRECTORY ${WORKING_DIRECTORY})
+
+set(fuelModels 101 102 121 122 124 165 1 4 10)
+set(input "")
+foreach(row RANGE 0 5999)
+    math(EXPR station "${row} / 1500")
+    math(EXPR hour "${row} % 24")
+    math(EXPR fuelModelIndex "(${row} / 24) % 9")
+    list(GET fuelModels ${fuelModelIndex} fuelModel)
+    math(EXPR oneHour "3 + (${row} * 7) % 17")
+    math(EXPR oneHourFraction "(${row} * 13) % 100")
+    math(EXPR tenHour "${oneHour} + 1")
+    math(EXPR hundredHour "${oneHour} + 2")
+    math(EXPR liveHerb "30 + (${row} * 11) % 120")
+    math(EXPR liveWoody "60 + (${row} * 17) % 120")
+    math(EXPR windSpeed "(${row} * 29) % 12")
+    math(EXPR windSpeedFraction "(${row} * 37) % 100")
+    math(EXPR windDirection "(${row} * 37) % 360")
+    math(EXPR slope "(${row} / 24) % 60")
+    math(EXPR aspect "(${row} * 53) % 360")
+    if(${row} EQUAL 4321)
+        # bad data is written as NA whatever the thread count
+        set(oneHour "NA")
+        set(oneHourFraction "")
+    else()
+        set(oneHourFraction ".${oneHourFraction}")
+    endif()
+    string(APPEND input "RAWS${station},2015-01-01 ${hour}:00:00,obs,${fuelModel},${oneHour}${oneHourFraction},${tenHour},"
+        "${hundredHour},${liveHerb},${liveWoody},${windSpeed}.${windSpeedFraction},${windDirection},${slope},${aspect}\n")
+endforeach()
+file(WRITE ${WORKING_DIRECTORY}/rawsThreadsInput.txt "${input}")
+
+foreach(memoOption "none" "0" "0.5" "50")
+    foreach(threads 1 4)
+        set(arguments --input-file-name rawsThreadsInput.txt --output-file-name rawsThreadsOutput${threads}.txt --threads ${threads})
+        if(NOT memoOption STREQUAL "none")
+            list(APPEND arguments --memo-tolerance ${memoOption})
+        endif()
+        execute_process(COMMAND ${RAWS_BATCH_EXECUTABLE} ${arguments}
+            WORKING_DIRECTORY ${WORKING_DIRECTORY}
+            RESULT_VARIABLE result
+            OUTPUT_QUIET)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "behaveRawsBatch ${arguments} failed with ${result}")
+        endif()
+        file(READ ${WORKING_DIRECTORY}/rawsThreadsOutput${threads}.txt output${threads})
+    endforeach()
+    string(LENGTH "${output1}" outputLength)
+    if(outputLength EQUAL 0)
+        message(FATAL_ERROR "behaveRawsBatch with memo tolerance ${memoOption} wrote no output")
+    endif()
+    if(NOT output1 STREQUAL output4)
+        message(FATAL_ERROR "behaveRawsBatch output with memo tolerance ${memoOption} differs between 1 and 4 threads")
+    endif()
+endforeach()
@@ -1,10 +1,48 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
+#include "behaveCApi.h"
 #include "behaveRun.h"
+#include "behaveRunEvaluator.h"
+#include "behaveService.h"
+#include "columnarFile.h"
+#include "compactSurfaceState.h"
+#include "ContainEnsembleRunner.h"
+#include "ContainOptimizer.h"
+#include "ContainVariantRunner.h"
+#include "csvReader.h"
+#include "fireGrowthRunner.h"
+#include "fuelLibrary.h"
 #include "fuelModels.h"
+#include "instrumentation.h"
+#include "kernelOffload.h"
+#include "landscapeReducer.h"
+#include "landscapeRunner.h"
+#include "landscapeTileRunner.h"
+#include "lazyBehaveRun.h"
+#include "monteCarloRunner.h"
+#include "palmettoGallberry.h"
+#include "randfuel.h"
+#include "resultCache.h"
+#include "runControl.h"
+#include "sharedSurfaceCache.h"
+#include "standMortalityRunner.h"
+#include "surfaceKernel.h"
+#include "surfaceLookupTable.h"
+#include "surfaceSensitivity.h"
+#include "surfaceTwoDimensionalSpreadTable.h"
+#include "sweepTableRunner.h"
+#include "threadPool.h"
+#include "vectorMath.h"
+#include "westernAspen.h"
 
 // Define the error tolerance for double values
 constexpr double error_tolerance = 1e-06;
@@ -31,10 +69,18 @@ void setSurfaceInputsForTwoFuelModelsLowMoistureScenario(BehaveRun& behaveRun);
 void setCrownInputsLowMoistureScenario(BehaveRun& behaveRun);
 
 void testSurfaceSingleFuelModel(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceFuelbedCache(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceIncrementalRun(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceBatch(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceFuelModelSweep(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSweepTableRunner(TestInfo& testInfo, BehaveRun& behaveRun);
+void testFuelModelStaticConstants(TestInfo& testInfo, BehaveRun& behaveRun);
+void testFuelLibrary(TestInfo& testInfo, BehaveRun& behaveRun);
 void testCalculateScorchHeight(TestInfo& testInfo, BehaveRun& behaveRun);
 void testChaparral(TestInfo& testInfo, BehaveRun& behaveRun);
 void testPalmettoGallberry(TestInfo& testInfo, BehaveRun& behaveRun);
 void testWesternAspen(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceFuelbedTypes(TestInfo& testInfo, BehaveRun& behaveRun);
 void testLengthToWidthRatio(TestInfo& testInfo, BehaveRun& behaveRun);
 void testEllipticalDimensions(TestInfo& testInfo, BehaveRun& behaveRun);
 void testDirectionOfInterest(TestInfo& testInfo, BehaveRun& behaveRun);
@@ -43,15 +89,55 @@ void testTwoFuelModels(TestInfo& testInfo, BehaveRun& behaveRun);
 void testCrownModuleRothermel(TestInfo& testInfo, BehaveRun& behaveRun);
 void testCrownModuleScottAndReinhardt(TestInfo& testInfo, BehaveRun& behaveRun);
 void testSpotModule(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSpotEmberLandingDensity(TestInfo& testInfo, BehaveRun& behaveRun);
 void testSpeedUnitConversion(TestInfo& testInfo, BehaveRun& behaveRun);
+void testOutputUnitProfile(TestInfo& testInfo, BehaveRun& behaveRun);
 void testIgniteModule(TestInfo& testInfo, BehaveRun& behaveRun);
 void testSafetyModule(TestInfo& testInfo, BehaveRun& behaveRun);
 void testContainModule(TestInfo& testInfo, BehaveRun& behaveRun);
 void testMortalityModule(TestInfo& testInfo, BehaveRun& behaveRun);
+void testStandMortalityRunner(TestInfo& testInfo, BehaveRun& behaveRun);
 void testFineDeadFuelMoistureTool(TestInfo& testInfo, BehaveRun& behaveRun);
 void testSlopeTool(TestInfo& testInfo, BehaveRun& behaveRun);
 void testVaporPressureDeficitCalculator(TestInfo& testInfo, BehaveRun& behaveRun);
 void testSimpleSurface(TestInfo& testInfo, BehaveRun& behaveRun);
+void testExpectedSpreadRate(TestInfo& testInfo, BehaveRun& behaveRun);
+void testCsvReader(TestInfo& testInfo, BehaveRun& behaveRun);
+void testLazyBehaveRun(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSharedThreadPool(TestInfo& testInfo, BehaveRun& behaveRun);
+void testLandscapeRunner(TestInfo& testInfo, BehaveRun& behaveRun);
+void testFireGrowthRunner(TestInfo& testInfo, BehaveRun& behaveRun);
+void testLandscapeTileRunner(TestInfo& testInfo, BehaveRun& behaveRun);
+void testResultCache(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceLookupTable(TestInfo& testInfo, BehaveRun& behaveRun);
+void testContainOptimizer(TestInfo& testInfo, BehaveRun& behaveRun);
+void testContainVariantRunner(TestInfo& testInfo, BehaveRun& behaveRun);
+void testContainEnsembleRunner(TestInfo& testInfo, BehaveRun& behaveRun);
+void testVectorMath(TestInfo& testInfo, BehaveRun& behaveRun);
+void testTimeSeriesRun(TestInfo& testInfo, BehaveRun& behaveRun);
+void testFusedSurfaceRun(TestInfo& testInfo, BehaveRun& behaveRun);
+void testMonteCarloRunner(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceSensitivity(TestInfo& testInfo, BehaveRun& behaveRun);
+void testChaparralBatch(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSpecialFuelbedMemo(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSurfaceKernel(TestInfo& testInfo, BehaveRun& behaveRun);
+void testCrownFuelKernel(TestInfo& testInfo, BehaveRun& behaveRun);
+void testCrownBatch(TestInfo& testInfo, BehaveRun& behaveRun);
+void testKernelOffload(TestInfo& testInfo, BehaveRun& behaveRun);
+void testBehaveService(TestInfo& testInfo, BehaveRun& behaveRun);
+void testTorchingAndCrowningIndex(TestInfo& testInfo, BehaveRun& behaveRun);
+void testFireSizeAtElapsedTimes(TestInfo& testInfo, BehaveRun& behaveRun);
+void testIgniteBatch(TestInfo& testInfo, BehaveRun& behaveRun);
+void testWeatherAndTerrainBatch(TestInfo& testInfo, BehaveRun& behaveRun);
+void testSafetyBatch(TestInfo& testInfo, BehaveRun& behaveRun);
+void testColumnarFile(TestInfo& testInfo);
+void testBehaveRunSnapshot(TestInfo& testInfo);
+void testCompactSurfaceState(TestInfo& testInfo);
+void testBehaveRunEvaluator(TestInfo& testInfo);
+void testBehaveCApi(TestInfo& testInfo);
+#ifdef BEHAVE_INSTRUMENTATION
+void testInstrumentation(TestInfo& testInfo, BehaveRun& behaveRun);
+#endif
 
 int main()
 {
@@ -65,10 +151,18 @@ int main()
     setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
 
     testSurfaceSingleFuelModel(testInfo, behaveRun);
+    testSurfaceFuelbedCache(testInfo, behaveRun);
+    testSurfaceIncrementalRun(testInfo, behaveRun);
+    testSurfaceBatch(testInfo, behaveRun);
+    testSurfaceFuelModelSweep(testInfo, behaveRun);
+    testSweepTableRunner(testInfo, behaveRun);
+    testFuelModelStaticConstants(testInfo, behaveRun);
+    testFuelLibrary(testInfo, behaveRun);
     testChaparral(testInfo, behaveRun);
     testCalculateScorchHeight(testInfo, behaveRun);
     testPalmettoGallberry(testInfo, behaveRun);
     testWesternAspen(testInfo, behaveRun);
+    testSurfaceFuelbedTypes(testInfo, behaveRun);
     testLengthToWidthRatio(testInfo, behaveRun);
     testEllipticalDimensions(testInfo, behaveRun);
     testDirectionOfInterest(testInfo, behaveRun);
@@ -77,15 +171,55 @@ int main()
     testCrownModuleRothermel(testInfo, behaveRun);
     testCrownModuleScottAndReinhardt(testInfo, behaveRun);
     testSpotModule(testInfo, behaveRun);
+    testSpotEmberLandingDensity(testInfo, behaveRun);
     testSpeedUnitConversion(testInfo, behaveRun);
+    testOutputUnitProfile(testInfo, behaveRun);
     testIgniteModule(testInfo, behaveRun);
     testSafetyModule(testInfo, behaveRun);
     testContainModule(testInfo, behaveRun);
     testMortalityModule(testInfo, behaveRun);
+    testStandMortalityRunner(testInfo, behaveRun);
     testFineDeadFuelMoistureTool(testInfo, behaveRun);
     testSlopeTool(testInfo, behaveRun);
     testVaporPressureDeficitCalculator(testInfo, behaveRun);
     testSimpleSurface(testInfo, behaveRun);
+    testExpectedSpreadRate(testInfo, behaveRun);
+    testCsvReader(testInfo, behaveRun);
+    testLazyBehaveRun(testInfo, behaveRun);
+    testSharedThreadPool(testInfo, behaveRun);
+    testLandscapeRunner(testInfo, behaveRun);
+    testFireGrowthRunner(testInfo, behaveRun);
+    testLandscapeTileRunner(testInfo, behaveRun);
+    testResultCache(testInfo, behaveRun);
+    testSurfaceLookupTable(testInfo, behaveRun);
+    testContainOptimizer(testInfo, behaveRun);
+    testContainVariantRunner(testInfo, behaveRun);
+    testContainEnsembleRunner(testInfo, behaveRun);
+    testVectorMath(testInfo, behaveRun);
+    testTimeSeriesRun(testInfo, behaveRun);
+    testFusedSurfaceRun(testInfo, behaveRun);
+    testMonteCarloRunner(testInfo, behaveRun);
+    testSurfaceSensitivity(testInfo, behaveRun);
+    testChaparralBatch(testInfo, behaveRun);
+    testSpecialFuelbedMemo(testInfo, behaveRun);
+    testSurfaceKernel(testInfo, behaveRun);
+    testCrownFuelKernel(testInfo, behaveRun);
+    testCrownBatch(testInfo, behaveRun);
+    testKernelOffload(testInfo, behaveRun);
+    testBehaveService(testInfo, behaveRun);
+    testTorchingAndCrowningIndex(testInfo, behaveRun);
+    testFireSizeAtElapsedTimes(testInfo, behaveRun);
+    testIgniteBatch(testInfo, behaveRun);
+    testWeatherAndTerrainBatch(testInfo, behaveRun);
+    testSafetyBatch(testInfo, behaveRun);
+    testColumnarFile(testInfo);
+    testBehaveRunSnapshot(testInfo);
+    testCompactSurfaceState(testInfo);
+    testBehaveRunEvaluator(testInfo);
+    testBehaveCApi(testInfo);
+#ifdef BEHAVE_INSTRUMENTATION
+    testInstrumentation(testInfo, behaveRun);
+#endif
 
     std::cout << "Total tests performed: " << testInfo.numTotalTests << "\n";
     if(testInfo.numPassed > 0)
@@ -364,6 +498,18 @@ void testSurfaceSingleFuelModel(TestInfo& testInfo, BehaveRun& behaveRun)
     expectedSurfaceFireSpreadRate = 1.978840;
     reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
 
+    MoistureScenarios moistureScenarios;
+    double scenarioMoistures[5];
+    bool isScenarioFound = moistureScenarios.getMoistureScenarioMoisturesByIndex(moistureScenarios.getMoistureScenarioIndexByName("d2l3"),
+        FractionUnits::Percent, scenarioMoistures);
+    testName = "Test all moistures of the D2L3 scenario at once";
+    reportTestResult(testInfo, testName, isScenarioFound && scenarioMoistures[0] == 6 && scenarioMoistures[2] == 8 &&
+        scenarioMoistures[3] == 90 && scenarioMoistures[4] == 120, true, error_tolerance);
+    testName = "Test moistures of an undefined scenario";
+    isScenarioFound = moistureScenarios.getMoistureScenarioMoisturesByIndex(moistureScenarios.getMoistureScenarioIndexByName("D9L9"),
+        FractionUnits::Fraction, scenarioMoistures);
+    reportTestResult(testInfo, testName, !isScenarioFound && scenarioMoistures[1] == -1.0, true, error_tolerance);
+
     testName = "Test aggregate live and dead moisture input mode, 5 mph 20 foot uplsope wind";
     behaveRun.surface.setMoistureInputMode(MoistureInputMode::AllAggregate);
     behaveRun.surface.setMoistureDeadAggregate(3.0, moistureUnits);
@@ -376,74 +522,74 @@ void testSurfaceSingleFuelModel(TestInfo& testInfo, BehaveRun& behaveRun)
     testName = "Test check for 1 hour input requirment for current fuel and aggregate moisture input mode, 5 mph 20 foot uplsope wind";
     bool observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::OneHour);
     bool expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for 10 hour moisture input requirment for current fuel and aggregate moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::TenHour);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for 100 hour moisture input requirment for current fuel and aggregate moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::HundredHour);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for live herb moisture input requirment for current fuel and aggregate moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::LiveHerbaceous);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for live woody moisture input requirment for current fuel and aggregate moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::LiveWoody);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for aggregate dead moisture input requirment for current fuel and aggregate moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::DeadAggregate);
     expectedIsMoistureClassNeeded = true;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for aggregate live moisture input requirment for current fuel and aggregate moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::LiveAggregate);
     expectedIsMoistureClassNeeded = true;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     behaveRun.surface.setMoistureInputMode(MoistureInputMode::DeadAggregateAndLiveSizeClass);
 
     testName = "Test check for 1 hour input requirment for current fuel and aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::OneHour);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for 10 hour moisture input requirment for current fuel and aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::TenHour);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for 100 hour moisture input requirment for current fuel and aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::HundredHour);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for live herb moisture input requirment for current fuel and aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::LiveHerbaceous);
     expectedIsMoistureClassNeeded = true;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for live woody moisture input requirment for current fuel and aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::LiveWoody);
     expectedIsMoistureClassNeeded = true;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for aggregate dead moisture input requirment for current fuel and aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::DeadAggregate);
     expectedIsMoistureClassNeeded = true;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test check for aggregate live moisture input requirment for current fuel and aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     observedIsMoistureClassNeeded = behaveRun.surface.isMoistureClassInputNeededForCurrentFuelModel(MoistureClassInput::LiveAggregate);
     expectedIsMoistureClassNeeded = false;
-    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)observedIsMoistureClassNeeded, error_tolerance);
+    reportTestResult(testInfo, testName, (double)observedIsMoistureClassNeeded, (double)expectedIsMoistureClassNeeded, error_tolerance);
 
     testName = "Test aggregate dead and live size class moisture input mode, 5 mph 20 foot uplsope wind";
     setSurfaceInputsForGS4LowMoistureScenario(behaveRun); // reset moisture
@@ -542,6 +688,750 @@ void testCalculateScorchHeight(TestInfo& testInfo, BehaveRun& behaveRun)
     reportTestResult(testInfo, testName, observedScorchHeight, expectedScorchHeight, error_tolerance);
 }
 
+void testSurfaceFuelbedCache(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    string testName = "";
+    double observedSurfaceFireSpreadRate = 0.0;
+    double expectedSurfaceFireSpreadRate = 0.0;
+    SpeedUnits::SpeedUnitsEnum windSpeedUnits = SpeedUnits::MilesPerHour;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode = WindHeightInputMode::TwentyFoot;
+
+    std::cout << "Testing Surface, fuelbed cache\n";
+    setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
+    behaveRun.surface.setFuelbedCacheCapacity(4);
+
+    // Same inputs as the single fuel model tests, so the cached runs must give the same spread rates
+    testName = "Test fuelbed cache miss, north oriented mode, 45 degree wind, 95 degree aspect, 5 mph 20 foot wind, 30 degree slope";
+    behaveRun.surface.setWindHeightInputMode(windHeightInputMode);
+    behaveRun.surface.setSlope(30, SlopeUnits::Degrees);
+    behaveRun.surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+    behaveRun.surface.setWindSpeed(5, windSpeedUnits, windHeightInputMode);
+    behaveRun.surface.setWindDirection(45);
+    behaveRun.surface.setAspect(95);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour));
+    expectedSurfaceFireSpreadRate = 19.677584;
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+
+    // Switch fuel models in between, otherwise the next run reuses the fuelbed of this one without looking in the cache
+    behaveRun.surface.setFuelModelNumber(1);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    behaveRun.surface.setFuelModelNumber(124);
+
+    testName = "Test fuelbed cache hit, upslope oriented mode, 5 mph 20 foot uplsope wind";
+    behaveRun.surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
+    behaveRun.surface.setWindDirection(0);
+    behaveRun.surface.setSlope(30, SlopeUnits::Percent);
+    behaveRun.surface.setAspect(0);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour));
+    expectedSurfaceFireSpreadRate = 8.876216;
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+
+    testName = "Test fuelbed cache hits after two runs with the same fuel and moisture";
+    reportTestResult(testInfo, testName, behaveRun.surface.getFuelbedCacheNumberOfHits(), 1, error_tolerance);
+    testName = "Test fuelbed cache misses after two runs with the same fuel and moisture";
+    reportTestResult(testInfo, testName, behaveRun.surface.getFuelbedCacheNumberOfMisses(), 2, error_tolerance);
+
+    testName = "Test fuelbed cache entries after a moisture change";
+    behaveRun.surface.setMoistureOneHour(10, FractionUnits::Percent);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    reportTestResult(testInfo, testName, behaveRun.surface.getFuelbedCacheNumberOfEntries(), 3, error_tolerance);
+    testName = "Test fuelbed cache misses after a moisture change";
+    reportTestResult(testInfo, testName, behaveRun.surface.getFuelbedCacheNumberOfMisses(), 3, error_tolerance);
+
+    testName = "Test fuelbed cache entries after clearing";
+    behaveRun.surface.clearFuelbedCache();
+    reportTestResult(testInfo, testName, behaveRun.surface.getFuelbedCacheNumberOfEntries(), 0, error_tolerance);
+
+    behaveRun.surface.setFuelbedCacheCapacity(0);
+
+    std::cout << "Finished testing Surface, fuelbed cache\n\n";
+}
+
+void testSurfaceIncrementalRun(TestInfo& testInfo, BehaveRun&)
+{
+    string testName = "";
+    FuelModels fuelModels;
+    const int customFuelModelNumber = 14;
+    double firstSpreadRate = 0.0;
+    double observedSurfaceFireSpreadRate = 0.0;
+    double expectedSurfaceFireSpreadRate = 0.0;
+    SpeedUnits::SpeedUnitsEnum speedUnits = SpeedUnits::ChainsPerHour;
+    WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode = WindHeightInputMode::TwentyFoot;
+
+    std::cout << "Testing Surface, incremental runs\n";
+
+    // Runs on a surface that has already run must match runs on a fresh surface with the same inputs
+    Surface surface(fuelModels);
+    surface.updateSurfaceInputs(1, 6, 7, 8, 60, 90, FractionUnits::Percent, 5, SpeedUnits::MilesPerHour, windHeightInputMode, 0,
+        WindAndSpreadOrientationMode::RelativeToUpslope, 30, SlopeUnits::Percent, 0, 50, FractionUnits::Percent, 30, LengthUnits::Feet,
+        50, FractionUnits::Percent);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+    firstSpreadRate = surface.getSpreadRate(speedUnits);
+
+    testName = "Test incremental run after a wind speed change matches a full run";
+    surface.setWindSpeed(10, SpeedUnits::MilesPerHour, windHeightInputMode);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(surface.getSpreadRate(speedUnits));
+    Surface freshSurface(fuelModels);
+    freshSurface.updateSurfaceInputs(1, 6, 7, 8, 60, 90, FractionUnits::Percent, 10, SpeedUnits::MilesPerHour, windHeightInputMode, 0,
+        WindAndSpreadOrientationMode::RelativeToUpslope, 30, SlopeUnits::Percent, 0, 50, FractionUnits::Percent, 30, LengthUnits::Feet,
+        50, FractionUnits::Percent);
+    freshSurface.doSurfaceRunInDirectionOfMaxSpread();
+    expectedSurfaceFireSpreadRate = roundToSixDecimalPlaces(freshSurface.getSpreadRate(speedUnits));
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+
+    testName = "Test incremental run after a slope and wind direction change matches a full run";
+    surface.setSlope(60, SlopeUnits::Percent);
+    surface.setWindDirection(45);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(surface.getSpreadRate(speedUnits));
+    freshSurface.setSlope(60, SlopeUnits::Percent);
+    freshSurface.setWindDirection(45);
+    freshSurface.setFuelModelNumber(1); // forces a full run
+    freshSurface.doSurfaceRunInDirectionOfMaxSpread();
+    expectedSurfaceFireSpreadRate = roundToSixDecimalPlaces(freshSurface.getSpreadRate(speedUnits));
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+
+    // A custom fuel model identical to fuel model 1, redefined under the same number between runs
+    testName = "Test incremental run of a custom copy of fuel model 1 matches fuel model 1";
+    surface.setSlope(30, SlopeUnits::Percent);
+    surface.setWindDirection(0);
+    surface.setWindSpeed(5, SpeedUnits::MilesPerHour, windHeightInputMode);
+    fuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    surface.setFuelModelNumber(customFuelModelNumber);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(surface.getSpreadRate(speedUnits));
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, roundToSixDecimalPlaces(firstSpreadRate), error_tolerance);
+
+    testName = "Test incremental run sees a redefined custom fuel model";
+    fuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.068, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(surface.getSpreadRate(speedUnits));
+    freshSurface.updateSurfaceInputs(customFuelModelNumber, 6, 7, 8, 60, 90, FractionUnits::Percent, 5, SpeedUnits::MilesPerHour,
+        windHeightInputMode, 0, WindAndSpreadOrientationMode::RelativeToUpslope, 30, SlopeUnits::Percent, 0, 50, FractionUnits::Percent,
+        30, LengthUnits::Feet, 50, FractionUnits::Percent);
+    freshSurface.doSurfaceRunInDirectionOfMaxSpread();
+    expectedSurfaceFireSpreadRate = roundToSixDecimalPlaces(freshSurface.getSpreadRate(speedUnits));
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+    testName = "Test redefined custom fuel model changes the spread rate";
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate != roundToSixDecimalPlaces(firstSpreadRate), true, error_tolerance);
+
+    testName = "Test spread rate at another 20 foot wind speed matches a full run";
+    firstSpreadRate = surface.getSpreadRate(speedUnits);
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(surface.calculateSpreadRateAtTwentyFootWindSpeed(12, SpeedUnits::MilesPerHour, speedUnits));
+    freshSurface.setWindSpeed(12, SpeedUnits::MilesPerHour, windHeightInputMode);
+    freshSurface.doSurfaceRunInDirectionOfMaxSpread();
+    expectedSurfaceFireSpreadRate = roundToSixDecimalPlaces(freshSurface.getSpreadRate(speedUnits));
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+    testName = "Test spread rate at another 20 foot wind speed leaves the last run unchanged";
+    reportTestResult(testInfo, testName, surface.getSpreadRate(speedUnits), firstSpreadRate, error_tolerance);
+
+    // Cells cycling through three canopy classes reuse the memoized wind adjustment factors
+    const int numberOfCells = 24;
+    const double canopyCovers[] = { 0.1, 0.5, 0.5 };
+    const double canopyHeights[] = { 30.0, 30.0, 80.0 };
+    Surface memoSurface(fuelModels);
+    int numberOfWindAdjustmentFactorMismatches = 0;
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        double windSpeed = 3.0 + i % 5;
+        Surface cellSurface(fuelModels);
+        Surface* surfaces[] = { &memoSurface, &cellSurface };
+        for (Surface* cell : surfaces)
+        {
+            cell->updateSurfaceInputs(1, 6, 7, 8, 60, 90, FractionUnits::Percent, windSpeed, SpeedUnits::MilesPerHour,
+                windHeightInputMode, 0, WindAndSpreadOrientationMode::RelativeToUpslope, 10, SlopeUnits::Degrees, 0,
+                canopyCovers[i % 3], FractionUnits::Fraction, canopyHeights[i % 3], LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+            cell->setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UseCrownRatio);
+            cell->doSurfaceRunInDirectionOfMaxSpread();
+        }
+        numberOfWindAdjustmentFactorMismatches +=
+            (memoSurface.getMidflameWindspeed(SpeedUnits::FeetPerMinute) != cellSurface.getMidflameWindspeed(SpeedUnits::FeetPerMinute)) ||
+            (memoSurface.getSpreadRate(speedUnits) != cellSurface.getSpreadRate(speedUnits));
+    }
+    testName = "Test memoized wind adjustment factors match full runs";
+    reportTestResult(testInfo, testName, numberOfWindAdjustmentFactorMismatches, 0, error_tolerance);
+    // Plus the midflame wind speed the first input update calculates before any fuelbed depth is known
+    testName = "Test wind adjustment factor memo calculates each canopy class once";
+    reportTestResult(testInfo, testName, memoSurface.getWindAdjustmentFactorMemoNumberOfMisses(), 3 + 1, error_tolerance);
+
+    std::cout << "Finished testing Surface, incremental runs\n\n";
+}
+
+void testSurfaceBatch(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    string testName = "";
+
+    std::cout << "Testing Surface, batch run\n";
+    setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
+    behaveRun.surface.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+    behaveRun.surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+
+    // Cell 0 matches the first single fuel model test, cell 2 has no fuel to burn
+    const int numberOfCells = 3;
+    int fuelModelNumber[numberOfCells] = { 124, 1, 91 };
+    double moistureOneHour[numberOfCells] = { 0.06, 0.06, 0.06 };
+    double moistureTenHour[numberOfCells] = { 0.07, 0.07, 0.07 };
+    double moistureHundredHour[numberOfCells] = { 0.08, 0.08, 0.08 };
+    double moistureLiveHerbaceous[numberOfCells] = { 0.60, 0.60, 0.60 };
+    double moistureLiveWoody[numberOfCells] = { 0.90, 0.90, 0.90 };
+    double windSpeed[numberOfCells] = { 440.0, 880.0, 440.0 }; // 5 and 10 mph in ft/min
+    double windDirection[numberOfCells] = { 45.0, 270.0, 0.0 };
+    double slope[numberOfCells] = { 30.0, 10.0, 0.0 };
+    double aspect[numberOfCells] = { 95.0, 180.0, 0.0 };
+    double canopyCover[numberOfCells] = { 0.50, 0.50, 0.50 };
+    double canopyHeight[numberOfCells] = { 30.0, 30.0, 30.0 };
+    double crownRatio[numberOfCells] = { 0.50, 0.50, 0.50 };
+
+    SurfaceBatchInputs inputs = { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour, moistureHundredHour,
+        moistureLiveHerbaceous, moistureLiveWoody, windSpeed, windDirection, slope, aspect, canopyCover, canopyHeight, crownRatio };
+
+    double spreadRate[numberOfCells];
+    double firelineIntensity[numberOfCells];
+    double flameLength[numberOfCells];
+    double directionOfMaxSpread[numberOfCells];
+    double fireLengthToWidthRatio[numberOfCells];
+    SurfaceBatchOutputs outputs = { spreadRate, firelineIntensity, flameLength, directionOfMaxSpread, fireLengthToWidthRatio };
+
+    behaveRun.surface.doSurfaceRunBatch(inputs, outputs);
+
+    double expectedSpreadRate[numberOfCells] = { 19.677584, 15.167219, 0.0 };
+    double expectedFirelineIntensity[numberOfCells] = { 1326.451096, 25.203472, 0.0 };
+    double expectedFlameLength[numberOfCells] = { 12.292791, 1.985566, 0.0 };
+    double expectedDirectionOfMaxSpread[numberOfCells] = { 268.912596, 60.806869, 0.0 };
+    double expectedFireLengthToWidthRatio[numberOfCells] = { 1.375624, 1.162075, 1.0 };
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        string cell = "cell " + std::to_string(i) + ", fuel model " + std::to_string(fuelModelNumber[i]);
+        testName = "Test batch spread rate in ch/h, " + cell;
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(SpeedUnits::fromBaseUnits(spreadRate[i], SpeedUnits::ChainsPerHour)),
+            expectedSpreadRate[i], error_tolerance);
+        testName = "Test batch fireline intensity, " + cell;
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(firelineIntensity[i]), expectedFirelineIntensity[i], error_tolerance);
+        testName = "Test batch flame length, " + cell;
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(flameLength[i]), expectedFlameLength[i], error_tolerance);
+        testName = "Test batch direction of max spread, " + cell;
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(directionOfMaxSpread[i]), expectedDirectionOfMaxSpread[i], error_tolerance);
+        testName = "Test batch length to width ratio, " + cell;
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fireLengthToWidthRatio[i]), expectedFireLengthToWidthRatio[i], error_tolerance);
+    }
+
+    // Fireline intensity only, the flame length and fire shape are skipped and read as zero or one
+    behaveRun.surface.setSurfaceFireOutputs(SurfaceFireOutputs::FirelineIntensity);
+    behaveRun.surface.doSurfaceRunBatch(inputs, outputs);
+    bool isMatchingRequestedOutputs = true;
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        isMatchingRequestedOutputs = isMatchingRequestedOutputs &&
+            roundToSixDecimalPlaces(SpeedUnits::fromBaseUnits(spreadRate[i], SpeedUnits::ChainsPerHour)) == expectedSpreadRate[i] &&
+            roundToSixDecimalPlaces(firelineIntensity[i]) == expectedFirelineIntensity[i] &&
+            roundToSixDecimalPlaces(directionOfMaxSpread[i]) == expectedDirectionOfMaxSpread[i] &&
+            flameLength[i] == 0.0 && fireLengthToWidthRatio[i] == 1.0;
+    }
+    testName = "Test batch run with only fireline intensity requested";
+    reportTestResult(testInfo, testName, isMatchingRequestedOutputs, true, error_tolerance);
+    behaveRun.surface.setSurfaceFireOutputs(SurfaceFireOutputs::All);
+
+    // A run without the fire shape after a full run reads the shape outputs as a fire that doesn't spread,
+    // not the shape of the full run
+    {
+        BehaveRun maskedRun(behaveRun);
+        setSurfaceInputsForGS4LowMoistureScenario(maskedRun);
+        maskedRun.surface.setSurfaceFireOutputs(SurfaceFireOutputs::All);
+        maskedRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        double fullRunSpreadRate = maskedRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour);
+        testName = "Test full run before a spread rate only run has a length to width ratio";
+        reportTestResult(testInfo, testName, maskedRun.surface.getFireLengthToWidthRatio() > 1.0, true, error_tolerance);
+
+        maskedRun.surface.setSurfaceFireOutputs(SurfaceFireOutputs::SpreadRateOnly);
+        maskedRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        testName = "Test spread rate only run after a full run spread rate";
+        reportTestResult(testInfo, testName, maskedRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour), fullRunSpreadRate, error_tolerance);
+        testName = "Test spread rate only run after a full run length to width ratio";
+        reportTestResult(testInfo, testName, maskedRun.surface.getFireLengthToWidthRatio(), 1.0, error_tolerance);
+        testName = "Test spread rate only run after a full run backing spread rate";
+        reportTestResult(testInfo, testName, maskedRun.surface.getBackingSpreadRate(SpeedUnits::ChainsPerHour), 0.0, error_tolerance);
+        testName = "Test spread rate only run after a full run flanking spread rate";
+        reportTestResult(testInfo, testName, maskedRun.surface.getFlankingSpreadRate(SpeedUnits::ChainsPerHour), 0.0, error_tolerance);
+        testName = "Test spread rate only run after a full run fire area";
+        reportTestResult(testInfo, testName, maskedRun.surface.getFireArea(AreaUnits::Acres, 1.0, TimeUnits::Hours), 0.0, error_tolerance);
+        testName = "Test spread rate only run after a full run fire perimeter";
+        reportTestResult(testInfo, testName, maskedRun.surface.getFirePerimeter(LengthUnits::Feet, 1.0, TimeUnits::Hours), 0.0, error_tolerance);
+        testName = "Test spread rate only run after a full run elliptical A";
+        reportTestResult(testInfo, testName, maskedRun.surface.getEllipticalA(LengthUnits::Feet, 1.0, TimeUnits::Hours), 0.0, error_tolerance);
+    }
+
+    // Rows of two stations interleaved by time run grouped by fuelbed give the input order results, calculating
+    // each station's fuelbed once, the first group reusing the fuelbed the input order run ended on
+    {
+        BehaveRun rowRun(behaveRun);
+        const int numberOfRows = 8;
+        int rowFuelModelNumber[numberOfRows];
+        double rowWindSpeed[numberOfRows];
+        double rowMoistureOneHour[numberOfRows];
+        for (int i = 0; i < numberOfRows; i++)
+        {
+            rowFuelModelNumber[i] = (i % 2 == 0) ? 124 : 1;
+            rowWindSpeed[i] = 88.0 * (2 + i);
+            rowMoistureOneHour[i] = (i % 2 == 0) ? 0.06 : 0.08;
+        }
+        vector<double> moistureTen(numberOfRows, 0.07), moistureHundred(numberOfRows, 0.08), moistureHerbaceous(numberOfRows, 0.6),
+            moistureWoody(numberOfRows, 0.9), rowWindDirection(numberOfRows, 45.0), rowSlope(numberOfRows, 20.0),
+            rowAspect(numberOfRows, 180.0), rowCanopyCover(numberOfRows, 0.5), rowCanopyHeight(numberOfRows, 30.0),
+            rowCrownRatio(numberOfRows, 0.5);
+        SurfaceBatchInputs rowInputs = { numberOfRows, rowFuelModelNumber, rowMoistureOneHour, moistureTen.data(), moistureHundred.data(),
+            moistureHerbaceous.data(), moistureWoody.data(), rowWindSpeed, rowWindDirection.data(), rowSlope.data(), rowAspect.data(),
+            rowCanopyCover.data(), rowCanopyHeight.data(), rowCrownRatio.data() };
+
+        vector<double> inputOrderSpreadRate(numberOfRows), inputOrderFlameLength(numberOfRows);
+        SurfaceBatchOutputs inputOrderOutputs = { inputOrderSpreadRate.data(), nullptr, inputOrderFlameLength.data(), nullptr, nullptr };
+        rowRun.surface.setFuelbedCacheCapacity(1);
+        rowRun.surface.doSurfaceRunBatch(rowInputs, inputOrderOutputs);
+        long inputOrderMisses = rowRun.surface.getFuelbedCacheNumberOfMisses();
+
+        vector<double> groupedSpreadRate(numberOfRows), groupedFlameLength(numberOfRows);
+        SurfaceBatchOutputs groupedOutputs = { groupedSpreadRate.data(), nullptr, groupedFlameLength.data(), nullptr, nullptr };
+        rowRun.surface.clearFuelbedCache();
+        rowRun.surface.setBatchOrderMode(SurfaceBatchOrderMode::GroupedByFuelbed);
+        rowRun.surface.doSurfaceRunBatch(rowInputs, groupedOutputs);
+        long groupedMisses = rowRun.surface.getFuelbedCacheNumberOfMisses();
+
+        testName = "Test batch grouped by fuelbed matches input order";
+        reportTestResult(testInfo, testName, groupedSpreadRate == inputOrderSpreadRate && groupedFlameLength == inputOrderFlameLength,
+            true, error_tolerance);
+        testName = "Test batch grouped by fuelbed calculates each fuelbed once";
+        reportTestResult(testInfo, testName, groupedMisses, 1, error_tolerance);
+        testName = "Test batch in input order recalculates alternating fuelbeds";
+        reportTestResult(testInfo, testName, inputOrderMisses, numberOfRows, error_tolerance);
+
+        // Cells with a NaN moisture are grouped after the others and leave the other cells' results as in input order
+        rowMoistureOneHour[2] = NAN;
+        rowMoistureOneHour[5] = NAN;
+        moistureWoody[3] = NAN;
+        rowRun.surface.setBatchOrderMode(SurfaceBatchOrderMode::InputOrder);
+        rowRun.surface.doSurfaceRunBatch(rowInputs, inputOrderOutputs);
+        rowRun.surface.setBatchOrderMode(SurfaceBatchOrderMode::GroupedByFuelbed);
+        rowRun.surface.doSurfaceRunBatch(rowInputs, groupedOutputs);
+        bool isMatchingInputOrder = true;
+        for (int i = 0; i < numberOfRows; i++)
+        {
+            isMatchingInputOrder = isMatchingInputOrder &&
+                (groupedSpreadRate[i] == inputOrderSpreadRate[i] || (std::isnan(groupedSpreadRate[i]) && std::isnan(inputOrderSpreadRate[i]))) &&
+                (groupedFlameLength[i] == inputOrderFlameLength[i] || (std::isnan(groupedFlameLength[i]) && std::isnan(inputOrderFlameLength[i])));
+        }
+        testName = "Test batch grouped by fuelbed with NaN moistures matches input order";
+        reportTestResult(testInfo, testName, isMatchingInputOrder, true, error_tolerance);
+    }
+
+    std::cout << "Finished testing Surface, batch run\n\n";
+}
+
+void testSurfaceFuelModelSweep(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    string testName = "";
+
+    std::cout << "Testing Surface, fuel model sweep\n";
+    BehaveRun sweepRun(behaveRun);
+    setSurfaceInputsForGS4LowMoistureScenario(sweepRun);
+    sweepRun.surface.setSlope(30.0, SlopeUnits::Percent);
+    sweepRun.surface.setWindDirection(45.0);
+
+    // Every standard fuel model, an undefined one and a fuelless one
+    std::vector<int> fuelModelNumbers;
+    for (int fuelModelNumber = 1; fuelModelNumber <= 204; fuelModelNumber++)
+    {
+        if (sweepRun.surface.isFuelModelDefined(fuelModelNumber))
+        {
+            fuelModelNumbers.push_back(fuelModelNumber);
+        }
+    }
+    fuelModelNumbers.push_back(14);
+    const int numberOfFuelModels = (int)fuelModelNumbers.size();
+    std::vector<double> spreadRate(numberOfFuelModels);
+    std::vector<double> firelineIntensity(numberOfFuelModels);
+    std::vector<double> flameLength(numberOfFuelModels);
+    std::vector<double> directionOfMaxSpread(numberOfFuelModels);
+    std::vector<double> fireLengthToWidthRatio(numberOfFuelModels);
+    SurfaceBatchOutputs outputs = { spreadRate.data(), firelineIntensity.data(), flameLength.data(), directionOfMaxSpread.data(),
+        fireLengthToWidthRatio.data() };
+    sweepRun.surface.doSurfaceRunForFuelModels(fuelModelNumbers.data(), numberOfFuelModels, outputs);
+
+    // A single run leaves the previous fire shape for a model with nothing to burn, the sweep reports one
+    BehaveRun singleRun(sweepRun);
+    bool isMatchingSingleRuns = true;
+    for (int i = 0; i < numberOfFuelModels; i++)
+    {
+        singleRun.surface.setFuelModelNumber(fuelModelNumbers[i]);
+        singleRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        bool isFuelToBurn = singleRun.surface.isFuelModelDefined(fuelModelNumbers[i]) && !singleRun.surface.isAllFuelLoadZero(fuelModelNumbers[i]);
+        isMatchingSingleRuns = isMatchingSingleRuns && spreadRate[i] == singleRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute) &&
+            firelineIntensity[i] == singleRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond) &&
+            flameLength[i] == singleRun.surface.getFlameLength(LengthUnits::Feet) &&
+            directionOfMaxSpread[i] == singleRun.surface.getDirectionOfMaxSpread() &&
+            fireLengthToWidthRatio[i] == (isFuelToBurn ? singleRun.surface.getFireLengthToWidthRatio() : 1.0);
+    }
+    testName = "Test fuel model sweep matches a single run of each fuel model";
+    reportTestResult(testInfo, testName, isMatchingSingleRuns, true, error_tolerance);
+    testName = "Test fuel model sweep gives no fire for an undefined fuel model";
+    reportTestResult(testInfo, testName, spreadRate[numberOfFuelModels - 1] == 0.0 && flameLength[numberOfFuelModels - 1] == 0.0 &&
+        fireLengthToWidthRatio[numberOfFuelModels - 1] == 1.0, true, error_tolerance);
+    testName = "Test fuel model sweep keeps the requested surface fire outputs";
+    reportTestResult(testInfo, testName, sweepRun.surface.getSurfaceFireOutputs() == singleRun.surface.getSurfaceFireOutputs(), true, error_tolerance);
+
+    std::vector<double> fastFlameLength(numberOfFuelModels);
+    outputs.flameLength = fastFlameLength.data();
+    sweepRun.surface.setVectorMathMode(VectorMathMode::Fast);
+    sweepRun.surface.doSurfaceRunForFuelModels(fuelModelNumbers.data(), numberOfFuelModels, outputs);
+    double maxRelativeError = 0.0;
+    for (int i = 0; i < numberOfFuelModels; i++)
+    {
+        if (flameLength[i] > 0.0)
+        {
+            maxRelativeError = std::max(maxRelativeError, fabs(fastFlameLength[i] - flameLength[i]) / flameLength[i]);
+        }
+    }
+    testName = "Test fuel model sweep flame lengths in Fast mode are within the pow error budget";
+    reportTestResult(testInfo, testName, maxRelativeError < 1.0e-13, true, error_tolerance);
+
+    // Outputs left out of the surface fire outputs are written as zero, or one for the length to width ratio
+    sweepRun.surface.setSurfaceFireOutputs(SurfaceFireOutputs::FirelineIntensity);
+    sweepRun.surface.doSurfaceRunForFuelModels(fuelModelNumbers.data(), numberOfFuelModels, outputs);
+    testName = "Test fuel model sweep skips the outputs that were not asked for";
+    reportTestResult(testInfo, testName, firelineIntensity[0] > 0.0 && fastFlameLength[0] == 0.0 && fireLengthToWidthRatio[0] == 1.0,
+        true, error_tolerance);
+
+    std::cout << "Finished testing Surface, fuel model sweep\n\n";
+}
+
+void testSweepTableRunner(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    string testName = "";
+
+    std::cout << "Testing sweep table runner\n";
+    BehaveRun sweepRun(behaveRun);
+    setSurfaceInputsForGS4LowMoistureScenario(sweepRun);
+    sweepRun.surface.setSlope(30.0, SlopeUnits::Percent);
+    sweepRun.surface.setWindDirection(45.0);
+    const WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode = sweepRun.surface.getWindHeightInputMode();
+
+    // Axes added innermost first, so evaluation order differs from the cube layout
+    const double windSpeeds[] = { 0.0, 88.0, 176.0, 264.0, 352.0, 440.0, 528.0, 616.0, 704.0, 792.0, 880.0, 968.0 };
+    const double moisturesOneHour[] = { 0.03, 0.06, 0.09, 0.12 };
+    const double aspects[] = { 0.0, 135.0, 270.0 };
+    const double fuelModelNumbers[] = { 2.0, 124.0, 165.0 };
+    SweepTableRunner runner(sweepRun);
+    runner.addAxis(SweepTableInput::WindSpeed, windSpeeds, 12);
+    runner.addAxis(SweepTableInput::MoistureOneHour, moisturesOneHour, 4);
+    runner.addAxis(SweepTableInput::Aspect, aspects, 3);
+    runner.addAxis(SweepTableInput::FuelModelNumber, fuelModelNumbers, 3);
+    testName = "Test sweep table rejects a second axis over the same input";
+    reportTestResult(testInfo, testName, runner.addAxis(SweepTableInput::Aspect, aspects, 3), false, error_tolerance);
+    testName = "Test sweep table cube has one dimension per axis";
+    reportTestResult(testInfo, testName, runner.getNumberOfAxes() == 4 && runner.getAxisLength(0) == 12 &&
+        runner.getAxisInput(3) == SweepTableInput::FuelModelNumber && runner.getNumberOfCells() == 12 * 4 * 3 * 3 &&
+        runner.getOutputCube(SweepTableOutput::SpreadRate) == nullptr, true, error_tolerance);
+
+    runner.setNumberOfThreads(1);
+    runner.run();
+    std::vector<double> serialSpreadRate(runner.getOutputCube(SweepTableOutput::SpreadRate),
+        runner.getOutputCube(SweepTableOutput::SpreadRate) + runner.getNumberOfCells());
+    std::vector<double> serialFlameLength(runner.getOutputCube(SweepTableOutput::FlameLength),
+        runner.getOutputCube(SweepTableOutput::FlameLength) + runner.getNumberOfCells());
+
+    BehaveRun singleRun(sweepRun);
+    double maxRelativeError = 0.0;
+    for (int wind = 0; wind < 12; wind++)
+    {
+        for (int moisture = 0; moisture < 4; moisture++)
+        {
+            for (int aspect = 0; aspect < 3; aspect++)
+            {
+                for (int fuelModel = 0; fuelModel < 3; fuelModel++)
+                {
+                    singleRun.surface.setFuelModelNumber((int)fuelModelNumbers[fuelModel]);
+                    singleRun.surface.setMoistureOneHour(moisturesOneHour[moisture], FractionUnits::Fraction);
+                    singleRun.surface.setWindSpeed(windSpeeds[wind], SpeedUnits::FeetPerMinute, windHeightInputMode);
+                    singleRun.surface.setAspect(aspects[aspect]);
+                    singleRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+                    const int axisIndices[] = { wind, moisture, aspect, fuelModel };
+                    long cell = runner.getCellIndex(axisIndices);
+                    double expected[] = { singleRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute),
+                        singleRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond),
+                        singleRun.surface.getFlameLength(LengthUnits::Feet), singleRun.surface.getDirectionOfMaxSpread() };
+                    for (int output = 0; output < 4; output++)
+                    {
+                        double observed = runner.getOutput((SweepTableOutput::SweepTableOutputEnum)output, cell);
+                        maxRelativeError = std::max(maxRelativeError, fabs(observed - expected[output]) / std::max(1.0, fabs(expected[output])));
+                    }
+                }
+            }
+        }
+    }
+    testName = "Test sweep table matches a single run of every cell";
+    reportTestResult(testInfo, testName, maxRelativeError < 1.0e-12, true, error_tolerance);
+
+    runner.setNumberOfThreads(4);
+    runner.run();
+    bool isMatchingSerialRun = true;
+    for (long cell = 0; cell < runner.getNumberOfCells(); cell++)
+    {
+        isMatchingSerialRun = isMatchingSerialRun && runner.getOutput(SweepTableOutput::SpreadRate, cell) == serialSpreadRate[cell] &&
+            runner.getOutput(SweepTableOutput::FlameLength, cell) == serialFlameLength[cell];
+    }
+    testName = "Test sweep table is the same on four threads as on one";
+    reportTestResult(testInfo, testName, isMatchingSerialRun, true, error_tolerance);
+
+    // Without axes the table is the prototype's single run
+    runner.clearAxes();
+    runner.run();
+    sweepRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    testName = "Test sweep table without axes is a single run of the prototype's inputs";
+    reportTestResult(testInfo, testName, runner.getNumberOfCells() == 1 &&
+        runner.getOutput(SweepTableOutput::SpreadRate, 0) == sweepRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute), true, error_tolerance);
+
+    std::cout << "Finished testing sweep table runner\n\n";
+}
+
+void testFuelModelStaticConstants(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    string testName = "";
+    FuelModels fuelModels;
+    const int customFuelModelNumber = 14;
+
+    std::cout << "Testing fuel model static fuelbed constants\n";
+
+    // Fuel model 1 only has one hour fuel, so its characteristic SAVR is the one hour SAVR
+    testName = "Test static fuelbed constants sigma for fuel model 1";
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelModels.getStaticFuelbedConstants(1)->sigma_), 3500.0, error_tolerance);
+
+    testName = "Test static fuelbed constants are computed for a static custom fuel model";
+    fuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelModels.getStaticFuelbedConstants(customFuelModelNumber)->reactionVelocity_),
+        roundToSixDecimalPlaces(fuelModels.getStaticFuelbedConstants(1)->reactionVelocity_), error_tolerance);
+
+    testName = "Test static fuelbed constants are not kept for a dynamic custom fuel model";
+    fuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, true);
+    reportTestResult(testInfo, testName, fuelModels.getStaticFuelbedConstants(customFuelModelNumber) == nullptr, true, error_tolerance);
+
+    testName = "Test static fuelbed constants are removed with a cleared custom fuel model";
+    fuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    fuelModels.clearCustomFuelModel(customFuelModelNumber);
+    reportTestResult(testInfo, testName, fuelModels.getStaticFuelbedConstants(customFuelModelNumber) == nullptr, true, error_tolerance);
+
+    // Fuel model 1 has a 3500 ft^2/ft^3 one hour particle and the fixed 109 and 30 ft^2/ft^3 ten and hundred hour ones
+    const FuelModels::SizeClassBins& bins = fuelModels.getFuelbedParameters(1).sizeClassBins_;
+    testName = "Test size class bins sort the one hour particle of fuel model 1";
+    reportTestResult(testInfo, testName, bins.sizeClassDead_[0], 0, error_tolerance);
+    testName = "Test size class bins sort the ten hour particle of fuel model 1";
+    reportTestResult(testInfo, testName, bins.sizeClassDead_[1], 2, error_tolerance);
+    testName = "Test size class bins sort the hundred hour particle of fuel model 1";
+    reportTestResult(testInfo, testName, bins.sizeClassDead_[2], 4, error_tolerance);
+    testName = "Test size class bins leave an empty particle unsorted";
+    reportTestResult(testInfo, testName, bins.sizeClassDead_[4], -1, error_tolerance);
+    testName = "Test size class bins count the dead size classes of fuel model 1";
+    reportTestResult(testInfo, testName, bins.numberOfSizeClasses_[FuelLifeState::Dead], FuelConstants::MaxDeadSizeClasses, error_tolerance);
+    testName = "Test size class bins count no live size classes for fuel model 1";
+    reportTestResult(testInfo, testName, bins.numberOfSizeClasses_[FuelLifeState::Live], 0, error_tolerance);
+
+    testName = "Test size class bins are sorted again when a custom fuel model changes";
+    fuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0.01, 0, LoadingUnits::PoundsPerSquareFoot, 1000, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, true);
+    const FuelModels::SizeClassBins& customBins = fuelModels.getFuelbedParameters(customFuelModelNumber).sizeClassBins_;
+    reportTestResult(testInfo, testName, customBins.sizeClassDead_[0], 1, error_tolerance);
+    testName = "Test size class bins count the live size classes of a custom fuel model";
+    reportTestResult(testInfo, testName, customBins.numberOfSizeClasses_[FuelLifeState::Live], FuelConstants::MaxLiveSizeClasses, error_tolerance);
+    fuelModels.clearCustomFuelModel(customFuelModelNumber);
+
+    // Dynamic fuel models are tabulated by curing level, fuel model gs4(124) is dynamic
+    testName = "Test curing level of a fully cured live herbaceous moisture";
+    reportTestResult(testInfo, testName, FuelModels::getCuringLevel(0.2), 0, error_tolerance);
+    testName = "Test curing level of an uncured live herbaceous moisture";
+    reportTestResult(testInfo, testName, FuelModels::getCuringLevel(1.5), FuelModels::NumberOfCuringLevels - 1, error_tolerance);
+    testName = "Test curing level of a whole percent live herbaceous moisture";
+    reportTestResult(testInfo, testName, FuelModels::getCuringLevel(60.0 / 100.0), 31, error_tolerance);
+    testName = "Test no curing level between two whole percents of live herbaceous moisture";
+    reportTestResult(testInfo, testName, FuelModels::getCuringLevel(0.605), -1, error_tolerance);
+    testName = "Test a dynamic fuel model has no static fuelbed constants";
+    reportTestResult(testInfo, testName, fuelModels.getStaticFuelbedConstants(124) == nullptr, true, error_tolerance);
+    testName = "Test a dynamic fuel model has fuelbed constants at a curing level";
+    reportTestResult(testInfo, testName, fuelModels.getFuelbedConstants(124, 0.6) != nullptr, true, error_tolerance);
+    testName = "Test a dynamic fuel model has no fuelbed constants between curing levels";
+    reportTestResult(testInfo, testName, fuelModels.getFuelbedConstants(124, 0.605) == nullptr, true, error_tolerance);
+
+    // A run at a curing level takes its constants from the table, one just off it calculates them
+    BehaveRun dynamicRun(behaveRun);
+    setSurfaceInputsForGS4LowMoistureScenario(dynamicRun);
+    dynamicRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    double tabulatedSpreadRate = dynamicRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour);
+    dynamicRun.surface.setMoistureLiveHerbaceous(60.000001, FractionUnits::Percent);
+    dynamicRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    double calculatedSpreadRate = dynamicRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour);
+    testName = "Test tabulated curing level constants match the calculated ones";
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(tabulatedSpreadRate), roundToSixDecimalPlaces(calculatedSpreadRate), error_tolerance);
+
+    // Standard records are shared between instances until one of them changes
+    FuelModels standardFuelModels;
+    FuelModels customFuelModels;
+    customFuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    FuelModels copiedCustomFuelModels = customFuelModels;
+    customFuelModels.clearCustomFuelModel(customFuelModelNumber);
+
+    testName = "Test setting a custom fuel model leaves other instances unchanged";
+    reportTestResult(testInfo, testName, standardFuelModels.isFuelModelDefined(customFuelModelNumber), false, error_tolerance);
+
+    testName = "Test a copy keeps its custom fuel model after the original clears it";
+    reportTestResult(testInfo, testName, copiedCustomFuelModels.isFuelModelDefined(customFuelModelNumber), true, error_tolerance);
+
+    testName = "Test instances sharing the standard records have the same revision";
+    reportTestResult(testInfo, testName, standardFuelModels.getRevision() == FuelModels().getRevision(), true, error_tolerance);
+
+    testName = "Test fuel model number from fuel code ignores case";
+    reportTestResult(testInfo, testName, standardFuelModels.getFuelModelNumberFromFuelCode("gr1"), 101, error_tolerance);
+    testName = "Test fuel model number from a copy's custom fuel code";
+    reportTestResult(testInfo, testName, copiedCustomFuelModels.getFuelModelNumberFromFuelCode("c14"), customFuelModelNumber, error_tolerance);
+    testName = "Test fuel model number from a cleared custom fuel code";
+    reportTestResult(testInfo, testName, customFuelModels.getFuelModelNumberFromFuelCode("C14") == -1 &&
+        standardFuelModels.getFuelModelNumberFromFuelCode("C14") == -1, true, error_tolerance);
+
+    const FuelModels::FuelbedParameters& gr2Parameters = standardFuelModels.getFuelbedParameters(102);
+    testName = "Test fuelbed parameters table is cache line aligned";
+    reportTestResult(testInfo, testName, reinterpret_cast<uintptr_t>(&gr2Parameters) % 64 == 0 &&
+        reinterpret_cast<uintptr_t>(&copiedCustomFuelModels.getFuelbedParameters(1)) % 64 == 0, true, error_tolerance);
+    testName = "Test fuelbed parameters match the per value getters";
+    reportTestResult(testInfo, testName, gr2Parameters.fuelLoadLiveHerbaceous_ == standardFuelModels.getFuelLoadLiveHerbaceous(102, LoadingUnits::PoundsPerSquareFoot) &&
+        gr2Parameters.savrOneHour_ == standardFuelModels.getSavrOneHour(102, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet) &&
+        gr2Parameters.fuelbedDepth_ == standardFuelModels.getFuelbedDepth(102, LengthUnits::Feet) && gr2Parameters.isDynamic_, true, error_tolerance);
+    testName = "Test fuelbed parameters of a copy's custom fuel model";
+    reportTestResult(testInfo, testName, copiedCustomFuelModels.getFuelbedParameters(customFuelModelNumber).savrLiveWoody_ > 0.0 &&
+        customFuelModels.getFuelbedParameters(customFuelModelNumber).savrLiveWoody_ == 0.0 &&
+        standardFuelModels.getFuelbedParameters(FuelConstants::MaxFuelModels).fuelbedDepth_ == 0.0, true, error_tolerance);
+
+    std::cout << "Finished testing fuel model static fuelbed constants\n\n";
+}
+
+void testFuelLibrary(TestInfo& testInfo, BehaveRun&)
+{
+    string testName = "";
+    const FuelModels standardFuelModels;
+    const string fileName = "testFuelLibrary.bfuel";
+
+    std::cout << "Testing fuel library\n";
+
+    // Model 300 is fuel model 1 again, model 5124 a copy of the dynamic fuel model gs4(124)
+    std::shared_ptr<FuelLibrary> fuelLibrary = std::make_shared<FuelLibrary>();
+    testName = "Test fuel library rejects a number inside the FuelModels table";
+    reportTestResult(testInfo, testName, fuelLibrary->addFuelModel(FuelLibrary::FirstFuelModelNumber - 1, "BAD", "Bad", 1.0, LengthUnits::Feet,
+        12, FractionUnits::Percent, 8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot,
+        3500, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false), false, error_tolerance);
+    fuelLibrary->addFuelModel(300, "lib1", "Library short grass", 1.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.034, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 3500, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    const int gs4 = 124;
+    fuelLibrary->addFuelModel(5124, "LGS4", "Library gs4", standardFuelModels.getFuelbedDepth(gs4, LengthUnits::Feet), LengthUnits::Feet,
+        standardFuelModels.getMoistureOfExtinctionDead(gs4, FractionUnits::Fraction), FractionUnits::Fraction,
+        standardFuelModels.getHeatOfCombustionDead(gs4, HeatOfCombustionUnits::BtusPerPound),
+        standardFuelModels.getHeatOfCombustionLive(gs4, HeatOfCombustionUnits::BtusPerPound), HeatOfCombustionUnits::BtusPerPound,
+        standardFuelModels.getFuelLoadOneHour(gs4, LoadingUnits::PoundsPerSquareFoot), standardFuelModels.getFuelLoadTenHour(gs4, LoadingUnits::PoundsPerSquareFoot),
+        standardFuelModels.getFuelLoadHundredHour(gs4, LoadingUnits::PoundsPerSquareFoot),
+        standardFuelModels.getFuelLoadLiveHerbaceous(gs4, LoadingUnits::PoundsPerSquareFoot),
+        standardFuelModels.getFuelLoadLiveWoody(gs4, LoadingUnits::PoundsPerSquareFoot), LoadingUnits::PoundsPerSquareFoot,
+        standardFuelModels.getSavrOneHour(gs4, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet),
+        standardFuelModels.getSavrLiveHerbaceous(gs4, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet),
+        standardFuelModels.getSavrLiveWoody(gs4, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet), SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, true);
+
+    testName = "Test fuel library derives the static constants of an added model";
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelLibrary->getFuelbedConstants(300, 0.6)->reactionVelocity_),
+        roundToSixDecimalPlaces(standardFuelModels.getStaticFuelbedConstants(1)->reactionVelocity_), error_tolerance);
+    testName = "Test fuel library tabulates the curing levels of a dynamic model";
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelLibrary->getFuelbedConstants(5124, 0.6)->sigma_),
+        roundToSixDecimalPlaces(standardFuelModels.getFuelbedConstants(gs4, 0.6)->sigma_), error_tolerance);
+    testName = "Test fuel library hashes numbers to slots in order of addition";
+    reportTestResult(testInfo, testName, fuelLibrary->getSlot(5124) == 1 && fuelLibrary->getFuelModelNumber(0) == 300 &&
+        fuelLibrary->getSlot(301) == -1, true, error_tolerance);
+
+    // Saved and loaded back on four threads, with model 300 listed again before a new model 301
+    testName = "Test fuel library saves to a file";
+    reportTestResult(testInfo, testName, fuelLibrary->save(fileName), true, error_tolerance);
+    std::shared_ptr<FuelLibrary> loadedFuelLibrary = std::make_shared<FuelLibrary>();
+    loadedFuelLibrary->addFuelModel(301, "LIB2", "Library model loaded over", 2.0, LengthUnits::Feet, 12, FractionUnits::Percent,
+        8000, 8000, HeatOfCombustionUnits::BtusPerPound, 0.05, 0, 0, 0, 0, LoadingUnits::PoundsPerSquareFoot, 2000, 1500, 1500,
+        SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    testName = "Test fuel library loads a file on four threads";
+    reportTestResult(testInfo, testName, loadedFuelLibrary->load(fileName, 4), true, error_tolerance);
+    testName = "Test fuel library keeps its models not in a loaded file";
+    reportTestResult(testInfo, testName, loadedFuelLibrary->getNumberOfFuelModels() == 3 && loadedFuelLibrary->isFuelModelDefined(301), true, error_tolerance);
+    testName = "Test fuel library loads the values and derives the constants of each model";
+    reportTestResult(testInfo, testName, loadedFuelLibrary->findFuelbedParameters(5124)->savrLiveHerbaceous_ ==
+        fuelLibrary->findFuelbedParameters(5124)->savrLiveHerbaceous_ && loadedFuelLibrary->getFuelName(300) == "Library short grass" &&
+        loadedFuelLibrary->getFuelbedConstants(5124, 1.0)->sigma_ == fuelLibrary->getFuelbedConstants(5124, 1.0)->sigma_ &&
+        loadedFuelLibrary->findFuelbedParameters(300)->sizeClassBins_.numberOfSizeClasses_[FuelLifeState::Dead] == FuelConstants::MaxDeadSizeClasses,
+        true, error_tolerance);
+    std::remove(fileName.c_str());
+    testName = "Test fuel library fails to load a missing file";
+    reportTestResult(testInfo, testName, loadedFuelLibrary->load(fileName) == false && loadedFuelLibrary->getNumberOfFuelModels() == 3, true, error_tolerance);
+
+    FuelModels libraryFuelModels;
+    libraryFuelModels.setFuelLibrary(fuelLibrary);
+    testName = "Test fuel models look up the numbers of an attached fuel library";
+    reportTestResult(testInfo, testName, libraryFuelModels.isFuelModelDefined(300) && !libraryFuelModels.isFuelModelDefined(301) &&
+        libraryFuelModels.getFuelCode(5124) == "LGS4" && libraryFuelModels.getIsDynamic(5124) && !standardFuelModels.isFuelModelDefined(300),
+        true, error_tolerance);
+    testName = "Test fuel models find the code of an attached fuel library model";
+    reportTestResult(testInfo, testName, libraryFuelModels.getFuelModelNumberFromFuelCode("Lib1"), 300, error_tolerance);
+    testName = "Test attaching a fuel library changes the fuel models revision";
+    reportTestResult(testInfo, testName, libraryFuelModels.getRevision() != standardFuelModels.getRevision(), true, error_tolerance);
+
+    // A batch run gives a library model the outputs of the standard model it copies, at and between curing levels
+    SpeciesMasterTable speciesMasterTable;
+    BehaveRun libraryRun(libraryFuelModels, speciesMasterTable);
+    setSurfaceInputsForGS4LowMoistureScenario(libraryRun);
+    const int numberOfCells = 6;
+    int fuelModelNumber[numberOfCells] = { 1, 300, gs4, 5124, gs4, 5124 };
+    double moistureOneHour[numberOfCells] = { 0.06, 0.06, 0.06, 0.06, 0.06, 0.06 };
+    double moistureTenHour[numberOfCells] = { 0.07, 0.07, 0.07, 0.07, 0.07, 0.07 };
+    double moistureHundredHour[numberOfCells] = { 0.08, 0.08, 0.08, 0.08, 0.08, 0.08 };
+    double moistureLiveHerbaceous[numberOfCells] = { 0.60, 0.60, 0.60, 0.60, 0.605, 0.605 };
+    double moistureLiveWoody[numberOfCells] = { 0.90, 0.90, 0.90, 0.90, 0.90, 0.90 };
+    double windSpeed[numberOfCells] = { 440.0, 440.0, 440.0, 440.0, 440.0, 440.0 };
+    double windDirection[numberOfCells] = { 45.0, 45.0, 45.0, 45.0, 45.0, 45.0 };
+    double slope[numberOfCells] = { 30.0, 30.0, 30.0, 30.0, 30.0, 30.0 };
+    double aspect[numberOfCells] = { 95.0, 95.0, 95.0, 95.0, 95.0, 95.0 };
+    double canopyCover[numberOfCells] = { 0.50, 0.50, 0.50, 0.50, 0.50, 0.50 };
+    double canopyHeight[numberOfCells] = { 30.0, 30.0, 30.0, 30.0, 30.0, 30.0 };
+    double crownRatio[numberOfCells] = { 0.50, 0.50, 0.50, 0.50, 0.50, 0.50 };
+    SurfaceBatchInputs inputs = { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour, moistureHundredHour,
+        moistureLiveHerbaceous, moistureLiveWoody, windSpeed, windDirection, slope, aspect, canopyCover, canopyHeight, crownRatio };
+    double spreadRate[numberOfCells];
+    double flameLength[numberOfCells];
+    SurfaceBatchOutputs outputs = { spreadRate, nullptr, flameLength, nullptr, nullptr };
+    libraryRun.surface.doSurfaceRunBatch(inputs, outputs);
+    for (int i = 0; i < numberOfCells; i += 2)
+    {
+        testName = "Test batch spread rate of fuel library model " + std::to_string(fuelModelNumber[i + 1]) + " at " +
+            std::to_string(moistureLiveHerbaceous[i]) + " live herbaceous moisture";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(spreadRate[i + 1]), roundToSixDecimalPlaces(spreadRate[i]), error_tolerance);
+    }
+    testName = "Test batch flame length of a fuel library model is nonzero";
+    reportTestResult(testInfo, testName, flameLength[1] > 0.0 && flameLength[1] == flameLength[0], true, error_tolerance);
+
+    std::cout << "Finished testing fuel library\n\n";
+}
+
 void testChaparral(TestInfo& testInfo, BehaveRun& behaveRun)
 {
     std::string testName = "";
@@ -611,8 +1501,6 @@ void testPalmettoGallberry(TestInfo& testInfo, BehaveRun& behaveRun)
     SpeedUnits::SpeedUnitsEnum windSpeedUnits = SpeedUnits::MilesPerHour;
     double windDirection = 0;
     WindAndSpreadOrientationMode::WindAndSpreadOrientationModeEnum windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToUpslope;
-    double firstFuelModelCoverage = 0;
-    FractionUnits::FractionUnitsEnum firstFuelModelCoverageUnits = FractionUnits::Percent;
     double slope = 30.0;
     SlopeUnits::SlopeUnitsEnum slopeUnits = SlopeUnits::Percent;
     double aspect = 0;
@@ -686,6 +1574,94 @@ void testWesternAspen(TestInfo& testInfo, BehaveRun& behaveRun)
     behaveRun.surface.setIsUsingWesternAspen(false);
 }
 
+void testSurfaceFuelbedTypes(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing Surface, fuelbed types\n";
+    string testName = "";
+
+    // Each fuelbed type has its own fuelbed builder, so each is checked against its known fuelbed intermediates
+    auto reportFuelbed = [&testInfo, &testName](BehaveRun& fuelbedRun, const string& fuelbedName, double expectedBulkDensity,
+        double expectedPackingRatio, double expectedCharacteristicSAVR, double expectedHeatSink, double expectedReactionIntensity,
+        double expectedSpreadRate)
+    {
+        fuelbedRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        testName = "Test " + fuelbedName + " fuelbed bulk density";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelbedRun.surface.getBulkDensity(DensityUnits::PoundsPerCubicFoot)),
+            expectedBulkDensity, error_tolerance);
+        testName = "Test " + fuelbedName + " fuelbed packing ratio";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelbedRun.surface.getPackingRatio()), expectedPackingRatio, error_tolerance);
+        testName = "Test " + fuelbedName + " fuelbed characteristic SAVR";
+        reportTestResult(testInfo, testName,
+            roundToSixDecimalPlaces(fuelbedRun.surface.getCharacteristicSAVR(SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet)),
+            expectedCharacteristicSAVR, error_tolerance);
+        testName = "Test " + fuelbedName + " fuelbed heat sink";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelbedRun.surface.getHeatSink(HeatSinkUnits::BtusPerCubicFoot)),
+            expectedHeatSink, error_tolerance);
+        testName = "Test " + fuelbedName + " fuelbed reaction intensity";
+        reportTestResult(testInfo, testName,
+            roundToSixDecimalPlaces(fuelbedRun.surface.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute)),
+            expectedReactionIntensity, error_tolerance);
+        testName = "Test " + fuelbedName + " fuelbed spread rate";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fuelbedRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour)),
+            expectedSpreadRate, error_tolerance);
+    };
+
+    {
+        BehaveRun standardRun(behaveRun);
+        setSurfaceInputsForGS4LowMoistureScenario(standardRun);
+        standardRun.surface.setFuelModelNumber(4); // static
+        reportFuelbed(standardRun, "standard static", 0.122667, 0.003833, 1739.237831, 78.932393, 11999.537013, 21.890495);
+    }
+
+    {
+        BehaveRun dynamicRun(behaveRun);
+        setSurfaceInputsForGS4LowMoistureScenario(dynamicRun);
+        reportFuelbed(dynamicRun, "standard dynamic", 0.279855, 0.008745, 1631.128734, 230.214011, 15618.346005, 8.876216);
+    }
+
+    {
+        // The intermediates are the second fuel model's, the last one run
+        BehaveRun twoFuelModelsRun(behaveRun);
+        setSurfaceInputsForTwoFuelModelsLowMoistureScenario(twoFuelModelsRun);
+        twoFuelModelsRun.surface.setTwoFuelModelsMethod(TwoFuelModelsMethod::Arithmetic);
+        twoFuelModelsRun.surface.setTwoFuelModelsFirstFuelModelCoverage(40.0, FractionUnits::Percent);
+        reportFuelbed(twoFuelModelsRun, "two fuel models", 0.279855, 0.008745, 1631.128734, 230.214011, 15618.346005, 14.114217);
+    }
+
+    {
+        BehaveRun chaparralRun(behaveRun);
+        setSurfaceInputsForGS4LowMoistureScenario(chaparralRun);
+        chaparralRun.surface.setIsUsingChaparral(true);
+        chaparralRun.surface.setChaparralFuelBedDepth(2.0, LengthUnits::Feet);
+        chaparralRun.surface.setChaparralFuelType(ChaparralFuelType::Chamise);
+        chaparralRun.surface.setChaparralFuelLoadInputMode(ChaparralFuelLoadInputMode::FuelLoadFromDepthAndChaparralType);
+        chaparralRun.surface.setChaparralFuelDeadLoadFraction(0.33);
+        reportFuelbed(chaparralRun, "chaparral", 0.098623, 0.002174, 1033.431521, 65.573188, 750.502099, 1.848493);
+    }
+
+    {
+        BehaveRun palmettoGallberryRun(behaveRun);
+        palmettoGallberryRun.surface.setIsUsingPalmettoGallberry(true);
+        palmettoGallberryRun.surface.updateSurfaceInputsForPalmettoGallbery(6.0, 7.0, 8.0, 60.0, 90.0, FractionUnits::Percent, 5.0,
+            SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 10, 4, 50, 50,
+            BasalAreaUnits::SquareFeetPerAcre, 30.0, SlopeUnits::Percent, 0, 50, FractionUnits::Percent, 30.0, LengthUnits::Feet, 0.5,
+            FractionUnits::Fraction);
+        reportFuelbed(palmettoGallberryRun, "palmetto-gallberry", 0.115085, 0.003041, 1864.664423, 61.119228, 5004.915387, 12.521131);
+    }
+
+    {
+        BehaveRun westernAspenRun(behaveRun);
+        westernAspenRun.surface.setIsUsingWesternAspen(true);
+        westernAspenRun.surface.updateSurfaceInputsForWesternAspen(3, 50.0, FractionUnits::Percent, AspenFireSeverity::Low, 10.0,
+            LengthUnits::Inches, 6.0, 7.0, 8.0, 60.0, 90.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, 0, WindAndSpreadOrientationMode::RelativeToNorth, 30.0, SlopeUnits::Percent, 0, 50,
+            FractionUnits::Percent, 30.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+        reportFuelbed(westernAspenRun, "western aspen", 0.454290, 0.014197, 1674.855026, 164.553826, 1014.745220, 0.847629);
+    }
+
+    std::cout << "Finished testing Surface, fuelbed types\n\n";
+}
+
 void testLengthToWidthRatio(TestInfo& testInfo, BehaveRun& behaveRun)
 {
     std::cout << "Testing length-to-width-ratio\n";
@@ -758,7 +1734,7 @@ void testLengthToWidthRatio(TestInfo& testInfo, BehaveRun& behaveRun)
     behaveRun.crown.doCrownRunRothermel();
     expectedCrownLengthToWidthRatio = 1.625;
     observedCrownLengthToWidthRatio = roundToSixDecimalPlaces(behaveRun.crown.getCrownFireLengthToWidthRatio());
-    reportTestResult(testInfo, testName, observedLengthToWidthRatio, expectedLengthToWidthRatio, error_tolerance);
+    reportTestResult(testInfo, testName, observedCrownLengthToWidthRatio, expectedCrownLengthToWidthRatio, error_tolerance);
 
     testName = "Test crown fire length-to-width-ratio, 10 mph 20 foot wind";
     setCrownInputsLowMoistureScenario(behaveRun);
@@ -766,7 +1742,7 @@ void testLengthToWidthRatio(TestInfo& testInfo, BehaveRun& behaveRun)
     behaveRun.crown.doCrownRunRothermel();
     expectedCrownLengthToWidthRatio = 2.25;
     observedCrownLengthToWidthRatio = roundToSixDecimalPlaces(behaveRun.crown.getCrownFireLengthToWidthRatio());
-    reportTestResult(testInfo, testName, observedLengthToWidthRatio, expectedLengthToWidthRatio, error_tolerance);
+    reportTestResult(testInfo, testName, observedCrownLengthToWidthRatio, expectedCrownLengthToWidthRatio, error_tolerance);
 
     testName = "Test crown fire length-to-width-ratio, 15 mph 20 foot wind";
     setCrownInputsLowMoistureScenario(behaveRun);
@@ -774,7 +1750,7 @@ void testLengthToWidthRatio(TestInfo& testInfo, BehaveRun& behaveRun)
     behaveRun.crown.doCrownRunRothermel();
     expectedCrownLengthToWidthRatio = 2.875;
     observedCrownLengthToWidthRatio = roundToSixDecimalPlaces(behaveRun.crown.getCrownFireLengthToWidthRatio());
-    reportTestResult(testInfo, testName, observedLengthToWidthRatio, expectedLengthToWidthRatio, error_tolerance);
+    reportTestResult(testInfo, testName, observedCrownLengthToWidthRatio, expectedCrownLengthToWidthRatio, error_tolerance);
 
     std::cout << "Finished testing length-to-width-ratio\n\n";
 }
@@ -932,6 +1908,87 @@ void testDirectionOfInterest(TestInfo& testInfo, BehaveRun& behaveRun)
     expectedSpreadRateInDirectionOfInterest = 2.944975;
     reportTestResult(testInfo, testName, observedSpreadRateInDirectionOfInterest, expectedSpreadRateInDirectionOfInterest, error_tolerance);
 
+    // A sweep must match the single direction runs, including directions outside of [0, 360)
+    const int numberOfDirections = 3;
+    double directionsOfInterest[numberOfDirections] = { 285, -75, 645 };
+    double spreadRates[numberOfDirections];
+    double firelineIntensities[numberOfDirections];
+    double flameLengths[numberOfDirections];
+    behaveRun.surface.doSurfaceRunInDirectionsOfInterest(directionsOfInterest, numberOfDirections, surfaceFireSpreadDirectionMode,
+        spreadRates, firelineIntensities, flameLengths);
+    for (int i = 0; i < numberOfDirections; i++)
+    {
+        testName = "Test direction sweep from ignition point, direction of interest " + std::to_string(static_cast<int>(directionsOfInterest[i])) + " degrees from north";
+        observedSpreadRateInDirectionOfInterest = roundToSixDecimalPlaces(SpeedUnits::fromBaseUnits(spreadRates[i], SpeedUnits::ChainsPerHour));
+        reportTestResult(testInfo, testName, observedSpreadRateInDirectionOfInterest, expectedSpreadRateInDirectionOfInterest, error_tolerance);
+    }
+
+    surfaceFireSpreadDirectionMode = SurfaceFireSpreadDirectionMode::FromPerimeter;
+    behaveRun.surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
+    behaveRun.surface.setWindDirection(0);
+    behaveRun.surface.setAspect(0);
+    directionsOfInterest[0] = 90;
+    directionsOfInterest[1] = 270;
+    directionsOfInterest[2] = -90;
+    behaveRun.surface.doSurfaceRunInDirectionsOfInterest(directionsOfInterest, numberOfDirections, surfaceFireSpreadDirectionMode,
+        spreadRates, firelineIntensities, flameLengths);
+    for (int i = 0; i < numberOfDirections; i++)
+    {
+        testName = "Test direction sweep from perimeter, direction of interest " + std::to_string(static_cast<int>(directionsOfInterest[i])) + " degrees from upslope";
+        observedSpreadRateInDirectionOfInterest = roundToSixDecimalPlaces(spreadRates[i]);
+        reportTestResult(testInfo, testName, observedSpreadRateInDirectionOfInterest, 5.596433, error_tolerance);
+        testName = "Test direction sweep from perimeter flame length, direction of interest " + std::to_string(static_cast<int>(directionsOfInterest[i])) + " degrees from upslope";
+        observedFlameLengthInDirectionOfInterest = roundToSixDecimalPlaces(flameLengths[i]);
+        reportTestResult(testInfo, testName, observedFlameLengthInDirectionOfInterest, 6.598148, error_tolerance);
+    }
+
+    testName = "Test direction sweep fireline intensity matches single direction run";
+    behaveRun.surface.doSurfaceRunInDirectionOfInterest(directionsOfInterest[0], surfaceFireSpreadDirectionMode);
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(firelineIntensities[0]),
+        roundToSixDecimalPlaces(behaveRun.surface.getFirelineIntensityInDirectionOfInterest(FirelineIntensityUnits::BtusPerFootPerSecond)), error_tolerance);
+
+    // The vectorized kernels must give the same results at the test tolerance
+    behaveRun.surface.setVectorMathMode(VectorMathMode::Fast);
+    behaveRun.surface.doSurfaceRunInDirectionsOfInterest(directionsOfInterest, numberOfDirections, surfaceFireSpreadDirectionMode,
+        spreadRates, firelineIntensities, flameLengths);
+    for (int i = 0; i < numberOfDirections; i++)
+    {
+        testName = "Test fast math direction sweep from perimeter, direction of interest " + std::to_string(static_cast<int>(directionsOfInterest[i])) + " degrees from upslope";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(spreadRates[i]), 5.596433, error_tolerance);
+        testName = "Test fast math direction sweep from perimeter flame length, direction of interest " + std::to_string(static_cast<int>(directionsOfInterest[i])) + " degrees from upslope";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(flameLengths[i]), 6.598148, error_tolerance);
+    }
+    const int numberOfSweepDirections = 73;
+    double sweepDirections[numberOfSweepDirections];
+    double exactSpreadRates[numberOfSweepDirections];
+    double exactFlameLengths[numberOfSweepDirections];
+    double fastSpreadRates[numberOfSweepDirections];
+    double fastFlameLengths[numberOfSweepDirections];
+    for (int i = 0; i < numberOfSweepDirections; i++)
+    {
+        sweepDirections[i] = i * 5.0;
+    }
+    const SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum sweepDirectionModes[] =
+        { SurfaceFireSpreadDirectionMode::FromIgnitionPoint, SurfaceFireSpreadDirectionMode::FromPerimeter };
+    double maxSweepDeviation = 0.0;
+    for (SurfaceFireSpreadDirectionMode::SurfaceFireSpreadDirectionModeEnum sweepDirectionMode : sweepDirectionModes)
+    {
+        behaveRun.surface.setVectorMathMode(VectorMathMode::Exact);
+        behaveRun.surface.doSurfaceRunInDirectionsOfInterest(sweepDirections, numberOfSweepDirections, sweepDirectionMode,
+            exactSpreadRates, nullptr, exactFlameLengths);
+        behaveRun.surface.setVectorMathMode(VectorMathMode::Fast);
+        behaveRun.surface.doSurfaceRunInDirectionsOfInterest(sweepDirections, numberOfSweepDirections, sweepDirectionMode,
+            fastSpreadRates, nullptr, fastFlameLengths);
+        for (int i = 0; i < numberOfSweepDirections; i++)
+        {
+            maxSweepDeviation = std::max(maxSweepDeviation, fabs(fastSpreadRates[i] - exactSpreadRates[i]) / exactSpreadRates[i]);
+            maxSweepDeviation = std::max(maxSweepDeviation, fabs(fastFlameLengths[i] - exactFlameLengths[i]) / exactFlameLengths[i]);
+        }
+    }
+    behaveRun.surface.setVectorMathMode(VectorMathMode::Exact);
+    testName = "Test fast math direction sweep is within 1e-12 of the exact sweep";
+    reportTestResult(testInfo, testName, maxSweepDeviation < 1.0e-12, true, error_tolerance);
+
     std::cout << "Finished testing spread rate in direction of interest\n\n";
 }
 
@@ -1050,6 +2107,210 @@ void testTwoFuelModels(TestInfo& testInfo, BehaveRun& behaveRun)
     expectedSurfaceFireSpreadRate = 21.971217;
     reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
 
+    // Per fuel model results from the cache must give the same weighted outputs for every coverage and method
+    setSurfaceInputsForTwoFuelModelsLowMoistureScenario(behaveRun);
+    Surface cachedSurface = behaveRun.surface;
+    cachedSurface.setTwoFuelModelsCacheCapacity(8);
+    const TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethods[] =
+        { TwoFuelModelsMethod::Arithmetic, TwoFuelModelsMethod::Harmonic, TwoFuelModelsMethod::TwoDimensional };
+    int numCachedTwoFuelModelsMismatches = 0;
+    for(TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod : twoFuelModelsMethods)
+    {
+        behaveRun.surface.setTwoFuelModelsMethod(twoFuelModelsMethod);
+        cachedSurface.setTwoFuelModelsMethod(twoFuelModelsMethod);
+        for(int coverage = 0; coverage <= 100; coverage += 10)
+        {
+            behaveRun.surface.setTwoFuelModelsFirstFuelModelCoverage(coverage, coverUnits);
+            cachedSurface.setTwoFuelModelsFirstFuelModelCoverage(coverage, coverUnits);
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            cachedSurface.doSurfaceRunInDirectionOfMaxSpread();
+            numCachedTwoFuelModelsMismatches +=
+                (cachedSurface.getSpreadRate(SpeedUnits::FeetPerMinute) != behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute)) ||
+                (cachedSurface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond) !=
+                    behaveRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond)) ||
+                (cachedSurface.getFlameLength(LengthUnits::Feet) != behaveRun.surface.getFlameLength(LengthUnits::Feet)) ||
+                (cachedSurface.getFireLengthToWidthRatio() != behaveRun.surface.getFireLengthToWidthRatio()) ||
+                (cachedSurface.getDirectionOfMaxSpread() != behaveRun.surface.getDirectionOfMaxSpread());
+        }
+    }
+    testName = "Test two fuel models cache gives the same outputs for every coverage and method";
+    reportTestResult(testInfo, testName, numCachedTwoFuelModelsMismatches, 0, error_tolerance);
+    testName = "Test two fuel models cache only calculates each fuel model once";
+    reportTestResult(testInfo, testName, cachedSurface.getTwoFuelModelsCacheNumberOfMisses(), 2, error_tolerance);
+    testName = "Test two fuel models cache hits for the rest of the sweep";
+    reportTestResult(testInfo, testName, cachedSurface.getTwoFuelModelsCacheNumberOfHits(), 3 * 11 * 2 - 2, error_tolerance);
+    cachedSurface.setWindSpeed(10.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    cachedSurface.doSurfaceRunInDirectionOfMaxSpread();
+    testName = "Test two fuel models cache misses when the wind changes";
+    reportTestResult(testInfo, testName, cachedSurface.getTwoFuelModelsCacheNumberOfMisses(), 4, error_tolerance);
+
+    // The interpolated two dimensional spread rate must stay within 0.5% of the exact one
+    setSurfaceInputsForTwoFuelModelsLowMoistureScenario(behaveRun);
+    behaveRun.surface.setTwoFuelModelsMethod(TwoFuelModelsMethod::TwoDimensional);
+    Surface interpolatedSurface = behaveRun.surface;
+    interpolatedSurface.setTwoDimensionalSpreadMode(TwoDimensionalSpreadMode::Interpolated);
+    const int twoDimensionalSecondFuelModels[] = { 124, 8, 1 };
+    double maxTwoDimensionalRelativeError = 0.0;
+    for(int secondFuelModel : twoDimensionalSecondFuelModels)
+    {
+        behaveRun.surface.setSecondFuelModelNumber(secondFuelModel);
+        interpolatedSurface.setSecondFuelModelNumber(secondFuelModel);
+        for(double windSpeed = 0.0; windSpeed <= 15.0; windSpeed += 5.0)
+        {
+            behaveRun.surface.setWindSpeed(windSpeed, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+            interpolatedSurface.setWindSpeed(windSpeed, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+            for(int coverage = 0; coverage <= 100; coverage += 5)
+            {
+                behaveRun.surface.setTwoFuelModelsFirstFuelModelCoverage(coverage, coverUnits);
+                interpolatedSurface.setTwoFuelModelsFirstFuelModelCoverage(coverage, coverUnits);
+                behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+                interpolatedSurface.doSurfaceRunInDirectionOfMaxSpread();
+                double exactSpreadRate = behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+                double interpolatedSpreadRate = interpolatedSurface.getSpreadRate(SpeedUnits::FeetPerMinute);
+                if(exactSpreadRate > 0.0)
+                {
+                    maxTwoDimensionalRelativeError = std::max(maxTwoDimensionalRelativeError,
+                        fabs(interpolatedSpreadRate - exactSpreadRate) / exactSpreadRate);
+                }
+            }
+        }
+    }
+    testName = "Test interpolated two dimensional spread rate is within 0.5% of the exact one";
+    reportTestResult(testInfo, testName, maxTwoDimensionalRelativeError < 0.005, true, error_tolerance);
+    testName = "Test interpolated two dimensional spread rate builds table nodes on demand";
+    int numberOfTableNodesBuilt = SurfaceTwoDimensionalSpreadTable::getSharedTable().getNumberOfNodesBuilt();
+    reportTestResult(testInfo, testName, numberOfTableNodesBuilt > 0 && numberOfTableNodesBuilt <
+        SurfaceTwoDimensionalSpreadTable::NumberOfRelativeSpreadRateNodes * SurfaceTwoDimensionalSpreadTable::NumberOfLengthToBreadthRatioNodes,
+        true, error_tolerance);
+
+    // Runs on several threads share the table, each must match the same run on its own
+    const int numberOfTableThreads = 4;
+    std::vector<double> threadedSpreadRates(numberOfTableThreads * 21);
+    std::vector<double> serialSpreadRates(numberOfTableThreads * 21);
+    std::vector<std::thread> tableThreads;
+    for(int t = 0; t < numberOfTableThreads; t++)
+    {
+        tableThreads.push_back(std::thread([&, t]()
+        {
+            Surface threadSurface = interpolatedSurface;
+            threadSurface.setWindSpeed(2.0 + 3.0 * t, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+            for(int i = 0; i <= 20; i++)
+            {
+                threadSurface.setTwoFuelModelsFirstFuelModelCoverage(5 * i, coverUnits);
+                threadSurface.doSurfaceRunInDirectionOfMaxSpread();
+                threadedSpreadRates[t * 21 + i] = threadSurface.getSpreadRate(SpeedUnits::FeetPerMinute);
+            }
+        }));
+    }
+    for(std::thread& tableThread : tableThreads)
+    {
+        tableThread.join();
+    }
+    for(int t = 0; t < numberOfTableThreads; t++)
+    {
+        interpolatedSurface.setWindSpeed(2.0 + 3.0 * t, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+        for(int i = 0; i <= 20; i++)
+        {
+            interpolatedSurface.setTwoFuelModelsFirstFuelModelCoverage(5 * i, coverUnits);
+            interpolatedSurface.doSurfaceRunInDirectionOfMaxSpread();
+            serialSpreadRates[t * 21 + i] = interpolatedSurface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        }
+    }
+    testName = "Test interpolated two dimensional spread rate is the same from several threads";
+    reportTestResult(testInfo, testName, threadedSpreadRates == serialSpreadRates, true, error_tolerance);
+
+    // The two fuel models batch must match running each cell on its own
+    const int numberOfCells = 60;
+    const int batchFirstFuelModels[] = { 1, 2, 124, 165 };
+    const int batchSecondFuelModels[] = { 124, 10, 102, 4 };
+    std::vector<int> batchFirstFuelModelNumber(numberOfCells);
+    std::vector<int> batchSecondFuelModelNumber(numberOfCells);
+    std::vector<double> batchFirstFuelModelCoverage(numberOfCells);
+    std::vector<double> batchMoistureOneHour(numberOfCells);
+    std::vector<double> batchMoistureTenHour(numberOfCells, 0.07);
+    std::vector<double> batchMoistureHundredHour(numberOfCells, 0.08);
+    std::vector<double> batchMoistureLiveHerbaceous(numberOfCells, 0.6);
+    std::vector<double> batchMoistureLiveWoody(numberOfCells, 0.9);
+    std::vector<double> batchWindSpeed(numberOfCells);
+    std::vector<double> batchWindDirection(numberOfCells, 0.0);
+    std::vector<double> batchSlope(numberOfCells, 15.0);
+    std::vector<double> batchAspect(numberOfCells, 0.0);
+    std::vector<double> batchCanopyCover(numberOfCells, 0.5);
+    std::vector<double> batchCanopyHeight(numberOfCells, 30.0);
+    std::vector<double> batchCrownRatio(numberOfCells, 0.5);
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        batchFirstFuelModelNumber[i] = batchFirstFuelModels[i % 4];
+        batchSecondFuelModelNumber[i] = batchSecondFuelModels[i % 4];
+        batchFirstFuelModelCoverage[i] = (i % 11) / 10.0;
+        batchMoistureOneHour[i] = 0.04 + (i / 20) * 0.02;
+        batchWindSpeed[i] = SpeedUnits::toBaseUnits(5.0 + (i / 30) * 5.0, SpeedUnits::MilesPerHour);
+    }
+    SurfaceBatchInputs twoFuelModelsBatchInputs = { numberOfCells, batchFirstFuelModelNumber.data(), batchMoistureOneHour.data(),
+        batchMoistureTenHour.data(), batchMoistureHundredHour.data(), batchMoistureLiveHerbaceous.data(), batchMoistureLiveWoody.data(),
+        batchWindSpeed.data(), batchWindDirection.data(), batchSlope.data(), batchAspect.data(), batchCanopyCover.data(),
+        batchCanopyHeight.data(), batchCrownRatio.data() };
+    std::vector<double> batchSpreadRate(numberOfCells);
+    std::vector<double> batchFlameLength(numberOfCells);
+    SurfaceBatchOutputs twoFuelModelsBatchOutputs = { batchSpreadRate.data(), nullptr, batchFlameLength.data(), nullptr, nullptr };
+    cachedSurface.clearTwoFuelModelsCache();
+    cachedSurface.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+    cachedSurface.setTwoFuelModelsMethod(TwoFuelModelsMethod::Arithmetic);
+    cachedSurface.doSurfaceRunBatchTwoFuelModels(twoFuelModelsBatchInputs, batchSecondFuelModelNumber.data(),
+        batchFirstFuelModelCoverage.data(), twoFuelModelsBatchOutputs);
+    int numTwoFuelModelsBatchMismatches = 0;
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        behaveRun.surface.updateSurfaceInputsForTwoFuelModels(batchFirstFuelModelNumber[i], batchSecondFuelModelNumber[i],
+            batchMoistureOneHour[i], 0.07, 0.08, 0.6, 0.9, FractionUnits::Fraction, batchWindSpeed[i], SpeedUnits::FeetPerMinute,
+            WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, batchFirstFuelModelCoverage[i],
+            FractionUnits::Fraction, TwoFuelModelsMethod::Arithmetic, 15.0, SlopeUnits::Degrees, 0.0, 0.5, FractionUnits::Fraction,
+            30.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+        behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+        numTwoFuelModelsBatchMismatches += (fabs(batchSpreadRate[i] - behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute)) > 1.0e-9) ||
+            (fabs(batchFlameLength[i] - behaveRun.surface.getFlameLength(LengthUnits::Feet)) > 1.0e-9);
+    }
+    testName = "Test two fuel models batch agrees with single cells";
+    reportTestResult(testInfo, testName, numTwoFuelModelsBatchMismatches, 0, error_tolerance);
+    // Four sets of moisture and wind, each with seven different fuel models as 124 is in two pairs
+    testName = "Test two fuel models batch calculates each fuel model once per set of conditions";
+    reportTestResult(testInfo, testName, cachedSurface.getTwoFuelModelsCacheNumberOfMisses(), 4 * 7, error_tolerance);
+
+    // A coverage sweep runs both fuel models once and must match running each coverage on its own
+    setSurfaceInputsForTwoFuelModelsLowMoistureScenario(behaveRun);
+    Surface sweepSurface = behaveRun.surface;
+    const int numberOfCoverages = 11;
+    std::vector<double> sweepCoverages(numberOfCoverages);
+    for(int i = 0; i < numberOfCoverages; i++)
+    {
+        sweepCoverages[i] = i * 10.0;
+    }
+    std::vector<double> sweepSpreadRate(numberOfCoverages);
+    std::vector<double> sweepFirelineIntensity(numberOfCoverages);
+    std::vector<double> sweepFlameLength(numberOfCoverages);
+    int numCoverageSweepMismatches = 0;
+    for(TwoFuelModelsMethod::TwoFuelModelsMethodEnum twoFuelModelsMethod : twoFuelModelsMethods)
+    {
+        behaveRun.surface.setTwoFuelModelsMethod(twoFuelModelsMethod);
+        sweepSurface.setTwoFuelModelsMethod(twoFuelModelsMethod);
+        sweepSurface.doSurfaceRunForFirstFuelModelCoverages(sweepCoverages.data(), numberOfCoverages, coverUnits,
+            sweepSpreadRate.data(), sweepFirelineIntensity.data(), sweepFlameLength.data());
+        for(int i = 0; i < numberOfCoverages; i++)
+        {
+            behaveRun.surface.setTwoFuelModelsFirstFuelModelCoverage(sweepCoverages[i], coverUnits);
+            behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+            numCoverageSweepMismatches += (sweepSpreadRate[i] != behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute)) ||
+                (sweepFirelineIntensity[i] != behaveRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond)) ||
+                (sweepFlameLength[i] != behaveRun.surface.getFlameLength(LengthUnits::Feet));
+        }
+    }
+    testName = "Test two fuel models coverage sweep agrees with single coverages";
+    reportTestResult(testInfo, testName, numCoverageSweepMismatches, 0, error_tolerance);
+    testName = "Test two fuel models coverage sweep reports the last coverage";
+    observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(sweepSurface.getSpreadRate(SpeedUnits::ChainsPerHour));
+    expectedSurfaceFireSpreadRate = roundToSixDecimalPlaces(behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour));
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+
     std::cout << "Finished testing Two Fuel Models, first fuel model 1, second fuel model 124\n\n";
 }
 
@@ -1101,7 +2362,7 @@ void testCrownModuleRothermel(TestInfo& testInfo, BehaveRun& behaveRun)
     testName = "Test crown fire Rothermel perimeter";
     expectedCrownFirePerimeter = 26.033937;
     observedCrownFirePerimeter = roundToSixDecimalPlaces(behaveRun.crown.getCrownFirePerimeter(LengthUnits::Chains, 1.0, TimeUnits::Hours));
-    reportTestResult(testInfo, testName, observedCrownFireArea, expectedCrownFireArea, error_tolerance);
+    reportTestResult(testInfo, testName, observedCrownFirePerimeter, expectedCrownFirePerimeter, error_tolerance);
 
     testName = "Test crown fire Rothermel flame length";
     expectedCrownFlameLength = 29.320557;
@@ -1143,7 +2404,7 @@ void testCrownModuleRothermel(TestInfo& testInfo, BehaveRun& behaveRun)
     canopyBaseHeight = 30;
     behaveRun.crown.setCanopyBaseHeight(canopyBaseHeight, LengthUnits::Feet);
     canopyBulkDensity = 0.06;
-    behaveRun.crown.setCanopyBulkDensity(0.06, DensityUnits::PoundsPerCubicFoot);
+    behaveRun.crown.setCanopyBulkDensity(canopyBulkDensity, DensityUnits::PoundsPerCubicFoot);
     behaveRun.crown.setWindSpeed(5, windSpeedUnits, windHeightInputMode);
     behaveRun.crown.doCrownRunRothermel();
     expectedFireType = (int)FireType::ConditionalCrownFire;
@@ -1415,9 +2676,283 @@ void testSpotModule(TestInfo& testInfo, BehaveRun& behaveRun)
     observedFlatSpottingDistance = roundToSixDecimalPlaces(behaveRun.spot.getMaxFlatTerrainSpottingDistanceFromTorchingTrees(spottingDistanceUnits));
     reportTestResult(testInfo, testName, observedFlatSpottingDistance, expectedFlatSpottingDistance, error_tolerance);
 
+    // The batch calculations must match running each source through a fresh Spot
+    const int numberOfSources = 2500;
+    std::vector<double> batchFlameHeight(numberOfSources);
+    std::vector<int> batchTorchingTrees(numberOfSources);
+    std::vector<double> batchDBH(numberOfSources);
+    std::vector<double> batchTreeHeight(numberOfSources);
+    std::vector<SpotTreeSpecies::SpotTreeSpeciesEnum> batchTreeSpecies(numberOfSources);
+    std::vector<double> batchWindSpeed(numberOfSources);
+    std::vector<double> batchCoverHeight(numberOfSources);
+    std::vector<SpotDownWindCanopyMode::SpotDownWindCanopyModeEnum> batchCanopyMode(numberOfSources);
+    std::vector<SpotFireLocation::SpotFireLocationEnum> batchLocation(numberOfSources);
+    std::vector<double> batchRidgeToValleyDistance(numberOfSources);
+    std::vector<double> batchRidgeToValleyElevation(numberOfSources);
+    for(int i = 0; i < numberOfSources; i++)
+    {
+        batchFlameHeight[i] = (i % 11) * 2.5;
+        batchTorchingTrees[i] = i % 20;
+        batchDBH[i] = 4.0 + (i * 7 % 30);
+        batchTreeHeight[i] = 20.0 + (i * 13 % 90);
+        batchTreeSpecies[i] = (SpotTreeSpecies::SpotTreeSpeciesEnum)(i % 14);
+        batchWindSpeed[i] = SpeedUnits::toBaseUnits((i % 13) * 2.0, SpeedUnits::MilesPerHour);
+        batchCoverHeight[i] = (i * 3 % 70) * 1.5;
+        batchCanopyMode[i] = (i % 3 == 0) ? SpotDownWindCanopyMode::OPEN : SpotDownWindCanopyMode::CLOSED;
+        batchLocation[i] = (SpotFireLocation::SpotFireLocationEnum)(i % 4);
+        batchRidgeToValleyDistance[i] = LengthUnits::toBaseUnits(0.25 + (i % 9) * 0.5, LengthUnits::Miles);
+        batchRidgeToValleyElevation[i] = (i * 17 % 5) * 750.0;
+    }
+    SpotBatchInputs spotBatchInputs;
+    spotBatchInputs.numberOfSources = numberOfSources;
+    spotBatchInputs.burningPileFlameHeight = batchFlameHeight.data();
+    spotBatchInputs.flameLength = batchFlameHeight.data();
+    spotBatchInputs.torchingTrees = batchTorchingTrees.data();
+    spotBatchInputs.dbh = batchDBH.data();
+    spotBatchInputs.treeHeight = batchTreeHeight.data();
+    spotBatchInputs.treeSpecies = batchTreeSpecies.data();
+    spotBatchInputs.windSpeedAtTwentyFeet = batchWindSpeed.data();
+    spotBatchInputs.downwindCoverHeight = batchCoverHeight.data();
+    spotBatchInputs.downwindCanopyMode = batchCanopyMode.data();
+    spotBatchInputs.location = batchLocation.data();
+    spotBatchInputs.ridgeToValleyDistance = batchRidgeToValleyDistance.data();
+    spotBatchInputs.ridgeToValleyElevation = batchRidgeToValleyElevation.data();
+    std::vector<double> batchFirebrandHeight(numberOfSources);
+    std::vector<double> batchFlatDistance(numberOfSources);
+    std::vector<double> batchMountainDistance(numberOfSources);
+    SpotBatchOutputs spotBatchOutputs = { batchFirebrandHeight.data(), batchFlatDistance.data(), batchMountainDistance.data() };
+    auto isSpotMismatch = [](double observed, double expected)
+    {
+        return fabs(observed - expected) > 1.0e-9 * std::max(1.0, fabs(expected));
+    };
+
+    int numPileMismatches = 0;
+    behaveRun.spot.calculateSpottingDistanceFromBurningPileBatch(spotBatchInputs, spotBatchOutputs, 4);
+    for(int i = 0; i < numberOfSources; i++)
+    {
+        Spot spot;
+        spot.updateSpotInputsForBurningPile(batchLocation[i], batchRidgeToValleyDistance[i], LengthUnits::Feet,
+            batchRidgeToValleyElevation[i], LengthUnits::Feet, batchCoverHeight[i], LengthUnits::Feet, batchCanopyMode[i],
+            batchFlameHeight[i], LengthUnits::Feet, batchWindSpeed[i], SpeedUnits::FeetPerMinute);
+        spot.calculateSpottingDistanceFromBurningPile();
+        numPileMismatches += isSpotMismatch(batchFirebrandHeight[i], spot.getMaxFirebrandHeightFromBurningPile(LengthUnits::Feet)) ||
+            isSpotMismatch(batchFlatDistance[i], spot.getMaxFlatTerrainSpottingDistanceFromBurningPile(LengthUnits::Feet)) ||
+            isSpotMismatch(batchMountainDistance[i], spot.getMaxMountainousTerrainSpottingDistanceFromBurningPile(LengthUnits::Feet));
+    }
+    testName = "Test batch spotting distance from burning piles agrees with single sources";
+    reportTestResult(testInfo, testName, numPileMismatches, 0, error_tolerance);
+
+    // Pile and surface sources never set a tree species, the source they read back must still be defined
+    Spot firstPileSpot;
+    Spot secondPileSpot;
+    for(Spot* pileSpot : { &firstPileSpot, &secondPileSpot })
+    {
+        pileSpot->updateSpotInputsForBurningPile(batchLocation[1], batchRidgeToValleyDistance[1], LengthUnits::Feet,
+            batchRidgeToValleyElevation[1], LengthUnits::Feet, batchCoverHeight[1], LengthUnits::Feet, batchCanopyMode[1],
+            batchFlameHeight[1], LengthUnits::Feet, batchWindSpeed[1], SpeedUnits::FeetPerMinute);
+        pileSpot->calculateSpottingDistanceFromBurningPile();
+    }
+    testName = "Test burning pile spotting leaves the tree species at its default";
+    reportTestResult(testInfo, testName, firstPileSpot.getTreeSpecies(), SpotTreeSpecies::ENGELMANN_SPRUCE, error_tolerance);
+    testName = "Test burning pile spotting inputs compare equal";
+    reportTestResult(testInfo, testName, firstPileSpot.hasSameInputs(secondPileSpot), true, error_tolerance);
+
+    int numSurfaceMismatches = 0;
+    behaveRun.spot.calculateSpottingDistanceFromSurfaceFireBatch(spotBatchInputs, spotBatchOutputs, 4);
+    for(int i = 0; i < numberOfSources; i++)
+    {
+        Spot spot;
+        spot.updateSpotInputsForSurfaceFire(batchLocation[i], batchRidgeToValleyDistance[i], LengthUnits::Feet,
+            batchRidgeToValleyElevation[i], LengthUnits::Feet, batchCoverHeight[i], LengthUnits::Feet, batchCanopyMode[i],
+            batchWindSpeed[i], SpeedUnits::FeetPerMinute, batchFlameHeight[i], LengthUnits::Feet);
+        spot.calculateSpottingDistanceFromSurfaceFire();
+        numSurfaceMismatches += isSpotMismatch(batchFirebrandHeight[i], spot.getMaxFirebrandHeightFromSurfaceFire(LengthUnits::Feet)) ||
+            isSpotMismatch(batchFlatDistance[i], spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet)) ||
+            isSpotMismatch(batchMountainDistance[i], spot.getMaxMountainousTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet));
+    }
+    testName = "Test batch spotting distance from surface fires agrees with single sources";
+    reportTestResult(testInfo, testName, numSurfaceMismatches, 0, error_tolerance);
+
+    int numTorchingMismatches = 0;
+    behaveRun.spot.calculateSpottingDistanceFromTorchingTreesBatch(spotBatchInputs, spotBatchOutputs, 4);
+    for(int i = 0; i < numberOfSources; i++)
+    {
+        Spot spot;
+        spot.updateSpotInputsForTorchingTrees(batchLocation[i], batchRidgeToValleyDistance[i], LengthUnits::Feet,
+            batchRidgeToValleyElevation[i], LengthUnits::Feet, batchCoverHeight[i], LengthUnits::Feet, batchCanopyMode[i],
+            batchTorchingTrees[i], batchDBH[i], LengthUnits::Inches, batchTreeHeight[i], LengthUnits::Feet, batchTreeSpecies[i],
+            batchWindSpeed[i], SpeedUnits::FeetPerMinute);
+        spot.calculateSpottingDistanceFromTorchingTrees();
+        numTorchingMismatches += isSpotMismatch(batchFirebrandHeight[i], spot.getMaxFirebrandHeightFromTorchingTrees(LengthUnits::Feet)) ||
+            isSpotMismatch(batchFlatDistance[i], spot.getMaxFlatTerrainSpottingDistanceFromTorchingTrees(LengthUnits::Feet)) ||
+            isSpotMismatch(batchMountainDistance[i], spot.getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(LengthUnits::Feet));
+    }
+    testName = "Test batch spotting distance from torching trees agrees with single sources";
+    reportTestResult(testInfo, testName, numTorchingMismatches, 0, error_tolerance);
+
+    // Torching trees from the table must be within the error it reports of the power laws, and
+    // sources outside the table must get the power laws
+    Spot tableSpot;
+    tableSpot.setIsUsingTorchingTreesTable(true);
+    const SpotTorchingTreesTable* torchingTreesTable = tableSpot.getTorchingTreesTable();
+    const double tableFlameHeightError = torchingTreesTable->getMaximumFlameHeightError();
+    const double tableFlameDurationError = torchingTreesTable->getMaximumFlameDurationError();
+    const double tableFirebrandHeightError = torchingTreesTable->getMaximumFirebrandHeightError();
+    auto firebrandRegime = [](double flameRatio, double flameDuration)
+    {
+        return (flameRatio >= 1.0) ? 0 : (flameRatio >= 0.5) ? 1 : (flameDuration < 3.5) ? 2 : 3;
+    };
+    auto isOutsideTableError = [](double observed, double expected, double tableError)
+    {
+        return fabs(observed - expected) > tableError * fabs(expected) * (1.0 + 1.0e-9) + 1.0e-12;
+    };
+    int numTableFlameMismatches = 0;
+    int numTableFirebrandMismatches = 0;
+    int numTableBatchMismatches = 0;
+    for(int i = 0; i < numberOfSources; i++)
+    {
+        batchDBH[i] = 1.0 + i * 0.0473;
+        batchTorchingTrees[i] = 1 + i % 50;
+    }
+    tableSpot.calculateSpottingDistanceFromTorchingTreesBatch(spotBatchInputs, spotBatchOutputs, 4);
+    for(int i = 0; i < numberOfSources; i++)
+    {
+        Spot exactSpot;
+        for(Spot* torchingSpot : { &exactSpot, &tableSpot })
+        {
+            torchingSpot->updateSpotInputsForTorchingTrees(batchLocation[i], batchRidgeToValleyDistance[i], LengthUnits::Feet,
+                batchRidgeToValleyElevation[i], LengthUnits::Feet, batchCoverHeight[i], LengthUnits::Feet, batchCanopyMode[i],
+                batchTorchingTrees[i], batchDBH[i], LengthUnits::Inches, batchTreeHeight[i], LengthUnits::Feet, batchTreeSpecies[i],
+                batchWindSpeed[i], SpeedUnits::FeetPerMinute);
+            torchingSpot->calculateSpottingDistanceFromTorchingTrees();
+        }
+        double exactFlameHeight = exactSpot.getFlameHeightForTorchingTrees(LengthUnits::Feet);
+        double tableFlameHeight = tableSpot.getFlameHeightForTorchingTrees(LengthUnits::Feet);
+        numTableFlameMismatches += isOutsideTableError(tableFlameHeight, exactFlameHeight, tableFlameHeightError) ||
+            isOutsideTableError(tableSpot.getFlameDurationForTorchingTrees(TimeUnits::Minutes),
+            exactSpot.getFlameDurationForTorchingTrees(TimeUnits::Minutes), tableFlameDurationError);
+        // The lofted part of the firebrand height, on sources where both are in the same regime
+        if (exactFlameHeight > 0.0 && firebrandRegime(exactSpot.getFlameRatioForTorchingTrees(), exactSpot.getFlameDurationForTorchingTrees(TimeUnits::Minutes)) ==
+            firebrandRegime(tableSpot.getFlameRatioForTorchingTrees(), tableSpot.getFlameDurationForTorchingTrees(TimeUnits::Minutes)))
+        {
+            numTableFirebrandMismatches += isOutsideTableError(tableSpot.getMaxFirebrandHeightFromTorchingTrees(LengthUnits::Feet) - batchTreeHeight[i] / 2.0,
+                exactSpot.getMaxFirebrandHeightFromTorchingTrees(LengthUnits::Feet) - batchTreeHeight[i] / 2.0, tableFirebrandHeightError);
+        }
+        numTableBatchMismatches += isSpotMismatch(batchFirebrandHeight[i], tableSpot.getMaxFirebrandHeightFromTorchingTrees(LengthUnits::Feet)) ||
+            isSpotMismatch(batchFlatDistance[i], tableSpot.getMaxFlatTerrainSpottingDistanceFromTorchingTrees(LengthUnits::Feet)) ||
+            isSpotMismatch(batchMountainDistance[i], tableSpot.getMaxMountainousTerrainSpottingDistanceFromTorchingTrees(LengthUnits::Feet));
+    }
+    testName = "Test torching tree table flame height and duration are within the table error";
+    reportTestResult(testInfo, testName, numTableFlameMismatches, 0, error_tolerance);
+    testName = "Test torching tree table firebrand height is within the table error";
+    reportTestResult(testInfo, testName, numTableFirebrandMismatches, 0, error_tolerance);
+    testName = "Test batch spotting distance from torching trees with the table agrees with single sources";
+    reportTestResult(testInfo, testName, numTableBatchMismatches, 0, error_tolerance);
+    testName = "Test torching tree table flame height error is below one percent";
+    reportTestResult(testInfo, testName, tableFlameHeightError < 0.01, true, error_tolerance);
+
+    int numOutsideTableMismatches = 0;
+    const double outsideTableDBH[] = { 0.5, 10.0, 150.0 };
+    const int outsideTableTorchingTrees[] = { 5, 60, 5 };
+    for(int i = 0; i < 3; i++)
+    {
+        Spot exactSpot;
+        for(Spot* torchingSpot : { &exactSpot, &tableSpot })
+        {
+            torchingSpot->updateSpotInputsForTorchingTrees(SpotFireLocation::RIDGE_TOP, 1.0, LengthUnits::Miles, 2000.0, LengthUnits::Feet,
+                30.0, LengthUnits::Feet, SpotDownWindCanopyMode::CLOSED, outsideTableTorchingTrees[i], outsideTableDBH[i], LengthUnits::Inches,
+                60.0, LengthUnits::Feet, SpotTreeSpecies::DOUGLAS_FIR, 10.0, SpeedUnits::MilesPerHour);
+            torchingSpot->calculateSpottingDistanceFromTorchingTrees();
+        }
+        numOutsideTableMismatches += tableSpot.getFlameHeightForTorchingTrees(LengthUnits::Feet) != exactSpot.getFlameHeightForTorchingTrees(LengthUnits::Feet) ||
+            tableSpot.getMaxFirebrandHeightFromTorchingTrees(LengthUnits::Feet) != exactSpot.getMaxFirebrandHeightFromTorchingTrees(LengthUnits::Feet);
+    }
+    testName = "Test torching tree sources outside the table use the power laws";
+    reportTestResult(testInfo, testName, numOutsideTableMismatches, 0, error_tolerance);
+
+    Spot copiedTableSpot(tableSpot);
+    testName = "Test copies of a Spot share its torching tree table";
+    reportTestResult(testInfo, testName, copiedTableSpot.getTorchingTreesTable() == torchingTreesTable, true, error_tolerance);
+    tableSpot.setIsUsingTorchingTreesTable(false);
+    testName = "Test turning off the torching tree table";
+    reportTestResult(testInfo, testName, tableSpot.getIsUsingTorchingTreesTable(), false, error_tolerance);
+
     std::cout << "Finished testing Spot module\n\n";
 }
 
+void testSpotEmberLandingDensity(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing Spot ember landing density\n";
+
+    string testName = "";
+
+    // Two surface fire sources at the origin with the wind blowing east, the second counting half
+    Spot spot;
+    spot.updateSpotInputsForSurfaceFire(SpotFireLocation::MIDSLOPE_WINDWARD, 1.0, LengthUnits::Miles, 2000.0, LengthUnits::Feet,
+        30.0, LengthUnits::Feet, SpotDownWindCanopyMode::CLOSED, 20.0, SpeedUnits::MilesPerHour, 15.0, LengthUnits::Feet);
+    spot.calculateSpottingDistanceFromSurfaceFire();
+    const double maxDistance = spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+
+    SpotBatchInputs inputs = {};
+    inputs.numberOfSources = 2;
+    vector<double> sourceX(2, 0.0);
+    vector<double> sourceY(2, 0.0);
+    vector<double> downwindDirection(2, 90.0);
+    vector<double> weight = { 1.0, 0.5 };
+    SpotEmberSources sources = { sourceX.data(), sourceY.data(), downwindDirection.data(), weight.data() };
+    SpotEmberParameters parameters = { 5000, 12345, 0.1, false };
+
+    // Cells of 50 ft from 500 ft west of the sources to 1000 ft past the maximum distance, and 3000 ft either side
+    const double cellSize = 50.0;
+    const double westEdge = -500.0;
+    const int numberOfColumns = (int)ceil((maxDistance + 1500.0) / cellSize);
+    const int numberOfRows = 120;
+    vector<double> density(numberOfRows * numberOfColumns, 0.0);
+    SpotEmberRaster raster = { numberOfRows, numberOfColumns, cellSize, westEdge, 3000.0, density.data() };
+    spot.accumulateEmberLandingDensityFromSurfaceFire(inputs, sources, parameters, raster, 1);
+
+    double totalDensity = 0.0;
+    double upwindDensity = 0.0;
+    double beyondMaxDistanceDensity = 0.0;
+    for(int row = 0; row < numberOfRows; row++)
+    {
+        for(int column = 0; column < numberOfColumns; column++)
+        {
+            double cellDensity = density[row * numberOfColumns + column];
+            double cellWestEdge = westEdge + column * cellSize;
+            totalDensity += cellDensity;
+            upwindDensity += (cellWestEdge + cellSize <= 0.0) ? cellDensity : 0.0;
+            beyondMaxDistanceDensity += (cellWestEdge > maxDistance) ? cellDensity : 0.0;
+        }
+    }
+    testName = "Test ember landing density adds up to the source weights";
+    reportTestResult(testInfo, testName, totalDensity, 1.5, error_tolerance);
+    testName = "Test no embers land upwind of their source";
+    reportTestResult(testInfo, testName, upwindDensity, 0.0, error_tolerance);
+    testName = "Test no embers land beyond the maximum spotting distance";
+    reportTestResult(testInfo, testName, beyondMaxDistanceDensity, 0.0, error_tolerance);
+
+    // The same draws land in the same cells and sum exactly whatever the number of threads
+    vector<double> threadedDensity(numberOfRows * numberOfColumns, 0.0);
+    SpotEmberRaster threadedRaster = raster;
+    threadedRaster.density = threadedDensity.data();
+    spot.accumulateEmberLandingDensityFromSurfaceFire(inputs, sources, parameters, threadedRaster, 4);
+    testName = "Test ember landing density does not depend on the number of threads";
+    reportTestResult(testInfo, testName, density == threadedDensity, true, error_tolerance);
+
+    // Densities add to what the raster already holds
+    spot.accumulateEmberLandingDensityFromSurfaceFire(inputs, sources, parameters, threadedRaster, 4);
+    double accumulatedDensity = 0.0;
+    for(double cellDensity : threadedDensity)
+    {
+        accumulatedDensity += cellDensity;
+    }
+    testName = "Test ember landing density accumulates into the raster";
+    reportTestResult(testInfo, testName, accumulatedDensity, 3.0, error_tolerance);
+
+    std::cout << "Finished testing Spot ember landing density\n\n";
+}
+
 void testSpeedUnitConversion(TestInfo& testInfo, BehaveRun& behaveRun)
 {
     std::cout << "Testing speed unit conversion\n";
@@ -1474,9 +3009,153 @@ void testSpeedUnitConversion(TestInfo& testInfo, BehaveRun& behaveRun)
     observedSurfaceFireSpreadRate = roundToSixDecimalPlaces(behaveRun.surface.getSpreadRate(SpeedUnits::MilesPerHour));
     reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
 
+    testName = "Test compile time speed conversion matches runtime conversion";
+    double spreadRate = behaveRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+    observedSurfaceFireSpreadRate = SpeedUnits::fromBaseUnits<SpeedUnits::ChainsPerHour>(spreadRate);
+    expectedSurfaceFireSpreadRate = SpeedUnits::fromBaseUnits(spreadRate, SpeedUnits::ChainsPerHour);
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+
+    testName = "Test speed buffer conversion matches runtime conversion";
+    double spreadRates[3] = { spreadRate, 2.0 * spreadRate, 0.0 };
+    SpeedUnits::fromBaseUnits(spreadRates, 3, SpeedUnits::MetersPerMinute);
+    observedSurfaceFireSpreadRate = spreadRates[1];
+    expectedSurfaceFireSpreadRate = SpeedUnits::fromBaseUnits(2.0 * spreadRate, SpeedUnits::MetersPerMinute);
+    reportTestResult(testInfo, testName, observedSurfaceFireSpreadRate, expectedSurfaceFireSpreadRate, error_tolerance);
+
+    testName = "Test compile time temperature conversion, 100 degrees Celsius to Fahrenheit";
+    reportTestResult(testInfo, testName, TemperatureUnits::toBaseUnits<TemperatureUnits::Celsius>(100.0), 212.0, error_tolerance);
+
+    testName = "Test temperature buffer conversion, Fahrenheit to Kelvin";
+    double temperatures[2] = { 32.0, 212.0 };
+    TemperatureUnits::fromBaseUnits(temperatures, 2, TemperatureUnits::Kelvin);
+    reportTestResult(testInfo, testName, temperatures[1], 373.15, error_tolerance);
+
     std::cout << "Finished testing speed unit conversion\n\n";
 }
 
+void testOutputUnitProfile(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing output unit profile\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-10;
+
+    OutputUnitProfile unitProfile;
+    unitProfile.setSpreadRateUnits(SpeedUnits::ChainsPerHour);
+    unitProfile.setWindSpeedUnits(SpeedUnits::MilesPerHour);
+    unitProfile.setFlameLengthUnits(LengthUnits::Meters);
+    unitProfile.setFirelineIntensityUnits(FirelineIntensityUnits::KilowattsPerMeter);
+    unitProfile.setHeatPerUnitAreaUnits(HeatPerUnitAreaUnits::KilojoulesPerSquareMeter);
+    unitProfile.setReactionIntensityUnits(HeatSourceAndReactionIntensityUnits::KilowattsPerSquareMeter);
+    unitProfile.setTimeUnits(TimeUnits::Seconds);
+
+    testName = "Test default output unit profile keeps base units";
+    OutputUnitProfile baseProfile;
+    reportTestResult(testInfo, testName, baseProfile.getSpreadRateFactor() == 1.0 && baseProfile.getFlameLengthFactor() == 1.0 &&
+        baseProfile.getFirelineIntensityFactor() == 1.0 && baseProfile.getTimeFactor() == 1.0, true, error_tolerance);
+
+    // The bulk Surface getter matches the single getters, here in a direction of interest so that
+    // every spread rate, flame length and fireline intensity output differs
+    BehaveRun unitsRun(behaveRun);
+    setSurfaceInputsForGS4LowMoistureScenario(unitsRun);
+    unitsRun.surface.doSurfaceRunInDirectionOfInterest(45.0, SurfaceFireSpreadDirectionMode::FromIgnitionPoint);
+    SurfaceOutputValues surfaceOutputs;
+    unitsRun.surface.getOutputs(unitProfile, surfaceOutputs);
+
+    testName = "Test bulk surface spread rate matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.spreadRate, unitsRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour), error_tolerance);
+    testName = "Test bulk surface spread rate in direction of interest matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.spreadRateInDirectionOfInterest,
+        unitsRun.surface.getSpreadRateInDirectionOfInterest(SpeedUnits::ChainsPerHour), error_tolerance);
+    testName = "Test bulk surface backing spread rate matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.backingSpreadRate, unitsRun.surface.getBackingSpreadRate(SpeedUnits::ChainsPerHour), error_tolerance);
+    testName = "Test bulk surface flanking spread rate matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.flankingSpreadRate, unitsRun.surface.getFlankingSpreadRate(SpeedUnits::ChainsPerHour), error_tolerance);
+    testName = "Test bulk surface direction of max spread matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.directionOfMaxSpread, unitsRun.surface.getDirectionOfMaxSpread(), error_tolerance);
+    testName = "Test bulk surface flame length matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.flameLength, unitsRun.surface.getFlameLength(LengthUnits::Meters), error_tolerance);
+    testName = "Test bulk surface flame length in direction of interest matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.flameLengthInDirectionOfInterest,
+        unitsRun.surface.getFlameLengthInDirectionOfInterest(LengthUnits::Meters), error_tolerance);
+    testName = "Test bulk surface backing flame length matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.backingFlameLength, unitsRun.surface.getBackingFlameLength(LengthUnits::Meters), error_tolerance);
+    testName = "Test bulk surface flanking flame length matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.flankingFlameLength, unitsRun.surface.getFlankingFlameLength(LengthUnits::Meters), error_tolerance);
+    testName = "Test bulk surface fireline intensity matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.firelineIntensity,
+        unitsRun.surface.getFirelineIntensity(FirelineIntensityUnits::KilowattsPerMeter), error_tolerance);
+    testName = "Test bulk surface fireline intensity in direction of interest matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.firelineIntensityInDirectionOfInterest,
+        unitsRun.surface.getFirelineIntensityInDirectionOfInterest(FirelineIntensityUnits::KilowattsPerMeter), error_tolerance);
+    testName = "Test bulk surface backing fireline intensity matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.backingFirelineIntensity,
+        unitsRun.surface.getBackingFirelineIntensity(FirelineIntensityUnits::KilowattsPerMeter), error_tolerance);
+    testName = "Test bulk surface flanking fireline intensity matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.flankingFirelineIntensity,
+        unitsRun.surface.getFlankingFirelineIntensity(FirelineIntensityUnits::KilowattsPerMeter), error_tolerance);
+    testName = "Test bulk surface heat per unit area matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.heatPerUnitArea,
+        unitsRun.surface.getHeatPerUnitArea(HeatPerUnitAreaUnits::KilojoulesPerSquareMeter), error_tolerance);
+    testName = "Test bulk surface reaction intensity matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.reactionIntensity,
+        unitsRun.surface.getReactionIntensity(HeatSourceAndReactionIntensityUnits::KilowattsPerSquareMeter), error_tolerance);
+    testName = "Test bulk surface residence time matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.residenceTime, unitsRun.surface.getResidenceTime(TimeUnits::Seconds), error_tolerance);
+    testName = "Test bulk surface midflame wind speed matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.midflameWindSpeed, unitsRun.surface.getMidflameWindspeed(SpeedUnits::MilesPerHour), error_tolerance);
+    testName = "Test bulk surface length to width ratio matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.fireLengthToWidthRatio, unitsRun.surface.getFireLengthToWidthRatio(), error_tolerance);
+    testName = "Test bulk surface eccentricity matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.fireEccentricity, unitsRun.surface.getFireEccentricity(), error_tolerance);
+    testName = "Test bulk surface heading to backing ratio matches getter";
+    reportTestResult(testInfo, testName, surfaceOutputs.headingToBackingRatio, unitsRun.surface.getHeadingToBackingRatio(), error_tolerance);
+
+    // The bulk Crown getter matches the single getters for a torching fire
+    FuelModels fuelModels;
+    Crown crown(fuelModels);
+    crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 10.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 30.0, SlopeUnits::Percent,
+        0.0, 50.0, FractionUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+    crown.doCrownRunScottAndReinhardt();
+    CrownOutputValues crownOutputs;
+    crown.getOutputs(unitProfile, crownOutputs);
+
+    testName = "Test bulk crown fire type matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.fireType, crown.getFireType(), error_tolerance);
+    testName = "Test bulk crown fraction burned matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.crownFractionBurned, crown.getCrownFractionBurned(), error_tolerance);
+    testName = "Test bulk crown surface fire spread rate matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.surfaceFireSpreadRate, crown.getSurfaceFireSpreadRate(SpeedUnits::ChainsPerHour), error_tolerance);
+    testName = "Test bulk crown fire spread rate matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.crownFireSpreadRate, crown.getCrownFireSpreadRate(SpeedUnits::ChainsPerHour), error_tolerance);
+    testName = "Test bulk crown flame length matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.crownFlameLength, crown.getCrownFlameLength(LengthUnits::Meters), error_tolerance);
+    testName = "Test bulk crown fireline intensity matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.crownFirelineIntensity,
+        crown.getCrownFirelineIntensity(FirelineIntensityUnits::KilowattsPerMeter), error_tolerance);
+    testName = "Test bulk crown final spread rate matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.finalSpreadRate, crown.getFinalSpreadRate(SpeedUnits::ChainsPerHour), error_tolerance);
+    testName = "Test bulk crown final heat per unit area matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.finalHeatPerUnitArea,
+        crown.getFinalHeatPerUnitArea(HeatPerUnitAreaUnits::KilojoulesPerSquareMeter), error_tolerance);
+    testName = "Test bulk crown final fireline intensity matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.finalFirelineIntensity,
+        crown.getFinalFirelineIntesity(FirelineIntensityUnits::KilowattsPerMeter), error_tolerance);
+    testName = "Test bulk crown final flame length matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.finalFlameLength, crown.getFinalFlameLength(LengthUnits::Meters), error_tolerance);
+    testName = "Test bulk crown length to width ratio matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.crownFireLengthToWidthRatio, crown.getCrownFireLengthToWidthRatio(), error_tolerance);
+    testName = "Test bulk crown critical open wind speed matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.criticalOpenWindSpeed, crown.getCriticalOpenWindSpeed(SpeedUnits::MilesPerHour), error_tolerance);
+    testName = "Test bulk crown torching index matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.torchingIndex, crown.getTorchingIndex(SpeedUnits::MilesPerHour), error_tolerance);
+    testName = "Test bulk crown crowning index matches getter";
+    reportTestResult(testInfo, testName, crownOutputs.crowningIndex, crown.getCrowningIndex(SpeedUnits::MilesPerHour), error_tolerance);
+
+    std::cout << "Finished testing output unit profile\n\n";
+}
+
 void testIgniteModule(TestInfo& testInfo, BehaveRun& behaveRun)
 {
     std::cout << "Testing Ignite module\n";
@@ -1611,6 +3290,16 @@ void testContainModule(TestInfo& testInfo, BehaveRun& behaveRun)
     double expectedFinalTimeSinceReport = 0;
     ContainStatus::ContainStatusEnum expectedContainmentStatus = ContainStatus::Unreported;
 
+    // Adapters copied per scenario before they ever run start out unreported
+    {
+        ContainAdapter unrunContain;
+        ContainAdapter unrunCopy(unrunContain);
+        testName = "Test a copied Contain adapter that has not run is unreported";
+        reportTestResult(testInfo, testName, unrunCopy.getContainmentStatus(), ContainStatus::Unreported, error_tolerance);
+        testName = "Test a copied Contain adapter that has not run has taken no steps";
+        reportTestResult(testInfo, testName, unrunCopy.getNumberOfSimulationSteps(), 0, error_tolerance);
+    }
+
     // Test case where expected result is containment
     behaveRun.contain.setAttackDistance(0, LengthUnits::Chains);
     behaveRun.contain.setLwRatio(3);
@@ -1661,21 +3350,718 @@ void testContainModule(TestInfo& testInfo, BehaveRun& behaveRun)
     observedContainmentStatus = behaveRun.contain.getContainmentStatus();
     reportTestResult(testInfo, testName, observedContainmentStatus, expectedContainmentStatus, error_tolerance);
 
-    std::cout << "Finished testing Contain module\n\n";
-}
-
-void testMortalityModule(TestInfo& testInfo, BehaveRun& behaveRun)
-{
-    std::cout << "Testing Mortality module\n";
-
-    // TODO: Create tests for Mortality module
-    // Stub for now
+    // Runs reuse the adapter's simulation workspace, repeating one must give the same results
+    behaveRun.contain.doContainRun();
+    testName = "Test repeated Contain run final fire size";
+    reportTestResult(testInfo, testName, behaveRun.contain.getFinalFireSize(AreaUnits::Acres), expectedFinalFireSize, error_tolerance);
+    testName = "Test repeated Contain run final time since report";
+    reportTestResult(testInfo, testName, behaveRun.contain.getFinalTimeSinceReport(TimeUnits::Minutes), expectedFinalTimeSinceReport, error_tolerance);
+
+    ContainAdapter largerContain(behaveRun.contain);
+    largerContain.setMaxSteps(2000);
+    largerContain.doContainRun();
+    largerContain.setMaxSteps(1000);
+    largerContain.doContainRun();
+    testName = "Test Contain run after a larger run final fire size";
+    reportTestResult(testInfo, testName, largerContain.getFinalFireSize(AreaUnits::Acres), expectedFinalFireSize, error_tolerance);
+
+    // The adaptive step must agree closely with the fixed step reference in far fewer steps
+    int fixedSteps = behaveRun.contain.getNumberOfSimulationSteps();
+    ContainAdapter adaptiveContain(behaveRun.contain);
+    adaptiveContain.setIntegrator(ContainIntegrator::AdaptiveStep, 1.0e-6);
+    adaptiveContain.doContainRun();
+    testName = "Test adaptive step Contain run final fire size";
+    reportTestResult(testInfo, testName, adaptiveContain.getFinalFireSize(AreaUnits::Acres), expectedFinalFireSize, 1.0e-3 * expectedFinalFireSize);
+    testName = "Test adaptive step Contain run final fire line length";
+    reportTestResult(testInfo, testName, adaptiveContain.getFinalFireLineLength(LengthUnits::Chains), expectedFinalFireLineLength, 1.0e-3 * expectedFinalFireLineLength);
+    testName = "Test adaptive step Contain run final time since report";
+    reportTestResult(testInfo, testName, adaptiveContain.getFinalTimeSinceReport(TimeUnits::Minutes), expectedFinalTimeSinceReport, 0.5);
+    testName = "Test adaptive step Contain run containment status";
+    reportTestResult(testInfo, testName, adaptiveContain.getContainmentStatus(), ContainStatus::Contained, error_tolerance);
+    testName = "Test adaptive step Contain run takes fewer steps";
+    reportTestResult(testInfo, testName, adaptiveContain.getNumberOfSimulationSteps() < fixedSteps / 4, true, error_tolerance);
+
+    // Constant production steps must agree with the fixed step reference, with the
+    // Runga-Kutta steps taking over across the second resource's arrival
+    {
+        double constantDiurnalROS[24];
+        std::fill(constantDiurnalROS, constantDiurnalROS + 24, 5.0);
+        Sem::ContainForce constantForce;
+        constantForce.addResource(60, 8, 480, Sem::LeftFlank);
+        constantForce.addResource(100, 8, 480, Sem::LeftFlank);
+        for(Sem::Contain::ContainTactic constantTactic : { Sem::Contain::HeadAttack, Sem::Contain::RearAttack })
+        {
+            std::string tacticName = (constantTactic == Sem::Contain::HeadAttack) ? "head" : "rear";
+            Sem::ContainSim fixedSim(1.0, 5.0, constantDiurnalROS, 0, 3.0, &constantForce, constantTactic, 0.0);
+            fixedSim.setOutputs(Sem::ContainSim::SummaryOutputs);
+            fixedSim.run();
+            Sem::ContainSim analyticSim(1.0, 5.0, constantDiurnalROS, 0, 3.0, &constantForce, constantTactic, 0.0);
+            analyticSim.setOutputs(Sem::ContainSim::SummaryOutputs);
+            analyticSim.setIntegrator(Sem::Contain::AdaptiveStep, 1.0e-6);
+            analyticSim.run();
+            testName = "Test constant production " + tacticName + " attack final fire size";
+            reportTestResult(testInfo, testName, analyticSim.finalFireSize(), fixedSim.finalFireSize(), 1.0e-3 * fixedSim.finalFireSize());
+            testName = "Test constant production " + tacticName + " attack final fire line length";
+            reportTestResult(testInfo, testName, analyticSim.finalFireLine(), fixedSim.finalFireLine(), 1.0e-3 * fixedSim.finalFireLine());
+            testName = "Test constant production " + tacticName + " attack final time";
+            reportTestResult(testInfo, testName, analyticSim.finalFireTime(), fixedSim.finalFireTime(), 0.5);
+            testName = "Test constant production " + tacticName + " attack status";
+            reportTestResult(testInfo, testName, analyticSim.status(), fixedSim.status(), error_tolerance);
+            testName = "Test constant production " + tacticName + " attack mixes both kinds of step";
+            reportTestResult(testInfo, testName, analyticSim.analyticStepCount() > 0 &&
+                analyticSim.analyticStepCount() < analyticSim.simulationSteps(), true, error_tolerance);
+            testName = "Test constant production " + tacticName + " attack takes fewer steps";
+            reportTestResult(testInfo, testName, analyticSim.simulationSteps() < fixedSim.simulationSteps() / 3, true, error_tolerance);
+        }
+
+        // With a single resource the production never changes, so every step is a constant production step
+        Sem::ContainForce singleForce;
+        singleForce.addResource(120, 20, 480, Sem::LeftFlank);
+        Sem::ContainSim singleSim(1.0, 5.0, constantDiurnalROS, 0, 3.0, &singleForce, Sem::Contain::HeadAttack, 0.0);
+        singleSim.setOutputs(Sem::ContainSim::SummaryOutputs);
+        singleSim.setIntegrator(Sem::Contain::AdaptiveStep, 1.0e-6);
+        singleSim.run();
+        testName = "Test constant production run takes only constant production steps";
+        reportTestResult(testInfo, testName, singleSim.analyticStepCount(), singleSim.simulationSteps(), error_tolerance);
+        double singleSize = singleSim.finalFireSize();
+        singleSim.setAnalyticSteps(false);
+        singleSim.reset(1.0, 5.0, constantDiurnalROS, 0, 3.0, &singleForce, Sem::Contain::HeadAttack, 0.0);
+        singleSim.run();
+        testName = "Test Runga-Kutta fallback takes no constant production steps";
+        reportTestResult(testInfo, testName, singleSim.analyticStepCount(), 0, error_tolerance);
+        testName = "Test Runga-Kutta fallback final fire size";
+        reportTestResult(testInfo, testName, singleSim.finalFireSize(), singleSize, 1.0e-3 * singleSize);
+    }
 
-    std::cout << "Finished testing Mortality module\n\n";
-}
+    // A RunControl counts the simulation steps, and an expired time budget stops the run
+    {
+        RunControl runControl;
+        ContainAdapter controlledContain(behaveRun.contain);
+        controlledContain.setRunControl(&runControl);
+        controlledContain.doContainRun();
+        testName = "Test Contain run with a RunControl is contained";
+        reportTestResult(testInfo, testName, controlledContain.getContainmentStatus(), ContainStatus::Contained, error_tolerance);
+        testName = "Test Contain run with a RunControl counts its steps";
+        reportTestResult(testInfo, testName, runControl.getWorkDone() >= fixedSteps, true, error_tolerance);
+
+        runControl.setTimeBudget(0.0);
+        controlledContain.doContainRun();
+        testName = "Test Contain run past its time budget is stopped";
+        reportTestResult(testInfo, testName, controlledContain.getContainmentStatus(), ContainStatus::Stopped, error_tolerance);
+        testName = "Test RunControl status after the time budget ran out";
+        reportTestResult(testInfo, testName, runControl.getStatus(), RunStatus::DeadlineExceeded, error_tolerance);
+    }
 
-void testFineDeadFuelMoistureTool(TestInfo& testInfo, BehaveRun& behaveRun)
-{
+    // A summary run must match a run that keeps the perimeter, and the streamed
+    // points of the final pass must be the kept perimeter
+    ContainAdapter perimeterContain(behaveRun.contain);
+    perimeterContain.setAttackDistance(1, LengthUnits::Chains);
+    std::vector<double> streamedX;
+    std::vector<double> streamedY;
+    perimeterContain.setPerimeterCallback([&streamedX, &streamedY](int, int step, double x, double y)
+    {
+        streamedX.resize(step);
+        streamedY.resize(step);
+        streamedX.push_back(x);
+        streamedY.push_back(y);
+    });
+    perimeterContain.doContainRun();
+    ContainAdapter summaryContain(perimeterContain);
+    summaryContain.setKeepPerimeter(false);
+    summaryContain.setPerimeterCallback(Sem::ContainPerimeterCallback());
+    summaryContain.doContainRun();
+    testName = "Test summary Contain run final fire size";
+    reportTestResult(testInfo, testName, summaryContain.getFinalFireSize(AreaUnits::Acres), perimeterContain.getFinalFireSize(AreaUnits::Acres), 1.0e-12);
+    testName = "Test summary Contain run final fire line length";
+    reportTestResult(testInfo, testName, summaryContain.getFinalFireLineLength(LengthUnits::Chains), perimeterContain.getFinalFireLineLength(LengthUnits::Chains), 1.0e-12);
+    testName = "Test summary Contain run final containment area";
+    reportTestResult(testInfo, testName, summaryContain.getFinalContainmentArea(AreaUnits::Acres), perimeterContain.getFinalContainmentArea(AreaUnits::Acres), 1.0e-12);
+    testName = "Test summary Contain run final time since report";
+    reportTestResult(testInfo, testName, summaryContain.getFinalTimeSinceReport(TimeUnits::Minutes), perimeterContain.getFinalTimeSinceReport(TimeUnits::Minutes), 1.0e-12);
+    testName = "Test streamed Contain perimeter point count";
+    reportTestResult(testInfo, testName, (int)streamedX.size(), perimeterContain.getNumberOfSimulationSteps() + 1, error_tolerance);
+    Sem::ContainForce streamForce;
+    streamForce.addResource(120, 480, 20, Sem::LeftFlank);
+    double streamDiurnalROS[24];
+    std::fill(streamDiurnalROS, streamDiurnalROS + 24, 5.0);
+    Sem::ContainSim streamSim(1.0, 5.0, streamDiurnalROS, 0, 3.0, &streamForce, Sem::Contain::HeadAttack, 1.0);
+    streamedX.clear();
+    streamedY.clear();
+    streamSim.setPerimeterCallback([&streamedX, &streamedY](int, int step, double x, double y)
+    {
+        streamedX.resize(step);
+        streamedY.resize(step);
+        streamedX.push_back(x);
+        streamedY.push_back(y);
+    });
+    streamSim.run();
+    int numStreamMismatches = ((int)streamedX.size() != streamSim.simulationSteps() + 1);
+    for(int i = 0; i < (int)streamedX.size() && i <= streamSim.simulationSteps(); i++)
+    {
+        numStreamMismatches += (streamedX[i] != streamSim.firePerimeterX()[i] || streamedY[i] != streamSim.firePerimeterY()[i]);
+    }
+    testName = "Test streamed Contain perimeter points match the kept perimeter";
+    reportTestResult(testInfo, testName, numStreamMismatches, 0, error_tolerance);
+    streamSim.setOutputs(Sem::ContainSim::SummaryOutputs);
+    streamSim.reset(1.0, 5.0, streamDiurnalROS, 0, 3.0, &streamForce, Sem::Contain::HeadAttack, 1.0);
+    streamSim.run();
+    testName = "Test summary ContainSim run keeps no perimeter";
+    reportTestResult(testInfo, testName, streamSim.firePoints() == 0 && streamSim.firePerimeterX() == 0, true, error_tolerance);
+
+    // The production schedule must agree with summing over every resource, and the
+    // next production boost with a minute by minute search
+    Sem::ContainForce force;
+    const Sem::ContainFlank flanks[] = { Sem::LeftFlank, Sem::RightFlank, Sem::BothFlanks };
+    for(int i = 0; i < 120; i++)
+    {
+        double arrival = (i * 37 % 300) + ((i % 4 == 0) ? 0.5 : 0.0);
+        force.addResource(arrival, 2.0 + i % 9, 60.0 + (i * 53 % 420), flanks[i % 3]);
+    }
+    auto sumProductionRate = [&force](double minutesSinceReport, Sem::ContainFlank flank)
+    {
+        double rate = 0.0;
+        for(int i = 0; i < force.resources(); i++)
+        {
+            if((force.resourceFlank(i) == flank || force.resourceFlank(i) == Sem::BothFlanks) &&
+                force.resourceArrival(i) <= minutesSinceReport + 0.001 &&
+                force.resourceArrival(i) + force.resourceDuration(i) >= minutesSinceReport)
+            {
+                rate += 0.5 * force.resourceProduction(i);
+            }
+        }
+        return rate;
+    };
+    int numRateMismatches = 0;
+    int numNextArrivalMismatches = 0;
+    for(double minutes = 0.0; minutes < 800.0; minutes += 0.25)
+    {
+        for(Sem::ContainFlank flank : { Sem::LeftFlank, Sem::RightFlank })
+        {
+            if(fabs(force.productionRate(minutes, flank) - sumProductionRate(minutes, flank)) > 1.0e-9)
+            {
+                numRateMismatches++;
+            }
+            double expectedNextArrival = 0.0;
+            double rate = sumProductionRate(minutes, flank);
+            for(double minute = (int)minutes + 1.0; minute < 700.0; minute += 1.0)
+            {
+                if(fabs(sumProductionRate(minute, flank) - rate) > 0.001)
+                {
+                    expectedNextArrival = minute;
+                    break;
+                }
+            }
+            if(force.nextArrival(minutes, 700.0, flank) != expectedNextArrival)
+            {
+                numNextArrivalMismatches++;
+            }
+        }
+    }
+    testName = "Test ContainForce production schedule agrees with summing over resources";
+    reportTestResult(testInfo, testName, numRateMismatches, 0, error_tolerance);
+    testName = "Test ContainForce next arrival agrees with a minute by minute search";
+    reportTestResult(testInfo, testName, numNextArrivalMismatches, 0, error_tolerance);
+
+    std::cout << "Finished testing Contain module\n\n";
+}
+
+void testMortalityModule(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing Mortality module\n";
+
+    string testName = "";
+    double error_tolerance = 1e-06;
+
+    SpeciesMasterTable speciesMasterTable;
+    speciesMasterTable.initializeMasterTable();
+
+    // Indexed lookups must agree with a first-match scan that stops at the blank record
+    int numMismatches = 0;
+    for(int i = 0; i < (int)speciesMasterTable.record_.size(); i++)
+    {
+        const SpeciesMasterTableRecord& record = speciesMasterTable.record_[i];
+        if(record.speciesCode == "")
+        {
+            break;
+        }
+        int expectedIndex = -1;
+        int expectedIndexForEquationType = -1;
+        for(int j = 0; j < (int)speciesMasterTable.record_.size() && speciesMasterTable.record_[j].speciesCode != ""; j++)
+        {
+            if(speciesMasterTable.record_[j].speciesCode == record.speciesCode)
+            {
+                if(expectedIndex == -1)
+                {
+                    expectedIndex = j;
+                }
+                if(expectedIndexForEquationType == -1 && speciesMasterTable.record_[j].equationType == record.equationType)
+                {
+                    expectedIndexForEquationType = j;
+                }
+            }
+        }
+        if(speciesMasterTable.getSpeciesTableIndexFromSpeciesCode(record.speciesCode) != expectedIndex ||
+            speciesMasterTable.getSpeciesTableIndexFromSpeciesCodeAndEquationType(record.speciesCode, record.equationType) != expectedIndexForEquationType)
+        {
+            numMismatches++;
+        }
+    }
+    testName = "Test species code index agrees with linear scan";
+    reportTestResult(testInfo, testName, numMismatches, 0, error_tolerance);
+
+    int upperCaseIndex = speciesMasterTable.getSpeciesTableIndexFromSpeciesCode("UMCA");
+    testName = "Test species code lookup is case insensitive";
+    reportTestResult(testInfo, testName, speciesMasterTable.getSpeciesTableIndexFromSpeciesCode("umCa"), upperCaseIndex, error_tolerance);
+
+    testName = "Test unknown species code is not found";
+    reportTestResult(testInfo, testName, speciesMasterTable.getSpeciesTableIndexFromSpeciesCode("NOTASPECIES"), -1, error_tolerance);
+
+    testName = "Test species code with unused equation type is not found";
+    reportTestResult(testInfo, testName, speciesMasterTable.getSpeciesTableIndexFromSpeciesCodeAndEquationType("UMCA", EquationType::bole_char), -1, error_tolerance);
+
+    testName = "Test blank species code is not found";
+    reportTestResult(testInfo, testName, speciesMasterTable.getSpeciesTableIndexFromSpeciesCode(""), -1, error_tolerance);
+
+    // Region spans must list the same records, in table order, as a scan of the table
+    const RegionCode regions[] = { RegionCode::interior_west, RegionCode::pacific_west,
+        RegionCode::north_east, RegionCode::south_east };
+    const EquationType equationTypes[] = { EquationType::crown_scorch, EquationType::bole_char,
+        EquationType::crown_damage };
+    numMismatches = 0;
+    int numRegionRecords = 0;
+    for(RegionCode region : regions)
+    {
+        SpeciesMasterTableRecordSpan regionSpan = behaveRun.mortality.getSpeciesRecordSpanForRegion(region);
+        numRegionRecords += regionSpan.size();
+        size_t spanPosition = 0;
+        for(int i = 0; i < (int)speciesMasterTable.record_.size(); i++)
+        {
+            if(behaveRun.mortality.checkIsInRegionAtSpeciesTableIndex(i, region))
+            {
+                if(spanPosition >= regionSpan.size() || regionSpan.getSpeciesTableIndex(spanPosition) != i)
+                {
+                    numMismatches++;
+                }
+                spanPosition++;
+            }
+        }
+        numMismatches += (spanPosition != regionSpan.size());
+
+        for(EquationType equationType : equationTypes)
+        {
+            SpeciesMasterTableRecordSpan equationTypeSpan = behaveRun.mortality.getSpeciesRecordSpanForRegionAndEquationType(region, equationType);
+            vector<SpeciesMasterTableRecord> equationTypeVector = behaveRun.mortality.getSpeciesRecordVectorForRegionAndEquationType(region, equationType);
+            numMismatches += (equationTypeVector.size() != equationTypeSpan.size());
+            spanPosition = 0;
+            for(const SpeciesMasterTableRecord& record : equationTypeSpan)
+            {
+                if(record.equationType != equationType ||
+                    !behaveRun.mortality.checkIsInRegionAtSpeciesTableIndex(equationTypeSpan.getSpeciesTableIndex(spanPosition), region) ||
+                    (spanPosition < equationTypeVector.size() && equationTypeVector[spanPosition].speciesCode != record.speciesCode))
+                {
+                    numMismatches++;
+                }
+                spanPosition++;
+            }
+        }
+    }
+    testName = "Test region record spans agree with table scan";
+    reportTestResult(testInfo, testName, numMismatches, 0, error_tolerance);
+    testName = "Test region record spans are not empty";
+    reportTestResult(testInfo, testName, numRegionRecords > 0, true, error_tolerance);
+
+    int numRecords = speciesMasterTable.record_.size();
+    speciesMasterTable.insertRecord("ZZTEST", "Test species", "Test species", 1, 1, 1, 1, -1, -1, -1,
+        EquationType::crown_scorch, CrownDamageEquationCode::not_set);
+    testName = "Test record inserted after blank species code is not found";
+    reportTestResult(testInfo, testName, speciesMasterTable.getSpeciesTableIndexFromSpeciesCode("ZZTEST"), -1, error_tolerance);
+    testName = "Test record count after insert";
+    reportTestResult(testInfo, testName, speciesMasterTable.record_.size(), numRecords + 1, error_tolerance);
+
+    // Batch mortality must match running each tree through a fresh Mortality
+    Mortality mortality(speciesMasterTable);
+    mortality.setRegion(RegionCode::interior_west);
+    mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::flame_length);
+
+    const string batchSpeciesCodes[] = { "ABBA", "PIPO", "PSME", "ACRU", "ACRU", "PIPO", "NOTASPECIES" };
+    const EquationType batchEquationTypes[] = { EquationType::crown_scorch, EquationType::crown_scorch,
+        EquationType::crown_scorch, EquationType::crown_scorch, EquationType::bole_char, EquationType::crown_damage,
+        EquationType::crown_scorch };
+    const int numBatchSpecies = sizeof(batchEquationTypes) / sizeof(batchEquationTypes[0]);
+    const int numBatchTrees = 3000; // spans several chunks
+    vector<int> speciesTableIndex(numBatchTrees);
+    vector<EquationType> equationType(numBatchTrees);
+    vector<double> treeDensityPerAcre(numBatchTrees);
+    vector<double> dbh(numBatchTrees);
+    vector<double> treeHeight(numBatchTrees);
+    vector<double> crownRatio(numBatchTrees);
+    vector<double> flameLength(numBatchTrees);
+    vector<double> crownDamage(numBatchTrees);
+    vector<double> cambiumKillRating(numBatchTrees);
+    vector<BeetleDamage> beetleDamage(numBatchTrees);
+    vector<double> boleCharHeight(numBatchTrees);
+    for(int i = 0; i < numBatchTrees; i++)
+    {
+        int species = i % numBatchSpecies;
+        speciesTableIndex[i] = speciesMasterTable.getSpeciesTableIndexFromSpeciesCodeAndEquationType(batchSpeciesCodes[species],
+            batchEquationTypes[species]);
+        equationType[i] = batchEquationTypes[species];
+        treeDensityPerAcre[i] = 5 + (i % 11);
+        dbh[i] = 2 + (i % 29);
+        treeHeight[i] = 15 + (i % 37) * 2;
+        crownRatio[i] = 0.2 + (i % 7) * 0.1;
+        flameLength[i] = 1 + (i % 13);
+        crownDamage[i] = (i % 10) * 10;
+        cambiumKillRating[i] = i % 5;
+        beetleDamage[i] = (i % 2) ? BeetleDamage::yes : BeetleDamage::no;
+        boleCharHeight[i] = 1 + (i % 9);
+    }
+
+    MortalityBatchInputs batchInputs = { numBatchTrees, speciesTableIndex.data(), equationType.data(),
+        treeDensityPerAcre.data(), dbh.data(), treeHeight.data(), crownRatio.data(), nullptr, flameLength.data(),
+        crownDamage.data(), cambiumKillRating.data(), beetleDamage.data(), boleCharHeight.data() };
+    vector<double> batchProbabilityOfMortality(numBatchTrees);
+    vector<double> batchBarkThickness(numBatchTrees);
+    vector<double> batchKilledTrees(numBatchTrees);
+    MortalityBatchOutputs batchOutputs = { batchProbabilityOfMortality.data(), batchBarkThickness.data(), batchKilledTrees.data() };
+    MortalityStandTotals standTotals = mortality.calculateMortalityBatch(batchInputs, batchOutputs, 4);
+
+    numMismatches = 0;
+    int numErrors = 0;
+    double totalKilledTrees = 0;
+    double basalAreaPrefire = 0;
+    for(int i = 0; i < numBatchTrees; i++)
+    {
+        Mortality treeMortality(mortality);
+        double probabilityOfMortality = -1.0;
+        double killedTrees = 0;
+        if(speciesTableIndex[i] >= 0)
+        {
+            string speciesCode = speciesMasterTable.record_[speciesTableIndex[i]].speciesCode;
+            treeMortality.setEquationType(equationType[i]);
+            treeMortality.setSpeciesCode(speciesCode);
+            treeMortality.setTreeDensityPerUnitArea(treeDensityPerAcre[i], AreaUnits::Acres);
+            treeMortality.setDBH(dbh[i], LengthUnits::Inches);
+            treeMortality.setTreeHeight(treeHeight[i], LengthUnits::Feet);
+            treeMortality.setCrownRatio(crownRatio[i], FractionUnits::Fraction);
+            treeMortality.setFlameLengthOrScorchHeightValue(flameLength[i], LengthUnits::Feet);
+            treeMortality.setCrownDamage(crownDamage[i]);
+            treeMortality.setCambiumKillRating(cambiumKillRating[i]);
+            treeMortality.setBeetleDamage(beetleDamage[i]);
+            treeMortality.setBoleCharHeight(boleCharHeight[i], LengthUnits::Feet);
+            probabilityOfMortality = treeMortality.calculateMortality(FractionUnits::Fraction);
+        }
+        if(probabilityOfMortality < 0)
+        {
+            numErrors++;
+        }
+        else
+        {
+            killedTrees = treeMortality.getKilledTrees();
+            totalKilledTrees += killedTrees;
+            basalAreaPrefire += treeMortality.getBasalAreaPrefire();
+            if(batchBarkThickness[i] != treeMortality.getBarkThickness(LengthUnits::Inches))
+            {
+                numMismatches++;
+            }
+        }
+        if(batchProbabilityOfMortality[i] != probabilityOfMortality || batchKilledTrees[i] != killedTrees)
+        {
+            numMismatches++;
+        }
+    }
+    testName = "Test batch mortality matches single tree runs";
+    reportTestResult(testInfo, testName, numMismatches, 0, error_tolerance);
+    testName = "Test batch mortality error count";
+    reportTestResult(testInfo, testName, standTotals.numberOfErrors, numErrors, error_tolerance);
+    testName = "Test batch mortality has errors for unknown species only";
+    reportTestResult(testInfo, testName, numErrors >= numBatchTrees / numBatchSpecies && numErrors < numBatchTrees / 2, true, error_tolerance);
+    testName = "Test batch mortality total killed trees";
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(standTotals.totalKilledTrees), roundToSixDecimalPlaces(totalKilledTrees), error_tolerance);
+    testName = "Test batch mortality prefire basal area";
+    reportTestResult(testInfo, testName, roundToSixDecimalPlaces(standTotals.basalAreaPrefire), roundToSixDecimalPlaces(basalAreaPrefire), error_tolerance);
+
+    MortalityStandTotals singleThreadStandTotals = mortality.calculateMortalityBatch(batchInputs, batchOutputs, 1);
+    testName = "Test batch mortality totals do not depend on thread count";
+    reportTestResult(testInfo, testName, singleThreadStandTotals.postfireCanopyCover == standTotals.postfireCanopyCover &&
+        singleThreadStandTotals.averageDBHKilled == standTotals.averageDBHKilled &&
+        singleThreadStandTotals.basalAreaPostfire == standTotals.basalAreaPostfire, true, error_tolerance);
+
+    // Trees of species and equation types interleaved so neighbours rarely share a group, with unknown species
+    // and indices past the table, come back at their input index and with the same totals at any thread count
+    {
+        vector<int> groupedSpeciesTableIndex(numBatchTrees);
+        vector<EquationType> groupedEquationType(numBatchTrees);
+        for(int i = 0; i < numBatchTrees; i++)
+        {
+            int species = (i * 5 + i / 17) % numBatchSpecies;
+            groupedSpeciesTableIndex[i] = (i % 499 == 0) ? (int)speciesMasterTable.record_.size() + i :
+                speciesMasterTable.getSpeciesTableIndexFromSpeciesCodeAndEquationType(batchSpeciesCodes[species], batchEquationTypes[species]);
+            groupedEquationType[i] = batchEquationTypes[species];
+        }
+        MortalityBatchInputs groupedInputs = batchInputs;
+        groupedInputs.speciesTableIndex = groupedSpeciesTableIndex.data();
+        groupedInputs.equationType = groupedEquationType.data();
+
+        int numGroupedMismatches = 0;
+        int numGroupedErrors = 0;
+        vector<double> expectedProbabilityOfMortality(numBatchTrees);
+        vector<double> expectedKilledTrees(numBatchTrees);
+        for(int i = 0; i < numBatchTrees; i++)
+        {
+            Mortality treeMortality(mortality);
+            expectedProbabilityOfMortality[i] = -1.0;
+            expectedKilledTrees[i] = 0;
+            if(groupedSpeciesTableIndex[i] >= 0 && groupedSpeciesTableIndex[i] < (int)speciesMasterTable.record_.size())
+            {
+                treeMortality.setEquationType(groupedEquationType[i]);
+                treeMortality.setSpeciesCode(speciesMasterTable.record_[groupedSpeciesTableIndex[i]].speciesCode);
+                treeMortality.setTreeDensityPerUnitArea(treeDensityPerAcre[i], AreaUnits::Acres);
+                treeMortality.setDBH(dbh[i], LengthUnits::Inches);
+                treeMortality.setTreeHeight(treeHeight[i], LengthUnits::Feet);
+                treeMortality.setCrownRatio(crownRatio[i], FractionUnits::Fraction);
+                treeMortality.setFlameLengthOrScorchHeightValue(flameLength[i], LengthUnits::Feet);
+                treeMortality.setCrownDamage(crownDamage[i]);
+                treeMortality.setCambiumKillRating(cambiumKillRating[i]);
+                treeMortality.setBeetleDamage(beetleDamage[i]);
+                treeMortality.setBoleCharHeight(boleCharHeight[i], LengthUnits::Feet);
+                expectedProbabilityOfMortality[i] = treeMortality.calculateMortality(FractionUnits::Fraction);
+            }
+            if(expectedProbabilityOfMortality[i] < 0)
+            {
+                numGroupedErrors++;
+            }
+            else
+            {
+                expectedKilledTrees[i] = treeMortality.getKilledTrees();
+            }
+        }
+
+        auto isSameStandTotals = [](const MortalityStandTotals& lhs, const MortalityStandTotals& rhs)
+        {
+            return lhs.numberOfTrees == rhs.numberOfTrees && lhs.numberOfErrors == rhs.numberOfErrors &&
+                lhs.totalPrefireTrees == rhs.totalPrefireTrees && lhs.totalKilledTrees == rhs.totalKilledTrees &&
+                lhs.averageProbabilityOfMortality == rhs.averageProbabilityOfMortality &&
+                lhs.averageProbabilityOfMortalityGreaterThan4DBH == rhs.averageProbabilityOfMortalityGreaterThan4DBH &&
+                lhs.averageDBHKilled == rhs.averageDBHKilled && lhs.basalAreaPrefire == rhs.basalAreaPrefire &&
+                lhs.basalAreaKilled == rhs.basalAreaKilled && lhs.basalAreaPostfire == rhs.basalAreaPostfire &&
+                lhs.prefireCanopyCover == rhs.prefireCanopyCover && lhs.postfireCanopyCover == rhs.postfireCanopyCover;
+        };
+        MortalityStandTotals groupedSingleThreadTotals = {};
+        bool isSameTotalsAtAnyThreadCount = true;
+        for(int numberOfThreads : { 1, 2, 3, 8 })
+        {
+            std::fill(batchProbabilityOfMortality.begin(), batchProbabilityOfMortality.end(), -2.0);
+            std::fill(batchKilledTrees.begin(), batchKilledTrees.end(), -2.0);
+            MortalityStandTotals groupedTotals = mortality.calculateMortalityBatch(groupedInputs, batchOutputs, numberOfThreads);
+            for(int i = 0; i < numBatchTrees; i++)
+            {
+                if(batchProbabilityOfMortality[i] != expectedProbabilityOfMortality[i] || batchKilledTrees[i] != expectedKilledTrees[i])
+                {
+                    numGroupedMismatches++;
+                }
+            }
+            if(numberOfThreads == 1)
+            {
+                groupedSingleThreadTotals = groupedTotals;
+            }
+            isSameTotalsAtAnyThreadCount = isSameTotalsAtAnyThreadCount && isSameStandTotals(groupedTotals, groupedSingleThreadTotals);
+        }
+        testName = "Test grouped batch mortality writes each tree at its input index";
+        reportTestResult(testInfo, testName, numGroupedMismatches, 0, error_tolerance);
+        testName = "Test grouped batch mortality error count, including species past the table";
+        reportTestResult(testInfo, testName, groupedSingleThreadTotals.numberOfErrors, numGroupedErrors, error_tolerance);
+        testName = "Test grouped batch mortality stand totals are the same at 1, 2, 3 and 8 threads";
+        reportTestResult(testInfo, testName, isSameTotalsAtAnyThreadCount, true, error_tolerance);
+    }
+
+    // The species' equation plan follows species changes, including to a species that isn't in the table
+    Mortality planMortality(mortality);
+    planMortality.setEquationType(EquationType::crown_scorch);
+    planMortality.setSpeciesCode("PIPO");
+    planMortality.setDBH(12, LengthUnits::Inches);
+    planMortality.setTreeHeight(60, LengthUnits::Feet);
+    planMortality.setCrownRatio(0.5, FractionUnits::Fraction);
+    planMortality.setFlameLengthOrScorchHeightValue(6, LengthUnits::Feet);
+    planMortality.setTreeDensityPerUnitArea(10, AreaUnits::Acres);
+    double pipoProbabilityOfMortality = planMortality.calculateMortality(FractionUnits::Fraction);
+    double pipoBarkThickness = planMortality.getBarkThickness(LengthUnits::Inches);
+    planMortality.setSpeciesCode("NOTASPECIES");
+    testName = "Test mortality for a species missing from the table after a valid one";
+    reportTestResult(testInfo, testName, planMortality.calculateMortality(FractionUnits::Fraction), -1.0, error_tolerance);
+    planMortality.setSpeciesCode("PIPO");
+    testName = "Test mortality is unchanged after switching back to the species";
+    reportTestResult(testInfo, testName, planMortality.calculateMortality(FractionUnits::Fraction), pipoProbabilityOfMortality, error_tolerance);
+    testName = "Test bark thickness from the species' bark equation";
+    reportTestResult(testInfo, testName, pipoBarkThickness > 0 && pipoBarkThickness < 12 * 0.1, true, error_tolerance);
+
+    std::cout << "Finished testing Mortality module\n\n";
+}
+
+void testStandMortalityRunner(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing stand mortality runner\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-12;
+
+    Mortality mortality(behaveRun.mortality);
+    mortality.setRegion(RegionCode::interior_west);
+
+    // Three stands of mixed species and equation types, one with a tree of an unknown species
+    const string speciesCodes[] = { "ABBA", "PIPO", "PSME", "ACRU", "PIPO", "NOTASPECIES" };
+    const EquationType equationTypes[] = { EquationType::crown_scorch, EquationType::crown_scorch,
+        EquationType::crown_scorch, EquationType::bole_char, EquationType::crown_damage, EquationType::crown_scorch };
+    const int numberOfSpecies = sizeof(equationTypes) / sizeof(equationTypes[0]);
+    const int standIds[] = { 10, 20, 30 };
+    const int numberOfStands = 3;
+    vector<vector<int>> speciesTableIndex(numberOfStands);
+    vector<vector<EquationType>> equationType(numberOfStands);
+    vector<vector<double>> treeDensityPerAcre(numberOfStands);
+    vector<vector<double>> dbh(numberOfStands);
+    vector<vector<double>> treeHeight(numberOfStands);
+    vector<vector<double>> crownRatio(numberOfStands);
+    vector<vector<double>> crownDamage(numberOfStands);
+    vector<vector<double>> cambiumKillRating(numberOfStands);
+    vector<vector<BeetleDamage>> beetleDamage(numberOfStands);
+    vector<vector<double>> boleCharHeight(numberOfStands);
+    StandMortalityRunner runner(mortality);
+    for(int stand = 0; stand < numberOfStands; stand++)
+    {
+        const int numberOfTrees = 20 + 15 * stand;
+        for(int i = 0; i < numberOfTrees; i++)
+        {
+            int species = (i * (stand + 1)) % (numberOfSpecies - (stand < 2));
+            speciesTableIndex[stand].push_back(behaveRun.mortality.getSpeciesTableIndexFromSpeciesCodeAndEquationType(speciesCodes[species],
+                equationTypes[species]));
+            equationType[stand].push_back(equationTypes[species]);
+            treeDensityPerAcre[stand].push_back(5 + (i % 11));
+            dbh[stand].push_back(2 + ((i + stand) % 29));
+            treeHeight[stand].push_back(15 + (i % 37) * 2);
+            crownRatio[stand].push_back(0.2 + (i % 7) * 0.1);
+            crownDamage[stand].push_back((i % 10) * 10);
+            cambiumKillRating[stand].push_back(i % 5);
+            beetleDamage[stand].push_back((i % 2) ? BeetleDamage::yes : BeetleDamage::no);
+            boleCharHeight[stand].push_back(1 + (i % 9));
+        }
+        MortalityBatchInputs trees = { numberOfTrees, speciesTableIndex[stand].data(), equationType[stand].data(),
+            treeDensityPerAcre[stand].data(), dbh[stand].data(), treeHeight[stand].data(), crownRatio[stand].data(), nullptr, nullptr,
+            crownDamage[stand].data(), cambiumKillRating[stand].data(), beetleDamage[stand].data(), boleCharHeight[stand].data() };
+        runner.addStand(standIds[stand], trees);
+    }
+    testName = "Test stand mortality runner keeps one tree list per stand";
+    reportTestResult(testInfo, testName, runner.getNumberOfStands(), numberOfStands, error_tolerance);
+
+    // Stands in blocks of columns, fireline intensity rising down the rows, with an unburned pixel,
+    // a no-data pixel and a pixel of a stand that wasn't added
+    const int numberOfRows = 40;
+    const int numberOfColumns = 30;
+    const int numberOfPixels = numberOfRows * numberOfColumns;
+    const double noDataValue = -9999.0;
+    vector<int> standIdBand(numberOfPixels);
+    vector<double> firelineIntensity(numberOfPixels);
+    vector<double> midflameWindSpeed(numberOfPixels);
+    for(int pixel = 0; pixel < numberOfPixels; pixel++)
+    {
+        int row = pixel / numberOfColumns;
+        int column = pixel % numberOfColumns;
+        standIdBand[pixel] = standIds[column / 10];
+        firelineIntensity[pixel] = 2.0 * row * row + (column % 3);
+        midflameWindSpeed[pixel] = 88.0 * (1 + column % 4);
+    }
+    firelineIntensity[0] = 0.0;
+    firelineIntensity[1] = noDataValue;
+    standIdBand[2] = 99;
+
+    StandMortalityInputBands inputs;
+    inputs.numberOfRows = numberOfRows;
+    inputs.numberOfColumns = numberOfColumns;
+    inputs.noDataValue = noDataValue;
+    inputs.standId = standIdBand.data();
+    inputs.firelineIntensity = { firelineIntensity.data(), 0.0 };
+    inputs.midflameWindSpeed = { midflameWindSpeed.data(), 0.0 };
+    inputs.airTemperature = { nullptr, 85.0 };
+    vector<double> basalAreaMortality(numberOfPixels, -1.0);
+    vector<double> stemMortality(numberOfPixels, -1.0);
+    StandMortalityOutputBands outputs = { noDataValue, basalAreaMortality.data(), stemMortality.data() };
+    runner.setNumberOfThreads(4);
+    runner.run(inputs, outputs);
+
+    // Every burned pixel must match its stand's trees run one by one at the pixel's scorch height
+    int numberOfMismatches = 0;
+    int numberOfPartlyKilledPixels = 0;
+    for(int pixel = 3; pixel < numberOfPixels; pixel += 7)
+    {
+        if(firelineIntensity[pixel] <= 0.0)
+        {
+            numberOfMismatches += (basalAreaMortality[pixel] != 0.0) || (stemMortality[pixel] != 0.0);
+            continue;
+        }
+        int stand = (pixel % numberOfColumns) / 10;
+        double scorchHeight = mortality.calculateScorchHeight(firelineIntensity[pixel], FirelineIntensityUnits::BtusPerFootPerSecond,
+            midflameWindSpeed[pixel], SpeedUnits::FeetPerMinute, 85.0, TemperatureUnits::Fahrenheit, LengthUnits::Feet);
+        double prefireTrees = 0;
+        double killedTrees = 0;
+        double prefireBasalArea = 0;
+        double killedBasalArea = 0;
+        for(size_t i = 0; i < speciesTableIndex[stand].size(); i++)
+        {
+            if(speciesTableIndex[stand][i] < 0)
+            {
+                continue;
+            }
+            Mortality treeMortality(mortality);
+            treeMortality.setEquationType(equationType[stand][i]);
+            treeMortality.setSpeciesCode(mortality.getSpeciesCodeAtSpeciesTableIndex(speciesTableIndex[stand][i]));
+            treeMortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::scorch_height);
+            treeMortality.setScorchHeight(scorchHeight, LengthUnits::Feet);
+            treeMortality.setTreeDensityPerUnitArea(treeDensityPerAcre[stand][i], AreaUnits::Acres);
+            treeMortality.setDBH(dbh[stand][i], LengthUnits::Inches);
+            treeMortality.setTreeHeight(treeHeight[stand][i], LengthUnits::Feet);
+            treeMortality.setCrownRatio(crownRatio[stand][i], FractionUnits::Fraction);
+            treeMortality.setCrownDamage(crownDamage[stand][i]);
+            treeMortality.setCambiumKillRating(cambiumKillRating[stand][i]);
+            treeMortality.setBeetleDamage(beetleDamage[stand][i]);
+            treeMortality.setBoleCharHeight(boleCharHeight[stand][i], LengthUnits::Feet);
+            if(treeMortality.calculateMortality(FractionUnits::Fraction) >= 0)
+            {
+                prefireTrees += treeDensityPerAcre[stand][i];
+                killedTrees += treeMortality.getKilledTrees();
+                prefireBasalArea += treeMortality.getBasalAreaPrefire();
+                killedBasalArea += treeMortality.getBasalAreaKillled();
+            }
+        }
+        double expectedBasalAreaMortality = killedBasalArea / prefireBasalArea;
+        double expectedStemMortality = killedTrees / prefireTrees;
+        if(fabs(basalAreaMortality[pixel] - expectedBasalAreaMortality) > error_tolerance ||
+            fabs(stemMortality[pixel] - expectedStemMortality) > error_tolerance)
+        {
+            numberOfMismatches++;
+        }
+        numberOfPartlyKilledPixels += (expectedBasalAreaMortality > 0.0) && (expectedBasalAreaMortality < 1.0);
+    }
+    testName = "Test stand mortality runner matches single tree runs";
+    reportTestResult(testInfo, testName, numberOfMismatches, 0, error_tolerance);
+    testName = "Test stand mortality runner has partly killed pixels";
+    reportTestResult(testInfo, testName, numberOfPartlyKilledPixels > 0, true, error_tolerance);
+    testName = "Test stand mortality runner kills nothing in an unburned pixel";
+    reportTestResult(testInfo, testName, basalAreaMortality[0] == 0.0 && stemMortality[0] == 0.0, true, error_tolerance);
+    testName = "Test stand mortality runner sets no-data pixels to no-data";
+    reportTestResult(testInfo, testName, basalAreaMortality[1] == noDataValue && stemMortality[1] == noDataValue &&
+        basalAreaMortality[2] == noDataValue && stemMortality[2] == noDataValue, true, error_tolerance);
+
+    vector<double> singleThreadBasalAreaMortality(numberOfPixels, -1.0);
+    StandMortalityOutputBands singleThreadOutputs = { noDataValue, singleThreadBasalAreaMortality.data(), nullptr };
+    runner.setNumberOfThreads(1);
+    runner.run(inputs, singleThreadOutputs);
+    testName = "Test stand mortality runner does not depend on thread count";
+    reportTestResult(testInfo, testName, singleThreadBasalAreaMortality == basalAreaMortality, true, error_tolerance);
+
+    std::cout << "Finished testing stand mortality runner\n\n";
+}
+
+void testFineDeadFuelMoistureTool(TestInfo& testInfo, BehaveRun& behaveRun)
+{
     int observedReferenceMoisture = 0;
     int observedCorrectionMoisture = 0;
     int observedFineDeadFuelMoisture = 0;
@@ -1780,6 +4166,94 @@ void testFineDeadFuelMoistureTool(TestInfo& testInfo, BehaveRun& behaveRun)
     testName = "Test fine dead fuel moisture all indices out of bounds\n";
     reportTestResult(testInfo, testName, observedFineDeadFuelMoisture, expectedFineDeadFuelMoisture, error_tolerance);
 
+    // The batch calculation must classify continuous inputs into the same indices
+    const int numberOfCells = 3000;
+    const int monthForIndex[3] = { 6, 9, 12 };
+    std::vector<int> cellIndices(numberOfCells * 8);
+    std::vector<double> batchAspect(numberOfCells);
+    std::vector<double> batchSlope(numberOfCells);
+    std::vector<double> batchShading(numberOfCells);
+    std::vector<double> batchDryBulb(numberOfCells);
+    std::vector<double> batchRelativeHumidity(numberOfCells);
+    std::vector<double> batchElevationDifference(numberOfCells);
+    std::vector<int> batchMonth(numberOfCells);
+    std::vector<double> batchHourOfDay(numberOfCells);
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        int* indices = &cellIndices[i * 8];
+        indices[0] = i % 4;
+        indices[1] = (i / 4) % 6;
+        indices[2] = (i / 24) % 3;
+        indices[3] = (i / 7) % 3;
+        indices[4] = (i * 7) % 21;
+        indices[5] = (i / 3) % 2;
+        indices[6] = (i / 5) % 2;
+        indices[7] = (i / 11) % 6;
+        batchAspect[i] = indices[0] * 90.0 - 44.0 + (i % 89);
+        batchDryBulb[i] = 10.0 + indices[1] * 20.0 + (i % 20) * 0.99;
+        batchElevationDifference[i] = (indices[2] - 1) * 1000.0 + ((indices[2] == 1) ? (i % 3 - 1) * 1000.0 : (indices[2] - 1) * (1.0 + i % 1000));
+        batchMonth[i] = monthForIndex[indices[3]];
+        batchRelativeHumidity[i] = (indices[4] == 20) ? 1.0 : (indices[4] * 5 + i % 5) / 100.0;
+        batchShading[i] = indices[5] ? 0.5 + (i % 6) * 0.1 : (i % 5) * 0.1;
+        batchSlope[i] = indices[6] ? 17.0 + (i % 30) : (i % 17);
+        batchHourOfDay[i] = 8.0 + indices[7] * 2.0 + (i % 4) * 0.5;
+    }
+    FDFMToolBatchInputs moistureBatchInputs = { numberOfCells, batchAspect.data(), batchSlope.data(), batchShading.data(),
+        batchDryBulb.data(), batchRelativeHumidity.data(), batchElevationDifference.data(), batchMonth.data(), batchHourOfDay.data(), 0, 0.0 };
+    std::vector<int> batchReferenceMoisture(numberOfCells);
+    std::vector<int> batchCorrectionMoisture(numberOfCells);
+    std::vector<int> batchFineDeadFuelMoisture(numberOfCells);
+    std::vector<double> batchMoistureOneHour(numberOfCells);
+    FDFMToolBatchOutputs moistureBatchOutputs = { batchReferenceMoisture.data(), batchCorrectionMoisture.data(),
+        batchFineDeadFuelMoisture.data(), batchMoistureOneHour.data() };
+    behaveRun.fineDeadFuelMoistureTool.calculateBatch(moistureBatchInputs, moistureBatchOutputs);
+    int numMoistureMismatches = 0;
+    FineDeadFuelMoistureTool singleCellTool;
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        const int* indices = &cellIndices[i * 8];
+        singleCellTool.calculateByIndex(indices[0], indices[1], indices[2], indices[3], indices[4], indices[5], indices[6], indices[7]);
+        numMoistureMismatches += (batchReferenceMoisture[i] != singleCellTool.getReferenceMoisture()) ||
+            (batchCorrectionMoisture[i] != singleCellTool.getCorrectionMoisture()) ||
+            (batchFineDeadFuelMoisture[i] != singleCellTool.getFineDeadFuelMoisture()) ||
+            (fabs(batchMoistureOneHour[i] - singleCellTool.getFineDeadFuelMoisture() / 100.0) > 1.0e-12);
+    }
+    testName = "Test batch fine dead fuel moisture agrees with single cells";
+    reportTestResult(testInfo, testName, numMoistureMismatches, 0, error_tolerance);
+
+    // One month and hour for every cell
+    moistureBatchInputs.month = nullptr;
+    moistureBatchInputs.hourOfDay = nullptr;
+    moistureBatchInputs.allCellsMonth = 7;
+    moistureBatchInputs.allCellsHourOfDay = 14.5;
+    behaveRun.fineDeadFuelMoistureTool.calculateBatch(moistureBatchInputs, moistureBatchOutputs);
+    numMoistureMismatches = 0;
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        const int* indices = &cellIndices[i * 8];
+        singleCellTool.calculateByIndex(indices[0], indices[1], indices[2], FDFMToolMonthIndex::MAY_JUNE_JULY, indices[4], indices[5], indices[6],
+            FDFMToolTimeOfDayIndex::FOURTEEN_HUNDRED_HOURS_TO_FIFTEEN_HUNDRED_FIFTY_NINE);
+        numMoistureMismatches += (batchFineDeadFuelMoisture[i] != singleCellTool.getFineDeadFuelMoisture());
+    }
+    testName = "Test batch fine dead fuel moisture with one month and hour for all cells";
+    reportTestResult(testInfo, testName, numMoistureMismatches, 0, error_tolerance);
+
+    // Inputs outside the tables
+    batchDryBulb[0] = 5.0;
+    batchRelativeHumidity[1] = 1.2;
+    batchElevationDifference[2] = -2500.0;
+    batchSlope[3] = -1.0;
+    batchShading[4] = 1.5;
+    moistureBatchInputs.numberOfCells = 5;
+    behaveRun.fineDeadFuelMoistureTool.calculateBatch(moistureBatchInputs, moistureBatchOutputs);
+    int numInvalidCells = 0;
+    for(int i = 0; i < 5; i++)
+    {
+        numInvalidCells += (batchFineDeadFuelMoisture[i] == -1) && (batchReferenceMoisture[i] == -1) && (batchMoistureOneHour[i] == -1.0);
+    }
+    testName = "Test batch fine dead fuel moisture for inputs outside the tables";
+    reportTestResult(testInfo, testName, numInvalidCells, 5, error_tolerance);
+
     std::cout << "Finished testing Fine Dead Fuel Moisture Tool\n\n";
 }
 
@@ -1824,8 +4298,8 @@ void testSlopeTool(TestInfo& testInfo, BehaveRun& behaveRun)
 
     testName = "Test slope elevation change from map measurements, imperial units";
     expectedSlopeElevationChange = 205.0;
-    observedSlopeSteepnessPercent = std::round(behaveRun.slopeTool.getSlopeElevationChangeFromMapMeasurements(LengthUnits::Feet));
-    reportTestResult(testInfo, testName, observedSlopeSteepnessPercent, expectedSlopeElevationChange, error_tolerance);
+    observedSlopeElevationChange = std::round(behaveRun.slopeTool.getSlopeElevationChangeFromMapMeasurements(slopeElevationUnits));
+    reportTestResult(testInfo, testName, observedSlopeElevationChange, expectedSlopeElevationChange, error_tolerance);
 
     testName = "Test slope horizontal distance from map measurements, imperial units";
     expectedSlopeDistance = 594.0;
@@ -1854,8 +4328,8 @@ void testSlopeTool(TestInfo& testInfo, BehaveRun& behaveRun)
 
     testName = "Test slope elevation change from map measurements, metric units";
     expectedSlopeElevationChange = 82.0;
-    observedSlopeSteepnessPercent = std::round(behaveRun.slopeTool.getSlopeElevationChangeFromMapMeasurements(LengthUnits::Meters));
-    reportTestResult(testInfo, testName, observedSlopeSteepnessPercent, expectedSlopeElevationChange, error_tolerance);
+    observedSlopeElevationChange = std::round(behaveRun.slopeTool.getSlopeElevationChangeFromMapMeasurements(slopeElevationUnits));
+    reportTestResult(testInfo, testName, observedSlopeElevationChange, expectedSlopeElevationChange, error_tolerance);
 
     testName = "Test slope horizontal distance from map measurements, metric units";
     expectedSlopeDistance = 119.0;
@@ -1986,3 +4460,4343 @@ void testSimpleSurface(TestInfo& testInfo, BehaveRun& behaveRun)
     observedRateofSpread = roundToSixDecimalPlaces(behaveRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond));
     reportTestResult(testInfo, testName, observedRateofSpread, expectedRateofSpread, error_tolerance);
 }
+
+void testExpectedSpreadRate(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing EXRATE expected spread rate\n";
+
+    string testName = "";
+    double expectedRos = 0.0;
+    double observedRos = 0.0;
+    double expectedHarmonicRos = 0.0;
+    double observedHarmonicRos = 0.0;
+    double maxRos = 0.0;
+
+    int threadCounts[] = { 1, 4 };
+    for (int threadCount : threadCounts)
+    {
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(3);
+        randFuel.setFuelData(0, 10.0, 0.5);
+        randFuel.setFuelData(1, 3.0, 0.3);
+        randFuel.setFuelData(2, 1.0, 0.2);
+
+        testName = "Test expected relative spread rate, 3x3 block, " + std::to_string(threadCount) + " thread(s)";
+        expectedRos = 0.731890;
+        observedRos = roundToSixDecimalPlaces(randFuel.computeSpread2(3, 3, 2.0, threadCount, &maxRos, &observedHarmonicRos, 0, 0));
+        reportTestResult(testInfo, testName, observedRos, expectedRos, error_tolerance);
+
+        testName = "Test harmonic relative spread rate, 3x3 block, " + std::to_string(threadCount) + " thread(s)";
+        expectedHarmonicRos = 0.628947;
+        observedHarmonicRos = roundToSixDecimalPlaces(observedHarmonicRos);
+        reportTestResult(testInfo, testName, observedHarmonicRos, expectedHarmonicRos, error_tolerance);
+    }
+
+    // Lateral extensions go through calcExtendedSpreadRates2, use an odd thread count so chunks get stolen
+    int extensionThreadCounts[] = { 1, 3 };
+    for (int threadCount : extensionThreadCounts)
+    {
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(3);
+        randFuel.setFuelData(0, 10.0, 0.5);
+        randFuel.setFuelData(1, 3.0, 0.3);
+        randFuel.setFuelData(2, 1.0, 0.2);
+
+        testName = "Test expected relative spread rate, 2x2 block, 1 lateral extension, " + std::to_string(threadCount) + " thread(s)";
+        expectedRos = 0.735363;
+        observedRos = roundToSixDecimalPlaces(randFuel.computeSpread2(2, 2, 2.0, threadCount, &maxRos, &observedHarmonicRos, 1, 0));
+        reportTestResult(testInfo, testName, observedRos, expectedRos, error_tolerance);
+
+        testName = "Test harmonic relative spread rate, 2x2 block, 1 lateral extension, " + std::to_string(threadCount) + " thread(s)";
+        expectedHarmonicRos = 0.608982;
+        observedHarmonicRos = roundToSixDecimalPlaces(observedHarmonicRos);
+        reportTestResult(testInfo, testName, observedHarmonicRos, expectedHarmonicRos, error_tolerance);
+    }
+
+    // A path memory limit too small for the block makes the run fail instead of growing without bound
+    {
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(3);
+        randFuel.setFuelData(0, 10.0, 0.5);
+        randFuel.setFuelData(1, 3.0, 0.3);
+        randFuel.setFuelData(2, 1.0, 0.2);
+
+        randFuel.setPathMemoryLimit(1024 * 1024);
+        testName = "Test expected relative spread rate, 3x3 block, path memory limit not reached";
+        expectedRos = 0.731890;
+        observedRos = roundToSixDecimalPlaces(randFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &observedHarmonicRos, 0, 0));
+        reportTestResult(testInfo, testName, observedRos, expectedRos, error_tolerance);
+
+        // a fresh instance, since randFuel would reuse its cached max spread rates
+        RandFuel limitedRandFuel;
+        limitedRandFuel.setCellDimensions(10);
+        limitedRandFuel.allocFuels(3);
+        limitedRandFuel.setFuelData(0, 10.0, 0.5);
+        limitedRandFuel.setFuelData(1, 3.0, 0.3);
+        limitedRandFuel.setFuelData(2, 1.0, 0.2);
+        limitedRandFuel.setPathMemoryLimit(64);
+        testName = "Test expected relative spread rate, 3x3 block, path memory limit exceeded";
+        expectedRos = -1.0;
+        observedRos = roundToSixDecimalPlaces(limitedRandFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &observedHarmonicRos, 0, 0));
+        reportTestResult(testInfo, testName, observedRos, expectedRos, error_tolerance);
+    }
+
+    // Changing only fuel fractions reuses the cached max spread rates: the rerun does not need
+    // any spread paths, so it succeeds under a path memory limit and matches a fresh run
+    {
+        RandFuel freshRandFuel;
+        freshRandFuel.setCellDimensions(10);
+        freshRandFuel.allocFuels(3);
+        freshRandFuel.setFuelData(0, 10.0, 0.2);
+        freshRandFuel.setFuelData(1, 3.0, 0.3);
+        freshRandFuel.setFuelData(2, 1.0, 0.5);
+        double freshHarmonicRos = 0.0;
+        expectedRos = roundToSixDecimalPlaces(freshRandFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &freshHarmonicRos, 0, 0));
+
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(3);
+        randFuel.setFuelData(0, 10.0, 0.5);
+        randFuel.setFuelData(1, 3.0, 0.3);
+        randFuel.setFuelData(2, 1.0, 0.2);
+        randFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &observedHarmonicRos, 0, 0);
+        randFuel.setFuelData(0, 10.0, 0.2);
+        randFuel.setFuelData(1, 3.0, 0.3);
+        randFuel.setFuelData(2, 1.0, 0.5);
+        randFuel.setPathMemoryLimit(64);
+
+        testName = "Test expected relative spread rate after changing only fuel fractions";
+        observedRos = roundToSixDecimalPlaces(randFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &observedHarmonicRos, 0, 0));
+        reportTestResult(testInfo, testName, observedRos, expectedRos, error_tolerance);
+
+        testName = "Test harmonic relative spread rate after changing only fuel fractions";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(observedHarmonicRos), roundToSixDecimalPlaces(freshHarmonicRos), error_tolerance);
+
+        randFuel.setFuelData(1, 4.0, 0.3);
+        testName = "Test expected relative spread rate is recomputed after changing a fuel spread rate";
+        observedRos = roundToSixDecimalPlaces(randFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &observedHarmonicRos, 0, 0));
+        reportTestResult(testInfo, testName, observedRos, -1.0, error_tolerance);
+    }
+
+    // Sampled arrangements estimate the enumerated 3x3 result within the reported interval,
+    // and the same seed gives the same estimate whatever the thread count
+    {
+        double sampledRos[2] = { 0.0, 0.0 };
+        double expectedInterval = 0.0;
+        double harmonicInterval = 0.0;
+        int sampledThreadCounts[] = { 1, 4 };
+        for (int t = 0; t < 2; t++)
+        {
+            RandFuel randFuel;
+            randFuel.setCellDimensions(10);
+            randFuel.allocFuels(3);
+            randFuel.setFuelData(0, 10.0, 0.5);
+            randFuel.setFuelData(1, 3.0, 0.3);
+            randFuel.setFuelData(2, 1.0, 0.2);
+            sampledRos[t] = randFuel.computeSpreadSampled(3, 3, 2.0, sampledThreadCounts[t], 4000, 1234,
+                &maxRos, &observedHarmonicRos, &expectedInterval, &harmonicInterval);
+        }
+
+        testName = "Test sampled expected relative spread rate is within its interval of the enumerated rate";
+        bool isWithinInterval = (expectedInterval > 0.0) && (fabs(sampledRos[0] - 0.731890) <= expectedInterval);
+        reportTestResult(testInfo, testName, isWithinInterval, true, error_tolerance);
+
+        testName = "Test sampled harmonic relative spread rate is within its interval of the enumerated rate";
+        isWithinInterval = (harmonicInterval > 0.0) && (fabs(observedHarmonicRos - 0.628947) <= harmonicInterval);
+        reportTestResult(testInfo, testName, isWithinInterval, true, error_tolerance);
+
+        testName = "Test sampled expected relative spread rate does not depend on thread count";
+        reportTestResult(testInfo, testName, sampledRos[1], sampledRos[0], error_tolerance);
+    }
+
+    // Two fuel types: the spread rates by number of first fuel cells give the expected
+    // spread rate at any fraction
+    {
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(2);
+        randFuel.setFuelData(0, 10.0, 0.5);
+        randFuel.setFuelData(1, 3.0, 0.5);
+        double countRos[5];
+        observedRos = randFuel.computeSpreadByFuelCount(2, 2, 2.5, 1, &maxRos, countRos);
+        testName = "Test EXRATE expected spread rate by fuel count matches computeSpread2";
+        expectedRos = randFuel.computeSpread2(2, 2, 2.5, 1, &maxRos, nullptr, 0, 0);
+        reportTestResult(testInfo, testName, observedRos, expectedRos, error_tolerance);
+        testName = "Test EXRATE spread rate by fuel count with only the slower fuel";
+        reportTestResult(testInfo, testName, countRos[0], 0.3, error_tolerance);
+        testName = "Test EXRATE spread rate by fuel count with only the faster fuel";
+        reportTestResult(testInfo, testName, countRos[4], 1.0, error_tolerance);
+
+        const double fraction = 0.37;
+        const double binomials[] = { 1, 4, 6, 4, 1 };
+        double polynomialRos = 0.0;
+        for (int k = 0; k <= 4; k++)
+        {
+            polynomialRos += binomials[k] * pow(fraction, k) * pow(1.0 - fraction, 4 - k) * countRos[k];
+        }
+        randFuel.setFuelData(0, 10.0, fraction);
+        randFuel.setFuelData(1, 3.0, 1.0 - fraction);
+        testName = "Test EXRATE spread rate by fuel count gives the expected spread rate at another fraction";
+        expectedRos = randFuel.computeSpread2(2, 2, 2.5, 1, &maxRos, nullptr, 0, 0);
+        reportTestResult(testInfo, testName, polynomialRos, expectedRos, error_tolerance);
+    }
+
+    // A cancelled RunControl stops both the enumerated and the sampled runs, and counts
+    // the combinations of a run that finishes
+    {
+        RunControl runControl;
+        RandFuel randFuel;
+        randFuel.setCellDimensions(10);
+        randFuel.allocFuels(3);
+        randFuel.setFuelData(0, 10.0, 0.5);
+        randFuel.setFuelData(1, 3.0, 0.3);
+        randFuel.setFuelData(2, 1.0, 0.2);
+        randFuel.setRunControl(&runControl);
+        randFuel.computeSpread2(2, 2, 2.0, 2, &maxRos, &observedHarmonicRos, 0, 0);
+        testName = "Test EXRATE run with a RunControl reports all combinations done";
+        reportTestResult(testInfo, testName, runControl.getProgress(), 1.0, error_tolerance);
+
+        runControl.cancel();
+        testName = "Test cancelled EXRATE run returns -1";
+        observedRos = randFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &observedHarmonicRos, 0, 0);
+        reportTestResult(testInfo, testName, observedRos, -1.0, error_tolerance);
+        testName = "Test cancelled sampled EXRATE run returns -1";
+        observedRos = randFuel.computeSpreadSampled(3, 3, 2.0, 2, 100, 1234, &maxRos, &observedHarmonicRos, nullptr, nullptr);
+        reportTestResult(testInfo, testName, observedRos, -1.0, error_tolerance);
+        testName = "Test RunControl status after cancel";
+        reportTestResult(testInfo, testName, runControl.getStatus(), RunStatus::Cancelled, error_tolerance);
+
+        runControl.reset();
+        testName = "Test RunControl is not stopped after reset";
+        reportTestResult(testInfo, testName, runControl.isStopRequested(), false, error_tolerance);
+    }
+
+    // Block arrays hold every block in one zero-filled row-major allocation
+    {
+        RandBlockArray blockArray;
+        blockArray.alloc(3, 4);
+        bool isContiguous = (blockArray[1] == blockArray.data() + 4)
+            && (blockArray[2] == blockArray.data() + 8);
+        bool isZeroFilled = true;
+        for (long i = 0; i < blockArray.blocks() * blockArray.stride(); i++)
+        {
+            isZeroFilled = isZeroFilled && (blockArray.data()[i] == 0.0);
+        }
+        testName = "Test EXRATE block array is contiguous and zero filled";
+        reportTestResult(testInfo, testName, isContiguous && isZeroFilled, true, error_tolerance);
+
+        blockArray.free();
+        testName = "Test EXRATE block array is empty after free";
+        reportTestResult(testInfo, testName, (blockArray.data() == 0) && (blockArray.blocks() == 0), true, error_tolerance);
+    }
+
+    // Fast lateral sweeps agree with the scalar flanking times, on wide sampled blocks where the
+    // sweeps are long, on the exhaustive 3x3 block and with lateral extensions
+    {
+        double exactRos[3];
+        double fastRos[3];
+        double exactHarmonicRos[3];
+        double fastHarmonicRos[3];
+        const VectorMathMode::VectorMathModeEnum modes[] = { VectorMathMode::Exact, VectorMathMode::Fast };
+        for (int mode = 0; mode < 2; mode++)
+        {
+            double* ros = (mode == 0) ? exactRos : fastRos;
+            double* harmonicRos = (mode == 0) ? exactHarmonicRos : fastHarmonicRos;
+            RandFuel randFuel;
+            randFuel.setCellDimensions(10);
+            randFuel.allocFuels(3);
+            randFuel.setFuelData(0, 10.0, 0.5);
+            randFuel.setFuelData(1, 3.0, 0.3);
+            randFuel.setFuelData(2, 1.0, 0.2);
+            randFuel.setVectorMathMode(modes[mode]);
+            ros[0] = randFuel.computeSpreadSampled(12, 4, 3.0, 3, 300, 1234, &maxRos, &harmonicRos[0], nullptr, nullptr);
+            ros[1] = randFuel.computeSpread2(3, 3, 2.0, 2, &maxRos, &harmonicRos[1], 0, 0);
+            ros[2] = randFuel.computeSpread2(2, 2, 2.0, 2, &maxRos, &harmonicRos[2], 1, 0);
+        }
+        double largestDifference = 0.0;
+        for (int run = 0; run < 3; run++)
+        {
+            largestDifference = std::max(largestDifference, fabs(fastRos[run] - exactRos[run]) / exactRos[run]);
+            largestDifference = std::max(largestDifference, fabs(fastHarmonicRos[run] - exactHarmonicRos[run]) / exactHarmonicRos[run]);
+        }
+        testName = "Test EXRATE fast lateral sweeps match the scalar flanking times";
+        reportTestResult(testInfo, testName, largestDifference < 1e-12 && exactRos[0] > 0.0, true, error_tolerance);
+        testName = "Test EXRATE fast lateral sweeps keep the 3x3 block result";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(fastRos[1]), 0.731890, error_tolerance);
+    }
+
+    // Extension max spread rates only depend on the fuel spread rates, so a rerun with new fractions reuses them
+    {
+        RandFuel memoFuel;
+        memoFuel.setCellDimensions(10);
+        memoFuel.allocFuels(3);
+        memoFuel.setFuelData(0, 10.0, 0.5);
+        memoFuel.setFuelData(1, 3.0, 0.3);
+        memoFuel.setFuelData(2, 1.0, 0.2);
+        double memoHarmonicRos = 0.0;
+        double memoRos = memoFuel.computeSpread2(2, 2, 2.0, 2, &maxRos, &memoHarmonicRos, 1, 0);
+        testName = "Test EXRATE extension memo keeps the 2x2 block, 1 lateral extension result";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(memoRos), 0.735363, error_tolerance);
+        testName = "Test EXRATE extension memo keeps the 2x2 block, 1 lateral extension harmonic result";
+        reportTestResult(testInfo, testName, roundToSixDecimalPlaces(memoHarmonicRos), 0.608982, error_tolerance);
+        testName = "Test EXRATE extension memo stores the extension spread rates";
+        reportTestResult(testInfo, testName, memoFuel.getExtensionMemoEntries() > 0, true, error_tolerance);
+
+        memoFuel.setFuelData(0, 10.0, 0.2);
+        memoFuel.setFuelData(1, 3.0, 0.3);
+        memoFuel.setFuelData(2, 1.0, 0.5);
+        memoRos = memoFuel.computeSpread2(2, 2, 2.0, 2, &maxRos, &memoHarmonicRos, 1, 0);
+        testName = "Test EXRATE extension memo is used when only the fuel fractions change";
+        reportTestResult(testInfo, testName, memoFuel.getExtensionMemoHits() > 0, true, error_tolerance);
+
+        RandFuel freshFuel;
+        freshFuel.setCellDimensions(10);
+        freshFuel.allocFuels(3);
+        freshFuel.setFuelData(0, 10.0, 0.2);
+        freshFuel.setFuelData(1, 3.0, 0.3);
+        freshFuel.setFuelData(2, 1.0, 0.5);
+        freshFuel.setExtensionMemoLimit(0);
+        double freshHarmonicRos = 0.0;
+        double freshRos = freshFuel.computeSpread2(2, 2, 2.0, 2, &maxRos, &freshHarmonicRos, 1, 0);
+        testName = "Test EXRATE extension memo rerun matches a run without the memo";
+        reportTestResult(testInfo, testName, fabs(memoRos - freshRos) < 1e-12 && fabs(memoHarmonicRos - freshHarmonicRos) < 1e-12, true, error_tolerance);
+        testName = "Test EXRATE extension memo limit of zero stores nothing";
+        reportTestResult(testInfo, testName, freshFuel.getExtensionMemoEntries(), 0, error_tolerance);
+    }
+
+    std::cout << "Finished testing EXRATE expected spread rate\n\n";
+}
+
+void testCsvReader(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing CSV reader\n";
+
+    string testName = "";
+    double error_tolerance = 1e-06;
+
+    // Long enough to make the reader grow its buffer past one block
+    string longField(3 << 20, 'x');
+    const string fileName = "testCsvReader.csv";
+    {
+        std::ofstream file(fileName, std::ios::out | std::ios::binary);
+        file << "PlotId, Diameter ,Species\r\n";
+        file << "CS-1,12.5,PIPO,\n";
+        file << "CS-2,,  abba\n";
+        file << longField << ",-3,NA\n";
+        file << "CS-4,1e2,7";
+    }
+
+    CsvReader reader(fileName);
+    testName = "Test CSV reader opens file";
+    reportTestResult(testInfo, testName, reader.isOpen(), true, error_tolerance);
+
+    reader.readRow();
+    testName = "Test CSV reader header field count";
+    reportTestResult(testInfo, testName, reader.getNumberOfFields(), 3, error_tolerance);
+    testName = "Test CSV reader strips carriage return and trims fields";
+    reportTestResult(testInfo, testName, reader.getField(1).trimmed().equals("Diameter") && reader.getField(2).equals("Species"), true, error_tolerance);
+
+    double value = 0;
+    reader.readRow();
+    testName = "Test CSV reader counts field after trailing comma";
+    reportTestResult(testInfo, testName, reader.getNumberOfFields(), 4, error_tolerance);
+    testName = "Test CSV reader parses double";
+    reportTestResult(testInfo, testName, reader.getField(1).toDouble(value) ? value : -1, 12.5, error_tolerance);
+
+    reader.readRow();
+    value = 99;
+    testName = "Test CSV reader rejects empty number";
+    reportTestResult(testInfo, testName, reader.getField(1).toDouble(value) || value != 99, false, error_tolerance);
+    testName = "Test CSV reader rejects text as number";
+    reportTestResult(testInfo, testName, reader.getField(2).trimmed().toDouble(value), false, error_tolerance);
+
+    int intValue = 0;
+    reader.readRow();
+    testName = "Test CSV reader reads field longer than its buffer";
+    reportTestResult(testInfo, testName, reader.getField(0).size() == longField.size() && reader.getField(0).data()[longField.size() - 1] == 'x', true, error_tolerance);
+    testName = "Test CSV reader parses negative int";
+    reportTestResult(testInfo, testName, reader.getField(1).toInt(intValue) ? intValue : 0, -3, error_tolerance);
+
+    reader.readRow();
+    testName = "Test CSV reader reads last row without line ending";
+    reportTestResult(testInfo, testName, reader.getField(1).toDouble(value) ? value : -1, 100, error_tolerance);
+    testName = "Test CSV reader rejects double as int";
+    reportTestResult(testInfo, testName, reader.getField(1).toInt(intValue), false, error_tolerance);
+    testName = "Test CSV reader field past end of row is empty";
+    reportTestResult(testInfo, testName, reader.getField(5).empty(), true, error_tolerance);
+
+    testName = "Test CSV reader stops at end of file";
+    reportTestResult(testInfo, testName, reader.readRow(), false, error_tolerance);
+    testName = "Test CSV reader row count";
+    reportTestResult(testInfo, testName, reader.getRowNumber(), 5, error_tolerance);
+
+    std::remove(fileName.c_str());
+
+    std::cout << "Finished testing CSV reader\n\n";
+}
+
+void testLazyBehaveRun(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing lazily constructed BehaveRun\n";
+
+    string testName = "";
+
+    const FuelModels fuelModels;
+    SpeciesMasterTable speciesMasterTable;
+    speciesMasterTable.initializeMasterTable();
+
+    setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
+    behaveRun.surface.setFuelModelNumber(124);
+    behaveRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    double expectedSpreadRate = behaveRun.surface.getSpreadRate(SpeedUnits::ChainsPerHour);
+
+    // Workers on separate threads share the same fuel models and species table
+    const int numberOfWorkers = 4;
+    LazyBehaveRun prototype(fuelModels, speciesMasterTable);
+    prototype.surface() = behaveRun.surface;
+    vector<LazyBehaveRun> workers(numberOfWorkers, prototype);
+    vector<double> spreadRates(numberOfWorkers, 0.0);
+    vector<int> speciesIndices(numberOfWorkers, -1);
+    ThreadPool threadPool(numberOfWorkers);
+    vector<std::function<void()>> tasks;
+    for(int i = 0; i < numberOfWorkers; i++)
+    {
+        tasks.push_back([&workers, &spreadRates, &speciesIndices, i]()
+        {
+            workers[i].surface().doSurfaceRunInDirectionOfMaxSpread();
+            spreadRates[i] = workers[i].surface().getSpreadRate(SpeedUnits::ChainsPerHour);
+            workers[i].mortality().setSpeciesCode("PIPO");
+            speciesIndices[i] = workers[i].mortality().getSpeciesTableIndexFromSpeciesCode("PIPO");
+        });
+    }
+    threadPool.runTasks(tasks);
+
+    int expectedSpeciesIndex = speciesMasterTable.getSpeciesTableIndexFromSpeciesCode("PIPO");
+    for(int i = 0; i < numberOfWorkers; i++)
+    {
+        testName = "Test worker " + std::to_string(i) + " surface spread rate matches BehaveRun";
+        reportTestResult(testInfo, testName, spreadRates[i], expectedSpreadRate, error_tolerance);
+        testName = "Test worker " + std::to_string(i) + " mortality uses the shared species table";
+        reportTestResult(testInfo, testName, speciesIndices[i], expectedSpeciesIndex, error_tolerance);
+    }
+
+    testName = "Test constructing Mortality on an initialized table leaves it unchanged";
+    int numberOfRecords = speciesMasterTable.record_.size();
+    speciesMasterTable.insertRecord("ZZTEST", "Test species", "Test species", 1, 1, 1, 1, -1, -1, -1,
+        EquationType::crown_scorch, CrownDamageEquationCode::not_set);
+    Mortality mortality(speciesMasterTable);
+    reportTestResult(testInfo, testName, speciesMasterTable.record_.size(), numberOfRecords + 1, error_tolerance);
+
+    std::cout << "Finished testing lazily constructed BehaveRun\n\n";
+}
+
+void testSharedThreadPool(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing shared thread pool\n";
+
+    string testName = "";
+
+    ThreadPool::configureShared(3, true);
+    std::shared_ptr<ThreadPool> threadPool = ThreadPool::getShared();
+    testName = "Test shared thread pool takes the configured size";
+    reportTestResult(testInfo, testName, threadPool->getNumberOfThreads(), 3, error_tolerance);
+    testName = "Test shared thread pool is the same pool on every call";
+    reportTestResult(testInfo, testName, ThreadPool::getShared() == threadPool, true, error_tolerance);
+    testName = "Test a run limit caps the shared pool's slots";
+    reportTestResult(testInfo, testName, threadPool->getNumberOfSlots(2), 2, error_tolerance);
+
+    // Every slot is visited once, on its own thread
+    vector<int> visits(threadPool->getNumberOfThreads(), 0);
+    vector<std::thread::id> slotThreads(threadPool->getNumberOfThreads());
+    threadPool->runOnEachSlot([&](int slot)
+    {
+        visits[slot]++;
+        slotThreads[slot] = std::this_thread::get_id();
+    });
+    bool isEachSlotVisitedOnce = true;
+    for(int slot = 0; slot < (int)visits.size(); slot++)
+    {
+        isEachSlotVisitedOnce = isEachSlotVisitedOnce && visits[slot] == 1;
+    }
+    testName = "Test shared thread pool visits each slot once";
+    reportTestResult(testInfo, testName, isEachSlotVisitedOnce, true, error_tolerance);
+    testName = "Test shared thread pool runs slot 0 on the caller";
+    reportTestResult(testInfo, testName, slotThreads[0] == std::this_thread::get_id(), true, error_tolerance);
+
+    // A run started from inside another run on the same pool runs inline instead of deadlocking
+    const long count = 1000;
+    vector<long> sums(threadPool->getNumberOfThreads(), 0);
+    vector<char> isInline(threadPool->getNumberOfThreads(), 1);
+    threadPool->runChunks(count, 50, [&](int slot, long begin, long end)
+    {
+        std::thread::id outerThread = std::this_thread::get_id();
+        threadPool->runChunks(end - begin, 10, [&](int innerSlot, long innerBegin, long innerEnd)
+        {
+            if(innerSlot != 0 || std::this_thread::get_id() != outerThread)
+            {
+                isInline[slot] = 0;
+            }
+            for(long i = begin + innerBegin; i < begin + innerEnd; i++)
+            {
+                sums[slot] += i;
+            }
+        });
+    });
+    long total = 0;
+    bool isEachNestedRunInline = true;
+    for(int slot = 0; slot < (int)sums.size(); slot++)
+    {
+        total += sums[slot];
+        isEachNestedRunInline = isEachNestedRunInline && isInline[slot] == 1;
+    }
+    testName = "Test nested runs on the shared thread pool run inline";
+    reportTestResult(testInfo, testName, isEachNestedRunInline, true, error_tolerance);
+    testName = "Test nested runs on the shared thread pool cover every item";
+    reportTestResult(testInfo, testName, (double)total, (double)(count * (count - 1) / 2), error_tolerance);
+
+    // Batches of different sizes and modes back to back must each run every body exactly
+    // once, workers that wake late must not take part in the next batch
+    {
+        ThreadPool stressThreadPool(4);
+        const int numberOfBatches = 200000;
+        const int maximumBatchSize = 7;
+        int numberOfMiscountedBatches = 0;
+        for(int batch = 0; batch < numberOfBatches; batch++)
+        {
+            vector<std::atomic<int>> runs(maximumBatchSize);
+            for(int i = 0; i < maximumBatchSize; i++)
+            {
+                runs[i] = 0;
+            }
+            int batchSize = 0;
+            switch(batch % 6)
+            {
+            case 0:
+            case 2:
+                batchSize = 2;
+                stressThreadPool.runOnEachSlot([&runs](int slot) { runs[slot]++; }, batchSize);
+                break;
+            case 1:
+            case 3:
+                batchSize = 4;
+                stressThreadPool.runOnEachSlot([&runs](int slot) { runs[slot]++; }, batchSize);
+                break;
+            case 4:
+            {
+                batchSize = 1 + batch % maximumBatchSize;
+                vector<std::function<void()>> tasks;
+                for(int i = 0; i < batchSize; i++)
+                {
+                    tasks.push_back([&runs, i]() { runs[i]++; });
+                }
+                stressThreadPool.runTasks(tasks);
+                break;
+            }
+            default:
+                batchSize = 3;
+                stressThreadPool.runChunks(batchSize, 1, [&runs](int, long begin, long end)
+                {
+                    for(long i = begin; i < end; i++)
+                    {
+                        runs[i]++;
+                    }
+                });
+                break;
+            }
+            for(int i = 0; i < maximumBatchSize; i++)
+            {
+                if(runs[i] != ((i < batchSize) ? 1 : 0))
+                {
+                    numberOfMiscountedBatches++;
+                    break;
+                }
+            }
+        }
+        testName = "Test mixed thread pool batches run each body exactly once";
+        reportTestResult(testInfo, testName, numberOfMiscountedBatches, 0, error_tolerance);
+    }
+
+    // Reconfiguring gives new callers a new pool, holders keep the old one
+    ThreadPool::configureShared(2, false);
+    std::shared_ptr<ThreadPool> resizedThreadPool = ThreadPool::getShared();
+    testName = "Test reconfiguring the shared thread pool resizes it";
+    reportTestResult(testInfo, testName, resizedThreadPool->getNumberOfThreads(), 2, error_tolerance);
+    testName = "Test reconfiguring the shared thread pool leaves holders their pool";
+    reportTestResult(testInfo, testName, threadPool->getNumberOfThreads(), 3, error_tolerance);
+
+    ThreadPool::configureShared(0, false);
+
+    std::cout << "Finished testing shared thread pool\n\n";
+}
+
+void testLandscapeRunner(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing landscape runner\n";
+
+    string testName = "";
+
+    const FuelModels fuelModels;
+    Crown prototype(fuelModels);
+    prototype.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UseCrownRatio);
+
+    // A small landscape with a no-data pixel and a non-burnable pixel, cut into partial tiles
+    const int numberOfRows = 5;
+    const int numberOfColumns = 7;
+    const int numberOfPixels = numberOfRows * numberOfColumns;
+    const double noDataValue = -9999.0;
+    vector<int> fuelModelNumber(numberOfPixels);
+    vector<double> slope(numberOfPixels);
+    vector<double> windSpeed(numberOfPixels);
+    vector<double> canopyBaseHeight(numberOfPixels);
+    for(int i = 0; i < numberOfPixels; i++)
+    {
+        fuelModelNumber[i] = (i % 3 == 0) ? 165 : 124;
+        slope[i] = (i % 5) * 8.0;
+        windSpeed[i] = 88.0 * (5 + i % 7 * 3); // ft/min
+        canopyBaseHeight[i] = 2.0 + (i % 4) * 4.0;
+    }
+    fuelModelNumber[8] = (int)noDataValue;
+    fuelModelNumber[20] = 91; // NB1, urban
+    slope[30] = noDataValue;
+
+    LandscapeInputBands inputs;
+    inputs.numberOfRows = numberOfRows;
+    inputs.numberOfColumns = numberOfColumns;
+    inputs.noDataValue = noDataValue;
+    inputs.fuelModelNumber = fuelModelNumber.data();
+    inputs.slope = { slope.data(), 0.0 };
+    inputs.aspect = { nullptr, 180.0 };
+    inputs.canopyCover = { nullptr, 0.5 };
+    inputs.canopyHeight = { nullptr, 60.0 };
+    inputs.canopyBaseHeight = { canopyBaseHeight.data(), 0.0 };
+    inputs.canopyBulkDensity = { nullptr, 0.02 };
+    inputs.windSpeed = { windSpeed.data(), 0.0 };
+    inputs.windDirection = { nullptr, 45.0 };
+    inputs.moistureOneHour = { nullptr, 0.06 };
+    inputs.moistureTenHour = { nullptr, 0.07 };
+    inputs.moistureHundredHour = { nullptr, 0.08 };
+    inputs.moistureLiveHerbaceous = { nullptr, 0.6 };
+    inputs.moistureLiveWoody = { nullptr, 0.9 };
+    inputs.moistureFoliar = { nullptr, 1.2 };
+
+    // Expected values from one Crown run pixel by pixel
+    Crown crown(prototype);
+    vector<double> expectedSpreadRate(numberOfPixels, 0.0);
+    vector<double> expectedFlameLength(numberOfPixels, 0.0);
+    vector<int> expectedFireType(numberOfPixels, FireType::Surface);
+    vector<double> expectedCrownFractionBurned(numberOfPixels, 0.0);
+    for(int i = 0; i < numberOfPixels; i++)
+    {
+        if(i == 8 || i == 20 || i == 30)
+        {
+            continue;
+        }
+        double crownRatio = (60.0 - canopyBaseHeight[i]) / 60.0;
+        crown.updateCrownInputs(fuelModelNumber[i], 0.06, 0.07, 0.08, 0.6, 0.9, 1.2, FractionUnits::Fraction, windSpeed[i],
+            SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot, 45.0, WindAndSpreadOrientationMode::RelativeToNorth,
+            slope[i], SlopeUnits::Degrees, 180.0, 0.5, FractionUnits::Fraction, 60.0, canopyBaseHeight[i], LengthUnits::Feet,
+            crownRatio, FractionUnits::Fraction, 0.02, DensityUnits::PoundsPerCubicFoot);
+        crown.doCrownRunScottAndReinhardt();
+        expectedSpreadRate[i] = crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+        expectedFlameLength[i] = crown.getFinalFlameLength(LengthUnits::Feet);
+        expectedFireType[i] = crown.getFireType();
+        expectedCrownFractionBurned[i] = crown.getCrownFractionBurned();
+    }
+    expectedSpreadRate[8] = expectedFlameLength[8] = expectedCrownFractionBurned[8] = noDataValue;
+    expectedSpreadRate[30] = expectedFlameLength[30] = expectedCrownFractionBurned[30] = noDataValue;
+    expectedFireType[8] = expectedFireType[30] = (int)noDataValue;
+
+    LandscapeRunner runner(prototype);
+    runner.setTileSize(3);
+    const int threadCounts[] = { 1, 3 };
+    for(int numberOfThreads : threadCounts)
+    {
+        vector<double> spreadRate(numberOfPixels, -1.0);
+        vector<double> flameLength(numberOfPixels, -1.0);
+        vector<int> fireType(numberOfPixels, -1);
+        vector<double> crownFractionBurned(numberOfPixels, -1.0);
+        LandscapeOutputBands outputs;
+        outputs.noDataValue = noDataValue;
+        outputs.spreadRate = spreadRate.data();
+        outputs.flameLength = flameLength.data();
+        outputs.firelineIntensity = nullptr;
+        outputs.fireType = fireType.data();
+        outputs.crownFractionBurned = crownFractionBurned.data();
+
+        runner.setNumberOfThreads(numberOfThreads);
+        runner.run(inputs, outputs);
+
+        bool isSpreadRateMatching = true;
+        bool isFlameLengthMatching = true;
+        bool isFireTypeMatching = true;
+        bool isCrownFractionBurnedMatching = true;
+        for(int i = 0; i < numberOfPixels; i++)
+        {
+            isSpreadRateMatching = isSpreadRateMatching && fabs(spreadRate[i] - expectedSpreadRate[i]) < error_tolerance;
+            isFlameLengthMatching = isFlameLengthMatching && fabs(flameLength[i] - expectedFlameLength[i]) < error_tolerance;
+            isFireTypeMatching = isFireTypeMatching && fireType[i] == expectedFireType[i];
+            isCrownFractionBurnedMatching = isCrownFractionBurnedMatching &&
+                fabs(crownFractionBurned[i] - expectedCrownFractionBurned[i]) < error_tolerance;
+        }
+        string threads = " with " + std::to_string(numberOfThreads) + " thread(s)";
+        testName = "Test landscape spread rates match single Crown runs" + threads;
+        reportTestResult(testInfo, testName, isSpreadRateMatching, true, error_tolerance);
+        testName = "Test landscape flame lengths match single Crown runs" + threads;
+        reportTestResult(testInfo, testName, isFlameLengthMatching, true, error_tolerance);
+        testName = "Test landscape fire types match single Crown runs" + threads;
+        reportTestResult(testInfo, testName, isFireTypeMatching, true, error_tolerance);
+        testName = "Test landscape crown fraction burned matches single Crown runs" + threads;
+        reportTestResult(testInfo, testName, isCrownFractionBurnedMatching, true, error_tolerance);
+        testName = "Test landscape no-data pixels are skipped" + threads;
+        reportTestResult(testInfo, testName, runner.getNumberOfNoDataPixels(), 2, error_tolerance);
+        testName = "Test landscape non-burnable pixels are skipped" + threads;
+        reportTestResult(testInfo, testName, runner.getNumberOfNonBurnablePixels(), 1, error_tolerance);
+    }
+
+    // Float bands give the double results rounded to float, as inputs such as the integer slopes are exact in float
+    vector<float> floatSlope(slope.begin(), slope.end());
+    vector<float> floatWindSpeed(windSpeed.begin(), windSpeed.end());
+    vector<float> floatCanopyBaseHeight(canopyBaseHeight.begin(), canopyBaseHeight.end());
+    LandscapeFloatInputBands floatInputs;
+    floatInputs.numberOfRows = numberOfRows;
+    floatInputs.numberOfColumns = numberOfColumns;
+    floatInputs.noDataValue = noDataValue;
+    floatInputs.fuelModelNumber = fuelModelNumber.data();
+    floatInputs.slope = { floatSlope.data(), 0.0 };
+    floatInputs.aspect = { nullptr, 180.0 };
+    floatInputs.canopyCover = { nullptr, 0.5 };
+    floatInputs.canopyHeight = { nullptr, 60.0 };
+    floatInputs.canopyBaseHeight = { floatCanopyBaseHeight.data(), 0.0 };
+    floatInputs.canopyBulkDensity = { nullptr, 0.02 };
+    floatInputs.windSpeed = { floatWindSpeed.data(), 0.0 };
+    floatInputs.windDirection = { nullptr, 45.0 };
+    floatInputs.moistureOneHour = { nullptr, 0.06 };
+    floatInputs.moistureTenHour = { nullptr, 0.07 };
+    floatInputs.moistureHundredHour = { nullptr, 0.08 };
+    floatInputs.moistureLiveHerbaceous = { nullptr, 0.6 };
+    floatInputs.moistureLiveWoody = { nullptr, 0.9 };
+    floatInputs.moistureFoliar = { nullptr, 1.2 };
+    vector<float> floatSpreadRate(numberOfPixels, -1.0f);
+    vector<int> floatFireType(numberOfPixels, -1);
+    LandscapeFloatOutputBands floatOutputs = { noDataValue, floatSpreadRate.data(), nullptr, nullptr, floatFireType.data(), nullptr };
+    runner.run(floatInputs, floatOutputs);
+    int numberOfFloatMismatches = 0;
+    for(int i = 0; i < numberOfPixels; i++)
+    {
+        numberOfFloatMismatches += (floatSpreadRate[i] != (float)expectedSpreadRate[i]) || (floatFireType[i] != expectedFireType[i]);
+    }
+    testName = "Test landscape float bands match single Crown runs rounded to float";
+    reportTestResult(testInfo, testName, numberOfFloatMismatches, 0, error_tolerance);
+
+    // Quantized bands in their delivered integer types and units give the same results as the double bands
+    vector<short> quantizedFuelModelNumber(fuelModelNumber.begin(), fuelModelNumber.end());
+    vector<unsigned char> quantizedSlope(numberOfPixels);
+    vector<unsigned char> quantizedWindSpeed(numberOfPixels);
+    vector<unsigned char> quantizedCanopyBaseHeight(numberOfPixels);
+    vector<unsigned char> quantizedCanopyCover(numberOfPixels, 50);
+    for(int i = 0; i < numberOfPixels; i++)
+    {
+        quantizedSlope[i] = (slope[i] == noDataValue) ? 255 : (unsigned char)slope[i];
+        quantizedWindSpeed[i] = (unsigned char)(windSpeed[i] / 88.0); // mph
+        quantizedCanopyBaseHeight[i] = (unsigned char)(canopyBaseHeight[i] * 10.0); // tenths of ft
+    }
+    LandscapeQuantizedInputBands quantizedInputs;
+    quantizedInputs.numberOfRows = numberOfRows;
+    quantizedInputs.numberOfColumns = numberOfColumns;
+    quantizedInputs.fuelModelNumber = { LandscapeBandDataType::Int16, quantizedFuelModelNumber.data(), 1.0, 0.0, true, (int)noDataValue, 0.0 };
+    quantizedInputs.slope = { LandscapeBandDataType::UInt8, quantizedSlope.data(), 1.0, 0.0, true, 255, 0.0 };
+    quantizedInputs.aspect = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 180.0 };
+    quantizedInputs.canopyCover = { LandscapeBandDataType::UInt8, quantizedCanopyCover.data(), 0.01, 0.0, true, 255, 0.0 };
+    quantizedInputs.canopyHeight = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 60.0 };
+    quantizedInputs.canopyBaseHeight = { LandscapeBandDataType::UInt8, quantizedCanopyBaseHeight.data(), 0.1, 0.0, true, 255, 0.0 };
+    quantizedInputs.canopyBulkDensity = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 0.02 };
+    quantizedInputs.windSpeed = { LandscapeBandDataType::UInt8, quantizedWindSpeed.data(), 88.0, 0.0, false, 0, 0.0 };
+    quantizedInputs.windDirection = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 45.0 };
+    quantizedInputs.moistureOneHour = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 0.06 };
+    quantizedInputs.moistureTenHour = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 0.07 };
+    quantizedInputs.moistureHundredHour = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 0.08 };
+    quantizedInputs.moistureLiveHerbaceous = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 0.6 };
+    quantizedInputs.moistureLiveWoody = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 0.9 };
+    quantizedInputs.moistureFoliar = { LandscapeBandDataType::Int16, nullptr, 1.0, 0.0, false, 0, 1.2 };
+    {
+        vector<double> spreadRate(numberOfPixels, -1.0);
+        vector<int> fireType(numberOfPixels, -1);
+        LandscapeOutputBands outputs = { noDataValue, spreadRate.data(), nullptr, nullptr, fireType.data(), nullptr };
+        runner.setNumberOfThreads(2);
+        runner.run(quantizedInputs, outputs);
+        int numberOfQuantizedMismatches = 0;
+        for(int i = 0; i < numberOfPixels; i++)
+        {
+            numberOfQuantizedMismatches += (fabs(spreadRate[i] - expectedSpreadRate[i]) > error_tolerance) ||
+                (fireType[i] != expectedFireType[i]);
+        }
+        testName = "Test landscape quantized bands match single Crown runs";
+        reportTestResult(testInfo, testName, numberOfQuantizedMismatches, 0, error_tolerance);
+        testName = "Test landscape quantized no-data pixels are skipped";
+        reportTestResult(testInfo, testName, runner.getNumberOfNoDataPixels(), 2, error_tolerance);
+    }
+
+    LandscapePrecisionReport precisionReport = runner.validateFloatPrecision(inputs);
+    testName = "Test landscape float spread rates are within 1e-6 of double";
+    reportTestResult(testInfo, testName, precisionReport.spreadRate < 1.0e-6, true, error_tolerance);
+    testName = "Test landscape float flame lengths are within 1e-6 of double";
+    reportTestResult(testInfo, testName, precisionReport.flameLength < 1.0e-6, true, error_tolerance);
+    testName = "Test landscape float crown fraction burned is within 1e-6 of double";
+    reportTestResult(testInfo, testName, precisionReport.crownFractionBurned < 1.0e-6, true, error_tolerance);
+    testName = "Test landscape float fire types match double";
+    reportTestResult(testInfo, testName, precisionReport.numberOfFireTypeMismatches, 0, error_tolerance);
+
+    // A RunControl counts tiles as work, and a cancelled one stops the run before the next tile
+    {
+        RunControl runControl;
+        runner.setRunControl(&runControl);
+        runner.setNumberOfThreads(2);
+        vector<double> spreadRate(numberOfPixels, -1.0);
+        LandscapeOutputBands outputs = { noDataValue, spreadRate.data(), nullptr, nullptr, nullptr, nullptr };
+        runner.run(inputs, outputs);
+        testName = "Test landscape run with a RunControl reports all tiles done";
+        reportTestResult(testInfo, testName, runControl.getProgress(), 1.0, error_tolerance);
+        testName = "Test landscape run with a RunControl is not stopped";
+        reportTestResult(testInfo, testName, runner.wasStopped(), false, error_tolerance);
+
+        runControl.cancel();
+        std::fill(spreadRate.begin(), spreadRate.end(), -1.0);
+        runner.run(inputs, outputs);
+        testName = "Test cancelled landscape run skips every tile";
+        reportTestResult(testInfo, testName, runner.getNumberOfTilesRun(), 0, error_tolerance);
+        testName = "Test cancelled landscape run is stopped";
+        reportTestResult(testInfo, testName, runner.wasStopped(), true, error_tolerance);
+        testName = "Test cancelled landscape run leaves the outputs unchanged";
+        reportTestResult(testInfo, testName, *std::min_element(spreadRate.begin(), spreadRate.end()) == -1.0
+            && *std::max_element(spreadRate.begin(), spreadRate.end()) == -1.0, true, error_tolerance);
+        runner.setRunControl(nullptr);
+    }
+
+    // Reducers summarize a run without any output bands and match the summaries of the full rasters
+    {
+        const int numberOfZones = 2;
+        vector<int> zones(numberOfPixels);
+        for(int i = 0; i < numberOfPixels; i++)
+        {
+            zones[i] = (i == 3) ? -1 : (i % numberOfColumns) % numberOfZones;
+        }
+        const double threshold = 4.0;
+        const int k = 5;
+        LandscapeZonalHistogram histogram(LandscapeReducerOutput::FlameLength, zones.data(), numberOfZones, 0.0, 2.0, 80);
+        LandscapeExceedanceFraction exceedance(LandscapeReducerOutput::FlameLength, threshold, zones.data(), numberOfZones);
+        LandscapeTopK topK(LandscapeReducerOutput::SpreadRate, k);
+        runner.addReducer(&histogram);
+        runner.addReducer(&exceedance);
+        runner.addReducer(&topK);
+        runner.setNumberOfThreads(3);
+        LandscapeOutputBands outputs = { noDataValue, nullptr, nullptr, nullptr, nullptr, nullptr };
+        runner.run(inputs, outputs);
+        runner.clearReducers();
+
+        vector<long> expectedPixels(numberOfZones, 0);
+        vector<long> expectedExceeding(numberOfZones, 0);
+        vector<vector<double>> zoneFlameLengths(numberOfZones);
+        vector<LandscapeTopValue> expectedTopValues;
+        for(int i = 0; i < numberOfPixels; i++)
+        {
+            if(i == 8 || i == 30)
+            {
+                continue;
+            }
+            expectedTopValues.push_back({ expectedSpreadRate[i], (long)i });
+            if(zones[i] < 0)
+            {
+                continue;
+            }
+            expectedPixels[zones[i]]++;
+            expectedExceeding[zones[i]] += (expectedFlameLength[i] > threshold);
+            zoneFlameLengths[zones[i]].push_back(expectedFlameLength[i]);
+        }
+        std::sort(expectedTopValues.begin(), expectedTopValues.end(), [](const LandscapeTopValue& lhs, const LandscapeTopValue& rhs)
+        {
+            return (lhs.value != rhs.value) ? lhs.value > rhs.value : lhs.pixel < rhs.pixel;
+        });
+
+        bool isZoneMatching = true;
+        bool isMedianWithinBin = true;
+        for(int zone = 0; zone < numberOfZones; zone++)
+        {
+            isZoneMatching = isZoneMatching && histogram.getNumberOfPixels(zone) == expectedPixels[zone] &&
+                exceedance.getNumberOfPixels(zone) == expectedPixels[zone] &&
+                exceedance.getNumberOfExceedingPixels(zone) == expectedExceeding[zone];
+            vector<double>& flameLengths = zoneFlameLengths[zone];
+            std::sort(flameLengths.begin(), flameLengths.end());
+            double median = flameLengths[(flameLengths.size() - 1) / 2];
+            isMedianWithinBin = isMedianWithinBin && fabs(histogram.getQuantile(zone, 0.5) - median) <= 2.0;
+        }
+        bool isTopKMatching = (int)topK.getTopValues().size() == k;
+        for(int i = 0; isTopKMatching && i < k; i++)
+        {
+            isTopKMatching = topK.getTopValues()[i].pixel == expectedTopValues[i].pixel &&
+                fabs(topK.getTopValues()[i].value - expectedTopValues[i].value) < error_tolerance;
+        }
+        testName = "Test landscape zonal histogram and exceedance counts match the full rasters";
+        reportTestResult(testInfo, testName, isZoneMatching, true, error_tolerance);
+        testName = "Test landscape zonal exceedance fraction";
+        reportTestResult(testInfo, testName, exceedance.getFraction(0), (double)expectedExceeding[0] / expectedPixels[0], error_tolerance);
+        testName = "Test landscape zonal histogram median is within one bin of the exact median";
+        reportTestResult(testInfo, testName, isMedianWithinBin, true, error_tolerance);
+        testName = "Test landscape top-K matches the highest spread rates";
+        reportTestResult(testInfo, testName, isTopKMatching, true, error_tolerance);
+    }
+
+    // Workers sharing one fuelbed and wind adjustment factor cache give the same results, the cache
+    // holding each distinct fuelbed and canopy once however many workers met it
+    {
+        SharedSurfaceCache sharedCache;
+        LandscapeRunner sharedRunner(prototype);
+        sharedRunner.setTileSize(3);
+        sharedRunner.setNumberOfThreads(3);
+        sharedRunner.setSharedSurfaceCache(&sharedCache);
+        vector<double> spreadRate(numberOfPixels, -1.0);
+        vector<double> flameLength(numberOfPixels, -1.0);
+        LandscapeOutputBands outputs;
+        outputs.noDataValue = noDataValue;
+        outputs.spreadRate = spreadRate.data();
+        outputs.flameLength = flameLength.data();
+        outputs.firelineIntensity = nullptr;
+        outputs.fireType = nullptr;
+        outputs.crownFractionBurned = nullptr;
+        sharedRunner.run(inputs, outputs);
+        int numberOfFuelbeds = sharedCache.getFuelbedNumberOfEntries();
+        int numberOfWindAdjustmentFactors = sharedCache.getWindAdjustmentFactorNumberOfEntries();
+        sharedRunner.run(inputs, outputs);
+
+        bool isMatching = true;
+        for(int i = 0; i < numberOfPixels; i++)
+        {
+            isMatching = isMatching && fabs(spreadRate[i] - expectedSpreadRate[i]) < error_tolerance &&
+                fabs(flameLength[i] - expectedFlameLength[i]) < error_tolerance;
+        }
+        testName = "Test landscape with a shared surface cache matches single Crown runs";
+        reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+        testName = "Test shared surface cache holds one fuelbed per fuel model";
+        reportTestResult(testInfo, testName, numberOfFuelbeds, 2, error_tolerance);
+        testName = "Test second landscape run adds nothing to the shared surface cache";
+        reportTestResult(testInfo, testName, sharedCache.getFuelbedNumberOfEntries() == numberOfFuelbeds &&
+            sharedCache.getWindAdjustmentFactorNumberOfEntries() == numberOfWindAdjustmentFactors, true, error_tolerance);
+        testName = "Test landscape workers take fuelbeds and wind adjustment factors from the shared surface cache";
+        reportTestResult(testInfo, testName, sharedCache.getFuelbedNumberOfHits() > 0 &&
+            sharedCache.getWindAdjustmentFactorNumberOfHits() > 0, true, error_tolerance);
+    }
+
+    // Threads inserting and looking up the same keys all read back complete entries, each key stored once
+    {
+        SharedSurfaceCache sharedCache;
+        const int numberOfKeys = 200;
+        const int numberOfWorkers = 4;
+        vector<int> isWorkerMatching(numberOfWorkers, 1);
+        vector<std::thread> workers;
+        for(int worker = 0; worker < numberOfWorkers; worker++)
+        {
+            workers.emplace_back([&sharedCache, &isWorkerMatching, worker]()
+            {
+                for(int pass = 0; pass < 3; pass++)
+                {
+                    for(int key = 0; key < numberOfKeys; key++)
+                    {
+                        int shiftedKey = (key + worker * 50) % numberOfKeys;
+                        double windAdjustmentFactor = 0.0;
+                        WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod;
+                        if(sharedCache.findWindAdjustmentFactor(true, 0.01 * shiftedKey, 60.0, 0.5, 1.0, windAdjustmentFactor, shelterMethod))
+                        {
+                            isWorkerMatching[worker] = isWorkerMatching[worker] && windAdjustmentFactor == 0.001 * shiftedKey &&
+                                shelterMethod == WindAdjustmentFactorShelterMethod::Sheltered;
+                        }
+                        else
+                        {
+                            sharedCache.insertWindAdjustmentFactor(true, 0.01 * shiftedKey, 60.0, 0.5, 1.0, 0.001 * shiftedKey,
+                                WindAdjustmentFactorShelterMethod::Sheltered);
+                        }
+                    }
+                }
+            });
+        }
+        for(std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        bool isMatching = std::find(isWorkerMatching.begin(), isWorkerMatching.end(), 0) == isWorkerMatching.end();
+        testName = "Test shared surface cache lookups from several threads read back the inserted values";
+        reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+        testName = "Test shared surface cache stores each key once from several threads";
+        reportTestResult(testInfo, testName, sharedCache.getWindAdjustmentFactorNumberOfEntries(), numberOfKeys, error_tolerance);
+        testName = "Test shared surface cache counts every lookup";
+        reportTestResult(testInfo, testName, sharedCache.getWindAdjustmentFactorNumberOfHits() + sharedCache.getWindAdjustmentFactorNumberOfMisses(),
+            (long)numberOfWorkers * 3 * numberOfKeys, error_tolerance);
+
+        sharedCache.setCapacity(0);
+        double windAdjustmentFactor = 0.0;
+        WindAdjustmentFactorShelterMethod::WindAdjustmentFactorShelterMethodEnum shelterMethod;
+        sharedCache.insertWindAdjustmentFactor(true, 0.5, 60.0, 0.5, 1.0, 0.1, WindAdjustmentFactorShelterMethod::Sheltered);
+        testName = "Test shared surface cache with zero capacity stores nothing";
+        reportTestResult(testInfo, testName, sharedCache.findWindAdjustmentFactor(true, 0.5, 60.0, 0.5, 1.0, windAdjustmentFactor, shelterMethod),
+            false, error_tolerance);
+    }
+
+    std::cout << "Finished testing landscape runner\n\n";
+}
+
+void testFireGrowthRunner(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing fire growth runner\n";
+
+    string testName = "";
+
+    // The heap pops entries in order of time whatever order they were pushed
+    FireGrowthQueue queue;
+    unsigned int state = 12345;
+    for(int i = 0; i < 1000; i++)
+    {
+        state = state * 1103515245u + 12345u;
+        queue.push((state >> 8) % 10000 / 10.0, i);
+    }
+    bool isSorted = true;
+    double previousTime = -1.0;
+    while(!queue.empty())
+    {
+        isSorted = isSorted && queue.top().time >= previousTime;
+        previousTime = queue.top().time;
+        queue.pop();
+    }
+    testName = "Test fire growth queue pops in order of time";
+    reportTestResult(testInfo, testName, isSorted, true, error_tolerance);
+
+    // A uniform landscape of GS4 with a non-burnable road across its bottom rows
+    const int numberOfRows = 31;
+    const int numberOfColumns = 31;
+    const int numberOfPixels = numberOfRows * numberOfColumns;
+    const double noDataValue = -9999.0;
+    const double cellSize = 30.0;
+    const double cellSizeInFeet = LengthUnits::toBaseUnits(cellSize, LengthUnits::Meters);
+    vector<int> fuelModelNumber(numberOfPixels, 124);
+    for(int column = 0; column < numberOfColumns; column++)
+    {
+        fuelModelNumber[(numberOfRows - 2) * numberOfColumns + column] = 91; // NB1, urban
+    }
+
+    LandscapeInputBands inputs;
+    inputs.numberOfRows = numberOfRows;
+    inputs.numberOfColumns = numberOfColumns;
+    inputs.noDataValue = noDataValue;
+    inputs.fuelModelNumber = fuelModelNumber.data();
+    inputs.slope = { nullptr, 0.0 };
+    inputs.aspect = { nullptr, 0.0 };
+    inputs.canopyCover = { nullptr, 0.0 };
+    inputs.canopyHeight = { nullptr, 0.0 };
+    inputs.canopyBaseHeight = { nullptr, 0.0 };
+    inputs.canopyBulkDensity = { nullptr, 0.0 };
+
+    const int numberOfHours = 4;
+    vector<double> windSpeed(numberOfHours, 0.0);
+    vector<double> windDirection(numberOfHours, 0.0);
+    vector<double> moistureOneHour(numberOfHours, 0.12);
+    vector<double> moistureTenHour(numberOfHours, 0.14);
+    vector<double> moistureHundredHour(numberOfHours, 0.16);
+    vector<double> moistureLiveHerbaceous(numberOfHours, 1.2);
+    vector<double> moistureLiveWoody(numberOfHours, 1.5);
+    vector<double> moistureFoliar(numberOfHours, 1.0);
+    BehaveTimeSeriesWeather weather;
+    weather.numberOfHours = numberOfHours;
+    weather.windSpeed = windSpeed.data();
+    weather.windDirection = windDirection.data();
+    weather.moistureOneHour = moistureOneHour.data();
+    weather.moistureTenHour = moistureTenHour.data();
+    weather.moistureHundredHour = moistureHundredHour.data();
+    weather.moistureLiveHerbaceous = moistureLiveHerbaceous.data();
+    weather.moistureLiveWoody = moistureLiveWoody.data();
+    weather.moistureFoliar = moistureFoliar.data();
+
+    Surface surface(behaveRun.surface);
+    surface.updateSurfaceInputs(124, 0.12, 0.14, 0.16, 1.2, 1.5, FractionUnits::Fraction, 0.0, SpeedUnits::FeetPerMinute,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 0.0, SlopeUnits::Degrees, 0.0,
+        0.0, FractionUnits::Fraction, 0.0, LengthUnits::Feet, 0.0, FractionUnits::Fraction);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+    double noWindSpreadRate = surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+
+    const int ignitionRow = 15;
+    const int ignitionColumn = 15;
+    vector<FireGrowthIgnition> ignitions(1);
+    ignitions[0].row = ignitionRow;
+    ignitions[0].column = ignitionColumn;
+    ignitions[0].time = 0.0;
+
+    vector<double> arrivalTime(numberOfPixels);
+    vector<int> flowDirection(numberOfPixels);
+    FireGrowthOutputBands outputs = { noDataValue, arrivalTime.data(), flowDirection.data() };
+
+    FireGrowthRunner runner(behaveRun);
+    runner.setFireMethod(FireGrowthFireMethod::Surface);
+    runner.setCellSize(cellSize, LengthUnits::Meters);
+    runner.setNumberOfThreads(1);
+    runner.run(inputs, weather, ignitions, outputs);
+
+    auto at = [&](const vector<double>& band, int row, int column)
+    {
+        return band[row * numberOfColumns + column];
+    };
+
+    testName = "Test fire growth with no wind reaches a neighbor at the cell size over the spread rate";
+    reportTestResult(testInfo, testName, at(arrivalTime, ignitionRow, ignitionColumn + 1) * noWindSpreadRate / cellSizeInFeet,
+        1.0, 1e-5);
+    testName = "Test fire growth with no wind reaches a knight's move at its length over the spread rate";
+    reportTestResult(testInfo, testName, at(arrivalTime, ignitionRow - 2, ignitionColumn + 1) * noWindSpreadRate / cellSizeInFeet,
+        sqrt(5.0), 1e-5);
+    testName = "Test fire growth with no wind is symmetric";
+    reportTestResult(testInfo, testName, at(arrivalTime, ignitionRow - 6, ignitionColumn + 3),
+        at(arrivalTime, ignitionRow + 3, ignitionColumn - 6), 1e-9);
+    testName = "Test fire growth ignition arrives at its ignition time";
+    reportTestResult(testInfo, testName, at(arrivalTime, ignitionRow, ignitionColumn), 0.0, error_tolerance);
+    testName = "Test fire growth does not burn across a non-burnable road";
+    reportTestResult(testInfo, testName, at(arrivalTime, numberOfRows - 1, ignitionColumn), noDataValue, error_tolerance);
+    testName = "Test fire growth burns every pixel above the road";
+    reportTestResult(testInfo, testName, runner.getNumberOfBurnedPixels(), (numberOfRows - 2) * numberOfColumns,
+        error_tolerance);
+
+    // Following the flow paths backwards from every burned pixel leads to the ignition
+    bool isLeadingToIgnition = true;
+    for(int pixel = 0; pixel < numberOfPixels; pixel++)
+    {
+        if(arrivalTime[pixel] == noDataValue)
+        {
+            continue;
+        }
+        int row = pixel / numberOfColumns;
+        int column = pixel % numberOfColumns;
+        int steps = 0;
+        while(flowDirection[row * numberOfColumns + column] >= 0 && steps < numberOfPixels)
+        {
+            int rowOffset = 0;
+            int columnOffset = 0;
+            FireGrowthRunner::getNeighborOffset(flowDirection[row * numberOfColumns + column], rowOffset, columnOffset);
+            row -= rowOffset;
+            column -= columnOffset;
+            steps++;
+        }
+        isLeadingToIgnition = isLeadingToIgnition && row == ignitionRow && column == ignitionColumn;
+    }
+    testName = "Test fire growth flow paths lead back to the ignition";
+    reportTestResult(testInfo, testName, isLeadingToIgnition, true, error_tolerance);
+
+    // More threads sweep the same spread rates
+    vector<double> serialArrivalTime = arrivalTime;
+    runner.setNumberOfThreads(4);
+    runner.run(inputs, weather, ignitions, outputs);
+    testName = "Test fire growth with four threads matches one thread";
+    reportTestResult(testInfo, testName, arrivalTime == serialArrivalTime, true, error_tolerance);
+
+    // A crown method spreads as the surface fire where nothing crowns
+    runner.setFireMethod(FireGrowthFireMethod::ScottAndReinhardt);
+    runner.run(inputs, weather, ignitions, outputs);
+    testName = "Test fire growth with a crown method and no canopy matches surface spread";
+    reportTestResult(testInfo, testName, arrivalTime == serialArrivalTime, true, error_tolerance);
+    runner.setFireMethod(FireGrowthFireMethod::Surface);
+
+    // The fire runs downwind faster than upwind
+    std::fill(windSpeed.begin(), windSpeed.end(), 440.0); // 5 mph
+    std::fill(windDirection.begin(), windDirection.end(), 90.0);
+    surface.updateSurfaceInputs(124, 0.12, 0.14, 0.16, 1.2, 1.5, FractionUnits::Fraction, 440.0, SpeedUnits::FeetPerMinute,
+        WindHeightInputMode::TwentyFoot, 90.0, WindAndSpreadOrientationMode::RelativeToNorth, 0.0, SlopeUnits::Degrees, 0.0,
+        0.0, FractionUnits::Fraction, 0.0, LengthUnits::Feet, 0.0, FractionUnits::Fraction);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+    double directionOfMaxSpread = surface.getDirectionOfMaxSpread();
+    int headNeighbor = (int)floor(directionOfMaxSpread / 22.5 + 0.5) % FireGrowthRunner::NumberOfNeighbors;
+    int headRowOffset = 0;
+    int headColumnOffset = 0;
+    FireGrowthRunner::getNeighborOffset(headNeighbor, headRowOffset, headColumnOffset);
+    runner.run(inputs, weather, ignitions, outputs);
+    testName = "Test fire growth with wind reaches the head before the back";
+    reportTestResult(testInfo, testName, at(arrivalTime, ignitionRow + 4 * headRowOffset, ignitionColumn + 4 * headColumnOffset) <
+        at(arrivalTime, ignitionRow - 4 * headRowOffset, ignitionColumn - 4 * headColumnOffset), true, error_tolerance);
+
+    // The maximum time leaves the later pixels unburned
+    runner.setMaximumTime(30.0);
+    runner.run(inputs, weather, ignitions, outputs);
+    double latestArrival = 0.0;
+    for(int pixel = 0; pixel < numberOfPixels; pixel++)
+    {
+        latestArrival = std::max(latestArrival, arrivalTime[pixel]);
+    }
+    testName = "Test fire growth burns no pixel after the maximum time";
+    reportTestResult(testInfo, testName, latestArrival <= 30.0, true, error_tolerance);
+    testName = "Test fire growth to a maximum time leaves pixels unburned";
+    reportTestResult(testInfo, testName, runner.getNumberOfBurnedPixels() < (numberOfRows - 2) * numberOfColumns, true,
+        error_tolerance);
+    runner.setMaximumTime(0.0);
+
+    // Drying out after the first hour speeds up the fire from then on, steps that left a pixel
+    // in the first hour keep its spread rates
+    std::fill(windSpeed.begin(), windSpeed.end(), 0.0);
+    runner.run(inputs, weather, ignitions, outputs);
+    vector<double> wetArrivalTime = arrivalTime;
+    std::fill(moistureOneHour.begin() + 1, moistureOneHour.end(), 0.04);
+    runner.run(inputs, weather, ignitions, outputs);
+    bool isNeverLater = true;
+    bool isSameInFirstHour = true;
+    double latestWetArrival = 0.0;
+    double latestDryArrival = 0.0;
+    for(int pixel = 0; pixel < numberOfPixels; pixel++)
+    {
+        if(wetArrivalTime[pixel] == noDataValue)
+        {
+            continue;
+        }
+        if(arrivalTime[pixel] < 60.0)
+        {
+            isSameInFirstHour = isSameInFirstHour && arrivalTime[pixel] == wetArrivalTime[pixel];
+        }
+        isNeverLater = isNeverLater && arrivalTime[pixel] <= wetArrivalTime[pixel];
+        latestWetArrival = std::max(latestWetArrival, wetArrivalTime[pixel]);
+        latestDryArrival = std::max(latestDryArrival, arrivalTime[pixel]);
+    }
+    testName = "Test fire growth sweeps spread rates for every hour it burns through";
+    reportTestResult(testInfo, testName, runner.getNumberOfSpreadRateSweeps() >= 2, true, error_tolerance);
+    testName = "Test fire growth arrivals in the first hour ignore later weather";
+    reportTestResult(testInfo, testName, isSameInFirstHour, true, error_tolerance);
+    testName = "Test fire growth arrivals after drying out are never later";
+    reportTestResult(testInfo, testName, isNeverLater, true, error_tolerance);
+    testName = "Test fire growth after drying out burns the landscape sooner";
+    reportTestResult(testInfo, testName, latestWetArrival > 60.0 && latestDryArrival < latestWetArrival, true, error_tolerance);
+
+    // A cancelled run stops before it burns anything
+    RunControl runControl;
+    runControl.cancel();
+    runner.setRunControl(&runControl);
+    runner.run(inputs, weather, ignitions, outputs);
+    testName = "Test cancelled fire growth is stopped";
+    reportTestResult(testInfo, testName, runner.wasStopped(), true, error_tolerance);
+    testName = "Test cancelled fire growth burns no pixel";
+    reportTestResult(testInfo, testName, runner.getNumberOfBurnedPixels(), 0, error_tolerance);
+    runner.setRunControl(nullptr);
+
+    std::cout << "Finished testing fire growth runner\n\n";
+}
+
+void testLandscapeTileRunner(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing landscape tile runner\n";
+
+    string testName = "";
+
+    const FuelModels fuelModels;
+    Crown prototype(fuelModels);
+    prototype.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UseCrownRatio);
+
+    // A raster of partial tiles with a no-data pixel, cut into nine tiles of four by four
+    const int numberOfRows = 9;
+    const int numberOfColumns = 11;
+    const int numberOfPixels = numberOfRows * numberOfColumns;
+    const double noDataValue = -9999.0;
+    vector<int> fuelModelNumber(numberOfPixels);
+    vector<double> slope(numberOfPixels);
+    vector<double> windSpeed(numberOfPixels);
+    vector<double> canopyBaseHeight(numberOfPixels);
+    for(int i = 0; i < numberOfPixels; i++)
+    {
+        fuelModelNumber[i] = (i % 3 == 0) ? 165 : 124;
+        slope[i] = (i % 5) * 8.0;
+        windSpeed[i] = 88.0 * (5 + i % 7 * 3); // ft/min
+        canopyBaseHeight[i] = 2.0 + (i % 4) * 4.0;
+    }
+    fuelModelNumber[40] = (int)noDataValue;
+
+    LandscapeInputBands inputs;
+    inputs.numberOfRows = numberOfRows;
+    inputs.numberOfColumns = numberOfColumns;
+    inputs.noDataValue = noDataValue;
+    inputs.fuelModelNumber = fuelModelNumber.data();
+    inputs.slope = { slope.data(), 0.0 };
+    inputs.aspect = { nullptr, 180.0 };
+    inputs.canopyCover = { nullptr, 0.5 };
+    inputs.canopyHeight = { nullptr, 60.0 };
+    inputs.canopyBaseHeight = { canopyBaseHeight.data(), 0.0 };
+    inputs.canopyBulkDensity = { nullptr, 0.02 };
+    inputs.windSpeed = { windSpeed.data(), 0.0 };
+    inputs.windDirection = { nullptr, 45.0 };
+    inputs.moistureOneHour = { nullptr, 0.06 };
+    inputs.moistureTenHour = { nullptr, 0.07 };
+    inputs.moistureHundredHour = { nullptr, 0.08 };
+    inputs.moistureLiveHerbaceous = { nullptr, 0.6 };
+    inputs.moistureLiveWoody = { nullptr, 0.9 };
+    inputs.moistureFoliar = { nullptr, 1.2 };
+
+    // Expected values from one run of the whole raster
+    vector<double> expectedSpreadRate(numberOfPixels);
+    vector<double> expectedFlameLength(numberOfPixels);
+    vector<double> expectedFirelineIntensity(numberOfPixels);
+    vector<int> expectedFireType(numberOfPixels);
+    vector<double> expectedCrownFractionBurned(numberOfPixels);
+    LandscapeOutputBands expectedOutputs = { noDataValue, expectedSpreadRate.data(), expectedFlameLength.data(),
+        expectedFirelineIntensity.data(), expectedFireType.data(), expectedCrownFractionBurned.data() };
+    LandscapeRunner landscapeRunner(prototype);
+    landscapeRunner.setNumberOfThreads(1);
+    landscapeRunner.run(inputs, expectedOutputs);
+
+    // The halo of a tile is clipped to the raster
+    LandscapeTiling tiling(numberOfRows, numberOfColumns, 4, FireGrowthRunner::NeighborReach);
+    LandscapeTile tile = tiling.getTile(4);
+    testName = "Test landscape tiling number of tiles";
+    reportTestResult(testInfo, testName, tiling.getNumberOfTiles(), 9, error_tolerance);
+    testName = "Test landscape tiling middle tile core and halo";
+    reportTestResult(testInfo, testName, tile.rowBegin == 4 && tile.rowEnd == 8 && tile.columnBegin == 4 && tile.columnEnd == 8 &&
+        tile.haloRowBegin == 2 && tile.haloRowEnd == 9 && tile.haloColumnBegin == 2 && tile.haloColumnEnd == 10, true, error_tolerance);
+    tile = tiling.getTile(8);
+    testName = "Test landscape tiling corner tile is clipped";
+    reportTestResult(testInfo, testName, tile.rowEnd == 9 && tile.columnEnd == 11 && tile.haloRowEnd == 9 &&
+        tile.haloColumnEnd == 11 && tile.haloRowBegin == 6 && tile.haloColumnBegin == 6, true, error_tolerance);
+    testName = "Test landscape tiling second of two workers gets four tiles";
+    reportTestResult(testInfo, testName, (int)tiling.getTilesOfWorker(1, 2).size(), 4, error_tolerance);
+
+    // The inputs of a tile read back the pixels of the raster
+    LandscapeTileInputs tileInputs;
+    tileInputs.extract(inputs, tiling.getTile(4));
+    const LandscapeInputBands& tileBands = tileInputs.getInputs();
+    testName = "Test landscape tile inputs are cut to the halo";
+    reportTestResult(testInfo, testName, tileBands.numberOfRows == 7 && tileBands.numberOfColumns == 8 &&
+        tileBands.slope.values[8 + 3] == slope[3 * numberOfColumns + 5] &&
+        tileBands.fuelModelNumber[8 + 3] == fuelModelNumber[3 * numberOfColumns + 5] &&
+        tileBands.canopyCover.values == nullptr, true, error_tolerance);
+
+    // Two workers of a partition, the merge only succeeds once both have run
+    const string outputPrefix = "testLandscapeTiles_";
+    vector<LandscapeTileRunner> workers;
+    for(int worker = 0; worker < 2; worker++)
+    {
+        workers.push_back(LandscapeTileRunner(prototype, outputPrefix));
+        workers.back().setTileSize(4);
+        workers.back().setNumberOfThreads(1);
+        workers.back().setWorker(worker, 2);
+    }
+    testName = "Test landscape tile runner first worker writes its tiles";
+    reportTestResult(testInfo, testName, workers[0].run(inputs), true, error_tolerance);
+    testName = "Test landscape tile runner first worker runs five tiles";
+    reportTestResult(testInfo, testName, workers[0].getNumberOfTilesRun(), 5, error_tolerance);
+
+    vector<double> spreadRate(numberOfPixels, -1.0);
+    vector<double> flameLength(numberOfPixels, -1.0);
+    vector<double> firelineIntensity(numberOfPixels, -1.0);
+    vector<int> fireType(numberOfPixels, -1);
+    vector<double> crownFractionBurned(numberOfPixels, -1.0);
+    LandscapeOutputBands outputs = { noDataValue, spreadRate.data(), flameLength.data(), firelineIntensity.data(),
+        fireType.data(), crownFractionBurned.data() };
+    testName = "Test landscape tile merge fails with missing tiles";
+    reportTestResult(testInfo, testName, workers[0].mergeTiles(numberOfRows, numberOfColumns, outputs), false, error_tolerance);
+
+    workers[1].run(inputs);
+    testName = "Test landscape tile runner second worker runs four tiles";
+    reportTestResult(testInfo, testName, workers[1].getNumberOfTilesRun(), 4, error_tolerance);
+    testName = "Test landscape tile runner all tiles are done";
+    reportTestResult(testInfo, testName, workers[0].areAllTilesDone(numberOfRows, numberOfColumns), true, error_tolerance);
+    testName = "Test landscape tile merge succeeds";
+    reportTestResult(testInfo, testName, workers[0].mergeTiles(numberOfRows, numberOfColumns, outputs), true, error_tolerance);
+
+    bool isMatching = true;
+    for(int i = 0; i < numberOfPixels; i++)
+    {
+        isMatching = isMatching && fabs(spreadRate[i] - expectedSpreadRate[i]) < 1.0e-9 &&
+            fabs(flameLength[i] - expectedFlameLength[i]) < 1.0e-9 &&
+            fabs(firelineIntensity[i] - expectedFirelineIntensity[i]) < 1.0e-9 &&
+            fireType[i] == expectedFireType[i] &&
+            fabs(crownFractionBurned[i] - expectedCrownFractionBurned[i]) < 1.0e-9;
+    }
+    testName = "Test merged landscape tiles match a whole landscape run";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+
+    // A rerun is checkpointed by the tile files, a lost tile file is the only tile run again
+    workers[0].run(inputs);
+    testName = "Test landscape tile rerun skips finished tiles";
+    reportTestResult(testInfo, testName, workers[0].getNumberOfTilesRun() == 0 && workers[0].getNumberOfTilesSkipped() == 5,
+        true, error_tolerance);
+    remove(workers[0].getTileFileName(2).c_str());
+    workers[0].run(inputs);
+    testName = "Test landscape tile rerun runs only the lost tile";
+    reportTestResult(testInfo, testName, workers[0].getNumberOfTilesRun(), 1, error_tolerance);
+
+    // A shared queue worker leaves a tile claimed by a failed worker until the claim is cleared
+    LandscapeTileRunner queueWorker(prototype, outputPrefix);
+    queueWorker.setTileSize(4);
+    queueWorker.setNumberOfThreads(1);
+    queueWorker.setDispatchMode(LandscapeTileDispatchMode::SharedQueue);
+    remove(queueWorker.getTileFileName(6).c_str());
+    const string staleClaimFileName = outputPrefix + "tile_6.claim";
+    FILE* staleClaim = fopen(staleClaimFileName.c_str(), "w");
+    fclose(staleClaim);
+    queueWorker.run(inputs);
+    testName = "Test shared queue worker skips a claimed tile";
+    reportTestResult(testInfo, testName, queueWorker.getNumberOfTilesRun() == 0 && !queueWorker.isTileDone(6), true, error_tolerance);
+    testName = "Test shared queue stale claim is cleared";
+    reportTestResult(testInfo, testName, queueWorker.clearStaleClaims(numberOfRows, numberOfColumns), 1, error_tolerance);
+    queueWorker.run(inputs);
+    testName = "Test shared queue worker runs the unclaimed tile";
+    reportTestResult(testInfo, testName, queueWorker.getNumberOfTilesRun() == 1 && queueWorker.isTileDone(6), true, error_tolerance);
+
+    for(int i = 0; i < tiling.getNumberOfTiles(); i++)
+    {
+        remove(queueWorker.getTileFileName(i).c_str());
+        remove((outputPrefix + "tile_" + std::to_string(i) + ".claim").c_str());
+    }
+
+    std::cout << "Finished testing landscape tile runner\n\n";
+}
+
+void testResultCache(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing result cache\n";
+
+    string testName = "";
+
+    const FuelModels fuelModels;
+    Crown prototype(fuelModels);
+    prototype.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UseCrownRatio);
+
+    // Keys are canonical, and change with the settings that change a run's results
+    ResultCacheKeyBuilder first;
+    ResultCacheKeyBuilder second;
+    first.add(0.0);
+    second.add(-0.0);
+    testName = "Test result cache key treats negative zero as zero";
+    reportTestResult(testInfo, testName, first.getKey() == second.getKey(), true, error_tolerance);
+    Crown crown(prototype);
+    crown.updateCrownInputs(124, 0.06, 0.07, 0.08, 0.6, 0.9, 1.0, FractionUnits::Fraction, 880.0, SpeedUnits::FeetPerMinute,
+        WindHeightInputMode::TwentyFoot, 45.0, WindAndSpreadOrientationMode::RelativeToNorth, 10.0, SlopeUnits::Degrees, 180.0,
+        0.5, FractionUnits::Fraction, 40.0, 4.0, LengthUnits::Feet, 0.9, FractionUnits::Fraction, 0.02, DensityUnits::PoundsPerCubicFoot);
+    ResultCacheKeyBuilder crownKey;
+    crownKey.addCrownRun(crown, LandscapeCrownFireMethod::ScottAndReinhardt, WindAndSpreadOrientationMode::RelativeToNorth);
+    crown.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::DontUseCrownRatio);
+    ResultCacheKeyBuilder otherCrownKey;
+    otherCrownKey.addCrownRun(crown, LandscapeCrownFireMethod::ScottAndReinhardt, WindAndSpreadOrientationMode::RelativeToNorth);
+    testName = "Test result cache key changes with the wind adjustment factor method";
+    reportTestResult(testInfo, testName, crownKey.getKey() == otherCrownKey.getKey(), false, error_tolerance);
+
+    // A landscape that repeats its pixels, so a first run already hits the cache
+    const int numberOfRows = 6;
+    const int numberOfColumns = 8;
+    const int numberOfPixels = numberOfRows * numberOfColumns;
+    const double noDataValue = -9999.0;
+    vector<int> fuelModelNumber(numberOfPixels);
+    vector<double> slope(numberOfPixels);
+    vector<double> windSpeed(numberOfPixels);
+    for(int i = 0; i < numberOfPixels; i++)
+    {
+        fuelModelNumber[i] = (i % 2 == 0) ? 165 : 124;
+        slope[i] = (i % 3) * 10.0;
+        windSpeed[i] = 88.0 * (4 + i % 4 * 5); // ft/min
+    }
+    LandscapeInputBands inputs;
+    inputs.numberOfRows = numberOfRows;
+    inputs.numberOfColumns = numberOfColumns;
+    inputs.noDataValue = noDataValue;
+    inputs.fuelModelNumber = fuelModelNumber.data();
+    inputs.slope = { slope.data(), 0.0 };
+    inputs.aspect = { nullptr, 180.0 };
+    inputs.canopyCover = { nullptr, 0.5 };
+    inputs.canopyHeight = { nullptr, 60.0 };
+    inputs.canopyBaseHeight = { nullptr, 4.0 };
+    inputs.canopyBulkDensity = { nullptr, 0.02 };
+    inputs.windSpeed = { windSpeed.data(), 0.0 };
+    inputs.windDirection = { nullptr, 45.0 };
+    inputs.moistureOneHour = { nullptr, 0.06 };
+    inputs.moistureTenHour = { nullptr, 0.07 };
+    inputs.moistureHundredHour = { nullptr, 0.08 };
+    inputs.moistureLiveHerbaceous = { nullptr, 0.6 };
+    inputs.moistureLiveWoody = { nullptr, 0.9 };
+    inputs.moistureFoliar = { nullptr, 1.2 };
+
+    vector<double> expectedSpreadRate(numberOfPixels);
+    vector<int> expectedFireType(numberOfPixels);
+    vector<double> expectedCrownFractionBurned(numberOfPixels);
+    LandscapeOutputBands expectedOutputs = { noDataValue, expectedSpreadRate.data(), nullptr, nullptr, expectedFireType.data(),
+        expectedCrownFractionBurned.data() };
+    LandscapeRunner runner(prototype);
+    runner.setNumberOfThreads(2);
+    runner.setTileSize(3);
+    runner.run(inputs, expectedOutputs);
+
+    vector<double> spreadRate(numberOfPixels);
+    vector<int> fireType(numberOfPixels);
+    vector<double> crownFractionBurned(numberOfPixels);
+    LandscapeOutputBands outputs = { noDataValue, spreadRate.data(), nullptr, nullptr, fireType.data(), crownFractionBurned.data() };
+    auto isMatchingExpected = [&]()
+    {
+        bool isMatching = true;
+        for(int i = 0; i < numberOfPixels; i++)
+        {
+            isMatching = isMatching && spreadRate[i] == expectedSpreadRate[i] && fireType[i] == expectedFireType[i] &&
+                crownFractionBurned[i] == expectedCrownFractionBurned[i];
+        }
+        return isMatching;
+    };
+
+    ResultCache resultCache;
+    runner.setResultCache(&resultCache);
+    runner.run(inputs, outputs);
+    testName = "Test landscape run through an empty result cache matches";
+    reportTestResult(testInfo, testName, isMatchingExpected(), true, error_tolerance);
+    testName = "Test result cache holds one entry per distinct pixel";
+    reportTestResult(testInfo, testName, resultCache.getNumberOfEntries(), 12, error_tolerance);
+    testName = "Test result cache counts every pixel lookup";
+    reportTestResult(testInfo, testName, resultCache.getNumberOfHits() + resultCache.getNumberOfMisses(), numberOfPixels,
+        error_tolerance);
+
+    // Saved and loaded into the cache of a later run, every pixel is a hit
+    const string fileName = "testResultCache.bcache";
+    testName = "Test result cache saves";
+    reportTestResult(testInfo, testName, resultCache.save(fileName), true, error_tolerance);
+    ResultCache loadedCache;
+    testName = "Test result cache loads";
+    reportTestResult(testInfo, testName, loadedCache.load(fileName), true, error_tolerance);
+    testName = "Test loaded result cache has every entry";
+    reportTestResult(testInfo, testName, loadedCache.getNumberOfEntries(), 12, error_tolerance);
+    std::fill(spreadRate.begin(), spreadRate.end(), -1.0);
+    runner.setResultCache(&loadedCache);
+    runner.run(inputs, outputs);
+    testName = "Test landscape run from a loaded result cache matches";
+    reportTestResult(testInfo, testName, isMatchingExpected(), true, error_tolerance);
+    testName = "Test landscape run from a loaded result cache only hits";
+    reportTestResult(testInfo, testName, loadedCache.getNumberOfHits() == numberOfPixels && loadedCache.getNumberOfMisses() == 0,
+        true, error_tolerance);
+    runner.setResultCache(nullptr);
+
+    // The size cap evicts the oldest entries, a damaged file does not load
+    loadedCache.setCapacity(5);
+    testName = "Test result cache capacity evicts entries";
+    reportTestResult(testInfo, testName, loadedCache.getNumberOfEntries(), 5, error_tolerance);
+    FILE* damagedFile = fopen(fileName.c_str(), "wb");
+    fputs("not a cache", damagedFile);
+    fclose(damagedFile);
+    ResultCache damagedCache;
+    testName = "Test damaged result cache file does not load";
+    reportTestResult(testInfo, testName, damagedCache.load(fileName), false, error_tolerance);
+    remove(fileName.c_str());
+
+    // A time series repeated from the cache
+    const int numberOfHours = 6;
+    vector<double> hourlyWindSpeed(numberOfHours);
+    vector<double> hourlyWindDirection(numberOfHours, 90.0);
+    vector<double> moistureOneHour(numberOfHours);
+    vector<double> moistureTenHour(numberOfHours, 0.07);
+    vector<double> moistureHundredHour(numberOfHours, 0.08);
+    vector<double> moistureLiveHerbaceous(numberOfHours, 0.6);
+    vector<double> moistureLiveWoody(numberOfHours, 0.9);
+    vector<double> moistureFoliar(numberOfHours, 1.0);
+    for(int hour = 0; hour < numberOfHours; hour++)
+    {
+        hourlyWindSpeed[hour] = 88.0 * (3 + 3 * hour);
+        moistureOneHour[hour] = 0.04 + 0.005 * (hour % 3);
+    }
+    BehaveTimeSeriesWeather weather = { numberOfHours, hourlyWindSpeed.data(), hourlyWindDirection.data(), moistureOneHour.data(),
+        moistureTenHour.data(), moistureHundredHour.data(), moistureLiveHerbaceous.data(), moistureLiveWoody.data(),
+        moistureFoliar.data() };
+    BehaveTimeSeriesLocation location = { 165, 20.0, 200.0, 0.5, 60.0, 6.0, 0.02, WindHeightInputMode::TwentyFoot,
+        WindAndSpreadOrientationMode::RelativeToNorth, TimeSeriesCrownFireMethod::ScottAndReinhardt };
+    vector<double> expectedHourlySpreadRate(numberOfHours);
+    vector<double> hourlySpreadRate(numberOfHours);
+    BehaveTimeSeriesOutputs expectedHourlyOutputs = { expectedHourlySpreadRate.data(), nullptr, nullptr, nullptr, nullptr, nullptr };
+    BehaveTimeSeriesOutputs hourlyOutputs = { hourlySpreadRate.data(), nullptr, nullptr, nullptr, nullptr, nullptr };
+    BehaveRun timeSeriesRun(behaveRun);
+    timeSeriesRun.doTimeSeriesRun(location, weather, expectedHourlyOutputs);
+
+    ResultCache timeSeriesCache;
+    timeSeriesRun.setResultCache(&timeSeriesCache);
+    timeSeriesRun.doTimeSeriesRun(location, weather, hourlyOutputs);
+    timeSeriesRun.doTimeSeriesRun(location, weather, hourlyOutputs);
+    bool isMatching = true;
+    for(int hour = 0; hour < numberOfHours; hour++)
+    {
+        isMatching = isMatching && hourlySpreadRate[hour] == expectedHourlySpreadRate[hour];
+    }
+    testName = "Test cached time series matches";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+    testName = "Test repeated time series hits the result cache";
+    reportTestResult(testInfo, testName, timeSeriesCache.getNumberOfHits() == numberOfHours &&
+        timeSeriesCache.getNumberOfMisses() == numberOfHours, true, error_tolerance);
+
+    std::cout << "Finished testing result cache\n\n";
+}
+
+void testSurfaceLookupTable(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing surface lookup table\n";
+
+    string testName = "";
+
+    setSurfaceInputsForGS4LowMoistureScenario(behaveRun);
+    Surface& surface = behaveRun.surface;
+    SurfaceLookupTable lookupTable(surface);
+    lookupTable.setAxis(SurfaceLookupAxis::MoistureOneHour, 0.04, 0.10, 0.01);
+    lookupTable.setAxis(SurfaceLookupAxis::WindSpeed, 0.0, 880.0, 88.0);
+    lookupTable.setAxis(SurfaceLookupAxis::Slope, 0.0, 30.0, 5.0);
+
+    testName = "Test surface lookup table number of points";
+    reportTestResult(testInfo, testName, lookupTable.getNumberOfTablePoints(), 7 * 11 * 7, error_tolerance);
+
+    // Exact results from a one cell batch run of the same Surface
+    auto exactSpreadRate = [&surface](int fuelModelNumber, double moistureOneHour, double windSpeed, double slope)
+    {
+        int fuelModel = fuelModelNumber;
+        double moistureTenHour = surface.getMoistureTenHour(FractionUnits::Fraction);
+        double moistureHundredHour = surface.getMoistureHundredHour(FractionUnits::Fraction);
+        double moistureLiveHerbaceous = surface.getMoistureLiveHerbaceous(FractionUnits::Fraction);
+        double moistureLiveWoody = surface.getMoistureLiveWoody(FractionUnits::Fraction);
+        double windDirection = surface.getWindDirection();
+        double aspect = surface.getAspect();
+        double canopyCover = surface.getCanopyCover(FractionUnits::Fraction);
+        double canopyHeight = surface.getCanopyHeight(LengthUnits::Feet);
+        double crownRatio = surface.getCrownRatio(FractionUnits::Fraction);
+        SurfaceBatchInputs inputs = { 1, &fuelModel, &moistureOneHour, &moistureTenHour, &moistureHundredHour, &moistureLiveHerbaceous,
+            &moistureLiveWoody, &windSpeed, &windDirection, &slope, &aspect, &canopyCover, &canopyHeight, &crownRatio };
+        Surface exactSurface(surface);
+        double spreadRate = 0.0;
+        SurfaceBatchOutputs outputs = { &spreadRate, nullptr, nullptr, nullptr, nullptr };
+        exactSurface.doSurfaceRunBatch(inputs, outputs);
+        return spreadRate;
+    };
+
+    double moistureTenHour = surface.getMoistureTenHour(FractionUnits::Fraction);
+    double moistureHundredHour = surface.getMoistureHundredHour(FractionUnits::Fraction);
+    double moistureLiveHerbaceous = surface.getMoistureLiveHerbaceous(FractionUnits::Fraction);
+    double moistureLiveWoody = surface.getMoistureLiveWoody(FractionUnits::Fraction);
+
+    testName = "Test surface lookup table matches the exact run at a grid point";
+    SurfaceLookupOutputs outputs = lookupTable.lookup(124, 0.06, moistureTenHour, moistureHundredHour, moistureLiveHerbaceous,
+        moistureLiveWoody, 440.0, 20.0);
+    reportTestResult(testInfo, testName, outputs.spreadRate, exactSpreadRate(124, 0.06, 440.0, 20.0), error_tolerance);
+
+    testName = "Test surface lookup table is built once per fuel model";
+    lookupTable.lookup(124, 0.05, moistureTenHour, moistureHundredHour, moistureLiveHerbaceous, moistureLiveWoody, 100.0, 3.0);
+    reportTestResult(testInfo, testName, lookupTable.getNumberOfTables(), 1, error_tolerance);
+
+    // Cell centres are where the error is measured, so they must be within the reported error
+    testName = "Test surface lookup table error at a cell centre is within the reported maximum";
+    outputs = lookupTable.lookup(124, 0.065, moistureTenHour, moistureHundredHour, moistureLiveHerbaceous, moistureLiveWoody,
+        396.0, 17.5);
+    double error = fabs(outputs.spreadRate - exactSpreadRate(124, 0.065, 396.0, 17.5));
+    double maximumError = lookupTable.getMaximumSpreadRateError(124);
+    reportTestResult(testInfo, testName, error <= maximumError + 1.0e-9 && maximumError > 0.0, true, error_tolerance);
+
+    testName = "Test surface lookup table clamps inputs to the axis ends";
+    SurfaceLookupOutputs clamped = lookupTable.lookup(124, 0.10, moistureTenHour, moistureHundredHour, moistureLiveHerbaceous,
+        moistureLiveWoody, 2000.0, 30.0);
+    reportTestResult(testInfo, testName, clamped.spreadRate, exactSpreadRate(124, 0.10, 880.0, 30.0), error_tolerance);
+
+    testName = "Test surface lookup table gives zero spread for a non-burnable fuel model";
+    outputs = lookupTable.lookup(91, 0.06, moistureTenHour, moistureHundredHour, moistureLiveHerbaceous, moistureLiveWoody, 440.0, 20.0);
+    reportTestResult(testInfo, testName, outputs.spreadRate, 0.0, error_tolerance);
+
+    std::cout << "Finished testing surface lookup table\n\n";
+}
+
+void testContainOptimizer(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing Contain optimizer\n";
+
+    string testName = "";
+
+    ContainAdapter prototype;
+    prototype.setAttackDistance(0, LengthUnits::Chains);
+    prototype.setLwRatio(3);
+    prototype.setReportRate(5, SpeedUnits::ChainsPerHour);
+    prototype.setReportSize(1, AreaUnits::Acres);
+    prototype.addResource(2, 8, TimeUnits::Hours, 20, SpeedUnits::ChainsPerHour, "crew", 1000, 100);
+    prototype.addResource(1, 8, TimeUnits::Hours, 10, SpeedUnits::ChainsPerHour, "engine", 500, 50);
+    prototype.addResource(2, 8, TimeUnits::Hours, 15, SpeedUnits::ChainsPerHour, "slower crew", 1200, 100); // dominated by the crew
+    prototype.addResource(10, 4, TimeUnits::Hours, 30, SpeedUnits::ChainsPerHour, "dozer", 300, 0);
+    prototype.addResource(0.5, 2, TimeUnits::Hours, 5, SpeedUnits::ChainsPerHour, "volunteers", 0, 0);
+
+    ContainOptimizer exhaustive(prototype);
+    exhaustive.setPruneDominatedResources(false);
+    exhaustive.setNumberOfThreads(2);
+    exhaustive.run();
+
+    ContainOptimizer optimizer(prototype);
+    optimizer.setNumberOfThreads(3);
+    testName = "Test Contain optimizer runs";
+    reportTestResult(testInfo, testName, optimizer.run(), true, error_tolerance);
+
+    testName = "Test Contain optimizer skips dominated and redundant subsets";
+    reportTestResult(testInfo, testName, optimizer.getNumberOfContainRuns() < exhaustive.getNumberOfContainRuns() &&
+        optimizer.getNumberOfDominatedSubsets() > 0 && optimizer.getNumberOfReusedResults() > 0, true, error_tolerance);
+
+    for(ContainParetoObjective::ContainParetoObjectiveEnum objective : { ContainParetoObjective::FinalFireSize, ContainParetoObjective::FinalTime })
+    {
+        std::vector<ContainScenarioResult> front = optimizer.getParetoFront(objective);
+        std::vector<ContainScenarioResult> expectedFront = exhaustive.getParetoFront(objective);
+        bool isFrontMatching = !front.empty() && front.size() == expectedFront.size();
+        for(size_t i = 0; isFrontMatching && i < front.size(); i++)
+        {
+            isFrontMatching = fabs(front[i].finalCost - expectedFront[i].finalCost) < error_tolerance &&
+                fabs(front[i].finalFireSize - expectedFront[i].finalFireSize) < error_tolerance &&
+                fabs(front[i].finalTime - expectedFront[i].finalTime) < error_tolerance;
+        }
+        testName = string("Test Contain optimizer Pareto front of cost versus ") +
+            ((objective == ContainParetoObjective::FinalTime) ? "time" : "fire size") + " matches exhaustive search";
+        reportTestResult(testInfo, testName, isFrontMatching, true, error_tolerance);
+    }
+
+    // The cheapest contained mix must reproduce with a single ContainAdapter run
+    ContainScenarioResult cheapest;
+    testName = "Test Contain optimizer finds a contained mix";
+    reportTestResult(testInfo, testName, optimizer.getCheapestContained(cheapest), true, error_tolerance);
+    ContainAdapter contain(prototype);
+    contain.removeAllResources();
+    for(int i = 0; i < prototype.getNumberOfResources(); i++)
+    {
+        if(cheapest.resourceMask & (1UL << i))
+        {
+            Sem::ContainResource resource = prototype.getResourceAt(i);
+            contain.addResource(resource);
+        }
+    }
+    contain.setTactic(cheapest.tactic);
+    contain.doContainRun();
+    testName = "Test Contain optimizer cheapest mix is contained when run on its own";
+    reportTestResult(testInfo, testName, contain.getContainmentStatus(), ContainStatus::Contained, error_tolerance);
+    testName = "Test Contain optimizer cheapest mix cost matches a single run";
+    reportTestResult(testInfo, testName, contain.getFinalCost(), cheapest.finalCost, error_tolerance);
+    testName = "Test Contain optimizer cheapest mix fire size matches a single run";
+    reportTestResult(testInfo, testName, contain.getFinalFireSize(AreaUnits::Acres),
+        AreaUnits::fromBaseUnits(cheapest.finalFireSize, AreaUnits::Acres), error_tolerance);
+
+    std::cout << "Finished testing Contain optimizer\n\n";
+}
+
+void testContainVariantRunner(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing Contain variant runner\n";
+
+    string testName = "";
+
+    ContainAdapter prototype;
+    prototype.setLwRatio(3);
+    prototype.setReportRate(5, SpeedUnits::ChainsPerHour);
+    prototype.setReportSize(1, AreaUnits::Acres);
+    prototype.addResource(2, 8, TimeUnits::Hours, 20, SpeedUnits::ChainsPerHour, "crew", 1000, 100);
+    prototype.addResource(1, 8, TimeUnits::Hours, 10, SpeedUnits::ChainsPerHour, "engine", 500, 50);
+
+    const double attackDistances[] = { 0, 1, 3 };
+    ContainVariantRunner runner(prototype);
+    runner.addTactic(ContainTactic::HeadAttack);
+    runner.addTactic(ContainTactic::RearAttack);
+    for(double attackDistance : attackDistances)
+    {
+        runner.addAttackDistance(attackDistance, LengthUnits::Chains);
+    }
+    runner.setNumberOfThreads(2);
+    runner.run();
+
+    const std::vector<ContainVariantResult>& results = runner.getResults();
+    testName = "Test Contain variant runner returns one result per tactic and attack distance";
+    reportTestResult(testInfo, testName, (int)results.size(), 6, error_tolerance);
+    testName = "Test Contain variant runner works out the fire at first attack once per worker";
+    reportTestResult(testInfo, testName, runner.getNumberOfFullRuns() >= 1 && runner.getNumberOfFullRuns() <= 2, true, error_tolerance);
+
+    // Every variant must reproduce with a single ContainAdapter run
+    bool isMatchingSingleRuns = results.size() == 6;
+    for(size_t i = 0; isMatchingSingleRuns && i < results.size(); i++)
+    {
+        ContainAdapter contain(prototype);
+        contain.setTactic(results[i].tactic);
+        contain.setAttackDistance(results[i].attackDistance, LengthUnits::Feet);
+        contain.doContainRun();
+        isMatchingSingleRuns = results[i].tactic == ((i < 3) ? ContainTactic::HeadAttack : ContainTactic::RearAttack) &&
+            fabs(LengthUnits::fromBaseUnits(results[i].attackDistance, LengthUnits::Chains) - attackDistances[i % 3]) < error_tolerance &&
+            results[i].status == contain.getContainmentStatus() &&
+            fabs(results[i].finalCost - contain.getFinalCost()) < error_tolerance &&
+            fabs(results[i].finalFireLineLength - contain.getFinalFireLineLength(LengthUnits::Feet)) < error_tolerance &&
+            fabs(results[i].finalFireSize - contain.getFinalFireSize(AreaUnits::SquareFeet)) < error_tolerance &&
+            fabs(results[i].finalTime - contain.getFinalTimeSinceReport(TimeUnits::Minutes)) < error_tolerance &&
+            results[i].numberOfSimulationSteps == contain.getNumberOfSimulationSteps();
+    }
+    testName = "Test Contain variant runner results match single runs";
+    reportTestResult(testInfo, testName, isMatchingSingleRuns, true, error_tolerance);
+
+    // A run with another tactic starts from the same fire at first attack
+    ContainAdapter shared(prototype);
+    shared.setTactic(ContainTactic::RearAttack);
+    shared.doContainRun();
+    shared.doContainRunWithAttack(ContainTactic::HeadAttack, 1, LengthUnits::Chains);
+    testName = "Test Contain run with another attack matches the head attack variant";
+    reportTestResult(testInfo, testName, shared.getFinalFireSize(AreaUnits::SquareFeet), results[1].finalFireSize, error_tolerance);
+
+    ContainVariantResult cheapest;
+    testName = "Test Contain variant runner finds a contained variant";
+    reportTestResult(testInfo, testName, runner.getCheapestContained(cheapest), true, error_tolerance);
+
+    std::cout << "Finished testing Contain variant runner\n\n";
+}
+
+void testContainEnsembleRunner(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing Contain ensemble runner\n";
+
+    string testName = "";
+
+    ContainAdapter prototype;
+    prototype.setLwRatio(3);
+    prototype.setReportRate(5, SpeedUnits::ChainsPerHour);
+    prototype.setReportSize(1, AreaUnits::Acres);
+    prototype.setFireStartTime(600);
+    prototype.addResource(2, 8, TimeUnits::Hours, 20, SpeedUnits::ChainsPerHour, "crew", 1000, 100);
+    prototype.addResource(1, 8, TimeUnits::Hours, 10, SpeedUnits::ChainsPerHour, "engine", 500, 50);
+
+    // A series holding the report rate and shape every hour is the plain report rate run
+    const int numberOfHours = 12;
+    const double reportRate = SpeedUnits::toBaseUnits(5, SpeedUnits::ChainsPerHour);
+    vector<double> constantSpreadRate(numberOfHours, reportRate);
+    vector<double> constantLengthToWidthRatio(numberOfHours, 3.0);
+    ContainHourlyFire constantFire = { numberOfHours, constantSpreadRate.data(), constantLengthToWidthRatio.data() };
+    ContainAdapter reportRun(prototype);
+    reportRun.doContainRun();
+    ContainAdapter hourlyRun(prototype);
+    hourlyRun.setHourlyFire(constantFire);
+    hourlyRun.doContainRun();
+    testName = "Test Contain with a constant hourly series matches the report rate run";
+    reportTestResult(testInfo, testName, hourlyRun.getFinalFireSize(AreaUnits::SquareFeet),
+        reportRun.getFinalFireSize(AreaUnits::SquareFeet), error_tolerance);
+
+    // The same start with the fire picking up after the first hour grows a larger fire
+    vector<double> risingSpreadRate(numberOfHours);
+    for(int hour = 0; hour < numberOfHours; hour++)
+    {
+        risingSpreadRate[hour] = reportRate * (1.0 + hour);
+    }
+    ContainHourlyFire risingFire = { numberOfHours, risingSpreadRate.data(), nullptr };
+    ContainAdapter risingRun(prototype);
+    risingRun.setHourlyFire(risingFire);
+    risingRun.doContainRun();
+    testName = "Test Contain with rising hourly spread rates grows a larger fire";
+    reportTestResult(testInfo, testName, risingRun.getFinalFireSize(AreaUnits::SquareFeet) >
+        reportRun.getFinalFireSize(AreaUnits::SquareFeet), true, error_tolerance);
+    risingRun.clearHourlyFire();
+    risingRun.doContainRun();
+    testName = "Test Contain after clearing the hourly series matches the report rate run";
+    reportTestResult(testInfo, testName, risingRun.getFinalFireSize(AreaUnits::SquareFeet),
+        reportRun.getFinalFireSize(AreaUnits::SquareFeet), error_tolerance);
+
+    // Members from time series runs of a day's weather with the wind scaled per member
+    const int numberOfMembers = 3;
+    BehaveTimeSeriesLocation location;
+    location.fuelModelNumber = 2;
+    location.slope = 10.0;
+    location.aspect = 180.0;
+    location.canopyCover = 0.0;
+    location.canopyHeight = 0.0;
+    location.canopyBaseHeight = 0.0;
+    location.canopyBulkDensity = 0.0;
+    location.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+    location.windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToNorth;
+    location.crownFireMethod = TimeSeriesCrownFireMethod::Rothermel;
+    vector<vector<double>> memberSpreadRates(numberOfMembers, vector<double>(numberOfHours));
+    vector<vector<double>> memberLengthToWidthRatios(numberOfMembers, vector<double>(numberOfHours));
+    BehaveRun timeSeriesRun(behaveRun);
+    ContainEnsembleRunner runner(prototype);
+    for(int member = 0; member < numberOfMembers; member++)
+    {
+        vector<double> windSpeed(numberOfHours);
+        vector<double> windDirection(numberOfHours, 180.0);
+        vector<double> moistureOneHour(numberOfHours, 0.06);
+        vector<double> moistureTenHour(numberOfHours, 0.07);
+        vector<double> moistureHundredHour(numberOfHours, 0.08);
+        vector<double> moistureLiveHerbaceous(numberOfHours, 0.6);
+        vector<double> moistureLiveWoody(numberOfHours, 0.9);
+        vector<double> moistureFoliar(numberOfHours, 1.0);
+        for(int hour = 0; hour < numberOfHours; hour++)
+        {
+            windSpeed[hour] = 88.0 * (1.0 + hour * 0.5) * (0.5 + 0.25 * member); // ft/min
+        }
+        BehaveTimeSeriesWeather weather;
+        weather.numberOfHours = numberOfHours;
+        weather.windSpeed = windSpeed.data();
+        weather.windDirection = windDirection.data();
+        weather.moistureOneHour = moistureOneHour.data();
+        weather.moistureTenHour = moistureTenHour.data();
+        weather.moistureHundredHour = moistureHundredHour.data();
+        weather.moistureLiveHerbaceous = moistureLiveHerbaceous.data();
+        weather.moistureLiveWoody = moistureLiveWoody.data();
+        weather.moistureFoliar = moistureFoliar.data();
+        BehaveTimeSeriesOutputs outputs = { memberSpreadRates[member].data(), nullptr, nullptr, nullptr, nullptr,
+            memberLengthToWidthRatios[member].data() };
+        timeSeriesRun.doTimeSeriesRun(location, weather, outputs);
+        ContainHourlyFire memberFire = { numberOfHours, memberSpreadRates[member].data(), memberLengthToWidthRatios[member].data() };
+        runner.addMember(memberFire);
+    }
+
+    std::vector<Sem::ContainResource> smallPlan;
+    smallPlan.push_back(prototype.getResourceAt(1));
+    std::vector<Sem::ContainResource> largePlan;
+    largePlan.push_back(prototype.getResourceAt(0));
+    largePlan.push_back(prototype.getResourceAt(1));
+    runner.addResourcePlan(smallPlan);
+    runner.addResourcePlan(largePlan);
+    runner.setNumberOfThreads(1);
+    runner.run();
+    std::vector<ContainEnsembleResult> singleThreadResults = runner.getResults();
+    runner.setNumberOfThreads(4);
+    runner.run();
+    const std::vector<ContainEnsembleResult>& results = runner.getResults();
+    testName = "Test Contain ensemble runner returns one result per member and plan";
+    reportTestResult(testInfo, testName, (int)results.size(), numberOfMembers * 2, error_tolerance);
+
+    // Every pairing must reproduce with a single ContainAdapter run, whatever the number of threads
+    bool isMatchingSingleRuns = results.size() == singleThreadResults.size();
+    for(size_t i = 0; isMatchingSingleRuns && i < results.size(); i++)
+    {
+        const std::vector<Sem::ContainResource>& plan = (results[i].plan == 0) ? smallPlan : largePlan;
+        ContainAdapter contain(prototype);
+        contain.removeAllResources();
+        for(Sem::ContainResource resource : plan)
+        {
+            contain.addResource(resource);
+        }
+        ContainHourlyFire memberFire = { numberOfHours, memberSpreadRates[results[i].member].data(),
+            memberLengthToWidthRatios[results[i].member].data() };
+        contain.setHourlyFire(memberFire);
+        contain.doContainRun();
+        isMatchingSingleRuns = results[i].member == (int)i / 2 && results[i].plan == (int)i % 2 &&
+            results[i].status == contain.getContainmentStatus() &&
+            results[i].status == singleThreadResults[i].status &&
+            fabs(results[i].finalCost - contain.getFinalCost()) < error_tolerance &&
+            fabs(results[i].finalFireLineLength - contain.getFinalFireLineLength(LengthUnits::Feet)) < error_tolerance &&
+            fabs(results[i].finalFireSize - contain.getFinalFireSize(AreaUnits::SquareFeet)) < error_tolerance &&
+            fabs(results[i].finalFireSize - singleThreadResults[i].finalFireSize) < error_tolerance &&
+            fabs(results[i].finalTime - contain.getFinalTimeSinceReport(TimeUnits::Minutes)) < error_tolerance &&
+            results[i].numberOfSimulationSteps == contain.getNumberOfSimulationSteps();
+    }
+    testName = "Test Contain ensemble runner results match single runs";
+    reportTestResult(testInfo, testName, isMatchingSingleRuns, true, error_tolerance);
+
+    // Windier members make for larger fires under the same plan
+    bool isGrowingWithWind = results.size() == numberOfMembers * 2;
+    for(size_t i = 2; isGrowingWithWind && i < results.size(); i++)
+    {
+        isGrowingWithWind = results[i].status != ContainStatus::Contained ||
+            results[i].finalFireSize > results[i - 2].finalFireSize;
+    }
+    testName = "Test Contain ensemble runner grows larger fires for windier members";
+    reportTestResult(testInfo, testName, isGrowingWithWind, true, error_tolerance);
+    testName = "Test Contain ensemble runner contains as often with the larger plan";
+    reportTestResult(testInfo, testName, runner.getFractionContained(1) >= runner.getFractionContained(0), true, error_tolerance);
+
+    std::cout << "Finished testing Contain ensemble runner\n\n";
+}
+
+// Distance between two doubles in units in the last place of the expected value
+static double unitsInTheLastPlace(double observed, double expected)
+{
+    if (observed == expected)
+    {
+        return 0.0;
+    }
+    double ulp = std::nextafter(fabs(expected), HUGE_VAL) - fabs(expected);
+    return fabs(observed - expected) / ulp;
+}
+
+void testVectorMath(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing vector math kernels\n";
+    string testName = "";
+
+    const int numberOfValues = 4001;
+    std::vector<double> x(numberOfValues);
+    std::vector<double> y(numberOfValues);
+    std::vector<double> exact(numberOfValues);
+    std::vector<double> fast(numberOfValues);
+
+    // Exact mode is the standard library
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        x[i] = 1.0e-3 * pow(1.0e7, i / (numberOfValues - 1.0)); // 0.001 to 10000
+    }
+    VectorMath::pow(x.data(), 1.5, exact.data(), numberOfValues, VectorMathMode::Exact);
+    int numberOfExactMismatches = 0;
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        numberOfExactMismatches += (exact[i] != pow(x[i], 1.5));
+    }
+    testName = "Test exact vector math pow is the standard library pow";
+    reportTestResult(testInfo, testName, numberOfExactMismatches, 0, error_tolerance);
+
+    // Powers used by the Rothermel model, within 4 + 2 * |y * ln(x)| ULP
+    const double exponents[] = { 1.5, 0.19, 0.46, -0.2, 0.4, 0.667, 2.5 };
+    int numberOfPowOverBudget = 0;
+    for (double exponent : exponents)
+    {
+        VectorMath::pow(x.data(), exponent, fast.data(), numberOfValues, VectorMathMode::Fast);
+        for (int i = 0; i < numberOfValues; i++)
+        {
+            double budget = 4.0 + 2.0 * fabs(exponent * log(x[i]));
+            numberOfPowOverBudget += (unitsInTheLastPlace(fast[i], pow(x[i], exponent)) > budget);
+        }
+    }
+    testName = "Test fast vector math pow is within its ULP budget";
+    reportTestResult(testInfo, testName, numberOfPowOverBudget, 0, error_tolerance);
+    x[0] = 0.0;
+    VectorMath::pow(x.data(), 0.46, fast.data(), 1, VectorMathMode::Fast);
+    testName = "Test fast vector math pow of zero is zero";
+    reportTestResult(testInfo, testName, fast[0], 0.0, error_tolerance);
+
+    double maxUlp = 0.0;
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        x[i] = -700.0 + 1400.0 * i / (numberOfValues - 1.0);
+    }
+    VectorMath::exp(x.data(), fast.data(), numberOfValues, VectorMathMode::Fast);
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        maxUlp = std::max(maxUlp, unitsInTheLastPlace(fast[i], exp(x[i])));
+    }
+    testName = "Test fast vector math exp is within 2 ULP";
+    reportTestResult(testInfo, testName, maxUlp <= 2.0, true, error_tolerance);
+    x[0] = -800.0;
+    x[1] = 800.0;
+    VectorMath::exp(x.data(), fast.data(), 2, VectorMathMode::Fast);
+    testName = "Test fast vector math exp underflows to zero";
+    reportTestResult(testInfo, testName, fast[0], 0.0, error_tolerance);
+    testName = "Test fast vector math exp overflows to infinity";
+    reportTestResult(testInfo, testName, std::isinf(fast[1]), true, error_tolerance);
+
+    maxUlp = 0.0;
+    bool isEveryLogInputFinite = true;
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        x[i] = pow(10.0, -300.0 + 600.0 * i / (numberOfValues - 1.0));
+        isEveryLogInputFinite = isEveryLogInputFinite && std::isfinite(x[i]) && x[i] > 0.0;
+    }
+    testName = "Test fast vector math log inputs are finite";
+    reportTestResult(testInfo, testName, isEveryLogInputFinite, true, error_tolerance);
+    VectorMath::log(x.data(), fast.data(), numberOfValues, VectorMathMode::Fast);
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        maxUlp = std::max(maxUlp, unitsInTheLastPlace(fast[i], log(x[i])));
+    }
+    testName = "Test fast vector math log is within 2 ULP";
+    reportTestResult(testInfo, testName, maxUlp <= 2.0, true, error_tolerance);
+
+    // Sines and cosines of every angle of a sweep in radians, within 4.5e-16
+    double maxSinError = 0.0;
+    double maxCosError = 0.0;
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        x[i] = -4.0 * M_PI + 8.0 * M_PI * i / (numberOfValues - 1.0);
+    }
+    VectorMath::sin(x.data(), fast.data(), numberOfValues, VectorMathMode::Fast);
+    VectorMath::cos(x.data(), exact.data(), numberOfValues, VectorMathMode::Fast);
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        maxSinError = std::max(maxSinError, fabs(fast[i] - sin(x[i])));
+        maxCosError = std::max(maxCosError, fabs(exact[i] - cos(x[i])));
+    }
+    testName = "Test fast vector math sin is within 4.5e-16";
+    reportTestResult(testInfo, testName, maxSinError <= 4.5e-16, true, error_tolerance);
+    testName = "Test fast vector math cos is within 4.5e-16";
+    reportTestResult(testInfo, testName, maxCosError <= 4.5e-16, true, error_tolerance);
+
+    // Every quadrant and the axes
+    maxUlp = 0.0;
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        double angle = 2.0 * M_PI * i / (numberOfValues - 1.0);
+        double radius = 0.5 + (i % 7);
+        x[i] = radius * cos(angle);
+        y[i] = radius * sin(angle);
+    }
+    x[0] = 0.0;
+    y[0] = 0.0;
+    x[1] = -1.0;
+    y[1] = 0.0;
+    x[2] = 0.0;
+    y[2] = -2.0;
+    VectorMath::atan2(y.data(), x.data(), fast.data(), numberOfValues, VectorMathMode::Fast);
+    for (int i = 0; i < numberOfValues; i++)
+    {
+        maxUlp = std::max(maxUlp, unitsInTheLastPlace(fast[i], atan2(y[i], x[i])));
+    }
+    testName = "Test fast vector math atan2 is within 3 ULP";
+    reportTestResult(testInfo, testName, maxUlp <= 3.0, true, error_tolerance);
+
+    std::cout << "Finished testing vector math kernels\n\n";
+}
+
+void testFusedSurfaceRun(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing fused surface, spot, mortality and safety run\n";
+
+    string testName = "";
+
+    // Copying a BehaveRun leaves out its mortality and safety modules, so every run is set up the same way
+    auto setFusedRunInputs = [](BehaveRun& run)
+    {
+        setSurfaceInputsForGS4LowMoistureScenario(run);
+        run.surface.setSlope(20.0, SlopeUnits::Percent);
+        run.surface.setCanopyCover(40.0, FractionUnits::Percent);
+        run.surface.setCanopyHeight(50.0, LengthUnits::Feet);
+        run.surface.setCrownRatio(0.5, FractionUnits::Fraction);
+        run.surface.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UseCrownRatio);
+        run.spot.setDownwindCoverHeight(30.0, LengthUnits::Feet);
+        run.spot.setDownwindCanopyMode(SpotDownWindCanopyMode::CLOSED);
+        run.spot.setLocation(SpotFireLocation::MIDSLOPE_WINDWARD);
+        run.spot.setRidgeToValleyDistance(1.0, LengthUnits::Miles);
+        run.spot.setRidgeToValleyElevation(1000.0, LengthUnits::Feet);
+        run.mortality.setRegion(RegionCode::interior_west);
+        run.mortality.setEquationType(EquationType::crown_scorch);
+        run.mortality.setSpeciesCode("PIPO");
+        run.mortality.setTreeDensityPerUnitArea(10.0, AreaUnits::Acres);
+        run.mortality.setDBH(12.0, LengthUnits::Inches);
+        run.mortality.setTreeHeight(60.0, LengthUnits::Feet);
+        run.mortality.setCrownRatio(0.4, FractionUnits::Fraction);
+        run.mortality.setAirTemperature(85.0, TemperatureUnits::Fahrenheit);
+        run.safety.updateSafetyInputs(0.0, LengthUnits::Feet, 10, 1, 50.0, 300.0, AreaUnits::SquareFeet);
+    };
+    BehaveRun fusedRun(behaveRun);
+    setFusedRunInputs(fusedRun);
+
+    // The same chain through each module's setters in other units, which round trips the values through the
+    // conversion factors
+    BehaveRun chainRun(behaveRun);
+    setFusedRunInputs(chainRun);
+    chainRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    chainRun.spot.setFlameLength(chainRun.surface.getFlameLength(LengthUnits::Meters), LengthUnits::Meters);
+    chainRun.spot.setWindSpeedAtTwentyFeet(chainRun.surface.getWindSpeed(SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot),
+        SpeedUnits::MilesPerHour);
+    chainRun.spot.calculateSpottingDistanceFromSurfaceFire();
+    chainRun.mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::flame_length);
+    chainRun.mortality.setFlameLength(chainRun.surface.getFlameLength(LengthUnits::Meters), LengthUnits::Meters);
+    chainRun.mortality.setFirelineIntensity(chainRun.surface.getFirelineIntensity(FirelineIntensityUnits::KilowattsPerMeter),
+        FirelineIntensityUnits::KilowattsPerMeter);
+    chainRun.mortality.setMidFlameWindSpeed(chainRun.surface.getMidflameWindspeed(SpeedUnits::MetersPerSecond), SpeedUnits::MetersPerSecond);
+    double chainProbabilityOfMortality = chainRun.mortality.calculateMortality(FractionUnits::Fraction);
+    chainRun.safety.setFlameHeight(chainRun.surface.getFlameLength(LengthUnits::Meters), LengthUnits::Meters);
+    chainRun.safety.calculateSafetyZone();
+
+    fusedRun.doFusedSurfaceRun();
+    double chainFlatDistance = chainRun.spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+    double chainScorchHeight = chainRun.mortality.getScorchHeight(LengthUnits::Feet);
+    double chainSafetyZoneRadius = chainRun.safety.getSafetyZoneRadius(LengthUnits::Feet);
+    testName = "Test fused run spotting distance matches chaining the modules";
+    reportTestResult(testInfo, testName, fusedRun.spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet) / chainFlatDistance,
+        1.0, 1e-7);
+    testName = "Test fused run scorch height matches chaining the modules";
+    reportTestResult(testInfo, testName, fusedRun.mortality.getScorchHeight(LengthUnits::Feet) / chainScorchHeight, 1.0, 1e-7);
+    testName = "Test fused run probability of mortality matches chaining the modules";
+    reportTestResult(testInfo, testName, fusedRun.mortality.calculateMortality(FractionUnits::Fraction), chainProbabilityOfMortality, 1e-7);
+    testName = "Test fused run safety zone radius matches chaining the modules";
+    reportTestResult(testInfo, testName, fusedRun.safety.getSafetyZoneRadius(LengthUnits::Feet) / chainSafetyZoneRadius, 1.0, 1e-7);
+
+    // Batch cells from calm to windy, each against the single fused run of its inputs
+    const int numberOfCells = 4;
+    const int fuelModelNumber[numberOfCells] = { 124, 124, 124, 124 };
+    const double moistureOneHour[numberOfCells] = { 0.06, 0.06, 0.06, 0.06 };
+    const double moistureTenHour[numberOfCells] = { 0.07, 0.07, 0.07, 0.07 };
+    const double moistureHundredHour[numberOfCells] = { 0.08, 0.08, 0.08, 0.08 };
+    const double moistureLiveHerbaceous[numberOfCells] = { 0.6, 0.6, 0.6, 0.6 };
+    const double moistureLiveWoody[numberOfCells] = { 0.9, 0.9, 0.9, 0.9 };
+    const double windSpeed[numberOfCells] = { 0.0, 440.0, 880.0, 1760.0 };
+    const double windDirection[numberOfCells] = { 0.0, 90.0, 90.0, 180.0 };
+    const double slope[numberOfCells] = { 11.3, 11.3, 11.3, 11.3 };
+    const double aspect[numberOfCells] = { 0.0, 0.0, 0.0, 0.0 };
+    const double canopyCover[numberOfCells] = { 0.4, 0.4, 0.4, 0.4 };
+    const double canopyHeight[numberOfCells] = { 50.0, 50.0, 50.0, 50.0 };
+    const double crownRatio[numberOfCells] = { 0.5, 0.5, 0.5, 0.5 };
+    SurfaceBatchInputs inputs = { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour, moistureHundredHour,
+        moistureLiveHerbaceous, moistureLiveWoody, windSpeed, windDirection, slope, aspect, canopyCover, canopyHeight, crownRatio };
+    vector<double> values(11 * numberOfCells);
+    BehaveFusedBatchOutputs outputs = { &values[0], &values[numberOfCells], &values[2 * numberOfCells], &values[3 * numberOfCells],
+        &values[4 * numberOfCells], &values[5 * numberOfCells], &values[6 * numberOfCells], &values[7 * numberOfCells],
+        &values[8 * numberOfCells], &values[9 * numberOfCells], &values[10 * numberOfCells] };
+    BehaveRun batchRun(behaveRun);
+    setFusedRunInputs(batchRun);
+    double scorchHeightBeforeBatch = batchRun.mortality.getScorchHeight(LengthUnits::Feet);
+    batchRun.doFusedSurfaceRunBatch(inputs, outputs);
+
+    double maxRelativeError = 0.0;
+    BehaveRun singleRun(behaveRun);
+    setFusedRunInputs(singleRun);
+    const WindHeightInputMode::WindHeightInputModeEnum windHeightInputMode = singleRun.surface.getWindHeightInputMode();
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        singleRun.surface.setFuelModelNumber(fuelModelNumber[i]);
+        singleRun.surface.setMoistureOneHour(moistureOneHour[i], FractionUnits::Fraction);
+        singleRun.surface.setMoistureTenHour(moistureTenHour[i], FractionUnits::Fraction);
+        singleRun.surface.setMoistureHundredHour(moistureHundredHour[i], FractionUnits::Fraction);
+        singleRun.surface.setMoistureLiveHerbaceous(moistureLiveHerbaceous[i], FractionUnits::Fraction);
+        singleRun.surface.setMoistureLiveWoody(moistureLiveWoody[i], FractionUnits::Fraction);
+        singleRun.surface.setWindSpeed(windSpeed[i], SpeedUnits::FeetPerMinute, windHeightInputMode);
+        singleRun.surface.setWindDirection(windDirection[i]);
+        singleRun.surface.setSlope(slope[i], SlopeUnits::Degrees);
+        singleRun.surface.setAspect(aspect[i]);
+        singleRun.doFusedSurfaceRun();
+        // The spot module keeps its previous mountain distance when nothing spots, the batch gives zero
+        double flatDistance = singleRun.spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+        const double expected[] = { singleRun.surface.getSpreadRate(SpeedUnits::FeetPerMinute),
+            singleRun.surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond),
+            singleRun.surface.getFlameLength(LengthUnits::Feet), singleRun.spot.getMaxFirebrandHeightFromSurfaceFire(LengthUnits::Feet),
+            flatDistance, (flatDistance > 0.0) ? singleRun.spot.getMaxMountainousTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet) : 0.0,
+            singleRun.mortality.getScorchHeight(LengthUnits::Feet), singleRun.mortality.calculateMortality(FractionUnits::Fraction),
+            singleRun.safety.getSeparationDistance(LengthUnits::Feet), singleRun.safety.getSafetyZoneRadius(LengthUnits::Feet),
+            singleRun.safety.getSafetyZoneArea(AreaUnits::SquareFeet) };
+        for(int output = 0; output < 11; output++)
+        {
+            double observed = values[output * numberOfCells + i];
+            maxRelativeError = std::max(maxRelativeError, fabs(observed - expected[output]) / std::max(1.0, fabs(expected[output])));
+        }
+    }
+    testName = "Test fused batch run matches a fused run of each cell";
+    reportTestResult(testInfo, testName, maxRelativeError < 1e-12, true, error_tolerance);
+    testName = "Test fused batch run spots and scorches more in the wind";
+    reportTestResult(testInfo, testName, values[4 * numberOfCells + 3] > values[4 * numberOfCells + 1] &&
+        values[6 * numberOfCells + 3] > 0.0, true, error_tolerance);
+    testName = "Test fused batch run leaves the mortality module's fire inputs alone";
+    reportTestResult(testInfo, testName, batchRun.mortality.getScorchHeight(LengthUnits::Feet), scorchHeightBeforeBatch, error_tolerance);
+
+    std::cout << "Finished testing fused surface, spot, mortality and safety run\n\n";
+}
+
+void testTimeSeriesRun(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing time series run\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-12;
+
+    // A day of hourly weather, drying and winding up in the afternoon, with the moistures held
+    // for a few hours so only the wind changes
+    const int numberOfHours = 24;
+    vector<double> windSpeed(numberOfHours);
+    vector<double> windDirection(numberOfHours);
+    vector<double> moistureOneHour(numberOfHours);
+    vector<double> moistureTenHour(numberOfHours);
+    vector<double> moistureHundredHour(numberOfHours);
+    vector<double> moistureLiveHerbaceous(numberOfHours);
+    vector<double> moistureLiveWoody(numberOfHours);
+    vector<double> moistureFoliar(numberOfHours);
+    for(int hour = 0; hour < numberOfHours; hour++)
+    {
+        double afternoon = sin(M_PI * hour / (numberOfHours - 1.0));
+        int moistureHour = (hour < 6) ? 0 : hour;
+        double dryness = sin(M_PI * moistureHour / (numberOfHours - 1.0));
+        windSpeed[hour] = 88.0 * (3.0 + 22.0 * afternoon); // ft/min
+        windDirection[hour] = 15.0 * hour;
+        moistureOneHour[hour] = 0.12 - 0.09 * dryness;
+        moistureTenHour[hour] = 0.13 - 0.08 * dryness;
+        moistureHundredHour[hour] = 0.14 - 0.05 * dryness;
+        moistureLiveHerbaceous[hour] = 0.9 - 0.3 * dryness;
+        moistureLiveWoody[hour] = 1.2 - 0.3 * dryness;
+        moistureFoliar[hour] = 1.1 - 0.2 * dryness;
+    }
+
+    BehaveTimeSeriesWeather weather;
+    weather.numberOfHours = numberOfHours;
+    weather.windSpeed = windSpeed.data();
+    weather.windDirection = windDirection.data();
+    weather.moistureOneHour = moistureOneHour.data();
+    weather.moistureTenHour = moistureTenHour.data();
+    weather.moistureHundredHour = moistureHundredHour.data();
+    weather.moistureLiveHerbaceous = moistureLiveHerbaceous.data();
+    weather.moistureLiveWoody = moistureLiveWoody.data();
+    weather.moistureFoliar = moistureFoliar.data();
+
+    BehaveTimeSeriesLocation location;
+    location.fuelModelNumber = 165;
+    location.slope = 20.0;
+    location.aspect = 200.0;
+    location.canopyCover = 0.5;
+    location.canopyHeight = 60.0;
+    location.canopyBaseHeight = 6.0;
+    location.canopyBulkDensity = 0.02;
+    location.windHeightInputMode = WindHeightInputMode::TwentyFoot;
+    location.windAndSpreadOrientationMode = WindAndSpreadOrientationMode::RelativeToNorth;
+
+    const TimeSeriesCrownFireMethod::TimeSeriesCrownFireMethodEnum crownFireMethods[] =
+        { TimeSeriesCrownFireMethod::Rothermel, TimeSeriesCrownFireMethod::ScottAndReinhardt };
+    const std::string crownFireMethodNames[] = { "Rothermel", "Scott and Reinhardt" };
+    for(int method = 0; method < 2; method++)
+    {
+        location.crownFireMethod = crownFireMethods[method];
+
+        // Expected values from a copy of the crown module with every input set hour by hour
+        Crown crown(behaveRun.crown);
+        vector<double> expectedSpreadRate(numberOfHours);
+        vector<double> expectedFlameLength(numberOfHours);
+        vector<double> expectedFirelineIntensity(numberOfHours);
+        vector<int> expectedFireType(numberOfHours);
+        vector<double> expectedCrownFractionBurned(numberOfHours);
+        vector<double> expectedLengthToWidthRatio(numberOfHours);
+        for(int hour = 0; hour < numberOfHours; hour++)
+        {
+            crown.updateCrownInputs(location.fuelModelNumber, moistureOneHour[hour], moistureTenHour[hour], moistureHundredHour[hour],
+                moistureLiveHerbaceous[hour], moistureLiveWoody[hour], moistureFoliar[hour], FractionUnits::Fraction, windSpeed[hour],
+                SpeedUnits::FeetPerMinute, location.windHeightInputMode, windDirection[hour], location.windAndSpreadOrientationMode,
+                location.slope, SlopeUnits::Degrees, location.aspect, location.canopyCover, FractionUnits::Fraction, location.canopyHeight,
+                location.canopyBaseHeight, LengthUnits::Feet, (60.0 - 6.0) / 60.0, FractionUnits::Fraction, location.canopyBulkDensity,
+                DensityUnits::PoundsPerCubicFoot);
+            if(location.crownFireMethod == TimeSeriesCrownFireMethod::Rothermel)
+            {
+                crown.doCrownRunRothermel();
+            }
+            else
+            {
+                crown.doCrownRunScottAndReinhardt();
+            }
+            expectedSpreadRate[hour] = crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+            expectedFlameLength[hour] = crown.getFinalFlameLength(LengthUnits::Feet);
+            expectedFirelineIntensity[hour] = crown.getFinalFirelineIntesity(FirelineIntensityUnits::BtusPerFootPerSecond);
+            expectedFireType[hour] = crown.getFireType();
+            expectedCrownFractionBurned[hour] = crown.getCrownFractionBurned();
+            expectedLengthToWidthRatio[hour] = (crown.getFireType() == FireType::Crowning) ?
+                crown.getCrownFireLengthToWidthRatio() : crown.getSurfaceFireLengthToWidthRatio();
+        }
+
+        vector<double> spreadRate(numberOfHours, -1.0);
+        vector<double> flameLength(numberOfHours, -1.0);
+        vector<double> firelineIntensity(numberOfHours, -1.0);
+        vector<int> fireType(numberOfHours, -1);
+        vector<double> crownFractionBurned(numberOfHours, -1.0);
+        vector<double> lengthToWidthRatio(numberOfHours, -1.0);
+        BehaveTimeSeriesOutputs outputs;
+        outputs.spreadRate = spreadRate.data();
+        outputs.flameLength = flameLength.data();
+        outputs.firelineIntensity = firelineIntensity.data();
+        outputs.fireType = fireType.data();
+        outputs.crownFractionBurned = crownFractionBurned.data();
+        outputs.lengthToWidthRatio = lengthToWidthRatio.data();
+        behaveRun.doTimeSeriesRun(location, weather, outputs);
+
+        int numberOfMismatches = 0;
+        int numberOfCrownFireHours = 0;
+        for(int hour = 0; hour < numberOfHours; hour++)
+        {
+            if((fabs(spreadRate[hour] - expectedSpreadRate[hour]) > error_tolerance * expectedSpreadRate[hour]) ||
+                (fabs(flameLength[hour] - expectedFlameLength[hour]) > error_tolerance * expectedFlameLength[hour]) ||
+                (fabs(firelineIntensity[hour] - expectedFirelineIntensity[hour]) > error_tolerance * expectedFirelineIntensity[hour]) ||
+                (fabs(crownFractionBurned[hour] - expectedCrownFractionBurned[hour]) > error_tolerance) ||
+                (fabs(lengthToWidthRatio[hour] - expectedLengthToWidthRatio[hour]) > error_tolerance * expectedLengthToWidthRatio[hour]) ||
+                (lengthToWidthRatio[hour] < 1.0) ||
+                (fireType[hour] != expectedFireType[hour]))
+            {
+                numberOfMismatches++;
+            }
+            if(expectedFireType[hour] != FireType::Surface)
+            {
+                numberOfCrownFireHours++;
+            }
+        }
+        testName = "Test " + crownFireMethodNames[method] + " time series matches hour by hour crown runs";
+        reportTestResult(testInfo, testName, numberOfMismatches, 0, error_tolerance);
+        testName = "Test " + crownFireMethodNames[method] + " time series has surface and crown fire hours";
+        reportTestResult(testInfo, testName, (numberOfCrownFireHours > 0) && (numberOfCrownFireHours < numberOfHours), true, error_tolerance);
+    }
+
+    testName = "Test time series run restores crown fuel model reuse setting";
+    reportTestResult(testInfo, testName, behaveRun.crown.getIsReusingCrownFuelModel(), false, error_tolerance);
+
+    // Nothing to burn, every hour is left at zero without running the crown module
+    location.fuelModelNumber = 91; // NB1, urban
+    vector<double> spreadRate(numberOfHours, -1.0);
+    BehaveTimeSeriesOutputs outputs = { spreadRate.data(), nullptr, nullptr, nullptr, nullptr, nullptr };
+    behaveRun.doTimeSeriesRun(location, weather, outputs);
+    double maxSpreadRate = *std::max_element(spreadRate.begin(), spreadRate.end());
+    double minSpreadRate = *std::min_element(spreadRate.begin(), spreadRate.end());
+    testName = "Test non-burnable time series has zero spread rate";
+    reportTestResult(testInfo, testName, (minSpreadRate == 0.0) && (maxSpreadRate == 0.0), true, error_tolerance);
+
+    std::cout << "Finished testing time series run\n\n";
+}
+
+void testMonteCarloRunner(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing Monte Carlo runner\n";
+
+    string testName = "";
+
+    // The counter-based draws are repeatable and spread evenly over (0, 1)
+    const int numberOfDraws = 100000;
+    double sumOfDraws = 0.0;
+    bool isEveryDrawInRange = true;
+    for(int i = 0; i < numberOfDraws; i++)
+    {
+        double u = CounterBasedRandom::getUniform(42, i, 3);
+        isEveryDrawInRange = isEveryDrawInRange && (u > 0.0) && (u < 1.0);
+        sumOfDraws += u;
+    }
+    testName = "Test counter-based random draws are in (0, 1)";
+    reportTestResult(testInfo, testName, isEveryDrawInRange, true, error_tolerance);
+    testName = "Test counter-based random draws average one half";
+    reportTestResult(testInfo, testName, sumOfDraws / numberOfDraws, 0.5, 0.005);
+    testName = "Test counter-based random draws depend only on seed, counter and stream";
+    reportTestResult(testInfo, testName, CounterBasedRandom::getBits(42, 7, 3) == CounterBasedRandom::getBits(42, 7, 3) &&
+        CounterBasedRandom::getBits(42, 7, 3) != CounterBasedRandom::getBits(42, 7, 4) &&
+        CounterBasedRandom::getBits(42, 7, 3) != CounterBasedRandom::getBits(43, 7, 3), true, error_tolerance);
+
+    // Sample means of the distributions
+    const MonteCarloDistribution distributions[] =
+    {
+        MonteCarloDistribution::constant(0.06),
+        MonteCarloDistribution::uniform(2.0, 6.0),
+        MonteCarloDistribution::triangular(1.0, 2.0, 6.0),
+        MonteCarloDistribution::normal(10.0, 2.0, 0.0, 0.0)
+    };
+    const double expectedMeans[] = { 0.06, 4.0, 3.0, 10.0 };
+    const std::string distributionNames[] = { "constant", "uniform", "triangular", "normal" };
+    for(int d = 0; d < 4; d++)
+    {
+        double sum = 0.0;
+        for(int i = 0; i < numberOfDraws; i++)
+        {
+            sum += MonteCarloRunner::drawSample(distributions[d], 42, i, 0);
+        }
+        testName = "Test Monte Carlo " + distributionNames[d] + " sample mean";
+        reportTestResult(testInfo, testName, sum / numberOfDraws, expectedMeans[d], 0.02);
+    }
+    MonteCarloDistribution clampedNormal = MonteCarloDistribution::normal(10.0, 5.0, 8.0, 12.0);
+    bool isEverySampleClamped = true;
+    for(int i = 0; i < 1000; i++)
+    {
+        double sample = MonteCarloRunner::drawSample(clampedNormal, 42, i, 1);
+        isEverySampleClamped = isEverySampleClamped && (sample >= 8.0) && (sample <= 12.0);
+    }
+    testName = "Test Monte Carlo normal samples are clamped to their bounds";
+    reportTestResult(testInfo, testName, isEverySampleClamped, true, error_tolerance);
+
+    // Quantiles of evenly spread values
+    MonteCarloHistogram histogram(0.0, 100.0, 100);
+    for(int i = 0; i < 1000; i++)
+    {
+        histogram.add(i * 0.1);
+    }
+    histogram.add(-5.0);
+    histogram.add(250.0);
+    testName = "Test Monte Carlo histogram median";
+    reportTestResult(testInfo, testName, histogram.getQuantile(0.5), 50.0, 0.1);
+    testName = "Test Monte Carlo histogram 90th percentile";
+    reportTestResult(testInfo, testName, histogram.getQuantile(0.9), 90.0, 0.2);
+    testName = "Test Monte Carlo histogram counts values outside its bins";
+    reportTestResult(testInfo, testName, histogram.getNumberBelowMinimum() == 1 && histogram.getNumberAboveMaximum() == 1 &&
+        histogram.getQuantile(0.0) == -5.0 && histogram.getQuantile(1.0) == 250.0, true, error_tolerance);
+
+    // A timber site with uncertain weather and canopy base height
+    MonteCarloInputs inputs;
+    inputs.numberOfSamples = 1000;
+    inputs.seed = 20260101;
+    inputs.fuelModelNumber = 165;
+    inputs.slope = 20.0;
+    inputs.aspect = 200.0;
+    inputs.canopyCover = 0.5;
+    inputs.canopyHeight = 60.0;
+    inputs.canopyBulkDensity = 0.02;
+    inputs.windSpeed = MonteCarloDistribution::normal(88.0 * 15.0, 88.0 * 5.0, 0.0, 88.0 * 40.0);
+    inputs.windDirection = MonteCarloDistribution::uniform(180.0, 270.0);
+    inputs.moistureOneHour = MonteCarloDistribution::triangular(0.03, 0.05, 0.10);
+    inputs.moistureTenHour = MonteCarloDistribution::triangular(0.04, 0.06, 0.11);
+    inputs.moistureHundredHour = MonteCarloDistribution::uniform(0.07, 0.12);
+    inputs.moistureLiveHerbaceous = MonteCarloDistribution::constant(0.6);
+    inputs.moistureLiveWoody = MonteCarloDistribution::uniform(0.7, 1.2);
+    inputs.moistureFoliar = MonteCarloDistribution::normal(1.0, 0.1, 0.7, 1.3);
+    inputs.canopyBaseHeight = MonteCarloDistribution::uniform(2.0, 12.0);
+
+    const MonteCarloFireMethod::MonteCarloFireMethodEnum fireMethods[] =
+        { MonteCarloFireMethod::Surface, MonteCarloFireMethod::ScottAndReinhardt };
+    const std::string fireMethodNames[] = { "surface", "Scott and Reinhardt" };
+    for(int method = 0; method < 2; method++)
+    {
+        // Expected values from one run per sample, with every output kept
+        Surface surface(behaveRun.surface);
+        Crown crown(behaveRun.crown);
+        vector<double> expectedSpreadRate(inputs.numberOfSamples);
+        double expectedMeanSpreadRate = 0.0;
+        double expectedMeanFlameLength = 0.0;
+        double expectedMeanCrownFractionBurned = 0.0;
+        long expectedNumberOfCrowningSamples = 0;
+        for(long i = 0; i < inputs.numberOfSamples; i++)
+        {
+            double sample[9];
+            const MonteCarloDistribution* sampledInputs[9] = { &inputs.windSpeed, &inputs.windDirection, &inputs.moistureOneHour,
+                &inputs.moistureTenHour, &inputs.moistureHundredHour, &inputs.moistureLiveHerbaceous, &inputs.moistureLiveWoody,
+                &inputs.moistureFoliar, &inputs.canopyBaseHeight };
+            for(int input = 0; input < 9; input++)
+            {
+                sample[input] = MonteCarloRunner::drawSample(*sampledInputs[input], inputs.seed, i, input);
+            }
+            double crownRatio = (60.0 - sample[8]) / 60.0;
+            if(fireMethods[method] == MonteCarloFireMethod::Surface)
+            {
+                surface.updateSurfaceInputs(inputs.fuelModelNumber, sample[2], sample[3], sample[4], sample[5], sample[6],
+                    FractionUnits::Fraction, sample[0], SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot, sample[1],
+                    WindAndSpreadOrientationMode::RelativeToNorth, inputs.slope, SlopeUnits::Degrees, inputs.aspect, inputs.canopyCover,
+                    FractionUnits::Fraction, inputs.canopyHeight, LengthUnits::Feet, crownRatio, FractionUnits::Fraction);
+                surface.doSurfaceRunInDirectionOfMaxSpread();
+                expectedSpreadRate[i] = surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+                expectedMeanFlameLength += surface.getFlameLength(LengthUnits::Feet);
+            }
+            else
+            {
+                crown.updateCrownInputs(inputs.fuelModelNumber, sample[2], sample[3], sample[4], sample[5], sample[6], sample[7],
+                    FractionUnits::Fraction, sample[0], SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot, sample[1],
+                    WindAndSpreadOrientationMode::RelativeToNorth, inputs.slope, SlopeUnits::Degrees, inputs.aspect, inputs.canopyCover,
+                    FractionUnits::Fraction, inputs.canopyHeight, sample[8], LengthUnits::Feet, crownRatio, FractionUnits::Fraction,
+                    inputs.canopyBulkDensity, DensityUnits::PoundsPerCubicFoot);
+                crown.doCrownRunScottAndReinhardt();
+                expectedSpreadRate[i] = crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+                expectedMeanFlameLength += crown.getFinalFlameLength(LengthUnits::Feet);
+                expectedMeanCrownFractionBurned += crown.getCrownFractionBurned();
+                expectedNumberOfCrowningSamples += (crown.getFireType() == FireType::Crowning);
+            }
+            expectedMeanSpreadRate += expectedSpreadRate[i];
+        }
+        expectedMeanSpreadRate /= inputs.numberOfSamples;
+        expectedMeanFlameLength /= inputs.numberOfSamples;
+        expectedMeanCrownFractionBurned /= inputs.numberOfSamples;
+        std::sort(expectedSpreadRate.begin(), expectedSpreadRate.end());
+
+        MonteCarloRunner runner(behaveRun);
+        runner.setFireMethod(fireMethods[method]);
+        runner.setSpreadRateBins(0.0, 500.0, 5000);
+        runner.setNumberOfThreads(1);
+        runner.run(inputs);
+        const double meanSpreadRate = runner.getMeanSpreadRate();
+        const long numberOfCrowningSamples = runner.getNumberOfSamplesOfFireType(FireType::Crowning);
+        const MonteCarloHistogram spreadRateHistogram = runner.getSpreadRateHistogram();
+
+        testName = "Test Monte Carlo " + fireMethodNames[method] + " mean spread rate matches one run per sample";
+        reportTestResult(testInfo, testName, meanSpreadRate, expectedMeanSpreadRate, 1e-10 * expectedMeanSpreadRate);
+        testName = "Test Monte Carlo " + fireMethodNames[method] + " mean flame length matches one run per sample";
+        reportTestResult(testInfo, testName, runner.getMeanFlameLength(), expectedMeanFlameLength, 1e-10 * expectedMeanFlameLength);
+        testName = "Test Monte Carlo " + fireMethodNames[method] + " mean crown fraction burned matches one run per sample";
+        reportTestResult(testInfo, testName, runner.getMeanCrownFractionBurned(), expectedMeanCrownFractionBurned, 1e-10);
+        testName = "Test Monte Carlo " + fireMethodNames[method] + " crowning samples match one run per sample";
+        reportTestResult(testInfo, testName, (double)numberOfCrowningSamples, (double)expectedNumberOfCrowningSamples, error_tolerance);
+        testName = "Test Monte Carlo " + fireMethodNames[method] + " median spread rate is within a bin of the samples' median";
+        reportTestResult(testInfo, testName, spreadRateHistogram.getQuantile(0.5), expectedSpreadRate[inputs.numberOfSamples / 2], 0.2);
+        testName = "Test Monte Carlo " + fireMethodNames[method] + " histogram holds every sample";
+        reportTestResult(testInfo, testName, (double)spreadRateHistogram.getNumberOfValues(), (double)inputs.numberOfSamples, error_tolerance);
+
+        // The same results on more threads
+        runner.setNumberOfThreads(3);
+        runner.run(inputs);
+        bool isEveryBinEqual = true;
+        for(int bin = 0; bin < spreadRateHistogram.getNumberOfBins(); bin++)
+        {
+            isEveryBinEqual = isEveryBinEqual && (runner.getSpreadRateHistogram().getCount(bin) == spreadRateHistogram.getCount(bin));
+        }
+        testName = "Test Monte Carlo " + fireMethodNames[method] + " results do not depend on the number of threads";
+        reportTestResult(testInfo, testName, isEveryBinEqual && (runner.getMeanSpreadRate() == meanSpreadRate) &&
+            (runner.getNumberOfSamplesOfFireType(FireType::Crowning) == numberOfCrowningSamples), true, error_tolerance);
+    }
+
+    std::cout << "Finished testing Monte Carlo runner\n\n";
+}
+
+void testSurfaceSensitivity(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing surface sensitivities\n";
+
+    string testName = "";
+
+    FuelModels fuelModels;
+    Surface surface(fuelModels);
+    SurfaceSensitivity sensitivity(fuelModels);
+    sensitivity.setIsIncludingFuelLoads(true);
+
+    // Surface spread rate and fireline intensity at the sensitivity inputs, variable shifted by step
+    auto runSurface = [&](SurfaceSensitivityInputs inputs, int variable, double step, double& spreadRate, double& firelineIntensity)
+    {
+        double* values[] = { &inputs.moistureOneHour, &inputs.moistureTenHour, &inputs.moistureHundredHour,
+            &inputs.moistureLiveHerbaceous, &inputs.moistureLiveWoody, &inputs.midflameWindSpeed, &inputs.slope };
+        if(variable >= 0)
+        {
+            *values[variable] += step;
+        }
+        surface.updateSurfaceInputs(inputs.fuelModelNumber, inputs.moistureOneHour, inputs.moistureTenHour, inputs.moistureHundredHour,
+            inputs.moistureLiveHerbaceous, inputs.moistureLiveWoody, FractionUnits::Fraction, inputs.midflameWindSpeed, SpeedUnits::FeetPerMinute,
+            WindHeightInputMode::DirectMidflame, inputs.windDirection, WindAndSpreadOrientationMode::RelativeToUpslope, inputs.slope,
+            SlopeUnits::Degrees, 0.0, 0.0, FractionUnits::Fraction, 0.0, LengthUnits::Feet, 0.0, FractionUnits::Fraction);
+        surface.doSurfaceRunInDirectionOfMaxSpread();
+        spreadRate = surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        firelineIntensity = surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond);
+    };
+
+    const string variableNames[] = { "1 hour moisture", "10 hour moisture", "100 hour moisture", "live herbaceous moisture",
+        "live woody moisture", "midflame wind speed", "slope" };
+    const double steps[] = { 1e-6, 1e-6, 1e-6, 1e-6, 1e-6, 1e-3, 1e-4 };
+    const int fuelModelNumbers[] = { 10, 124 }; // static TU1 and dynamic GS4
+    const string fuelModelNames[] = { "fuel model 10", "dynamic fuel model 124" };
+    for(int model = 0; model < 2; model++)
+    {
+        // The live herbaceous moisture is within the range of partial load transfer
+        SurfaceSensitivityInputs inputs = { fuelModelNumbers[model], 0.06, 0.07, 0.08, 0.6, 0.9, 300.0, 45.0, 20.0 };
+        SurfaceSensitivityOutputs outputs;
+        sensitivity.calculate(inputs, outputs);
+
+        double spreadRate = 0.0;
+        double firelineIntensity = 0.0;
+        runSurface(inputs, -1, 0.0, spreadRate, firelineIntensity);
+        testName = "Test sensitivity spread rate of " + fuelModelNames[model] + " matches the surface run";
+        reportTestResult(testInfo, testName, outputs.spreadRate, spreadRate, 1e-9 * spreadRate);
+        testName = "Test sensitivity fireline intensity of " + fuelModelNames[model] + " matches the surface run";
+        reportTestResult(testInfo, testName, outputs.firelineIntensity, firelineIntensity, 1e-9 * firelineIntensity);
+
+        // Derivatives against central differences of surface runs
+        for(int variable = 0; variable < SurfaceSensitivityVariable::LoadOneHour; variable++)
+        {
+            double spreadRateAbove = 0.0;
+            double spreadRateBelow = 0.0;
+            double firelineIntensityAbove = 0.0;
+            double firelineIntensityBelow = 0.0;
+            runSurface(inputs, variable, steps[variable], spreadRateAbove, firelineIntensityAbove);
+            runSurface(inputs, variable, -steps[variable], spreadRateBelow, firelineIntensityBelow);
+            double spreadRateDerivative = (spreadRateAbove - spreadRateBelow) / (2.0 * steps[variable]);
+            double firelineIntensityDerivative = (firelineIntensityAbove - firelineIntensityBelow) / (2.0 * steps[variable]);
+            testName = "Test spread rate derivative of " + fuelModelNames[model] + " with respect to " + variableNames[variable];
+            reportTestResult(testInfo, testName, outputs.spreadRateGradient[variable], spreadRateDerivative,
+                1e-5 * fabs(spreadRateDerivative) + 1e-6);
+            testName = "Test fireline intensity derivative of " + fuelModelNames[model] + " with respect to " + variableNames[variable];
+            reportTestResult(testInfo, testName, outputs.firelineIntensityGradient[variable], firelineIntensityDerivative,
+                1e-5 * fabs(firelineIntensityDerivative) + 1e-6);
+        }
+
+        // Load derivatives against central differences over custom copies of the fuel model
+        const int customFuelModelNumber = 14;
+        const double loadStep = 1e-6;
+        bool isEveryLoadDerivativeClose = true;
+        for(int load = 0; load < 5; load++)
+        {
+            double spreadRateAtStep[2];
+            for(int side = 0; side < 2; side++)
+            {
+                double loads[5] =
+                {
+                    fuelModels.getFuelLoadOneHour(inputs.fuelModelNumber, LoadingUnits::PoundsPerSquareFoot),
+                    fuelModels.getFuelLoadTenHour(inputs.fuelModelNumber, LoadingUnits::PoundsPerSquareFoot),
+                    fuelModels.getFuelLoadHundredHour(inputs.fuelModelNumber, LoadingUnits::PoundsPerSquareFoot),
+                    fuelModels.getFuelLoadLiveHerbaceous(inputs.fuelModelNumber, LoadingUnits::PoundsPerSquareFoot),
+                    fuelModels.getFuelLoadLiveWoody(inputs.fuelModelNumber, LoadingUnits::PoundsPerSquareFoot)
+                };
+                loads[load] += (side == 0) ? loadStep : -loadStep;
+                fuelModels.setCustomFuelModel(customFuelModelNumber, "C14", "Custom copy",
+                    fuelModels.getFuelbedDepth(inputs.fuelModelNumber, LengthUnits::Feet),
+                    LengthUnits::Feet, fuelModels.getMoistureOfExtinctionDead(inputs.fuelModelNumber, FractionUnits::Fraction), FractionUnits::Fraction,
+                    fuelModels.getHeatOfCombustionDead(inputs.fuelModelNumber, HeatOfCombustionUnits::BtusPerPound),
+                    fuelModels.getHeatOfCombustionLive(inputs.fuelModelNumber, HeatOfCombustionUnits::BtusPerPound), HeatOfCombustionUnits::BtusPerPound,
+                    loads[0], loads[1], loads[2], loads[3], loads[4], LoadingUnits::PoundsPerSquareFoot,
+                    fuelModels.getSavrOneHour(inputs.fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet),
+                    fuelModels.getSavrLiveHerbaceous(inputs.fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet),
+                    fuelModels.getSavrLiveWoody(inputs.fuelModelNumber, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet),
+                    SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, fuelModels.getIsDynamic(inputs.fuelModelNumber));
+                SurfaceSensitivityInputs customInputs = inputs;
+                customInputs.fuelModelNumber = customFuelModelNumber;
+                double firelineIntensityAtStep = 0.0;
+                runSurface(customInputs, -1, 0.0, spreadRateAtStep[side], firelineIntensityAtStep);
+            }
+            double spreadRateDerivative = (spreadRateAtStep[0] - spreadRateAtStep[1]) / (2.0 * loadStep);
+            isEveryLoadDerivativeClose = isEveryLoadDerivativeClose &&
+                (fabs(outputs.spreadRateGradient[SurfaceSensitivityVariable::LoadOneHour + load] - spreadRateDerivative) <=
+                1e-4 * fabs(spreadRateDerivative) + 1e-3);
+        }
+        testName = "Test spread rate derivatives of " + fuelModelNames[model] + " with respect to the fuel loads";
+        reportTestResult(testInfo, testName, isEveryLoadDerivativeClose, true, error_tolerance);
+        fuelModels.clearCustomFuelModel(customFuelModelNumber);
+    }
+
+    // Past the wind speed limit the spread rate no longer depends on the wind speed
+    SurfaceSensitivityInputs limitedInputs = { 10, 0.06, 0.07, 0.08, 0.6, 0.9, 10000.0, 0.0, 0.0 };
+    SurfaceSensitivityOutputs limitedOutputs;
+    sensitivity.calculate(limitedInputs, limitedOutputs);
+    double limitedSpreadRate = 0.0;
+    double limitedFirelineIntensity = 0.0;
+    runSurface(limitedInputs, -1, 0.0, limitedSpreadRate, limitedFirelineIntensity);
+    testName = "Test sensitivity spread rate past the wind speed limit matches the surface run";
+    reportTestResult(testInfo, testName, limitedOutputs.spreadRate, limitedSpreadRate, 1e-9 * limitedSpreadRate);
+    testName = "Test spread rate derivative with respect to wind past the wind speed limit is zero";
+    reportTestResult(testInfo, testName, limitedOutputs.spreadRateGradient[SurfaceSensitivityVariable::MidflameWindSpeed], 0.0, error_tolerance);
+
+    // Without fuel loads the other derivatives are unchanged and the load derivatives are zero
+    SurfaceSensitivityInputs inputs = { 124, 0.06, 0.07, 0.08, 0.6, 0.9, 300.0, 45.0, 20.0 };
+    SurfaceSensitivityOutputs outputsWithLoads;
+    SurfaceSensitivityOutputs outputsWithoutLoads;
+    sensitivity.calculate(inputs, outputsWithLoads);
+    sensitivity.setIsIncludingFuelLoads(false);
+    sensitivity.calculate(inputs, outputsWithoutLoads);
+    bool isEveryDerivativeSame = true;
+    for(int variable = 0; variable < SurfaceSensitivityVariable::NumberOfVariables; variable++)
+    {
+        double expectedDerivative = (variable < SurfaceSensitivityVariable::LoadOneHour) ? outputsWithLoads.spreadRateGradient[variable] : 0.0;
+        isEveryDerivativeSame = isEveryDerivativeSame && (outputsWithoutLoads.spreadRateGradient[variable] == expectedDerivative);
+    }
+    testName = "Test sensitivities without fuel loads match those with them";
+    reportTestResult(testInfo, testName, isEveryDerivativeSame && (outputsWithoutLoads.spreadRate == outputsWithLoads.spreadRate), true, error_tolerance);
+
+    testName = "Test sensitivities of an undefined fuel model are not calculated";
+    inputs.fuelModelNumber = 14;
+    reportTestResult(testInfo, testName, !sensitivity.calculate(inputs, outputsWithoutLoads) && (outputsWithoutLoads.spreadRate == 0.0), true, error_tolerance);
+
+    std::cout << "Finished testing surface sensitivities\n\n";
+}
+
+void testChaparralBatch(TestInfo& testInfo, BehaveRun&)
+{
+    std::cout << "Testing Chaparral, batch run\n";
+
+    string testName = "";
+
+    // The last cell is past Oct 31 and uses the Oct 31 date
+    const int numberOfCells = 4;
+    double age[numberOfCells] = { 5.0, 20.0, 40.0, 40.0 };
+    double daysSinceMayFirst[numberOfCells] = { 0.0, 60.0, 120.0, 250.0 };
+    ChaparralBatchInputs chaparralInputs = { numberOfCells, age, daysSinceMayFirst };
+
+    double fuelBedDepth[numberOfCells];
+    double totalFuelLoad[numberOfCells];
+    double deadFuelFraction[numberOfCells];
+    double liveLeafMoisture[numberOfCells];
+    double liveStemMoisture[numberOfCells];
+    double liveLeafHeatOfCombustion[numberOfCells];
+    double liveStemHeatOfCombustion[numberOfCells];
+    ChaparralBatchOutputs chaparralOutputs = { fuelBedDepth, totalFuelLoad, deadFuelFraction, liveLeafMoisture, liveStemMoisture,
+        liveLeafHeatOfCombustion, liveStemHeatOfCombustion };
+    ChaparralFuel::calculateFuelbedPropertiesBatch(ChaparralFuelType::Chamise, chaparralInputs, chaparralOutputs);
+
+    bool isEveryPropertyEqual = true;
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        ChaparralFuel chaparralFuel;
+        chaparralFuel.setChaparralFuelType(ChaparralFuelType::Chamise);
+        chaparralFuel.setAge(age[i]);
+        chaparralFuel.setDate((int)daysSinceMayFirst[i]);
+        isEveryPropertyEqual = isEveryPropertyEqual && (fuelBedDepth[i] == chaparralFuel.getFuelBedDepth()) &&
+            (totalFuelLoad[i] == chaparralFuel.getTotalFuelLoad()) && (deadFuelFraction[i] == chaparralFuel.getDeadFuelFraction()) &&
+            (liveLeafMoisture[i] == chaparralFuel.getMoisture(FuelLifeState::Live, 0)) &&
+            (liveStemMoisture[i] == chaparralFuel.getMoisture(FuelLifeState::Live, 1)) &&
+            (liveLeafHeatOfCombustion[i] == chaparralFuel.getHeatOfCombustion(FuelLifeState::Live, 0)) &&
+            (liveStemHeatOfCombustion[i] == chaparralFuel.getHeatOfCombustion(FuelLifeState::Live, 1));
+    }
+    testName = "Test Chaparral batch fuelbed properties match setAge() and setDate()";
+    reportTestResult(testInfo, testName, isEveryPropertyEqual, true, error_tolerance);
+
+    // Batch surface runs against single cell runs with the same derived inputs
+    FuelModels fuelModels;
+    Surface surface(fuelModels);
+    surface.setIsUsingChaparral(true);
+    surface.setChaparralFuelType(ChaparralFuelType::Chamise);
+    surface.setWindHeightInputMode(WindHeightInputMode::DirectMidflame);
+    surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToUpslope);
+    Surface singleCellSurface = surface;
+
+    int fuelModelNumber[numberOfCells] = { 1, 1, 1, 1 };
+    double moistureOneHour[numberOfCells] = { 0.04, 0.06, 0.06, 0.08 };
+    double moistureTenHour[numberOfCells] = { 0.05, 0.07, 0.07, 0.09 };
+    double moistureHundredHour[numberOfCells] = { 0.06, 0.08, 0.08, 0.10 };
+    double windSpeed[numberOfCells] = { 264.0, 440.0, 440.0, 88.0 };
+    double windDirection[numberOfCells] = { 0.0, 45.0, 45.0, 180.0 };
+    double slope[numberOfCells] = { 10.0, 20.0, 20.0, 0.0 };
+    double aspect[numberOfCells] = { 0.0, 0.0, 0.0, 0.0 };
+    double canopyCover[numberOfCells] = { 0.0, 0.0, 0.0, 0.0 };
+    double canopyHeight[numberOfCells] = { 0.0, 0.0, 0.0, 0.0 };
+    double crownRatio[numberOfCells] = { 0.0, 0.0, 0.0, 0.0 };
+    SurfaceBatchInputs inputs = { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour, moistureHundredHour,
+        nullptr, nullptr, windSpeed, windDirection, slope, aspect, canopyCover, canopyHeight, crownRatio };
+
+    double spreadRate[numberOfCells];
+    double flameLength[numberOfCells];
+    SurfaceBatchOutputs outputs = { spreadRate, nullptr, flameLength, nullptr, nullptr };
+    surface.doSurfaceRunBatchChaparral(inputs, chaparralInputs, outputs);
+
+    for (int i = 0; i < numberOfCells; i++)
+    {
+        singleCellSurface.setChaparralFuelLoadInputMode(ChaparralFuelLoadInputMode::DirectFuelLoad);
+        singleCellSurface.setChaparralFuelBedDepth(fuelBedDepth[i], LengthUnits::Feet);
+        singleCellSurface.setChaparralTotalFuelLoad(totalFuelLoad[i], LoadingUnits::PoundsPerSquareFoot);
+        singleCellSurface.setChaparralFuelDeadLoadFraction(deadFuelFraction[i]);
+        singleCellSurface.updateSurfaceInputs(fuelModelNumber[i], moistureOneHour[i], moistureTenHour[i], moistureHundredHour[i],
+            liveLeafMoisture[i], liveStemMoisture[i], FractionUnits::Fraction, windSpeed[i], SpeedUnits::FeetPerMinute,
+            WindHeightInputMode::DirectMidflame, windDirection[i], WindAndSpreadOrientationMode::RelativeToUpslope, slope[i],
+            SlopeUnits::Degrees, aspect[i], canopyCover[i], FractionUnits::Fraction, canopyHeight[i], LengthUnits::Feet, crownRatio[i],
+            FractionUnits::Fraction);
+        singleCellSurface.doSurfaceRunInDirectionOfMaxSpread();
+
+        string cell = "cell " + std::to_string(i) + ", age " + std::to_string((int)age[i]);
+        double expectedSpreadRate = singleCellSurface.getSpreadRate(SpeedUnits::FeetPerMinute);
+        testName = "Test Chaparral batch spread rate matches a single cell run, " + cell;
+        reportTestResult(testInfo, testName, spreadRate[i], expectedSpreadRate, 1e-10 * expectedSpreadRate);
+        double expectedFlameLength = singleCellSurface.getFlameLength(LengthUnits::Feet);
+        testName = "Test Chaparral batch flame length matches a single cell run, " + cell;
+        reportTestResult(testInfo, testName, flameLength[i], expectedFlameLength, 1e-10 * expectedFlameLength);
+    }
+    testName = "Test Chaparral batch run has fire to report";
+    reportTestResult(testInfo, testName, spreadRate[1] > 0.0, true, error_tolerance);
+
+    std::cout << "Finished testing Chaparral, batch run\n\n";
+}
+
+void testSpecialFuelbedMemo(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::string testName = "";
+
+    double ageOfRough = 10.0;
+    double heightOfUnderstory = 4.0;
+    double palmettoCoverage = 50.0;
+    double overstoryBasalArea = 50.0;
+
+    PalmettoGallberry regressions;
+    double expectedDepth = regressions.calculatePalmettoGallberyFuelBedDepth(heightOfUnderstory);
+    double expectedDeadFine = regressions.calculatePalmettoGallberyDeadFineFuelLoad(ageOfRough, heightOfUnderstory);
+    double expectedLitter = regressions.calculatePalmettoGallberyLitterLoad(ageOfRough, overstoryBasalArea);
+    double expectedLiveFoliage = regressions.calculatePalmettoGallberyLiveFoliageLoad(ageOfRough, palmettoCoverage, heightOfUnderstory);
+
+    PalmettoGallberry palmettoGallberry;
+    const PalmettoGallberryFuelbed& first = palmettoGallberry.calculatePalmettoGallberyFuelbed(ageOfRough, heightOfUnderstory,
+        palmettoCoverage, overstoryBasalArea);
+    testName = "Test Palmetto-Gallberry fuelbed memo depth matches the regression";
+    reportTestResult(testInfo, testName, first.fuelBedDepth, expectedDepth, 1.0e-12);
+    testName = "Test Palmetto-Gallberry fuelbed memo dead fine load matches the regression";
+    reportTestResult(testInfo, testName, first.deadFineFuelLoad, expectedDeadFine, 1.0e-12);
+    testName = "Test Palmetto-Gallberry fuelbed memo litter load matches the regression";
+    reportTestResult(testInfo, testName, first.litterLoad, expectedLitter, 1.0e-12);
+    testName = "Test Palmetto-Gallberry fuelbed memo live foliage load matches the regression";
+    reportTestResult(testInfo, testName, first.liveFoliageLoad, expectedLiveFoliage, 1.0e-12);
+
+    palmettoGallberry.calculatePalmettoGallberyFuelbed(ageOfRough + 5.0, heightOfUnderstory, palmettoCoverage, overstoryBasalArea);
+    palmettoGallberry.initializeMembers();
+    const PalmettoGallberryFuelbed& repeated = palmettoGallberry.calculatePalmettoGallberyFuelbed(ageOfRough, heightOfUnderstory,
+        palmettoCoverage, overstoryBasalArea);
+    testName = "Test Palmetto-Gallberry fuelbed memo hits on a repeated stand";
+    reportTestResult(testInfo, testName, static_cast<double>(palmettoGallberry.getFuelbedMemoNumberOfHits()), 1.0, 1.0e-12);
+    testName = "Test Palmetto-Gallberry fuelbed memo misses once per new stand";
+    reportTestResult(testInfo, testName, static_cast<double>(palmettoGallberry.getFuelbedMemoNumberOfMisses()), 2.0, 1.0e-12);
+    testName = "Test Palmetto-Gallberry fuelbed memo hit restores the getters";
+    reportTestResult(testInfo, testName, palmettoGallberry.getPalmettoGallberyDeadFineFuelLoad(), expectedDeadFine, 1.0e-12);
+    testName = "Test Palmetto-Gallberry fuelbed memo hit returns the same litter load";
+    reportTestResult(testInfo, testName, repeated.litterLoad, expectedLitter, 1.0e-12);
+
+    int aspenFuelModelNumber = 3;
+    double aspenCuringLevel = 0.5;
+    WesternAspen interpolations;
+    double expectedAspenDeadOneHour = interpolations.calculateAspenLoadDeadOneHour(aspenFuelModelNumber, aspenCuringLevel);
+    double expectedAspenSavrLiveWoody = interpolations.calculateAspenSavrLiveWoody(aspenFuelModelNumber, aspenCuringLevel);
+
+    WesternAspen westernAspen;
+    const WesternAspenFuelbed& aspenFirst = westernAspen.calculateAspenFuelbed(aspenFuelModelNumber, aspenCuringLevel);
+    testName = "Test Western Aspen fuelbed memo dead one hour load matches the interpolation";
+    reportTestResult(testInfo, testName, aspenFirst.loadDeadOneHour, expectedAspenDeadOneHour, 1.0e-12);
+    testName = "Test Western Aspen fuelbed memo live woody SAVR matches the interpolation";
+    reportTestResult(testInfo, testName, aspenFirst.savrLiveWoody, expectedAspenSavrLiveWoody, 1.0e-12);
+
+    westernAspen.calculateAspenFuelbed(aspenFuelModelNumber, 0.9);
+    westernAspen.calculateAspenFuelbed(aspenFuelModelNumber, aspenCuringLevel);
+    testName = "Test Western Aspen fuelbed memo hits on a repeated stand";
+    reportTestResult(testInfo, testName, static_cast<double>(westernAspen.getFuelbedMemoNumberOfHits()), 1.0, 1.0e-12);
+    testName = "Test Western Aspen fuelbed memo hit restores the getters";
+    reportTestResult(testInfo, testName, westernAspen.getAspenLoadDeadOneHour(), expectedAspenDeadOneHour, 1.0e-12);
+
+    WesternAspen copiedAspen = westernAspen;
+    copiedAspen.calculateAspenFuelbed(aspenFuelModelNumber, 0.9);
+    testName = "Test Western Aspen fuelbed memo copy keeps its entries";
+    reportTestResult(testInfo, testName, static_cast<double>(copiedAspen.getFuelbedMemoNumberOfHits()), 2.0, 1.0e-12);
+}
+
+void testSurfaceKernel(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing stateless surface kernel\n";
+
+    string testName = "";
+
+    FuelModels fuelModels;
+    Surface surface(fuelModels);
+
+    // Static fuel models 1, 10 and 165, dynamic 124, and fuel model 4 on a steep slope with a strong wind past the wind limit
+    const int fuelModelNumbers[] = { 1, 10, 165, 124, 4 };
+    const double midflameWindSpeeds[] = { 250.0, 300.0, 440.0, 300.0, 3000.0 };
+    const double windDirections[] = { 45.0, 300.0, 0.0, 90.0, 180.0 };
+    const double slopes[] = { 20.0, 10.0, 0.0, 30.0, 40.0 };
+    for(int run = 0; run < 5; run++)
+    {
+        // The live herbaceous moisture is within the range of partial load transfer
+        SurfaceKernelInputs inputs = { 0.06, 0.07, 0.08, 0.6, 0.9, midflameWindSpeeds[run], windDirections[run], slopes[run] };
+        SurfaceKernelFuelModel fuelModel;
+        SurfaceKernel::loadFuelModel(fuelModels, fuelModelNumbers[run], fuelModel);
+        SurfaceKernelOutputs outputs;
+        SurfaceKernel::calculate(fuelModel, inputs, outputs);
+
+        surface.updateSurfaceInputs(fuelModelNumbers[run], inputs.moistureOneHour, inputs.moistureTenHour, inputs.moistureHundredHour,
+            inputs.moistureLiveHerbaceous, inputs.moistureLiveWoody, FractionUnits::Fraction, inputs.midflameWindSpeed, SpeedUnits::FeetPerMinute,
+            WindHeightInputMode::DirectMidflame, inputs.windDirection, WindAndSpreadOrientationMode::RelativeToUpslope, inputs.slope,
+            SlopeUnits::Degrees, 0.0, 0.0, FractionUnits::Fraction, 0.0, LengthUnits::Feet, 0.0, FractionUnits::Fraction);
+        surface.doSurfaceRunInDirectionOfMaxSpread();
+
+        string prefix = "Test surface kernel for fuel model " + std::to_string(fuelModelNumbers[run]) + " matches Surface ";
+        testName = prefix + "reaction intensity";
+        reportTestResult(testInfo, testName, outputs.reactionIntensity,
+            surface.getReactionIntensity(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute), 1.0e-10);
+        testName = prefix + "spread rate";
+        reportTestResult(testInfo, testName, outputs.spreadRate, surface.getSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-10);
+        testName = prefix + "backing spread rate";
+        reportTestResult(testInfo, testName, outputs.backingSpreadRate, surface.getBackingSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-10);
+        testName = prefix + "flanking spread rate";
+        reportTestResult(testInfo, testName, outputs.flankingSpreadRate, surface.getFlankingSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-10);
+        testName = prefix + "direction of max spread";
+        reportTestResult(testInfo, testName, outputs.directionOfMaxSpread, surface.getDirectionOfMaxSpread(), 1.0e-10);
+        testName = prefix + "length to width ratio";
+        reportTestResult(testInfo, testName, outputs.fireLengthToWidthRatio, surface.getFireLengthToWidthRatio(), 1.0e-10);
+        testName = prefix + "heat per unit area";
+        reportTestResult(testInfo, testName, outputs.heatPerUnitArea, surface.getHeatPerUnitArea(HeatPerUnitAreaUnits::BtusPerSquareFoot), 1.0e-10);
+        testName = prefix + "fireline intensity";
+        reportTestResult(testInfo, testName, outputs.firelineIntensity,
+            surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond), 1.0e-10);
+        testName = prefix + "flame length";
+        reportTestResult(testInfo, testName, outputs.flameLength, surface.getFlameLength(LengthUnits::Feet), 1.0e-10);
+    }
+
+    SurfaceKernelFuelModel fuelModel;
+    testName = "Test surface kernel does not load an undefined fuel model";
+    reportTestResult(testInfo, testName, SurfaceKernel::loadFuelModel(fuelModels, 14, fuelModel), false, 1.0e-10);
+    testName = "Test surface kernel does not load a fuel model without fuel";
+    reportTestResult(testInfo, testName, SurfaceKernel::loadFuelModel(fuelModels, 91, fuelModel), false, 1.0e-10);
+}
+
+void testCrownFuelKernel(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing crown fuel model kernel\n";
+
+    string testName = "";
+
+    FuelModels fuelModels;
+    Crown kernelCrown(fuelModels);
+    Crown surfaceCrown(fuelModels);
+    surfaceCrown.setIsUsingCrownFuelKernel(false);
+
+    const WindHeightInputMode::WindHeightInputModeEnum windHeightInputModes[] = { WindHeightInputMode::TwentyFoot, WindHeightInputMode::TenMeter };
+    const string windHeightNames[] = { "20 foot", "10 meter" };
+    const double windSpeeds[] = { 5.0, 25.0 };
+    for(int run = 0; run < 2; run++)
+    {
+        Crown* crowns[] = { &kernelCrown, &surfaceCrown };
+        for(Crown* crown : crowns)
+        {
+            crown->updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, windSpeeds[run], SpeedUnits::MilesPerHour,
+                windHeightInputModes[run], 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 30.0, SlopeUnits::Percent, 0.0, 50.0,
+                FractionUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+        }
+
+        kernelCrown.doCrownRunRothermel();
+        surfaceCrown.doCrownRunRothermel();
+        string prefix = "Test crown fuel kernel with " + windHeightNames[run] + " wind matches the crown fuel model run for ";
+        testName = prefix + "Rothermel crown fire spread rate";
+        reportTestResult(testInfo, testName, kernelCrown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute),
+            surfaceCrown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-12);
+        testName = prefix + "Rothermel final fireline intensity";
+        reportTestResult(testInfo, testName, kernelCrown.getFinalFirelineIntesity(FirelineIntensityUnits::BtusPerFootPerSecond),
+            surfaceCrown.getFinalFirelineIntesity(FirelineIntensityUnits::BtusPerFootPerSecond), 1.0e-12);
+
+        kernelCrown.doCrownRunScottAndReinhardt();
+        surfaceCrown.doCrownRunScottAndReinhardt();
+        testName = prefix + "Scott and Reinhardt crown fire spread rate";
+        reportTestResult(testInfo, testName, kernelCrown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute),
+            surfaceCrown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-12);
+        testName = prefix + "Scott and Reinhardt crown fraction burned";
+        reportTestResult(testInfo, testName, kernelCrown.getCrownFractionBurned(), surfaceCrown.getCrownFractionBurned(), 1.0e-12);
+        testName = prefix + "Scott and Reinhardt final spread rate";
+        reportTestResult(testInfo, testName, kernelCrown.getFinalSpreadRate(SpeedUnits::FeetPerMinute),
+            surfaceCrown.getFinalSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-12);
+    }
+
+    testName = "Test crown fuel kernel is kept by updating the crown inputs";
+    reportTestResult(testInfo, testName, surfaceCrown.getIsUsingCrownFuelKernel(), false, 1.0e-12);
+}
+
+void testCrownBatch(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing crown batch run\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-10;
+
+    FuelModels fuelModels;
+    Crown batchCrown(fuelModels);
+    Crown crown(fuelModels);
+
+    const int numberOfCells = 6;
+    const int fuelModelNumber[numberOfCells] = { 124, 124, 165, 1, 10, 91 };
+    const double windSpeedMilesPerHour[numberOfCells] = { 5.0, 25.0, 10.0, 2.0, 15.0, 10.0 };
+    const double canopyHeight[numberOfCells] = { 30.0, 30.0, 60.0, 50.0, 40.0, 30.0 };
+    const double canopyBaseHeight[numberOfCells] = { 6.0, 6.0, 2.0, 20.0, 3.0, 6.0 };
+    const double canopyBulkDensity[numberOfCells] = { 0.03, 0.03, 0.01, 0.005, 0.02, 0.03 };
+    const double moistureFoliar[numberOfCells] = { 1.2, 1.2, 0.9, 1.0, 1.0, 1.2 };
+    const double moistureOneHour[numberOfCells] = { 0.06, 0.06, 0.04, 0.06, 0.03, 0.06 };
+
+    double moistureTenHour[numberOfCells];
+    double moistureHundredHour[numberOfCells];
+    double moistureLiveHerbaceous[numberOfCells];
+    double moistureLiveWoody[numberOfCells];
+    double windSpeed[numberOfCells];
+    double windDirection[numberOfCells];
+    double slope[numberOfCells];
+    double aspect[numberOfCells];
+    double canopyCover[numberOfCells];
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        moistureTenHour[i] = 0.07;
+        moistureHundredHour[i] = 0.08;
+        moistureLiveHerbaceous[i] = 0.6;
+        moistureLiveWoody[i] = 0.9;
+        windSpeed[i] = SpeedUnits::toBaseUnits(windSpeedMilesPerHour[i], SpeedUnits::MilesPerHour);
+        windDirection[i] = 45.0;
+        slope[i] = 10.0;
+        aspect[i] = 180.0;
+        canopyCover[i] = 0.5;
+    }
+
+    // Sets the orientation and wind adjustment factor modes the batch runs with
+    batchCrown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 10.0, SlopeUnits::Degrees, 0.0, 50.0,
+        FractionUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+
+    CrownBatchInputs inputs = { { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour, moistureHundredHour,
+        moistureLiveHerbaceous, moistureLiveWoody, windSpeed, windDirection, slope, aspect, canopyCover, canopyHeight, nullptr },
+        canopyBaseHeight, canopyBulkDensity, moistureFoliar };
+    FireType::FireTypeEnum fireType[numberOfCells];
+    double crownFractionBurned[numberOfCells];
+    double crownFireSpreadRate[numberOfCells];
+    double finalSpreadRate[numberOfCells];
+    double finalHeatPerUnitArea[numberOfCells];
+    double finalFirelineIntensity[numberOfCells];
+    double finalFlameLength[numberOfCells];
+    CrownBatchOutputs outputs = { fireType, crownFractionBurned, crownFireSpreadRate, finalSpreadRate, finalHeatPerUnitArea,
+        finalFirelineIntensity, finalFlameLength, nullptr, nullptr };
+    batchCrown.doCrownRunBatchScottAndReinhardt(inputs, outputs);
+
+    int numberOfFireTypes[4] = { 0, 0, 0, 0 };
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        crown.updateCrownInputs(fuelModelNumber[i], moistureOneHour[i], moistureTenHour[i], moistureHundredHour[i], moistureLiveHerbaceous[i],
+            moistureLiveWoody[i], moistureFoliar[i], FractionUnits::Fraction, windSpeedMilesPerHour[i], SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, windDirection[i], WindAndSpreadOrientationMode::RelativeToNorth, slope[i], SlopeUnits::Degrees,
+            aspect[i], canopyCover[i], FractionUnits::Fraction, canopyHeight[i], canopyBaseHeight[i], LengthUnits::Feet, 0.5,
+            FractionUnits::Fraction, canopyBulkDensity[i], DensityUnits::PoundsPerCubicFoot);
+        crown.doCrownRunScottAndReinhardt();
+
+        string prefix = "Test crown batch cell " + std::to_string(i) + " ";
+        testName = prefix + "fire type";
+        reportTestResult(testInfo, testName, fireType[i], crown.getFireType(), error_tolerance);
+        testName = prefix + "crown fraction burned";
+        reportTestResult(testInfo, testName, crownFractionBurned[i], crown.getCrownFractionBurned(), error_tolerance);
+        testName = prefix + "crown fire spread rate";
+        reportTestResult(testInfo, testName, crownFireSpreadRate[i], crown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute), error_tolerance);
+        testName = prefix + "final spread rate";
+        reportTestResult(testInfo, testName, finalSpreadRate[i], crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute), error_tolerance);
+        testName = prefix + "final heat per unit area";
+        reportTestResult(testInfo, testName, finalHeatPerUnitArea[i],
+            crown.getFinalHeatPerUnitArea(HeatPerUnitAreaUnits::BtusPerSquareFoot), error_tolerance);
+        testName = prefix + "final fireline intensity";
+        reportTestResult(testInfo, testName, finalFirelineIntensity[i],
+            crown.getFinalFirelineIntesity(FirelineIntensityUnits::BtusPerFootPerSecond), error_tolerance);
+        testName = prefix + "final flame length";
+        reportTestResult(testInfo, testName, finalFlameLength[i], crown.getFinalFlameLength(LengthUnits::Feet), error_tolerance);
+        numberOfFireTypes[fireType[i]]++;
+    }
+
+    testName = "Test crown batch covers surface, torching and crowning fire types";
+    reportTestResult(testInfo, testName, numberOfFireTypes[FireType::Surface] > 0 && numberOfFireTypes[FireType::Torching] > 0 &&
+        numberOfFireTypes[FireType::Crowning] > 0, true, error_tolerance);
+
+    // Null output arrays are skipped
+    double onlyFinalSpreadRate[numberOfCells];
+    CrownBatchOutputs spreadRateOutputs = { nullptr, nullptr, nullptr, onlyFinalSpreadRate, nullptr, nullptr, nullptr, nullptr, nullptr };
+    batchCrown.doCrownRunBatchScottAndReinhardt(inputs, spreadRateOutputs);
+    testName = "Test crown batch with only the final spread rate output";
+    reportTestResult(testInfo, testName, onlyFinalSpreadRate[numberOfCells - 2], finalSpreadRate[numberOfCells - 2], error_tolerance);
+
+    std::cout << "Finished testing crown batch run\n\n";
+}
+
+void testKernelOffload(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing kernel offload\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-9;
+
+    FuelModels fuelModels;
+    Crown crown(fuelModels);
+    Surface surface(fuelModels);
+
+    // Cells from surface fire to crowning, with a non-burnable and an undefined fuel model
+    const int numberOfCells = 8;
+    const int fuelModelNumber[numberOfCells] = { 124, 124, 165, 1, 10, 91, 250, 145 };
+    const double midflameWindSpeed[numberOfCells] = { 88.0, 880.0, 440.0, 176.0, 660.0, 440.0, 440.0, 1320.0 };
+    const double windDirection[numberOfCells] = { 0.0, 45.0, 90.0, 180.0, 270.0, 0.0, 0.0, 10.0 };
+    const double slope[numberOfCells] = { 0.0, 20.0, 10.0, 35.0, 0.0, 5.0, 5.0, 15.0 };
+    const double canopyBaseHeight[numberOfCells] = { 6.0, 6.0, 2.0, 20.0, 3.0, 6.0, 6.0, 4.0 };
+    const double canopyBulkDensity[numberOfCells] = { 0.03, 0.03, 0.01, 0.005, 0.02, 0.03, 0.03, 0.015 };
+    vector<double> moistureOneHour(numberOfCells);
+    vector<double> moistureTenHour(numberOfCells);
+    vector<double> moistureHundredHour(numberOfCells);
+    vector<double> moistureLiveHerbaceous(numberOfCells);
+    vector<double> moistureLiveWoody(numberOfCells);
+    vector<double> moistureFoliar(numberOfCells);
+    vector<double> windSpeedAtTwentyFeet(numberOfCells);
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        moistureOneHour[i] = 0.04 + 0.01 * i;
+        moistureTenHour[i] = 0.05 + 0.01 * i;
+        moistureHundredHour[i] = 0.06 + 0.01 * i;
+        moistureLiveHerbaceous[i] = 0.6 + 0.1 * i;
+        moistureLiveWoody[i] = 0.9 + 0.05 * i;
+        moistureFoliar[i] = 0.9 + 0.05 * i;
+        windSpeedAtTwentyFeet[i] = midflameWindSpeed[i] / 0.4;
+    }
+
+    KernelOffloadInputs inputs = { numberOfCells, fuelModelNumber, moistureOneHour.data(), moistureTenHour.data(),
+        moistureHundredHour.data(), moistureLiveHerbaceous.data(), moistureLiveWoody.data(), midflameWindSpeed, windDirection,
+        slope, windSpeedAtTwentyFeet.data(), canopyBaseHeight, canopyBulkDensity, moistureFoliar.data() };
+    vector<double> spreadRate(numberOfCells, -1.0);
+    vector<double> firelineIntensity(numberOfCells, -1.0);
+    vector<double> flameLength(numberOfCells, -1.0);
+    vector<double> directionOfMaxSpread(numberOfCells, -1.0);
+    vector<double> crownFireSpreadRate(numberOfCells, -1.0);
+    vector<int> fireType(numberOfCells, -1);
+    vector<double> finalSpreadRate(numberOfCells, -1.0);
+    KernelOffloadOutputs outputs = { spreadRate.data(), firelineIntensity.data(), flameLength.data(), directionOfMaxSpread.data(),
+        crownFireSpreadRate.data(), fireType.data(), finalSpreadRate.data() };
+
+    KernelOffload kernelOffload(fuelModels);
+    kernelOffload.run(inputs, outputs);
+
+    // With a midflame wind the crown fuel model also takes the wind as given, which is 0.4 of the 20 ft wind
+    double largestDeviation = 0.0;
+    int numberOfFireTypeMismatches = 0;
+    bool isCrowningSeen = false;
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        double expectedSpreadRate = 0.0;
+        double expectedFirelineIntensity = 0.0;
+        double expectedFlameLength = 0.0;
+        double expectedDirectionOfMaxSpread = 0.0;
+        double expectedCrownFireSpreadRate = 0.0;
+        int expectedFireType = FireType::Surface;
+        double expectedFinalSpreadRate = 0.0;
+        if(fuelModels.isFuelModelDefined(fuelModelNumber[i]) && !fuelModels.isAllFuelLoadZero(fuelModelNumber[i]))
+        {
+            surface.updateSurfaceInputs(fuelModelNumber[i], moistureOneHour[i], moistureTenHour[i], moistureHundredHour[i],
+                moistureLiveHerbaceous[i], moistureLiveWoody[i], FractionUnits::Fraction, midflameWindSpeed[i],
+                SpeedUnits::FeetPerMinute, WindHeightInputMode::DirectMidflame, windDirection[i],
+                WindAndSpreadOrientationMode::RelativeToUpslope, slope[i], SlopeUnits::Degrees, 0.0, 0.5,
+                FractionUnits::Fraction, 60.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+            surface.doSurfaceRunInDirectionOfMaxSpread();
+            expectedSpreadRate = surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+            expectedFirelineIntensity = surface.getFirelineIntensity(FirelineIntensityUnits::BtusPerFootPerSecond);
+            expectedFlameLength = surface.getFlameLength(LengthUnits::Feet);
+            expectedDirectionOfMaxSpread = surface.getDirectionOfMaxSpread();
+
+            double crownRatio = (60.0 - canopyBaseHeight[i]) / 60.0;
+            crown.updateCrownInputs(fuelModelNumber[i], moistureOneHour[i], moistureTenHour[i], moistureHundredHour[i],
+                moistureLiveHerbaceous[i], moistureLiveWoody[i], moistureFoliar[i], FractionUnits::Fraction,
+                midflameWindSpeed[i], SpeedUnits::FeetPerMinute, WindHeightInputMode::DirectMidflame, windDirection[i],
+                WindAndSpreadOrientationMode::RelativeToUpslope, slope[i], SlopeUnits::Degrees, 0.0, 0.5, FractionUnits::Fraction,
+                60.0, canopyBaseHeight[i], LengthUnits::Feet, crownRatio, FractionUnits::Fraction, canopyBulkDensity[i],
+                DensityUnits::PoundsPerCubicFoot);
+            crown.doCrownRunRothermel();
+            expectedCrownFireSpreadRate = crown.getCrownFireSpreadRate(SpeedUnits::FeetPerMinute);
+            expectedFireType = crown.getFireType();
+            expectedFinalSpreadRate = crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+        }
+        largestDeviation = std::max(largestDeviation, fabs(spreadRate[i] - expectedSpreadRate) / std::max(1.0, expectedSpreadRate));
+        largestDeviation = std::max(largestDeviation,
+            fabs(firelineIntensity[i] - expectedFirelineIntensity) / std::max(1.0, expectedFirelineIntensity));
+        largestDeviation = std::max(largestDeviation, fabs(flameLength[i] - expectedFlameLength) / std::max(1.0, expectedFlameLength));
+        largestDeviation = std::max(largestDeviation, fabs(directionOfMaxSpread[i] - expectedDirectionOfMaxSpread) / 360.0);
+        largestDeviation = std::max(largestDeviation,
+            fabs(crownFireSpreadRate[i] - expectedCrownFireSpreadRate) / std::max(1.0, expectedCrownFireSpreadRate));
+        largestDeviation = std::max(largestDeviation,
+            fabs(finalSpreadRate[i] - expectedFinalSpreadRate) / std::max(1.0, expectedFinalSpreadRate));
+        numberOfFireTypeMismatches += (fireType[i] != expectedFireType);
+        isCrowningSeen = isCrowningSeen || expectedFireType == FireType::Crowning;
+    }
+    testName = "Test kernel offload matches the surface and Rothermel crown runs";
+    reportTestResult(testInfo, testName, largestDeviation, 0.0, error_tolerance);
+    testName = "Test kernel offload matches the Rothermel fire types";
+    reportTestResult(testInfo, testName, numberOfFireTypeMismatches, 0, error_tolerance);
+    testName = "Test kernel offload cells include a crowning fire";
+    reportTestResult(testInfo, testName, isCrowningSeen, true, error_tolerance);
+    testName = "Test kernel offload uploads the fuel models once";
+    reportTestResult(testInfo, testName, kernelOffload.getNumberOfUploads(), 1, error_tolerance);
+
+    // Without the crown arrays only the surface fire is run
+    KernelOffloadInputs surfaceInputs = inputs;
+    surfaceInputs.canopyBulkDensity = nullptr;
+    vector<double> surfaceSpreadRate(numberOfCells, -1.0);
+    KernelOffloadOutputs surfaceOutputs = { surfaceSpreadRate.data(), nullptr, nullptr, nullptr, crownFireSpreadRate.data(),
+        fireType.data(), finalSpreadRate.data() };
+    kernelOffload.run(surfaceInputs, surfaceOutputs);
+    testName = "Test kernel offload without crown inputs is a surface fire";
+    reportTestResult(testInfo, testName, surfaceSpreadRate == spreadRate && finalSpreadRate == spreadRate &&
+        *std::max_element(fireType.begin(), fireType.end()) == FireType::Surface &&
+        *std::max_element(crownFireSpreadRate.begin(), crownFireSpreadRate.end()) == 0.0, true, error_tolerance);
+
+    // A changed fuel model is uploaded again before the next run
+    fuelModels.setCustomFuelModel(250, "TST", "Test fuel", 1.0, LengthUnits::Feet, 0.25, FractionUnits::Fraction,
+        8000.0, 8000.0, HeatOfCombustionUnits::BtusPerPound, 1.0, 0.0, 0.0, 0.0, 0.0, LoadingUnits::TonsPerAcre, 2000.0,
+        1500.0, 1500.0, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    kernelOffload.run(surfaceInputs, surfaceOutputs);
+    testName = "Test kernel offload uploads changed fuel models again";
+    reportTestResult(testInfo, testName, kernelOffload.getNumberOfUploads(), 2, error_tolerance);
+    testName = "Test kernel offload burns a fuel model defined after construction";
+    reportTestResult(testInfo, testName, surfaceSpreadRate[6] > 0.0, true, error_tolerance);
+
+    std::cout << "Finished testing kernel offload\n\n";
+}
+
+void testBehaveService(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing behave service\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-10;
+
+    BehaveService service;
+    service.setNumberOfThreads(3);
+    service.setCoalescingWindow(std::chrono::milliseconds(20));
+    BehaveRun& prototype = service.getPrototype();
+    prototype.surface.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+    prototype.surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+    prototype.crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 10.0, SlopeUnits::Degrees, 0.0, 50.0,
+        FractionUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+
+    // Requests from several client threads, repeating fuel models and moistures so the fuelbed cache is hit
+    const int numberOfClients = 4;
+    const int requestsPerClient = 12;
+    const int numberOfRequests = numberOfClients * requestsPerClient;
+    const int fuelModels[3] = { 124, 1, 165 };
+    vector<BehaveServiceCrownRequest> requests(numberOfRequests);
+    for(int i = 0; i < numberOfRequests; i++)
+    {
+        BehaveServiceSurfaceRequest surfaceRequest = { fuelModels[i % 3], 0.06, 0.07, 0.08, 0.6, 0.9, 88.0 * (2 + i % 11),
+            static_cast<double>((i * 37) % 360), (i % 4) * 10.0, 180.0, 0.5, 40.0, 0.5 };
+        requests[i] = { surfaceRequest, 2.0 + i % 5, 0.02, 1.0 };
+    }
+
+    service.start();
+    testName = "Test behave service is running";
+    reportTestResult(testInfo, testName, service.isRunning(), true, error_tolerance);
+
+    vector<std::future<BehaveServiceSurfaceResult>> surfaceResults(numberOfRequests);
+    vector<std::future<BehaveServiceCrownResult>> crownResults(numberOfRequests);
+    vector<std::thread> clients;
+    for(int client = 0; client < numberOfClients; client++)
+    {
+        clients.push_back(std::thread([&, client]()
+        {
+            for(int i = client * requestsPerClient; i < (client + 1) * requestsPerClient; i++)
+            {
+                surfaceResults[i] = service.submitSurfaceRequest(requests[i].surface);
+                crownResults[i] = service.submitCrownRequest(requests[i]);
+            }
+        }));
+    }
+    for(size_t client = 0; client < clients.size(); client++)
+    {
+        clients[client].join();
+    }
+
+    // Expected values from one batch of all the requests on a copy of the prototype
+    BehaveRun expectedRun(prototype);
+    vector<int> fuelModelNumber(numberOfRequests);
+    vector<vector<double>> values(15, vector<double>(numberOfRequests));
+    for(int i = 0; i < numberOfRequests; i++)
+    {
+        const BehaveServiceSurfaceRequest& request = requests[i].surface;
+        fuelModelNumber[i] = request.fuelModelNumber;
+        const double requestValues[15] = { request.moistureOneHour, request.moistureTenHour, request.moistureHundredHour,
+            request.moistureLiveHerbaceous, request.moistureLiveWoody, request.windSpeed, request.windDirection, request.slope,
+            request.aspect, request.canopyCover, request.canopyHeight, request.crownRatio, requests[i].canopyBaseHeight,
+            requests[i].canopyBulkDensity, requests[i].moistureFoliar };
+        for(int value = 0; value < 15; value++)
+        {
+            values[value][i] = requestValues[value];
+        }
+    }
+    SurfaceBatchInputs surfaceInputs = { numberOfRequests, fuelModelNumber.data(), values[0].data(), values[1].data(),
+        values[2].data(), values[3].data(), values[4].data(), values[5].data(), values[6].data(), values[7].data(),
+        values[8].data(), values[9].data(), values[10].data(), values[11].data() };
+    vector<double> spreadRate(numberOfRequests);
+    vector<double> flameLength(numberOfRequests);
+    vector<double> directionOfMaxSpread(numberOfRequests);
+    SurfaceBatchOutputs surfaceOutputs = { spreadRate.data(), nullptr, flameLength.data(), directionOfMaxSpread.data(), nullptr };
+    expectedRun.surface.doSurfaceRunBatch(surfaceInputs, surfaceOutputs);
+    CrownBatchInputs crownInputs = { surfaceInputs, values[12].data(), values[13].data(), values[14].data() };
+    vector<FireType::FireTypeEnum> fireType(numberOfRequests);
+    vector<double> finalSpreadRate(numberOfRequests);
+    CrownBatchOutputs crownOutputs = { fireType.data(), nullptr, nullptr, finalSpreadRate.data(), nullptr, nullptr, nullptr,
+        nullptr, nullptr };
+    expectedRun.crown.doCrownRunBatchScottAndReinhardt(crownInputs, crownOutputs);
+
+    bool isMatching = true;
+    for(int i = 0; i < numberOfRequests; i++)
+    {
+        BehaveServiceSurfaceResult surfaceResult = surfaceResults[i].get();
+        BehaveServiceCrownResult crownResult = crownResults[i].get();
+        isMatching = isMatching && fabs(surfaceResult.spreadRate - spreadRate[i]) < error_tolerance &&
+            fabs(surfaceResult.flameLength - flameLength[i]) < error_tolerance &&
+            fabs(surfaceResult.directionOfMaxSpread - directionOfMaxSpread[i]) < error_tolerance &&
+            crownResult.fireType == fireType[i] && fabs(crownResult.finalSpreadRate - finalSpreadRate[i]) < error_tolerance;
+    }
+    testName = "Test behave service results match a batch run";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+
+    BehaveServiceSurfaceResult singleResult = service.runSurfaceRequest(requests[5].surface);
+    testName = "Test behave service single request";
+    reportTestResult(testInfo, testName, singleResult.spreadRate, spreadRate[5], error_tolerance);
+
+    BehaveServiceMetrics metrics = service.getMetrics();
+    testName = "Test behave service counts every request";
+    reportTestResult(testInfo, testName, metrics.numberOfRequests, 2 * numberOfRequests + 1, error_tolerance);
+    testName = "Test behave service coalesces requests into fewer batches";
+    reportTestResult(testInfo, testName, metrics.numberOfBatches < metrics.numberOfRequests && metrics.largestBatchSize > 1,
+        true, error_tolerance);
+    testName = "Test behave service latency percentiles are ordered";
+    reportTestResult(testInfo, testName, metrics.latencyMedian > 0.0 &&
+        metrics.latencyNinetyNinthPercentile >= metrics.latencyMedian, true, error_tolerance);
+    testName = "Test behave service workers hit their fuelbed caches";
+    reportTestResult(testInfo, testName, metrics.fuelbedCacheNumberOfHits > 0, true, error_tolerance);
+
+    service.stop();
+    testName = "Test behave service is stopped";
+    reportTestResult(testInfo, testName, service.isRunning(), false, error_tolerance);
+    bool isRejected = false;
+    try
+    {
+        service.runSurfaceRequest(requests[0].surface);
+    }
+    catch(const std::runtime_error&)
+    {
+        isRejected = true;
+    }
+    testName = "Test stopped behave service rejects requests";
+    reportTestResult(testInfo, testName, isRejected, true, error_tolerance);
+
+    std::cout << "Finished testing behave service\n\n";
+}
+
+void testTorchingAndCrowningIndex(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing torching and crowning index\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-06;
+
+    FuelModels fuelModels;
+    Crown crown(fuelModels);
+
+    // Upslope wind inverts the wind factor in closed form, cross slope wind searches for the wind speed
+    const double windDirections[] = { 0.0, 90.0 };
+    const string windDirectionNames[] = { "upslope", "cross slope" };
+    double torchingIndex[2];
+    double crowningIndex[2];
+    for(int run = 0; run < 2; run++)
+    {
+        crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, windDirections[run], WindAndSpreadOrientationMode::RelativeToUpslope, 30.0, SlopeUnits::Percent,
+            0.0, 50.0, FractionUnits::Percent, 30.0, 15.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+        crown.doCrownRunScottAndReinhardt();
+        torchingIndex[run] = crown.getTorchingIndex(SpeedUnits::MilesPerHour);
+        crowningIndex[run] = crown.getCrowningIndex(SpeedUnits::MilesPerHour);
+
+        testName = "Test crowning index with " + windDirectionNames[run] + " wind is the critical open wind speed";
+        reportTestResult(testInfo, testName, crowningIndex[run], crown.getCriticalOpenWindSpeed(SpeedUnits::MilesPerHour), error_tolerance);
+
+        // Just below each index the fire does not torch or crown, just above it does
+        const double offsets[] = { 1.0 - 1e-06, 1.0 + 1e-06 };
+        for(int side = 0; side < 2; side++)
+        {
+            string sideName = (side == 0) ? "below" : "above";
+            crown.setWindSpeed(torchingIndex[run] * offsets[side], SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+            crown.doCrownRunScottAndReinhardt();
+            bool isTransitioning = crown.getFireType() == FireType::Torching || crown.getFireType() == FireType::Crowning;
+            testName = "Test fire " + sideName + " the torching index with " + windDirectionNames[run] + " wind transitions to the crown";
+            reportTestResult(testInfo, testName, isTransitioning, side == 1, error_tolerance);
+
+            crown.setWindSpeed(crowningIndex[run] * offsets[side], SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+            crown.doCrownRunScottAndReinhardt();
+            bool isActive = crown.getFireType() == FireType::ConditionalCrownFire || crown.getFireType() == FireType::Crowning;
+            testName = "Test fire " + sideName + " the crowning index with " + windDirectionNames[run] + " wind can crown actively";
+            reportTestResult(testInfo, testName, isActive, side == 1, error_tolerance);
+        }
+    }
+
+    testName = "Test crowning index does not depend on the wind direction";
+    reportTestResult(testInfo, testName, crowningIndex[1], crowningIndex[0], error_tolerance);
+    testName = "Test torching index is higher with cross slope wind than upslope wind";
+    reportTestResult(testInfo, testName, torchingIndex[1] > torchingIndex[0], true, error_tolerance);
+
+    // A canopy base height well above any surface flame never torches within the wind speed limit
+    crown.updateCrownInputs(1, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 0.0, SlopeUnits::Percent,
+        0.0, 50.0, FractionUnits::Percent, 150.0, 100.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+    crown.doCrownRunScottAndReinhardt();
+    testName = "Test torching index is not reached under the wind speed limit";
+    reportTestResult(testInfo, testName, crown.getTorchingIndex(SpeedUnits::MilesPerHour) == HUGE_VAL, true, error_tolerance);
+
+    // The batch run gives the same indices, each cell warm starting from the previous one
+    Crown batchCrown(fuelModels);
+    batchCrown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 30.0, SlopeUnits::Percent,
+        0.0, 50.0, FractionUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+    const int numberOfCells = 4;
+    const int fuelModelNumber[numberOfCells] = { 124, 124, 165, 10 };
+    const double windDirection[numberOfCells] = { 0.0, 90.0, 45.0, 0.0 };
+    const double canopyBaseHeight[numberOfCells] = { 15.0, 15.0, 20.0, 10.0 };
+    const double canopyBulkDensity[numberOfCells] = { 0.03, 0.03, 0.01, 0.02 };
+    double moistureOneHour[numberOfCells];
+    double moistureTenHour[numberOfCells];
+    double moistureHundredHour[numberOfCells];
+    double moistureLiveHerbaceous[numberOfCells];
+    double moistureLiveWoody[numberOfCells];
+    double moistureFoliar[numberOfCells];
+    double windSpeed[numberOfCells];
+    double slope[numberOfCells];
+    double aspect[numberOfCells];
+    double canopyCover[numberOfCells];
+    double canopyHeight[numberOfCells];
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        moistureOneHour[i] = 0.06;
+        moistureTenHour[i] = 0.07;
+        moistureHundredHour[i] = 0.08;
+        moistureLiveHerbaceous[i] = 0.6;
+        moistureLiveWoody[i] = 0.9;
+        moistureFoliar[i] = 1.2;
+        windSpeed[i] = SpeedUnits::toBaseUnits(5.0, SpeedUnits::MilesPerHour);
+        slope[i] = SlopeUnits::toBaseUnits(30.0, SlopeUnits::Percent);
+        aspect[i] = 0.0;
+        canopyCover[i] = 0.5;
+        canopyHeight[i] = 30.0;
+    }
+    CrownBatchInputs inputs = { { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour, moistureHundredHour,
+        moistureLiveHerbaceous, moistureLiveWoody, windSpeed, windDirection, slope, aspect, canopyCover, canopyHeight, nullptr },
+        canopyBaseHeight, canopyBulkDensity, moistureFoliar };
+    double batchTorchingIndex[numberOfCells];
+    double batchCrowningIndex[numberOfCells];
+    CrownBatchOutputs outputs = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, batchTorchingIndex, batchCrowningIndex };
+    batchCrown.doCrownRunBatchScottAndReinhardt(inputs, outputs);
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        crown.updateCrownInputs(fuelModelNumber[i], 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+            WindHeightInputMode::TwentyFoot, windDirection[i], WindAndSpreadOrientationMode::RelativeToUpslope, 30.0, SlopeUnits::Percent,
+            0.0, 50.0, FractionUnits::Percent, 30.0, canopyBaseHeight[i], LengthUnits::Feet, 0.5, FractionUnits::Fraction,
+            canopyBulkDensity[i], DensityUnits::PoundsPerCubicFoot);
+        crown.doCrownRunScottAndReinhardt();
+        testName = "Test crown batch torching index of cell " + std::to_string(i);
+        reportTestResult(testInfo, testName, batchTorchingIndex[i], crown.getTorchingIndex(SpeedUnits::FeetPerMinute), error_tolerance);
+        testName = "Test crown batch crowning index of cell " + std::to_string(i);
+        reportTestResult(testInfo, testName, batchCrowningIndex[i], crown.getCrowningIndex(SpeedUnits::FeetPerMinute), error_tolerance);
+    }
+
+    std::cout << "Finished testing torching and crowning index\n\n";
+}
+
+void testFireSizeAtElapsedTimes(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing fire size at elapsed times\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-10;
+
+    FuelModels fuelModels;
+    Surface surface(fuelModels);
+    surface.updateSurfaceInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 30.0, SlopeUnits::Percent, 0.0, 50.0,
+        FractionUnits::Percent, 30.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+    surface.doSurfaceRunInDirectionOfMaxSpread();
+
+    Crown crown(fuelModels);
+    crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 25.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 30.0, SlopeUnits::Percent, 0.0, 50.0,
+        FractionUnits::Percent, 30.0, 6.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+    crown.doCrownRunScottAndReinhardt();
+
+    // Zero to 12 hours in 15 minute steps
+    const int numberOfElapsedTimes = 49;
+    double elapsedTimes[numberOfElapsedTimes];
+    for(int i = 0; i < numberOfElapsedTimes; i++)
+    {
+        elapsedTimes[i] = 0.25 * i;
+    }
+    double ellipticalA[numberOfElapsedTimes];
+    double ellipticalB[numberOfElapsedTimes];
+    double ellipticalC[numberOfElapsedTimes];
+    double fireLength[numberOfElapsedTimes];
+    double maxFireWidth[numberOfElapsedTimes];
+    double firePerimeter[numberOfElapsedTimes];
+    double fireArea[numberOfElapsedTimes];
+    FireSizeBatchOutputs outputs = { ellipticalA, ellipticalB, ellipticalC, fireLength, maxFireWidth, firePerimeter, fireArea };
+
+    surface.getFireSizeAtElapsedTimes(elapsedTimes, numberOfElapsedTimes, TimeUnits::Hours, LengthUnits::Chains, AreaUnits::Acres, outputs);
+    bool isMatching[7] = { true, true, true, true, true, true, true };
+    for(int i = 0; i < numberOfElapsedTimes; i++)
+    {
+        const double t = elapsedTimes[i];
+        const double expected[7] = { surface.getEllipticalA(LengthUnits::Chains, t, TimeUnits::Hours),
+            surface.getEllipticalB(LengthUnits::Chains, t, TimeUnits::Hours), surface.getEllipticalC(LengthUnits::Chains, t, TimeUnits::Hours),
+            surface.getFireLength(LengthUnits::Chains, t, TimeUnits::Hours), surface.getMaxFireWidth(LengthUnits::Chains, t, TimeUnits::Hours),
+            surface.getFirePerimeter(LengthUnits::Chains, t, TimeUnits::Hours), surface.getFireArea(AreaUnits::Acres, t, TimeUnits::Hours) };
+        const double observed[7] = { ellipticalA[i], ellipticalB[i], ellipticalC[i], fireLength[i], maxFireWidth[i], firePerimeter[i], fireArea[i] };
+        for(int j = 0; j < 7; j++)
+        {
+            isMatching[j] = isMatching[j] && fabs(observed[j] - expected[j]) <= error_tolerance * (1.0 + fabs(expected[j]));
+        }
+    }
+    const string outputNames[7] = { "elliptical A", "elliptical B", "elliptical C", "fire length", "max fire width", "fire perimeter", "fire area" };
+    for(int j = 0; j < 7; j++)
+    {
+        testName = "Test surface " + outputNames[j] + " at elapsed times matches the single time getter";
+        reportTestResult(testInfo, testName, isMatching[j], true, error_tolerance);
+    }
+
+    // Crown fires use Rothermel's 1991 perimeter and area, only those two are requested
+    FireSizeBatchOutputs crownOutputs = { nullptr, nullptr, nullptr, nullptr, nullptr, firePerimeter, fireArea };
+    crown.getCrownFireSizeAtElapsedTimes(elapsedTimes, numberOfElapsedTimes, TimeUnits::Hours, LengthUnits::Meters, AreaUnits::Hectares,
+        crownOutputs);
+    bool isPerimeterMatching = true;
+    bool isAreaMatching = true;
+    for(int i = 0; i < numberOfElapsedTimes; i++)
+    {
+        double expectedPerimeter = crown.getCrownFirePerimeter(LengthUnits::Meters, elapsedTimes[i], TimeUnits::Hours);
+        double expectedArea = crown.getCrownFireArea(AreaUnits::Hectares, elapsedTimes[i], TimeUnits::Hours);
+        isPerimeterMatching = isPerimeterMatching && fabs(firePerimeter[i] - expectedPerimeter) <= error_tolerance * (1.0 + expectedPerimeter);
+        isAreaMatching = isAreaMatching && fabs(fireArea[i] - expectedArea) <= error_tolerance * (1.0 + expectedArea);
+    }
+    testName = "Test crown fire perimeter at elapsed times matches the single time getter";
+    reportTestResult(testInfo, testName, isPerimeterMatching, true, error_tolerance);
+    testName = "Test crown fire area at elapsed times matches the single time getter";
+    reportTestResult(testInfo, testName, isAreaMatching, true, error_tolerance);
+
+    std::cout << "Finished testing fire size at elapsed times\n\n";
+}
+
+void testIgniteBatch(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing Ignite batch\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-12;
+
+    const int numberOfCells = 5;
+    const double moistureOneHour[numberOfCells] = { 0.02, 0.06, 0.10, 0.15, 0.30 };
+    const double moistureHundredHour[numberOfCells] = { 0.05, 0.08, 0.20, 0.35, 0.60 };
+    const double airTemperature[numberOfCells] = { 40.0, 65.0, 80.0, 95.0, 110.0 };
+    const double sunShade[numberOfCells] = { 0.0, 0.25, 0.5, 0.75, 1.0 };
+    const double duffDepth[numberOfCells] = { 0.0, 0.05, 0.1, 0.2, 0.4 };
+    IgniteBatchInputs inputs = { numberOfCells, moistureOneHour, moistureHundredHour, airTemperature, sunShade, duffDepth };
+
+    double fuelTemperature[numberOfCells];
+    double firebrandIgnitionProbability[numberOfCells];
+    double lightningIgnitionProbability[numberOfCells];
+    IgniteBatchOutputs outputs = { fuelTemperature, firebrandIgnitionProbability, lightningIgnitionProbability };
+
+    Ignite batchIgnite;
+    Ignite ignite;
+    const int numberOfFuelBedTypes = 8;
+    const LightningCharge::LightningChargeEnum charges[] = { LightningCharge::Negative, LightningCharge::Positive, LightningCharge::Unknown };
+    bool isFuelTemperatureMatching = true;
+    bool isFirebrandMatching = true;
+    bool isLightningMatching = true;
+    for(int fuelBedType = 0; fuelBedType < numberOfFuelBedTypes; fuelBedType++)
+    {
+        for(LightningCharge::LightningChargeEnum charge : charges)
+        {
+            IgnitionFuelBedType::IgnitionFuelBedTypeEnum type = static_cast<IgnitionFuelBedType::IgnitionFuelBedTypeEnum>(fuelBedType);
+            batchIgnite.setIgnitionFuelBedType(type);
+            batchIgnite.setLightningChargeType(charge);
+            batchIgnite.calculateIgnitionProbabilitiesBatch(inputs, outputs);
+            for(int i = 0; i < numberOfCells; i++)
+            {
+                ignite.updateIgniteInputs(moistureOneHour[i], moistureHundredHour[i], FractionUnits::Fraction, airTemperature[i],
+                    TemperatureUnits::Fahrenheit, sunShade[i], FractionUnits::Fraction, type, duffDepth[i], LengthUnits::Feet, charge);
+                double firebrand = ignite.calculateFirebrandIgnitionProbability(FractionUnits::Fraction);
+                double lightning = ignite.calculateLightningIgnitionProbability(FractionUnits::Fraction);
+                isFuelTemperatureMatching = isFuelTemperatureMatching &&
+                    fabs(fuelTemperature[i] - ignite.getFuelTemperature(TemperatureUnits::Fahrenheit)) < error_tolerance;
+                isFirebrandMatching = isFirebrandMatching && fabs(firebrandIgnitionProbability[i] - firebrand) < error_tolerance;
+                isLightningMatching = isLightningMatching && fabs(lightningIgnitionProbability[i] - lightning) < error_tolerance;
+            }
+        }
+    }
+
+    testName = "Test Ignite batch fuel temperature matches the single cell run";
+    reportTestResult(testInfo, testName, isFuelTemperatureMatching, true, error_tolerance);
+    testName = "Test Ignite batch firebrand ignition probability matches the single cell run";
+    reportTestResult(testInfo, testName, isFirebrandMatching, true, error_tolerance);
+    testName = "Test Ignite batch lightning ignition probability matches the single cell run for all fuel bed types and charges";
+    reportTestResult(testInfo, testName, isLightningMatching, true, error_tolerance);
+
+    std::cout << "Finished testing Ignite batch\n\n";
+}
+
+void testWeatherAndTerrainBatch(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    (void)behaveRun;
+    std::cout << "Testing vapor pressure deficit and slope tool arrays\n";
+
+    string testName = "";
+    const double error_tolerance = 1e-12;
+    const VectorMathMode::VectorMathModeEnum modes[] = { VectorMathMode::Exact, VectorMathMode::Fast };
+    const string modeNames[] = { "exact", "fast" };
+
+    const int count = 64;
+    std::vector<double> temperature(count);
+    std::vector<double> relativeHumidity(count);
+    std::vector<double> mapDistance(count);
+    std::vector<double> elevationChange(count);
+    std::vector<double> maxSlope(count);
+    std::vector<double> directionFromUpslope(count);
+    for(int i = 0; i < count; i++)
+    {
+        temperature[i] = -10.0 + 2.0 * i;
+        relativeHumidity[i] = 0.05 + 0.9 * i / (count - 1.0);
+        mapDistance[i] = (i == 0) ? 0.0 : 0.01 * i;
+        elevationChange[i] = 40.0 * (i % 9);
+        maxSlope[i] = 1.25 * i;
+        directionFromUpslope[i] = 15.0 * (i % 7);
+    }
+
+    std::vector<double> saturatedVaporPressure(count);
+    std::vector<double> actualVaporPressure(count);
+    std::vector<double> vaporPressureDeficit(count);
+    std::vector<double> slope(count);
+    std::vector<double> horizontalDistance(count);
+    std::vector<double> slopeHorizontalDistance(count);
+    const int mapRepresentativeFraction = 24000;
+    for(int mode = 0; mode < 2; mode++)
+    {
+        VaporPressureDeficitCalculator::runCalculations(temperature.data(), relativeHumidity.data(), count, saturatedVaporPressure.data(),
+            actualVaporPressure.data(), vaporPressureDeficit.data(), modes[mode]);
+        SlopeTool::calculateHorizontalDistances(mapDistance.data(), maxSlope.data(), directionFromUpslope.data(), count,
+            horizontalDistance.data(), modes[mode]);
+        SlopeTool::calculateSlopesFromMapMeasurements(mapRepresentativeFraction, mapDistance.data(), elevationChange.data(), count,
+            slope.data(), slopeHorizontalDistance.data(), modes[mode]);
+
+        double maxPressureError = 0.0;
+        double maxDistanceError = 0.0;
+        double maxSlopeError = 0.0;
+        for(int i = 0; i < count; i++)
+        {
+            VaporPressureDeficitCalculator calculator;
+            calculator.setTemperature(temperature[i], TemperatureUnits::Fahrenheit);
+            calculator.setRelativeHumidity(relativeHumidity[i], FractionUnits::Fraction);
+            calculator.runCalculation();
+            const double expectedPressures[3] = { calculator.getSaturatedVaporPressure(PressureUnits::Pascal),
+                calculator.getActualVaporPressure(PressureUnits::Pascal), calculator.getVaporPressureDeficit(PressureUnits::Pascal) };
+            const double observedPressures[3] = { saturatedVaporPressure[i], actualVaporPressure[i], vaporPressureDeficit[i] };
+            for(int j = 0; j < 3; j++)
+            {
+                maxPressureError = std::max(maxPressureError, fabs(observedPressures[j] - expectedPressures[j]) / (1.0 + expectedPressures[j]));
+            }
+
+            // The single value horizontal distances are at 15 degree steps from upslope
+            SlopeTool slopeTool;
+            slopeTool.calculateHorizontalDistance(mapDistance[i], LengthUnits::Feet, maxSlope[i], SlopeUnits::Degrees);
+            double expectedDistance = slopeTool.getHorizontalDistanceAtIndex(i % 7, LengthUnits::Feet);
+            maxDistanceError = std::max(maxDistanceError, fabs(horizontalDistance[i] - expectedDistance) / (1.0 + expectedDistance));
+
+            slopeTool.calculateSlopeFromMapMeasurements(mapRepresentativeFraction, mapDistance[i], LengthUnits::Feet, elevationChange[i], 1.0,
+                LengthUnits::Feet);
+            maxSlopeError = std::max(maxSlopeError, fabs(slope[i] - slopeTool.getSlopeFromMapMeasurements(SlopeUnits::Degrees)));
+            maxSlopeError = std::max(maxSlopeError, fabs(slopeHorizontalDistance[i] -
+                slopeTool.getSlopeHorizontalDistanceFromMapMeasurements(LengthUnits::Feet)));
+        }
+
+        testName = "Test vapor pressure arrays match the single value calculation in " + modeNames[mode] + " mode";
+        reportTestResult(testInfo, testName, maxPressureError, 0.0, error_tolerance);
+        testName = "Test horizontal distance arrays match the single value calculation in " + modeNames[mode] + " mode";
+        reportTestResult(testInfo, testName, maxDistanceError, 0.0, error_tolerance);
+        testName = "Test slope from map measurements arrays match the single value calculation in " + modeNames[mode] + " mode";
+        reportTestResult(testInfo, testName, maxSlopeError, 0.0, error_tolerance);
+    }
+
+    std::cout << "Finished testing vapor pressure deficit and slope tool arrays\n\n";
+}
+
+void testSafetyBatch(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing Safety batch and crew table\n";
+
+    const int numberOfCells = 5;
+    double flameHeight[numberOfCells] = { 0.0, 2.5, 5.0, 12.0, 40.0 }; // ft
+    double separationDistance[numberOfCells];
+    double safetyZoneRadius[numberOfCells];
+    double safetyZoneArea[numberOfCells];
+    SafetyBatchOutputs outputs = { separationDistance, safetyZoneRadius, safetyZoneArea };
+
+    SafetyZoneTable table(50, 300, AreaUnits::SquareFeet, 20, 4);
+
+    bool isBatchMatching = true;
+    bool isTableMatching = true;
+    int crews[][2] = { { 6, 1 }, { 0, 0 }, { 20, 4 }, { 25, 6 } }; // the last crew is outside the table
+    for (int crew = 0; crew < 4; crew++)
+    {
+        int numberOfPersonnel = crews[crew][0];
+        int numberOfEquipment = crews[crew][1];
+        behaveRun.safety.updateSafetyInputs(0, LengthUnits::Feet, numberOfPersonnel, numberOfEquipment, 50, 300, AreaUnits::SquareFeet);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            if (pass == 0)
+            {
+                behaveRun.safety.calculateSafetyZonesBatch(flameHeight, numberOfCells, outputs);
+            }
+            else
+            {
+                table.calculateSafetyZones(numberOfPersonnel, numberOfEquipment, flameHeight, numberOfCells, outputs);
+            }
+            bool& isMatching = (pass == 0) ? isBatchMatching : isTableMatching;
+            for (int i = 0; i < numberOfCells; i++)
+            {
+                behaveRun.safety.setFlameHeight(flameHeight[i], LengthUnits::Feet);
+                behaveRun.safety.calculateSafetyZone();
+                isMatching = isMatching &&
+                    fabs(separationDistance[i] - behaveRun.safety.getSeparationDistance(LengthUnits::Feet)) < 1.0e-10 &&
+                    fabs(safetyZoneRadius[i] - behaveRun.safety.getSafetyZoneRadius(LengthUnits::Feet)) < 1.0e-10 &&
+                    fabs(safetyZoneArea[i] - behaveRun.safety.getSafetyZoneArea(AreaUnits::SquareFeet)) < 1.0e-8;
+            }
+        }
+    }
+    reportTestResult(testInfo, "Test safety zone batch matches scalar calculation", isBatchMatching, true, error_tolerance);
+    reportTestResult(testInfo, "Test safety zone crew table matches scalar calculation", isTableMatching, true, error_tolerance);
+
+    // 6 personnel at 50 ft^2 and 1 piece of equipment at 300 ft^2 gives a core of 600 ft^2
+    reportTestResult(testInfo, "Test safety zone crew table core radius", table.getCoreRadius(6, 1, LengthUnits::Feet), sqrt(600 / M_PI), 1.0e-10);
+
+    double onlyArea[numberOfCells];
+    SafetyBatchOutputs areaOnly = { nullptr, nullptr, onlyArea };
+    table.calculateSafetyZones(6, 1, flameHeight, numberOfCells, areaOnly);
+    reportTestResult(testInfo, "Test safety zone batch with null outputs", onlyArea[2] / 43560.0, 0.082490356, error_tolerance);
+
+    std::cout << "Finished testing Safety batch and crew table\n\n";
+}
+
+void testColumnarFile(TestInfo& testInfo)
+{
+    std::cout << "Testing columnar binary file\n";
+
+    const std::string fileName = "testColumnarFile.bcol";
+    const int numberOfChunks = 3;
+    const int rowsPerChunk = 500;
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        bool isCompressed = (pass == 1);
+        std::string passName = isCompressed ? " compressed" : " uncompressed";
+
+        ColumnarWriter writer;
+        writer.addColumn("RAWS_ID", ColumnarColumnType::String);
+        writer.addColumn("SPREAD_RATE", ColumnarColumnType::Float64);
+        writer.addColumn("FLAME_LENGTH", ColumnarColumnType::Float32);
+        writer.addColumn("FUEL_MODEL", ColumnarColumnType::Int32);
+        bool isWritten = writer.open(fileName, isCompressed);
+
+        std::vector<std::string> expectedIds;
+        std::vector<double> expectedSpreadRates;
+        ColumnarChunk chunk(writer);
+        for (int chunkIndex = 0; chunkIndex < numberOfChunks; chunkIndex++)
+        {
+            chunk.clear();
+            for (int row = 0; row < rowsPerChunk; row++)
+            {
+                int runNumber = chunkIndex * rowsPerChunk + row;
+                // long runs of repeated ids and bad data, as in a RAWS file, so compression has something to work on
+                std::string id = (runNumber % 7 == 0) ? "" : "RAWS" + std::to_string(runNumber / 100);
+                double spreadRate = (runNumber % 50 < 10) ? NAN : 0.01 * runNumber;
+                chunk.appendString(0, id);
+                chunk.appendValue(1, spreadRate);
+                chunk.appendValue(2, 0.5 * runNumber);
+                chunk.appendValue(3, 101 + runNumber % 3);
+                expectedIds.push_back(id);
+                expectedSpreadRates.push_back(spreadRate);
+            }
+            isWritten = writer.writeChunk(chunk) && isWritten;
+        }
+        // A chunk whose columns are out of step is refused
+        chunk.clear();
+        chunk.appendValue(1, 1.0);
+        isWritten = !writer.writeChunk(chunk) && isWritten;
+        isWritten = writer.close() && isWritten;
+        reportTestResult(testInfo, "Test columnar file written" + passName, isWritten, true, error_tolerance);
+
+        ColumnarReader reader;
+        bool isOpen = reader.open(fileName);
+        reportTestResult(testInfo, "Test columnar file opened" + passName, isOpen, true, error_tolerance);
+        if (!isOpen)
+        {
+            continue;
+        }
+        bool isSchemaMatching = reader.getNumberOfColumns() == 4 && reader.getColumnIndex("FLAME_LENGTH") == 2 &&
+            reader.getColumnType(2) == ColumnarColumnType::Float32 && reader.getColumnIndex("ASPECT") == -1 &&
+            reader.getNumberOfChunks() == numberOfChunks && reader.getNumberOfRows() == numberOfChunks * rowsPerChunk;
+        reportTestResult(testInfo, "Test columnar file schema" + passName, isSchemaMatching, true, error_tolerance);
+
+        std::vector<std::string> ids;
+        std::vector<double> spreadRates;
+        std::vector<double> flameLengths;
+        std::vector<double> fuelModels;
+        std::vector<double> wrongType;
+        bool isRead = reader.readColumn(0, ids) && reader.readColumn(1, spreadRates) &&
+            reader.readColumn(2, flameLengths) && reader.readColumn(3, fuelModels) && !reader.readColumn(0, wrongType);
+        bool isMatching = isRead && ids == expectedIds && spreadRates.size() == expectedSpreadRates.size();
+        for (size_t i = 0; isMatching && i < expectedSpreadRates.size(); i++)
+        {
+            isMatching = (std::isnan(expectedSpreadRates[i]) ? std::isnan(spreadRates[i]) : spreadRates[i] == expectedSpreadRates[i]) &&
+                flameLengths[i] == 0.5 * i && fuelModels[i] == 101 + i % 3;
+        }
+        reportTestResult(testInfo, "Test columnar file read back" + passName, isMatching, true, error_tolerance);
+    }
+    remove(fileName.c_str());
+
+    std::cout << "Finished testing columnar binary file\n\n";
+}
+
+void testBehaveRunEvaluator(TestInfo& testInfo)
+{
+    std::cout << "Testing BehaveRun evaluator\n";
+
+    FuelModels fuelModels;
+    SpeciesMasterTable speciesMasterTable;
+    BehaveRun run(fuelModels, speciesMasterTable);
+    run.surface.updateSurfaceInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 20.0, SlopeUnits::Percent, 0.0,
+        50.0, FractionUnits::Percent, 30.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+    run.crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 20.0, SlopeUnits::Percent, 0.0, 50.0,
+        FractionUnits::Percent, 30.0, 15.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+    run.spot.updateSpotInputsForSurfaceFire(SpotFireLocation::MIDSLOPE_WINDWARD, 1.0, LengthUnits::Miles, 1000.0, LengthUnits::Feet,
+        30.0, LengthUnits::Feet, SpotDownWindCanopyMode::CLOSED, 5.0, SpeedUnits::MilesPerHour, 4.0, LengthUnits::Feet);
+    run.safety.updateSafetyInputs(4.0, LengthUnits::Feet, 6, 1, 50, 300, AreaUnits::SquareFeet);
+
+    // The same scenario run module by module, the surface flame length chained into spot and safety
+    BehaveRun expectedRun(run);
+    expectedRun.safety.updateSafetyInputs(4.0, LengthUnits::Feet, 6, 1, 50, 300, AreaUnits::SquareFeet);
+    expectedRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    expectedRun.crown.doCrownRunScottAndReinhardt();
+    double expectedFlameLength = expectedRun.surface.getFlameLength(LengthUnits::Feet);
+    expectedRun.spot.setFlameLength(expectedFlameLength, LengthUnits::Feet);
+    expectedRun.spot.setWindSpeedAtTwentyFeet(expectedRun.surface.getWindSpeed(SpeedUnits::FeetPerMinute, WindHeightInputMode::TwentyFoot),
+        SpeedUnits::FeetPerMinute);
+    expectedRun.spot.calculateSpottingDistanceFromSurfaceFire();
+    expectedRun.safety.setFlameHeight(expectedFlameLength, LengthUnits::Feet);
+    expectedRun.safety.calculateSafetyZone();
+
+    BehaveRunEvaluator evaluator(run);
+    double spottingDistance = evaluator.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+    reportTestResult(testInfo, "Test evaluator spotting distance matches chaining the modules", spottingDistance,
+        expectedRun.spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet), error_tolerance);
+    reportTestResult(testInfo, "Test evaluator runs only the nodes a spotting distance needs",
+        evaluator.getNumberOfEvaluations(BehaveRunNode::SurfaceFire) == 1 && evaluator.getNumberOfEvaluations(BehaveRunNode::SpotFromSurfaceFire) == 1 &&
+        evaluator.getNumberOfEvaluations(BehaveRunNode::CrownFire) == 0 && evaluator.getNumberOfEvaluations(BehaveRunNode::SafetyZone) == 0,
+        true, error_tolerance);
+    reportTestResult(testInfo, "Test evaluator leaves the spot module's surface fire inputs alone",
+        run.spot.getSurfaceFlameLength(LengthUnits::Feet), 4.0, error_tolerance);
+
+    // Outputs of up to date nodes come from their memos
+    reportTestResult(testInfo, "Test evaluator flame length matches the surface run", evaluator.getFlameLength(LengthUnits::Feet),
+        expectedFlameLength, error_tolerance);
+    reportTestResult(testInfo, "Test evaluator safety zone radius matches chaining the modules", evaluator.getSafetyZoneRadius(LengthUnits::Feet),
+        expectedRun.safety.getSafetyZoneRadius(LengthUnits::Feet), error_tolerance);
+    reportTestResult(testInfo, "Test evaluator fire type matches the crown run", evaluator.getFireType(), expectedRun.crown.getFireType(),
+        error_tolerance);
+    evaluator.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+    evaluator.getCrownFractionBurned();
+    reportTestResult(testInfo, "Test evaluator reuses up to date nodes", evaluator.getNumberOfEvaluations(BehaveRunNode::SurfaceFire) == 1 &&
+        evaluator.getNumberOfEvaluations(BehaveRunNode::SpotFromSurfaceFire) == 1 && evaluator.getNumberOfEvaluations(BehaveRunNode::CrownFire) == 1 &&
+        evaluator.getNumberOfEvaluations(BehaveRunNode::SafetyZone) == 1, true, error_tolerance);
+
+    // A spot input only reruns spotting, a surface input the surface fire and whatever is asked for downstream of it
+    run.spot.setDownwindCoverHeight(60.0, LengthUnits::Feet);
+    reportTestResult(testInfo, "Test evaluator notices a changed spot input", evaluator.isNodeUpToDate(BehaveRunNode::SpotFromSurfaceFire) ||
+        !evaluator.isNodeUpToDate(BehaveRunNode::SurfaceFire), false, error_tolerance);
+    evaluator.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+    reportTestResult(testInfo, "Test evaluator reruns only spotting after a spot input changes",
+        evaluator.getNumberOfEvaluations(BehaveRunNode::SurfaceFire) == 1 && evaluator.getNumberOfEvaluations(BehaveRunNode::SpotFromSurfaceFire) == 2,
+        true, error_tolerance);
+
+    run.surface.setWindSpeed(15.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    double safetyZoneRadius = evaluator.getSafetyZoneRadius(LengthUnits::Feet);
+    reportTestResult(testInfo, "Test evaluator reruns the surface fire and safety zone after the wind changes",
+        evaluator.getNumberOfEvaluations(BehaveRunNode::SurfaceFire) == 2 && evaluator.getNumberOfEvaluations(BehaveRunNode::SafetyZone) == 2 &&
+        evaluator.getNumberOfEvaluations(BehaveRunNode::SpotFromSurfaceFire) == 2 && !evaluator.isNodeUpToDate(BehaveRunNode::SpotFromSurfaceFire) &&
+        evaluator.isNodeUpToDate(BehaveRunNode::CrownFire), true, error_tolerance);
+    expectedRun.surface.setWindSpeed(15.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    expectedRun.surface.doSurfaceRunInDirectionOfMaxSpread();
+    expectedRun.safety.setFlameHeight(expectedRun.surface.getFlameLength(LengthUnits::Feet), LengthUnits::Feet);
+    expectedRun.safety.calculateSafetyZone();
+    reportTestResult(testInfo, "Test evaluator safety zone radius follows the wind", safetyZoneRadius,
+        expectedRun.safety.getSafetyZoneRadius(LengthUnits::Feet), error_tolerance);
+
+    evaluator.setCrownFireMethod(EvaluatorCrownFireMethod::Rothermel);
+    evaluator.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+    evaluator.invalidate();
+    evaluator.getFlameLength(LengthUnits::Feet);
+    reportTestResult(testInfo, "Test evaluator reruns after a method change or invalidation",
+        evaluator.getNumberOfEvaluations(BehaveRunNode::CrownFire) == 2 && evaluator.getNumberOfEvaluations(BehaveRunNode::SurfaceFire) == 3,
+        true, error_tolerance);
+
+    std::cout << "Finished testing BehaveRun evaluator\n\n";
+}
+
+void testCompactSurfaceState(TestInfo& testInfo)
+{
+    std::cout << "Testing compact Surface state\n";
+
+    string testName = "";
+
+    FuelModels fuelModels;
+    Surface prototype(fuelModels);
+    prototype.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+    prototype.setWindAdjustmentFactorCalculationMethod(WindAdjustmentFactorCalculationMethod::UseCrownRatio);
+
+    Surface pixel(prototype);
+    pixel.updateSurfaceInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 45.0, WindAndSpreadOrientationMode::RelativeToNorth, 20.0, SlopeUnits::Percent, 95.0,
+        50.0, FractionUnits::Percent, 30.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+    pixel.doSurfaceRunInDirectionOfMaxSpread();
+    CompactSurfaceState state(pixel);
+
+    // A Surface left with another pixel's inputs runs as the captured one once rehydrated
+    Surface rehydrated(prototype);
+    rehydrated.updateSurfaceInputs(1, 12.0, 13.0, 14.0, 120.0, 150.0, FractionUnits::Percent, 15.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::DirectMidflame, 270.0, WindAndSpreadOrientationMode::RelativeToNorth, 5.0, SlopeUnits::Degrees, 0.0,
+        0.0, FractionUnits::Percent, 0.0, LengthUnits::Feet, 0.0, FractionUnits::Fraction);
+    state.rehydrate(rehydrated);
+    rehydrated.doSurfaceRunInDirectionOfMaxSpread();
+    testName = "Test rehydrated Surface spread rate matches the captured Surface";
+    reportTestResult(testInfo, testName, rehydrated.getSpreadRate(SpeedUnits::FeetPerMinute),
+        pixel.getSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-12);
+    testName = "Test rehydrated Surface flame length matches the captured Surface";
+    reportTestResult(testInfo, testName, rehydrated.getFlameLength(LengthUnits::Feet), pixel.getFlameLength(LengthUnits::Feet), 1.0e-12);
+    testName = "Test rehydrated Surface direction of max spread matches the captured Surface";
+    reportTestResult(testInfo, testName, rehydrated.getDirectionOfMaxSpread(), pixel.getDirectionOfMaxSpread(), 1.0e-12);
+    testName = "Test rehydrated Surface captures the same inputs";
+    reportTestResult(testInfo, testName, CompactSurfaceState(rehydrated).hasSameInputs(state), true, error_tolerance);
+
+    // The standard fuel state holds no special fuel or results block until results are captured
+    size_t inputsOnlyBytes = state.getNumberOfBytes();
+    testName = "Test compact state of a standard fuel pixel has no special fuel inputs";
+    reportTestResult(testInfo, testName, state.getSpecialFuelInputs() == nullptr && state.getResults() == nullptr, true, error_tolerance);
+    testName = "Test compact state is under a tenth of a Surface";
+    reportTestResult(testInfo, testName, inputsOnlyBytes * 10 < sizeof(Surface), true, error_tolerance);
+    state.captureResults(pixel);
+    testName = "Test compact state results block adds its size";
+    reportTestResult(testInfo, testName, (double)state.getNumberOfBytes(), (double)(inputsOnlyBytes + sizeof(CompactSurfaceResults)),
+        error_tolerance);
+    testName = "Test compact state keeps the captured spread rate";
+    reportTestResult(testInfo, testName, state.getResults()->spreadRate, pixel.getSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-12);
+    CompactSurfaceState copiedState(state);
+    testName = "Test copied compact state keeps its own results";
+    reportTestResult(testInfo, testName, copiedState.getResults() != nullptr && copiedState.getResults() != state.getResults(), true,
+        error_tolerance);
+
+    // Palmetto-gallberry inputs round trip through the special fuel block, and a standard state turns it back off
+    Surface palmettoPixel(prototype);
+    palmettoPixel.setIsUsingPalmettoGallberry(true);
+    palmettoPixel.updateSurfaceInputsForPalmettoGallbery(6.0, 7.0, 8.0, 60.0, 90.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToNorth, 10.0, 4.0, 50.0, 50.0,
+        BasalAreaUnits::SquareFeetPerAcre, 30.0, SlopeUnits::Percent, 0.0, 50.0, FractionUnits::Percent, 30.0, LengthUnits::Feet, 0.5,
+        FractionUnits::Fraction);
+    palmettoPixel.doSurfaceRunInDirectionOfMaxSpread();
+    CompactSurfaceState palmettoState(palmettoPixel);
+    palmettoState.rehydrate(rehydrated);
+    rehydrated.doSurfaceRunInDirectionOfMaxSpread();
+    testName = "Test rehydrated palmetto-gallberry spread rate matches the captured Surface";
+    reportTestResult(testInfo, testName, rehydrated.getSpreadRate(SpeedUnits::FeetPerMinute),
+        palmettoPixel.getSpreadRate(SpeedUnits::FeetPerMinute), 1.0e-12);
+    testName = "Test compact state of a palmetto-gallberry pixel adds the special fuel inputs";
+    reportTestResult(testInfo, testName, (double)palmettoState.getNumberOfBytes(), (double)(inputsOnlyBytes + sizeof(CompactSpecialFuelInputs)),
+        error_tolerance);
+    state.rehydrate(rehydrated);
+    rehydrated.doSurfaceRunInDirectionOfMaxSpread();
+    testName = "Test rehydrating a standard fuel state turns palmetto-gallberry off";
+    reportTestResult(testInfo, testName, !rehydrated.getIsUsingPalmettoGallberry() &&
+        rehydrated.getSpreadRate(SpeedUnits::FeetPerMinute) == pixel.getSpreadRate(SpeedUnits::FeetPerMinute), true, error_tolerance);
+
+    std::cout << "Finished testing compact Surface state\n\n";
+}
+
+void testBehaveRunSnapshot(TestInfo& testInfo)
+{
+    std::cout << "Testing BehaveRun snapshots\n";
+
+    FuelModels fuelModels;
+    SpeciesMasterTable speciesMasterTable;
+    BehaveRun run(fuelModels, speciesMasterTable);
+    run.surface.setFuelbedCacheCapacity(16);
+
+    // Base scenario
+    run.surface.updateSurfaceInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 20.0, SlopeUnits::Percent, 0.0,
+        50.0, FractionUnits::Percent, 30.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction);
+    run.surface.doSurfaceRunInDirectionOfMaxSpread();
+    run.crown.updateCrownInputs(124, 6.0, 7.0, 8.0, 60.0, 90.0, 120.0, FractionUnits::Percent, 5.0, SpeedUnits::MilesPerHour,
+        WindHeightInputMode::TwentyFoot, 0.0, WindAndSpreadOrientationMode::RelativeToUpslope, 20.0, SlopeUnits::Percent, 0.0, 50.0,
+        FractionUnits::Percent, 30.0, 15.0, LengthUnits::Feet, 0.5, FractionUnits::Fraction, 0.03, DensityUnits::PoundsPerCubicFoot);
+    run.crown.doCrownRunScottAndReinhardt();
+    run.spot.updateSpotInputsForSurfaceFire(SpotFireLocation::MIDSLOPE_WINDWARD, 1.0, LengthUnits::Miles, 1000.0, LengthUnits::Feet,
+        30.0, LengthUnits::Feet, SpotDownWindCanopyMode::CLOSED, 5.0, SpeedUnits::MilesPerHour, 4.0, LengthUnits::Feet);
+    run.spot.calculateSpottingDistanceFromSurfaceFire();
+    run.safety.updateSafetyInputs(4.0, LengthUnits::Feet, 6, 1, 50, 300, AreaUnits::SquareFeet);
+    run.safety.calculateSafetyZone();
+
+    BehaveRunSnapshot base(fuelModels);
+    run.takeSnapshot(base);
+    double baseSpreadRate = run.surface.getSpreadRate(SpeedUnits::FeetPerMinute);
+    double baseFinalSpreadRate = run.crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute);
+    double baseSpottingDistance = run.spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet);
+    double baseSafetyZoneRadius = run.safety.getSafetyZoneRadius(LengthUnits::Feet);
+    int numberOfCacheEntries = run.surface.getFuelbedCacheNumberOfEntries();
+
+    reportTestResult(testInfo, "Test snapshot has no changed modules when just taken", run.getModulesWithChangedInputs(base),
+        BehaveRunModule::None, error_tolerance);
+
+    // What-if branch with a stronger wind
+    run.surface.setWindSpeed(20.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    run.crown.setWindSpeed(20.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    run.spot.setWindSpeedAtTwentyFeet(20.0, SpeedUnits::MilesPerHour);
+    reportTestResult(testInfo, "Test snapshot changed modules after changing the wind", run.getModulesWithChangedInputs(base),
+        BehaveRunModule::Surface | BehaveRunModule::Crown | BehaveRunModule::Spot, error_tolerance);
+    run.surface.doSurfaceRunInDirectionOfMaxSpread();
+    run.crown.doCrownRunScottAndReinhardt();
+    run.spot.calculateSpottingDistanceFromSurfaceFire();
+    bool isBranchDifferent = run.surface.getSpreadRate(SpeedUnits::FeetPerMinute) != baseSpreadRate &&
+        run.crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute) != baseFinalSpreadRate &&
+        run.spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet) != baseSpottingDistance;
+    reportTestResult(testInfo, "Test snapshot branch results differ from the base", isBranchDifferent, true, error_tolerance);
+
+    run.restoreSnapshot(base);
+    bool isRestored = run.getModulesWithChangedInputs(base) == BehaveRunModule::None &&
+        run.surface.getSpreadRate(SpeedUnits::FeetPerMinute) == baseSpreadRate &&
+        run.crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute) == baseFinalSpreadRate &&
+        run.spot.getMaxFlatTerrainSpottingDistanceFromSurfaceFire(LengthUnits::Feet) == baseSpottingDistance &&
+        fabs(run.spot.getWindSpeedAtTwentyFeet(SpeedUnits::MilesPerHour) - 5.0) < 1e-6 &&
+        run.safety.getSafetyZoneRadius(LengthUnits::Feet) == baseSafetyZoneRadius;
+    reportTestResult(testInfo, "Test snapshot restores inputs and results", isRestored, true, error_tolerance);
+    reportTestResult(testInfo, "Test snapshot restore keeps the run's fuelbed cache", run.surface.getFuelbedCacheNumberOfEntries() >= numberOfCacheEntries &&
+        numberOfCacheEntries > 0, true, error_tolerance);
+
+    // Running the restored inputs again gives the same results
+    run.surface.doSurfaceRunInDirectionOfMaxSpread();
+    run.crown.doCrownRunScottAndReinhardt();
+    reportTestResult(testInfo, "Test snapshot rerun surface spread rate", run.surface.getSpreadRate(SpeedUnits::FeetPerMinute), baseSpreadRate, 1e-12);
+    reportTestResult(testInfo, "Test snapshot rerun crown final spread rate", run.crown.getFinalSpreadRate(SpeedUnits::FeetPerMinute), baseFinalSpreadRate, 1e-12);
+
+    // A branch that only changes the crew keeps every other module's results, inputs are compared by
+    // value so a wind speed set and then set back counts as unchanged
+    run.safety.updateSafetyInputs(4.0, LengthUnits::Feet, 20, 2, 50, 300, AreaUnits::SquareFeet);
+    run.surface.setWindSpeed(20.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    run.surface.setWindSpeed(5.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    int changedModules = run.restoreModulesWithUnchangedInputs(base);
+    reportTestResult(testInfo, "Test snapshot only the changed module is left to run", changedModules, BehaveRunModule::Safety, error_tolerance);
+    reportTestResult(testInfo, "Test snapshot crew size is kept", run.safety.getSafetyZoneRadius(LengthUnits::Feet) == baseSafetyZoneRadius &&
+        run.surface.getSpreadRate(SpeedUnits::FeetPerMinute) == baseSpreadRate, true, error_tolerance);
+    run.safety.calculateSafetyZone();
+    reportTestResult(testInfo, "Test snapshot changed module runs again", run.safety.getSafetyZoneRadius(LengthUnits::Feet) > baseSafetyZoneRadius,
+        true, error_tolerance);
+
+    // A direction of interest run round trips through a snapshot with its heat source and direction
+    run.surface.doSurfaceRunInDirectionOfInterest(45.0, SurfaceFireSpreadDirectionMode::FromIgnitionPoint);
+    BehaveRunSnapshot directionOfInterestBase(fuelModels);
+    run.takeSnapshot(directionOfInterestBase);
+    double baseHeatSource = run.surface.getHeatSource(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute);
+    double baseDirectionOfInterestSpreadRate = run.surface.getSpreadRateInDirectionOfInterest(SpeedUnits::FeetPerMinute);
+    run.surface.setWindSpeed(20.0, SpeedUnits::MilesPerHour, WindHeightInputMode::TwentyFoot);
+    run.surface.doSurfaceRunInDirectionOfInterest(135.0, SurfaceFireSpreadDirectionMode::FromIgnitionPoint);
+    run.restoreSnapshot(directionOfInterestBase);
+    reportTestResult(testInfo, "Test snapshot restores the heat source", run.surface.getHeatSource(HeatSourceAndReactionIntensityUnits::BtusPerSquareFootPerMinute),
+        baseHeatSource, 1e-12);
+    reportTestResult(testInfo, "Test snapshot heat source is not zero", baseHeatSource > 0.0, true, error_tolerance);
+    reportTestResult(testInfo, "Test snapshot restores the direction of interest spread rate",
+        run.surface.getSpreadRateInDirectionOfInterest(SpeedUnits::FeetPerMinute), baseDirectionOfInterestSpreadRate, 1e-12);
+    run.surface.doSurfaceRunInDirectionOfMaxSpread();
+
+    // Changing a fuel model changes the Surface and Crown inputs
+    fuelModels.setCustomFuelModel(200, "SNAP", "Snapshot test", 1.0, LengthUnits::Feet, 0.25, FractionUnits::Fraction, 8000, 8000, HeatOfCombustionUnits::BtusPerPound,
+        0.1, 0.0, 0.0, 0.0, 0.0, LoadingUnits::PoundsPerSquareFoot, 2000, 1500, 1500, SurfaceAreaToVolumeUnits::SquareFeetOverCubicFeet, false);
+    reportTestResult(testInfo, "Test snapshot fuel model change", run.getModulesWithChangedInputs(base) & (BehaveRunModule::Surface | BehaveRunModule::Crown),
+        BehaveRunModule::Surface | BehaveRunModule::Crown, error_tolerance);
+
+    std::cout << "Finished testing BehaveRun snapshots\n\n";
+}
+
+void testBehaveCApi(TestInfo& testInfo)
+{
+    string testName = "";
+    std::cout << "Testing C interface batch calls\n";
+
+    BehaveEngine* engine = behaveCreateEngine();
+    testName = "Test C interface engine is created";
+    reportTestResult(testInfo, testName, engine != nullptr, true, error_tolerance);
+    if(!engine)
+    {
+        return;
+    }
+
+    FuelModels fuelModels;
+    SpeciesMasterTable speciesMasterTable;
+    speciesMasterTable.initializeMasterTable();
+
+    // Surface and crown, against the C++ batch runs with the same wind conventions
+    const int numberOfCells = 4;
+    int fuelModelNumber[numberOfCells] = { 124, 1, 10, 165 };
+    double moistureOneHour[numberOfCells] = { 0.06, 0.06, 0.05, 0.04 };
+    double moistureTenHour[numberOfCells] = { 0.07, 0.07, 0.06, 0.05 };
+    double moistureHundredHour[numberOfCells] = { 0.08, 0.08, 0.07, 0.06 };
+    double moistureLiveHerbaceous[numberOfCells] = { 0.60, 0.60, 0.70, 0.50 };
+    double moistureLiveWoody[numberOfCells] = { 0.90, 0.90, 0.80, 0.70 };
+    double windSpeed[numberOfCells] = { 440.0, 880.0, 1320.0, 1760.0 }; // 5 to 20 mph in ft/min
+    double windDirection[numberOfCells] = { 45.0, 270.0, 180.0, 0.0 };
+    double slope[numberOfCells] = { 30.0, 10.0, 20.0, 0.0 };
+    double aspect[numberOfCells] = { 95.0, 180.0, 225.0, 0.0 };
+    double canopyCover[numberOfCells] = { 0.50, 0.50, 0.60, 0.70 };
+    double canopyHeight[numberOfCells] = { 30.0, 30.0, 60.0, 80.0 };
+    double crownRatio[numberOfCells] = { 0.50, 0.50, 0.40, 0.30 };
+    double canopyBaseHeight[numberOfCells] = { 6.0, 6.0, 4.0, 2.0 };
+    double canopyBulkDensity[numberOfCells] = { 0.03, 0.03, 0.02, 0.01 }; // lb/ft^3
+    double moistureFoliar[numberOfCells] = { 1.2, 1.2, 1.0, 0.9 };
+
+    BehaveSurfaceBatchInputs cSurfaceInputs = { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour,
+        moistureHundredHour, moistureLiveHerbaceous, moistureLiveWoody, windSpeed, windDirection, slope, aspect,
+        canopyCover, canopyHeight, crownRatio };
+    SurfaceBatchInputs surfaceInputs = { numberOfCells, fuelModelNumber, moistureOneHour, moistureTenHour,
+        moistureHundredHour, moistureLiveHerbaceous, moistureLiveWoody, windSpeed, windDirection, slope, aspect,
+        canopyCover, canopyHeight, crownRatio };
+
+    double cSpreadRate[numberOfCells];
+    double cFlameLength[numberOfCells];
+    double spreadRate[numberOfCells];
+    double flameLength[numberOfCells];
+    BehaveSurfaceBatchOutputs cSurfaceOutputs = { cSpreadRate, nullptr, cFlameLength, nullptr, nullptr };
+    SurfaceBatchOutputs surfaceOutputs = { spreadRate, nullptr, flameLength, nullptr, nullptr };
+    BehaveStatus status = behaveDoSurfaceRunBatch(engine, &cSurfaceInputs, &cSurfaceOutputs);
+    Surface surface(fuelModels);
+    surface.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+    surface.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+    surface.doSurfaceRunBatch(surfaceInputs, surfaceOutputs);
+
+    bool isMatching = status == BehaveStatusOk;
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        isMatching = isMatching && cSpreadRate[i] == spreadRate[i] && cFlameLength[i] == flameLength[i];
+    }
+    testName = "Test C interface surface batch matches Surface::doSurfaceRunBatch()";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+
+    BehaveCrownBatchInputs cCrownInputs = { cSurfaceInputs, canopyBaseHeight, canopyBulkDensity, moistureFoliar };
+    CrownBatchInputs crownInputs = { surfaceInputs, canopyBaseHeight, canopyBulkDensity, moistureFoliar };
+    int cFireType[numberOfCells];
+    double cFinalSpreadRate[numberOfCells];
+    double cTorchingIndex[numberOfCells];
+    FireType::FireTypeEnum fireType[numberOfCells];
+    double finalSpreadRate[numberOfCells];
+    double torchingIndex[numberOfCells];
+    BehaveCrownBatchOutputs cCrownOutputs = { cFireType, nullptr, nullptr, cFinalSpreadRate, nullptr, nullptr, nullptr,
+        cTorchingIndex, nullptr };
+    CrownBatchOutputs crownOutputs = { fireType, nullptr, nullptr, finalSpreadRate, nullptr, nullptr, nullptr,
+        torchingIndex, nullptr };
+    status = behaveDoCrownRunBatchScottAndReinhardt(engine, &cCrownInputs, &cCrownOutputs);
+    Crown crown(fuelModels);
+    crown.setWindHeightInputMode(WindHeightInputMode::TwentyFoot);
+    crown.setWindAndSpreadOrientationMode(WindAndSpreadOrientationMode::RelativeToNorth);
+    crown.doCrownRunBatchScottAndReinhardt(crownInputs, crownOutputs);
+
+    isMatching = status == BehaveStatusOk;
+    for(int i = 0; i < numberOfCells; i++)
+    {
+        isMatching = isMatching && cFireType[i] == fireType[i] && cFinalSpreadRate[i] == finalSpreadRate[i]
+            && cTorchingIndex[i] == torchingIndex[i];
+    }
+    testName = "Test C interface crown batch matches Crown::doCrownRunBatchScottAndReinhardt()";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+
+    // Spotting from torching trees, with the enum arrays passed as ints
+    const int numberOfSources = 3;
+    int torchingTrees[numberOfSources] = { 1, 5, 15 };
+    double dbh[numberOfSources] = { 10.0, 15.0, 20.0 };
+    double treeHeight[numberOfSources] = { 50.0, 80.0, 100.0 };
+    int cTreeSpecies[numberOfSources] = { SpotTreeSpecies::ENGELMANN_SPRUCE, SpotTreeSpecies::DOUGLAS_FIR,
+        SpotTreeSpecies::PONDEROSA_PINE };
+    SpotTreeSpecies::SpotTreeSpeciesEnum treeSpecies[numberOfSources] = { SpotTreeSpecies::ENGELMANN_SPRUCE,
+        SpotTreeSpecies::DOUGLAS_FIR, SpotTreeSpecies::PONDEROSA_PINE };
+    double windSpeedAtTwentyFeet[numberOfSources] = { 440.0, 880.0, 1320.0 };
+    double downwindCoverHeight[numberOfSources] = { 30.0, 50.0, 70.0 };
+    BehaveSpotBatchInputs cSpotInputs = { numberOfSources, nullptr, nullptr, torchingTrees, dbh, treeHeight, cTreeSpecies,
+        windSpeedAtTwentyFeet, downwindCoverHeight, nullptr, nullptr, nullptr, nullptr };
+    SpotBatchInputs spotInputs = { numberOfSources, nullptr, nullptr, torchingTrees, dbh, treeHeight, treeSpecies,
+        windSpeedAtTwentyFeet, downwindCoverHeight, nullptr, nullptr, nullptr, nullptr };
+    double cFlatDistance[numberOfSources];
+    double flatDistance[numberOfSources];
+    BehaveSpotBatchOutputs cSpotOutputs = { nullptr, cFlatDistance, nullptr };
+    SpotBatchOutputs spotOutputs = { nullptr, flatDistance, nullptr };
+    status = behaveCalculateSpottingDistanceBatch(engine, BehaveSpotSourceTorchingTrees, &cSpotInputs, &cSpotOutputs, 2);
+    Spot spot;
+    spot.calculateSpottingDistanceFromTorchingTreesBatch(spotInputs, spotOutputs, 1);
+
+    isMatching = status == BehaveStatusOk;
+    for(int i = 0; i < numberOfSources; i++)
+    {
+        isMatching = isMatching && cFlatDistance[i] == flatDistance[i];
+    }
+    testName = "Test C interface spot batch matches Spot torching trees batch";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+
+    // Mortality with species looked up through the engine's table
+    const int numberOfTrees = 4;
+    int speciesTableIndex[numberOfTrees] = { behaveGetSpeciesTableIndex(engine, "PIPO"), behaveGetSpeciesTableIndex(engine, "PSME"),
+        behaveGetSpeciesTableIndex(engine, "ABBA"), -1 };
+    double treeDensityPerAcre[numberOfTrees] = { 10.0, 20.0, 30.0, 40.0 };
+    double treeDbh[numberOfTrees] = { 8.0, 12.0, 16.0, 20.0 };
+    double mortalityTreeHeight[numberOfTrees] = { 40.0, 60.0, 80.0, 100.0 };
+    double treeCrownRatio[numberOfTrees] = { 0.3, 0.4, 0.5, 0.6 };
+    double treeFlameLength[numberOfTrees] = { 4.0, 6.0, 8.0, 10.0 };
+    BehaveMortalityStandInputs cStandInputs = { (int)RegionCode::interior_west, (int)FireSeverity::not_set };
+    BehaveMortalityBatchInputs cMortalityInputs = { numberOfTrees, speciesTableIndex, nullptr, treeDensityPerAcre, treeDbh,
+        mortalityTreeHeight, treeCrownRatio, nullptr, treeFlameLength, nullptr, nullptr, nullptr, nullptr };
+    MortalityBatchInputs mortalityInputs = { numberOfTrees, speciesTableIndex, nullptr, treeDensityPerAcre, treeDbh,
+        mortalityTreeHeight, treeCrownRatio, nullptr, treeFlameLength, nullptr, nullptr, nullptr, nullptr };
+    double cProbabilityOfMortality[numberOfTrees];
+    double probabilityOfMortality[numberOfTrees];
+    BehaveMortalityBatchOutputs cMortalityOutputs = { cProbabilityOfMortality, nullptr, nullptr };
+    MortalityBatchOutputs mortalityOutputs = { probabilityOfMortality, nullptr, nullptr };
+    BehaveMortalityStandTotals cStandTotals;
+    status = behaveCalculateMortalityBatch(engine, &cStandInputs, &cMortalityInputs, &cMortalityOutputs, &cStandTotals, 2);
+    Mortality mortality(speciesMasterTable);
+    mortality.setRegion(RegionCode::interior_west);
+    mortality.setFireSeverity(FireSeverity::not_set);
+    MortalityStandTotals standTotals = mortality.calculateMortalityBatch(mortalityInputs, mortalityOutputs, 1);
+
+    isMatching = status == BehaveStatusOk && cStandTotals.numberOfTrees == standTotals.numberOfTrees
+        && cStandTotals.numberOfErrors == standTotals.numberOfErrors
+        && cStandTotals.totalKilledTrees == standTotals.totalKilledTrees;
+    for(int i = 0; i < numberOfTrees; i++)
+    {
+        isMatching = isMatching && cProbabilityOfMortality[i] == probabilityOfMortality[i];
+    }
+    testName = "Test C interface mortality batch matches Mortality::calculateMortalityBatch()";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+    testName = "Test C interface mortality batch has valid trees";
+    reportTestResult(testInfo, testName, cStandTotals.numberOfTrees, 3, error_tolerance);
+
+    // Contain, against one ContainAdapter run per fire
+    const int numberOfResources = 2;
+    double arrival[numberOfResources] = { 60.0, 120.0 }; // minutes
+    double duration[numberOfResources] = { 480.0, 480.0 };
+    double productionRate[numberOfResources] = { 22.0, 11.0 }; // ft/min
+    const int numberOfFires = 20; // spans two chunks
+    vector<double> reportSize(numberOfFires);
+    vector<double> reportRate(numberOfFires);
+    vector<double> lwRatio(numberOfFires);
+    vector<int> tactic(numberOfFires);
+    for(int i = 0; i < numberOfFires; i++)
+    {
+        reportSize[i] = 43560.0 * (1 + i % 4); // 1 to 4 acres
+        reportRate[i] = 1.0 + i % 5; // ft/min
+        lwRatio[i] = 1.5 + (i % 3);
+        tactic[i] = (i % 2) ? ContainTactic::RearAttack : ContainTactic::HeadAttack;
+    }
+    BehaveContainResources cResources = { numberOfResources, arrival, duration, productionRate, nullptr, nullptr };
+    BehaveContainBatchInputs cContainInputs = { numberOfFires, reportSize.data(), reportRate.data(), lwRatio.data(),
+        tactic.data(), nullptr };
+    vector<int> cContainmentStatus(numberOfFires);
+    vector<double> cFinalFireSize(numberOfFires);
+    BehaveContainBatchOutputs cContainOutputs = { cContainmentStatus.data(), nullptr, cFinalFireSize.data(), nullptr,
+        nullptr, nullptr };
+    status = behaveDoContainRunBatch(engine, &cResources, &cContainInputs, &cContainOutputs, 2);
+
+    isMatching = status == BehaveStatusOk;
+    for(int i = 0; i < numberOfFires; i++)
+    {
+        ContainAdapter contain;
+        for(int resource = 0; resource < numberOfResources; resource++)
+        {
+            contain.addResource(arrival[resource], duration[resource], TimeUnits::Minutes, productionRate[resource],
+                SpeedUnits::FeetPerMinute);
+        }
+        contain.setReportSize(reportSize[i], AreaUnits::SquareFeet);
+        contain.setReportRate(reportRate[i], SpeedUnits::FeetPerMinute);
+        contain.setLwRatio(lwRatio[i]);
+        contain.setTactic(static_cast<ContainTactic::ContainTacticEnum>(tactic[i]));
+        contain.doContainRun();
+        isMatching = isMatching && cContainmentStatus[i] == contain.getContainmentStatus()
+            && cFinalFireSize[i] == contain.getFinalFireSize(AreaUnits::SquareFeet);
+    }
+    testName = "Test C interface contain batch matches ContainAdapter runs";
+    reportTestResult(testInfo, testName, isMatching, true, error_tolerance);
+
+    // Missing required buffers are reported rather than dereferenced
+    cSurfaceInputs.windSpeed = nullptr;
+    status = behaveDoSurfaceRunBatch(engine, &cSurfaceInputs, &cSurfaceOutputs);
+    testName = "Test C interface rejects a missing surface input array";
+    reportTestResult(testInfo, testName, status, BehaveStatusInvalidArgument, error_tolerance);
+    testName = "Test C interface reports an error message";
+    reportTestResult(testInfo, testName, string(behaveGetLastErrorMessage()).empty(), false, error_tolerance);
+
+    behaveDestroyEngine(engine);
+}
+
+#ifdef BEHAVE_INSTRUMENTATION
+void testInstrumentation(TestInfo& testInfo, BehaveRun& behaveRun)
+{
+    std::cout << "Testing instrumentation\n";
+
+    string testName = "";
+
+    Instrumentation::reset();
+
+    // One sweep over several directions is a single surface run, its nested runs are not counted again
+    const double directionsOfInterest[] = { 0.0, 90.0, 180.0 };
+    double spreadRates[3];
+    behaveRun.surface.doSurfaceRunInDirectionsOfInterest(directionsOfInterest, 3, SurfaceFireSpreadDirectionMode::FromIgnitionPoint,
+        spreadRates, nullptr, nullptr);
+
+    // A crown run, with its two surface runs, on a worker thread that exits before the totals are read
+    {
+        ThreadPool threadPool(2);
+        Crown crown(behaveRun.crown);
+        std::vector<std::function<void()>> tasks;
+        tasks.push_back([]() {});
+        tasks.push_back([&crown]() { crown.doCrownRunScottAndReinhardt(); });
+        threadPool.runTasks(tasks);
+    }
+
+    InstrumentationCounters totals[InstrumentationStage::NumberOfStages];
+    Instrumentation::getTotals(totals);
+    testName = "Test instrumentation counts outermost surface runs";
+    reportTestResult(testInfo, testName, (double)totals[InstrumentationStage::SurfaceRun].numberOfCalls, 3, error_tolerance);
+    testName = "Test instrumentation counts crown runs";
+    reportTestResult(testInfo, testName, (double)totals[InstrumentationStage::CrownRun].numberOfCalls, 1, error_tolerance);
+    testName = "Test instrumentation times crown runs";
+    reportTestResult(testInfo, testName, totals[InstrumentationStage::CrownRun].nanoseconds > 0, true, error_tolerance);
+    testName = "Test instrumentation does not count stages that did not run";
+    reportTestResult(testInfo, testName, (double)totals[InstrumentationStage::ContainSimRun].numberOfCalls, 0, error_tolerance);
+
+    std::string json = Instrumentation::toJson();
+    testName = "Test instrumentation JSON holds the crown run count";
+    reportTestResult(testInfo, testName, json.find("{\"name\":\"crownRun\",\"calls\":1,") != std::string::npos, true, error_tolerance);
+
+    Instrumentation::reset();
+    Instrumentation::getTotals(totals);
+    testName = "Test instrumentation reset clears the counters";
+    reportTestResult(testInfo, testName, (double)totals[InstrumentationStage::SurfaceRun].numberOfCalls, 0, error_tolerance);
+
+    std::cout << "Finished testing instrumentation\n\n";
+}
+#endif
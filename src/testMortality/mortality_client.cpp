@@ -1,80 +1,32 @@
+#include "columnarFile.h"
+#include "csvReader.h"
 #include "mortality.h"
 
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <fstream>
 #include <iostream>
-#include <locale>
-#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class readFile {
 public:
     std::vector<string> vHeader;
-    std::vector<string> vPlotIds;
-    std::vector<string> vFofemProbs;
-    std::vector<std::vector<string>> vData;
+    std::unordered_map<string, string> fofemProbsByPlotId;
+    std::vector<CsvField> vRow; // fields of the current row, valid until the next readRow()
 
     explicit readFile (const string& fName);
     int getDataTypeIndex(const string& str);
-    int getDataIndex(const string& str);
+    bool readRow();
 
 protected:
-    std::fstream file;
-    string lineDetails;
-    int itemCount = 0;
-    string header;
-    string headerItem;
-    string dataItem;
-    string dataItems;
-
-    std::stringstream ss;
-    std::vector<string> vDataItems;
-
-    static string cleanString (string text) {
-        for( std::string::iterator iter = text.begin() ; iter != text.end() ; )
-        {
-            if( !std::isprint(*iter) ) iter = text.erase(iter) ;  // erase non-printable characters
-            else ++iter ;  // not erased, increment iterator
-        }
-
-        // Remove leading and trailing whitespace
-        auto it_r = std::find_if(text.rbegin(), text.rend(),
-                               [](char c) {
-                                   return !std::isspace<char>(c, std::locale::classic());
-                               });
-        text.erase(it_r.base(), text.end());
-
-        auto it_l = std::find_if(text.begin(), text.end(),
-                               [](char c) {
-                                   return !std::isspace<char>(c, std::locale::classic());
-                               });
-        text.erase(text.begin(), it_l);
-
-
-        return text;
-    }
+    CsvReader reader;
+    int plotIdx = -1;
+    int mortAvgx = -1;
 };
 
-int readFile::getDataIndex(const string& pid) {
-    auto it = find(vPlotIds.begin(), vPlotIds.end(), pid);
-
-    // If element was found
-    if (it != vPlotIds.end())
-    {
-        // calculating the index of K
-        int index = it - vPlotIds.begin();
-        return index;
-    }
-    else {
-        // If the element is not
-        // present in the vector
-        std::cout << "-1" << std::endl;
-        return -1;
-    }
-}
-
 int readFile::getDataTypeIndex(const string& pid) {
     auto it = find(vHeader.begin(), vHeader.end(), pid);
 
@@ -94,72 +46,91 @@ int readFile::getDataTypeIndex(const string& pid) {
     }
 }
 
+bool readFile::readRow() {
+    if (!reader.readRow()) {
+        return false;
+    }
 
-readFile::readFile(const string& fName) { // Constructor with parameters
-    file.open(fName, std::ios::in);
+    vRow.clear();
+    for (int i = 0; i < reader.getNumberOfFields(); i++) {
+        vRow.push_back(reader.getField(i).trimmed());
+    }
+    // A trailing comma doesn't start another field
+    if (!vRow.empty() && vRow.back().empty()) {
+        vRow.pop_back();
+    }
+
+    // Make vRow at least the same size as vHeader
+    while (vRow.size() < vHeader.size()) {
+        vRow.push_back(CsvField());
+    }
+    return true;
+}
+
+readFile::readFile(const string& fName) // Constructor with parameters
+    : reader(fName) {
 
     /* Check that the file can be found and is accessible */
-    if( !file.is_open()) {
+    if( !reader.isOpen()) {
 
         std::cout << "File "<< fName <<" not found." << std::endl;
         exit(-1);
     }
 
     // Get the index names from the header row of file
-    getline (file, header);
-    ss << header;
-
-    while (getline (ss, headerItem, ','))
-    {
-        vHeader.push_back (cleanString((headerItem)));
-    };
-
-    while (getline(file, dataItems))
-    {
-        // Reset the string stream to allow new data line to be passed to it
-        ss.str("");
-        ss.clear();
-
-        // Convert the data line to a string stream so that it can be parsed
-        ss << cleanString(dataItems);
-
-        while (getline (ss, dataItem, ','))
-        {
-            vDataItems.push_back (cleanString(dataItem));
-        };
-
-        // Only create Vectors of FOFEM Probabilities if the output file is being read
-        if (getDataTypeIndex("MortAvg percent") != -1)
-        {
-            vPlotIds.push_back(vDataItems[getDataTypeIndex("PlotId")]);
-            vFofemProbs.push_back(vDataItems[getDataTypeIndex("MortAvg percent")]);
+    if (reader.readRow()) {
+        for (int i = 0; i < reader.getNumberOfFields(); i++) {
+            vHeader.push_back(reader.getField(i).trimmed().toString());
         }
-
-        // Make vDataItems the same size as vHeader
-        for (int i = (int) vDataItems.size(); i < vHeader.size(); i++)
-        {
-            vDataItems.emplace_back((""));
+        if (!vHeader.empty() && vHeader.back().empty()) {
+            vHeader.pop_back();
         }
-
-        vData.push_back(vDataItems);
-        vDataItems.clear();
     }
 
-    file.close();
+    // Only keep the FOFEM Probabilities if the output file is being read, the
+    // tree list itself is streamed a row at a time through readRow()
+    plotIdx = getDataTypeIndex("PlotId");
+    mortAvgx = getDataTypeIndex("MortAvg percent");
+    if (mortAvgx != -1 && plotIdx != -1)
+    {
+        while (readRow()) {
+            fofemProbsByPlotId.emplace(vRow[plotIdx].toString(), vRow[mortAvgx].toString());
+        }
+    }
 }
 
-
 int main(int argc, char *argv[])
 {
     if (argc < 4) {
       std::cout
         << "Unable to start tests. Please supply .tre and .csv files like so:\n\n"
-        << "testMortality <input.tre> <output.csv> <results.csv>"
+        << "testMortality <input.tre> <output.csv> <results.csv> [--format csv|binary] [--compress]"
         << argc
         << std::endl;
       return 1;
     }
 
+    // The results file is comma delimited text unless binary columnar output is asked for
+    bool isBinaryOutput = false;
+    bool isCompressed = false;
+    for (int argIndex = 4; argIndex < argc; argIndex++)
+    {
+        string argument = argv[argIndex];
+        if (argument == "--format" && argIndex + 1 < argc && (string(argv[argIndex + 1]) == "csv" || string(argv[argIndex + 1]) == "binary"))
+        {
+            isBinaryOutput = (string(argv[++argIndex]) == "binary");
+        }
+        else if (argument == "--compress")
+        {
+            isCompressed = true;
+        }
+        else
+        {
+            std::cout << "Invalid argument " << argument << "\n";
+            return 1;
+        }
+    }
+
     std::cout << "Starting tests with:"
               << "\nInput File:" << argv[1]
               << "\nOutput File:" << argv[2]
@@ -175,7 +146,6 @@ int main(int argc, char *argv[])
     string speciesCode;
 
     double probalilityOfMortality = 0;
-    double p = 0;
     std::fstream outFile;
     int runid = 0;
 
@@ -214,8 +184,6 @@ int main(int argc, char *argv[])
     string outputFilename = argv[2];
     readFile myFileOutput(outputFilename);
 
-    auto resultsFilename = argv[3];
-
     fsx = myFileInput.getDataTypeIndex("FS");
     FlLe_ScHtx = myFileInput.getDataTypeIndex("FlLe/ScHt");
     TreeExpansionFactorx = myFileInput.getDataTypeIndex("TreeExpansionFactor");
@@ -237,37 +205,60 @@ int main(int argc, char *argv[])
 //    bool isInRegion = mortality.checkIsInRegionAtSpeciesTableIndex(speciesIndex, region);
 
     string resultFilename = argv[3];
-    outFile.open(resultFilename, std::ios::out);
-    outFile << "RunId,";
-    for (const auto &e : myFileInput.vHeader) outFile << e << ",";
-    outFile << "BehaveProbability,"  << "FOFEMProbability," << "AbsoluteDifference" << std::endl;
-
-    // Iterate through vector to calculate probabilities of mortality
-    for (auto & element : myFileInput.vData) {
-        int idx = myFileInput.getDataTypeIndex("EquationType");
-        string plotID = element[myFileInput.getDataTypeIndex("PlotId")];
+    ColumnarWriter resultWriter;
+    const int numberOfInputColumns = (int)myFileInput.vHeader.size();
+    const size_t rowsPerChunk = 4096;
+    if (isBinaryOutput)
+    {
+        resultWriter.addColumn("RunId", ColumnarColumnType::Int32);
+        for (const auto &e : myFileInput.vHeader) resultWriter.addColumn(e, ColumnarColumnType::String);
+        resultWriter.addColumn("BehaveProbability", ColumnarColumnType::Int32);
+        resultWriter.addColumn("FOFEMProbability", ColumnarColumnType::Float64); // NaN where there is no FOFEM result
+        resultWriter.addColumn("AbsoluteDifference", ColumnarColumnType::Float64);
+        resultWriter.open(resultFilename, isCompressed);
+    }
+    else
+    {
+        outFile.open(resultFilename, std::ios::out);
+        outFile << "RunId,";
+        for (const auto &e : myFileInput.vHeader) outFile << e << ",";
+        outFile << "BehaveProbability,"  << "FOFEMProbability," << "AbsoluteDifference" << std::endl;
+    }
+    ColumnarChunk resultChunk(resultWriter);
+    resultChunk.reserve(rowsPerChunk);
+
+    int idx = myFileInput.getDataTypeIndex("EquationType");
+    int plotIdx = myFileInput.getDataTypeIndex("PlotId");
+    int treeSpeciesx = myFileInput.getDataTypeIndex("TreeSpecies");
+    int boleCharHeightx = myFileInput.getDataTypeIndex("BoleCharHeight");
+    double value = 0;
+
+    // Stream through the tree list to calculate probabilities of mortality
+    while (myFileInput.readRow()) {
+        const std::vector<CsvField>& element = myFileInput.vRow;
+        string plotID = element[plotIdx].toString();
         
-        string fs = element[fsx];
-        string FlLe_ScHt = element[FlLe_ScHtx];
-        string TreeExpansionFactor = element[TreeExpansionFactorx];
-        string Diameter = element[Diameterx];
-        string TreeHeight = element[TreeHeightx];
-        string CrownRatio = element[CrownRatiox];
-        string CrownScorchP = element[CrownScorchPx];
-        string CKR = element[CKRx];
-        string BeetleDamage = element[BeetleDamagex];
-
-        if (element[idx] == "CRNSCH")
+        CsvField fs = element[fsx];
+        CsvField FlLe_ScHt = element[FlLe_ScHtx];
+        CsvField TreeExpansionFactor = element[TreeExpansionFactorx];
+        CsvField Diameter = element[Diameterx];
+        CsvField TreeHeight = element[TreeHeightx];
+        CsvField CrownRatio = element[CrownRatiox];
+        CsvField CrownScorchP = element[CrownScorchPx];
+        CsvField CKR = element[CKRx];
+        CsvField BeetleDamage = element[BeetleDamagex];
+
+        if (element[idx].equals("CRNSCH"))
         {
             mortality.setEquationType(EquationType::crown_scorch);
             equationType = EquationType::crown_scorch;
         }
-        else if (element[idx] == "CRCABE")
+        else if (element[idx].equals("CRCABE"))
         {
             mortality.setEquationType(EquationType::crown_damage);
             equationType = EquationType::crown_damage;
         }
-        else if (element[idx] == "BOLCHR")
+        else if (element[idx].equals("BOLCHR"))
         {
             mortality.setEquationType(EquationType::bole_char);
             equationType = EquationType::bole_char;
@@ -278,16 +269,16 @@ int main(int argc, char *argv[])
             equationType = EquationType::not_set;
         }
 
-        speciesCode = element[myFileInput.getDataTypeIndex("TreeSpecies")];
+        speciesCode = element[treeSpeciesx].toString();
         mortality.setSpeciesCode(speciesCode);
         rc = mortality.updateInputsForSpeciesCodeAndEquationType(speciesCode, equationType);
 
         if(rc == ok)
         {
             if (!fs.empty() ){
-              if (fs == "S") {
+              if (fs.equals("S")) {
                 mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::scorch_height);
-              } else if (fs == "F") {
+              } else if (fs.equals("F")) {
                 mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::flame_length);
               } else {
                 mortality.setFlameLengthOrScorchHeightSwitch(FlameLengthOrScorchHeightSwitch::flame_length);
@@ -295,45 +286,46 @@ int main(int argc, char *argv[])
               }
             }
 
-            if (!FlLe_ScHt.empty() )
-                mortality.setFlameLengthOrScorchHeightValue(stod(FlLe_ScHt), LengthUnits::Feet);
+            if (FlLe_ScHt.toDouble(value))
+                mortality.setFlameLengthOrScorchHeightValue(value, LengthUnits::Feet);
 
-            if (!TreeExpansionFactor.empty() )
-                mortality.setTreeDensityPerUnitArea(stod(TreeExpansionFactor), AreaUnits::Acres);
+            if (TreeExpansionFactor.toDouble(value))
+                mortality.setTreeDensityPerUnitArea(value, AreaUnits::Acres);
 
-            if (!Diameter.empty() )
-                mortality.setDBH(stod(Diameter), LengthUnits::Inches);
+            if (Diameter.toDouble(value))
+                mortality.setDBH(value, LengthUnits::Inches);
 
-            if (!TreeHeight.empty() )
-                mortality.setTreeHeight(stod(TreeHeight), LengthUnits::Feet);
+            if (TreeHeight.toDouble(value))
+                mortality.setTreeHeight(value, LengthUnits::Feet);
 
-            if (!CrownRatio.empty() )
-                mortality.setCrownRatio(stod(CrownRatio) / 100, FractionUnits::Fraction); // input as a fraction from 0.0 to 1.0
+            if (CrownRatio.toDouble(value))
+                mortality.setCrownRatio(value / 100, FractionUnits::Fraction); // input as a fraction from 0.0 to 1.0
 
-            if (!CrownScorchP.empty() )
-                mortality.setCrownDamage(stod(CrownScorchP));
+            if (CrownScorchP.toDouble(value))
+                mortality.setCrownDamage(value);
 
-            if (!CKR.empty() )
-                mortality.setCambiumKillRating(stod(CKR));
+            if (CKR.toDouble(value))
+                mortality.setCambiumKillRating(value);
             
             if(!BeetleDamage.empty())
             {
-                std::transform(BeetleDamage.begin(), BeetleDamage.end(), BeetleDamage.begin(), ::toupper);
-                if ( BeetleDamage == "YES")
+                string beetleDamage = BeetleDamage.toString();
+                std::transform(beetleDamage.begin(), beetleDamage.end(), beetleDamage.begin(), ::toupper);
+                if ( beetleDamage == "YES")
                     mortality.setBeetleDamage(BeetleDamage::yes);
-                else if ( BeetleDamage == "NO")
+                else if ( beetleDamage == "NO")
                     mortality.setBeetleDamage(BeetleDamage::no);
                 else
                     mortality.setBeetleDamage(BeetleDamage::not_set);
             }
 
-            if (!element[myFileInput.getDataTypeIndex("BoleCharHeight")].empty())
-                mortality.setBoleCharHeight(stod(element[myFileInput.getDataTypeIndex("BoleCharHeight")]), LengthUnits::Feet);
+            if (element[boleCharHeightx].toDouble(value))
+                mortality.setBoleCharHeight(value, LengthUnits::Feet);
 
 
             requiredFieldVector = mortality.getRequiredFieldVector();
 
-            for(int i = (int)RequiredFieldNames::dbh; i < requiredFieldVector.size(); i++)
+            for(size_t i = (size_t)RequiredFieldNames::dbh; i < requiredFieldVector.size(); i++)
             {
                 if(requiredFieldVector[i] == true)
                 {
@@ -375,17 +367,57 @@ int main(int argc, char *argv[])
 
             probalilityOfMortality = mortality.calculateMortality(FractionUnits::Percent);
 
+            auto fofemProbIt = myFileOutput.fofemProbsByPlotId.find(plotID);
+            if (isBinaryOutput)
+            {
+                int column = 0;
+                resultChunk.appendValue(column++, ++runid);
+                for (int i = 0; i < numberOfInputColumns; i++)
+                {
+                    resultChunk.appendString(column++, element[i].data(), element[i].size());
+                }
+                resultChunk.appendValue(column++, (int) probalilityOfMortality);
+                double fofemProb = NAN;
+                if (fofemProbIt != myFileOutput.fofemProbsByPlotId.end())
+                {
+                    fofemProb = stod(fofemProbIt->second);
+                }
+                else
+                {
+                    std::cout << "Error, no FOFEM result for " << plotID << "\n";
+                }
+                resultChunk.appendValue(column++, fofemProb);
+                resultChunk.appendValue(column++, fabs(fofemProb - probalilityOfMortality));
+                if (resultChunk.getNumberOfRows(0) == rowsPerChunk)
+                {
+                    resultWriter.writeChunk(resultChunk);
+                    resultChunk.clear();
+                }
+                continue;
+            }
+
             // Write out input data for this current plotid to results file
             outFile << ++runid << ",";
-            for (const auto &e : element) outFile << e << ",";
+            for (const auto &e : element) {
+                outFile.write(e.data(), e.size());
+                outFile << ",";
+            }
             outFile << (int) probalilityOfMortality << ",";
 
             // Find the FOFEM Probability for the current plot ID and include in results output file
-            double fofemProb = stod(myFileOutput.vFofemProbs[myFileOutput.getDataIndex(plotID)]);
+            if (fofemProbIt != myFileOutput.fofemProbsByPlotId.end())
+            {
+                double fofemProb = stod(fofemProbIt->second);
 
-            outFile << myFileOutput.vFofemProbs[myFileOutput.getDataIndex(plotID)] << ",";
-            outFile << fabs((fofemProb - probalilityOfMortality)) << ",";
-            outFile << std::endl;
+                outFile << fofemProbIt->second << ",";
+                outFile << fabs((fofemProb - probalilityOfMortality)) << ",";
+            }
+            else
+            {
+                std::cout << "Error, no FOFEM result for " << plotID << "\n";
+                outFile << ",,";
+            }
+            outFile << '\n';
 
 //            std::cout << "Probability of mortality: " << probalilityOfMortality <<"%\n";
         }
@@ -395,7 +427,18 @@ int main(int argc, char *argv[])
         }
     }
 
-    outFile.close();
+    if (isBinaryOutput)
+    {
+        if (resultChunk.getNumberOfRows(0) > 0)
+        {
+            resultWriter.writeChunk(resultChunk);
+        }
+        resultWriter.close();
+    }
+    else
+    {
+        outFile.close();
+    }
 
 
     return 0;